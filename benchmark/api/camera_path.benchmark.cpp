@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/gl/headless_frontend.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/renderer/renderer.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <ctime>
+
+using namespace mbgl;
+
+namespace {
+
+// Replays camera paths recorded at 60 frames per second in continuous mode, against the tiles of
+// the offline cache. The benchmark's time is the time it takes from the first frame of a path
+// until the map has fully loaded after its last frame.
+class CameraPathBenchmark : public MapObserver {
+public:
+    CameraPathBenchmark() {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+    }
+
+    void onDidFinishRenderingFrame(RenderMode mode) final {
+        frames++;
+        loaded = mode == RenderMode::Full;
+        frameTimes.push_back(frontend->getRenderer()->getStatistics().frameTime);
+    }
+
+    void run(::benchmark::State&, const std::vector<CameraOptions>&);
+
+    util::RunLoop loop;
+    DefaultFileSource fileSource { "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool { 4 };
+
+    std::unique_ptr<HeadlessFrontend> frontend;
+    std::size_t frames = 0;
+    bool loaded = false;
+    std::vector<Duration> frameTimes;
+};
+
+// The paths stay within the tiles of the cache: they keep to zoom level 15 in Manhattan.
+std::vector<CameraOptions> loadPath(const std::string& name) {
+    JSDocument document;
+    document.Parse<0>(util::read_file("benchmark/fixtures/api/camera_paths.json").c_str());
+    assert(!document.HasParseError() && document.HasMember(name.c_str()));
+
+    std::vector<CameraOptions> path;
+    for (const auto& frame : document[name.c_str()].GetArray()) {
+        CameraOptions camera;
+        camera.center = LatLng { frame[1].GetDouble(), frame[0].GetDouble() };
+        camera.zoom = frame[2].GetDouble();
+        camera.angle = -frame[3].GetDouble() * util::DEG2RAD;
+        path.push_back(camera);
+    }
+    return path;
+}
+
+double cpuTime(clockid_t clock) {
+    timespec value;
+    clock_gettime(clock, &value);
+    return value.tv_sec + value.tv_nsec / 1e9;
+}
+
+double milliseconds(Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void CameraPathBenchmark::run(::benchmark::State& state, const std::vector<CameraOptions>& path) {
+    double workerTime = 0;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        frontend = std::make_unique<HeadlessFrontend>(Size { 512, 512 }, 1, fileSource, threadPool);
+        auto map = std::make_unique<Map>(*frontend, *this, frontend->getSize(), 1, fileSource, threadPool, MapMode::Continuous);
+        map->getStyle().loadJSON(util::read_file("benchmark/fixtures/api/style.json"));
+        state.ResumeTiming();
+
+        // CPU time spent on other threads than this one: workers, and the file source's.
+        const double startTime = cpuTime(CLOCK_PROCESS_CPUTIME_ID) - cpuTime(CLOCK_THREAD_CPUTIME_ID);
+
+        for (const auto& camera : path) {
+            map->jumpTo(camera);
+            const std::size_t before = frames;
+            while (frames == before) {
+                loop.runOnce();
+            }
+        }
+        while (!loaded) {
+            loop.runOnce();
+        }
+
+        workerTime += cpuTime(CLOCK_PROCESS_CPUTIME_ID) - cpuTime(CLOCK_THREAD_CPUTIME_ID) - startTime;
+
+        state.PauseTiming();
+        loaded = false;
+        map.reset();
+        frontend.reset();
+        state.ResumeTiming();
+    }
+
+    if (frameTimes.empty()) {
+        return;
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    const auto percentile = [&] (double p) {
+        return milliseconds(frameTimes[std::min(frameTimes.size() - 1, std::size_t(p * frameTimes.size()))]);
+    };
+
+    // Linux reports the peak resident set size in kilobytes, macOS in bytes.
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if __APPLE__
+    const double peakMemory = usage.ru_maxrss / 1048576.0;
+#else
+    const double peakMemory = usage.ru_maxrss / 1024.0;
+#endif
+
+    char label[128];
+    std::snprintf(label, sizeof(label), "frame p50 %.2f ms, p99 %.2f ms, worker CPU %.0f ms, peak RSS %.0f MB",
+                  percentile(0.5), percentile(0.99), workerTime * 1000 / state.iterations(), peakMemory);
+    state.SetLabel(label);
+}
+
+} // end namespace
+
+static void API_cameraPath_pan(::benchmark::State& state) {
+    CameraPathBenchmark bench;
+    bench.run(state, loadPath("pan"));
+}
+
+static void API_cameraPath_zoom(::benchmark::State& state) {
+    CameraPathBenchmark bench;
+    bench.run(state, loadPath("zoom"));
+}
+
+static void API_cameraPath_fly(::benchmark::State& state) {
+    CameraPathBenchmark bench;
+    bench.run(state, loadPath("fly"));
+}
+
+BENCHMARK(API_cameraPath_pan);
+BENCHMARK(API_cameraPath_zoom);
+BENCHMARK(API_cameraPath_fly);
@@ -36,6 +36,24 @@ static void prepare(Map& map, optional<std::string> json = {}) {
                                                            decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png")), 1.0));
 }
  
+// Lines and translucent fills covered by opaque fills and an opaque background, the case where
+// depth testing against the opaque pass saves the most fragment work.
+const char* fillHeavyStyle = R"STYLE({
+  "version": 8,
+  "sources": { "composite": { "type": "vector", "url": "mapbox://mapbox.mapbox-terrain-v2,mapbox.mapbox-streets-v7" } },
+  "layers": [
+    { "id": "background-bottom", "type": "background", "paint": { "background-color": "#eee" } },
+    { "id": "road-below", "type": "line", "source": "composite", "source-layer": "road", "paint": { "line-width": 12 } },
+    { "id": "landuse-translucent", "type": "fill", "source": "composite", "source-layer": "landuse", "paint": { "fill-opacity": 0.5 } },
+    { "id": "background-middle", "type": "background", "paint": { "background-color": "#ddd" } },
+    { "id": "landuse", "type": "fill", "source": "composite", "source-layer": "landuse", "paint": { "fill-color": "#cfc" } },
+    { "id": "water", "type": "fill", "source": "composite", "source-layer": "water", "paint": { "fill-color": "#ccf" } },
+    { "id": "building-below", "type": "fill", "source": "composite", "source-layer": "building", "paint": { "fill-color": "#999", "fill-antialias": false } },
+    { "id": "building", "type": "fill", "source": "composite", "source-layer": "building", "paint": { "fill-color": "#aaa" } },
+    { "id": "road", "type": "line", "source": "composite", "source-layer": "road", "paint": { "line-width": 4 } }
+  ]
+})STYLE";
+
 } // end namespace
 
 static void API_renderStill_reuse_map(::benchmark::State& state) {
@@ -49,6 +67,17 @@ static void API_renderStill_reuse_map(::benchmark::State& state) {
     }
 }
 
+static void API_renderStill_fill_heavy(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
+    Map map { frontend, MapObserver::nullObserver(), frontend.getSize(), 1, bench.fileSource, bench.threadPool, MapMode::Still };
+    prepare(map, std::string(fillHeavyStyle));
+
+    while (state.KeepRunning()) {
+        frontend.render(map);
+    }
+}
+
 static void API_renderStill_reuse_map_switch_styles(::benchmark::State& state) {
     RenderBenchmark bench;
     HeadlessFrontend frontend { { 1000, 1000 }, 1, bench.fileSource, bench.threadPool };
@@ -74,5 +103,6 @@ static void API_renderStill_recreate_map(::benchmark::State& state) {
 }
 
 BENCHMARK(API_renderStill_reuse_map);
+BENCHMARK(API_renderStill_fill_heavy);
 BENCHMARK(API_renderStill_reuse_map_switch_styles);
 BENCHMARK(API_renderStill_recreate_map);
@@ -5,10 +5,13 @@
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 #include <rapidjson/document.h>
 
+#include <vector>
+
 using namespace mbgl;
 
 style::Filter parse(const char* expression) {
@@ -38,5 +41,58 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+// A landuse-style filter evaluated over a layer of 100k features.
+static const char* layerFilter = R"FILTER(["all",
+    ["==", "$type", "Polygon"],
+    ["in", "class", "park", "cemetery", "hospital", "pitch", "school", "wood", "grass", "sand"],
+    ["!=", "class", "industrial"],
+    [">=", "rank", 2]
+])FILTER";
+
+static std::vector<Feature> layerFeatures() {
+    static const char* classes[] = { "park", "industrial", "residential", "wood", "school", "parking" };
+    std::vector<Feature> features;
+    features.reserve(100000);
+    for (uint64_t i = 0; i < 100000; i++) {
+        Feature feature { i % 4 ? Geometry<double>(Polygon<double>()) : Geometry<double>(Point<double>()) };
+        feature.id = { i };
+        feature.properties = {
+            { "class", std::string(classes[i % 6]) },
+            { "rank", int64_t(i % 5) },
+            { "name", std::string("feature") }
+        };
+        features.push_back(std::move(feature));
+    }
+    return features;
+}
+
+static void Parse_EvaluateFilterLayer(benchmark::State& state) {
+    const style::Filter filter = parse(layerFilter);
+    const std::vector<Feature> features = layerFeatures();
+
+    while (state.KeepRunning()) {
+        std::size_t matches = 0;
+        for (const auto& feature : features) {
+            matches += filter(feature);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
+static void Parse_EvaluateCompiledFilterLayer(benchmark::State& state) {
+    const style::CompiledFilter filter(parse(layerFilter));
+    const std::vector<Feature> features = layerFeatures();
+
+    while (state.KeepRunning()) {
+        std::size_t matches = 0;
+        for (const auto& feature : features) {
+            matches += filter(feature);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilterLayer);
+BENCHMARK(Parse_EvaluateCompiledFilterLayer);
@@ -0,0 +1,20 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/style/parser.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+static void Parse_Style(benchmark::State& state) {
+    const std::string json = util::read_file("benchmark/fixtures/api/style.json");
+
+    while (state.KeepRunning()) {
+        style::Parser parser;
+        auto error = parser.parse(json);
+        benchmark::DoNotOptimize(error);
+    }
+
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+BENCHMARK(Parse_Style);
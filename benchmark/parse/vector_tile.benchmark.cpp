@@ -1,6 +1,9 @@
 #include <benchmark/benchmark.h>
 
 #include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/buckets/line_bucket.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/io.hpp>
 
 using namespace mbgl;
@@ -26,3 +29,132 @@ static void Parse_VectorTile(benchmark::State& state) {
 }
 
 BENCHMARK(Parse_VectorTile);
+
+static void Parse_VectorTileProperties(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    // Look up a mix of keys that exist in most layers ("class", "name") and keys that don't, the
+    // way filters and data-driven property bindings do for every feature.
+    const std::vector<std::string> keys { "class", "name", "type", "ref", "nonexistent" };
+
+    while (state.KeepRunning()) {
+        std::size_t found = 0;
+        VectorTileData tile(data);
+        for (const auto& name : tile.layerNames()) {
+            if (auto layer = tile.getLayer(name)) {
+                const std::size_t count = layer->featureCount();
+                for (std::size_t i = 0; i < count; i++) {
+                    if (auto feature = layer->getFeature(i)) {
+                        for (const auto& key : keys) {
+                            found += bool(feature->getValue(key));
+                        }
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+BENCHMARK(Parse_VectorTileProperties);
+
+// Decodes the geometries of every feature of a tile with mapbox::vector_tile, or the way
+// VectorTileData does.
+static void Parse_VectorTileGeometries(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    mapbox::vector_tile::buffer buffer(*data);
+    VectorTileData tile(data);
+    const bool vendor = !state.range(0);
+
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        for (const auto& name : tile.layerNames()) {
+            if (vendor) {
+                const mapbox::vector_tile::layer layer(buffer.getLayers().at(name));
+                for (std::size_t i = 0; i < layer.featureCount(); i++) {
+                    const mapbox::vector_tile::feature feature(layer.getFeature(i), layer);
+                    count += feature.getGeometries<GeometryCollection>(float(util::EXTENT) / feature.getExtent()).size();
+                }
+            } else if (auto layer = tile.getLayer(name)) {
+                for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                    count += layer->getFeature(i)->getGeometries().size();
+                }
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+BENCHMARK(Parse_VectorTileGeometries)->Arg(0)->Arg(1);
+
+// Classifies the rings of every polygon of a tile, allocating the polygons for every feature, or
+// reusing them between features the way fill buckets do.
+static void Parse_ClassifyRings(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    std::vector<GeometryCollection> geometries;
+    VectorTileData tile(data);
+    for (const auto& name : tile.layerNames()) {
+        if (auto layer = tile.getLayer(name)) {
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                auto feature = layer->getFeature(i);
+                if (feature->getType() == FeatureType::Polygon) {
+                    geometries.push_back(feature->getGeometries());
+                }
+            }
+        }
+    }
+
+    const bool reuse = state.range(0);
+    std::vector<GeometryCollection> polygons;
+
+    while (state.KeepRunning()) {
+        std::size_t count = 0;
+        for (const auto& geometry : geometries) {
+            if (reuse) {
+                classifyRings(geometry, polygons);
+                count += polygons.size();
+            } else {
+                count += classifyRings(geometry).size();
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+BENCHMARK(Parse_ClassifyRings)->Arg(0)->Arg(1);
+
+// Builds the line geometry of every line feature of a tile, the way a tile's road and boundary
+// layers are laid out.
+static void Parse_LineBucket(benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    VectorTileData tile(data);
+    for (const auto& name : tile.layerNames()) {
+        if (auto layer = tile.getLayer(name)) {
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                auto feature = layer->getFeature(i);
+                if (feature->getType() == FeatureType::LineString) {
+                    features.push_back(std::move(feature));
+                }
+            }
+        }
+    }
+
+    std::vector<GeometryCollection> geometries;
+    for (const auto& feature : features) {
+        geometries.push_back(feature->getGeometries());
+    }
+
+    while (state.KeepRunning()) {
+        LineBucket bucket { { { 10, 163, 395 }, MapMode::Continuous, 1.0 }, {}, {} };
+        for (std::size_t i = 0; i < features.size(); i++) {
+            bucket.addFeature(*features[i], geometries[i], i);
+        }
+        benchmark::DoNotOptimize(bucket.vertices.vertexSize());
+    }
+}
+
+BENCHMARK(Parse_LineBucket);
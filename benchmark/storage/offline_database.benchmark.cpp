@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Resource tile(int64_t i) {
+    return Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, i % 65536, i / 65536, 16, Tileset::Scheme::XYZ);
+}
+
+} // namespace
+
+// Deletes a region of a thousand tiles from a database holding state.range(0) tiles of other
+// regions, evicting the tiles it leaves unused, as without room for an ambient cache.
+static void Storage_OfflineDatabase_deleteRegion(::benchmark::State& state) {
+    OfflineDatabase db(":memory:", 0);
+    db.setWriteBatching(Duration::max(), 10000);
+
+    const OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, 16, 1.0 };
+    Response response;
+    response.data = std::make_shared<std::string>(256, 'x');
+
+    const OfflineRegion other = db.createRegion(definition, {});
+    for (int64_t i = 0; i < state.range(0); i++) {
+        db.putRegionResource(other.getID(), tile(i), response);
+    }
+    db.flush();
+
+    int64_t next = state.range(0);
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        OfflineRegion region = db.createRegion(definition, {});
+        for (int64_t i = 0; i < 1000; i++) {
+            db.putRegionResource(region.getID(), tile(next++), response);
+        }
+        db.flush();
+        state.ResumeTiming();
+
+        db.deleteRegion(std::move(region));
+    }
+}
+
+BENCHMARK(Storage_OfflineDatabase_deleteRegion)->Arg(10000)->Arg(100000)->Arg(1000000);
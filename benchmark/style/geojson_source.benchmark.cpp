@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+
+#include <random>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+FeatureCollection randomPoints(std::size_t count) {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> lon(-180, 180);
+    std::uniform_real_distribution<double> lat(-85, 85);
+
+    FeatureCollection features;
+    features.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        features.push_back(Feature { mapbox::geometry::point<double>(lon(generator), lat(generator)) });
+    }
+    return features;
+}
+
+void buildIndex(::benchmark::State& state, bool cluster, Scheduler* scheduler = nullptr) {
+    const GeoJSON geoJSON { randomPoints(state.range(0)) };
+    GeoJSONOptions options;
+    options.cluster = cluster;
+
+    while (state.KeepRunning()) {
+        auto data = GeoJSONData::create(geoJSON, options, scheduler);
+        benchmark::DoNotOptimize(data);
+    }
+}
+
+} // namespace
+
+// Builds the cluster index of the points, one kdbush index per zoom level.
+static void GeoJSON_buildClusters(::benchmark::State& state) {
+    buildIndex(state, true);
+}
+
+// Builds the same index with the neighbour searches of each zoom level spread across 4 threads.
+static void GeoJSON_buildClustersParallel(::benchmark::State& state) {
+    ThreadPool threadPool { 4 };
+    buildIndex(state, true, &threadPool);
+}
+
+static void GeoJSON_buildTiles(::benchmark::State& state) {
+    buildIndex(state, false);
+}
+
+BENCHMARK(GeoJSON_buildClusters)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK(GeoJSON_buildClustersParallel)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK(GeoJSON_buildTiles)->Arg(10000)->Arg(100000)->Arg(1000000);
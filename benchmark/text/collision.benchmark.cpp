@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wshadow"
+#ifdef __clang__
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#endif
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wdeprecated-register"
+#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
+#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+#ifndef __clang__
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wmisleading-indentation"
+#endif
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#pragma GCC diagnostic pop
+
+using namespace mbgl;
+
+namespace {
+
+namespace bg = boost::geometry;
+namespace bgi = bg::index;
+using RTreePoint = bg::model::point<float, 2, bg::cs::cartesian>;
+using RTreeBox = bg::model::box<RTreePoint>;
+using RTree = bgi::rtree<std::pair<RTreeBox, std::size_t>, bgi::linear<16, 4>>;
+
+// Label sized boxes around every vertex of the named features of a tile, in the order
+// SymbolLayout would place them.
+std::vector<CollisionGrid::Bounds> labelBounds(const std::string& path) {
+    std::vector<CollisionGrid::Bounds> result;
+
+    VectorTileData tile(std::make_shared<std::string>(util::read_file(path)));
+    for (const auto& name : tile.layerNames()) {
+        auto layer = tile.getLayer(name);
+        if (!layer) {
+            continue;
+        }
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            auto label = feature->getValue("name");
+            if (!label || !label->is<std::string>()) {
+                continue;
+            }
+
+            // 16 tile units per pixel; about 7 pixels per character and 16 pixels per line.
+            const float halfWidth = label->get<std::string>().size() * 7 * 16 / 2.0f;
+            const float halfHeight = 8 * 16;
+            for (const auto& geometry : feature->getGeometries()) {
+                for (const auto& point : geometry) {
+                    result.push_back({ point.x - halfWidth, point.y - halfHeight,
+                                       point.x + halfWidth, point.y + halfHeight });
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+const std::vector<std::string> tiles {
+    "test/fixtures/api/assets/streets/0-0-0.vector.pbf",
+    "test/fixtures/api/assets/streets/10-163-395.vector.pbf",
+};
+
+} // namespace
+
+// Greedily places every box that doesn't intersect one placed before it.
+static void Collision_Grid(benchmark::State& state) {
+    const auto bounds = labelBounds(tiles[state.range(0)]);
+    const CollisionBox box({ 0, 0 }, { 0, 0 }, 0, 0, 0, 0, 1);
+
+    while (state.KeepRunning()) {
+        CollisionGrid grid(util::EXTENT, 16, 16);
+        const std::size_t feature = grid.addFeature(IndexedSubfeature { 0, 0, 0, 0 });
+        for (const auto& b : bounds) {
+            bool collides = false;
+            grid.query(b, [&] (std::size_t) {
+                collides = true;
+                return false;
+            });
+            if (!collides) {
+                grid.insert(b, box, feature);
+            }
+        }
+        benchmark::DoNotOptimize(grid.size());
+    }
+}
+
+static void Collision_RTree(benchmark::State& state) {
+    const auto bounds = labelBounds(tiles[state.range(0)]);
+
+    while (state.KeepRunning()) {
+        RTree tree;
+        for (std::size_t i = 0; i < bounds.size(); ++i) {
+            const RTreeBox b { { bounds[i].x1, bounds[i].y1 }, { bounds[i].x2, bounds[i].y2 } };
+            if (tree.qbegin(bgi::intersects(b)) == tree.qend()) {
+                tree.insert(std::make_pair(b, i));
+            }
+        }
+        benchmark::DoNotOptimize(tree.size());
+    }
+}
+
+BENCHMARK(Collision_Grid)->Arg(0)->Arg(1);
+BENCHMARK(Collision_RTree)->Arg(0)->Arg(1);
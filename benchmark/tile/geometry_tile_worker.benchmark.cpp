@@ -0,0 +1,215 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/map/transform_state.hpp>
+#include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/sprite/sprite_parser.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/style/style_impl.hpp>
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/tile_observer.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const char* cachePath = "benchmark/fixtures/api/cache.db";
+const char* tileURL = "mapbox://tiles/mapbox.mapbox-terrain-v2,mapbox.mapbox-streets-v7/{z}/{x}/{y}.vector.pbf";
+
+double cpuTime(clockid_t clock) {
+    timespec value;
+    clock_gettime(clock, &value);
+    return value.tv_sec + value.tv_nsec / 1e9;
+}
+
+// Forwards to a pool, adding up the time that scheduling mailboxes takes on all threads. That's
+// mostly the time spent waiting for the pool's locks once several threads contend for them.
+class TimedScheduler : public Scheduler {
+public:
+    explicit TimedScheduler(std::unique_ptr<Scheduler> pool_)
+        : pool(std::move(pool_)) {
+    }
+
+    void schedule(std::weak_ptr<Mailbox> mailbox) override {
+        const TimePoint start = Clock::now();
+        pool->schedule(std::move(mailbox));
+        scheduling += (Clock::now() - start).count();
+    }
+
+    std::size_t getQueueDepth() const override {
+        return pool->getQueueDepth();
+    }
+
+    std::unique_ptr<Scheduler> pool;
+    std::atomic<Duration::rep> scheduling { 0 };
+};
+
+class RecordedTile : public GeometryTile {
+public:
+    using GeometryTile::GeometryTile;
+    void setNecessity(Necessity) final {}
+};
+
+// Lays out the tiles of the offline cache, the 30 tiles of Manhattan at zoom level 15 that the
+// render benchmarks use, with the layers, glyphs and sprite of its style.
+class LayoutBenchmark : public TileObserver {
+public:
+    LayoutBenchmark() {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+
+        style.loadJSON(util::read_file("benchmark/fixtures/api/style.json"));
+        layers = style.impl->getLayerImpls();
+        glyphManager.setURL(style.impl->getGlyphURL());
+
+        OfflineDatabase database(cachePath, OfflineDatabase::ReadOnly {});
+        auto spriteImage = database.get(Resource::spriteImage("mapbox://sprites/mapbox/streets-v10", 1));
+        auto spriteJSON = database.get(Resource::spriteJSON("mapbox://sprites/mapbox/streets-v10", 1));
+        if (spriteImage && spriteImage->data && spriteJSON && spriteJSON->data) {
+            for (auto& image : parseSprite(*spriteImage->data, *spriteJSON->data)) {
+                imageManager.addImage(image->baseImpl);
+            }
+        }
+        imageManager.setLoaded(true);
+
+        for (uint32_t x = 9646; x <= 9651; x++) {
+            for (uint32_t y = 12316; y <= 12320; y++) {
+                auto response = database.get(Resource::tile(tileURL, 1, x, y, 15, Tileset::Scheme::XYZ));
+                if (response && response->data) {
+                    tiles.emplace_back(OverscaledTileID { 15, x, y }, response->data);
+                }
+            }
+        }
+    }
+
+    void layout(const TileParameters& parameters) {
+        std::vector<std::unique_ptr<RecordedTile>> laidOut;
+        completed.clear();
+
+        for (const auto& tile : tiles) {
+            laidOut.push_back(std::make_unique<RecordedTile>(tile.first, "composite", parameters));
+            laidOut.back()->setObserver(this);
+            laidOut.back()->setPlacementConfig({});
+            laidOut.back()->setLayers(*layers);
+            laidOut.back()->setData(std::make_unique<VectorTileData>(tile.second));
+        }
+
+        while (completed.size() < laidOut.size()) {
+            loop.runOnce();
+        }
+    }
+
+    void onTileChanged(Tile& tile) final {
+        if (tile.isComplete()) {
+            completed.insert(&tile);
+        }
+    }
+
+    void onTileError(Tile& tile, std::exception_ptr) final {
+        completed.insert(&tile);
+    }
+
+    util::RunLoop loop;
+    DefaultFileSource fileSource { cachePath, "." };
+    style::Style style { loop, fileSource, 1 };
+    TransformState transformState;
+    AnnotationManager annotationManager { style };
+    ImageManager imageManager;
+    GlyphManager glyphManager { fileSource };
+
+    Immutable<std::vector<Immutable<style::Layer::Impl>>> layers =
+        makeMutable<std::vector<Immutable<style::Layer::Impl>>>();
+    std::vector<std::pair<OverscaledTileID, std::shared_ptr<const std::string>>> tiles;
+    std::unordered_set<Tile*> completed;
+};
+
+} // end namespace
+
+// Lays out the tiles with state.range(0) workers, of a ThreadPool if state.range(1) is 0, or of a
+// WorkStealingThreadPool otherwise. Besides tiles per second, reports the time spent scheduling
+// mailboxes per tile, and the share of the time the workers were idle, out of their CPU time.
+static void Tile_GeometryTileWorker_scaling(::benchmark::State& state) {
+    LayoutBenchmark bench;
+
+    const auto threads = std::size_t(state.range(0));
+    TimedScheduler scheduler { state.range(1)
+        ? std::unique_ptr<Scheduler>(std::make_unique<WorkStealingThreadPool>(threads))
+        : std::unique_ptr<Scheduler>(std::make_unique<ThreadPool>(threads)) };
+
+    const TileParameters parameters {
+        1.0,
+        MapDebugOptions(),
+        bench.transformState,
+        scheduler,
+        bench.fileSource,
+        MapMode::Continuous,
+        bench.annotationManager,
+        bench.imageManager,
+        bench.glyphManager,
+        0,
+        0,
+        {}
+    };
+
+    // Loads the glyphs, so that they don't count towards the first iteration.
+    bench.layout(parameters);
+    scheduler.scheduling = 0;
+
+    const TimePoint start = Clock::now();
+    const double workerStart = cpuTime(CLOCK_PROCESS_CPUTIME_ID) - cpuTime(CLOCK_THREAD_CPUTIME_ID);
+
+    while (state.KeepRunning()) {
+        bench.layout(parameters);
+    }
+
+    // The CPU time of all threads but this one, most of which is that of the workers.
+    const double workerTime = cpuTime(CLOCK_PROCESS_CPUTIME_ID) - cpuTime(CLOCK_THREAD_CPUTIME_ID) - workerStart;
+    const double wallTime = std::chrono::duration<double>(Clock::now() - start).count();
+    const auto laidOut = state.iterations() * bench.tiles.size();
+    state.SetItemsProcessed(laidOut);
+
+    const double idle = std::max(0.0, 1 - workerTime / (wallTime * threads));
+    const double scheduling = std::chrono::duration<double, std::micro>(Duration(scheduler.scheduling)).count();
+
+    char label[128];
+    std::snprintf(label, sizeof(label), "%s, scheduling %.1f us per tile, workers idle %.0f%%",
+                  state.range(1) ? "work stealing" : "shared queue",
+                  laidOut ? scheduling / laidOut : 0, idle * 100);
+    state.SetLabel(label);
+}
+
+static void threadCounts(::benchmark::internal::Benchmark* benchmark) {
+    const int cores = std::max(1, int(std::thread::hardware_concurrency()));
+    for (int pool = 0; pool <= 1; pool++) {
+        for (int threads = 1; threads < cores; threads *= 2) {
+            benchmark->Args({ threads, pool });
+        }
+        benchmark->Args({ cores, pool });
+    }
+}
+
+BENCHMARK(Tile_GeometryTileWorker_scaling)->Apply(threadCounts)->UseRealTime();
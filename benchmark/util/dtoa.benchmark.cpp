@@ -45,6 +45,53 @@ static void Util_standardDtoa(::benchmark::State& state) {
     }
 }
 
+static void Util_dtoaBuffer(::benchmark::State& state) {
+    char buffer[util::dtoaBufferSize];
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(util::dtoa(0., buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_E, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_LOG2E, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_LOG10E, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_LN2, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_LN10, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_PI, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_PI_2, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_PI_4, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_1_PI, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_2_PI, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_2_SQRTPI, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_SQRT2, buffer));
+        ::benchmark::DoNotOptimize(util::dtoa(M_SQRT1_2, buffer));
+    }
+}
+
+// Short numbers, as in feature properties and colors, fit into a string without allocating.
+static void Util_dtoaShort(::benchmark::State& state) {
+    while (state.KeepRunning()) {
+        util::dtoa(1.);
+        util::dtoa(42.);
+        util::dtoa(0.5);
+        util::dtoa(255.);
+        util::dtoa(-122.4194);
+        util::dtoa(37.7749);
+        util::dtoa(1024.25);
+        util::dtoa(1e21);
+    }
+}
+
+static void Util_standardDtoaShort(::benchmark::State& state) {
+    while (state.KeepRunning()) {
+        std::to_string(1.);
+        std::to_string(42.);
+        std::to_string(0.5);
+        std::to_string(255.);
+        std::to_string(-122.4194);
+        std::to_string(37.7749);
+        std::to_string(1024.25);
+        std::to_string(1e21);
+    }
+}
+
 static void Util_dtoaLimits(::benchmark::State& state) {
     while (state.KeepRunning()) {
         util::dtoa(DBL_MIN);
@@ -60,7 +107,11 @@ static void Util_standardDtoaLimits(::benchmark::State& state) {
 }
 
 BENCHMARK(Util_dtoa);
+BENCHMARK(Util_dtoaBuffer);
 BENCHMARK(Util_standardDtoa);
 
+BENCHMARK(Util_dtoaShort);
+BENCHMARK(Util_standardDtoaShort);
+
 BENCHMARK(Util_dtoaLimits);
 BENCHMARK(Util_standardDtoaLimits);
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/transform.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+TransformState pitchedState() {
+    Transform transform;
+    transform.resize({ 1024, 768 });
+    transform.setLatLngZoom({ 37.7749, -122.4194 }, 14.5);
+    transform.setPitch(60.0 * util::DEG2RAD);
+    transform.setAngle(30.0 * util::DEG2RAD);
+    return transform.getState();
+}
+
+} // namespace
+
+static void Util_mat4Multiply(::benchmark::State& state) {
+    mat4 a, b, out;
+    pitchedState().getProjMatrix(a);
+    matrix::identity(b);
+    matrix::translate(b, b, 100, 200, 0);
+
+    while (state.KeepRunning()) {
+        matrix::multiply(out, a, b);
+        ::benchmark::DoNotOptimize(out);
+    }
+}
+
+static void Util_mat4Invert(::benchmark::State& state) {
+    mat4 a, b;
+    pitchedState().getProjMatrix(a);
+
+    while (state.KeepRunning()) {
+        matrix::invert(b, a);
+        ::benchmark::DoNotOptimize(b);
+    }
+}
+
+// The matrix of every tile is computed once per frame, for the regular and the near-clipped
+// projection.
+static void Util_tileMatrixMultiplied(::benchmark::State& state) {
+    const TransformState transformState = pitchedState();
+    mat4 projMatrix, matrix;
+    transformState.getProjMatrix(projMatrix);
+    const UnwrappedTileID id { 14, 2620, 6332 };
+
+    while (state.KeepRunning()) {
+        transformState.matrixFor(matrix, id);
+        matrix::multiply(matrix, projMatrix, matrix);
+        ::benchmark::DoNotOptimize(matrix);
+    }
+}
+
+static void Util_tileMatrixProjected(::benchmark::State& state) {
+    const TransformState transformState = pitchedState();
+    mat4 projMatrix, matrix;
+    transformState.getProjMatrix(projMatrix);
+    const UnwrappedTileID id { 14, 2620, 6332 };
+
+    while (state.KeepRunning()) {
+        transformState.matrixFor(matrix, id, projMatrix);
+        ::benchmark::DoNotOptimize(matrix);
+    }
+}
+
+BENCHMARK(Util_mat4Multiply);
+BENCHMARK(Util_mat4Invert);
+
+BENCHMARK(Util_tileMatrixMultiplied);
+BENCHMARK(Util_tileMatrixProjected);
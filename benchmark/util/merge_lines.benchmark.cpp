@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/layout/merge_lines.hpp>
+#include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/utf.hpp>
+
+using namespace mbgl;
+
+// Merges the named roads of a tile, the way line labels of a road layer are laid out.
+static void Util_mergeLines(::benchmark::State& state) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    VectorTileData tile(data);
+    auto layer = tile.getLayer("road");
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        std::vector<SymbolFeature> features;
+        for (std::size_t i = 0; layer && i < layer->featureCount(); i++) {
+            SymbolFeature feature(layer->getFeature(i));
+            if (feature.getType() != FeatureType::LineString) {
+                continue;
+            }
+            if (auto name = feature.getValue("name")) {
+                if (name->is<std::string>()) {
+                    feature.text = util::utf8_to_utf16::convert(name->get<std::string>());
+                }
+            }
+            features.push_back(std::move(feature));
+        }
+        state.ResumeTiming();
+
+        util::mergeLines(features);
+        benchmark::DoNotOptimize(features);
+    }
+}
+
+BENCHMARK(Util_mergeLines);
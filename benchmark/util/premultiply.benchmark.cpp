@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/premultiply.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+UnassociatedImage makeImage() {
+    UnassociatedImage image({ 1024, 1024 });
+    for (std::size_t i = 0; i < image.bytes(); i++) {
+        image.data[i] = uint8_t(i * 7919);
+    }
+    return image;
+}
+
+} // namespace
+
+static void Util_premultiply(::benchmark::State& state) {
+    UnassociatedImage image = makeImage();
+
+    while (state.KeepRunning()) {
+        util::premultiply(image.data.get(), image.bytes());
+        benchmark::DoNotOptimize(image.data.get());
+    }
+}
+
+static void Util_unpremultiply(::benchmark::State& state) {
+    UnassociatedImage image = makeImage();
+    std::unique_ptr<uint8_t[]> result(new uint8_t[image.bytes()]);
+
+    while (state.KeepRunning()) {
+        util::unpremultiply(image.data.get(), result.get(), image.bytes());
+        benchmark::DoNotOptimize(result.get());
+    }
+}
+
+BENCHMARK(Util_premultiply);
+BENCHMARK(Util_unpremultiply);
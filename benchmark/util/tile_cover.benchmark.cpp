@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/transform.hpp>
+#include <mbgl/util/tile_cover.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A pitched viewport at zoom 15, as on a high resolution screen.
+void setUp(Transform& transform) {
+    transform.resize({ 2048, 1536 });
+    transform.setLatLngZoom({ 40.7, -74.0 }, 15.3);
+    transform.setAngle(0.4);
+    transform.setPitch(45.0 * M_PI / 180.0);
+}
+
+} // namespace
+
+// Pans by a few pixels per frame, as during a slow drag, which mostly keeps the cover.
+static void Util_tileCover_pan(::benchmark::State& state) {
+    Transform transform;
+    setUp(transform);
+    size_t i = 0;
+
+    while (state.KeepRunning()) {
+        transform.moveBy({ (i++ % 20) < 10 ? 2.0 : -2.0, 1.0 });
+        benchmark::DoNotOptimize(util::tileCover(transform.getState(), 15));
+    }
+}
+
+static void Util_tileCover_pan_incremental(::benchmark::State& state) {
+    Transform transform;
+    setUp(transform);
+    util::TileCover cover;
+    size_t i = 0;
+
+    while (state.KeepRunning()) {
+        transform.moveBy({ (i++ % 20) < 10 ? 2.0 : -2.0, 1.0 });
+        benchmark::DoNotOptimize(cover.update(transform.getState(), 15));
+    }
+}
+
+BENCHMARK(Util_tileCover_pan);
+BENCHMARK(Util_tileCover_pan_incremental);
@@ -3,11 +3,14 @@
 #include <mbgl/util/string.hpp>
 
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
 
 #include <cstdlib>
 #include <iostream>
 #include <csignal>
 #include <atomic>
+#include <unordered_map>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunknown-pragmas"
@@ -24,6 +27,9 @@ int main(int argc, char *argv[]) {
     double north = 37.2, west = -122.8, south = 38.1, east = -121.7; // Bay area
     double minZoom = 0.0, maxZoom = 15.0, pixelRatio = 1.0;
     std::string output = "offline.db";
+    std::vector<std::string> archives;
+    uint16_t archiveTileSize = 512;
+    bool archiveRaster = false;
 
     const char* tokenEnv = getenv("MAPBOX_ACCESS_TOKEN");
     std::string token = tokenEnv ? tokenEnv : std::string();
@@ -40,6 +46,12 @@ int main(int argc, char *argv[]) {
         ("pixelRatio", po::value(&pixelRatio)->value_name("number")->default_value(pixelRatio), "Pixel ratio")
         ("token,t", po::value(&token)->value_name("key")->default_value(token), "Mapbox access token")
         ("output,o", po::value(&output)->value_name("file")->default_value(output), "Output database file name")
+        ("archive", po::value(&archives)->value_name("template=path")->composing(),
+            "Store the region's tiles of the tileset with the given URL template, as the style's "
+            "sources request them, from a local MBTiles file or tile pack, or from file://{z}/{x}/{y} "
+            "URLs, before downloading what's missing")
+        ("archiveTileSize", po::value(&archiveTileSize)->value_name("pixels")->default_value(archiveTileSize), "Tile size of the archived tilesets")
+        ("archiveRaster", po::bool_switch(&archiveRaster)->default_value(archiveRaster), "Archived tilesets are raster tilesets")
     ;
 
     try {
@@ -113,6 +125,158 @@ int main(int argc, char *argv[]) {
         Timestamp start;
     };
 
+    // Reads the tiles of the region from local archives and stores them in large batches, so
+    // that the download only fetches what the archives are missing.
+    class Ingestion {
+    public:
+        struct Archive {
+            std::string urlTemplate;
+            std::string localTemplate;
+            std::vector<CanonicalTileID> tiles;
+        };
+
+        Ingestion(DefaultFileSource& fileSource_, util::RunLoop& loop_, const OfflineRegion& region_,
+                  float pixelRatio_, std::vector<Archive> archives_, std::function<void ()> done_)
+            : fileSource(fileSource_),
+              loop(loop_),
+              region(region_),
+              pixelRatio(pixelRatio_),
+              archives(std::move(archives_)),
+              done(std::move(done_)),
+              start(util::now()) {
+        }
+
+        void run() {
+            requestTiles();
+            finishIfDone();
+        }
+
+    private:
+        void requestTiles() {
+            while (requests.size() < maximumRequests && puts < maximumPuts && archiveIndex < archives.size()) {
+                const Archive& archive = archives[archiveIndex];
+                if (tileIndex == archive.tiles.size()) {
+                    archiveIndex++;
+                    tileIndex = 0;
+                    continue;
+                }
+
+                const CanonicalTileID& tile = archive.tiles[tileIndex++];
+                Resource resource = Resource::tile(archive.urlTemplate, pixelRatio, tile.x, tile.y, tile.z, Tileset::Scheme::XYZ);
+                const Resource local = Resource::tile(archive.localTemplate, pixelRatio, tile.x, tile.y, tile.z, Tileset::Scheme::XYZ);
+
+                const uint64_t id = nextRequestID++;
+                requests.emplace(id, fileSource.request(local, [this, id, resource] (Response response) {
+                    // Erasing the request destroys this callback.
+                    Resource stored = resource;
+                    requests.erase(id);
+                    tileResponse(std::move(stored), std::move(response));
+                }));
+            }
+        }
+
+        void tileResponse(Resource resource, Response response) {
+            if (response.error) {
+                if (response.error->reason != Response::Error::Reason::NotFound) {
+                    std::cerr << "Error reading " << resource.url << ": " << response.error->message << std::endl;
+                }
+                missing++;
+            } else if (response.noContent || !response.data) {
+                missing++;
+            } else {
+                batch.emplace_back(std::move(resource), std::move(response));
+            }
+
+            if (batch.size() >= batchSize) {
+                putBatch();
+            }
+            requestTiles();
+            finishIfDone();
+        }
+
+        void putBatch() {
+            if (batch.empty()) {
+                return;
+            }
+
+            const std::size_t count = batch.size();
+            puts++;
+            fileSource.putOfflineRegionResources(region, std::move(batch), [this, count] (std::exception_ptr error) {
+                loop.invoke([this, count, error] {
+                    puts--;
+                    if (error) {
+                        std::cerr << "Error storing tiles: " << util::toString(error) << std::endl;
+                        exit(1);
+                    }
+
+                    stored += count;
+                    const auto elapsedSeconds = (util::now() - start) / 1s;
+                    std::cout << stored << " tiles stored from archives ("
+                              << (elapsedSeconds ? util::toString(stored / elapsedSeconds) : std::string("-"))
+                              << " tiles/sec)" << std::endl;
+
+                    requestTiles();
+                    finishIfDone();
+                });
+            });
+            batch = {};
+        }
+
+        void finishIfDone() {
+            if (finished || archiveIndex < archives.size() || !requests.empty()) {
+                return;
+            }
+
+            putBatch();
+            if (puts == 0) {
+                finished = true;
+                std::cout << stored << " tiles stored from archives, " << missing << " not in them" << std::endl;
+                done();
+            }
+        }
+
+        // Keeps enough tiles in flight to fill the next batch while the last one is stored.
+        const std::size_t batchSize = 4096;
+        const std::size_t maximumRequests = 1024;
+        const std::size_t maximumPuts = 2;
+
+        DefaultFileSource& fileSource;
+        util::RunLoop& loop;
+        const OfflineRegion& region;
+        const float pixelRatio;
+        const std::vector<Archive> archives;
+        const std::function<void ()> done;
+        const Timestamp start;
+
+        std::size_t archiveIndex = 0;
+        std::size_t tileIndex = 0;
+        uint64_t nextRequestID = 0;
+        std::unordered_map<uint64_t, std::unique_ptr<AsyncRequest>> requests;
+        std::vector<std::pair<Resource, Response>> batch;
+        std::size_t puts = 0;
+        uint64_t stored = 0;
+        uint64_t missing = 0;
+        bool finished = false;
+    };
+
+    std::vector<Ingestion::Archive> ingestionArchives;
+    for (const auto& archive : archives) {
+        const std::size_t separator = archive.rfind('=');
+        if (separator == std::string::npos || separator == 0 || separator + 1 == archive.size()) {
+            std::cout << "Error: Invalid archive " << archive << ", expected template=path" << std::endl << desc;
+            exit(1);
+        }
+
+        Ingestion::Archive ingestionArchive;
+        ingestionArchive.urlTemplate = archive.substr(0, separator);
+        const std::string path = archive.substr(separator + 1);
+        ingestionArchive.localTemplate = path.compare(0, 7, "file://") == 0 ? path : "pack://" + path + "?z={z}&x={x}&y={y}";
+        ingestionArchive.tiles = definition.tileCover(archiveRaster ? SourceType::Raster : SourceType::Vector,
+                                                      archiveTileSize, Tileset().zoomRange);
+        ingestionArchives.push_back(std::move(ingestionArchive));
+    }
+    std::unique_ptr<Ingestion> ingestion;
+
     static auto stop = [&] {
         if (region) {
             std::cout << "Stopping download... ";
@@ -130,8 +294,19 @@ int main(int argc, char *argv[]) {
         } else {
             assert(region_);
             region = std::make_unique<OfflineRegion>(std::move(*region_));
-            fileSource.setOfflineRegionObserver(*region, std::make_unique<Observer>(*region, fileSource, loop));
-            fileSource.setOfflineRegionDownloadState(*region, OfflineRegionDownloadState::Active);
+            loop.invoke([&] {
+                auto download = [&] {
+                    fileSource.setOfflineRegionObserver(*region, std::make_unique<Observer>(*region, fileSource, loop));
+                    fileSource.setOfflineRegionDownloadState(*region, OfflineRegionDownloadState::Active);
+                };
+
+                if (ingestionArchives.empty()) {
+                    download();
+                } else {
+                    ingestion = std::make_unique<Ingestion>(fileSource, loop, *region, pixelRatio, std::move(ingestionArchives), download);
+                    ingestion->run();
+                }
+            });
         }
     });
 
@@ -1,8 +1,10 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 #include <mbgl/gl/headless_frontend.hpp>
+#include <mbgl/renderer/renderer.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/style/style.hpp>
@@ -16,9 +18,11 @@
 
 namespace po = boost::program_options;
 
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 int main(int argc, char *argv[]) {
     std::string style_path;
@@ -34,7 +38,9 @@ int main(int argc, char *argv[]) {
     std::string cache_file = "cache.sqlite";
     std::string asset_root = ".";
     std::string token;
+    std::string batch;
     bool debug = false;
+    bool profile = false;
 
     po::options_description desc("Allowed options");
     desc.add_options()
@@ -49,9 +55,12 @@ int main(int argc, char *argv[]) {
         ("ratio,r", po::value(&pixelRatio)->value_name("number")->default_value(pixelRatio), "Image scale factor")
         ("token,t", po::value(&token)->value_name("key")->default_value(token), "Mapbox access token")
         ("debug", po::bool_switch(&debug)->default_value(debug), "Debug mode")
+        ("profile", po::bool_switch(&profile)->default_value(profile), "Print the layout cost of each layer")
         ("output,o", po::value(&output)->value_name("file")->default_value(output), "Output file name")
         ("cache,d", po::value(&cache_file)->value_name("file")->default_value(cache_file), "Cache database file name")
         ("assets,d", po::value(&asset_root)->value_name("file")->default_value(asset_root), "Directory to which asset:// URLs will resolve")
+        ("batch", po::value(&batch)->value_name("file"), "Render the images listed in a file, or - for stdin, one per line as "
+                                                          "\"lon lat zoom bearing pitch width height output\"")
     ;
 
     try {
@@ -98,13 +107,114 @@ int main(int argc, char *argv[]) {
         map.setDebug(debug ? mbgl::MapDebugOptions::TileBorders | mbgl::MapDebugOptions::ParseStatus : mbgl::MapDebugOptions::NoDebug);
     }
 
-    try {
-        std::ofstream out(output, std::ios::binary);
-        out << encodePNG(frontend.render(map));
-        out.close();
-    } catch(std::exception& e) {
-        std::cout << "Error: " << e.what() << std::endl;
-        exit(1);
+    if (profile) {
+        frontend.getRenderer()->setLayoutProfilingEnabled(true);
+    }
+
+    if (!batch.empty()) {
+        // All images are rendered by the same map, so the style, the shaders and the tiles
+        // that are shared between images are only loaded once. Each image is read back while
+        // the next one is rendered.
+        std::ifstream batchFile;
+        if (batch != "-") {
+            batchFile.open(batch);
+            if (!batchFile) {
+                std::cout << "Error: Couldn't open " << batch << std::endl;
+                exit(1);
+            }
+        }
+        std::istream& jobs = batch == "-" ? std::cin : batchFile;
+
+        std::size_t rendered = 0;
+        std::size_t failed = 0;
+        optional<std::string> pendingOutput;
+
+        const auto writePending = [&] {
+            if (!pendingOutput) {
+                return;
+            }
+            std::ofstream out(*pendingOutput, std::ios::binary);
+            out << encodePNG(frontend.readStillImage());
+            if (out) {
+                rendered++;
+            } else {
+                std::cout << "Error: Couldn't write " << *pendingOutput << std::endl;
+                failed++;
+            }
+            pendingOutput = {};
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::string line;
+        for (std::size_t number = 1; std::getline(jobs, line); number++) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            std::istringstream job(line);
+            double jobLon, jobLat, jobZoom, jobBearing, jobPitch;
+            uint32_t jobWidth, jobHeight;
+            std::string jobOutput;
+            if (!(job >> jobLon >> jobLat >> jobZoom >> jobBearing >> jobPitch >> jobWidth >> jobHeight >> jobOutput) ||
+                jobWidth == 0 || jobHeight == 0) {
+                std::cout << "Error: Invalid job on line " << number << ": " << line << std::endl;
+                failed++;
+                continue;
+            }
+
+            const Size jobSize { jobWidth, jobHeight };
+            frontend.setSize(jobSize);
+            map.setSize(jobSize);
+            map.setLatLngZoom({ jobLat, jobLon }, jobZoom);
+            map.setBearing(jobBearing);
+            map.setPitch(jobPitch);
+
+            try {
+                frontend.renderAndStartReadback(map);
+            } catch(std::exception& e) {
+                std::cout << "Error: " << jobOutput << ": " << e.what() << std::endl;
+                failed++;
+                continue;
+            }
+
+            writePending();
+            pendingOutput = jobOutput;
+        }
+        writePending();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Rendered " << rendered << " images in " << seconds << " s ("
+                  << (seconds > 0 ? rendered / seconds : 0) << " images/s)";
+        if (failed) {
+            std::cout << ", " << failed << " failed";
+        }
+        std::cout << std::endl;
+
+        if (failed) {
+            exit(1);
+        }
+    } else {
+        try {
+            std::ofstream out(output, std::ios::binary);
+            out << encodePNG(frontend.render(map));
+            out.close();
+        } catch(std::exception& e) {
+            std::cout << "Error: " << e.what() << std::endl;
+            exit(1);
+        }
+    }
+
+    if (profile) {
+        const auto ms = [] (Duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        std::cout << "layer\tzoom\ttiles\tlayout ms\tplacement ms\tfeatures\tvertices\tbytes" << std::endl;
+        for (const auto& layer : frontend.getRenderer()->getStatistics().layout) {
+            std::cout << layer.layer << '\t' << int(layer.zoom) << '\t' << layer.tiles << '\t'
+                      << ms(layer.layoutTime) << '\t' << ms(layer.placementTime) << '\t'
+                      << layer.features << '\t' << layer.vertices << '\t' << layer.bytes << std::endl;
+        }
     }
 
     return 0;
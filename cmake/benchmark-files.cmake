@@ -2,6 +2,7 @@
 
 set(MBGL_BENCHMARK_FILES
     # api
+    benchmark/api/camera_path.benchmark.cpp
     benchmark/api/query.benchmark.cpp
     benchmark/api/render.benchmark.cpp
 
@@ -10,6 +11,7 @@ set(MBGL_BENCHMARK_FILES
 
     # parse
     benchmark/parse/filter.benchmark.cpp
+    benchmark/parse/style.benchmark.cpp
     benchmark/parse/tile_mask.benchmark.cpp
     benchmark/parse/vector_tile.benchmark.cpp
 
@@ -19,6 +21,23 @@ set(MBGL_BENCHMARK_FILES
     # src/mbgl/benchmark
     benchmark/src/mbgl/benchmark/benchmark.cpp
 
+    # storage
+    benchmark/storage/offline_database.benchmark.cpp
+
+    # style
+    benchmark/style/geojson_source.benchmark.cpp
+
+    # text
+    benchmark/text/collision.benchmark.cpp
+
+    # tile
+    benchmark/tile/geometry_tile_worker.benchmark.cpp
+
     # util
     benchmark/util/dtoa.benchmark.cpp
+    benchmark/util/image.benchmark.cpp
+    benchmark/util/mat4.benchmark.cpp
+    benchmark/util/merge_lines.benchmark.cpp
+    benchmark/util/premultiply.benchmark.cpp
+    benchmark/util/tile_cover.benchmark.cpp
 )
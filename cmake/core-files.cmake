@@ -43,14 +43,21 @@ set(MBGL_CORE_FILES
     # geometry
     src/mbgl/geometry/anchor.hpp
     src/mbgl/geometry/debug_font_data.hpp
+    src/mbgl/geometry/dem_data.cpp
+    src/mbgl/geometry/dem_data.hpp
     src/mbgl/geometry/feature_index.cpp
     src/mbgl/geometry/feature_index.hpp
     src/mbgl/geometry/line_atlas.cpp
     src/mbgl/geometry/line_atlas.hpp
+    src/mbgl/geometry/tessellation.cpp
+    src/mbgl/geometry/tessellation.hpp
 
     # gl
     src/mbgl/gl/attribute.cpp
     src/mbgl/gl/attribute.hpp
+    src/mbgl/gl/buffer_arena.cpp
+    src/mbgl/gl/buffer_arena.hpp
+    src/mbgl/gl/buffer_mapping_extension.hpp
     src/mbgl/gl/color_mode.cpp
     src/mbgl/gl/color_mode.hpp
     src/mbgl/gl/context.cpp
@@ -64,12 +71,15 @@ set(MBGL_CORE_FILES
     src/mbgl/gl/draw_mode.hpp
     src/mbgl/gl/extension.hpp
     src/mbgl/gl/features.hpp
+    src/mbgl/gl/fence_sync_extension.hpp
     src/mbgl/gl/framebuffer.hpp
     src/mbgl/gl/gl.cpp
     src/mbgl/gl/gl.hpp
     src/mbgl/gl/index_buffer.hpp
+    src/mbgl/gl/instanced_arrays_extension.hpp
     src/mbgl/gl/object.cpp
     src/mbgl/gl/object.hpp
+    src/mbgl/gl/parallel_shader_compile_extension.hpp
     src/mbgl/gl/primitives.hpp
     src/mbgl/gl/program.hpp
     src/mbgl/gl/program_binary_extension.hpp
@@ -78,6 +88,7 @@ set(MBGL_CORE_FILES
     src/mbgl/gl/stencil_mode.cpp
     src/mbgl/gl/stencil_mode.hpp
     src/mbgl/gl/texture.hpp
+    src/mbgl/gl/timer_query_extension.hpp
     src/mbgl/gl/types.hpp
     src/mbgl/gl/uniform.cpp
     src/mbgl/gl/uniform.hpp
@@ -91,6 +102,8 @@ set(MBGL_CORE_FILES
     # layout
     src/mbgl/layout/clip_lines.cpp
     src/mbgl/layout/clip_lines.hpp
+    src/mbgl/layout/layout_profiler.cpp
+    src/mbgl/layout/layout_profiler.hpp
     src/mbgl/layout/merge_lines.cpp
     src/mbgl/layout/merge_lines.hpp
     src/mbgl/layout/symbol_feature.hpp
@@ -106,6 +119,7 @@ set(MBGL_CORE_FILES
     include/mbgl/map/change.hpp
     include/mbgl/map/map.hpp
     include/mbgl/map/map_observer.hpp
+    include/mbgl/map/missing_tile.hpp
     include/mbgl/map/mode.hpp
     src/mbgl/map/map.cpp
     src/mbgl/map/transform.cpp
@@ -141,6 +155,10 @@ set(MBGL_CORE_FILES
     src/mbgl/programs/fill_extrusion_program.hpp
     src/mbgl/programs/fill_program.cpp
     src/mbgl/programs/fill_program.hpp
+    src/mbgl/programs/heatmap_program.cpp
+    src/mbgl/programs/heatmap_program.hpp
+    src/mbgl/programs/hillshade_program.cpp
+    src/mbgl/programs/hillshade_program.hpp
     src/mbgl/programs/line_program.cpp
     src/mbgl/programs/line_program.hpp
     src/mbgl/programs/program.hpp
@@ -156,25 +174,41 @@ set(MBGL_CORE_FILES
 
     # renderer
     include/mbgl/renderer/backend_scope.hpp
+    include/mbgl/renderer/gpu_timings.hpp
     include/mbgl/renderer/query.hpp
     include/mbgl/renderer/renderer.hpp
     include/mbgl/renderer/renderer_backend.hpp
     include/mbgl/renderer/renderer_frontend.hpp
+    include/mbgl/renderer/renderer_statistics.hpp
+    include/mbgl/renderer/threaded_renderer_frontend.hpp
     src/mbgl/renderer/backend_scope.cpp
+    src/mbgl/renderer/bucket.cpp
     src/mbgl/renderer/bucket.hpp
     src/mbgl/renderer/bucket_parameters.cpp
     src/mbgl/renderer/bucket_parameters.hpp
+    src/mbgl/renderer/bucket_uploader.cpp
+    src/mbgl/renderer/bucket_uploader.hpp
     src/mbgl/renderer/cross_faded_property_evaluator.cpp
     src/mbgl/renderer/cross_faded_property_evaluator.hpp
+    src/mbgl/renderer/cross_tile_symbol_index.cpp
+    src/mbgl/renderer/cross_tile_symbol_index.hpp
     src/mbgl/renderer/data_driven_property_evaluator.hpp
+    src/mbgl/renderer/feature_state.cpp
+    src/mbgl/renderer/feature_state.hpp
     src/mbgl/renderer/frame_history.cpp
     src/mbgl/renderer/frame_history.hpp
+    src/mbgl/renderer/frame_timer.cpp
+    src/mbgl/renderer/frame_timer.hpp
+    src/mbgl/renderer/frame_timings.hpp
+    src/mbgl/renderer/gpu_timer.cpp
+    src/mbgl/renderer/gpu_timer.hpp
     src/mbgl/renderer/group_by_layout.cpp
     src/mbgl/renderer/group_by_layout.hpp
     src/mbgl/renderer/image_atlas.cpp
     src/mbgl/renderer/image_atlas.hpp
     src/mbgl/renderer/image_manager.cpp
     src/mbgl/renderer/image_manager.hpp
+    src/mbgl/renderer/image_manager_observer.hpp
     src/mbgl/renderer/paint_parameters.cpp
     src/mbgl/renderer/paint_parameters.hpp
     src/mbgl/renderer/paint_property_binder.hpp
@@ -205,14 +239,22 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/renderer_observer.hpp
     src/mbgl/renderer/style_diff.cpp
     src/mbgl/renderer/style_diff.hpp
+    src/mbgl/renderer/threaded_renderer_frontend.cpp
     src/mbgl/renderer/tile_mask.hpp
+    src/mbgl/renderer/tile_mask_cache.cpp
+    src/mbgl/renderer/tile_mask_cache.hpp
     src/mbgl/renderer/tile_parameters.hpp
     src/mbgl/renderer/tile_pyramid.cpp
     src/mbgl/renderer/tile_pyramid.hpp
+    src/mbgl/renderer/tile_snapshot.cpp
+    src/mbgl/renderer/tile_snapshot.hpp
+    src/mbgl/renderer/tile_upload_queue.cpp
+    src/mbgl/renderer/tile_upload_queue.hpp
     src/mbgl/renderer/transition_parameters.hpp
     src/mbgl/renderer/update_parameters.hpp
 
     # renderer/buckets
+    src/mbgl/renderer/buckets/bucket_serialization.hpp
     src/mbgl/renderer/buckets/circle_bucket.cpp
     src/mbgl/renderer/buckets/circle_bucket.hpp
     src/mbgl/renderer/buckets/debug_bucket.cpp
@@ -225,6 +267,8 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/buckets/line_bucket.hpp
     src/mbgl/renderer/buckets/raster_bucket.cpp
     src/mbgl/renderer/buckets/raster_bucket.hpp
+    src/mbgl/renderer/buckets/segment_bounds.cpp
+    src/mbgl/renderer/buckets/segment_bounds.hpp
     src/mbgl/renderer/buckets/symbol_bucket.cpp
     src/mbgl/renderer/buckets/symbol_bucket.hpp
 
@@ -247,6 +291,8 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/layers/render_symbol_layer.hpp
 
     # renderer/sources
+    src/mbgl/renderer/sources/render_custom_geometry_source.cpp
+    src/mbgl/renderer/sources/render_custom_geometry_source.hpp
     src/mbgl/renderer/sources/render_geojson_source.cpp
     src/mbgl/renderer/sources/render_geojson_source.hpp
     src/mbgl/renderer/sources/render_image_source.cpp
@@ -259,6 +305,10 @@ set(MBGL_CORE_FILES
     # shaders
     src/mbgl/shaders/circle.cpp
     src/mbgl/shaders/circle.hpp
+    src/mbgl/shaders/circle_instanced.cpp
+    src/mbgl/shaders/circle_instanced.hpp
+    src/mbgl/shaders/circle_state.cpp
+    src/mbgl/shaders/circle_state.hpp
     src/mbgl/shaders/collision_box.cpp
     src/mbgl/shaders/collision_box.hpp
     src/mbgl/shaders/debug.cpp
@@ -275,8 +325,20 @@ set(MBGL_CORE_FILES
     src/mbgl/shaders/fill_outline.hpp
     src/mbgl/shaders/fill_outline_pattern.cpp
     src/mbgl/shaders/fill_outline_pattern.hpp
+    src/mbgl/shaders/fill_outline_state.cpp
+    src/mbgl/shaders/fill_outline_state.hpp
     src/mbgl/shaders/fill_pattern.cpp
     src/mbgl/shaders/fill_pattern.hpp
+    src/mbgl/shaders/fill_state.cpp
+    src/mbgl/shaders/fill_state.hpp
+    src/mbgl/shaders/heatmap.cpp
+    src/mbgl/shaders/heatmap.hpp
+    src/mbgl/shaders/heatmap_instanced.cpp
+    src/mbgl/shaders/heatmap_instanced.hpp
+    src/mbgl/shaders/heatmap_texture.cpp
+    src/mbgl/shaders/heatmap_texture.hpp
+    src/mbgl/shaders/hillshade.cpp
+    src/mbgl/shaders/hillshade.hpp
     src/mbgl/shaders/line.cpp
     src/mbgl/shaders/line.hpp
     src/mbgl/shaders/line_pattern.cpp
@@ -313,14 +375,21 @@ set(MBGL_CORE_FILES
     include/mbgl/storage/resource_transform.hpp
     include/mbgl/storage/response.hpp
     src/mbgl/storage/asset_file_source.hpp
+    src/mbgl/storage/concurrency_limit.cpp
+    src/mbgl/storage/concurrency_limit.hpp
     src/mbgl/storage/file_source_request.cpp
     src/mbgl/storage/file_source_request.hpp
     src/mbgl/storage/http_file_source.hpp
     src/mbgl/storage/local_file_source.hpp
     src/mbgl/storage/network_status.cpp
+    src/mbgl/storage/pack_file_source.hpp
     src/mbgl/storage/resource.cpp
     src/mbgl/storage/resource_transform.cpp
     src/mbgl/storage/response.cpp
+    src/mbgl/storage/response_cache.cpp
+    src/mbgl/storage/response_cache.hpp
+    src/mbgl/storage/tile_batch.cpp
+    src/mbgl/storage/tile_batch.hpp
 
     # style
     include/mbgl/style/conversion.hpp
@@ -339,6 +408,8 @@ set(MBGL_CORE_FILES
     include/mbgl/style/types.hpp
     include/mbgl/style/undefined.hpp
     src/mbgl/style/collection.hpp
+    src/mbgl/style/compiled_filter.cpp
+    src/mbgl/style/compiled_filter.hpp
     src/mbgl/style/image.cpp
     src/mbgl/style/image_impl.cpp
     src/mbgl/style/image_impl.hpp
@@ -404,7 +475,9 @@ set(MBGL_CORE_FILES
     # style/layers
     include/mbgl/style/layers/background_layer.hpp
     include/mbgl/style/layers/circle_layer.hpp
+    include/mbgl/style/layers/circle_layer_heatmap.hpp
     include/mbgl/style/layers/custom_layer.hpp
+    include/mbgl/style/layers/feature_state_color.hpp
     include/mbgl/style/layers/fill_extrusion_layer.hpp
     include/mbgl/style/layers/fill_layer.hpp
     include/mbgl/style/layers/line_layer.hpp
@@ -416,6 +489,7 @@ set(MBGL_CORE_FILES
     src/mbgl/style/layers/background_layer_properties.cpp
     src/mbgl/style/layers/background_layer_properties.hpp
     src/mbgl/style/layers/circle_layer.cpp
+    src/mbgl/style/layers/circle_layer_heatmap.cpp
     src/mbgl/style/layers/circle_layer_impl.cpp
     src/mbgl/style/layers/circle_layer_impl.hpp
     src/mbgl/style/layers/circle_layer_properties.cpp
@@ -423,6 +497,7 @@ set(MBGL_CORE_FILES
     src/mbgl/style/layers/custom_layer.cpp
     src/mbgl/style/layers/custom_layer_impl.cpp
     src/mbgl/style/layers/custom_layer_impl.hpp
+    src/mbgl/style/layers/feature_state_color.cpp
     src/mbgl/style/layers/fill_extrusion_layer.cpp
     src/mbgl/style/layers/fill_extrusion_layer_impl.cpp
     src/mbgl/style/layers/fill_extrusion_layer_impl.hpp
@@ -450,16 +525,22 @@ set(MBGL_CORE_FILES
     src/mbgl/style/layers/symbol_layer_properties.hpp
 
     # style/sources
+    include/mbgl/style/sources/custom_geometry_source.hpp
     include/mbgl/style/sources/geojson_source.hpp
     include/mbgl/style/sources/image_source.hpp
+    include/mbgl/style/sources/raster_dem_source.hpp
     include/mbgl/style/sources/raster_source.hpp
     include/mbgl/style/sources/vector_source.hpp
+    src/mbgl/style/sources/custom_geometry_source.cpp
+    src/mbgl/style/sources/custom_geometry_source_impl.cpp
+    src/mbgl/style/sources/custom_geometry_source_impl.hpp
     src/mbgl/style/sources/geojson_source.cpp
     src/mbgl/style/sources/geojson_source_impl.cpp
     src/mbgl/style/sources/geojson_source_impl.hpp
     src/mbgl/style/sources/image_source.cpp
     src/mbgl/style/sources/image_source_impl.cpp
     src/mbgl/style/sources/image_source_impl.hpp
+    src/mbgl/style/sources/raster_dem_source.cpp
     src/mbgl/style/sources/raster_source.cpp
     src/mbgl/style/sources/raster_source_impl.cpp
     src/mbgl/style/sources/raster_source_impl.hpp
@@ -473,6 +554,8 @@ set(MBGL_CORE_FILES
     src/mbgl/text/check_max_angle.hpp
     src/mbgl/text/collision_feature.cpp
     src/mbgl/text/collision_feature.hpp
+    src/mbgl/text/collision_grid.cpp
+    src/mbgl/text/collision_grid.hpp
     src/mbgl/text/collision_tile.cpp
     src/mbgl/text/collision_tile.hpp
     src/mbgl/text/get_anchors.cpp
@@ -481,19 +564,29 @@ set(MBGL_CORE_FILES
     src/mbgl/text/glyph.hpp
     src/mbgl/text/glyph_atlas.cpp
     src/mbgl/text/glyph_atlas.hpp
+    src/mbgl/text/glyph_binary.cpp
+    src/mbgl/text/glyph_binary.hpp
     src/mbgl/text/glyph_manager.cpp
     src/mbgl/text/glyph_manager.hpp
     src/mbgl/text/glyph_manager_observer.hpp
     src/mbgl/text/glyph_pbf.cpp
     src/mbgl/text/glyph_pbf.hpp
     src/mbgl/text/glyph_range.hpp
+    src/mbgl/text/line_break_cache.cpp
+    src/mbgl/text/line_break_cache.hpp
+    src/mbgl/text/local_glyph_rasterizer.cpp
+    src/mbgl/text/local_glyph_rasterizer.hpp
     src/mbgl/text/placement_config.hpp
     src/mbgl/text/quads.cpp
     src/mbgl/text/quads.hpp
     src/mbgl/text/shaping.cpp
     src/mbgl/text/shaping.hpp
+    src/mbgl/text/shaping_cache.cpp
+    src/mbgl/text/shaping_cache.hpp
 
     # tile
+    src/mbgl/tile/custom_geometry_tile.cpp
+    src/mbgl/tile/custom_geometry_tile.hpp
     src/mbgl/tile/geojson_tile.cpp
     src/mbgl/tile/geojson_tile.hpp
     src/mbgl/tile/geometry_tile.cpp
@@ -502,6 +595,8 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/geometry_tile_data.hpp
     src/mbgl/tile/geometry_tile_worker.cpp
     src/mbgl/tile/geometry_tile_worker.hpp
+    src/mbgl/tile/layout_cache.cpp
+    src/mbgl/tile/layout_cache.hpp
     src/mbgl/tile/raster_tile.cpp
     src/mbgl/tile/raster_tile.hpp
     src/mbgl/tile/raster_tile_worker.cpp
@@ -519,6 +614,8 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/vector_tile.hpp
     src/mbgl/tile/vector_tile_data.cpp
     src/mbgl/tile/vector_tile_data.hpp
+    src/mbgl/tile/vector_tile_data_cache.cpp
+    src/mbgl/tile/vector_tile_data_cache.hpp
 
     # util
     include/mbgl/util/any.hpp
@@ -567,6 +664,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/clip_id.cpp
     src/mbgl/util/clip_id.hpp
     src/mbgl/util/color.cpp
+    src/mbgl/util/compressed_image.cpp
+    src/mbgl/util/compressed_image.hpp
     src/mbgl/util/compression.cpp
     src/mbgl/util/constants.cpp
     src/mbgl/util/convert.cpp
@@ -575,6 +674,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/event.cpp
     src/mbgl/util/font_stack.cpp
     src/mbgl/util/geo.cpp
+    src/mbgl/util/geobuf.cpp
+    src/mbgl/util/geobuf.hpp
     src/mbgl/util/geojson_impl.cpp
     src/mbgl/util/grid_index.cpp
     src/mbgl/util/grid_index.hpp
@@ -584,6 +685,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/http_timeout.hpp
     src/mbgl/util/i18n.cpp
     src/mbgl/util/i18n.hpp
+    src/mbgl/util/interned_string.cpp
+    src/mbgl/util/interned_string.hpp
     src/mbgl/util/interpolate.cpp
     src/mbgl/util/intersection_tests.cpp
     src/mbgl/util/intersection_tests.hpp
@@ -602,6 +705,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/math.hpp
     src/mbgl/util/offscreen_texture.cpp
     src/mbgl/util/offscreen_texture.hpp
+    src/mbgl/util/parallel.cpp
+    src/mbgl/util/parallel.hpp
     src/mbgl/util/premultiply.cpp
     src/mbgl/util/rapidjson.hpp
     src/mbgl/util/rect.hpp
@@ -616,11 +721,18 @@ set(MBGL_CORE_FILES
     src/mbgl/util/tile_coordinate.hpp
     src/mbgl/util/tile_cover.cpp
     src/mbgl/util/tile_cover.hpp
+    src/mbgl/util/timer_wheel.cpp
+    src/mbgl/util/timer_wheel.hpp
     src/mbgl/util/token.hpp
+    src/mbgl/util/trace.cpp
+    src/mbgl/util/trace.hpp
+    src/mbgl/util/unitbezier_table.cpp
+    src/mbgl/util/unitbezier_table.hpp
     src/mbgl/util/url.cpp
     src/mbgl/util/url.hpp
     src/mbgl/util/utf.hpp
     src/mbgl/util/version.cpp
     src/mbgl/util/version.hpp
+    src/mbgl/util/weak_cache.hpp
     src/mbgl/util/work_request.cpp
 )
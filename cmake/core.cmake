@@ -29,6 +29,18 @@ target_add_mason_package(mbgl-core PRIVATE wagyu)
 target_add_mason_package(mbgl-core PRIVATE shelf-pack)
 target_add_mason_package(mbgl-core PRIVATE vector-tile)
 
+if(WITH_ZSTD)
+    find_path(ZSTD_INCLUDE_DIR zstd.h)
+    find_library(ZSTD_LIBRARY zstd)
+    if(NOT ZSTD_INCLUDE_DIR OR NOT ZSTD_LIBRARY)
+        message(FATAL_ERROR "WITH_ZSTD requires the zstd library and headers.")
+    endif()
+
+    target_include_directories(mbgl-core PRIVATE ${ZSTD_INCLUDE_DIR})
+    target_compile_definitions(mbgl-core PRIVATE MBGL_USE_ZSTD=1)
+    target_link_libraries(mbgl-core PUBLIC ${ZSTD_LIBRARY})
+endif()
+
 mbgl_platform_core()
 
 create_source_groups(mbgl-core)
@@ -18,13 +18,21 @@ set(MBGL_TEST_FILES
     test/api/custom_layer.test.cpp
     test/api/query.test.cpp
 
+    # geometry
+    test/geometry/dem_data.test.cpp
+    test/geometry/tessellation.test.cpp
+
     # gl
     test/gl/bucket.test.cpp
+    test/gl/buffer_arena.test.cpp
     test/gl/object.test.cpp
 
     # include/mbgl
     test/include/mbgl/test.hpp
 
+    # layout
+    test/layout/symbol_layout.test.cpp
+
     # map
     test/map/map.test.cpp
     test/map/prefetch.test.cpp
@@ -41,8 +49,17 @@ set(MBGL_TEST_FILES
 
     # renderer
     test/renderer/backend_scope.test.cpp
+    test/renderer/bucket_uploader.test.cpp
+    test/renderer/cross_tile_symbol_index.test.cpp
+    test/renderer/feature_state.test.cpp
+    test/renderer/frame_history.test.cpp
+    test/renderer/frame_timer.test.cpp
     test/renderer/group_by_layout.test.cpp
     test/renderer/image_manager.test.cpp
+    test/renderer/layout_profiler.test.cpp
+    test/renderer/threaded_renderer_frontend.test.cpp
+    test/renderer/tile_pyramid.test.cpp
+    test/renderer/tile_snapshot.test.cpp
 
     # sprite
     test/sprite/sprite_loader.test.cpp
@@ -68,6 +85,7 @@ set(MBGL_TEST_FILES
 
     # storage
     test/storage/asset_file_source.test.cpp
+    test/storage/concurrency_limit.test.cpp
     test/storage/default_file_source.test.cpp
     test/storage/headers.test.cpp
     test/storage/http_file_source.test.cpp
@@ -76,11 +94,15 @@ set(MBGL_TEST_FILES
     test/storage/offline_database.test.cpp
     test/storage/offline_download.test.cpp
     test/storage/online_file_source.test.cpp
+    test/storage/pack_file_source.test.cpp
     test/storage/resource.test.cpp
+    test/storage/response_cache.test.cpp
     test/storage/sqlite.test.cpp
+    test/storage/tile_batch.test.cpp
 
     # style/conversion
     test/style/conversion/function.test.cpp
+    test/style/conversion/geojson.test.cpp
     test/style/conversion/geojson_options.test.cpp
     test/style/conversion/layer.test.cpp
     test/style/conversion/light.test.cpp
@@ -105,30 +127,45 @@ set(MBGL_TEST_FILES
     test/style/style_parser.test.cpp
 
     # text
+    test/text/collision_grid.test.cpp
+    test/text/glyph_atlas.test.cpp
+    test/text/glyph_binary.test.cpp
     test/text/glyph_loader.test.cpp
     test/text/glyph_pbf.test.cpp
+    test/text/line_break_cache.test.cpp
+    test/text/local_glyph_rasterizer.test.cpp
     test/text/quads.test.cpp
+    test/text/shaping_cache.test.cpp
 
     # tile
     test/tile/annotation_tile.test.cpp
     test/tile/geojson_tile.test.cpp
     test/tile/geometry_tile_data.test.cpp
+    test/tile/layout_cache.test.cpp
     test/tile/raster_tile.test.cpp
+    test/tile/tile_cache.test.cpp
     test/tile/tile_coordinate.test.cpp
     test/tile/tile_id.test.cpp
     test/tile/vector_tile.test.cpp
+    test/tile/vector_tile_data_cache.test.cpp
 
     # util
     test/util/async_task.test.cpp
+    test/util/compressed_image.test.cpp
+    test/util/compression.test.cpp
     test/util/dtoa.test.cpp
     test/util/geo.test.cpp
+    test/util/geobuf.test.cpp
+    test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
     test/util/image.test.cpp
+    test/util/interned_string.test.cpp
     test/util/mapbox.test.cpp
     test/util/memory.test.cpp
     test/util/merge_lines.test.cpp
     test/util/number_conversions.test.cpp
     test/util/offscreen_texture.test.cpp
+    test/util/parallel.test.cpp
     test/util/position.test.cpp
     test/util/projection.test.cpp
     test/util/run_loop.test.cpp
@@ -137,6 +174,10 @@ set(MBGL_TEST_FILES
     test/util/thread_local.test.cpp
     test/util/tile_cover.test.cpp
     test/util/timer.test.cpp
+    test/util/timer_wheel.test.cpp
     test/util/token.test.cpp
+    test/util/trace.test.cpp
+    test/util/unitbezier_table.test.cpp
     test/util/url.test.cpp
+    test/util/work_stealing_thread_pool.test.cpp
 )
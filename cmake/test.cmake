@@ -35,6 +35,9 @@ target_add_mason_package(mbgl-test PRIVATE pixelmatch)
 target_add_mason_package(mbgl-test PRIVATE boost)
 target_add_mason_package(mbgl-test PRIVATE geojson)
 target_add_mason_package(mbgl-test PRIVATE geojsonvt)
+target_add_mason_package(mbgl-test PRIVATE supercluster)
+target_add_mason_package(mbgl-test PRIVATE kdbush)
+target_add_mason_package(mbgl-test PRIVATE protozero)
 target_add_mason_package(mbgl-test PRIVATE shelf-pack)
 
 mbgl_platform_test()
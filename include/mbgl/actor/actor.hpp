@@ -24,6 +24,10 @@ namespace mbgl {
     to R is *not* guaranteed (and can't be: S1 and S2 may be acting asynchronously with respect
     to each other).
 
+    Messages sent with `coalesce` rather than `invoke` are last-writer-wins: a coalesced message
+    drops the coalesced messages for the same member function that are still waiting in the
+    mailbox, e.g. for state updates that only matter in their latest version.
+
     An `Actor<O>` can be converted to an `ActorRef<O>`, a non-owning value object representing
     a (weak) reference to the actor. Messages can be sent via the `Ref` as well.
 
@@ -74,6 +78,12 @@ public:
         mailbox->push(actor::makeMessage(object, fn, std::forward<Args>(args)...));
     }
 
+    // See Mailbox::coalesce.
+    template <typename Fn, class... Args>
+    void coalesce(Fn fn, Args&&... args) {
+        mailbox->coalesce(actor::makeMessage(object, fn, std::forward<Args>(args)...));
+    }
+
     template <typename Fn, class... Args>
     auto ask(Fn fn, Args&&... args) {
         // Result type is deduced from the function's return type
@@ -85,6 +95,11 @@ public:
         return future;
     }
 
+    // See Mailbox::setPriority.
+    void setPriority(int32_t priority) {
+        mailbox->setPriority(priority);
+    }
+
     ActorRef<std::decay_t<Object>> self() {
         return ActorRef<std::decay_t<Object>>(object, mailbox);
     }
@@ -35,6 +35,14 @@ public:
         }
     }
 
+    // See Mailbox::coalesce.
+    template <typename Fn, class... Args>
+    void coalesce(Fn fn, Args&&... args) {
+        if (auto mailbox = weakMailbox.lock()) {
+            mailbox->coalesce(actor::makeMessage(*object, fn, std::forward<Args>(args)...));
+        }
+    }
+
     template <typename Fn, class... Args>
     auto ask(Fn fn, Args&&... args) {
         // Result type is deduced from the function's return type
@@ -1,35 +1,74 @@
 #pragma once
 
+#include <mbgl/actor/message.hpp>
+
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <vector>
 
 namespace mbgl {
 
 class Scheduler;
-class Message;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
     Mailbox(Scheduler&);
+    ~Mailbox();
 
     void push(std::unique_ptr<Message>);
 
+    // Pushes a message that supersedes the coalesced messages for the same function of the same
+    // object that are still waiting in the mailbox: those are dropped without being received, so
+    // that of several coalesced messages, only the last one is received, in its place in the queue.
+    void coalesce(std::unique_ptr<Message>);
+
     void close();
     void receive();
 
+    // Schedulers that support it process mailboxes with a higher priority first. This never
+    // changes the order in which the messages of a single mailbox are processed.
+    void setPriority(int32_t);
+    int32_t getPriority() const;
+
     static void maybeReceive(std::weak_ptr<Mailbox>);
 
 private:
+    // Intrusive multi-producer/single-consumer queue (after Dmitry Vyukov's design). Producers
+    // link messages in at `head` with a single atomic exchange; the receiving thread -- there is
+    // only ever one at a time -- unlinks them from `tail`. `stub` keeps the list non-empty.
+    void enqueue(Message*);
+    Message* dequeue();
+    Message* dequeueWaiting();
+
+    // Whether the message has been superseded by a coalesced one pushed after it.
+    bool isSuperseded(Message&);
+
+    class Stub : public Message {
+    public:
+        void operator()() override {}
+    };
+
     Scheduler& scheduler;
 
     std::recursive_mutex receivingMutex;
-    std::mutex pushingMutex;
 
-    bool closed { false };
+    // The last coalesced message for each function, which hasn't been received yet. Only taken
+    // for coalesced messages, so that pushing others stays lock-free.
+    std::mutex coalescingMutex;
+    std::vector<Message*> coalescing;
+
+    std::atomic<bool> closed { false };
+    std::atomic<std::size_t> pushing { 0 };
+    std::atomic<int32_t> priority { 0 };
+
+    // Number of messages that have been fully enqueued and not yet received.
+    std::atomic<std::size_t> size { 0 };
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    Stub stub;
+    std::atomic<Message*> head;
+    Message* tail;
 };
 
 } // namespace mbgl
@@ -2,18 +2,44 @@
 
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
 #include <future>
 #include <utility>
 
 namespace mbgl {
 
+class Mailbox;
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
+//
+// Messages double as the nodes of their mailbox's queue, so that sending a message doesn't
+// allocate anything beyond the message itself.
 class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    // Whether this message and the given one call the same function of the same object, and thus
+    // supersede one another when coalesced.
+    virtual bool coalescesWith(const Message&) const {
+        return false;
+    }
+
+    // Identifies the type of the message, for coalescesWith().
+    virtual const void* type() const {
+        return nullptr;
+    }
+
+private:
+    friend class Mailbox;
+    std::atomic<Message*> next { nullptr };
+
+    // Set before the message is pushed; `superseded` is guarded by the coalescing mutex of the
+    // mailbox.
+    bool coalesced = false;
+    bool superseded = false;
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -34,9 +60,22 @@ public:
         (object.*memberFn)(std::move(std::get<I>(argsTuple))...);
     }
 
+    bool coalescesWith(const Message& other) const override {
+        if (other.type() != type()) {
+            return false;
+        }
+        const auto& message = static_cast<const MessageImpl&>(other);
+        return &message.object == &object && message.memberFn == memberFn;
+    }
+
     Object& object;
     MemberFn memberFn;
     ArgsTuple argsTuple;
+
+    const void* type() const override {
+        static const char tag = 0;
+        return &tag;
+    }
 };
 
 template <class ResultType, class Object, class MemberFn, class ArgsTuple>
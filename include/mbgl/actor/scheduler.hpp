@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 
 namespace mbgl {
@@ -20,6 +21,12 @@ class Mailbox;
 
       Subject to these constraints, processing can happen on whatever thread in the
       pool is available.
+      When several mailboxes are waiting, those with a higher `Mailbox::getPriority()`
+      are processed first.
+
+    * `WorkStealingThreadPool` preserves the same behaviors as `ThreadPool`, but gives each
+      thread its own queue and lets idle threads steal work from busy ones, avoiding contention
+      on a single shared queue when many mailboxes are scheduled at once.
 
     * `RunLoop` is a `Scheduler` that is typically used to create a mailbox and
       `ActorRef` for an object that lives on the main thread and is not itself wrapped
@@ -33,6 +40,10 @@ class Scheduler {
 public:
     virtual ~Scheduler() = default;
     virtual void schedule(std::weak_ptr<Mailbox>) = 0;
+
+    // The number of scheduled mailboxes that are waiting to be processed, for schedulers that
+    // queue them; zero otherwise.
+    virtual std::size_t getQueueDepth() const { return 0; }
 };
 
 } // namespace mbgl
@@ -4,6 +4,7 @@
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/map/map_observer.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/missing_tile.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/size.hpp>
 #include <mbgl/annotation/annotation.hpp>
@@ -44,6 +45,13 @@ public:
     using StillImageCallback = std::function<void (std::exception_ptr)>;
     void renderStill(StillImageCallback callback);
 
+    // Like renderStill(), but renders with whatever has loaded once `timeout` has passed, rather
+    // than waiting for the slowest tile. Loaded parents or children of the missing tiles are
+    // rendered in their place, and the callback receives the tiles that were missing, if any.
+    // The style itself must have loaded.
+    using PartialStillImageCallback = std::function<void (std::exception_ptr, MissingTiles)>;
+    void renderStill(Duration timeout, PartialStillImageCallback callback);
+
     // Triggers a repaint.
     void triggerRepaint();
 
@@ -141,6 +149,11 @@ public:
     void updateAnnotation(AnnotationID, const Annotation&);
     void removeAnnotation(AnnotationID);
 
+    // Apply all of the changes at once, refreshing the annotation tiles only once.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&);
+    void updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>&);
+    void removeAnnotations(const AnnotationIDs&);
+
     // Tile prefetching
     //
     // When loading a map, if `PrefetchZoomDelta` is set to any number greater than 0, the map will
@@ -150,6 +163,42 @@ public:
     void setPrefetchZoomDelta(uint8_t delta);
     uint8_t getPrefetchZoomDelta() const;
 
+    // Tile cache
+    //
+    // Tiles that are no longer visible are kept in a per-source cache so that panning back to
+    // them doesn't require reloading. The cache evicts the least recently used tiles once their
+    // vertex, index and texture data exceeds `size` bytes. The default is 32 MB per source.
+    void setTileCacheSize(uint64_t size);
+    uint64_t getTileCacheSize() const;
+
+    // Placement budget
+    //
+    // If `symbols` is greater than 0, tiles with more symbols than that place them in several
+    // passes of at most `symbols` each, in the order of their features, and show the symbols
+    // placed so far after every pass. Applies to tiles loaded afterwards, and not to still image
+    // rendering. The default is 0, which places all symbols of a tile at once.
+    void setPlacementBudget(uint32_t symbols);
+    uint32_t getPlacementBudget() const;
+
+    // Tile level of detail
+    //
+    // If `bias` is set, pitched views load tiles farther from the camera than the center of the
+    // map at lower zoom levels: one level lower at twice the distance, two levels lower at four
+    // times the distance, and so on. A positive `bias`, in zoom levels, keeps more detail, and a
+    // negative one less. Unset by default, which loads all tiles at the zoom level of the center.
+    void setTileLODBias(optional<double> bias);
+    optional<double> getTileLODBias() const;
+
+    // Style images on demand
+    //
+    // If `onDemand` is true, symbol tiles are laid out with the style images that are present,
+    // instead of waiting for the style's sprite to load, and are laid out again as images are
+    // added, by the sprite or with Style::addImage(). MapObserver::onStyleImageMissing() is
+    // called for the images that symbols use but the style doesn't have yet, so that they can be
+    // added one by one. The default is false.
+    void setStyleImagesOnDemand(bool onDemand);
+    bool getStyleImagesOnDemand() const;
+
     // Debug
     void setDebug(MapDebugOptions);
     void cycleDebugOptions();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/renderer/gpu_timings.hpp>
 #include <mbgl/style/source.hpp>
 
 #include <cstdint>
@@ -39,6 +40,15 @@ public:
     virtual void onDidFinishRenderingMap(RenderMode) {}
     virtual void onDidFinishLoadingStyle() {}
     virtual void onSourceChanged(style::Source&) {}
+
+    // Called once for every image that symbols use but the style doesn't have, until it is added
+    // with Style::addImage(). See Map::setStyleImagesOnDemand().
+    virtual void onStyleImageMissing(const std::string&) {}
+
+    // Called in continuous mode after onDidFinishRenderingFrame() when GPU timing is enabled on the
+    // renderer, with the timings of an earlier frame once the GPU has made them available. See
+    // Renderer::setGPUTimingEnabled().
+    virtual void onDidCollectGPUTimings(const GPUTimings&) {}
 };
 
 } // namespace mbgl
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// A tile that hadn't loaded by the time a still image was rendered, identified by the source it
+// belongs to and its canonical coordinates.
+class MissingTile {
+public:
+    std::string sourceID;
+    uint8_t z;
+    uint32_t x;
+    uint32_t y;
+
+    bool operator==(const MissingTile& rhs) const {
+        return sourceID == rhs.sourceID && z == rhs.z && x == rhs.x && y == rhs.y;
+    }
+};
+
+using MissingTiles = std::vector<MissingTile>;
+
+} // namespace mbgl
@@ -23,6 +23,14 @@ enum class GLContextMode : EnumType {
     Shared,
 };
 
+// How much memory a renderer should free when the system runs low on it. Moderate pressure frees
+// the tiles and textures kept for reuse; critical pressure also frees what the tiles in use keep
+// to speed up relayouts and queries.
+enum class MemoryPressure : EnumType {
+    Moderate,
+    Critical,
+};
+
 // We can choose to constrain the map both horizontally or vertically, or only
 // vertically e.g. while panning.
 enum class ConstrainMode : EnumType {
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+// GPU time a frame took, broken down by render pass and by style layer.
+class GPUTimings {
+public:
+    using Entries = std::vector<std::pair<std::string, Duration>>;
+
+    // In the order the passes were rendered.
+    Entries passes;
+
+    // Summed over all passes a layer was rendered in, in the order the layers were first
+    // rendered.
+    Entries layers;
+};
+
+} // namespace mbgl
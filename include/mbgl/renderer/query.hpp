@@ -1,8 +1,11 @@
 #pragma once
 
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/style/filter.hpp>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -38,6 +41,16 @@ public:
     optional<std::vector<std::string>> sourceLayers;
 
     optional<style::Filter> filter;
+
+    // If set, only features intersecting this polygon, given as its outer ring, are included.
+    optional<std::vector<LatLng>> geometry;
+
+    // Features are included once for every loaded tile they're in, unless this is set, in which
+    // case each feature with an identifier is only included from the first tile it's found in.
+    bool unique = false;
 };
 
+// Receives the features a source query finds one by one, so that they needn't be collected.
+using SourceFeatureCallback = std::function<void (Feature&&)>;
+
 } // namespace mbgl
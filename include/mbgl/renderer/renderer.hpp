@@ -2,9 +2,11 @@
 
 #include <mbgl/map/mode.hpp>
 #include <mbgl/renderer/query.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/feature.hpp>
 
 #include <functional>
 #include <memory>
@@ -23,9 +25,12 @@ class UpdateParameters;
 
 class Renderer {
 public:
+    // With a local font family, CJK glyphs are rasterized with that font of the platform rather
+    // than downloaded, on platforms that can draw glyphs.
     Renderer(RendererBackend&, float pixelRatio_, FileSource&, Scheduler&,
              GLContextMode = GLContextMode::Unique,
-             const optional<std::string> programCacheDir = {});
+             const optional<std::string> programCacheDir = {},
+             const optional<std::string> localFontFamily = {});
     ~Renderer();
 
     void setObserver(RendererObserver*);
@@ -36,14 +41,88 @@ public:
     std::vector<Feature> queryRenderedFeatures(const ScreenLineString&, const RenderedQueryOptions& options = {}) const;
     std::vector<Feature> queryRenderedFeatures(const ScreenCoordinate& point, const RenderedQueryOptions& options = {}) const;
     std::vector<Feature> queryRenderedFeatures(const ScreenBox& box, const RenderedQueryOptions& options = {}) const;
+
+    // Batched feature queries, returning the features of each geometry at the same position.
+    // Cheaper than querying one geometry at a time.
+    std::vector<std::vector<Feature>> queryRenderedFeatures(const std::vector<ScreenLineString>&, const RenderedQueryOptions& options = {}) const;
+    std::vector<std::vector<Feature>> queryRenderedFeatures(const std::vector<ScreenCoordinate>& points, const RenderedQueryOptions& options = {}) const;
+    std::vector<std::vector<Feature>> queryRenderedFeatures(const std::vector<ScreenBox>& boxes, const RenderedQueryOptions& options = {}) const;
     std::vector<Feature> querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options = {}) const;
+    void querySourceFeatures(const std::string& sourceID, const SourceQueryOptions&, const SourceFeatureCallback&) const;
     AnnotationIDs queryPointAnnotations(const ScreenBox& box) const;
 
     // Debug
     void dumpDebugLogs();
 
+    // The renderer's counters, as of the most recent frame. They're also reported to the
+    // renderer's observer after every frame.
+    RendererStatistics getStatistics() const;
+
     // Memory
-    void onLowMemory();
+    // Frees memory that can be recreated when it's needed again. What each step freed is
+    // reported in the statistics' lowMemoryFreed.
+    void onLowMemory(MemoryPressure = MemoryPressure::Moderate);
+
+    // Limits the newly laid out tile data uploaded to the GPU per frame, in bytes. Tiles that
+    // don't fit into a frame's budget are uploaded in later frames, nearest to the center first,
+    // and their parents or children are rendered in their place meanwhile. Zero, the default,
+    // uploads tiles in the frame they arrive.
+    void setUploadBudget(std::size_t bytesPerFrame);
+
+    // Measures the GPU time spent on each render pass and style layer, if the context supports
+    // timer queries. Results are reported to the renderer's observer once they're available, and
+    // from there to MapObserver::onDidCollectGPUTimings().
+    void setGPUTimingEnabled(bool);
+
+    // Reports frames in continuous mode that take longer than `budget` on the render thread to the
+    // renderer's observer, with the phases of the frame and what they did. Defaults to 16 ms;
+    // zero disables it.
+    void setFrameBudget(Duration budget);
+
+    // Measures the time each style layer takes to lay out and place at each zoom level, and the
+    // features, vertices and bytes it produces, summed over the tiles laid out from now on. The
+    // totals are part of the renderer's statistics while profiling is enabled; enabling it again
+    // starts over.
+    void setLayoutProfilingEnabled(bool);
+
+    // Renders at the given pixel ratio instead of the one the renderer was created with, e.g. to
+    // render @1x and @2x images of the same view. Tiles and their layout are kept: they're made
+    // for the pixel ratio of the map, like its sprite.
+    void setRenderPixelRatio(float);
+
+    // Keeps the laid out geometry of the vector tiles laid out from now on, except for their
+    // labels, so that it can be taken with getTileSnapshot(). Disabling it drops what was kept.
+    void setTileSnapshotRecording(bool);
+
+    // The geometry kept for the tiles rendered in the latest frame, to be stored by the caller,
+    // preferably off the render thread.
+    std::string getTileSnapshot() const;
+
+    // Draws the tiles of a snapshot taken by the same build, e.g. before the app was last closed,
+    // until they're loaded and laid out. Call it before the first frame is rendered. Snapshots of
+    // other builds are ignored.
+    void setTileSnapshot(const std::string&);
+
+    // Keeps up to `bytes` of the laid out geometry of vector tiles in memory, so that tiles laid
+    // out again with the same data and style layout, e.g. when an area is revisited, copy it
+    // instead of laying it out. Labels are laid out as usual. Zero, the default, disables it.
+    void setLayoutCacheSize(std::size_t bytes);
+
+    // Draws just the roofs of small buildings in fill-extrusion layers where their footprint would
+    // be smaller than `pixels` on screen. Zero, the default, draws all walls.
+    void setExtrusionWallThreshold(float pixels);
+
+    // Feature state
+    // Sets the state of a feature of a source, from 0 to 1, by the id of the feature; zero, the
+    // default, removes it. Circle and fill layers with a state color mix that color into the
+    // color of each feature by its state, e.g. to highlight a hovered feature. Changes take effect
+    // in the next frame without laying tiles out again. `sourceLayer` is empty for sources without
+    // layers, such as GeoJSON sources. Ids match only if they have the same type and value, and
+    // features without an id have no state.
+    void setFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                         const FeatureIdentifier&, float state);
+    float getFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                          const FeatureIdentifier&) const;
 
 private:
     class Impl;
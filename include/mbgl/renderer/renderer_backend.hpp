@@ -35,6 +35,17 @@ public:
     // set to the current state.
     virtual void bind() = 0;
 
+    // Backends that can create a second OpenGL context sharing objects with the rendering
+    // context may return true and implement activateUploadContext() and
+    // deactivateUploadContext(). The renderer then turns new tile buckets into GPU buffers on a
+    // separate thread, through that context, before they're rendered.
+    virtual bool supportsSharedUploadContext() const;
+
+    // Backends whose framebuffer keeps its stencil buffer intact from one frame to the next may
+    // return true. The renderer then skips redrawing the tile clipping masks while neither the
+    // tiles nor the camera change.
+    virtual bool preservesStencilBuffer() const;
+
 protected:
     // Called with the name of an OpenGL extension that should be loaded. RendererBackend implementations
     // must call the API-specific version that obtains the function pointer for this function,
@@ -52,6 +63,12 @@ protected:
     virtual void activate() = 0;
     virtual void deactivate() = 0;
 
+    // Called on the upload thread to make the shared upload context current, and to release it
+    // again when the upload thread terminates. Only called if supportsSharedUploadContext()
+    // returns true.
+    virtual void activateUploadContext();
+    virtual void deactivateUploadContext();
+
     // Reads the color pixel data from the currently bound framebuffer.
     PremultipliedImage readFramebuffer(const Size&) const;
 
@@ -81,6 +98,7 @@ private:
     std::once_flag initialized;
 
     friend class BackendScope;
+    friend class BucketUploader;
 };
 
 MBGL_CONSTEXPR bool operator==(const RendererBackend& a, const RendererBackend& b) {
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// Counters describing the work of a renderer, cheap enough to be kept at all times.
+class RendererStatistics {
+public:
+    // The time the renderer took to issue the most recent frame, and the draw calls it issued.
+    Duration frameTime = Duration::zero();
+    std::size_t drawCalls = 0;
+    // The program changes the most recent frame avoided by drawing opaque layers that use the same
+    // program one after another.
+    std::size_t stateChangesAvoided = 0;
+
+    // Frames rendered since the renderer was created, and repaints skipped because they'd have
+    // been identical to the frame before.
+    uint64_t frames = 0;
+    uint64_t skippedFrames = 0;
+
+    // The time from the creation of the renderer until it finished its first frame, and its
+    // first frame with everything loaded. Zero until then.
+    Duration timeToFirstFrame = Duration::zero();
+    Duration timeToFullFrame = Duration::zero();
+
+    // Vertex, index and texture data uploaded through the renderer's context since it was created,
+    // in bytes. Buckets prepared on a shared upload context aren't included.
+    uint64_t uploadedBytes = 0;
+
+    // Tile textures that reused the storage of a released tile texture, and those that didn't.
+    uint64_t tileTexturePoolHits = 0;
+    uint64_t tileTexturePoolMisses = 0;
+
+    // Offscreen render targets, e.g. the one extrusions are drawn into, that reused the objects of
+    // a released render target, and those that didn't.
+    uint64_t renderTargetPoolHits = 0;
+    uint64_t renderTargetPoolMisses = 0;
+
+    // The GL buffers that the small static vertex and index buffers of buckets are ranges of, and
+    // how full they are, in bytes. Free bytes split into many small ranges are fragmented: only
+    // buffers up to the size of the largest free range fit without another arena.
+    struct BufferArenas {
+        std::size_t arenas = 0;
+        std::size_t reservedBytes = 0;
+        std::size_t usedBytes = 0;
+        std::size_t freeRanges = 0;
+        std::size_t largestFreeRange = 0;
+    };
+    BufferArenas bufferArenas;
+
+    struct Tiles {
+        // Tiles needed for rendering, still waiting for their data.
+        std::size_t loading = 0;
+        // Tiles with data whose parsing or placement is pending.
+        std::size_t pending = 0;
+        // Tiles that have been fully processed.
+        std::size_t complete = 0;
+        // Tiles that are no longer needed, kept in memory in case they're needed again.
+        std::size_t cached = 0;
+
+        Tiles& operator+=(const Tiles& rhs) {
+            loading += rhs.loading;
+            pending += rhs.pending;
+            complete += rhs.complete;
+            cached += rhs.cached;
+            return *this;
+        }
+    };
+
+    // Summed over all sources.
+    Tiles tiles;
+
+    // Mailboxes waiting for a worker thread, if the renderer's scheduler keeps track of them.
+    std::size_t workerQueueDepth = 0;
+
+    // Memory in use, in bytes: in main memory, and in GL buffers and textures.
+    struct Memory {
+        std::size_t cpu = 0;
+        std::size_t gpu = 0;
+
+        Memory& operator+=(const Memory& rhs) {
+            cpu += rhs.cpu;
+            gpu += rhs.gpu;
+            return *this;
+        }
+    };
+
+    // Memory held by the tiles of each source, rendered and cached, by source ID: their buckets,
+    // feature indexes, collision tiles and tile data.
+    std::map<std::string, Memory> sourceMemory;
+
+    // Memory held by the glyph, icon and line atlases that the sources share.
+    Memory atlasMemory;
+
+    // The bytes that low memory warnings freed since the renderer was created, by step: the tiles
+    // cached for reuse, the caches of the tile workers, and the parsed tile data and feature
+    // indexes that queries use. Workers free their caches on their own threads, so their share
+    // is added once they've got to it.
+    struct LowMemory {
+        Memory tileCache;
+        std::size_t workerCaches = 0;
+        std::size_t queryData = 0;
+    };
+    LowMemory lowMemoryFreed;
+
+    // Lookups in the file source's cache since it was created, if it has one.
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+
+    // Lookups in the renderer's layout cache, if it's enabled, and the bytes it holds.
+    uint64_t layoutCacheHits = 0;
+    uint64_t layoutCacheMisses = 0;
+    std::size_t layoutCacheSize = 0;
+
+    // The cost of laying out a style layer at a zoom level, summed over the tiles laid out while
+    // layout profiling was enabled. Layers that share their layout with the layers before them
+    // are laid out together, and counted under the first of them.
+    struct LayerLayout {
+        std::string layer;
+        uint8_t zoom = 0;
+        uint64_t tiles = 0;
+
+        // The time spent building the layer's buckets, and for symbol layers, shaping their
+        // symbols and placing them.
+        Duration layoutTime = Duration::zero();
+        Duration placementTime = Duration::zero();
+
+        // The features the buckets were made of, and the vertices and bytes they took.
+        uint64_t features = 0;
+        uint64_t vertices = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Empty unless layout profiling is enabled; most expensive first.
+    std::vector<LayerLayout> layout;
+};
+
+} // namespace mbgl
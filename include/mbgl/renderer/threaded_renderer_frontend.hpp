@@ -0,0 +1,46 @@
+#pragma once
+
+#include <mbgl/map/mode.hpp>
+#include <mbgl/renderer/renderer_frontend.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class FileSource;
+class Renderer;
+class RendererBackend;
+class Scheduler;
+
+// Renders on a thread of its own, with its own run loop, so that the thread of the map, which
+// handles gestures and changes to the style, never waits for the renderer. update() only hands
+// over the latest parameters: when the render thread gets to them, it renders a frame for the
+// most recent ones and skips those it missed in between.
+//
+// Must be created on a thread with a RunLoop, which the renderer's observer is called on. The
+// backend is only used on the render thread, and must be able to make its context current there.
+class ThreadedRendererFrontend : public RendererFrontend {
+public:
+    ThreadedRendererFrontend(RendererBackend&, float pixelRatio, FileSource&, Scheduler&,
+                             GLContextMode = GLContextMode::Unique,
+                             const optional<std::string> programCacheDir = {});
+    ~ThreadedRendererFrontend() override;
+
+    // Destroys the renderer and stops the render thread.
+    void reset() override;
+    void setObserver(RendererObserver&) override;
+    void update(std::shared_ptr<UpdateParameters>) override;
+
+    // Calls `fn` with the renderer on the render thread, e.g. to query features, and waits for it
+    // to return.
+    void withRenderer(std::function<void (Renderer&)> fn);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -3,9 +3,11 @@
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/offline.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
 #include <vector>
 #include <mutex>
 
@@ -16,6 +18,7 @@ template <typename T> class Thread;
 } // namespace util
 
 class ResourceTransform;
+class ResponseCache;
 
 class DefaultFileSource : public FileSource {
 public:
@@ -38,6 +41,19 @@ public:
         return true;
     }
 
+    // The network request can only start during the lookup when a reader thread does it.
+    bool supportsConcurrentNetworkRequests() const override {
+        return readersEnabled;
+    }
+
+    CacheStatistics getCacheStatistics() const override;
+
+    /*
+     * Keep up to `bytes` of the most recently read resources in memory, decompressed, in front
+     * of the database, for all maps using this file source. Disabled by default.
+     */
+    void setMemoryCacheSize(std::size_t bytes);
+
     void setAPIBaseURL(const std::string&);
     std::string getAPIBaseURL();
 
@@ -46,6 +62,28 @@ public:
 
     void setResourceTransform(optional<ActorRef<ResourceTransform>>&&);
 
+    /*
+     * Rewrite the URLs of network requests with `transform`, called on the file source's thread
+     * as each request is scheduled. Unlike with a ResourceTransform actor, there is no round trip
+     * to another thread per request, but `transform` must be safe to call from any thread. Takes
+     * precedence over a ResourceTransform actor; an empty function removes it.
+     */
+    void setSynchronousResourceTransform(std::function<std::string(Resource::Kind, const std::string&)>);
+
+    /*
+     * Multiplex network requests to the same host over a single HTTP/2 connection, with at
+     * most `maximumStreamsPerHost` of them in flight at once. Ignored on platforms whose HTTP
+     * stack negotiates HTTP/2 on its own.
+     */
+    void setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost = 100);
+
+    /*
+     * Adapt the number of network requests in flight to the latency and throughput that
+     * responses arrive with, instead of keeping as many in flight as the platform allows.
+     * Suits connections whose bandwidth varies widely, such as cellular ones. Disabled by default.
+     */
+    void setAdaptiveConcurrency(bool enabled);
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
     /*
@@ -91,6 +129,14 @@ public:
      */
     void setOfflineRegionDownloadState(OfflineRegion&, OfflineRegionDownloadState);
 
+    /*
+     * Bring a region's resources up to date, downloading only what changed. This activates
+     * the region's download like `setOfflineRegionDownloadState(OfflineRegionDownloadState::Active)`,
+     * but also revalidates resources already stored; tiles of tilesets with a `manifest`
+     * are revalidated in bulk. The download deactivates itself once the refresh completes.
+     */
+    void refreshOfflineRegion(OfflineRegion&);
+
     /*
      * Retrieve the current status of the region. The query will be executed
      * asynchronously and the results passed to the given callback, which will be
@@ -117,12 +163,68 @@ public:
      */
     void deleteOfflineRegion(OfflineRegion&&, std::function<void (std::exception_ptr)>);
 
+    /*
+     * Export an offline region, with the resources and tiles downloaded for it, to a single
+     * region archive file at `path`, e.g. to bundle it with an application or to copy it to
+     * another device. The archive is complete once the callback is executed without an error.
+     *
+     * When the operation is complete or encounters an error, the given callback will be
+     * executed on the database thread; it is the responsibility of the SDK bindings
+     * to re-execute a user-provided callback on the main thread.
+     */
+    void exportOfflineRegion(const OfflineRegion&,
+                             const std::string& path,
+                             std::function<void (std::exception_ptr)>);
+
+    /*
+     * Import a region archive created by `exportOfflineRegion` as a new offline region. The
+     * region and its resources are added in a single transaction; nothing is added if the
+     * archive is invalid or the import would exceed the Mapbox tile count limit.
+     *
+     * As with `createOfflineRegion`, the resulting region will be in an inactive download
+     * state. When the import is complete or encounters an error, the given callback will be
+     * executed on the database thread; it is the responsibility of the SDK bindings
+     * to re-execute a user-provided callback on the main thread.
+     */
+    void importOfflineRegion(const std::string& path,
+                             std::function<void (std::exception_ptr,
+                                                 optional<OfflineRegion>)>);
+
+    /*
+     * Store resources obtained elsewhere, e.g. tiles read from a local tile archive, for an
+     * offline region as if they had been downloaded for it, so that its download skips them.
+     * The resources are compressed in parallel and stored in a single transaction; nothing
+     * is stored if they would exceed the Mapbox tile count limit.
+     *
+     * When the operation is complete or encounters an error, the given callback will be
+     * executed on the database thread; it is the responsibility of the SDK bindings
+     * to re-execute a user-provided callback on the main thread.
+     */
+    void putOfflineRegionResources(const OfflineRegion&,
+                                   std::vector<std::pair<Resource, Response>>,
+                                   std::function<void (std::exception_ptr)>);
+
     /*
      * Changing or bypassing this limit without permission from Mapbox is prohibited
      * by the Mapbox Terms of Service.
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Group writes to the database (ambient caching as well as offline downloads) into
+     * transactions of up to `flushSize` resources, committed at least every `flushInterval`.
+     * This trades durability of the most recent writes for far fewer synchronous disk
+     * flushes. A `flushSize` of 1, the default, commits every write on its own.
+     */
+    void setOfflineWriteBatching(Duration flushInterval, std::size_t flushSize) const;
+
+    /*
+     * Limit the number of network requests each active offline download keeps in flight,
+     * in total and to any single host. Requests are still subject to the global limit
+     * of the underlying HTTP file source.
+     */
+    void setOfflineDownloadConcurrency(uint32_t maximumRequests, uint32_t maximumRequestsPerHost) const;
+
     /*
      * Pause file request activity.
      *
@@ -145,10 +247,24 @@ public:
     class Impl;
 
 private:
+    // Counted by the threads that look resources up in the cache, which are stopped before
+    // these are destroyed.
+    std::atomic<uint64_t> cacheHits { 0 };
+    std::atomic<uint64_t> cacheMisses { 0 };
+    // Set by the Impl once it has opened the database that the cache readers connect to.
+    std::atomic<bool> readersEnabled { false };
+    const std::unique_ptr<ResponseCache> memoryCache;
+
     // Shared so destruction is done on this thread
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<util::Thread<Impl>> impl;
 
+    class CacheReader;
+    static constexpr std::size_t cacheReaderCount = 2;
+    std::vector<std::unique_ptr<util::Thread<CacheReader>>> readers;
+    // Requests take turns between the readers.
+    std::atomic<std::size_t> nextReader { 0 };
+
     std::mutex cachedBaseURLMutex;
     std::string cachedBaseURL = mbgl::util::API_BASE_URL;
 
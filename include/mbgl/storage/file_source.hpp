@@ -31,6 +31,22 @@ public:
     virtual bool supportsOptionalRequests() const {
         return false;
     }
+
+    // When a file source honors Resource::concurrentNetworkRequest, it must return true.
+    virtual bool supportsConcurrentNetworkRequests() const {
+        return false;
+    }
+
+    struct CacheStatistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    // The lookups in the file source's cache since it was created. File sources without a cache
+    // report none.
+    virtual CacheStatistics getCacheStatistics() const {
+        return {};
+    }
 };
 
 } // namespace mbgl
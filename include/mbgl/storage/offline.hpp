@@ -1,8 +1,10 @@
 #pragma once
 
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/geometry.hpp>
 #include <mbgl/util/range.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/variant.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/storage/response.hpp>
 
@@ -30,7 +32,11 @@ public:
     OfflineTilePyramidRegionDefinition(std::string, LatLngBounds, double, double, float);
 
     /* Private */
+    // The zoom levels of a source's tiles in the region; empty if `min` is greater than `max`.
+    Range<uint8_t> coveringZoomRange(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
     std::vector<CanonicalTileID> tileCover(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+    // The size of tileCover(), computed without enumerating the tiles.
+    uint64_t tileCount(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
 
     const std::string styleURL;
     const LatLngBounds bounds;
@@ -40,10 +46,33 @@ public:
 };
 
 /*
- * For the present, a tile pyramid is the only type of offline region. In the future,
- * other definition types will be available and this will be a variant type.
+ * An offline region defined by a style URL, geometry, zoom range, and device pixel ratio.
+ *
+ * The geometry is in longitudes and latitudes, as in GeoJSON. At each zoom level the region
+ * includes the tiles its points are in, its lines pass through, and its polygons overlap, so
+ * a route is downloaded as the corridor of tiles along it; to include the tiles within some
+ * distance of a line, buffer it into a polygon. Lines and polygons may cross the antimeridian
+ * by continuing past ±180°.
+ *
+ * The zoom range and pixel ratio are as for tile pyramid regions.
  */
-using OfflineRegionDefinition = OfflineTilePyramidRegionDefinition;
+class OfflineGeometryRegionDefinition {
+public:
+    OfflineGeometryRegionDefinition(std::string, Geometry<double>, double, double, float);
+
+    /* Private */
+    Range<uint8_t> coveringZoomRange(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+    std::vector<CanonicalTileID> tileCover(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+    uint64_t tileCount(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+
+    const std::string styleURL;
+    const Geometry<double> geometry;
+    const double minZoom;
+    const double maxZoom;
+    const float pixelRatio;
+};
+
+using OfflineRegionDefinition = variant<OfflineTilePyramidRegionDefinition, OfflineGeometryRegionDefinition>;
 
 /*
  * The encoded format is private.
@@ -128,6 +157,15 @@ public:
      */
     bool requiredResourceCountIsPrecise = false;
 
+    /**
+     * The average rate at which tiles, and bytes of all resources, have been downloaded
+     * from the network since the download was last activated. Resources that were already
+     * present in the database do not count towards these figures. Both are zero while
+     * the download is inactive.
+     */
+    double tilesPerSecond = 0;
+    double bytesPerSecond = 0;
+
     bool complete() const {
         return completedResourceCount == requiredResourceCount;
     }
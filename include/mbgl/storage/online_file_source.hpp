@@ -22,6 +22,15 @@ public:
 
     void setResourceTransform(optional<ActorRef<ResourceTransform>>&&);
 
+    // See DefaultFileSource::setSynchronousResourceTransform.
+    void setSynchronousResourceTransform(std::function<std::string(Resource::Kind, const std::string&)>);
+
+    // See HTTPFileSource::setHTTP2Multiplexing.
+    void setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost);
+
+    // See DefaultFileSource::setAdaptiveConcurrency.
+    void setAdaptiveConcurrency(bool enabled);
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
 private:
@@ -35,6 +35,13 @@ public:
         Required = true,
     };
 
+    // Requests of low priority, such as those of offline downloads and of tiles prefetched
+    // ahead of the camera, only go out when no request of regular priority is waiting.
+    enum class Priority : bool {
+        Regular,
+        Low,
+    };
+
     Resource(Kind kind_, std::string url_, optional<TileData> tileData_ = {}, Necessity necessity_ = Required)
         : kind(kind_),
           necessity(necessity_),
@@ -60,6 +67,7 @@ public:
     
     Kind kind;
     Necessity necessity;
+    Priority priority = Priority::Regular;
     std::string url;
 
     // Includes auxiliary data if this is a tile request.
@@ -68,6 +76,15 @@ public:
     optional<Timestamp> priorModified = {};
     optional<Timestamp> priorExpires = {};
     optional<std::string> priorEtag = {};
+
+    // Starts the network request of a required resource while the cache is being looked up,
+    // instead of once the lookup has missed. The response of the lookup comes first, with a
+    // NotFound error on a miss; a fresh copy in the cache cancels the network request.
+    bool concurrentNetworkRequest = false;
+
+    // For tiles of tilesets with a batch endpoint, its URL template. The network request may
+    // then be sent together with those of other tiles. See Tileset::batch.
+    optional<std::string> batchURL;
 };
 
 } // namespace mbgl
@@ -34,6 +34,25 @@ public:
     optional<Timestamp> expires;
     optional<std::string> etag;
 
+    // Where the time of a network request went. Each phase starts where the previous one
+    // ended; phases a request skipped, such as resolving and connecting on a reused
+    // connection, are zero.
+    struct Timing {
+        Duration dns = Duration::zero();
+        Duration connect = Duration::zero();
+        Duration tls = Duration::zero();
+
+        // From sending the request until the first byte of the response arrived.
+        Duration firstByte = Duration::zero();
+        Duration transfer = Duration::zero();
+
+        bool reusedConnection = false;
+        bool multiplexed = false;
+    };
+
+    // Present for responses fetched over the network, where the HTTP stack reports it.
+    optional<Timing> timing;
+
     bool isFresh() const {
         return expires ? *expires > util::now() : !error;
     }
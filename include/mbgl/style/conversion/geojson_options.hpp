@@ -44,6 +44,26 @@ struct Converter<GeoJSONOptions> {
             }
         }
 
+        const auto indexMaxZoomValue = objectMember(value, "indexMaxZoom");
+        if (indexMaxZoomValue) {
+            if (toNumber(*indexMaxZoomValue)) {
+                options.indexMaxZoom = static_cast<uint8_t>(*toNumber(*indexMaxZoomValue));
+            } else {
+                error = { "GeoJSON source indexMaxZoom value must be a number" };
+                return {};
+            }
+        }
+
+        const auto indexMaxPointsValue = objectMember(value, "indexMaxPoints");
+        if (indexMaxPointsValue) {
+            if (toNumber(*indexMaxPointsValue)) {
+                options.indexMaxPoints = static_cast<uint32_t>(*toNumber(*indexMaxPointsValue));
+            } else {
+                error = { "GeoJSON source indexMaxPoints value must be a number" };
+                return {};
+            }
+        }
+
         const auto clusterValue = objectMember(value, "cluster");
         if (clusterValue) {
             if (toBool(*clusterValue)) {
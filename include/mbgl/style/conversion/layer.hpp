@@ -3,6 +3,7 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/circle_layer_heatmap.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
@@ -12,6 +13,7 @@
 #include <mbgl/style/conversion/constant.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/style/conversion/make_property_setters.hpp>
+#include <mbgl/style/conversion/property_value.hpp>
 
 namespace mbgl {
 namespace style {
@@ -92,6 +94,13 @@ public:
             converted = convertVectorLayer<LineLayer>(*id, value, error);
         } else if (*type == "circle") {
             converted = convertVectorLayer<CircleLayer>(*id, value, error);
+        } else if (*type == "heatmap") {
+            converted = convertVectorLayer<CircleLayer>(*id, value, error);
+            if (converted) {
+                auto& circle = *(*converted)->template as<CircleLayer>();
+                circle.setCircleRadius(30.0f);
+                setCircleHeatmap(circle, CircleHeatmap());
+            }
         } else if (*type == "symbol") {
             converted = convertVectorLayer<SymbolLayer>(*id, value, error);
         } else if (*type == "raster") {
@@ -144,7 +153,9 @@ public:
             }
         }
 
-        optional<Error> error_ = setPaintProperties(*layer, value);
+        optional<Error> error_ = *type == "heatmap"
+            ? setHeatmapPaintProperties(*layer->template as<CircleLayer>(), value)
+            : setPaintProperties(*layer, value);
         if (error_) {
             error = *error_;
             return {};
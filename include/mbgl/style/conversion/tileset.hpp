@@ -72,6 +72,26 @@ public:
             result.attribution = std::move(*attribution);
         }
 
+        auto manifestValue = objectMember(value, "manifest");
+        if (manifestValue) {
+            optional<std::string> manifest = toString(*manifestValue);
+            if (!manifest) {
+                error = { "source manifest must be a string" };
+                return {};
+            }
+            result.manifest = std::move(*manifest);
+        }
+
+        auto batchValue = objectMember(value, "batch");
+        if (batchValue) {
+            optional<std::string> batch = toString(*batchValue);
+            if (!batch) {
+                error = { "source batch must be a string" };
+                return {};
+            }
+            result.batch = std::move(*batch);
+        }
+
         return result;
     }
 };
@@ -42,6 +42,10 @@ public:
         return value.template is<Undefined>();
     }
 
+    bool isCameraFunction() const {
+        return value.template is<CameraFunction<T>>();
+    }
+
     bool isDataDriven() const {
         return value.template is<SourceFunction<T>>() || value.template is<CompositeFunction<T>>();
     }
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <utility>
 #include <map>
+#include <memory>
 
 namespace mbgl {
 namespace style {
@@ -15,6 +16,9 @@ public:
     using variant<bool, int64_t, std::string>::variant;
 };
 
+template <class T>
+class CompositeCategoricalStops;
+
 template <class T>
 class CategoricalStops {
 public:
@@ -24,7 +28,8 @@ public:
 
     CategoricalStops() = default;
     CategoricalStops(Stops stops_)
-        : stops(std::move(stops_)) {
+        : stops(std::move(stops_)),
+          lookup(compile(stops)) {
         assert(stops.size() > 0);
     }
 
@@ -34,6 +39,21 @@ public:
                            const CategoricalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    // The stops sorted into hash tables and arrays by the type of their value, so that evaluating
+    // them neither compares variants nor copies strings. It's built once, on construction, and
+    // shared by copies.
+    struct Lookup;
+    std::shared_ptr<const Lookup> lookup;
+
+    static std::shared_ptr<const Lookup> compile(const Stops&);
+
+    // Used for the inner stops of composite functions, which are only evaluated.
+    friend class CompositeCategoricalStops<T>;
+    explicit CategoricalStops(std::shared_ptr<const Lookup> lookup_)
+        : lookup(std::move(lookup_)) {
+    }
 };
 
 } // namespace style
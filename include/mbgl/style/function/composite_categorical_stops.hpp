@@ -14,16 +14,25 @@ public:
     CompositeCategoricalStops() = default;
     CompositeCategoricalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        for (const auto& stop : stops) {
+            lookups.emplace(stop.first, CategoricalStops<T>::compile(stop.second));
+        }
     }
 
-    CategoricalStops<T> innerStops(const std::map<CategoricalValue, T>& stops_) const {
-        return CategoricalStops<T>(stops_);
+    // The inner stops share the lookup built for them on construction, instead of copying and
+    // compiling them again every time they're evaluated.
+    CategoricalStops<T> innerStops(const typename Stops::value_type& stop) const {
+        auto it = lookups.find(stop.first);
+        return CategoricalStops<T>(it != lookups.end() ? it->second : CategoricalStops<T>::compile(stop.second));
     }
 
     friend bool operator==(const CompositeCategoricalStops& lhs,
                            const CompositeCategoricalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    std::map<float, std::shared_ptr<const typename CategoricalStops<T>::Lookup>> lookups;
 };
 
 } // namespace style
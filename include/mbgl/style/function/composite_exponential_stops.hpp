@@ -21,8 +21,8 @@ public:
           base(base_) {
     }
 
-    ExponentialStops<T> innerStops(const std::map<float, T>& stops_) const {
-        return ExponentialStops<T>(stops_, base);
+    ExponentialStops<T> innerStops(const typename Stops::value_type& stop) const {
+        return ExponentialStops<T>(stop.second, base);
     }
 
     friend bool operator==(const CompositeExponentialStops& lhs,
@@ -78,8 +78,8 @@ public:
                         maxIt == s.stops.end() ? s.stops.rbegin()->first : maxIt->first
                     },
                     Range<InnerStops> {
-                        s.innerStops(minIt == s.stops.end() ? s.stops.rbegin()->second : minIt->second),
-                        s.innerStops(maxIt == s.stops.end() ? s.stops.rbegin()->second : maxIt->second)
+                        s.innerStops(minIt == s.stops.end() ? *s.stops.rbegin() : *minIt),
+                        s.innerStops(maxIt == s.stops.end() ? *s.stops.rbegin() : *maxIt)
                     }
                 };
             }
@@ -18,8 +18,8 @@ public:
         : stops(std::move(stops_)) {
     }
 
-    IntervalStops<T> innerStops(const std::map<float, T>& stops_) const {
-        return IntervalStops<T>(stops_);
+    IntervalStops<T> innerStops(const typename Stops::value_type& stop) const {
+        return IntervalStops<T>(stop.second);
     }
 
     friend bool operator==(const CompositeIntervalStops& lhs,
@@ -13,6 +13,9 @@ public:
     Image(std::string id, PremultipliedImage&&, float pixelRatio, bool sdf = false);
     Image(const Image&);
 
+    class Impl;
+    explicit Image(Immutable<Impl>);
+
     std::string getID() const;
 
     const PremultipliedImage& getImage() const;
@@ -23,7 +26,6 @@ public:
     // Whether this image should be interpreted as a signed distance field icon.
     bool isSdf() const;
 
-    class Impl;
     Immutable<Impl> baseImpl;
 };
 
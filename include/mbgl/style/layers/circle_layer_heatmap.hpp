@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/property_value.hpp>
+#include <mbgl/util/optional.hpp>
+
+namespace mbgl {
+namespace style {
+
+// Circle layers can be drawn as a heatmap instead of as circles. Each feature then adds a kernel
+// to the heatmap's density, which is colored with a fixed color ramp running from transparent
+// through blue, cyan, green and yellow to red. circle-radius is the radius of the kernels in
+// pixels and circle-opacity the weight of each feature; the other circle paint properties
+// don't apply.
+//
+// Style JSON layers of type "heatmap" are circle layers drawn as a heatmap.
+class CircleHeatmap {
+public:
+    // Multiplies the weight of every feature, typically raised with the zoom level.
+    PropertyValue<float> intensity = 1.0f;
+    // The opacity of the whole heatmap.
+    PropertyValue<float> opacity = 1.0f;
+
+    friend bool operator==(const CircleHeatmap& lhs, const CircleHeatmap& rhs) {
+        return lhs.intensity == rhs.intensity && lhs.opacity == rhs.opacity;
+    }
+
+    friend bool operator!=(const CircleHeatmap& lhs, const CircleHeatmap& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+optional<CircleHeatmap> getCircleHeatmap(const CircleLayer&);
+void setCircleHeatmap(CircleLayer&, optional<CircleHeatmap>);
+
+} // namespace style
+} // namespace mbgl
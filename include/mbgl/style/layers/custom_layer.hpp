@@ -1,6 +1,11 @@
 #pragma once
 
 #include <mbgl/style/layer.hpp>
+#include <mbgl/util/traits.hpp>
+#include <mbgl/util/util.hpp>
+
+#include <array>
+#include <cstdint>
 
 namespace mbgl {
 namespace style {
@@ -26,6 +31,12 @@ struct CustomLayerRenderParameters {
     double bearing;
     double pitch;
     double fieldOfView;
+
+    // The map's column-major projection matrix, which transforms world coordinates in pixels at
+    // the current zoom level, with a world that's 512 * 2^zoom pixels wide, to clip space. Drawing with it places fragments in the
+    // map's depth buffer, which holds the depth of the opaque layers and the extrusions below the
+    // custom layer, so the layer can be depth tested against them.
+    std::array<double, 16> projectionMatrix;
 };
 
 /**
@@ -38,6 +49,48 @@ struct CustomLayerRenderParameters {
  */
 using CustomLayerRenderFunction = void (*)(void* context, const CustomLayerRenderParameters&);
 
+/**
+ * Prepare the data the layer draws in the next frame, e.g. upload its instance data into the
+ * buffer that isn't drawn from this frame. This optional method is called once per frame during
+ * the renderer's upload pass, with the same parameters as the CustomLayerRenderFunction, before
+ * anything of the frame is drawn.
+ */
+using CustomLayerPrepareFunction = void (*)(void* context, const CustomLayerRenderParameters&);
+
+/**
+ * The groups of GL state a custom layer may change. The renderer only restores the state a
+ * layer declares with CustomLayer::setModifiedGLState() after calling it, instead of
+ * sending all of its state again.
+ */
+enum class CustomLayerGLState : uint32_t {
+    None         = 0,
+    // The current program.
+    Program      = 1 << 0,
+    // Vertex array objects, vertex and index buffers, and vertex attributes.
+    VertexArrays = 1 << 1,
+    // Texture bindings, the active texture unit and pixel storage modes.
+    Textures     = 1 << 2,
+    // The depth test, function, mask and range, and the depth clear value.
+    Depth        = 1 << 3,
+    // The stencil test, function, mask and operations, and the stencil clear value.
+    Stencil      = 1 << 4,
+    // Blending, the color mask and the color clear value.
+    Color        = 1 << 5,
+    // The bound framebuffer, the viewport and the scissor test.
+    Framebuffer  = 1 << 6,
+    // Everything else, e.g. the line width.
+    Other        = 1 << 7,
+    All          = (1 << 8) - 1,
+};
+
+MBGL_CONSTEXPR CustomLayerGLState operator|(CustomLayerGLState lhs, CustomLayerGLState rhs) {
+    return CustomLayerGLState(mbgl::underlying_type(lhs) | mbgl::underlying_type(rhs));
+}
+
+MBGL_CONSTEXPR bool operator&(CustomLayerGLState lhs, CustomLayerGLState rhs) {
+    return mbgl::underlying_type(lhs) & mbgl::underlying_type(rhs);
+}
+
 /**
  * Destroy any GL state needed by the custom layer, and deallocate context, if necessary. This
  * method is called once, from the main thread, at a point when the GL context is active.
@@ -62,6 +115,13 @@ public:
     void setMinZoom(float) final;
     void setMaxZoom(float) final;
 
+    // Called during the upload pass of every frame the layer is rendered in; none by default.
+    void setPrepareFunction(CustomLayerPrepareFunction);
+
+    // The GL state the layer's functions may change; all of it by default.
+    void setModifiedGLState(CustomLayerGLState);
+    CustomLayerGLState getModifiedGLState() const;
+
     // Private implementation
 
     class Impl;
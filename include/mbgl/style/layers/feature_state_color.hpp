@@ -0,0 +1,22 @@
+#pragma once
+
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/optional.hpp>
+
+namespace mbgl {
+namespace style {
+
+// Circle and fill layers with a state color mix it into the color of each feature by the state
+// of the feature, as set with Renderer::setFeatureState(): a feature with state 1 is drawn in the
+// state color, one without state in its own. Opacity still applies. Changing feature states
+// doesn't lay out tiles again, so it's cheap enough to do on hover.
+optional<Color> getCircleStateColor(const CircleLayer&);
+void setCircleStateColor(CircleLayer&, optional<Color>);
+
+optional<Color> getFillStateColor(const FillLayer&);
+void setFillStateColor(FillLayer&, optional<Color>);
+
+} // namespace style
+} // namespace mbgl
@@ -12,6 +12,7 @@
 namespace mbgl {
 
 class FileSource;
+class Scheduler;
 
 namespace style {
 
@@ -68,6 +69,11 @@ public:
     void setObserver(SourceObserver*);
     SourceObserver* observer = nullptr;
 
+    // The style's worker scheduler while the source is part of a style, for sources that prepare
+    // their data in the background.
+    void setScheduler(Scheduler*);
+    Scheduler* scheduler = nullptr;
+
     virtual void loadDescription(FileSource&) = 0;
     void dumpDebugLogs() const;
 
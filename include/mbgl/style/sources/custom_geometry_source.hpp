@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mbgl/style/source.hpp>
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/geo.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace mbgl {
+
+class CanonicalTileID;
+
+namespace style {
+
+// Returns the features of a tile, in longitude and latitude; they're clipped to the tile and its
+// buffer afterwards. Called on a worker thread, possibly for several tiles at once. `cancelled`
+// is set once the tile isn't needed anymore, in which case the features aren't used and the
+// function may return early.
+using CustomTileFunction = std::function<GeoJSON(const CanonicalTileID&, const std::atomic<bool>& cancelled)>;
+
+struct CustomGeometrySourceOptions {
+    CustomTileFunction fetchTile;
+
+    uint8_t minzoom = 0;
+    uint8_t maxzoom = 18;
+
+    // As for GeoJSON sources, in pixels.
+    uint16_t buffer = 128;
+    double tolerance = 0.375;
+};
+
+// A source whose tiles are generated on demand for the tiles that are rendered, rather than
+// sliced from data that is indexed up front, e.g. for procedural grids. Once generated, tiles
+// are laid out like those of GeoJSON sources.
+class CustomGeometrySource : public Source {
+public:
+    CustomGeometrySource(std::string id, CustomGeometrySourceOptions);
+    ~CustomGeometrySource() final;
+
+    // Generates the tiles within the bounds again, e.g. because the data changed; tiles keep
+    // rendering their current features until then.
+    void invalidateRegion(const LatLngBounds&);
+    void invalidateTile(const CanonicalTileID&);
+
+    class Impl;
+    const Impl& impl() const;
+
+    void loadDescription(FileSource&) final;
+};
+
+template <>
+inline bool Source::is<CustomGeometrySource>() const {
+    return getType() == SourceType::CustomGeometry;
+}
+
+} // namespace style
+} // namespace mbgl
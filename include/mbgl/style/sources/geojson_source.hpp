@@ -2,21 +2,38 @@
 
 #include <mbgl/style/source.hpp>
 #include <mbgl/util/geojson.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace mbgl {
 
 class AsyncRequest;
+class Mailbox;
+template <class> class Actor;
 
 namespace style {
 
+class GeoJSONData;
+
 struct GeoJSONOptions {
     // GeoJSON-VT options
     uint8_t maxzoom = 18;
     uint16_t buffer = 128;
     double tolerance = 0.375;
 
-    // Supercluster options
+    // The data is tiled up front up to indexMaxZoom, or until tiles have at most indexMaxPoints
+    // points. Deeper tiles are sliced from their parents when they're first requested, so
+    // an indexMaxZoom of 0 tiles large data lazily, at the cost of slower first tiles.
+    uint8_t indexMaxZoom = 5;
+    uint32_t indexMaxPoints = 100000;
+
+    // Supercluster options. Clustered sources only hold the point features of the data; other
+    // geometries are left out of the clusters and of the tiles.
     bool cluster = false;
     uint16_t clusterRadius = 50;
     uint8_t clusterMaxZoom = 17;
@@ -28,8 +45,21 @@ public:
     ~GeoJSONSource() final;
 
     void setURL(const std::string& url);
+
+    // Once the source is part of a style, its index is built on the style's worker scheduler.
+    // The source keeps rendering its current data, and isn't loaded, until the index is ready.
     void setGeoJSON(const GeoJSON&);
 
+    // Sets the data from geobuf, which is decoded without going through JSON. Data from a URL
+    // may be geobuf too. Malformed data is reported to the observer as a source error.
+    void setGeobuf(const std::string&);
+
+    // Adds the features, replacing the features with the same IDs, and removes the features with
+    // the removed IDs. Unless the source is clustered, only the tiles that the changed features
+    // are in are laid out again.
+    void updateGeoJSON(const FeatureCollection& features,
+                       const std::vector<FeatureIdentifier>& removed = {});
+
     optional<std::string> getURL() const;
 
     class Impl;
@@ -38,8 +68,34 @@ public:
     void loadDescription(FileSource&) final;
 
 private:
+    class Worker;
+
+    struct FeatureUpdate {
+        FeatureCollection features;
+        std::vector<FeatureIdentifier> removed;
+    };
+
+    void build(GeoJSON, bool fromURL);
+    void update();
+    void createWorker();
+    void onBuilt(std::unique_ptr<GeoJSONData>, uint64_t version, bool fromURL);
+    void onUpdated(std::shared_ptr<const GeoJSON>, std::unique_ptr<GeoJSONData>, LatLngBounds changed, uint64_t version);
+    void setData(std::unique_ptr<GeoJSONData>, optional<LatLngBounds> changed, bool fromURL);
+
     optional<std::string> url;
     std::unique_ptr<AsyncRequest> req;
+
+    // The version of the latest data, and whether its index is still being built.
+    std::atomic<uint64_t> version { 0 };
+    bool building = false;
+
+    // The latest data, which updates apply to, and the updates that wait for its index.
+    std::shared_ptr<const GeoJSON> snapshot;
+    std::vector<FeatureUpdate> pendingUpdates;
+
+    std::shared_ptr<Mailbox> mailbox;
+    Scheduler* workerScheduler = nullptr;
+    std::unique_ptr<Actor<Worker>> worker;
 };
 
 template <>
@@ -4,6 +4,8 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <vector>
+
 namespace mbgl {
 class LatLng;
 class AsyncRequest;
@@ -20,6 +22,14 @@ public:
 
     void setImage(PremultipliedImage&&);
 
+    // Replaces the image with a sequence of frames, showing the first. All of them are uploaded
+    // as soon as the source is drawn, so that animating it with setFrame() is cheap.
+    void setFrames(std::vector<PremultipliedImage>&&);
+    // Shows the frame at the index. Indices beyond the frames are ignored.
+    void setFrame(std::size_t);
+    std::size_t getFrame() const;
+    std::size_t getFrameCount() const;
+
     void setCoordinates(const std::array<LatLng, 4>&);
     std::array<LatLng, 4> getCoordinates() const;
 
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <mbgl/style/sources/raster_source.hpp>
+
+namespace mbgl {
+namespace style {
+
+/**
+ * A source of elevation tiles in the Mapbox Terrain-RGB encoding. Raster layers draw it as
+ * hillshading instead of drawing the tiles' colors.
+ */
+class RasterDEMSource : public RasterSource {
+public:
+    RasterDEMSource(std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize);
+};
+
+template <>
+inline bool Source::is<RasterDEMSource>() const {
+    return getType() == SourceType::RasterDEM;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -13,7 +13,7 @@ namespace style {
 class RasterSource : public Source {
 public:
     RasterSource(std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize);
-    ~RasterSource() final;
+    ~RasterSource() override;
 
     const variant<std::string, Tileset>& getURLOrTileset() const;
     optional<std::string> getURL() const;
@@ -25,6 +25,9 @@ public:
 
     void loadDescription(FileSource&) final;
 
+protected:
+    RasterSource(SourceType, std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize);
+
 private:
     const variant<std::string, Tileset> urlOrTileset;
     std::unique_ptr<AsyncRequest> req;
@@ -32,7 +35,7 @@ private:
 
 template <>
 inline bool Source::is<RasterSource>() const {
-    return getType() == SourceType::Raster;
+    return getType() == SourceType::Raster || getType() == SourceType::RasterDEM;
 }
 
 } // namespace style
@@ -18,6 +18,12 @@ public:
     const variant<std::string, Tileset>& getURLOrTileset() const;
     optional<std::string> getURL() const;
 
+    // Lines and polygons are simplified before they are rendered, dropping points that are less
+    // than this many pixels away from the simplified shape at the zoom level a tile is rendered
+    // for. Defaults to 0, which renders them at the full resolution of the source.
+    void setSimplificationTolerance(float);
+    float getSimplificationTolerance() const;
+
     class Impl;
     const Impl& impl() const;
 
@@ -72,6 +72,13 @@ public:
     void addLayer(std::unique_ptr<Layer>, const optional<std::string>& beforeLayerID = {});
     std::unique_ptr<Layer> removeLayer(const std::string& layerID);
 
+    // Batching: from beginBatch() until the matching commitBatch(), changes to sources and
+    // layers, including their properties and filters, apply right away but are only rendered
+    // once the outermost batch is committed, so that many changes cost a single update rather
+    // than one each. Batches may be nested.
+    void beginBatch();
+    void commitBatch();
+
     // Private implementation
     class Impl;
     const std::unique_ptr<Impl> impl;
@@ -11,7 +11,9 @@ enum class SourceType : uint8_t {
     GeoJSON,
     Video,
     Annotations,
-    Image
+    Image,
+    RasterDEM,
+    CustomGeometry
 };
 
 namespace style {
@@ -1,12 +1,39 @@
 #pragma once
 
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace util {
 
 std::string compress(const std::string& raw);
+// Compresses with zlib at the given level, from 0 to 9, or the default level for -1.
+std::string compress(const std::string& raw, int level);
 std::string decompress(const std::string& raw);
 
+// Codecs for data at rest. The values are persisted, e.g. in the offline database, and must
+// remain stable.
+enum class Codec : uint8_t {
+    None = 0,
+    Zlib = 1,
+    Zstd = 2,
+};
+
+// Zstd is only available in builds configured with WITH_ZSTD.
+bool isCodecAvailable(Codec);
+
+// Dictionaries are ignored by codecs that don't support them. Data compressed with a
+// dictionary must be decompressed with the same dictionary.
+std::string compress(const std::string& raw, Codec, const std::string& dictionary = {});
+std::string decompress(const std::string& raw, Codec, const std::string& dictionary = {});
+
+// Trains a dictionary of at most `size` bytes from samples representative of the data to be
+// compressed. Returns nothing if the codec doesn't support dictionaries or the samples don't
+// suffice.
+optional<std::string> trainDictionary(Codec, const std::vector<std::string>& samples, std::size_t size);
+
 } // namespace util
 } // namespace mbgl
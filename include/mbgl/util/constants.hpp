@@ -42,6 +42,11 @@ constexpr uint8_t DEFAULT_PREFETCH_ZOOM_DELTA = 4;
 
 constexpr uint64_t DEFAULT_MAX_CACHE_SIZE = 50 * 1024 * 1024;
 
+constexpr uint64_t DEFAULT_TILE_CACHE_SIZE = 32 * 1024 * 1024;
+
+// Maximum size of tile data kept alive by the process-wide cache of parsed vector tiles.
+constexpr uint64_t DEFAULT_VECTOR_TILE_DATA_CACHE_SIZE = 16 * 1024 * 1024;
+
 constexpr Duration DEFAULT_TRANSITION_DURATION = Milliseconds(300);
 constexpr Seconds CLOCK_SKEW_RETRY_TIMEOUT { 30 };
 
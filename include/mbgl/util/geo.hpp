@@ -108,6 +108,10 @@ public:
     // Constructs a LatLngBounds object with the tile's exact boundaries.
     LatLngBounds(const CanonicalTileID&);
 
+    // Constructs a LatLngBounds object with the tile's boundaries, extended on each side by the
+    // fraction of the tile's size. Longitudes may extend past the antimeridian.
+    LatLngBounds(const CanonicalTileID&, double buffer);
+
     bool valid() const {
         return (sw.latitude() <= ne.latitude()) && (sw.longitude() <= ne.longitude());
     }
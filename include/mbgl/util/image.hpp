@@ -7,6 +7,7 @@
 #include <string>
 #include <memory>
 #include <algorithm>
+#include <vector>
 
 namespace mbgl {
 
@@ -91,6 +92,37 @@ public:
         operator=(std::move(newImage));
     }
 
+    // Averages blocks of `factor` × `factor` pixels into one, dropping the rows and columns that
+    // don't fill a block. The average is only exact for premultiplied colors.
+    Image downsample(uint32_t factor) const {
+        if (factor <= 1) {
+            return clone();
+        }
+
+        Image result({ size.width / factor, size.height / factor });
+        const uint32_t area = factor * factor;
+        std::vector<uint32_t> sums(result.stride());
+
+        for (uint32_t y = 0; y < result.size.height; y++) {
+            std::fill(sums.begin(), sums.end(), 0);
+            for (uint32_t row = y * factor; row < (y + 1) * factor; row++) {
+                const uint8_t* src = data.get() + row * stride();
+                for (uint32_t x = 0; x < result.size.width; x++) {
+                    for (uint32_t i = 0; i < factor * channels; i++) {
+                        sums[x * channels + i % channels] += *src++;
+                    }
+                }
+            }
+
+            uint8_t* dst = result.data.get() + y * result.stride();
+            for (const uint32_t sum : sums) {
+                *dst++ = (sum + area / 2) / area;
+            }
+        }
+
+        return result;
+    }
+
     // Copy image data within `rect` from `src` to the rectangle of the same size at `pt`
     // in `dst`. If the specified bounds exceed the bounds of the source or destination,
     // throw `std::out_of_range`. Must not be used to move data within a single Image.
@@ -145,7 +177,11 @@ using PremultipliedImage = Image<ImageAlphaMode::Premultiplied>;
 using AlphaImage = Image<ImageAlphaMode::Exclusive>;
 
 // TODO: don't use std::string for binary data.
-PremultipliedImage decodeImage(const std::string&);
-std::string encodePNG(const PremultipliedImage&);
+// Decoders that can do so cheaply reduce the image by a power of two, for as long as it stays at
+// least `minimumSize`. An empty size decodes the image at full resolution.
+PremultipliedImage decodeImage(const std::string&, Size minimumSize = {});
+// The compression level ranges from 0 (no compression) to 9 (best compression); -1 selects the
+// default level.
+std::string encodePNG(const PremultipliedImage&, int compressionLevel = -1);
 
 } // namespace mbgl
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -20,9 +21,32 @@ std::string getCurrentThreadName();
 // Set the name of the current thread, truncated at 15.
 void setCurrentThreadName(const std::string& name);
 
+// How urgent the work of a thread is, from work that nobody waits for, like offline downloads,
+// to work the user is waiting for, like laying out the tiles coming into view during a gesture.
+enum class ThreadPriority : uint8_t {
+    Background,
+    Low,
+    Normal,
+    Interactive,
+};
+
+// Sets the priority of the current thread, using the platform's classes of service where there
+// are any. Raising the priority may not be permitted, in which case it stays as it is.
+void setCurrentThreadPriority(ThreadPriority);
+
 // Makes the current thread low priority.
 void makeThreadLowPriority();
 
+// Which cores a thread runs on, on devices with cores of different speeds.
+enum class ThreadAffinity : uint8_t {
+    Any,
+    // Only the fastest cores of the device, where the platform allows choosing.
+    PerformanceCores,
+};
+
+// Restricts the cores the current thread runs on.
+void setCurrentThreadAffinity(ThreadAffinity);
+
 // Shows an alpha image with the specified dimensions in a named window.
 void showDebugImage(std::string name, const char *data, size_t width, size_t height);
 
@@ -2,11 +2,19 @@
 
 #include <mbgl/util/image.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace mbgl {
 namespace util {
 
 PremultipliedImage premultiply(UnassociatedImage&&);
 UnassociatedImage unpremultiply(PremultipliedImage&&);
 
+// Convert `bytes` bytes of RGBA pixels in place, or from `src` into `dst` for unpremultiply(),
+// which may be the same buffer.
+void premultiply(uint8_t* data, std::size_t bytes);
+void unpremultiply(const uint8_t* src, uint8_t* dst, std::size_t bytes);
+
 } // namespace util
 } // namespace mbgl
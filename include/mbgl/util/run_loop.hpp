@@ -16,6 +16,8 @@
 namespace mbgl {
 namespace util {
 
+class TimerWheel;
+
 using LOOP_HANDLE = void *;
 
 class RunLoop : public Scheduler,
@@ -51,7 +53,7 @@ public:
     template <class Fn, class... Args>
     void invoke(Fn&& fn, Args&&... args) {
         std::shared_ptr<WorkTask> task = WorkTask::make(std::forward<Fn>(fn), std::forward<Args>(args)...);
-        push(task);
+        push({ std::move(task), {} });
     }
 
     // Post the cancellable work fn(args...) to this RunLoop.
@@ -59,23 +61,46 @@ public:
     std::unique_ptr<AsyncRequest>
     invokeCancellable(Fn&& fn, Args&&... args) {
         std::shared_ptr<WorkTask> task = WorkTask::make(std::forward<Fn>(fn), std::forward<Args>(args)...);
-        push(task);
+        push({ task, {} });
         return std::make_unique<WorkRequest>(task);
     }
 
     class Impl;
 
 private:
+    friend class TimerWheel;
+
     MBGL_STORE_THREAD(tid)
 
-    using Queue = std::queue<std::shared_ptr<WorkTask>>;
+    // A task, or a mailbox with a message to receive. Mailboxes are queued as they are rather
+    // than in a task of their own, which saves an allocation for every message sent to an actor
+    // on this loop, such as the results of the tile workers.
+    struct Entry {
+        std::shared_ptr<WorkTask> task;
+        std::weak_ptr<Mailbox> mailbox;
+    };
 
-    void push(std::shared_ptr<WorkTask>);
+    using Queue = std::queue<Entry>;
 
-    void schedule(std::weak_ptr<Mailbox> mailbox) override {
-        invoke([mailbox] () {
-            Mailbox::maybeReceive(mailbox);
+    void push(Entry entry) {
+        bool wasEmpty = false;
+        withMutex([&] {
+            wasEmpty = queue.empty();
+            queue.push(std::move(entry));
         });
+
+        // Otherwise the loop has been woken up already, and hasn't taken the queue yet; everything
+        // queued in the meantime is processed in the same batch.
+        if (wasEmpty) {
+            wake();
+        }
+    }
+
+    // Makes the loop process the queue.
+    void wake();
+
+    void schedule(std::weak_ptr<Mailbox> mailbox) override {
+        push({ {}, std::move(mailbox) });
     }
 
     void withMutex(std::function<void()>&& fn) {
@@ -88,7 +113,12 @@ private:
         withMutex([&] { queue_.swap(queue); });
 
         while (!queue_.empty()) {
-            (*(queue_.front()))();
+            Entry& entry = queue_.front();
+            if (entry.task) {
+                (*entry.task)();
+            } else {
+                Mailbox::maybeReceive(entry.mailbox);
+            }
             queue_.pop();
         }
     }
@@ -97,6 +127,10 @@ private:
     std::mutex mutex;
 
     std::unique_ptr<Impl> impl;
+
+    // Created once a timer is started on it. Declared after the implementation, so that the
+    // wheel's timer is destroyed while the loop is still there.
+    std::shared_ptr<TimerWheel> timerWheel;
 };
 
 } // namespace util
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/util/optional.hpp>
 #include <mbgl/util/range.hpp>
 
 #include <vector>
@@ -17,6 +18,15 @@ public:
     std::string attribution;
     Scheme scheme;
 
+    // A URL that lists the tiles that changed since a given time, which lets offline regions
+    // refresh only those. Not part of the TileJSON specification; see OfflineDownload::refresh().
+    optional<std::string> manifest;
+
+    // A URL template of an endpoint that returns several tiles in one response, which saves
+    // the round trips of requesting small tiles one by one over high-latency connections. Not
+    // part of the TileJSON specification; see tile_batch.hpp.
+    optional<std::string> batch;
+
     Tileset(std::vector<std::string> tiles_ = std::vector<std::string>(),
             Range<uint8_t> zoomRange_ = { 0, 22 },
             std::string attribution_ = {},
@@ -29,8 +39,8 @@ public:
     // TileJSON also includes center, zoom, and bounds, but they are not used by mbgl.
 
     friend bool operator==(const Tileset& lhs, const Tileset& rhs) {
-        return std::tie(lhs.tiles, lhs.zoomRange, lhs.attribution, lhs.scheme)
-            == std::tie(rhs.tiles, rhs.zoomRange, rhs.attribution, rhs.scheme);
+        return std::tie(lhs.tiles, lhs.zoomRange, lhs.attribution, lhs.scheme, lhs.manifest, lhs.batch)
+            == std::tie(rhs.tiles, rhs.zoomRange, rhs.attribution, rhs.scheme, rhs.manifest, rhs.batch);
     }
 };
 
@@ -39,6 +39,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/default_file_source.cpp
         PRIVATE platform/default/asset_file_source.cpp
         PRIVATE platform/default/local_file_source.cpp
+        PRIVATE platform/default/pack_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
 
         # Offline
@@ -53,8 +54,10 @@ macro(mbgl_platform_core)
         # Misc
         PRIVATE platform/android/src/logging_android.cpp
         PRIVATE platform/android/src/thread.cpp
+        PRIVATE platform/default/thread_affinity.cpp
         PRIVATE platform/default/string_stdlib.cpp
         PRIVATE platform/default/bidi.cpp
+        PRIVATE platform/default/local_glyph_rasterizer.cpp
         PRIVATE platform/default/thread_local.cpp
         PRIVATE platform/default/utf.cpp
 
@@ -71,6 +74,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/util/shared_thread_pool.hpp
         PRIVATE platform/default/mbgl/util/default_thread_pool.cpp
         PRIVATE platform/default/mbgl/util/default_thread_pool.hpp
+        PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.cpp
+        PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.hpp
 
         # Rendering
         PRIVATE platform/android/src/android_renderer_frontend.cpp
@@ -190,4 +190,8 @@ uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
 
+void HTTPFileSource::setHTTP2Multiplexing(bool, uint32_t) {
+    // OkHttp negotiates HTTP/2 and multiplexes on its own.
+}
+
 } // namespace mbgl
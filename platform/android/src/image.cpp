@@ -8,7 +8,7 @@
 
 namespace mbgl {
 
-PremultipliedImage decodeImage(const std::string& string) {
+PremultipliedImage decodeImage(const std::string& string, Size) {
     auto env{ android::AttachEnv() };
 
     auto array = jni::Array<jni::jbyte>::New(*env, string.size());
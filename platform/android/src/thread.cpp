@@ -25,12 +25,25 @@ void setCurrentThreadName(const std::string& name) {
     }
 }
 
-void makeThreadLowPriority() {
-    // ANDROID_PRIORITY_LOWEST = 19
-    //
+void setCurrentThreadPriority(ThreadPriority priority) {
     // Supposedly would set the priority for the whole process, but
     // on Linux/Android it only sets for the current thread.
-    setpriority(PRIO_PROCESS, 0, 19);
+    switch (priority) {
+    case ThreadPriority::Background:
+    case ThreadPriority::Low:
+        setpriority(PRIO_PROCESS, 0, 19); // ANDROID_PRIORITY_LOWEST
+        break;
+    case ThreadPriority::Normal:
+        setpriority(PRIO_PROCESS, 0, 0); // ANDROID_PRIORITY_NORMAL
+        break;
+    case ThreadPriority::Interactive:
+        setpriority(PRIO_PROCESS, 0, -4); // ANDROID_PRIORITY_DISPLAY
+        break;
+    }
+}
+
+void makeThreadLowPriority() {
+    setCurrentThreadPriority(ThreadPriority::Low);
 }
 
 } // namespace platform
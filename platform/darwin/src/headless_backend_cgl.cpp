@@ -10,7 +10,8 @@
 namespace mbgl {
 
 struct CGLImpl : public HeadlessBackend::Impl {
-    CGLImpl(CGLContextObj glContext_) : glContext(glContext_) {
+    CGLImpl(CGLContextObj glContext_, CGLPixelFormatObj pixelFormat_)
+        : glContext(glContext_), pixelFormat(pixelFormat_) {
     }
 
     ~CGLImpl() {
@@ -33,7 +34,17 @@ struct CGLImpl : public HeadlessBackend::Impl {
         }
     }
 
+    std::unique_ptr<HeadlessBackend::Impl> createSharedContext() final {
+        CGLContextObj sharedContext = nullptr;
+        if (CGLCreateContext(pixelFormat, glContext, &sharedContext) != kCGLNoError) {
+            return nullptr;
+        }
+        return std::make_unique<CGLImpl>(sharedContext, pixelFormat);
+    }
+
     CGLContextObj glContext = nullptr;
+    // Owned by the HeadlessDisplay.
+    CGLPixelFormatObj pixelFormat = nullptr;
 };
 
 gl::ProcAddress HeadlessBackend::initializeExtension(const char* name) {
@@ -59,8 +70,9 @@ bool HeadlessBackend::hasDisplay() {
 void HeadlessBackend::createContext() {
     assert(!hasContext());
 
+    CGLPixelFormatObj pixelFormat = display->attribute<CGLPixelFormatObj>();
     CGLContextObj glContext = nullptr;
-    CGLError error = CGLCreateContext(display->attribute<CGLPixelFormatObj>(), nullptr, &glContext);
+    CGLError error = CGLCreateContext(pixelFormat, nullptr, &glContext);
     if (error != kCGLNoError) {
         throw std::runtime_error(std::string("Error creating GL context object:") +
                                  CGLErrorString(error) + "\n");
@@ -72,7 +84,7 @@ void HeadlessBackend::createContext() {
                                  CGLErrorString(error) + "\n");
     }
 
-    impl.reset(new CGLImpl(glContext));
+    impl.reset(new CGLImpl(glContext, pixelFormat));
 }
 
 } // namespace mbgl
@@ -24,6 +24,17 @@ struct EAGLImpl : public HeadlessBackend::Impl {
         [EAGLContext setCurrentContext:nil];
     }
 
+    std::unique_ptr<HeadlessBackend::Impl> createSharedContext() {
+        EAGLContext* sharedContext = [[EAGLContext alloc] initWithAPI:kEAGLRenderingAPIOpenGLES2
+                                                           sharegroup:glContext.sharegroup];
+        if (sharedContext == nil) {
+            return nullptr;
+        }
+        auto result = std::make_unique<EAGLImpl>(sharedContext);
+        [sharedContext release];
+        return std::move(result);
+    }
+
     EAGLContext* glContext = nullptr;
 };
 
@@ -196,6 +196,10 @@ uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
 
+void HTTPFileSource::setHTTP2Multiplexing(bool, uint32_t) {
+    // NSURLSession negotiates HTTP/2 and multiplexes on its own.
+}
+
 std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource, Callback callback) {
     auto request = std::make_unique<HTTPRequest>(callback);
     auto shared = request->shared; // Explicit copy so that it also gets copied into the completion handler block below.
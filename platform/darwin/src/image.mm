@@ -83,7 +83,19 @@ mbgl::PremultipliedImage MGLPremultipliedImageFromCGImage(CGImageRef src) {
 
 namespace mbgl {
 
-PremultipliedImage decodeImage(const std::string& source) {
+PremultipliedImage decodeWebP(const uint8_t*, size_t, Size minimumSize);
+
+PremultipliedImage decodeImage(const std::string& source, Size minimumSize) {
+    // ImageIO only reads WebP on recent OS versions, so it's decoded with libwebp everywhere.
+    const auto* bytes = reinterpret_cast<const uint8_t*>(source.data());
+    if (source.size() >= 12) {
+        uint32_t riff_magic = (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+        uint32_t webp_magic = (bytes[8] << 24) | (bytes[9] << 16) | (bytes[10] << 8) | bytes[11];
+        if (riff_magic == 0x52494646 && webp_magic == 0x57454250) {
+            return decodeWebP(bytes, source.size(), minimumSize);
+        }
+    }
+
     CFDataHandle data(CFDataCreateWithBytesNoCopy(
         kCFAllocatorDefault, reinterpret_cast<const unsigned char*>(source.data()), source.size(),
         kCFAllocatorNull));
@@ -3,6 +3,7 @@
 #include <mbgl/util/platform.hpp>
 
 #include <pthread.h>
+#include <pthread/qos.h>
 
 namespace mbgl {
 namespace platform {
@@ -19,8 +20,32 @@ void setCurrentThreadName(const std::string& name) {
     pthread_setname_np(qualifiedName.c_str());
 }
 
+void setCurrentThreadPriority(ThreadPriority priority) {
+    qos_class_t qos = QOS_CLASS_DEFAULT;
+    switch (priority) {
+    case ThreadPriority::Background:
+        qos = QOS_CLASS_BACKGROUND;
+        break;
+    case ThreadPriority::Low:
+        qos = QOS_CLASS_UTILITY;
+        break;
+    case ThreadPriority::Normal:
+        qos = QOS_CLASS_DEFAULT;
+        break;
+    case ThreadPriority::Interactive:
+        qos = QOS_CLASS_USER_INITIATED;
+        break;
+    }
+    pthread_set_qos_class_self_np(qos, 0);
+}
+
 void makeThreadLowPriority() {
-    [[NSThread currentThread] setThreadPriority:0.0];
+    setCurrentThreadPriority(ThreadPriority::Low);
+}
+
+// The cores can't be chosen, but the scheduler prefers the performance cores for threads of
+// higher classes of service.
+void setCurrentThreadAffinity(ThreadAffinity) {
 }
 
 }
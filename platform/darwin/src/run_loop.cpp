@@ -35,8 +35,7 @@ RunLoop::~RunLoop() {
     current().set(nullptr);
 }
 
-void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+void RunLoop::wake() {
     impl->async->send();
 }
 
@@ -1,8 +1,9 @@
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/string.hpp>
-#include <mbgl/util/thread.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/util.hpp>
 #include <mbgl/util/io.hpp>
@@ -10,6 +11,14 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+namespace {
+
+// Styles, sprites, glyphs and tiles bundled with an application are often requested all at
+// once on startup.
+const std::size_t readerCount = 4;
+
+} // namespace
+
 namespace mbgl {
 
 class AssetFileSource::Impl {
@@ -56,7 +65,10 @@ private:
 };
 
 AssetFileSource::AssetFileSource(const std::string& root)
-    : impl(std::make_unique<util::Thread<Impl>>("AssetFileSource", root)) {
+    : threadPool(std::make_unique<ThreadPool>(readerCount)) {
+    for (std::size_t i = 0; i < readerCount; i++) {
+        impls.push_back(std::make_unique<Actor<Impl>>(*threadPool, root));
+    }
 }
 
 AssetFileSource::~AssetFileSource() = default;
@@ -64,7 +76,8 @@ AssetFileSource::~AssetFileSource() = default;
 std::unique_ptr<AsyncRequest> AssetFileSource::request(const Resource& resource, Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
-    impl->actor().invoke(&Impl::request, resource.url, req->actor());
+    impls[nextImpl]->invoke(&Impl::request, resource.url, req->actor());
+    nextImpl = (nextImpl + 1) % impls.size();
 
     return std::move(req);
 }
@@ -3,16 +3,26 @@
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/local_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/pack_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
 #include <mbgl/storage/resource_transform.hpp>
+#include <mbgl/storage/response_cache.hpp>
 
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
+#include <mbgl/util/trace.hpp>
 #include <mbgl/util/work_request.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <thread>
 
 namespace {
 
@@ -26,12 +36,94 @@ bool isAssetURL(const std::string& url) {
 
 namespace mbgl {
 
+namespace {
+
+bool isCacheable(const std::string& url) {
+    return !isAssetURL(url) && !LocalFileSource::acceptsURL(url) && !PackFileSource::acceptsURL(url);
+}
+
+// Looks `resource` up in the cache, first in memory, then in the database, unless the caller
+// already has a copy of it, and prepares `revalidation` to request it conditionally from the
+// network. Lookups are counted in `hits` and `misses`.
+optional<Response> getCached(ResponseCache& memoryCache, OfflineDatabase& database,
+                             const Resource& resource, Resource& revalidation,
+                             std::atomic<uint64_t>& hits, std::atomic<uint64_t>& misses) {
+    optional<Response> offlineResponse;
+
+    const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
+    if (!hasPrior || resource.necessity == Resource::Optional) {
+        offlineResponse = memoryCache.get(resource);
+        if (offlineResponse) {
+            database.recordAccess(resource);
+        } else {
+            const util::trace::Span span("cache lookup", util::trace::tileOf(resource));
+            offlineResponse = database.get(resource);
+            if (offlineResponse) {
+                memoryCache.add(resource, *offlineResponse);
+            }
+        }
+
+        if (offlineResponse) {
+            hits++;
+        } else {
+            misses++;
+        }
+
+        if ((resource.necessity == Resource::Optional || resource.concurrentNetworkRequest) && !offlineResponse) {
+            // Ensure there's always a response that we can send, so the caller knows that
+            // there's no optional data available in the cache.
+            offlineResponse.emplace();
+            offlineResponse->noContent = true;
+            offlineResponse->error = std::make_unique<Response::Error>(
+                    Response::Error::Reason::NotFound, "Not found in offline database");
+        }
+
+        if (offlineResponse) {
+            revalidation.priorModified = offlineResponse->modified;
+            revalidation.priorExpires = offlineResponse->expires;
+            revalidation.priorEtag = offlineResponse->etag;
+        }
+    }
+
+    return offlineResponse;
+}
+
+} // namespace
+
 class DefaultFileSource::Impl {
 public:
-    Impl(ActorRef<Impl>, std::shared_ptr<FileSource> assetFileSource_, const std::string& cachePath, uint64_t maximumCacheSize)
+    Impl(ActorRef<Impl>, std::shared_ptr<FileSource> assetFileSource_, ResponseCache& memoryCache_,
+         std::atomic<uint64_t>& cacheHits_, std::atomic<uint64_t>& cacheMisses_, std::atomic<bool>& readersEnabled_)
             : assetFileSource(assetFileSource_)
             , localFileSource(std::make_unique<LocalFileSource>())
-            , offlineDatabase(cachePath, maximumCacheSize) {
+            , packFileSource(std::make_unique<PackFileSource>())
+            , memoryCache(memoryCache_)
+            , cacheHits(cacheHits_)
+            , cacheMisses(cacheMisses_)
+            , readersEnabled(readersEnabled_) {
+    }
+
+    // Opening the database may migrate its schema, which can take a while on large caches. It's
+    // the first message the Impl gets, so it's done on this thread before anything else uses the
+    // database, without holding up the thread that creates the file source. The cache readers
+    // connect to the database only once it has been opened here, and not at all if it couldn't.
+    void open(const std::string& cachePath, uint64_t maximumCacheSize, bool concurrentReads) {
+        try {
+            offlineDatabase = std::make_unique<OfflineDatabase>(cachePath, maximumCacheSize);
+        } catch (const std::exception& ex) {
+            Log::Error(Event::Database, "Unable to open the cache, using one in memory: %s", ex.what());
+            offlineDatabase = std::make_unique<OfflineDatabase>(":memory:", maximumCacheSize);
+            return;
+        }
+
+        if (concurrentReads) {
+            try {
+                offlineDatabase->enableConcurrentReads();
+                readersEnabled = true;
+            } catch (const std::exception& ex) {
+                Log::Error(Event::Database, "Unable to enable concurrent reads: %s", ex.what());
+            }
+        }
     }
 
     void setAPIBaseURL(const std::string& url) {
@@ -54,9 +146,21 @@ public:
         onlineFileSource.setResourceTransform(std::move(transform));
     }
 
+    void setSynchronousResourceTransform(std::function<std::string(Resource::Kind, const std::string&)> transform) {
+        onlineFileSource.setSynchronousResourceTransform(std::move(transform));
+    }
+
+    void setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost) {
+        onlineFileSource.setHTTP2Multiplexing(enabled, maximumStreamsPerHost);
+    }
+
+    void setAdaptiveConcurrency(bool enabled) {
+        onlineFileSource.setAdaptiveConcurrency(enabled);
+    }
+
     void listRegions(std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
         try {
-            callback({}, offlineDatabase.listRegions());
+            callback({}, offlineDatabase->listRegions());
         } catch (...) {
             callback(std::current_exception(), {});
         }
@@ -66,7 +170,7 @@ public:
                       const OfflineRegionMetadata& metadata,
                       std::function<void (std::exception_ptr, optional<OfflineRegion>)> callback) {
         try {
-            callback({}, offlineDatabase.createRegion(definition, metadata));
+            callback({}, offlineDatabase->createRegion(definition, metadata));
         } catch (...) {
             callback(std::current_exception(), {});
         }
@@ -76,7 +180,7 @@ public:
                       const OfflineRegionMetadata& metadata,
                       std::function<void (std::exception_ptr, optional<OfflineRegionMetadata>)> callback) {
         try {
-            callback({}, offlineDatabase.updateMetadata(regionID, metadata));
+            callback({}, offlineDatabase->updateMetadata(regionID, metadata));
         } catch (...) {
             callback(std::current_exception(), {});
         }
@@ -93,7 +197,39 @@ public:
     void deleteRegion(OfflineRegion&& region, std::function<void (std::exception_ptr)> callback) {
         try {
             downloads.erase(region.getID());
-            offlineDatabase.deleteRegion(std::move(region));
+            offlineDatabase->deleteRegion(std::move(region));
+            callback({});
+        } catch (...) {
+            callback(std::current_exception());
+        }
+    }
+
+    void exportRegion(int64_t regionID, const std::string& path, std::function<void (std::exception_ptr)> callback) {
+        try {
+            offlineDatabase->exportRegion(regionID, path);
+            callback({});
+        } catch (...) {
+            callback(std::current_exception());
+        }
+    }
+
+    void importRegion(const std::string& path,
+                      std::function<void (std::exception_ptr, optional<OfflineRegion>)> callback) {
+        try {
+            callback({}, offlineDatabase->importRegion(path));
+        } catch (...) {
+            callback(std::current_exception(), {});
+        }
+    }
+
+    void putRegionResources(int64_t regionID, std::vector<std::pair<Resource, Response>> resources,
+                            std::function<void (std::exception_ptr)> callback) {
+        try {
+            if (!compressionThreadPool) {
+                compressionThreadPool = std::make_unique<ThreadPool>(
+                    std::max(1u, std::thread::hardware_concurrency()), platform::ThreadPriority::Low);
+            }
+            offlineDatabase->putRegionResources(regionID, resources, *compressionThreadPool);
             callback({});
         } catch (...) {
             callback(std::current_exception());
@@ -108,6 +244,10 @@ public:
         getDownload(regionID).setState(state);
     }
 
+    void refreshRegion(int64_t regionID) {
+        getDownload(regionID).refresh();
+    }
+
     void request(AsyncRequest* req, Resource resource, ActorRef<FileSourceRequest> ref) {
         auto callback = [ref] (const Response& res) mutable {
             ref.invoke(&FileSourceRequest::setResponse, res);
@@ -119,70 +259,334 @@ public:
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (PackFileSource::acceptsURL(resource.url)) {
+            //Tile archive request
+            tasks[req] = packFileSource->request(resource, callback);
         } else {
+            // Identical requests share a single cache lookup and network request. Joining
+            // requests start out with the most recent response, and all of them receive the
+            // responses that follow.
+            const std::string key = sharedRequestKey(resource);
+            SharedRequest& shared = sharedRequests[key];
+            shared.callbacks.emplace(req, callback);
+            sharedRequestKeys.emplace(req, key);
+
+            if (shared.callbacks.size() > 1) {
+                if (shared.latest) {
+                    callback(*shared.latest);
+                }
+                return;
+            }
+
             // Try the offline database
             Resource revalidation = resource;
+            if (auto offlineResponse = getCached(memoryCache, *offlineDatabase, resource, revalidation, cacheHits, cacheMisses)) {
+                respond(key, *offlineResponse);
+            }
 
-            const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
-            if (!hasPrior || resource.necessity == Resource::Optional) {
-                auto offlineResponse = offlineDatabase.get(resource);
-
-                if (resource.necessity == Resource::Optional && !offlineResponse) {
-                    // Ensure there's always a response that we can send, so the caller knows that
-                    // there's no optional data available in the cache.
-                    offlineResponse.emplace();
-                    offlineResponse->noContent = true;
-                    offlineResponse->error = std::make_unique<Response::Error>(
-                            Response::Error::Reason::NotFound, "Not found in offline database");
-                }
+            // Get from the online file source
+            if (resource.necessity == Resource::Required) {
+                requestOnline(key, revalidation);
+            }
+        }
+    }
+
+    // Starts the network request of a request whose cache lookup a CacheReader is about to do.
+    // Its responses are held back until the lookup is done, so that the requestor doesn't get
+    // an older cached copy after them.
+    void requestConcurrently(AsyncRequest* req, Resource resource, ActorRef<FileSourceRequest> ref) {
+        ConcurrentRequest& concurrent = concurrentRequests[req];
+        concurrent.callback = [ref] (const Response& res) mutable {
+            ref.invoke(&FileSourceRequest::setResponse, res);
+        };
+        concurrent.request = onlineFileSource.request(resource, [=] (Response onlineResponse) {
+            this->store(resource, onlineResponse);
+            ConcurrentRequest& pending = this->concurrentRequests.at(req);
+            if (pending.lookedUp) {
+                pending.callback(onlineResponse);
+            } else {
+                pending.held = std::move(onlineResponse);
+            }
+        });
+    }
 
-                if (offlineResponse) {
-                    revalidation.priorModified = offlineResponse->modified;
-                    revalidation.priorExpires = offlineResponse->expires;
-                    revalidation.priorEtag = offlineResponse->etag;
-                    callback(*offlineResponse);
+    // Continues a request whose cache lookup a CacheReader has already done.
+    void revalidate(AsyncRequest* req, Resource revalidation, optional<Response> cached, ActorRef<FileSourceRequest> ref) {
+        const bool cacheHit = cached && !cached->error;
+        if (cacheHit) {
+            offlineDatabase->recordAccess(revalidation);
+        }
+
+        if (revalidation.necessity == Resource::Optional) {
+            return;
+        }
+
+        auto concurrent = concurrentRequests.find(req);
+        if (concurrent != concurrentRequests.end()) {
+            if (!cacheHit || !revalidation.priorExpires || *revalidation.priorExpires <= util::now()) {
+                // The network request that is under way brings the data, or a newer copy of it.
+                ConcurrentRequest& pending = concurrent->second;
+                pending.lookedUp = true;
+                if (pending.held) {
+                    auto held = std::move(*pending.held);
+                    pending.held = {};
+                    pending.callback(held);
                 }
+                return;
             }
 
-            // Get from the online file source
-            if (resource.necessity == Resource::Required) {
-                tasks[req] = onlineFileSource.request(revalidation, [=] (Response onlineResponse) mutable {
-                    this->offlineDatabase.put(revalidation, onlineResponse);
-                    callback(onlineResponse);
-                });
+            // The cached copy is still fresh, so it is revalidated once it expires, like any other.
+            concurrentRequests.erase(concurrent);
+            revalidation.concurrentNetworkRequest = false;
+        }
+
+        // Requests that found the same data in the cache coalesce here.
+        const std::string key = sharedRequestKey(revalidation);
+        SharedRequest& shared = sharedRequests[key];
+        shared.callbacks.emplace(req, [ref] (const Response& res) mutable {
+            ref.invoke(&FileSourceRequest::setResponse, res);
+        });
+        sharedRequestKeys.emplace(req, key);
+
+        if (shared.callbacks.size() > 1) {
+            if (shared.latest) {
+                shared.callbacks[req](*shared.latest);
             }
+        } else {
+            // The cached copy is what a 304 revalidates, for the requests that join later.
+            if (cacheHit) {
+                shared.latest = std::move(cached);
+            }
+            requestOnline(key, revalidation);
         }
     }
 
     void cancel(AsyncRequest* req) {
         tasks.erase(req);
+        concurrentRequests.erase(req);
+
+        auto it = sharedRequestKeys.find(req);
+        if (it != sharedRequestKeys.end()) {
+            auto shared = sharedRequests.find(it->second);
+            assert(shared != sharedRequests.end());
+            shared->second.callbacks.erase(req);
+            if (shared->second.callbacks.empty()) {
+                sharedRequests.erase(shared);
+            }
+            sharedRequestKeys.erase(it);
+        }
     }
 
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
-        offlineDatabase.setOfflineMapboxTileCountLimit(limit);
+        offlineDatabase->setOfflineMapboxTileCountLimit(limit);
+    }
+
+    void setOfflineWriteBatching(Duration flushInterval, std::size_t flushSize) {
+        offlineDatabase->setWriteBatching(flushInterval, flushSize);
+
+        // Writes only check the interval as they happen; the timer bounds the time the last
+        // writes of a burst stay uncommitted.
+        flushTimer.stop();
+        if (flushSize > 1 && flushInterval > Duration::zero()) {
+            flushTimer.start(flushInterval, flushInterval, [this] {
+                try {
+                    offlineDatabase->flush();
+                } catch (const std::exception& ex) {
+                    Log::Error(Event::Database, "Unable to commit batched writes: %s", ex.what());
+                }
+            });
+        }
+    }
+
+    void setOfflineDownloadConcurrency(uint32_t maximumRequests, uint32_t maximumRequestsPerHost) {
+        downloadConcurrency = std::make_pair(maximumRequests, maximumRequestsPerHost);
+        for (auto& download : downloads) {
+            download.second->setMaximumConcurrentRequests(maximumRequests, maximumRequestsPerHost);
+        }
     }
 
     void put(const Resource& resource, const Response& response) {
-        offlineDatabase.put(resource, response);
+        offlineDatabase->put(resource, response);
+        memoryCache.remove(resource);
+        scheduleEviction();
     }
 
 private:
+    struct SharedRequest {
+        std::unique_ptr<AsyncRequest> request;
+        std::unordered_map<AsyncRequest*, std::function<void (const Response&)>> callbacks;
+        optional<Response> latest;
+    };
+
+    // Concurrent requests don't coalesce, as each waits for its own lookup.
+    struct ConcurrentRequest {
+        std::unique_ptr<AsyncRequest> request;
+        std::function<void (const Response&)> callback;
+        bool lookedUp = false;
+        optional<Response> held;
+    };
+
+    // Requests coalesce when everything that affects what they return matches. Requests of
+    // different priorities don't, so that a map doesn't wait for a tile behind an offline download.
+    static std::string sharedRequestKey(const Resource& resource) {
+        const auto timestamp = [] (const optional<Timestamp>& time) {
+            return time ? util::toString(time->time_since_epoch().count()) : std::string();
+        };
+
+        return util::toString(int(resource.kind)) + '|' +
+               util::toString(int(resource.necessity)) + '|' +
+               util::toString(int(resource.priority)) + '|' +
+               timestamp(resource.priorModified) + '|' +
+               timestamp(resource.priorExpires) + '|' +
+               resource.priorEtag.value_or("") + '|' +
+               resource.url;
+    }
+
+    void requestOnline(const std::string& key, const Resource& revalidation) {
+        sharedRequests[key].request = onlineFileSource.request(revalidation, [=] (Response onlineResponse) {
+            this->store(revalidation, onlineResponse);
+            this->respond(key, onlineResponse);
+        });
+    }
+
+    void store(const Resource& resource, const Response& onlineResponse) {
+        offlineDatabase->put(resource, onlineResponse);
+        // A revalidated copy in memory would keep its old expiration time.
+        if (onlineResponse.notModified) {
+            memoryCache.remove(resource);
+        } else {
+            memoryCache.add(resource, onlineResponse);
+        }
+        scheduleEviction();
+    }
+
+    void respond(const std::string& key, const Response& response) {
+        auto it = sharedRequests.find(key);
+        assert(it != sharedRequests.end());
+        optional<Response>& latest = it->second.latest;
+        if (response.notModified) {
+            // Joining requests may have no copy of their own to revalidate, so they start out
+            // with the data of the response that the 304 revalidated instead.
+            if (latest && latest->data) {
+                latest->expires = response.expires;
+                latest->etag = response.etag ? response.etag : latest->etag;
+                latest->modified = response.modified ? response.modified : latest->modified;
+            }
+        } else if (!response.error || !latest || !latest->data) {
+            // A failed revalidation doesn't take the data away from the requests that join.
+            latest = response;
+        }
+        for (auto& callback : it->second.callbacks) {
+            callback.second(response);
+        }
+    }
+
+    // Evicts from the ambient cache one chunk per run loop iteration, so that requests
+    // are served in between.
+    void scheduleEviction() {
+        if (!evictionScheduled && offlineDatabase->isEvictionPending()) {
+            evictionScheduled = true;
+            evictionTimer.start(Duration::zero(), Duration::zero(), [this] {
+                evictionScheduled = false;
+                try {
+                    offlineDatabase->evictIncrementally();
+                } catch (const std::exception& ex) {
+                    Log::Error(Event::Database, "Unable to evict from the cache: %s", ex.what());
+                    return;
+                }
+                scheduleEviction();
+            });
+        }
+    }
+
     OfflineDownload& getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
             return *it->second;
         }
-        return *downloads.emplace(regionID,
-            std::make_unique<OfflineDownload>(regionID, offlineDatabase.getRegionDefinition(regionID), offlineDatabase, onlineFileSource)).first->second;
+        auto& download = *downloads.emplace(regionID,
+            std::make_unique<OfflineDownload>(regionID, offlineDatabase->getRegionDefinition(regionID), *offlineDatabase, onlineFileSource)).first->second;
+        if (downloadConcurrency) {
+            download.setMaximumConcurrentRequests(downloadConcurrency->first, downloadConcurrency->second);
+        }
+        return download;
     }
 
     // shared so that destruction is done on the creating thread
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
-    OfflineDatabase offlineDatabase;
+    const std::unique_ptr<FileSource> packFileSource;
+    std::unique_ptr<OfflineDatabase> offlineDatabase;
+    ResponseCache& memoryCache;
+    std::atomic<uint64_t>& cacheHits;
+    std::atomic<uint64_t>& cacheMisses;
+    std::atomic<bool>& readersEnabled;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
+    std::unordered_map<std::string, SharedRequest> sharedRequests;
+    std::unordered_map<AsyncRequest*, std::string> sharedRequestKeys;
+    std::unordered_map<AsyncRequest*, ConcurrentRequest> concurrentRequests;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
+    optional<std::pair<uint32_t, uint32_t>> downloadConcurrency;
+    // Created on the first bulk put.
+    std::unique_ptr<ThreadPool> compressionThreadPool;
+    util::Timer flushTimer;
+    util::Timer evictionTimer;
+    bool evictionScheduled = false;
+};
+
+// Serves cache lookups on a read-only connection of its own, so that they don't wait behind
+// writes and offline region management on the Impl thread. Each request then moves on to the
+// Impl for revalidation.
+class DefaultFileSource::CacheReader {
+public:
+    CacheReader(ActorRef<CacheReader>, std::string cachePath_, ActorRef<Impl> impl_, ResponseCache& memoryCache_,
+                std::atomic<uint64_t>& cacheHits_, std::atomic<uint64_t>& cacheMisses_)
+        : cachePath(std::move(cachePath_)),
+          impl(std::move(impl_)),
+          memoryCache(memoryCache_),
+          cacheHits(cacheHits_),
+          cacheMisses(cacheMisses_) {
+    }
+
+    void request(AsyncRequest* req, Resource resource, ActorRef<FileSourceRequest> ref) {
+        Resource revalidation = resource;
+        optional<Response> offlineResponse;
+
+        try {
+            offlineResponse = getCached(memoryCache, database(), resource, revalidation, cacheHits, cacheMisses);
+        } catch (const std::exception& ex) {
+            Log::Error(Event::Database, "Unable to read from the cache: %s", ex.what());
+            // Reconnect on the next request.
+            offlineDatabase.reset();
+            revalidation = resource;
+        }
+
+        if (offlineResponse) {
+            ref.invoke(&FileSourceRequest::setResponse, *offlineResponse);
+        }
+
+        impl.invoke(&Impl::revalidate, req, revalidation, std::move(offlineResponse), ref);
+    }
+
+    void cancel(AsyncRequest* req) {
+        impl.invoke(&Impl::cancel, req);
+    }
+
+private:
+    OfflineDatabase& database() {
+        if (!offlineDatabase) {
+            offlineDatabase = std::make_unique<OfflineDatabase>(cachePath, OfflineDatabase::ReadOnly());
+        }
+        return *offlineDatabase;
+    }
+
+    const std::string cachePath;
+    ActorRef<Impl> impl;
+    ResponseCache& memoryCache;
+    std::atomic<uint64_t>& cacheHits;
+    std::atomic<uint64_t>& cacheMisses;
+    std::unique_ptr<OfflineDatabase> offlineDatabase;
 };
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
@@ -194,12 +598,35 @@ DefaultFileSource::DefaultFileSource(const std::string& cachePath,
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      std::unique_ptr<FileSource>&& assetFileSource_,
                                      uint64_t maximumCacheSize)
-        : assetFileSource(std::move(assetFileSource_))
-        , impl(std::make_unique<util::Thread<Impl>>("DefaultFileSource", assetFileSource, cachePath, maximumCacheSize)) {
+        : memoryCache(std::make_unique<ResponseCache>())
+        , assetFileSource(std::move(assetFileSource_))
+        // Requests for the tiles in view go through the database and the network on this thread,
+        // so it runs at normal priority.
+        , impl(std::make_unique<util::Thread<Impl>>(platform::ThreadPriority::Normal, "DefaultFileSource", assetFileSource, *memoryCache, cacheHits, cacheMisses, readersEnabled)) {
+    // An in-memory database can't be shared across connections.
+    const bool concurrentReads = cachePath != ":memory:";
+    impl->actor().invoke(&Impl::open, cachePath, maximumCacheSize, concurrentReads);
+
+    if (concurrentReads) {
+        for (std::size_t i = 0; i < cacheReaderCount; i++) {
+            readers.push_back(std::make_unique<util::Thread<CacheReader>>(platform::ThreadPriority::Normal, "DefaultFileSource reader", cachePath, impl->actor(), *memoryCache, cacheHits, cacheMisses));
+        }
+    }
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
 
+FileSource::CacheStatistics DefaultFileSource::getCacheStatistics() const {
+    CacheStatistics statistics;
+    statistics.hits = cacheHits;
+    statistics.misses = cacheMisses;
+    return statistics;
+}
+
+void DefaultFileSource::setMemoryCacheSize(std::size_t bytes) {
+    memoryCache->setMaximumSize(bytes);
+}
+
 void DefaultFileSource::setAPIBaseURL(const std::string& baseURL) {
     impl->actor().invoke(&Impl::setAPIBaseURL, baseURL);
 
@@ -232,12 +659,38 @@ void DefaultFileSource::setResourceTransform(optional<ActorRef<ResourceTransform
     impl->actor().invoke(&Impl::setResourceTransform, std::move(transform));
 }
 
+void DefaultFileSource::setSynchronousResourceTransform(std::function<std::string(Resource::Kind, const std::string&)> transform) {
+    impl->actor().invoke(&Impl::setSynchronousResourceTransform, std::move(transform));
+}
+
+void DefaultFileSource::setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost) {
+    impl->actor().invoke(&Impl::setHTTP2Multiplexing, enabled, maximumStreamsPerHost);
+}
+
+void DefaultFileSource::setAdaptiveConcurrency(bool enabled) {
+    impl->actor().invoke(&Impl::setAdaptiveConcurrency, enabled);
+}
+
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
-    req->onCancel([fs = impl->actor(), req = req.get()] () mutable { fs.invoke(&Impl::cancel, req); });
-
-    impl->actor().invoke(&Impl::request, req.get(), resource, req->actor());
+    // Until the database is open, requests wait for it on the Impl thread.
+    if (readersEnabled && isCacheable(resource.url)) {
+        // Cancellation must follow the request through the same reader, so that it reaches Impl
+        // after whatever the reader forwards there.
+        auto& reader = *readers[nextReader++ % readers.size()];
+        req->onCancel([fs = reader.actor(), req = req.get()] () mutable { fs.invoke(&CacheReader::cancel, req); });
+
+        // Requests that have a copy already skip the lookup, and revalidate it conditionally.
+        const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
+        if (resource.concurrentNetworkRequest && resource.necessity == Resource::Required && !hasPrior) {
+            impl->actor().invoke(&Impl::requestConcurrently, req.get(), resource, req->actor());
+        }
+        reader.actor().invoke(&CacheReader::request, req.get(), resource, req->actor());
+    } else {
+        req->onCancel([fs = impl->actor(), req = req.get()] () mutable { fs.invoke(&Impl::cancel, req); });
+        impl->actor().invoke(&Impl::request, req.get(), resource, req->actor());
+    }
 
     return std::move(req);
 }
@@ -262,6 +715,23 @@ void DefaultFileSource::deleteOfflineRegion(OfflineRegion&& region, std::functio
     impl->actor().invoke(&Impl::deleteRegion, std::move(region), callback);
 }
 
+void DefaultFileSource::exportOfflineRegion(const OfflineRegion& region,
+                                            const std::string& path,
+                                            std::function<void (std::exception_ptr)> callback) {
+    impl->actor().invoke(&Impl::exportRegion, region.getID(), path, callback);
+}
+
+void DefaultFileSource::putOfflineRegionResources(const OfflineRegion& region,
+                                                  std::vector<std::pair<Resource, Response>> resources,
+                                                  std::function<void (std::exception_ptr)> callback) {
+    impl->actor().invoke(&Impl::putRegionResources, region.getID(), std::move(resources), callback);
+}
+
+void DefaultFileSource::importOfflineRegion(const std::string& path,
+                                            std::function<void (std::exception_ptr, optional<OfflineRegion>)> callback) {
+    impl->actor().invoke(&Impl::importRegion, path, callback);
+}
+
 void DefaultFileSource::setOfflineRegionObserver(OfflineRegion& region, std::unique_ptr<OfflineRegionObserver> observer) {
     impl->actor().invoke(&Impl::setRegionObserver, region.getID(), std::move(observer));
 }
@@ -270,6 +740,10 @@ void DefaultFileSource::setOfflineRegionDownloadState(OfflineRegion& region, Off
     impl->actor().invoke(&Impl::setRegionDownloadState, region.getID(), state);
 }
 
+void DefaultFileSource::refreshOfflineRegion(OfflineRegion& region) {
+    impl->actor().invoke(&Impl::refreshRegion, region.getID());
+}
+
 void DefaultFileSource::getOfflineRegionStatus(OfflineRegion& region, std::function<void (std::exception_ptr, optional<OfflineRegionStatus>)> callback) const {
     impl->actor().invoke(&Impl::getRegionStatus, region.getID(), callback);
 }
@@ -278,11 +752,25 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     impl->actor().invoke(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setOfflineWriteBatching(Duration flushInterval, std::size_t flushSize) const {
+    impl->actor().invoke(&Impl::setOfflineWriteBatching, flushInterval, flushSize);
+}
+
+void DefaultFileSource::setOfflineDownloadConcurrency(uint32_t maximumRequests, uint32_t maximumRequestsPerHost) const {
+    impl->actor().invoke(&Impl::setOfflineDownloadConcurrency, maximumRequests, maximumRequestsPerHost);
+}
+
 void DefaultFileSource::pause() {
     impl->pause();
+    for (auto& reader : readers) {
+        reader->pause();
+    }
 }
 
 void DefaultFileSource::resume() {
+    for (auto& reader : readers) {
+        reader->resume();
+    }
     impl->resume();
 }
 
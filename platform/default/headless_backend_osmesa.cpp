@@ -7,6 +7,14 @@
 
 namespace mbgl {
 
+static OSMesaContext createOSMesaContext(OSMesaContext sharedContext) {
+#if OSMESA_MAJOR_VERSION * 100 + OSMESA_MINOR_VERSION >= 305
+    return OSMesaCreateContextExt(OSMESA_RGBA, 16, 0, 0, sharedContext);
+#else
+    return OSMesaCreateContext(OSMESA_RGBA, sharedContext);
+#endif
+}
+
 struct OSMesaImpl : public HeadlessBackend::Impl {
     OSMesaImpl(OSMesaContext glContext_) : glContext(glContext_) {
     }
@@ -21,6 +29,14 @@ struct OSMesaImpl : public HeadlessBackend::Impl {
         }
     }
 
+    std::unique_ptr<HeadlessBackend::Impl> createSharedContext() final {
+        OSMesaContext sharedContext = createOSMesaContext(glContext);
+        if (sharedContext == nullptr) {
+            return nullptr;
+        }
+        return std::make_unique<OSMesaImpl>(sharedContext);
+    }
+
     OSMesaContext glContext = nullptr;
     GLubyte fakeBuffer = 0;
 };
@@ -36,11 +52,7 @@ bool HeadlessBackend::hasDisplay() {
 void HeadlessBackend::createContext() {
     assert(!hasContext());
 
-#if OSMESA_MAJOR_VERSION * 100 + OSMESA_MINOR_VERSION >= 305
-    OSMesaContext glContext = OSMesaCreateContextExt(OSMESA_RGBA, 16, 0, 0, nullptr);
-#else
-    OSMesaContext glContext = OSMesaCreateContext(OSMESA_RGBA, nullptr);
-#endif
+    OSMesaContext glContext = createOSMesaContext(nullptr);
     if (glContext == nullptr) {
         throw std::runtime_error("Error creating GL context object.");
     }
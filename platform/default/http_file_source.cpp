@@ -13,11 +13,13 @@
 
 #include <curl/curl.h>
 
+#include <algorithm>
 #include <queue>
 #include <map>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 
 static void handleError(CURLMcode code) {
     if (code != CURLM_OK) {
@@ -54,9 +56,13 @@ public:
     // block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state (e.g. resolved host names and TLS
+    // sessions) between easy handles.
     CURLSH *share = nullptr;
 
+    // Whether requests wait for, and multiplex over, an existing HTTP/2 connection to their host.
+    bool multiplexing = false;
+
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
     // them all the time.
     std::queue<CURL *> handles;
@@ -70,6 +76,8 @@ public:
     void handleResult(CURLcode code);
 
 private:
+    Response::Timing getTiming() const;
+
     static size_t headerCallback(char *const buffer, const size_t size, const size_t nmemb, void *userp);
     static size_t writeCallback(void *const contents, const size_t size, const size_t nmemb, void *userp);
 
@@ -96,6 +104,8 @@ HTTPFileSource::Impl::Impl() {
     }
 
     share = curl_share_init();
+    handleError(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS));
+    handleError(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION));
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
@@ -261,6 +271,16 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl* context_, Resource resource_, Fil
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
 
+    if (context->multiplexing) {
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // Added in 7.47.0
+        handleError(curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+        // Rather wait for a connection that's being established than open another one.
+        handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+#endif
+    }
+
     // Start requesting the information.
     handleError(curl_multi_add_handle(context->multi, handle));
 }
@@ -333,6 +353,18 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
         baton->retryAfter = std::string(buffer + begin, length - begin - 2); // remove \r\n
     } else if ((begin = headerMatches("x-rate-limit-reset: ", buffer, length)) != std::string::npos) {
         baton->xRateLimitReset = std::string(buffer + begin, length - begin - 2); // remove \r\n
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        // Size the body buffer up front, so that writeCallback appends without reallocating.
+        // With a compressed transfer encoding this is a lower bound.
+        const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
+        const std::size_t contentLength = std::strtoull(value.c_str(), nullptr, 10);
+        if (contentLength > 0) {
+            if (!baton->data) {
+                baton->data = std::make_shared<std::string>();
+            }
+            // Don't trust the header with more than a generous tile's worth.
+            baton->data->reserve(std::min<std::size_t>(contentLength, 16 * 1024 * 1024));
+        }
     }
 
     return length;
@@ -364,6 +396,8 @@ void HTTPRequest::handleResult(CURLcode code) {
             break;
         }
     } else {
+        response->timing = getTiming();
+
         long responseCode = 0;
         curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
 
@@ -401,6 +435,41 @@ void HTTPRequest::handleResult(CURLcode code) {
     callback_(response_);
 }
 
+Response::Timing HTTPRequest::getTiming() const {
+    // CURL reports the time from the start of the request until the end of each phase.
+    double nameLookup = 0, connect = 0, appConnect = 0, preTransfer = 0, startTransfer = 0, total = 0;
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME, &nameLookup);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &appConnect);
+    curl_easy_getinfo(handle, CURLINFO_PRETRANSFER_TIME, &preTransfer);
+    curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME, &startTransfer);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &total);
+
+    const auto phase = [] (double start, double end) {
+        return std::chrono::duration_cast<Duration>(std::chrono::duration<double>(std::max(end - start, 0.0)));
+    };
+
+    Response::Timing timing;
+    timing.dns = phase(0, nameLookup);
+    timing.connect = phase(nameLookup, connect);
+    // The TLS handshake time is zero for plain HTTP.
+    timing.tls = appConnect > 0 ? phase(connect, appConnect) : Duration::zero();
+    timing.firstByte = phase(preTransfer, startTransfer);
+    timing.transfer = phase(startTransfer, total);
+
+    long connects = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    timing.reusedConnection = connects == 0;
+
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (50) << 8 | 0) // Added in 7.50.0
+    long version = 0;
+    curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &version);
+    timing.multiplexed = context->multiplexing && version == CURL_HTTP_VERSION_2_0;
+#endif
+
+    return timing;
+}
+
 HTTPFileSource::HTTPFileSource()
     : impl(std::make_unique<Impl>()) {
 }
@@ -415,4 +484,16 @@ uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
 
+void HTTPFileSource::setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost) {
+    impl->multiplexing = enabled;
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    handleError(curl_multi_setopt(impl->multi, CURLMOPT_PIPELINING, enabled ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (67) << 8 | 0) // Added in 7.67.0
+    handleError(curl_multi_setopt(impl->multi, CURLMOPT_MAX_CONCURRENT_STREAMS, long(maximumStreamsPerHost)));
+#else
+    (void)maximumStreamsPerHost;
+#endif
+}
+
 } // namespace mbgl
@@ -89,7 +89,7 @@ struct jpeg_info_guard {
     jpeg_decompress_struct* i_;
 };
 
-PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
+PremultipliedImage decodeJPEG(const uint8_t* data, size_t size, Size minimumSize) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -106,6 +106,30 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     if (ret != JPEG_HEADER_OK)
         throw std::runtime_error("JPEG Reader: failed to read header");
 
+    // Scaling the inverse DCT skips most of the decoding work for reduced images.
+    if (!minimumSize.isEmpty()) {
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = 1;
+        while (cinfo.scale_denom < 8 &&
+               cinfo.image_width / (cinfo.scale_denom * 2) >= minimumSize.width &&
+               cinfo.image_height / (cinfo.scale_denom * 2) >= minimumSize.height) {
+            cinfo.scale_denom *= 2;
+        }
+    }
+
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo converts colors to RGBA itself, with SIMD where available, straight into
+    // the rows of the image.
+    const bool rgba = cinfo.jpeg_color_space == JCS_YCbCr ||
+                      cinfo.jpeg_color_space == JCS_RGB ||
+                      cinfo.jpeg_color_space == JCS_GRAYSCALE;
+    if (rgba) {
+        cinfo.out_color_space = JCS_EXT_RGBA;
+    }
+#else
+    const bool rgba = false;
+#endif
+
     jpeg_start_decompress(&cinfo);
 
     if (cinfo.out_color_space == JCS_UNKNOWN)
@@ -122,6 +146,16 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     PremultipliedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
     uint8_t* dst = image.data.get();
 
+    // JPEGs are opaque, so their pixels need no premultiplication.
+    if (rgba) {
+        while (cinfo.output_scanline < cinfo.output_height) {
+            JSAMPROW row = dst + cinfo.output_scanline * width * 4;
+            jpeg_read_scanlines(&cinfo, &row, 1);
+        }
+        jpeg_finish_decompress(&cinfo);
+        return image;
+    }
+
     JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr) &cinfo, JPOOL_IMAGE, rowStride, 1);
 
     while (cinfo.output_scanline < cinfo.output_height) {
@@ -1,8 +1,9 @@
 #include <mbgl/storage/local_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/string.hpp>
-#include <mbgl/util/thread.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/util.hpp>
 #include <mbgl/util/io.hpp>
@@ -16,6 +17,10 @@ namespace {
 const char* protocol = "file://";
 const std::size_t protocolLength = 7;
 
+// Styles, sprites, glyphs and tiles bundled with an application are often requested all at
+// once on startup.
+const std::size_t readerCount = 4;
+
 } // namespace
 
 namespace mbgl {
@@ -53,7 +58,10 @@ public:
 };
 
 LocalFileSource::LocalFileSource()
-    : impl(std::make_unique<util::Thread<Impl>>("LocalFileSource")) {
+    : threadPool(std::make_unique<ThreadPool>(readerCount)) {
+    for (std::size_t i = 0; i < readerCount; i++) {
+        impls.push_back(std::make_unique<Actor<Impl>>(*threadPool));
+    }
 }
 
 LocalFileSource::~LocalFileSource() = default;
@@ -61,7 +69,8 @@ LocalFileSource::~LocalFileSource() = default;
 std::unique_ptr<AsyncRequest> LocalFileSource::request(const Resource& resource, Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
-    impl->actor().invoke(&Impl::request, resource.url, req->actor());
+    impls[nextImpl]->invoke(&Impl::request, resource.url, req->actor());
+    nextImpl = (nextImpl + 1) % impls.size();
 
     return std::move(req);
 }
@@ -0,0 +1,10 @@
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+
+namespace mbgl {
+
+// There is no font backend to draw glyphs with on this platform, so all glyphs are downloaded.
+std::unique_ptr<LocalGlyphRasterizer> LocalGlyphRasterizer::create(const std::string&) {
+    return nullptr;
+}
+
+} // namespace mbgl
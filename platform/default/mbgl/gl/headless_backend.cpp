@@ -28,8 +28,10 @@ HeadlessBackend::HeadlessBackend(Size size_)
 
 HeadlessBackend::~HeadlessBackend() {
     BackendScope guard { *this };
+    pendingReadbacks.clear();
     view.reset();
     context.reset();
+    uploadImpl.reset();
 }
 
 void HeadlessBackend::activate() {
@@ -40,6 +42,9 @@ void HeadlessBackend::activate() {
             throw std::runtime_error("Display is not set");
         }
         createContext();
+        if (sharedUploadContextEnabled) {
+            uploadImpl = impl->createSharedContext();
+        }
     }
 
     assert(hasContext());
@@ -52,6 +57,29 @@ void HeadlessBackend::deactivate() {
     active = false;
 }
 
+void HeadlessBackend::activateUploadContext() {
+    assert(uploadImpl);
+    uploadImpl->activateContext();
+}
+
+void HeadlessBackend::deactivateUploadContext() {
+    assert(uploadImpl);
+    uploadImpl->deactivateContext();
+}
+
+bool HeadlessBackend::preservesStencilBuffer() const {
+    return true;
+}
+
+void HeadlessBackend::setSharedUploadContextEnabled(bool enabled) {
+    assert(!hasContext());
+    sharedUploadContextEnabled = enabled;
+}
+
+bool HeadlessBackend::supportsSharedUploadContext() const {
+    return bool(uploadImpl);
+}
+
 void HeadlessBackend::bind() {
     gl::Context& context_ = getContext();
 
@@ -73,7 +101,16 @@ void HeadlessBackend::setSize(Size size_) {
     view.reset();
 }
 
+void HeadlessBackend::startReadStillImage() {
+    pendingReadbacks.push_back(std::make_unique<gl::FramebufferReadback>(getContext().startReadFramebuffer(size)));
+}
+
 PremultipliedImage HeadlessBackend::readStillImage() {
+    if (!pendingReadbacks.empty()) {
+        std::unique_ptr<gl::FramebufferReadback> readback = std::move(pendingReadbacks.front());
+        pendingReadbacks.pop_front();
+        return getContext().finishReadFramebuffer<PremultipliedImage>(std::move(*readback));
+    }
     return getContext().readFramebuffer<PremultipliedImage>(size);
 }
 
@@ -2,6 +2,7 @@
 
 #include <mbgl/renderer/renderer_backend.hpp>
 
+#include <deque>
 #include <memory>
 #include <functional>
 
@@ -9,6 +10,10 @@ namespace mbgl {
 
 class HeadlessDisplay;
 
+namespace gl {
+class FramebufferReadback;
+} // namespace gl
+
 class HeadlessBackend : public RendererBackend {
 public:
     HeadlessBackend(Size = { 256, 256 });
@@ -17,13 +22,30 @@ public:
     void bind() override;
     void updateAssumedState() override;
 
+    // Renders into a framebuffer of its own, which nothing else draws into.
+    bool preservesStencilBuffer() const override;
+
+    // Uploads tile buckets through a second context that shares objects with the rendering
+    // context, if enabled before the backend is first activated and the platform supports it.
+    void setSharedUploadContextEnabled(bool);
+    bool supportsSharedUploadContext() const override;
+
     void setSize(Size);
+
+    // Starts reading back the still image without waiting for the GPU, if the context supports
+    // it, so that the readback overlaps with whatever is rendered next. readStillImage() returns
+    // the images started this way in order, before reading back the current one.
+    void startReadStillImage();
     PremultipliedImage readStillImage();
 
     struct Impl {
         virtual ~Impl() = default;
         virtual void activateContext() = 0;
         virtual void deactivateContext() {}
+
+        // Creates a context that shares objects with this one, to be activated on another
+        // thread, or returns nothing if the platform can't.
+        virtual std::unique_ptr<Impl> createSharedContext() { return nullptr; }
     };
 
 private:
@@ -32,6 +54,8 @@ private:
 
     void activate() override;
     void deactivate() override;
+    void activateUploadContext() override;
+    void deactivateUploadContext() override;
 
     bool hasContext() const { return bool(impl); }
     bool hasDisplay();
@@ -40,6 +64,8 @@ private:
 
     std::shared_ptr<HeadlessDisplay> display;
     std::unique_ptr<Impl> impl;
+    std::unique_ptr<Impl> uploadImpl;
+    bool sharedUploadContextEnabled = false;
 
     Size size;
     float pixelRatio;
@@ -47,6 +73,8 @@ private:
 
     class View;
     std::unique_ptr<View> view;
+
+    std::deque<std::unique_ptr<gl::FramebufferReadback>> pendingReadbacks;
 };
 
 } // namespace mbgl
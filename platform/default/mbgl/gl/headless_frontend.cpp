@@ -3,6 +3,9 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <cassert>
+#include <stdexcept>
+
 namespace mbgl {
 
 HeadlessFrontend::HeadlessFrontend(float pixelRatio_, FileSource& fileSource, Scheduler& scheduler)
@@ -12,10 +15,14 @@ HeadlessFrontend::HeadlessFrontend(float pixelRatio_, FileSource& fileSource, Sc
 HeadlessFrontend::HeadlessFrontend(Size size_, float pixelRatio_, FileSource& fileSource, Scheduler& scheduler)
     : size(size_),
     pixelRatio(pixelRatio_),
+    renderPixelRatio(pixelRatio_),
     backend({ static_cast<uint32_t>(size.width * pixelRatio),
               static_cast<uint32_t>(size.height * pixelRatio) }),
     asyncInvalidate([this] {
         if (renderer && updateParameters) {
+            if (updateParameters->stillImageRequest) {
+                stillParameters = updateParameters;
+            }
             mbgl::BackendScope guard { backend };
             renderer->render(*updateParameters);
         }
@@ -56,12 +63,40 @@ RendererBackend* HeadlessFrontend::getBackend() {
 void HeadlessFrontend::setSize(Size size_) {
     if (size != size_) {
         size = size_;
-        backend.setSize({ static_cast<uint32_t>(size_.width * pixelRatio),
-                          static_cast<uint32_t>(size_.height * pixelRatio) });
+        backend.setSize({ static_cast<uint32_t>(size_.width * renderPixelRatio),
+                          static_cast<uint32_t>(size_.height * renderPixelRatio) });
+    }
+}
+
+void HeadlessFrontend::setRenderPixelRatio(float pixelRatio_) {
+    if (renderPixelRatio != pixelRatio_) {
+        renderPixelRatio = pixelRatio_;
+        backend.setSize({ static_cast<uint32_t>(size.width * renderPixelRatio),
+                          static_cast<uint32_t>(size.height * renderPixelRatio) });
+    }
+    assert(renderer);
+    renderer->setRenderPixelRatio(renderPixelRatio);
+}
+
+void HeadlessFrontend::rerenderStillImage(float pixelRatio_) {
+    if (!stillParameters) {
+        throw std::logic_error("no still image was rendered");
     }
+
+    setRenderPixelRatio(pixelRatio_);
+
+    BackendScope guard { backend };
+    renderer->render(*stillParameters);
+    backend.startReadStillImage();
+}
+
+void HeadlessFrontend::startReadStillImage() {
+    BackendScope guard { backend };
+    backend.startReadStillImage();
 }
 
 PremultipliedImage HeadlessFrontend::readStillImage() {
+    BackendScope guard { backend };
     return backend.readStillImage();
 }
 
@@ -83,4 +118,67 @@ PremultipliedImage HeadlessFrontend::render(Map& map) {
     return result;
 }
 
+void HeadlessFrontend::renderAndStartReadback(Map& map) {
+    bool rendered = false;
+
+    map.renderStill([&](std::exception_ptr error) {
+        if (error) {
+            std::rethrow_exception(error);
+        } else {
+            startReadStillImage();
+            rendered = true;
+        }
+    });
+
+    while (!rendered) {
+        util::RunLoop::Get()->runOnce();
+    }
+}
+
+std::vector<PremultipliedImage> HeadlessFrontend::render(Map& map, const std::vector<float>& pixelRatios) {
+    const float previousPixelRatio = renderPixelRatio;
+    std::vector<PremultipliedImage> images;
+
+    try {
+        for (std::size_t i = 0; i < pixelRatios.size(); i++) {
+            if (i == 0) {
+                setRenderPixelRatio(pixelRatios[i]);
+                renderAndStartReadback(map);
+            } else {
+                rerenderStillImage(pixelRatios[i]);
+            }
+        }
+        for (std::size_t i = 0; i < pixelRatios.size(); i++) {
+            images.push_back(readStillImage());
+        }
+    } catch (...) {
+        setRenderPixelRatio(previousPixelRatio);
+        throw;
+    }
+
+    setRenderPixelRatio(previousPixelRatio);
+    return images;
+}
+
+std::vector<PremultipliedImage> HeadlessFrontend::renderTiles(Map& map, uint32_t n) {
+    return splitImage(render(map), n);
+}
+
+std::vector<PremultipliedImage> HeadlessFrontend::splitImage(const PremultipliedImage& image, uint32_t n) {
+    if (n == 0 || image.size.width % n != 0 || image.size.height % n != 0) {
+        throw std::invalid_argument("image size must be a multiple of the number of tiles");
+    }
+
+    const Size tileSize { image.size.width / n, image.size.height / n };
+    std::vector<PremultipliedImage> tiles;
+    tiles.reserve(n * n);
+    for (uint32_t y = 0; y < n; y++) {
+        for (uint32_t x = 0; x < n; x++) {
+            tiles.emplace_back(tileSize);
+            PremultipliedImage::copy(image, tiles.back(), { x * tileSize.width, y * tileSize.height }, { 0, 0 }, tileSize);
+        }
+    }
+    return tiles;
+}
+
 } // namespace mbgl
@@ -5,6 +5,7 @@
 #include <mbgl/util/async_task.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace mbgl {
 
@@ -30,18 +31,45 @@ public:
     Renderer* getRenderer();
     RendererBackend* getBackend();
 
+    // Starts reading back the still image that was just rendered; see HeadlessBackend.
+    void startReadStillImage();
     PremultipliedImage readStillImage();
     PremultipliedImage render(Map&);
 
+    // Renders a still image like render(), but only starts reading it back. readStillImage()
+    // returns the images rendered this way in order, so that reading back each image overlaps
+    // with rendering the ones after it.
+    void renderAndStartReadback(Map&);
+
+    // Renders a still image once and splits it into `n`×`n` tiles of equal size, in row-major
+    // order. The tiles share layout and label placement, so labels match across their edges.
+    // The size must be a multiple of `n`.
+    std::vector<PremultipliedImage> renderTiles(Map&, uint32_t n);
+    static std::vector<PremultipliedImage> splitImage(const PremultipliedImage&, uint32_t n);
+
+    // The pixel ratio images are rendered at, by default the one the frontend was created with.
+    // Tiles, their layout and the sprite stay those of the map's pixel ratio; see Renderer.
+    void setRenderPixelRatio(float);
+
+    // Renders the most recent still image again at another pixel ratio, from the same tiles and
+    // label placement, and starts reading it back; see startReadStillImage(). Throws if no still
+    // image was rendered.
+    void rerenderStillImage(float pixelRatio);
+
+    // Renders a still image once for each pixel ratio, sharing tiles and layout between them.
+    std::vector<PremultipliedImage> render(Map&, const std::vector<float>& pixelRatios);
+
 private:
     Size size;
     float pixelRatio;
+    float renderPixelRatio;
 
     HeadlessBackend backend;
     util::AsyncTask asyncInvalidate;
 
     std::unique_ptr<Renderer> renderer;
     std::shared_ptr<UpdateParameters> updateParameters;
+    std::shared_ptr<UpdateParameters> stillParameters;
 };
 
 } // namespace mbgl
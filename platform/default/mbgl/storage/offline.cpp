@@ -2,6 +2,9 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/rapidjson.hpp>
+
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
@@ -10,20 +13,16 @@
 
 namespace mbgl {
 
-OfflineTilePyramidRegionDefinition::OfflineTilePyramidRegionDefinition(
-    std::string styleURL_, LatLngBounds bounds_, double minZoom_, double maxZoom_, float pixelRatio_)
-    : styleURL(std::move(styleURL_)),
-      bounds(std::move(bounds_)),
-      minZoom(minZoom_),
-      maxZoom(maxZoom_),
-      pixelRatio(pixelRatio_) {
+namespace {
+
+void validateRegion(double minZoom, double maxZoom, float pixelRatio) {
     if (minZoom < 0 || maxZoom < 0 || maxZoom < minZoom || pixelRatio < 0 ||
         !std::isfinite(minZoom) || std::isnan(maxZoom) || !std::isfinite(pixelRatio)) {
         throw std::invalid_argument("Invalid offline region definition");
     }
 }
 
-std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+Range<uint8_t> coveringZoomRange(double minZoom, double maxZoom, SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) {
     double minZ = std::max<double>(util::coveringZoomLevel(minZoom, type, tileSize), zoomRange.min);
     double maxZ = std::min<double>(util::coveringZoomLevel(maxZoom, type, tileSize), zoomRange.max);
 
@@ -32,26 +31,89 @@ std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(Sourc
     assert(minZ < std::numeric_limits<uint8_t>::max());
     assert(maxZ < std::numeric_limits<uint8_t>::max());
 
-    std::vector<CanonicalTileID> result;
+    return { uint8_t(minZ), uint8_t(maxZ) };
+}
 
-    for (uint8_t z = minZ; z <= maxZ; z++) {
-        for (const auto& tile : util::tileCover(bounds, z)) {
-            result.emplace_back(tile.canonical);
+template <class Area>
+std::vector<CanonicalTileID> tileCover(const Area& area, const Range<uint8_t>& zooms) {
+    std::vector<CanonicalTileID> result;
+    for (uint8_t z = zooms.min; z <= zooms.max; z++) {
+        const util::TileRange range(area, z);
+        result.reserve(result.size() + range.size());
+        for (uint64_t i = 0; i < range.size(); i++) {
+            result.push_back(range[i]);
         }
     }
+    return result;
+}
 
+template <class Area>
+uint64_t tileCount(const Area& area, const Range<uint8_t>& zooms) {
+    uint64_t result = 0;
+    for (uint8_t z = zooms.min; z <= zooms.max; z++) {
+        result += util::TileRange(area, z).size();
+    }
     return result;
 }
 
+} // namespace
+
+OfflineTilePyramidRegionDefinition::OfflineTilePyramidRegionDefinition(
+    std::string styleURL_, LatLngBounds bounds_, double minZoom_, double maxZoom_, float pixelRatio_)
+    : styleURL(std::move(styleURL_)),
+      bounds(std::move(bounds_)),
+      minZoom(minZoom_),
+      maxZoom(maxZoom_),
+      pixelRatio(pixelRatio_) {
+    validateRegion(minZoom, maxZoom, pixelRatio);
+}
+
+Range<uint8_t> OfflineTilePyramidRegionDefinition::coveringZoomRange(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    return mbgl::coveringZoomRange(minZoom, maxZoom, type, tileSize, zoomRange);
+}
+
+std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    return mbgl::tileCover(bounds, coveringZoomRange(type, tileSize, zoomRange));
+}
+
+uint64_t OfflineTilePyramidRegionDefinition::tileCount(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    return mbgl::tileCount(bounds, coveringZoomRange(type, tileSize, zoomRange));
+}
+
+OfflineGeometryRegionDefinition::OfflineGeometryRegionDefinition(
+    std::string styleURL_, Geometry<double> geometry_, double minZoom_, double maxZoom_, float pixelRatio_)
+    : styleURL(std::move(styleURL_)),
+      geometry(std::move(geometry_)),
+      minZoom(minZoom_),
+      maxZoom(maxZoom_),
+      pixelRatio(pixelRatio_) {
+    validateRegion(minZoom, maxZoom, pixelRatio);
+}
+
+Range<uint8_t> OfflineGeometryRegionDefinition::coveringZoomRange(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    return mbgl::coveringZoomRange(minZoom, maxZoom, type, tileSize, zoomRange);
+}
+
+std::vector<CanonicalTileID> OfflineGeometryRegionDefinition::tileCover(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    return mbgl::tileCover(geometry, coveringZoomRange(type, tileSize, zoomRange));
+}
+
+uint64_t OfflineGeometryRegionDefinition::tileCount(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    return mbgl::tileCount(geometry, coveringZoomRange(type, tileSize, zoomRange));
+}
+
 OfflineRegionDefinition decodeOfflineRegionDefinition(const std::string& region) {
     rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
     doc.Parse<0>(region.c_str());
 
+    // Tile pyramids have "bounds", geometry regions a GeoJSON "geometry".
     if (doc.HasParseError() ||
         !doc.HasMember("style_url") || !doc["style_url"].IsString() ||
-        !doc.HasMember("bounds") || !doc["bounds"].IsArray() || doc["bounds"].Size() != 4 ||
+        !(doc.HasMember("bounds") || doc.HasMember("geometry")) ||
+        (doc.HasMember("bounds") && (!doc["bounds"].IsArray() || doc["bounds"].Size() != 4 ||
           !doc["bounds"][0].IsDouble() || !doc["bounds"][1].IsDouble() ||
-          !doc["bounds"][2].IsDouble() || !doc["bounds"][3].IsDouble() ||
+          !doc["bounds"][2].IsDouble() || !doc["bounds"][3].IsDouble())) ||
+        (doc.HasMember("geometry") && !doc["geometry"].IsObject()) ||
         !doc.HasMember("min_zoom") || !doc["min_zoom"].IsDouble() ||
         (doc.HasMember("max_zoom") && !doc["max_zoom"].IsDouble()) ||
         !doc.HasMember("pixel_ratio") || !doc["pixel_ratio"].IsDouble()) {
@@ -59,35 +121,52 @@ OfflineRegionDefinition decodeOfflineRegionDefinition(const std::string& region)
     }
 
     std::string styleURL { doc["style_url"].GetString(), doc["style_url"].GetStringLength() };
-    LatLngBounds bounds = LatLngBounds::hull(
-        LatLng(doc["bounds"][0].GetDouble(), doc["bounds"][1].GetDouble()),
-        LatLng(doc["bounds"][2].GetDouble(), doc["bounds"][3].GetDouble()));
     double minZoom = doc["min_zoom"].GetDouble();
     double maxZoom = doc.HasMember("max_zoom") ? doc["max_zoom"].GetDouble() : INFINITY;
     float pixelRatio = doc["pixel_ratio"].GetDouble();
 
-    return { styleURL, bounds, minZoom, maxZoom, pixelRatio };
+    if (doc.HasMember("geometry")) {
+        return OfflineGeometryRegionDefinition {
+            styleURL, mapbox::geojson::convert<Geometry<double>>(doc["geometry"]), minZoom, maxZoom, pixelRatio
+        };
+    }
+
+    LatLngBounds bounds = LatLngBounds::hull(
+        LatLng(doc["bounds"][0].GetDouble(), doc["bounds"][1].GetDouble()),
+        LatLng(doc["bounds"][2].GetDouble(), doc["bounds"][3].GetDouble()));
+
+    return OfflineTilePyramidRegionDefinition { styleURL, bounds, minZoom, maxZoom, pixelRatio };
 }
 
 std::string encodeOfflineRegionDefinition(const OfflineRegionDefinition& region) {
     rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
     doc.SetObject();
 
-    doc.AddMember("style_url", rapidjson::StringRef(region.styleURL.data(), region.styleURL.length()), doc.GetAllocator());
-
-    rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator> bounds(rapidjson::kArrayType);
-    bounds.PushBack(region.bounds.south(), doc.GetAllocator());
-    bounds.PushBack(region.bounds.west(), doc.GetAllocator());
-    bounds.PushBack(region.bounds.north(), doc.GetAllocator());
-    bounds.PushBack(region.bounds.east(), doc.GetAllocator());
-    doc.AddMember("bounds", bounds, doc.GetAllocator());
-
-    doc.AddMember("min_zoom", region.minZoom, doc.GetAllocator());
-    if (std::isfinite(region.maxZoom)) {
-        doc.AddMember("max_zoom", region.maxZoom, doc.GetAllocator());
-    }
+    region.match([&](const auto& definition) {
+        doc.AddMember("style_url", rapidjson::StringRef(definition.styleURL.data(), definition.styleURL.length()), doc.GetAllocator());
+    });
+
+    region.match(
+        [&](const OfflineTilePyramidRegionDefinition& definition) {
+            rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator> bounds(rapidjson::kArrayType);
+            bounds.PushBack(definition.bounds.south(), doc.GetAllocator());
+            bounds.PushBack(definition.bounds.west(), doc.GetAllocator());
+            bounds.PushBack(definition.bounds.north(), doc.GetAllocator());
+            bounds.PushBack(definition.bounds.east(), doc.GetAllocator());
+            doc.AddMember("bounds", bounds, doc.GetAllocator());
+        },
+        [&](const OfflineGeometryRegionDefinition& definition) {
+            doc.AddMember("geometry", mapbox::geojson::convert(definition.geometry, doc.GetAllocator()), doc.GetAllocator());
+        });
+
+    region.match([&](const auto& definition) {
+        doc.AddMember("min_zoom", definition.minZoom, doc.GetAllocator());
+        if (std::isfinite(definition.maxZoom)) {
+            doc.AddMember("max_zoom", definition.maxZoom, doc.GetAllocator());
+        }
 
-    doc.AddMember("pixel_ratio", region.pixelRatio, doc.GetAllocator());
+        doc.AddMember("pixel_ratio", definition.pixelRatio, doc.GetAllocator());
+    });
 
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
@@ -5,26 +5,210 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/parallel.hpp>
 
 #include "sqlite3.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <tuple>
+
 namespace mbgl {
 
+namespace {
+
+constexpr const char regionArchiveMagic[8] = { 'M', 'B', 'G', 'L', 'R', 'E', 'G', 'N' };
+constexpr uint32_t regionArchiveVersion = 1;
+constexpr uint32_t absentString = std::numeric_limits<uint32_t>::max();
+constexpr int64_t absentTimestamp = std::numeric_limits<int64_t>::min();
+constexpr uint8_t noContentCodec = 255;
+
+enum class RegionArchiveEntry : uint8_t {
+    End = 0,
+    Resource = 1,
+    Tile = 2,
+};
+
+class RegionArchiveWriter {
+public:
+    explicit RegionArchiveWriter(const std::string& path)
+        : file(path, std::ios::binary | std::ios::trunc) {
+        if (!file) {
+            throw std::runtime_error("Unable to write region archive " + path);
+        }
+    }
+
+    template <class T>
+    void write(T value) {
+        using Unsigned = std::make_unsigned_t<T>;
+        auto bits = static_cast<Unsigned>(value);
+        char bytes[sizeof(T)];
+        for (char& byte : bytes) {
+            byte = static_cast<char>(bits & 0xFF);
+            bits = static_cast<Unsigned>(bits >> 8);
+        }
+        write(bytes, sizeof(T));
+    }
+
+    void write(const std::string& string) {
+        write(static_cast<uint32_t>(string.size()));
+        write(string.data(), string.size());
+    }
+
+    void write(const optional<std::string>& string) {
+        if (string) {
+            write(*string);
+        } else {
+            write(absentString);
+        }
+    }
+
+    void write(const optional<Timestamp>& time) {
+        write(time ? int64_t(time->time_since_epoch().count()) : absentTimestamp);
+    }
+
+    void write(const char* data, std::size_t size) {
+        if (!file.write(data, size)) {
+            throw std::runtime_error("Unable to write region archive");
+        }
+    }
+
+    void close() {
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Unable to write region archive");
+        }
+    }
+
+private:
+    std::ofstream file;
+};
+
+class RegionArchiveReader {
+public:
+    explicit RegionArchiveReader(const std::string& path)
+        : file(path, std::ios::binary) {
+        if (!file) {
+            throw std::runtime_error("Unable to read region archive " + path);
+        }
+    }
+
+    template <class T>
+    T read() {
+        using Unsigned = std::make_unsigned_t<T>;
+        unsigned char bytes[sizeof(T)];
+        read(reinterpret_cast<char*>(bytes), sizeof(T));
+        Unsigned bits = 0;
+        for (std::size_t i = sizeof(T); i-- > 0;) {
+            bits = static_cast<Unsigned>(bits << 8 | bytes[i]);
+        }
+        return static_cast<T>(bits);
+    }
+
+    std::string readString() {
+        const auto size = read<uint32_t>();
+        return readString(size);
+    }
+
+    optional<std::string> readOptionalString() {
+        const auto size = read<uint32_t>();
+        if (size == absentString) {
+            return {};
+        }
+        return readString(size);
+    }
+
+    optional<Timestamp> readTimestamp() {
+        const auto time = read<int64_t>();
+        if (time == absentTimestamp) {
+            return {};
+        }
+        return Timestamp(Seconds(time));
+    }
+
+    void read(char* data, std::size_t size) {
+        if (!file.read(data, size)) {
+            throw std::runtime_error("Truncated region archive");
+        }
+    }
+
+private:
+    std::string readString(uint32_t size) {
+        std::string result;
+        // Strings are read in chunks, so that a corrupt length fails as a truncated archive
+        // rather than as an allocation of up to 4 GB.
+        constexpr std::size_t chunk = 1024 * 1024;
+        while (result.size() < size) {
+            const std::size_t offset = result.size();
+            result.resize(std::min<std::size_t>(size, offset + chunk));
+            read(&result[offset], result.size() - offset);
+        }
+        return result;
+    }
+
+    std::ifstream file;
+};
+
+} // namespace
+
 OfflineDatabase::Statement::~Statement() {
     stmt.reset();
     stmt.clearBindings();
 }
 
+OfflineDatabase::WriteTransaction::WriteTransaction(OfflineDatabase& database_)
+    : database(database_) {
+    if (database.batch) {
+        database.db->exec("SAVEPOINT put");
+    } else {
+        transaction = std::make_unique<mapbox::sqlite::Transaction>(*database.db, mapbox::sqlite::Transaction::Immediate);
+    }
+}
+
+OfflineDatabase::WriteTransaction::~WriteTransaction() {
+    // A standalone transaction rolls itself back when destroyed without being committed.
+    if (pending && !transaction) {
+        try {
+            database.db->exec("ROLLBACK TO put");
+            database.db->exec("RELEASE put");
+        } catch (...) {
+            // Ignore failed rollbacks in destructor.
+        }
+    }
+}
+
+void OfflineDatabase::WriteTransaction::commit() {
+    pending = false;
+    if (transaction) {
+        transaction->commit();
+    } else {
+        database.db->exec("RELEASE put");
+    }
+}
+
 OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
     : path(std::move(path_)),
       maximumCacheSize(maximumCacheSize_) {
     ensureSchema();
 }
 
+OfflineDatabase::OfflineDatabase(std::string path_, ReadOnly)
+    : path(std::move(path_)),
+      readOnly(true),
+      maximumCacheSize(0) {
+    connect(mapbox::sqlite::ReadOnly);
+}
+
+void OfflineDatabase::enableConcurrentReads() {
+    db->exec("PRAGMA journal_mode = WAL");
+}
+
 OfflineDatabase::~OfflineDatabase() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
     try {
+        flush();
         statements.clear();
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
@@ -49,7 +233,11 @@ void OfflineDatabase::ensureSchema() {
             case 2: migrateToVersion3(); // fall through
             case 3: // no-op and fall through
             case 4: migrateToVersion5(); // fall through
-            case 5: return;
+            case 5: migrateToVersion6(); // fall through
+            case 6: migrateToVersion7(); // fall through
+            case 7: migrateToVersion8(); // fall through
+            case 8: migrateToVersion9(); // fall through
+            case 9: return;
             default: throw std::runtime_error("unknown schema version");
             }
 
@@ -83,7 +271,7 @@ void OfflineDatabase::ensureSchema() {
         db->exec("PRAGMA journal_mode = DELETE");
         db->exec("PRAGMA synchronous = FULL");
         db->exec(schema);
-        db->exec("PRAGMA user_version = 5");
+        db->exec("PRAGMA user_version = 9");
     } catch (...) {
         Log::Error(Event::Database, "Unexpected error creating database schema: %s", util::toString(std::current_exception()).c_str());
         throw;
@@ -126,6 +314,86 @@ void OfflineDatabase::migrateToVersion5() {
     db->exec("PRAGMA user_version = 5");
 }
 
+void OfflineDatabase::migrateToVersion6() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("CREATE TABLE dictionaries ("
+             "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+             "  url_template TEXT NOT NULL,"
+             "  codec INTEGER NOT NULL,"
+             "  data BLOB NOT NULL,"
+             "  UNIQUE (url_template, codec)"
+             ")");
+    db->exec("PRAGMA user_version = 6");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion7() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("CREATE TABLE region_syncs ("
+             "  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,"
+             "  url_template TEXT NOT NULL,"
+             "  synced INTEGER NOT NULL,"
+             "  UNIQUE (region_id, url_template)"
+             ")");
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion8() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("ALTER TABLE resources ADD COLUMN region_count INTEGER NOT NULL DEFAULT 0");
+    db->exec("ALTER TABLE tiles ADD COLUMN region_count INTEGER NOT NULL DEFAULT 0");
+    db->exec("UPDATE resources SET region_count = "
+             "  (SELECT COUNT(*) FROM region_resources WHERE resource_id = resources.id) "
+             "WHERE id IN (SELECT resource_id FROM region_resources)");
+    db->exec("UPDATE tiles SET region_count = "
+             "  (SELECT COUNT(*) FROM region_tiles WHERE tile_id = tiles.id) "
+             "WHERE id IN (SELECT tile_id FROM region_tiles)");
+    db->exec("CREATE TRIGGER region_resources_insert AFTER INSERT ON region_resources "
+             "BEGIN UPDATE resources SET region_count = region_count + 1 WHERE id = NEW.resource_id; END");
+    db->exec("CREATE TRIGGER region_resources_delete AFTER DELETE ON region_resources "
+             "BEGIN UPDATE resources SET region_count = region_count - 1 WHERE id = OLD.resource_id; END");
+    db->exec("CREATE TRIGGER region_tiles_insert AFTER INSERT ON region_tiles "
+             "BEGIN UPDATE tiles SET region_count = region_count + 1 WHERE id = NEW.tile_id; END");
+    db->exec("CREATE TRIGGER region_tiles_delete AFTER DELETE ON region_tiles "
+             "BEGIN UPDATE tiles SET region_count = region_count - 1 WHERE id = OLD.tile_id; END");
+    db->exec("DROP INDEX IF EXISTS resources_accessed");
+    db->exec("DROP INDEX IF EXISTS tiles_accessed");
+    db->exec("CREATE INDEX resources_evictable ON resources (region_count, accessed)");
+    db->exec("CREATE INDEX tiles_evictable ON tiles (region_count, accessed)");
+    db->exec("PRAGMA user_version = 8");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion9() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("CREATE TABLE tile_blobs ("
+             "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+             "  hash INTEGER NOT NULL,"
+             "  data BLOB NOT NULL,"
+             "  compressed INTEGER NOT NULL DEFAULT 0,"
+             "  tile_count INTEGER NOT NULL DEFAULT 0"
+             ")");
+    db->exec("ALTER TABLE tiles ADD COLUMN blob_id INTEGER REFERENCES tile_blobs(id)");
+    db->exec("CREATE TRIGGER tiles_blob_insert AFTER INSERT ON tiles WHEN NEW.blob_id IS NOT NULL "
+             "BEGIN UPDATE tile_blobs SET tile_count = tile_count + 1 WHERE id = NEW.blob_id; END");
+    db->exec("CREATE TRIGGER tiles_blob_update AFTER UPDATE OF blob_id ON tiles "
+             "BEGIN"
+             "  UPDATE tile_blobs SET tile_count = tile_count + 1 WHERE id = NEW.blob_id;"
+             "  UPDATE tile_blobs SET tile_count = tile_count - 1 WHERE id = OLD.blob_id;"
+             "  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND tile_count = 0;"
+             " END");
+    db->exec("CREATE TRIGGER tiles_blob_delete AFTER DELETE ON tiles WHEN OLD.blob_id IS NOT NULL "
+             "BEGIN"
+             "  UPDATE tile_blobs SET tile_count = tile_count - 1 WHERE id = OLD.blob_id;"
+             "  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND tile_count = 0;"
+             " END");
+    db->exec("CREATE INDEX tile_blobs_hash ON tile_blobs (hash)");
+    db->exec("CREATE INDEX tiles_blob_id ON tiles (blob_id)");
+    db->exec("PRAGMA user_version = 9");
+    transaction.commit();
+}
+
 OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
     auto it = statements.find(sql);
 
@@ -142,12 +410,19 @@ optional<Response> OfflineDatabase::get(const Resource& resource) {
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
+    optional<std::pair<Response, uint64_t>> result;
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
-        return getTile(*resource.tileData);
+        result = getTile(*resource.tileData);
     } else {
-        return getResource(resource);
+        result = getResource(resource);
+    }
+
+    if (result && !readOnly) {
+        recordAccess(resource);
     }
+
+    return result;
 }
 
 optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
@@ -160,7 +435,10 @@ optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
 }
 
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) {
-    return putInternal(resource, response, true);
+    beginWrite();
+    auto result = putInternal(resource, response, true);
+    endWrite();
+    return result;
 }
 
 std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource, const Response& response, bool evict_) {
@@ -168,14 +446,22 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
         return { false, 0 };
     }
 
-    std::string compressedData;
-    bool compressed = false;
+    return putInternal(resource, response, evict_,
+                       response.data ? compressEntry(resource, *response.data) : std::pair<int64_t, std::string>());
+}
+
+std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource, const Response& response, bool evict_,
+                                                       const std::pair<int64_t, std::string>& compressed) {
+    if (response.error) {
+        return { false, 0 };
+    }
+
+    const int64_t compression = compressed.first;
+    const std::string& compressedData = compressed.second;
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
-        size = compressed ? compressedData.size() : response.data->size();
+        size = compression ? compressedData.size() : response.data->size();
     }
 
     if (evict_ && !evict(size)) {
@@ -188,27 +474,18 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compression ? compressedData : response.data ? *response.data : "",
+                compression);
     } else {
         inserted = putResource(resource, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compression ? compressedData : response.data ? *response.data : "",
+                compression);
     }
 
     return { inserted, size };
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // clang-format off
-    Statement accessedStmt = getStatement(
-        "UPDATE resources SET accessed = ?1 WHERE url = ?2");
-    // clang-format on
-
-    accessedStmt->bind(1, util::now());
-    accessedStmt->bind(2, resource.url);
-    accessedStmt->run();
-
     // clang-format off
     Statement stmt = getStatement(
         //        0      1        2       3        4
@@ -233,12 +510,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     optional<std::string> data = stmt->get<optional<std::string>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+    } else if (int64_t compression = stmt->get<int64_t>(4)) {
+        response.data = std::make_shared<std::string>(decompressEntry(*data, compression));
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -260,7 +537,7 @@ optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
                                   const std::string& data,
-                                  bool compressed) {
+                                  int64_t compression) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -281,7 +558,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
     // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    WriteTransaction transaction(*this);
 
     // clang-format off
     Statement update = getStatement(
@@ -308,7 +585,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         update->bind(7, false);
     } else {
         update->bindBlob(6, data.data(), data.size(), false);
-        update->bind(7, compressed);
+        update->bind(7, compression);
     }
 
     update->run();
@@ -335,7 +612,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         insert->bind(8, false);
     } else {
         insert->bindBlob(7, data.data(), data.size(), false);
-        insert->bind(8, compressed);
+        insert->bind(8, compression);
     }
 
     insert->run();
@@ -345,30 +622,14 @@ bool OfflineDatabase::putResource(const Resource& resource,
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // clang-format off
-    Statement accessedStmt = getStatement(
-        "UPDATE tiles "
-        "SET accessed       = ?1 "
-        "WHERE url_template = ?2 "
-        "  AND pixel_ratio  = ?3 "
-        "  AND x            = ?4 "
-        "  AND y            = ?5 "
-        "  AND z            = ?6 ");
-    // clang-format on
-
-    accessedStmt->bind(1, util::now());
-    accessedStmt->bind(2, tile.urlTemplate);
-    accessedStmt->bind(3, tile.pixelRatio);
-    accessedStmt->bind(4, tile.x);
-    accessedStmt->bind(5, tile.y);
-    accessedStmt->bind(6, tile.z);
-    accessedStmt->run();
-
     // clang-format off
     Statement stmt = getStatement(
-        //        0      1        2       3        4
-        "SELECT etag, expires, modified, data, compressed "
+        //        0      1        2
+        "SELECT etag, expires, modified, "
+        //                     3                                       4
+        "       coalesce(tile_blobs.data, tiles.data), coalesce(tile_blobs.compressed, tiles.compressed) "
         "FROM tiles "
+        "LEFT JOIN tile_blobs ON tile_blobs.id = blob_id "
         "WHERE url_template = ?1 "
         "  AND pixel_ratio  = ?2 "
         "  AND x            = ?3 "
@@ -396,12 +657,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     optional<std::string> data = stmt->get<optional<std::string>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+    } else if (int64_t compression = stmt->get<int64_t>(4)) {
+        response.data = std::make_shared<std::string>(decompressEntry(*data, compression));
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -410,8 +671,9 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
 optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
     // clang-format off
     Statement stmt = getStatement(
-        "SELECT length(data) "
+        "SELECT length(coalesce(tile_blobs.data, tiles.data)) "
         "FROM tiles "
+        "LEFT JOIN tile_blobs ON tile_blobs.id = blob_id "
         "WHERE url_template = ?1 "
         "  AND pixel_ratio  = ?2 "
         "  AND x            = ?3 "
@@ -435,7 +697,7 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              int64_t compression) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -464,7 +726,12 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
     // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    WriteTransaction transaction(*this);
+
+    optional<int64_t> blobID;
+    if (deduplicateTiles && !response.noContent) {
+        blobID = putTileBlob(data, compression);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -474,7 +741,8 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         "    expires        = ?3, "
         "    accessed       = ?4, "
         "    data           = ?5, "
-        "    compressed     = ?6 "
+        "    compressed     = ?6, "
+        "    blob_id        = ?12 "
         "WHERE url_template = ?7 "
         "  AND pixel_ratio  = ?8 "
         "  AND x            = ?9 "
@@ -492,12 +760,17 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     update->bind(10, tile.y);
     update->bind(11, tile.z);
 
-    if (response.noContent) {
+    if (response.noContent || blobID) {
         update->bind(5, nullptr);
         update->bind(6, false);
     } else {
         update->bindBlob(5, data.data(), data.size(), false);
-        update->bind(6, compressed);
+        update->bind(6, compression);
+    }
+    if (blobID) {
+        update->bind(12, *blobID);
+    } else {
+        update->bind(12, nullptr);
     }
 
     update->run();
@@ -508,8 +781,8 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
     // clang-format off
     Statement insert = getStatement(
-        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified,  etag,  expires,  accessed,  data, compressed) "
-        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,        ?7,    ?8,       ?9,        ?10,  ?11) ");
+        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified,  etag,  expires,  accessed,  data, compressed, blob_id) "
+        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,        ?7,    ?8,       ?9,        ?10,  ?11,        ?12) ");
     // clang-format on
 
     insert->bind(1, tile.urlTemplate);
@@ -522,12 +795,17 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     insert->bind(8, response.expires);
     insert->bind(9, util::now());
 
-    if (response.noContent) {
+    if (response.noContent || blobID) {
         insert->bind(10, nullptr);
         insert->bind(11, false);
     } else {
         insert->bindBlob(10, data.data(), data.size(), false);
-        insert->bind(11, compressed);
+        insert->bind(11, compression);
+    }
+    if (blobID) {
+        insert->bind(12, *blobID);
+    } else {
+        insert->bind(12, nullptr);
     }
 
     insert->run();
@@ -536,6 +814,44 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     return true;
 }
 
+int64_t OfflineDatabase::putTileBlob(const std::string& data, int64_t compression) {
+    // FNV-1a, which unlike std::hash is the same on every platform reading the database.
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : data) {
+        hash = (hash ^ uint8_t(c)) * 1099511628211ULL;
+    }
+
+    // clang-format off
+    Statement select = getStatement(
+        "SELECT id "
+        "FROM tile_blobs "
+        "WHERE hash       = ?1 "
+        "  AND compressed = ?2 "
+        "  AND data       = ?3 "
+        "LIMIT 1 ");
+    // clang-format on
+
+    select->bind(1, int64_t(hash));
+    select->bind(2, compression);
+    select->bindBlob(3, data.data(), data.size(), false);
+    if (select->run()) {
+        return select->get<int64_t>(0);
+    }
+
+    // Unreferenced until the tile is written, in the same transaction.
+    // clang-format off
+    Statement insert = getStatement(
+        "INSERT INTO tile_blobs (hash, data, compressed) "
+        "VALUES                 (?1,   ?2,   ?3) ");
+    // clang-format on
+
+    insert->bind(1, int64_t(hash));
+    insert->bindBlob(2, data.data(), data.size(), false);
+    insert->bind(3, compression);
+    insert->run();
+    return insert->lastInsertRowId();
+}
+
 std::vector<OfflineRegion> OfflineDatabase::listRegions() {
     // clang-format off
     Statement stmt = getStatement(
@@ -583,13 +899,37 @@ OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, co
 }
 
 void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
-    // clang-format off
-    Statement stmt = getStatement(
-        "DELETE FROM regions WHERE id = ?");
-    // clang-format on
+    // Vacuuming below must not be part of a pending batch.
+    flush();
 
-    stmt->bind(1, region.getID());
-    stmt->run();
+    // Deleting the region's rows through the (region_id, ...) unique indexes releases its
+    // resources and tiles, by the triggers on these tables, in time proportional to their number.
+    {
+        WriteTransaction transaction(*this);
+
+        // clang-format off
+        Statement resources = getStatement(
+            "DELETE FROM region_resources WHERE region_id = ?");
+        // clang-format on
+        resources->bind(1, region.getID());
+        resources->run();
+
+        // clang-format off
+        Statement tiles = getStatement(
+            "DELETE FROM region_tiles WHERE region_id = ?");
+        // clang-format on
+        tiles->bind(1, region.getID());
+        tiles->run();
+
+        // clang-format off
+        Statement stmt = getStatement(
+            "DELETE FROM regions WHERE id = ?");
+        // clang-format on
+        stmt->bind(1, region.getID());
+        stmt->run();
+
+        transaction.commit();
+    }
 
     evict(0);
     db->exec("PRAGMA incremental_vacuum");
@@ -619,6 +959,7 @@ optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Res
 }
 
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
+    beginWrite();
     uint64_t size = putInternal(resource, response, false).second;
     bool previouslyUnused = markUsed(regionID, resource);
 
@@ -629,9 +970,69 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& re
         *offlineMapboxTileCount += 1;
     }
 
+    endWrite();
     return size;
 }
 
+uint64_t OfflineDatabase::putRegionResources(int64_t regionID,
+                                             const std::vector<std::pair<Resource, Response>>& resources,
+                                             Scheduler& scheduler) {
+    // Dictionaries are picked, and trained, in the order the resources would have been stored
+    // one by one, before the compression itself is spread across threads.
+    std::vector<int64_t> dictionaryIDs(resources.size(), 0);
+    if (codec == util::Codec::Zstd) {
+        for (std::size_t i = 0; i < resources.size(); i++) {
+            const Resource& resource = resources[i].first;
+            const Response& response = resources[i].second;
+            if (resource.kind == Resource::Kind::Tile && response.data && !response.error) {
+                assert(resource.tileData);
+                dictionaryIDs[i] = tileDictionaryID(resource.tileData->urlTemplate, *response.data);
+                if (dictionaryIDs[i]) {
+                    getDictionary(dictionaryIDs[i]);
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<int64_t, std::string>> compressed(resources.size());
+    util::parallelFor(scheduler, resources.size(), [&] (std::size_t i) {
+        const Response& response = resources[i].second;
+        if (response.data && !response.error) {
+            compressed[i] = compressEntry(*response.data, dictionaryIDs[i]);
+        }
+    });
+
+    // Like an import, all resources are stored in one batch.
+    flush();
+    batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+
+    try {
+        uint64_t size = 0;
+        bool addedMapboxTiles = false;
+        for (std::size_t i = 0; i < resources.size(); i++) {
+            const Resource& resource = resources[i].first;
+            size += putInternal(resource, resources[i].second, false, compressed[i]).second;
+            if (markUsed(regionID, resource) && resource.kind == Resource::Kind::Tile &&
+                util::mapbox::isMapboxURL(resource.url)) {
+                addedMapboxTiles = true;
+            }
+        }
+
+        offlineMapboxTileCount = {};
+        if (addedMapboxTiles && getOfflineMapboxTileCount() > offlineMapboxTileCountLimit) {
+            throw std::runtime_error("Mapbox tile limit exceeded");
+        }
+
+        auto transaction = std::move(batch);
+        transaction->commit();
+        return size;
+    } catch (...) {
+        batch.reset();
+        offlineMapboxTileCount = {};
+        throw;
+    }
+}
+
 bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         // clang-format off
@@ -661,24 +1062,21 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
 
         // clang-format off
         Statement select = getStatement(
-            "SELECT region_id "
-            "FROM region_tiles, tiles "
-            "WHERE region_id   != ?1 "
-            "  AND url_template = ?2 "
-            "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 "
-            "LIMIT 1 ");
+            "SELECT region_count "
+            "FROM tiles "
+            "WHERE url_template = ?1 "
+            "  AND pixel_ratio  = ?2 "
+            "  AND x            = ?3 "
+            "  AND y            = ?4 "
+            "  AND z            = ?5 ");
         // clang-format on
 
-        select->bind(1, regionID);
-        select->bind(2, tile.urlTemplate);
-        select->bind(3, tile.pixelRatio);
-        select->bind(4, tile.x);
-        select->bind(5, tile.y);
-        select->bind(6, tile.z);
-        return !select->run();
+        select->bind(1, tile.urlTemplate);
+        select->bind(2, tile.pixelRatio);
+        select->bind(3, tile.x);
+        select->bind(4, tile.y);
+        select->bind(5, tile.z);
+        return select->run() && select->get<int64_t>(0) == 1;
     } else {
         // clang-format off
         Statement insert = getStatement(
@@ -698,16 +1096,13 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
 
         // clang-format off
         Statement select = getStatement(
-            "SELECT region_id "
-            "FROM region_resources, resources "
-            "WHERE region_id    != ?1 "
-            "  AND resources.url = ?2 "
-            "LIMIT 1 ");
+            "SELECT region_count "
+            "FROM resources "
+            "WHERE url = ?1 ");
         // clang-format on
 
-        select->bind(1, regionID);
-        select->bind(2, resource.url);
-        return !select->run();
+        select->bind(1, resource.url);
+        return select->run() && select->get<int64_t>(0) == 1;
     }
 }
 
@@ -723,6 +1118,241 @@ OfflineRegionDefinition OfflineDatabase::getRegionDefinition(int64_t regionID) {
     return decodeOfflineRegionDefinition(stmt->get<std::string>(0));
 }
 
+optional<Timestamp> OfflineDatabase::getRegionSyncTime(int64_t regionID, const std::string& urlTemplate) {
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT synced FROM region_syncs "
+        "WHERE region_id = ?1 AND url_template = ?2");
+    // clang-format on
+
+    stmt->bind(1, regionID);
+    stmt->bind(2, urlTemplate);
+    if (!stmt->run()) {
+        return {};
+    }
+
+    return stmt->get<Timestamp>(0);
+}
+
+void OfflineDatabase::setRegionSyncTime(int64_t regionID, const std::string& urlTemplate, Timestamp synced) {
+    // clang-format off
+    Statement stmt = getStatement(
+        "INSERT OR REPLACE INTO region_syncs (region_id, url_template, synced) "
+        "VALUES                              (?1,        ?2,           ?3) ");
+    // clang-format on
+
+    stmt->bind(1, regionID);
+    stmt->bind(2, urlTemplate);
+    stmt->bind(3, synced);
+    stmt->run();
+}
+
+uint64_t OfflineDatabase::revalidateRegionTiles(int64_t regionID,
+                                                const std::string& urlTemplate,
+                                                optional<Timestamp> expires) {
+    // A single statement, rather than a 304 response per tile.
+    // clang-format off
+    Statement stmt = getStatement(
+        "UPDATE tiles "
+        "SET expires = ?1 "
+        "WHERE url_template = ?2 "
+        "  AND id IN (SELECT tile_id FROM region_tiles WHERE region_id = ?3) ");
+    // clang-format on
+
+    stmt->bind(1, expires);
+    stmt->bind(2, urlTemplate);
+    stmt->bind(3, regionID);
+    stmt->run();
+    return stmt->changes();
+}
+
+void OfflineDatabase::exportRegion(int64_t regionID, const std::string& archivePath) {
+    // Pending writes of the region's download belong in the archive.
+    flush();
+
+    // clang-format off
+    Statement region = getStatement(
+        "SELECT definition, description FROM regions WHERE id = ?1");
+    // clang-format on
+
+    region->bind(1, regionID);
+    if (!region->run()) {
+        throw std::runtime_error("Unknown offline region");
+    }
+
+    RegionArchiveWriter writer(archivePath);
+    writer.write(regionArchiveMagic, sizeof(regionArchiveMagic));
+    writer.write(regionArchiveVersion);
+    writer.write(region->get<std::string>(0));
+    const auto metadata = region->get<std::vector<uint8_t>>(1);
+    writer.write(std::string(metadata.begin(), metadata.end()));
+
+    // Entries are stored compressed with zlib, which every build can decompress, unless that
+    // doesn't make them any smaller. Data the database compressed with zlib alone is copied as is.
+    auto writeData = [&] (const optional<std::string>& data, int64_t compression) {
+        if (!data) {
+            writer.write(noContentCodec);
+            writer.write(std::string());
+        } else if (compression == int64_t(util::Codec::Zlib)) {
+            writer.write(uint8_t(util::Codec::Zlib));
+            writer.write(*data);
+        } else {
+            const std::string raw = compression ? decompressEntry(*data, compression) : *data;
+            std::string compressed = util::compress(raw);
+            if (compressed.size() < raw.size()) {
+                writer.write(uint8_t(util::Codec::Zlib));
+                writer.write(compressed);
+            } else {
+                writer.write(uint8_t(util::Codec::None));
+                writer.write(raw);
+            }
+        }
+    };
+
+    uint64_t entries = 0;
+
+    // clang-format off
+    Statement resources = getStatement(
+        //        0     1      2         3        4     5      6
+        "SELECT url, kind, expires, modified, etag, data, compressed "
+        "FROM region_resources, resources "
+        "WHERE region_id = ?1 "
+        "AND resource_id = resources.id ");
+    // clang-format on
+
+    resources->bind(1, regionID);
+    while (resources->run()) {
+        writer.write(uint8_t(RegionArchiveEntry::Resource));
+        writer.write(uint8_t(resources->get<int64_t>(1)));
+        writer.write(resources->get<std::string>(0));
+        writer.write(resources->get<optional<Timestamp>>(2));
+        writer.write(resources->get<optional<Timestamp>>(3));
+        writer.write(resources->get<optional<std::string>>(4));
+        writeData(resources->get<optional<std::string>>(5), resources->get<int64_t>(6));
+        entries++;
+    }
+
+    // clang-format off
+    Statement tiles = getStatement(
+        //             0            1     2  3  4     5         6        7
+        "SELECT url_template, pixel_ratio, z, x, y, expires, modified, etag, "
+        //                     8                                       9
+        "       coalesce(tile_blobs.data, tiles.data), coalesce(tile_blobs.compressed, tiles.compressed) "
+        "FROM region_tiles "
+        "JOIN tiles ON tile_id = tiles.id "
+        "LEFT JOIN tile_blobs ON tile_blobs.id = blob_id "
+        "WHERE region_id = ?1 ");
+    // clang-format on
+
+    tiles->bind(1, regionID);
+    while (tiles->run()) {
+        writer.write(uint8_t(RegionArchiveEntry::Tile));
+        writer.write(tiles->get<std::string>(0));
+        writer.write(uint8_t(tiles->get<int64_t>(1)));
+        writer.write(int8_t(tiles->get<int64_t>(2)));
+        writer.write(int32_t(tiles->get<int64_t>(3)));
+        writer.write(int32_t(tiles->get<int64_t>(4)));
+        writer.write(tiles->get<optional<Timestamp>>(5));
+        writer.write(tiles->get<optional<Timestamp>>(6));
+        writer.write(tiles->get<optional<std::string>>(7));
+        writeData(tiles->get<optional<std::string>>(8), tiles->get<int64_t>(9));
+        entries++;
+    }
+
+    writer.write(uint8_t(RegionArchiveEntry::End));
+    writer.write(entries);
+    writer.close();
+}
+
+OfflineRegion OfflineDatabase::importRegion(const std::string& archivePath) {
+    RegionArchiveReader reader(archivePath);
+
+    char magic[sizeof(regionArchiveMagic)];
+    reader.read(magic, sizeof(magic));
+    if (!std::equal(magic, magic + sizeof(magic), regionArchiveMagic)) {
+        throw std::runtime_error("Not a region archive");
+    }
+    if (reader.read<uint32_t>() != regionArchiveVersion) {
+        throw std::runtime_error("Unsupported region archive version");
+    }
+
+    const OfflineRegionDefinition definition = decodeOfflineRegionDefinition(reader.readString());
+    const std::string metadata = reader.readString();
+
+    // The import is a single batch, so that each entry is a savepoint within it rather than a
+    // transaction of its own, and so that nothing is left behind if it fails.
+    flush();
+    batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+    offlineMapboxTileCount = {};
+
+    try {
+        OfflineRegion region = createRegion(definition, OfflineRegionMetadata(metadata.begin(), metadata.end()));
+
+        uint64_t entries = 0;
+        while (true) {
+            const auto type = RegionArchiveEntry(reader.read<uint8_t>());
+            if (type == RegionArchiveEntry::End) {
+                if (reader.read<uint64_t>() != entries) {
+                    throw std::runtime_error("Corrupt region archive");
+                }
+                break;
+            }
+
+            optional<Resource> resource;
+            if (type == RegionArchiveEntry::Resource) {
+                const auto kind = Resource::Kind(reader.read<uint8_t>());
+                resource = Resource(kind, reader.readString());
+            } else if (type == RegionArchiveEntry::Tile) {
+                Resource::TileData tile;
+                tile.urlTemplate = reader.readString();
+                tile.pixelRatio = reader.read<uint8_t>();
+                tile.z = reader.read<int8_t>();
+                tile.x = reader.read<int32_t>();
+                tile.y = reader.read<int32_t>();
+                resource = Resource(Resource::Kind::Tile, tile.urlTemplate, tile);
+            } else {
+                throw std::runtime_error("Corrupt region archive");
+            }
+
+            Response response;
+            response.expires = reader.readTimestamp();
+            response.modified = reader.readTimestamp();
+            response.etag = reader.readOptionalString();
+
+            const auto codec = reader.read<uint8_t>();
+            std::string data = reader.readString();
+            if (codec == noContentCodec) {
+                response.noContent = true;
+            } else if (codec == uint8_t(util::Codec::Zlib)) {
+                response.data = std::make_shared<std::string>(util::decompress(data, util::Codec::Zlib));
+            } else if (codec == uint8_t(util::Codec::None)) {
+                response.data = std::make_shared<std::string>(std::move(data));
+            } else {
+                throw std::runtime_error("Corrupt region archive");
+            }
+
+            putInternal(*resource, response, false);
+            markUsed(region.getID(), *resource);
+            entries++;
+        }
+
+        // Imports count against the limit like downloads do.
+        offlineMapboxTileCount = {};
+        if (getOfflineMapboxTileCount() > offlineMapboxTileCountLimit) {
+            throw std::runtime_error("Mapbox tile limit exceeded");
+        }
+
+        auto transaction = std::move(batch);
+        transaction->commit();
+        return region;
+    } catch (...) {
+        // Rolls the import back.
+        batch.reset();
+        offlineMapboxTileCount = {};
+        throw;
+    }
+}
+
 OfflineRegionStatus OfflineDatabase::getRegionCompletedStatus(int64_t regionID) {
     OfflineRegionStatus result;
 
@@ -753,10 +1383,11 @@ std::pair<int64_t, int64_t> OfflineDatabase::getCompletedResourceCountAndSize(in
 std::pair<int64_t, int64_t> OfflineDatabase::getCompletedTileCountAndSize(int64_t regionID) {
     // clang-format off
     Statement stmt = getStatement(
-        "SELECT COUNT(*), SUM(LENGTH(data)) "
-        "FROM region_tiles, tiles "
-        "WHERE region_id = ?1 "
-        "AND tile_id = tiles.id ");
+        "SELECT COUNT(*), SUM(LENGTH(coalesce(tile_blobs.data, tiles.data))) "
+        "FROM region_tiles "
+        "JOIN tiles ON tile_id = tiles.id "
+        "LEFT JOIN tile_blobs ON tile_blobs.id = blob_id "
+        "WHERE region_id = ?1 ");
     // clang-format on
     stmt->bind(1, regionID);
     stmt->run();
@@ -770,91 +1401,205 @@ T OfflineDatabase::getPragma(const char * sql) {
     return stmt->get<T>(0);
 }
 
+uint64_t OfflineDatabase::usedSize() {
+    // SQLite database never shrinks in size unless we call VACCUM. We here
+    // are monitoring the soft limit (i.e. number of free pages in the file)
+    // and as it approaches to the hard limit (i.e. the actual file size) we
+    // delete an arbitrary number of old cache entries. The free pages approach saves
+    // us from calling VACCUM or keeping a running total, which can be costly.
+    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
+
+    // The addition of pageSize is a fudge factor to account for non `data` column
+    // size, and because pages can get fragmented on the database.
+    return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count") + 1);
+}
+
 // Remove least-recently used resources and tiles until the used database size,
 // as calculated by multiplying the number of in-use pages by the page size, is
 // less than the maximum cache size. Returns false if this condition cannot be
 // satisfied.
-//
-// SQLite database never shrinks in size unless we call VACCUM. We here
-// are monitoring the soft limit (i.e. number of free pages in the file)
-// and as it approaches to the hard limit (i.e. the actual file size) we
-// delete an arbitrary number of old cache entries. The free pages approach saves
-// us from calling VACCUM or keeping a running total, which can be costly.
 bool OfflineDatabase::evict(uint64_t neededFreeSize) {
-    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
-
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
+    flushAccesses();
 
-    // The addition of pageSize is a fudge factor to account for non `data` column
-    // size, and because pages can get fragmented on the database.
-    while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
-        // clang-format off
-        Statement accessedStmt = getStatement(
-            "SELECT max(accessed) "
-            "FROM ( "
-            "    SELECT accessed "
-            "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
-            "  UNION ALL "
-            "    SELECT accessed "
-            "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") "
-        );
-        accessedStmt->bind(1, 50);
-        // clang-format on
-        if (!accessedStmt->run()) {
+    uint64_t size = usedSize();
+    while (size + neededFreeSize > maximumCacheSize) {
+        if (!evictChunk()) {
             return false;
         }
-        Timestamp accessed = accessedStmt->get<Timestamp>(0);
+        size = usedSize();
+    }
+
+    if (size + neededFreeSize > maximumCacheSize * highWatermark) {
+        evictionPending = true;
+    }
+
+    return true;
+}
+
+bool OfflineDatabase::evictIncrementally() {
+    if (!evictionPending) {
+        return false;
+    }
+
+    flushAccesses();
+
+    if (usedSize() <= maximumCacheSize * lowWatermark) {
+        evictionPending = false;
+        return false;
+    }
+
+    WriteTransaction transaction(*this);
+    evictionPending = evictChunk();
+    transaction.commit();
+
+    return evictionPending;
+}
+
+bool OfflineDatabase::isEvictionPending() const {
+    return evictionPending;
+}
+
+void OfflineDatabase::setEvictionWatermarks(double high, double low) {
+    assert(low <= high && high <= 1);
+    highWatermark = high;
+    lowWatermark = low;
+}
+
+// Removes up to `evictionChunkSize` of the least-recently used resources and as many tiles.
+// Returns false if there was nothing left to remove.
+bool OfflineDatabase::evictChunk() {
+    // Resources and tiles no region requires are found through the (region_count, accessed)
+    // indexes, in order of access, whatever the number of those regions do require.
+    // clang-format off
+    Statement accessedStmt = getStatement(
+        "SELECT max(accessed) "
+        "FROM ( "
+        "    SELECT accessed FROM ( "
+        "      SELECT accessed "
+        "      FROM resources "
+        "      WHERE region_count = 0 "
+        "      ORDER BY accessed ASC LIMIT ?1 "
+        "    ) "
+        "  UNION ALL "
+        "    SELECT accessed FROM ( "
+        "      SELECT accessed "
+        "      FROM tiles "
+        "      WHERE region_count = 0 "
+        "      ORDER BY accessed ASC LIMIT ?1 "
+        "    ) "
+        "  ORDER BY accessed ASC LIMIT ?1 "
+        ") "
+    );
+    accessedStmt->bind(1, evictionChunkSize);
+    // clang-format on
+    if (!accessedStmt->run()) {
+        return false;
+    }
+    Timestamp accessed = accessedStmt->get<Timestamp>(0);
 
+    // clang-format off
+    Statement stmt1 = getStatement(
+        "DELETE FROM resources "
+        "WHERE id IN ( "
+        "  SELECT id FROM resources "
+        "  WHERE region_count = 0 "
+        "  AND accessed <= ?1 "
+        "  ORDER BY accessed ASC LIMIT ?2 "
+        ") ");
+    // clang-format on
+    stmt1->bind(1, accessed);
+    stmt1->bind(2, evictionChunkSize);
+    stmt1->run();
+    uint64_t changes1 = stmt1->changes();
+
+    // clang-format off
+    Statement stmt2 = getStatement(
+        "DELETE FROM tiles "
+        "WHERE id IN ( "
+        "  SELECT id FROM tiles "
+        "  WHERE region_count = 0 "
+        "  AND accessed <= ?1 "
+        "  ORDER BY accessed ASC LIMIT ?2 "
+        ") ");
+    // clang-format on
+    stmt2->bind(1, accessed);
+    stmt2->bind(2, evictionChunkSize);
+    stmt2->run();
+    uint64_t changes2 = stmt2->changes();
+
+    // The cached value of offlineTileCount does not need to be updated
+    // here because only non-offline tiles can be removed by eviction.
+
+    return changes1 != 0 || changes2 != 0;
+}
+
+void OfflineDatabase::recordAccess(const Resource& resource) {
+    if (readOnly) {
+        return;
+    }
+
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        tileAccesses.emplace_back(*resource.tileData, util::now());
+    } else {
+        resourceAccesses.emplace_back(resource.url, util::now());
+    }
+
+    if (resourceAccesses.size() + tileAccesses.size() >= accessFlushSize) {
+        flushAccesses();
+    }
+}
+
+// Writes the access times recorded since the last flush, all in one transaction.
+void OfflineDatabase::flushAccesses() {
+    if (resourceAccesses.empty() && tileAccesses.empty()) {
+        return;
+    }
+
+    // Access times only steer eviction; if writing them fails, they are dropped.
+    auto resources = std::move(resourceAccesses);
+    auto tiles = std::move(tileAccesses);
+    resourceAccesses.clear();
+    tileAccesses.clear();
+
+    WriteTransaction transaction(*this);
+
+    for (const auto& access : resources) {
         // clang-format off
-        Statement stmt1 = getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ");
+        Statement stmt = getStatement(
+            "UPDATE resources SET accessed = ?1 WHERE url = ?2 AND accessed < ?1");
         // clang-format on
-        stmt1->bind(1, accessed);
-        stmt1->run();
-        uint64_t changes1 = stmt1->changes();
 
+        stmt->bind(1, access.second);
+        stmt->bind(2, access.first);
+        stmt->run();
+    }
+
+    for (const auto& access : tiles) {
         // clang-format off
-        Statement stmt2 = getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ");
+        Statement stmt = getStatement(
+            "UPDATE tiles "
+            "SET accessed       = ?1 "
+            "WHERE url_template = ?2 "
+            "  AND pixel_ratio  = ?3 "
+            "  AND x            = ?4 "
+            "  AND y            = ?5 "
+            "  AND z            = ?6 "
+            "  AND accessed     < ?1 ");
         // clang-format on
-        stmt2->bind(1, accessed);
-        stmt2->run();
-        uint64_t changes2 = stmt2->changes();
 
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
-
-        if (changes1 == 0 && changes2 == 0) {
-            return false;
-        }
+        const Resource::TileData& tile = access.first;
+        stmt->bind(1, access.second);
+        stmt->bind(2, tile.urlTemplate);
+        stmt->bind(3, tile.pixelRatio);
+        stmt->bind(4, tile.x);
+        stmt->bind(5, tile.y);
+        stmt->bind(6, tile.z);
+        stmt->run();
     }
 
-    return true;
+    transaction.commit();
 }
 
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
@@ -893,4 +1638,176 @@ uint64_t OfflineDatabase::getOfflineMapboxTileCount() {
     return *offlineMapboxTileCount;
 }
 
+void OfflineDatabase::setWriteBatching(Duration flushInterval_, std::size_t flushSize_) {
+    flush();
+    flushInterval = flushInterval_;
+    flushSize = std::max<std::size_t>(flushSize_, 1);
+}
+
+void OfflineDatabase::setBatchObserver(BatchObserver observer) {
+    batchObserver = std::move(observer);
+}
+
+bool OfflineDatabase::hasPendingWrites() const {
+    return bool(batch);
+}
+
+void OfflineDatabase::beginWrite() {
+    if (flushSize > 1 && !batch) {
+        batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+        batchWrites = 0;
+        batchStart = Clock::now();
+    }
+}
+
+void OfflineDatabase::endWrite() {
+    if (batch && (++batchWrites >= flushSize || Clock::now() - batchStart >= flushInterval)) {
+        flush();
+    }
+}
+
+void OfflineDatabase::flush() {
+    flushAccesses();
+
+    if (!batch) {
+        return;
+    }
+
+    auto transaction = std::move(batch);
+    const std::size_t writes = batchWrites;
+    batchWrites = 0;
+
+    const TimePoint start = Clock::now();
+    transaction->commit();
+    const Duration latency = Clock::now() - start;
+
+    Log::Debug(Event::Database, "Committed %zu batched writes in %lldms", writes,
+               static_cast<long long>(std::chrono::duration_cast<Milliseconds>(latency).count()));
+
+    if (batchObserver) {
+        batchObserver(writes, latency);
+    }
+}
+
+void OfflineDatabase::setTileDeduplication(bool deduplicate) {
+    deduplicateTiles = deduplicate;
+}
+
+void OfflineDatabase::setCompression(util::Codec codec_) {
+    if (util::isCodecAvailable(codec_)) {
+        codec = codec_;
+    } else {
+        Log::Warning(Event::Database, "Compression codec %d isn't available", int(codec_));
+    }
+}
+
+std::pair<int64_t, std::string> OfflineDatabase::compressEntry(const Resource& resource, const std::string& data) {
+    if (codec == util::Codec::None) {
+        return { 0, {} };
+    }
+
+    int64_t dictionaryID = 0;
+    if (codec == util::Codec::Zstd && resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        dictionaryID = tileDictionaryID(resource.tileData->urlTemplate, data);
+        if (dictionaryID) {
+            getDictionary(dictionaryID);
+        }
+    }
+
+    return compressEntry(data, dictionaryID);
+}
+
+std::pair<int64_t, std::string> OfflineDatabase::compressEntry(const std::string& data, int64_t dictionaryID) const {
+    if (codec == util::Codec::None) {
+        return { 0, {} };
+    }
+
+    std::string compressed = util::compress(data, codec, dictionaryID ? dictionaries.at(dictionaryID) : std::string());
+    if (compressed.size() >= data.size()) {
+        return { 0, {} };
+    }
+
+    return { int64_t(codec) | (dictionaryID << 8), std::move(compressed) };
+}
+
+std::string OfflineDatabase::decompressEntry(const std::string& data, int64_t compression) {
+    const int64_t dictionaryID = compression >> 8;
+    return util::decompress(data, util::Codec(compression & 0xFF),
+                            dictionaryID ? getDictionary(dictionaryID) : std::string());
+}
+
+int64_t OfflineDatabase::tileDictionaryID(const std::string& urlTemplate, const std::string& sample) {
+    DictionaryTraining& training = dictionaryTraining[urlTemplate];
+
+    if (!training.loaded) {
+        training.loaded = true;
+
+        // clang-format off
+        Statement stmt = getStatement(
+            "SELECT id FROM dictionaries WHERE url_template = ?1 AND codec = ?2");
+        // clang-format on
+
+        stmt->bind(1, urlTemplate);
+        stmt->bind(2, int64_t(codec));
+        if (stmt->run()) {
+            training.id = stmt->get<int64_t>(0);
+            training.done = true;
+        }
+    }
+
+    if (training.done) {
+        return training.id;
+    }
+
+    training.samples.push_back(sample);
+    training.sampleSize += sample.size();
+    if (training.samples.size() < dictionarySampleCount && training.sampleSize < dictionarySampleSize) {
+        return 0;
+    }
+
+    // Only ever try once per template; tiles that can't be trained on are compressed without
+    // a dictionary.
+    training.done = true;
+    optional<std::string> dictionary = util::trainDictionary(codec, training.samples, dictionarySize);
+    training.samples = {};
+
+    if (!dictionary) {
+        Log::Debug(Event::Database, "Unable to train a dictionary for %s", urlTemplate.c_str());
+        return 0;
+    }
+
+    // clang-format off
+    Statement insert = getStatement(
+        "INSERT INTO dictionaries (url_template, codec, data) VALUES (?1, ?2, ?3)");
+    // clang-format on
+
+    insert->bind(1, urlTemplate);
+    insert->bind(2, int64_t(codec));
+    insert->bindBlob(3, dictionary->data(), dictionary->size(), false);
+    insert->run();
+
+    training.id = insert->lastInsertRowId();
+    dictionaries.emplace(training.id, std::move(*dictionary));
+    return training.id;
+}
+
+const std::string& OfflineDatabase::getDictionary(int64_t id) {
+    auto it = dictionaries.find(id);
+    if (it != dictionaries.end()) {
+        return it->second;
+    }
+
+    // clang-format off
+    Statement stmt = getStatement("SELECT data FROM dictionaries WHERE id = ?1");
+    // clang-format on
+
+    stmt->bind(1, id);
+    if (!stmt->run()) {
+        throw std::runtime_error("missing compression dictionary");
+    }
+
+    return dictionaries.emplace(id, stmt->get<std::string>(0)).first->second;
+}
+
 } // namespace mbgl
@@ -6,8 +6,12 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/compression.hpp>
 
+#include <functional>
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <string>
 
@@ -15,12 +19,14 @@ namespace mapbox {
 namespace sqlite {
 class Database;
 class Statement;
+class Transaction;
 } // namespace sqlite
 } // namespace mapbox
 
 namespace mbgl {
 
 class Response;
+class Scheduler;
 class TileID;
 
 class OfflineDatabase : private util::noncopyable {
@@ -28,10 +34,25 @@ public:
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
     OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+
+    // Opens an existing database for cache reads only, alongside the instance that owns it
+    // and performs all writes. Reads through such a connection don't record access times;
+    // report cache hits to the owning instance with `recordAccess()` instead.
+    struct ReadOnly {};
+    OfflineDatabase(std::string path, ReadOnly);
+
     ~OfflineDatabase();
 
     optional<Response> get(const Resource&);
 
+    // Reads don't update access times right away, but record them to be written in batches;
+    // writing them on every read would turn each cache hit into a write.
+    void recordAccess(const Resource&);
+
+    // Switches the database to write-ahead logging, so that read-only connections to it no
+    // longer wait for writes to complete. The setting persists in the database file.
+    void enableConcurrentReads();
+
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
@@ -49,14 +70,85 @@ public:
     optional<int64_t> hasRegionResource(int64_t regionID, const Resource&);
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
 
+    // Stores resources for a region like `putRegionResource()`, but all in one transaction,
+    // compressing them in parallel on the threads of `scheduler`. Nothing is stored if the
+    // resources would exceed the Mapbox tile count limit. Returns the total stored size.
+    uint64_t putRegionResources(int64_t regionID, const std::vector<std::pair<Resource, Response>>&, Scheduler&);
+
     OfflineRegionDefinition getRegionDefinition(int64_t regionID);
     OfflineRegionStatus getRegionCompletedStatus(int64_t regionID);
 
+    // The time a region's tiles of a tile URL template were last synced against their tileset's
+    // manifest, if ever. See OfflineDownload::refresh().
+    optional<Timestamp> getRegionSyncTime(int64_t regionID, const std::string& urlTemplate);
+    void setRegionSyncTime(int64_t regionID, const std::string& urlTemplate, Timestamp);
+
+    // Sets the expiration time of all of a region's tiles of a tile URL template at once, as if
+    // each had been revalidated with a 304 Not Modified response. Returns the number of tiles.
+    uint64_t revalidateRegionTiles(int64_t regionID, const std::string& urlTemplate, optional<Timestamp> expires);
+
+    // Writes the region's definition and metadata, and all of its resources and tiles, to a
+    // region archive at `path`, which is written and read sequentially. A region archive is a
+    // little-endian file consisting of
+    //   - an 8 byte magic `MBGLREGN` and a uint32 version (1),
+    //   - the encoded region definition and the region metadata, as strings,
+    //   - an entry per resource or tile, starting with a uint8 type: 1 for a resource, followed
+    //     by its uint8 kind and URL; 2 for a tile, followed by its URL template, uint8 pixel
+    //     ratio, int8 z and int32 x and y. Either is followed by the int64 expiration and
+    //     modification times in seconds since the epoch, or INT64_MIN if there are none, the
+    //     ETag as an optional string, a uint8 codec, and the data as a string. The codec is
+    //     util::Codec::None or Zlib, or 255 for resources without content.
+    //   - a uint8 0 and the uint64 number of entries, which tells complete archives apart.
+    // Strings are prefixed with their uint32 length, optional strings with 0xFFFFFFFF if absent.
+    void exportRegion(int64_t regionID, const std::string& path);
+
+    // Creates a region from a region archive, storing its resources and tiles as if they were
+    // downloaded, in a single transaction. Nothing is imported if the archive is invalid or
+    // incomplete, or if its tiles would exceed the Mapbox tile count limit.
+    OfflineRegion importRegion(const std::string& path);
+
     void setOfflineMapboxTileCountLimit(uint64_t);
     uint64_t getOfflineMapboxTileCountLimit();
     bool offlineMapboxTileCountLimitExceeded();
     uint64_t getOfflineMapboxTileCount();
 
+    // By default, every put is committed in a transaction of its own. With batching enabled,
+    // puts are grouped into a single transaction that is committed once it holds `flushSize`
+    // writes or has been open for `flushInterval`, whichever comes first. The interval is only
+    // checked when writing; owners that need a bound on latency should also call `flush()`
+    // periodically. Pending writes are visible to this connection, but not to others until
+    // they are flushed. A `flushSize` of 1 disables batching.
+    void setWriteBatching(Duration flushInterval, std::size_t flushSize);
+
+    // Commits pending batched writes and access times, if any.
+    void flush();
+    bool hasPendingWrites() const;
+
+    // Invoked after each batch commit with the number of writes it held and the time taken
+    // to commit it.
+    using BatchObserver = std::function<void (std::size_t writes, Duration latency)>;
+    void setBatchObserver(BatchObserver);
+
+    // Ambient cache eviction. Writes only evict on their own to stay within the maximum cache
+    // size. Once the database has grown past the high watermark, `evictIncrementally()` removes
+    // least-recently used ambient resources in bounded chunks until it's back below the low
+    // watermark; owners call it between other work, for as long as it returns true. Watermarks
+    // are fractions of the maximum cache size, 0.9 and 0.8 by default.
+    void setEvictionWatermarks(double high, double low);
+    bool evictIncrementally();
+    bool isEvictionPending() const;
+
+    // Codec for entries written from now on; entries already stored stay readable whatever
+    // the setting. Zlib by default. With zstd, tiles are compressed with a dictionary trained
+    // on the first tiles stored for their URL template. Codecs unavailable in this build are
+    // ignored.
+    void setCompression(util::Codec);
+
+    // With tile deduplication enabled, tiles written from now on that are byte-identical as
+    // stored, like the ocean and empty land tiles of a source, share a single copy of their
+    // data. Disabled by default; tiles already stored stay readable whatever the setting.
+    void setTileDeduplication(bool);
+
 private:
     void connect(int flags);
     int userVersion();
@@ -64,6 +156,10 @@ private:
     void removeExisting();
     void migrateToVersion3();
     void migrateToVersion5();
+    void migrateToVersion6();
+    void migrateToVersion7();
+    void migrateToVersion8();
+    void migrateToVersion9();
 
     class Statement {
     public:
@@ -80,19 +176,45 @@ private:
 
     Statement getStatement(const char *);
 
+    // Scope of a single write. Outside of a batch, this is an immediate-mode transaction of
+    // its own; within a batch it's a savepoint, so that a failing write is undone without
+    // discarding the writes batched before it.
+    class WriteTransaction {
+    public:
+        explicit WriteTransaction(OfflineDatabase&);
+        WriteTransaction(const WriteTransaction&) = delete;
+        ~WriteTransaction();
+
+        void commit();
+
+    private:
+        OfflineDatabase& database;
+        std::unique_ptr<::mapbox::sqlite::Transaction> transaction;
+        bool pending = true;
+    };
+
+    void beginWrite();
+    void endWrite();
+
     optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, int64_t compression);
+    // Returns the id of the tile blob holding the data, stored as compressed, adding it if
+    // there is none yet.
+    int64_t putTileBlob(const std::string&, int64_t compression);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const std::string&, int64_t compression);
 
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
     optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
+    // Takes the entry as returned by `compressEntry()`.
+    std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict,
+                                          const std::pair<int64_t, std::string>& compressed);
 
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
@@ -101,6 +223,7 @@ private:
     std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
     const std::string path;
+    const bool readOnly = false;
     std::unique_ptr<::mapbox::sqlite::Database> db;
     std::unordered_map<const char *, std::unique_ptr<::mapbox::sqlite::Statement>> statements;
 
@@ -112,7 +235,59 @@ private:
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
     optional<uint64_t> offlineMapboxTileCount;
 
+    uint64_t usedSize();
     bool evict(uint64_t neededFreeSize);
+    bool evictChunk();
+
+    double highWatermark = 0.9;
+    double lowWatermark = 0.8;
+    bool evictionPending = false;
+    static constexpr int evictionChunkSize = 50;
+
+    void flushAccesses();
+
+    static constexpr std::size_t accessFlushSize = 64;
+    std::vector<std::pair<std::string, Timestamp>> resourceAccesses;
+    std::vector<std::pair<Resource::TileData, Timestamp>> tileAccesses;
+
+    Duration flushInterval = Duration::zero();
+    std::size_t flushSize = 1;
+    BatchObserver batchObserver;
+
+    std::unique_ptr<::mapbox::sqlite::Transaction> batch;
+    std::size_t batchWrites = 0;
+    TimePoint batchStart;
+
+    // The value of an entry's `compressed` column holds the codec in its low 8 bits and the
+    // id of the dictionary used, if any, in the bits above. Returns 0 and no data if
+    // compression doesn't make the entry any smaller.
+    std::pair<int64_t, std::string> compressEntry(const Resource&, const std::string& data);
+    // Compresses with the given dictionary, which must have been loaded with
+    // `getDictionary()`. Doesn't touch the database, so it's safe to call from other threads.
+    std::pair<int64_t, std::string> compressEntry(const std::string& data, int64_t dictionaryID) const;
+    std::string decompressEntry(const std::string& data, int64_t compression);
+
+    // Returns 0 while samples for the template are still being collected, or if training
+    // failed.
+    int64_t tileDictionaryID(const std::string& urlTemplate, const std::string& sample);
+    const std::string& getDictionary(int64_t id);
+
+    struct DictionaryTraining {
+        bool loaded = false;
+        int64_t id = 0;
+        bool done = false;
+        std::vector<std::string> samples;
+        std::size_t sampleSize = 0;
+    };
+
+    static constexpr std::size_t dictionarySampleCount = 256;
+    static constexpr std::size_t dictionarySampleSize = 1024 * 1024;
+    static constexpr std::size_t dictionarySize = 32 * 1024;
+
+    util::Codec codec = util::Codec::Zlib;
+    bool deduplicateTiles = false;
+    std::unordered_map<std::string, DictionaryTraining> dictionaryTraining;
+    std::unordered_map<int64_t, std::string> dictionaries;
 };
 
 } // namespace mbgl
@@ -12,17 +12,51 @@
 #include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion/tileset.hpp>
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/rapidjson.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
+#include <mbgl/util/url.hpp>
 
+#include <algorithm>
 #include <set>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+std::string requestHost(const Resource& resource) {
+    const util::URL url(resource.url);
+    return resource.url.substr(url.domain.first, url.domain.second);
+}
+
+// A conditional request for a resource stored in the database.
+Resource revalidation(Resource resource, const Response& stored) {
+    resource.priorModified = stored.modified;
+    resource.priorExpires = stored.expires;
+    resource.priorEtag = stored.etag;
+    return resource;
+}
+
+std::string styleURL(const OfflineRegionDefinition& definition) {
+    return definition.match([](const auto& region) { return region.styleURL; });
+}
+
+float pixelRatio(const OfflineRegionDefinition& definition) {
+    return definition.match([](const auto& region) { return region.pixelRatio; });
+}
+
+uint64_t tileCount(const OfflineRegionDefinition& definition, SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) {
+    return definition.match([&](const auto& region) { return region.tileCount(type, tileSize, zoomRange); });
+}
+
+} // namespace
+
 OfflineDownload::OfflineDownload(int64_t id_,
                                  OfflineRegionDefinition&& definition_,
                                  OfflineDatabase& offlineDatabase_,
@@ -30,7 +64,9 @@ OfflineDownload::OfflineDownload(int64_t id_,
     : id(id_),
       definition(definition_),
       offlineDatabase(offlineDatabase_),
-      onlineFileSource(onlineFileSource_) {
+      onlineFileSource(onlineFileSource_),
+      maximumConcurrentRequests(HTTPFileSource::maximumConcurrentRequests()),
+      maximumConcurrentRequestsPerHost(HTTPFileSource::maximumConcurrentRequests()) {
     setObserver(nullptr);
 }
 
@@ -40,6 +76,15 @@ void OfflineDownload::setObserver(std::unique_ptr<OfflineRegionObserver> observe
     observer = observer_ ? std::move(observer_) : std::make_unique<OfflineRegionObserver>();
 }
 
+void OfflineDownload::setMaximumConcurrentRequests(uint32_t total, uint32_t perHost) {
+    maximumConcurrentRequests = std::max<uint32_t>(total, 1);
+    maximumConcurrentRequestsPerHost = std::max<uint32_t>(perHost, 1);
+
+    if (status.downloadState == OfflineRegionDownloadState::Active) {
+        continueDownload();
+    }
+}
+
 void OfflineDownload::setState(OfflineRegionDownloadState state) {
     if (status.downloadState == state) {
         return;
@@ -56,6 +101,17 @@ void OfflineDownload::setState(OfflineRegionDownloadState state) {
     observer->statusChanged(status);
 }
 
+void OfflineDownload::refresh() {
+    if (status.downloadState == OfflineRegionDownloadState::Active) {
+        deactivateDownload();
+    }
+
+    refreshing = true;
+    activateDownload();
+
+    observer->statusChanged(status);
+}
+
 OfflineRegionStatus OfflineDownload::getStatus() const {
     if (status.downloadState == OfflineRegionDownloadState::Active) {
         return status;
@@ -64,7 +120,7 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
     OfflineRegionStatus result = offlineDatabase.getRegionCompletedStatus(id);
 
     result.requiredResourceCount++;
-    optional<Response> styleResponse = offlineDatabase.get(Resource::style(definition.styleURL));
+    optional<Response> styleResponse = offlineDatabase.get(Resource::style(styleURL(definition)));
     if (!styleResponse) {
         return result;
     }
@@ -80,7 +136,7 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
         auto handleTiledSource = [&] (const variant<std::string, Tileset>& urlOrTileset, const uint16_t tileSize) {
             if (urlOrTileset.is<Tileset>()) {
                 result.requiredResourceCount +=
-                    definition.tileCover(type, tileSize, urlOrTileset.get<Tileset>().zoomRange).size();
+                    tileCount(definition, type, tileSize, urlOrTileset.get<Tileset>().zoomRange);
             } else {
                 result.requiredResourceCount += 1;
                 const auto& url = urlOrTileset.get<std::string>();
@@ -90,7 +146,7 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
                     optional<Tileset> tileset = style::conversion::convertJSON<Tileset>(*sourceResponse->data, error);
                     if (tileset) {
                         result.requiredResourceCount +=
-                            definition.tileCover(type, tileSize, (*tileset).zoomRange).size();
+                            tileCount(definition, type, tileSize, (*tileset).zoomRange);
                     }
                 } else {
                     result.requiredResourceCountIsPrecise = false;
@@ -105,7 +161,8 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
             break;
         }
 
-        case SourceType::Raster: {
+        case SourceType::Raster:
+        case SourceType::RasterDEM: {
             const auto& rasterSource = *source->as<RasterSource>();
             handleTiledSource(rasterSource.getURLOrTileset(), rasterSource.getTileSize());
             break;
@@ -129,6 +186,7 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 
         case SourceType::Video:
         case SourceType::Annotations:
+        case SourceType::CustomGeometry:
             break;
         }
     }
@@ -148,7 +206,10 @@ void OfflineDownload::activateDownload() {
     status = OfflineRegionStatus();
     status.downloadState = OfflineRegionDownloadState::Active;
     status.requiredResourceCount++;
-    ensureResource(Resource::style(definition.styleURL), [&](Response styleResponse) {
+    activationTime = Clock::now();
+    fetchedTileCount = 0;
+    fetchedSize = 0;
+    ensureResource(Resource::style(styleURL(definition)), [&](Response styleResponse) {
         status.requiredResourceCountIsPrecise = true;
 
         style::Parser parser;
@@ -158,7 +219,9 @@ void OfflineDownload::activateDownload() {
             SourceType type = source->getType();
 
             auto handleTiledSource = [&] (const variant<std::string, Tileset>& urlOrTileset, const uint16_t tileSize) {
-                if (urlOrTileset.is<Tileset>()) {
+                if (urlOrTileset.is<Tileset>() && refreshing) {
+                    refreshTiles(type, tileSize, urlOrTileset.get<Tileset>());
+                } else if (urlOrTileset.is<Tileset>()) {
                     queueTiles(type, tileSize, urlOrTileset.get<Tileset>());
                 } else {
                     const auto& url = urlOrTileset.get<std::string>();
@@ -171,7 +234,11 @@ void OfflineDownload::activateDownload() {
                         optional<Tileset> tileset = style::conversion::convertJSON<Tileset>(*sourceResponse.data, error);
                         if (tileset) {
                             util::mapbox::canonicalizeTileset(*tileset, url, type, tileSize);
-                            queueTiles(type, tileSize, *tileset);
+                            if (refreshing) {
+                                refreshTiles(type, tileSize, *tileset);
+                            } else {
+                                queueTiles(type, tileSize, *tileset);
+                            }
 
                             requiredSourceURLs.erase(url);
                             if (requiredSourceURLs.empty()) {
@@ -189,7 +256,8 @@ void OfflineDownload::activateDownload() {
                 break;
             }
 
-            case SourceType::Raster: {
+            case SourceType::Raster:
+            case SourceType::RasterDEM: {
                 const auto& rasterSource = *source->as<RasterSource>();
                 handleTiledSource(rasterSource.getURLOrTileset(), rasterSource.getTileSize());
                 break;
@@ -214,6 +282,7 @@ void OfflineDownload::activateDownload() {
 
             case SourceType::Video:
             case SourceType::Annotations:
+            case SourceType::CustomGeometry:
                 break;
             }
         }
@@ -227,8 +296,8 @@ void OfflineDownload::activateDownload() {
         }
 
         if (!parser.spriteURL.empty()) {
-            queueResource(Resource::spriteImage(parser.spriteURL, definition.pixelRatio));
-            queueResource(Resource::spriteJSON(parser.spriteURL, definition.pixelRatio));
+            queueResource(Resource::spriteImage(parser.spriteURL, pixelRatio(definition)));
+            queueResource(Resource::spriteJSON(parser.spriteURL, pixelRatio(definition)));
         }
 
         continueDownload();
@@ -251,23 +320,109 @@ void OfflineDownload::activateDownload() {
    of the same type. For instance if a server is unreachable, all the requests to that
    host are going to error. In that case, continuing to try subsequent resources after
    the first few errors is fruitless anyway.
+
+   Queued resources go through two stages: a check against the database, which runs ahead
+   in batches, and a network request for those that are missing, subject to the download's
+   total and per-host request limits. A resource whose host is at its limit is skipped over
+   in favor of resources from other hosts.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty() && status.complete()) {
+    if (resourcesRemaining.empty() && tilesRemaining.empty() && resourcesToFetch.empty() &&
+        pendingManifests == 0 && status.complete()) {
+        for (const auto& sync : pendingSyncs) {
+            offlineDatabase.setRegionSyncTime(id, sync.first, sync.second);
+        }
         setState(OfflineRegionDownloadState::Inactive);
         return;
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < HTTPFileSource::maximumConcurrentRequests()) {
-        ensureResource(resourcesRemaining.front());
-        resourcesRemaining.pop_front();
+    auto it = resourcesToFetch.begin();
+    while (it != resourcesToFetch.end() && requests.size() < maximumConcurrentRequests) {
+        if (requestsPerHost[requestHost(*it)] >= maximumConcurrentRequestsPerHost) {
+            ++it;
+            continue;
+        }
+
+        Resource resource = std::move(*it);
+        it = resourcesToFetch.erase(it);
+
+        if (checkTileCountLimit(resource)) {
+            return;
+        }
+
+        requestResource(resource, {});
+    }
+
+    // Keep up to two rounds of requests' worth of resources checked ahead.
+    if (!checkRequest && (!resourcesRemaining.empty() || !tilesRemaining.empty()) &&
+        resourcesToFetch.size() < 2 * maximumConcurrentRequests) {
+        checkRequest = util::RunLoop::Get()->invokeCancellable([this] {
+            checkResources();
+        });
+    }
+}
+
+void OfflineDownload::checkResources() {
+    checkRequest.reset();
+
+    bool changed = false;
+    while ((!resourcesRemaining.empty() || !tilesRemaining.empty()) &&
+           resourcesToFetch.size() < 2 * maximumConcurrentRequests) {
+        bool listedAsChanged = false;
+        Resource resource = takeRemainingResource(listedAsChanged);
+
+        if (listedAsChanged) {
+            resourcesToFetch.push_back(std::move(resource));
+            continue;
+        }
+
+        // When refreshing, stored resources are revalidated once stale, except for tiles
+        // their manifest already revalidated.
+        if (refreshing && !(resource.tileData && manifestURLTemplates.count(resource.tileData->urlTemplate))) {
+            optional<std::pair<Response, uint64_t>> stored = offlineDatabase.getRegionResource(id, resource);
+            if (stored && stored->first.isFresh()) {
+                addCompleted(resource, stored->second);
+                changed = true;
+            } else if (stored) {
+                resourcesToFetch.push_back(revalidation(std::move(resource), stored->first));
+            } else {
+                resourcesToFetch.push_back(std::move(resource));
+            }
+            continue;
+        }
+
+        if (optional<int64_t> size = offlineDatabase.hasRegionResource(id, resource)) {
+            addCompleted(resource, *size);
+            changed = true;
+        } else {
+            resourcesToFetch.push_back(std::move(resource));
+        }
+    }
+
+    if (changed) {
+        observer->statusChanged(status);
+    }
+
+    // The observer may have deactivated the download.
+    if (status.downloadState == OfflineRegionDownloadState::Active) {
+        continueDownload();
     }
 }
 
 void OfflineDownload::deactivateDownload() {
     requiredSourceURLs.clear();
     resourcesRemaining.clear();
+    tilesRemaining.clear();
+    resourcesToFetch.clear();
+    checkRequest.reset();
     requests.clear();
+    requestsPerHost.clear();
+    refreshing = false;
+    manifestURLTemplates.clear();
+    pendingSyncs.clear();
+    pendingManifests = 0;
+    status.tilesPerSecond = 0;
+    status.bytesPerSecond = 0;
 }
 
 void OfflineDownload::queueResource(Resource resource) {
@@ -275,20 +430,166 @@ void OfflineDownload::queueResource(Resource resource) {
     resourcesRemaining.push_front(std::move(resource));
 }
 
-void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    for (const auto& tile : definition.tileCover(type, tileSize, tileset.zoomRange)) {
-        status.requiredResourceCount++;
-        resourcesRemaining.push_back(
-            Resource::tile(tileset.tiles[0], definition.pixelRatio, tile.x, tile.y, tile.z, tileset.scheme));
+void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset,
+                                 std::shared_ptr<const std::unordered_set<CanonicalTileID>> changed) {
+    const Range<uint8_t> zooms = definition.match([&](const auto& region) {
+        return region.coveringZoomRange(type, tileSize, tileset.zoomRange);
+    });
+    for (uint8_t z = zooms.min; z <= zooms.max; z++) {
+        const util::TileRange range = definition.match(
+            [&](const OfflineTilePyramidRegionDefinition& region) { return util::TileRange(region.bounds, z); },
+            [&](const OfflineGeometryRegionDefinition& region) { return util::TileRange(region.geometry, z); });
+        if (range.size() == 0) {
+            continue;
+        }
+        status.requiredResourceCount += range.size();
+        tilesRemaining.push_back({ tileset.tiles[0], tileset.scheme, range, 0, changed });
     }
 }
 
+Resource OfflineDownload::takeRemainingResource(bool& changed) {
+    if (!resourcesRemaining.empty()) {
+        Resource resource = std::move(resourcesRemaining.front());
+        resourcesRemaining.pop_front();
+        changed = false;
+        return resource;
+    }
+
+    QueuedTiles& tiles = tilesRemaining.front();
+    const CanonicalTileID tile = tiles.range[tiles.next++];
+    changed = tiles.changed && tiles.changed->count(tile);
+
+    Resource resource =
+        Resource::tile(tiles.urlTemplate, pixelRatio(definition), tile.x, tile.y, tile.z, tiles.scheme);
+    if (tiles.next == tiles.range.size()) {
+        tilesRemaining.pop_front();
+    }
+    return resource;
+}
+
+void OfflineDownload::refreshTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
+    const std::string& urlTemplate = tileset.tiles[0];
+    const Timestamp now = util::now();
+
+    optional<Timestamp> synced;
+    if (tileset.manifest) {
+        synced = offlineDatabase.getRegionSyncTime(id, urlTemplate);
+        // Changes made while the refresh is running will be listed by the next one.
+        pendingSyncs.emplace_back(urlTemplate, now);
+    }
+
+    if (!synced) {
+        queueTiles(type, tileSize, tileset);
+        return;
+    }
+
+    const std::string& manifest = *tileset.manifest;
+    const std::string url = manifest + (manifest.find('?') == std::string::npos ? "?" : "&") +
+        "since=" + util::toString(int64_t(synced->time_since_epoch().count()));
+
+    status.requiredResourceCountIsPrecise = false;
+    requiredSourceURLs.insert(manifest);
+    pendingManifests++;
+    requestManifest(type, tileSize, tileset, url, std::make_shared<std::unordered_set<CanonicalTileID>>());
+}
+
+void OfflineDownload::requestManifest(SourceType type, uint16_t tileSize, const Tileset& tileset,
+                                      const std::string& url,
+                                      std::shared_ptr<std::unordered_set<CanonicalTileID>> changed) {
+    Resource resource = Resource::source(url);
+    resource.priority = Resource::Priority::Low;
+
+    auto manifestRequestsIt = requests.insert(requests.begin(), nullptr);
+    *manifestRequestsIt = onlineFileSource.request(resource, [=](Response response) {
+        if (response.error) {
+            observer->responseError(*response.error);
+            return;
+        }
+
+        requests.erase(manifestRequestsIt);
+
+        JSDocument document;
+        if (response.data) {
+            document.Parse<0>(response.data->c_str());
+        }
+
+        const bool valid = response.data && !document.HasParseError() && document.IsObject() &&
+            document.HasMember("tiles") && document["tiles"].IsArray();
+
+        if (valid) {
+            const JSValue& tiles = document["tiles"];
+            for (rapidjson::SizeType i = 0; i < tiles.Size(); i++) {
+                const JSValue& tile = tiles[i];
+                if (!tile.IsArray() || tile.Size() != 3 || !tile[0].IsUint() || !tile[1].IsUint() || !tile[2].IsUint()) {
+                    continue;
+                }
+                const uint32_t z = tile[0].GetUint();
+                const uint32_t x = tile[1].GetUint();
+                const uint32_t y = tile[2].GetUint();
+                if (z < 32 && x < (1u << z) && y < (1u << z)) {
+                    changed->emplace(uint8_t(z), x, y);
+                }
+            }
+
+            if (document.HasMember("next") && document["next"].IsString()) {
+                requestManifest(type, tileSize, tileset, document["next"].GetString(), changed);
+                return;
+            }
+
+            // Tiles the manifest doesn't list are up to date.
+            if (response.expires) {
+                offlineDatabase.revalidateRegionTiles(id, tileset.tiles[0], response.expires);
+            }
+            manifestURLTemplates.insert(tileset.tiles[0]);
+            queueTiles(type, tileSize, tileset, changed);
+        } else {
+            Log::Warning(Event::General, "Invalid tile manifest %s; revalidating tiles one by one", url.c_str());
+            queueTiles(type, tileSize, tileset);
+        }
+
+        pendingManifests--;
+        requiredSourceURLs.erase(*tileset.manifest);
+        if (requiredSourceURLs.empty()) {
+            status.requiredResourceCountIsPrecise = true;
+        }
+
+        observer->statusChanged(status);
+        continueDownload();
+    });
+}
+
 void OfflineDownload::ensureResource(const Resource& resource,
                                      std::function<void(Response)> callback) {
     auto workRequestsIt = requests.insert(requests.begin(), nullptr);
     *workRequestsIt = util::RunLoop::Get()->invokeCancellable([=]() {
         requests.erase(workRequestsIt);
 
+        // When refreshing, a stored resource is used while it's fresh, and revalidated
+        // otherwise.
+        if (refreshing) {
+            optional<std::pair<Response, uint64_t>> stored = offlineDatabase.getRegionResource(id, resource);
+            if (stored && stored->first.isFresh()) {
+                if (callback) {
+                    callback(stored->first);
+                }
+                addCompleted(resource, stored->second);
+
+                observer->statusChanged(status);
+                continueDownload();
+                return;
+            }
+
+            if (stored) {
+                const Response storedResponse = stored->first;
+                requestResource(revalidation(resource, storedResponse), [=](Response response) {
+                    if (callback) {
+                        callback(response.notModified ? storedResponse : response);
+                    }
+                });
+                return;
+            }
+        }
+
         auto getResourceSizeInDatabase = [&] () -> optional<int64_t> {
             if (!callback) {
                 return offlineDatabase.hasRegionResource(id, resource);
@@ -303,12 +604,7 @@ void OfflineDownload::ensureResource(const Resource& resource,
 
         optional<int64_t> offlineResponse = getResourceSizeInDatabase();
         if (offlineResponse) {
-            status.completedResourceCount++;
-            status.completedResourceSize += *offlineResponse;
-            if (resource.kind == Resource::Kind::Tile) {
-                status.completedTileCount += 1;
-                status.completedTileSize += *offlineResponse;
-            }
+            addCompleted(resource, *offlineResponse);
 
             observer->statusChanged(status);
             continueDownload();
@@ -319,38 +615,72 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return;
         }
 
-        auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
-            if (onlineResponse.error) {
-                observer->responseError(*onlineResponse.error);
-                return;
-            }
+        requestResource(resource, callback);
+    });
+}
 
-            requests.erase(fileRequestsIt);
+void OfflineDownload::requestResource(const Resource& resource,
+                                      std::function<void(Response)> callback) {
+    const std::string host = requestHost(resource);
+    requestsPerHost[host]++;
 
-            if (callback) {
-                callback(onlineResponse);
-            }
+    // Maps using the same file source go first.
+    Resource lowPriority = resource;
+    lowPriority.priority = Resource::Priority::Low;
+
+    auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
+    *fileRequestsIt = onlineFileSource.request(lowPriority, [=](Response onlineResponse) {
+        if (onlineResponse.error) {
+            observer->responseError(*onlineResponse.error);
+            return;
+        }
+
+        requests.erase(fileRequestsIt);
+        if (--requestsPerHost[host] == 0) {
+            requestsPerHost.erase(host);
+        }
 
-            status.completedResourceCount++;
-            uint64_t resourceSize = offlineDatabase.putRegionResource(id, resource, onlineResponse);
-            status.completedResourceSize += resourceSize;
+        if (callback) {
+            callback(onlineResponse);
+        }
+
+        uint64_t resourceSize = offlineDatabase.putRegionResource(id, resource, onlineResponse);
+        if (onlineResponse.notModified) {
+            // Revalidated; the stored copy is complete.
+            resourceSize = offlineDatabase.hasRegionResource(id, resource).value_or(0);
+        } else {
+            fetchedSize += resourceSize;
             if (resource.kind == Resource::Kind::Tile) {
-                status.completedTileCount += 1;
-                status.completedTileSize += resourceSize;
+                fetchedTileCount++;
             }
+        }
+        addCompleted(resource, resourceSize);
 
-            observer->statusChanged(status);
+        const double elapsed = std::chrono::duration<double>(Clock::now() - activationTime).count();
+        if (elapsed > 0) {
+            status.tilesPerSecond = fetchedTileCount / elapsed;
+            status.bytesPerSecond = fetchedSize / elapsed;
+        }
 
-            if (checkTileCountLimit(resource)) {
-                return;
-            }
+        observer->statusChanged(status);
 
-            continueDownload();
-        });
+        if (checkTileCountLimit(resource)) {
+            return;
+        }
+
+        continueDownload();
     });
 }
 
+void OfflineDownload::addCompleted(const Resource& resource, uint64_t size) {
+    status.completedResourceCount++;
+    status.completedResourceSize += size;
+    if (resource.kind == Resource::Kind::Tile) {
+        status.completedTileCount += 1;
+        status.completedTileSize += size;
+    }
+}
+
 bool OfflineDownload::checkTileCountLimit(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile && util::mapbox::isMapboxURL(resource.url) &&
         offlineDatabase.offlineMapboxTileCountLimitExceeded()) {
@@ -2,11 +2,18 @@
 
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/tileset.hpp>
 
 #include <list>
+#include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <deque>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -14,7 +21,6 @@ class OfflineDatabase;
 class FileSource;
 class AsyncRequest;
 class Response;
-class Tileset;
 
 namespace style {
 class Parser;
@@ -35,18 +41,51 @@ public:
 
     OfflineRegionStatus getStatus() const;
 
+    /*
+     * Activate the download in refresh mode, which also brings resources that are already
+     * in the database up to date. Stale resources are revalidated with a conditional
+     * request each, except for the tiles of tilesets that have a `manifest`: for those, the
+     * manifest is asked which tiles changed since the region was last synced, and only
+     * the changed tiles are downloaded again. The others are revalidated in bulk, expiring
+     * when the manifest response does.
+     *
+     * A manifest is requested as `<manifest>?since=<seconds since the epoch>` and responds
+     * with JSON of the form `{ "tiles": [[z, x, y], ...], "next": "<url>" }`, listing
+     * changed tiles in XYZ coordinates. Long lists may be split into pages, with `next`, if
+     * present, giving the URL of the following page. A region is synced once a refresh
+     * completes; until then, tilesets with a manifest are revalidated tile by tile.
+     */
+    void refresh();
+
+    /*
+     * Limit the number of network requests this download keeps in flight, in total and
+     * to any single host. Both default to `HTTPFileSource::maximumConcurrentRequests()`.
+     */
+    void setMaximumConcurrentRequests(uint32_t total, uint32_t perHost);
+
 private:
     void activateDownload();
     void continueDownload();
     void deactivateDownload();
 
+    /*
+     * Move queued resources that are already in the database to the completed counts, and
+     * the rest to `resourcesToFetch`. Runs ahead of the network requests, so that request
+     * slots are only spent on resources that are actually missing.
+     */
+    void checkResources();
+
     /*
      * Ensure that the resource is stored in the database, requesting it if necessary.
      * While the request is in progress, it is recorded in `requests`. If the download
      * is deactivated, all in progress requests are cancelled.
      */
     void ensureResource(const Resource&, std::function<void (Response)> = {});
+    void requestResource(const Resource&, std::function<void (Response)>);
+    void requestManifest(SourceType, uint16_t tileSize, const Tileset&, const std::string& url,
+                         std::shared_ptr<std::unordered_set<CanonicalTileID>> changed);
     bool checkTileCountLimit(const Resource& resource);
+    void addCompleted(const Resource&, uint64_t size);
 
     int64_t id;
     OfflineRegionDefinition definition;
@@ -59,8 +98,43 @@ private:
     std::unordered_set<std::string> requiredSourceURLs;
     std::deque<Resource> resourcesRemaining;
 
+    // The tiles of a tileset at one zoom level, turned into resources as they're checked, so
+    // that large regions don't queue millions of them up front.
+    struct QueuedTiles {
+        std::string urlTemplate;
+        Tileset::Scheme scheme;
+        util::TileRange range;
+        uint64_t next;
+        // Tiles their manifest listed as changed, to be downloaded without checking the
+        // database first.
+        std::shared_ptr<const std::unordered_set<CanonicalTileID>> changed;
+    };
+    std::deque<QueuedTiles> tilesRemaining;
+    std::deque<Resource> resourcesToFetch;
+    std::unique_ptr<AsyncRequest> checkRequest;
+
+    uint32_t maximumConcurrentRequests;
+    uint32_t maximumConcurrentRequestsPerHost;
+    std::unordered_map<std::string, uint32_t> requestsPerHost;
+
+    // Network transfers since the download was last activated, for throughput figures.
+    TimePoint activationTime;
+    uint64_t fetchedTileCount = 0;
+    uint64_t fetchedSize = 0;
+
+    bool refreshing = false;
+    // Tile URL templates whose tiles were revalidated by their manifest.
+    std::unordered_set<std::string> manifestURLTemplates;
+    // Sync times to record for tile URL templates once the refresh completes.
+    std::vector<std::pair<std::string, Timestamp>> pendingSyncs;
+    uint32_t pendingManifests = 0;
+
     void queueResource(Resource);
-    void queueTiles(SourceType, uint16_t tileSize, const Tileset&);
+    void queueTiles(SourceType, uint16_t tileSize, const Tileset&,
+                    std::shared_ptr<const std::unordered_set<CanonicalTileID>> changed = {});
+    // Removes the next resource from resourcesRemaining, or else tilesRemaining.
+    Resource takeRemainingResource(bool& changed);
+    void refreshTiles(SourceType, uint16_t tileSize, const Tileset&);
 };
 
 } // namespace mbgl
@@ -6,11 +6,20 @@ CREATE TABLE resources (                   -- Generic table for style, source, s
   modified INTEGER,
   etag TEXT,
   data BLOB,
-  compressed INTEGER NOT NULL DEFAULT 0,
+  compressed INTEGER NOT NULL DEFAULT 0,    -- 0 if uncompressed; else the codec in the low 8 bits and the dictionary id in the rest.
   accessed INTEGER NOT NULL,
+  region_count INTEGER NOT NULL DEFAULT 0,  -- The number of regions that require the resource; only those of none are evicted.
   UNIQUE (url)
 );
 
+CREATE TABLE tile_blobs (                -- Data shared by byte-identical tiles, if tiles are deduplicated.
+  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+  hash INTEGER NOT NULL,                    -- FNV-1a hash of the data as stored.
+  data BLOB NOT NULL,
+  compressed INTEGER NOT NULL DEFAULT 0,    -- As for resources.
+  tile_count INTEGER NOT NULL DEFAULT 0     -- The number of tiles sharing the data; blobs go with their last tile.
+);
+
 CREATE TABLE tiles (
   id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
   url_template TEXT NOT NULL,
@@ -22,11 +31,21 @@ CREATE TABLE tiles (
   modified INTEGER,
   etag TEXT,
   data BLOB,
-  compressed INTEGER NOT NULL DEFAULT 0,
+  compressed INTEGER NOT NULL DEFAULT 0,    -- As for resources.
   accessed INTEGER NOT NULL,
+  region_count INTEGER NOT NULL DEFAULT 0,  -- As for resources.
+  blob_id INTEGER REFERENCES tile_blobs(id),  -- If set, the tile's data is in tile_blobs, and data is NULL.
   UNIQUE (url_template, pixel_ratio, z, x, y)
 );
 
+CREATE TABLE dictionaries (                -- Compression dictionaries, trained per tile source.
+  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+  url_template TEXT NOT NULL,
+  codec INTEGER NOT NULL,
+  data BLOB NOT NULL,
+  UNIQUE (url_template, codec)
+);
+
 CREATE TABLE regions (
   id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
   definition TEXT NOT NULL,   -- JSON formatted definition of region. Regions may be of variant types:
@@ -47,16 +66,63 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE region_syncs (                -- Last refresh of a region's tiles against their tileset's manifest.
+  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,
+  url_template TEXT NOT NULL,
+  synced INTEGER NOT NULL,
+  UNIQUE (region_id, url_template)
+);
+
+-- Reference counts of resources and tiles by regions, kept by the region tables themselves
+
+CREATE TRIGGER region_resources_insert AFTER INSERT ON region_resources
+BEGIN UPDATE resources SET region_count = region_count + 1 WHERE id = NEW.resource_id; END;
+
+CREATE TRIGGER region_resources_delete AFTER DELETE ON region_resources
+BEGIN UPDATE resources SET region_count = region_count - 1 WHERE id = OLD.resource_id; END;
+
+CREATE TRIGGER region_tiles_insert AFTER INSERT ON region_tiles
+BEGIN UPDATE tiles SET region_count = region_count + 1 WHERE id = NEW.tile_id; END;
+
+CREATE TRIGGER region_tiles_delete AFTER DELETE ON region_tiles
+BEGIN UPDATE tiles SET region_count = region_count - 1 WHERE id = OLD.tile_id; END;
+
+-- Reference counts of tile blobs by tiles
+
+CREATE TRIGGER tiles_blob_insert AFTER INSERT ON tiles WHEN NEW.blob_id IS NOT NULL
+BEGIN UPDATE tile_blobs SET tile_count = tile_count + 1 WHERE id = NEW.blob_id; END;
+
+CREATE TRIGGER tiles_blob_update AFTER UPDATE OF blob_id ON tiles
+BEGIN
+  UPDATE tile_blobs SET tile_count = tile_count + 1 WHERE id = NEW.blob_id;
+  UPDATE tile_blobs SET tile_count = tile_count - 1 WHERE id = OLD.blob_id;
+  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND tile_count = 0;
+END;
+
+CREATE TRIGGER tiles_blob_delete AFTER DELETE ON tiles WHEN OLD.blob_id IS NOT NULL
+BEGIN
+  UPDATE tile_blobs SET tile_count = tile_count - 1 WHERE id = OLD.blob_id;
+  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND tile_count = 0;
+END;
+
 -- Indexes for efficient eviction queries
 
-CREATE INDEX resources_accessed
-ON resources (accessed);
+CREATE INDEX resources_evictable
+ON resources (region_count, accessed);
 
-CREATE INDEX tiles_accessed
-ON tiles (accessed);
+CREATE INDEX tiles_evictable
+ON tiles (region_count, accessed);
 
 CREATE INDEX region_resources_resource_id
 ON region_resources (resource_id);
 
 CREATE INDEX region_tiles_tile_id
 ON region_tiles (tile_id);
+
+-- Indexes for finding and releasing tile blobs
+
+CREATE INDEX tile_blobs_hash
+ON tile_blobs (hash);
+
+CREATE INDEX tiles_blob_id
+ON tiles (blob_id);
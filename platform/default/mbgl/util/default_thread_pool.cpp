@@ -5,11 +5,19 @@
 
 namespace mbgl {
 
-ThreadPool::ThreadPool(std::size_t count) {
+ThreadPool::ThreadPool(std::size_t count,
+                       optional<platform::ThreadPriority> priority,
+                       platform::ThreadAffinity affinity) {
     threads.reserve(count);
     for (std::size_t i = 0; i < count; ++i) {
-        threads.emplace_back([this, i]() {
+        threads.emplace_back([this, i, priority, affinity]() {
             platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+            if (priority) {
+                platform::setCurrentThreadPriority(*priority);
+            }
+            if (affinity != platform::ThreadAffinity::Any) {
+                platform::setCurrentThreadAffinity(affinity);
+            }
 
             while (true) {
                 std::unique_lock<std::mutex> lock(mutex);
@@ -22,7 +30,7 @@ ThreadPool::ThreadPool(std::size_t count) {
                     return;
                 }
 
-                auto mailbox = queue.front();
+                auto mailbox = queue.top().mailbox;
                 queue.pop();
                 lock.unlock();
 
@@ -46,12 +54,22 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    int32_t priority = 0;
+    if (auto locked = mailbox.lock()) {
+        priority = locked->getPriority();
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        queue.push({ priority, sequence++, std::move(mailbox) });
     }
 
     cv.notify_one();
 }
 
+std::size_t ThreadPool::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
 } // namespace mbgl
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/platform.hpp>
 
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -11,15 +14,34 @@ namespace mbgl {
 
 class ThreadPool : public Scheduler {
 public:
-    ThreadPool(std::size_t count);
+    // The workers run at the given priority, or else at that of the thread creating the pool,
+    // and on the given cores. Workers laying out tiles, for instance, may run at interactive
+    // priority on the performance cores, so that tiles keep up with gestures.
+    ThreadPool(std::size_t count,
+               optional<platform::ThreadPriority> = {},
+               platform::ThreadAffinity = platform::ThreadAffinity::Any);
     ~ThreadPool() override;
 
     void schedule(std::weak_ptr<Mailbox>) override;
+    std::size_t getQueueDepth() const override;
 
 private:
+    // Mailboxes are processed in order of their priority at the time they were scheduled, and
+    // in the order they were scheduled for equal priorities.
+    struct Entry {
+        int32_t priority;
+        uint64_t sequence;
+        std::weak_ptr<Mailbox> mailbox;
+
+        bool operator<(const Entry& rhs) const {
+            return priority < rhs.priority || (priority == rhs.priority && sequence > rhs.sequence);
+        }
+    };
+
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
-    std::mutex mutex;
+    std::priority_queue<Entry> queue;
+    uint64_t sequence { 0 };
+    mutable std::mutex mutex;
     std::condition_variable cv;
     bool terminate { false };
 };
@@ -6,7 +6,9 @@ std::shared_ptr<ThreadPool> sharedThreadPool() {
     static std::weak_ptr<ThreadPool> weak;
     auto pool = weak.lock();
     if (!pool) {
-        weak = pool = std::make_shared<ThreadPool>(4);
+        // Lays out the tiles of the maps, which the user waits for during gestures.
+        weak = pool = std::make_shared<ThreadPool>(4, platform::ThreadPriority::Interactive,
+                                                   platform::ThreadAffinity::PerformanceCores);
     }
     return pool;
 }
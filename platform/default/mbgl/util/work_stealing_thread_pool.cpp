@@ -0,0 +1,120 @@
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cassert>
+#include <limits>
+
+namespace mbgl {
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t count,
+                                               optional<platform::ThreadPriority> priority,
+                                               platform::ThreadAffinity affinity)
+    : queues(count) {
+    assert(count > 0);
+
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([this, i, priority, affinity]() {
+            platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+            if (priority) {
+                platform::setCurrentThreadPriority(*priority);
+            }
+            if (affinity != platform::ThreadAffinity::Any) {
+                platform::setCurrentThreadAffinity(affinity);
+            }
+
+            while (!terminate) {
+                std::weak_ptr<Mailbox> mailbox;
+                if (pop(i, mailbox)) {
+                    Mailbox::maybeReceive(mailbox);
+                    continue;
+                }
+
+                // Out of work: sleep until something is scheduled. `sleeping` is incremented
+                // before `pending` is checked, and schedule() increments `pending` before it
+                // checks `sleeping`, so at least one side always observes the other.
+                std::unique_lock<std::mutex> lock(mutex);
+                ++sleeping;
+                cv.wait(lock, [this] {
+                    return pending > 0 || terminate;
+                });
+                --sleeping;
+            }
+        });
+    }
+
+    // Kept separately from `threads` so that currentWorker() doesn't race with join().
+    for (auto& thread : threads) {
+        ids.push_back(thread.get_id());
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminate = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    std::size_t worker = currentWorker();
+    if (worker >= queues.size()) {
+        worker = next++ % queues.size();
+    }
+
+    {
+        Queue& queue = queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.mailboxes.push_back(std::move(mailbox));
+    }
+
+    ++pending;
+
+    if (sleeping > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_one();
+    }
+}
+
+std::size_t WorkStealingThreadPool::currentWorker() const {
+    const auto id = std::this_thread::get_id();
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (ids[i] == id) {
+            return i;
+        }
+    }
+    return std::numeric_limits<std::size_t>::max();
+}
+
+bool WorkStealingThreadPool::pop(std::size_t worker, std::weak_ptr<Mailbox>& mailbox) {
+    for (std::size_t n = 0; n < queues.size(); ++n) {
+        Queue& queue = queues[(worker + n) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.mailboxes.empty()) {
+            continue;
+        }
+
+        if (n == 0) {
+            mailbox = std::move(queue.mailboxes.front());
+            queue.mailboxes.pop_front();
+        } else {
+            mailbox = std::move(queue.mailboxes.back());
+            queue.mailboxes.pop_back();
+        }
+
+        --pending;
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace mbgl
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/platform.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A `WorkStealingThreadPool` is a drop-in replacement for `ThreadPool` that avoids a single,
+    shared queue. Each worker owns a queue of mailboxes; mailboxes scheduled from a worker thread
+    (e.g. an actor sending a message to another actor) go to that worker's queue, and mailboxes
+    scheduled from any other thread are distributed round-robin. Workers process their own queue
+    in FIFO order and steal from the back of other workers' queues when they run out of work.
+
+    The per-mailbox guarantees of `Scheduler` are unaffected: a mailbox is only ever present in
+    one queue at a time, so its messages are still processed in order, one at a time.
+*/
+
+class WorkStealingThreadPool : public Scheduler {
+public:
+    // Runs the workers at the priority and on the cores given, as for `ThreadPool`.
+    WorkStealingThreadPool(std::size_t count,
+                           optional<platform::ThreadPriority> = {},
+                           platform::ThreadAffinity = platform::ThreadAffinity::Any);
+    ~WorkStealingThreadPool() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+    std::size_t getQueueDepth() const override {
+        return pending;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::weak_ptr<Mailbox>> mailboxes;
+    };
+
+    std::size_t currentWorker() const;
+    bool pop(std::size_t worker, std::weak_ptr<Mailbox>&);
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> threads;
+    std::vector<std::thread::id> ids;
+
+    std::atomic<std::size_t> pending { 0 };
+    std::atomic<std::size_t> sleeping { 0 };
+    std::atomic<std::size_t> next { 0 };
+    std::atomic<bool> terminate { false };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+} // namespace mbgl
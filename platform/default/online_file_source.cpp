@@ -1,6 +1,8 @@
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/concurrency_limit.hpp>
 #include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/tile_batch.hpp>
 
 #include <mbgl/storage/resource_transform.hpp>
 #include <mbgl/storage/response.hpp>
@@ -15,16 +17,26 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/timer.hpp>
+#include <mbgl/util/timer_wheel.hpp>
 #include <mbgl/util/http_timeout.hpp>
+#include <mbgl/util/trace.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <list>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
+namespace {
+
+// Keeps a batch's URL, and the time until its first tile arrives, reasonably short.
+const std::size_t maximumBatchSize = 16;
+
+} // namespace
+
 class OnlineFileRequest : public AsyncRequest {
 public:
     using Callback = std::function<void (Response)>;
@@ -43,7 +55,12 @@ public:
     OnlineFileSource::Impl& impl;
     Resource resource;
     std::unique_ptr<AsyncRequest> request;
+    TimePoint activated;
+    util::trace::Span networkSpan;
     util::Timer timer;
+    // For timeouts that may fire a second late, like expiration refreshes and long backoffs, of
+    // which there may be thousands at once.
+    util::CoarseTimer coarseTimer;
     Callback callback;
 
     std::shared_ptr<Mailbox> mailbox;
@@ -60,6 +77,58 @@ public:
     optional<Timestamp> retryAfter;
 };
 
+// Requests waiting for room in the active set, in the order they'll be activated: requests of
+// regular priority before those of low priority, and within a priority, in the order they were
+// queued.
+class PendingRequests {
+public:
+    void insert(OnlineFileRequest* request) {
+        if (request->resource.priority == Resource::Priority::Low) {
+            auto it = queue.insert(queue.end(), request);
+            if (firstLowPriority == queue.end()) {
+                firstLowPriority = it;
+            }
+            positions.emplace(request, it);
+        } else {
+            positions.emplace(request, queue.insert(firstLowPriority, request));
+        }
+        assert(positions.size() == queue.size());
+    }
+
+    void remove(OnlineFileRequest* request) {
+        auto it = positions.find(request);
+        if (it != positions.end()) {
+            if (it->second == firstLowPriority) {
+                ++firstLowPriority;
+            }
+            queue.erase(it->second);
+            positions.erase(it);
+        }
+        assert(positions.size() == queue.size());
+    }
+
+    OnlineFileRequest* pop() {
+        assert(!queue.empty());
+        OnlineFileRequest* request = queue.front();
+        remove(request);
+        return request;
+    }
+
+    bool contains(OnlineFileRequest* request) const {
+        return positions.find(request) != positions.end();
+    }
+
+    bool empty() const {
+        return queue.empty();
+    }
+
+private:
+    std::list<OnlineFileRequest*> queue;
+    // Requests of regular priority are queued in front of this one.
+    std::list<OnlineFileRequest*>::iterator firstLowPriority = queue.end();
+    std::unordered_map<OnlineFileRequest*, std::list<OnlineFileRequest*>::iterator> positions;
+};
+
 class OnlineFileSource::Impl {
 public:
     Impl() {
@@ -72,7 +141,10 @@ public:
 
     void add(OnlineFileRequest* request) {
         allRequests.insert(request);
-        if (resourceTransform) {
+        if (synchronousTransform) {
+            request->resource.url = synchronousTransform(request->resource.kind, request->resource.url);
+            request->schedule();
+        } else if (resourceTransform) {
             // Request the ResourceTransform actor a new url and replace the resource url with the
             // transformed one before proceeding to schedule the request.
             resourceTransform->invoke(&ResourceTransform::transform, request->resource.kind,
@@ -86,16 +158,22 @@ public:
 
     void remove(OnlineFileRequest* request) {
         allRequests.erase(request);
+        auto batched = batchedRequests.find(request);
+        if (batched != batchedRequests.end()) {
+            auto batch = batched->second;
+            batch->requests.erase(std::find(batch->requests.begin(), batch->requests.end(), request));
+            batchedRequests.erase(batched);
+            if (batch->requests.empty() && !batch->completing) {
+                // Nothing is waiting for the batch anymore.
+                batches.erase(batch);
+            }
+        }
         if (activeRequests.erase(request)) {
-            activatePendingRequest();
+            activatePendingRequests();
         } else {
-            auto it = pendingRequestsMap.find(request);
-            if (it != pendingRequestsMap.end()) {
-                pendingRequestsList.erase(it->second);
-                pendingRequestsMap.erase(it);
-            }
+            // Requests for tiles that went out of view are canceled before they go out.
+            pendingRequests.remove(request);
         }
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
     void activateOrQueueRequest(OnlineFileRequest* request) {
@@ -103,46 +181,32 @@ public:
         assert(activeRequests.find(request) == activeRequests.end());
         assert(!request->request);
 
-        if (activeRequests.size() >= HTTPFileSource::maximumConcurrentRequests()) {
-            queueRequest(request);
+        if (activeRequestCount() >= maximumConcurrentRequests()) {
+            pendingRequests.insert(request);
         } else {
             activateRequest(request);
         }
     }
 
-    void queueRequest(OnlineFileRequest* request) {
-        auto it = pendingRequestsList.insert(pendingRequestsList.end(), request);
-        pendingRequestsMap.emplace(request, std::move(it));
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
-    }
-
     void activateRequest(OnlineFileRequest* request) {
         activeRequests.insert(request);
-        request->request = httpFileSource.request(request->resource, [=] (Response response) {
-            activeRequests.erase(request);
-            activatePendingRequest();
-            request->request.reset();
-            request->completed(response);
-        });
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+        request->activated = Clock::now();
+        request->networkSpan = util::trace::Span("network", util::trace::tileOf(request->resource));
+        if (isBatchable(*request)) {
+            addToBatch(request);
+        } else {
+            sendRequest(request);
+        }
     }
 
-    void activatePendingRequest() {
-        if (pendingRequestsList.empty()) {
-            return;
+    void activatePendingRequests() {
+        while (!pendingRequests.empty() && activeRequestCount() < maximumConcurrentRequests()) {
+            activateRequest(pendingRequests.pop());
         }
-
-        OnlineFileRequest* request = pendingRequestsList.front();
-        pendingRequestsList.pop_front();
-
-        pendingRequestsMap.erase(request);
-
-        activateRequest(request);
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
     bool isPending(OnlineFileRequest* request) {
-        return pendingRequestsMap.find(request) != pendingRequestsMap.end();
+        return pendingRequests.contains(request);
     }
 
     bool isActive(OnlineFileRequest* request) {
@@ -153,7 +217,180 @@ public:
         resourceTransform = std::move(transform);
     }
 
+    void setSynchronousResourceTransform(std::function<std::string(Resource::Kind, const std::string&)> transform) {
+        synchronousTransform = std::move(transform);
+    }
+
+    void setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost) {
+        httpFileSource.setHTTP2Multiplexing(enabled, maximumStreamsPerHost);
+    }
+
+    void setAdaptiveConcurrency(bool enabled) {
+        if (!enabled) {
+            concurrencyLimit.reset();
+        } else if (!concurrencyLimit) {
+            // Keeps a couple of requests in flight even on the worst connections, so that a
+            // single slow response doesn't hold up everything else.
+            concurrencyLimit = std::make_unique<ConcurrencyLimit>(2, HTTPFileSource::maximumConcurrentRequests());
+        }
+        activatePendingRequests();
+    }
+
 private:
+    // Tile requests that are sent together to their tileset's batch endpoint. Until it's sent, a
+    // batch collects the tiles activated during the current run loop iteration. See tile_batch.hpp.
+    struct Batch {
+        std::string urlTemplate;
+        std::vector<OnlineFileRequest*> requests;
+        std::unique_ptr<AsyncRequest> request;
+        TimePoint activated;
+        bool completing = false;
+    };
+
+    // Revalidations are sent on their own, since the batch endpoint doesn't take the tiles'
+    // validators.
+    static bool isBatchable(const OnlineFileRequest& request) {
+        const Resource& resource = request.resource;
+        return resource.kind == Resource::Kind::Tile && resource.tileData && resource.batchURL &&
+               !resource.priorEtag && !resource.priorModified;
+    }
+
+    // A batch takes up a single slot among the active requests.
+    std::size_t activeRequestCount() const {
+        return activeRequests.size() - batchedRequests.size() + batches.size();
+    }
+
+    void sendRequest(OnlineFileRequest* request) {
+        request->request = httpFileSource.request(request->resource, [=] (Response response) {
+            recordConcurrency(request->activated, response);
+            completeRequest(request, std::move(response));
+        });
+    }
+
+    void completeRequest(OnlineFileRequest* request, Response response) {
+        request->networkSpan.end();
+        activeRequests.erase(request);
+        activatePendingRequests();
+        request->request.reset();
+        request->completed(response);
+    }
+
+    void addToBatch(OnlineFileRequest* request) {
+        auto batch = std::find_if(batches.begin(), batches.end(), [&] (const Batch& candidate) {
+            return !candidate.request && candidate.urlTemplate == *request->resource.batchURL;
+        });
+        if (batch == batches.end()) {
+            batch = batches.emplace(batches.end());
+            batch->urlTemplate = *request->resource.batchURL;
+        }
+        batch->requests.push_back(request);
+        batchedRequests.emplace(request, batch);
+
+        if (batch->requests.size() >= maximumBatchSize) {
+            sendBatch(batch);
+        } else {
+            batchTimer.start(Duration::zero(), Duration::zero(), [this] {
+                for (auto it = batches.begin(); it != batches.end();) {
+                    // Sending a batch of a single tile takes it out of the list.
+                    auto next = std::next(it);
+                    if (!it->request) {
+                        sendBatch(it);
+                    }
+                    it = next;
+                }
+            });
+        }
+    }
+
+    void sendBatch(std::list<Batch>::iterator batch) {
+        if (batch->requests.size() == 1) {
+            OnlineFileRequest* request = batch->requests.front();
+            batchedRequests.erase(request);
+            batches.erase(batch);
+            sendRequest(request);
+            return;
+        }
+
+        std::vector<Resource::TileData> tiles;
+        for (const auto& request : batch->requests) {
+            tiles.push_back(*request->resource.tileData);
+        }
+
+        batch->activated = Clock::now();
+        batch->request = httpFileSource.request({ Resource::Unknown, batchURL(batch->urlTemplate, tiles) },
+                                                [this, batch] (Response response) {
+            completeBatch(batch, std::move(response));
+        });
+    }
+
+    void completeBatch(std::list<Batch>::iterator batch, Response response) {
+        batch->completing = true;
+        recordConcurrency(batch->activated, response);
+
+        std::unordered_map<std::string, Response> tiles;
+        if (!response.error && response.data) {
+            try {
+                tiles = parseBatchResponse(*response.data);
+            } catch (const std::exception& ex) {
+                Log::Warning(Event::HttpRequest, "Couldn't split batch response: %s", ex.what());
+            }
+        }
+
+        // The callbacks may cancel other requests of the batch, which takes them out of it.
+        while (!batch->requests.empty()) {
+            OnlineFileRequest* request = batch->requests.back();
+            batch->requests.pop_back();
+            batchedRequests.erase(request);
+
+            if (response.error && response.error->reason == Response::Error::Reason::Connection) {
+                // The tiles wouldn't have fared better on their own.
+                Response tile;
+                tile.error = std::make_unique<Response::Error>(*response.error);
+                completeRequest(request, std::move(tile));
+                continue;
+            }
+
+            // Tiles the batch doesn't have, or all of them if it failed, are requested on their own.
+            auto it = tiles.find(batchTileKey(*request->resource.tileData));
+            if (it == tiles.end()) {
+                sendRequest(request);
+            } else {
+                completeRequest(request, std::move(it->second));
+            }
+        }
+
+        batches.erase(batch);
+        activatePendingRequests();
+    }
+
+    std::size_t maximumConcurrentRequests() const {
+        return concurrencyLimit ? concurrencyLimit->get() : HTTPFileSource::maximumConcurrentRequests();
+    }
+
+    void recordConcurrency(TimePoint activated, const Response& response) {
+        if (!concurrencyLimit) {
+            return;
+        }
+
+        if (response.error) {
+            // Other errors came back as fast as the connection allowed.
+            if (response.error->reason == Response::Error::Reason::Connection) {
+                concurrencyLimit->failed();
+            }
+            return;
+        }
+
+        Response::Timing timing;
+        if (response.timing) {
+            timing = *response.timing;
+        } else {
+            // Without a breakdown from the HTTP stack, the whole request counts as latency.
+            timing.firstByte = Clock::now() - activated;
+        }
+
+        concurrencyLimit->completed(timing, response.data ? response.data->size() : 0, activeRequestCount());
+    }
+
     void networkIsReachableAgain() {
         for (auto& request : allRequests) {
             request->networkIsReachableAgain();
@@ -161,6 +398,7 @@ private:
     }
 
     optional<ActorRef<ResourceTransform>> resourceTransform;
+    std::function<std::string(Resource::Kind, const std::string&)> synchronousTransform;
 
     /**
      * The lifetime of a request is:
@@ -171,14 +409,21 @@ private:
      * 4. Back to #1
      *
      * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * `pendingRequests`. Requests in the active state are in `activeRequests`; there are at
+     * most `maximumConcurrentRequests()` of them, counting every batch as one. Batched requests
+     * are also in `batchedRequests`, along with their batch.
      */
     std::unordered_set<OnlineFileRequest*> allRequests;
-    std::list<OnlineFileRequest*> pendingRequestsList;
-    std::unordered_map<OnlineFileRequest*, std::list<OnlineFileRequest*>::iterator> pendingRequestsMap;
+    PendingRequests pendingRequests;
     std::unordered_set<OnlineFileRequest*> activeRequests;
+    std::unique_ptr<ConcurrencyLimit> concurrencyLimit;
 
     HTTPFileSource httpFileSource;
+
+    std::list<Batch> batches;
+    std::unordered_map<OnlineFileRequest*, std::list<Batch>::iterator> batchedRequests;
+    util::Timer batchTimer;
+
     util::AsyncTask reachability { std::bind(&Impl::networkIsReachableAgain, this) };
 };
 
@@ -225,6 +470,18 @@ void OnlineFileSource::setResourceTransform(optional<ActorRef<ResourceTransform>
     impl->setResourceTransform(std::move(transform));
 }
 
+void OnlineFileSource::setSynchronousResourceTransform(std::function<std::string(Resource::Kind, const std::string&)> transform) {
+    impl->setSynchronousResourceTransform(std::move(transform));
+}
+
+void OnlineFileSource::setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost) {
+    impl->setHTTP2Multiplexing(enabled, maximumStreamsPerHost);
+}
+
+void OnlineFileSource::setAdaptiveConcurrency(bool enabled) {
+    impl->setAdaptiveConcurrency(enabled);
+}
+
 OnlineFileRequest::OnlineFileRequest(Resource resource_, Callback callback_, OnlineFileSource::Impl& impl_)
     : impl(impl_),
       resource(std::move(resource_)),
@@ -305,9 +562,16 @@ void OnlineFileRequest::schedule(optional<Timestamp> expires) {
         timeout = Duration::max();
     }
 
-    timer.start(timeout, Duration::zero(), [&] {
+    auto activate = [&] {
         impl.activateOrQueueRequest(this);
-    });
+    };
+    if (timeout >= Seconds(1) && timeout != Duration::max()) {
+        timer.stop();
+        coarseTimer.start(timeout, Duration::zero(), std::move(activate));
+    } else {
+        coarseTimer.stop();
+        timer.start(timeout, Duration::zero(), std::move(activate));
+    }
 }
 
 void OnlineFileRequest::completed(Response response) {
@@ -0,0 +1,358 @@
+#include <mbgl/storage/pack_file_source.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include "sqlite3.hpp"
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char* protocol = "pack://";
+const std::size_t protocolLength = 7;
+
+using JSONWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+} // namespace
+
+namespace mbgl {
+
+namespace {
+
+class Archive {
+public:
+    virtual ~Archive() = default;
+
+    // Writes the members of the archive's TileJSON, other than `tiles`.
+    virtual void writeMetadata(JSONWriter&) = 0;
+
+    // Returns null if the archive doesn't contain the tile.
+    virtual std::shared_ptr<const std::string> getTile(uint32_t z, uint32_t x, uint32_t y) = 0;
+};
+
+class MappedPack : public Archive {
+public:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+        uint64_t metadataOffset;
+        uint64_t metadataLength;
+    };
+
+    struct Entry {
+        uint32_t z;
+        uint32_t x;
+        uint32_t y;
+        uint32_t length;
+        uint64_t offset;
+    };
+
+    static_assert(sizeof(Header) == 32, "unexpected pack header size");
+    static_assert(sizeof(Entry) == 24, "unexpected pack index entry size");
+
+    MappedPack(int fd_, std::size_t size_)
+        : fd(fd_),
+          size(size_),
+          base(mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)) {
+    }
+
+    ~MappedPack() override {
+        if (base != MAP_FAILED) {
+            munmap(base, size);
+        }
+        close(fd);
+    }
+
+    void validate() {
+        if (base == MAP_FAILED) {
+            throw std::runtime_error(std::string("unable to map pack: ") + std::strerror(errno));
+        }
+
+        // Tiles are looked up at random.
+        madvise(base, size, MADV_RANDOM);
+
+        const auto& header = *reinterpret_cast<const Header*>(base);
+        if (header.version != 1) {
+            throw std::runtime_error("unsupported pack version " + util::toString(header.version));
+        }
+        if (sizeof(Header) + uint64_t(header.count) * sizeof(Entry) > size ||
+            header.metadataOffset > size || header.metadataLength > size - header.metadataOffset) {
+            throw std::runtime_error("truncated pack");
+        }
+
+        begin = reinterpret_cast<const Entry*>(data() + sizeof(Header));
+        end = begin + header.count;
+        metadataOffset = header.metadataOffset;
+        metadataLength = header.metadataLength;
+    }
+
+    void writeMetadata(JSONWriter& writer) override {
+        JSDocument document;
+        document.Parse<0>(data() + metadataOffset, metadataLength);
+        if (document.HasParseError() || !document.IsObject()) {
+            throw std::runtime_error("invalid pack metadata");
+        }
+
+        for (const auto& member : document.GetObject()) {
+            if (std::strcmp(member.name.GetString(), "tiles") != 0) {
+                member.name.Accept(writer);
+                member.value.Accept(writer);
+            }
+        }
+    }
+
+    std::shared_ptr<const std::string> getTile(uint32_t z, uint32_t x, uint32_t y) override {
+        const auto key = std::make_tuple(z, x, y);
+        const Entry* entry = std::lower_bound(begin, end, key, [] (const Entry& lhs, const std::tuple<uint32_t, uint32_t, uint32_t>& rhs) {
+            return std::tie(lhs.z, lhs.x, lhs.y) < rhs;
+        });
+
+        if (entry == end || std::tie(entry->z, entry->x, entry->y) != key ||
+            entry->offset > size || entry->length > size - entry->offset) {
+            return nullptr;
+        }
+
+        // Response data owns its bytes, so this is the one copy the tile incurs; it comes
+        // straight out of the page cache.
+        return std::make_shared<const std::string>(data() + entry->offset, entry->length);
+    }
+
+private:
+    const char* data() const {
+        return reinterpret_cast<const char*>(base);
+    }
+
+    const int fd;
+    const std::size_t size;
+    void* const base;
+
+    const Entry* begin = nullptr;
+    const Entry* end = nullptr;
+    uint64_t metadataOffset = 0;
+    uint64_t metadataLength = 0;
+};
+
+class MBTiles : public Archive {
+public:
+    MBTiles(const std::string& path)
+        : db(path, mapbox::sqlite::ReadOnly) {
+        // Read pages through a memory map instead of copying them into SQLite's page cache.
+        db.exec("PRAGMA mmap_size = 1073741824");
+    }
+
+    void writeMetadata(JSONWriter& writer) override {
+        writer.Key("tilejson");
+        writer.String("2.2.0");
+
+        mapbox::sqlite::Statement stmt = db.prepare("SELECT name, value FROM metadata");
+        while (stmt.run()) {
+            const std::string name = stmt.get<std::string>(0);
+            const std::string value = stmt.get<std::string>(1);
+
+            if (name == "minzoom" || name == "maxzoom") {
+                writer.Key(name.c_str());
+                writer.Int(std::atoi(value.c_str()));
+            } else if (name == "bounds") {
+                double bounds[4];
+                if (std::sscanf(value.c_str(), "%lf,%lf,%lf,%lf", &bounds[0], &bounds[1], &bounds[2], &bounds[3]) == 4) {
+                    writer.Key("bounds");
+                    writer.StartArray();
+                    for (double bound : bounds) {
+                        writer.Double(bound);
+                    }
+                    writer.EndArray();
+                }
+            } else if (name == "name" || name == "description" || name == "attribution" || name == "version") {
+                writer.Key(name.c_str());
+                writer.String(value);
+            }
+        }
+    }
+
+    std::shared_ptr<const std::string> getTile(uint32_t z, uint32_t x, uint32_t y) override {
+        if (!tileStmt) {
+            tileStmt = std::make_unique<mapbox::sqlite::Statement>(db.prepare(
+                "SELECT tile_data FROM tiles WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3"));
+        }
+
+        // MBTiles rows are numbered from the south.
+        tileStmt->bind(1, z);
+        tileStmt->bind(2, x);
+        tileStmt->bind(3, (1u << z) - 1 - y);
+
+        std::shared_ptr<const std::string> result;
+        if (tileStmt->run()) {
+            std::string data = tileStmt->get<std::string>(0);
+            if (data.size() >= 2 && uint8_t(data[0]) == 0x1F && uint8_t(data[1]) == 0x8B) {
+                data = util::decompress(data);
+            }
+            result = std::make_shared<const std::string>(std::move(data));
+        }
+
+        tileStmt->reset();
+        return result;
+    }
+
+private:
+    mapbox::sqlite::Database db;
+    std::unique_ptr<mapbox::sqlite::Statement> tileStmt;
+};
+
+std::unique_ptr<Archive> openArchive(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+
+    struct stat buf;
+    char magic[16] = {};
+    if (fstat(fd, &buf) == -1 || pread(fd, magic, sizeof(magic), 0) == -1) {
+        const int error = errno;
+        close(fd);
+        throw std::system_error(error, std::system_category());
+    }
+
+    if (std::size_t(buf.st_size) >= sizeof(MappedPack::Header) && std::memcmp(magic, "MBGLPACK", 8) == 0) {
+        auto pack = std::make_unique<MappedPack>(fd, buf.st_size);
+        pack->validate();
+        return std::move(pack);
+    }
+
+    close(fd);
+
+    if (std::memcmp(magic, "SQLite format 3", 16) == 0) {
+        return std::make_unique<MBTiles>(path);
+    }
+
+    throw std::runtime_error("not a tile pack or MBTiles file");
+}
+
+// Parses the `z=…&x=…&y=…` query of a tile URL.
+bool parseTileQuery(const std::string& query, uint32_t& z, uint32_t& x, uint32_t& y) {
+    bool hasZ = false, hasX = false, hasY = false;
+    std::size_t start = 0;
+    while (start < query.size()) {
+        std::size_t end = query.find('&', start);
+        if (end == std::string::npos) {
+            end = query.size();
+        }
+        if (end - start > 2 && query[start + 1] == '=') {
+            const uint32_t value = std::strtoul(query.c_str() + start + 2, nullptr, 10);
+            switch (query[start]) {
+                case 'z': z = value; hasZ = true; break;
+                case 'x': x = value; hasX = true; break;
+                case 'y': y = value; hasY = true; break;
+            }
+        }
+        start = end + 1;
+    }
+    return hasZ && hasX && hasY && z < 32;
+}
+
+} // namespace
+
+class PackFileSource::Impl {
+public:
+    Impl(ActorRef<Impl>) {}
+
+    void request(const std::string& url, ActorRef<FileSourceRequest> req) {
+        Response response;
+
+        try {
+            const std::size_t queryStart = url.find('?');
+            const std::string archiveURL = url.substr(0, queryStart);
+            Archive& archive = getArchive(util::percentDecode(archiveURL.substr(protocolLength)));
+
+            if (queryStart == std::string::npos) {
+                response.data = std::make_shared<std::string>(tileJSON(archiveURL, archive));
+            } else {
+                uint32_t z = 0, x = 0, y = 0;
+                if (!parseTileQuery(url.substr(queryStart + 1), z, x, y)) {
+                    response.error = std::make_unique<Response::Error>(
+                        Response::Error::Reason::Other, "Invalid tile URL");
+                } else if (auto data = archive.getTile(z, x, y)) {
+                    response.data = std::move(data);
+                } else {
+                    response.noContent = true;
+                }
+            }
+        } catch (const std::system_error& error) {
+            response.error = std::make_unique<Response::Error>(
+                error.code().value() == ENOENT ? Response::Error::Reason::NotFound : Response::Error::Reason::Other,
+                error.what());
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+
+        req.invoke(&FileSourceRequest::setResponse, response);
+    }
+
+private:
+    Archive& getArchive(const std::string& path) {
+        auto it = archives.find(path);
+        if (it == archives.end()) {
+            it = archives.emplace(path, openArchive(path)).first;
+        }
+        return *it->second;
+    }
+
+    static std::string tileJSON(const std::string& archiveURL, Archive& archive) {
+        rapidjson::StringBuffer buffer;
+        JSONWriter writer(buffer);
+
+        writer.StartObject();
+        archive.writeMetadata(writer);
+        writer.Key("tiles");
+        writer.StartArray();
+        writer.String(archiveURL + "?z={z}&x={x}&y={y}");
+        writer.EndArray();
+        writer.EndObject();
+
+        return buffer.GetString();
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<Archive>> archives;
+};
+
+PackFileSource::PackFileSource()
+    : impl(std::make_unique<util::Thread<Impl>>("PackFileSource")) {
+}
+
+PackFileSource::~PackFileSource() = default;
+
+std::unique_ptr<AsyncRequest> PackFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    impl->actor().invoke(&Impl::request, resource.url, req->actor());
+
+    return std::move(req);
+}
+
+bool PackFileSource::acceptsURL(const std::string& url) {
+    return url.compare(0, protocolLength, protocol) == 0;
+}
+
+} // namespace mbgl
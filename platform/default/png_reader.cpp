@@ -98,7 +98,10 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     int color_type = 0;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+    PremultipliedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+
+    // Without an alpha channel or transparency, colors are premultiplied already.
+    const bool hasAlpha = (color_type & PNG_COLOR_MASK_ALPHA) || png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
     if (color_type == PNG_COLOR_TYPE_PALETTE)
         png_set_expand(png_ptr);
@@ -118,25 +121,35 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
 
-    if (png_get_interlace_type(png_ptr,info_ptr) == PNG_INTERLACE_ADAM7) {
-        png_set_interlace_handling(png_ptr); // FIXME: libpng bug?
-        // according to docs png_read_image
-        // "..automatically handles interlacing,
-        // so you don't need to call png_set_interlace_handling()"
-    }
+    const bool interlaced = png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_ADAM7;
+    const int passes = interlaced ? png_set_interlace_handling(png_ptr) : 1;
 
     png_read_update_info(png_ptr, info_ptr);
 
-    // we can read whole image at once
-    // alloc row pointers
-    const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
-    for (unsigned row = 0; row < height; ++row)
-        rows[row] = image.data.get() + row * width * 4;
-    png_read_image(png_ptr, rows.get());
+    const std::size_t stride = std::size_t(width) * 4;
+    if (passes == 1) {
+        // Rows are decoded straight into the image, and premultiplied while they're still in cache.
+        for (png_uint_32 row = 0; row < height; ++row) {
+            png_bytep pixels = image.data.get() + row * stride;
+            png_read_row(png_ptr, pixels, nullptr);
+            if (hasAlpha) {
+                util::premultiply(pixels, stride);
+            }
+        }
+    } else {
+        // Interlaced rows are complete only after the last pass.
+        const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
+        for (png_uint_32 row = 0; row < height; ++row)
+            rows[row] = image.data.get() + row * stride;
+        png_read_image(png_ptr, rows.get());
+        if (hasAlpha) {
+            util::premultiply(image.data.get(), image.bytes());
+        }
+    }
 
     png_read_end(png_ptr, nullptr);
 
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
@@ -38,10 +38,7 @@ void addChunk(std::string& png, const char* type, const char* data = "", const u
 namespace mbgl {
 
 // Encode PNGs without libpng.
-std::string encodePNG(const PremultipliedImage& pre) {
-    // Make copy of the image so that we can unpremultiply it.
-    const auto src = util::unpremultiply(pre.clone());
-
+std::string encodePNG(const PremultipliedImage& src, int compressionLevel) {
     // PNG magic bytes
     const char preamble[8] = { char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
 
@@ -56,15 +53,17 @@ std::string encodePNG(const PremultipliedImage& pre) {
         0,                                    // interlace method == none
     };
 
-    // Prepare the (compressed) data chunk.
+    // Prepare the (compressed) data chunk. The pixels are unpremultiplied while they're copied
+    // into the scanlines, rather than in a copy of the image.
     const auto stride = src.stride();
-    std::string idat;
+    std::string idat((stride + 1) * src.size.height, '\0');
     for (uint32_t y = 0; y < src.size.height; y++) {
-        // Every scanline needs to be prefixed with one byte that indicates the filter type.
-        idat.append(1, 0); // filter type 0
-        idat.append((const char*)(src.data.get() + y * stride), stride);
+        // Every scanline needs to be prefixed with one byte that indicates the filter type,
+        // which is left at 0.
+        util::unpremultiply(src.data.get() + y * stride,
+                            reinterpret_cast<uint8_t*>(&idat[y * (stride + 1) + 1]), stride);
     }
-    idat = util::compress(idat);
+    idat = util::compress(idat, compressionLevel);
 
     // Assemble the PNG.
     std::string png;
@@ -103,6 +103,9 @@ RunLoop::RunLoop(Type type) : impl(std::make_unique<Impl>()) {
 }
 
 RunLoop::~RunLoop() {
+    // The timer of the wheel has to be closed along with the other handles.
+    timerWheel.reset();
+
     current.set(nullptr);
 
     // Close the dummy handle that we have
@@ -130,8 +133,7 @@ LOOP_HANDLE RunLoop::getLoopHandle() {
     return current.get()->impl->loop;
 }
 
-void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+void RunLoop::wake() {
     impl->async->send();
 }
 
@@ -5,6 +5,7 @@
 
 #include <pthread.h>
 #include <sched.h>
+#include <sys/resource.h>
 
 namespace mbgl {
 namespace platform {
@@ -24,14 +25,28 @@ void setCurrentThreadName(const std::string& name) {
     }
 }
 
-void makeThreadLowPriority() {
+void setCurrentThreadPriority(ThreadPriority priority) {
     struct sched_param param;
     param.sched_priority = 0;
 
-    if (sched_setscheduler(0, SCHED_IDLE, &param) != 0) {
+    // Threads of low priority only run on cores that would be idle otherwise.
+    const bool idle = priority == ThreadPriority::Background || priority == ThreadPriority::Low;
+    if (sched_setscheduler(0, idle ? SCHED_IDLE : SCHED_OTHER, &param) != 0) {
         Log::Warning(Event::General, "Couldn't set thread scheduling policy");
+        return;
+    }
+
+    if (!idle) {
+        // On Linux, this only sets the nice value of the current thread rather than that of the
+        // whole process. Lowering it below zero needs privileges, so interactive threads may run
+        // at normal priority.
+        setpriority(PRIO_PROCESS, 0, priority == ThreadPriority::Interactive ? -5 : 0);
     }
 }
 
+void makeThreadLowPriority() {
+    setCurrentThreadPriority(ThreadPriority::Low);
+}
+
 } // namespace platform
 } // namespace mbgl
@@ -0,0 +1,60 @@
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <unistd.h>
+
+namespace mbgl {
+namespace platform {
+
+namespace {
+
+// The cores with the highest maximum frequency, which are all cores unless the device has cores
+// of different speeds, like big.LITTLE designs.
+cpu_set_t performanceCores() {
+    // Offline cores, and cores without frequency scaling, have no frequency.
+    const long count = std::min<long>(sysconf(_SC_NPROCESSORS_CONF), CPU_SETSIZE);
+    std::vector<uint64_t> frequencies(std::max<long>(count, 0), 0);
+    for (std::size_t core = 0; core < frequencies.size(); core++) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + util::toString(core) + "/cpufreq/cpuinfo_max_freq");
+        file >> frequencies[core];
+    }
+
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    const uint64_t fastest = frequencies.empty() ? 0 : *std::max_element(frequencies.begin(), frequencies.end());
+    for (std::size_t core = 0; core < frequencies.size(); core++) {
+        if (fastest == 0 || frequencies[core] == fastest) {
+            CPU_SET(core, &cores);
+        }
+    }
+    return cores;
+}
+
+} // namespace
+
+void setCurrentThreadAffinity(ThreadAffinity affinity) {
+    cpu_set_t cores;
+    if (affinity == ThreadAffinity::PerformanceCores) {
+        static const cpu_set_t fastest = performanceCores();
+        cores = fastest;
+    } else {
+        CPU_ZERO(&cores);
+        for (int core = 0; core < CPU_SETSIZE; core++) {
+            CPU_SET(core, &cores);
+        }
+    }
+
+    if (CPU_COUNT(&cores) == 0 || sched_setaffinity(0, sizeof(cores), &cores) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+    }
+}
+
+} // namespace platform
+} // namespace mbgl
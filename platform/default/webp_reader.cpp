@@ -1,5 +1,4 @@
 #include <mbgl/util/image.hpp>
-#include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/logging.hpp>
 
 extern "C"
@@ -9,23 +8,49 @@ extern "C"
 
 namespace mbgl {
 
-PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
-    int width = 0, height = 0;
-    if (WebPGetInfo(data, size, &width, &height) == 0) {
+PremultipliedImage decodeWebP(const uint8_t* data, size_t size, Size minimumSize) {
+    WebPDecoderConfig config;
+    if (!WebPInitDecoderConfig(&config)) {
+        throw std::runtime_error("incompatible WebP decoder version");
+    }
+
+    if (WebPGetFeatures(data, size, &config.input) != VP8_STATUS_OK) {
         throw std::runtime_error("failed to retrieve WebP basic header information");
     }
 
-    int stride = width * 4;
-    size_t webpSize = stride * height;
-    auto webp = std::make_unique<uint8_t[]>(webpSize);
+    uint32_t width = config.input.width;
+    uint32_t height = config.input.height;
+
+    // Scale down by powers of two like the JPEG decoder, for as long as the image stays at least
+    // as large as requested. The rescaler works while decoding, so the full size is never held.
+    if (!minimumSize.isEmpty()) {
+        while (width % 2 == 0 && height % 2 == 0 &&
+               width / 2 >= minimumSize.width && height / 2 >= minimumSize.height) {
+            width /= 2;
+            height /= 2;
+        }
+        if (width != uint32_t(config.input.width)) {
+            config.options.use_scaling = 1;
+            config.options.scaled_width = width;
+            config.options.scaled_height = height;
+        }
+    }
+
+    // Decodes straight into the image, which libwebp premultiplies in the process.
+    PremultipliedImage image({ width, height });
+    config.output.colorspace = MODE_rgbA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = image.data.get();
+    config.output.u.RGBA.stride = width * 4;
+    config.output.u.RGBA.size = image.bytes();
 
-    if (!WebPDecodeRGBAInto(data, size, webp.get(), webpSize, stride)) {
+    const VP8StatusCode status = WebPDecode(data, size, &config);
+    WebPFreeDecBuffer(&config.output);
+    if (status != VP8_STATUS_OK) {
         throw std::runtime_error("failed to decode WebP data");
     }
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) },
-                            std::move(webp));
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
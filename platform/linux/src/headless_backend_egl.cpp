@@ -9,6 +9,15 @@
 
 namespace mbgl {
 
+// EGL initializes the context client version to 1 by default. We want to
+// use OpenGL ES 2.0 which has the ability to create shader and program
+// objects and also to write vertex and fragment shaders in the OpenGL ES
+// Shading Language.
+static const EGLint contextAttribs[] = {
+    EGL_CONTEXT_CLIENT_VERSION, 2,
+    EGL_NONE
+};
+
 struct EGLImpl : public HeadlessBackend::Impl {
     EGLImpl(EGLContext glContext_, EGLDisplay display_, EGLConfig config_)
             : glContext(glContext_),
@@ -55,6 +64,16 @@ struct EGLImpl : public HeadlessBackend::Impl {
         }
     }
 
+    std::unique_ptr<HeadlessBackend::Impl> createSharedContext() final {
+        EGLContext sharedContext = eglCreateContext(display, config, glContext, contextAttribs);
+        if (sharedContext == EGL_NO_CONTEXT) {
+            mbgl::Log::Warning(mbgl::Event::OpenGL, "eglCreateContext() returned error 0x%04x for the shared context",
+                               eglGetError());
+            return nullptr;
+        }
+        return std::make_unique<EGLImpl>(sharedContext, display, config);
+    }
+
     EGLContext glContext = EGL_NO_CONTEXT;
     EGLDisplay display = EGL_NO_DISPLAY;
     EGLConfig config = 0;
@@ -79,16 +98,7 @@ void HeadlessBackend::createContext() {
     EGLDisplay display_ = display->attribute<EGLDisplay>();
     EGLConfig& config = display->attribute<EGLConfig&>();
 
-    // EGL initializes the context client version to 1 by default. We want to
-    // use OpenGL ES 2.0 which has the ability to create shader and program
-    // objects and also to write vertex and fragment shaders in the OpenGL ES
-    // Shading Language.
-    const EGLint attribs[] = {
-        EGL_CONTEXT_CLIENT_VERSION, 2,
-        EGL_NONE
-    };
-
-    EGLContext glContext = eglCreateContext(display_, config, EGL_NO_CONTEXT, attribs);
+    EGLContext glContext = eglCreateContext(display_, config, EGL_NO_CONTEXT, contextAttribs);
     if (glContext == EGL_NO_CONTEXT) {
         mbgl::Log::Error(mbgl::Event::OpenGL, "eglCreateContext() returned error 0x%04x",
                          eglGetError());
@@ -9,6 +9,17 @@
 
 namespace mbgl {
 
+// Creates a dummy pbuffer. We will render to framebuffers anyway, but we need a pbuffer to
+// activate the context.
+static GLXPbuffer createPbuffer(Display* xDisplay, GLXFBConfig* fbConfigs) {
+    int pbufferAttributes[] = {
+        GLX_PBUFFER_WIDTH, 8,
+        GLX_PBUFFER_HEIGHT, 8,
+        None
+    };
+    return glXCreatePbuffer(xDisplay, fbConfigs[0], pbufferAttributes);
+}
+
 struct GLXImpl : public HeadlessBackend::Impl {
     GLXImpl(GLXContext glContext_, GLXPbuffer glxPbuffer_, Display* xDisplay_, GLXFBConfig* fbConfigs_)
             : glContext(glContext_),
@@ -36,6 +47,14 @@ struct GLXImpl : public HeadlessBackend::Impl {
         }
     }
 
+    std::unique_ptr<HeadlessBackend::Impl> createSharedContext() final {
+        GLXContext sharedContext = glXCreateNewContext(xDisplay, fbConfigs[0], GLX_RGBA_TYPE, glContext, True);
+        if (!sharedContext) {
+            return nullptr;
+        }
+        return std::make_unique<GLXImpl>(sharedContext, createPbuffer(xDisplay, fbConfigs), xDisplay, fbConfigs);
+    }
+
     GLXContext glContext = nullptr;
     GLXPbuffer glxPbuffer = 0;
 
@@ -72,16 +91,7 @@ void HeadlessBackend::createContext() {
         throw std::runtime_error("Error creating GL context object.");
     }
 
-    // Create a dummy pbuffer. We will render to framebuffers anyway, but we need a pbuffer to
-    // activate the context.
-    int pbufferAttributes[] = {
-        GLX_PBUFFER_WIDTH, 8,
-        GLX_PBUFFER_HEIGHT, 8,
-        None
-    };
-    GLXPbuffer glxPbuffer = glXCreatePbuffer(xDisplay, fbConfigs[0], pbufferAttributes);
-
-    impl = std::make_unique<mbgl::GLXImpl>(glContext, glxPbuffer, xDisplay, fbConfigs);
+    impl = std::make_unique<mbgl::GLXImpl>(glContext, createPbuffer(xDisplay, fbConfigs), xDisplay, fbConfigs);
 }
 
 } // namespace mbgl
@@ -5,6 +5,7 @@ mason_use(boost_libprogram_options VERSION 1.62.0)
 mason_use(gtest VERSION 1.8.0)
 mason_use(benchmark VERSION 1.0.0-1)
 mason_use(icu VERSION 58.1-min-size)
+mason_use(webp VERSION 0.5.1)
 
 include(cmake/loop-darwin.cmake)
 
@@ -15,6 +16,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/asset_file_source.cpp
         PRIVATE platform/default/default_file_source.cpp
         PRIVATE platform/default/local_file_source.cpp
+        PRIVATE platform/default/pack_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
 
         # Default styles
@@ -36,6 +38,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/darwin/src/nsthread.mm
         PRIVATE platform/darwin/src/string_nsstring.mm
         PRIVATE platform/default/bidi.cpp
+        PRIVATE platform/default/local_glyph_rasterizer.cpp
         PRIVATE platform/default/thread_local.cpp
         PRIVATE platform/default/utf.cpp
 
@@ -43,6 +46,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/darwin/mbgl/util/image+MGLAdditions.hpp
         PRIVATE platform/darwin/src/image.mm
         PRIVATE platform/default/png_writer.cpp
+        PRIVATE platform/default/webp_reader.cpp
 
         # Headless view
         PRIVATE platform/default/mbgl/gl/headless_frontend.cpp
@@ -58,11 +62,14 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/util/shared_thread_pool.hpp
         PRIVATE platform/default/mbgl/util/default_thread_pool.cpp
         PRIVATE platform/default/mbgl/util/default_thread_pool.cpp
+        PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.cpp
+        PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.hpp
     )
 
     target_add_mason_package(mbgl-core PUBLIC geojson)
     target_add_mason_package(mbgl-core PUBLIC polylabel)
     target_add_mason_package(mbgl-core PRIVATE icu)
+    target_add_mason_package(mbgl-core PRIVATE webp)
 
     target_compile_options(mbgl-core
         PRIVATE -fobjc-arc
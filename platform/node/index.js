@@ -49,4 +49,104 @@ var Map = function(options) {
 Map.prototype = mbgl.Map.prototype;
 Map.prototype.constructor = Map;
 
-module.exports = Object.assign(mbgl, { Map: Map });
+// Reads back the features that queryRenderedFeatures returns with `format: 'buffer'`. The
+// geometry and properties of each feature are only read from the buffer once they are accessed.
+var geometryTypes = ['Point', 'LineString', 'Polygon', 'MultiPoint', 'MultiLineString', 'MultiPolygon', 'GeometryCollection'];
+
+var decodeFeatures = function(buffer) {
+    var offset = 0;
+
+    var readString = function() {
+        var length = buffer.readUInt32LE(offset);
+        offset += 4;
+        offset += length;
+        return buffer.toString('utf8', offset - length, offset);
+    };
+
+    var readValue = function() {
+        var tag = buffer.readUInt8(offset++);
+        var i, length, result;
+        switch (tag) {
+        case 0: return null;
+        case 1: return false;
+        case 2: return true;
+        case 3: offset += 8; return buffer.readDoubleLE(offset - 8);
+        case 4: return readString();
+        case 5:
+            length = buffer.readUInt32LE(offset);
+            offset += 4;
+            result = [];
+            for (i = 0; i < length; i++) result.push(readValue());
+            return result;
+        default:
+            length = buffer.readUInt32LE(offset);
+            offset += 4;
+            result = {};
+            for (i = 0; i < length; i++) {
+                var key = readString();
+                result[key] = readValue();
+            }
+            return result;
+        }
+    };
+
+    // Reads `depth` levels of nested arrays of points.
+    var readCoordinates = function(depth) {
+        if (depth === 0) {
+            offset += 16;
+            return [buffer.readDoubleLE(offset - 16), buffer.readDoubleLE(offset - 8)];
+        }
+        var length = buffer.readUInt32LE(offset);
+        offset += 4;
+        var result = [];
+        for (var i = 0; i < length; i++) result.push(readCoordinates(depth - 1));
+        return result;
+    };
+
+    var readGeometry = function() {
+        var type = buffer.readUInt8(offset++);
+        if (type === 6) {
+            var length = buffer.readUInt32LE(offset);
+            offset += 4;
+            var geometries = [];
+            for (var i = 0; i < length; i++) geometries.push(readGeometry());
+            return { type: geometryTypes[type], geometries: geometries };
+        }
+        return { type: geometryTypes[type], coordinates: readCoordinates([0, 1, 2, 1, 2, 3][type]) };
+    };
+
+    // Defines a property that reads its value at `start` when it is first accessed.
+    var defineLazy = function(feature, name, start, read) {
+        var value;
+        Object.defineProperty(feature, name, {
+            enumerable: true,
+            get: function() {
+                if (value === undefined) {
+                    offset = start;
+                    value = read();
+                }
+                return value;
+            },
+            set: function(v) { value = v; }
+        });
+    };
+
+    var count = buffer.readUInt32LE(offset);
+    offset += 4;
+    var features = [];
+    for (var i = 0; i < count; i++) {
+        var feature = { type: 'Feature' };
+        var geometryLength = buffer.readUInt32LE(offset);
+        defineLazy(feature, 'geometry', offset + 4, readGeometry);
+        offset += 4 + geometryLength;
+        var propertiesLength = buffer.readUInt32LE(offset);
+        defineLazy(feature, 'properties', offset + 4, readValue);
+        offset += 4 + propertiesLength;
+        var id = readValue();
+        if (id !== null) feature.id = id;
+        features.push(feature);
+    }
+    return features;
+};
+
+module.exports = Object.assign(mbgl, { Map: Map, decodeFeatures: decodeFeatures });
@@ -1,5 +1,9 @@
 #include "node_feature.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
 namespace node_mbgl {
 
 using namespace mapbox::geometry;
@@ -166,4 +170,139 @@ v8::Local<v8::Object> toJS(const Feature& feature) {
     return scope.Escape(result);
 }
 
+namespace {
+
+// Writes the bytes of an unsigned integer from the least significant one, whatever the byte order
+// of the host.
+template <class T>
+void write(std::string& out, T value) {
+    static_assert(std::is_unsigned<T>::value, "only unsigned integers are written byte by byte");
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(char(uint8_t(value >> (8 * i))));
+    }
+}
+
+template <>
+void write<double>(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write<uint64_t>(out, bits);
+}
+
+void write(std::string& out, const std::string& string) {
+    write<uint32_t>(out, string.size());
+    out.append(string);
+}
+
+// Writes what `fn` writes, prefixed by its byte length.
+template <class Fn>
+void writeSized(std::string& out, Fn fn) {
+    const std::size_t start = out.size();
+    write<uint32_t>(out, 0);
+    fn();
+    const auto length = uint32_t(out.size() - start - sizeof(uint32_t));
+    for (std::size_t i = 0; i < sizeof(length); ++i) {
+        out[start + i] = char(uint8_t(length >> (8 * i)));
+    }
+}
+
+template <class T>
+struct ToTypeCode {
+    uint8_t operator()(const point<T>&) { return 0; }
+    uint8_t operator()(const line_string<T>&) { return 1; }
+    uint8_t operator()(const polygon<T>&) { return 2; }
+    uint8_t operator()(const multi_point<T>&) { return 3; }
+    uint8_t operator()(const multi_line_string<T>&) { return 4; }
+    uint8_t operator()(const multi_polygon<T>&) { return 5; }
+    uint8_t operator()(const geometry_collection<T>&) { return 6; }
+};
+
+template <class T>
+struct EncodeCoordinatesOrGeometries {
+    std::string& out;
+
+    // Handles line_string, polygon, multi_point, multi_line_string, multi_polygon, and geometry_collection.
+    template <class E>
+    void operator()(const std::vector<E>& vector) {
+        write<uint32_t>(out, vector.size());
+        for (const auto& element : vector) {
+            operator()(element);
+        }
+    }
+
+    void operator()(const point<T>& point) {
+        write<double>(out, point.x);
+        write<double>(out, point.y);
+    }
+
+    void operator()(const geometry<T>& geometry) {
+        write<uint8_t>(out, mapbox::geometry::geometry<T>::visit(geometry, ToTypeCode<T>()));
+        mapbox::geometry::geometry<T>::visit(geometry, *this);
+    }
+};
+
+struct EncodeValue {
+    std::string& out;
+
+    void operator()(mbgl::NullValue) {
+        write<uint8_t>(out, 0);
+    }
+
+    void operator()(bool t) {
+        write<uint8_t>(out, t ? 2 : 1);
+    }
+
+    void operator()(int64_t t) {
+        operator()(double(t));
+    }
+
+    void operator()(uint64_t t) {
+        operator()(double(t));
+    }
+
+    void operator()(double t) {
+        write<uint8_t>(out, 3);
+        write<double>(out, t);
+    }
+
+    void operator()(const std::string& t) {
+        write<uint8_t>(out, 4);
+        write(out, t);
+    }
+
+    void operator()(const std::vector<mbgl::Value>& array) {
+        write<uint8_t>(out, 5);
+        write<uint32_t>(out, array.size());
+        for (const auto& value : array) {
+            Value::visit(value, *this);
+        }
+    }
+
+    void operator()(const std::unordered_map<std::string, mbgl::Value>& map) {
+        write<uint8_t>(out, 6);
+        write<uint32_t>(out, map.size());
+        for (const auto& property : map) {
+            write(out, property.first);
+            Value::visit(property.second, *this);
+        }
+    }
+};
+
+} // namespace
+
+std::string encodeFeatures(const std::vector<Feature>& features) {
+    std::string out;
+    write<uint32_t>(out, features.size());
+    for (const auto& feature : features) {
+        writeSized(out, [&] { EncodeCoordinatesOrGeometries<double> { out }(feature.geometry); });
+        writeSized(out, [&] { EncodeValue { out }(feature.properties); });
+        if (feature.id) {
+            FeatureIdentifier::visit(*feature.id, EncodeValue { out });
+        } else {
+            EncodeValue { out }(mbgl::NullValue());
+        }
+    }
+    return out;
+}
+
 } // namespace node_mbgl
@@ -8,6 +8,9 @@
 #include <nan.h>
 #pragma GCC diagnostic pop
 
+#include <string>
+#include <vector>
+
 namespace node_mbgl {
 
 v8::Local<v8::Value> toJS(const mbgl::Value&);
@@ -15,4 +18,18 @@ v8::Local<v8::Object> toJS(const mbgl::Feature&);
 v8::Local<v8::Object> toJS(const mbgl::Feature::geometry_type&);
 v8::Local<v8::Object> toJS(const mbgl::PropertyMap&);
 
+// Encodes features into a single buffer, which `decodeFeatures()` in index.js reads back. Numbers
+// are little-endian and strings UTF-8 prefixed by their uint32 byte length. The buffer holds a
+// uint32 feature count, then, for each feature, its geometry and its properties, each prefixed by
+// its uint32 byte length so that either can be skipped, and its identifier.
+//
+// A geometry is a uint8 type, in the order of the GeoJSON types from 0 for Point to 6 for
+// GeometryCollection, then its coordinates: a pair of doubles for a point, and a uint32 count of
+// the points, rings, polygons or geometries of the others, followed by those.
+//
+// A value is a uint8 tag, from 0 to 6 for null, false, true, a double, a string, an array of a
+// uint32 count of values, and an object of a uint32 count of string keys each followed by a value.
+// Properties are encoded as an object, and features without identifier have a null one.
+std::string encodeFeatures(const std::vector<mbgl::Feature>&);
+
 }
@@ -15,6 +15,8 @@
 #include <mbgl/map/map_observer.hpp>
 #include <mbgl/util/premultiply.hpp>
 
+#include <algorithm>
+#include <thread>
 #include <unistd.h>
 
 namespace node_mbgl {
@@ -26,10 +28,28 @@ struct NodeMap::RenderOptions {
     double latitude = 0;
     double longitude = 0;
     mbgl::Size size = { 512, 512 };
+    uint32_t metatile = 1;
+    std::vector<float> ratios;
+    double timeout = 0;
+    std::string format = "raw";
+    int compressionLevel = -1;
     std::vector<std::string> classes;
     mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
 };
 
+struct NodeMap::RenderRequest {
+    RenderOptions options;
+    std::unique_ptr<Nan::Callback> callback;
+    std::exception_ptr error;
+    bool started = false;
+    bool rendered = false;
+    // Whether the still image was also rendered at the further pixel ratios.
+    bool rerendered = false;
+    // The number of images started to be read back.
+    std::size_t readbacks = 0;
+    mbgl::MissingTiles missingTiles;
+};
+
 Nan::Persistent<v8::Function> NodeMap::constructor;
 
 static const char* releasedMessage() {
@@ -67,6 +87,7 @@ void NodeMap::Init(v8::Local<v8::Object> target) {
 
     Nan::SetPrototypeMethod(tpl, "dumpDebugLogs", DumpDebugLogs);
     Nan::SetPrototypeMethod(tpl, "queryRenderedFeatures", QueryRenderedFeatures);
+    Nan::SetPrototypeMethod(tpl, "queryRenderedFeaturesBatch", QueryRenderedFeaturesBatch);
 
     constructor.Reset(tpl->GetFunction());
     Nan::Set(target, Nan::New("Map").ToLocalChecked(), tpl->GetFunction());
@@ -103,6 +124,11 @@ void NodeMap::Init(v8::Local<v8::Object> target) {
  * over the internet
  * @param {Function} [options.cancel]
  * @param {number} options.ratio pixel ratio
+ * @param {string} [options.threadPool='libuv'] where tiles are parsed and laid out: `libuv` runs
+ * the work on the libuv thread pool, `mbgl` and `workStealing` on threads of their own, which
+ * maps using the same kind and number of threads share
+ * @param {number} [options.threads] the number of threads of `mbgl` and `workStealing` thread
+ * pools, by default the number of cores
  * @example
  * var map = new mbgl.Map({ request: function() {} });
  * map.load(require('./test/fixtures/style.json'));
@@ -139,6 +165,16 @@ void NodeMap::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Options object 'ratio' property must be a number");
     }
 
+    if (Nan::Has(options, Nan::New("threadPool").ToLocalChecked()).FromJust()
+     && !Nan::Get(options, Nan::New("threadPool").ToLocalChecked()).ToLocalChecked()->IsString()) {
+        return Nan::ThrowError("Options object 'threadPool' property must be a string");
+    }
+
+    if (Nan::Has(options, Nan::New("threads").ToLocalChecked()).FromJust()
+     && !(Nan::Get(options, Nan::New("threads").ToLocalChecked()).ToLocalChecked()->IntegerValue() > 0)) {
+        return Nan::ThrowError("Options object 'threads' property must be a positive number");
+    }
+
     info.This()->SetInternalField(1, options);
 
     try {
@@ -261,6 +297,32 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
         options.size.height = Nan::Get(obj, Nan::New("height").ToLocalChecked()).ToLocalChecked()->IntegerValue();
     }
 
+    if (Nan::Has(obj, Nan::New("metatile").ToLocalChecked()).FromJust()) {
+        options.metatile = std::max<int64_t>(1, Nan::Get(obj, Nan::New("metatile").ToLocalChecked()).ToLocalChecked()->IntegerValue());
+    }
+
+    if (Nan::Has(obj, Nan::New("ratios").ToLocalChecked()).FromJust()) {
+        auto ratiosObj = Nan::Get(obj, Nan::New("ratios").ToLocalChecked()).ToLocalChecked();
+        if (ratiosObj->IsArray()) {
+            auto ratios = ratiosObj.As<v8::Array>();
+            for (uint32_t i = 0; i < ratios->Length(); i++) {
+                options.ratios.push_back(Nan::Get(ratios, i).ToLocalChecked()->NumberValue());
+            }
+        }
+    }
+
+    if (Nan::Has(obj, Nan::New("timeout").ToLocalChecked()).FromJust()) {
+        options.timeout = Nan::Get(obj, Nan::New("timeout").ToLocalChecked()).ToLocalChecked()->NumberValue();
+    }
+
+    if (Nan::Has(obj, Nan::New("format").ToLocalChecked()).FromJust()) {
+        options.format = *Nan::Utf8String(Nan::Get(obj, Nan::New("format").ToLocalChecked()).ToLocalChecked());
+    }
+
+    if (Nan::Has(obj, Nan::New("compressionLevel").ToLocalChecked()).FromJust()) {
+        options.compressionLevel = std::min<int64_t>(9, std::max<int64_t>(-1, Nan::Get(obj, Nan::New("compressionLevel").ToLocalChecked()).ToLocalChecked()->IntegerValue()));
+    }
+
     if (Nan::Has(obj, Nan::New("classes").ToLocalChecked()).FromJust()) {
         auto classes = Nan::To<v8::Object>(Nan::Get(obj, Nan::New("classes").ToLocalChecked()).ToLocalChecked()).ToLocalChecked().As<v8::Array>();
         const int length = classes->Length();
@@ -314,9 +376,23 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
  * of the map
  * @param {number} [options.bearing=0] rotation
  * @param {Array<string>} [options.classes=[]] style classes
+ * @param {number} [options.metatile=1] renders a block of `metatile`×`metatile` images of the
+ * given size around the center at once, sharing layout and label placement between them. The
+ * callback then receives an array of the images, in row-major order.
+ * @param {Array<number>} [options.ratios] renders images at each of these pixel ratios rather than
+ * the map's, sharing tiles and layout between them. The callback then receives an array of the
+ * results, one for each ratio.
+ * @param {number} [options.timeout] renders with whatever has loaded after this many milliseconds,
+ * rather than waiting for all tiles. The callback then receives the tiles that were missing as a
+ * third argument, an array of `{ source, z, x, y }` objects.
+ * @param {string} [options.format='raw'] either `raw`, for premultiplied RGBA pixels, or `png`.
+ * PNGs are encoded on the thread pool.
+ * @param {number} [options.compressionLevel=-1] the zlib compression level of PNGs, from 0 to 9,
+ * or -1 for the default level
  * @param {Function} callback
  * @returns {undefined} calls callback
- * @throws {Error} if stylesheet is not loaded or if map is already rendering
+ * @throws {Error} if stylesheet is not loaded. Calls made while the map is rendering are queued,
+ * and their callbacks are called in order.
  */
 void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
@@ -334,28 +410,42 @@ void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowTypeError("Style is not loaded");
     }
 
-    if (nodeMap->callback) {
-        return Nan::ThrowError("Map is currently rendering an image");
+    auto request = std::make_unique<RenderRequest>();
+    request->options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    if (std::any_of(request->options.ratios.begin(), request->options.ratios.end(),
+                    [] (float ratio) { return !(ratio > 0); })) {
+        return Nan::ThrowTypeError("Options object 'ratios' property must contain positive numbers");
+    }
+    if (request->options.format != "raw" && request->options.format != "png") {
+        return Nan::ThrowTypeError("Options object 'format' property must be 'raw' or 'png'");
     }
+    request->callback = std::make_unique<Nan::Callback>(info[1].As<v8::Function>());
 
-    auto options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    nodeMap->renders.push_back(std::move(request));
 
-    assert(!nodeMap->callback);
-    assert(!nodeMap->image.data);
-    nodeMap->callback = std::make_unique<Nan::Callback>(info[1].As<v8::Function>());
+    // Retain this object, otherwise it might get destructed before we are finished rendering the
+    // still image.
+    nodeMap->Ref();
 
-    try {
-        nodeMap->startRender(std::move(options));
-    } catch (mbgl::util::Exception &ex) {
-        return Nan::ThrowError(ex.what());
-    }
+    // Similarly, we're now waiting for the async to be called, so we need to make sure that it
+    // keeps the loop alive.
+    uv_ref(reinterpret_cast<uv_handle_t *>(nodeMap->async));
+
+    // Calls made while the map is rendering start once it has rendered, while the previous image
+    // is being read back.
+    nodeMap->startNextRender();
 
     info.GetReturnValue().SetUndefined();
 }
 
-void NodeMap::startRender(NodeMap::RenderOptions options) {
-    frontend->setSize(options.size);
-    map->setSize(options.size);
+void NodeMap::startRender(RenderRequest& request) {
+    request.started = true;
+
+    const RenderOptions& options = request.options;
+    const mbgl::Size size { options.size.width * options.metatile, options.size.height * options.metatile };
+    frontend->setSize(size);
+    map->setSize(size);
+    frontend->setRenderPixelRatio(options.ratios.empty() ? pixelRatio : options.ratios.front());
 
     if (map->getZoom() != options.zoom) {
         map->setZoom(options.zoom);
@@ -378,84 +468,284 @@ void NodeMap::startRender(NodeMap::RenderOptions options) {
         map->setDebug(options.debugOptions);
     }
 
-    map->renderStill([this](const std::exception_ptr eptr) {
+    const mbgl::Duration timeout = options.timeout > 0
+        ? std::chrono::duration_cast<mbgl::Duration>(std::chrono::duration<double, std::milli>(options.timeout))
+        : mbgl::Duration::max();
+    map->renderStill(timeout, [this, &request](const std::exception_ptr eptr, mbgl::MissingTiles missingTiles) {
+        request.missingTiles = std::move(missingTiles);
         if (eptr) {
-            error = std::move(eptr);
-            uv_async_send(async);
+            request.error = std::move(eptr);
         } else {
-            assert(!image.data);
-            image = frontend->readStillImage();
-            uv_async_send(async);
+            // The image is read back in renderFinished(), after the next render has started
+            // loading its tiles.
+            frontend->startReadStillImage();
+            request.readbacks = 1;
         }
+        request.rendered = true;
+        request.rerendered = request.error || request.options.ratios.size() <= 1;
+        uv_async_send(async);
     });
+}
 
-    // Retain this object, otherwise it might get destructed before we are finished rendering the
-    // still image.
-    Ref();
+void NodeMap::startNextRender() {
+    // Renders at further pixel ratios reuse the parameters of the still image, so the next render
+    // waits for them.
+    if (std::any_of(renders.begin(), renders.end(),
+                    [] (const auto& render) { return render->rendered && !render->rerendered; })) {
+        return;
+    }
 
-    // Similarly, we're now waiting for the async to be called, so we need to make sure that it
-    // keeps the loop alive.
-    uv_ref(reinterpret_cast<uv_handle_t *>(async));
-}
+    auto next = std::find_if(renders.begin(), renders.end(),
+                             [] (const auto& render) { return !render->rendered; });
+    if (next == renders.end() || (*next)->started) {
+        return;
+    }
 
-void NodeMap::renderFinished() {
-    Nan::HandleScope scope;
+    try {
+        startRender(**next);
+    } catch (const std::exception&) {
+        (*next)->error = std::current_exception();
+        (*next)->rendered = true;
+        (*next)->rerendered = true;
+        uv_async_send(async);
+        startNextRender();
+    }
+}
 
-    // We're done with this render call, so we're unrefing so that the loop could close.
-    uv_unref(reinterpret_cast<uv_handle_t *>(async));
+// Hands the pixels over to a node buffer, without copying them.
+static v8::Local<v8::Object> toBuffer(mbgl::PremultipliedImage&& img) {
+    v8::Local<v8::Object> pixels = Nan::NewBuffer(
+        reinterpret_cast<char *>(img.data.get()), img.bytes(),
+        // Retain the data until the buffer is deleted.
+        [](char *, void * hint) {
+            delete [] reinterpret_cast<uint8_t*>(hint);
+        },
+        img.data.get()
+    ).ToLocalChecked();
+    img.data.release();
+    return pixels;
+}
 
-    // There is no render pending anymore, we the GC could now delete this object if it went out
-    // of scope.
-    Unref();
+// Likewise for encoded images.
+static v8::Local<v8::Object> toBuffer(std::string&& data) {
+    auto retained = new std::string(std::move(data));
+    return Nan::NewBuffer(
+        &(*retained)[0], retained->size(),
+        // Retain the data until the buffer is deleted.
+        [](char *, void * hint) {
+            delete reinterpret_cast<std::string*>(hint);
+        },
+        retained
+    ).ToLocalChecked();
+}
 
-    // Move the callback and image out of the way so that the callback can start a new render call.
-    auto cb = std::move(callback);
-    auto img = std::move(image);
-    assert(cb);
+static v8::Local<v8::Array> toJS(const mbgl::MissingTiles& tiles) {
+    auto array = Nan::New<v8::Array>();
+    for (uint32_t i = 0; i < tiles.size(); i++) {
+        auto tile = Nan::New<v8::Object>();
+        Nan::Set(tile, Nan::New("source").ToLocalChecked(), Nan::New(tiles[i].sourceID).ToLocalChecked());
+        Nan::Set(tile, Nan::New("z").ToLocalChecked(), Nan::New<v8::Uint32>(tiles[i].z));
+        Nan::Set(tile, Nan::New("x").ToLocalChecked(), Nan::New<v8::Uint32>(tiles[i].x));
+        Nan::Set(tile, Nan::New("y").ToLocalChecked(), Nan::New<v8::Uint32>(tiles[i].y));
+        array->Set(i, tile);
+    }
+    return array;
+}
 
-    // These have to be empty to be prepared for the next render call.
-    assert(!callback);
-    assert(!image.data);
+// The result of a render call: the images of each pixel ratio, each a buffer or, for metatiles,
+// an array of buffers. Only calls with several pixel ratios receive an array of those.
+template <class T>
+static v8::Local<v8::Value> toResult(std::vector<std::vector<T>>&& images, bool metatiled, bool perRatio) {
+    auto toImage = [&] (std::vector<T>& tiles) -> v8::Local<v8::Value> {
+        if (!metatiled) {
+            return toBuffer(std::move(tiles.front()));
+        }
+        auto array = Nan::New<v8::Array>();
+        for (uint32_t i = 0; i < tiles.size(); i++) {
+            array->Set(i, toBuffer(std::move(tiles[i])));
+        }
+        return array;
+    };
 
-    if (error) {
-        std::string errorMessage;
+    if (!perRatio) {
+        return toImage(images.front());
+    }
+    auto array = Nan::New<v8::Array>();
+    for (uint32_t i = 0; i < images.size(); i++) {
+        array->Set(i, toImage(images[i]));
+    }
+    return array;
+}
 
+// Splits and encodes rendered images on the thread pool, and hands the encoded images over to node
+// buffers without copying them.
+class EncodeWorker : public Nan::AsyncWorker {
+public:
+    EncodeWorker(Nan::Callback* callback_, std::vector<mbgl::PremultipliedImage>&& images_,
+                 uint32_t metatile_, bool perRatio_, int compressionLevel_,
+                 mbgl::optional<mbgl::MissingTiles> missingTiles_)
+        : AsyncWorker(callback_),
+          images(std::move(images_)),
+          metatile(metatile_),
+          perRatio(perRatio_),
+          compressionLevel(compressionLevel_),
+          missingTiles(std::move(missingTiles_)) {
+    }
+
+    void Execute() override {
         try {
-            std::rethrow_exception(error);
+            for (const auto& image : images) {
+                encoded.emplace_back();
+                if (metatile > 1) {
+                    for (const auto& tile : mbgl::HeadlessFrontend::splitImage(image, metatile)) {
+                        encoded.back().push_back(mbgl::encodePNG(tile, compressionLevel));
+                    }
+                } else {
+                    encoded.back().push_back(mbgl::encodePNG(image, compressionLevel));
+                }
+            }
+            images.clear();
         } catch (const std::exception& ex) {
-            errorMessage = ex.what();
+            SetErrorMessage(ex.what());
         }
+    }
 
-        v8::Local<v8::Value> argv[] = {
-            Nan::Error(errorMessage.c_str())
-        };
-
-        // This must be empty to be prepared for the next render call.
-        error = nullptr;
-        assert(!error);
-
-        cb->Call(1, argv);
-    } else if (img.data) {
-        v8::Local<v8::Object> pixels = Nan::NewBuffer(
-            reinterpret_cast<char *>(img.data.get()), img.bytes(),
-            // Retain the data until the buffer is deleted.
-            [](char *, void * hint) {
-                delete [] reinterpret_cast<uint8_t*>(hint);
-            },
-            img.data.get()
-        ).ToLocalChecked();
-        img.data.release();
+    void HandleOKCallback() override {
+        Nan::HandleScope scope;
 
         v8::Local<v8::Value> argv[] = {
             Nan::Null(),
-            pixels
-        };
-        cb->Call(2, argv);
-    } else {
-        v8::Local<v8::Value> argv[] = {
-            Nan::Error("Didn't get an image")
+            toResult(std::move(encoded), metatile > 1, perRatio),
+            missingTiles ? v8::Local<v8::Value>(toJS(*missingTiles)) : v8::Local<v8::Value>(Nan::Undefined())
         };
-        cb->Call(1, argv);
+        callback->Call(missingTiles ? 3 : 2, argv);
+    }
+
+private:
+    std::vector<mbgl::PremultipliedImage> images;
+    const uint32_t metatile;
+    const bool perRatio;
+    const int compressionLevel;
+    const mbgl::optional<mbgl::MissingTiles> missingTiles;
+    std::vector<std::vector<std::string>> encoded;
+};
+
+void NodeMap::renderFinished() {
+    Nan::HandleScope scope;
+
+    // Render the finished still image at its further pixel ratios, before the map moves on.
+    for (auto& request : renders) {
+        if (!request->rendered || request->rerendered) {
+            continue;
+        }
+        try {
+            for (std::size_t i = 1; i < request->options.ratios.size(); i++) {
+                frontend->rerenderStillImage(request->options.ratios[i]);
+                request->readbacks++;
+            }
+        } catch (const std::exception&) {
+            request->error = std::current_exception();
+        }
+        request->rerendered = true;
+    }
+
+    // Keep the map busy while the finished images are read back and delivered.
+    startNextRender();
+
+    // Deliver the renders that are done, in order. Each is removed from the queue before its
+    // callback is called, so that the callback can start a new render call.
+    std::size_t delivered = 0;
+    while (!renders.empty() && renders.front()->rendered) {
+        std::unique_ptr<RenderRequest> request = std::move(renders.front());
+        renders.pop_front();
+        delivered++;
+
+        // Images are read back in the order they were rendered, so all of them are read, even
+        // those of failed renders.
+        std::vector<mbgl::PremultipliedImage> images;
+        for (std::size_t i = 0; i < request->readbacks; i++) {
+            try {
+                images.push_back(frontend->readStillImage());
+                if (!images.back().data && !request->error) {
+                    throw std::runtime_error("Didn't get an image");
+                }
+            } catch (const std::exception&) {
+                if (!request->error) {
+                    request->error = std::current_exception();
+                }
+            }
+        }
+
+        const RenderOptions& options = request->options;
+        const bool perRatio = !options.ratios.empty();
+
+        if (!request->error && options.format == "png") {
+            // The callback is called once the images are encoded, possibly after those of later
+            // render calls.
+            mbgl::optional<mbgl::MissingTiles> missingTiles;
+            if (options.timeout > 0) {
+                missingTiles = std::move(request->missingTiles);
+            }
+            Nan::AsyncQueueWorker(new EncodeWorker(request->callback.release(), std::move(images),
+                                                   options.metatile, perRatio, options.compressionLevel,
+                                                   std::move(missingTiles)));
+            continue;
+        }
+
+        std::vector<std::vector<mbgl::PremultipliedImage>> result;
+        if (!request->error) {
+            try {
+                for (auto& image : images) {
+                    if (options.metatile > 1) {
+                        result.push_back(mbgl::HeadlessFrontend::splitImage(image, options.metatile));
+                    } else {
+                        result.emplace_back();
+                        result.back().push_back(std::move(image));
+                    }
+                }
+            } catch (const std::exception&) {
+                request->error = std::current_exception();
+            }
+        }
+
+        if (request->error) {
+            std::string errorMessage;
+
+            try {
+                std::rethrow_exception(request->error);
+            } catch (const std::exception& ex) {
+                errorMessage = ex.what();
+            }
+
+            v8::Local<v8::Value> argv[] = {
+                Nan::Error(errorMessage.c_str())
+            };
+            request->callback->Call(1, argv);
+        } else if (options.timeout > 0) {
+            v8::Local<v8::Value> argv[] = {
+                Nan::Null(),
+                toResult(std::move(result), options.metatile > 1, perRatio),
+                toJS(request->missingTiles)
+            };
+            request->callback->Call(3, argv);
+        } else {
+            v8::Local<v8::Value> argv[] = {
+                Nan::Null(),
+                toResult(std::move(result), options.metatile > 1, perRatio)
+            };
+            request->callback->Call(2, argv);
+        }
+    }
+
+    // We're done with all render calls, so we're unrefing so that the loop could close.
+    if (renders.empty()) {
+        uv_unref(reinterpret_cast<uv_handle_t *>(async));
+    }
+
+    // There are no renders pending for these calls anymore, so the GC could now delete this
+    // object if it went out of scope.
+    for (std::size_t i = 0; i < delivered; i++) {
+        Unref();
     }
 }
 
@@ -488,8 +778,8 @@ void NodeMap::release() {
 }
 
 /**
- * Cancel an ongoing render request. The callback will be called with
- * the error set to "Canceled". Will throw if no rendering is in progress.
+ * Cancel the ongoing and queued render requests. Their callbacks will be called
+ * with the error set to "Canceled". Will throw if no rendering is in progress.
  * @name cancel
  * @returns {undefined}
  */
@@ -497,7 +787,7 @@ void NodeMap::Cancel(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
 
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
-    if (!nodeMap->callback) return Nan::ThrowError("No render in progress");
+    if (nodeMap->renders.empty()) return Nan::ThrowError("No render in progress");
 
     try {
         nodeMap->cancel();
@@ -514,16 +804,22 @@ void NodeMap::cancel() {
     // Reset map explicitly as it resets the renderer frontend
     map.reset();
 
-    frontend = std::make_unique<mbgl::HeadlessFrontend>(mbgl::Size{ 256, 256 }, pixelRatio, *this, threadpool);
+    frontend = std::make_unique<mbgl::HeadlessFrontend>(mbgl::Size{ 256, 256 }, pixelRatio, *this, *threadpool);
     map = std::make_unique<mbgl::Map>(*frontend, mapObserver, frontend->getSize(), pixelRatio,
-                                      *this, threadpool, mbgl::MapMode::Still);
+                                      *this, *threadpool, mbgl::MapMode::Still);
 
     // FIXME: Reload the style after recreating the map. We need to find
     // a better way of canceling an ongoing rendering on the core level
     // without resetting the map, which is way too expensive.
     map->getStyle().loadJSON(style);
 
-    error = std::make_exception_ptr(std::runtime_error("Canceled"));
+    // The images that were being read back went away with the frontend.
+    for (auto& request : renders) {
+        request->error = std::make_exception_ptr(std::runtime_error("Canceled"));
+        request->rendered = true;
+        request->rerendered = true;
+        request->readbacks = 0;
+    }
     renderFinished();
 }
 
@@ -875,10 +1171,129 @@ void NodeMap::DumpDebugLogs(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     info.GetReturnValue().SetUndefined();
 }
 
-void NodeMap::QueryRenderedFeatures(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+// Converts a point `[x, y]` or a box `[[x1, y1], [x2, y2]]`, as accepted by the query methods.
+static mbgl::optional<mbgl::ScreenLineString> toQueryGeometry(v8::Local<v8::Value> value, std::string& error) {
+    if (!value->IsArray()) {
+        error = "Query geometry must be an array";
+        return {};
+    }
+
+    auto posOrBox = value.As<v8::Array>();
+    if (posOrBox->Length() != 2) {
+        error = "Query geometry must have two components";
+        return {};
+    }
+
+    if (Nan::Get(posOrBox, 0).ToLocalChecked()->IsArray()) {
+        auto pos0 = Nan::Get(posOrBox, 0).ToLocalChecked().As<v8::Array>();
+        auto pos1 = Nan::Get(posOrBox, 1).ToLocalChecked().As<v8::Array>();
+
+        const mbgl::ScreenBox box {
+            {
+                Nan::Get(pos0, 0).ToLocalChecked()->NumberValue(),
+                Nan::Get(pos0, 1).ToLocalChecked()->NumberValue()
+            }, {
+                Nan::Get(pos1, 0).ToLocalChecked()->NumberValue(),
+                Nan::Get(pos1, 1).ToLocalChecked()->NumberValue()
+            }
+        };
+        return mbgl::ScreenLineString {
+            box.min,
+            { box.max.x, box.min.y },
+            box.max,
+            { box.min.x, box.max.y },
+            box.min
+        };
+    }
+
+    return mbgl::ScreenLineString { mbgl::ScreenCoordinate {
+        Nan::Get(posOrBox, 0).ToLocalChecked()->NumberValue(),
+        Nan::Get(posOrBox, 1).ToLocalChecked()->NumberValue()
+    } };
+}
+
+static mbgl::optional<mbgl::RenderedQueryOptions> toQueryOptions(v8::Local<v8::Value> value, std::string& error) {
     using namespace mbgl::style;
     using namespace mbgl::style::conversion;
 
+    mbgl::RenderedQueryOptions queryOptions;
+    if (value->IsNull() || value->IsUndefined()) {
+        return queryOptions;
+    }
+
+    if (!value->IsObject()) {
+        error = "options argument must be an object";
+        return {};
+    }
+
+    auto options = Nan::To<v8::Object>(value).ToLocalChecked();
+
+    //Check if layers is set. If provided, it must be an array of strings
+    if (Nan::Has(options, Nan::New("layers").ToLocalChecked()).FromJust()) {
+        auto layersOption = Nan::Get(options, Nan::New("layers").ToLocalChecked()).ToLocalChecked();
+        if (!layersOption->IsArray()) {
+            error = "Requires options.layers property to be an array";
+            return {};
+        }
+        auto layers = layersOption.As<v8::Array>();
+        std::vector<std::string> layersVec;
+        for (uint32_t i=0; i < layers->Length(); i++) {
+            layersVec.emplace_back(*Nan::Utf8String(Nan::Get(layers,i).ToLocalChecked()));
+        }
+        queryOptions.layerIDs = layersVec;
+    }
+
+    //Check if filter is provided. If set it must be a valid Filter object
+    if (Nan::Has(options, Nan::New("filter").ToLocalChecked()).FromJust()) {
+        auto filterOption = Nan::Get(options, Nan::New("filter").ToLocalChecked()).ToLocalChecked();
+        Error conversionError;
+        mbgl::optional<Filter> converted = convert<Filter>(filterOption, conversionError);
+        if (!converted) {
+            error = conversionError.message;
+            return {};
+        }
+        queryOptions.filter = std::move(*converted);
+    }
+
+    return queryOptions;
+}
+
+static v8::Local<v8::Array> toJS(const std::vector<mbgl::Feature>& features) {
+    auto array = Nan::New<v8::Array>();
+    for (unsigned int i = 0; i < features.size(); i++) {
+        array->Set(i, toJS(features[i]));
+    }
+    return array;
+}
+
+// Query results are objects by default, and with `format: 'buffer'` a buffer of encoded features,
+// which is much faster to create for many features, and which `decodeFeatures()` reads back.
+static mbgl::optional<bool> toBinaryFormat(v8::Local<v8::Value> value, std::string& error) {
+    if (!value->IsObject()) {
+        return false;
+    }
+
+    auto options = Nan::To<v8::Object>(value).ToLocalChecked();
+    if (!Nan::Has(options, Nan::New("format").ToLocalChecked()).FromJust()) {
+        return false;
+    }
+
+    const std::string format = *Nan::Utf8String(Nan::Get(options, Nan::New("format").ToLocalChecked()).ToLocalChecked());
+    if (format != "objects" && format != "buffer") {
+        error = "Requires options.format property to be 'objects' or 'buffer'";
+        return {};
+    }
+    return format == "buffer";
+}
+
+static v8::Local<v8::Value> toJS(const std::vector<mbgl::Feature>& features, bool binary) {
+    if (binary) {
+        return toBuffer(encodeFeatures(features));
+    }
+    return toJS(features);
+}
+
+void NodeMap::QueryRenderedFeatures(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
 
@@ -886,73 +1301,66 @@ void NodeMap::QueryRenderedFeatures(const Nan::FunctionCallbackInfo<v8::Value>&
         return Nan::ThrowTypeError("First argument must be an array");
     }
 
-    auto posOrBox = info[0].As<v8::Array>();
-    if (posOrBox->Length() != 2) {
+    std::string error;
+    auto geometry = toQueryGeometry(info[0], error);
+    if (!geometry) {
         return Nan::ThrowTypeError("First argument must have two components");
     }
 
-    mbgl::RenderedQueryOptions queryOptions;
-    if (!info[1]->IsNull() && !info[1]->IsUndefined()) {
-        if (!info[1]->IsObject()) {
-            return Nan::ThrowTypeError("options argument must be an object");
-        }
-        
-        auto options = Nan::To<v8::Object>(info[1]).ToLocalChecked();
-        
-        //Check if layers is set. If provided, it must be an array of strings
-        if (Nan::Has(options, Nan::New("layers").ToLocalChecked()).FromJust()) {
-            auto layersOption = Nan::Get(options, Nan::New("layers").ToLocalChecked()).ToLocalChecked();
-            if (!layersOption->IsArray()) {
-                return Nan::ThrowTypeError("Requires options.layers property to be an array");
-            }
-            auto layers = layersOption.As<v8::Array>();
-            std::vector<std::string> layersVec;
-            for (uint32_t i=0; i < layers->Length(); i++) {
-                layersVec.emplace_back(*Nan::Utf8String(Nan::Get(layers,i).ToLocalChecked()));
-            }
-            queryOptions.layerIDs = layersVec;
-        }
-        
-        //Check if filter is provided. If set it must be a valid Filter object
-        if (Nan::Has(options, Nan::New("filter").ToLocalChecked()).FromJust()) {
-            auto filterOption = Nan::Get(options, Nan::New("filter").ToLocalChecked()).ToLocalChecked();
-            Error error;
-            mbgl::optional<Filter> converted = convert<Filter>(filterOption, error);
-            if (!converted) {
-                return Nan::ThrowTypeError(error.message.c_str());
-            }
-            queryOptions.filter = std::move(*converted);
-        }
+    auto queryOptions = toQueryOptions(info[1], error);
+    if (!queryOptions) {
+        return Nan::ThrowTypeError(error.c_str());
     }
 
-    try {
-        std::vector<mbgl::Feature> optional;
+    auto binary = toBinaryFormat(info[1], error);
+    if (!binary) {
+        return Nan::ThrowTypeError(error.c_str());
+    }
 
-        if (Nan::Get(posOrBox, 0).ToLocalChecked()->IsArray()) {
+    try {
+        info.GetReturnValue().Set(toJS(nodeMap->frontend->getRenderer()->queryRenderedFeatures(*geometry, *queryOptions), *binary));
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+}
 
-            auto pos0 = Nan::Get(posOrBox, 0).ToLocalChecked().As<v8::Array>();
-            auto pos1 = Nan::Get(posOrBox, 1).ToLocalChecked().As<v8::Array>();
+// Takes an array of points and boxes in the form queryRenderedFeatures accepts, and returns an
+// array with the features of each of them.
+void NodeMap::QueryRenderedFeaturesBatch(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
+    if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
 
-            optional = nodeMap->frontend->getRenderer()->queryRenderedFeatures(mbgl::ScreenBox {
-                {
-                    Nan::Get(pos0, 0).ToLocalChecked()->NumberValue(),
-                    Nan::Get(pos0, 1).ToLocalChecked()->NumberValue()
-                }, {
-                    Nan::Get(pos1, 0).ToLocalChecked()->NumberValue(),
-                    Nan::Get(pos1, 1).ToLocalChecked()->NumberValue()
-                }
-            },  queryOptions);
+    if (info.Length() <= 0 || !info[0]->IsArray()) {
+        return Nan::ThrowTypeError("First argument must be an array");
+    }
 
-        } else {
-            optional = nodeMap->frontend->getRenderer()->queryRenderedFeatures(mbgl::ScreenCoordinate {
-                Nan::Get(posOrBox, 0).ToLocalChecked()->NumberValue(),
-                Nan::Get(posOrBox, 1).ToLocalChecked()->NumberValue()
-            }, queryOptions);
+    std::string error;
+    auto queries = info[0].As<v8::Array>();
+    std::vector<mbgl::ScreenLineString> geometries;
+    geometries.reserve(queries->Length());
+    for (uint32_t i = 0; i < queries->Length(); i++) {
+        auto geometry = toQueryGeometry(Nan::Get(queries, i).ToLocalChecked(), error);
+        if (!geometry) {
+            return Nan::ThrowTypeError(error.c_str());
         }
+        geometries.push_back(std::move(*geometry));
+    }
+
+    auto queryOptions = toQueryOptions(info[1], error);
+    if (!queryOptions) {
+        return Nan::ThrowTypeError(error.c_str());
+    }
 
+    auto binary = toBinaryFormat(info[1], error);
+    if (!binary) {
+        return Nan::ThrowTypeError(error.c_str());
+    }
+
+    try {
+        auto results = nodeMap->frontend->getRenderer()->queryRenderedFeatures(geometries, *queryOptions);
         auto array = Nan::New<v8::Array>();
-        for (unsigned int i = 0; i < optional.size(); i++) {
-            array->Set(i, toJS(optional[i]));
+        for (unsigned int i = 0; i < results.size(); i++) {
+            array->Set(i, toJS(results[i], *binary));
         }
         info.GetReturnValue().Set(array);
     } catch (const std::exception &ex) {
@@ -969,14 +1377,24 @@ NodeMap::NodeMap(v8::Local<v8::Object> options)
                            ->NumberValue()
                      : 1.0;
       }())
+    , threadpool([&] {
+          Nan::HandleScope scope;
+          const std::string kind = Nan::Has(options, Nan::New("threadPool").ToLocalChecked()).FromJust()
+              ? *Nan::Utf8String(Nan::Get(options, Nan::New("threadPool").ToLocalChecked()).ToLocalChecked())
+              : "libuv";
+          const std::size_t threads = Nan::Has(options, Nan::New("threads").ToLocalChecked()).FromJust()
+              ? Nan::Get(options, Nan::New("threads").ToLocalChecked()).ToLocalChecked()->IntegerValue()
+              : std::max(1u, std::thread::hardware_concurrency());
+          return sharedScheduler(kind, threads);
+      }())
     , mapObserver(NodeMapObserver())
-    , frontend(std::make_unique<mbgl::HeadlessFrontend>(mbgl::Size { 256, 256 }, pixelRatio, *this, threadpool))
+    , frontend(std::make_unique<mbgl::HeadlessFrontend>(mbgl::Size { 256, 256 }, pixelRatio, *this, *threadpool))
     , map(std::make_unique<mbgl::Map>(*frontend,
                                       mapObserver,
                                       frontend->getSize(),
                                       pixelRatio,
                                       *this,
-                                      threadpool,
+                                      *threadpool,
                                       mbgl::MapMode::Still)),
       async(new uv_async_t) {
 
@@ -6,6 +6,7 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/util/image.hpp>
 
+#include <deque>
 #include <exception>
 
 #pragma GCC diagnostic push
@@ -29,6 +30,7 @@ class NodeMap : public Nan::ObjectWrap,
                 public mbgl::FileSource {
 public:
     struct RenderOptions;
+    struct RenderRequest;
     class RenderWorker;
 
     NodeMap(v8::Local<v8::Object>);
@@ -58,8 +60,10 @@ public:
     static void SetPitch(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void DumpDebugLogs(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void QueryRenderedFeatures(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void QueryRenderedFeaturesBatch(const Nan::FunctionCallbackInfo<v8::Value>&);
 
-    void startRender(RenderOptions options);
+    void startRender(RenderRequest&);
+    void startNextRender();
     void renderFinished();
 
     void release();
@@ -70,14 +74,14 @@ public:
     std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource&, mbgl::FileSource::Callback);
 
     const float pixelRatio;
-    NodeThreadPool threadpool;
+    std::shared_ptr<mbgl::Scheduler> threadpool;
     NodeMapObserver mapObserver;
     std::unique_ptr<mbgl::HeadlessFrontend> frontend;
     std::unique_ptr<mbgl::Map> map;
 
-    std::exception_ptr error;
-    mbgl::PremultipliedImage image;
-    std::unique_ptr<Nan::Callback> callback;
+    // Render calls whose callbacks haven't been called yet, in the order they were made. The
+    // first one that hasn't rendered is rendering; the ones before it are being read back.
+    std::deque<std::unique_ptr<RenderRequest>> renders;
 
     // Async for delivering the notifications of render completion.
     uv_async_t *async;
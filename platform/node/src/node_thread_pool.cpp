@@ -2,6 +2,12 @@
 #include "util/async_queue.hpp"
 
 #include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <map>
+#include <stdexcept>
+#include <utility>
 
 namespace node_mbgl {
 
@@ -34,4 +40,28 @@ void NodeThreadPool::Worker::WorkComplete() {
     // no-op to avoid calling nullptr callback
 }
 
+std::shared_ptr<mbgl::Scheduler> sharedScheduler(const std::string& kind, std::size_t threads) {
+    if (kind == "libuv") {
+        threads = 0;
+    } else if (kind != "mbgl" && kind != "workStealing") {
+        throw std::invalid_argument("Unknown thread pool '" + kind + "'");
+    }
+
+    // Only called on the main thread. Pools go away with the last map that uses them.
+    static std::map<std::pair<std::string, std::size_t>, std::weak_ptr<mbgl::Scheduler>> schedulers;
+    std::weak_ptr<mbgl::Scheduler>& shared = schedulers[{ kind, threads }];
+    std::shared_ptr<mbgl::Scheduler> scheduler = shared.lock();
+    if (!scheduler) {
+        if (kind == "libuv") {
+            scheduler = std::make_shared<NodeThreadPool>();
+        } else if (kind == "mbgl") {
+            scheduler = std::make_shared<mbgl::ThreadPool>(threads);
+        } else {
+            scheduler = std::make_shared<mbgl::WorkStealingThreadPool>(threads);
+        }
+        shared = scheduler;
+    }
+    return scheduler;
+}
+
 } // namespace node_mbgl
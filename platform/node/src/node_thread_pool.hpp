@@ -2,6 +2,9 @@
 
 #include <mbgl/actor/scheduler.hpp>
 
+#include <memory>
+#include <string>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wshadow"
@@ -34,4 +37,11 @@ private:
     };
 };
 
+// Returns the scheduler of the given kind, which is shared by all maps that use it:
+//  - "libuv" runs mailboxes on the libuv thread pool, which node shares with fs, dns and zlib work.
+//  - "mbgl" and "workStealing" run them on threads of their own, `threads` of them. Messages
+//    to the main thread still go through its run loop.
+// Throws if the kind is unknown.
+std::shared_ptr<mbgl::Scheduler> sharedScheduler(const std::string& kind, std::size_t threads);
+
 } // namespace node_mbgl
@@ -89,6 +89,39 @@ test('Map', function(t) {
         t.end();
     });
 
+    t.test('optional threadPool property must be a known thread pool', function(t) {
+        var options = {
+            request: function() {}
+        };
+
+        options.threadPool = 1;
+        t.throws(function() {
+            new mbgl.Map(options);
+        }, /Options object 'threadPool' property must be a string/);
+
+        options.threadPool = 'test';
+        t.throws(function() {
+            new mbgl.Map(options);
+        }, /Unknown thread pool 'test'/);
+
+        options.threadPool = 'mbgl';
+        options.threads = 0;
+        t.throws(function() {
+            new mbgl.Map(options);
+        }, /Options object 'threads' property must be a positive number/);
+
+        ['libuv', 'mbgl', 'workStealing'].forEach(function(threadPool) {
+            options.threadPool = threadPool;
+            options.threads = 2;
+            t.doesNotThrow(function() {
+                var map = new mbgl.Map(options);
+                map.release();
+            });
+        });
+
+        t.end();
+    });
+
     t.test('instanceof mbgl.Map', function(t) {
         var options = {
             request: function() {},
@@ -494,6 +527,18 @@ test('Map', function(t) {
             });
         });
 
+        t.test('renders on its own thread pool', function(t) {
+            var map = new mbgl.Map(Object.assign({ threadPool: 'workStealing', threads: 2 }, options));
+            map.load(style);
+            map.render({}, function(err, pixels) {
+                t.error(err);
+                map.release();
+                t.ok(pixels instanceof Buffer);
+                t.equal(pixels.length, 512 * 512 * 4);
+                t.end();
+            });
+        });
+
         t.test('can be called several times in serial', function(t) {
             var completed = 0;
             var remaining = 10;
@@ -519,17 +564,74 @@ test('Map', function(t) {
             render();
         });
 
-        t.test('throws if called in parallel', function(t) {
+        t.test('queues renders called in parallel', function(t) {
             var map = new mbgl.Map(options);
             map.load(style);
 
-            t.throws(function() {
-                map.render({}, function() {});
-                map.render({}, function() {});
-            }, /Map is currently rendering an image/);
+            var completed = [];
+            [0, 1, 2].forEach(function(i) {
+                map.render({ zoom: i }, function(err, pixels) {
+                    t.error(err);
+                    t.ok(pixels instanceof Buffer);
+                    completed.push(i);
+                    if (completed.length === 3) {
+                        t.deepEqual(completed, [0, 1, 2], 'calls back in order');
+                        map.release();
+                        t.end();
+                    }
+                });
+            });
+        });
 
-            map.release();
-            t.end();
+        t.test('renders at several pixel ratios', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ width: 64, height: 64, ratios: [1, 2] }, function(err, images) {
+                t.error(err);
+                t.ok(Array.isArray(images));
+                t.equal(images.length, 2);
+                t.equal(images[0].length, 64 * 64 * 4);
+                t.equal(images[1].length, 128 * 128 * 4);
+                map.release();
+                t.end();
+            });
+        });
+
+        t.test('renders what has loaded at the timeout', function(t) {
+            var map = new mbgl.Map({
+                // Tiles never arrive.
+                request: function() {},
+                ratio: 1
+            });
+            map.load({
+                version: 8,
+                sources: {
+                    raster: { type: 'raster', tiles: [ 'tile://{z}-{x}-{y}' ], tileSize: 256 }
+                },
+                layers: [{ id: 'raster', type: 'raster', source: 'raster' }]
+            });
+            map.render({ width: 64, height: 64, timeout: 50 }, function(err, pixels, missing) {
+                t.error(err);
+                t.ok(pixels instanceof Buffer);
+                t.deepEqual(missing, [{ source: 'raster', z: 0, x: 0, y: 0 }]);
+                map.release();
+                t.end();
+            });
+        });
+
+        t.test('encodes PNGs', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ width: 64, height: 64, format: 'png', compressionLevel: 9 }, function(err, png) {
+                t.error(err);
+                t.ok(png instanceof Buffer);
+                t.deepEqual(Array.from(png.slice(0, 8)), [0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A], 'has a PNG signature');
+                t.throws(function() {
+                    map.render({ format: 'webp' }, function() {});
+                }, /Options object 'format' property must be 'raw' or 'png'/);
+                map.release();
+                t.end();
+            });
         });
 
         // This can't be tested with a test-suite render test because zoom and center
@@ -575,6 +677,59 @@ test('Map', function(t) {
         })
     });
 
+    t.test('.queryRenderedFeatures', function(t) {
+        var options = {
+            request: function() {},
+            ratio: 1
+        };
+
+        var pointStyle = {
+            version: 8,
+            sources: {
+                points: {
+                    type: 'geojson',
+                    data: {
+                        type: 'FeatureCollection',
+                        features: [{
+                            type: 'Feature',
+                            id: 1,
+                            geometry: { type: 'Point', coordinates: [0, 0] },
+                            properties: { name: 'a', rank: 2, tags: ['x', true], nested: { value: null } }
+                        }]
+                    }
+                }
+            },
+            layers: [{ id: 'points', type: 'circle', source: 'points', paint: { 'circle-radius': 10 } }]
+        };
+
+        t.test('requires a known format', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(pointStyle);
+            t.throws(function() {
+                map.queryRenderedFeatures([256, 256], { format: 'json' });
+            }, /Requires options.format property to be 'objects' or 'buffer'/);
+            map.release();
+            t.end();
+        });
+
+        t.test('returns features as a buffer', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(pointStyle);
+            map.render({ width: 512, height: 512 }, function(err) {
+                t.error(err);
+                var objects = map.queryRenderedFeatures([256, 256]);
+                var buffer = map.queryRenderedFeatures([256, 256], { format: 'buffer' });
+                var batch = map.queryRenderedFeaturesBatch([[256, 256]], { format: 'buffer' });
+                map.release();
+                t.equal(objects.length, 1);
+                t.ok(buffer instanceof Buffer);
+                t.deepEqual(JSON.parse(JSON.stringify(mbgl.decodeFeatures(buffer))), objects);
+                t.deepEqual(JSON.parse(JSON.stringify(mbgl.decodeFeatures(batch[0]))), objects);
+                t.end();
+            });
+        });
+    });
+
     t.test('request callback', function (t) {
         t.test('returning an error', function(t) {
             var map = new mbgl.Map({
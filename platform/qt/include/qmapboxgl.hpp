@@ -38,6 +38,9 @@ public:
     GLContextMode contextMode() const;
     void setContextMode(GLContextMode);
 
+    bool threadedRendering() const;
+    void setThreadedRendering(bool);
+
     ConstrainMode constrainMode() const;
     void setConstrainMode(ConstrainMode);
 
@@ -61,6 +64,7 @@ public:
 
 private:
     GLContextMode m_contextMode;
+    bool m_threadedRendering;
     ConstrainMode m_constrainMode;
     ViewportMode m_viewportMode;
 
@@ -17,6 +17,7 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/asset_file_source.cpp
     PRIVATE platform/default/default_file_source.cpp
     PRIVATE platform/default/local_file_source.cpp
+    PRIVATE platform/default/pack_file_source.cpp
     PRIVATE platform/default/online_file_source.cpp
 
     # Offline
@@ -35,6 +36,8 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/mbgl/util/shared_thread_pool.hpp
     PRIVATE platform/default/mbgl/util/default_thread_pool.cpp
     PRIVATE platform/default/mbgl/util/default_thread_pool.hpp
+    PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.cpp
+    PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.hpp
 
     # Thread
     PRIVATE platform/qt/src/thread_local.cpp
@@ -54,6 +57,7 @@ set(MBGL_QT_FILES
     PRIVATE platform/qt/src/timer.cpp
     PRIVATE platform/qt/src/timer_impl.hpp
     PRIVATE platform/qt/src/utf.cpp
+    PRIVATE platform/default/local_glyph_rasterizer.cpp
 )
 
 include_directories(
@@ -100,6 +104,7 @@ if (MASON_PLATFORM STREQUAL "osx" OR MASON_PLATFORM STREQUAL "ios")
 elseif (CMAKE_HOST_SYSTEM_NAME STREQUAL "Linux")
     list(APPEND MBGL_QT_FILES
         PRIVATE platform/default/thread.cpp
+        PRIVATE platform/default/thread_affinity.cpp
     )
     list(APPEND MBGL_QT_LIBRARIES
         PRIVATE -lGL
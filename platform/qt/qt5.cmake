@@ -20,6 +20,11 @@ set(MBGL_QT_TEST_LIBRARIES
     PRIVATE Qt5::OpenGL
 )
 
+target_sources(qmapboxgl
+    PRIVATE platform/qt/src/qmapboxgl_threaded_renderer_frontend_p.hpp
+    PRIVATE platform/qt/src/qmapboxgl_threaded_renderer_frontend_p.cpp
+)
+
 target_link_libraries(qmapboxgl
     PRIVATE mbgl-core
     PRIVATE Qt5::Core
@@ -108,4 +108,8 @@ uint32_t HTTPFileSource::maximumConcurrentRequests() {
 #endif
 }
 
+void HTTPFileSource::setHTTP2Multiplexing(bool, uint32_t) {
+    // Not supported by the QNetworkAccessManager versions we build against.
+}
+
 } // namespace mbgl
@@ -181,6 +181,7 @@ std::unique_ptr<mbgl::style::Image> toStyleImage(const QString &id, const QImage
 */
 QMapboxGLSettings::QMapboxGLSettings()
     : m_contextMode(QMapboxGLSettings::SharedGLContext)
+    , m_threadedRendering(false)
     , m_constrainMode(QMapboxGLSettings::ConstrainHeightOnly)
     , m_viewportMode(QMapboxGLSettings::DefaultViewport)
     , m_cacheMaximumSize(mbgl::util::DEFAULT_MAX_CACHE_SIZE)
@@ -210,6 +211,33 @@ void QMapboxGLSettings::setContextMode(GLContextMode mode)
     m_contextMode = mode;
 }
 
+/*!
+    Returns true when the map is rendered on a thread of its own.
+
+    By default, it is set to false.
+*/
+bool QMapboxGLSettings::threadedRendering() const
+{
+    return m_threadedRendering;
+}
+
+/*!
+    Renders the map on a thread of its own when \a enabled, so that the GUI thread doesn't wait
+    for rendering, e.g. when many tiles are uploaded at once. The render thread uses an OpenGL
+    context that shares its objects with the one QMapboxGL::render() is first called with, and
+    renders the frames into textures. QMapboxGL::render() then only draws the most recent
+    frame, which leaves blending, depth, stencil and scissor tests, and face culling disabled.
+    The needsRendering() signal is emitted whenever a new frame is ready.
+
+    The OpenGL context mode doesn't apply, since the context of the render thread isn't shared
+    with anything else. Requires Qt 5; with Qt 4, the map is always rendered by
+    QMapboxGL::render().
+*/
+void QMapboxGLSettings::setThreadedRendering(bool enabled)
+{
+    m_threadedRendering = enabled;
+}
+
 /*!
     Returns the constrain mode. This is used to limit the map to wrap
     around the globe horizontally.
@@ -1499,14 +1527,25 @@ QMapboxGLPrivate::QMapboxGLPrivate(QMapboxGL *q, const QMapboxGLSettings &settin
     , threadPool(mbgl::sharedThreadPool())
 {
     // Setup and connect the renderer frontend
-    frontend = std::make_unique<QMapboxGLRendererFrontend>(
-            std::make_unique<mbgl::Renderer>(*this, pixelRatio, *fileSourceObj, *threadPool,
-                                             static_cast<mbgl::GLContextMode>(settings.contextMode())),
-            *this);
-    connect(frontend.get(), SIGNAL(updated()), this, SLOT(invalidate()));
-    
+    mbgl::RendererFrontend* rendererFrontend = nullptr;
+#if QT_VERSION >= 0x050000
+    if (settings.threadedRendering()) {
+        threadedFrontend = std::make_unique<QMapboxGLThreadedRendererFrontend>(pixelRatio, *fileSourceObj, *threadPool);
+        connect(threadedFrontend.get(), SIGNAL(updated()), this, SLOT(invalidate()));
+        rendererFrontend = threadedFrontend.get();
+    }
+#endif
+    if (!rendererFrontend) {
+        frontend = std::make_unique<QMapboxGLRendererFrontend>(
+                std::make_unique<mbgl::Renderer>(*this, pixelRatio, *fileSourceObj, *threadPool,
+                                                 static_cast<mbgl::GLContextMode>(settings.contextMode())),
+                *this);
+        connect(frontend.get(), SIGNAL(updated()), this, SLOT(invalidate()));
+        rendererFrontend = frontend.get();
+    }
+
     mapObj = std::make_unique<mbgl::Map>(
-            *frontend,
+            *rendererFrontend,
             *this, sanitizedSize(size),
             pixelRatio, *fileSourceObj, *threadPool,
             mbgl::MapMode::Continuous,
@@ -1551,6 +1590,12 @@ void QMapboxGLPrivate::invalidate()
 
 void QMapboxGLPrivate::render()
 {
+#if QT_VERSION >= 0x050000
+    if (threadedFrontend) {
+        threadedFrontend->render(fbObject, fbSize);
+        return;
+    }
+#endif
     frontend->render();
 }
 
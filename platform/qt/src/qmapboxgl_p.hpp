@@ -3,6 +3,10 @@
 #include "qmapboxgl.hpp"
 #include "qmapboxgl_renderer_frontend_p.hpp"
 
+#if QT_VERSION >= 0x050000
+#include "qmapboxgl_threaded_renderer_frontend_p.hpp"
+#endif
+
 #include <mbgl/map/map.hpp>
 #include <mbgl/renderer/renderer_backend.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
@@ -52,6 +56,9 @@ public:
     std::shared_ptr<mbgl::DefaultFileSource> fileSourceObj;
     std::shared_ptr<mbgl::ThreadPool> threadPool;
     std::unique_ptr<QMapboxGLRendererFrontend> frontend;
+#if QT_VERSION >= 0x050000
+    std::unique_ptr<QMapboxGLThreadedRendererFrontend> threadedFrontend;
+#endif
     std::unique_ptr<mbgl::Map> mapObj;
 
     bool dirty { false };
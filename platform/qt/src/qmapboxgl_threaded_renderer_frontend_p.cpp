@@ -0,0 +1,269 @@
+#include "qmapboxgl_threaded_renderer_frontend_p.hpp"
+
+#include <mbgl/renderer/renderer_backend.hpp>
+#include <mbgl/renderer/threaded_renderer_frontend.hpp>
+
+#include <QDebug>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+// Used on the render thread only, except for the frames it hands over. It renders into one of
+// three framebuffers: while one is being rendered into, another holds the most recent frame
+// that is ready, and the GUI thread draws the third one.
+class QMapboxGLRenderThreadBackend : public mbgl::RendererBackend
+{
+public:
+    // Called on the GUI thread, with the context to share objects with current.
+    explicit QMapboxGLRenderThreadBackend(std::function<void()> frameReady_)
+        : shareContext(QOpenGLContext::currentContext())
+        , frameReady(std::move(frameReady_))
+    {
+        // Offscreen surfaces must be created on the GUI thread, but may be used on any thread.
+        surface.setFormat(shareContext->format());
+        surface.create();
+    }
+
+    ~QMapboxGLRenderThreadBackend() override
+    {
+        Q_ASSERT(!context);
+    }
+
+    // Called on the GUI thread before the render thread is stopped, so that the render thread
+    // releases its context along with the renderer.
+    void stop()
+    {
+        stopped = true;
+    }
+
+    // Called on the GUI thread, with the size of the framebuffer the frames are drawn into.
+    void setSize(const QSize& size_)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size = size_.expandedTo(QSize(1, 1));
+    }
+
+    // Called on the GUI thread. Returns the texture of the most recent frame, or 0 if there
+    // hasn't been any yet.
+    GLuint takeFrame()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (readyIsNew) {
+            std::swap(displayed, ready);
+            readyIsNew = false;
+        }
+        return displayed ? displayed->texture() : 0;
+    }
+
+    void bind() final
+    {
+        QSize framebufferSize;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            framebufferSize = size;
+        }
+
+        if (!rendering || rendering->size() != framebufferSize) {
+            rendering = std::make_unique<QOpenGLFramebufferObject>(
+                framebufferSize, QOpenGLFramebufferObject::CombinedDepthStencil);
+            // Creating the framebuffer changes the binding behind the context's back.
+            assumeFramebufferBinding(ImplicitFramebufferBinding);
+        }
+
+        setFramebufferBinding(rendering->handle());
+        setViewport(0, 0, { static_cast<uint32_t>(framebufferSize.width()),
+                            static_cast<uint32_t>(framebufferSize.height()) });
+        frameBound = true;
+    }
+
+    void updateAssumedState() final
+    {
+        assumeFramebufferBinding(ImplicitFramebufferBinding);
+    }
+
+protected:
+    void activate() final
+    {
+        if (!context) {
+            // Created on the render thread, which it then belongs to.
+            context = std::make_unique<QOpenGLContext>();
+            context->setFormat(shareContext->format());
+            context->setShareContext(shareContext);
+            if (!context->create()) {
+                qWarning() << "Couldn't create the OpenGL context of the render thread";
+            }
+        }
+        context->makeCurrent(&surface);
+    }
+
+    void deactivate() final
+    {
+        if (frameBound) {
+            frameBound = false;
+            // The GUI thread draws the frame through the other context, which doesn't wait for
+            // the commands of this one.
+            context->functions()->glFinish();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                std::swap(rendering, ready);
+                readyIsNew = true;
+            }
+            frameReady();
+        }
+
+        if (stopped) {
+            rendering.reset();
+            ready.reset();
+            displayed.reset();
+            context->doneCurrent();
+            context.reset();
+        } else {
+            context->doneCurrent();
+        }
+    }
+
+    mbgl::gl::ProcAddress initializeExtension(const char* name) final
+    {
+        return context->getProcAddress(name);
+    }
+
+private:
+    QOpenGLContext* const shareContext;
+    const std::function<void()> frameReady;
+    QOffscreenSurface surface;
+    std::unique_ptr<QOpenGLContext> context;
+    std::atomic<bool> stopped { false };
+    bool frameBound { false };
+
+    std::mutex mutex;
+    QSize size { 1, 1 };
+    std::unique_ptr<QOpenGLFramebufferObject> rendering;
+    std::unique_ptr<QOpenGLFramebufferObject> ready;
+    std::unique_ptr<QOpenGLFramebufferObject> displayed;
+    bool readyIsNew { false };
+};
+
+QMapboxGLThreadedRendererFrontend::QMapboxGLThreadedRendererFrontend(float pixelRatio_, mbgl::FileSource& fileSource_, mbgl::Scheduler& scheduler_)
+    : pixelRatio(pixelRatio_)
+    , fileSource(fileSource_)
+    , scheduler(scheduler_)
+{
+}
+
+QMapboxGLThreadedRendererFrontend::~QMapboxGLThreadedRendererFrontend()
+{
+    reset();
+}
+
+void QMapboxGLThreadedRendererFrontend::reset()
+{
+    stopped = true;
+    if (threaded) {
+        // Stopping the thread destroys the renderer, along with the render thread's context.
+        backend->stop();
+        threaded.reset();
+    }
+    backend.reset();
+    updateParameters.reset();
+}
+
+void QMapboxGLThreadedRendererFrontend::setObserver(mbgl::RendererObserver& observer_)
+{
+    if (threaded) {
+        threaded->setObserver(observer_);
+    } else {
+        observer = &observer_;
+    }
+}
+
+void QMapboxGLThreadedRendererFrontend::update(std::shared_ptr<mbgl::UpdateParameters> parameters)
+{
+    if (threaded) {
+        // The render thread tells once the frame is ready.
+        threaded->update(std::move(parameters));
+    } else {
+        updateParameters = std::move(parameters);
+        emit updated();
+    }
+}
+
+void QMapboxGLThreadedRendererFrontend::start()
+{
+    // Emitted on the render thread, so the connections are queued to the GUI thread.
+    backend = std::make_unique<QMapboxGLRenderThreadBackend>([this] { emit updated(); });
+
+    // The context of the render thread is only ever used by the renderer.
+    threaded = std::make_unique<mbgl::ThreadedRendererFrontend>(
+        *backend, pixelRatio, fileSource, scheduler, mbgl::GLContextMode::Unique);
+    if (observer) {
+        threaded->setObserver(*observer);
+    }
+    if (updateParameters) {
+        threaded->update(std::move(updateParameters));
+    }
+}
+
+void QMapboxGLThreadedRendererFrontend::render(quint32 fbObject, const QSize& fbSize)
+{
+    if (stopped || !QOpenGLContext::currentContext()) return;
+
+    if (!threaded) {
+        start();
+    }
+
+    backend->setSize(fbSize);
+    const GLuint texture = backend->takeFrame();
+    if (!texture) return;
+
+    if (!program) {
+        program = std::make_unique<QOpenGLShaderProgram>();
+        program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+            "attribute vec2 a_pos;\n"
+            "varying vec2 v_pos;\n"
+            "void main() {\n"
+            "    v_pos = (a_pos + 1.0) / 2.0;\n"
+            "    gl_Position = vec4(a_pos, 0.0, 1.0);\n"
+            "}\n");
+        program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+            "#ifdef GL_ES\n"
+            "precision mediump float;\n"
+            "#endif\n"
+            "uniform sampler2D u_texture;\n"
+            "varying vec2 v_pos;\n"
+            "void main() {\n"
+            "    gl_FragColor = texture2D(u_texture, v_pos);\n"
+            "}\n");
+        program->bindAttributeLocation("a_pos", 0);
+        program->link();
+    }
+
+    // Covers the framebuffer with the frame, which has the same orientation, since both follow
+    // the OpenGL convention.
+    static const GLfloat quad[] = { -1, -1, 1, -1, -1, 1, 1, 1 };
+
+    QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbObject);
+    gl->glViewport(0, 0, fbSize.width(), fbSize.height());
+    gl->glDisable(GL_BLEND);
+    gl->glDisable(GL_DEPTH_TEST);
+    gl->glDisable(GL_STENCIL_TEST);
+    gl->glDisable(GL_SCISSOR_TEST);
+    gl->glDisable(GL_CULL_FACE);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D, texture);
+
+    program->bind();
+    program->setUniformValue("u_texture", 0);
+    program->enableAttributeArray(0);
+    program->setAttributeArray(0, GL_FLOAT, quad, 2);
+    gl->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    program->disableAttributeArray(0);
+    program->release();
+}
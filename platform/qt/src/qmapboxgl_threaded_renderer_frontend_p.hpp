@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mbgl/map/mode.hpp>
+#include <mbgl/renderer/renderer_frontend.hpp>
+
+#include <QObject>
+#include <QSize>
+
+#include <memory>
+
+namespace mbgl {
+    class FileSource;
+    class Scheduler;
+    class ThreadedRendererFrontend;
+} // namespace mbgl
+
+class QMapboxGLRenderThreadBackend;
+class QOpenGLShaderProgram;
+
+// Renders the map on a thread of its own, through an OpenGL context that shares its objects with
+// the one QMapboxGL::render() is called with, so that the GUI thread never waits for a frame to
+// be rendered. Frames are rendered into textures, of which render() draws the most recent one.
+class QMapboxGLThreadedRendererFrontend : public QObject, public mbgl::RendererFrontend
+{
+    Q_OBJECT
+
+public:
+    QMapboxGLThreadedRendererFrontend(float pixelRatio, mbgl::FileSource&, mbgl::Scheduler&);
+    ~QMapboxGLThreadedRendererFrontend() override;
+
+    void reset() override;
+    void setObserver(mbgl::RendererObserver&) override;
+
+    void update(std::shared_ptr<mbgl::UpdateParameters>) override;
+
+    // Draws the most recent frame into the framebuffer, with the context of the map current.
+    // The first call starts the render thread, with a context sharing the current one's objects.
+    void render(quint32 fbObject, const QSize& fbSize);
+
+signals:
+    void updated();
+
+private:
+    void start();
+
+    const float pixelRatio;
+    mbgl::FileSource& fileSource;
+    mbgl::Scheduler& scheduler;
+    bool stopped { false };
+
+    // Until the render thread starts.
+    mbgl::RendererObserver* observer { nullptr };
+    std::shared_ptr<mbgl::UpdateParameters> updateParameters;
+
+    std::unique_ptr<QMapboxGLRenderThreadBackend> backend;
+    std::unique_ptr<mbgl::ThreadedRendererFrontend> threaded;
+    std::unique_ptr<QOpenGLShaderProgram> program;
+};
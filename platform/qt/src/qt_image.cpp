@@ -4,9 +4,11 @@
 #include <QByteArray>
 #include <QImage>
 
+#include <algorithm>
+
 namespace mbgl {
 
-std::string encodePNG(const PremultipliedImage& pre) {
+std::string encodePNG(const PremultipliedImage& pre, int compressionLevel) {
     QImage image(pre.data.get(), pre.size.width, pre.size.height,
         QImage::Format_ARGB32_Premultiplied);
 
@@ -14,17 +16,19 @@ std::string encodePNG(const PremultipliedImage& pre) {
     QBuffer buffer(&array);
 
     buffer.open(QIODevice::WriteOnly);
-    image.rgbSwapped().save(&buffer, "PNG");
+    // Qt derives the compression level of PNGs from the quality.
+    const int quality = compressionLevel < 0 ? -1 : (9 - std::min(compressionLevel, 9)) * 100 / 9;
+    image.rgbSwapped().save(&buffer, "PNG", quality);
 
     return std::string(array.constData(), array.size());
 }
 
 #if !defined(QT_IMAGE_DECODERS)
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
-PremultipliedImage decodeWebP(const uint8_t*, size_t);
+PremultipliedImage decodeJPEG(const uint8_t*, size_t, Size minimumSize);
+PremultipliedImage decodeWebP(const uint8_t*, size_t, Size minimumSize);
 #endif
 
-PremultipliedImage decodeImage(const std::string& string) {
+PremultipliedImage decodeImage(const std::string& string, Size minimumSize) {
     const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
     const size_t size = string.size();
 
@@ -33,14 +37,14 @@ PremultipliedImage decodeImage(const std::string& string) {
         uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         uint32_t webp_magic = (data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
         if (riff_magic == 0x52494646 && webp_magic == 0x57454250) {
-            return decodeWebP(data, size);
+            return decodeWebP(data, size, minimumSize);
         }
     }
 
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return decodeJPEG(data, size, minimumSize);
         }
     }
 #endif
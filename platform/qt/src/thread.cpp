@@ -12,8 +12,14 @@ std::string getCurrentThreadName() {
 void setCurrentThreadName(const std::string&) {
 }
 
+void setCurrentThreadPriority(ThreadPriority) {
+}
+
 void makeThreadLowPriority() {
 }
 
+void setCurrentThreadAffinity(ThreadAffinity) {
+}
+
 } // namespace platform
 } // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/renderer/backend_scope.hpp>
+#include <mbgl/util/trace.hpp>
 
 #include <array>
 #include <cassert>
@@ -43,6 +44,7 @@ void ThreadLocal<T>::set(T* ptr) {
 
 template class ThreadLocal<RunLoop>;
 template class ThreadLocal<BackendScope>;
+template class ThreadLocal<trace::ThreadBuffer>;
 template class ThreadLocal<int>; // For unit tests
 
 } // namespace util
@@ -2,39 +2,76 @@
 #include <mbgl/actor/message.hpp>
 #include <mbgl/actor/scheduler.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <thread>
 
 namespace mbgl {
 
 Mailbox::Mailbox(Scheduler& scheduler_)
-    : scheduler(scheduler_) {
+    : scheduler(scheduler_),
+      head(&stub),
+      tail(&stub) {
+}
+
+Mailbox::~Mailbox() {
+    while (Message* message = dequeue()) {
+        delete message;
+    }
 }
 
 void Mailbox::close() {
-    // Block until neither receive() nor push() are in progress. Two mutexes are used because receive()
-    // must not block send(). Of the two, the receiving mutex must be acquired first, because that is
-    // the order that an actor will obtain them when it self-sends a message, and consistent lock
-    // acquisition order prevents deadlocks.
+    // Block until neither receive() nor push() are in progress. receive() is excluded with a
+    // mutex; push() must not take a lock, so instead it announces itself via `pushing` before
+    // checking `closed`. Both are sequentially consistent, so either push() sees `closed` and
+    // bails, or we see it in progress and wait for it to finish.
     // The receiving mutex is recursive to allow a mailbox (and thus the actor) to close itself.
     std::lock_guard<std::recursive_mutex> receivingLock(receivingMutex);
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
 
     closed = true;
+
+    while (pushing > 0) {
+        std::this_thread::yield();
+    }
 }
 
 void Mailbox::push(std::unique_ptr<Message> message) {
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
+    ++pushing;
 
     if (closed) {
+        --pushing;
         return;
     }
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
-    queue.push(std::move(message));
-    if (wasEmpty) {
+    enqueue(message.release());
+
+    if (size++ == 0) {
         scheduler.schedule(shared_from_this());
     }
+
+    --pushing;
+}
+
+void Mailbox::coalesce(std::unique_ptr<Message> message) {
+    std::lock_guard<std::mutex> coalescingLock(coalescingMutex);
+
+    // Messages that push() drops once the mailbox is closed mustn't be kept in `coalescing`.
+    if (closed) {
+        return;
+    }
+
+    message->coalesced = true;
+    auto it = std::find_if(coalescing.begin(), coalescing.end(), [&] (Message* queued) {
+        return queued->coalescesWith(*message);
+    });
+    if (it != coalescing.end()) {
+        (*it)->superseded = true;
+        *it = message.get();
+    } else {
+        coalescing.push_back(message.get());
+    }
+
+    push(std::move(message));
 }
 
 void Mailbox::receive() {
@@ -44,28 +81,103 @@ void Mailbox::receive() {
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
+    assert(size > 0);
 
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
+    // Superseded messages are dropped, and the next message, if any, is received in their place.
+    std::unique_ptr<Message> message(dequeueWaiting());
+    bool superseded = isSuperseded(*message);
+    while (superseded && size > 1) {
+        --size;
+        message.reset(dequeueWaiting());
+        superseded = isSuperseded(*message);
     }
 
-    (*message)();
+    if (!superseded) {
+        (*message)();
+    }
 
-    if (!wasEmpty) {
+    if (size-- > 1) {
         scheduler.schedule(shared_from_this());
     }
 }
 
+void Mailbox::setPriority(int32_t priority_) {
+    priority = priority_;
+}
+
+int32_t Mailbox::getPriority() const {
+    return priority;
+}
+
 void Mailbox::maybeReceive(std::weak_ptr<Mailbox> mailbox) {
     if (auto locked = mailbox.lock()) {
         locked->receive();
     }
 }
 
+bool Mailbox::isSuperseded(Message& message) {
+    if (!message.coalesced) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> coalescingLock(coalescingMutex);
+    if (message.superseded) {
+        return true;
+    }
+    coalescing.erase(std::find(coalescing.begin(), coalescing.end(), &message));
+    return false;
+}
+
+Message* Mailbox::dequeueWaiting() {
+    // `size` is only incremented once a message is fully linked in, but a producer that started
+    // earlier may still be between its exchange and its link. That window is a couple of
+    // instructions wide, so wait it out.
+    Message* message;
+    while (!(message = dequeue())) {
+        std::this_thread::yield();
+    }
+    return message;
+}
+
+void Mailbox::enqueue(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head.exchange(message, std::memory_order_acq_rel);
+    prev->next.store(message, std::memory_order_release);
+}
+
+Message* Mailbox::dequeue() {
+    Message* first = tail;
+    Message* next = first->next.load(std::memory_order_acquire);
+
+    if (first == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    if (first != head.load(std::memory_order_acquire)) {
+        // A push is in progress.
+        return nullptr;
+    }
+
+    // `first` is the last message; put the stub back behind it so it can be unlinked.
+    enqueue(&stub);
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    return nullptr;
+}
+
 } // namespace mbgl
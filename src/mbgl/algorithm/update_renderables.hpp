@@ -4,11 +4,14 @@
 #include <mbgl/util/range.hpp>
 #include <mbgl/storage/resource.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 
 namespace mbgl {
 namespace algorithm {
 
+// `checked` keeps track of the parent tiles that have been looked for; it's cleared first, and
+// passing the same set to every call reuses its allocation.
 template <typename GetTileFn,
           typename CreateTileFn,
           typename RetainTileFn,
@@ -20,18 +23,28 @@ void updateRenderables(GetTileFn getTile,
                        RenderTileFn renderTile,
                        const IdealTileIDs& idealTileIDs,
                        const Range<uint8_t>& zoomRange,
-                       const uint8_t dataTileZoom) {
-    std::unordered_set<UnwrappedTileID> checked;
+                       const uint8_t dataTileZoom,
+                       std::unordered_set<UnwrappedTileID>& checked) {
+    checked.clear();
     bool covered;
     int32_t overscaledZ;
 
+    // The ideal tiles may be at several zoom levels, with the ones far from the camera of a pitched
+    // view at lower ones. `dataTileZoom` is the zoom level of the data of the highest of them, and
+    // the others are overscaled by as much.
+    uint8_t idealZoom = 0;
+    for (const auto& idealRenderTileID : idealTileIDs) {
+        idealZoom = std::max(idealZoom, idealRenderTileID.canonical.z);
+    }
+    assert(idealTileIDs.empty() || dataTileZoom >= idealZoom);
+
     // for (all in the set of ideal tiles of the source) {
     for (const auto& idealRenderTileID : idealTileIDs) {
         assert(idealRenderTileID.canonical.z >= zoomRange.min);
         assert(idealRenderTileID.canonical.z <= zoomRange.max);
-        assert(dataTileZoom >= idealRenderTileID.canonical.z);
 
-        const OverscaledTileID idealDataTileID(dataTileZoom, idealRenderTileID.wrap, idealRenderTileID.canonical);
+        const uint8_t idealDataTileZoom = dataTileZoom - (idealZoom - idealRenderTileID.canonical.z);
+        const OverscaledTileID idealDataTileID(idealDataTileZoom, idealRenderTileID.wrap, idealRenderTileID.canonical);
         auto tile = getTile(idealDataTileID);
         if (!tile) {
             tile = createTile(idealDataTileID);
@@ -50,7 +63,7 @@ void updateRenderables(GetTileFn getTile,
             // The tile isn't loaded yet, but retain it anyway because it's an ideal tile.
             retainTile(*tile, Resource::Necessity::Required);
             covered = true;
-            overscaledZ = dataTileZoom + 1;
+            overscaledZ = idealDataTileZoom + 1;
             if (overscaledZ > zoomRange.max) {
                 // We're looking for an overzoomed child tile.
                 const auto childDataTileID = idealDataTileID.scaledTo(overscaledZ);
@@ -79,7 +92,7 @@ void updateRenderables(GetTileFn getTile,
 
             if (!covered) {
                 // We couldn't find child tiles that entirely cover the ideal tile.
-                for (overscaledZ = dataTileZoom - 1; overscaledZ >= zoomRange.min; --overscaledZ) {
+                for (overscaledZ = idealDataTileZoom - 1; overscaledZ >= zoomRange.min; --overscaledZ) {
                     const auto parentDataTileID = idealDataTileID.scaledTo(overscaledZ);
                     const auto parentRenderTileID = parentDataTileID.toUnwrapped();
 
@@ -117,5 +130,21 @@ void updateRenderables(GetTileFn getTile,
     }
 }
 
+template <typename GetTileFn,
+          typename CreateTileFn,
+          typename RetainTileFn,
+          typename RenderTileFn,
+          typename IdealTileIDs>
+void updateRenderables(GetTileFn getTile,
+                       CreateTileFn createTile,
+                       RetainTileFn retainTile,
+                       RenderTileFn renderTile,
+                       const IdealTileIDs& idealTileIDs,
+                       const Range<uint8_t>& zoomRange,
+                       const uint8_t dataTileZoom) {
+    std::unordered_set<UnwrappedTileID> checked;
+    updateRenderables(getTile, createTile, retainTile, renderTile, idealTileIDs, zoomRange, dataTileZoom, checked);
+}
+
 } // namespace algorithm
 } // namespace mbgl
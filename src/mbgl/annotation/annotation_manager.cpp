@@ -10,8 +10,13 @@
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/storage/file_source.hpp>
 
+#include <mbgl/util/constants.hpp>
+
 #include <boost/function_output_iterator.hpp>
 
+#include <algorithm>
+#include <set>
+
 namespace mbgl {
 
 using namespace style;
@@ -19,6 +24,23 @@ using namespace style;
 const std::string AnnotationManager::SourceID = "com.mapbox.annotations";
 const std::string AnnotationManager::PointLayerID = "com.mapbox.annotations.points";
 
+// The buffer that shapes are tiled with, as a fraction of the tile size.
+static const double shapeBuffer = 256.0 / util::EXTENT;
+
+// The bounds, and their copies shifted by 360° where they extend past the antimeridian.
+static std::vector<LatLngBounds> wrappedBounds(const LatLngBounds& bounds) {
+    std::vector<LatLngBounds> result { bounds };
+    if (bounds.west() < -util::LONGITUDE_MAX) {
+        result.push_back(LatLngBounds::hull({ bounds.south(), bounds.west() + util::DEGREES_MAX },
+                                            { bounds.north(), bounds.east() + util::DEGREES_MAX }));
+    }
+    if (bounds.east() > util::LONGITUDE_MAX) {
+        result.push_back(LatLngBounds::hull({ bounds.south(), bounds.west() - util::DEGREES_MAX },
+                                            { bounds.north(), bounds.east() - util::DEGREES_MAX }));
+    }
+    return result;
+}
+
 AnnotationManager::AnnotationManager(Style& style_)
         : style(style_) {
 };
@@ -54,22 +76,66 @@ void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     remove(id);
 }
 
+AnnotationIDs AnnotationManager::addAnnotations(const std::vector<Annotation>& annotations, const uint8_t maxZoom) {
+    std::lock_guard<std::mutex> lock(mutex);
+    AnnotationIDs ids;
+    ids.reserve(annotations.size());
+    for (const auto& annotation : annotations) {
+        AnnotationID id = nextID++;
+        Annotation::visit(annotation, [&] (const auto& annotation_) {
+            this->add(id, annotation_, maxZoom);
+        });
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+Update AnnotationManager::updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>& annotations,
+                                            const uint8_t maxZoom) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Update result = Update::Nothing;
+    for (const auto& annotation : annotations) {
+        result |= Annotation::visit(annotation.second, [&] (const auto& annotation_) {
+            return this->update(annotation.first, annotation_, maxZoom);
+        });
+    }
+    return result;
+}
+
+void AnnotationManager::removeAnnotations(const AnnotationIDs& ids) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& id : ids) {
+        remove(id);
+    }
+}
+
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t) {
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
     symbolTree.insert(impl);
     symbolAnnotations.emplace(id, impl);
+    changed(LatLngBounds::singleton({ annotation.geometry.y, annotation.geometry.x }));
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<LineAnnotationImpl>(id, annotation, maxZoom)).first->second;
     impl.updateStyle(*style.get().impl);
+    const LatLngBounds bounds = impl.bounds();
+    if (!bounds.isEmpty()) {
+        shapeTree.insert({ bounds, id });
+    }
+    changed(bounds);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation, const uint8_t maxZoom) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<FillAnnotationImpl>(id, annotation, maxZoom)).first->second;
     impl.updateStyle(*style.get().impl);
+    const LatLngBounds bounds = impl.bounds();
+    if (!bounds.isEmpty()) {
+        shapeTree.insert({ bounds, id });
+    }
+    changed(bounds);
 }
 
 Update AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t maxZoom) {
@@ -100,7 +166,7 @@ Update AnnotationManager::update(const AnnotationID& id, const LineAnnotation& a
         return Update::Nothing;
     }
 
-    shapeAnnotations.erase(it);
+    removeShape(it);
     add(id, annotation, maxZoom);
     return Update::AnnotationData;
 }
@@ -112,24 +178,41 @@ Update AnnotationManager::update(const AnnotationID& id, const FillAnnotation& a
         return Update::Nothing;
     }
 
-    shapeAnnotations.erase(it);
+    removeShape(it);
     add(id, annotation, maxZoom);
     return Update::AnnotationData;
 }
 
 void AnnotationManager::remove(const AnnotationID& id) {
     if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
+        const Point<double>& point = symbolAnnotations.at(id)->annotation.geometry;
+        changed(LatLngBounds::singleton({ point.y, point.x }));
         symbolTree.remove(symbolAnnotations.at(id));
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
         auto it = shapeAnnotations.find(id);
         *style.get().impl->removeLayer(it->second->layerID);
-        shapeAnnotations.erase(it);
+        removeShape(it);
     } else {
         assert(false); // Should never happen
     }
 }
 
+void AnnotationManager::removeShape(ShapeAnnotationMap::iterator it) {
+    const LatLngBounds bounds = it->second->bounds();
+    if (!bounds.isEmpty()) {
+        shapeTree.remove(std::make_pair(bounds, it->first));
+    }
+    changed(bounds);
+    shapeAnnotations.erase(it);
+}
+
+void AnnotationManager::changed(const LatLngBounds& bounds) {
+    if (!bounds.isEmpty()) {
+        changedBounds.push_back(bounds);
+    }
+}
+
 std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const CanonicalTileID& tileID) {
     if (symbolAnnotations.empty() && shapeAnnotations.empty())
         return nullptr;
@@ -145,8 +228,17 @@ std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const Canonic
             val->updateLayer(tileID, *pointLayer);
         }));
 
-    for (const auto& shape : shapeAnnotations) {
-        shape.second->updateTileData(tileID, *tileData);
+    // Shapes are tiled with a buffer, which wraps around the antimeridian.
+    std::set<AnnotationID> shapes;
+    for (const LatLngBounds& bounds : wrappedBounds(LatLngBounds(tileID, shapeBuffer))) {
+        shapeTree.query(boost::geometry::index::intersects(bounds),
+            boost::make_function_output_iterator([&](const auto& val){
+                shapes.insert(val.second);
+            }));
+    }
+
+    for (const AnnotationID& id : shapes) {
+        shapeAnnotations.at(id)->updateTileData(tileID, *tileData);
     }
 
     return tileData;
@@ -188,8 +280,18 @@ void AnnotationManager::updateStyle() {
 void AnnotationManager::updateData() {
     std::lock_guard<std::mutex> lock(mutex);
     for (auto& tile : tiles) {
-        tile->setData(getTileData(tile->id.canonical));
+        const CanonicalTileID& tileID = tile->id.canonical;
+        const auto tileBounds = wrappedBounds(LatLngBounds(tileID, shapeBuffer));
+        const bool affected = std::any_of(changedBounds.begin(), changedBounds.end(), [&] (const LatLngBounds& bounds) {
+            return std::any_of(tileBounds.begin(), tileBounds.end(), [&] (const LatLngBounds& wrapped) {
+                return boost::geometry::intersects(wrapped, bounds);
+            });
+        });
+        if (affected) {
+            tile->setData(getTileData(tileID));
+        }
     }
+    changedBounds.clear();
 }
 
 void AnnotationManager::addTile(AnnotationTile& tile) {
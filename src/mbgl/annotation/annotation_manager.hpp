@@ -33,6 +33,10 @@ public:
     Update updateAnnotation(const AnnotationID&, const Annotation&, const uint8_t maxZoom);
     void removeAnnotation(const AnnotationID&);
 
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&, const uint8_t maxZoom);
+    Update updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>&, const uint8_t maxZoom);
+    void removeAnnotations(const AnnotationIDs&);
+
     void addImage(std::unique_ptr<style::Image>);
     void removeImage(const std::string&);
     double getTopOffsetPixelsForImage(const std::string&);
@@ -58,6 +62,7 @@ private:
     Update update(const AnnotationID&, const FillAnnotation&, const uint8_t);
 
     void remove(const AnnotationID&);
+    void changed(const LatLngBounds&);
 
     void updateStyle();
 
@@ -75,12 +80,20 @@ private:
     using SymbolAnnotationMap = std::map<AnnotationID, std::shared_ptr<SymbolAnnotationImpl>>;
     using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
     using ImageMap = std::unordered_map<std::string, style::Image>;
+    using ShapeAnnotationTree = boost::geometry::index::rtree<std::pair<LatLngBounds, AnnotationID>, boost::geometry::index::rstar<16, 4>>;
+
+    void removeShape(ShapeAnnotationMap::iterator);
 
     SymbolAnnotationTree symbolTree;
     SymbolAnnotationMap symbolAnnotations;
+    ShapeAnnotationTree shapeTree;
     ShapeAnnotationMap shapeAnnotations;
     ImageMap images;
 
+    // The bounds of the annotations that changed since the last updateData(), which only
+    // updates the tiles within them.
+    std::vector<LatLngBounds> changedBounds;
+
     std::unordered_set<AnnotationTile*> tiles;
 
     friend class AnnotationTile;
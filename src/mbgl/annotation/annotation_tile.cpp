@@ -111,6 +111,19 @@ std::unique_ptr<GeometryTileLayer> AnnotationTileData::getLayer(const std::strin
     return nullptr;
 }
 
+std::size_t AnnotationTileData::byteSize() const {
+    std::size_t result = 0;
+    for (const auto& layer : layers) {
+        for (const auto& feature : layer.second->features) {
+            result += sizeof(AnnotationTileFeatureData);
+            for (const auto& geometry : feature->geometries) {
+                result += geometry.capacity() * sizeof(GeometryCoordinate);
+            }
+        }
+    }
+    return result;
+}
+
 std::unique_ptr<AnnotationTileLayer> AnnotationTileData::addLayer(const std::string& name) {
     // Only constructs a new layer if it doesn't yet exist, otherwise, we'll use the existing one.
     auto it = layers.find(name);
@@ -59,6 +59,7 @@ class AnnotationTileData : public GeometryTileData {
 public:
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const override;
+    std::size_t byteSize() const override;
 
     std::unique_ptr<AnnotationTileLayer> addLayer(const std::string&);
 
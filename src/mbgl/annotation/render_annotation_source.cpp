@@ -23,6 +23,18 @@ bool RenderAnnotationSource::isLoaded() const {
     return tilePyramid.isLoaded();
 }
 
+std::vector<OverscaledTileID> RenderAnnotationSource::getIncompleteTiles() const {
+    return tilePyramid.getIncompleteTiles();
+}
+
+RendererStatistics::Tiles RenderAnnotationSource::getTileStatistics() const {
+    return tilePyramid.getTileStatistics();
+}
+
+RendererStatistics::Memory RenderAnnotationSource::getMemoryUsage() const {
+    return tilePyramid.getMemoryUsage();
+}
+
 void RenderAnnotationSource::update(Immutable<style::Source::Impl> baseImpl_,
                                     const std::vector<Immutable<Layer::Impl>>& layers,
                                     const bool needsRendering,
@@ -65,12 +77,11 @@ RenderAnnotationSource::queryRenderedFeatures(const ScreenLineString& geometry,
     return tilePyramid.queryRenderedFeatures(geometry, transformState, style, options);
 }
 
-std::vector<Feature> RenderAnnotationSource::querySourceFeatures(const SourceQueryOptions&) const {
-    return {};
+void RenderAnnotationSource::querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const {
 }
 
-void RenderAnnotationSource::onLowMemory() {
-    tilePyramid.onLowMemory();
+RendererStatistics::LowMemory RenderAnnotationSource::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    return tilePyramid.onLowMemory(pressure, workerCachesFreed);
 }
 
 void RenderAnnotationSource::dumpDebugLogs() const {
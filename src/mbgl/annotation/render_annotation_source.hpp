@@ -11,6 +11,9 @@ public:
     RenderAnnotationSource(Immutable<AnnotationSource::Impl>);
 
     bool isLoaded() const final;
+    std::vector<OverscaledTileID> getIncompleteTiles() const final;
+    RendererStatistics::Tiles getTileStatistics() const final;
+    RendererStatistics::Memory getMemoryUsage() const final;
 
     void update(Immutable<style::Source::Impl>,
                 const std::vector<Immutable<style::Layer::Impl>>&,
@@ -29,10 +32,9 @@ public:
                           const RenderStyle& style,
                           const RenderedQueryOptions& options) const final;
 
-    std::vector<Feature>
-    querySourceFeatures(const SourceQueryOptions&) const final;
+    void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const final;
 
-    void onLowMemory() final;
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) final;
     void dumpDebugLogs() const final;
 
 private:
@@ -7,6 +7,8 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry.hpp>
 
+#include <mapbox/geometry/envelope.hpp>
+
 namespace mbgl {
 
 using namespace style;
@@ -18,6 +20,17 @@ ShapeAnnotationImpl::ShapeAnnotationImpl(const AnnotationID id_, const uint8_t m
       layerID("com.mapbox.annotations.shape." + util::toString(id)) {
 }
 
+LatLngBounds ShapeAnnotationImpl::bounds() const {
+    const auto box = ShapeAnnotationGeometry::visit(geometry(), [] (const auto& geom) {
+        return mapbox::geometry::envelope(geom);
+    });
+    if (!(box.min.x <= box.max.x && box.min.y <= box.max.y)) {
+        return LatLngBounds::empty();
+    }
+    return LatLngBounds::hull({ util::clamp(box.min.y, -90.0, 90.0), box.min.x },
+                              { util::clamp(box.max.y, -90.0, 90.0), box.max.x });
+}
+
 void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, AnnotationTileData& data) {
     static const double baseTolerance = 4;
 
@@ -5,6 +5,7 @@
 
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/style/style.hpp>
 
 #include <string>
@@ -25,6 +26,9 @@ public:
 
     void updateTileData(const CanonicalTileID&, AnnotationTileData&);
 
+    // The bounds of the geometry, which are empty for empty geometries.
+    LatLngBounds bounds() const;
+
     const AnnotationID id;
     const uint8_t maxZoom;
     const std::string layerID;
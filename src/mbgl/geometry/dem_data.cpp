@@ -0,0 +1,98 @@
+#include <mbgl/geometry/dem_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mbgl {
+
+DEMData::DEMData(const PremultipliedImage& image, const CanonicalTileID& id)
+    : dim(image.size.width),
+      stride(dim + 2),
+      elevations(stride * stride),
+      rowScales(dim),
+      slopes({ image.size.width, image.size.height }) {
+    if (image.size.width != image.size.height || image.size.isEmpty()) {
+        throw std::runtime_error("DEM tiles must be square");
+    }
+
+    // Terrain-RGB tiles are opaque, so their colors aren't changed by premultiplication.
+    const uint8_t* pixel = image.data.get();
+    for (int32_t y = 0; y < dim; y++) {
+        for (int32_t x = 0; x < dim; x++, pixel += 4) {
+            at(x, y) = -10000.0f + (pixel[0] * 65536 + pixel[1] * 256 + pixel[2]) * 0.1f;
+        }
+    }
+
+    for (int32_t x = 0; x < dim; x++) {
+        at(x, -1) = at(x, 0);
+        at(x, dim) = at(x, dim - 1);
+    }
+    for (int32_t y = -1; y <= dim; y++) {
+        at(-1, y) = at(0, y);
+        at(dim, y) = at(dim - 1, y);
+    }
+
+    // Terrain looks flat at low zoom levels, where pixels span kilometers, so its slopes are
+    // exaggerated there. This also keeps small slopes from rounding to flat.
+    const double scale = std::pow(2.0, id.z);
+    const double exaggeration = id.z < 14 ? std::pow(2.0, (14 - id.z) * 0.5) : 1.0;
+    for (int32_t y = 0; y < dim; y++) {
+        const double worldY = (id.y + (y + 0.5) / dim) / scale;
+        const double latitude = std::atan(std::sinh(M_PI * (1 - 2 * worldY)));
+        const double metersPerPixel = util::M2PI * util::EARTH_RADIUS_M * std::cos(latitude) / (dim * scale);
+        // The Sobel operator below weighs differences by a total of 8.
+        rowScales[y] = exaggeration / (8 * metersPerPixel);
+    }
+
+    updateSlopes(0, 0, dim - 1, dim - 1);
+}
+
+void DEMData::backfillBorder(const DEMData& neighbor, int8_t dx, int8_t dy) {
+    if (neighbor.dim != dim) {
+        return;
+    }
+
+    const int32_t x0 = dx == -1 ? -1 : dx == 1 ? dim : 0;
+    const int32_t x1 = dx == -1 ? -1 : dx == 1 ? dim : dim - 1;
+    const int32_t y0 = dy == -1 ? -1 : dy == 1 ? dim : 0;
+    const int32_t y1 = dy == -1 ? -1 : dy == 1 ? dim : dim - 1;
+
+    for (int32_t y = y0; y <= y1; y++) {
+        for (int32_t x = x0; x <= x1; x++) {
+            at(x, y) = neighbor.get(x - dx * dim, y - dy * dim);
+        }
+    }
+
+    updateSlopes(std::max(x0 - 1, 0), std::max(y0 - 1, 0),
+                 std::min(x1 + 1, dim - 1), std::min(y1 + 1, dim - 1));
+}
+
+static uint8_t packSlope(float slope) {
+    const float angle = std::atan(slope) / float(M_PI_2);
+    return static_cast<uint8_t>(128 + std::max(-127.0f, std::min(127.0f, std::round(angle * 127))));
+}
+
+void DEMData::updateSlopes(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    for (int32_t y = y0; y <= y1; y++) {
+        uint8_t* pixel = slopes.data.get() + (y * dim + x0) * 4;
+        for (int32_t x = x0; x <= x1; x++, pixel += 4) {
+            const float a = get(x - 1, y - 1), b = get(x, y - 1), c = get(x + 1, y - 1);
+            const float d = get(x - 1, y),                        f = get(x + 1, y);
+            const float g = get(x - 1, y + 1), h = get(x, y + 1), i = get(x + 1, y + 1);
+
+            pixel[0] = packSlope(((c + 2 * f + i) - (a + 2 * d + g)) * rowScales[y]);
+            pixel[1] = packSlope(((g + 2 * h + i) - (a + 2 * b + c)) * rowScales[y]);
+            pixel[2] = 0;
+            pixel[3] = 255;
+        }
+    }
+}
+
+std::size_t DEMData::byteSize() const {
+    return elevations.size() * sizeof(float) + rowScales.size() * sizeof(float) + slopes.bytes();
+}
+
+} // namespace mbgl
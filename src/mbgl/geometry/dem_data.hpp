@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+class CanonicalTileID;
+
+/*
+    The elevations of a Terrain-RGB tile, and the slopes of the terrain that hillshading is drawn
+    from. Elevations have a border of one pixel on each side, which starts out as a copy of the
+    tile's edges, and is filled in from the tiles around it once they've loaded, so that the
+    slopes along the edges of tiles match up.
+
+    Slopes are stored as the angles of the terrain towards the east and south, in the red and green
+    channels of an image of the tile's size. Each step is a 127th of 90°, with 128 being flat.
+*/
+class DEMData {
+public:
+    DEMData(const PremultipliedImage&, const CanonicalTileID&);
+
+    // Fills in the border shared with the tile at `dx`, `dy` from this one, with both ranging from
+    // -1 to 1, and updates the slopes along it.
+    void backfillBorder(const DEMData& neighbor, int8_t dx, int8_t dy);
+
+    // Elevation in meters, at coordinates from -1 to `dim`.
+    float get(int32_t x, int32_t y) const {
+        return elevations[(y + 1) * stride + (x + 1)];
+    }
+
+    const PremultipliedImage& getSlopes() const {
+        return slopes;
+    }
+
+    std::size_t byteSize() const;
+
+    const int32_t dim;
+
+private:
+    float& at(int32_t x, int32_t y) {
+        return elevations[(y + 1) * stride + (x + 1)];
+    }
+
+    void updateSlopes(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+
+    const int32_t stride;
+    std::vector<float> elevations;
+    // Converts the elevation differences of a row into slopes.
+    std::vector<float> rowScales;
+    PremultipliedImage slopes;
+};
+
+} // namespace mbgl
@@ -8,12 +8,13 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/math/minmax.hpp>
 #include <mbgl/style/filter.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
 
 #include <mapbox/geometry/envelope.hpp>
 
 #include <cassert>
+#include <limits>
 #include <string>
 
 namespace mbgl {
@@ -27,11 +28,35 @@ void FeatureIndex::insert(const GeometryCollection& geometries,
                           const std::string& sourceLayerName,
                           const std::string& bucketName) {
     for (const auto& ring : geometries) {
-        grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
-                    mapbox::geometry::envelope(ring));
+        insert(mapbox::geometry::envelope(ring), index, sourceLayerName, bucketName);
     }
 }
 
+void FeatureIndex::insert(const BBox& envelope,
+                          std::size_t index,
+                          const std::string& sourceLayerName,
+                          const std::string& bucketName) {
+    grid.insert(IndexedFeature { static_cast<uint32_t>(index), getSourceLayerID(sourceLayerName), getBucketID(bucketName) }, envelope);
+}
+
+uint16_t FeatureIndex::getSourceLayerID(const std::string& sourceLayerName) {
+    auto sourceLayer = sourceLayerIDs.emplace(sourceLayerName, sourceLayerNames.size());
+    if (sourceLayer.second) {
+        assert(sourceLayerNames.size() < std::numeric_limits<uint16_t>::max());
+        sourceLayerNames.push_back(sourceLayerName);
+    }
+    return sourceLayer.first->second;
+}
+
+uint16_t FeatureIndex::getBucketID(const std::string& bucketName) {
+    auto bucket = bucketIDs.emplace(bucketName, bucketLayerIDs.size());
+    if (bucket.second) {
+        assert(bucketLayerIDs.size() < std::numeric_limits<uint16_t>::max());
+        bucketLayerIDs.emplace_back();
+    }
+    return bucket.first->second;
+}
+
 static bool vectorContains(const std::vector<std::string>& vector, const std::string& s) {
     return std::find(vector.begin(), vector.end(), s) != vector.end();
 }
@@ -45,10 +70,6 @@ static bool vectorsIntersect(const std::vector<std::string>& vectorA, const std:
     return false;
 }
 
-static bool topDown(const IndexedSubfeature& a, const IndexedSubfeature& b) {
-    return a.sortIndex > b.sortIndex;
-}
-
 static bool topDownSymbols(const IndexedSubfeature& a, const IndexedSubfeature& b) {
     return a.sortIndex < b.sortIndex;
 }
@@ -102,18 +123,18 @@ void FeatureIndex::query(
 
     // Query the grid index
     mapbox::geometry::box<int16_t> box = mapbox::geometry::envelope(queryGeometry);
-    std::vector<IndexedSubfeature> features = grid.query({ box.min - additionalRadius, box.max + additionalRadius });
-
-
-    std::sort(features.begin(), features.end(), topDown);
-    size_t previousSortIndex = std::numeric_limits<size_t>::max();
-    for (const auto& indexedFeature : features) {
-
-        // If this feature is the same as the previous feature, skip it.
-        if (indexedFeature.sortIndex == previousSortIndex) continue;
-        previousSortIndex = indexedFeature.sortIndex;
-
-        addFeature(result, indexedFeature, queryGeometry, queryOptions, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+    std::vector<std::size_t> ids;
+    grid.query({ box.min - additionalRadius, box.max + additionalRadius }, ids);
+
+    // Compile the filter once for all features in this tile.
+    const style::CompiledFilter filter = queryOptions.filter ? style::CompiledFilter(*queryOptions.filter) : style::CompiledFilter();
+
+    // Features inserted later are drawn on top, so they come first.
+    for (auto it = ids.rbegin(); it != ids.rend(); ++it) {
+        const IndexedFeature& indexedFeature = grid.get(*it);
+        addFeature(result, indexedFeature.index, sourceLayerNames[indexedFeature.sourceLayer],
+                   bucketLayerIDs[indexedFeature.bucket], queryGeometry, queryOptions, filter,
+                   geometryTileData, tileID, style, bearing, pixelsToTileUnits);
     }
 
     // Query symbol features, if they've been placed.
@@ -124,32 +145,42 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> symbolFeatures = collisionTile->queryRenderedSymbols(queryGeometry, scale);
     std::sort(symbolFeatures.begin(), symbolFeatures.end(), topDownSymbols);
     for (const auto& symbolFeature : symbolFeatures) {
-        addFeature(result, symbolFeature, queryGeometry, queryOptions, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        // The collision tile is always that of the layout this index was built by.
+        assert(symbolFeature.sourceLayer < sourceLayerNames.size());
+        assert(symbolFeature.bucket < bucketLayerIDs.size());
+        addFeature(result, symbolFeature.index, sourceLayerNames[symbolFeature.sourceLayer], bucketLayerIDs[symbolFeature.bucket],
+                   queryGeometry, queryOptions, filter, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
     }
 }
 
 void FeatureIndex::addFeature(
     std::unordered_map<std::string, std::vector<Feature>>& result,
-    const IndexedSubfeature& indexedFeature,
+    const std::size_t index,
+    const std::string& sourceLayerName,
+    const std::vector<std::string>& layerIDs,
     const GeometryCoordinates& queryGeometry,
     const RenderedQueryOptions& options,
+    const style::CompiledFilter& filter,
     const GeometryTileData& geometryTileData,
     const CanonicalTileID& tileID,
     const RenderStyle& style,
     const float bearing,
     const float pixelsToTileUnits) const {
 
-    auto& layerIDs = bucketLayerIDs.at(indexedFeature.bucketName);
     if (options.layerIDs && !vectorsIntersect(layerIDs, *options.layerIDs)) {
         return;
     }
 
-    auto sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName);
+    auto sourceLayer = geometryTileData.getLayer(sourceLayerName);
     assert(sourceLayer);
 
-    auto geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
+    auto geometryTileFeature = sourceLayer->getFeature(index);
     assert(geometryTileFeature);
 
+    // The filter doesn't depend on the layer, and the feature is only converted once it matches.
+    optional<bool> passesFilter;
+    optional<Feature> feature;
+
     for (const auto& layerID : layerIDs) {
         if (options.layerIDs && !vectorContains(*options.layerIDs, layerID)) {
             continue;
@@ -162,11 +193,17 @@ void FeatureIndex::addFeature(
             continue;
         }
 
-        if (options.filter && !(*options.filter)(*geometryTileFeature)) {
-            continue;
+        if (!passesFilter) {
+            passesFilter = filter(*geometryTileFeature);
+        }
+        if (!*passesFilter) {
+            return;
         }
 
-        result[layerID].push_back(convertFeature(*geometryTileFeature, tileID));
+        if (!feature) {
+            feature = convertFeature(*geometryTileFeature, tileID);
+        }
+        result[layerID].push_back(*feature);
     }
 }
 
@@ -193,7 +230,17 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
 }
 
 void FeatureIndex::setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs) {
-    bucketLayerIDs[bucketName] = layerIDs;
+    bucketLayerIDs[getBucketID(bucketName)] = layerIDs;
+}
+
+std::size_t FeatureIndex::byteSize() const {
+    return grid.byteSize();
+}
+
+std::size_t FeatureIndex::compact() {
+    const std::size_t before = byteSize();
+    grid.pack();
+    return before - byteSize();
 }
 
 } // namespace mbgl
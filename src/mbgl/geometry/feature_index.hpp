@@ -18,21 +18,41 @@ class RenderStyle;
 class CollisionTile;
 class CanonicalTileID;
 
+namespace style {
+class CompiledFilter;
+} // namespace style
+
+// A symbol's entry in the CollisionTile, with the source layer and bucket IDs of the FeatureIndex
+// of the same layout.
 class IndexedSubfeature {
 public:
     IndexedSubfeature() = delete;
-    std::size_t index;
-    std::string sourceLayerName;
-    std::string bucketName;
-    size_t sortIndex;
+    uint32_t index;
+    uint16_t sourceLayer;
+    uint16_t bucket;
+    uint32_t sortIndex;
+};
+
+// A feature's entry in the FeatureIndex grid. The source layer and bucket are interned by the
+// index, so querying copies no names. Entries are inserted in sort order.
+class IndexedFeature {
+public:
+    uint32_t index;
+    uint16_t sourceLayer;
+    uint16_t bucket;
 };
 
 class FeatureIndex {
 public:
     FeatureIndex();
 
+    using BBox = GridIndex<IndexedFeature>::BBox;
+
     void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
 
+    // Inserts a single ring whose envelope has already been computed.
+    void insert(const BBox& envelope, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
+
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCoordinates& queryGeometry,
@@ -55,21 +75,36 @@ public:
 
     void setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs);
 
+    // The IDs the index stores the names with, for the IndexedSubfeatures of the same layout.
+    uint16_t getSourceLayerID(const std::string& sourceLayerName);
+    uint16_t getBucketID(const std::string& bucketName);
+
+    std::size_t byteSize() const;
+
+    // Packs the grid once all features are inserted, and returns the bytes freed.
+    std::size_t compact();
+
 private:
     void addFeature(
             std::unordered_map<std::string, std::vector<Feature>>& result,
-            const IndexedSubfeature&,
+            std::size_t index,
+            const std::string& sourceLayerName,
+            const std::vector<std::string>& layerIDs,
             const GeometryCoordinates& queryGeometry,
             const RenderedQueryOptions& options,
+            const style::CompiledFilter&,
             const GeometryTileData&,
             const CanonicalTileID&,
             const RenderStyle&,
             const float bearing,
             const float pixelsToTileUnits) const;
 
-    GridIndex<IndexedSubfeature> grid;
-    unsigned int sortIndex = 0;
+    GridIndex<IndexedFeature> grid;
+
+    std::unordered_map<std::string, uint16_t> sourceLayerIDs;
+    std::vector<std::string> sourceLayerNames;
 
-    std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+    std::unordered_map<std::string, uint16_t> bucketIDs;
+    std::vector<std::vector<std::string>> bucketLayerIDs;
 };
 } // namespace mbgl
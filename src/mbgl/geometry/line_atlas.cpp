@@ -11,8 +11,7 @@
 namespace mbgl {
 
 LineAtlas::LineAtlas(const Size size)
-    : image(size),
-      dirty(true) {
+    : image(size) {
 }
 
 LineAtlas::~LineAtlas() = default;
@@ -112,8 +111,6 @@ LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatte
 
     nextRow += dashheight;
 
-    dirty = true;
-
     return position;
 }
 
@@ -121,14 +118,24 @@ Size LineAtlas::getSize() const {
     return image.size;
 }
 
+RendererStatistics::Memory LineAtlas::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = image.bytes();
+    memory.gpu = texture ? texture->size.area() : 0;
+    return memory;
+}
+
 void LineAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (!texture) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
-        context.updateTexture(*texture, image, unit);
+    } else if (uploadedRows < nextRow) {
+        const Size size { image.size.width, nextRow - uploadedRows };
+        AlphaImage rows(size);
+        AlphaImage::copy(image, rows, { 0, uploadedRows }, { 0, 0 }, size);
+        context.updateTextureSubImage(*texture, rows, { 0, static_cast<uint16_t>(uploadedRows) }, unit);
     }
 
-    dirty = false;
+    uploadedRows = nextRow;
 }
 
 void LineAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
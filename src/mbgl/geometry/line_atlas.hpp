@@ -2,6 +2,7 @@
 
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/gl/object.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/optional.hpp>
 
@@ -36,7 +37,7 @@ public:
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // once the texture exists, only the rows of dashes added since are uploaded.
     void upload(gl::Context&, gl::TextureUnit unit);
 
     LinePatternPos getDashPosition(const std::vector<float>&, LinePatternCap);
@@ -44,9 +45,13 @@ public:
 
     Size getSize() const;
 
+    // Memory held by the atlas image, and by its texture once uploaded.
+    RendererStatistics::Memory memoryUsage() const;
+
 private:
     const AlphaImage image;
-    bool dirty;
+    // Dashes are added in rows from the top, so only the rows from here on need uploading.
+    uint32_t uploadedRows = 0;
     mbgl::optional<gl::Texture> texture;
     uint32_t nextRow = 0;
     std::unordered_map<size_t, LinePatternPos> positions;
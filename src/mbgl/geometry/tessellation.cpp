@@ -0,0 +1,132 @@
+#include <mbgl/geometry/tessellation.hpp>
+
+#include <mapbox/earcut.hpp>
+
+namespace mapbox {
+namespace util {
+template <> struct nth<0, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
+};
+
+template <> struct nth<1, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
+};
+} // namespace util
+} // namespace mapbox
+
+namespace mbgl {
+
+namespace {
+
+int sign(int64_t value) {
+    return (value > 0) - (value < 0);
+}
+
+// The number of times the sign of the x (or y) extent of the edges of the ring changes, once
+// around the ring. Rings that turn consistently but wind around more than once change it more
+// than twice.
+template <class Extent>
+std::size_t directionChanges(std::size_t n, Extent&& extent) {
+    int last = 0;
+    for (std::size_t i = n; last == 0 && i-- > 0;) {
+        last = sign(extent(i));
+    }
+
+    std::size_t changes = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const int current = sign(extent(i));
+        if (current != 0) {
+            changes += current != last;
+            last = current;
+        }
+    }
+    return changes;
+}
+
+// Whether the first n points of the ring form a convex polygon. Collinear points are allowed.
+bool isConvex(const GeometryCoordinates& ring, std::size_t n) {
+    if (n < 3) {
+        return false;
+    }
+
+    int turn = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const GeometryCoordinate& a = ring[i];
+        const GeometryCoordinate& b = ring[(i + 1) % n];
+        const GeometryCoordinate& c = ring[(i + 2) % n];
+        const int current = sign(int64_t(b.x - a.x) * (c.y - b.y) - int64_t(b.y - a.y) * (c.x - b.x));
+        if (current != 0) {
+            if (turn != 0 && current != turn) {
+                return false;
+            }
+            turn = current;
+        }
+    }
+
+    // All points on a line.
+    if (turn == 0) {
+        return false;
+    }
+
+    return directionChanges(n, [&] (std::size_t i) { return int64_t(ring[(i + 1) % n].x) - ring[i].x; }) <= 2 &&
+           directionChanges(n, [&] (std::size_t i) { return int64_t(ring[(i + 1) % n].y) - ring[i].y; }) <= 2;
+}
+
+} // namespace
+
+std::vector<uint32_t> tessellate(const GeometryCollection& polygon) {
+    if (polygon.size() == 1) {
+        const GeometryCoordinates& ring = polygon[0];
+        // The closing point repeats the first one, and isn't part of the fan.
+        const std::size_t n = ring.size() > 1 && ring.front() == ring.back() ? ring.size() - 1 : ring.size();
+
+        if (isConvex(ring, n)) {
+            std::vector<uint32_t> indices;
+            indices.reserve(3 * (n - 2));
+            for (uint32_t i = 1; i + 1 < n; i++) {
+                indices.push_back(0);
+                indices.push_back(i);
+                indices.push_back(i + 1);
+            }
+            return indices;
+        }
+    }
+
+    return mapbox::earcut(polygon);
+}
+
+const FeatureTessellation* TessellationCache::get(const std::string& sourceLayer, std::size_t feature) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto layer = layers.find(sourceLayer);
+    if (layer == layers.end()) {
+        return nullptr;
+    }
+
+    auto it = layer->second.find(feature);
+    return it == layer->second.end() ? nullptr : &it->second;
+}
+
+void TessellationCache::add(const std::string& sourceLayer, std::size_t feature, FeatureTessellation tessellation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Another bucket of the source layer may have added the feature in the meantime; entries that
+    // are handed out are never replaced.
+    layers[sourceLayer].emplace(feature, std::move(tessellation));
+}
+
+std::size_t TessellationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t result = 0;
+    for (const auto& layer : layers) {
+        for (const auto& feature : layer.second) {
+            result += sizeof(feature) + 2 * sizeof(void*) + feature.second.capacity() * sizeof(std::vector<uint32_t>);
+            for (const auto& polygon : feature.second) {
+                result += polygon.capacity() * sizeof(uint32_t);
+            }
+        }
+    }
+    layers.clear();
+    return result;
+}
+
+} // namespace mbgl
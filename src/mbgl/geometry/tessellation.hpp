@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+// Triangulates a polygon, an exterior ring followed by its holes, into indices of its vertices in
+// ring order, like mapbox::earcut(). Convex rings without holes, which most buildings are, are
+// triangulated as a fan instead.
+std::vector<uint32_t> tessellate(const GeometryCollection& polygon);
+
+// The triangulations of the polygons of a feature, in the order classifyRings() returns them.
+using FeatureTessellation = std::vector<std::vector<uint32_t>>;
+
+/*
+   The triangulations of the polygons of a tile's features, by source layer and index of the
+   feature. They only depend on the geometries of the tile, so layouts of the tile for a changed
+   style reuse them until its data changes. Safe to use from the parallel bucket jobs of a layout.
+*/
+class TessellationCache : private util::noncopyable {
+public:
+    // The cached triangulations of the feature, or nullptr.
+    const FeatureTessellation* get(const std::string& sourceLayer, std::size_t feature) const;
+    void add(const std::string& sourceLayer, std::size_t feature, FeatureTessellation);
+
+    // Removes all triangulations, and returns the bytes they took.
+    std::size_t clear();
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::unordered_map<std::size_t, FeatureTessellation>> layers;
+};
+
+} // namespace mbgl
@@ -1,9 +1,28 @@
 #include <mbgl/gl/attribute.hpp>
 #include <mbgl/gl/gl.hpp>
 
+#include <boost/functional/hash.hpp>
+
 namespace mbgl {
 namespace gl {
 
+std::size_t hashBindings(const AttributeBindingArray& bindings, std::size_t seed) {
+    for (const auto& binding : bindings) {
+        if (!binding) {
+            boost::hash_combine(seed, false);
+            continue;
+        }
+        boost::hash_combine(seed, static_cast<uint32_t>(binding->attributeType));
+        boost::hash_combine(seed, binding->attributeSize);
+        boost::hash_combine(seed, binding->attributeOffset);
+        boost::hash_combine(seed, binding->vertexBuffer);
+        boost::hash_combine(seed, binding->vertexSize);
+        boost::hash_combine(seed, binding->vertexOffset);
+        boost::hash_combine(seed, binding->divisor);
+    }
+    return seed;
+}
+
 void bindAttributeLocation(ProgramID id, AttributeLocation location, const char* name) {
     if (location >= MAX_ATTRIBUTES) {
         throw gl::Error("too many vertex attributes");
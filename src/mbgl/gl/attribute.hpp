@@ -38,15 +38,22 @@ public:
     uint32_t vertexSize;
     uint32_t vertexOffset;
 
+    // Non-zero for attributes that advance once per this many instances rather than per vertex.
+    uint32_t divisor = 0;
+
     friend bool operator==(const AttributeBinding& lhs,
                            const AttributeBinding& rhs) {
-        return std::tie(lhs.attributeType, lhs.attributeSize, lhs.attributeOffset, lhs.vertexBuffer, lhs.vertexSize, lhs.vertexOffset)
-            == std::tie(rhs.attributeType, rhs.attributeSize, rhs.attributeOffset, rhs.vertexBuffer, rhs.vertexSize, rhs.vertexOffset);
+        return std::tie(lhs.attributeType, lhs.attributeSize, lhs.attributeOffset, lhs.vertexBuffer, lhs.vertexSize, lhs.vertexOffset, lhs.divisor)
+            == std::tie(rhs.attributeType, rhs.attributeSize, rhs.attributeOffset, rhs.vertexBuffer, rhs.vertexSize, rhs.vertexOffset, rhs.divisor);
     }
 };
 
 using AttributeBindingArray = std::array<optional<AttributeBinding>, MAX_ATTRIBUTES>;
 
+// Hashes the bindings of all locations into `seed`, which tells the sets of buffers vertex arrays
+// are bound to apart without comparing them location by location.
+std::size_t hashBindings(const AttributeBindingArray&, std::size_t seed = 0);
+
 /*
     gl::Attribute<T,N> manages the binding of a vertex buffer to a GL program attribute.
       - T is the underlying primitive type (exposed as Attribute<T,N>::ValueType)
@@ -74,12 +81,12 @@ public:
         static_assert(std::is_standard_layout<Vertex>::value, "vertex type must use standard layout");
         assert(attributeSize >= 1);
         assert(attributeSize <= 4);
-        assert(Vertex::attributeOffsets[attributeIndex] <= std::numeric_limits<uint32_t>::max());
+        assert(buffer.byteOffset + Vertex::attributeOffsets[attributeIndex] <= std::numeric_limits<uint32_t>::max());
         static_assert(sizeof(Vertex) <= std::numeric_limits<uint32_t>::max(), "vertex too large");
         return AttributeBinding {
             DataTypeOf<T>::value,
             static_cast<uint8_t>(attributeSize),
-            static_cast<uint32_t>(Vertex::attributeOffsets[attributeIndex]),
+            static_cast<uint32_t>(buffer.byteOffset + Vertex::attributeOffsets[attributeIndex]),
             buffer.buffer,
             static_cast<uint32_t>(sizeof(Vertex)),
             0,
@@ -96,6 +103,16 @@ public:
             return binding;
         }
     }
+
+    static optional<Binding> instanceBinding(const optional<Binding>& binding) {
+        if (binding) {
+            AttributeBinding result = *binding;
+            result.divisor = 1;
+            return result;
+        } else {
+            return binding;
+        }
+    }
 };
 
 #define MBGL_DEFINE_ATTRIBUTE(type_, n_, name_)        \
@@ -275,6 +292,11 @@ public:
         return Bindings { As::Type::offsetBinding(bindings.template get<As>(), vertexOffset)... };
     }
 
+    // Turns the bindings into ones that advance once per instance.
+    static Bindings instanceBindings(const Bindings& bindings) {
+        return Bindings { As::Type::instanceBinding(bindings.template get<As>())... };
+    }
+
     static AttributeBindingArray toBindingArray(const Locations& locations, const Bindings& bindings) {
         AttributeBindingArray result;
 
@@ -0,0 +1,88 @@
+#include <mbgl/gl/buffer_arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace mbgl {
+namespace gl {
+
+BufferArena::BufferArena(std::size_t size_)
+    : size(size_) {
+    if (size) {
+        freeRanges.emplace(0, size);
+    }
+}
+
+std::size_t BufferArena::align(std::size_t bytes) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+std::map<std::size_t, std::size_t>::const_iterator BufferArena::bestFit(std::size_t bytes) const {
+    auto best = freeRanges.end();
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second >= bytes && (best == freeRanges.end() || it->second < best->second)) {
+            best = it;
+        }
+    }
+    return best;
+}
+
+optional<std::size_t> BufferArena::fit(std::size_t bytes) const {
+    auto it = bestFit(align(bytes));
+    if (it == freeRanges.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+optional<std::size_t> BufferArena::allocate(std::size_t bytes) {
+    bytes = align(bytes);
+    auto it = bestFit(bytes);
+    if (it == freeRanges.end()) {
+        return {};
+    }
+
+    const std::size_t offset = it->first;
+    const std::size_t remaining = it->second - bytes;
+    freeRanges.erase(it);
+    if (remaining) {
+        freeRanges.emplace(offset + bytes, remaining);
+    }
+    used += bytes;
+    return offset;
+}
+
+void BufferArena::release(std::size_t offset, std::size_t bytes) {
+    bytes = align(bytes);
+    assert(offset + bytes <= size);
+    assert(used >= bytes);
+    used -= bytes;
+
+    auto next = freeRanges.lower_bound(offset);
+    assert(next == freeRanges.end() || next->first >= offset + bytes);
+    if (next != freeRanges.end() && next->first == offset + bytes) {
+        bytes += next->second;
+        next = freeRanges.erase(next);
+    }
+    if (next != freeRanges.begin()) {
+        auto previous = std::prev(next);
+        assert(previous->first + previous->second <= offset);
+        if (previous->first + previous->second == offset) {
+            previous->second += bytes;
+            return;
+        }
+    }
+    freeRanges.emplace_hint(next, offset, bytes);
+}
+
+std::size_t BufferArena::getLargestFreeRange() const {
+    std::size_t largest = 0;
+    for (const auto& range : freeRanges) {
+        largest = std::max(largest, range.second);
+    }
+    return largest;
+}
+
+} // namespace gl
+} // namespace mbgl
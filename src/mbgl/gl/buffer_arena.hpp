@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <map>
+
+namespace mbgl {
+namespace gl {
+
+/*
+    Keeps track of the ranges of a large GL buffer that are in use, so that the small vertex and
+    index buffers of buckets can be ranges of a few shared buffers rather than buffers of their
+    own. Ranges are handed out best fit, and released ranges are merged with the free ranges next
+    to them, so that the ranges of evicted tiles make room for ranges of any size again.
+*/
+class BufferArena {
+public:
+    // Ranges start at multiples of this, which suits any vertex attribute and index type.
+    static constexpr const std::size_t alignment = 16;
+
+    explicit BufferArena(std::size_t size);
+
+    // Returns the size of the free range that a range of `size` bytes would be taken from, or
+    // none if there's no free range large enough.
+    optional<std::size_t> fit(std::size_t size) const;
+
+    // Returns the offset of a range of `size` bytes, or none if there's no free range large
+    // enough.
+    optional<std::size_t> allocate(std::size_t size);
+    void release(std::size_t offset, std::size_t size);
+
+    std::size_t getSize() const { return size; }
+    std::size_t getUsedBytes() const { return used; }
+    std::size_t getFreeRangeCount() const { return freeRanges.size(); }
+    std::size_t getLargestFreeRange() const;
+
+    bool empty() const { return used == 0; }
+
+private:
+    static std::size_t align(std::size_t);
+    std::map<std::size_t, std::size_t>::const_iterator bestFit(std::size_t) const;
+
+    const std::size_t size;
+    std::size_t used = 0;
+
+    // The sizes of the free ranges by their offset; free ranges are never next to each other.
+    std::map<std::size_t, std::size_t> freeRanges;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#define GL_MAP_READ_BIT                            0x0001
+#define GL_MAP_WRITE_BIT                           0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT               0x0008
+#define GL_MAP_UNSYNCHRONIZED_BIT                  0x0020
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class BufferMapping {
+public:
+    template <typename Fn>
+    BufferMapping(const Fn& loadExtension)
+        : mapBufferRange(
+              loadExtension({ { "GL_ARB_map_buffer_range", "glMapBufferRange" },
+                              { "GL_EXT_map_buffer_range", "glMapBufferRangeEXT" } })),
+          unmapBuffer(
+              loadExtension({ { "GL_ARB_map_buffer_range", "glUnmapBuffer" },
+                              { "GL_EXT_map_buffer_range", "glUnmapBufferOES" } })) {
+    }
+
+    const ExtensionFunction<GLvoid*(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)>
+        mapBufferRange;
+
+    const ExtensionFunction<GLboolean(GLenum target)> unmapBuffer;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -3,15 +3,32 @@
 #include <mbgl/gl/debugging_extension.hpp>
 #include <mbgl/gl/vertex_array_extension.hpp>
 #include <mbgl/gl/program_binary_extension.hpp>
+#include <mbgl/gl/buffer_mapping_extension.hpp>
+#include <mbgl/gl/fence_sync_extension.hpp>
+#include <mbgl/gl/parallel_shader_compile_extension.hpp>
+#include <mbgl/gl/timer_query_extension.hpp>
+#include <mbgl/gl/instanced_arrays_extension.hpp>
 #include <mbgl/util/traits.hpp>
 #include <mbgl/util/std.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/math.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 
 namespace mbgl {
 namespace gl {
 
+// From EXT_texture_filter_anisotropic, which not all headers define.
+constexpr GLenum TEXTURE_MAX_ANISOTROPY_EXT = 0x84FE;
+constexpr GLenum MAX_TEXTURE_MAX_ANISOTROPY_EXT = 0x84FF;
+
+static std::size_t textureBytes(const Size size, TextureFormat format, TextureType type = TextureType::UnsignedByte) {
+    return std::size_t(size.width) * size.height * (format == TextureFormat::RGBA ? 4 : 1) *
+           (type == TextureType::HalfFloat ? 2 : 1);
+}
+
 static_assert(underlying_type(ShaderType::Vertex) == GL_VERTEX_SHADER, "OpenGL type mismatch");
 static_assert(underlying_type(ShaderType::Fragment) == GL_FRAGMENT_SHADER, "OpenGL type mismatch");
 
@@ -113,6 +130,42 @@ void Context::initializeExtensions(const std::function<gl::ProcAddress(const cha
 #if MBGL_HAS_BINARY_PROGRAMS
         programBinary = std::make_unique<extension::ProgramBinary>(fn);
 #endif
+        bufferMapping = std::make_unique<extension::BufferMapping>(fn);
+        fenceSync = std::make_unique<extension::FenceSync>(fn);
+        parallelShaderCompile = std::make_unique<extension::ParallelShaderCompile>(fn);
+        timerQuery = std::make_unique<extension::TimerQuery>(
+            fn, strstr(extensions, "GL_EXT_disjoint_timer_query") != nullptr);
+        instancedArrays = std::make_unique<extension::InstancedArrays>(fn);
+
+        if (strstr(extensions, "GL_EXT_texture_filter_anisotropic") != nullptr) {
+            GLfloat value = 0;
+            MBGL_CHECK_ERROR(glGetFloatv(MAX_TEXTURE_MAX_ANISOTROPY_EXT, &value));
+            maxAnisotropy = std::min(value, 16.0f);
+        }
+
+#if MBGL_USE_GLES2
+        halfFloatTextures = strstr(extensions, "OES_texture_half_float") != nullptr &&
+                            strstr(extensions, "EXT_color_buffer_half_float") != nullptr;
+#else
+        halfFloatTextures = strstr(extensions, "ARB_half_float_pixel") != nullptr &&
+                            strstr(extensions, "ARB_color_buffer_float") != nullptr;
+#endif // MBGL_USE_GLES2
+
+        GLint textureSize = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &textureSize));
+        maximumTextureSize = static_cast<uint32_t>(textureSize);
+
+        GLint formatCount = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &formatCount));
+        compressedTextureFormats.resize(formatCount);
+        if (formatCount > 0) {
+            MBGL_CHECK_ERROR(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, compressedTextureFormats.data()));
+        }
+
+        // Let the driver compile and link on as many threads as it likes.
+        if (parallelShaderCompile->maxShaderCompilerThreads) {
+            MBGL_CHECK_ERROR(parallelShaderCompile->maxShaderCompilerThreads(0xFFFFFFFF));
+        }
 
         if (!supportsVertexArrays()) {
             Log::Warning(Event::OpenGL, "Not using Vertex Array Objects");
@@ -210,31 +263,152 @@ void Context::verifyProgramLinkage(ProgramID program_) {
     throw std::runtime_error("program failed to link");
 }
 
-UniqueBuffer Context::createVertexBuffer(const void* data, std::size_t size, const BufferUsage usage) {
+Context::BufferAllocation Context::createVertexBuffer(const void* data, std::size_t size, const BufferUsage usage) {
+    if (usage == BufferUsage::StaticDraw) {
+        if (auto allocation = allocateBufferRange(BufferTarget::Vertex, data, size)) {
+            return std::move(*allocation);
+        }
+    }
+
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
-    UniqueBuffer result { std::move(id), { this } };
+    UniqueBuffer result { std::move(id), { objectOwner } };
     vertexBuffer = result;
     MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, size, data, static_cast<GLenum>(usage)));
-    return result;
+    if (data) {
+        uploadedBytes += size;
+    }
+    return { std::move(result), 0 };
 }
 
-void Context::updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size) {
+void Context::updateVertexBuffer(UniqueBuffer& buffer, std::size_t byteOffset, const void* data, std::size_t size, const BufferUsage usage) {
     vertexBuffer = buffer;
+    uploadedBytes += size;
+
+    if (usage == BufferUsage::StaticDraw) {
+        MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, byteOffset, size, data));
+        return;
+    }
+
+    // Dynamic and streamed buffers are never ranges of arenas.
+    assert(byteOffset == 0);
+
+    if (bufferMapping && bufferMapping->mapBufferRange && bufferMapping->unmapBuffer) {
+        void* mapped = MBGL_CHECK_ERROR(bufferMapping->mapBufferRange(
+            GL_ARRAY_BUFFER, 0, size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        if (mapped) {
+            std::memcpy(mapped, data, size);
+            // The contents are undefined if the storage was lost while mapped; upload them again.
+            if (MBGL_CHECK_ERROR(bufferMapping->unmapBuffer(GL_ARRAY_BUFFER))) {
+                return;
+            }
+        }
+    }
+
+    // Orphan the current storage, so that the upload doesn't wait for pending draws.
+    MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, size, nullptr, static_cast<GLenum>(usage)));
     MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
 }
 
-UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size) {
+void Context::updateVertexBufferRange(UniqueBuffer& buffer, std::size_t offset, const void* data, std::size_t size) {
+    vertexBuffer = buffer;
+    uploadedBytes += size;
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
+Context::BufferAllocation Context::createIndexBuffer(const void* data, std::size_t size) {
+    if (auto allocation = allocateBufferRange(BufferTarget::Index, data, size)) {
+        return std::move(*allocation);
+    }
+
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
-    UniqueBuffer result { std::move(id), { this } };
-    bindVertexArray = 0;
-    globalVertexArrayState.indexBuffer = result;
+    UniqueBuffer result { std::move(id), { objectOwner } };
+    bindBuffer(BufferTarget::Index, result);
     MBGL_CHECK_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
-    return result;
+    uploadedBytes += size;
+    return { std::move(result), 0 };
 }
 
-UniqueTexture Context::createTexture() {
+void Context::bindBuffer(const BufferTarget target, const BufferID id) {
+    if (target == BufferTarget::Vertex) {
+        vertexBuffer = id;
+    } else {
+        // The index buffer binding is part of the vertex array state.
+        bindVertexArray = 0;
+        globalVertexArrayState.indexBuffer = id;
+    }
+}
+
+optional<Context::BufferAllocation> Context::allocateBufferRange(const BufferTarget target, const void* data, const std::size_t size) {
+    // The buffers of upload contexts are released on the thread of the context that owns them,
+    // which mustn't touch the arenas of this one.
+    if (objectOwner != this || size == 0 || size > BufferArenaRangeMax) {
+        return {};
+    }
+
+    // Takes the range from the arena whose free range fits it most tightly, leaving the large
+    // free ranges for large buffers.
+    BufferArenaEntry* entry = nullptr;
+    optional<std::size_t> fit;
+    for (auto& candidate : bufferArenas) {
+        if (candidate->target != target) {
+            continue;
+        }
+        const optional<std::size_t> candidateFit = candidate->arena.fit(size);
+        if (candidateFit && (!fit || *candidateFit < *fit)) {
+            entry = candidate.get();
+            fit = candidateFit;
+        }
+    }
+
+    const GLenum glTarget = target == BufferTarget::Vertex ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER;
+    if (!entry) {
+        BufferID id = 0;
+        MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+        bufferArenas.push_back(std::make_unique<BufferArenaEntry>(BufferArenaEntry {
+            target, UniqueBuffer { std::move(id), { this } }, BufferArena(BufferArenaSize)
+        }));
+        entry = bufferArenas.back().get();
+        bindBuffer(target, entry->buffer);
+        MBGL_CHECK_ERROR(glBufferData(glTarget, BufferArenaSize, nullptr, GL_STATIC_DRAW));
+    } else {
+        bindBuffer(target, entry->buffer);
+    }
+
+    const std::size_t offset = *entry->arena.allocate(size);
+    if (data) {
+        MBGL_CHECK_ERROR(glBufferSubData(glTarget, offset, size, data));
+        uploadedBytes += size;
+    }
+
+    return BufferAllocation {
+        UniqueBuffer { entry->buffer.get(), { this, &entry->arena, offset, size } },
+        offset
+    };
+}
+
+Context::BufferArenaStats Context::getBufferArenaStats() const {
+    BufferArenaStats stats;
+    for (const auto& entry : bufferArenas) {
+        stats.arenas++;
+        stats.reservedBytes += entry->arena.getSize();
+        stats.usedBytes += entry->arena.getUsedBytes();
+        stats.freeRanges += entry->arena.getFreeRangeCount();
+        stats.largestFreeRange = std::max(stats.largestFreeRange, entry->arena.getLargestFreeRange());
+    }
+    return stats;
+}
+
+void Context::releaseBufferArenas(const std::size_t keep) {
+    std::size_t kept[2] = { 0, 0 };
+    bufferArenas.erase(std::remove_if(bufferArenas.begin(), bufferArenas.end(), [&] (const auto& entry) {
+        return entry->arena.empty() && kept[static_cast<std::size_t>(entry->target)]++ >= keep;
+    }), bufferArenas.end());
+}
+
+TextureID Context::genTexture() {
     if (pooledTextures.empty()) {
         pooledTextures.resize(TextureMax);
         MBGL_CHECK_ERROR(glGenTextures(TextureMax, pooledTextures.data()));
@@ -242,7 +416,11 @@ UniqueTexture Context::createTexture() {
 
     TextureID id = pooledTextures.back();
     pooledTextures.pop_back();
-    return UniqueTexture{ std::move(id), { this } };
+    return id;
+}
+
+UniqueTexture Context::createTexture() {
+    return UniqueTexture{ genTexture(), { objectOwner } };
 }
 
 bool Context::supportsVertexArrays() const {
@@ -252,6 +430,27 @@ bool Context::supportsVertexArrays() const {
            vertexArray->deleteVertexArrays;
 }
 
+extension::TimerQuery* Context::getTimerQueryExtension() const {
+    if (timerQuery &&
+        timerQuery->genQueries &&
+        timerQuery->deleteQueries &&
+        timerQuery->queryCounter &&
+        timerQuery->getQueryObjectiv &&
+        timerQuery->getQueryObjectui64v) {
+        return timerQuery.get();
+    }
+    return nullptr;
+}
+
+extension::InstancedArrays* Context::getInstancedArraysExtension() const {
+    if (instancedArrays &&
+        instancedArrays->vertexAttribDivisor &&
+        instancedArrays->drawElementsInstanced) {
+        return instancedArrays.get();
+    }
+    return nullptr;
+}
+
 #if MBGL_HAS_BINARY_PROGRAMS
 bool Context::supportsProgramBinaries() const {
     if (!programBinary || !programBinary->programBinary || !programBinary->getProgramBinary) {
@@ -337,16 +536,70 @@ std::unique_ptr<uint8_t[]> Context::readFramebuffer(const Size size, const Textu
                                   GL_UNSIGNED_BYTE, data.get()));
 
     if (flip) {
-        auto tmp = std::make_unique<uint8_t[]>(stride);
         uint8_t* rgba = data.get();
         for (int i = 0, j = size.height - 1; i < j; i++, j--) {
-            std::memcpy(tmp.get(), rgba + i * stride, stride);
-            std::memcpy(rgba + i * stride, rgba + j * stride, stride);
-            std::memcpy(rgba + j * stride, tmp.get(), stride);
+            std::swap_ranges(rgba + i * stride, rgba + (i + 1) * stride, rgba + j * stride);
+        }
+    }
+
+    return data;
+}
+
+FramebufferReadback Context::startReadFramebuffer(const Size size, const bool flip) {
+#if not MBGL_USE_GLES2
+    if (bufferMapping && bufferMapping->mapBufferRange && bufferMapping->unmapBuffer) {
+        BufferID id = 0;
+        MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+        UniqueBuffer buffer { std::move(id), { objectOwner } };
+
+        pixelStorePack = { 1 };
+
+        // With a pack buffer bound, glReadPixels writes into it at the given offset and returns
+        // without waiting for the GPU.
+        MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer));
+        MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, size.width * 4 * size.height, nullptr, GL_STREAM_READ));
+        MBGL_CHECK_ERROR(glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+        return { size, flip, std::move(buffer), nullptr };
+    }
+#endif // MBGL_USE_GLES2
+
+    return { size, flip, {}, readFramebuffer(size, TextureFormat::RGBA, flip) };
+}
+
+std::unique_ptr<uint8_t[]> Context::finishReadFramebuffer(FramebufferReadback& readback) {
+    if (!readback.buffer) {
+        return std::move(readback.data);
+    }
+
+#if not MBGL_USE_GLES2
+    assert(bufferMapping);
+    const Size size = readback.size;
+    const size_t stride = size.width * 4;
+    auto data = std::make_unique<uint8_t[]>(stride * size.height);
+
+    // Mapping the buffer waits for the read to complete.
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, *readback.buffer));
+    const auto* mapped = static_cast<const uint8_t*>(MBGL_CHECK_ERROR(bufferMapping->mapBufferRange(
+        GL_PIXEL_PACK_BUFFER, 0, stride * size.height, GL_MAP_READ_BIT)));
+    if (mapped) {
+        for (uint32_t i = 0; i < size.height; i++) {
+            const uint32_t row = readback.flip ? size.height - 1 - i : i;
+            std::memcpy(data.get() + i * stride, mapped + row * stride, stride);
         }
+        MBGL_CHECK_ERROR(bufferMapping->unmapBuffer(GL_PIXEL_PACK_BUFFER));
+    } else {
+        Log::Warning(Event::OpenGL, "Failed to map the pixel pack buffer");
     }
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
 
+    readback.buffer = {};
     return data;
+#else
+    assert(false);
+    return nullptr;
+#endif // MBGL_USE_GLES2
 }
 
 #if not MBGL_USE_GLES2
@@ -466,10 +719,10 @@ Context::createFramebuffer(const Texture& color,
 }
 
 UniqueTexture
-Context::createTexture(const Size size, const void* data, TextureFormat format, TextureUnit unit) {
+Context::createTexture(const Size size, const void* data, TextureFormat format, TextureUnit unit, TextureType type) {
     auto obj = createTexture();
     pixelStoreUnpack = { 1 };
-    updateTexture(obj, size, data, format, unit);
+    updateTexture(obj, size, data, format, unit, type);
     // We are using clamp to edge here since OpenGL ES doesn't allow GL_REPEAT on NPOT textures.
     // We use those when the pixelRatio isn't a power of two, e.g. on iPhone 6 Plus.
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
@@ -479,13 +732,161 @@ Context::createTexture(const Size size, const void* data, TextureFormat format,
     return obj;
 }
 
+Texture Context::createTexture(const CompressedImage& image, TextureUnit unit) {
+    assert(supportsCompressedTextureFormat(image.format));
+    auto obj = createTexture();
+    activeTexture = unit;
+    texture[unit] = obj;
+    MBGL_CHECK_ERROR(glCompressedTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLenum>(image.format),
+                                            image.size.width, image.size.height, 0,
+                                            static_cast<GLsizei>(image.bytes()), image.data.get()));
+    uploadedBytes += image.bytes();
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    return { image.size, std::move(obj) };
+}
+
+Texture Context::createTileTexture(const PremultipliedImage& image, bool mipmap, TextureUnit unit) {
+    auto it = std::find_if(tileTextures.begin(), tileTextures.end(), [&] (const auto& entry) {
+        return entry.first == image.size;
+    });
+
+    const bool reused = it != tileTextures.end();
+    TextureID id;
+    if (reused) {
+        id = it->second;
+        tileTextures.erase(it);
+        tileTexturePoolStats.hits++;
+    } else {
+        id = genTexture();
+        tileTexturePoolStats.misses++;
+    }
+    UniqueTexture obj{ std::move(id), { objectOwner, image.size } };
+
+    activeTexture = unit;
+    texture[unit] = obj;
+    pixelStoreUnpack = { 1 };
+    if (reused) {
+        // Overwriting the pixels keeps the storage the texture has already.
+        MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.size.width, image.size.height,
+                                         GL_RGBA, GL_UNSIGNED_BYTE, image.data.get()));
+    } else {
+        MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.size.width, image.size.height,
+                                      0, GL_RGBA, GL_UNSIGNED_BYTE, image.data.get()));
+    }
+    uploadedBytes += image.bytes();
+
+    // Pooled textures may have been sampled differently by the tile that used them before.
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+
+    if (mipmap && util::isPowerOfTwo(image.size.width) && util::isPowerOfTwo(image.size.height)) {
+        MBGL_CHECK_ERROR(glGenerateMipmap(GL_TEXTURE_2D));
+        if (maxAnisotropy > 1) {
+            MBGL_CHECK_ERROR(glTexParameterf(GL_TEXTURE_2D, TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy));
+        }
+    }
+
+    return { image.size, std::move(obj) };
+}
+
+void Context::releaseTileTextures() {
+    for (const auto& entry : tileTextures) {
+        abandonedTextures.push_back(entry.second);
+    }
+    tileTextures.clear();
+}
+
+Context::RenderTarget Context::createRenderTarget(const Size size, const bool depth, const TextureType type) {
+    // A target of the same size can be drawn into as it is.
+    auto it = std::find_if(renderTargets.begin(), renderTargets.end(), [&] (const auto& entry) {
+        return bool(entry.depth) == depth && entry.type == type && entry.texture.size == size;
+    });
+    if (it == renderTargets.end()) {
+        it = std::find_if(renderTargets.begin(), renderTargets.end(), [&] (const auto& entry) {
+            return bool(entry.depth) == depth && entry.type == type;
+        });
+    }
+
+    if (it == renderTargets.end()) {
+        renderTargetPoolStats.misses++;
+        Texture color = createTexture(size, TextureFormat::RGBA, 0, type);
+        if (depth) {
+            auto depthTarget = createRenderbuffer<RenderbufferType::DepthComponent>(size);
+            Framebuffer fbo = createFramebuffer(color, depthTarget);
+            return { std::move(color), type, std::move(fbo), std::move(depthTarget) };
+        }
+        Framebuffer fbo = createFramebuffer(color);
+        return { std::move(color), type, std::move(fbo), {} };
+    }
+
+    renderTargetPoolStats.hits++;
+    RenderTarget target = std::move(*it);
+    renderTargets.erase(it);
+
+    bindFramebuffer = target.framebuffer.framebuffer;
+    if (target.texture.size != size) {
+        // Respecifying the storage of the attachments keeps them attached to the framebuffer.
+        updateTexture(target.texture.texture, size, nullptr, TextureFormat::RGBA, 0, type);
+        target.texture.size = size;
+        if (target.depth) {
+            bindRenderbuffer = target.depth->renderbuffer;
+            MBGL_CHECK_ERROR(glRenderbufferStorage(
+                GL_RENDERBUFFER, static_cast<GLenum>(RenderbufferType::DepthComponent), size.width, size.height));
+            bindRenderbuffer = 0;
+            target.depth->size = size;
+        }
+        target.framebuffer.size = size;
+        checkFramebuffer();
+    }
+    return target;
+}
+
+void Context::releaseRenderTarget(RenderTarget target) {
+    if (renderTargets.size() < RenderTargetMax) {
+        renderTargets.push_back(std::move(target));
+    }
+}
+
+void Context::releaseRenderTargets() {
+    // Their objects are abandoned as they're destroyed.
+    renderTargets.clear();
+}
+
+bool Context::supportsCompressedTextureFormat(CompressedImageFormat format) const {
+    return std::find(compressedTextureFormats.begin(), compressedTextureFormats.end(),
+                     int32_t(format)) != compressedTextureFormats.end();
+}
+
 void Context::updateTexture(
-    TextureID id, const Size size, const void* data, TextureFormat format, TextureUnit unit) {
+    TextureID id, const Size size, const void* data, TextureFormat format, TextureUnit unit, TextureType type) {
+    assert(type != TextureType::HalfFloat || halfFloatTextures);
     activeTexture = unit;
     texture[unit] = id;
     MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLenum>(format), size.width,
-                                  size.height, 0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
+                                  size.height, 0, static_cast<GLenum>(format), static_cast<GLenum>(type),
                                   data));
+    if (data) {
+        uploadedBytes += textureBytes(size, format, type);
+    }
+}
+
+void Context::updateTextureSubImage(TextureID id,
+                                    const Point<uint16_t>& offset,
+                                    const Size size,
+                                    const void* data,
+                                    TextureFormat format,
+                                    TextureUnit unit) {
+    activeTexture = unit;
+    texture[unit] = id;
+    pixelStoreUnpack = { 1 };
+    MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, size.width, size.height,
+                                     static_cast<GLenum>(format), GL_UNSIGNED_BYTE, data));
+    uploadedBytes += textureBytes(size, format);
 }
 
 void Context::bindTexture(Texture& obj,
@@ -532,6 +933,9 @@ void Context::bindTexture(Texture& obj,
 }
 
 void Context::reset() {
+    releaseRenderTargets();
+    releaseTileTextures();
+    releaseBufferArenas();
     std::copy(pooledTextures.begin(), pooledTextures.end(), std::back_inserter(abandonedTextures));
     pooledTextures.resize(0);
     performCleanup();
@@ -540,40 +944,59 @@ void Context::reset() {
 void Context::setDirtyState() {
     // Note: does not set viewport/scissorTest/bindFramebuffer to dirty
     // since they are handled separately in the view object.
-    stencilFunc.setDirty();
-    stencilMask.setDirty();
-    stencilTest.setDirty();
-    stencilOp.setDirty();
-    depthRange.setDirty();
-    depthMask.setDirty();
-    depthTest.setDirty();
-    depthFunc.setDirty();
-    blend.setDirty();
-    blendEquation.setDirty();
-    blendFunc.setDirty();
-    blendColor.setDirty();
-    colorMask.setDirty();
-    clearDepth.setDirty();
-    clearColor.setDirty();
-    clearStencil.setDirty();
-    program.setDirty();
-    lineWidth.setDirty();
-    activeTexture.setDirty();
-    pixelStorePack.setDirty();
-    pixelStoreUnpack.setDirty();
+    setDirtyState(DirtyProgram | DirtyVertexArrays | DirtyTextures | DirtyDepth | DirtyStencil |
+                  DirtyColor | DirtyOther);
+}
+
+void Context::setDirtyState(const uint32_t groups) {
+    if (groups & DirtyStencil) {
+        stencilFunc.setDirty();
+        stencilMask.setDirty();
+        stencilTest.setDirty();
+        stencilOp.setDirty();
+        clearStencil.setDirty();
+    }
+    if (groups & DirtyDepth) {
+        depthRange.setDirty();
+        depthMask.setDirty();
+        depthTest.setDirty();
+        depthFunc.setDirty();
+        clearDepth.setDirty();
+    }
+    if (groups & DirtyColor) {
+        blend.setDirty();
+        blendEquation.setDirty();
+        blendFunc.setDirty();
+        blendColor.setDirty();
+        colorMask.setDirty();
+        clearColor.setDirty();
+    }
+    if (groups & DirtyProgram) {
+        program.setDirty();
+    }
+    if (groups & DirtyTextures) {
+        activeTexture.setDirty();
+        pixelStorePack.setDirty();
+        pixelStoreUnpack.setDirty();
+        for (auto& tex : texture) {
+           tex.setDirty();
+        }
+    }
+    if (groups & DirtyVertexArrays) {
+        vertexBuffer.setDirty();
+        bindVertexArray.setDirty();
+        globalVertexArrayState.setDirty();
+    }
+    if (groups & DirtyOther) {
+        lineWidth.setDirty();
 #if not MBGL_USE_GLES2
-    pointSize.setDirty();
-    pixelZoom.setDirty();
-    rasterPos.setDirty();
-    pixelTransferDepth.setDirty();
-    pixelTransferStencil.setDirty();
+        pointSize.setDirty();
+        pixelZoom.setDirty();
+        rasterPos.setDirty();
+        pixelTransferDepth.setDirty();
+        pixelTransferStencil.setDirty();
 #endif // MBGL_USE_GLES2
-    for (auto& tex : texture) {
-       tex.setDirty();
     }
-    vertexBuffer.setDirty();
-    bindVertexArray.setDirty();
-    globalVertexArrayState.setDirty();
 }
 
 void Context::clear(optional<mbgl::Color> color,
@@ -671,9 +1094,37 @@ void Context::setColorMode(const ColorMode& color) {
     colorMask = color.mask;
 }
 
+Context::Fence Context::createFence() {
+    if (fenceSync && fenceSync->fenceSync && fenceSync->waitSync && fenceSync->deleteSync) {
+        Fence fence = MBGL_CHECK_ERROR(fenceSync->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        // Make sure the fence reaches the GPU, or waiting for it from another context might
+        // never return.
+        MBGL_CHECK_ERROR(glFlush());
+        return fence;
+    }
+
+    MBGL_CHECK_ERROR(glFinish());
+    return nullptr;
+}
+
+void Context::waitFence(Fence fence) {
+    if (!fence) {
+        return;
+    }
+
+    assert(fenceSync);
+    MBGL_CHECK_ERROR(fenceSync->waitSync(fence, 0, GL_TIMEOUT_IGNORED));
+    MBGL_CHECK_ERROR(fenceSync->deleteSync(fence));
+}
+
+void Context::setObjectOwner(Context& owner) {
+    objectOwner = &owner;
+}
+
 void Context::draw(PrimitiveType primitiveType,
                    std::size_t indexOffset,
                    std::size_t indexLength) {
+    drawCalls++;
     MBGL_CHECK_ERROR(glDrawElements(
         static_cast<GLenum>(primitiveType),
         static_cast<GLsizei>(indexLength),
@@ -681,7 +1132,25 @@ void Context::draw(PrimitiveType primitiveType,
         reinterpret_cast<GLvoid*>(sizeof(uint16_t) * indexOffset)));
 }
 
+void Context::drawInstanced(PrimitiveType primitiveType,
+                            std::size_t indexOffset,
+                            std::size_t indexLength,
+                            std::size_t instanceCount) {
+    assert(getInstancedArraysExtension());
+    drawCalls++;
+    MBGL_CHECK_ERROR(instancedArrays->drawElementsInstanced(
+        static_cast<GLenum>(primitiveType),
+        static_cast<GLsizei>(indexLength),
+        GL_UNSIGNED_SHORT,
+        reinterpret_cast<GLvoid*>(sizeof(uint16_t) * indexOffset),
+        static_cast<GLsizei>(instanceCount)));
+}
+
 void Context::performCleanup() {
+    // Arenas emptied by evicted tiles are deleted, keeping one of each kind for the tiles that
+    // replace them.
+    releaseBufferArenas(1);
+
     for (auto id : abandonedPrograms) {
         if (program == id) {
             program.setDirty();
@@ -702,6 +1171,15 @@ void Context::performCleanup() {
             } else if (globalVertexArrayState.indexBuffer == id) {
                 globalVertexArrayState.indexBuffer.setDirty();
             }
+            // The name of a deleted buffer may be handed out again, which mustn't be mistaken
+            // for the buffer the attributes are bound to still.
+            for (auto& binding : globalVertexArrayState.bindings) {
+                const auto& current = binding.getCurrentValue();
+                if (current && current->vertexBuffer == id) {
+                    binding.setDirty();
+                    globalVertexArrayState.bindingsHash = {};
+                }
+            }
         }
         MBGL_CHECK_ERROR(glDeleteBuffers(int(abandonedBuffers.size()), abandonedBuffers.data()));
         abandonedBuffers.clear();
@@ -2,6 +2,7 @@
 
 #include <mbgl/gl/features.hpp>
 #include <mbgl/gl/object.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 #include <mbgl/gl/state.hpp>
 #include <mbgl/gl/value.hpp>
 #include <mbgl/gl/texture.hpp>
@@ -16,6 +17,9 @@
 #include <mbgl/gl/stencil_mode.hpp>
 #include <mbgl/gl/color_mode.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/compressed_image.hpp>
+#include <mbgl/util/image.hpp>
 
 
 #include <functional>
@@ -23,17 +27,31 @@
 #include <vector>
 #include <array>
 #include <string>
+#include <utility>
 
 namespace mbgl {
 namespace gl {
 
 constexpr size_t TextureMax = 64;
+// The number of released tile textures kept for reuse.
+constexpr size_t TileTextureMax = 16;
+// The number of released render targets kept for reuse.
+constexpr size_t RenderTargetMax = 4;
+// The size of the buffer arenas, and of the largest static buffers that are ranges of them
+// rather than buffers of their own.
+constexpr size_t BufferArenaSize = 1024 * 1024;
+constexpr size_t BufferArenaRangeMax = BufferArenaSize / 4;
 using ProcAddress = void (*)();
 
 namespace extension {
 class VertexArray;
 class Debugging;
 class ProgramBinary;
+class BufferMapping;
+class FenceSync;
+class ParallelShaderCompile;
+class TimerQuery;
+class InstancedArrays;
 } // namespace extension
 
 class Context : private util::noncopyable {
@@ -60,24 +78,45 @@ public:
 #endif
     optional<std::pair<BinaryProgramFormat, std::string>> getBinaryProgram(ProgramID) const;
 
+    // Static vertex and index buffers are ranges of a few large buffers, the buffer arenas,
+    // rather than buffers of their own, unless they're large. Buffers created for dynamic or
+    // streamed use always have their own.
     template <class Vertex, class DrawMode>
     VertexBuffer<Vertex, DrawMode> createVertexBuffer(VertexVector<Vertex, DrawMode>&& v, const BufferUsage usage=BufferUsage::StaticDraw) {
+        BufferAllocation allocation = createVertexBuffer(v.data(), v.byteSize(), usage);
         return VertexBuffer<Vertex, DrawMode> {
             v.vertexSize(),
-            createVertexBuffer(v.data(), v.byteSize(), usage)
+            std::move(allocation.buffer),
+            usage,
+            allocation.byteOffset
         };
     }
 
+    // Buffers created for dynamic or streamed use are refilled without synchronizing with draws
+    // that still read their previous contents: the old storage is invalidated and the driver
+    // hands out fresh storage instead of stalling.
     template <class Vertex, class DrawMode>
     void updateVertexBuffer(VertexBuffer<Vertex, DrawMode>& buffer, VertexVector<Vertex, DrawMode>&& v) {
         assert(v.vertexSize() == buffer.vertexCount);
-        updateVertexBuffer(buffer.buffer, v.data(), v.byteSize());
+        updateVertexBuffer(buffer.buffer, buffer.byteOffset, v.data(), v.byteSize(), buffer.usage);
+    }
+
+    // Replaces `count` vertices of the buffer from `offset` on, leaving the others as they are.
+    template <class Vertex, class DrawMode>
+    void updateVertexBufferRange(VertexBuffer<Vertex, DrawMode>& buffer, std::size_t offset,
+                                 const Vertex* vertices, std::size_t count) {
+        assert(offset + count <= buffer.vertexCount);
+        updateVertexBufferRange(buffer.buffer, buffer.byteOffset + offset * sizeof(Vertex), vertices,
+                                count * sizeof(Vertex));
     }
 
     template <class DrawMode>
     IndexBuffer<DrawMode> createIndexBuffer(IndexVector<DrawMode>&& v) {
+        BufferAllocation allocation = createIndexBuffer(v.data(), v.byteSize());
         return IndexBuffer<DrawMode> {
-            createIndexBuffer(v.data(), v.byteSize())
+            v.indexSize(),
+            std::move(allocation.buffer),
+            allocation.byteOffset
         };
     }
 
@@ -108,6 +147,18 @@ public:
         return { size, readFramebuffer(size, format, flip) };
     }
 
+    // Starts reading back the RGBA framebuffer. Where pixel pack buffers are supported, the read
+    // is queued without waiting for the rendering to finish, so that further commands overlap
+    // with it. finishReadFramebuffer() waits for it, and flips the rows while copying them out.
+    FramebufferReadback startReadFramebuffer(Size, bool flip = true);
+
+    template <typename Image>
+    Image finishReadFramebuffer(FramebufferReadback&& readback) {
+        static_assert(Image::channels == 4, "image format mismatch");
+        const Size size = readback.size;
+        return { size, finishReadFramebuffer(readback) };
+    }
+
 #if not MBGL_USE_GLES2
     template <typename Image>
     void drawPixels(const Image& image) {
@@ -130,11 +181,94 @@ public:
         obj.size = image.size;
     }
 
-    // Creates an empty texture with the specified dimensions.
+    // Replaces a region of the texture, which must be large enough to contain it.
+    template <typename Image>
+    void updateTextureSubImage(Texture& obj, const Image& image, const Point<uint16_t>& offset, TextureUnit unit = 0) {
+        assert(offset.x + image.size.width <= obj.size.width && offset.y + image.size.height <= obj.size.height);
+        auto format = image.channels == 4 ? TextureFormat::RGBA : TextureFormat::Alpha;
+        updateTextureSubImage(obj.texture.get(), offset, image.size, image.data.get(), format, unit);
+    }
+
+    // Creates an empty texture with the specified dimensions. Half float textures require
+    // supportsHalfFloatTextures().
     Texture createTexture(const Size size,
                           TextureFormat format = TextureFormat::RGBA,
-                          TextureUnit unit = 0) {
-        return { size, createTexture(size, nullptr, format, unit) };
+                          TextureUnit unit = 0,
+                          TextureType type = TextureType::UnsignedByte) {
+        return { size, createTexture(size, nullptr, format, unit, type) };
+    }
+
+    // Requires supportsCompressedTextureFormat() for the format of the image.
+    Texture createTexture(const CompressedImage&, TextureUnit = 0);
+
+    // Creates a texture for a tile, reusing the storage of a released tile texture of the same
+    // size if there is one. With `mipmap` set, mipmaps are generated if the size is a power of
+    // two, which OpenGL ES 2 requires, and they're sampled anisotropically where supported.
+    Texture createTileTexture(const PremultipliedImage&, bool mipmap, TextureUnit = 0);
+
+    struct TexturePoolStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+
+    const TexturePoolStats& getTileTexturePoolStats() const {
+        return tileTexturePoolStats;
+    }
+
+    // Deletes the released tile textures kept for reuse.
+    void releaseTileTextures();
+
+    // How full the buffer arenas are: the bytes they reserve, and those in use. The free bytes
+    // are split into `freeRanges` ranges, the largest of which limits the size of the buffers the
+    // arenas can still take without another one.
+    struct BufferArenaStats {
+        std::size_t arenas = 0;
+        std::size_t reservedBytes = 0;
+        std::size_t usedBytes = 0;
+        std::size_t freeRanges = 0;
+        std::size_t largestFreeRange = 0;
+    };
+
+    BufferArenaStats getBufferArenaStats() const;
+
+    // Deletes the buffer arenas none of whose ranges are in use, except for `keep` of each kind.
+    void releaseBufferArenas(std::size_t keep = 0);
+
+    // An RGBA texture attached to a framebuffer, with a depth renderbuffer if it was created
+    // with one.
+    struct RenderTarget {
+        Texture texture;
+        TextureType type;
+        Framebuffer framebuffer;
+        optional<Renderbuffer<RenderbufferType::DepthComponent>> depth;
+    };
+
+    // Creates a render target and binds its framebuffer, reusing the objects of a released render
+    // target with the same attachments if there is one. Their storage is reallocated if the
+    // released target had another size, which keeps a resize from creating new objects.
+    RenderTarget createRenderTarget(Size, bool depth, TextureType = TextureType::UnsignedByte);
+
+    // Keeps the objects of a render target that's no longer drawn into for reuse.
+    void releaseRenderTarget(RenderTarget);
+
+    const TexturePoolStats& getRenderTargetPoolStats() const {
+        return renderTargetPoolStats;
+    }
+
+    // Deletes the released render targets kept for reuse.
+    void releaseRenderTargets();
+
+    bool supportsCompressedTextureFormat(CompressedImageFormat) const;
+
+    // The largest width and height of a texture, GL_MAX_TEXTURE_SIZE. Zero until the extensions
+    // are initialized.
+    uint32_t getMaximumTextureSize() const {
+        return maximumTextureSize;
+    }
+
+    // Whether half float textures can be created and drawn into.
+    bool supportsHalfFloatTextures() const {
+        return halfFloatTextures;
     }
 
     void bindTexture(Texture&,
@@ -162,6 +296,33 @@ public:
               std::size_t indexOffset,
               std::size_t indexLength);
 
+    // Requires getInstancedArraysExtension().
+    void drawInstanced(PrimitiveType,
+                       std::size_t indexOffset,
+                       std::size_t indexLength,
+                       std::size_t instanceCount);
+
+    // Fences let a context wait for commands issued through another context that shares objects
+    // with it. Where sync objects aren't supported, createFence() waits for all previously issued
+    // commands to complete and returns null.
+    using Fence = void*;
+    Fence createFence();
+    // Makes the commands issued from now on wait for the fence, and deletes it.
+    void waitFence(Fence);
+
+    // Objects created through this context are handed to `owner` for deletion once they're
+    // released. Contexts that upload on behalf of another context, sharing its objects, use this
+    // to keep their objects' lifetime independent of their own.
+    void setObjectOwner(Context& owner);
+
+    // The number of draw calls issued since the last reset. The renderer resets it at the start
+    // of every frame.
+    std::size_t drawCalls = 0;
+
+    // The vertex, index and texture data uploaded through this context since it was created,
+    // in bytes.
+    uint64_t uploadedBytes = 0;
+
     // Actually remove the objects we marked as abandoned with the above methods.
     // Only call this while the OpenGL context is exclusive to this thread.
     void performCleanup();
@@ -172,6 +333,9 @@ public:
 
     bool empty() const {
         return pooledTextures.empty()
+            && tileTextures.empty()
+            && bufferArenas.empty()
+            && renderTargets.empty()
             && abandonedPrograms.empty()
             && abandonedShaders.empty()
             && abandonedBuffers.empty()
@@ -182,6 +346,21 @@ public:
 
     void setDirtyState();
 
+    // Groups of the state setDirtyState() marks dirty.
+    enum DirtyStateGroup : uint32_t {
+        DirtyProgram      = 1 << 0,
+        DirtyVertexArrays = 1 << 1,
+        DirtyTextures     = 1 << 2,
+        DirtyDepth        = 1 << 3,
+        DirtyStencil      = 1 << 4,
+        DirtyColor        = 1 << 5,
+        DirtyOther        = 1 << 6,
+    };
+
+    // Marks only the state in the given groups dirty, for code that changed some of the state
+    // without going through the context.
+    void setDirtyState(uint32_t groups);
+
     extension::Debugging* getDebuggingExtension() const {
         return debugging.get();
     }
@@ -190,12 +369,24 @@ public:
         return vertexArray.get();
     }
 
+    // Returns null if timestamp queries aren't supported.
+    extension::TimerQuery* getTimerQueryExtension() const;
+
+    // Returns null if instanced drawing isn't supported.
+    extension::InstancedArrays* getInstancedArraysExtension() const;
+
 private:
     std::unique_ptr<extension::Debugging> debugging;
     std::unique_ptr<extension::VertexArray> vertexArray;
 #if MBGL_HAS_BINARY_PROGRAMS
     std::unique_ptr<extension::ProgramBinary> programBinary;
 #endif
+    std::unique_ptr<extension::BufferMapping> bufferMapping;
+    std::unique_ptr<extension::FenceSync> fenceSync;
+    std::unique_ptr<extension::ParallelShaderCompile> parallelShaderCompile;
+    std::unique_ptr<extension::TimerQuery> timerQuery;
+    std::unique_ptr<extension::InstancedArrays> instancedArrays;
+    Context* objectOwner = this;
 
 public:
     State<value::ActiveTexture> activeTexture;
@@ -242,14 +433,32 @@ private:
     State<value::PointSize> pointSize;
 #endif // MBGL_USE_GLES2
 
-    UniqueBuffer createVertexBuffer(const void* data, std::size_t size, const BufferUsage usage);
-    void updateVertexBuffer(UniqueBuffer& buffer, const void* data, std::size_t size);
-    UniqueBuffer createIndexBuffer(const void* data, std::size_t size);
-    UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit);
-    void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit);
+    struct BufferAllocation {
+        UniqueBuffer buffer;
+        std::size_t byteOffset;
+    };
+
+    enum class BufferTarget : bool {
+        Vertex,
+        Index,
+    };
+
+    BufferAllocation createVertexBuffer(const void* data, std::size_t size, const BufferUsage usage);
+    void updateVertexBuffer(UniqueBuffer& buffer, std::size_t byteOffset, const void* data, std::size_t size, BufferUsage);
+    void updateVertexBufferRange(UniqueBuffer& buffer, std::size_t offset, const void* data, std::size_t size);
+    BufferAllocation createIndexBuffer(const void* data, std::size_t size);
+    optional<BufferAllocation> allocateBufferRange(BufferTarget, const void* data, std::size_t size);
+    void bindBuffer(BufferTarget, BufferID);
+    TextureID genTexture();
+    UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit,
+                                TextureType = TextureType::UnsignedByte);
+    void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit,
+                       TextureType = TextureType::UnsignedByte);
+    void updateTextureSubImage(TextureID, const Point<uint16_t>& offset, Size size, const void* data, TextureFormat, TextureUnit);
     UniqueFramebuffer createFramebuffer();
     UniqueRenderbuffer createRenderbuffer(RenderbufferType, Size size);
     std::unique_ptr<uint8_t[]> readFramebuffer(Size, TextureFormat, bool flip);
+    std::unique_ptr<uint8_t[]> finishReadFramebuffer(FramebufferReadback&);
 #if not MBGL_USE_GLES2
     void drawPixels(Size size, const void* data, TextureFormat);
 #endif // MBGL_USE_GLES2
@@ -265,6 +474,20 @@ private:
     friend detail::RenderbufferDeleter;
 
     std::vector<TextureID> pooledTextures;
+    // Released tile textures, which still have storage of their size.
+    std::vector<std::pair<Size, TextureID>> tileTextures;
+    TexturePoolStats tileTexturePoolStats;
+    // Released render targets, which still have storage of their size.
+    std::vector<RenderTarget> renderTargets;
+    TexturePoolStats renderTargetPoolStats;
+    // Zero if anisotropic filtering isn't supported.
+    float maxAnisotropy = 0;
+
+    // The compressed texture formats the driver accepts.
+    std::vector<int32_t> compressedTextureFormats;
+
+    bool halfFloatTextures = false;
+    uint32_t maximumTextureSize = 0;
 
     std::vector<ProgramID> abandonedPrograms;
     std::vector<ShaderID> abandonedShaders;
@@ -274,6 +497,15 @@ private:
     std::vector<FramebufferID> abandonedFramebuffers;
     std::vector<RenderbufferID> abandonedRenderbuffers;
 
+    // Declared after the abandoned objects, which the arenas' buffers are added to when they're
+    // destroyed.
+    struct BufferArenaEntry {
+        BufferTarget target;
+        UniqueBuffer buffer;
+        BufferArena arena;
+    };
+    std::vector<std::unique_ptr<BufferArenaEntry>> bufferArenas;
+
 public:
     // For testing
     bool disableVAOExtension = false;
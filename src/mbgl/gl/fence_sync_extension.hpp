@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <cstdint>
+
+#define GL_SYNC_GPU_COMMANDS_COMPLETE              0x9117
+#define GL_TIMEOUT_IGNORED                         0xFFFFFFFFFFFFFFFFull
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+// Sync objects are opaque pointers; they're passed around as such, since not all GL headers
+// declare GLsync.
+class FenceSync {
+public:
+    template <typename Fn>
+    FenceSync(const Fn& loadExtension)
+        : fenceSync(
+              loadExtension({ { "GL_ARB_sync", "glFenceSync" },
+                              { "GL_APPLE_sync", "glFenceSyncAPPLE" } })),
+          waitSync(
+              loadExtension({ { "GL_ARB_sync", "glWaitSync" },
+                              { "GL_APPLE_sync", "glWaitSyncAPPLE" } })),
+          deleteSync(
+              loadExtension({ { "GL_ARB_sync", "glDeleteSync" },
+                              { "GL_APPLE_sync", "glDeleteSyncAPPLE" } })) {
+    }
+
+    const ExtensionFunction<void*(GLenum condition, GLbitfield flags)> fenceSync;
+
+    const ExtensionFunction<void(void* sync, GLbitfield flags, uint64_t timeout)> waitSync;
+
+    const ExtensionFunction<void(void* sync)> deleteSync;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -2,6 +2,10 @@
 
 #include <mbgl/gl/object.hpp>
 #include <mbgl/util/size.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <memory>
 
 namespace mbgl {
 namespace gl {
@@ -12,5 +16,16 @@ public:
     gl::UniqueFramebuffer framebuffer;
 };
 
+// An RGBA read of a framebuffer that was started with Context::startReadFramebuffer().
+class FramebufferReadback {
+public:
+    Size size;
+    bool flip;
+    // The pixel pack buffer that's read into, if the context supports them; the pixels read
+    // right away otherwise.
+    optional<gl::UniqueBuffer> buffer;
+    std::unique_ptr<uint8_t[]> data;
+};
+
 } // namespace gl
 } // namespace mbgl
@@ -4,6 +4,7 @@
 #include <mbgl/gl/draw_mode.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <cstring>
 #include <vector>
 
 namespace mbgl {
@@ -28,6 +29,12 @@ public:
     const uint16_t* data() const { return v.data(); }
     const std::vector<uint16_t>& vector() const { return v; }
 
+    // Replaces the indices with `count` indices copied from `bytes`, which needn't be aligned.
+    void assign(const char* bytes, std::size_t count) {
+        v.resize(count);
+        std::memcpy(v.data(), bytes, count * sizeof(uint16_t));
+    }
+
 private:
     std::vector<uint16_t> v;
 };
@@ -35,7 +42,12 @@ private:
 template <class DrawMode>
 class IndexBuffer {
 public:
+    std::size_t indexCount;
     UniqueBuffer buffer;
+    // Where the indices start within the buffer, as for vertex buffers.
+    std::size_t byteOffset = 0;
+
+    std::size_t byteSize() const { return indexCount * sizeof(uint16_t); }
 };
 
 } // namespace gl
@@ -1,5 +1,6 @@
 #include <mbgl/gl/object.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 
 #include <cassert>
 
@@ -19,12 +20,18 @@ void ShaderDeleter::operator()(ShaderID id) const {
 
 void BufferDeleter::operator()(BufferID id) const {
     assert(context);
-    context->abandonedBuffers.push_back(id);
+    if (arena) {
+        arena->release(offset, size);
+    } else {
+        context->abandonedBuffers.push_back(id);
+    }
 }
 
 void TextureDeleter::operator()(TextureID id) const {
     assert(context);
-    if (context->pooledTextures.size() >= TextureMax) {
+    if (!poolSize.isEmpty() && context->tileTextures.size() < TileTextureMax) {
+        context->tileTextures.emplace_back(poolSize, id);
+    } else if (context->pooledTextures.size() >= TextureMax) {
         context->abandonedTextures.push_back(id);
     } else {
         context->pooledTextures.push_back(id);
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <mbgl/gl/types.hpp>
+#include <mbgl/util/size.hpp>
 
 #include <unique_resource.hpp>
 
+#include <cstddef>
+
 namespace mbgl {
 namespace gl {
 
 class Context;
+class BufferArena;
 
 namespace detail {
 
@@ -23,11 +27,18 @@ struct ShaderDeleter {
 
 struct BufferDeleter {
     Context* context;
+    // Set for ranges of one of the context's buffer arenas, which return to the arena when
+    // released rather than deleting the buffer.
+    BufferArena* arena = nullptr;
+    std::size_t offset = 0;
+    std::size_t size = 0;
     void operator()(BufferID) const;
 };
 
 struct TextureDeleter {
     Context* context;
+    // Set for tile textures, which return to the context's tile texture pool when released.
+    Size poolSize = {};
     void operator()(TextureID) const;
 };
 
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class ParallelShaderCompile {
+public:
+    template <typename Fn>
+    ParallelShaderCompile(const Fn& loadExtension)
+        : maxShaderCompilerThreads(
+              loadExtension({ { "GL_KHR_parallel_shader_compile", "glMaxShaderCompilerThreadsKHR" },
+                              { "GL_ARB_parallel_shader_compile", "glMaxShaderCompilerThreadsARB" } })) {
+    }
+
+    const ExtensionFunction<void(GLuint count)> maxShaderCompilerThreads;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -119,6 +119,59 @@ public:
               const IndexBuffer<DrawMode>& indexBuffer,
               std::size_t indexOffset,
               std::size_t indexLength) {
+        bind(context, drawMode, depthMode, stencilMode, colorMode, uniformValues,
+             vertexArray, attributeBindings, indexBuffer);
+
+        context.draw(drawMode.primitiveType,
+                     indexBuffer.byteOffset / sizeof(uint16_t) + indexOffset,
+                     indexLength);
+    }
+
+    // Draws the indexed vertices once per instance. Requires
+    // Context::getInstancedArraysExtension().
+    template <class DrawMode>
+    void drawInstanced(Context& context,
+                       DrawMode drawMode,
+                       DepthMode depthMode,
+                       StencilMode stencilMode,
+                       ColorMode colorMode,
+                       const UniformValues& uniformValues,
+                       VertexArray& vertexArray,
+                       const AttributeBindings& attributeBindings,
+                       const IndexBuffer<DrawMode>& indexBuffer,
+                       std::size_t indexOffset,
+                       std::size_t indexLength,
+                       std::size_t instanceCount) {
+        bind(context, drawMode, depthMode, stencilMode, colorMode, uniformValues,
+             vertexArray, attributeBindings, indexBuffer);
+
+        context.drawInstanced(drawMode.primitiveType,
+                              indexBuffer.byteOffset / sizeof(uint16_t) + indexOffset,
+                              indexLength,
+                              instanceCount);
+    }
+
+    // Identifies the vertex array for drawing with these bindings and this program. Vertex arrays
+    // are kept by this key, so that draws with another set of buffers, e.g. of another layer
+    // drawing the same segment with other data-driven paint attributes, get a vertex array of
+    // their own instead of rebinding a shared one.
+    std::size_t vertexArrayKey(const AttributeBindings& attributeBindings, BufferID indexBuffer) const {
+        const uint64_t objects = uint64_t(program.get()) << 32 | indexBuffer;
+        return hashBindings(Attributes::toBindingArray(attributeLocations, attributeBindings),
+                            std::hash<uint64_t>()(objects));
+    }
+
+private:
+    template <class DrawMode>
+    void bind(Context& context,
+              const DrawMode& drawMode,
+              const DepthMode& depthMode,
+              const StencilMode& stencilMode,
+              const ColorMode& colorMode,
+              const UniformValues& uniformValues,
+              VertexArray& vertexArray,
+              const AttributeBindings& attributeBindings,
+              const IndexBuffer<DrawMode>& indexBuffer) {
         static_assert(std::is_same<Primitive, typename DrawMode::Primitive>::value, "incompatible draw mode");
 
         context.setDrawMode(drawMode);
@@ -133,13 +186,8 @@ public:
         vertexArray.bind(context,
                         indexBuffer.buffer,
                         Attributes::toBindingArray(attributeLocations, attributeBindings));
-
-        context.draw(drawMode.primitiveType,
-                     indexOffset,
-                     indexLength);
     }
 
-private:
     UniqueProgram program;
 
     typename Uniforms::State uniformsState;
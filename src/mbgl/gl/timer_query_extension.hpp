@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <cstdint>
+
+#define GL_QUERY_RESULT_EXT                        0x8866
+#define GL_QUERY_RESULT_AVAILABLE_EXT              0x8867
+#define GL_TIMESTAMP_EXT                           0x8E28
+#define GL_GPU_DISJOINT_EXT                        0x8FBB
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class TimerQuery {
+public:
+    template <typename Fn>
+    TimerQuery(const Fn& loadExtension, bool reportsDisjoint_)
+        : reportsDisjoint(reportsDisjoint_),
+          genQueries(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGenQueriesEXT" },
+                              { "GL_ARB_timer_query", "glGenQueries" } })),
+          deleteQueries(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glDeleteQueriesEXT" },
+                              { "GL_ARB_timer_query", "glDeleteQueries" } })),
+          queryCounter(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glQueryCounterEXT" },
+                              { "GL_ARB_timer_query", "glQueryCounter" } })),
+          getQueryObjectiv(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectivEXT" },
+                              { "GL_ARB_timer_query", "glGetQueryObjectiv" } })),
+          getQueryObjectui64v(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectui64vEXT" },
+                              { "GL_ARB_timer_query", "glGetQueryObjectui64v" } })) {
+    }
+
+    // Only GL_EXT_disjoint_timer_query reports events, like frequency changes, that invalidate
+    // the timer queries in flight.
+    const bool reportsDisjoint;
+
+    const ExtensionFunction<void(GLsizei n, GLuint* ids)> genQueries;
+
+    const ExtensionFunction<void(GLsizei n, const GLuint* ids)> deleteQueries;
+
+    const ExtensionFunction<void(GLuint id, GLenum target)> queryCounter;
+
+    const ExtensionFunction<void(GLuint id, GLenum pname, GLint* params)> getQueryObjectiv;
+
+    const ExtensionFunction<void(GLuint id, GLenum pname, uint64_t* params)> getQueryObjectui64v;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -2,6 +2,7 @@
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/vertex_array_extension.hpp>
+#include <mbgl/gl/instanced_arrays_extension.hpp>
 
 namespace mbgl {
 namespace gl {
@@ -378,6 +379,14 @@ void VertexAttribute::Set(const optional<AttributeBinding>& binding, Context& co
             static_cast<GLboolean>(false),
             static_cast<GLsizei>(binding->vertexSize),
             reinterpret_cast<GLvoid*>(binding->attributeOffset + (binding->vertexSize * binding->vertexOffset))));
+
+        // Divisors are per location, so locations that were last used for instanced attributes
+        // need to be reset as well.
+        if (auto instancedArrays = context.getInstancedArraysExtension()) {
+            MBGL_CHECK_ERROR(instancedArrays->vertexAttribDivisor(location, binding->divisor));
+        } else {
+            assert(binding->divisor == 0);
+        }
     } else {
         MBGL_CHECK_ERROR(glDisableVertexAttribArray(location));
     }
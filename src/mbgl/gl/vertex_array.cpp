@@ -9,9 +9,18 @@ void VertexArray::bind(Context& context, BufferID indexBuffer, const AttributeBi
     context.bindVertexArray = state->vertexArray;
     state->indexBuffer = indexBuffer;
 
+    // Vertex arrays are usually drawn with the bindings they were drawn with before.
+    const std::size_t hash = hashBindings(bindings);
+    if (state->bindingsHash == hash) {
+        return;
+    }
+
+    // Only the locations whose bindings changed are specified again, which matters most without
+    // vertex array objects, where all draws share the global attribute state.
     for (AttributeLocation location = 0; location < MAX_ATTRIBUTES; ++location) {
         state->bindings[location] = bindings[location];
     }
+    state->bindingsHash = hash;
 }
 
 } // namespace gl
@@ -25,6 +25,7 @@ public:
         for (auto& binding : bindings) {
             binding.setDirty();
         }
+        bindingsHash = {};
     }
 
     UniqueVertexArray vertexArray;
@@ -33,6 +34,9 @@ public:
     using AttributeState = State<value::VertexAttribute, Context&, AttributeLocation>;
     std::array<AttributeState, MAX_ATTRIBUTES> bindings;
 
+    // The hash of the bindings last assigned, unless they may have been changed since.
+    optional<std::size_t> bindingsHash;
+
 private:
     template <std::size_t... I>
     std::array<AttributeState, MAX_ATTRIBUTES> makeBindings(Context& context, std::index_sequence<I...>) {
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <mbgl/gl/object.hpp>
+#include <mbgl/gl/types.hpp>
 #include <mbgl/gl/primitives.hpp>
 #include <mbgl/gl/draw_mode.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <cstring>
 #include <vector>
 
 namespace mbgl {
@@ -30,6 +32,12 @@ public:
     const Vertex* data() const { return v.data(); }
     const std::vector<Vertex>& vector() const { return v; }
 
+    // Replaces the vertices with `count` vertices copied from `bytes`, which needn't be aligned.
+    void assign(const char* bytes, std::size_t count) {
+        v.resize(count);
+        std::memcpy(v.data(), bytes, count * sizeof(Vertex));
+    }
+
 private:
     std::vector<Vertex> v;
 };
@@ -42,6 +50,12 @@ public:
 
     std::size_t vertexCount;
     UniqueBuffer buffer;
+    BufferUsage usage = BufferUsage::StaticDraw;
+    // Where the vertices start within the buffer, which is shared with other vertex buffers if
+    // it's a range of a buffer arena.
+    std::size_t byteOffset = 0;
+
+    std::size_t byteSize() const { return vertexCount * vertexSize; }
 };
 
 } // namespace gl
@@ -0,0 +1,49 @@
+#include <mbgl/layout/layout_profiler.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+void LayoutProfiler::setEnabled(bool enabled_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (enabled_ && !enabled) {
+        totals.clear();
+    }
+    enabled = enabled_;
+}
+
+void LayoutProfiler::add(const RendererStatistics::LayerLayout& cost) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = totals.find({ cost.layer, cost.zoom });
+    if (it == totals.end()) {
+        totals.emplace(std::make_pair(cost.layer, cost.zoom), cost);
+        return;
+    }
+
+    RendererStatistics::LayerLayout& total = it->second;
+    total.tiles += cost.tiles;
+    total.layoutTime += cost.layoutTime;
+    total.placementTime += cost.placementTime;
+    total.features += cost.features;
+    total.vertices += cost.vertices;
+    total.bytes += cost.bytes;
+}
+
+std::vector<RendererStatistics::LayerLayout> LayoutProfiler::getProfile() const {
+    std::vector<RendererStatistics::LayerLayout> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result.reserve(totals.size());
+        for (const auto& entry : totals) {
+            result.push_back(entry.second);
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [] (const auto& a, const auto& b) {
+        return a.layoutTime + a.placementTime > b.layoutTime + b.placementTime;
+    });
+    return result;
+}
+
+} // namespace mbgl
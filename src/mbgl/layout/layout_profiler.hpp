@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/renderer/renderer_statistics.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   Sums up the cost of laying out each style layer at each zoom level, so that the layers that
+   make a style slow can be found. Tile workers only measure their layout while profiling is
+   enabled, which it isn't by default.
+
+   Shared by all tile workers of a renderer, and safe to use from any thread.
+*/
+class LayoutProfiler : private util::noncopyable {
+public:
+    // Enabling profiling starts over from empty totals.
+    void setEnabled(bool);
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    // Adds the times and counts of `cost` to the totals of its layer and zoom level.
+    void add(const RendererStatistics::LayerLayout& cost);
+
+    // The totals, with the layers that took the longest to lay out and place first.
+    std::vector<RendererStatistics::LayerLayout> getProfile() const;
+
+private:
+    std::atomic<bool> enabled { false };
+
+    mutable std::mutex mutex;
+    std::map<std::pair<std::string, uint8_t>, RendererStatistics::LayerLayout> totals;
+};
+
+} // namespace mbgl
@@ -1,19 +1,27 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
 
-#include <boost/functional/hash.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
 
 namespace mbgl {
 namespace util {
 
+// The text of a line and one of its endpoints: the ID of the text in the upper 32 bits, and the
+// coordinates in the lower ones. Unlike a hash of them, keys of different texts or endpoints never
+// collide.
+using Key = uint64_t;
+
 // Map of key -> index into features
-using Index = std::unordered_map<size_t, size_t>;
+using Index = std::unordered_map<Key, size_t>;
 
-size_t mergeFromRight(std::vector<SymbolFeature>& features,
-                      Index& rightIndex,
-                      Index::iterator left,
-                      size_t rightKey,
-                      GeometryCollection& geom) {
+static size_t mergeFromRight(std::vector<SymbolFeature>& features,
+                             Index& rightIndex,
+                             Index::iterator left,
+                             Key rightKey,
+                             GeometryCollection& geom) {
 
     const size_t index = left->second;
     rightIndex.erase(left);
@@ -25,11 +33,11 @@ size_t mergeFromRight(std::vector<SymbolFeature>& features,
     return index;
 }
 
-size_t mergeFromLeft(std::vector<SymbolFeature>& features,
-                     Index& leftIndex,
-                     Index::iterator right,
-                     size_t leftKey,
-                     GeometryCollection& geom) {
+static size_t mergeFromLeft(std::vector<SymbolFeature>& features,
+                            Index& leftIndex,
+                            Index::iterator right,
+                            Key leftKey,
+                            GeometryCollection& geom) {
 
     const size_t index = right->second;
     leftIndex.erase(right);
@@ -42,17 +50,19 @@ size_t mergeFromLeft(std::vector<SymbolFeature>& features,
     return index;
 }
 
-size_t getKey(const std::u16string& text, const GeometryCoordinate& coord) {
-    auto hash = std::hash<std::u16string>()(text);
-    boost::hash_combine(hash, coord.x);
-    boost::hash_combine(hash, coord.y);
-    return hash;
+static Key getKey(uint32_t text, const GeometryCoordinate& coord) {
+    return (Key(text) << 32) | (Key(uint16_t(coord.x)) << 16) | Key(uint16_t(coord.y));
 }
 
 void mergeLines(std::vector<SymbolFeature>& features) {
     Index leftIndex;
     Index rightIndex;
 
+    // Texts are numbered in the order they are first seen. The features own the texts for as long
+    // as they are referenced here.
+    std::unordered_map<std::reference_wrapper<const std::u16string>, uint32_t,
+                       std::hash<std::u16string>, std::equal_to<std::u16string>> textIDs;
+
     for (size_t k = 0; k < features.size(); k++) {
         SymbolFeature& feature = features[k];
         GeometryCollection& geometry = feature.geometry;
@@ -61,8 +71,13 @@ void mergeLines(std::vector<SymbolFeature>& features) {
             continue;
         }
 
-        const size_t leftKey = getKey(*feature.text, geometry[0].front());
-        const size_t rightKey = getKey(*feature.text, geometry[0].back());
+        auto textID = textIDs.find(*feature.text);
+        if (textID == textIDs.end()) {
+            textID = textIDs.emplace(*feature.text, uint32_t(textIDs.size())).first;
+        }
+        const uint32_t text = textID->second;
+        const Key leftKey = getKey(text, geometry[0].front());
+        const Key rightKey = getKey(text, geometry[0].back());
 
         const auto left = rightIndex.find(leftKey);
         const auto right = leftIndex.find(rightKey);
@@ -75,7 +90,7 @@ void mergeLines(std::vector<SymbolFeature>& features) {
 
             leftIndex.erase(leftKey);
             rightIndex.erase(rightKey);
-            rightIndex[getKey(*feature.text, features[i].geometry[0].back())] = i;
+            rightIndex[getKey(text, features[i].geometry[0].back())] = i;
 
         } else if (left != rightIndex.end()) {
             // found mergeable line adjacent to the start of the current line, merge
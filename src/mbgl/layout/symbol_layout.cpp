@@ -1,8 +1,9 @@
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/clip_lines.hpp>
+#include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
@@ -10,6 +11,7 @@
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/utf.hpp>
 #include <mbgl/util/token.hpp>
@@ -42,9 +44,12 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                            const std::vector<const RenderLayer*>& layers,
                            std::unique_ptr<GeometryTileLayer> sourceLayer_,
                            ImageDependencies& imageDependencies,
-                           GlyphDependencies& glyphDependencies)
+                           GlyphDependencies& glyphDependencies,
+                           FeatureIndex& featureIndex)
     : sourceLayer(std::move(sourceLayer_)),
       bucketName(layers.at(0)->getID()),
+      sourceLayerID(featureIndex.getSourceLayerID(sourceLayer->getName())),
+      bucketID(featureIndex.getBucketID(bucketName.str())),
       overscaling(parameters.tileID.overscaleFactor()),
       zoom(parameters.tileID.overscaledZ),
       mode(parameters.mode),
@@ -101,7 +106,7 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
     const size_t featureCount = sourceLayer->featureCount();
     for (size_t i = 0; i < featureCount; ++i) {
         auto feature = sourceLayer->getFeature(i);
-        if (!leader.filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        if (!leader.compiledFilter(*feature))
             continue;
         
         SymbolFeature ft(std::move(feature));
@@ -179,7 +184,10 @@ bool SymbolLayout::hasSymbolInstances() const {
 }
 
 void SymbolLayout::prepare(const GlyphMap& glyphMap, const GlyphPositions& glyphPositions,
-                           const ImageMap& imageMap, const ImagePositions& imagePositions) {
+                           const ImageMap& imageMap, const ImagePositions& imagePositions,
+                           ShapingCache& shapingCache,
+                           LineBreakCache* lineBreakCache,
+                           const std::function<bool ()>& cancelled) {
     const bool textAlongLine = layout.get<TextRotationAlignment>() == AlignmentType::Map &&
         layout.get<SymbolPlacement>() == SymbolPlacementType::Line;
 
@@ -191,10 +199,17 @@ void SymbolLayout::prepare(const GlyphMap& glyphMap, const GlyphPositions& glyph
     const GlyphPositionMap& glyphPositionMap = glyphPositionsIt != glyphPositions.end()
         ? glyphPositionsIt->second : GlyphPositionMap();
 
+    bool nonSDFIcons = false;
+
     for (auto it = features.begin(); it != features.end(); ++it) {
         auto& feature = *it;
+        // Features that have already been processed have their geometry cleared below.
         if (feature.geometry.empty()) continue;
 
+        if (cancelled()) {
+            return;
+        }
+
         std::pair<Shaping, Shaping> shapedTextOrientations;
         optional<PositionedIcon> shapedIcon;
 
@@ -202,8 +217,9 @@ void SymbolLayout::prepare(const GlyphMap& glyphMap, const GlyphPositions& glyph
         if (feature.text) {
             auto applyShaping = [&] (const std::u16string& text, WritingModeType writingMode) {
                 const float oneEm = 24.0f;
-                const Shaping result = getShaping(
+                ShapingCache::Key key {
                     /* string */ text,
+                    /* fontStack */ layout.get<TextFont>(),
                     /* maxWidth: ems */ layout.get<SymbolPlacement>() != SymbolPlacementType::Line ?
                         layout.get<TextMaxWidth>() * oneEm : 0,
                     /* lineHeight: ems */ layout.get<TextLineHeight>() * oneEm,
@@ -212,9 +228,18 @@ void SymbolLayout::prepare(const GlyphMap& glyphMap, const GlyphPositions& glyph
                     /* spacing: ems */ util::i18n::allowsLetterSpacing(*feature.text) ? layout.get<TextLetterSpacing>() * oneEm : 0.0f,
                     /* translate */ Point<float>(layout.evaluate<TextOffset>(zoom, feature)[0] * oneEm, layout.evaluate<TextOffset>(zoom, feature)[1] * oneEm),
                     /* verticalHeight */ oneEm,
-                    /* writingMode */ writingMode,
-                    /* bidirectional algorithm object */ bidi,
-                    /* glyphs */ glyphs);
+                    /* writingMode */ writingMode
+                };
+
+                if (const Shaping* cached = shapingCache.get(key)) {
+                    return *cached;
+                }
+
+                const Shaping result = getShaping(key.text, key.maxWidth, key.lineHeight,
+                                                  key.textAnchor, key.textJustify, key.spacing,
+                                                  key.translate, key.verticalHeight, key.writingMode,
+                                                  bidi, lineBreakCache, key.fontStack, glyphs);
+                shapingCache.add(std::move(key), result);
 
                 return result;
             };
@@ -236,6 +261,8 @@ void SymbolLayout::prepare(const GlyphMap& glyphMap, const GlyphPositions& glyph
                     layout.evaluate<IconRotate>(zoom, feature) * util::DEG2RAD);
                 if (image->second->sdf) {
                     sdfIcons = true;
+                } else {
+                    nonSDFIcons = true;
                 }
                 if (image->second->pixelRatio != pixelRatio) {
                     iconsNeedLinear = true;
@@ -253,6 +280,11 @@ void SymbolLayout::prepare(const GlyphMap& glyphMap, const GlyphPositions& glyph
         feature.geometry.clear();
     }
 
+    if (sdfIcons && nonSDFIcons) {
+        // SDF icons are kept in an atlas of their own, and a bucket draws its icons from one atlas.
+        Log::Warning(Event::Style, "Symbol layer %s can't mix SDF and non-SDF icons", bucketName.str().c_str());
+    }
+
     compareText.clear();
 }
 
@@ -291,8 +323,8 @@ void SymbolLayout::addFeature(const std::size_t index,
                                                   ? SymbolPlacementType::Point
                                                   : layout.get<SymbolPlacement>();
     const float textRepeatDistance = symbolSpacing / 2;
-    IndexedSubfeature indexedFeature = { feature.index, sourceLayer->getName(), bucketName,
-                                         symbolInstances.size() };
+    IndexedSubfeature indexedFeature = { static_cast<uint32_t>(feature.index), sourceLayerID, bucketID,
+                                         static_cast<uint32_t>(symbolInstances.size()) };
 
     auto addSymbolInstance = [&] (const GeometryCoordinates& line, Anchor& anchor) {
         // https://github.com/mapbox/vector-tile-spec/tree/master/2.1#41-layers
@@ -391,12 +423,168 @@ bool SymbolLayout::anchorIsTooClose(const std::u16string& text, const float repe
     return false;
 }
 
-std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile) {
-    auto bucket = std::make_unique<SymbolBucket>(layout, layerPaintProperties, textSize, iconSize, zoom, sdfIcons, iconsNeedLinear);
+bool SymbolLayout::canUpdatePlacement(const PlacementConfig& config) const {
+    if (mode != MapMode::Continuous || config.debug) {
+        return false;
+    }
+
+    // Overlapping symbols are sorted by their position on screen, which depends on the angle.
+    if (layout.get<TextAllowOverlap>() || layout.get<IconAllowOverlap>() ||
+        layout.get<TextIgnorePlacement>() || layout.get<IconIgnorePlacement>()) {
+        return false;
+    }
+
+    // So do the glyphs of vertical text.
+    return std::none_of(symbolInstances.begin(), symbolInstances.end(), [] (const SymbolInstance& symbolInstance) {
+        return symbolInstance.writingModes & WritingModeType::Vertical;
+    });
+}
+
+std::pair<float, float> SymbolLayout::placeSymbol(CollisionTile& collisionTile, SymbolInstance& symbolInstance) {
+    const bool hasText = symbolInstance.hasText;
+    const bool hasIcon = symbolInstance.hasIcon;
+
+    const bool iconWithoutText = layout.get<TextOptional>() || !hasText;
+    const bool textWithoutIcon = layout.get<IconOptional>() || !hasIcon;
+
+    // Calculate the scales at which the text and icon can be placed without collision.
+
+    float glyphScale = hasText ?
+        collisionTile.placeFeature(symbolInstance.textCollisionFeature,
+                layout.get<TextAllowOverlap>(), layout.get<SymbolAvoidEdges>()) :
+        collisionTile.minScale;
+    float iconScale = hasIcon ?
+        collisionTile.placeFeature(symbolInstance.iconCollisionFeature,
+                layout.get<IconAllowOverlap>(), layout.get<SymbolAvoidEdges>()) :
+        collisionTile.minScale;
+
+
+    // Combine the scales for icons and text.
+
+    if (!iconWithoutText && !textWithoutIcon) {
+        iconScale = glyphScale = util::max(iconScale, glyphScale);
+    } else if (!textWithoutIcon && glyphScale) {
+        glyphScale = util::max(iconScale, glyphScale);
+    } else if (!iconWithoutText && iconScale) {
+        iconScale = util::max(iconScale, glyphScale);
+    }
+
+    // Insert final placement into collision tree
+
+    if (hasText) {
+        collisionTile.insertFeature(symbolInstance.textCollisionFeature, glyphScale, layout.get<TextIgnorePlacement>());
+    }
+    if (hasIcon) {
+        collisionTile.insertFeature(symbolInstance.iconCollisionFeature, iconScale, layout.get<IconIgnorePlacement>());
+    }
+
+    return { glyphScale, iconScale };
+}
+
+float SymbolLayout::placementZoom(const CollisionTile& collisionTile, float scale) const {
+    return scale < collisionTile.maxScale ? util::max(util::log2(scale) + zoom, 0.0f) : util::MAX_ZOOM_F;
+}
+
+optional<SymbolPlacementZooms> SymbolLayout::updatePlacement(CollisionTile& collisionTile, const std::function<bool ()>& cancelled) {
+    SymbolPlacementZooms placement;
+
+    for (SymbolInstance &symbolInstance : symbolInstances) {
+        if (cancelled()) {
+            return {};
+        }
+
+        const auto scales = placeSymbol(collisionTile, symbolInstance);
+
+        // The symbols of the bucket, as added by place() with `allCandidates`.
+        if (symbolInstance.hasText) {
+            placement.text.push_back(placementZoom(collisionTile, scales.first));
+        }
+        if (symbolInstance.hasIcon && symbolInstance.iconQuad) {
+            placement.icon.push_back(placementZoom(collisionTile, scales.second));
+        }
+    }
+
+    return placement;
+}
+
+void SymbolLayout::resetPlacement() {
+    partialBucket.reset();
+    placedVertexCounts.clear();
+}
+
+std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile, const std::function<bool ()>& cancelled,
+                                                  bool allCandidates, std::size_t* budget) {
+    // A resumed placement adds the symbols it places to the bucket it started, and keeps the
+    // order of the symbols it started with.
+    if (!partialBucket) {
+        partialBucket = std::make_unique<SymbolBucket>(layout, layerPaintProperties, textSize, iconSize, zoom, sdfIcons, iconsNeedLinear);
+        partialBucket->labelRepeatDistance = tilePixelRatio * layout.get<SymbolSpacing>() / 2;
+
+        const bool mayOverlap = layout.get<TextAllowOverlap>() || layout.get<IconAllowOverlap>() ||
+            layout.get<TextIgnorePlacement>() || layout.get<IconIgnorePlacement>();
+
+        // Sort symbols by their y position on the canvas so that they lower symbols
+        // are drawn on top of higher symbols.
+        // Don't sort symbols that won't overlap because it isn't necessary and
+        // because it causes more labels to pop in and out when rotating.
+        if (mayOverlap) {
+            const float sin = std::sin(collisionTile.config.angle);
+            const float cos = std::cos(collisionTile.config.angle);
+
+            std::sort(symbolInstances.begin(), symbolInstances.end(), [sin, cos](SymbolInstance &a, SymbolInstance &b) {
+                const int32_t aRotated = sin * a.anchor.point.x + cos * a.anchor.point.y;
+                const int32_t bRotated = sin * b.anchor.point.x + cos * b.anchor.point.y;
+                return aRotated != bRotated ?
+                    aRotated < bRotated :
+                    a.index > b.index;
+            });
+        }
+
+        placedVertexCounts.reserve(symbolInstances.size());
+    }
 
     // Calculate which labels can be shown and when they can be shown and
     // create the bufers used for rendering.
 
+    const std::size_t begin = placedVertexCounts.size();
+    const std::size_t end = budget ? util::min(symbolInstances.size(), begin + *budget) : symbolInstances.size();
+    for (std::size_t i = begin; i < end; ++i) {
+        if (cancelled()) {
+            resetPlacement();
+            return nullptr;
+        }
+
+        SymbolInstance& symbolInstance = symbolInstances[i];
+        addPlacedSymbol(*partialBucket, collisionTile, symbolInstance,
+                        placeSymbol(collisionTile, symbolInstance), allCandidates);
+
+        const auto& feature = features.at(symbolInstance.featureIndex);
+        for (auto& pair : partialBucket->paintPropertyBinders) {
+            pair.second.first.populateVertexVectors(feature, partialBucket->icon.vertices.vertexSize());
+            pair.second.second.populateVertexVectors(feature, partialBucket->text.vertices.vertexSize());
+        }
+        placedVertexCounts.emplace_back(partialBucket->icon.vertices.vertexSize(), partialBucket->text.vertices.vertexSize());
+    }
+    if (budget) {
+        *budget -= end - begin;
+    }
+
+    if (end < symbolInstances.size()) {
+        return copyPartialBucket();
+    }
+
+    std::unique_ptr<SymbolBucket> bucket = std::move(partialBucket);
+    resetPlacement();
+
+    if (collisionTile.config.debug) {
+        addToDebugBuffers(collisionTile, *bucket);
+    }
+
+    return bucket;
+}
+
+void SymbolLayout::addPlacedSymbol(SymbolBucket& bucket, const CollisionTile& collisionTile, const SymbolInstance& symbolInstance,
+                                   std::pair<float, float> scales, bool allCandidates) {
     const SymbolPlacementType textPlacement = layout.get<TextRotationAlignment>() != AlignmentType::Map
                                                   ? SymbolPlacementType::Point
                                                   : layout.get<SymbolPlacement>();
@@ -404,108 +592,105 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
                                                   ? SymbolPlacementType::Point
                                                   : layout.get<SymbolPlacement>();
 
-    const bool mayOverlap = layout.get<TextAllowOverlap>() || layout.get<IconAllowOverlap>() ||
-        layout.get<TextIgnorePlacement>() || layout.get<IconIgnorePlacement>();
-
     const bool keepUpright = layout.get<TextKeepUpright>();
 
-    // Sort symbols by their y position on the canvas so that they lower symbols
-    // are drawn on top of higher symbols.
-    // Don't sort symbols that won't overlap because it isn't necessary and
-    // because it causes more labels to pop in and out when rotating.
-    if (mayOverlap) {
-        const float sin = std::sin(collisionTile.config.angle);
-        const float cos = std::cos(collisionTile.config.angle);
+    // Line labels are repeated along their lines, and each tile labels its part of a line, so
+    // they are the labels neighbouring tiles duplicate.
+    const bool crossTileLabels = layout.get<SymbolPlacement>() == SymbolPlacementType::Line;
 
-        std::sort(symbolInstances.begin(), symbolInstances.end(), [sin, cos](SymbolInstance &a, SymbolInstance &b) {
-            const int32_t aRotated = sin * a.anchor.point.x + cos * a.anchor.point.y;
-            const int32_t bRotated = sin * b.anchor.point.x + cos * b.anchor.point.y;
-            return aRotated != bRotated ?
-                aRotated < bRotated :
-                a.index > b.index;
-        });
-    }
+    const bool hasText = symbolInstance.hasText;
+    const bool hasIcon = symbolInstance.hasIcon;
 
-    for (SymbolInstance &symbolInstance : symbolInstances) {
+    const float glyphScale = scales.first;
+    const float iconScale = scales.second;
+
+    const auto& feature = features.at(symbolInstance.featureIndex);
 
-        const bool hasText = symbolInstance.hasText;
-        const bool hasIcon = symbolInstance.hasIcon;
+    SymbolBucket::Label label {
+        crossTileLabels && feature.text ? *feature.text : std::u16string(),
+        symbolInstance.anchor.point, {}, {}
+    };
 
-        const bool iconWithoutText = layout.get<TextOptional>() || !hasText;
-        const bool textWithoutIcon = layout.get<IconOptional>() || !hasIcon;
+    // Add glyphs/icons to buffers. Symbols that can't be shown get a placement zoom they're
+    // never shown at.
 
-        // Calculate the scales at which the text and icon can be placed without collision.
+    if (hasText) {
+        const float textPlacementZoom = placementZoom(collisionTile, glyphScale);
+        if (glyphScale < collisionTile.maxScale || allCandidates) {
 
-        float glyphScale = hasText ?
-            collisionTile.placeFeature(symbolInstance.textCollisionFeature,
-                    layout.get<TextAllowOverlap>(), layout.get<SymbolAvoidEdges>()) :
-            collisionTile.minScale;
-        float iconScale = hasIcon ?
-            collisionTile.placeFeature(symbolInstance.iconCollisionFeature,
-                    layout.get<IconAllowOverlap>(), layout.get<SymbolAvoidEdges>()) :
-            collisionTile.minScale;
+            const float labelAngle = std::fmod((symbolInstance.anchor.angle + collisionTile.config.angle) + 2 * M_PI, 2 * M_PI);
+            const bool inVerticalRange = (
+                (labelAngle > M_PI * 1.0 / 4.0 && labelAngle <= M_PI * 3.0 / 4) ||
+                (labelAngle > M_PI * 5.0 / 4.0 && labelAngle <= M_PI * 7.0 / 4));
+            const bool useVerticalMode = symbolInstance.writingModes & WritingModeType::Vertical && inVerticalRange;
 
+            const Range<float> sizeData = bucket.textSizeBinder->getVertexSizeData(feature);
+            label.textSymbol = bucket.text.placedSymbols.size();
+            bucket.text.placedSymbols.emplace_back(symbolInstance.anchor.point, symbolInstance.anchor.segment, sizeData.min, sizeData.max,
+                    symbolInstance.textOffset, textPlacementZoom, useVerticalMode, symbolInstance.line);
 
-        // Combine the scales for icons and text.
+            for (const auto& symbol : symbolInstance.glyphQuads) {
+                addSymbol(
+                    bucket.text, sizeData, symbol, textPlacementZoom,
+                    keepUpright, textPlacement, symbolInstance.anchor, bucket.text.placedSymbols.back());
+            }
+        }
+    }
 
-        if (!iconWithoutText && !textWithoutIcon) {
-            iconScale = glyphScale = util::max(iconScale, glyphScale);
-        } else if (!textWithoutIcon && glyphScale) {
-            glyphScale = util::max(iconScale, glyphScale);
-        } else if (!iconWithoutText && iconScale) {
-            iconScale = util::max(iconScale, glyphScale);
+    if (hasIcon) {
+        const float iconPlacementZoom = placementZoom(collisionTile, iconScale);
+        if ((iconScale < collisionTile.maxScale || allCandidates) && symbolInstance.iconQuad) {
+            const Range<float> sizeData = bucket.iconSizeBinder->getVertexSizeData(feature);
+            label.iconSymbol = bucket.icon.placedSymbols.size();
+            bucket.icon.placedSymbols.emplace_back(symbolInstance.anchor.point, symbolInstance.anchor.segment, sizeData.min, sizeData.max,
+                    symbolInstance.iconOffset, iconPlacementZoom, false, symbolInstance.line);
+            addSymbol(
+                bucket.icon, sizeData, *symbolInstance.iconQuad, iconPlacementZoom,
+                keepUpright, iconPlacement, symbolInstance.anchor, bucket.icon.placedSymbols.back());
         }
+    }
 
-        const auto& feature = features.at(symbolInstance.featureIndex);
+    if (crossTileLabels && feature.text && (label.textSymbol || label.iconSymbol)) {
+        bucket.labels.push_back(std::move(label));
+    }
+}
 
-        // Insert final placement into collision tree and add glyphs/icons to buffers
+namespace {
 
-        if (hasText) {
-            const float placementZoom = util::max(util::log2(glyphScale) + zoom, 0.0f);
-            collisionTile.insertFeature(symbolInstance.textCollisionFeature, glyphScale, layout.get<TextIgnorePlacement>());
-            if (glyphScale < collisionTile.maxScale) {
-
-                const float labelAngle = std::fmod((symbolInstance.anchor.angle + collisionTile.config.angle) + 2 * M_PI, 2 * M_PI);
-                const bool inVerticalRange = (
-                    (labelAngle > M_PI * 1.0 / 4.0 && labelAngle <= M_PI * 3.0 / 4) ||
-                    (labelAngle > M_PI * 5.0 / 4.0 && labelAngle <= M_PI * 7.0 / 4));
-                const bool useVerticalMode = symbolInstance.writingModes & WritingModeType::Vertical && inVerticalRange;
-
-                const Range<float> sizeData = bucket->textSizeBinder->getVertexSizeData(feature);
-                bucket->text.placedSymbols.emplace_back(symbolInstance.anchor.point, symbolInstance.anchor.segment, sizeData.min, sizeData.max,
-                        symbolInstance.textOffset, placementZoom, useVerticalMode, symbolInstance.line);
-
-                for (const auto& symbol : symbolInstance.glyphQuads) {
-                    addSymbol(
-                        bucket->text, sizeData, symbol, placementZoom,
-                        keepUpright, textPlacement, symbolInstance.anchor, bucket->text.placedSymbols.back());
-                }
-            }
-        }
+template <typename Buffer>
+void copySymbols(const Buffer& from, Buffer& to) {
+    to.vertices = from.vertices;
+    to.dynamicVertices = from.dynamicVertices;
+    to.triangles = from.triangles;
+    to.placedSymbols = from.placedSymbols;
+
+    // Segments can't be copied, as they hold on to the vertex arrays they're drawn with.
+    to.segments.reserve(from.segments.size());
+    for (const auto& segment : from.segments) {
+        to.segments.emplace_back(segment.vertexOffset, segment.indexOffset, segment.vertexLength, segment.indexLength);
+    }
+}
 
-        if (hasIcon) {
-            const float placementZoom = util::max(util::log2(iconScale) + zoom, 0.0f);
-            collisionTile.insertFeature(symbolInstance.iconCollisionFeature, iconScale, layout.get<IconIgnorePlacement>());
-            if (iconScale < collisionTile.maxScale && symbolInstance.iconQuad) {
-                const Range<float> sizeData = bucket->iconSizeBinder->getVertexSizeData(feature);
-                bucket->icon.placedSymbols.emplace_back(symbolInstance.anchor.point, symbolInstance.anchor.segment, sizeData.min, sizeData.max,
-                        symbolInstance.iconOffset, placementZoom, false, symbolInstance.line);
-                addSymbol(
-                    bucket->icon, sizeData, *symbolInstance.iconQuad, placementZoom,
-                    keepUpright, iconPlacement, symbolInstance.anchor, bucket->icon.placedSymbols.back());
-            }
-        }
-        
+} // namespace
+
+std::unique_ptr<SymbolBucket> SymbolLayout::copyPartialBucket() const {
+    // The tile uploads the buckets it gets, which moves their vertices, so the partial bucket
+    // itself isn't handed out.
+    auto bucket = std::make_unique<SymbolBucket>(layout, layerPaintProperties, textSize, iconSize, zoom, sdfIcons, iconsNeedLinear);
+    bucket->labelRepeatDistance = partialBucket->labelRepeatDistance;
+    bucket->labels = partialBucket->labels;
+    copySymbols(partialBucket->text, bucket->text);
+    copySymbols(partialBucket->icon, bucket->icon);
+
+    // Nor can paint property binders, so those are populated again.
+    for (std::size_t i = 0; i < placedVertexCounts.size(); ++i) {
+        const auto& feature = features.at(symbolInstances[i].featureIndex);
         for (auto& pair : bucket->paintPropertyBinders) {
-            pair.second.first.populateVertexVectors(feature, bucket->icon.vertices.vertexSize());
-            pair.second.second.populateVertexVectors(feature, bucket->text.vertices.vertexSize());
+            pair.second.first.populateVertexVectors(feature, placedVertexCounts[i].first);
+            pair.second.second.populateVertexVectors(feature, placedVertexCounts[i].second);
         }
     }
 
-    if (collisionTile.config.debug) {
-        addToDebugBuffers(collisionTile, *bucket);
-    }
-
     return bucket;
 }
 
@@ -7,7 +7,9 @@
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/util/interned_string.hpp>
 
+#include <functional>
 #include <memory>
 #include <map>
 #include <unordered_set>
@@ -21,6 +23,11 @@ class SymbolBucket;
 class Anchor;
 class RenderLayer;
 class PlacedSymbol;
+class PlacementConfig;
+class ShapingCache;
+class FeatureIndex;
+class LineBreakCache;
+struct SymbolPlacementZooms;
 
 namespace style {
 class Filter;
@@ -32,15 +39,54 @@ public:
                  const std::vector<const RenderLayer*>&,
                  std::unique_ptr<GeometryTileLayer>,
                  ImageDependencies&,
-                 GlyphDependencies&);
+                 GlyphDependencies&,
+                 FeatureIndex&);
 
+    // Both stop early if `cancelled` returns true. An interrupted prepare() can be resumed by
+    // calling it again; an interrupted place() returns nullptr.
     void prepare(const GlyphMap&, const GlyphPositions&,
-                 const ImageMap&, const ImagePositions&);
-
-    std::unique_ptr<SymbolBucket> place(CollisionTile&);
+                 const ImageMap&, const ImagePositions&,
+                 ShapingCache&,
+                 LineBreakCache*,
+                 const std::function<bool ()>& cancelled);
+
+    // With `allCandidates`, symbols that can't be placed are added to the bucket too, so that
+    // updatePlacement() can place them later on without rebuilding the bucket.
+    //
+    // With a `budget`, at most that many symbols are placed, and the budget is reduced by the
+    // number placed. If symbols are left, the bucket has a copy of those placed so far, and the
+    // next call resumes the placement, adding to them; it must be made with the same collision tile.
+    std::unique_ptr<SymbolBucket> place(CollisionTile&, const std::function<bool ()>& cancelled,
+                                        bool allCandidates = false, std::size_t* budget = nullptr);
+
+    // Whether the last place() placed all symbols.
+    bool placementComplete() const { return !partialBucket; }
+
+    // Abandons a placement that place() didn't complete.
+    void resetPlacement();
+
+    // Whether the buckets placed with `allCandidates` stay valid for any placement configuration,
+    // so that placing them again only changes their placement zooms.
+    bool canUpdatePlacement(const PlacementConfig&) const;
+
+    // Returns the placement zooms of the symbols of a bucket placed with `allCandidates`, in the
+    // order in which they were added to it; nothing if cancelled.
+    optional<SymbolPlacementZooms> updatePlacement(CollisionTile&, const std::function<bool ()>& cancelled);
 
     bool hasSymbolInstances() const;
 
+    // The ID of the first of the layers the layout is made for, and the features it lays out.
+    const std::string& getBucketName() const {
+        return bucketName.str();
+    }
+    std::size_t getFeatureCount() const {
+        return features.size();
+    }
+
+    // Set by the worker once it has sent a bucket placed from this layout.
+    bool placed = false;
+    bool placedAllCandidates = false;
+
     std::map<std::string,
         std::pair<style::IconPaintProperties::PossiblyEvaluated, style::TextPaintProperties::PossiblyEvaluated>> layerPaintProperties;
 
@@ -56,6 +102,17 @@ private:
 
     void addToDebugBuffers(CollisionTile&, SymbolBucket&);
 
+    // Places the text and icon of the symbol, returning the scales at which they show.
+    std::pair<float, float> placeSymbol(CollisionTile&, SymbolInstance&);
+    float placementZoom(const CollisionTile&, float scale) const;
+
+    // Adds the glyphs and icon of a symbol placed at the given scales to the bucket.
+    void addPlacedSymbol(SymbolBucket&, const CollisionTile&, const SymbolInstance&,
+                         std::pair<float, float> scales, bool allCandidates);
+
+    // A bucket with the symbols the incomplete placement has added so far.
+    std::unique_ptr<SymbolBucket> copyPartialBucket() const;
+
     // Adds placed items to the buffer.
     template <typename Buffer>
     void addSymbol(Buffer&,
@@ -70,7 +127,12 @@ private:
     // Stores the layer so that we can hold on to GeometryTileFeature instances in SymbolFeature,
     // which may reference data from this object.
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
-    const std::string bucketName;
+    const util::InternedString bucketName;
+
+    // The FeatureIndex IDs of the source layer and bucket, for the IndexedSubfeatures.
+    const uint16_t sourceLayerID;
+    const uint16_t bucketID;
+
     const float overscaling;
     const float zoom;
     const MapMode mode;
@@ -90,6 +152,11 @@ private:
     std::vector<SymbolInstance> symbolInstances;
     std::vector<SymbolFeature> features;
 
+    // The bucket an incomplete place() adds symbols to, and the number of icon and text vertices
+    // it has after each of the symbols placed so far, in the order of the symbol instances.
+    std::unique_ptr<SymbolBucket> partialBucket;
+    std::vector<std::pair<std::size_t, std::size_t>> placedVertexCounts;
+
     BiDi bidi; // Consider moving this up to geometry tile worker to reduce reinstantiation costs; use of BiDi/ubiditransform object must be constrained to one thread
 };
 
@@ -7,6 +7,8 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/math.hpp>
 
+#include <unordered_map>
+
 namespace mbgl {
 
 	/*
@@ -94,6 +96,10 @@ namespace mbgl {
     }
 
 
+    LineLabelCamera getLineLabelCamera(const mat4& posMatrix, const TransformState& state) {
+        return { posMatrix, state.getZoom(), state.getAngle(), state.getSize() };
+    }
+
     Point<float> project(const Point<float>& point, const mat4& matrix) {
         vec4 pos = {{ point.x, point.y, 0, 1 }};
         matrix::transformMat4(pos, pos, matrix);
@@ -151,8 +157,13 @@ namespace mbgl {
         NeedsFlipping
     };
 
+    // The vertices of a symbol's line projected so far, by index. Each glyph walks the line from
+    // the anchor, so all but the first to pass a vertex can reuse its projection.
+    using ProjectionCache = std::unordered_map<int32_t, Point<float>>;
+
 	optional<PlacedGlyph> placeGlyphAlongLine(const float offsetX, const float lineOffsetX, const float lineOffsetY, const bool flip,
-            Point<float> anchorPoint, const uint16_t anchorSegment, const GeometryCoordinates& line, const mat4& labelPlaneMatrix) {
+            Point<float> anchorPoint, const uint16_t anchorSegment, const GeometryCoordinates& line, const mat4& labelPlaneMatrix,
+            ProjectionCache& projectionCache) {
 
         const float combinedOffsetX = flip ?
             offsetX - lineOffsetX :
@@ -185,7 +196,11 @@ namespace mbgl {
             if (currentIndex < 0 || currentIndex >= static_cast<int32_t>(line.size())) return {};
 
             prev = current;
-            current = project(convertPoint<float>(line.at(currentIndex)), labelPlaneMatrix);
+            auto projected = projectionCache.find(currentIndex);
+            if (projected == projectionCache.end()) {
+                projected = projectionCache.emplace(currentIndex, project(convertPoint<float>(line.at(currentIndex)), labelPlaneMatrix)).first;
+            }
+            current = projected->second;
 
             distanceToPrev += currentSegmentDistance;
             currentSegmentDistance = util::dist<float>(prev, current);
@@ -211,6 +226,7 @@ namespace mbgl {
                               const mat4& posMatrix,
                               const mat4& labelPlaneMatrix,
                               const mat4& glCoordMatrix,
+                              ProjectionCache& projectionCache,
                               gl::VertexVector<SymbolDynamicLayoutAttributes::Vertex>& dynamicVertexArray) {
         const float fontScale = fontSize / 24.0;
         const float lineOffsetX = symbol.lineOffset[0] * fontSize;
@@ -224,11 +240,11 @@ namespace mbgl {
             const float firstGlyphOffset = symbol.glyphOffsets.front();
             const float lastGlyphOffset = symbol.glyphOffsets.back();
             
-            optional<PlacedGlyph> firstPlacedGlyph = placeGlyphAlongLine(fontScale * firstGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment, symbol.line, labelPlaneMatrix);
+            optional<PlacedGlyph> firstPlacedGlyph = placeGlyphAlongLine(fontScale * firstGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment, symbol.line, labelPlaneMatrix, projectionCache);
             if (!firstPlacedGlyph)
                 return PlacementResult::NotEnoughRoom;
 
-            optional<PlacedGlyph> lastPlacedGlyph = placeGlyphAlongLine(fontScale * lastGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment, symbol.line, labelPlaneMatrix);
+            optional<PlacedGlyph> lastPlacedGlyph = placeGlyphAlongLine(fontScale * lastGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment, symbol.line, labelPlaneMatrix, projectionCache);
             if (!lastPlacedGlyph)
                 return PlacementResult::NotEnoughRoom;
 
@@ -244,7 +260,7 @@ namespace mbgl {
             for (size_t glyphIndex = 1; glyphIndex < symbol.glyphOffsets.size() - 1; glyphIndex++) {
                 const float glyphOffsetX = symbol.glyphOffsets[glyphIndex];
                 // Since first and last glyph fit on the line, we're sure that the rest of the glyphs can be placed
-                auto placedGlyph = placeGlyphAlongLine(glyphOffsetX * fontScale, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment, symbol.line, labelPlaneMatrix);
+                auto placedGlyph = placeGlyphAlongLine(glyphOffsetX * fontScale, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment, symbol.line, labelPlaneMatrix, projectionCache);
                 placedGlyphs.push_back(*placedGlyph);
             }
             placedGlyphs.push_back(*lastPlacedGlyph);
@@ -261,7 +277,7 @@ namespace mbgl {
             assert(symbol.glyphOffsets.size() == 1); // We are relying on SymbolInstance.hasText filtering out symbols without any glyphs at all
             const float glyphOffsetX = symbol.glyphOffsets.front();
             optional<PlacedGlyph> singleGlyph = placeGlyphAlongLine(fontScale * glyphOffsetX, lineOffsetX, lineOffsetY, flip, anchorPoint, symbol.segment,
-                symbol.line, labelPlaneMatrix);
+                symbol.line, labelPlaneMatrix, projectionCache);
             if (!singleGlyph)
                 return PlacementResult::NotEnoughRoom;
 
@@ -294,12 +310,14 @@ namespace mbgl {
         
         dynamicVertexArray.clear();
 
+        ProjectionCache projectionCache;
+
         for (auto& placedSymbol : placedSymbols) {
 			vec4 anchorPos = {{ placedSymbol.anchorPoint.x, placedSymbol.anchorPoint.y, 0, 1 }};
             matrix::transformMat4(anchorPos, anchorPos, posMatrix);
 
             // Don't bother calculating the correct point for invisible labels.
-            if (!isVisible(anchorPos, placedSymbol.placementZoom, clippingBuffer, frameHistory)) {
+            if (placedSymbol.hidden || !isVisible(anchorPos, placedSymbol.placementZoom, clippingBuffer, frameHistory)) {
                 hideGlyphs(placedSymbol.glyphOffsets.size(), dynamicVertexArray);
                 continue;
             }
@@ -312,12 +330,28 @@ namespace mbgl {
                 fontSize * perspectiveRatio :
                 fontSize / perspectiveRatio;
 
-            PlacementResult placeUnflipped = placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, false /*unflipped*/, values.keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, dynamicVertexArray);
+            // Both directions walk the same line in the same label plane.
+            projectionCache.clear();
+            PlacementResult placeUnflipped = placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, false /*unflipped*/, values.keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, projectionCache, dynamicVertexArray);
 
             if (placeUnflipped == PlacementResult::NotEnoughRoom ||
                 (placeUnflipped == PlacementResult::NeedsFlipping &&
-                 placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, true /*flipped*/, values.keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, dynamicVertexArray) == PlacementResult::NotEnoughRoom)) {
+                 placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, true /*flipped*/, values.keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, projectionCache, dynamicVertexArray) == PlacementResult::NotEnoughRoom)) {
+                hideGlyphs(placedSymbol.glyphOffsets.size(), dynamicVertexArray);
+            }
+        }
+    }
+
+    void updateAnchoredLabels(gl::VertexVector<SymbolDynamicLayoutAttributes::Vertex>& dynamicVertexArray, const std::vector<PlacedSymbol>& placedSymbols) {
+        dynamicVertexArray.clear();
+
+        for (auto& placedSymbol : placedSymbols) {
+            if (placedSymbol.hidden) {
                 hideGlyphs(placedSymbol.glyphOffsets.size(), dynamicVertexArray);
+                continue;
+            }
+            for (size_t i = 0; i < placedSymbol.glyphOffsets.size(); i++) {
+                addDynamicAttributes(placedSymbol.anchorPoint, 0, placedSymbol.placementZoom, dynamicVertexArray);
             }
         }
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/util/mat4.hpp>
+#include <mbgl/util/size.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/programs/symbol_program.hpp>
 
@@ -18,8 +19,31 @@ namespace mbgl {
     mat4 getLabelPlaneMatrix(const mat4& posMatrix, const bool pitchWithMap, const bool rotateWithMap, const TransformState& state, const float pixelsToTileUnits);
     mat4 getGlCoordMatrix(const mat4& posMatrix, const bool pitchWithMap, const bool rotateWithMap, const TransformState& state, const float pixelsToTileUnits);
 
+    // The camera, relative to a tile, that line labels were projected for. The labels only need
+    // projecting again once it changes, or once their placement or fading does.
+    struct LineLabelCamera {
+        mat4 posMatrix;
+        double zoom;
+        double angle;
+        Size size;
+
+        friend bool operator==(const LineLabelCamera& a, const LineLabelCamera& b) {
+            return a.posMatrix == b.posMatrix && a.zoom == b.zoom && a.angle == b.angle && a.size == b.size;
+        }
+
+        friend bool operator!=(const LineLabelCamera& a, const LineLabelCamera& b) {
+            return !(a == b);
+        }
+    };
+
+    LineLabelCamera getLineLabelCamera(const mat4& posMatrix, const TransformState&);
+
     void reprojectLineLabels(gl::VertexVector<SymbolDynamicLayoutAttributes::Vertex>&, const std::vector<PlacedSymbol>&,
             const mat4& posMatrix, const style::SymbolPropertyValues&,
             const RenderTile&, const SymbolSizeBinder& sizeBinder, const TransformState&, const FrameHistory& frameHistory);
 
+    // Rewrites the dynamic attributes of labels that stay at their anchors, moving the glyphs of
+    // hidden labels off screen.
+    void updateAnchoredLabels(gl::VertexVector<SymbolDynamicLayoutAttributes::Vertex>&, const std::vector<PlacedSymbol>&);
+
 } // end namespace mbgl
@@ -16,6 +16,7 @@
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/math/log2.hpp>
@@ -26,11 +27,14 @@ namespace mbgl {
 using namespace style;
 
 struct StillImageRequest {
-    StillImageRequest(Map::StillImageCallback&& callback_)
+    StillImageRequest(Map::PartialStillImageCallback&& callback_)
         : callback(std::move(callback_)) {
     }
 
-    Map::StillImageCallback callback;
+    Map::PartialStillImageCallback callback;
+    util::Timer timeout;
+    bool timedOut = false;
+    MissingTiles missingTiles;
 };
 
 class Map::Impl : public style::Observer,
@@ -59,9 +63,11 @@ public:
     void onInvalidate() override;
     void onResourceError(std::exception_ptr) override;
     void onWillStartRenderingFrame() override;
-    void onDidFinishRenderingFrame(RenderMode, bool) override;
+    void onDidFinishRenderingFrame(RenderMode, bool, const optional<GPUTimings>&) override;
     void onWillStartRenderingMap() override;
     void onDidFinishRenderingMap() override;
+    void onDidRenderIncompleteStill(const MissingTiles&) override;
+    void onStyleImageMissing(const std::string&) override;
 
     Map& map;
     MapObserver& observer;
@@ -82,6 +88,10 @@ public:
     bool cameraMutated = false;
 
     uint8_t prefetchZoomDelta = util::DEFAULT_PREFETCH_ZOOM_DELTA;
+    uint64_t tileCacheSize = util::DEFAULT_TILE_CACHE_SIZE;
+    uint32_t placementBudget = 0;
+    optional<double> tileLODBias;
+    bool styleImagesOnDemand = false;
 
     bool loading = false;
     bool rendererFullyLoaded;
@@ -149,6 +159,17 @@ void Map::renderStill(StillImageCallback callback) {
         return;
     }
 
+    renderStill(Duration::max(), [stillCallback = std::move(callback)] (std::exception_ptr error, MissingTiles) {
+        stillCallback(error);
+    });
+}
+
+void Map::renderStill(Duration timeout, PartialStillImageCallback callback) {
+    if (!callback) {
+        Log::Error(Event::General, "StillImageCallback not set");
+        return;
+    }
+
     if (impl->mode != MapMode::Still) {
         callback(std::make_exception_ptr(util::MisuseException("Map is not in still image render mode")));
         return;
@@ -166,6 +187,13 @@ void Map::renderStill(StillImageCallback callback) {
 
     impl->stillImageRequest = std::make_unique<StillImageRequest>(std::move(callback));
 
+    if (timeout != Duration::max()) {
+        impl->stillImageRequest->timeout.start(timeout, Duration::zero(), [this] {
+            impl->stillImageRequest->timedOut = true;
+            impl->onUpdate(Update::Repaint);
+        });
+    }
+
     impl->onUpdate(Update::Repaint);
 }
 
@@ -187,11 +215,14 @@ void Map::Impl::onWillStartRenderingFrame() {
     }
 }
 
-void Map::Impl::onDidFinishRenderingFrame(RenderMode renderMode, bool needsRepaint) {
+void Map::Impl::onDidFinishRenderingFrame(RenderMode renderMode, bool needsRepaint, const optional<GPUTimings>& gpuTimings) {
     rendererFullyLoaded = renderMode == RenderMode::Full;
 
     if (mode == MapMode::Continuous) {
         observer.onDidFinishRenderingFrame(MapObserver::RenderMode(renderMode));
+        if (gpuTimings) {
+            observer.onDidCollectGPUTimings(*gpuTimings);
+        }
 
         if (needsRepaint || transform.inTransition()) {
             onUpdate(Update::Repaint);
@@ -208,10 +239,20 @@ void Map::Impl::onDidFinishRenderingMap() {
         }
     } else if (stillImageRequest) {
         auto request = std::move(stillImageRequest);
-        request->callback(nullptr);
+        request->callback(nullptr, std::move(request->missingTiles));
     }
 };
 
+void Map::Impl::onDidRenderIncompleteStill(const MissingTiles& missingTiles) {
+    if (stillImageRequest) {
+        stillImageRequest->missingTiles = missingTiles;
+    }
+}
+
+void Map::Impl::onStyleImageMissing(const std::string& id) {
+    observer.onStyleImageMissing(id);
+}
+
 #pragma mark - Style
 
 style::Style& Map::getStyle() {
@@ -631,6 +672,21 @@ void Map::removeAnnotation(AnnotationID annotation) {
     impl->onUpdate(Update::AnnotationData);
 }
 
+AnnotationIDs Map::addAnnotations(const std::vector<Annotation>& annotations) {
+    auto result = impl->annotationManager.addAnnotations(annotations, getMaxZoom());
+    impl->onUpdate(Update::AnnotationData);
+    return result;
+}
+
+void Map::updateAnnotations(const std::vector<std::pair<AnnotationID, Annotation>>& annotations) {
+    impl->onUpdate(impl->annotationManager.updateAnnotations(annotations, getMaxZoom()));
+}
+
+void Map::removeAnnotations(const AnnotationIDs& annotations) {
+    impl->annotationManager.removeAnnotations(annotations);
+    impl->onUpdate(Update::AnnotationData);
+}
+
 #pragma mark - Toggles
 
 void Map::setDebug(MapDebugOptions debugOptions) {
@@ -674,6 +730,41 @@ uint8_t Map::getPrefetchZoomDelta() const {
     return impl->prefetchZoomDelta;
 }
 
+void Map::setTileCacheSize(uint64_t size) {
+    impl->tileCacheSize = size;
+    impl->onUpdate(Update::Repaint);
+}
+
+uint64_t Map::getTileCacheSize() const {
+    return impl->tileCacheSize;
+}
+
+void Map::setPlacementBudget(uint32_t symbols) {
+    impl->placementBudget = symbols;
+}
+
+uint32_t Map::getPlacementBudget() const {
+    return impl->placementBudget;
+}
+
+void Map::setTileLODBias(optional<double> bias) {
+    impl->tileLODBias = bias;
+    impl->onUpdate(Update::Repaint);
+}
+
+optional<double> Map::getTileLODBias() const {
+    return impl->tileLODBias;
+}
+
+void Map::setStyleImagesOnDemand(bool onDemand) {
+    impl->styleImagesOnDemand = onDemand;
+    impl->onUpdate(Update::Repaint);
+}
+
+bool Map::getStyleImagesOnDemand() const {
+    return impl->styleImagesOnDemand;
+}
+
 bool Map::isFullyLoaded() const {
     return impl->style->impl->isLoaded() && impl->rendererFullyLoaded;
 }
@@ -704,6 +795,7 @@ void Map::Impl::onUpdate(Update flags) {
         transform.getState(),
         style->impl->getGlyphURL(),
         style->impl->spriteLoaded,
+        styleImagesOnDemand,
         style->impl->getTransitionOptions(),
         style->impl->getLight()->impl,
         style->impl->getImageImpls(),
@@ -713,7 +805,12 @@ void Map::Impl::onUpdate(Update flags) {
         fileSource,
         annotationManager,
         prefetchZoomDelta,
-        bool(stillImageRequest)
+        tileCacheSize,
+        placementBudget,
+        tileLODBias,
+        transform.getTransitionKeyframes(),
+        bool(stillImageRequest),
+        stillImageRequest && stillImageRequest->timedOut
     };
 
     rendererFrontend.update(std::make_shared<UpdateParameters>(std::move(params)));
@@ -548,20 +548,38 @@ void Transform::startTransition(const CameraOptions& camera,
         anchorLatLng = state.screenCoordinateToLatLng(*anchor);
     }
 
+    // Sample the camera path ahead of time by running the frame function on a scratch copy of
+    // the state.
+    transitionKeyframes.clear();
+    if (isAnimated) {
+        const TransformState current = state;
+        for (double k : { 0.25, 0.5, 0.75, 1.0 }) {
+            frame(k);
+            if (anchor) state.moveLatLng(anchorLatLng, *anchor);
+            transitionKeyframes.emplace_back(k, state);
+            state = current;
+        }
+    }
+
     transitionStart = Clock::now();
     transitionDuration = duration;
 
     transitionFrameFn = [isAnimated, animation, frame, anchor, anchorLatLng, this](const TimePoint now) {
         float t = isAnimated ? (std::chrono::duration<float>(now - transitionStart) / transitionDuration) : 1.0;
-        if (t >= 1.0) {
-            frame(1.0);
-        } else {
+        double k = 1.0;
+        if (t < 1.0) {
             util::UnitBezier ease = animation.easing ? *animation.easing : util::DEFAULT_TRANSITION_EASE;
-            frame(ease.solve(t, 0.001));
+            k = ease.solve(t, 0.001);
         }
+        frame(k);
 
         if (anchor) state.moveLatLng(anchorLatLng, *anchor);
 
+        // Drop keyframes the camera has already passed.
+        while (!transitionKeyframes.empty() && transitionKeyframes.front().first < k) {
+            transitionKeyframes.erase(transitionKeyframes.begin());
+        }
+
         // At t = 1.0, a DidChangeAnimated notification should be sent from finish().
         if (t < 1.0) {
             if (animation.transitionFrameFn) {
@@ -579,6 +597,7 @@ void Transform::startTransition(const CameraOptions& camera,
     };
 
     transitionFinishFn = [isAnimated, animation, this] {
+        transitionKeyframes.clear();
         state.panning = false;
         state.scaling = false;
         state.rotating = false;
@@ -597,6 +616,15 @@ bool Transform::inTransition() const {
     return transitionFrameFn != nullptr;
 }
 
+std::vector<TransformState> Transform::getTransitionKeyframes() const {
+    std::vector<TransformState> keyframes;
+    keyframes.reserve(transitionKeyframes.size());
+    for (const auto& keyframe : transitionKeyframes) {
+        keyframes.push_back(keyframe.second);
+    }
+    return keyframes;
+}
+
 void Transform::updateTransitions(const TimePoint& now) {
     if (transitionFrameFn) {
         transitionFrameFn(now);
@@ -608,6 +636,8 @@ void Transform::cancelTransitions() {
         transitionFinishFn();
     }
 
+    transitionKeyframes.clear();
+
     transitionFrameFn = nullptr;
     transitionFinishFn = nullptr;
 }
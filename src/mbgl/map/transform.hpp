@@ -12,6 +12,8 @@
 #include <cstdint>
 #include <cmath>
 #include <functional>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -132,6 +134,11 @@ public:
     Duration getTransitionDuration() const { return transitionDuration; }
     void cancelTransitions();
 
+    /** Returns camera states sampled along the remainder of the current
+        animation, ending with its destination, so that the tiles they
+        need can be requested before the camera gets there. */
+    std::vector<TransformState> getTransitionKeyframes() const;
+
     // Gesture
     void setGestureInProgress(bool);
     bool isGestureInProgress() const { return state.isGestureInProgress(); }
@@ -159,6 +166,9 @@ private:
     Duration transitionDuration;
     std::function<void(const TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
+
+    // Pairs of animation progress and the camera state at that point, in order.
+    std::vector<std::pair<double, TransformState>> transitionKeyframes;
 };
 
 } // namespace mbgl
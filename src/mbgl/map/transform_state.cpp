@@ -27,6 +27,18 @@ void TransformState::matrixFor(mat4& matrix, const UnwrappedTileID& tileID) cons
     matrix::scale(matrix, matrix, s / util::EXTENT, s / util::EXTENT, 1);
 }
 
+void TransformState::matrixFor(mat4& matrix, const UnwrappedTileID& tileID, const mat4& projMatrix) const {
+    const uint64_t tileScale = 1ull << tileID.canonical.z;
+    const double s = Projection::worldSize(scale) / tileScale;
+
+    // The tile's matrix only translates and scales, so rather than multiplying by it, translate
+    // and scale the projection: the result is the same, for a fraction of the work.
+    matrix::translate(matrix, projMatrix,
+                      int64_t(tileID.canonical.x + tileID.wrap * tileScale) * s,
+                      int64_t(tileID.canonical.y) * s, 0);
+    matrix::scale(matrix, matrix, s / util::EXTENT, s / util::EXTENT, 1);
+}
+
 void TransformState::getProjMatrix(mat4& projMatrix, uint16_t nearZ) const {
     if (size.isEmpty()) {
         return;
@@ -389,8 +401,7 @@ float TransformState::getCameraToTileDistance(const UnwrappedTileID& tileID) con
     mat4 projectionMatrix;
     getProjMatrix(projectionMatrix);
     mat4 tileProjectionMatrix;
-    matrixFor(tileProjectionMatrix, tileID);
-    matrix::multiply(tileProjectionMatrix, projectionMatrix, tileProjectionMatrix);
+    matrixFor(tileProjectionMatrix, tileID, projectionMatrix);
     vec4 tileCenter = {{util::tileSize / 2, util::tileSize / 2, 0, 1}};
     vec4 projectedCenter;
     matrix::transformMat4(projectedCenter, tileCenter, tileProjectionMatrix);
@@ -25,6 +25,8 @@ public:
 
     // Matrix
     void matrixFor(mat4&, const UnwrappedTileID&) const;
+    // The tile's matrix, projected by `projMatrix`.
+    void matrixFor(mat4&, const UnwrappedTileID&, const mat4& projMatrix) const;
     void getProjMatrix(mat4& matrix, uint16_t nearZ = 1) const;
 
     // Dimensions
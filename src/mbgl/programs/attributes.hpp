@@ -49,29 +49,33 @@ struct a_offset {
 
 // Paint attributes
 
+// Colors are encoded as a pair of packUint8Pair() values. They are stored as unsigned shorts,
+// which the shaders read as the same floats that they would otherwise be stored as, in half
+// the space.
+
 struct a_color {
     static auto name() { return "a_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_fill_color {
     static auto name() { return "a_fill_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_halo_color {
     static auto name() { return "a_halo_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_stroke_color {
     static auto name() { return "a_stroke_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_outline_color {
     static auto name() { return "a_outline_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_opacity {
@@ -140,5 +144,10 @@ struct a_halo_blur {
     using Type = gl::Attribute<float, 1>;
 };
 
+// Feature state attributes
+
+// The feature state of each vertex, from 0 to 255; see FeatureStateBuffer.
+MBGL_DEFINE_ATTRIBUTE(uint8_t, 1, a_state);
+
 } // namespace attributes
 } // namespace mbgl
@@ -3,7 +3,8 @@
 #include <mbgl/programs/program.hpp>
 #include <mbgl/programs/attributes.hpp>
 #include <mbgl/programs/uniforms.hpp>
-#include <mbgl/shaders/circle.hpp>
+#include <mbgl/shaders/circle_state.hpp>
+#include <mbgl/shaders/circle_instanced.hpp>
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/style/layers/circle_layer_properties.hpp>
 
@@ -13,18 +14,23 @@ namespace uniforms {
 MBGL_DEFINE_UNIFORM_SCALAR(bool, u_scale_with_map);
 } // namespace uniforms
 
+using CircleUniforms = gl::Uniforms<
+    uniforms::u_matrix,
+    uniforms::u_scale_with_map,
+    uniforms::u_extrude_scale,
+    uniforms::u_camera_to_center_distance,
+    uniforms::u_pitch_with_map,
+    uniforms::u_state_color>;
+
 class CircleProgram : public Program<
-    shaders::circle,
+    shaders::circle_state,
     gl::Triangle,
     gl::Attributes<
         attributes::a_pos>,
-    gl::Uniforms<
-        uniforms::u_matrix,
-        uniforms::u_scale_with_map,
-        uniforms::u_extrude_scale,
-        uniforms::u_camera_to_center_distance,
-        uniforms::u_pitch_with_map>,
-    style::CirclePaintProperties>
+    CircleUniforms,
+    style::CirclePaintProperties,
+    gl::Attributes<
+        attributes::a_state>>
 {
 public:
     using Program::Program;
@@ -45,7 +51,43 @@ public:
     }
 };
 
+// Draws a shared quad, through quadTriangleIndexBuffer, once for each circle.
+class CircleInstancedProgram : public InstancedProgram<
+    shaders::circle_instanced,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_extrude>,
+    gl::Attributes<
+        attributes::a_pos>,
+    CircleUniforms,
+    style::CirclePaintProperties,
+    gl::Attributes<
+        attributes::a_state>>
+{
+public:
+    using InstancedProgram::InstancedProgram;
+
+    /*
+     * @param {number} ex extrude normal
+     * @param {number} ey extrude normal
+     */
+    static LayoutVertex cornerVertex(int16_t ex, int16_t ey) {
+        return LayoutVertex {
+            {{ ex, ey }}
+        };
+    }
+
+    static InstanceVertex instanceVertex(Point<int16_t> p) {
+        return InstanceVertex {
+            {{ p.x, p.y }}
+        };
+    }
+};
+
 using CircleLayoutVertex = CircleProgram::LayoutVertex;
 using CircleAttributes = CircleProgram::Attributes;
+using CircleCornerVertex = CircleInstancedProgram::LayoutVertex;
+using CircleInstanceVertex = CircleInstancedProgram::InstanceVertex;
+using CircleInstancedAttributes = CircleInstancedProgram::Attributes;
 
 } // namespace mbgl
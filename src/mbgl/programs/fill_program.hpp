@@ -3,9 +3,9 @@
 #include <mbgl/programs/program.hpp>
 #include <mbgl/programs/attributes.hpp>
 #include <mbgl/programs/uniforms.hpp>
-#include <mbgl/shaders/fill.hpp>
+#include <mbgl/shaders/fill_state.hpp>
 #include <mbgl/shaders/fill_pattern.hpp>
-#include <mbgl/shaders/fill_outline.hpp>
+#include <mbgl/shaders/fill_outline_state.hpp>
 #include <mbgl/shaders/fill_outline_pattern.hpp>
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/util/mat4.hpp>
@@ -27,7 +27,8 @@ struct FillLayoutAttributes : gl::Attributes<
 
 struct FillUniforms : gl::Uniforms<
     uniforms::u_matrix,
-    uniforms::u_world>
+    uniforms::u_world,
+    uniforms::u_state_color>
 {};
 
 struct FillPatternUniforms : gl::Uniforms<
@@ -59,11 +60,13 @@ struct FillPatternUniforms : gl::Uniforms<
 };
 
 class FillProgram : public Program<
-    shaders::fill,
+    shaders::fill_state,
     gl::Triangle,
     FillLayoutAttributes,
     FillUniforms,
-    style::FillPaintProperties>
+    style::FillPaintProperties,
+    gl::Attributes<
+        attributes::a_state>>
 {
 public:
     using Program::Program;
@@ -90,11 +93,13 @@ public:
 };
 
 class FillOutlineProgram : public Program<
-    shaders::fill_outline,
+    shaders::fill_outline_state,
     gl::Line,
     FillLayoutAttributes,
     FillUniforms,
-    style::FillPaintProperties>
+    style::FillPaintProperties,
+    gl::Attributes<
+        attributes::a_state>>
 {
 public:
     using Program::Program;
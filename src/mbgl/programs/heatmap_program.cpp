@@ -0,0 +1,17 @@
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/programs/circle_program.hpp>
+#include <mbgl/programs/extrusion_texture_program.hpp>
+
+#include <type_traits>
+
+namespace mbgl {
+
+static_assert(std::is_same<HeatmapLayoutVertex, CircleLayoutVertex>::value,
+              "expected HeatmapLayoutVertex to match CircleLayoutVertex");
+static_assert(std::is_same<HeatmapInstancedProgram::LayoutVertex, CircleCornerVertex>::value &&
+              std::is_same<HeatmapInstancedProgram::InstanceVertex, CircleInstanceVertex>::value,
+              "expected the vertices of HeatmapInstancedProgram to match CircleInstancedProgram");
+static_assert(std::is_same<HeatmapTextureLayoutVertex, ExtrusionTextureLayoutVertex>::value,
+              "expected HeatmapTextureLayoutVertex to match ExtrusionTextureLayoutVertex");
+
+} // namespace mbgl
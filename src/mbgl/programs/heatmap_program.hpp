@@ -0,0 +1,73 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/shaders/heatmap.hpp>
+#include <mbgl/shaders/heatmap_instanced.hpp>
+#include <mbgl/shaders/heatmap_texture.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/style/layers/circle_layer_properties.hpp>
+#include <mbgl/style/properties.hpp>
+
+namespace mbgl {
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_SCALAR(float, u_intensity);
+MBGL_DEFINE_UNIFORM_SCALAR(gl::TextureUnit, u_color_ramp);
+} // namespace uniforms
+
+using HeatmapUniforms = gl::Uniforms<
+    uniforms::u_matrix,
+    uniforms::u_extrude_scale,
+    uniforms::u_intensity>;
+
+// Draws the circles of a circle layer bucket, with the vertices of CircleProgram, as kernels
+// into the density texture of a heatmap.
+class HeatmapProgram : public Program<
+    shaders::heatmap,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_pos>,
+    HeatmapUniforms,
+    style::CirclePaintProperties>
+{
+public:
+    using Program::Program;
+};
+
+// Draws the instances of a circle layer bucket, with the vertices of CircleInstancedProgram.
+class HeatmapInstancedProgram : public InstancedProgram<
+    shaders::heatmap_instanced,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_extrude>,
+    gl::Attributes<
+        attributes::a_pos>,
+    HeatmapUniforms,
+    style::CirclePaintProperties>
+{
+public:
+    using InstancedProgram::InstancedProgram;
+};
+
+// Draws the density texture over the viewport, with the vertices of ExtrusionTextureProgram.
+class HeatmapTextureProgram : public Program<
+    shaders::heatmap_texture,
+    gl::Triangle,
+    gl::Attributes<attributes::a_pos>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_world,
+        uniforms::u_image,
+        uniforms::u_color_ramp,
+        uniforms::u_opacity>,
+    style::Properties<>> {
+public:
+    using Program::Program;
+};
+
+using HeatmapLayoutVertex = HeatmapProgram::LayoutVertex;
+using HeatmapTextureLayoutVertex = HeatmapTextureProgram::LayoutVertex;
+
+} // namespace mbgl
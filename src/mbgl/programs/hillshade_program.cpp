@@ -0,0 +1,11 @@
+#include <mbgl/programs/hillshade_program.hpp>
+#include <mbgl/programs/raster_program.hpp>
+
+#include <type_traits>
+
+namespace mbgl {
+
+static_assert(std::is_same<HillshadeProgram::LayoutVertex, RasterLayoutVertex>::value,
+              "expected hillshade to be drawn with raster vertices");
+
+} // namespace mbgl
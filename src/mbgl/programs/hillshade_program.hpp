@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/shaders/hillshade.hpp>
+#include <mbgl/style/properties.hpp>
+
+namespace mbgl {
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_VECTOR(float, 3, u_light_direction);
+} // namespace uniforms
+
+// Draws the tiles of raster-dem sources, with the same vertices as raster tiles.
+class HillshadeProgram : public Program<
+    shaders::hillshade,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_pos,
+        attributes::a_texture_pos>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_image,
+        uniforms::u_light_direction,
+        uniforms::u_opacity>,
+    style::Properties<>>
+{
+public:
+    using Program::Program;
+};
+
+} // namespace mbgl
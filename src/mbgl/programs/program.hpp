@@ -10,15 +10,21 @@
 #include <mbgl/shaders/shaders.hpp>
 #include <mbgl/util/io.hpp>
 
-#include <unordered_map>
+#include <array>
+#include <memory>
+#include <vector>
 
 namespace mbgl {
 
+// Programs of layers that mix feature states into their colors also bind `StateAttrs`, from a
+// buffer of their own that is parallel to the layout vertices; see FeatureStateBuffer. The
+// segments of the buckets they draw are the same as without them.
 template <class Shaders,
           class Primitive,
           class LayoutAttrs,
           class Uniforms,
-          class PaintProps>
+          class PaintProps,
+          class StateAttrs = gl::Attributes<>>
 class Program {
 public:
     using LayoutAttributes = LayoutAttrs;
@@ -29,11 +35,14 @@ public:
     using PaintAttributes = typename PaintPropertyBinders::Attributes;
     using Attributes = gl::ConcatenateAttributes<LayoutAttributes, PaintAttributes>;
 
+    using StateAttributes = StateAttrs;
+    using AllAttributes = gl::ConcatenateAttributes<Attributes, StateAttributes>;
+
     using UniformValues = typename Uniforms::Values;
     using PaintUniforms = typename PaintPropertyBinders::Uniforms;
     using AllUniforms = gl::ConcatenateUniforms<Uniforms, PaintUniforms>;
 
-    using ProgramType = gl::Program<Primitive, Attributes, AllUniforms>;
+    using ProgramType = gl::Program<Primitive, AllAttributes, AllUniforms>;
 
     ProgramType program;
 
@@ -59,18 +68,31 @@ public:
               const PaintPropertyBinders& paintPropertyBinders,
               const typename PaintProperties::PossiblyEvaluated& currentProperties,
               float currentZoom,
-              const std::string& layerID) {
+              const std::vector<bool>& drawnSegments = {},
+              const typename StateAttributes::Bindings& stateAttributeBindings = {}) {
         typename AllUniforms::Values allUniformValues = uniformValues
             .concat(paintPropertyBinders.uniformValues(currentZoom, currentProperties));
 
-        typename Attributes::Bindings allAttributeBindings = LayoutAttributes::bindings(layoutVertexBuffer)
-            .concat(paintPropertyBinders.attributeBindings(currentProperties));
+        typename AllAttributes::Bindings allAttributeBindings = LayoutAttributes::bindings(layoutVertexBuffer)
+            .concat(paintPropertyBinders.attributeBindings(currentProperties))
+            .concat(stateAttributeBindings);
 
-        for (auto& segment : segments) {
-            auto vertexArrayIt = segment.vertexArrays.find(layerID);
+        for (std::size_t i = 0; i < segments.size(); i++) {
+            const auto& segment = segments[i];
+
+            // Segments without any indices, e.g. those holding only degenerate polygons, need no draw.
+            // If `drawnSegments` isn't empty, it has a flag for each segment, e.g. to cull those that
+            // are off-screen.
+            if (segment.indexLength == 0 || (!drawnSegments.empty() && !drawnSegments[i])) {
+                continue;
+            }
+
+            const typename AllAttributes::Bindings attributeBindings = AllAttributes::offsetBindings(allAttributeBindings, segment.vertexOffset);
+            const std::size_t key = program.vertexArrayKey(attributeBindings, indexBuffer.buffer);
+            auto vertexArrayIt = segment.vertexArrays.find(key);
 
             if (vertexArrayIt == segment.vertexArrays.end()) {
-                vertexArrayIt = segment.vertexArrays.emplace(layerID, context.createVertexArray()).first;
+                vertexArrayIt = segment.vertexArrays.emplace(key, context.createVertexArray()).first;
             }
 
             program.draw(
@@ -81,7 +103,7 @@ public:
                 std::move(colorMode),
                 allUniformValues,
                 vertexArrayIt->second,
-                Attributes::offsetBindings(allAttributeBindings, segment.vertexOffset),
+                attributeBindings,
                 indexBuffer,
                 segment.indexOffset,
                 segment.indexLength);
@@ -89,6 +111,109 @@ public:
     }
 };
 
+// Draws the same layout vertices once for every vertex of an instance buffer. Paint attributes
+// that vary by feature are bound per instance too, so the paint property binders are expected
+// to hold one vertex per instance. Segments are ranges of instances. So are the vertices of the
+// state attributes, see Program.
+template <class Shaders,
+          class Primitive,
+          class LayoutAttrs,
+          class InstanceAttrs,
+          class Uniforms,
+          class PaintProps,
+          class StateAttrs = gl::Attributes<>>
+class InstancedProgram {
+public:
+    using LayoutAttributes = LayoutAttrs;
+    using LayoutVertex = typename LayoutAttributes::Vertex;
+
+    using InstanceAttributes = InstanceAttrs;
+    using InstanceVertex = typename InstanceAttributes::Vertex;
+
+    using PaintProperties = PaintProps;
+    using PaintPropertyBinders = typename PaintProperties::Binders;
+    using PaintAttributes = typename PaintPropertyBinders::Attributes;
+    using PerInstanceAttributes = gl::ConcatenateAttributes<InstanceAttributes, PaintAttributes>;
+    using Attributes = gl::ConcatenateAttributes<LayoutAttributes, PerInstanceAttributes>;
+
+    using StateAttributes = StateAttrs;
+    using AllPerInstanceAttributes = gl::ConcatenateAttributes<PerInstanceAttributes, StateAttributes>;
+    using AllAttributes = gl::ConcatenateAttributes<LayoutAttributes, AllPerInstanceAttributes>;
+
+    using UniformValues = typename Uniforms::Values;
+    using PaintUniforms = typename PaintPropertyBinders::Uniforms;
+    using AllUniforms = gl::ConcatenateUniforms<Uniforms, PaintUniforms>;
+
+    using ProgramType = gl::Program<Primitive, AllAttributes, AllUniforms>;
+
+    ProgramType program;
+
+    InstancedProgram(gl::Context& context, const ProgramParameters& programParameters)
+        : program(ProgramType::createProgram(
+            context,
+            programParameters,
+            Shaders::name,
+            Shaders::vertexSource,
+            Shaders::fragmentSource)) {
+    }
+
+    template <class DrawMode>
+    void draw(gl::Context& context,
+              DrawMode drawMode,
+              gl::DepthMode depthMode,
+              gl::StencilMode stencilMode,
+              gl::ColorMode colorMode,
+              const UniformValues& uniformValues,
+              const gl::VertexBuffer<LayoutVertex>& layoutVertexBuffer,
+              const gl::IndexBuffer<DrawMode>& indexBuffer,
+              const gl::VertexBuffer<InstanceVertex>& instanceBuffer,
+              const SegmentVector<Attributes>& segments,
+              const PaintPropertyBinders& paintPropertyBinders,
+              const typename PaintProperties::PossiblyEvaluated& currentProperties,
+              float currentZoom,
+              const typename StateAttributes::Bindings& stateAttributeBindings = {}) {
+        typename AllUniforms::Values allUniformValues = uniformValues
+            .concat(paintPropertyBinders.uniformValues(currentZoom, currentProperties));
+
+        const typename LayoutAttributes::Bindings layoutAttributeBindings =
+            LayoutAttributes::bindings(layoutVertexBuffer);
+
+        const typename AllPerInstanceAttributes::Bindings instanceAttributeBindings =
+            AllPerInstanceAttributes::instanceBindings(InstanceAttributes::bindings(instanceBuffer)
+                .concat(paintPropertyBinders.attributeBindings(currentProperties))
+                .concat(stateAttributeBindings));
+
+        for (auto& segment : segments) {
+            if (segment.vertexLength == 0) {
+                continue;
+            }
+
+            const typename AllAttributes::Bindings attributeBindings = layoutAttributeBindings.concat(
+                AllPerInstanceAttributes::offsetBindings(instanceAttributeBindings, segment.vertexOffset));
+            const std::size_t key = program.vertexArrayKey(attributeBindings, indexBuffer.buffer);
+            auto vertexArrayIt = segment.vertexArrays.find(key);
+
+            if (vertexArrayIt == segment.vertexArrays.end()) {
+                vertexArrayIt = segment.vertexArrays.emplace(key, context.createVertexArray()).first;
+            }
+
+            program.drawInstanced(
+                context,
+                std::move(drawMode),
+                std::move(depthMode),
+                std::move(stencilMode),
+                std::move(colorMode),
+                allUniformValues,
+                vertexArrayIt->second,
+                attributeBindings,
+                indexBuffer,
+                0,
+                indexBuffer.indexCount,
+                segment.vertexLength);
+        }
+    }
+};
+
 template <class Program>
 class ProgramMap {
 public:
@@ -102,21 +227,46 @@ public:
     }
 
     Program& get(const typename PaintProperties::PossiblyEvaluated& currentProperties) {
-        Bitset bits = PaintPropertyBinders::constants(currentProperties);
-        auto it = programs.find(bits);
-        if (it != programs.end()) {
-            return it->second;
+        const Bitset bits = PaintPropertyBinders::constants(currentProperties);
+        std::unique_ptr<Program>& program = programs[bits.to_ulong()];
+        if (!program) {
+            program = std::make_unique<Program>(context,
+                parameters.withAdditionalDefines(PaintPropertyBinders::defines(currentProperties)));
+        }
+        return *program;
+    }
+
+private:
+    // Programs have few data-driven paint properties, so every combination of constant ones has
+    // a slot in a fixed table, indexed by the bits of the combination.
+    static constexpr std::size_t variants = std::size_t(1) << Bitset().size();
+    static_assert(variants <= 256, "too many program variants for a lookup table");
+
+    gl::Context& context;
+    ProgramParameters parameters;
+    std::array<std::unique_ptr<Program>, variants> programs;
+};
+
+// A program without variants, compiled the first time it's used rather than with the others.
+template <class Program>
+class LazyProgram {
+public:
+    LazyProgram(gl::Context& context_, ProgramParameters parameters_)
+        : context(context_),
+          parameters(std::move(parameters_)) {
+    }
+
+    Program& get() {
+        if (!program) {
+            program = std::make_unique<Program>(context, parameters);
         }
-        return programs.emplace(std::piecewise_construct,
-                                std::forward_as_tuple(bits),
-                                std::forward_as_tuple(context,
-                                    parameters.withAdditionalDefines(PaintPropertyBinders::defines(currentProperties)))).first->second;
+        return *program;
     }
 
 private:
     gl::Context& context;
     ProgramParameters parameters;
-    std::unordered_map<Bitset, Program> programs;
+    std::unique_ptr<Program> program;
 };
 
 } // namespace mbgl
@@ -4,6 +4,8 @@
 #include <mbgl/programs/extrusion_texture_program.hpp>
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/programs/hillshade_program.hpp>
 #include <mbgl/programs/line_program.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/programs/symbol_program.hpp>
@@ -16,7 +18,9 @@ namespace mbgl {
 class Programs {
 public:
     Programs(gl::Context& context, const ProgramParameters& programParameters)
-        : circle(context, programParameters),
+        : instancing(context.getInstancedArraysExtension() != nullptr),
+          circle(context, programParameters),
+          circleInstanced(context, programParameters),
           extrusionTexture(context, programParameters),
           fill(context, programParameters),
           fillExtrusion(context, programParameters),
@@ -24,6 +28,10 @@ public:
           fillPattern(context, programParameters),
           fillOutline(context, programParameters),
           fillOutlinePattern(context, programParameters),
+          heatmap(context, programParameters),
+          heatmapInstanced(context, programParameters),
+          heatmapTexture(context, programParameters),
+          hillshade(context, programParameters),
           line(context, programParameters),
           lineSDF(context, programParameters),
           linePattern(context, programParameters),
@@ -35,24 +43,32 @@ public:
           collisionBox(context, programParameters) {
     }
 
+    // Whether buckets are drawn with instanced arrays, and so with the instanced programs.
+    const bool instancing;
+
     ProgramMap<CircleProgram> circle;
-    ExtrusionTextureProgram extrusionTexture;
+    ProgramMap<CircleInstancedProgram> circleInstanced;
+    LazyProgram<ExtrusionTextureProgram> extrusionTexture;
     ProgramMap<FillProgram> fill;
     ProgramMap<FillExtrusionProgram> fillExtrusion;
     ProgramMap<FillExtrusionPatternProgram> fillExtrusionPattern;
     ProgramMap<FillPatternProgram> fillPattern;
     ProgramMap<FillOutlineProgram> fillOutline;
     ProgramMap<FillOutlinePatternProgram> fillOutlinePattern;
+    ProgramMap<HeatmapProgram> heatmap;
+    ProgramMap<HeatmapInstancedProgram> heatmapInstanced;
+    LazyProgram<HeatmapTextureProgram> heatmapTexture;
+    LazyProgram<HillshadeProgram> hillshade;
     ProgramMap<LineProgram> line;
     ProgramMap<LineSDFProgram> lineSDF;
     ProgramMap<LinePatternProgram> linePattern;
-    RasterProgram raster;
+    LazyProgram<RasterProgram> raster;
     ProgramMap<SymbolIconProgram> symbolIcon;
     ProgramMap<SymbolSDFIconProgram> symbolIconSDF;
     ProgramMap<SymbolSDFTextProgram> symbolGlyph;
 
-    DebugProgram debug;
-    CollisionBoxProgram collisionBox;
+    LazyProgram<DebugProgram> debug;
+    LazyProgram<CollisionBoxProgram> collisionBox;
 };
 
 } // namespace mbgl
@@ -5,7 +5,7 @@
 
 #include <cstddef>
 #include <vector>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
@@ -27,17 +27,25 @@ public:
     std::size_t vertexLength;
     std::size_t indexLength;
 
-    // One VertexArray per layer ID. This minimizes rebinding in cases where
-    // several layers share buckets but have different sets of active attributes.
-    // This can happen:
-    //   * when two layers have the same layout properties, but differing
-    //     data-driven paint properties
-    //   * when two fill layers have the same layout properties, but one
-    //     uses fill-color and the other uses fill-pattern
-    mutable std::map<std::string, gl::VertexArray> vertexArrays;
+    // One VertexArray per set of buffers and program the segment is drawn with, keyed by
+    // gl::Program::vertexArrayKey(). Layers that share buckets draw with the same vertex array
+    // unless they have different sets of active attributes, e.g. because of differing data-driven
+    // paint properties, or because one fill layer uses fill-color and the other fill-pattern. A
+    // vertex array is bound once, when it's created. They're released with the buffers they're
+    // bound to, see releaseVertexArrays().
+    mutable std::unordered_map<std::size_t, gl::VertexArray> vertexArrays;
 };
 
 template <class Attributes>
 using SegmentVector = std::vector<Segment<Attributes>>;
 
+// Releases the vertex arrays of the segments, which is needed when the buffers they're bound to
+// are replaced: vertex arrays keep deleted buffers alive, and their names may be reused.
+template <class Attributes>
+void releaseVertexArrays(const SegmentVector<Attributes>& segments) {
+    for (const auto& segment : segments) {
+        segment.vertexArrays.clear();
+    }
+}
+
 } // namespace mbgl
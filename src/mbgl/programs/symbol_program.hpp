@@ -315,8 +315,7 @@ public:
               const SegmentVector<Attributes>& segments,
               const PaintPropertyBinders& paintPropertyBinders,
               const typename PaintProperties::PossiblyEvaluated& currentProperties,
-              float currentZoom,
-              const std::string& layerID) {
+              float currentZoom) {
         typename AllUniforms::Values allUniformValues = uniformValues
             .concat(symbolSizeBinder.uniformValues(currentZoom))
             .concat(paintPropertyBinders.uniformValues(currentZoom, currentProperties));
@@ -326,10 +325,12 @@ public:
             .concat(paintPropertyBinders.attributeBindings(currentProperties));
 
         for (auto& segment : segments) {
-            auto vertexArrayIt = segment.vertexArrays.find(layerID);
+            const typename Attributes::Bindings attributeBindings = Attributes::offsetBindings(allAttributeBindings, segment.vertexOffset);
+            const std::size_t key = program.vertexArrayKey(attributeBindings, indexBuffer.buffer);
+            auto vertexArrayIt = segment.vertexArrays.find(key);
 
             if (vertexArrayIt == segment.vertexArrays.end()) {
-                vertexArrayIt = segment.vertexArrays.emplace(layerID, context.createVertexArray()).first;
+                vertexArrayIt = segment.vertexArrays.emplace(key, context.createVertexArray()).first;
             }
 
             program.draw(
@@ -340,7 +341,7 @@ public:
                 std::move(colorMode),
                 allUniformValues,
                 vertexArrayIt->second,
-                Attributes::offsetBindings(allAttributeBindings, segment.vertexOffset),
+                attributeBindings,
                 indexBuffer,
                 segment.indexOffset,
                 segment.indexLength);
@@ -26,6 +26,7 @@ MBGL_DEFINE_UNIFORM_SCALAR(Color, u_halo_color);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_halo_width);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_halo_blur);
 MBGL_DEFINE_UNIFORM_SCALAR(Color, u_outline_color);
+MBGL_DEFINE_UNIFORM_SCALAR(Color, u_state_color);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_height);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_base);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_width);
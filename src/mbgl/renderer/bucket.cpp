@@ -0,0 +1,31 @@
+#include <mbgl/renderer/bucket.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+namespace mbgl {
+
+void Bucket::serializeFeatures(protozero::pbf_writer& pbf, uint32_t tag) const {
+    std::vector<uint32_t> values;
+    values.reserve(features.size() * 2);
+    for (const auto& feature : features) {
+        values.push_back(feature.first);
+        values.push_back(feature.second);
+    }
+    pbf.add_packed_uint32(tag, values.begin(), values.end());
+}
+
+bool Bucket::deserializeFeatures(protozero::pbf_reader& pbf) {
+    const auto range = pbf.get_packed_uint32();
+    const std::vector<uint32_t> values(range.begin(), range.end());
+    if (values.size() % 2 != 0) {
+        return false;
+    }
+    features.clear();
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+        features.emplace_back(values[i], values[i + 1]);
+    }
+    return true;
+}
+
+} // namespace mbgl
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <mbgl/renderer/renderer_statistics.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace protozero {
+class pbf_reader;
+class pbf_writer;
+} // namespace protozero
 
 namespace mbgl {
 
@@ -20,9 +32,36 @@ public:
 
     // Feature geometries are also used to populate the feature index.
     // Obtaining these is a costly operation, so we do it only once, and
-    // pass-by-const-ref the geometries as a second parameter.
+    // pass-by-const-ref the geometries as a second parameter. The index is the position of the
+    // feature in its source layer.
     virtual void addFeature(const GeometryTileFeature&,
-                            const GeometryCollection&) {};
+                            const GeometryCollection&,
+                            std::size_t /* index */) {};
+
+    // Buckets whose layers changed in data-driven paint properties only are repainted rather
+    // than laid out again. On the worker, repaint() populates the paint attributes of this bucket,
+    // just created for the changed layers, for the features of `laidOut`, a bucket of the same
+    // type laid out before; it returns false if the bucket can't be repainted. On the render
+    // thread, the tile hands this bucket to setPaint() of `laidOut`, and uploadPaint() then swaps
+    // the paint attributes in.
+    virtual bool repaint(const Bucket& /* laidOut */, const GeometryTileLayer&) {
+        return false;
+    }
+
+    void setPaint(std::shared_ptr<Bucket> painted) {
+        pendingPaint = std::move(painted);
+    }
+
+    bool needsPaintUpload() const {
+        return bool(pendingPaint);
+    }
+
+    void uploadPaint(gl::Context& context) {
+        swapPaint(*pendingPaint, context);
+        // Releases the paint attributes this bucket had before on the render thread, once their
+        // replacements are uploaded.
+        pendingPaint.reset();
+    }
 
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
     // this only happens once when the bucket is being rendered for the first time.
@@ -30,6 +69,23 @@ public:
 
     virtual bool hasData() const = 0;
 
+    // Memory held by this bucket: vertex, index and image data on the CPU, and the GL buffers
+    // and textures they're uploaded to.
+    virtual RendererStatistics::Memory memoryUsage() const = 0;
+
+    std::size_t byteSize() const {
+        const RendererStatistics::Memory memory = memoryUsage();
+        return memory.cpu + memory.gpu;
+    }
+
+    // The features added to the bucket, and the vertices they make up.
+    std::size_t getFeatureCount() const {
+        return features.size();
+    }
+    virtual std::size_t getVertexCount() const {
+        return features.empty() ? 0 : features.back().second;
+    }
+
     virtual float getQueryRadius(const RenderLayer&) const {
         return 0;
     };
@@ -38,8 +94,83 @@ public:
         return hasData() && !uploaded;
     }
 
+    // Buckets whose geometry can be kept in a TileSnapshot write it with serialize(), which
+    // returns false if the bucket can't be written, e.g. because it has data-driven paint
+    // attributes. deserialize() reads it back into a bucket just created for the same layers, and
+    // returns false if the data doesn't fit the bucket.
+    virtual bool serialize(protozero::pbf_writer&) const {
+        return false;
+    }
+    virtual bool deserialize(protozero::pbf_reader&) {
+        return false;
+    }
+
 protected:
+    // Called by addFeature() implementations with the index of the feature and the number of
+    // vertices the bucket has once the feature is added, for repaint().
+    void addedFeature(std::size_t index, std::size_t vertexCount) {
+        features.emplace_back(uint32_t(index), uint32_t(vertexCount));
+    }
+
+    // Adds the paint property binders of a layer, sharing the binders of the layers added before
+    // it wherever they bind the same function.
+    template <class Binders, class EvaluatedProperties>
+    static void addBinders(Binders& binders, const std::string& layerID,
+                           const EvaluatedProperties& properties, float zoom) {
+        auto& added = binders.emplace(std::piecewise_construct,
+                                      std::forward_as_tuple(layerID),
+                                      std::forward_as_tuple(properties, zoom)).first->second;
+        for (const auto& pair : binders) {
+            if (&pair.second != &added) {
+                added.share(properties, pair.second);
+            }
+        }
+    }
+
+    // Returns true if the binders of all layers of the bucket have no attribute data.
+    template <class Binders>
+    static bool hasConstantPaint(const Binders& binders) {
+        for (const auto& pair : binders) {
+            if (!pair.second.isConstant()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The features of the bucket, for serialize() and deserialize() implementations.
+    void serializeFeatures(protozero::pbf_writer&, uint32_t tag) const;
+    bool deserializeFeatures(protozero::pbf_reader&);
+
+    // Populates paint property binders for the features of `laidOut`.
+    template <class Binders>
+    static void repaintFeatures(Binders& binders, const Bucket& laidOut, const GeometryTileLayer& layer) {
+        for (const auto& entry : laidOut.features) {
+            const std::unique_ptr<GeometryTileFeature> feature = layer.getFeature(entry.first);
+            for (auto& pair : binders) {
+                pair.second.populateVertexVectors(*feature, entry.second);
+            }
+        }
+    }
+
+    // Swaps the paint attributes of this bucket with those of `painted`, and uploads them if the
+    // bucket is uploaded already.
+    virtual void swapPaint(Bucket& /* painted */, gl::Context&) {}
+
     std::atomic<bool> uploaded { false };
+
+private:
+    friend class BucketUploader;
+
+    // The features added to the bucket, with the number of vertices after each of them. Not
+    // changed once the bucket is laid out, so that the worker may read them meanwhile.
+    std::vector<std::pair<uint32_t, uint32_t>> features;
+
+    // A bucket passed to setPaint() that wasn't uploaded yet.
+    std::shared_ptr<Bucket> pendingPaint;
+
+    // Set while the bucket is owned by the BucketUploader's upload thread.
+    bool uploadScheduled = false;
 };
 
 } // namespace mbgl
@@ -5,11 +5,17 @@
 
 namespace mbgl {
 
+class TessellationCache;
+
 class BucketParameters {
 public:
     const OverscaledTileID tileID;
     const MapMode mode;
     const float pixelRatio;
+    // Whether buckets may lay their geometry out for instanced drawing.
+    const bool instancing = false;
+    // Triangulations of polygons, reused by the layouts of a tile until its data changes.
+    TessellationCache* const tessellationCache = nullptr;
 };
 
 } // namespace mbgl
@@ -0,0 +1,158 @@
+#include <mbgl/renderer/bucket_uploader.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/renderer_backend.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+class BucketUploader::Queue {
+public:
+    struct Batch {
+        gl::Context::Fence fence;
+        std::vector<std::shared_ptr<Bucket>> buckets;
+    };
+
+    std::mutex mutex;
+    std::condition_variable completion;
+
+    // Buckets waiting for the upload thread, and the batches it has uploaded but the render
+    // thread hasn't collected yet. Buckets are only ever released on the render thread, keeping
+    // the deletion of their GL objects on the thread that owns them.
+    std::vector<std::shared_ptr<Bucket>> pending;
+    std::vector<Batch> completed;
+};
+
+class BucketUploader::Worker {
+public:
+    Worker(ActorRef<Worker>,
+           std::function<void ()> activate,
+           std::function<void ()> deactivate_,
+           std::function<gl::ProcAddress (const char*)> getProcAddress,
+           gl::Context& owner,
+           std::shared_ptr<Queue> queue_)
+        : deactivate(std::move(deactivate_)),
+          queue(std::move(queue_)) {
+        activate();
+        context = std::make_unique<gl::Context>();
+        context->initializeExtensions(getProcAddress);
+        context->setObjectOwner(owner);
+    }
+
+    ~Worker() {
+        context.reset();
+        deactivate();
+    }
+
+    void process() {
+        Queue::Batch batch;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            batch.buckets.swap(queue->pending);
+        }
+
+        if (batch.buckets.empty()) {
+            return;
+        }
+
+        for (auto& bucket : batch.buckets) {
+            if (bucket->needsUpload()) {
+                bucket->upload(*context);
+            }
+        }
+        batch.fence = context->createFence();
+
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->completed.push_back(std::move(batch));
+        }
+        queue->completion.notify_all();
+    }
+
+private:
+    const std::function<void ()> deactivate;
+    const std::shared_ptr<Queue> queue;
+    std::unique_ptr<gl::Context> context;
+};
+
+BucketUploader::BucketUploader(RendererBackend& backend)
+    : context(backend.getContext()),
+      queue(std::make_shared<Queue>()),
+      thread(std::make_unique<util::Thread<Worker>>(
+          "BucketUploader",
+          [&backend] { backend.activateUploadContext(); },
+          [&backend] { backend.deactivateUploadContext(); },
+          [&backend] (const char* name) { return backend.initializeExtension(name); },
+          context,
+          queue)) {
+}
+
+BucketUploader::~BucketUploader() {
+    // Waits for the upload in progress, if any; buckets still pending are abandoned.
+    thread.reset();
+    collect(context);
+
+    for (auto& bucket : queue->pending) {
+        bucket->uploadScheduled = false;
+    }
+    queue->pending.clear();
+}
+
+void BucketUploader::schedule(const std::unordered_map<std::string, std::shared_ptr<Bucket>>& buckets) {
+    bool scheduled = false;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (const auto& entry : buckets) {
+            Bucket& bucket = *entry.second;
+            if (!bucket.uploadScheduled && bucket.needsUpload()) {
+                bucket.uploadScheduled = true;
+                queue->pending.push_back(entry.second);
+                scheduled = true;
+            }
+        }
+    }
+
+    if (scheduled) {
+        thread->actor().invoke(&Worker::process);
+    }
+}
+
+void BucketUploader::upload(Bucket& bucket, gl::Context& context) {
+    if (!bucket.uploadScheduled) {
+        if (bucket.needsUpload()) {
+            bucket.upload(context);
+        }
+        return;
+    }
+
+    collect(context);
+    while (bucket.uploadScheduled) {
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->completion.wait(lock, [&] { return !queue->completed.empty(); });
+        }
+        collect(context);
+    }
+}
+
+void BucketUploader::collect(gl::Context& context) {
+    std::vector<Queue::Batch> completed;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        completed.swap(queue->completed);
+    }
+
+    for (auto& batch : completed) {
+        context.waitFence(batch.fence);
+        for (auto& bucket : batch.buckets) {
+            bucket->uploadScheduled = false;
+        }
+    }
+}
+
+} // namespace mbgl
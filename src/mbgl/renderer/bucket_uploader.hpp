@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class Bucket;
+class RendererBackend;
+
+namespace gl {
+class Context;
+} // namespace gl
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Turns tile buckets into GPU buffers on a separate thread, through an OpenGL context that shares
+// objects with the rendering context, so that tiles arriving in bulk don't stall a frame. Fences
+// keep the rendering context from drawing buffers before their upload has completed.
+//
+// All member functions must be called on the render thread, with the rendering context active.
+class BucketUploader : private util::noncopyable {
+public:
+    BucketUploader(RendererBackend&);
+    ~BucketUploader();
+
+    // Queues the buckets that still need uploading. From then on, they're uploaded by the upload
+    // thread only, and must be passed to upload() before they're drawn.
+    void schedule(const std::unordered_map<std::string, std::shared_ptr<Bucket>>&);
+
+    // Makes the bucket ready for drawing through `context`: waits for its upload to finish if it
+    // was scheduled, or uploads it right away otherwise.
+    void upload(Bucket&, gl::Context&);
+
+private:
+    // Makes the buckets that the upload thread finished so far available to `context`.
+    void collect(gl::Context&);
+
+    class Queue;
+    class Worker;
+
+    gl::Context& context;
+    const std::shared_ptr<Queue> queue;
+    std::unique_ptr<util::Thread<Worker>> thread;
+};
+
+} // namespace mbgl
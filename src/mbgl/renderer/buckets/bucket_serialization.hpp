@@ -0,0 +1,111 @@
+#pragma once
+
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/programs/segment.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// Helpers for implementations of Bucket::serialize() and Bucket::deserialize(). Vertices and
+// indices are written as they're laid out in memory, so only the build that wrote them may read
+// them back.
+
+template <class V, class DrawMode>
+void serializeVertices(protozero::pbf_writer& pbf, protozero::pbf_tag_type tag,
+                       const gl::VertexVector<V, DrawMode>& vertices) {
+    pbf.add_bytes(tag, reinterpret_cast<const char*>(vertices.data()), vertices.byteSize());
+}
+
+template <class V, class DrawMode>
+bool deserializeVertices(protozero::pbf_reader& pbf, gl::VertexVector<V, DrawMode>& vertices) {
+    const protozero::data_view bytes = pbf.get_view();
+    if (bytes.size() % sizeof(V) != 0) {
+        return false;
+    }
+    vertices.assign(bytes.data(), bytes.size() / sizeof(V));
+    return true;
+}
+
+template <class DrawMode>
+void serializeIndices(protozero::pbf_writer& pbf, protozero::pbf_tag_type tag,
+                      const gl::IndexVector<DrawMode>& indices) {
+    pbf.add_bytes(tag, reinterpret_cast<const char*>(indices.data()), indices.byteSize());
+}
+
+template <class DrawMode>
+bool deserializeIndices(protozero::pbf_reader& pbf, gl::IndexVector<DrawMode>& indices) {
+    const protozero::data_view bytes = pbf.get_view();
+    if (bytes.size() % (sizeof(uint16_t) * DrawMode::bufferGroupSize) != 0) {
+        return false;
+    }
+    indices.assign(bytes.data(), bytes.size() / sizeof(uint16_t));
+    return true;
+}
+
+// Segments are written as the offsets and lengths of each, in a single packed field.
+template <class Attributes>
+void serializeSegments(protozero::pbf_writer& pbf, protozero::pbf_tag_type tag,
+                       const SegmentVector<Attributes>& segments) {
+    std::vector<uint64_t> values;
+    values.reserve(segments.size() * 4);
+    for (const auto& segment : segments) {
+        values.push_back(segment.vertexOffset);
+        values.push_back(segment.indexOffset);
+        values.push_back(segment.vertexLength);
+        values.push_back(segment.indexLength);
+    }
+    pbf.add_packed_uint64(tag, values.begin(), values.end());
+}
+
+template <class Attributes>
+bool deserializeSegments(protozero::pbf_reader& pbf, SegmentVector<Attributes>& segments) {
+    const auto range = pbf.get_packed_uint64();
+    const std::vector<uint64_t> values(range.begin(), range.end());
+    if (values.size() % 4 != 0) {
+        return false;
+    }
+    for (std::size_t i = 0; i < values.size(); i += 4) {
+        segments.emplace_back(values[i], values[i + 1], values[i + 2], values[i + 3]);
+    }
+    return true;
+}
+
+// Returns true if the segments stay within `vertexCount` vertices, and within `indexCount`
+// indices unless they index into a shared index buffer.
+template <class Attributes>
+bool validSegments(const SegmentVector<Attributes>& segments, std::size_t vertexCount,
+                   optional<std::size_t> indexCount = {}) {
+    for (const auto& segment : segments) {
+        if (segment.vertexOffset + segment.vertexLength > vertexCount ||
+            (indexCount && segment.indexOffset + segment.indexLength > *indexCount)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if, in addition, the indices of each segment refer to its own vertices.
+template <class Attributes, class DrawMode>
+bool validSegments(const SegmentVector<Attributes>& segments, std::size_t vertexCount,
+                   const gl::IndexVector<DrawMode>& indices) {
+    if (!validSegments(segments, vertexCount, indices.indexSize())) {
+        return false;
+    }
+    for (const auto& segment : segments) {
+        for (std::size_t i = segment.indexOffset; i < segment.indexOffset + segment.indexLength; i++) {
+            if (indices.data()[i] >= segment.vertexLength) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace mbgl
@@ -1,4 +1,5 @@
 #include <mbgl/renderer/buckets/circle_bucket.hpp>
+#include <mbgl/renderer/buckets/bucket_serialization.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/programs/circle_program.hpp>
 #include <mbgl/style/layers/circle_layer_impl.hpp>
@@ -11,20 +12,20 @@ namespace mbgl {
 using namespace style;
 
 CircleBucket::CircleBucket(const BucketParameters& parameters, const std::vector<const RenderLayer*>& layers)
-    : mode(parameters.mode) {
+    : mode(parameters.mode),
+      instanced(parameters.instancing) {
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(layer->getID()),
-            std::forward_as_tuple(
-                layer->as<RenderCircleLayer>()->evaluated,
-                parameters.tileID.overscaledZ));
+        addBinders(paintPropertyBinders, layer->getID(), layer->as<RenderCircleLayer>()->evaluated,
+                   parameters.tileID.overscaledZ);
     }
 }
 
 void CircleBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (instanced) {
+        instanceBuffer = context.createVertexBuffer(std::move(instances));
+    } else {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -34,12 +35,64 @@ void CircleBucket::upload(gl::Context& context) {
 }
 
 bool CircleBucket::hasData() const {
-    return !segments.empty();
+    return !segments.empty() || !instanceSegments.empty();
+}
+
+RendererStatistics::Memory CircleBucket::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = vertices.byteSize() + instances.byteSize();
+    memory.gpu = (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (instanceBuffer ? instanceBuffer->byteSize() : 0);
+    memory += featureState.memoryUsage();
+    return memory;
+}
+
+bool CircleBucket::serialize(protozero::pbf_writer& pbf) const {
+    if (uploaded || !hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    serializeFeatures(pbf, 1);
+    pbf.add_bool(2, instanced);
+    if (instanced) {
+        serializeVertices(pbf, 3, instances);
+        serializeSegments(pbf, 4, instanceSegments);
+    } else {
+        serializeVertices(pbf, 3, vertices);
+        serializeSegments(pbf, 4, segments);
+    }
+    featureState.serialize(pbf, 5);
+    return true;
+}
+
+bool CircleBucket::deserialize(protozero::pbf_reader& pbf) {
+    if (!hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    while (pbf.next()) {
+        bool valid = true;
+        switch (pbf.tag()) {
+        case 1: valid = deserializeFeatures(pbf); break;
+        // Buckets are laid out either for instanced drawing or not, depending on the context.
+        case 2: valid = pbf.get_bool() == instanced; break;
+        case 3: valid = instanced ? deserializeVertices(pbf, instances) : deserializeVertices(pbf, vertices); break;
+        case 4: valid = instanced ? deserializeSegments(pbf, instanceSegments) : deserializeSegments(pbf, segments); break;
+        case 5: valid = featureState.deserialize(pbf); break;
+        default: pbf.skip(); break;
+        }
+        if (!valid) {
+            return false;
+        }
+    }
+    // The segments index into the quads of RenderStaticData.
+    return instanced ? validSegments(instanceSegments, instances.vertexSize())
+                     : validSegments(segments, vertices.vertexSize());
 }
 
 void CircleBucket::addFeature(const GeometryTileFeature& feature,
-                              const GeometryCollection& geometry) {
+                              const GeometryCollection& geometry,
+                              std::size_t index) {
     constexpr const uint16_t vertexLength = 4;
+    const std::size_t begin = instanced ? instances.vertexSize() : vertices.vertexSize();
 
     for (auto& circle : geometry) {
         for(auto& point : circle) {
@@ -52,9 +105,20 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             if ((mode != MapMode::Still) &&
                 (x < 0 || x >= util::EXTENT || y < 0 || y >= util::EXTENT)) continue;
 
+            if (instanced) {
+                // Instances aren't addressed through 16 bit indices, so a single segment holds
+                // all of them.
+                if (instanceSegments.empty()) {
+                    instanceSegments.emplace_back(0, 0);
+                }
+                instances.emplace_back(CircleInstancedProgram::instanceVertex(point));
+                instanceSegments.back().vertexLength++;
+                continue;
+            }
+
             if (segments.empty() || segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
                 // Move to a new segments because the old one can't hold the geometry.
-                segments.emplace_back(vertices.vertexSize(), triangles.indexSize());
+                segments.emplace_back(vertices.vertexSize(), 0);
             }
 
             // this geometry will be of the Point type, and we'll derive
@@ -71,22 +135,34 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             vertices.emplace_back(CircleProgram::vertex(point,  1,  1)); // 3
             vertices.emplace_back(CircleProgram::vertex(point, -1,  1)); // 4
 
+            // The shared quad indices draw it as 1, 2, 3 and 1, 4, 3.
             auto& segment = segments.back();
-            assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
-            uint16_t index = segment.vertexLength;
-
-            // 1, 2, 3
-            // 1, 4, 3
-            triangles.emplace_back(index, index + 1, index + 2);
-            triangles.emplace_back(index, index + 3, index + 2);
-
             segment.vertexLength += vertexLength;
             segment.indexLength += 6;
         }
     }
 
+    const std::size_t end = instanced ? instances.vertexSize() : vertices.vertexSize();
+    addedFeature(index, end);
+    featureState.addFeature(feature, begin, end);
     for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+        pair.second.populateVertexVectors(feature, end);
+    }
+}
+
+bool CircleBucket::repaint(const Bucket& laidOut, const GeometryTileLayer& layer) {
+    repaintFeatures(paintPropertyBinders, laidOut, layer);
+    return true;
+}
+
+void CircleBucket::swapPaint(Bucket& painted, gl::Context& context) {
+    std::swap(paintPropertyBinders, static_cast<CircleBucket&>(painted).paintPropertyBinders);
+    if (uploaded) {
+        for (auto& pair : paintPropertyBinders) {
+            pair.second.upload(context);
+        }
+        releaseVertexArrays(segments);
+        releaseVertexArrays(instanceSegments);
     }
 }
 
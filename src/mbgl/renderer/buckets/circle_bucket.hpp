@@ -7,6 +7,7 @@
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/programs/segment.hpp>
 #include <mbgl/programs/circle_program.hpp>
+#include <mbgl/renderer/feature_state.hpp>
 #include <mbgl/style/layers/circle_layer_properties.hpp>
 
 namespace mbgl {
@@ -18,23 +19,42 @@ public:
     CircleBucket(const BucketParameters&, const std::vector<const RenderLayer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    bool repaint(const Bucket&, const GeometryTileLayer&) override;
     bool hasData() const override;
+    RendererStatistics::Memory memoryUsage() const override;
+    bool serialize(protozero::pbf_writer&) const override;
+    bool deserialize(protozero::pbf_reader&) override;
 
     void upload(gl::Context&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
+    // Each circle is a quad. The segments index into RenderStaticData::quadsIndexBuffer, so
+    // buckets don't have index buffers of their own.
     gl::VertexVector<CircleLayoutVertex> vertices;
-    gl::IndexVector<gl::Triangles> triangles;
     SegmentVector<CircleAttributes> segments;
 
     optional<gl::VertexBuffer<CircleLayoutVertex>> vertexBuffer;
-    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+    // Used instead of the above when the bucket is drawn instanced: one vertex per circle, drawn
+    // over the shared quad in RenderStaticData.
+    gl::VertexVector<CircleInstanceVertex> instances;
+    SegmentVector<CircleInstancedAttributes> instanceSegments;
+
+    optional<gl::VertexBuffer<CircleInstanceVertex>> instanceBuffer;
 
     std::map<std::string, CircleProgram::PaintPropertyBinders> paintPropertyBinders;
 
+    // Parallel to the vertices, or to the instances when instanced.
+    FeatureStateBuffer featureState;
+
     const MapMode mode;
+    const bool instanced;
+
+protected:
+    void swapPaint(Bucket&, gl::Context&) override;
 };
 
 } // namespace mbgl
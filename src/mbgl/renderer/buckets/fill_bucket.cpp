@@ -1,46 +1,44 @@
 #include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/renderer/buckets/bucket_serialization.hpp>
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/geometry/tessellation.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_layer.hpp>
 #include <mbgl/util/math.hpp>
 
-#include <mapbox/earcut.hpp>
-
 #include <cassert>
 
-namespace mapbox {
-namespace util {
-template <> struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
-};
-
-template <> struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
-};
-} // namespace util
-} // namespace mapbox
-
 namespace mbgl {
 
 using namespace style;
 
 struct GeometryTooLongException : std::exception {};
 
-FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<const RenderLayer*>& layers) {
+FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<const RenderLayer*>& layers)
+    : tessellationCache(parameters.tessellationCache),
+      sourceLayer(layers.empty() ? std::string() : layers.front()->baseImpl->sourceLayer) {
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(layer->getID()),
-            std::forward_as_tuple(
-                layer->as<RenderFillLayer>()->evaluated,
-                parameters.tileID.overscaledZ));
+        addBinders(paintPropertyBinders, layer->getID(), layer->as<RenderFillLayer>()->evaluated,
+                   parameters.tileID.overscaledZ);
     }
 }
 
 void FillBucket::addFeature(const GeometryTileFeature& feature,
-                            const GeometryCollection& geometry) {
-    for (auto& polygon : classifyRings(geometry)) {
+                            const GeometryCollection& geometry,
+                            std::size_t index) {
+    const std::size_t begin = vertices.vertexSize();
+    classifyRings(geometry, polygons);
+
+    const FeatureTessellation* cached = tessellationCache ? tessellationCache->get(sourceLayer, index) : nullptr;
+    if (cached && cached->size() != polygons.size()) {
+        cached = nullptr;
+    }
+    FeatureTessellation tessellation;
+
+    for (std::size_t p = 0; p < polygons.size(); p++) {
+        auto& polygon = polygons[p];
+
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
 
@@ -54,15 +52,24 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
 
         std::size_t startVertices = vertices.vertexSize();
 
+        SegmentBounds bounds;
+        bounds.extend(polygon.front());
+        const bool startsSegment = startsCulledSegment(triangleSegments, triangleSegmentBounds, bounds);
+        bool startsLineSegment = startsSegment;
+
         for (const auto& ring : polygon) {
             std::size_t nVertices = ring.size();
 
             if (nVertices == 0)
                 continue;
 
-            if (lineSegments.empty() || lineSegments.back().vertexLength + nVertices > std::numeric_limits<uint16_t>::max()) {
+            if (lineSegments.empty() || startsLineSegment ||
+                lineSegments.back().vertexLength + nVertices > std::numeric_limits<uint16_t>::max()) {
                 lineSegments.emplace_back(vertices.vertexSize(), lines.indexSize());
+                lineSegmentBounds.emplace_back();
+                startsLineSegment = false;
             }
+            lineSegmentBounds.back().extend(bounds);
 
             auto& lineSegment = lineSegments.back();
             assert(lineSegment.vertexLength <= std::numeric_limits<uint16_t>::max());
@@ -80,14 +87,20 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             lineSegment.indexLength += nVertices * 2;
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        if (!cached) {
+            tessellation.push_back(tessellate(polygon));
+        }
+        const std::vector<uint32_t>& indices = cached ? (*cached)[p] : tessellation.back();
 
         std::size_t nIndicies = indices.size();
         assert(nIndicies % 3 == 0);
 
-        if (triangleSegments.empty() || triangleSegments.back().vertexLength + totalVertices > std::numeric_limits<uint16_t>::max()) {
+        if (triangleSegments.empty() || startsSegment ||
+            triangleSegments.back().vertexLength + totalVertices > std::numeric_limits<uint16_t>::max()) {
             triangleSegments.emplace_back(startVertices, triangles.indexSize());
+            triangleSegmentBounds.emplace_back();
         }
+        triangleSegmentBounds.back().extend(bounds);
 
         auto& triangleSegment = triangleSegments.back();
         assert(triangleSegment.vertexLength <= std::numeric_limits<uint16_t>::max());
@@ -103,12 +116,38 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.indexLength += nIndicies;
     }
 
+    if (!cached && tessellationCache) {
+        tessellationCache->add(sourceLayer, index, std::move(tessellation));
+    }
+
+    addedFeature(index, vertices.vertexSize());
+    featureState.addFeature(feature, begin, vertices.vertexSize());
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
 }
 
+bool FillBucket::repaint(const Bucket& laidOut, const GeometryTileLayer& layer) {
+    repaintFeatures(paintPropertyBinders, laidOut, layer);
+    return true;
+}
+
+void FillBucket::swapPaint(Bucket& painted, gl::Context& context) {
+    std::swap(paintPropertyBinders, static_cast<FillBucket&>(painted).paintPropertyBinders);
+    if (uploaded) {
+        for (auto& pair : paintPropertyBinders) {
+            pair.second.upload(context);
+        }
+        releaseVertexArrays(lineSegments);
+        releaseVertexArrays(triangleSegments);
+    }
+}
+
 void FillBucket::upload(gl::Context& context) {
+    // No features are added once the bucket is uploaded.
+    polygons = {};
+    tessellationCache = nullptr;
+
     vertexBuffer = context.createVertexBuffer(std::move(vertices));
     lineIndexBuffer = context.createIndexBuffer(std::move(lines));
     triangleIndexBuffer = context.createIndexBuffer(std::move(triangles));
@@ -124,6 +163,63 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+RendererStatistics::Memory FillBucket::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = vertices.byteSize() + lines.byteSize() + triangles.byteSize();
+    memory.gpu = (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (lineIndexBuffer ? lineIndexBuffer->byteSize() : 0) +
+        (triangleIndexBuffer ? triangleIndexBuffer->byteSize() : 0);
+    memory += featureState.memoryUsage();
+    return memory;
+}
+
+bool FillBucket::serialize(protozero::pbf_writer& pbf) const {
+    if (uploaded || !hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    serializeFeatures(pbf, 1);
+    serializeVertices(pbf, 2, vertices);
+    serializeIndices(pbf, 3, lines);
+    serializeIndices(pbf, 4, triangles);
+    serializeSegments(pbf, 5, lineSegments);
+    serializeSegments(pbf, 6, triangleSegments);
+    featureState.serialize(pbf, 7);
+    return true;
+}
+
+bool FillBucket::deserialize(protozero::pbf_reader& pbf) {
+    if (!hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    while (pbf.next()) {
+        bool valid = true;
+        switch (pbf.tag()) {
+        case 1: valid = deserializeFeatures(pbf); break;
+        case 2: valid = deserializeVertices(pbf, vertices); break;
+        case 3: valid = deserializeIndices(pbf, lines); break;
+        case 4: valid = deserializeIndices(pbf, triangles); break;
+        case 5: valid = deserializeSegments(pbf, lineSegments); break;
+        case 6: valid = deserializeSegments(pbf, triangleSegments); break;
+        case 7: valid = featureState.deserialize(pbf); break;
+        default: pbf.skip(); break;
+        }
+        if (!valid) {
+            return false;
+        }
+    }
+    if (!validSegments(lineSegments, vertices.vertexSize(), lines) ||
+        !validSegments(triangleSegments, vertices.vertexSize(), triangles)) {
+        return false;
+    }
+
+    auto position = [] (const FillLayoutVertex& vertex) {
+        return GeometryCoordinate { vertex.a1[0], vertex.a1[1] };
+    };
+    lineSegmentBounds = computeSegmentBounds(lineSegments, vertices, position);
+    triangleSegmentBounds = computeSegmentBounds(triangleSegments, vertices, position);
+    return true;
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     if (!layer.is<RenderFillLayer>()) {
         return 0;
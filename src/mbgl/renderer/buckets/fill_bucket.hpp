@@ -5,7 +5,9 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/programs/segment.hpp>
+#include <mbgl/renderer/buckets/segment_bounds.hpp>
 #include <mbgl/programs/fill_program.hpp>
+#include <mbgl/renderer/feature_state.hpp>
 #include <mbgl/style/layers/fill_layer_properties.hpp>
 
 #include <vector>
@@ -13,14 +15,20 @@
 namespace mbgl {
 
 class BucketParameters;
+class TessellationCache;
 
 class FillBucket : public Bucket {
 public:
     FillBucket(const BucketParameters&, const std::vector<const RenderLayer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    bool repaint(const Bucket&, const GeometryTileLayer&) override;
     bool hasData() const override;
+    RendererStatistics::Memory memoryUsage() const override;
+    bool serialize(protozero::pbf_writer&) const override;
+    bool deserialize(protozero::pbf_reader&) override;
 
     void upload(gl::Context&) override;
 
@@ -32,11 +40,30 @@ public:
     SegmentVector<FillAttributes> lineSegments;
     SegmentVector<FillAttributes> triangleSegments;
 
+    // The box of the polygons of each segment, for culling segments that are off-screen.
+    std::vector<SegmentBounds> lineSegmentBounds;
+    std::vector<SegmentBounds> triangleSegmentBounds;
+
     optional<gl::VertexBuffer<FillLayoutVertex>> vertexBuffer;
     optional<gl::IndexBuffer<gl::Lines>> lineIndexBuffer;
     optional<gl::IndexBuffer<gl::Triangles>> triangleIndexBuffer;
 
     std::map<std::string, FillProgram::PaintPropertyBinders> paintPropertyBinders;
+
+    // Parallel to the vertices, for both the triangles and the lines.
+    FeatureStateBuffer featureState;
+
+protected:
+    void swapPaint(Bucket&, gl::Context&) override;
+
+private:
+    // Set while the bucket is laid out; triangulations are cached by the source layer of its layers.
+    TessellationCache* tessellationCache;
+    const std::string sourceLayer;
+
+    // Reused by addFeature(), so that only features with more or larger rings than the ones
+    // before them allocate for them.
+    std::vector<GeometryCollection> polygons;
 };
 
 } // namespace mbgl
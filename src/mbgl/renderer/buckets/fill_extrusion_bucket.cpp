@@ -1,32 +1,17 @@
 #include <mbgl/renderer/buckets/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/buckets/bucket_serialization.hpp>
 #include <mbgl/programs/fill_extrusion_program.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/geometry/tessellation.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_extrusion_layer.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/constants.hpp>
 
-#include <mapbox/earcut.hpp>
-
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-
-namespace mapbox {
-namespace util {
-template <>
-struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) {
-        return t.x;
-    };
-};
-
-template <>
-struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) {
-        return t.y;
-    };
-};
-} // namespace util
-} // namespace mapbox
+#include <limits>
 
 namespace mbgl {
 
@@ -34,19 +19,34 @@ using namespace style;
 
 struct GeometryTooLongException : std::exception {};
 
-FillExtrusionBucket::FillExtrusionBucket(const BucketParameters& parameters, const std::vector<const RenderLayer*>& layers) {
+static std::atomic<uint64_t> nextRevision { 0 };
+
+constexpr int16_t FillExtrusionBucket::smallBuildingSize;
+
+FillExtrusionBucket::FillExtrusionBucket(const BucketParameters& parameters, const std::vector<const RenderLayer*>& layers)
+    : tessellationCache(parameters.tessellationCache),
+      sourceLayer(layers.empty() ? std::string() : layers.front()->baseImpl->sourceLayer),
+      revision(++nextRevision) {
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(std::piecewise_construct,
-                                     std::forward_as_tuple(layer->getID()),
-                                     std::forward_as_tuple(
-                                                           layer->as<RenderFillExtrusionLayer>()->evaluated,
-                                                           parameters.tileID.overscaledZ));
+        addBinders(paintPropertyBinders, layer->getID(), layer->as<RenderFillExtrusionLayer>()->evaluated,
+                   parameters.tileID.overscaledZ);
     }
 }
 
 void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
-                                     const GeometryCollection& geometry) {
-    for (auto& polygon : classifyRings(geometry)) {
+                                     const GeometryCollection& geometry,
+                                     std::size_t index) {
+    classifyRings(geometry, polygons);
+
+    const FeatureTessellation* cached = tessellationCache ? tessellationCache->get(sourceLayer, index) : nullptr;
+    if (cached && cached->size() != polygons.size()) {
+        cached = nullptr;
+    }
+    FeatureTessellation tessellation;
+
+    for (std::size_t p = 0; p < polygons.size(); p++) {
+        auto& polygon = polygons[p];
+
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
 
@@ -58,9 +58,14 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
                 throw GeometryTooLongException();
         }
 
-        if (totalVertices == 0) continue;
+        if (totalVertices == 0) {
+            if (!cached) {
+                tessellation.emplace_back();
+            }
+            continue;
+        }
 
-        std::vector<uint32_t> flatIndices;
+        flatIndices.clear();
         flatIndices.reserve(totalVertices);
 
         std::size_t startVertices = vertices.vertexSize();
@@ -69,8 +74,20 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
             triangleSegments.back().vertexLength + (5 * (totalVertices - 1) + 1) >
                 std::numeric_limits<uint16_t>::max()) {
             triangleSegments.emplace_back(startVertices, triangles.indexSize());
+            wallSegments.emplace_back(startVertices, wallTriangles.indexSize());
+            smallWallSegments.emplace_back(startVertices, smallWallTriangles.indexSize());
+            segmentBounds.emplace_back();
         }
 
+        SegmentBounds footprint;
+        footprint.extend(polygon.front());
+        segmentBounds.back().extend(footprint);
+
+        const bool small = footprint.max.x - footprint.min.x < smallBuildingSize &&
+                           footprint.max.y - footprint.min.y < smallBuildingSize;
+        gl::IndexVector<gl::Triangles>& walls = small ? smallWallTriangles : wallTriangles;
+        auto& wallSegment = small ? smallWallSegments.back() : wallSegments.back();
+
         auto& triangleSegment = triangleSegments.back();
         assert(triangleSegment.vertexLength <= std::numeric_limits<uint16_t>::max());
         uint16_t triangleIndex = triangleSegment.vertexLength;
@@ -114,16 +131,19 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
                     vertices.emplace_back(
                         FillExtrusionProgram::layoutVertex(p2, perp.x, perp.y, 0, 1, edgeDistance));
 
-                    triangles.emplace_back(triangleIndex, triangleIndex + 1, triangleIndex + 2);
-                    triangles.emplace_back(triangleIndex + 1, triangleIndex + 2, triangleIndex + 3);
+                    walls.emplace_back(triangleIndex, triangleIndex + 1, triangleIndex + 2);
+                    walls.emplace_back(triangleIndex + 1, triangleIndex + 2, triangleIndex + 3);
                     triangleIndex += 4;
                     triangleSegment.vertexLength += 4;
-                    triangleSegment.indexLength += 6;
+                    wallSegment.indexLength += 6;
                 }
             }
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        if (!cached) {
+            tessellation.push_back(tessellate(polygon));
+        }
+        const std::vector<uint32_t>& indices = cached ? (*cached)[p] : tessellation.back();
 
         std::size_t nIndices = indices.size();
         assert(nIndices % 3 == 0);
@@ -135,16 +155,48 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
 
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndices;
+        wallSegments.back().vertexLength = triangleSegment.vertexLength;
+        smallWallSegments.back().vertexLength = triangleSegment.vertexLength;
     }
 
+    if (!cached && tessellationCache) {
+        tessellationCache->add(sourceLayer, index, std::move(tessellation));
+    }
+
+    addedFeature(index, vertices.vertexSize());
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
 }
 
+bool FillExtrusionBucket::repaint(const Bucket& laidOut, const GeometryTileLayer& layer) {
+    repaintFeatures(paintPropertyBinders, laidOut, layer);
+    return true;
+}
+
+void FillExtrusionBucket::swapPaint(Bucket& painted, gl::Context& context) {
+    std::swap(paintPropertyBinders, static_cast<FillExtrusionBucket&>(painted).paintPropertyBinders);
+    revision = ++nextRevision;
+    if (uploaded) {
+        for (auto& pair : paintPropertyBinders) {
+            pair.second.upload(context);
+        }
+        releaseVertexArrays(triangleSegments);
+        releaseVertexArrays(wallSegments);
+        releaseVertexArrays(smallWallSegments);
+    }
+}
+
 void FillExtrusionBucket::upload(gl::Context& context) {
+    // No features are added once the bucket is uploaded.
+    polygons = {};
+    flatIndices = {};
+    tessellationCache = nullptr;
+
     vertexBuffer = context.createVertexBuffer(std::move(vertices));
     indexBuffer = context.createIndexBuffer(std::move(triangles));
+    wallIndexBuffer = context.createIndexBuffer(std::move(wallTriangles));
+    smallWallIndexBuffer = context.createIndexBuffer(std::move(smallWallTriangles));
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
@@ -157,6 +209,66 @@ bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
 
+RendererStatistics::Memory FillExtrusionBucket::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = vertices.byteSize() + triangles.byteSize() + wallTriangles.byteSize() +
+        smallWallTriangles.byteSize();
+    memory.gpu = (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0) +
+        (wallIndexBuffer ? wallIndexBuffer->byteSize() : 0) +
+        (smallWallIndexBuffer ? smallWallIndexBuffer->byteSize() : 0);
+    return memory;
+}
+
+bool FillExtrusionBucket::serialize(protozero::pbf_writer& pbf) const {
+    if (uploaded || !hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    serializeFeatures(pbf, 1);
+    serializeVertices(pbf, 2, vertices);
+    serializeIndices(pbf, 3, triangles);
+    serializeSegments(pbf, 4, triangleSegments);
+    serializeIndices(pbf, 5, wallTriangles);
+    serializeSegments(pbf, 6, wallSegments);
+    serializeIndices(pbf, 7, smallWallTriangles);
+    serializeSegments(pbf, 8, smallWallSegments);
+    return true;
+}
+
+bool FillExtrusionBucket::deserialize(protozero::pbf_reader& pbf) {
+    if (!hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    while (pbf.next()) {
+        bool valid = true;
+        switch (pbf.tag()) {
+        case 1: valid = deserializeFeatures(pbf); break;
+        case 2: valid = deserializeVertices(pbf, vertices); break;
+        case 3: valid = deserializeIndices(pbf, triangles); break;
+        case 4: valid = deserializeSegments(pbf, triangleSegments); break;
+        case 5: valid = deserializeIndices(pbf, wallTriangles); break;
+        case 6: valid = deserializeSegments(pbf, wallSegments); break;
+        case 7: valid = deserializeIndices(pbf, smallWallTriangles); break;
+        case 8: valid = deserializeSegments(pbf, smallWallSegments); break;
+        default: pbf.skip(); break;
+        }
+        if (!valid) {
+            return false;
+        }
+    }
+    if (wallSegments.size() != triangleSegments.size() || smallWallSegments.size() != triangleSegments.size() ||
+        !validSegments(triangleSegments, vertices.vertexSize(), triangles) ||
+        !validSegments(wallSegments, vertices.vertexSize(), wallTriangles) ||
+        !validSegments(smallWallSegments, vertices.vertexSize(), smallWallTriangles)) {
+        return false;
+    }
+
+    segmentBounds = computeSegmentBounds(triangleSegments, vertices, [] (const FillExtrusionLayoutVertex& vertex) {
+        return GeometryCoordinate { vertex.a1[0], vertex.a1[1] };
+    });
+    return true;
+}
+
 float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
     if (!layer.is<RenderFillExtrusionLayer>()) {
         return 0;
@@ -5,33 +5,79 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/programs/segment.hpp>
+#include <mbgl/renderer/buckets/segment_bounds.hpp>
 #include <mbgl/programs/fill_extrusion_program.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer_properties.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <vector>
 
 namespace mbgl {
 
 class BucketParameters;
+class TessellationCache;
 
 class FillExtrusionBucket : public Bucket {
 public:
     FillExtrusionBucket(const BucketParameters&, const std::vector<const RenderLayer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    bool repaint(const Bucket&, const GeometryTileLayer&) override;
     bool hasData() const override;
+    RendererStatistics::Memory memoryUsage() const override;
+    bool serialize(protozero::pbf_writer&) const override;
+    bool deserialize(protozero::pbf_reader&) override;
 
     void upload(gl::Context&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
+    // Buildings whose footprint is smaller than this, in tile units, on both axes, are small:
+    // their walls are kept apart so that they can be left out where they'd be tiny on screen.
+    static constexpr int16_t smallBuildingSize = util::EXTENT / 128;
+
+    // Roofs, the walls of buildings, and those of small buildings are drawn with separate indices
+    // but the same vertices, in segments that go together: the n-th segment of each of the three
+    // covers the vertices of the n-th segment of the others.
     gl::VertexVector<FillExtrusionLayoutVertex> vertices;
     gl::IndexVector<gl::Triangles> triangles;
+    gl::IndexVector<gl::Triangles> wallTriangles;
+    gl::IndexVector<gl::Triangles> smallWallTriangles;
     SegmentVector<FillExtrusionAttributes> triangleSegments;
+    SegmentVector<FillExtrusionAttributes> wallSegments;
+    SegmentVector<FillExtrusionAttributes> smallWallSegments;
+
+    // The footprint of the buildings of each segment, for culling segments that are off-screen.
+    std::vector<SegmentBounds> segmentBounds;
 
     optional<gl::VertexBuffer<FillExtrusionLayoutVertex>> vertexBuffer;
     optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> wallIndexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> smallWallIndexBuffer;
+
+    // Unique to the bucket and its paint attributes: it changes when the bucket is repainted.
+    uint64_t getRevision() const {
+        return revision;
+    }
     
     std::unordered_map<std::string, FillExtrusionProgram::PaintPropertyBinders> paintPropertyBinders;
+
+protected:
+    void swapPaint(Bucket&, gl::Context&) override;
+
+private:
+    // Set while the bucket is laid out; triangulations are cached by the source layer of its layers.
+    TessellationCache* tessellationCache;
+    const std::string sourceLayer;
+
+    // Reused by addFeature(), so that only features with more or larger rings than the ones
+    // before them allocate for them.
+    std::vector<GeometryCollection> polygons;
+    std::vector<uint32_t> flatIndices;
+
+    uint64_t revision;
 };
 
 } // namespace mbgl
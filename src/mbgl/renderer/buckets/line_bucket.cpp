@@ -1,4 +1,5 @@
 #include <mbgl/renderer/buckets/line_bucket.hpp>
+#include <mbgl/renderer/buckets/bucket_serialization.hpp>
 #include <mbgl/renderer/layers/render_line_layer.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/line_layer_impl.hpp>
@@ -18,26 +19,39 @@ LineBucket::LineBucket(const BucketParameters& parameters,
       overscaling(parameters.tileID.overscaleFactor()),
       zoom(parameters.tileID.overscaledZ) {
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(layer->getID()),
-            std::forward_as_tuple(
-                layer->as<RenderLineLayer>()->evaluated,
-                parameters.tileID.overscaledZ));
+        addBinders(paintPropertyBinders, layer->getID(), layer->as<RenderLineLayer>()->evaluated,
+                   parameters.tileID.overscaledZ);
     }
 }
 
 void LineBucket::addFeature(const GeometryTileFeature& feature,
-                            const GeometryCollection& geometryCollection) {
+                            const GeometryCollection& geometryCollection,
+                            std::size_t index) {
     for (auto& line : geometryCollection) {
         addGeometry(line, feature);
     }
 
+    addedFeature(index, vertices.vertexSize());
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
 }
 
+bool LineBucket::repaint(const Bucket& laidOut, const GeometryTileLayer& layer) {
+    repaintFeatures(paintPropertyBinders, laidOut, layer);
+    return true;
+}
+
+void LineBucket::swapPaint(Bucket& painted, gl::Context& context) {
+    std::swap(paintPropertyBinders, static_cast<LineBucket&>(painted).paintPropertyBinders);
+    if (uploaded) {
+        for (auto& pair : paintPropertyBinders) {
+            pair.second.upload(context);
+        }
+        releaseVertexArrays(segments);
+    }
+}
+
 /*
  * Sharp corners cause dashed lines to tilt because the distance along the line
  * is the same at both the inner and outer corners. To improve the appearance of
@@ -91,6 +105,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, const Geome
     const LineJoinType joinType = layout.evaluate<LineJoin>(zoom, feature);
 
     const float miterLimit = joinType == LineJoinType::Bevel ? 1.05f : float(layout.get<LineMiterLimit>());
+    const float roundLimit = layout.get<LineRoundLimit>();
 
     const double sharpCornerOffset = SHARP_CORNER_OFFSET * (float(util::EXTENT) / (util::tileSize * overscaling));
 
@@ -114,8 +129,19 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, const Geome
         nextNormal = util::perp(util::unit(convertPoint<double>(firstCoordinate - *currentCoordinate)));
     }
 
+    // The normals of the segments from each vertex to the next one, in a single pass over the
+    // line. Repeated vertices are skipped below and don't have one.
+    segmentNormals.resize(len - first);
+    for (std::size_t i = first; i < len; ++i) {
+        const std::size_t next = type == FeatureType::Polygon && i == len - 1 ? first + 1 : i + 1;
+        if (next < len && coordinates[next] != coordinates[i]) {
+            segmentNormals[i - first] = util::perp(util::unit(convertPoint<double>(coordinates[next] - coordinates[i])));
+        }
+    }
+
     const std::size_t startVertex = vertices.vertexSize();
-    std::vector<TriangleElement> triangleStore;
+    std::vector<TriangleElement>& triangleStore = triangleScratch;
+    triangleStore.clear();
 
     for (std::size_t i = first; i < len; ++i) {
         if (type == FeatureType::Polygon && i == len - 1) {
@@ -146,8 +172,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, const Geome
         // Calculate the normal towards the next vertex in this line. In case
         // there is no next vertex, pretend that the line is continuing straight,
         // meaning that we are just using the previous normal.
-        nextNormal = nextCoordinate ? util::perp(util::unit(convertPoint<double>(*nextCoordinate - *currentCoordinate)))
-                                : prevNormal;
+        nextNormal = nextCoordinate ? segmentNormals[i - first] : prevNormal;
 
         // If we still don't have a previous normal, this is the beginning of a
         // non-closed line, so we're doing a straight "join".
@@ -202,7 +227,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, const Geome
 
         if (middleVertex) {
             if (currentJoin == LineJoinType::Round) {
-                if (miterLength < layout.get<LineRoundLimit>()) {
+                if (miterLength < roundLimit) {
                     currentJoin = LineJoinType::Miter;
                 } else if (miterLength <= 2) {
                     currentJoin = LineJoinType::FakeRound;
@@ -374,9 +399,17 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, const Geome
     const std::size_t endVertex = vertices.vertexSize();
     const std::size_t vertexCount = endVertex - startVertex;
 
-    if (segments.empty() || segments.back().vertexLength + vertexCount > std::numeric_limits<uint16_t>::max()) {
+    SegmentBounds bounds;
+    for (std::size_t i = first; i < len; ++i) {
+        bounds.extend(coordinates[i]);
+    }
+
+    if (segments.empty() || startsCulledSegment(segments, segmentBounds, bounds) ||
+        segments.back().vertexLength + vertexCount > std::numeric_limits<uint16_t>::max()) {
         segments.emplace_back(startVertex, triangles.indexSize());
+        segmentBounds.emplace_back();
     }
+    segmentBounds.back().extend(bounds);
 
     auto& segment = segments.back();
     assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
@@ -465,6 +498,53 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+RendererStatistics::Memory LineBucket::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = vertices.byteSize() + triangles.byteSize();
+    memory.gpu = (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0);
+    return memory;
+}
+
+bool LineBucket::serialize(protozero::pbf_writer& pbf) const {
+    if (uploaded || !hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    serializeFeatures(pbf, 1);
+    serializeVertices(pbf, 2, vertices);
+    serializeIndices(pbf, 3, triangles);
+    serializeSegments(pbf, 4, segments);
+    return true;
+}
+
+bool LineBucket::deserialize(protozero::pbf_reader& pbf) {
+    if (!hasConstantPaint(paintPropertyBinders)) {
+        return false;
+    }
+    while (pbf.next()) {
+        bool valid = true;
+        switch (pbf.tag()) {
+        case 1: valid = deserializeFeatures(pbf); break;
+        case 2: valid = deserializeVertices(pbf, vertices); break;
+        case 3: valid = deserializeIndices(pbf, triangles); break;
+        case 4: valid = deserializeSegments(pbf, segments); break;
+        default: pbf.skip(); break;
+        }
+        if (!valid) {
+            return false;
+        }
+    }
+    if (!validSegments(segments, vertices.vertexSize(), triangles)) {
+        return false;
+    }
+
+    // Positions are stored doubled, along with the texture coordinates in the lowest bit.
+    segmentBounds = computeSegmentBounds(segments, vertices, [] (const LineLayoutVertex& vertex) {
+        return GeometryCoordinate { int16_t(vertex.a1[0] >> 1), int16_t(vertex.a1[1] >> 1) };
+    });
+    return true;
+}
+
 template <class Property>
 static float get(const RenderLineLayer& layer, const std::map<std::string, LineProgram::PaintPropertyBinders>& paintPropertyBinders) {
     auto it = paintPropertyBinders.find(layer.getID());
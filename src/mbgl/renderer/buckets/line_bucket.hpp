@@ -5,6 +5,7 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/programs/segment.hpp>
+#include <mbgl/renderer/buckets/segment_bounds.hpp>
 #include <mbgl/programs/line_program.hpp>
 #include <mbgl/style/layers/line_layer_properties.hpp>
 
@@ -22,8 +23,13 @@ public:
                const style::LineLayoutProperties::Unevaluated&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    bool repaint(const Bucket&, const GeometryTileLayer&) override;
     bool hasData() const override;
+    RendererStatistics::Memory memoryUsage() const override;
+    bool serialize(protozero::pbf_writer&) const override;
+    bool deserialize(protozero::pbf_reader&) override;
 
     void upload(gl::Context&) override;
 
@@ -35,11 +41,17 @@ public:
     gl::IndexVector<gl::Triangles> triangles;
     SegmentVector<LineAttributes> segments;
 
+    // The box of the lines of each segment, for culling segments that are off-screen.
+    std::vector<SegmentBounds> segmentBounds;
+
     optional<gl::VertexBuffer<LineLayoutVertex>> vertexBuffer;
     optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
 
     std::map<std::string, LineProgram::PaintPropertyBinders> paintPropertyBinders;
 
+protected:
+    void swapPaint(Bucket&, gl::Context&) override;
+
 private:
     void addGeometry(const GeometryCoordinates&, const GeometryTileFeature&);
 
@@ -58,6 +70,10 @@ private:
     std::ptrdiff_t e2;
     std::ptrdiff_t e3;
 
+    // Reused by addGeometry() for every line.
+    std::vector<Point<double>> segmentNormals;
+    std::vector<TriangleElement> triangleScratch;
+
     const uint32_t overscaling;
     const float zoom;
 
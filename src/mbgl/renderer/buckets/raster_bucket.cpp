@@ -2,12 +2,15 @@
 #include <mbgl/renderer/layers/render_raster_layer.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/math.hpp>
 
 namespace mbgl {
 
 using namespace style;
 
-RasterBucket::RasterBucket(PremultipliedImage&& image_) {
+RasterBucket::RasterBucket(PremultipliedImage&& image_)
+    : tile(true) {
     image = std::make_shared<PremultipliedImage>(std::move(image_));
 }
 
@@ -15,13 +18,47 @@ RasterBucket::RasterBucket(std::shared_ptr<PremultipliedImage> image_): image(im
 
 }
 
+RasterBucket::RasterBucket(CompressedImage&& image_)
+    : compressedImage(std::make_shared<const CompressedImage>(std::move(image_))) {
+}
+
+RasterBucket::RasterBucket(DEMData&& dem_)
+    : dem(std::make_unique<DEMData>(std::move(dem_))) {
+}
+
 void RasterBucket::upload(gl::Context& context) {
     if (!hasData()) {
         return;
     }
-    if (!texture) {
+    if (dem) {
+        if (!texture) {
+            texture = context.createTexture(dem->getSlopes());
+        } else if (!uploaded) {
+            // The border changed since the texture was created.
+            context.updateTexture(*texture, dem->getSlopes());
+        }
+    } else if (!texture && compressedImage) {
+        if (!context.supportsCompressedTextureFormat(compressedImage->format)) {
+            Log::Warning(Event::OpenGL, "Raster tile in unsupported compressed texture format 0x%x",
+                         static_cast<uint32_t>(compressedImage->format));
+            compressedImage.reset();
+            uploaded = true;
+            return;
+        }
+        texture = context.createTexture(*compressedImage);
+    } else if (!texture && tile) {
+        texture = context.createTileTexture(*image, true);
+        mipmapped = util::isPowerOfTwo(image->size.width) && util::isPowerOfTwo(image->size.height);
+    } else if (!frames.empty()) {
+        for (std::size_t i = frameTextures.size(); i < frames.size(); i++) {
+            frameTextures.push_back(context.createTexture(*frames[i]));
+        }
+    } else if (!texture) {
         texture = context.createTexture(*image);
+    } else if (textureOutdated) {
+        context.updateTextureSubImage(*texture, *image, { 0, 0 });
     }
+    textureOutdated = false;
     if (!segments.empty()) {
         vertexBuffer = context.createVertexBuffer(std::move(vertices));
         indexBuffer = context.createIndexBuffer(std::move(indices));
@@ -41,70 +78,79 @@ void RasterBucket::clear() {
 
 void RasterBucket::setImage(std::shared_ptr<PremultipliedImage> image_) {
     image = std::move(image_);
-    texture = {};
+    if (texture && !tile && !compressedImage && texture->size == image->size) {
+        textureOutdated = true;
+    } else {
+        texture = {};
+    }
     uploaded = false;
 }
 
-void RasterBucket::setMask(TileMask&& mask_) {
-    if (mask == mask_) {
+void RasterBucket::setFrames(const std::vector<std::shared_ptr<PremultipliedImage>>& frames_) {
+    if (frames == frames_) {
         return;
     }
 
-    mask = std::move(mask_);
-    clear();
-
-    if (mask == TileMask{ { 0, 0, 0 } }) {
-        // We want to render the full tile, and keeping the segments/vertices/indices empty means
-        // using the global shared buffers for covering the entire tile.
-        return;
+    // Textures are kept up to the first frame that changed.
+    std::size_t kept = 0;
+    while (kept < frameTextures.size() && kept < frames_.size() && frames[kept] == frames_[kept]) {
+        kept++;
     }
+    frameTextures.erase(frameTextures.begin() + kept, frameTextures.end());
 
-    // Create a new segment so that we will upload (empty) buffers even when there is nothing to
-    // draw for this tile.
-    segments.emplace_back(0, 0);
-
-    constexpr const uint16_t vertexLength = 4;
-
-    // Create the vertex buffer for the specified tile mask.
-    for (const auto& id : mask) {
-        // Create a quad for every masked tile.
-        const int32_t vertexExtent = util::EXTENT >> id.z;
+    frames = frames_;
+    frame = 0;
+    image = frames.empty() ? image : frames.front();
+    uploaded = false;
+}
 
-        const Point<int16_t> tlVertex = { static_cast<int16_t>(id.x * vertexExtent),
-                                          static_cast<int16_t>(id.y * vertexExtent) };
-        const Point<int16_t> brVertex = { static_cast<int16_t>(tlVertex.x + vertexExtent),
-                                          static_cast<int16_t>(tlVertex.y + vertexExtent) };
+gl::Texture& RasterBucket::getTexture() {
+    if (!frames.empty()) {
+        assert(frame < frameTextures.size());
+        return frameTextures[frame];
+    }
+    assert(texture);
+    return *texture;
+}
 
-        if (segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
-            // Move to a new segments because the old one can't hold the geometry.
-            segments.emplace_back(vertices.vertexSize(), indices.indexSize());
-        }
+void RasterBucket::backfillBorder(const RasterBucket& neighbor, int8_t dx, int8_t dy) {
+    if (dem && neighbor.dem) {
+        dem->backfillBorder(*neighbor.dem, dx, dy);
+        uploaded = false;
+    }
+}
 
-        vertices.emplace_back(
-            RasterProgram::layoutVertex({ tlVertex.x, tlVertex.y }, { static_cast<uint16_t>(tlVertex.x), static_cast<uint16_t>(tlVertex.y) }));
-        vertices.emplace_back(
-            RasterProgram::layoutVertex({ brVertex.x, tlVertex.y }, { static_cast<uint16_t>(brVertex.x), static_cast<uint16_t>(tlVertex.y) }));
-        vertices.emplace_back(
-            RasterProgram::layoutVertex({ tlVertex.x, brVertex.y }, { static_cast<uint16_t>(tlVertex.x), static_cast<uint16_t>(brVertex.y) }));
-        vertices.emplace_back(
-            RasterProgram::layoutVertex({ brVertex.x, brVertex.y }, { static_cast<uint16_t>(brVertex.x), static_cast<uint16_t>(brVertex.y) }));
-
-        auto& segment = segments.back();
-        assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
-        const uint16_t offset = segment.vertexLength;
-
-        // 0, 1, 2
-        // 1, 2, 3
-        indices.emplace_back(offset, offset + 1, offset + 2);
-        indices.emplace_back(offset + 1, offset + 2, offset + 3);
-
-        segment.vertexLength += vertexLength;
-        segment.indexLength += 6;
+void RasterBucket::setMask(TileMask&& mask_) {
+    if (mask == mask_) {
+        return;
     }
+
+    mask = std::move(mask_);
+    maskGeometry.reset();
 }
 
 bool RasterBucket::hasData() const {
-    return !!image;
+    return image || compressedImage || dem;
+}
+
+RendererStatistics::Memory RasterBucket::memoryUsage() const {
+    const std::size_t textureBytes = !texture ? 0
+        : compressedImage ? compressedImage->bytes()
+        : texture->size.width * texture->size.height * (mipmapped ? 16 : 12) / 3;
+    std::size_t frameBytes = 0;
+    for (const auto& frameTexture : frameTextures) {
+        frameBytes += frameTexture.size.width * frameTexture.size.height * 4;
+    }
+
+    RendererStatistics::Memory memory;
+    memory.cpu = (image ? image->bytes() : 0) +
+        (compressedImage ? compressedImage->bytes() : 0) +
+        (dem ? dem->byteSize() : 0) +
+        vertices.byteSize() + indices.byteSize();
+    memory.gpu = textureBytes + frameBytes +
+        (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0);
+    return memory;
 }
 
 } // namespace mbgl
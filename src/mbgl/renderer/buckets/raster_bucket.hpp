@@ -1,12 +1,14 @@
 #pragma once
 
+#include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/renderer/bucket.hpp>
-#include <mbgl/renderer/tile_mask.hpp>
+#include <mbgl/renderer/tile_mask_cache.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/compressed_image.hpp>
 #include <mbgl/util/mat4.hpp>
 #include <mbgl/util/optional.hpp>
 
@@ -16,17 +18,50 @@ class RasterBucket : public Bucket {
 public:
     RasterBucket(PremultipliedImage&&);
     RasterBucket(std::shared_ptr<PremultipliedImage>);
+    RasterBucket(CompressedImage&&);
+    RasterBucket(DEMData&&);
 
     void upload(gl::Context&) override;
     bool hasData() const override;
+    RendererStatistics::Memory memoryUsage() const override;
 
     void clear();
+    // Keeps the texture if the image has the same size, and only replaces its contents on upload.
     void setImage(std::shared_ptr<PremultipliedImage>);
+    // Sets the frames of an animated image source. Unchanged frames keep their textures.
+    void setFrames(const std::vector<std::shared_ptr<PremultipliedImage>>&);
+    // The texture of the frame that is shown, or of the image.
+    gl::Texture& getTexture();
     void setMask(TileMask&&);
+    // Fills in the border of `dem` shared with the bucket of the tile at `dx`, `dy` from this one.
+    void backfillBorder(const RasterBucket&, int8_t dx, int8_t dy);
 
     std::shared_ptr<PremultipliedImage> image;
+    // Set instead of `image` for tiles in a compressed texture format. If the context doesn't
+    // support the format, it's dropped on upload and the bucket has no data.
+    std::shared_ptr<const CompressedImage> compressedImage;
+    // Set instead of `image` for tiles of raster-dem sources, whose texture holds the slopes of
+    // the terrain.
+    std::unique_ptr<DEMData> dem;
     optional<gl::Texture> texture;
+
+    // Frames of an animated image source, drawn one at a time. Each gets its own texture on
+    // upload, so that switching frames is only a matter of binding another one.
+    std::vector<std::shared_ptr<PremultipliedImage>> frames;
+    std::vector<gl::Texture> frameTextures;
+    std::size_t frame = 0;
+
+    // Raster tiles are drawn at fractional zoom levels and pitched, so their textures get
+    // mipmaps where possible. They're taken from the context's tile texture pool.
+    bool tile = false;
+    // Whether the texture has mipmaps.
+    bool mipmapped = false;
+    // Whether `texture` still holds a previous image of the same size.
+    bool textureOutdated = false;
     TileMask mask{ { 0, 0, 0 } };
+    // The geometry of `mask`, shared with the tiles drawn with the same mask. Left empty for the
+    // full tile, and set by the source after the mask changes.
+    std::shared_ptr<TileMaskGeometry> maskGeometry;
 
     // Bucket specific vertices are used for Image Sources only
     // Raster Tile Sources use the default buffers from Painter
@@ -0,0 +1,36 @@
+#include <mbgl/renderer/buckets/segment_bounds.hpp>
+#include <mbgl/util/mat4.hpp>
+
+namespace mbgl {
+
+bool segmentVisible(const mat4& clipMatrix, const SegmentBounds& bounds, double padding, double height) {
+    bool left = true, right = true, below = true, above = true;
+    for (double x : { bounds.min.x - padding, bounds.max.x + padding }) {
+        for (double y : { bounds.min.y - padding, bounds.max.y + padding }) {
+            for (double z : { 0.0, height }) {
+                vec4 corner;
+                matrix::transformMat4(corner, {{ x, y, z, 1 }}, clipMatrix);
+                if (corner[3] <= 0) {
+                    return true;
+                }
+                left = left && corner[0] < -corner[3];
+                right = right && corner[0] > corner[3];
+                below = below && corner[1] < -corner[3];
+                above = above && corner[1] > corner[3];
+            }
+        }
+    }
+    return !(left || right || below || above);
+}
+
+std::vector<bool> visibleSegments(const mat4& clipMatrix, const std::vector<SegmentBounds>& bounds,
+                                  double padding, double height) {
+    std::vector<bool> result;
+    result.reserve(bounds.size());
+    for (const auto& segment : bounds) {
+        result.push_back(segmentVisible(clipMatrix, segment, padding, height));
+    }
+    return result;
+}
+
+} // namespace mbgl
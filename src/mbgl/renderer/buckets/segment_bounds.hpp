@@ -0,0 +1,87 @@
+#pragma once
+
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/programs/segment.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace mbgl {
+
+// The box around the geometry of a segment of a bucket, in tile units, for culling segments that
+// are off-screen.
+struct SegmentBounds {
+    GeometryCoordinate min { std::numeric_limits<int16_t>::max(), std::numeric_limits<int16_t>::max() };
+    GeometryCoordinate max { std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::min() };
+
+    void extend(const GeometryCoordinate& point) {
+        min = { std::min(min.x, point.x), std::min(min.y, point.y) };
+        max = { std::max(max.x, point.x), std::max(max.y, point.y) };
+    }
+
+    void extend(const GeometryCoordinates& points) {
+        for (const auto& point : points) {
+            extend(point);
+        }
+    }
+
+    void extend(const SegmentBounds& other) {
+        min = { std::min(min.x, other.min.x), std::min(min.y, other.min.y) };
+        max = { std::max(max.x, other.max.x), std::max(max.y, other.max.y) };
+    }
+
+    // Whether the box would still be at most `size` tile units wide and high if it was extended
+    // by `other`.
+    bool fits(const SegmentBounds& other, int32_t size) const {
+        return std::max<int32_t>(max.x, other.max.x) - std::min<int32_t>(min.x, other.min.x) <= size &&
+               std::max<int32_t>(max.y, other.max.y) - std::min<int32_t>(min.y, other.min.y) <= size;
+    }
+};
+
+// Buckets add their features to the last segment, in order, until it has this many vertices.
+// From then on, a feature that would make the segment's box larger than a quarter of the tile on
+// either side starts a new segment, so that the parts of a tile that are off-screen can be culled
+// without changing the order features are drawn in.
+constexpr std::size_t segmentCullingVertices = 4096;
+constexpr int32_t segmentCullingSize = util::EXTENT / 4;
+
+template <class Attributes>
+bool startsCulledSegment(const SegmentVector<Attributes>& segments,
+                         const std::vector<SegmentBounds>& bounds,
+                         const SegmentBounds& feature) {
+    return !segments.empty() && segments.back().vertexLength >= segmentCullingVertices &&
+           !bounds.back().fits(feature, segmentCullingSize);
+}
+
+// The bounds of segments read back by Bucket::deserialize(), from their vertices.
+template <class Attributes, class Vertex, class Position>
+std::vector<SegmentBounds> computeSegmentBounds(const SegmentVector<Attributes>& segments,
+                                                const gl::VertexVector<Vertex>& vertices,
+                                                Position position) {
+    std::vector<SegmentBounds> result;
+    result.reserve(segments.size());
+    for (const auto& segment : segments) {
+        SegmentBounds bounds;
+        for (std::size_t i = segment.vertexOffset; i < segment.vertexOffset + segment.vertexLength; i++) {
+            bounds.extend(position(vertices.data()[i]));
+        }
+        result.push_back(bounds);
+    }
+    return result;
+}
+
+// Returns false if the box, grown by `padding` tile units on every side and raised to `height`,
+// is entirely on the outer side of one of the planes of the clip space left, right, below or
+// above the view. Boxes reaching behind the camera are always visible.
+bool segmentVisible(const mat4& clipMatrix, const SegmentBounds&, double padding, double height = 0);
+
+// The flags for Program::draw() to draw only the segments that are visible.
+std::vector<bool> visibleSegments(const mat4& clipMatrix, const std::vector<SegmentBounds>&,
+                                  double padding, double height = 0);
+
+} // namespace mbgl
@@ -3,6 +3,7 @@
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/util/constants.hpp>
 
 namespace mbgl {
 
@@ -60,10 +61,69 @@ void SymbolBucket::upload(gl::Context& context) {
     uploaded = true;
 }
 
+void SymbolBucket::setHidden(const Label& label, bool hidden) {
+    auto update = [&] (PlacedSymbol& symbol) {
+        if (symbol.hidden != hidden) {
+            symbol.hidden = hidden;
+            dynamicVerticesOutdated = true;
+        }
+    };
+
+    if (label.textSymbol) {
+        update(text.placedSymbols[*label.textSymbol]);
+    }
+    if (label.iconSymbol) {
+        update(icon.placedSymbols[*label.iconSymbol]);
+    }
+}
+
+bool SymbolBucket::isPlaced(const Label& label) const {
+    return (label.textSymbol && text.placedSymbols[*label.textSymbol].placementZoom < util::MAX_ZOOM_F) ||
+        (label.iconSymbol && icon.placedSymbols[*label.iconSymbol].placementZoom < util::MAX_ZOOM_F);
+}
+
+void SymbolBucket::applyPlacement(const SymbolPlacementZooms& placement) {
+    assert(placement.text.size() == text.placedSymbols.size());
+    assert(placement.icon.size() == icon.placedSymbols.size());
+
+    for (std::size_t i = 0; i < text.placedSymbols.size(); ++i) {
+        text.placedSymbols[i].placementZoom = placement.text[i];
+    }
+    for (std::size_t i = 0; i < icon.placedSymbols.size(); ++i) {
+        icon.placedSymbols[i].placementZoom = placement.icon[i];
+    }
+
+    // Which labels duplicate which others may change with their placement.
+    dynamicVerticesOutdated = true;
+    crossTileIndexed = false;
+}
+
 bool SymbolBucket::hasData() const {
     return hasTextData() || hasIconData() || hasCollisionBoxData();
 }
 
+std::size_t SymbolBucket::getVertexCount() const {
+    return text.vertices.vertexSize() + icon.vertices.vertexSize();
+}
+
+RendererStatistics::Memory SymbolBucket::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = text.vertices.byteSize() + text.dynamicVertices.byteSize() + text.triangles.byteSize() +
+        icon.vertices.byteSize() + icon.dynamicVertices.byteSize() + icon.triangles.byteSize() +
+        icon.atlasImage.bytes() +
+        collisionBox.vertices.byteSize() + collisionBox.lines.byteSize();
+    memory.gpu = (text.vertexBuffer ? text.vertexBuffer->byteSize() : 0) +
+        (text.dynamicVertexBuffer ? text.dynamicVertexBuffer->byteSize() : 0) +
+        (text.indexBuffer ? text.indexBuffer->byteSize() : 0) +
+        (icon.vertexBuffer ? icon.vertexBuffer->byteSize() : 0) +
+        (icon.dynamicVertexBuffer ? icon.dynamicVertexBuffer->byteSize() : 0) +
+        (icon.indexBuffer ? icon.indexBuffer->byteSize() : 0) +
+        (collisionBox.vertexBuffer ? collisionBox.vertexBuffer->byteSize() : 0) +
+        (collisionBox.dynamicVertexBuffer ? collisionBox.dynamicVertexBuffer->byteSize() : 0) +
+        (collisionBox.indexBuffer ? collisionBox.indexBuffer->byteSize() : 0);
+    return memory;
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.segments.empty();
 }
@@ -10,6 +10,7 @@
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/layout/symbol_projection.hpp>
 
 #include <vector>
 
@@ -30,6 +31,14 @@ public:
     bool useVerticalMode;
     GeometryCoordinates line;
     std::vector<float> glyphOffsets;
+    // Set for symbols that a neighbouring tile shows already; see CrossTileSymbolIndex.
+    bool hidden = false;
+};
+
+// The placement zooms of the text and icon symbols of a bucket, in the order of its placedSymbols.
+struct SymbolPlacementZooms {
+    std::vector<float> text;
+    std::vector<float> icon;
 };
 
 class SymbolBucket : public Bucket {
@@ -44,10 +53,30 @@ public:
 
     void upload(gl::Context&) override;
     bool hasData() const override;
+    RendererStatistics::Memory memoryUsage() const override;
+    std::size_t getVertexCount() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
 
+    // A label of a line-placed layer, as matched against the labels of neighbouring tiles by the
+    // CrossTileSymbolIndex. The symbols are indices into text.placedSymbols and icon.placedSymbols.
+    struct Label {
+        std::u16string text;
+        Point<float> anchor;
+        optional<std::size_t> textSymbol;
+        optional<std::size_t> iconSymbol;
+    };
+
+    void setHidden(const Label&, bool hidden);
+
+    // Whether the label is shown at any zoom level, disregarding labels hidden in favour of those
+    // of neighbouring tiles.
+    bool isPlaced(const Label&) const;
+
+    // Replaces the placement zooms of all symbols, without changing their glyphs.
+    void applyPlacement(const SymbolPlacementZooms&);
+
     const style::SymbolLayoutProperties::PossiblyEvaluated layout;
     const bool sdfIcons;
     const bool iconsNeedLinear;
@@ -68,6 +97,9 @@ public:
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::VertexBuffer<SymbolDynamicLayoutAttributes::Vertex>> dynamicVertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+        // The camera the dynamic vertex buffer was last written for, for labels along lines.
+        optional<LineLabelCamera> projectedCamera;
     } text;
     
     std::unique_ptr<SymbolSizeBinder> iconSizeBinder;
@@ -83,6 +115,9 @@ public:
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::VertexBuffer<SymbolDynamicLayoutAttributes::Vertex>> dynamicVertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+        // The camera the dynamic vertex buffer was last written for, for icons along lines.
+        optional<LineLabelCamera> projectedCamera;
     } icon;
 
     struct CollisionBoxBuffer {
@@ -94,6 +129,17 @@ public:
         optional<gl::VertexBuffer<SymbolDynamicLayoutAttributes::Vertex>> dynamicVertexBuffer;
         optional<gl::IndexBuffer<gl::Lines>> indexBuffer;
     } collisionBox;
+
+    std::vector<Label> labels;
+
+    // Labels of the same text closer than this, in tile units, duplicate each other.
+    float labelRepeatDistance = 0;
+
+    // Whether the CrossTileSymbolIndex has matched the labels of this bucket.
+    bool crossTileIndexed = false;
+
+    // Set when symbols were hidden or shown since the dynamic vertex buffers were last written.
+    bool dynamicVerticesOutdated = false;
 };
 
 } // namespace mbgl
@@ -0,0 +1,152 @@
+#include <mbgl/renderer/cross_tile_symbol_index.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <cmath>
+#include <unordered_set>
+
+namespace mbgl {
+
+bool CrossTileSymbolIndex::update(const std::vector<RenderSymbolLayer*>& renderLayers, TimePoint deadline) {
+    bool complete = true;
+
+    // Layers with the same layout share their buckets; those are matched for the first of them.
+    std::unordered_set<const SymbolBucket*> seen;
+    std::map<std::string, Layer> updated;
+
+    for (RenderSymbolLayer* renderLayer : renderLayers) {
+        Layer& layer = updated[renderLayer->getID()];
+        auto it = layers.find(renderLayer->getID());
+        if (it != layers.end()) {
+            layer = std::move(it->second);
+        }
+
+        for (auto& entry : layer) {
+            entry.second.used = false;
+        }
+
+        std::vector<std::pair<UnwrappedTileID, SymbolBucket*>> pending;
+
+        for (const RenderTile& tile : renderLayer->getRenderTiles()) {
+            auto bucket = static_cast<SymbolBucket*>(tile.tile.getBucket(*renderLayer->baseImpl));
+            if (!bucket || !seen.insert(bucket).second) {
+                continue;
+            }
+
+            auto entry = layer.find(tile.id);
+            if (entry != layer.end() && entry->second.bucket == bucket && bucket->crossTileIndexed) {
+                entry->second.used = true;
+            } else if (!bucket->labels.empty()) {
+                pending.emplace_back(tile.id, bucket);
+            }
+        }
+
+        // Forget the buckets that were replaced or aren't rendered any more. Their neighbours may
+        // have hidden labels in favour of theirs.
+        std::vector<UnwrappedTileID> removed;
+        for (auto entry = layer.begin(); entry != layer.end();) {
+            if (entry->second.used) {
+                ++entry;
+            } else {
+                removed.push_back(entry->first);
+                entry = layer.erase(entry);
+            }
+        }
+        for (const auto& id : removed) {
+            requeueNeighbours(layer, id, pending);
+        }
+
+        for (const auto& bucket : pending) {
+            if (Clock::now() >= deadline) {
+                complete = false;
+                break;
+            }
+            index(layer, bucket.first, *bucket.second);
+        }
+    }
+
+    layers = std::move(updated);
+    return complete;
+}
+
+void CrossTileSymbolIndex::requeueNeighbours(Layer& layer, const UnwrappedTileID& id,
+                                             std::vector<std::pair<UnwrappedTileID, SymbolBucket*>>& pending) {
+    const uint8_t z = id.canonical.z;
+    const int64_t x = int64_t(id.wrap) * (1ll << z) + id.canonical.x;
+    const int64_t y = id.canonical.y;
+
+    for (int64_t dy = -1; dy <= 1; ++dy) {
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            if ((dx == 0 && dy == 0) || y + dy < 0 || y + dy >= (1ll << z)) {
+                continue;
+            }
+            auto neighbour = layer.find(UnwrappedTileID(z, x + dx, y + dy));
+            if (neighbour != layer.end() && neighbour->second.used) {
+                neighbour->second.bucket->crossTileIndexed = false;
+                pending.emplace_back(neighbour->first, neighbour->second.bucket);
+                layer.erase(neighbour);
+            }
+        }
+    }
+}
+
+void CrossTileSymbolIndex::index(Layer& layer, const UnwrappedTileID& id, SymbolBucket& bucket) {
+    const uint8_t z = id.canonical.z;
+    const int64_t x = int64_t(id.wrap) * (1ll << z) + id.canonical.x;
+    const int64_t y = id.canonical.y;
+
+    std::vector<const IndexedBucket*> neighbours;
+    for (int64_t dy = -1; dy <= 1; ++dy) {
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            if ((dx == 0 && dy == 0) || y + dy < 0 || y + dy >= (1ll << z)) {
+                continue;
+            }
+            auto neighbour = layer.find(UnwrappedTileID(z, x + dx, y + dy));
+            if (neighbour != layer.end()) {
+                neighbours.push_back(&neighbour->second);
+            }
+        }
+    }
+
+    const double originX = double(x) * util::EXTENT;
+    const double originY = double(y) * util::EXTENT;
+    const double distance = bucket.labelRepeatDistance;
+
+    IndexedBucket indexed { &bucket, {}, true };
+    indexed.labels.reserve(bucket.labels.size());
+
+    for (const auto& label : bucket.labels) {
+        const bool placed = bucket.isPlaced(label);
+        IndexedLabel indexedLabel { &label.text, originX + label.anchor.x, originY + label.anchor.y, placed };
+
+        // Only labels this close to the edge of the tile can duplicate those of a neighbour.
+        const bool nearEdge = label.anchor.x < distance || label.anchor.y < distance ||
+            label.anchor.x > util::EXTENT - distance || label.anchor.y > util::EXTENT - distance;
+
+        if (placed && nearEdge) {
+            for (const IndexedBucket* neighbour : neighbours) {
+                for (const auto& other : neighbour->labels) {
+                    if (other.shown && *other.text == label.text &&
+                        std::hypot(other.x - indexedLabel.x, other.y - indexedLabel.y) < distance) {
+                        indexedLabel.shown = false;
+                        break;
+                    }
+                }
+                if (!indexedLabel.shown) {
+                    break;
+                }
+            }
+        }
+
+        bucket.setHidden(label, placed && !indexedLabel.shown);
+        indexed.labels.push_back(indexedLabel);
+    }
+
+    bucket.crossTileIndexed = true;
+    layer.emplace(id, std::move(indexed));
+}
+
+} // namespace mbgl
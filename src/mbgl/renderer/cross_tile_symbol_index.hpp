@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class RenderSymbolLayer;
+class SymbolBucket;
+
+/*
+   Hides the labels of line-placed symbol layers that a neighbouring tile at the same zoom level
+   already shows close by. Every tile places the labels of its part of a line by itself, so a line
+   crossing a tile boundary is otherwise labelled on both sides of it.
+
+   Buckets are matched on the render thread, the first frame they're rendered in, against the
+   buckets of the neighbouring tiles matched before them. Buckets that don't fit into a frame's
+   time budget are matched in the following frames. When a tile goes away, its neighbours are
+   matched again, so that the labels they hid for it reappear.
+*/
+class CrossTileSymbolIndex {
+public:
+    // Returns whether all buckets of the layers are matched; if not, the rest are matched by the
+    // next calls.
+    bool update(const std::vector<RenderSymbolLayer*>&, TimePoint deadline);
+
+private:
+    struct IndexedLabel {
+        const std::u16string* text;
+        // In tile units from the top left of the world at the tile's zoom level.
+        double x;
+        double y;
+        bool shown;
+    };
+
+    struct IndexedBucket {
+        SymbolBucket* bucket;
+        std::vector<IndexedLabel> labels;
+        bool used;
+    };
+
+    using Layer = std::map<UnwrappedTileID, IndexedBucket>;
+
+    void index(Layer&, const UnwrappedTileID&, SymbolBucket&);
+    void requeueNeighbours(Layer&, const UnwrappedTileID&, std::vector<std::pair<UnwrappedTileID, SymbolBucket*>>& pending);
+
+    std::map<std::string, Layer> layers;
+};
+
+} // namespace mbgl
@@ -0,0 +1,215 @@
+#include <mbgl/renderer/feature_state.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+bool FeatureStateStore::set(const std::string& sourceID, const std::string& sourceLayer,
+                            const FeatureIdentifier& id, float state) {
+    FeatureStates& layer = layers[{ sourceID, sourceLayer }];
+    if (state == 0) {
+        if (!layer.states.erase(id)) {
+            return false;
+        }
+    } else {
+        auto it = layer.states.find(id);
+        if (it != layer.states.end() && it->second == state) {
+            return false;
+        }
+        layer.states[id] = state;
+    }
+    layer.revision = ++revision;
+    return true;
+}
+
+float FeatureStateStore::get(const std::string& sourceID, const std::string& sourceLayer,
+                             const FeatureIdentifier& id) const {
+    const FeatureStates* layer = find(sourceID, sourceLayer);
+    if (!layer) {
+        return 0;
+    }
+    auto it = layer->states.find(id);
+    return it == layer->states.end() ? 0 : it->second;
+}
+
+const FeatureStates* FeatureStateStore::find(const std::string& sourceID, const std::string& sourceLayer) const {
+    auto it = layers.find({ sourceID, sourceLayer });
+    return it == layers.end() ? nullptr : &it->second;
+}
+
+namespace {
+
+struct CompareID {
+    template <class Feature>
+    bool operator()(const Feature& feature, const FeatureIdentifier& id) const {
+        return feature.id < id;
+    }
+    template <class Feature>
+    bool operator()(const FeatureIdentifier& id, const Feature& feature) const {
+        return id < feature.id;
+    }
+};
+
+uint8_t encodeState(float state) {
+    return static_cast<uint8_t>(std::round(util::clamp(state, 0.0f, 1.0f) * 255));
+}
+
+} // namespace
+
+void FeatureStateBuffer::addFeature(const GeometryTileFeature& feature, std::size_t begin, std::size_t end) {
+    if (begin == end) {
+        return;
+    }
+    optional<FeatureIdentifier> id = feature.getID();
+    if (id) {
+        features.push_back({ std::move(*id), uint32_t(begin), uint32_t(end) });
+    }
+}
+
+void FeatureStateBuffer::update(gl::Context& context, const FeatureStates* states, std::size_t vertexCount) {
+    const uint64_t statesRevision = states ? states->revision : 0;
+    if (statesRevision == revision || features.empty()) {
+        return;
+    }
+    revision = statesRevision;
+
+    if (!sorted) {
+        std::stable_sort(features.begin(), features.end(), [] (const Feature& a, const Feature& b) {
+            return a.id < b.id;
+        });
+        sorted = true;
+    }
+
+    // The features that have state now, with their encoded state.
+    std::vector<std::pair<std::size_t, uint8_t>> values;
+    if (states) {
+        for (const auto& state : states->states) {
+            const uint8_t value = encodeState(state.second);
+            if (value == 0) {
+                continue;
+            }
+            const auto range = std::equal_range(features.begin(), features.end(), state.first, CompareID());
+            for (auto it = range.first; it != range.second; ++it) {
+                values.emplace_back(it - features.begin(), value);
+            }
+        }
+    }
+    std::sort(values.begin(), values.end());
+
+    if (!buffer && values.empty()) {
+        return;
+    }
+    if (!buffer) {
+        vertices.resize(vertexCount, FeatureStateVertex { {{ 0 }} });
+    }
+
+    std::vector<std::size_t> changed;
+    auto assign = [&] (std::size_t index, uint8_t value) {
+        const Feature& feature = features[index];
+        if (feature.end > vertices.size() || vertices[feature.begin].a1[0] == value) {
+            return;
+        }
+        std::fill(vertices.begin() + feature.begin, vertices.begin() + feature.end,
+                  FeatureStateVertex { {{ value }} });
+        changed.push_back(index);
+    };
+
+    for (std::size_t index : active) {
+        const auto it = std::lower_bound(values.begin(), values.end(), std::make_pair(index, uint8_t(0)));
+        if (it == values.end() || it->first != index) {
+            assign(index, 0);
+        }
+    }
+    active.clear();
+    for (const auto& value : values) {
+        assign(value.first, value.second);
+        active.push_back(value.first);
+    }
+
+    if (!buffer) {
+        gl::VertexVector<FeatureStateVertex> initial;
+        initial.assign(reinterpret_cast<const char*>(vertices.data()), vertices.size());
+        buffer = context.createVertexBuffer(std::move(initial));
+        return;
+    }
+
+    for (std::size_t index : changed) {
+        const Feature& feature = features[index];
+        context.updateVertexBufferRange(*buffer, feature.begin, vertices.data() + feature.begin,
+                                        feature.end - feature.begin);
+    }
+}
+
+FeatureStateAttributes::Bindings FeatureStateBuffer::attributeBindings() const {
+    return buffer ? FeatureStateAttributes::bindings(*buffer) : FeatureStateAttributes::Bindings();
+}
+
+RendererStatistics::Memory FeatureStateBuffer::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = features.size() * sizeof(Feature) + vertices.size() * sizeof(FeatureStateVertex);
+    memory.gpu = buffer ? buffer->byteSize() : 0;
+    return memory;
+}
+
+void FeatureStateBuffer::serialize(protozero::pbf_writer& pbf, uint32_t tag) const {
+    std::vector<uint64_t> ids;
+    std::vector<uint32_t> ranges;
+    ids.reserve(features.size());
+    ranges.reserve(features.size() * 2);
+    for (const auto& feature : features) {
+        if (!feature.id.is<uint64_t>()) {
+            return;
+        }
+        ids.push_back(feature.id.get<uint64_t>());
+        ranges.push_back(feature.begin);
+        ranges.push_back(feature.end);
+    }
+    if (ids.empty()) {
+        return;
+    }
+    protozero::pbf_writer message(pbf, tag);
+    message.add_packed_uint64(1, ids.begin(), ids.end());
+    message.add_packed_uint32(2, ranges.begin(), ranges.end());
+}
+
+bool FeatureStateBuffer::deserialize(protozero::pbf_reader& pbf) {
+    protozero::pbf_reader message = pbf.get_message();
+    std::vector<uint64_t> ids;
+    std::vector<uint32_t> ranges;
+    while (message.next()) {
+        switch (message.tag()) {
+        case 1: {
+            const auto range = message.get_packed_uint64();
+            ids.assign(range.begin(), range.end());
+            break;
+        }
+        case 2: {
+            const auto range = message.get_packed_uint32();
+            ranges.assign(range.begin(), range.end());
+            break;
+        }
+        default:
+            message.skip();
+            break;
+        }
+    }
+    if (ranges.size() != ids.size() * 2) {
+        return false;
+    }
+    features.clear();
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        if (ranges[i * 2] >= ranges[i * 2 + 1]) {
+            return false;
+        }
+        features.push_back({ FeatureIdentifier(ids[i]), ranges[i * 2], ranges[i * 2 + 1] });
+    }
+    return true;
+}
+
+} // namespace mbgl
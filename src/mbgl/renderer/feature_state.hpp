@@ -0,0 +1,99 @@
+#pragma once
+
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace protozero {
+class pbf_reader;
+class pbf_writer;
+} // namespace protozero
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+// The states of the features of one source layer, by feature id, from 0 to 1. Features without
+// state have none.
+class FeatureStates {
+public:
+    std::map<FeatureIdentifier, float> states;
+
+    // Changes whenever the states do, to a value no other FeatureStates of the store had before.
+    uint64_t revision = 0;
+};
+
+// The feature states set through Renderer::setFeatureState(), by source and source layer.
+class FeatureStateStore {
+public:
+    // Sets the state of a feature; zero removes it. Returns whether the state changed.
+    bool set(const std::string& sourceID, const std::string& sourceLayer, const FeatureIdentifier&, float state);
+    float get(const std::string& sourceID, const std::string& sourceLayer, const FeatureIdentifier&) const;
+
+    // The states of a source layer, or nullptr if no feature of it ever had one.
+    const FeatureStates* find(const std::string& sourceID, const std::string& sourceLayer) const;
+
+private:
+    std::map<std::pair<std::string, std::string>, FeatureStates> layers;
+    uint64_t revision = 0;
+};
+
+using FeatureStateAttributes = gl::Attributes<attributes::a_state>;
+using FeatureStateVertex = FeatureStateAttributes::Vertex;
+
+// The feature state of each vertex of a bucket, in a buffer separate from its layout and paint
+// attributes. When states change, only the vertices of the features whose state changed are
+// uploaded again, rather than the tile being laid out again. Buckets none of whose features ever
+// had state have no buffer, and draw as if every state was zero.
+class FeatureStateBuffer {
+public:
+    // Called by the bucket's addFeature() with the vertices the feature added, [begin, end).
+    // Features without an id can't have state.
+    void addFeature(const GeometryTileFeature&, std::size_t begin, std::size_t end);
+
+    // Brings the buffer up to date with `states`, which is null if the source layer has none, on
+    // the render thread. `vertexCount` is the number of vertices of the bucket.
+    void update(gl::Context&, const FeatureStates*, std::size_t vertexCount);
+
+    // The bindings of the state attributes for Program::draw(), which are disabled if there's no
+    // buffer, so that the shaders read zero.
+    FeatureStateAttributes::Bindings attributeBindings() const;
+
+    RendererStatistics::Memory memoryUsage() const;
+
+    // Writes the ranges of features within a nested message, if all of them have integer ids.
+    void serialize(protozero::pbf_writer&, uint32_t tag) const;
+    bool deserialize(protozero::pbf_reader&);
+
+private:
+    struct Feature {
+        FeatureIdentifier id;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // Sorted by id on the first update, so that updates look up the features with state rather
+    // than going through all of them.
+    std::vector<Feature> features;
+    bool sorted = false;
+
+    // The features whose vertices have a non-zero state.
+    std::vector<std::size_t> active;
+
+    std::vector<FeatureStateVertex> vertices;
+    optional<gl::VertexBuffer<FeatureStateVertex>> buffer;
+    uint64_t revision = 0;
+};
+
+} // namespace mbgl
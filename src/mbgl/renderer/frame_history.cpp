@@ -36,6 +36,7 @@ void FrameHistory::record(const TimePoint& now, float zoom, const Duration& dura
         }
     }
 
+    settled = true;
     for (int16_t z = 0; z <= 255; z++) {
         const std::chrono::duration<float> timeDiff = now - changeTimes[z];
         const int32_t opacityChange = (duration == Milliseconds(0) ? 1 : (timeDiff / duration)) * 255;
@@ -46,6 +47,9 @@ void FrameHistory::record(const TimePoint& now, float zoom, const Duration& dura
             opacities.data[z] = opacity;
             dirty = true;
         }
+        if (opacity != (z <= zoomIndex ? 255 : 0)) {
+            settled = false;
+        }
     }
 
     if (zoomIndex != previousZoomIndex) {
@@ -60,6 +64,10 @@ bool FrameHistory::needsAnimation(const Duration& duration) const {
     return (time - previousTime) < duration;
 }
 
+bool FrameHistory::isSettled() const {
+    return settled;
+}
+
 void FrameHistory::upload(gl::Context& context, uint32_t unit) {
     if (!texture) {
         texture = context.createTexture(opacities, unit);
@@ -20,6 +20,10 @@ public:
     void record(const TimePoint&, float zoom, const Duration&);
 
     bool needsAnimation(const Duration&) const;
+
+    // Returns true if the recorded frame shows every opacity at its final value. Fades settle
+    // before the duration has passed when they start out partially faded.
+    bool isSettled() const;
     void bind(gl::Context&, uint32_t);
     void upload(gl::Context&, uint32_t);
     bool isVisible(const float zoom) const;
@@ -34,6 +38,8 @@ private:
     TimePoint time;
     bool firstFrame = true;
     bool dirty = true;
+    // Whether every opacity had reached its final value in the recorded frame.
+    bool settled = false;
 
     mbgl::optional<gl::Texture> texture;
 };
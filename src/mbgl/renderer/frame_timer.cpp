@@ -0,0 +1,86 @@
+#include <mbgl/renderer/frame_timer.hpp>
+#include <mbgl/gl/context.hpp>
+
+#include <cstdio>
+
+namespace mbgl {
+
+FrameTimer::Scope::Scope(FrameTimer& timer_, const char* name, const gl::Context& context_)
+    : timer(timer_),
+      context(context_),
+      index(timer.phases.size()),
+      start(Clock::now()),
+      drawCalls(context.drawCalls),
+      uploadedBytes(context.uploadedBytes) {
+    timer.phases.push_back({ name, Duration::zero(), 0, 0, 0, nullptr, {}, Duration::zero() });
+}
+
+FrameTimer::Scope::~Scope() {
+    Phase& phase = timer.phases[index];
+    phase.time = Clock::now() - start;
+    // The draw call counter is reset at the start of each frame.
+    phase.drawCalls = context.drawCalls >= drawCalls ? context.drawCalls - drawCalls : context.drawCalls;
+    phase.uploadedBytes = context.uploadedBytes - uploadedBytes;
+}
+
+void FrameTimer::Scope::setCount(std::size_t count, const char* format) {
+    Phase& phase = timer.phases[index];
+    phase.count = count;
+    phase.countFormat = format;
+}
+
+void FrameTimer::Scope::addItem(const std::string& name, Duration time) {
+    Phase& phase = timer.phases[index];
+    if (time > phase.slowestItemTime) {
+        phase.slowestItem = name;
+        phase.slowestItemTime = time;
+    }
+}
+
+void FrameTimer::beginFrame() {
+    frameStart = Clock::now();
+    phases.clear();
+}
+
+optional<FrameTimings> FrameTimer::endFrame(Duration budget) {
+    const Duration total = Clock::now() - frameStart;
+    if (budget == Duration::zero() || total <= budget) {
+        return {};
+    }
+
+    FrameTimings timings;
+    timings.total = total;
+    timings.budget = budget;
+    for (const auto& phase : phases) {
+        timings.phases.push_back({ phase.name, phase.time, describe(phase) });
+    }
+    return timings;
+}
+
+std::string FrameTimer::describe(const Phase& phase) {
+    std::string result;
+    char buffer[256];
+
+    if (phase.countFormat && phase.count) {
+        std::snprintf(buffer, sizeof(buffer), phase.countFormat, phase.count);
+        result += buffer;
+    }
+    if (phase.uploadedBytes) {
+        std::snprintf(buffer, sizeof(buffer), "%s%.1f MB", result.empty() ? "uploaded " : ", ",
+                      phase.uploadedBytes / (1024.0 * 1024.0));
+        result += buffer;
+    }
+    if (phase.drawCalls) {
+        std::snprintf(buffer, sizeof(buffer), "%s%zu draw calls", result.empty() ? "" : ", ", phase.drawCalls);
+        result += buffer;
+    }
+    if (!phase.slowestItem.empty()) {
+        std::snprintf(buffer, sizeof(buffer), "%sslowest %s (%.1f ms)", result.empty() ? "" : ", ",
+                      phase.slowestItem.c_str(),
+                      std::chrono::duration<double, std::milli>(phase.slowestItemTime).count());
+        result += buffer;
+    }
+    return result;
+}
+
+} // namespace mbgl
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mbgl/renderer/frame_timings.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+// Measures the CPU time of the phases of a frame, along with the draw calls they issued and the
+// data they uploaded. Timing is cheap enough to stay on; what each phase did is only described
+// for frames that turn out to be slow.
+class FrameTimer : private util::noncopyable {
+public:
+    // Times the phase that runs during its lifetime.
+    class Scope : private util::noncopyable {
+    public:
+        Scope(FrameTimer&, const char* name, const gl::Context&);
+        ~Scope();
+
+        // Says what the phase worked through, e.g. `setCount(14, "uploaded %zu tiles")`.
+        void setCount(std::size_t count, const char* format);
+
+        // Keeps track of the most expensive of the items the phase worked through.
+        void addItem(const std::string& name, Duration);
+
+    private:
+        FrameTimer& timer;
+        const gl::Context& context;
+        const std::size_t index;
+        const TimePoint start;
+        const std::size_t drawCalls;
+        const uint64_t uploadedBytes;
+    };
+
+    void beginFrame();
+
+    // Returns the timings of the frame if it took longer than `budget`.
+    optional<FrameTimings> endFrame(Duration budget);
+
+private:
+    struct Phase {
+        const char* name;
+        Duration time;
+        std::size_t drawCalls;
+        uint64_t uploadedBytes;
+        std::size_t count;
+        const char* countFormat;
+        std::string slowestItem;
+        Duration slowestItemTime;
+    };
+
+    static std::string describe(const Phase&);
+
+    TimePoint frameStart;
+    std::vector<Phase> phases;
+};
+
+} // namespace mbgl
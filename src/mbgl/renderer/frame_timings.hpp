@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// CPU time a frame took on the render thread, broken down by the phases of rendering it.
+class FrameTimings {
+public:
+    class Phase {
+    public:
+        std::string name;
+        Duration time = Duration::zero();
+
+        // What the phase did, e.g. "uploaded 14 tiles, 6.2 MB".
+        std::string details;
+    };
+
+    Duration total = Duration::zero();
+
+    // The budget the frame exceeded.
+    Duration budget = Duration::zero();
+
+    // In the order they ran.
+    std::vector<Phase> phases;
+
+    const Phase& slowest() const {
+        assert(!phases.empty());
+        return *std::max_element(phases.begin(), phases.end(), [] (const Phase& a, const Phase& b) {
+            return a.time < b.time;
+        });
+    }
+};
+
+} // namespace mbgl
@@ -0,0 +1,141 @@
+#include <mbgl/renderer/gpu_timer.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/timer_query_extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <cassert>
+#include <unordered_map>
+
+namespace mbgl {
+
+namespace {
+
+// Queries are allocated in batches of this size.
+const std::size_t queryBatchSize = 64;
+
+// Frames whose results haven't arrived after this many frames are dropped.
+const std::size_t maxPendingFrames = 8;
+
+} // namespace
+
+GPUTimer::GPUTimer(gl::Context& context)
+    : extension(*context.getTimerQueryExtension()) {
+}
+
+GPUTimer::~GPUTimer() {
+    std::vector<GLuint> ids(queries.begin(), queries.end());
+    if (!ids.empty()) {
+        MBGL_CHECK_ERROR(extension.deleteQueries(ids.size(), ids.data()));
+    }
+}
+
+void GPUTimer::beginFrame() {
+    recycle(currentFrame);
+    currentFrame.clear();
+}
+
+void GPUTimer::endFrame() {
+    if (currentFrame.empty()) {
+        return;
+    }
+
+    pendingFrames.push_back(std::move(currentFrame));
+    currentFrame.clear();
+
+    if (pendingFrames.size() > maxPendingFrames) {
+        recycle(pendingFrames.front());
+        pendingFrames.pop_front();
+    }
+}
+
+optional<GPUTimings> GPUTimer::collect() {
+    if (extension.reportsDisjoint) {
+        GLint disjoint = GL_FALSE;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+        if (disjoint) {
+            for (const auto& frame : pendingFrames) {
+                recycle(frame);
+            }
+            pendingFrames.clear();
+            return {};
+        }
+    }
+
+    if (pendingFrames.empty()) {
+        return {};
+    }
+
+    const Frame& frame = pendingFrames.front();
+    for (const auto& section : frame) {
+        if (!isAvailable(section.begin) || !isAvailable(section.end)) {
+            return {};
+        }
+    }
+
+    GPUTimings timings;
+    std::unordered_map<std::string, std::size_t> layerIndices;
+
+    for (const auto& section : frame) {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        MBGL_CHECK_ERROR(extension.getQueryObjectui64v(section.begin, GL_QUERY_RESULT_EXT, &begin));
+        MBGL_CHECK_ERROR(extension.getQueryObjectui64v(section.end, GL_QUERY_RESULT_EXT, &end));
+        const Duration duration = std::chrono::duration_cast<Duration>(
+            std::chrono::nanoseconds(end > begin ? end - begin : 0));
+
+        if (section.kind == Kind::Pass) {
+            timings.passes.emplace_back(section.name, duration);
+        } else {
+            auto it = layerIndices.emplace(section.name, timings.layers.size()).first;
+            if (it->second == timings.layers.size()) {
+                timings.layers.emplace_back(section.name, duration);
+            } else {
+                timings.layers[it->second].second += duration;
+            }
+        }
+    }
+
+    recycle(frame);
+    pendingFrames.pop_front();
+
+    return timings;
+}
+
+std::size_t GPUTimer::begin(Kind kind, const std::string& name) {
+    currentFrame.push_back({ kind, name, timestamp(), 0 });
+    return currentFrame.size() - 1;
+}
+
+void GPUTimer::end(std::size_t index) {
+    assert(index < currentFrame.size());
+    currentFrame[index].end = timestamp();
+}
+
+uint32_t GPUTimer::timestamp() {
+    if (freeQueries.empty()) {
+        GLuint ids[queryBatchSize];
+        MBGL_CHECK_ERROR(extension.genQueries(queryBatchSize, ids));
+        queries.insert(queries.end(), ids, ids + queryBatchSize);
+        freeQueries.insert(freeQueries.end(), ids, ids + queryBatchSize);
+    }
+
+    const uint32_t query = freeQueries.back();
+    freeQueries.pop_back();
+    MBGL_CHECK_ERROR(extension.queryCounter(query, GL_TIMESTAMP_EXT));
+    return query;
+}
+
+bool GPUTimer::isAvailable(uint32_t query) const {
+    GLint available = GL_FALSE;
+    MBGL_CHECK_ERROR(extension.getQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available));
+    return available;
+}
+
+void GPUTimer::recycle(const Frame& frame) {
+    for (const auto& section : frame) {
+        freeQueries.push_back(section.begin);
+        freeQueries.push_back(section.end);
+    }
+}
+
+} // namespace mbgl
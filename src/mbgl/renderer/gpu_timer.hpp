@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mbgl/renderer/gpu_timings.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+namespace extension {
+class TimerQuery;
+} // namespace extension
+} // namespace gl
+
+// Measures the GPU time taken by the passes and layers of a frame with timestamp queries.
+// Results are only read back once the GPU has made them available, typically a few frames
+// later, so timing a frame never stalls the pipeline.
+class GPUTimer : private util::noncopyable {
+public:
+    enum class Kind : bool {
+        Pass,
+        Layer,
+    };
+
+    // Times the GPU commands issued during its lifetime, if there is a timer.
+    class Scope : private util::noncopyable {
+    public:
+        Scope(GPUTimer* timer_, Kind kind, const std::string& name)
+            : timer(timer_), index(timer ? timer->begin(kind, name) : 0) {
+        }
+
+        ~Scope() {
+            if (timer) {
+                timer->end(index);
+            }
+        }
+
+    private:
+        GPUTimer* const timer;
+        const std::size_t index;
+    };
+
+    // The context must support timer queries; see gl::Context::getTimerQueryExtension().
+    GPUTimer(gl::Context&);
+    ~GPUTimer();
+
+    void beginFrame();
+    void endFrame();
+
+    // Returns the timings of the oldest frame whose results are available, if any.
+    optional<GPUTimings> collect();
+
+private:
+    struct Section {
+        Kind kind;
+        std::string name;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    using Frame = std::vector<Section>;
+
+    std::size_t begin(Kind, const std::string&);
+    void end(std::size_t);
+
+    uint32_t timestamp();
+    bool isAvailable(uint32_t query) const;
+    void recycle(const Frame&);
+
+    gl::extension::TimerQuery& extension;
+
+    std::vector<uint32_t> queries;
+    std::vector<uint32_t> freeQueries;
+
+    Frame currentFrame;
+    std::deque<Frame> pendingFrames;
+};
+
+} // namespace mbgl
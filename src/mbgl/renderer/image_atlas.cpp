@@ -1,7 +1,5 @@
 #include <mbgl/renderer/image_atlas.hpp>
 
-#include <mapbox/shelf-pack.hpp>
-
 namespace mbgl {
 
 static constexpr uint32_t padding = 1;
@@ -16,45 +14,4 @@ ImagePosition::ImagePosition(const mapbox::Bin& bin, const style::Image::Impl& i
       ) {
 }
 
-ImageAtlas makeImageAtlas(const ImageMap& images) {
-    ImageAtlas result;
-
-    mapbox::ShelfPack::ShelfPackOptions options;
-    options.autoResize = true;
-    mapbox::ShelfPack pack(0, 0, options);
-
-    for (const auto& entry : images) {
-        const style::Image::Impl& image = *entry.second;
-
-        const mapbox::Bin& bin = *pack.packOne(-1,
-            image.image.size.width + 2 * padding,
-            image.image.size.height + 2 * padding);
-
-        result.image.resize({
-            static_cast<uint32_t>(pack.width()),
-            static_cast<uint32_t>(pack.height())
-        });
-
-        PremultipliedImage::copy(image.image,
-                                 result.image,
-                                 { 0, 0 },
-                                 {
-                                    bin.x + padding,
-                                    bin.y + padding
-                                 },
-                                 image.image.size);
-
-        result.positions.emplace(image.id,
-                                 ImagePosition { bin, image });
-    }
-
-    pack.shrink();
-    result.image.resize({
-        static_cast<uint32_t>(pack.width()),
-        static_cast<uint32_t>(pack.height())
-    });
-
-    return result;
-}
-
 } // namespace mbgl
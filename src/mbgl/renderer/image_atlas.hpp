@@ -40,12 +40,4 @@ public:
 
 using ImagePositions = std::map<std::string, ImagePosition>;
 
-class ImageAtlas {
-public:
-    PremultipliedImage image;
-    ImagePositions positions;
-};
-
-ImageAtlas makeImageAtlas(const ImageMap&);
-
 } // namespace mbgl
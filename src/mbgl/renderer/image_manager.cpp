@@ -1,9 +1,16 @@
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/gl/context.hpp>
 
 namespace mbgl {
 
+static ImageManagerObserver nullObserver;
+
+void ImageManager::setObserver(ImageManagerObserver* observer_) {
+    observer = observer_ ? observer_ : &nullObserver;
+}
+
 void ImageManager::setLoaded(bool loaded_) {
     if (loaded == loaded_) {
         return;
@@ -12,10 +19,7 @@ void ImageManager::setLoaded(bool loaded_) {
     loaded = loaded_;
 
     if (loaded) {
-        for (const auto& entry : requestors) {
-            notify(*entry.first, entry.second);
-        }
-        requestors.clear();
+        notifyRequestors();
     }
 }
 
@@ -23,25 +27,77 @@ bool ImageManager::isLoaded() const {
     return loaded;
 }
 
+void ImageManager::setImagesOnDemand(bool imagesOnDemand_) {
+    if (imagesOnDemand == imagesOnDemand_) {
+        return;
+    }
+
+    imagesOnDemand = imagesOnDemand_;
+
+    if (imagesOnDemand) {
+        notifyRequestors();
+    }
+}
+
+void ImageManager::notifyRequestors() {
+    for (const auto& entry : requestors) {
+        notify(*entry.first, entry.second);
+    }
+    requestors.clear();
+}
+
 void ImageManager::addImage(Immutable<style::Image::Impl> image_) {
     assert(images.find(image_->id) == images.end());
+    missingImages.erase(image_->id);
     images.emplace(image_->id, std::move(image_));
+    ++version;
 }
 
 void ImageManager::updateImage(Immutable<style::Image::Impl> image_) {
-    removeImage(image_->id);
-    addImage(std::move(image_));
+    const std::string id = image_->id;
+    assert(images.find(id) != images.end());
+    ++version;
+
+    // Images that keep their size are replaced in the atlas, so that the positions tiles have
+    // stay valid. Otherwise, they're added to the atlas again once they're used.
+    auto icon = icons.find(id);
+    if (icon != icons.end()) {
+        if (image_->sdf == images.at(id)->sdf && fitsBin(*image_, *icon->second.bin)) {
+            copyIcon(*image_, *icon->second.bin);
+            icon->second.position = ImagePosition { *icon->second.bin, *image_ };
+        } else {
+            icons.erase(icon);
+        }
+    }
+
+    auto pattern = patterns.find(id);
+    if (pattern != patterns.end()) {
+        if (fitsBin(*image_, *pattern->second.bin)) {
+            copyPattern(*image_, *pattern->second.bin);
+            pattern->second.position = ImagePosition { *pattern->second.bin, *image_ };
+        } else {
+            shelfPack.unref(*pattern->second.bin);
+            patterns.erase(pattern);
+        }
+    }
+
+    images.erase(id);
+    images.emplace(id, std::move(image_));
 }
 
 void ImageManager::removeImage(const std::string& id) {
     assert(images.find(id) != images.end());
     images.erase(id);
+    ++version;
 
     auto it = patterns.find(id);
     if (it != patterns.end()) {
         shelfPack.unref(*it->second.bin);
         patterns.erase(it);
     }
+
+    // The icon stays in the atlas until the tiles referencing it are gone.
+    icons.erase(id);
 }
 
 const style::Image::Impl* ImageManager::getImage(const std::string& id) const {
@@ -57,15 +113,17 @@ void ImageManager::getImages(ImageRequestor& requestor, ImageDependencies depend
     // (i.e. if they've been addeded via runtime styling), then notify the requestor immediately.
     // Otherwise, delay notification until the sprite is loaded. At that point, if any of the
     // dependencies are still unavailable, we'll just assume they are permanently missing.
+    // With images on demand, the requestor is notified immediately regardless, and laid out
+    // again once the missing images are added.
     bool hasAllDependencies = true;
-    if (!isLoaded()) {
+    if (!isLoaded() && !imagesOnDemand) {
         for (const auto& dependency : dependencies) {
             if (images.find(dependency) == images.end()) {
                 hasAllDependencies = false;
             }
         }
     }
-    if (isLoaded() || hasAllDependencies) {
+    if (isLoaded() || imagesOnDemand || hasAllDependencies) {
         notify(requestor, dependencies);
     } else {
         requestors.emplace(&requestor, std::move(dependencies));
@@ -74,23 +132,52 @@ void ImageManager::getImages(ImageRequestor& requestor, ImageDependencies depend
 
 void ImageManager::removeRequestor(ImageRequestor& requestor) {
     requestors.erase(&requestor);
+
+    auto references = iconReferences.find(&requestor);
+    if (references == iconReferences.end()) {
+        return;
+    }
+
+    for (const auto& reference : references->second) {
+        mapbox::Bin* bin = reference.first;
+        if (iconShelfPack(reference.second.sdf).unref(*bin) == 0) {
+            auto icon = icons.find(reference.second.id);
+            if (icon != icons.end() && icon->second.bin == bin) {
+                icons.erase(icon);
+            }
+        }
+    }
+    iconReferences.erase(references);
 }
 
-void ImageManager::notify(ImageRequestor& requestor, const ImageDependencies& dependencies) const {
+void ImageManager::notify(ImageRequestor& requestor, const ImageDependencies& dependencies) {
     ImageMap response;
+    ImagePositions positions;
+    std::vector<std::string> missing;
+    auto& references = iconReferences[&requestor];
 
     for (const auto& dependency : dependencies) {
         auto it = images.find(dependency);
         if (it != images.end()) {
             response.emplace(*it);
+            if (auto position = referenceIcon(references, *it->second)) {
+                positions.emplace(dependency, *position);
+            }
+        } else if (missingImages.insert(dependency).second) {
+            missing.push_back(dependency);
         }
     }
 
-    requestor.onImagesAvailable(response);
+    requestor.onImagesAvailable(std::move(response), std::move(positions));
+
+    for (const auto& id : missing) {
+        observer->onStyleImageMissing(id);
+    }
 }
 
 void ImageManager::dumpDebugLogs() const {
     Log::Info(Event::General, "ImageManager::loaded: %d", loaded);
+    Log::Info(Event::General, "ImageManager::imagesOnDemand: %d", imagesOnDemand);
 }
 
 // When copied into the atlas texture, image data is padded by one pixel on each side. Icon
@@ -106,11 +193,118 @@ static mapbox::ShelfPack::ShelfPackOptions shelfPackOptions() {
 }
 
 ImageManager::ImageManager()
-    : shelfPack(64, 64, shelfPackOptions()) {
+    : observer(&nullObserver),
+      shelfPack(64, 64, shelfPackOptions()),
+      sdfShelfPack(64, 64, shelfPackOptions()) {
 }
 
 ImageManager::~ImageManager() = default;
 
+// Uploading many small regions one by one is slower than uploading the whole atlas.
+static constexpr std::size_t maxSubImageUploads = 64;
+
+bool ImageManager::fitsBin(const style::Image::Impl& image, const mapbox::Bin& bin) {
+    return uint32_t(bin.w) == image.size.width + padding * 2 &&
+        uint32_t(bin.h) == image.size.height + padding * 2;
+}
+
+mapbox::ShelfPack& ImageManager::iconShelfPack(bool sdf) {
+    return sdf ? sdfShelfPack : shelfPack;
+}
+
+optional<ImagePosition> ImageManager::referenceIcon(IconReferences& references,
+                                                    const style::Image::Impl& image) {
+    mapbox::ShelfPack& pack = iconShelfPack(image.sdf);
+
+    auto it = icons.find(image.id);
+    if (it != icons.end()) {
+        // Requestors reference each icon once, however often they request it.
+        if (references.emplace(it->second.bin, IconReference { image.id, image.sdf }).second) {
+            pack.ref(*it->second.bin);
+        }
+        return it->second.position;
+    }
+
+    mapbox::Bin* bin = pack.packOne(-1,
+        image.size.width + padding * 2,
+        image.size.height + padding * 2);
+    if (!bin) {
+        return {};
+    }
+
+    if (image.sdf) {
+        sdfAtlasImage.resize(getSDFPixelSize());
+    } else {
+        atlasImage.resize(getPixelSize());
+    }
+    copyIcon(image, *bin);
+    references.emplace(bin, IconReference { image.id, image.sdf });
+
+    return icons.emplace(image.id, AtlasEntry { bin, { *bin, image } }).first->second.position;
+}
+
+void ImageManager::copyIcon(const style::Image::Impl& image, const mapbox::Bin& bin) {
+    // The bin may have held another image before, so its padding is cleared as well.
+    const Size binSize { static_cast<uint32_t>(bin.w), static_cast<uint32_t>(bin.h) };
+    PremultipliedImage padded(binSize);
+    PremultipliedImage::copy(*image.sheet, padded, image.origin, { padding, padding }, image.size);
+
+    if (image.sdf) {
+        // Only the alpha channel holds the distance field.
+        for (uint32_t y = 0; y < binSize.height; y++) {
+            const uint8_t* src = padded.data.get() + y * binSize.width * 4;
+            uint8_t* dst = sdfAtlasImage.data.get() + (bin.y + y) * sdfAtlasImage.size.width + bin.x;
+            for (uint32_t x = 0; x < binSize.width; x++) {
+                dst[x] = src[x * 4 + 3];
+            }
+        }
+        sdfDirtyRects.push_back({
+            static_cast<uint16_t>(bin.x),
+            static_cast<uint16_t>(bin.y),
+            static_cast<uint16_t>(bin.w),
+            static_cast<uint16_t>(bin.h)
+        });
+        return;
+    }
+
+    PremultipliedImage::copy(padded, atlasImage, { 0, 0 },
+                             { static_cast<uint32_t>(bin.x), static_cast<uint32_t>(bin.y) }, binSize);
+
+    dirtyRects.push_back({
+        static_cast<uint16_t>(bin.x),
+        static_cast<uint16_t>(bin.y),
+        static_cast<uint16_t>(bin.w),
+        static_cast<uint16_t>(bin.h)
+    });
+}
+
+void ImageManager::copyPattern(const style::Image::Impl& image, const mapbox::Bin& bin) {
+    // Sprite images are copied straight from their sheet.
+    const PremultipliedImage& src = *image.sheet;
+    const uint32_t sx = image.origin.x;
+    const uint32_t sy = image.origin.y;
+
+    const uint32_t x = bin.x + padding;
+    const uint32_t y = bin.y + padding;
+    const uint32_t w = image.size.width;
+    const uint32_t h = image.size.height;
+
+    PremultipliedImage::copy(src, atlasImage, { sx, sy }, { x, y }, { w, h });
+
+    // Add 1 pixel wrapped padding on each side of the image.
+    PremultipliedImage::copy(src, atlasImage, { sx, sy + h - 1 }, { x, y - 1 }, { w, 1 }); // T
+    PremultipliedImage::copy(src, atlasImage, { sx,         sy }, { x, y + h }, { w, 1 }); // B
+    PremultipliedImage::copy(src, atlasImage, { sx + w - 1, sy }, { x - 1, y }, { 1, h }); // L
+    PremultipliedImage::copy(src, atlasImage, { sx,         sy }, { x + w, y }, { 1, h }); // R
+
+    dirtyRects.push_back({
+        static_cast<uint16_t>(bin.x),
+        static_cast<uint16_t>(bin.y),
+        static_cast<uint16_t>(bin.w),
+        static_cast<uint16_t>(bin.h)
+    });
+}
+
 optional<ImagePosition> ImageManager::getPattern(const std::string& id) {
     auto it = patterns.find(id);
     if (it != patterns.end()) {
@@ -122,8 +316,8 @@ optional<ImagePosition> ImageManager::getPattern(const std::string& id) {
         return {};
     }
 
-    const uint16_t width = image->image.size.width + padding * 2;
-    const uint16_t height = image->image.size.height + padding * 2;
+    const uint16_t width = image->size.width + padding * 2;
+    const uint16_t height = image->size.height + padding * 2;
 
     mapbox::Bin* bin = shelfPack.packOne(-1, width, height);
     if (!bin) {
@@ -131,25 +325,9 @@ optional<ImagePosition> ImageManager::getPattern(const std::string& id) {
     }
 
     atlasImage.resize(getPixelSize());
+    copyPattern(*image, *bin);
 
-    const PremultipliedImage& src = image->image;
-
-    const uint32_t x = bin->x + padding;
-    const uint32_t y = bin->y + padding;
-    const uint32_t w = src.size.width;
-    const uint32_t h = src.size.height;
-
-    PremultipliedImage::copy(src, atlasImage, { 0, 0 }, { x, y }, { w, h });
-
-    // Add 1 pixel wrapped padding on each side of the image.
-    PremultipliedImage::copy(src, atlasImage, { 0, h - 1 }, { x, y - 1 }, { w, 1 }); // T
-    PremultipliedImage::copy(src, atlasImage, { 0,     0 }, { x, y + h }, { w, 1 }); // B
-    PremultipliedImage::copy(src, atlasImage, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
-    PremultipliedImage::copy(src, atlasImage, { 0,     0 }, { x + w, y }, { 1, h }); // R
-
-    dirty = true;
-
-    return patterns.emplace(id, Pattern { bin, { *bin, *image } }).first->second.position;
+    return patterns.emplace(id, AtlasEntry { bin, { *bin, *image } }).first->second.position;
 }
 
 Size ImageManager::getPixelSize() const {
@@ -159,19 +337,56 @@ Size ImageManager::getPixelSize() const {
     };
 }
 
-void ImageManager::upload(gl::Context& context, gl::TextureUnit unit) {
-    if (!atlasTexture) {
-        atlasTexture = context.createTexture(atlasImage, unit);
-    } else if (dirty) {
-        context.updateTexture(*atlasTexture, atlasImage, unit);
+RendererStatistics::Memory ImageManager::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = atlasImage.bytes() + sdfAtlasImage.bytes();
+    memory.gpu = (atlasTexture ? atlasTexture->size.area() * 4 : 0) +
+        (sdfAtlasTexture ? sdfAtlasTexture->size.area() : 0);
+    return memory;
+}
+
+Size ImageManager::getSDFPixelSize() const {
+    return Size {
+        static_cast<uint32_t>(sdfShelfPack.width()),
+        static_cast<uint32_t>(sdfShelfPack.height())
+    };
+}
+
+template <class Image>
+static void uploadAtlas(gl::Context& context,
+                        optional<gl::Texture>& texture,
+                        const Image& image,
+                        std::vector<Rect<uint16_t>>& dirtyRects,
+                        gl::TextureUnit unit) {
+    if (!texture) {
+        texture = context.createTexture(image, unit);
+    } else if (texture->size != image.size || dirtyRects.size() > maxSubImageUploads) {
+        context.updateTexture(*texture, image, unit);
+    } else {
+        for (const auto& rect : dirtyRects) {
+            const Size size { rect.w, rect.h };
+            Image region(size);
+            Image::copy(image, region, { rect.x, rect.y }, { 0, 0 }, size);
+            context.updateTextureSubImage(*texture, region, { rect.x, rect.y }, unit);
+        }
     }
 
-    dirty = false;
+    dirtyRects.clear();
 }
 
-void ImageManager::bind(gl::Context& context, gl::TextureUnit unit) {
+void ImageManager::upload(gl::Context& context, gl::TextureUnit unit) {
+    uploadAtlas(context, atlasTexture, atlasImage, dirtyRects, unit);
+}
+
+void ImageManager::bind(gl::Context& context, gl::TextureUnit unit, gl::TextureFilter filter) {
     upload(context, unit);
-    context.bindTexture(*atlasTexture, unit, gl::TextureFilter::Linear);
+    context.bindTexture(*atlasTexture, unit, filter);
+}
+
+void ImageManager::bindSDF(gl::Context& context, gl::TextureUnit unit) {
+    sdfAtlasImage.resize(getSDFPixelSize());
+    uploadAtlas(context, sdfAtlasTexture, sdfAtlasImage, sdfDirtyRects, unit);
+    context.bindTexture(*sdfAtlasTexture, unit, gl::TextureFilter::Linear);
 }
 
 } // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/immutable.hpp>
 #include <mbgl/util/optional.hpp>
@@ -11,6 +12,8 @@
 
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -18,30 +21,46 @@ namespace gl {
 class Context;
 } // namespace gl
 
+class ImageManagerObserver;
+
 class ImageRequestor {
 public:
     virtual ~ImageRequestor() = default;
-    virtual void onImagesAvailable(ImageMap) = 0;
+    // The positions are those of the images in the ImageManager's atlas, which keeps them for as
+    // long as the requestor isn't removed.
+    virtual void onImagesAvailable(ImageMap, ImagePositions) = 0;
 };
 
 /*
     ImageManager does two things:
 
         1. Tracks requests for icon images from tile workers and sends responses when the requests are fulfilled.
-        2. Builds a texture atlas for pattern images.
+        2. Builds a texture atlas for icon and pattern images, shared by all tiles.
 
     These are disparate responsibilities and should eventually be handled by different classes. When we implement
     data-driven support for `*-pattern`, we'll likely use per-bucket pattern atlases, and that would be a good time
     to refactor this.
+
+    Icons are added to the atlas when they are sent to a requestor, and stay in it for as long as a requestor
+    that was sent them exists. Patterns are added when they're first rendered. Icons of SDF images go in a
+    separate single channel atlas, since symbol layers draw them with only their alpha channel.
 */
 class ImageManager : public util::noncopyable {
 public:
     ImageManager();
     ~ImageManager();
 
+    void setObserver(ImageManagerObserver*);
+
     void setLoaded(bool);
     bool isLoaded() const;
 
+    // With images on demand, requestors are sent the images that are present at once, instead of
+    // waiting for the sprite to load. Either way, the observer is told about every image that a
+    // requestor is sent without, once per image until it is added, which may be before the sprite
+    // has provided it.
+    void setImagesOnDemand(bool);
+
     void dumpDebugLogs() const;
 
     const style::Image::Impl* getImage(const std::string&) const;
@@ -50,42 +69,87 @@ public:
     void updateImage(Immutable<style::Image::Impl>);
     void removeImage(const std::string&);
 
+    // Changes whenever an image is added, updated or removed, which symbol layouts depend on.
+    uint64_t getVersion() const {
+        return version;
+    }
+
     void getImages(ImageRequestor&, ImageDependencies);
     void removeRequestor(ImageRequestor&);
 
 private:
-    void notify(ImageRequestor&, const ImageDependencies&) const;
+    void notifyRequestors();
+    void notify(ImageRequestor&, const ImageDependencies&);
 
+    ImageManagerObserver* observer;
     bool loaded = false;
+    bool imagesOnDemand = false;
+    uint64_t version = 0;
 
     std::unordered_map<ImageRequestor*, ImageDependencies> requestors;
     ImageMap images;
+    std::set<std::string> missingImages;
 
 // Pattern stuff
 public:
     optional<ImagePosition> getPattern(const std::string& name);
 
-    void bind(gl::Context&, gl::TextureUnit unit);
+    void bind(gl::Context&, gl::TextureUnit unit, gl::TextureFilter = gl::TextureFilter::Linear);
     void upload(gl::Context&, gl::TextureUnit unit);
 
     Size getPixelSize() const;
 
+    // Icons of SDF images are kept in an atlas of their own, which only holds their alpha channel.
+    void bindSDF(gl::Context&, gl::TextureUnit unit);
+    Size getSDFPixelSize() const;
+
+    // Memory held by the atlas images, and by their textures once uploaded. The images themselves
+    // belong to the style.
+    RendererStatistics::Memory memoryUsage() const;
+
     // Only for use in tests.
     const PremultipliedImage& getAtlasImage() const {
         return atlasImage;
     }
+    const AlphaImage& getSDFAtlasImage() const {
+        return sdfAtlasImage;
+    }
 
 private:
-    struct Pattern {
+    struct AtlasEntry {
         mapbox::Bin* bin;
         ImagePosition position;
     };
 
+    struct IconReference {
+        std::string id;
+        bool sdf;
+    };
+    using IconReferences = std::unordered_map<mapbox::Bin*, IconReference>;
+
+    static bool fitsBin(const style::Image::Impl&, const mapbox::Bin&);
+    mapbox::ShelfPack& iconShelfPack(bool sdf);
+    optional<ImagePosition> referenceIcon(IconReferences&, const style::Image::Impl&);
+    void copyIcon(const style::Image::Impl&, const mapbox::Bin&);
+    void copyPattern(const style::Image::Impl&, const mapbox::Bin&);
+
     mapbox::ShelfPack shelfPack;
-    std::unordered_map<std::string, Pattern> patterns;
+    std::unordered_map<std::string, AtlasEntry> patterns;
+
+    // Icons of images that were removed, or changed their size, stay in the atlas until they're no
+    // longer referenced, but aren't in here any more.
+    std::unordered_map<std::string, AtlasEntry> icons;
+    std::unordered_map<ImageRequestor*, IconReferences> iconReferences;
+
     PremultipliedImage atlasImage;
     mbgl::optional<gl::Texture> atlasTexture;
-    bool dirty = true;
+    // Regions changed since the last upload.
+    std::vector<Rect<uint16_t>> dirtyRects;
+
+    mapbox::ShelfPack sdfShelfPack;
+    AlphaImage sdfAtlasImage;
+    mbgl::optional<gl::Texture> sdfAtlasTexture;
+    std::vector<Rect<uint16_t>> sdfDirtyRects;
 };
 
 } // namespace mbgl
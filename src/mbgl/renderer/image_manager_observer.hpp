@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace mbgl {
+
+class ImageManagerObserver {
+public:
+    virtual ~ImageManagerObserver() = default;
+
+    virtual void onStyleImageMissing(const std::string&) {}
+};
+
+} // namespace mbgl
@@ -32,16 +32,30 @@ void RenderBackgroundLayer::transition(const TransitionParameters &parameters) {
 }
 
 void RenderBackgroundLayer::evaluate(const PropertyEvaluationParameters &parameters) {
-    evaluated = unevaluated.evaluate(parameters);
-
-    passes = evaluated.get<style::BackgroundOpacity>() > 0 ? RenderPass::Translucent
-                                                           : RenderPass::None;
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
+
+    // An opaque background in the middle of a style hides everything below it. Rendering it in
+    // the opaque pass lets it write depth, so that the depth test rejects the fragments of the
+    // layers it covers, and its own fragments under opaque fills above it.
+    if (evaluated.get<style::BackgroundOpacity>() <= 0) {
+        passes = RenderPass::None;
+    } else if (evaluated.get<style::BackgroundPattern>().to.empty() &&
+               evaluated.get<style::BackgroundOpacity>() >= 1.0f &&
+               evaluated.get<style::BackgroundColor>().a >= 1.0f) {
+        passes = RenderPass::Opaque;
+    } else {
+        passes = RenderPass::Translucent;
+    }
 }
 
 bool RenderBackgroundLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderBackgroundLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent();
+}
+
 void RenderBackgroundLayer::render(PaintParameters& parameters, RenderSource*) {
     // Note that for bottommost layers without a pattern, the background color is drawn with
     // glClear rather than this method.
@@ -84,8 +98,7 @@ void RenderBackgroundLayer::render(PaintParameters& parameters, RenderSource*) {
                 parameters.staticData.tileTriangleSegments,
                 paintAttibuteData,
                 properties,
-                parameters.state.getZoom(),
-                getID()
+                parameters.state.getZoom()
             );
         }
     } else {
@@ -93,23 +106,38 @@ void RenderBackgroundLayer::render(PaintParameters& parameters, RenderSource*) {
             parameters.programs.fill.get(properties).draw(
                 parameters.context,
                 gl::Triangles(),
-                parameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+                parameters.depthModeForSublayer(0, parameters.pass == RenderPass::Opaque
+                                                       ? gl::DepthMode::ReadWrite
+                                                       : gl::DepthMode::ReadOnly),
                 gl::StencilMode::disabled(),
                 parameters.colorModeForRenderPass(),
                 FillProgram::UniformValues {
                     uniforms::u_matrix::Value{ parameters.matrixForTile(tileID) },
                     uniforms::u_world::Value{ parameters.context.viewport.getCurrentValue().size },
+                    uniforms::u_state_color::Value{ Color() },
                 },
                 parameters.staticData.tileVertexBuffer,
                 parameters.staticData.quadTriangleIndexBuffer,
                 parameters.staticData.tileTriangleSegments,
                 paintAttibuteData,
                 properties,
-                parameters.state.getZoom(),
-                getID()
+                parameters.state.getZoom()
             );
         }
     }
 }
 
+void RenderBackgroundLayer::precompilePrograms(Programs& programs) const {
+    style::FillPaintProperties::PossiblyEvaluated properties;
+    properties.get<FillPattern>() = evaluated.get<BackgroundPattern>();
+    properties.get<FillOpacity>() = { evaluated.get<BackgroundOpacity>() };
+    properties.get<FillColor>() = { evaluated.get<BackgroundColor>() };
+
+    if (!evaluated.get<BackgroundPattern>().to.empty()) {
+        programs.fillPattern.get(properties);
+    } else {
+        programs.fill.get(properties);
+    }
+}
+
 } // namespace mbgl
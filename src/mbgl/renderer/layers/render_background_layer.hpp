@@ -14,7 +14,9 @@ public:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
     void render(PaintParameters&, RenderSource*) override;
+    void precompilePrograms(Programs&) const override;
 
     std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const RenderLayer*>&) const override;
 
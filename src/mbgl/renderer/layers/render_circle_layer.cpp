@@ -2,13 +2,24 @@
 #include <mbgl/renderer/buckets/circle_bucket.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/render_static_data.hpp>
+#include <mbgl/renderer/renderer_backend.hpp>
+#include <mbgl/renderer/feature_state.hpp>
+#include <mbgl/renderer/property_evaluator.hpp>
 #include <mbgl/programs/programs.hpp>
 #include <mbgl/programs/circle_program.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/style/layers/circle_layer_impl.hpp>
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/intersection_tests.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/interpolate.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 
@@ -32,7 +43,18 @@ void RenderCircleLayer::transition(const TransitionParameters& parameters) {
 }
 
 void RenderCircleLayer::evaluate(const PropertyEvaluationParameters& parameters) {
-    evaluated = unevaluated.evaluate(parameters);
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
+
+    if (impl().heatmap) {
+        heatmapIntensity = impl().heatmap->intensity.evaluate(PropertyEvaluator<float>(parameters, 1.0f));
+        heatmapOpacity = impl().heatmap->opacity.evaluate(PropertyEvaluator<float>(parameters, 1.0f));
+
+        passes = (heatmapOpacity > 0 && heatmapIntensity > 0 &&
+                  evaluated.get<style::CircleRadius>().constantOr(1) > 0 &&
+                  evaluated.get<style::CircleOpacity>().constantOr(1) > 0)
+                 ? RenderPass::Translucent : RenderPass::None;
+        return;
+    }
 
     passes = ((evaluated.get<style::CircleRadius>().constantOr(1) > 0 ||
                evaluated.get<style::CircleStrokeWidth>().constantOr(1) > 0)
@@ -47,52 +69,270 @@ bool RenderCircleLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderCircleLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent() ||
+        (impl().heatmap && (impl().heatmap->intensity.isCameraFunction() ||
+                            impl().heatmap->opacity.isCameraFunction()));
+}
+
 void RenderCircleLayer::render(PaintParameters& parameters, RenderSource*) {
     if (parameters.pass == RenderPass::Opaque) {
         return;
     }
 
+    if (impl().heatmap) {
+        renderHeatmap(parameters);
+        return;
+    }
+
     const bool scaleWithMap = evaluated.get<CirclePitchScale>() == CirclePitchScaleType::Map;
     const bool pitchWithMap = evaluated.get<CirclePitchAlignment>() == AlignmentType::Map;
 
+    const optional<Color>& stateColor = impl().stateColor;
+    const FeatureStates* states = stateColor && parameters.featureStates
+        ? parameters.featureStates->find(impl().source, impl().sourceLayer)
+        : nullptr;
+
     for (const RenderTile& tile : renderTiles) {
         assert(dynamic_cast<CircleBucket*>(tile.tile.getBucket(*baseImpl)));
         CircleBucket& bucket = *reinterpret_cast<CircleBucket*>(tile.tile.getBucket(*baseImpl));
 
+        // Without a state color, the states of the features aren't drawn, and aren't uploaded.
+        FeatureStateAttributes::Bindings stateBindings;
+        if (stateColor) {
+            bucket.featureState.update(parameters.context, states, bucket.instanceBuffer
+                ? bucket.instanceBuffer->vertexCount
+                : bucket.vertexBuffer->vertexCount);
+            stateBindings = bucket.featureState.attributeBindings();
+        }
+
+        const CircleProgram::UniformValues uniformValues {
+            uniforms::u_matrix::Value{
+                tile.translatedMatrix(evaluated.get<CircleTranslate>(),
+                                      evaluated.get<CircleTranslateAnchor>(),
+                                      parameters.state)
+            },
+            uniforms::u_scale_with_map::Value{ scaleWithMap },
+            uniforms::u_extrude_scale::Value{ pitchWithMap
+                ? std::array<float, 2> {{
+                    tile.id.pixelsToTileUnits(1, parameters.state.getZoom()),
+                    tile.id.pixelsToTileUnits(1, parameters.state.getZoom()) }}
+                : parameters.pixelsToGLUnits },
+            uniforms::u_camera_to_center_distance::Value{ parameters.state.getCameraToCenterDistance() },
+            uniforms::u_pitch_with_map::Value{ pitchWithMap },
+            uniforms::u_state_color::Value{ stateColor.value_or(Color()) }
+        };
+
+        const auto stencilMode = parameters.mapMode == MapMode::Still
+            ? parameters.stencilModeForClipping(tile.clip)
+            : gl::StencilMode::disabled();
+
+        if (bucket.instanceBuffer) {
+            parameters.programs.circleInstanced.get(evaluated).draw(
+                parameters.context,
+                gl::Triangles(),
+                parameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+                stencilMode,
+                parameters.colorModeForRenderPass(),
+                uniformValues,
+                parameters.staticData.circleCornerVertexBuffer,
+                parameters.staticData.quadTriangleIndexBuffer,
+                *bucket.instanceBuffer,
+                bucket.instanceSegments,
+                bucket.paintPropertyBinders.at(getID()),
+                evaluated,
+                parameters.state.getZoom(),
+                stateBindings
+            );
+            continue;
+        }
+
         parameters.programs.circle.get(evaluated).draw(
             parameters.context,
             gl::Triangles(),
             parameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly),
-            parameters.mapMode == MapMode::Still
-                ? parameters.stencilModeForClipping(tile.clip)
-                : gl::StencilMode::disabled(),
+            stencilMode,
             parameters.colorModeForRenderPass(),
-            CircleProgram::UniformValues {
-                uniforms::u_matrix::Value{
-                    tile.translatedMatrix(evaluated.get<CircleTranslate>(),
-                                          evaluated.get<CircleTranslateAnchor>(),
-                                          parameters.state)
-                },
-                uniforms::u_scale_with_map::Value{ scaleWithMap },
-                uniforms::u_extrude_scale::Value{ pitchWithMap
-                    ? std::array<float, 2> {{
-                        tile.id.pixelsToTileUnits(1, parameters.state.getZoom()),
-                        tile.id.pixelsToTileUnits(1, parameters.state.getZoom()) }}
-                    : parameters.pixelsToGLUnits },
-                uniforms::u_camera_to_center_distance::Value{ parameters.state.getCameraToCenterDistance() },
-                uniforms::u_pitch_with_map::Value{ pitchWithMap }
-            },
+            uniformValues,
             *bucket.vertexBuffer,
-            *bucket.indexBuffer,
+            parameters.staticData.quadsIndexBuffer,
             bucket.segments,
             bucket.paintPropertyBinders.at(getID()),
             evaluated,
             parameters.state.getZoom(),
-            getID()
+            {},
+            stateBindings
         );
     }
 }
 
+namespace {
+
+// The default heatmap-color of the style spec, as premultiplied colors for densities from 0 to 1.
+PremultipliedImage heatmapColorRamp() {
+    struct Stop {
+        float density;
+        std::array<float, 4> color;
+    };
+    static const std::array<Stop, 6> stops {{
+        { 0.0f, {{ 0, 0, 255, 0 }} },
+        { 0.1f, {{ 65, 105, 225, 1 }} },
+        { 0.3f, {{ 0, 255, 255, 1 }} },
+        { 0.5f, {{ 0, 255, 0, 1 }} },
+        { 0.7f, {{ 255, 255, 0, 1 }} },
+        { 1.0f, {{ 255, 0, 0, 1 }} },
+    }};
+
+    PremultipliedImage image({ 256, 1 });
+    std::size_t stop = 0;
+    for (uint32_t i = 0; i < image.size.width; i++) {
+        const float density = i / float(image.size.width - 1);
+        while (stop + 2 < stops.size() && stops[stop + 1].density < density) {
+            stop++;
+        }
+        const Stop& lower = stops[stop];
+        const Stop& upper = stops[stop + 1];
+        const float t = util::clamp((density - lower.density) / (upper.density - lower.density), 0.0f, 1.0f);
+
+        const float alpha = util::interpolate(lower.color[3], upper.color[3], t);
+        for (std::size_t channel = 0; channel < 3; channel++) {
+            image.data[i * 4 + channel] = static_cast<uint8_t>(std::round(
+                util::interpolate(lower.color[channel], upper.color[channel], t) * alpha));
+        }
+        image.data[i * 4 + 3] = static_cast<uint8_t>(std::round(alpha * 255));
+    }
+    return image;
+}
+
+} // namespace
+
+// Heatmaps are drawn in two passes. First, the kernels of all features are added up into an
+// offscreen texture, which stores the density in its red channel. The texture has a quarter of
+// the viewport's resolution, as density varies smoothly, and half floats where available, so that
+// densities above 1 and faint kernels aren't clipped. Then the texture is drawn over the
+// viewport, looking up each density in the color ramp.
+void RenderCircleLayer::renderHeatmap(PaintParameters& parameters) {
+    const auto viewportSize = parameters.context.viewport.getCurrentValue().size;
+    const Size size { std::max(viewportSize.width / 4, 1u), std::max(viewportSize.height / 4, 1u) };
+
+    if (!heatmapTexture || heatmapTexture->getSize() != size) {
+        heatmapTexture = OffscreenTexture(parameters.context, size, OffscreenTextureAttachment::None,
+                                          parameters.context.supportsHalfFloatTextures()
+                                              ? gl::TextureType::HalfFloat
+                                              : gl::TextureType::UnsignedByte);
+    }
+
+    heatmapTexture->bind();
+    parameters.context.clear(Color{ 0.0f, 0.0f, 0.0f, 0.0f }, {}, {});
+
+    const gl::ColorMode additive {
+        gl::ColorMode::Add { gl::ColorMode::One, gl::ColorMode::One },
+        {},
+        { true, true, true, true }
+    };
+
+    for (const RenderTile& tile : renderTiles) {
+        assert(dynamic_cast<CircleBucket*>(tile.tile.getBucket(*baseImpl)));
+        CircleBucket& bucket = *reinterpret_cast<CircleBucket*>(tile.tile.getBucket(*baseImpl));
+
+        const float extrudeScale = tile.id.pixelsToTileUnits(1, parameters.state.getZoom());
+        const HeatmapProgram::UniformValues uniformValues {
+            uniforms::u_matrix::Value{
+                tile.translatedMatrix(evaluated.get<CircleTranslate>(),
+                                      evaluated.get<CircleTranslateAnchor>(),
+                                      parameters.state)
+            },
+            uniforms::u_extrude_scale::Value{ std::array<float, 2> {{ extrudeScale, extrudeScale }} },
+            uniforms::u_intensity::Value{ heatmapIntensity }
+        };
+
+        if (bucket.instanceBuffer) {
+            parameters.programs.heatmapInstanced.get(evaluated).draw(
+                parameters.context,
+                gl::Triangles(),
+                gl::DepthMode::disabled(),
+                gl::StencilMode::disabled(),
+                additive,
+                uniformValues,
+                parameters.staticData.circleCornerVertexBuffer,
+                parameters.staticData.quadTriangleIndexBuffer,
+                *bucket.instanceBuffer,
+                bucket.instanceSegments,
+                bucket.paintPropertyBinders.at(getID()),
+                evaluated,
+                parameters.state.getZoom()
+            );
+            continue;
+        }
+
+        parameters.programs.heatmap.get(evaluated).draw(
+            parameters.context,
+            gl::Triangles(),
+            gl::DepthMode::disabled(),
+            gl::StencilMode::disabled(),
+            additive,
+            uniformValues,
+            *bucket.vertexBuffer,
+            parameters.staticData.quadsIndexBuffer,
+            bucket.segments,
+            bucket.paintPropertyBinders.at(getID()),
+            evaluated,
+            parameters.state.getZoom()
+        );
+    }
+
+    parameters.backend.bind();
+
+    if (!colorRampTexture) {
+        colorRampTexture = parameters.context.createTexture(heatmapColorRamp(), 1);
+    }
+    parameters.context.bindTexture(heatmapTexture->getTexture(), 0, gl::TextureFilter::Linear);
+    parameters.context.bindTexture(*colorRampTexture, 1, gl::TextureFilter::Linear);
+
+    mat4 viewportMat;
+    matrix::ortho(viewportMat, 0, viewportSize.width, viewportSize.height, 0, 0, 1);
+
+    const Properties<>::PossiblyEvaluated properties;
+
+    parameters.programs.heatmapTexture.get().draw(
+        parameters.context,
+        gl::Triangles(),
+        gl::DepthMode::disabled(),
+        gl::StencilMode::disabled(),
+        parameters.colorModeForRenderPass(),
+        HeatmapTextureProgram::UniformValues{
+            uniforms::u_matrix::Value{ viewportMat },
+            uniforms::u_world::Value{ viewportSize },
+            uniforms::u_image::Value{ 0 },
+            uniforms::u_color_ramp::Value{ 1 },
+            uniforms::u_opacity::Value{ heatmapOpacity }
+        },
+        parameters.staticData.extrusionTextureVertexBuffer,
+        parameters.staticData.quadTriangleIndexBuffer,
+        parameters.staticData.extrusionTextureSegments,
+        HeatmapTextureProgram::PaintPropertyBinders{ properties, 0 },
+        properties,
+        parameters.state.getZoom());
+}
+
+void RenderCircleLayer::precompilePrograms(Programs& programs) const {
+    // Buckets are either all instanced or none of them are, see CircleBucket.
+    if (impl().heatmap) {
+        if (programs.instancing) {
+            programs.heatmapInstanced.get(evaluated);
+        } else {
+            programs.heatmap.get(evaluated);
+        }
+        programs.heatmapTexture.get();
+        return;
+    }
+    if (programs.instancing) {
+        programs.circleInstanced.get(evaluated);
+    } else {
+        programs.circle.get(evaluated);
+    }
+}
+
 bool RenderCircleLayer::queryIntersectsFeature(
         const GeometryCoordinates& queryGeometry,
         const GeometryTileFeature& feature,
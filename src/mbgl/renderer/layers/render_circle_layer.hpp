@@ -3,6 +3,9 @@
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/style/layers/circle_layer_impl.hpp>
 #include <mbgl/style/layers/circle_layer_properties.hpp>
+#include <mbgl/gl/texture.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+#include <mbgl/util/optional.hpp>
 
 namespace mbgl {
 
@@ -14,7 +17,9 @@ public:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
     void render(PaintParameters&, RenderSource*) override;
+    void precompilePrograms(Programs&) const override;
 
     bool queryIntersectsFeature(
             const GeometryCoordinates&,
@@ -29,7 +34,18 @@ public:
     style::CirclePaintProperties::Unevaluated unevaluated;
     style::CirclePaintProperties::PossiblyEvaluated evaluated;
 
+    // The evaluated heatmap properties, for layers drawn as a heatmap.
+    float heatmapIntensity = 1;
+    float heatmapOpacity = 1;
+
     const style::CircleLayer::Impl& impl() const;
+
+private:
+    void renderHeatmap(PaintParameters&);
+
+    // The density of the heatmap, at a quarter of the viewport's resolution, and its color ramp.
+    optional<OffscreenTexture> heatmapTexture;
+    optional<gl::Texture> colorRampTexture;
 };
 
 template <>
@@ -33,27 +33,25 @@ bool RenderCustomLayer::hasTransition() const {
     return false;
 }
 
+bool RenderCustomLayer::isZoomDependent() const {
+    return false;
+}
+
 std::unique_ptr<Bucket> RenderCustomLayer::createBucket(const BucketParameters&, const std::vector<const RenderLayer*>&) const {
     assert(false);
     return nullptr;
 }
 
-void RenderCustomLayer::render(PaintParameters& paintParameters, RenderSource*) {
+void RenderCustomLayer::initialize() {
     if (!initialized) {
         assert(impl().initializeFn);
         impl().initializeFn(impl().context);
         initialized = true;
     }
+}
 
-    gl::Context& context = paintParameters.context;
+CustomLayerRenderParameters RenderCustomLayer::renderParameters(const PaintParameters& paintParameters) const {
     const TransformState& state = paintParameters.state;
-
-    // Reset GL state to a known state so the CustomLayer always has a clean slate.
-    context.bindVertexArray = 0;
-    context.setDepthMode(paintParameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly));
-    context.setStencilMode(gl::StencilMode::disabled());
-    context.setColorMode(paintParameters.colorModeForRenderPass());
-
     CustomLayerRenderParameters parameters;
 
     parameters.width = state.getSize().width;
@@ -64,14 +62,75 @@ void RenderCustomLayer::render(PaintParameters& paintParameters, RenderSource*)
     parameters.bearing = -state.getAngle() * util::RAD2DEG;
     parameters.pitch = state.getPitch();
     parameters.fieldOfView = state.getFieldOfView();
+    parameters.projectionMatrix = paintParameters.projMatrix;
+
+    return parameters;
+}
+
+void RenderCustomLayer::upload(PaintParameters& paintParameters) {
+    if (!impl().prepareFn) {
+        return;
+    }
+
+    initialize();
+    impl().prepareFn(impl().context, renderParameters(paintParameters));
+    restoreState(paintParameters);
+}
+
+void RenderCustomLayer::render(PaintParameters& paintParameters, RenderSource*) {
+    initialize();
+
+    gl::Context& context = paintParameters.context;
+
+    // Reset GL state to a known state so the CustomLayer always has a clean slate.
+    context.bindVertexArray = 0;
+    context.setDepthMode(paintParameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly));
+    context.setStencilMode(gl::StencilMode::disabled());
+    context.setColorMode(paintParameters.colorModeForRenderPass());
 
     assert(impl().renderFn);
-    impl().renderFn(impl().context, parameters);
+    impl().renderFn(impl().context, renderParameters(paintParameters));
+
+    restoreState(paintParameters);
+}
+
+void RenderCustomLayer::restoreState(PaintParameters& paintParameters) const {
+    gl::Context& context = paintParameters.context;
+    const CustomLayerGLState modified = impl().modifiedGLState;
+
+    if (modified & CustomLayerGLState::Framebuffer) {
+        context.bindFramebuffer.setDirty();
+        context.viewport.setDirty();
+        context.scissorTest.setDirty();
+    }
 
     // Reset the view back to our original one, just in case the CustomLayer changed
     // the viewport or Framebuffer.
     paintParameters.backend.bind();
-    context.setDirtyState();
+
+    uint32_t groups = 0;
+    if (modified & CustomLayerGLState::Program) {
+        groups |= gl::Context::DirtyProgram;
+    }
+    if (modified & CustomLayerGLState::VertexArrays) {
+        groups |= gl::Context::DirtyVertexArrays;
+    }
+    if (modified & CustomLayerGLState::Textures) {
+        groups |= gl::Context::DirtyTextures;
+    }
+    if (modified & CustomLayerGLState::Depth) {
+        groups |= gl::Context::DirtyDepth;
+    }
+    if (modified & CustomLayerGLState::Stencil) {
+        groups |= gl::Context::DirtyStencil;
+    }
+    if (modified & CustomLayerGLState::Color) {
+        groups |= gl::Context::DirtyColor;
+    }
+    if (modified & CustomLayerGLState::Other) {
+        groups |= gl::Context::DirtyOther;
+    }
+    context.setDirtyState(groups);
 }
 
 } // namespace mbgl
@@ -13,13 +13,20 @@ public:
     void transition(const TransitionParameters&) final {}
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
 
     std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const RenderLayer*>&) const final;
+    void upload(PaintParameters&) final;
     void render(PaintParameters&, RenderSource*) final;
 
     const style::CustomLayer::Impl& impl() const;
 
 private:
+    void initialize();
+    style::CustomLayerRenderParameters renderParameters(const PaintParameters&) const;
+    // Marks the GL state the layer may have changed as dirty, so it's sent again when it's used.
+    void restoreState(PaintParameters&) const;
+
     bool initialized = false;
 };
 
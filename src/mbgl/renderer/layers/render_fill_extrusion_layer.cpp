@@ -13,6 +13,9 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/intersection_tests.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -35,7 +38,8 @@ void RenderFillExtrusionLayer::transition(const TransitionParameters& parameters
 }
 
 void RenderFillExtrusionLayer::evaluate(const PropertyEvaluationParameters& parameters) {
-    evaluated = unevaluated.evaluate(parameters);
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
+    evaluations++;
 
     passes = (evaluated.get<style::FillExtrusionOpacity>() > 0) ? RenderPass::Translucent
                                                          : RenderPass::None;
@@ -45,6 +49,35 @@ bool RenderFillExtrusionLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderFillExtrusionLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent();
+}
+
+bool RenderFillExtrusionLayer::ExtrusionDraw::Tile::operator==(const Tile& rhs) const {
+    return bucketRevision == rhs.bucketRevision && matrix == rhs.matrix &&
+        smallWalls == rhs.smallWalls && segments == rhs.segments;
+}
+
+bool RenderFillExtrusionLayer::ExtrusionDraw::operator==(const ExtrusionDraw& rhs) const {
+    return size == rhs.size && zoom == rhs.zoom && evaluations == rhs.evaluations &&
+        light == rhs.light && tiles == rhs.tiles;
+}
+
+namespace {
+
+// The highest any extrusion of the bucket reaches, in meters.
+template <class Property>
+float maxHeight(const RenderFillExtrusionLayer& layer, const FillExtrusionBucket& bucket) {
+    auto it = bucket.paintPropertyBinders.find(layer.getID());
+    if (it == bucket.paintPropertyBinders.end() || !it->second.statistics<Property>().max()) {
+        return layer.evaluated.get<Property>().constantOr(Property::defaultValue());
+    } else {
+        return *it->second.statistics<Property>().max();
+    }
+}
+
+} // namespace
+
 void RenderFillExtrusionLayer::render(PaintParameters& parameters, RenderSource*) {
     if (parameters.pass == RenderPass::Opaque) {
         return;
@@ -54,81 +87,37 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters, RenderSource*
 
     if (!parameters.staticData.extrusionTexture || parameters.staticData.extrusionTexture->getSize() != size) {
         parameters.staticData.extrusionTexture = OffscreenTexture(parameters.context, size, OffscreenTextureAttachment::Depth);
+        parameters.staticData.extrusionTextureLayer = nullptr;
     }
 
-    parameters.staticData.extrusionTexture->bind();
+    // Segments whose buildings are off-screen are culled, and the walls of small buildings are
+    // left out where they'd be smaller than the threshold on screen.
+    ExtrusionDraw draw { size, float(parameters.state.getZoom()), evaluations, parameters.evaluatedLight, {} };
+    draw.tiles.reserve(renderTiles.size());
+    for (const RenderTile& tile : renderTiles) {
+        assert(dynamic_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl)));
+        const FillExtrusionBucket& bucket = *reinterpret_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl));
 
-    parameters.context.setStencilMode(gl::StencilMode::disabled());
-    parameters.context.setDepthMode(parameters.depthModeForSublayer(0, gl::DepthMode::ReadWrite));
-    parameters.context.clear(Color{ 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, {});
+        const mat4 matrix = tile.translatedClipMatrix(evaluated.get<FillExtrusionTranslate>(),
+                                                      evaluated.get<FillExtrusionTranslateAnchor>(),
+                                                      parameters.state);
+        const double height = std::max(maxHeight<FillExtrusionHeight>(*this, bucket),
+                                       maxHeight<FillExtrusionBase>(*this, bucket));
+        std::vector<bool> segments = visibleSegments(matrix, bucket.segmentBounds, 0, height);
 
-    if (evaluated.get<FillExtrusionPattern>().from.empty()) {
-        for (const RenderTile& tile : renderTiles) {
-            assert(dynamic_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl)));
-            FillExtrusionBucket& bucket = *reinterpret_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl));
+        const double pixelsPerUnit = util::tileSize * std::pow(2.0, parameters.state.getZoom() - tile.id.canonical.z) / util::EXTENT;
+        const bool smallWalls = FillExtrusionBucket::smallBuildingSize * pixelsPerUnit >= parameters.extrusionWallThreshold;
 
-            parameters.programs.fillExtrusion.get(evaluated).draw(
-                parameters.context,
-                gl::Triangles(),
-                parameters.depthModeForSublayer(0, gl::DepthMode::ReadWrite),
-                gl::StencilMode::disabled(),
-                parameters.colorModeForRenderPass(),
-                FillExtrusionUniforms::values(
-                    tile.translatedClipMatrix(evaluated.get<FillExtrusionTranslate>(),
-                                              evaluated.get<FillExtrusionTranslateAnchor>(),
-                                              parameters.state),
-                    parameters.state,
-                    parameters.evaluatedLight
-                ),
-                *bucket.vertexBuffer,
-                *bucket.indexBuffer,
-                bucket.triangleSegments,
-                bucket.paintPropertyBinders.at(getID()),
-                evaluated,
-                parameters.state.getZoom(),
-                getID());
-        }
-    } else {
-        optional<ImagePosition> imagePosA = parameters.imageManager.getPattern(evaluated.get<FillExtrusionPattern>().from);
-        optional<ImagePosition> imagePosB = parameters.imageManager.getPattern(evaluated.get<FillExtrusionPattern>().to);
+        draw.tiles.push_back({ bucket.getRevision(), matrix, smallWalls, std::move(segments) });
+    }
 
-        if (!imagePosA || !imagePosB) {
+    const bool patterned = !evaluated.get<FillExtrusionPattern>().from.empty();
+    if (patterned || parameters.staticData.extrusionTextureLayer != this || !(draw == lastDraw)) {
+        if (!renderExtrusions(parameters, draw)) {
             return;
         }
-
-        parameters.imageManager.bind(parameters.context, 0);
-
-        for (const RenderTile& tile : renderTiles) {
-            assert(dynamic_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl)));
-            FillExtrusionBucket& bucket = *reinterpret_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl));
-
-            parameters.programs.fillExtrusionPattern.get(evaluated).draw(
-                parameters.context,
-                gl::Triangles(),
-                parameters.depthModeForSublayer(0, gl::DepthMode::ReadWrite),
-                gl::StencilMode::disabled(),
-                parameters.colorModeForRenderPass(),
-                FillExtrusionPatternUniforms::values(
-                    tile.translatedClipMatrix(evaluated.get<FillExtrusionTranslate>(),
-                                              evaluated.get<FillExtrusionTranslateAnchor>(),
-                                              parameters.state),
-                    parameters.imageManager.getPixelSize(),
-                    *imagePosA,
-                    *imagePosB,
-                    evaluated.get<FillExtrusionPattern>(),
-                    tile.id,
-                    parameters.state,
-                    -std::pow(2, tile.id.canonical.z) / util::tileSize / 8.0f,
-                    parameters.evaluatedLight
-                ),
-                *bucket.vertexBuffer,
-                *bucket.indexBuffer,
-                bucket.triangleSegments,
-                bucket.paintPropertyBinders.at(getID()),
-                evaluated,
-                parameters.state.getZoom(),
-                getID());
-        }
+        parameters.staticData.extrusionTextureLayer = patterned ? nullptr : this;
+        lastDraw = std::move(draw);
     }
 
     parameters.backend.bind();
@@ -139,7 +128,7 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters, RenderSource*
 
     const Properties<>::PossiblyEvaluated properties;
 
-    parameters.programs.extrusionTexture.draw(
+    parameters.programs.extrusionTexture.get().draw(
         parameters.context,
         gl::Triangles(),
         gl::DepthMode::disabled(),
@@ -155,8 +144,100 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters, RenderSource*
         parameters.staticData.extrusionTextureSegments,
         ExtrusionTextureProgram::PaintPropertyBinders{ properties, 0 },
         properties,
-        parameters.state.getZoom(),
-        getID());
+        parameters.state.getZoom());
+}
+
+bool RenderFillExtrusionLayer::renderExtrusions(PaintParameters& parameters, const ExtrusionDraw& draw) {
+    optional<ImagePosition> imagePosA;
+    optional<ImagePosition> imagePosB;
+    if (!evaluated.get<FillExtrusionPattern>().from.empty()) {
+        imagePosA = parameters.imageManager.getPattern(evaluated.get<FillExtrusionPattern>().from);
+        imagePosB = parameters.imageManager.getPattern(evaluated.get<FillExtrusionPattern>().to);
+
+        if (!imagePosA || !imagePosB) {
+            return false;
+        }
+    }
+
+    parameters.staticData.extrusionTexture->bind();
+
+    parameters.context.setStencilMode(gl::StencilMode::disabled());
+    parameters.context.setDepthMode(parameters.depthModeForSublayer(0, gl::DepthMode::ReadWrite));
+    parameters.context.clear(Color{ 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, {});
+
+    // Roofs and walls share their vertices, and are drawn with the same program and uniforms.
+    auto drawTile = [&] (auto& program, const auto& uniformValues, FillExtrusionBucket& bucket,
+                         const ExtrusionDraw::Tile& tile) {
+        auto drawSegments = [&] (const gl::IndexBuffer<gl::Triangles>& indexBuffer,
+                                 const SegmentVector<FillExtrusionAttributes>& segments) {
+            program.draw(
+                parameters.context,
+                gl::Triangles(),
+                parameters.depthModeForSublayer(0, gl::DepthMode::ReadWrite),
+                gl::StencilMode::disabled(),
+                parameters.colorModeForRenderPass(),
+                uniformValues,
+                *bucket.vertexBuffer,
+                indexBuffer,
+                segments,
+                bucket.paintPropertyBinders.at(getID()),
+                evaluated,
+                parameters.state.getZoom(),
+                tile.segments);
+        };
+        drawSegments(*bucket.indexBuffer, bucket.triangleSegments);
+        drawSegments(*bucket.wallIndexBuffer, bucket.wallSegments);
+        if (tile.smallWalls) {
+            drawSegments(*bucket.smallWallIndexBuffer, bucket.smallWallSegments);
+        }
+    };
+
+    if (!imagePosA) {
+        for (std::size_t i = 0; i < renderTiles.size(); i++) {
+            const RenderTile& tile = renderTiles[i];
+            FillExtrusionBucket& bucket = *reinterpret_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl));
+
+            drawTile(parameters.programs.fillExtrusion.get(evaluated),
+                     FillExtrusionUniforms::values(
+                         draw.tiles[i].matrix,
+                         parameters.state,
+                         parameters.evaluatedLight
+                     ),
+                     bucket, draw.tiles[i]);
+        }
+    } else {
+        parameters.imageManager.bind(parameters.context, 0);
+
+        for (std::size_t i = 0; i < renderTiles.size(); i++) {
+            const RenderTile& tile = renderTiles[i];
+            FillExtrusionBucket& bucket = *reinterpret_cast<FillExtrusionBucket*>(tile.tile.getBucket(*baseImpl));
+
+            drawTile(parameters.programs.fillExtrusionPattern.get(evaluated),
+                     FillExtrusionPatternUniforms::values(
+                         draw.tiles[i].matrix,
+                         parameters.imageManager.getPixelSize(),
+                         *imagePosA,
+                         *imagePosB,
+                         evaluated.get<FillExtrusionPattern>(),
+                         tile.id,
+                         parameters.state,
+                         -std::pow(2, tile.id.canonical.z) / util::tileSize / 8.0f,
+                         parameters.evaluatedLight
+                     ),
+                     bucket, draw.tiles[i]);
+        }
+    }
+
+    return true;
+}
+
+void RenderFillExtrusionLayer::precompilePrograms(Programs& programs) const {
+    if (evaluated.get<FillExtrusionPattern>().from.empty()) {
+        programs.fillExtrusion.get(evaluated);
+    } else {
+        programs.fillExtrusionPattern.get(evaluated);
+    }
+    programs.extrusionTexture.get();
 }
 
 bool RenderFillExtrusionLayer::queryIntersectsFeature(
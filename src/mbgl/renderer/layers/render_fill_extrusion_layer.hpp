@@ -1,6 +1,9 @@
 #pragma once
 
 #include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/render_light.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/size.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer_properties.hpp>
 
@@ -14,7 +17,9 @@ public:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
     void render(PaintParameters&, RenderSource*) override;
+    void precompilePrograms(Programs&) const override;
 
     bool queryIntersectsFeature(
         const GeometryCoordinates&,
@@ -30,6 +35,36 @@ public:
     style::FillExtrusionPaintProperties::PossiblyEvaluated evaluated;
 
     const style::FillExtrusionLayer::Impl& impl() const;
+
+private:
+    struct ExtrusionDraw;
+    // Draws the extrusions into the extrusion texture; returns false if their pattern isn't loaded.
+    bool renderExtrusions(PaintParameters&, const ExtrusionDraw&);
+
+    // Counts evaluations, which change the evaluated paint properties.
+    uint64_t evaluations = 0;
+
+    // What the extrusion texture was drawn with, so that it's only drawn again once the camera
+    // moves or the buildings change. Patterned extrusions are always drawn again.
+    struct ExtrusionDraw {
+        Size size;
+        float zoom;
+        uint64_t evaluations;
+        EvaluatedLight light;
+
+        struct Tile {
+            uint64_t bucketRevision;
+            mat4 matrix;
+            bool smallWalls;
+            std::vector<bool> segments;
+
+            bool operator==(const Tile&) const;
+        };
+        std::vector<Tile> tiles;
+
+        bool operator==(const ExtrusionDraw&) const;
+    };
+    ExtrusionDraw lastDraw;
 };
 
 template <>
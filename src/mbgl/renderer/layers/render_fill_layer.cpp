@@ -3,6 +3,7 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/feature_state.hpp>
 #include <mbgl/programs/programs.hpp>
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/tile/tile.hpp>
@@ -33,7 +34,7 @@ void RenderFillLayer::transition(const TransitionParameters& parameters) {
 }
 
 void RenderFillLayer::evaluate(const PropertyEvaluationParameters& parameters) {
-    evaluated = unevaluated.evaluate(parameters);
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
 
     if (unevaluated.get<style::FillOutlineColor>().isUndefined()) {
         evaluated.get<style::FillOutlineColor>() = evaluated.get<style::FillColor>();
@@ -47,7 +48,8 @@ void RenderFillLayer::evaluate(const PropertyEvaluationParameters& parameters) {
 
     if (!unevaluated.get<style::FillPattern>().isUndefined()
         || evaluated.get<style::FillColor>().constantOr(Color()).a < 1.0f
-        || evaluated.get<style::FillOpacity>().constantOr(0) < 1.0f) {
+        || evaluated.get<style::FillOpacity>().constantOr(0) < 1.0f
+        || (impl().stateColor && impl().stateColor->a < 1.0f)) {
         passes |= RenderPass::Translucent;
     } else {
         passes |= RenderPass::Opaque;
@@ -58,17 +60,46 @@ bool RenderFillLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderFillLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent();
+}
+
+std::size_t RenderFillLayer::opaqueProgramKey() const {
+    // Fills with the same data-driven properties share a variant of the fill program.
+    return RenderLayer::opaqueProgramKey() |
+        FillProgram::PaintPropertyBinders::constants(evaluated).to_ulong();
+}
+
 void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
     if (evaluated.get<FillPattern>().from.empty()) {
+        const optional<Color>& stateColor = impl().stateColor;
+        const FeatureStates* states = stateColor && parameters.featureStates
+            ? parameters.featureStates->find(impl().source, impl().sourceLayer)
+            : nullptr;
+
         for (const RenderTile& tile : renderTiles) {
             assert(dynamic_cast<FillBucket*>(tile.tile.getBucket(*baseImpl)));
             FillBucket& bucket = *reinterpret_cast<FillBucket*>(tile.tile.getBucket(*baseImpl));
 
+            // Without a state color, the states of the features aren't drawn, and aren't uploaded.
+            FeatureStateAttributes::Bindings stateBindings;
+            if (stateColor) {
+                bucket.featureState.update(parameters.context, states, bucket.vertexBuffer->vertexCount);
+                stateBindings = bucket.featureState.attributeBindings();
+            }
+
+            // Segments whose polygons are off-screen are culled, with room for their outlines.
+            const mat4 clipMatrix = tile.translatedClipMatrix(evaluated.get<FillTranslate>(),
+                                                              evaluated.get<FillTranslateAnchor>(),
+                                                              parameters.state);
+            const double padding = tile.id.pixelsToTileUnits(2, parameters.state.getZoom());
+
             auto draw = [&] (uint8_t sublayer,
                              auto& program,
                              const auto& drawMode,
                              const auto& indexBuffer,
-                             const auto& segments) {
+                             const auto& segments,
+                             const std::vector<SegmentBounds>& segmentBounds) {
                 program.get(evaluated).draw(
                     parameters.context,
                     drawMode,
@@ -82,6 +113,7 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                                                   parameters.state)
                         },
                         uniforms::u_world::Value{ parameters.context.viewport.getCurrentValue().size },
+                        uniforms::u_state_color::Value{ stateColor.value_or(Color()) },
                     },
                     *bucket.vertexBuffer,
                     indexBuffer,
@@ -89,7 +121,8 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                     bucket.paintPropertyBinders.at(getID()),
                     evaluated,
                     parameters.state.getZoom(),
-                    getID()
+                    visibleSegments(clipMatrix, segmentBounds, padding),
+                    stateBindings
                 );
             };
 
@@ -98,18 +131,21 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                      parameters.programs.fillOutline,
                      gl::Lines { 2.0f },
                      *bucket.lineIndexBuffer,
-                     bucket.lineSegments);
+                     bucket.lineSegments,
+                     bucket.lineSegmentBounds);
             }
 
             // Only draw the fill when it's opaque and we're drawing opaque fragments,
             // or when it's translucent and we're drawing translucent fragments.
             if ((evaluated.get<FillColor>().constantOr(Color()).a >= 1.0f
-              && evaluated.get<FillOpacity>().constantOr(0) >= 1.0f) == (parameters.pass == RenderPass::Opaque)) {
+              && evaluated.get<FillOpacity>().constantOr(0) >= 1.0f
+              && (!stateColor || stateColor->a >= 1.0f)) == (parameters.pass == RenderPass::Opaque)) {
                 draw(1,
                      parameters.programs.fill,
                      gl::Triangles(),
                      *bucket.triangleIndexBuffer,
-                     bucket.triangleSegments);
+                     bucket.triangleSegments,
+                     bucket.triangleSegmentBounds);
             }
 
             if (evaluated.get<FillAntialias>() && unevaluated.get<FillOutlineColor>().isUndefined() && parameters.pass == RenderPass::Translucent) {
@@ -117,7 +153,8 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                      parameters.programs.fillOutline,
                      gl::Lines { 2.0f },
                      *bucket.lineIndexBuffer,
-                     bucket.lineSegments);
+                     bucket.lineSegments,
+                     bucket.lineSegmentBounds);
             }
         }
     } else {
@@ -138,11 +175,18 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
             assert(dynamic_cast<FillBucket*>(tile.tile.getBucket(*baseImpl)));
             FillBucket& bucket = *reinterpret_cast<FillBucket*>(tile.tile.getBucket(*baseImpl));
 
+            // Segments whose polygons are off-screen are culled, with room for their outlines.
+            const mat4 clipMatrix = tile.translatedClipMatrix(evaluated.get<FillTranslate>(),
+                                                              evaluated.get<FillTranslateAnchor>(),
+                                                              parameters.state);
+            const double padding = tile.id.pixelsToTileUnits(2, parameters.state.getZoom());
+
             auto draw = [&] (uint8_t sublayer,
                              auto& program,
                              const auto& drawMode,
                              const auto& indexBuffer,
-                             const auto& segments) {
+                             const auto& segments,
+                             const std::vector<SegmentBounds>& segmentBounds) {
                 program.get(evaluated).draw(
                     parameters.context,
                     drawMode,
@@ -167,7 +211,7 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                     bucket.paintPropertyBinders.at(getID()),
                     evaluated,
                     parameters.state.getZoom(),
-                    getID()
+                    visibleSegments(clipMatrix, segmentBounds, padding)
                 );
             };
 
@@ -175,7 +219,8 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                  parameters.programs.fillPattern,
                  gl::Triangles(),
                  *bucket.triangleIndexBuffer,
-                 bucket.triangleSegments);
+                 bucket.triangleSegments,
+                 bucket.triangleSegmentBounds);
 
             if (!evaluated.get<FillAntialias>() || !unevaluated.get<FillOutlineColor>().isUndefined()) {
                 continue;
@@ -185,7 +230,22 @@ void RenderFillLayer::render(PaintParameters& parameters, RenderSource*) {
                  parameters.programs.fillOutlinePattern,
                  gl::Lines { 2.0f },
                  *bucket.lineIndexBuffer,
-                 bucket.lineSegments);
+                 bucket.lineSegments,
+                 bucket.lineSegmentBounds);
+        }
+    }
+}
+
+void RenderFillLayer::precompilePrograms(Programs& programs) const {
+    if (evaluated.get<FillPattern>().from.empty()) {
+        programs.fill.get(evaluated);
+        if (evaluated.get<FillAntialias>()) {
+            programs.fillOutline.get(evaluated);
+        }
+    } else {
+        programs.fillPattern.get(evaluated);
+        if (evaluated.get<FillAntialias>()) {
+            programs.fillOutlinePattern.get(evaluated);
         }
     }
 }
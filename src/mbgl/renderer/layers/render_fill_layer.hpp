@@ -14,7 +14,10 @@ public:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
     void render(PaintParameters&, RenderSource*) override;
+    std::size_t opaqueProgramKey() const override;
+    void precompilePrograms(Programs&) const override;
 
     bool queryIntersectsFeature(
             const GeometryCoordinates&,
@@ -12,6 +12,9 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/intersection_tests.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -52,6 +55,26 @@ bool RenderLineLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderLineLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent();
+}
+
+namespace {
+
+// The largest magnitude of a property among the lines of the bucket.
+template <class Property>
+float maxValue(const RenderLineLayer& layer, const LineBucket& bucket) {
+    auto it = bucket.paintPropertyBinders.find(layer.getID());
+    if (it == bucket.paintPropertyBinders.end() || !it->second.statistics<Property>().max()) {
+        return std::abs(layer.evaluated.get<Property>().constantOr(Property::defaultValue()));
+    } else {
+        return std::max(std::abs(*it->second.statistics<Property>().min()),
+                        std::abs(*it->second.statistics<Property>().max()));
+    }
+}
+
+} // namespace
+
 void RenderLineLayer::render(PaintParameters& parameters, RenderSource*) {
     if (parameters.pass == RenderPass::Opaque) {
         return;
@@ -61,6 +84,20 @@ void RenderLineLayer::render(PaintParameters& parameters, RenderSource*) {
         assert(dynamic_cast<LineBucket*>(tile.tile.getBucket(*baseImpl)));
         LineBucket& bucket = *reinterpret_cast<LineBucket*>(tile.tile.getBucket(*baseImpl));
 
+        // Segments whose lines are off-screen are culled. Lines reach out from their geometry by
+        // half their width, or past their gap, and by their offset; joins by as much again as the
+        // miter limit allows.
+        const float gapWidth = maxValue<LineGapWidth>(*this, bucket);
+        const float halfWidth = gapWidth ? gapWidth / 2 + maxValue<LineWidth>(*this, bucket)
+                                         : maxValue<LineWidth>(*this, bucket) / 2;
+        const float reach = (halfWidth + maxValue<LineOffset>(*this, bucket)) *
+                                std::max(2.0f, bucket.layout.get<LineMiterLimit>()) +
+                            maxValue<LineBlur>(*this, bucket) + 1;
+        const std::vector<bool> drawnSegments = visibleSegments(
+            tile.translatedClipMatrix(evaluated.get<LineTranslate>(), evaluated.get<LineTranslateAnchor>(), parameters.state),
+            bucket.segmentBounds,
+            tile.id.pixelsToTileUnits(reach, parameters.state.getZoom()));
+
         auto draw = [&] (auto& program, auto&& uniformValues) {
             program.get(evaluated).draw(
                 parameters.context,
@@ -75,7 +112,7 @@ void RenderLineLayer::render(PaintParameters& parameters, RenderSource*) {
                 bucket.paintPropertyBinders.at(getID()),
                 evaluated,
                 parameters.state.getZoom(),
-                getID()
+                drawnSegments
             );
         };
 
@@ -128,6 +165,16 @@ void RenderLineLayer::render(PaintParameters& parameters, RenderSource*) {
     }
 }
 
+void RenderLineLayer::precompilePrograms(Programs& programs) const {
+    if (!evaluated.get<LineDasharray>().from.empty()) {
+        programs.lineSDF.get(evaluated);
+    } else if (!evaluated.get<LinePattern>().from.empty()) {
+        programs.linePattern.get(evaluated);
+    } else {
+        programs.line.get(evaluated);
+    }
+}
+
 optional<GeometryCollection> offsetLine(const GeometryCollection& rings, const double offset) {
     if (offset == 0) return {};
 
@@ -23,7 +23,9 @@ public:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
     void render(PaintParameters&, RenderSource*) override;
+    void precompilePrograms(Programs&) const override;
 
     bool queryIntersectsFeature(
             const GeometryCoordinates&,
@@ -6,6 +6,7 @@
 #include <mbgl/renderer/render_static_data.hpp>
 #include <mbgl/programs/programs.hpp>
 #include <mbgl/programs/raster_program.hpp>
+#include <mbgl/programs/hillshade_program.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/style/layers/raster_layer_impl.hpp>
 
@@ -32,7 +33,7 @@ void RenderRasterLayer::transition(const TransitionParameters& parameters) {
 }
 
 void RenderRasterLayer::evaluate(const PropertyEvaluationParameters& parameters) {
-    evaluated = unevaluated.evaluate(parameters);
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
 
     passes = evaluated.get<style::RasterOpacity>() > 0 ? RenderPass::Translucent : RenderPass::None;
 }
@@ -41,6 +42,10 @@ bool RenderRasterLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderRasterLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent();
+}
+
 static float saturationFactor(float saturation) {
     if (saturation > 0) {
         return 1 - 1 / (1.001 - saturation);
@@ -69,15 +74,52 @@ static std::array<float, 3> spinWeights(float spin) {
     return spin_weights;
 }
 
+// Light comes from the top left of the viewport, at 45° above the horizon.
+static std::array<float, 3> lightDirection(const TransformState& state) {
+    const float azimuth = 335 * util::DEG2RAD - state.getAngle();
+    const float altitude = 45 * util::DEG2RAD;
+    return {{
+        std::cos(altitude) * std::sin(azimuth),
+        -std::cos(altitude) * std::cos(azimuth),
+        std::sin(altitude)
+    }};
+}
+
 void RenderRasterLayer::render(PaintParameters& parameters, RenderSource* source) {
     if (parameters.pass != RenderPass::Translucent)
         return;
 
+    const Properties<>::PossiblyEvaluated hillshadeProperties;
+    auto drawHillshade = [&] (const mat4& matrix,
+                              const auto& vertexBuffer,
+                              const auto& indexBuffer,
+                              const auto& segments) {
+        parameters.programs.hillshade.get().draw(
+            parameters.context,
+            gl::Triangles(),
+            parameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+            gl::StencilMode::disabled(),
+            parameters.colorModeForRenderPass(),
+            HillshadeProgram::UniformValues {
+                uniforms::u_matrix::Value{ matrix },
+                uniforms::u_image::Value{ 0 },
+                uniforms::u_light_direction::Value{ lightDirection(parameters.state) },
+                uniforms::u_opacity::Value{ evaluated.get<RasterOpacity>() },
+            },
+            vertexBuffer,
+            indexBuffer,
+            segments,
+            HillshadeProgram::PaintPropertyBinders { hillshadeProperties, 0 },
+            hillshadeProperties,
+            parameters.state.getZoom()
+        );
+    };
+
     auto draw = [&] (const mat4& matrix,
                      const auto& vertexBuffer,
                      const auto& indexBuffer,
                      const auto& segments) {
-        parameters.programs.raster.draw(
+        parameters.programs.raster.get().draw(
             parameters.context,
             gl::Triangles(),
             parameters.depthModeForSublayer(0, gl::DepthMode::ReadOnly),
@@ -103,8 +145,7 @@ void RenderRasterLayer::render(PaintParameters& parameters, RenderSource* source
             segments,
             RasterProgram::PaintPropertyBinders { evaluated, 0 },
             evaluated,
-            parameters.state.getZoom(),
-            getID()
+            parameters.state.getZoom()
         );
     };
 
@@ -112,9 +153,9 @@ void RenderRasterLayer::render(PaintParameters& parameters, RenderSource* source
         if (imageSource->isEnabled() && imageSource->isLoaded() && !imageSource->bucket->needsUpload()) {
             RasterBucket& bucket = *imageSource->bucket;
 
-            assert(bucket.texture);
-            parameters.context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear);
-            parameters.context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear);
+            gl::Texture& texture = bucket.getTexture();
+            parameters.context.bindTexture(texture, 0, gl::TextureFilter::Linear);
+            parameters.context.bindTexture(texture, 1, gl::TextureFilter::Linear);
 
             for (auto matrix_ : imageSource->matrices) {
                 draw(matrix_,
@@ -132,15 +173,33 @@ void RenderRasterLayer::render(PaintParameters& parameters, RenderSource* source
                 continue;
 
             assert(bucket.texture);
-            parameters.context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear);
-            parameters.context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear);
+            if (bucket.dem) {
+                // Elevation tiles are shaded from the slopes in their texture.
+                parameters.context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear);
+                if (bucket.maskGeometry) {
+                    drawHillshade(tile.matrix,
+                                  *bucket.maskGeometry->vertexBuffer,
+                                  *bucket.maskGeometry->indexBuffer,
+                                  bucket.maskGeometry->segments);
+                } else {
+                    drawHillshade(tile.matrix,
+                                  parameters.staticData.rasterVertexBuffer,
+                                  parameters.staticData.quadTriangleIndexBuffer,
+                                  parameters.staticData.rasterSegments);
+                }
+                continue;
+            }
+
+            const gl::TextureMipMap mipmap = bucket.mipmapped ? gl::TextureMipMap::Yes : gl::TextureMipMap::No;
+            parameters.context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear, mipmap);
+            parameters.context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear, mipmap);
 
-            if (bucket.vertexBuffer && bucket.indexBuffer && !bucket.segments.empty()) {
+            if (bucket.maskGeometry) {
                 // Draw only the parts of the tile that aren't drawn by another tile in the layer.
                 draw(tile.matrix,
-                     *bucket.vertexBuffer,
-                     *bucket.indexBuffer,
-                     bucket.segments);
+                     *bucket.maskGeometry->vertexBuffer,
+                     *bucket.maskGeometry->indexBuffer,
+                     bucket.maskGeometry->segments);
             } else {
                 // Draw the full tile.
                 draw(tile.matrix,
@@ -41,12 +41,14 @@ std::unique_ptr<SymbolLayout> RenderSymbolLayer::createLayout(const BucketParame
                                                               const std::vector<const RenderLayer*>& group,
                                                               std::unique_ptr<GeometryTileLayer> layer,
                                                               GlyphDependencies& glyphDependencies,
-                                                              ImageDependencies& imageDependencies) const {
+                                                              ImageDependencies& imageDependencies,
+                                                              FeatureIndex& featureIndex) const {
     return std::make_unique<SymbolLayout>(parameters,
                                           group,
                                           std::move(layer),
                                           imageDependencies,
-                                          glyphDependencies);
+                                          glyphDependencies,
+                                          featureIndex);
 }
 
 void RenderSymbolLayer::transition(const TransitionParameters& parameters) {
@@ -54,7 +56,7 @@ void RenderSymbolLayer::transition(const TransitionParameters& parameters) {
 }
 
 void RenderSymbolLayer::evaluate(const PropertyEvaluationParameters& parameters) {
-    evaluated = unevaluated.evaluate(parameters);
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
 
     auto hasIconOpacity = evaluated.get<style::IconColor>().constantOr(Color::black()).a > 0 ||
                           evaluated.get<style::IconHaloColor>().constantOr(Color::black()).a > 0;
@@ -70,6 +72,10 @@ bool RenderSymbolLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderSymbolLayer::isZoomDependent() const {
+    return unevaluated.isZoomDependent();
+}
+
 void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
     if (parameters.pass == RenderPass::Opaque) {
         return;
@@ -112,14 +118,10 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                 buffers.segments,
                 binders,
                 paintProperties,
-                parameters.state.getZoom(),
-                getID()
+                parameters.state.getZoom()
             );
         };
 
-        assert(dynamic_cast<GeometryTile*>(&tile.tile));
-        GeometryTile& geometryTile = static_cast<GeometryTile&>(tile.tile);
-
         if (bucket.hasIconData()) {
             auto values = iconPropertyValues(layout);
             auto paintPropertyValues = iconPaintProperties();
@@ -128,26 +130,41 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                 layout.get<IconRotationAlignment>() == AlignmentType::Map;
 
             if (alongLine) {
-                reprojectLineLabels(bucket.icon.dynamicVertices,
-                                    bucket.icon.placedSymbols,
-                                    tile.matrix,
-                                    values,
-                                    tile,
-                                    *bucket.iconSizeBinder,
-                                    parameters.state,
-                                    parameters.frameHistory);
-
+                // While the camera, the placement and the fading hold still, so do the labels,
+                // also for the other layers drawing this bucket.
+                const LineLabelCamera camera = getLineLabelCamera(tile.matrix, parameters.state);
+                if (bucket.dynamicVerticesOutdated || !parameters.frameHistory.isSettled() ||
+                    bucket.icon.projectedCamera != camera) {
+                    reprojectLineLabels(bucket.icon.dynamicVertices,
+                                        bucket.icon.placedSymbols,
+                                        tile.matrix,
+                                        values,
+                                        tile,
+                                        *bucket.iconSizeBinder,
+                                        parameters.state,
+                                        parameters.frameHistory);
+
+                    parameters.context.updateVertexBuffer(*bucket.icon.dynamicVertexBuffer, std::move(bucket.icon.dynamicVertices));
+                    bucket.icon.projectedCamera = camera;
+                }
+            } else if (bucket.dynamicVerticesOutdated) {
+                updateAnchoredLabels(bucket.icon.dynamicVertices, bucket.icon.placedSymbols);
                 parameters.context.updateVertexBuffer(*bucket.icon.dynamicVertexBuffer, std::move(bucket.icon.dynamicVertices));
             }
 
             const bool iconScaled = layout.get<IconSize>().constantOr(1.0) != 1.0 || bucket.iconsNeedLinear;
             const bool iconTransformed = values.rotationAlignment == AlignmentType::Map || parameters.state.getPitch() != 0;
 
-            parameters.context.bindTexture(*geometryTile.iconAtlasTexture, 0,
-                bucket.sdfIcons || parameters.state.isChanging() || iconScaled || iconTransformed
-                    ? gl::TextureFilter::Linear : gl::TextureFilter::Nearest);
+            if (bucket.sdfIcons) {
+                parameters.imageManager.bindSDF(parameters.context, 0);
+            } else {
+                parameters.imageManager.bind(parameters.context, 0,
+                    parameters.state.isChanging() || iconScaled || iconTransformed
+                        ? gl::TextureFilter::Linear : gl::TextureFilter::Nearest);
+            }
 
-            const Size texsize = geometryTile.iconAtlasTexture->size;
+            const Size texsize = bucket.sdfIcons ? parameters.imageManager.getSDFPixelSize()
+                                                 : parameters.imageManager.getPixelSize();
 
             if (bucket.sdfIcons) {
                 if (values.hasHalo) {
@@ -181,7 +198,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
         }
 
         if (bucket.hasTextData()) {
-            parameters.context.bindTexture(*geometryTile.glyphAtlasTexture, 0, gl::TextureFilter::Linear);
+            parameters.glyphAtlas.bind(parameters.context, 0);
 
             auto values = textPropertyValues(layout);
             auto paintPropertyValues = textPaintProperties();
@@ -190,19 +207,29 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                 layout.get<TextRotationAlignment>() == AlignmentType::Map;
 
             if (alongLine) {
-                reprojectLineLabels(bucket.text.dynamicVertices,
-                                    bucket.text.placedSymbols,
-                                    tile.matrix,
-                                    values,
-                                    tile,
-                                    *bucket.textSizeBinder,
-                                    parameters.state,
-                                    parameters.frameHistory);
-
+                // While the camera, the placement and the fading hold still, so do the labels,
+                // also for the other layers drawing this bucket.
+                const LineLabelCamera camera = getLineLabelCamera(tile.matrix, parameters.state);
+                if (bucket.dynamicVerticesOutdated || !parameters.frameHistory.isSettled() ||
+                    bucket.text.projectedCamera != camera) {
+                    reprojectLineLabels(bucket.text.dynamicVertices,
+                                        bucket.text.placedSymbols,
+                                        tile.matrix,
+                                        values,
+                                        tile,
+                                        *bucket.textSizeBinder,
+                                        parameters.state,
+                                        parameters.frameHistory);
+
+                    parameters.context.updateVertexBuffer(*bucket.text.dynamicVertexBuffer, std::move(bucket.text.dynamicVertices));
+                    bucket.text.projectedCamera = camera;
+                }
+            } else if (bucket.dynamicVerticesOutdated) {
+                updateAnchoredLabels(bucket.text.dynamicVertices, bucket.text.placedSymbols);
                 parameters.context.updateVertexBuffer(*bucket.text.dynamicVertexBuffer, std::move(bucket.text.dynamicVertices));
             }
 
-            const Size texsize = geometryTile.glyphAtlasTexture->size;
+            const Size texsize = parameters.glyphAtlas.getPixelSize();
 
             if (values.hasHalo) {
                 draw(parameters.programs.symbolGlyph,
@@ -225,11 +252,13 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
             }
         }
 
+        bucket.dynamicVerticesOutdated = false;
+
         if (bucket.hasCollisionBoxData()) {
             static const style::Properties<>::PossiblyEvaluated properties {};
             static const CollisionBoxProgram::PaintPropertyBinders paintAttributeData(properties, 0);
 
-            parameters.programs.collisionBox.draw(
+            parameters.programs.collisionBox.get().draw(
                 parameters.context,
                 gl::Lines { 1.0f },
                 gl::DepthMode::disabled(),
@@ -250,13 +279,26 @@ void RenderSymbolLayer::render(PaintParameters& parameters, RenderSource*) {
                 bucket.collisionBox.segments,
                 paintAttributeData,
                 properties,
-                parameters.state.getZoom(),
-                getID()
+                parameters.state.getZoom()
             );
         }
     }
 }
 
+void RenderSymbolLayer::precompilePrograms(Programs& programs) const {
+    // Whether a bucket's icons are SDFs depends on its images, so both icon programs are
+    // prepared.
+    if (!impl().layout.get<IconImage>().isUndefined()) {
+        const auto iconProperties = iconPaintProperties();
+        programs.symbolIcon.get(iconProperties);
+        programs.symbolIconSDF.get(iconProperties);
+    }
+
+    if (!impl().layout.get<TextField>().isUndefined()) {
+        programs.symbolGlyph.get(textPaintProperties());
+    }
+}
+
 style::IconPaintProperties::PossiblyEvaluated RenderSymbolLayer::iconPaintProperties() const {
     return style::IconPaintProperties::PossiblyEvaluated {
             evaluated.get<style::IconOpacity>(),
@@ -57,6 +57,7 @@ public:
 class BucketParameters;
 class SymbolLayout;
 class GeometryTileLayer;
+class FeatureIndex;
 
 class RenderSymbolLayer: public RenderLayer {
 public:
@@ -66,7 +67,9 @@ public:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomDependent() const override;
     void render(PaintParameters&, RenderSource*) override;
+    void precompilePrograms(Programs&) const override;
 
     style::IconPaintProperties::PossiblyEvaluated iconPaintProperties() const;
     style::TextPaintProperties::PossiblyEvaluated textPaintProperties() const;
@@ -79,7 +82,8 @@ public:
                                                const std::vector<const RenderLayer*>&,
                                                std::unique_ptr<GeometryTileLayer>,
                                                GlyphDependencies&,
-                                               ImageDependencies&) const;
+                                               ImageDependencies&,
+                                               FeatureIndex&) const;
 
     // Paint properties
     style::SymbolPaintProperties::Unevaluated unevaluated;
@@ -2,6 +2,7 @@
 #include <mbgl/renderer/update_parameters.hpp>
 #include <mbgl/renderer/render_style.hpp>
 #include <mbgl/renderer/render_static_data.hpp>
+#include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/map/transform_state.hpp>
 
 namespace mbgl {
@@ -21,6 +22,7 @@ PaintParameters::PaintParameters(gl::Context& context_,
     staticData(staticData_),
     frameHistory(frameHistory_),
     imageManager(*style.imageManager),
+    glyphAtlas(style.glyphManager->getAtlas()),
     lineAtlas(*style.lineAtlas),
     mapMode(updateParameters.mode),
     debugOptions(updateParameters.debugOptions),
@@ -50,8 +52,7 @@ PaintParameters::PaintParameters(gl::Context& context_,
 
 mat4 PaintParameters::matrixForTile(const UnwrappedTileID& tileID) {
     mat4 matrix;
-    state.matrixFor(matrix, tileID);
-    matrix::multiply(matrix, projMatrix, matrix);
+    state.matrixFor(matrix, tileID, projMatrix);
     return matrix;
 }
 
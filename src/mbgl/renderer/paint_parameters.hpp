@@ -21,8 +21,10 @@ class FrameHistory;
 class Programs;
 class TransformState;
 class ImageManager;
+class GlyphAtlas;
 class LineAtlas;
 class UnwrappedTileID;
+class FeatureStateStore;
 
 class PaintParameters {
 public:
@@ -44,6 +46,7 @@ public:
     RenderStaticData& staticData;
     FrameHistory& frameHistory;
     ImageManager& imageManager;
+    GlyphAtlas& glyphAtlas;
     LineAtlas& lineAtlas;
 
     RenderPass pass = RenderPass::Opaque;
@@ -54,6 +57,11 @@ public:
 
     float pixelRatio;
     std::array<float, 2> pixelsToGLUnits;
+    // Fill-extrusion layers leave out the walls of small buildings below this size on screen, in
+    // pixels.
+    float extrusionWallThreshold = 0;
+    // The states of features that layers mix their state colors into, if any.
+    const FeatureStateStore* featureStates = nullptr;
     algorithm::ClipIDGenerator clipIDGenerator;
 
     Programs& programs;
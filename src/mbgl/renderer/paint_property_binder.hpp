@@ -26,22 +26,23 @@ inline std::array<float, 1> attributeValue(float v) {
 }
 
 /*
-    Encode a four-component color value into a pair of floats.  Since csscolorparser
-    uses 8-bit precision for each color component, for each float we use the upper 8
+    Encode a four-component color value into a pair of values.  Since csscolorparser
+    uses 8-bit precision for each color component, for each value we use the upper 8
     bits for one component (e.g. (color.r * 255) * 256), and the lower 8 for another.
+    The shaders read them as floats.
     
     Also note that colors come in as floats 0..1, so we scale by 255.
 */
-inline std::array<float, 2> attributeValue(const Color& color) {
+inline std::array<uint16_t, 2> attributeValue(const Color& color) {
     return {{
-        static_cast<float>(mbgl::attributes::packUint8Pair(255 * color.r, 255 * color.g)),
-        static_cast<float>(mbgl::attributes::packUint8Pair(255 * color.b, 255 * color.a))
+        mbgl::attributes::packUint8Pair(255 * color.r, 255 * color.g),
+        mbgl::attributes::packUint8Pair(255 * color.b, 255 * color.a)
     }};
 }
 
-template <size_t N>
-std::array<float, N*2> zoomInterpolatedAttributeValue(const std::array<float, N>& min, const std::array<float, N>& max) {
-    std::array<float, N*2> result;
+template <class T, size_t N>
+std::array<T, N*2> zoomInterpolatedAttributeValue(const std::array<T, N>& min, const std::array<T, N>& max) {
+    std::array<T, N*2> result;
     for (size_t i = 0; i < N; i++) {
         result[i]   = min[i];
         result[i+N] = max[i];
@@ -86,6 +87,13 @@ public:
     virtual float interpolationFactor(float currentZoom) const = 0;
     virtual T uniformValue(const PossiblyEvaluatedPropertyValue<T>& currentValue) const = 0;
 
+    // Returns true if the binder's attribute data is the one `value` would produce, so that the
+    // binder can serve it as well.
+    virtual bool binds(const PossiblyEvaluatedPropertyValue<T>& value) const = 0;
+
+    // Returns true if the binder has no attribute data: the value is passed as a uniform.
+    virtual bool isConstant() const = 0;
+
     static std::unique_ptr<PaintPropertyBinder> create(const PossiblyEvaluatedPropertyValue<T>& value, float zoom, T defaultValue);
 
     PaintPropertyStatistics<T> statistics;
@@ -116,6 +124,15 @@ public:
         return currentValue.constantOr(constant);
     }
 
+    bool binds(const PossiblyEvaluatedPropertyValue<T>&) const override {
+        // There's no attribute data worth sharing.
+        return false;
+    }
+
+    bool isConstant() const override {
+        return true;
+    }
+
 private:
     T constant;
 };
@@ -169,6 +186,21 @@ public:
         }
     }
 
+    bool binds(const PossiblyEvaluatedPropertyValue<T>& value) const override {
+        return value.match(
+            [&] (const style::SourceFunction<T>& other) {
+                return other == function && other.useIntegerZoom == function.useIntegerZoom;
+            },
+            [&] (const auto&) {
+                return false;
+            }
+        );
+    }
+
+    bool isConstant() const override {
+        return false;
+    }
+
 private:
     style::SourceFunction<T> function;
     T defaultValue;
@@ -234,6 +266,21 @@ public:
         }
     }
 
+    bool binds(const PossiblyEvaluatedPropertyValue<T>& value) const override {
+        return value.match(
+            [&] (const style::CompositeFunction<T>& other) {
+                return other == function && other.useIntegerZoom == function.useIntegerZoom;
+            },
+            [&] (const auto&) {
+                return false;
+            }
+        );
+    }
+
+    bool isConstant() const override {
+        return false;
+    }
+
 private:
     style::CompositeFunction<T> function;
     T defaultValue;
@@ -284,7 +331,7 @@ public:
 
     using Binders = IndexedTuple<
         TypeList<Ps...>,
-        TypeList<std::unique_ptr<Binder<Ps>>...>>;
+        TypeList<std::shared_ptr<Binder<Ps>>...>>;
 
     template <class EvaluatedProperties>
     PaintPropertyBinders(const EvaluatedProperties& properties, float z)
@@ -295,16 +342,38 @@ public:
     PaintPropertyBinders(PaintPropertyBinders&&) = default;
     PaintPropertyBinders(const PaintPropertyBinders&) = delete;
 
+    // Takes over the binders of `other` for the properties that `properties` binds to the same
+    // function, so that layers of a bucket which use the same function share its vertex buffer.
+    // Binders taken over this way are populated and uploaded by `other`, which must outlive them
+    // in the bucket, and not by this object.
+    template <class EvaluatedProperties>
+    void share(const EvaluatedProperties& properties, const PaintPropertyBinders& other) {
+        util::ignore({
+            (shareBinder<Ps>(properties.template get<Ps>(), other), 0)...
+        });
+    }
+
     void populateVertexVectors(const GeometryTileFeature& feature, std::size_t length) {
         util::ignore({
-            (binders.template get<Ps>()->populateVertexVector(feature, length), 0)...
+            (shared.test(TypeIndex<Ps, Ps...>::value) ? 0
+                : (binders.template get<Ps>()->populateVertexVector(feature, length), 0))...
         });
     }
 
     void upload(gl::Context& context) {
         util::ignore({
-            (binders.template get<Ps>()->upload(context), 0)...
+            (shared.test(TypeIndex<Ps, Ps...>::value) ? 0
+                : (binders.template get<Ps>()->upload(context), 0))...
+        });
+    }
+
+    // Returns true if none of the binders has attribute data.
+    bool isConstant() const {
+        bool result = true;
+        util::ignore({
+            (result = result && binders.template get<Ps>()->isConstant(), 0)...
         });
+        return result;
     }
 
     template <class P>
@@ -366,7 +435,19 @@ public:
     }
 
 private:
+    template <class P>
+    void shareBinder(const PossiblyEvaluatedPropertyValue<typename P::Type>& value, const PaintPropertyBinders& other) {
+        const std::size_t index = TypeIndex<P, Ps...>::value;
+        if (!shared.test(index) && other.binders.template get<P>()->binds(value)) {
+            binders.template get<P>() = other.binders.template get<P>();
+            shared.set(index);
+        }
+    }
+
     Binders binders;
+
+    // The properties whose binders are populated and uploaded by another object.
+    Bitset shared;
 };
 
 } // namespace mbgl
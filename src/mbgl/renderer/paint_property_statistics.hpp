@@ -7,6 +7,7 @@ namespace mbgl {
 template <class T>
 class PaintPropertyStatistics {
 public:
+    optional<T> min() const { return {}; }
     optional<T> max() const { return {}; }
     void add(const T&) {}
 };
@@ -14,15 +15,21 @@ public:
 template <>
 class PaintPropertyStatistics<float> {
 public:
+    optional<float> min() const {
+        return _min;
+    }
+
     optional<float> max() const {
         return _max;
     }
 
     void add(float value) {
+        _min = _min ? std::min(*_min, value) : value;
         _max = _max ? std::max(*_max, value) : value;
     }
 
 private:
+    optional<float> _min;
     optional<float> _max;
 };
 
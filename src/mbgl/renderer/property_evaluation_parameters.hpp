@@ -29,6 +29,10 @@ public:
     ZoomHistory zoomHistory;
     Duration defaultFadeDuration;
     bool useIntegerZoom;
+
+    // Set when nothing but transitions changed since the properties were last evaluated, so that
+    // only the properties that have a transition need evaluating again.
+    bool transitionsOnly = false;
 };
 
 } // namespace mbgl
@@ -9,6 +9,8 @@
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
 
 namespace mbgl {
 
@@ -39,6 +41,24 @@ std::unique_ptr<RenderLayer> RenderLayer::create(Immutable<Layer::Impl> impl) {
     return nullptr;
 }
 
+std::vector<std::unique_ptr<RenderLayer>> RenderLayer::createForLayout(const std::vector<Immutable<Layer::Impl>>& layers, float zoom) {
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers;
+    renderLayers.reserve(layers.size());
+    for (auto& layer : layers) {
+        renderLayers.push_back(RenderLayer::create(layer));
+
+        renderLayers.back()->transition(TransitionParameters {
+            Clock::time_point::max(),
+            TransitionOptions()
+        });
+
+        renderLayers.back()->evaluate(PropertyEvaluationParameters {
+            zoom
+        });
+    }
+    return renderLayers;
+}
+
 RenderLayer::RenderLayer(style::LayerType type_, Immutable<style::Layer::Impl> baseImpl_)
         : type(type_),
           baseImpl(baseImpl_) {
@@ -56,6 +76,11 @@ bool RenderLayer::hasRenderPass(RenderPass pass) const {
     return bool(passes & pass);
 }
 
+std::size_t RenderLayer::opaqueProgramKey() const {
+    // Layers of different types never share programs.
+    return static_cast<std::size_t>(type) << 8;
+}
+
 bool RenderLayer::needsRendering(float zoom) const {
     return passes != RenderPass::None
            && baseImpl->visibility != style::VisibilityType::None
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 
@@ -17,6 +18,7 @@ class PropertyEvaluationParameters;
 class PaintParameters;
 class RenderSource;
 class RenderTile;
+class Programs;
 
 class RenderLayer {
 protected:
@@ -27,6 +29,10 @@ protected:
 public:
     static std::unique_ptr<RenderLayer> create(Immutable<style::Layer::Impl>);
 
+    // Creates render layers for laying out tiles of zoom level `zoom`, with their paint properties
+    // evaluated at that zoom level and no transitions.
+    static std::vector<std::unique_ptr<RenderLayer>> createForLayout(const std::vector<Immutable<style::Layer::Impl>>&, float zoom);
+
     virtual ~RenderLayer() = default;
 
     // Begin transitions for any properties that have changed since the last frame.
@@ -38,6 +44,9 @@ public:
     // Returns true if any paint properties have active transitions.
     virtual bool hasTransition() const = 0;
 
+    // Returns true if the evaluated paint properties change with the zoom level.
+    virtual bool isZoomDependent() const = 0;
+
     // Check whether this layer is of the given subtype.
     template <class T>
     bool is() const;
@@ -61,8 +70,19 @@ public:
     // Checks whether this layer can be rendered.
     bool needsRendering(float zoom) const;
 
+    // Called during the upload pass of the frames the layer is rendered in, before anything is drawn.
+    virtual void upload(PaintParameters&) {}
+
     virtual void render(PaintParameters&, RenderSource*) = 0;
 
+    // Identifies the program the layer draws with in the opaque pass. The renderer draws opaque
+    // layers with the same key one after another to avoid switching programs.
+    virtual std::size_t opaqueProgramKey() const;
+
+    // Compiles, or loads from the program cache, the programs this layer renders with given its
+    // current paint properties, so that they're ready before the layer is first rendered.
+    virtual void precompilePrograms(Programs&) const {}
+
     // Check wether the given geometry intersects
     // with the feature
     virtual bool queryIntersectsFeature(
@@ -75,12 +95,11 @@ public:
     virtual std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const RenderLayer*>&) const = 0;
 
     void setRenderTiles(std::vector<std::reference_wrapper<RenderTile>>);
+    const std::vector<std::reference_wrapper<RenderTile>>& getRenderTiles() const { return renderTiles; }
     // Private implementation
     Immutable<style::Layer::Impl> baseImpl;
     void setImpl(Immutable<style::Layer::Impl>);
 
-    friend std::string layoutKey(const RenderLayer&);
-
 protected:
     // Stores what render passes this layer is currently enabled for. This depends on the
     // evaluated StyleProperties object and is updated accordingly.
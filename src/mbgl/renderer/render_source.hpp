@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mbgl/map/mode.hpp>
+#include <mbgl/renderer/query.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/util/mat4.hpp>
@@ -8,6 +11,7 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/layer_impl.hpp>
 
+#include <atomic>
 #include <unordered_map>
 #include <vector>
 #include <map>
@@ -20,8 +24,6 @@ class TransformState;
 class RenderTile;
 class RenderStyle;
 class RenderLayer;
-class RenderedQueryOptions;
-class SourceQueryOptions;
 class Tile;
 class RenderSourceObserver;
 class TileParameters;
@@ -48,6 +50,15 @@ public:
     bool isEnabled() const;
     virtual bool isLoaded() const = 0;
 
+    // The tiles that are needed but haven't loaded yet.
+    virtual std::vector<OverscaledTileID> getIncompleteTiles() const = 0;
+
+    // The source's tiles, counted by their state.
+    virtual RendererStatistics::Tiles getTileStatistics() const = 0;
+
+    // Memory held by the source's tiles, including the cached ones.
+    virtual RendererStatistics::Memory getMemoryUsage() const = 0;
+
     virtual void update(Immutable<style::Source::Impl>,
                         const std::vector<Immutable<style::Layer::Impl>>&,
                         bool needsRendering,
@@ -66,10 +77,11 @@ public:
                           const RenderStyle& style,
                           const RenderedQueryOptions& options) const = 0;
 
-    virtual std::vector<Feature>
-    querySourceFeatures(const SourceQueryOptions&) const = 0;
+    virtual void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const = 0;
 
-    virtual void onLowMemory() = 0;
+    // Frees the source's cached tiles, and under critical pressure what its tiles keep to speed up
+    // relayouts and queries.
+    virtual RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) = 0;
 
     virtual void dumpDebugLogs() const = 0;
 
@@ -1,6 +1,8 @@
 #include <mbgl/renderer/render_static_data.hpp>
 #include <mbgl/programs/program_parameters.hpp>
 
+#include <limits>
+
 namespace mbgl {
 
 static gl::VertexVector<FillLayoutVertex> tileVertices() {
@@ -19,6 +21,16 @@ static gl::IndexVector<gl::Triangles> quadTriangleIndices() {
     return result;
 }
 
+static gl::IndexVector<gl::Triangles> quadsIndices() {
+    gl::IndexVector<gl::Triangles> result;
+    // As many quads as fit into a segment.
+    for (uint16_t i = 0; i + 4 <= std::numeric_limits<uint16_t>::max(); i += 4) {
+        result.emplace_back(i, i + 1, i + 2);
+        result.emplace_back(i, i + 3, i + 2);
+    }
+    return result;
+}
+
 static gl::IndexVector<gl::LineStrip> tileLineStripIndices() {
     gl::IndexVector<gl::LineStrip> result;
     result.emplace_back(0);
@@ -47,11 +59,22 @@ static gl::VertexVector<ExtrusionTextureLayoutVertex> extrusionTextureVertices()
     return result;
 }
 
+static gl::VertexVector<CircleCornerVertex> circleCornerVertices() {
+    gl::VertexVector<CircleCornerVertex> result;
+    result.emplace_back(CircleInstancedProgram::cornerVertex(-1, -1));
+    result.emplace_back(CircleInstancedProgram::cornerVertex( 1, -1));
+    result.emplace_back(CircleInstancedProgram::cornerVertex(-1,  1));
+    result.emplace_back(CircleInstancedProgram::cornerVertex( 1,  1));
+    return result;
+}
+
 RenderStaticData::RenderStaticData(gl::Context& context, float pixelRatio, const optional<std::string>& programCacheDir)
     : tileVertexBuffer(context.createVertexBuffer(tileVertices())),
       rasterVertexBuffer(context.createVertexBuffer(rasterVertices())),
       extrusionTextureVertexBuffer(context.createVertexBuffer(extrusionTextureVertices())),
+      circleCornerVertexBuffer(context.createVertexBuffer(circleCornerVertices())),
       quadTriangleIndexBuffer(context.createIndexBuffer(quadTriangleIndices())),
+      quadsIndexBuffer(context.createIndexBuffer(quadsIndices())),
       tileBorderIndexBuffer(context.createIndexBuffer(tileLineStripIndices())),
       programs(context, ProgramParameters { pixelRatio, false, programCacheDir })
 #ifndef NDEBUG
@@ -10,6 +10,8 @@
 
 namespace mbgl {
 
+class RenderLayer;
+
 class RenderStaticData {
 public:
     RenderStaticData(gl::Context&, float pixelRatio, const optional<std::string>& programCacheDir);
@@ -17,8 +19,12 @@ public:
     gl::VertexBuffer<FillLayoutVertex> tileVertexBuffer;
     gl::VertexBuffer<RasterLayoutVertex> rasterVertexBuffer;
     gl::VertexBuffer<ExtrusionTextureLayoutVertex> extrusionTextureVertexBuffer;
+    gl::VertexBuffer<CircleCornerVertex> circleCornerVertexBuffer;
 
     gl::IndexBuffer<gl::Triangles> quadTriangleIndexBuffer;
+    // The two triangles of each of the quads of a segment, for the four vertices of each quad in
+    // order around it. Shared by the segments of all circle buckets.
+    gl::IndexBuffer<gl::Triangles> quadsIndexBuffer;
     gl::IndexBuffer<gl::LineStrip> tileBorderIndexBuffer;
 
     SegmentVector<FillAttributes> tileTriangleSegments;
@@ -27,6 +33,8 @@ public:
     SegmentVector<ExtrusionTextureAttributes> extrusionTextureSegments;
 
     optional<OffscreenTexture> extrusionTexture;
+    // The fill-extrusion layer whose extrusions the texture holds, if it still holds them.
+    const RenderLayer* extrusionTextureLayer = nullptr;
 
     Programs programs;
 
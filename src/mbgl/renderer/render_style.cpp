@@ -24,30 +24,53 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/sprite/sprite_loader.hpp>
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/text/line_break_cache.hpp>
+#include <mbgl/layout/layout_profiler.hpp>
+#include <mbgl/renderer/tile_snapshot.hpp>
+#include <mbgl/tile/layout_cache.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/math/wrap.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <unordered_set>
+
 namespace mbgl {
 
 using namespace style;
 
+// How many render sources of removed sources are kept around for reuse.
+static constexpr std::size_t retiredSourceLimit = 16;
+
 RenderStyleObserver nullObserver;
 
-RenderStyle::RenderStyle(Scheduler& scheduler_, FileSource& fileSource_)
+RenderStyle::RenderStyle(Scheduler& scheduler_, FileSource& fileSource_, const optional<std::string>& cacheDir,
+                         const optional<std::string>& localFontFamily)
     : scheduler(scheduler_),
       fileSource(fileSource_),
-      glyphManager(std::make_unique<GlyphManager>(fileSource)),
+      glyphManager(std::make_unique<GlyphManager>(
+          fileSource, cacheDir, scheduler,
+          localFontFamily ? LocalGlyphRasterizer::create(*localFontFamily) : nullptr)),
       imageManager(std::make_unique<ImageManager>()),
       lineAtlas(std::make_unique<LineAtlas>(Size{ 256, 512 })),
+      lineBreakCache(std::make_unique<LineBreakCache>()),
+      layoutProfiler(std::make_unique<LayoutProfiler>()),
+      tileSnapshot(std::make_unique<TileSnapshot>()),
+      layoutCache(std::make_unique<LayoutCache>()),
       imageImpls(makeMutable<std::vector<Immutable<style::Image::Impl>>>()),
       sourceImpls(makeMutable<std::vector<Immutable<style::Source::Impl>>>()),
       layerImpls(makeMutable<std::vector<Immutable<style::Layer::Impl>>>()),
       renderLight(makeMutable<Light::Impl>()),
       observer(&nullObserver) {
     glyphManager->setObserver(this);
+    imageManager->setObserver(this);
 }
 
 RenderStyle::~RenderStyle() {
@@ -58,6 +81,30 @@ void RenderStyle::setObserver(RenderStyleObserver* observer_) {
     observer = observer_;
 }
 
+void RenderStyle::setBucketUploader(BucketUploader* bucketUploader_) {
+    bucketUploader = bucketUploader_;
+}
+
+void RenderStyle::setUploadQueue(TileUploadQueue* uploadQueue_) {
+    uploadQueue = uploadQueue_;
+}
+
+void RenderStyle::setInstancing(bool instancing_) {
+    instancing = instancing_;
+}
+
+void RenderStyle::precompilePrograms(Programs& programs) {
+    if (!programsOutdated) {
+        return;
+    }
+
+    for (const auto& entry : renderLayers) {
+        entry.second->precompilePrograms(programs);
+    }
+
+    programsOutdated = false;
+}
+
 std::vector<const RenderLayer*> RenderStyle::getRenderLayers() const {
     std::vector<const RenderLayer*> result;
     result.reserve(renderLayers.size());
@@ -107,10 +154,25 @@ void RenderStyle::update(const UpdateParameters& parameters) {
         parameters.annotationManager,
         *imageManager,
         *glyphManager,
-        parameters.prefetchZoomDelta
+        parameters.prefetchZoomDelta,
+        parameters.tileCacheSize,
+        parameters.transitionKeyframes,
+        bucketUploader,
+        uploadQueue,
+        instancing,
+        lineBreakCache.get(),
+        parameters.placementBudget,
+        layoutProfiler.get(),
+        parameters.tileLODBias,
+        tileSnapshot.get(),
+        layoutCache.get()
     };
 
-    glyphManager->setURL(parameters.glyphURL);
+    // Lines are broken with the advances of the glyphs, which other glyphs may not share.
+    if (glyphManager->getURL() != parameters.glyphURL) {
+        lineBreakCache->clear();
+        glyphManager->setURL(parameters.glyphURL);
+    }
 
     // Update light.
     const bool lightChanged = renderLight.impl != parameters.light;
@@ -143,6 +205,7 @@ void RenderStyle::update(const UpdateParameters& parameters) {
         imageManager->updateImage(entry.second.after);
     }
 
+    imageManager->setImagesOnDemand(parameters.styleImagesOnDemand);
     imageManager->setLoaded(parameters.spriteLoaded);
 
 
@@ -164,33 +227,85 @@ void RenderStyle::update(const UpdateParameters& parameters) {
         renderLayers.at(entry.first)->setImpl(entry.second.after);
     }
 
-    // Update layers for class and zoom changes.
-    for (const auto& entry : renderLayers) {
-        RenderLayer& layer = *entry.second;
-        const bool layerAdded = layerDiff.added.count(entry.first);
-        const bool layerChanged = layerDiff.changed.count(entry.first);
+    if (!layerDiff.added.empty() || !layerDiff.changed.empty()) {
+        programsOutdated = true;
+    }
 
-        if (layerAdded || layerChanged) {
-            layer.transition(transitionParameters);
-        }
+    if (zoomChanged || !layerDiff.added.empty() || !layerDiff.changed.empty() || !layerDiff.removed.empty()) {
+        transitioningLayers.clear();
 
-        if (layerAdded || layerChanged || zoomChanged || layer.hasTransition()) {
-            layer.evaluate(evaluationParameters);
+        // Update layers for class and zoom changes.
+        for (const auto& entry : renderLayers) {
+            RenderLayer& layer = *entry.second;
+            const bool layerAdded = layerDiff.added.count(entry.first);
+            const bool layerChanged = layerDiff.changed.count(entry.first);
+
+            if (layerAdded || layerChanged) {
+                layer.transition(transitionParameters);
+            }
+
+            // Layers whose paint properties don't depend on the zoom level keep their evaluated
+            // values until the style changes them again.
+            if (layerAdded || layerChanged || layer.hasTransition() ||
+                (zoomChanged && layer.isZoomDependent())) {
+                layer.evaluate(evaluationParameters);
+            }
+
+            if (layer.hasTransition()) {
+                transitioningLayers.push_back(&layer);
+            }
         }
+    } else if (!transitioningLayers.empty()) {
+        // Only time has passed since the layers were evaluated, so only the properties that are in
+        // transition can have changed, and only in the layers that have them.
+        PropertyEvaluationParameters transitionEvaluationParameters = evaluationParameters;
+        transitionEvaluationParameters.transitionsOnly = true;
+
+        transitioningLayers.erase(std::remove_if(transitioningLayers.begin(), transitioningLayers.end(),
+            [&](RenderLayer* layer) {
+                layer->evaluate(transitionEvaluationParameters);
+                return !layer->hasTransition();
+            }), transitioningLayers.end());
+    }
+
+    // Ahead of the tiles, whose requests follow.
+    const int32_t glyphZoom = std::floor(parameters.transformState.getZoom());
+    if (!layerDiff.added.empty() || !layerDiff.changed.empty() ||
+        prefetchedGlyphZoom != glyphZoom || prefetchedGlyphURL != parameters.glyphURL) {
+        prefetchGlyphs(glyphZoom);
+        prefetchedGlyphZoom = glyphZoom;
+        prefetchedGlyphURL = parameters.glyphURL;
     }
 
 
     const SourceDifference sourceDiff = diffSources(sourceImpls, parameters.sources);
     sourceImpls = parameters.sources;
 
-    // Remove render layers for removed sources.
+    // Retire render sources of removed sources; switching back to a style that uses them again
+    // then reuses their tiles instead of loading them anew.
     for (const auto& entry : sourceDiff.removed) {
-        renderSources.erase(entry.first);
+        auto it = renderSources.find(entry.first);
+        if (it != renderSources.end()) {
+            it->second->setObserver(nullptr);
+            retiredSources.push_front(std::move(it->second));
+            renderSources.erase(it);
+            if (retiredSources.size() > retiredSourceLimit) {
+                retiredSources.pop_back();
+            }
+        }
+        tileOrders.erase(entry.first);
     }
 
-    // Create render sources for newly added sources.
+    // Create render sources for newly added sources, or revive retired ones of the same ID and
+    // type. Their tiles were laid out for other layers, so they're always laid out again.
+    std::unordered_set<std::string> revivedSources;
     for (const auto& entry : sourceDiff.added) {
-        std::unique_ptr<RenderSource> renderSource = RenderSource::create(entry.second);
+        std::unique_ptr<RenderSource> renderSource = reviveSource(*entry.second);
+        if (renderSource) {
+            revivedSources.insert(entry.first);
+        } else {
+            renderSource = RenderSource::create(entry.second);
+        }
         renderSource->setObserver(this);
         renderSources.emplace(entry.first, std::move(renderSource));
     }
@@ -199,7 +314,7 @@ void RenderStyle::update(const UpdateParameters& parameters) {
     for (const auto& source : *sourceImpls) {
         std::vector<Immutable<Layer::Impl>> filteredLayers;
         bool needsRendering = false;
-        bool needsRelayout = false;
+        bool needsRelayout = revivedSources.count(source->id) > 0;
 
         for (const auto& layer : *layerImpls) {
             if (layer->type == LayerType::Background ||
@@ -231,23 +346,48 @@ void RenderStyle::update(const UpdateParameters& parameters) {
     }
 }
 
-RenderSource* RenderStyle::getRenderSource(const std::string& id) const {
-    auto it = renderSources.find(id);
-    return it != renderSources.end() ? it->second.get() : nullptr;
-}
+void RenderStyle::prefetchGlyphs(int32_t zoom) {
+    // Basic Latin and Latin-1, and General Punctuation, which most labels are written in. The
+    // ranges of other scripts are loaded once tiles need them.
+    static const GlyphRangeSet ranges { { 0, 255 }, { 8192, 8447 } };
 
-bool RenderStyle::hasTransitions() const {
-    if (renderLight.hasTransition()) {
-        return true;
+    std::set<FontStack> fontStacks;
+    for (const auto& layer : *layerImpls) {
+        if (layer->type != LayerType::Symbol || layer->visibility == VisibilityType::None ||
+            zoom < layer->minZoom || zoom >= layer->maxZoom) {
+            continue;
+        }
+
+        const auto& impl = static_cast<const SymbolLayer::Impl&>(*layer);
+        if (impl.layout.get<TextField>().isUndefined()) {
+            continue;
+        }
+        fontStacks.insert(impl.layout.evaluate(PropertyEvaluationParameters(zoom)).get<TextFont>());
     }
 
-    for (const auto& entry : renderLayers) {
-        if (entry.second->hasTransition()) {
-            return true;
+    for (const auto& fontStack : fontStacks) {
+        glyphManager->prefetchGlyphs(fontStack, ranges);
+    }
+}
+
+std::unique_ptr<RenderSource> RenderStyle::reviveSource(const Source::Impl& impl) {
+    for (auto it = retiredSources.begin(); it != retiredSources.end(); ++it) {
+        if ((*it)->baseImpl->id == impl.id && (*it)->baseImpl->type == impl.type) {
+            std::unique_ptr<RenderSource> renderSource = std::move(*it);
+            retiredSources.erase(it);
+            return renderSource;
         }
     }
+    return nullptr;
+}
+
+RenderSource* RenderStyle::getRenderSource(const std::string& id) const {
+    auto it = renderSources.find(id);
+    return it != renderSources.end() ? it->second.get() : nullptr;
+}
 
-    return false;
+bool RenderStyle::hasTransitions() const {
+    return renderLight.hasTransition() || !transitioningLayers.empty();
 }
 
 bool RenderStyle::isLoaded() const {
@@ -264,6 +404,56 @@ bool RenderStyle::isLoaded() const {
     return true;
 }
 
+MissingTiles RenderStyle::getMissingTiles() const {
+    MissingTiles result;
+    for (const auto& entry : renderSources) {
+        if (!entry.second->isEnabled()) {
+            continue;
+        }
+        for (const auto& id : entry.second->getIncompleteTiles()) {
+            MissingTile tile { entry.first, id.canonical.z, id.canonical.x, id.canonical.y };
+            // Overscaled tiles of the same source share their canonical tile.
+            if (std::find(result.begin(), result.end(), tile) == result.end()) {
+                result.push_back(std::move(tile));
+            }
+        }
+    }
+    return result;
+}
+
+RendererStatistics::Tiles RenderStyle::getTileStatistics() const {
+    RendererStatistics::Tiles result;
+    for (const auto& entry : renderSources) {
+        result += entry.second->getTileStatistics();
+    }
+    return result;
+}
+
+std::map<std::string, RendererStatistics::Memory> RenderStyle::getSourceMemory() const {
+    std::map<std::string, RendererStatistics::Memory> result;
+    for (const auto& entry : renderSources) {
+        result.emplace(entry.first, entry.second->getMemoryUsage());
+    }
+    return result;
+}
+
+RendererStatistics::Memory RenderStyle::getAtlasMemory() const {
+    RendererStatistics::Memory result = glyphManager->getAtlas().memoryUsage();
+    result += imageManager->memoryUsage();
+    result += lineAtlas->memoryUsage();
+    return result;
+}
+
+std::string RenderStyle::encodeTileSnapshot() const {
+    std::set<std::pair<std::string, OverscaledTileID>> tiles;
+    for (const auto& entry : renderSources) {
+        for (const RenderTile& tile : entry.second->getRenderTiles()) {
+            tiles.emplace(entry.first, tile.tile.id);
+        }
+    }
+    return tileSnapshot->encode(tiles);
+}
+
 RenderData RenderStyle::getRenderData(MapDebugOptions debugOptions, float angle) {
     RenderData result;
 
@@ -271,6 +461,24 @@ RenderData RenderStyle::getRenderData(MapDebugOptions debugOptions, float angle)
         if (entry.second->isEnabled()) {
             result.sources.insert(entry.second.get());
         }
+
+        // Render tiles are rebuilt on every update, so the references have to be refreshed, but
+        // the cached orderings remain valid for as long as the tile set stays the same.
+        TileOrder& tileOrder = tileOrders[entry.first];
+        tileOrder.tiles = entry.second->getRenderTiles();
+
+        const bool unchanged = tileOrder.tiles.size() == tileOrder.tileIDs.size() &&
+            std::equal(tileOrder.tiles.begin(), tileOrder.tiles.end(), tileOrder.tileIDs.begin(),
+                       [](const RenderTile& tile, const UnwrappedTileID& id) { return tile.id == id; });
+        if (!unchanged) {
+            tileOrder.tileIDs.clear();
+            tileOrder.tileIDs.reserve(tileOrder.tiles.size());
+            for (const RenderTile& tile : tileOrder.tiles) {
+                tileOrder.tileIDs.push_back(tile.id);
+            }
+            tileOrder.regular = {};
+            tileOrder.symbol = {};
+        }
     }
 
     for (auto& layerImpl : *layerImpls) {
@@ -311,28 +519,14 @@ RenderData RenderStyle::getRenderData(MapDebugOptions debugOptions, float angle)
 
         const bool symbolLayer = layer->is<RenderSymbolLayer>();
 
-        auto sortedTiles = source->getRenderTiles();
-        if (symbolLayer) {
-            // Sort symbol tiles in opposite y position, so tiles with overlapping symbols are drawn
-            // on top of each other, with lower symbols being drawn on top of higher symbols.
-            std::sort(sortedTiles.begin(), sortedTiles.end(),
-                      [angle](const RenderTile& a, const RenderTile& b) {
-                Point<float> pa(a.id.canonical.x, a.id.canonical.y);
-                Point<float> pb(b.id.canonical.x, b.id.canonical.y);
-
-                auto par = util::rotate(pa, angle);
-                auto pbr = util::rotate(pb, angle);
-
-                return std::tie(par.y, par.x) < std::tie(pbr.y, pbr.x);
-            });
-        } else {
-            std::sort(sortedTiles.begin(), sortedTiles.end(),
-                      [](const auto& a, const auto& b) { return a.get().id < b.get().id; });
-        }
+        TileOrder& tileOrder = tileOrders.at(layer->baseImpl->source);
+        const std::vector<std::reference_wrapper<RenderTile>>& tiles = tileOrder.tiles;
+        const std::vector<std::size_t>& order = getTileOrder(tileOrder, symbolLayer, angle);
 
         std::vector<std::reference_wrapper<RenderTile>> sortedTilesForInsertion;
-        for (auto& sortedTile : sortedTiles) {
-            auto& tile = sortedTile.get();
+        sortedTilesForInsertion.reserve(order.size());
+        for (std::size_t index : order) {
+            RenderTile& tile = tiles[index];
             if (!tile.tile.isRenderable()) {
                 continue;
             }
@@ -370,11 +564,66 @@ RenderData RenderStyle::getRenderData(MapDebugOptions debugOptions, float angle)
     return result;
 }
 
+const std::vector<std::size_t>& RenderStyle::getTileOrder(TileOrder& tileOrder, bool symbolLayer, float angle) {
+    const auto sortedIndices = [&](auto compare) {
+        std::vector<std::size_t> indices(tileOrder.tileIDs.size());
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            indices[i] = i;
+        }
+        std::sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) {
+            return compare(tileOrder.tileIDs[a], tileOrder.tileIDs[b]);
+        });
+        return indices;
+    };
+
+    if (!symbolLayer) {
+        if (!tileOrder.regular) {
+            tileOrder.regular = sortedIndices([](const UnwrappedTileID& a, const UnwrappedTileID& b) {
+                return a < b;
+            });
+        }
+        return *tileOrder.regular;
+    }
+
+    // Symbol tiles are ordered by their rotated position, which only changes in a meaningful way
+    // once the bearing has moved by a noticeable amount. Sorting by the center of a one degree
+    // bucket keeps the order stable while rotating within that bucket.
+    constexpr double bucketSize = M_PI / 180;
+    const auto bucket = static_cast<int32_t>(std::lround(util::wrap<double>(angle, -M_PI, M_PI) / bucketSize));
+    if (!tileOrder.symbol || tileOrder.symbolBearingBucket != bucket) {
+        const float bucketAngle = bucket * bucketSize;
+
+        // Sort symbol tiles in opposite y position, so tiles with overlapping symbols are drawn
+        // on top of each other, with lower symbols being drawn on top of higher symbols.
+        tileOrder.symbol = sortedIndices([bucketAngle](const UnwrappedTileID& a, const UnwrappedTileID& b) {
+            Point<float> pa(a.canonical.x, a.canonical.y);
+            Point<float> pb(b.canonical.x, b.canonical.y);
+
+            auto par = util::rotate(pa, bucketAngle);
+            auto pbr = util::rotate(pb, bucketAngle);
+
+            return std::tie(par.y, par.x) < std::tie(pbr.y, pbr.x);
+        });
+        tileOrder.symbolBearingBucket = bucket;
+    }
+    return *tileOrder.symbol;
+}
+
 std::vector<Feature> RenderStyle::queryRenderedFeatures(const ScreenLineString& geometry,
                                                   const TransformState& transformState,
                                                   const RenderedQueryOptions& options) const {
-    std::unordered_map<std::string, std::vector<Feature>> resultsByLayer;
+    return std::move(queryRenderedFeatures(std::vector<ScreenLineString> { geometry }, transformState, options).front());
+}
+
+std::vector<std::vector<Feature>> RenderStyle::queryRenderedFeatures(const std::vector<ScreenLineString>& geometries,
+                                                                     const TransformState& transformState,
+                                                                     const RenderedQueryOptions& options) const {
+    std::vector<std::vector<Feature>> results(geometries.size());
+    if (geometries.empty()) {
+        return results;
+    }
 
+    std::vector<RenderSource*> sources;
     if (options.layerIDs) {
         std::unordered_set<std::string> sourceIDs;
         for (const auto& layerID : *options.layerIDs) {
@@ -384,42 +633,59 @@ std::vector<Feature> RenderStyle::queryRenderedFeatures(const ScreenLineString&
         }
         for (const auto& sourceID : sourceIDs) {
             if (RenderSource* renderSource = getRenderSource(sourceID)) {
-                auto sourceResults = renderSource->queryRenderedFeatures(geometry, transformState, *this, options);
-                std::move(sourceResults.begin(), sourceResults.end(), std::inserter(resultsByLayer, resultsByLayer.begin()));
+                sources.push_back(renderSource);
             }
         }
     } else {
         for (const auto& entry : renderSources) {
-            auto sourceResults = entry.second->queryRenderedFeatures(geometry, transformState, *this, options);
-            std::move(sourceResults.begin(), sourceResults.end(), std::inserter(resultsByLayer, resultsByLayer.begin()));
+            sources.push_back(entry.second.get());
         }
     }
 
-    std::vector<Feature> result;
-
-    if (resultsByLayer.empty()) {
-        return result;
-    }
-
-    // Combine all results based on the style layer order.
+    // The layers that are rendered at this zoom, in style order.
+    std::vector<const std::string*> layerIDs;
     for (const auto& layerImpl : *layerImpls) {
         const RenderLayer* layer = getRenderLayer(layerImpl->id);
-        if (!layer->needsRendering(zoomHistory.lastZoom)) {
+        if (layer->needsRendering(zoomHistory.lastZoom)) {
+            layerIDs.push_back(&layer->baseImpl->id);
+        }
+    }
+
+    for (std::size_t i = 0; i < geometries.size(); i++) {
+        std::unordered_map<std::string, std::vector<Feature>> resultsByLayer;
+        for (RenderSource* renderSource : sources) {
+            auto sourceResults = renderSource->queryRenderedFeatures(geometries[i], transformState, *this, options);
+            std::move(sourceResults.begin(), sourceResults.end(), std::inserter(resultsByLayer, resultsByLayer.begin()));
+        }
+
+        if (resultsByLayer.empty()) {
             continue;
         }
-        auto it = resultsByLayer.find(layer->baseImpl->id);
-        if (it != resultsByLayer.end()) {
-            std::move(it->second.begin(), it->second.end(), std::back_inserter(result));
+
+        // Combine all results based on the style layer order.
+        for (const std::string* layerID : layerIDs) {
+            auto it = resultsByLayer.find(*layerID);
+            if (it != resultsByLayer.end()) {
+                std::move(it->second.begin(), it->second.end(), std::back_inserter(results[i]));
+            }
         }
     }
 
-    return result;
+    return results;
 }
 
-void RenderStyle::onLowMemory() {
+RendererStatistics::LowMemory RenderStyle::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    RendererStatistics::LowMemory freed;
     for (const auto& entry : renderSources) {
-        entry.second->onLowMemory();
+        const RendererStatistics::LowMemory source = entry.second->onLowMemory(pressure, workerCachesFreed);
+        freed.tileCache += source.tileCache;
+        freed.queryData += source.queryData;
+    }
+    for (const auto& source : retiredSources) {
+        freed.tileCache += source->getMemoryUsage();
     }
+    retiredSources.clear();
+    return freed;
 }
 
 void RenderStyle::onGlyphsError(const FontStack& fontStack, const GlyphRange& glyphRange, std::exception_ptr error) {
@@ -428,6 +694,10 @@ void RenderStyle::onGlyphsError(const FontStack& fontStack, const GlyphRange& gl
     observer->onResourceError(error);
 }
 
+void RenderStyle::onStyleImageMissing(const std::string& id) {
+    observer->onStyleImageMissing(id);
+}
+
 void RenderStyle::onTileError(RenderSource& source, const OverscaledTileID& tileID, std::exception_ptr error) {
     Log::Error(Event::Style, "Failed to load tile %s for source %s: %s",
                util::toString(tileID).c_str(), source.baseImpl->id.c_str(), util::toString(error).c_str());
@@ -444,6 +714,12 @@ void RenderStyle::dumpDebugLogs() const {
     }
 
     imageManager->dumpDebugLogs();
+    lineBreakCache->dumpDebugLogs();
+
+    const PolygonFixupCounts fixups = getPolygonFixupCounts();
+    Log::Info(Event::General, "fixupPolygons: %llu of %llu polygons fixed",
+              static_cast<unsigned long long>(fixups.fixed),
+              static_cast<unsigned long long>(fixups.polygons));
 }
 
 } // namespace mbgl
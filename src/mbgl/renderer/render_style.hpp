@@ -5,12 +5,19 @@
 #include <mbgl/renderer/render_source_observer.hpp>
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/renderer/render_light.hpp>
+#include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/map/zoom_history.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/missing_tile.hpp>
+#include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mbgl {
@@ -19,12 +26,19 @@ class FileSource;
 class GlyphManager;
 class ImageManager;
 class LineAtlas;
+class LineBreakCache;
+class LayoutProfiler;
+class TileSnapshot;
+class LayoutCache;
 class RenderData;
 class TransformState;
 class RenderedQueryOptions;
 class Scheduler;
 class UpdateParameters;
 class RenderStyleObserver;
+class BucketUploader;
+class TileUploadQueue;
+class Programs;
 
 namespace style {
 class Image;
@@ -33,15 +47,36 @@ class Layer;
 } // namespace style
 
 class RenderStyle : public GlyphManagerObserver,
+                    public ImageManagerObserver,
                     public RenderSourceObserver {
 public:
-    RenderStyle(Scheduler&, FileSource&);
+    // Parsed glyphs are cached in `cacheDir`, if any. With a local font family, CJK glyphs are
+    // rasterized with it rather than downloaded, where the platform supports it.
+    RenderStyle(Scheduler&, FileSource&, const optional<std::string>& cacheDir = {},
+                const optional<std::string>& localFontFamily = {});
     ~RenderStyle() final;
 
     void setObserver(RenderStyleObserver*);
+
+    // Tiles created from now on upload their buckets through the given uploader, and wait in the
+    // given queue for their first upload.
+    void setBucketUploader(BucketUploader*);
+    void setUploadQueue(TileUploadQueue*);
+
+    // Tiles created from now on lay out their buckets for instanced drawing where they can.
+    void setInstancing(bool);
+
     void update(const UpdateParameters&);
 
+    // Prepares the programs of the layers added or changed since the last call, so that they
+    // aren't compiled in the middle of rendering a frame.
+    void precompilePrograms(Programs&);
+
     bool isLoaded() const;
+    MissingTiles getMissingTiles() const;
+    RendererStatistics::Tiles getTileStatistics() const;
+    std::map<std::string, RendererStatistics::Memory> getSourceMemory() const;
+    RendererStatistics::Memory getAtlasMemory() const;
     bool hasTransitions() const;
 
     RenderSource* getRenderSource(const std::string& id) const;
@@ -59,7 +94,13 @@ public:
                                                const TransformState& transformState,
                                                const RenderedQueryOptions& options) const;
 
-    void onLowMemory();
+    // Runs one query per geometry, sharing the selection of sources and layers between them.
+    std::vector<std::vector<Feature>> queryRenderedFeatures(const std::vector<ScreenLineString>& geometries,
+                                                            const TransformState& transformState,
+                                                            const RenderedQueryOptions& options) const;
+
+    // Returns what was freed right away; workers add what they free to `workerCachesFreed`.
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed);
 
     void dumpDebugLogs() const;
 
@@ -69,23 +110,83 @@ public:
     std::unique_ptr<ImageManager> imageManager;
     std::unique_ptr<LineAtlas> lineAtlas;
 
+    LayoutProfiler& getLayoutProfiler() {
+        return *layoutProfiler;
+    }
+
+    TileSnapshot& getTileSnapshot() {
+        return *tileSnapshot;
+    }
+
+    LayoutCache& getLayoutCache() {
+        return *layoutCache;
+    }
+
+    // Encodes the buckets the tile snapshot recorded for the tiles currently rendered.
+    std::string encodeTileSnapshot() const;
+
 private:
+    // Used by the workers of the tiles of all sources, so it must outlive them.
+    std::unique_ptr<LineBreakCache> lineBreakCache;
+    std::unique_ptr<LayoutProfiler> layoutProfiler;
+    // Tiles erase their entries when they're destroyed, so it must outlive them as well.
+    std::unique_ptr<TileSnapshot> tileSnapshot;
+    std::unique_ptr<LayoutCache> layoutCache;
+
     Immutable<std::vector<Immutable<style::Image::Impl>>> imageImpls;
     Immutable<std::vector<Immutable<style::Source::Impl>>> sourceImpls;
     Immutable<std::vector<Immutable<style::Layer::Impl>>> layerImpls;
 
     std::unordered_map<std::string, std::unique_ptr<RenderSource>> renderSources;
+
+    // Render sources of recently removed sources, most recently removed first. A source added
+    // later with the same ID and type takes over its render source, along with its tiles.
+    std::list<std::unique_ptr<RenderSource>> retiredSources;
+    std::unique_ptr<RenderSource> reviveSource(const style::Source::Impl&);
+
     std::unordered_map<std::string, std::unique_ptr<RenderLayer>> renderLayers;
     RenderLight renderLight;
 
+    // The render layers that had a transition in progress when they were last evaluated. Unless
+    // the zoom level or the layers change, only these are evaluated again.
+    std::vector<RenderLayer*> transitioningLayers;
+
+    // The order in which a source's render tiles are drawn, as indices into its render tiles.
+    // Sorting is only redone when the source's tile set changes or, for symbol layers, when the
+    // bearing moves to a different bucket.
+    struct TileOrder {
+        std::vector<std::reference_wrapper<RenderTile>> tiles;
+        std::vector<UnwrappedTileID> tileIDs;
+        optional<std::vector<std::size_t>> regular;
+        optional<std::vector<std::size_t>> symbol;
+        int32_t symbolBearingBucket = 0;
+    };
+
+    std::unordered_map<std::string, TileOrder> tileOrders;
+
+    const std::vector<std::size_t>& getTileOrder(TileOrder&, bool symbolLayer, float angle);
+
+    // Loads the glyph ranges of the common scripts for the fonts that the symbol layers use at
+    // the zoom level, so that the first tiles don't wait for them after they're parsed.
+    void prefetchGlyphs(int32_t zoom);
+    optional<int32_t> prefetchedGlyphZoom;
+    std::string prefetchedGlyphURL;
+
     // GlyphManagerObserver implementation.
     void onGlyphsError(const FontStack&, const GlyphRange&, std::exception_ptr) override;
 
+    // ImageManagerObserver implementation.
+    void onStyleImageMissing(const std::string&) override;
+
     // RenderSourceObserver implementation.
     void onTileChanged(RenderSource&, const OverscaledTileID&) override;
     void onTileError(RenderSource&, const OverscaledTileID&, std::exception_ptr) override;
 
     RenderStyleObserver* observer;
+    BucketUploader* bucketUploader = nullptr;
+    TileUploadQueue* uploadQueue = nullptr;
+    bool instancing = false;
+    bool programsOutdated = false;
     ZoomHistory zoomHistory;
 };
 
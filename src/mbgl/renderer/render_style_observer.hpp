@@ -1,6 +1,7 @@
 #pragma once
 
 #include <exception>
+#include <string>
 
 namespace mbgl {
 
@@ -9,6 +10,7 @@ public:
     virtual ~RenderStyleObserver() = default;
     virtual void onInvalidate() {}
     virtual void onResourceError(std::exception_ptr) {}
+    virtual void onStyleImageMissing(const std::string&) {}
 };
 
 } // namespace mbgl
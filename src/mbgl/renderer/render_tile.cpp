@@ -58,13 +58,12 @@ void RenderTile::setMask(TileMask&& mask) {
 
 void RenderTile::startRender(PaintParameters& parameters) {
     tile.upload(parameters.context);
+    tile.setDrawn();
 
     // Calculate two matrices for this tile: matrix is the standard tile matrix; nearClippedMatrix
     // clips the near plane to 100 to save depth buffer precision
-    parameters.state.matrixFor(matrix, id);
-    parameters.state.matrixFor(nearClippedMatrix, id);
-    matrix::multiply(matrix, parameters.projMatrix, matrix);
-    matrix::multiply(nearClippedMatrix, parameters.nearClippedProjMatrix, nearClippedMatrix);
+    parameters.state.matrixFor(matrix, id, parameters.projMatrix);
+    parameters.state.matrixFor(nearClippedMatrix, id, parameters.nearClippedProjMatrix);
 }
 
 void RenderTile::finishRender(PaintParameters& parameters) {
@@ -75,7 +74,7 @@ void RenderTile::finishRender(PaintParameters& parameters) {
     static const DebugProgram::PaintPropertyBinders paintAttibuteData(properties, 0);
 
     auto draw = [&] (Color color, const auto& vertexBuffer, const auto& indexBuffer, const auto& segments, auto drawMode) {
-        parameters.programs.debug.draw(
+        parameters.programs.debug.get().draw(
             parameters.context,
             drawMode,
             gl::DepthMode::disabled(),
@@ -90,8 +89,7 @@ void RenderTile::finishRender(PaintParameters& parameters) {
             segments,
             paintAttibuteData,
             properties,
-            parameters.state.getZoom(),
-            "debug"
+            parameters.state.getZoom()
         );
     };
 
@@ -1,6 +1,10 @@
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/renderer/renderer_impl.hpp>
 #include <mbgl/renderer/update_parameters.hpp>
+#include <mbgl/renderer/render_style.hpp>
+#include <mbgl/layout/layout_profiler.hpp>
+#include <mbgl/renderer/tile_snapshot.hpp>
+#include <mbgl/tile/layout_cache.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 
 namespace mbgl {
@@ -10,9 +14,11 @@ Renderer::Renderer(RendererBackend& backend,
                    FileSource& fileSource_,
                    Scheduler& scheduler_,
                    GLContextMode contextMode_,
-                   const optional<std::string> programCacheDir_)
+                   const optional<std::string> programCacheDir_,
+                   const optional<std::string> localFontFamily_)
         : impl(std::make_unique<Impl>(backend, pixelRatio_, fileSource_, scheduler_,
-                                      contextMode_, std::move(programCacheDir_))) {
+                                      contextMode_, std::move(programCacheDir_),
+                                      std::move(localFontFamily_))) {
 }
 
 Renderer::~Renderer() = default;
@@ -30,20 +36,43 @@ std::vector<Feature> Renderer::queryRenderedFeatures(const ScreenLineString& geo
 }
 
 std::vector<Feature> Renderer::queryRenderedFeatures(const ScreenCoordinate& point, const RenderedQueryOptions& options) const {
-    return impl->queryRenderedFeatures({ point }, options);
+    return impl->queryRenderedFeatures(ScreenLineString { point }, options);
+}
+
+static ScreenLineString boxGeometry(const ScreenBox& box) {
+    return {
+        box.min,
+        {box.max.x, box.min.y},
+        box.max,
+        {box.min.x, box.max.y},
+        box.min
+    };
 }
 
 std::vector<Feature> Renderer::queryRenderedFeatures(const ScreenBox& box, const RenderedQueryOptions& options) const {
-    return impl->queryRenderedFeatures(
-            {
-                    box.min,
-                    {box.max.x, box.min.y},
-                    box.max,
-                    {box.min.x, box.max.y},
-                    box.min
-            },
-            options
-    );
+    return impl->queryRenderedFeatures(boxGeometry(box), options);
+}
+
+std::vector<std::vector<Feature>> Renderer::queryRenderedFeatures(const std::vector<ScreenLineString>& geometries, const RenderedQueryOptions& options) const {
+    return impl->queryRenderedFeatures(geometries, options);
+}
+
+std::vector<std::vector<Feature>> Renderer::queryRenderedFeatures(const std::vector<ScreenCoordinate>& points, const RenderedQueryOptions& options) const {
+    std::vector<ScreenLineString> geometries;
+    geometries.reserve(points.size());
+    for (const auto& point : points) {
+        geometries.push_back(ScreenLineString { point });
+    }
+    return impl->queryRenderedFeatures(geometries, options);
+}
+
+std::vector<std::vector<Feature>> Renderer::queryRenderedFeatures(const std::vector<ScreenBox>& boxes, const RenderedQueryOptions& options) const {
+    std::vector<ScreenLineString> geometries;
+    geometries.reserve(boxes.size());
+    for (const auto& box : boxes) {
+        geometries.push_back(boxGeometry(box));
+    }
+    return impl->queryRenderedFeatures(geometries, options);
 }
 
 AnnotationIDs Renderer::queryPointAnnotations(const ScreenBox& box) const {
@@ -64,15 +93,79 @@ AnnotationIDs Renderer::queryPointAnnotations(const ScreenBox& box) const {
 }
 
 std::vector<Feature> Renderer::querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options) const {
-    return impl->querySourceFeatures(sourceID, options);
+    std::vector<Feature> result;
+    impl->querySourceFeatures(sourceID, options, [&] (Feature&& feature) {
+        result.push_back(std::move(feature));
+    });
+    return result;
+}
+
+void Renderer::querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options, const SourceFeatureCallback& callback) const {
+    impl->querySourceFeatures(sourceID, options, callback);
 }
 
 void Renderer::dumpDebugLogs() {
     impl->dumDebugLogs();
 }
 
-void Renderer::onLowMemory() {
-    impl->onLowMemory();
+RendererStatistics Renderer::getStatistics() const {
+    return impl->statistics;
+}
+
+void Renderer::onLowMemory(MemoryPressure pressure) {
+    impl->onLowMemory(pressure);
+}
+
+void Renderer::setUploadBudget(std::size_t bytesPerFrame) {
+    impl->uploadQueue.setBudget(bytesPerFrame);
+}
+
+void Renderer::setGPUTimingEnabled(bool enabled) {
+    impl->gpuTimingEnabled = enabled;
+}
+
+void Renderer::setFrameBudget(Duration budget) {
+    impl->frameBudget = budget;
+}
+
+void Renderer::setLayoutProfilingEnabled(bool enabled) {
+    impl->renderStyle->getLayoutProfiler().setEnabled(enabled);
+}
+
+void Renderer::setRenderPixelRatio(float pixelRatio) {
+    impl->pixelRatio = pixelRatio;
+}
+
+void Renderer::setTileSnapshotRecording(bool recording) {
+    impl->renderStyle->getTileSnapshot().setRecording(recording);
+}
+
+std::string Renderer::getTileSnapshot() const {
+    return impl->renderStyle->encodeTileSnapshot();
+}
+
+void Renderer::setTileSnapshot(const std::string& snapshot) {
+    impl->renderStyle->getTileSnapshot().decode(snapshot);
+}
+
+void Renderer::setLayoutCacheSize(std::size_t bytes) {
+    impl->renderStyle->getLayoutCache().setMaximumSize(bytes);
+}
+
+void Renderer::setExtrusionWallThreshold(float pixels) {
+    impl->extrusionWallThreshold = pixels;
+}
+
+void Renderer::setFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                               const FeatureIdentifier& id, float state) {
+    if (impl->featureStates.set(sourceID, sourceLayer, id, state)) {
+        impl->onInvalidate();
+    }
+}
+
+float Renderer::getFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                                const FeatureIdentifier& id) const {
+    return impl->featureStates.get(sourceID, sourceLayer, id);
 }
 
 } // namespace mbgl
@@ -21,6 +21,22 @@ gl::Context& RendererBackend::getContext() {
     return *context;
 }
 
+bool RendererBackend::supportsSharedUploadContext() const {
+    return false;
+}
+
+bool RendererBackend::preservesStencilBuffer() const {
+    return false;
+}
+
+void RendererBackend::activateUploadContext() {
+    assert(false);
+}
+
+void RendererBackend::deactivateUploadContext() {
+    assert(false);
+}
+
 PremultipliedImage RendererBackend::readFramebuffer(const Size& size) const {
     assert(context);
     return context->readFramebuffer<PremultipliedImage>(size);
@@ -6,11 +6,26 @@
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/backend_scope.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/bucket_uploader.hpp>
+#include <mbgl/renderer/gpu_timer.hpp>
+#include <mbgl/renderer/layers/render_custom_layer.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+#include <mbgl/layout/layout_profiler.hpp>
+#include <mbgl/tile/layout_cache.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/storage/file_source.hpp>
 #include <mbgl/gl/debugging.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <algorithm>
+#include <unordered_map>
 
 namespace mbgl {
 
+// Time spent matching labels across tiles per frame.
+static constexpr Duration crossTileSymbolBudget = Milliseconds(2);
+
 using namespace style;
 
 static RendererObserver& nullObserver() {
@@ -23,21 +38,28 @@ Renderer::Impl::Impl(RendererBackend& backend_,
                      FileSource& fileSource_,
                      Scheduler& scheduler_,
                      GLContextMode contextMode_,
-                     const optional<std::string> programCacheDir_)
+                     const optional<std::string> programCacheDir_,
+                     const optional<std::string> localFontFamily_)
         : backend(backend_)
+        , fileSource(fileSource_)
+        , scheduler(scheduler_)
         , observer(&nullObserver())
+        , invalidateTask([this] { observer->onInvalidate(); })
         , contextMode(contextMode_)
         , pixelRatio(pixelRatio_)
         , programCacheDir(programCacheDir_)
-        , renderStyle(std::make_unique<RenderStyle>(scheduler_, fileSource_)) {
+        , renderStyle(std::make_unique<RenderStyle>(scheduler_, fileSource_, programCacheDir_, localFontFamily_)) {
 
     renderStyle->setObserver(this);
+    renderStyle->setUploadQueue(&uploadQueue);
 }
 
 Renderer::Impl::~Impl() {
     BackendScope guard { backend };
     renderStyle.reset();
-    staticData.reset();
+    staticData.clear();
+    bucketUploader.reset();
+    gpuTimer.reset();
 };
 
 void Renderer::Impl::setObserver(RendererObserver* observer_) {
@@ -50,11 +72,41 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
     
     assert(BackendScope::exists());
 
-    renderStyle->update(updateParameters);
-    transformState = updateParameters.transformState;
+    const TimePoint frameStart = Clock::now();
+    frameTimer.beginFrame();
+
+    if (!gpuTimingEnabled) {
+        gpuTimer.reset();
+    } else if (!gpuTimer && backend.getContext().getTimerQueryExtension()) {
+        gpuTimer = std::make_unique<GPUTimer>(backend.getContext());
+    }
+
+    if (!bucketUploader && backend.supportsSharedUploadContext()) {
+        bucketUploader = std::make_unique<BucketUploader>(backend);
+        renderStyle->setBucketUploader(bucketUploader.get());
+    }
+
+    // Tiles that were waiting for their first upload and fit into this frame's budget replace the
+    // tiles covering for them right away. Still images are rendered only once, so they get all.
+    {
+        FrameTimer::Scope phase(frameTimer, "tile upload", backend.getContext());
+        phase.setCount(uploadQueue.upload(backend.getContext(), updateParameters.mode == MapMode::Still),
+                       "uploaded %zu tiles");
+    }
+
+    std::unique_ptr<RenderStaticData>& data = staticData[pixelRatio];
+    {
+        const FrameTimer::Scope phase(frameTimer, "update", backend.getContext());
+
+        renderStyle->setInstancing(backend.getContext().getInstancedArraysExtension() != nullptr);
+        renderStyle->update(updateParameters);
+        transformState = updateParameters.transformState;
 
-    if (!staticData) {
-        staticData = std::make_unique<RenderStaticData>(backend.getContext(), pixelRatio, programCacheDir);
+        if (!data) {
+            data = std::make_unique<RenderStaticData>(backend.getContext(), pixelRatio, programCacheDir);
+        }
+
+        renderStyle->precompilePrograms(data->programs);
     }
 
     PaintParameters parameters {
@@ -64,9 +116,11 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         backend,
         updateParameters,
         *renderStyle,
-        *staticData,
+        *data,
         frameHistory
     };
+    parameters.extrusionWallThreshold = extrusionWallThreshold;
+    parameters.featureStates = &featureStates;
 
     bool loaded = updateParameters.styleLoaded && renderStyle->isLoaded();
 
@@ -80,11 +134,34 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
         backend.updateAssumedState();
 
         doRender(parameters);
-        parameters.context.performCleanup();
+        {
+            const FrameTimer::Scope phase(frameTimer, "cleanup", parameters.context);
+            parameters.context.performCleanup();
+        }
+
+        const optional<FrameTimings> slowFrame = frameTimer.endFrame(frameBudget);
+        if (slowFrame) {
+            observer->onSlowFrame(*slowFrame);
+        }
+
+        const optional<GPUTimings> gpuTimings = collectGPUTimings();
+
+        // Another frame is only needed if it would differ from this one. Transitions that reached
+        // their end state this frame don't report themselves anymore; fades are done once every
+        // opacity is at its final value, which may be before the fade duration has passed.
+        const bool fading = frameHistory.needsAnimation(util::DEFAULT_TRANSITION_DURATION);
+        const bool needsRepaint = renderStyle->hasTransitions() || (fading && !frameHistory.isSettled()) ||
+            !uploadQueue.empty() || crossTileSymbolsPending;
+        if (fading && !needsRepaint) {
+            skippedFrames++;
+        }
+
+        updateStatistics(parameters.context, Clock::now() - frameStart, loaded);
 
         observer->onDidFinishRenderingFrame(
                 loaded ? RendererObserver::RenderMode::Full : RendererObserver::RenderMode::Partial,
-                renderStyle->hasTransitions() || frameHistory.needsAnimation(util::DEFAULT_TRANSITION_DURATION)
+                needsRepaint,
+                gpuTimings
         );
 
         if (!loaded) {
@@ -93,15 +170,21 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
             renderState = RenderState::Fully;
             observer->onDidFinishRenderingMap();
         }
-    } else if (loaded) {
+    } else if (loaded || (updateParameters.stillImageTimedOut && updateParameters.styleLoaded)) {
+        // Tiles that timed out are covered by their loaded parents or children, if any.
+        if (!loaded) {
+            observer->onDidRenderIncompleteStill(renderStyle->getMissingTiles());
+        }
+
         observer->onWillStartRenderingMap();
         observer->onWillStartRenderingFrame();
 
         backend.updateAssumedState();
 
         doRender(parameters);
+        updateStatistics(parameters.context, Clock::now() - frameStart, true);
 
-        observer->onDidFinishRenderingFrame(RendererObserver::RenderMode::Full, false);
+        observer->onDidFinishRenderingFrame(RendererObserver::RenderMode::Full, false, collectGPUTimings());
         observer->onDidFinishRenderingMap();
 
         // Cleanup only after signaling completion
@@ -109,27 +192,85 @@ void Renderer::Impl::render(const UpdateParameters& updateParameters) {
     }
 }
 
+optional<GPUTimings> Renderer::Impl::collectGPUTimings() {
+    if (!gpuTimer) {
+        return {};
+    }
+
+    optional<GPUTimings> timings = gpuTimer->collect();
+    if (timings) {
+        lastGPUTimings = timings;
+    }
+    return timings;
+}
+
 void Renderer::Impl::doRender(PaintParameters& parameters) {
+    if (gpuTimer) {
+        gpuTimer->beginFrame();
+    }
+
+    renderFrame(parameters);
+
+    if (gpuTimer) {
+        gpuTimer->endFrame();
+    }
+}
+
+void Renderer::Impl::renderFrame(PaintParameters& parameters) {
     if (parameters.contextMode == GLContextMode::Shared) {
         parameters.context.setDirtyState();
     }
 
-    RenderData renderData = renderStyle->getRenderData(parameters.debugOptions, parameters.state.getAngle());
+    parameters.context.drawCalls = 0;
+
+    RenderData renderData;
+    {
+        FrameTimer::Scope phase(frameTimer, "render data", parameters.context);
+        renderData = renderStyle->getRenderData(parameters.debugOptions, parameters.state.getAngle());
+        phase.setCount(renderData.order.size(), "%zu render items");
+
+        frameHistory.record(parameters.timePoint,
+                            parameters.state.getZoom(),
+                            parameters.mapMode == MapMode::Continuous ? util::DEFAULT_TRANSITION_DURATION : Milliseconds(0));
+    }
     const std::vector<RenderItem>& order = renderData.order;
     const std::unordered_set<RenderSource*>& sources = renderData.sources;
 
-    frameHistory.record(parameters.timePoint,
-                        parameters.state.getZoom(),
-                        parameters.mapMode == MapMode::Continuous ? util::DEFAULT_TRANSITION_DURATION : Milliseconds(0));
+    // - CROSS-TILE SYMBOLS ------------------------------------------------------------------------
+    // Hides labels that neighbouring tiles show already. Matching the buckets of newly placed tiles
+    // is spread over frames; still images are rendered only once, so they wait for all of them.
+    {
+        FrameTimer::Scope phase(frameTimer, "symbols", parameters.context);
+
+        std::vector<RenderSymbolLayer*> symbolLayers;
+        for (const auto& item : order) {
+            if (item.layer.is<RenderSymbolLayer>()) {
+                symbolLayers.push_back(item.layer.as<RenderSymbolLayer>());
+            }
+        }
+
+        const TimePoint deadline = parameters.mapMode == MapMode::Still
+            ? TimePoint::max()
+            : Clock::now() + crossTileSymbolBudget;
+        crossTileSymbolsPending = !crossTileSymbolIndex.update(symbolLayers, deadline);
+        phase.setCount(symbolLayers.size(), "matched symbols of %zu layers");
+    }
 
     // - UPLOAD PASS -------------------------------------------------------------------------------
     // Uploads all required buffers and images before we do any actual rendering.
     {
         MBGL_DEBUG_GROUP(parameters.context, "upload");
+        const GPUTimer::Scope passTiming(gpuTimer.get(), GPUTimer::Kind::Pass, "upload");
+        const FrameTimer::Scope phase(frameTimer, "upload", parameters.context);
 
         parameters.imageManager.upload(parameters.context, 0);
+        parameters.glyphAtlas.upload(parameters.context, 0);
         parameters.lineAtlas.upload(parameters.context, 0);
         parameters.frameHistory.upload(parameters.context, 0);
+
+        for (const auto& item : order) {
+            item.layer.upload(parameters);
+        }
     }
 
     // - CLEAR -------------------------------------------------------------------------------------
@@ -137,18 +278,23 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
     // tiles whatsoever.
     {
         MBGL_DEBUG_GROUP(parameters.context, "clear");
+        const GPUTimer::Scope passTiming(gpuTimer.get(), GPUTimer::Kind::Pass, "clear");
+        const FrameTimer::Scope phase(frameTimer, "clear", parameters.context);
         parameters.backend.bind();
+        // The stencil buffer is cleared along with the clipping masks.
         parameters.context.clear((parameters.debugOptions & MapDebugOptions::Overdraw)
                         ? Color::black()
                         : renderData.backgroundColor,
                       1.0f,
-                      0);
+                      {});
     }
 
     // - CLIPPING MASKS ----------------------------------------------------------------------------
     // Draws the clipping masks to the stencil buffer.
     {
         MBGL_DEBUG_GROUP(parameters.context, "clip");
+        const GPUTimer::Scope passTiming(gpuTimer.get(), GPUTimer::Kind::Pass, "clip");
+        FrameTimer::Scope phase(frameTimer, "clip", parameters.context);
 
         // Update all clipping IDs.
         for (const auto& source : sources) {
@@ -157,35 +303,60 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
 
         MBGL_DEBUG_GROUP(parameters.context, "clipping masks");
 
-        static const style::FillPaintProperties::PossiblyEvaluated properties {};
-        static const FillProgram::PaintPropertyBinders paintAttibuteData(properties, 0);
-
-        for (const auto& clipID : parameters.clipIDGenerator.getClipIDs()) {
-            parameters.staticData.programs.fill.get(properties).draw(
-                parameters.context,
-                gl::Triangles(),
-                gl::DepthMode::disabled(),
-                gl::StencilMode {
-                    gl::StencilMode::Always(),
-                    static_cast<int32_t>(clipID.second.reference.to_ulong()),
-                    0b11111111,
-                    gl::StencilMode::Keep,
-                    gl::StencilMode::Keep,
-                    gl::StencilMode::Replace
-                },
-                gl::ColorMode::disabled(),
-                FillProgram::UniformValues {
-                    uniforms::u_matrix::Value{ parameters.matrixForTile(clipID.first) },
-                    uniforms::u_world::Value{ parameters.context.viewport.getCurrentValue().size },
-                },
-                parameters.staticData.tileVertexBuffer,
-                parameters.staticData.quadTriangleIndexBuffer,
-                parameters.staticData.tileTriangleSegments,
-                paintAttibuteData,
-                properties,
-                parameters.state.getZoom(),
-                "clipping"
-            );
+        StencilClips clips {
+            parameters.clipIDGenerator.getClipIDs(),
+            parameters.projMatrix,
+            parameters.context.bindFramebuffer.getCurrentValue(),
+            parameters.context.viewport.getCurrentValue().size
+        };
+
+        // The masks only depend on the tiles' clip IDs and on where the tiles are on screen.
+        const bool reuseClips = stencilClips &&
+            stencilClips->clipIDs == clips.clipIDs &&
+            stencilClips->projMatrix == clips.projMatrix &&
+            stencilClips->framebuffer == clips.framebuffer &&
+            stencilClips->viewport == clips.viewport;
+
+        if (!reuseClips) {
+            phase.setCount(clips.clipIDs.size(), "drew %zu clipping masks");
+            parameters.context.clear({}, {}, 0);
+
+            static const style::FillPaintProperties::PossiblyEvaluated properties {};
+            static const FillProgram::PaintPropertyBinders paintAttibuteData(properties, 0);
+
+            for (const auto& clipID : clips.clipIDs) {
+                parameters.staticData.programs.fill.get(properties).draw(
+                    parameters.context,
+                    gl::Triangles(),
+                    gl::DepthMode::disabled(),
+                    gl::StencilMode {
+                        gl::StencilMode::Always(),
+                        static_cast<int32_t>(clipID.second.reference.to_ulong()),
+                        0b11111111,
+                        gl::StencilMode::Keep,
+                        gl::StencilMode::Keep,
+                        gl::StencilMode::Replace
+                    },
+                    gl::ColorMode::disabled(),
+                    FillProgram::UniformValues {
+                        uniforms::u_matrix::Value{ parameters.matrixForTile(clipID.first) },
+                        uniforms::u_world::Value{ parameters.context.viewport.getCurrentValue().size },
+                        uniforms::u_state_color::Value{ Color() },
+                    },
+                    parameters.staticData.tileVertexBuffer,
+                    parameters.staticData.quadTriangleIndexBuffer,
+                    parameters.staticData.tileTriangleSegments,
+                    paintAttibuteData,
+                    properties,
+                    parameters.state.getZoom()
+                );
+            }
+        }
+
+        if (parameters.contextMode == GLContextMode::Unique && parameters.backend.preservesStencilBuffer()) {
+            stencilClips = std::move(clips);
+        } else {
+            stencilClips = {};
         }
     }
 
@@ -232,19 +403,55 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
     {
         parameters.pass = RenderPass::Opaque;
         MBGL_DEBUG_GROUP(parameters.context, "opaque");
+        const GPUTimer::Scope passTiming(gpuTimer.get(), GPUTimer::Kind::Pass, "opaque");
+        FrameTimer::Scope phase(frameTimer, "opaque", parameters.context);
+        std::size_t rendered = 0;
 
         if (debug::renderTree) {
             Log::Info(Event::Render, "%*s%s {", indent++ * 4, "", "opaque");
         }
 
+        // Every layer has a depth range of its own and opaque fragments aren't blended, so the
+        // result doesn't depend on the order of opaque draws. Layers that draw with the same
+        // program are drawn one after another, in the order of the topmost of them, so that
+        // e.g. a background below all fills is still drawn last and mostly rejected by the depth
+        // test.
+        struct OpaqueItem {
+            const RenderItem* item;
+            uint32_t layer;
+            std::size_t key;
+            std::size_t group;
+        };
+        std::vector<OpaqueItem> opaqueItems;
+        std::unordered_map<std::size_t, std::size_t> groups;
+        std::size_t unbatchedChanges = 0;
         uint32_t i = 0;
         for (auto it = order.rbegin(); it != order.rend(); ++it, ++i) {
-            parameters.currentLayer = i;
             if (it->layer.hasRenderPass(parameters.pass)) {
-                MBGL_DEBUG_GROUP(parameters.context, it->layer.getID());
-                it->layer.render(parameters, it->source);
+                const std::size_t key = it->layer.opaqueProgramKey();
+                if (!opaqueItems.empty() && opaqueItems.back().key != key) {
+                    unbatchedChanges++;
+                }
+                const std::size_t group = groups.emplace(key, groups.size()).first->second;
+                opaqueItems.push_back({ &*it, i, key, group });
             }
         }
+        std::stable_sort(opaqueItems.begin(), opaqueItems.end(), [] (const auto& a, const auto& b) {
+            return a.group < b.group;
+        });
+        frameStateChangesAvoided = unbatchedChanges - (groups.empty() ? 0 : groups.size() - 1);
+
+        for (const auto& opaque : opaqueItems) {
+            const RenderItem& item = *opaque.item;
+            parameters.currentLayer = opaque.layer;
+            MBGL_DEBUG_GROUP(parameters.context, item.layer.getID());
+            const GPUTimer::Scope layerTiming(gpuTimer.get(), GPUTimer::Kind::Layer, item.layer.getID());
+            const TimePoint layerStart = Clock::now();
+            item.layer.render(parameters, item.source);
+            phase.addItem(item.layer.getID(), Clock::now() - layerStart);
+            rendered++;
+        }
+        phase.setCount(rendered, "rendered %zu layers");
 
         if (debug::renderTree) {
             Log::Info(Event::Render, "%*s%s", --indent * 4, "", "}");
@@ -256,6 +463,9 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
     {
         parameters.pass = RenderPass::Translucent;
         MBGL_DEBUG_GROUP(parameters.context, "translucent");
+        const GPUTimer::Scope passTiming(gpuTimer.get(), GPUTimer::Kind::Pass, "translucent");
+        FrameTimer::Scope phase(frameTimer, "translucent", parameters.context);
+        std::size_t rendered = 0;
 
         if (debug::renderTree) {
             Log::Info(Event::Render, "%*s%s {", indent++ * 4, "", "translucent");
@@ -266,9 +476,19 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
             parameters.currentLayer = i;
             if (it->layer.hasRenderPass(parameters.pass)) {
                 MBGL_DEBUG_GROUP(parameters.context, it->layer.getID());
+                const GPUTimer::Scope layerTiming(gpuTimer.get(), GPUTimer::Kind::Layer, it->layer.getID());
+                const TimePoint layerStart = Clock::now();
                 it->layer.render(parameters, it->source);
+                phase.addItem(it->layer.getID(), Clock::now() - layerStart);
+                rendered++;
+
+                // Custom layers may draw into the stencil buffer.
+                if (it->layer.is<RenderCustomLayer>()) {
+                    stencilClips = {};
+                }
             }
         }
+        phase.setCount(rendered, "rendered %zu layers");
 
         if (debug::renderTree) {
             Log::Info(Event::Render, "%*s%s", --indent * 4, "", "}");
@@ -281,6 +501,8 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
     // Renders debug overlays.
     {
         MBGL_DEBUG_GROUP(parameters.context, "debug");
+        const GPUTimer::Scope passTiming(gpuTimer.get(), GPUTimer::Kind::Pass, "debug");
+        const FrameTimer::Scope phase(frameTimer, "debug", parameters.context);
 
         // Finalize the rendering, e.g. by calling debug render calls per tile.
         // This guarantees that we have at least one function per tile called.
@@ -326,36 +548,126 @@ void Renderer::Impl::doRender(PaintParameters& parameters) {
 
         parameters.context.bindVertexArray = 0;
     }
+
+    frameDrawCalls = parameters.context.drawCalls;
 }
 
 std::vector<Feature> Renderer::Impl::queryRenderedFeatures(const ScreenLineString& geometry, const RenderedQueryOptions& options) const {
     return renderStyle->queryRenderedFeatures(geometry, transformState, options);
 }
 
-std::vector<Feature> Renderer::Impl::querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options) const {
+std::vector<std::vector<Feature>> Renderer::Impl::queryRenderedFeatures(const std::vector<ScreenLineString>& geometries, const RenderedQueryOptions& options) const {
+    return renderStyle->queryRenderedFeatures(geometries, transformState, options);
+}
+
+void Renderer::Impl::querySourceFeatures(const std::string& sourceID, const SourceQueryOptions& options, const SourceFeatureCallback& callback) const {
     const RenderSource* source = renderStyle->getRenderSource(sourceID);
-    if (!source) return {};
+    if (!source) return;
 
-    return source->querySourceFeatures(options);
+    source->querySourceFeatures(options, callback);
 }
 
 void Renderer::Impl::onInvalidate() {
-    observer->onInvalidate();
+    invalidateTask.send();
 }
 
 void Renderer::Impl::onResourceError(std::exception_ptr ptr) {
     observer->onResourceError(ptr);
 }
 
-void Renderer::Impl::onLowMemory() {
+void Renderer::Impl::onStyleImageMissing(const std::string& id) {
+    observer->onStyleImageMissing(id);
+}
+
+void Renderer::Impl::onLowMemory(MemoryPressure pressure) {
     BackendScope guard { backend };
+    backend.getContext().releaseTileTextures();
+    backend.getContext().releaseBufferArenas();
     backend.getContext().performCleanup();
-    renderStyle->onLowMemory();
+
+    const RendererStatistics::LowMemory freed = renderStyle->onLowMemory(pressure, workerCachesFreed);
+    statistics.lowMemoryFreed.tileCache += freed.tileCache;
+    statistics.lowMemoryFreed.queryData += freed.queryData;
+    statistics.lowMemoryFreed.workerCaches = *workerCachesFreed;
+
     observer->onInvalidate();
 }
 
+void Renderer::Impl::updateStatistics(gl::Context& context, Duration frameTime, bool complete) {
+    const Duration sinceCreation = Clock::now() - created;
+    if (statistics.frames == 0) {
+        statistics.timeToFirstFrame = sinceCreation;
+    }
+    if (complete && statistics.timeToFullFrame == Duration::zero()) {
+        statistics.timeToFullFrame = sinceCreation;
+    }
+
+    statistics.frameTime = frameTime;
+    statistics.drawCalls = frameDrawCalls;
+    statistics.stateChangesAvoided = frameStateChangesAvoided;
+    statistics.frames++;
+    statistics.skippedFrames = skippedFrames;
+    statistics.uploadedBytes = context.uploadedBytes;
+    statistics.tileTexturePoolHits = context.getTileTexturePoolStats().hits;
+    statistics.tileTexturePoolMisses = context.getTileTexturePoolStats().misses;
+    statistics.renderTargetPoolHits = context.getRenderTargetPoolStats().hits;
+    statistics.renderTargetPoolMisses = context.getRenderTargetPoolStats().misses;
+    const gl::Context::BufferArenaStats bufferArenas = context.getBufferArenaStats();
+    statistics.bufferArenas.arenas = bufferArenas.arenas;
+    statistics.bufferArenas.reservedBytes = bufferArenas.reservedBytes;
+    statistics.bufferArenas.usedBytes = bufferArenas.usedBytes;
+    statistics.bufferArenas.freeRanges = bufferArenas.freeRanges;
+    statistics.bufferArenas.largestFreeRange = bufferArenas.largestFreeRange;
+    statistics.tiles = renderStyle->getTileStatistics();
+    statistics.sourceMemory = renderStyle->getSourceMemory();
+    statistics.atlasMemory = renderStyle->getAtlasMemory();
+    statistics.workerQueueDepth = scheduler.getQueueDepth();
+    statistics.lowMemoryFreed.workerCaches = *workerCachesFreed;
+
+    const FileSource::CacheStatistics cache = fileSource.getCacheStatistics();
+    statistics.cacheHits = cache.hits;
+    statistics.cacheMisses = cache.misses;
+
+    const LayoutCache::Stats layoutCache = renderStyle->getLayoutCache().getStats();
+    statistics.layoutCacheHits = layoutCache.hits;
+    statistics.layoutCacheMisses = layoutCache.misses;
+    statistics.layoutCacheSize = layoutCache.bytes;
+
+    LayoutProfiler& layoutProfiler = renderStyle->getLayoutProfiler();
+    if (layoutProfiler.isEnabled()) {
+        statistics.layout = layoutProfiler.getProfile();
+    } else {
+        statistics.layout.clear();
+    }
+
+    observer->onDidUpdateStatistics(statistics);
+}
+
 void Renderer::Impl::dumDebugLogs() {
     renderStyle->dumpDebugLogs();
+    Log::Info(Event::Render, "Draw calls in last frame: %zu", frameDrawCalls);
+    Log::Info(Event::Render, "Repaints skipped after settled fades: %zu", skippedFrames);
+
+    const gl::Context::TexturePoolStats& textures = backend.getContext().getTileTexturePoolStats();
+    Log::Info(Event::Render, "Tile texture pool: %zu hits, %zu misses", textures.hits, textures.misses);
+
+    for (const auto& source : renderStyle->getSourceMemory()) {
+        Log::Info(Event::Render, "Memory of source %s: %zu bytes CPU, %zu bytes GPU",
+                  source.first.c_str(), source.second.cpu, source.second.gpu);
+    }
+    const RendererStatistics::Memory atlases = renderStyle->getAtlasMemory();
+    Log::Info(Event::Render, "Memory of atlases: %zu bytes CPU, %zu bytes GPU", atlases.cpu, atlases.gpu);
+
+    if (lastGPUTimings) {
+        for (const auto& pass : lastGPUTimings->passes) {
+            Log::Info(Event::Render, "GPU time of %s pass: %.3f ms", pass.first.c_str(),
+                      std::chrono::duration<double, std::milli>(pass.second).count());
+        }
+        for (const auto& layer : lastGPUTimings->layers) {
+            Log::Info(Event::Render, "GPU time of layer %s: %.3f ms", layer.first.c_str(),
+                      std::chrono::duration<double, std::milli>(layer.second).count());
+        }
+    }
 }
 
 } // namespace mbgl
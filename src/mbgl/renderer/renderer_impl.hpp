@@ -5,8 +5,20 @@
 #include <mbgl/renderer/renderer_observer.hpp>
 #include <mbgl/renderer/render_style_observer.hpp>
 #include <mbgl/renderer/frame_history.hpp>
+#include <mbgl/renderer/frame_timer.hpp>
+#include <mbgl/renderer/tile_upload_queue.hpp>
+#include <mbgl/renderer/cross_tile_symbol_index.hpp>
+#include <mbgl/renderer/feature_state.hpp>
 #include <mbgl/map/transform_state.hpp>
-
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/gl/types.hpp>
+#include <mbgl/util/async_task.hpp>
+#include <mbgl/util/clip_id.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/size.hpp>
+
+#include <atomic>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,11 +29,13 @@ class UpdateParameters;
 class PaintParameters;
 class RenderStyle;
 class RenderStaticData;
+class BucketUploader;
+class GPUTimer;
 
 class Renderer::Impl : public RenderStyleObserver {
 public:
     Impl(RendererBackend&, float pixelRatio_, FileSource&, Scheduler&, GLContextMode,
-         const optional<std::string> programCacheDir);
+         const optional<std::string> programCacheDir, const optional<std::string> localFontFamily);
     ~Impl() final;
 
     void setObserver(RendererObserver*);
@@ -29,25 +43,39 @@ public:
     void render(const UpdateParameters&);
 
     std::vector<Feature> queryRenderedFeatures(const ScreenLineString&, const RenderedQueryOptions&) const;
-    std::vector<Feature> querySourceFeatures(const std::string& sourceID, const SourceQueryOptions&) const;
+    std::vector<std::vector<Feature>> queryRenderedFeatures(const std::vector<ScreenLineString>&, const RenderedQueryOptions&) const;
+    void querySourceFeatures(const std::string& sourceID, const SourceQueryOptions&, const SourceFeatureCallback&) const;
 
-    void onLowMemory();
+    void onLowMemory(MemoryPressure);
     void dumDebugLogs();
 
     // RenderStyleObserver implementation
     void onInvalidate() override;
     void onResourceError(std::exception_ptr) override;
+    void onStyleImageMissing(const std::string&) override;
 
 private:
     void doRender(PaintParameters&);
+    void renderFrame(PaintParameters&);
+    optional<GPUTimings> collectGPUTimings();
+    void updateStatistics(gl::Context&, Duration frameTime, bool complete);
 
     friend class Renderer;
 
     RendererBackend& backend;
+    FileSource& fileSource;
+    Scheduler& scheduler;
     RendererObserver* observer;
 
+    // Added to by the tile workers as they free their caches for onLowMemory().
+    const std::shared_ptr<std::atomic<std::size_t>> workerCachesFreed = std::make_shared<std::atomic<std::size_t>>(0);
+
+    // Tiles that finish together, with their results processed in the same pass of the run loop,
+    // invalidate the map only once.
+    util::AsyncTask invalidateTask;
+
     const GLContextMode contextMode;
-    const float pixelRatio;
+    float pixelRatio;
     const optional<std::string> programCacheDir;
 
     enum class RenderState {
@@ -58,10 +86,55 @@ private:
 
     RenderState renderState = RenderState::Never;
     FrameHistory frameHistory;
+
+    // Draw calls issued while rendering the most recent frame.
+    std::size_t frameDrawCalls = 0;
+    // Program changes the last frame's opaque pass avoided by drawing layers out of order.
+    std::size_t frameStateChangesAvoided = 0;
+
+    // Frames that weren't requested because they'd have been identical to the one before.
+    std::size_t skippedFrames = 0;
+
+    // When the renderer was created, which its time to the first frames is measured from.
+    const TimePoint created = Clock::now();
+    RendererStatistics statistics;
+
+    // The clipping masks left in the stencil buffer by the previous frame, if the backend
+    // preserves it and nothing else may have drawn into it since.
+    struct StencilClips {
+        std::map<UnwrappedTileID, ClipID> clipIDs;
+        mat4 projMatrix;
+        gl::FramebufferID framebuffer;
+        Size viewport;
+    };
+    optional<StencilClips> stencilClips;
+
+    CrossTileSymbolIndex crossTileSymbolIndex;
+    // Whether buckets are left for the cross-tile symbol index to match in the next frames.
+    bool crossTileSymbolsPending = false;
+
+    FrameTimer frameTimer;
+    // Frames in continuous mode that take longer are reported to the observer. Zero disables it.
+    Duration frameBudget = Milliseconds(16);
+
+    // See Renderer::setExtrusionWallThreshold().
+    float extrusionWallThreshold = 0;
+
+    // See Renderer::setFeatureState().
+    FeatureStateStore featureStates;
+
+    bool gpuTimingEnabled = false;
+    std::unique_ptr<GPUTimer> gpuTimer;
+    optional<GPUTimings> lastGPUTimings;
+
     TransformState transformState;
 
+    // Declared ahead of renderStyle, since tiles refer to them until they're destroyed.
+    TileUploadQueue uploadQueue;
+    std::unique_ptr<BucketUploader> bucketUploader;
     std::unique_ptr<RenderStyle> renderStyle;
-    std::unique_ptr<RenderStaticData> staticData;
+    // Programs are compiled for a pixel ratio, so each ratio rendered at has its own.
+    std::map<float, std::unique_ptr<RenderStaticData>> staticData;
 };
 
 } // namespace mbgl
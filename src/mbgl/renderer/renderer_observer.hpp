@@ -1,6 +1,13 @@
 #pragma once
 
+#include <mbgl/map/missing_tile.hpp>
+#include <mbgl/renderer/gpu_timings.hpp>
+#include <mbgl/renderer/frame_timings.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
+#include <mbgl/util/optional.hpp>
+
 #include <exception>
+#include <string>
 
 namespace mbgl {
 
@@ -19,17 +26,33 @@ public:
     // Resource failed to download / parse
     virtual void onResourceError(std::exception_ptr) {}
 
+    // A symbol layer uses an image the style doesn't have, see Map::setStyleImagesOnDemand()
+    virtual void onStyleImageMissing(const std::string&) {}
+
     // First frame
     virtual void onWillStartRenderingMap() {}
 
     // Start of frame, initial is the first frame for this map
     virtual void onWillStartRenderingFrame() {}
 
-    // End of frame, boolean flags that a repaint is required
-    virtual void onDidFinishRenderingFrame(RenderMode, bool) {}
+    // End of frame, boolean flags that a repaint is required. When GPU timing is enabled, also
+    // carries the timings of an earlier frame, once the GPU has made them available.
+    virtual void onDidFinishRenderingFrame(RenderMode, bool, const optional<GPUTimings>&) {}
+
+    // Called ahead of onDidFinishRenderingFrame() in continuous mode when the frame took longer
+    // than the renderer's frame budget, with the time each phase of the frame took.
+    virtual void onSlowFrame(const FrameTimings&) {}
+
+    // Called ahead of onDidFinishRenderingFrame() with the renderer's counters, updated for
+    // the frame.
+    virtual void onDidUpdateStatistics(const RendererStatistics&) {}
 
     // Final frame
     virtual void onDidFinishRenderingMap() {}
+
+    // Called ahead of onDidFinishRenderingMap() when a still image was rendered because it timed
+    // out, with the tiles that hadn't loaded.
+    virtual void onDidRenderIncompleteStill(const MissingTiles&) {}
 };
 
 } // namespace mbgl
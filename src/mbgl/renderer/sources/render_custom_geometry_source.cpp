@@ -0,0 +1,113 @@
+#include <mbgl/renderer/sources/render_custom_geometry_source.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/tile/custom_geometry_tile.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geo.hpp>
+
+#include <mbgl/algorithm/generate_clip_ids.hpp>
+#include <mbgl/algorithm/generate_clip_ids_impl.hpp>
+
+namespace mbgl {
+
+using namespace style;
+
+RenderCustomGeometrySource::RenderCustomGeometrySource(Immutable<style::CustomGeometrySource::Impl> impl_)
+    : RenderSource(impl_) {
+    tilePyramid.setObserver(this);
+}
+
+const style::CustomGeometrySource::Impl& RenderCustomGeometrySource::impl() const {
+    return static_cast<const style::CustomGeometrySource::Impl&>(*baseImpl);
+}
+
+bool RenderCustomGeometrySource::isLoaded() const {
+    return tilePyramid.isLoaded();
+}
+
+std::vector<OverscaledTileID> RenderCustomGeometrySource::getIncompleteTiles() const {
+    return tilePyramid.getIncompleteTiles();
+}
+
+RendererStatistics::Tiles RenderCustomGeometrySource::getTileStatistics() const {
+    return tilePyramid.getTileStatistics();
+}
+
+RendererStatistics::Memory RenderCustomGeometrySource::getMemoryUsage() const {
+    return tilePyramid.getMemoryUsage();
+}
+
+void RenderCustomGeometrySource::update(Immutable<style::Source::Impl> baseImpl_,
+                                        const std::vector<Immutable<Layer::Impl>>& layers,
+                                        const bool needsRendering,
+                                        const bool needsRelayout,
+                                        const TileParameters& parameters) {
+    std::swap(baseImpl, baseImpl_);
+
+    enabled = needsRendering;
+
+    if (impl().getRevision() != revision) {
+        const optional<LatLngBounds> invalidated = impl().getInvalidatedBounds(revision);
+        revision = impl().getRevision();
+        tilePyramid.cache.clear();
+
+        // Tiles whose buffers reach into the bounds are generated again too, with a pixel of
+        // margin for the rounding of the buffer.
+        const double buffer = (impl().getTileOptions().buffer + 1.0) / util::tileSize;
+
+        for (auto const& item : tilePyramid.tiles) {
+            if (invalidated && !LatLngBounds(item.first.canonical, buffer).intersects(*invalidated)) {
+                continue;
+            }
+            static_cast<CustomGeometryTile*>(item.second.get())->invalidate();
+        }
+    }
+
+    tilePyramid.update(layers,
+                       needsRendering,
+                       needsRelayout,
+                       parameters,
+                       SourceType::CustomGeometry,
+                       util::tileSize,
+                       impl().getZoomRange(),
+                       [&] (const OverscaledTileID& tileID) {
+                           return std::make_unique<CustomGeometryTile>(tileID, impl().id, parameters,
+                                                                       impl().getTileFunction(),
+                                                                       impl().getTileOptions());
+                       });
+}
+
+void RenderCustomGeometrySource::startRender(PaintParameters& parameters) {
+    parameters.clipIDGenerator.update(tilePyramid.getRenderTiles());
+    tilePyramid.startRender(parameters);
+}
+
+void RenderCustomGeometrySource::finishRender(PaintParameters& parameters) {
+    tilePyramid.finishRender(parameters);
+}
+
+std::vector<std::reference_wrapper<RenderTile>> RenderCustomGeometrySource::getRenderTiles() {
+    return tilePyramid.getRenderTiles();
+}
+
+std::unordered_map<std::string, std::vector<Feature>>
+RenderCustomGeometrySource::queryRenderedFeatures(const ScreenLineString& geometry,
+                                                  const TransformState& transformState,
+                                                  const RenderStyle& style,
+                                                  const RenderedQueryOptions& options) const {
+    return tilePyramid.queryRenderedFeatures(geometry, transformState, style, options);
+}
+
+void RenderCustomGeometrySource::querySourceFeatures(const SourceQueryOptions& options, const SourceFeatureCallback& callback) const {
+    tilePyramid.querySourceFeatures(options, callback);
+}
+
+RendererStatistics::LowMemory RenderCustomGeometrySource::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    return tilePyramid.onLowMemory(pressure, workerCachesFreed);
+}
+
+void RenderCustomGeometrySource::dumpDebugLogs() const {
+    tilePyramid.dumpDebugLogs();
+}
+
+} // namespace mbgl
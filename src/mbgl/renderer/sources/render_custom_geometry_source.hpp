@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mbgl/renderer/render_source.hpp>
+#include <mbgl/renderer/tile_pyramid.hpp>
+#include <mbgl/style/sources/custom_geometry_source_impl.hpp>
+
+namespace mbgl {
+
+class RenderCustomGeometrySource : public RenderSource {
+public:
+    RenderCustomGeometrySource(Immutable<style::CustomGeometrySource::Impl>);
+
+    bool isLoaded() const final;
+    std::vector<OverscaledTileID> getIncompleteTiles() const final;
+    RendererStatistics::Tiles getTileStatistics() const final;
+    RendererStatistics::Memory getMemoryUsage() const final;
+
+    void update(Immutable<style::Source::Impl>,
+                const std::vector<Immutable<style::Layer::Impl>>&,
+                bool needsRendering,
+                bool needsRelayout,
+                const TileParameters&) final;
+
+    void startRender(PaintParameters&) final;
+    void finishRender(PaintParameters&) final;
+
+    std::vector<std::reference_wrapper<RenderTile>> getRenderTiles() final;
+
+    std::unordered_map<std::string, std::vector<Feature>>
+    queryRenderedFeatures(const ScreenLineString& geometry,
+                          const TransformState& transformState,
+                          const RenderStyle& style,
+                          const RenderedQueryOptions& options) const final;
+
+    void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const final;
+
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) final;
+    void dumpDebugLogs() const final;
+
+private:
+    const style::CustomGeometrySource::Impl& impl() const;
+
+    TilePyramid tilePyramid;
+    // The revision of the source that the tiles were invalidated for last.
+    uint64_t revision = 0;
+};
+
+template <>
+inline bool RenderSource::is<RenderCustomGeometrySource>() const {
+    return baseImpl->type == SourceType::CustomGeometry;
+}
+
+} // namespace mbgl
@@ -2,6 +2,10 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
 
 #include <mbgl/algorithm/generate_clip_ids.hpp>
 #include <mbgl/algorithm/generate_clip_ids_impl.hpp>
@@ -10,6 +14,21 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+bool intersects(const LatLngBounds& tile, const LatLngBounds& changed) {
+    // The buffers of tiles at the antimeridian extend past it.
+    for (const double shift : { -360.0, 0.0, 360.0 }) {
+        if (tile.intersects(LatLngBounds::hull({ changed.south(), changed.west() + shift },
+                                               { changed.north(), changed.east() + shift }))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 RenderGeoJSONSource::RenderGeoJSONSource(Immutable<style::GeoJSONSource::Impl> impl_)
     : RenderSource(impl_) {
     tilePyramid.setObserver(this);
@@ -23,6 +42,18 @@ bool RenderGeoJSONSource::isLoaded() const {
     return tilePyramid.isLoaded();
 }
 
+std::vector<OverscaledTileID> RenderGeoJSONSource::getIncompleteTiles() const {
+    return tilePyramid.getIncompleteTiles();
+}
+
+RendererStatistics::Tiles RenderGeoJSONSource::getTileStatistics() const {
+    return tilePyramid.getTileStatistics();
+}
+
+RendererStatistics::Memory RenderGeoJSONSource::getMemoryUsage() const {
+    return tilePyramid.getMemoryUsage();
+}
+
 void RenderGeoJSONSource::update(Immutable<style::Source::Impl> baseImpl_,
                                  const std::vector<Immutable<Layer::Impl>>& layers,
                                  const bool needsRendering,
@@ -42,8 +73,23 @@ void RenderGeoJSONSource::update(Immutable<style::Source::Impl> baseImpl_,
         data = data_;
         tilePyramid.cache.clear();
 
+        // Updates of some features only change the tiles they are in. Clusters can change
+        // anywhere near them.
+        optional<LatLngBounds> changed;
+        if (!impl().getOptions().cluster) {
+            changed = impl().getChangedBounds(dataID);
+        }
+        dataID = impl().getDataID();
+
+        // With a pixel of margin for the rounding of the buffer.
+        const double buffer = (impl().getOptions().buffer + 1.0) / util::tileSize;
+
         for (auto const& item : tilePyramid.tiles) {
-            static_cast<GeoJSONTile*>(item.second.get())->updateData(data->getTile(item.first.canonical));
+            const CanonicalTileID& tileID = item.first.canonical;
+            if (changed && (changed->isEmpty() || !intersects(LatLngBounds(tileID, buffer), *changed))) {
+                continue;
+            }
+            static_cast<GeoJSONTile*>(item.second.get())->updateData(data->getTile(tileID));
         }
     }
 
@@ -80,15 +126,19 @@ RenderGeoJSONSource::queryRenderedFeatures(const ScreenLineString& geometry,
     return tilePyramid.queryRenderedFeatures(geometry, transformState, style, options);
 }
 
-std::vector<Feature> RenderGeoJSONSource::querySourceFeatures(const SourceQueryOptions& options) const {
-    return tilePyramid.querySourceFeatures(options);
+void RenderGeoJSONSource::querySourceFeatures(const SourceQueryOptions& options, const SourceFeatureCallback& callback) const {
+    tilePyramid.querySourceFeatures(options, callback);
 }
 
-void RenderGeoJSONSource::onLowMemory() {
-    tilePyramid.onLowMemory();
+RendererStatistics::LowMemory RenderGeoJSONSource::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    return tilePyramid.onLowMemory(pressure, workerCachesFreed);
 }
 
 void RenderGeoJSONSource::dumpDebugLogs() const {
+    if (data) {
+        Log::Info(Event::General, "GeoJSONSource::%s: %s indexed tiles", impl().id.c_str(),
+                  util::toString(data->getIndexedTileCount()).c_str());
+    }
     tilePyramid.dumpDebugLogs();
 }
 
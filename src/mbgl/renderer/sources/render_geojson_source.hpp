@@ -15,6 +15,9 @@ public:
     RenderGeoJSONSource(Immutable<style::GeoJSONSource::Impl>);
 
     bool isLoaded() const final;
+    std::vector<OverscaledTileID> getIncompleteTiles() const final;
+    RendererStatistics::Tiles getTileStatistics() const final;
+    RendererStatistics::Memory getMemoryUsage() const final;
 
     void update(Immutable<style::Source::Impl>,
                 const std::vector<Immutable<style::Layer::Impl>>&,
@@ -33,10 +36,9 @@ public:
                           const RenderStyle& style,
                           const RenderedQueryOptions& options) const final;
 
-    std::vector<Feature>
-    querySourceFeatures(const SourceQueryOptions&) const final;
+    void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const final;
 
-    void onLowMemory() final;
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) final;
     void dumpDebugLogs() const final;
 
 private:
@@ -44,6 +46,7 @@ private:
 
     TilePyramid tilePyramid;
     style::GeoJSONData* data = nullptr;
+    uint64_t dataID = 0;
 };
 
 template <>
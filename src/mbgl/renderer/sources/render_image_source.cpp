@@ -30,6 +30,10 @@ bool RenderImageSource::isLoaded() const {
     return !!bucket;
 }
 
+RendererStatistics::Memory RenderImageSource::getMemoryUsage() const {
+    return bucket ? bucket->memoryUsage() : RendererStatistics::Memory();
+}
+
 void RenderImageSource::startRender(PaintParameters& parameters) {
     if (!isLoaded()) {
         return;
@@ -39,9 +43,7 @@ void RenderImageSource::startRender(PaintParameters& parameters) {
 
     for (size_t i = 0; i < tileIds.size(); i++) {
         mat4 matrix;
-        matrix::identity(matrix);
-        parameters.state.matrixFor(matrix, tileIds[i]);
-        matrix::multiply(matrix, parameters.projMatrix, matrix);
+        parameters.state.matrixFor(matrix, tileIds[i], parameters.projMatrix);
         matrices.push_back(matrix);
     }
 
@@ -59,7 +61,7 @@ void RenderImageSource::finishRender(PaintParameters& parameters) {
     static const DebugProgram::PaintPropertyBinders paintAttibuteData(properties, 0);
 
     for (auto matrix : matrices) {
-        parameters.programs.debug.draw(
+        parameters.programs.debug.get().draw(
             parameters.context,
             gl::LineStrip { 4.0f * parameters.pixelRatio },
             gl::DepthMode::disabled(),
@@ -74,8 +76,7 @@ void RenderImageSource::finishRender(PaintParameters& parameters) {
             parameters.staticData.tileBorderSegments,
             paintAttibuteData,
             properties,
-            parameters.state.getZoom(),
-            "debug"
+            parameters.state.getZoom()
         );
     }
 }
@@ -88,8 +89,7 @@ RenderImageSource::queryRenderedFeatures(const ScreenLineString&,
     return std::unordered_map<std::string, std::vector<Feature>> {};
 }
 
-std::vector<Feature> RenderImageSource::querySourceFeatures(const SourceQueryOptions&) const {
-    return {};
+void RenderImageSource::querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const {
 }
 
 void RenderImageSource::update(Immutable<style::Source::Impl> baseImpl_,
@@ -185,6 +185,15 @@ void RenderImageSource::update(Immutable<style::Source::Impl> baseImpl_,
         bucket = std::make_unique<RasterBucket>(image);
     } else {
         bucket->clear();
+    }
+
+    const auto& frames = impl().getFrames();
+    if (frames.size() > 1) {
+        // Animated sources switch between textures of all their frames.
+        bucket->setFrames(frames);
+        bucket->frame = impl().getFrame();
+    } else {
+        bucket->setFrames({});
         if (image != bucket->image) {
             bucket->setImage(image);
         }
@@ -15,6 +15,16 @@ public:
 
     bool isLoaded() const final;
 
+    std::vector<OverscaledTileID> getIncompleteTiles() const final {
+        return {};
+    }
+
+    RendererStatistics::Tiles getTileStatistics() const final {
+        return {};
+    }
+
+    RendererStatistics::Memory getMemoryUsage() const final;
+
     void startRender(PaintParameters&) final;
     void finishRender(PaintParameters&) final;
 
@@ -34,9 +44,10 @@ public:
                           const RenderStyle& style,
                           const RenderedQueryOptions& options) const final;
 
-    std::vector<Feature> querySourceFeatures(const SourceQueryOptions&) const final;
+    void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const final;
 
-    void onLowMemory() final {
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>&) final {
+        return {};
     }
     void dumpDebugLogs() const final;
 
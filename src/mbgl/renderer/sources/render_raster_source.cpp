@@ -1,7 +1,11 @@
 #include <mbgl/renderer/sources/render_raster_source.hpp>
 #include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/algorithm/update_tile_masks.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <cmath>
 
 namespace mbgl {
 
@@ -20,6 +24,18 @@ bool RenderRasterSource::isLoaded() const {
     return tilePyramid.isLoaded();
 }
 
+std::vector<OverscaledTileID> RenderRasterSource::getIncompleteTiles() const {
+    return tilePyramid.getIncompleteTiles();
+}
+
+RendererStatistics::Tiles RenderRasterSource::getTileStatistics() const {
+    return tilePyramid.getTileStatistics();
+}
+
+RendererStatistics::Memory RenderRasterSource::getMemoryUsage() const {
+    return tilePyramid.getMemoryUsage();
+}
+
 void RenderRasterSource::update(Immutable<style::Source::Impl> baseImpl_,
                                 const std::vector<Immutable<Layer::Impl>>& layers,
                                 const bool needsRendering,
@@ -49,16 +65,84 @@ void RenderRasterSource::update(Immutable<style::Source::Impl> baseImpl_,
                        needsRendering,
                        needsRelayout,
                        parameters,
-                       SourceType::Raster,
+                       baseImpl->type,
                        impl().getTileSize(),
                        tileset->zoomRange,
                        [&] (const OverscaledTileID& tileID) {
-                           return std::make_unique<RasterTile>(tileID, parameters, *tileset);
+                           return std::make_unique<RasterTile>(tileID, parameters, *tileset, impl().getTileSize(), baseImpl->type);
                        });
 }
 
+void RenderRasterSource::backfillBorders() {
+    for (auto& entry : tilePyramid.tiles) {
+        auto& tile = static_cast<RasterTile&>(*entry.second);
+        if (!tile.needsBackfill()) {
+            continue;
+        }
+
+        const OverscaledTileID& id = entry.first;
+        const int64_t worldSize = 1ll << id.canonical.z;
+        for (int8_t dy = -1; dy <= 1; dy++) {
+            const int64_t y = int64_t(id.canonical.y) + dy;
+            if (y < 0 || y >= worldSize) {
+                continue;
+            }
+            for (int8_t dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) {
+                    continue;
+                }
+
+                // Neighbors across the antimeridian are in the next world copy.
+                int64_t x = int64_t(id.canonical.x) + dx;
+                int16_t wrap = id.wrap;
+                if (x < 0) {
+                    x += worldSize;
+                    wrap--;
+                } else if (x >= worldSize) {
+                    x -= worldSize;
+                    wrap++;
+                }
+
+                auto neighbor = tilePyramid.tiles.find(
+                    OverscaledTileID(id.overscaledZ, wrap, id.canonical.z, uint32_t(x), uint32_t(y)));
+                if (neighbor != tilePyramid.tiles.end()) {
+                    tile.backfillBorder(static_cast<const RasterTile&>(*neighbor->second), dx, dy);
+                }
+            }
+        }
+    }
+}
+
 void RenderRasterSource::startRender(PaintParameters& parameters) {
-    algorithm::updateTileMasks(tilePyramid.getRenderTiles());
+    if (baseImpl->type == SourceType::RasterDEM) {
+        backfillBorders();
+    }
+
+    nextMaskedTiles.clear();
+    for (const RenderTile& renderTile : tilePyramid.renderTiles) {
+        nextMaskedTiles.push_back({ renderTile.id,
+                                    static_cast<const RasterTile&>(renderTile.tile).getMask(),
+                                    renderTile.used });
+    }
+    if (nextMaskedTiles != maskedTiles) {
+        algorithm::updateTileMasks(tilePyramid.getRenderTiles());
+        for (RenderTile& renderTile : tilePyramid.renderTiles) {
+            static_cast<RasterTile&>(renderTile.tile).updateMaskGeometry(maskCache, parameters.context);
+        }
+        std::swap(maskedTiles, nextMaskedTiles);
+    }
+
+    tileArea = 0;
+    drawnArea = 0;
+    for (const RenderTile& renderTile : tilePyramid.renderTiles) {
+        const TileMask* mask = static_cast<const RasterTile&>(renderTile.tile).getMask();
+        if (renderTile.used && mask) {
+            const double area = std::ldexp(1.0, -2 * renderTile.id.canonical.z);
+            tileArea += area;
+            drawnArea += area * maskedArea(*mask);
+        }
+    }
+
     tilePyramid.startRender(parameters);
 }
 
@@ -78,16 +162,17 @@ RenderRasterSource::queryRenderedFeatures(const ScreenLineString&,
     return std::unordered_map<std::string, std::vector<Feature>> {};
 }
 
-std::vector<Feature> RenderRasterSource::querySourceFeatures(const SourceQueryOptions&) const {
-    return {};
+void RenderRasterSource::querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const {
 }
 
-void RenderRasterSource::onLowMemory() {
-    tilePyramid.onLowMemory();
+RendererStatistics::LowMemory RenderRasterSource::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    return tilePyramid.onLowMemory(pressure, workerCachesFreed);
 }
 
 void RenderRasterSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
+    Log::Info(Event::General, "RenderRasterSource::%s overdraw without tile masks: %.2fx",
+              baseImpl->id.c_str(), drawnArea > 0 ? tileArea / drawnArea : 1.0);
 }
 
 } // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/renderer/render_source.hpp>
 #include <mbgl/renderer/tile_pyramid.hpp>
+#include <mbgl/renderer/tile_mask_cache.hpp>
 #include <mbgl/style/sources/raster_source_impl.hpp>
 
 namespace mbgl {
@@ -11,6 +12,9 @@ public:
     RenderRasterSource(Immutable<style::RasterSource::Impl>);
 
     bool isLoaded() const final;
+    std::vector<OverscaledTileID> getIncompleteTiles() const final;
+    RendererStatistics::Tiles getTileStatistics() const final;
+    RendererStatistics::Memory getMemoryUsage() const final;
 
     void update(Immutable<style::Source::Impl>,
                 const std::vector<Immutable<style::Layer::Impl>>&,
@@ -29,22 +33,45 @@ public:
                           const RenderStyle& style,
                           const RenderedQueryOptions& options) const final;
 
-    std::vector<Feature>
-    querySourceFeatures(const SourceQueryOptions&) const final;
+    void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const final;
 
-    void onLowMemory() final;
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) final;
     void dumpDebugLogs() const final;
 
 private:
     const style::RasterSource::Impl& impl() const;
 
+    // Fills in the borders of elevation tiles from the tiles around them.
+    void backfillBorders();
+
     TilePyramid tilePyramid;
     optional<std::vector<std::string>> tileURLTemplates;
+
+    // The areas of the tiles drawn in the last frame, in fractions of the world: in full, and of
+    // the parts left by their masks. Without masks, fallback tiles would overdraw by their ratio.
+    double tileArea = 0;
+    double drawnArea = 0;
+
+    // The render tiles that the masks were last computed for, and the masks of their buckets. The
+    // masks only need computing again when either changes.
+    struct MaskedTile {
+        UnwrappedTileID id;
+        const TileMask* mask;
+        bool used;
+
+        bool operator==(const MaskedTile& rhs) const {
+            return id == rhs.id && mask == rhs.mask && used == rhs.used;
+        }
+    };
+    std::vector<MaskedTile> maskedTiles;
+    std::vector<MaskedTile> nextMaskedTiles;
+
+    TileMaskCache maskCache;
 };
 
 template <>
 inline bool RenderSource::is<RenderRasterSource>() const {
-    return baseImpl->type == SourceType::Raster;
+    return baseImpl->type == SourceType::Raster || baseImpl->type == SourceType::RasterDEM;
 }
 
 } // namespace mbgl
@@ -23,6 +23,18 @@ bool RenderVectorSource::isLoaded() const {
     return tilePyramid.isLoaded();
 }
 
+std::vector<OverscaledTileID> RenderVectorSource::getIncompleteTiles() const {
+    return tilePyramid.getIncompleteTiles();
+}
+
+RendererStatistics::Tiles RenderVectorSource::getTileStatistics() const {
+    return tilePyramid.getTileStatistics();
+}
+
+RendererStatistics::Memory RenderVectorSource::getMemoryUsage() const {
+    return tilePyramid.getMemoryUsage();
+}
+
 void RenderVectorSource::update(Immutable<style::Source::Impl> baseImpl_,
                                 const std::vector<Immutable<Layer::Impl>>& layers,
                                 const bool needsRendering,
@@ -38,8 +50,10 @@ void RenderVectorSource::update(Immutable<style::Source::Impl> baseImpl_,
         return;
     }
 
-    if (tileURLTemplates != tileset->tiles) {
+    if (tileURLTemplates != tileset->tiles ||
+        simplificationTolerance != impl().getSimplificationTolerance()) {
         tileURLTemplates = tileset->tiles;
+        simplificationTolerance = impl().getSimplificationTolerance();
 
         // TODO: this removes existing buckets, and will cause flickering.
         // Should instead refresh tile data in place.
@@ -55,8 +69,12 @@ void RenderVectorSource::update(Immutable<style::Source::Impl> baseImpl_,
                        SourceType::Vector,
                        util::tileSize,
                        tileset->zoomRange,
-                       [&] (const OverscaledTileID& tileID) {
-                           return std::make_unique<VectorTile>(tileID, impl().id, parameters, *tileset);
+                       [&] (const OverscaledTileID& tileID) -> std::unique_ptr<Tile> {
+                           // Inline and custom tilesets may have no tile URLs, and load no tiles.
+                           if (tileset->tiles.empty()) {
+                               return nullptr;
+                           }
+                           return std::make_unique<VectorTile>(tileID, impl().id, parameters, *tileset, simplificationTolerance);
                        });
 }
 
@@ -81,12 +99,12 @@ RenderVectorSource::queryRenderedFeatures(const ScreenLineString& geometry,
     return tilePyramid.queryRenderedFeatures(geometry, transformState, style, options);
 }
 
-std::vector<Feature> RenderVectorSource::querySourceFeatures(const SourceQueryOptions& options) const {
-    return tilePyramid.querySourceFeatures(options);
+void RenderVectorSource::querySourceFeatures(const SourceQueryOptions& options, const SourceFeatureCallback& callback) const {
+    tilePyramid.querySourceFeatures(options, callback);
 }
 
-void RenderVectorSource::onLowMemory() {
-    tilePyramid.onLowMemory();
+RendererStatistics::LowMemory RenderVectorSource::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    return tilePyramid.onLowMemory(pressure, workerCachesFreed);
 }
 
 void RenderVectorSource::dumpDebugLogs() const {
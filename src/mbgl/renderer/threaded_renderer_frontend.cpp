@@ -0,0 +1,173 @@
+#include <mbgl/renderer/threaded_renderer_frontend.hpp>
+#include <mbgl/renderer/renderer.hpp>
+#include <mbgl/renderer/renderer_observer.hpp>
+#include <mbgl/renderer/backend_scope.hpp>
+#include <mbgl/renderer/update_parameters.hpp>
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <cassert>
+#include <future>
+
+namespace mbgl {
+
+namespace {
+
+// Forwards the notifications of the renderer to the thread of the map.
+class ForwardingRendererObserver : public RendererObserver {
+public:
+    ForwardingRendererObserver(Scheduler& scheduler, RendererObserver& observer)
+        : mailbox(std::make_shared<Mailbox>(scheduler)),
+          delegate(observer, mailbox) {
+    }
+
+    ~ForwardingRendererObserver() override {
+        mailbox->close();
+    }
+
+    void onInvalidate() override {
+        delegate.coalesce(&RendererObserver::onInvalidate);
+    }
+
+    void onResourceError(std::exception_ptr error) override {
+        delegate.invoke(&RendererObserver::onResourceError, error);
+    }
+
+    void onWillStartRenderingMap() override {
+        delegate.invoke(&RendererObserver::onWillStartRenderingMap);
+    }
+
+    void onWillStartRenderingFrame() override {
+        delegate.invoke(&RendererObserver::onWillStartRenderingFrame);
+    }
+
+    void onDidFinishRenderingFrame(RenderMode mode, bool repaint, const optional<GPUTimings>& timings) override {
+        delegate.invoke(&RendererObserver::onDidFinishRenderingFrame, mode, repaint, timings);
+    }
+
+    void onSlowFrame(const FrameTimings& timings) override {
+        delegate.invoke(&RendererObserver::onSlowFrame, timings);
+    }
+
+    void onDidUpdateStatistics(const RendererStatistics& statistics) override {
+        delegate.coalesce(&RendererObserver::onDidUpdateStatistics, statistics);
+    }
+
+    void onDidFinishRenderingMap() override {
+        delegate.invoke(&RendererObserver::onDidFinishRenderingMap);
+    }
+
+    void onDidRenderIncompleteStill(const MissingTiles& missing) override {
+        delegate.invoke(&RendererObserver::onDidRenderIncompleteStill, missing);
+    }
+
+    void onStyleImageMissing(const std::string& id) override {
+        delegate.invoke(&RendererObserver::onStyleImageMissing, id);
+    }
+
+private:
+    std::shared_ptr<Mailbox> mailbox;
+    ActorRef<RendererObserver> delegate;
+};
+
+// Owns the renderer, on the render thread.
+class RenderThread {
+public:
+    RenderThread(ActorRef<RenderThread>,
+                 RendererBackend& backend_,
+                 float pixelRatio,
+                 FileSource& fileSource,
+                 Scheduler& scheduler,
+                 GLContextMode contextMode,
+                 const optional<std::string> programCacheDir)
+        : backend(backend_),
+          renderer(std::make_unique<Renderer>(backend, pixelRatio, fileSource, scheduler,
+                                              contextMode, programCacheDir)) {
+    }
+
+    ~RenderThread() {
+        BackendScope guard { backend };
+        renderer.reset();
+    }
+
+    void setObserver(std::shared_ptr<RendererObserver> observer_) {
+        observer = std::move(observer_);
+        renderer->setObserver(observer.get());
+    }
+
+    void render(std::shared_ptr<UpdateParameters> parameters) {
+        BackendScope guard { backend };
+        renderer->render(*parameters);
+    }
+
+    void run(std::function<void (Renderer&)> fn, std::promise<void>* done) {
+        fn(*renderer);
+        done->set_value();
+    }
+
+private:
+    RendererBackend& backend;
+    std::shared_ptr<RendererObserver> observer;
+    std::unique_ptr<Renderer> renderer;
+};
+
+} // namespace
+
+class ThreadedRendererFrontend::Impl {
+public:
+    Impl(RendererBackend& backend, float pixelRatio, FileSource& fileSource, Scheduler& scheduler,
+         GLContextMode contextMode, const optional<std::string> programCacheDir)
+        : thread(std::make_unique<util::Thread<RenderThread>>(
+              "Render", backend, pixelRatio, fileSource, scheduler, contextMode, programCacheDir)) {
+    }
+
+    util::RunLoop& loop = *util::RunLoop::Get();
+    std::shared_ptr<RendererObserver> observer;
+    std::unique_ptr<util::Thread<RenderThread>> thread;
+};
+
+ThreadedRendererFrontend::ThreadedRendererFrontend(RendererBackend& backend,
+                                                   float pixelRatio,
+                                                   FileSource& fileSource,
+                                                   Scheduler& scheduler,
+                                                   GLContextMode contextMode,
+                                                   const optional<std::string> programCacheDir)
+    : impl(std::make_unique<Impl>(backend, pixelRatio, fileSource, scheduler, contextMode, programCacheDir)) {
+}
+
+ThreadedRendererFrontend::~ThreadedRendererFrontend() {
+    reset();
+}
+
+void ThreadedRendererFrontend::reset() {
+    // Stopping the thread destroys the renderer first, so nothing notifies the observer anymore.
+    impl->thread.reset();
+    impl->observer.reset();
+}
+
+void ThreadedRendererFrontend::setObserver(RendererObserver& observer) {
+    assert(impl->thread);
+    // The render thread holds on to the observer it's been using until it gets the new one.
+    impl->observer = std::make_shared<ForwardingRendererObserver>(impl->loop, observer);
+    impl->thread->actor().invoke(&RenderThread::setObserver, impl->observer);
+}
+
+void ThreadedRendererFrontend::update(std::shared_ptr<UpdateParameters> parameters) {
+    assert(impl->thread);
+
+    // Renders that haven't started yet are superseded by this one.
+    impl->thread->actor().coalesce(&RenderThread::render, std::move(parameters));
+}
+
+void ThreadedRendererFrontend::withRenderer(std::function<void (Renderer&)> fn) {
+    assert(impl->thread);
+
+    std::promise<void> done;
+    auto future = done.get_future();
+    impl->thread->actor().invoke(&RenderThread::run, std::move(fn), &done);
+    future.get();
+}
+
+} // namespace mbgl
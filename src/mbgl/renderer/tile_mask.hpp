@@ -2,6 +2,7 @@
 
 #include <mbgl/tile/tile_id.hpp>
 
+#include <cmath>
 #include <set>
 
 namespace mbgl {
@@ -12,4 +13,13 @@ namespace mbgl {
 // TileMasks are typically generated with algorithm::updateTileMasks().
 using TileMask = std::set<CanonicalTileID>;
 
+// The fraction of its tile that is rendered with the mask.
+inline double maskedArea(const TileMask& mask) {
+    double area = 0;
+    for (const auto& id : mask) {
+        area += std::ldexp(1.0, -2 * id.z);
+    }
+    return area;
+}
+
 } // namespace mbgl
@@ -0,0 +1,88 @@
+#include <mbgl/renderer/tile_mask_cache.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <cassert>
+#include <limits>
+
+namespace mbgl {
+
+TileMaskGeometry::TileMaskGeometry(const TileMask& mask) {
+    // Create a segment even when there is nothing to draw for this mask, so that (empty) buffers
+    // are uploaded.
+    segments.emplace_back(0, 0);
+
+    constexpr const uint16_t vertexLength = 4;
+
+    // Create the vertex buffer for the specified tile mask.
+    for (const auto& id : mask) {
+        // Create a quad for every masked tile.
+        const int32_t vertexExtent = util::EXTENT >> id.z;
+
+        const Point<int16_t> tlVertex = { static_cast<int16_t>(id.x * vertexExtent),
+                                          static_cast<int16_t>(id.y * vertexExtent) };
+        const Point<int16_t> brVertex = { static_cast<int16_t>(tlVertex.x + vertexExtent),
+                                          static_cast<int16_t>(tlVertex.y + vertexExtent) };
+
+        if (segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
+            // Move to a new segments because the old one can't hold the geometry.
+            segments.emplace_back(vertices.vertexSize(), indices.indexSize());
+        }
+
+        vertices.emplace_back(
+            RasterProgram::layoutVertex({ tlVertex.x, tlVertex.y }, { static_cast<uint16_t>(tlVertex.x), static_cast<uint16_t>(tlVertex.y) }));
+        vertices.emplace_back(
+            RasterProgram::layoutVertex({ brVertex.x, tlVertex.y }, { static_cast<uint16_t>(brVertex.x), static_cast<uint16_t>(tlVertex.y) }));
+        vertices.emplace_back(
+            RasterProgram::layoutVertex({ tlVertex.x, brVertex.y }, { static_cast<uint16_t>(tlVertex.x), static_cast<uint16_t>(brVertex.y) }));
+        vertices.emplace_back(
+            RasterProgram::layoutVertex({ brVertex.x, brVertex.y }, { static_cast<uint16_t>(brVertex.x), static_cast<uint16_t>(brVertex.y) }));
+
+        auto& segment = segments.back();
+        assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
+        const uint16_t offset = segment.vertexLength;
+
+        // 0, 1, 2
+        // 1, 2, 3
+        indices.emplace_back(offset, offset + 1, offset + 2);
+        indices.emplace_back(offset + 1, offset + 2, offset + 3);
+
+        segment.vertexLength += vertexLength;
+        segment.indexLength += 6;
+    }
+}
+
+void TileMaskGeometry::upload(gl::Context& context) {
+    if (!vertexBuffer) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = context.createIndexBuffer(std::move(indices));
+    }
+}
+
+std::shared_ptr<TileMaskGeometry> TileMaskCache::get(const TileMask& mask) {
+    if (mask == TileMask{ { 0, 0, 0 } }) {
+        return {};
+    }
+
+    auto it = entries.find(mask);
+    if (it != entries.end()) {
+        if (auto geometry = it->second.lock()) {
+            return geometry;
+        }
+    }
+
+    // Drop the masks that no tile uses anymore before adding another one.
+    for (auto entry = entries.begin(); entry != entries.end();) {
+        if (entry->second.expired()) {
+            entry = entries.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+
+    auto geometry = std::make_shared<TileMaskGeometry>(mask);
+    entries[mask] = geometry;
+    return geometry;
+}
+
+} // namespace mbgl
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/programs/raster_program.hpp>
+#include <mbgl/renderer/tile_mask.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <map>
+#include <memory>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+// The quads of the parts of a tile that a mask leaves to be drawn.
+class TileMaskGeometry : private util::noncopyable {
+public:
+    explicit TileMaskGeometry(const TileMask&);
+
+    // Uploads the buffers the first time it's called.
+    void upload(gl::Context&);
+
+    gl::VertexVector<RasterLayoutVertex> vertices;
+    gl::IndexVector<gl::Triangles> indices;
+    SegmentVector<RasterAttributes> segments;
+
+    optional<gl::VertexBuffer<RasterLayoutVertex>> vertexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+};
+
+// Hands out the geometry of each distinct tile mask, so that the tiles drawn with the same mask
+// share its buffers. The geometry is kept for as long as a tile uses it.
+class TileMaskCache {
+public:
+    // Nothing for the mask of the full tile, which is drawn with the tile buffers that
+    // RenderStaticData shares.
+    std::shared_ptr<TileMaskGeometry> get(const TileMask&);
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+private:
+    std::map<TileMask, std::weak_ptr<TileMaskGeometry>> entries;
+};
+
+} // namespace mbgl
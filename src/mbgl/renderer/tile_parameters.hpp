@@ -1,15 +1,24 @@
 #pragma once
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/transform_state.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <vector>
 
 namespace mbgl {
 
-class TransformState;
 class Scheduler;
 class FileSource;
 class AnnotationManager;
 class ImageManager;
 class GlyphManager;
+class BucketUploader;
+class TileUploadQueue;
+class LineBreakCache;
+class LayoutProfiler;
+class TileSnapshot;
+class LayoutCache;
 
 class TileParameters {
 public:
@@ -23,6 +32,17 @@ public:
     ImageManager& imageManager;
     GlyphManager& glyphManager;
     const uint8_t prefetchZoomDelta;
+    const uint64_t tileCacheSize;
+    const std::vector<TransformState> transitionKeyframes;
+    BucketUploader* const bucketUploader = nullptr;
+    TileUploadQueue* const uploadQueue = nullptr;
+    const bool instancing = false;
+    LineBreakCache* const lineBreakCache = nullptr;
+    const uint32_t placementBudget = 0;
+    LayoutProfiler* const layoutProfiler = nullptr;
+    const optional<double> tileLODBias = {};
+    TileSnapshot* const tileSnapshot = nullptr;
+    LayoutCache* const layoutCache = nullptr;
 };
 
 } // namespace mbgl
@@ -2,20 +2,28 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/render_source.hpp>
+#include <mbgl/renderer/render_style.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/parallel.hpp>
 
 #include <mbgl/algorithm/update_renderables.hpp>
 
 #include <mapbox/geometry/envelope.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <utility>
 
 namespace mbgl {
 
@@ -29,6 +37,18 @@ TilePyramid::TilePyramid()
 
 TilePyramid::~TilePyramid() = default;
 
+// The tiles are kept in hash order, which differs from run to run. Where the order shows, e.g. in
+// the order of query results or of the tiles moved to the cache, they're visited in ID order.
+std::vector<OverscaledTileID> TilePyramid::getTileIDs() const {
+    std::vector<OverscaledTileID> result;
+    result.reserve(tiles.size());
+    for (const auto& pair : tiles) {
+        result.push_back(pair.first);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
 bool TilePyramid::isLoaded() const {
     for (const auto& pair : tiles) {
         if (!pair.second->isComplete()) {
@@ -39,6 +59,40 @@ bool TilePyramid::isLoaded() const {
     return true;
 }
 
+std::vector<OverscaledTileID> TilePyramid::getIncompleteTiles() const {
+    std::vector<OverscaledTileID> result;
+    for (const auto& pair : tiles) {
+        if (!pair.second->isComplete()) {
+            result.push_back(pair.first);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+RendererStatistics::Tiles TilePyramid::getTileStatistics() const {
+    RendererStatistics::Tiles result;
+    for (const auto& pair : tiles) {
+        if (!pair.second->isLoaded()) {
+            result.loading++;
+        } else if (!pair.second->isComplete()) {
+            result.pending++;
+        } else {
+            result.complete++;
+        }
+    }
+    result.cached = cache.getCount();
+    return result;
+}
+
+RendererStatistics::Memory TilePyramid::getMemoryUsage() const {
+    RendererStatistics::Memory result = cache.getMemoryUsage();
+    for (const auto& pair : tiles) {
+        result += pair.second->memoryUsage();
+    }
+    return result;
+}
+
 void TilePyramid::startRender(PaintParameters& parameters) {
     for (auto& tile : renderTiles) {
         tile.startRender(parameters);
@@ -51,6 +105,17 @@ void TilePyramid::finishRender(PaintParameters& parameters) {
     }
 }
 
+// Tiles at the zoom level we're actually trying to display come before fallback tiles at other
+// zoom levels; within each zoom level, tiles closer to the center of the viewport come first.
+static int32_t tilePriority(const OverscaledTileID& id, const TileCoordinate& center, int32_t idealZoom) {
+    const double scale = std::pow(2.0, id.canonical.z);
+    const TileCoordinate zoomed = center.zoomTo(id.canonical.z);
+    const double dx = id.canonical.x + id.wrap * scale + 0.5 - zoomed.p.x;
+    const double dy = id.canonical.y + 0.5 - zoomed.p.y;
+    const double distance = std::min(std::sqrt(dx * dx + dy * dy) * 16, 1023.0);
+    return -(std::abs(id.overscaledZ - idealZoom) * 1024 + int32_t(distance));
+}
+
 std::vector<std::reference_wrapper<RenderTile>> TilePyramid::getRenderTiles() {
     return { renderTiles.begin(), renderTiles.end() };
 }
@@ -88,14 +153,15 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
     int32_t tileZoom = overscaledZoom;
     int32_t panZoom = zoomRange.max;
 
-    std::vector<UnwrappedTileID> idealTiles;
-    std::vector<UnwrappedTileID> panTiles;
+    static const std::vector<UnwrappedTileID> noTiles;
+    const std::vector<UnwrappedTileID>* idealTiles = &noTiles;
+    const std::vector<UnwrappedTileID>* panTiles = &noTiles;
 
     if (overscaledZoom >= zoomRange.min) {
         int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
 
         // Make sure we're not reparsing overzoomed raster tiles.
-        if (type == SourceType::Raster) {
+        if (type == SourceType::Raster || type == SourceType::RasterDEM) {
             tileZoom = idealZoom;
 
             // FIXME: Prefetching is only enabled for raster
@@ -108,21 +174,30 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
             }
 
             if (panZoom < tileZoom) {
-                panTiles = util::tileCover(parameters.transformState, panZoom);
+                panTiles = &panCover.update(parameters.transformState, panZoom);
             }
         }
 
-        idealTiles = util::tileCover(parameters.transformState, idealZoom);
+        if (parameters.tileLODBias) {
+            lodTiles = util::lodTileCover(parameters.transformState, idealZoom, zoomRange.min, *parameters.tileLODBias);
+            idealTiles = &lodTiles;
+        } else {
+            idealTiles = &idealCover.update(parameters.transformState, idealZoom);
+        }
     }
 
     // Stores a list of all the tiles that we're definitely going to retain. There are two
     // kinds of tiles we need: the ideal tiles determined by the tile cover. They may not yet be in
     // use because they're still loading. In addition to that, we also need to retain all tiles that
     // we're actively using, e.g. as a replacement for tile that aren't loaded yet.
-    std::set<OverscaledTileID> retain;
+    retained.clear();
+    retained.reserve(tiles.size() + idealTiles->size() + panTiles->size());
 
+    // Tiles needed for the current frame are requested ahead of the prefetched ones.
+    Resource::Priority retainPriority = Resource::Priority::Regular;
     auto retainTileFn = [&](Tile& tile, Resource::Necessity necessity) -> void {
-        if (retain.emplace(tile.id).second) {
+        if (retained.emplace(tile.id).second) {
+            tile.setRequestPriority(retainPriority);
             tile.setNecessity(necessity);
         }
 
@@ -154,54 +229,95 @@ void TilePyramid::update(const std::vector<Immutable<style::Layer::Impl>>& layer
 
     renderTiles.clear();
 
-    if (!panTiles.empty()) {
+    if (!panTiles->empty()) {
         algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn,
-                [](const UnwrappedTileID&, Tile&) {}, panTiles, zoomRange, panZoom);
+                [](const UnwrappedTileID&, Tile&) {}, *panTiles, zoomRange, panZoom, checked);
     }
 
+    renderTiles.reserve(idealTiles->size());
     algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
-                                 idealTiles, zoomRange, tileZoom);
+                                 *idealTiles, zoomRange, tileZoom, checked);
+
+    // Request the tiles covering the rest of a camera animation, so that they're loaded by the
+    // time the camera gets there. They're retained but not rendered, and are parsed after the
+    // tiles needed for the current frame, nearest keyframe first.
+    prefetchPriorities.clear();
+    retainPriority = Resource::Priority::Low;
+    int32_t keyframePriority = std::numeric_limits<int32_t>::min() / 2;
+    for (auto keyframe = parameters.transitionKeyframes.rbegin(); keyframe != parameters.transitionKeyframes.rend(); ++keyframe) {
+        const int32_t keyframeZoom = util::coveringZoomLevel(keyframe->getZoom(), type, tileSize);
+        keyframePriority++;
+        if (keyframeZoom < zoomRange.min) {
+            continue;
+        }
+
+        const int32_t idealKeyframeZoom = std::min<int32_t>(zoomRange.max, keyframeZoom);
+        const int32_t dataZoom = type == SourceType::Raster || type == SourceType::RasterDEM ? idealKeyframeZoom : keyframeZoom;
+        for (const auto& tileID : util::tileCover(*keyframe, idealKeyframeZoom)) {
+            const OverscaledTileID dataTileID(dataZoom, tileID.wrap, tileID.canonical);
+            if (retained.count(dataTileID) && !prefetchPriorities.count(dataTileID)) {
+                continue;
+            }
+
+            Tile* tile = getTileFn(dataTileID);
+            if (!tile) {
+                tile = createTileFn(dataTileID);
+            }
+            if (tile) {
+                retainTileFn(*tile, Resource::Necessity::Required);
+                prefetchPriorities[dataTileID] = keyframePriority;
+            }
+        }
+    }
 
     if (type != SourceType::Annotations) {
-        size_t conservativeCacheSize =
-            std::max((float)parameters.transformState.getSize().width / tileSize, 1.0f) *
-            std::max((float)parameters.transformState.getSize().height / tileSize, 1.0f) *
-            (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) *
-            0.5;
-        cache.setSize(conservativeCacheSize);
+        cache.setSize(parameters.tileCacheSize);
     }
 
-    removeStaleTiles(retain);
+    removeStaleTiles(retained);
+
+    const TileCoordinate center = TileCoordinate::fromLatLng(0, parameters.transformState.getLatLng());
+
+    // While the camera is being moved by a gesture or an animation, tiles that have been placed
+    // keep their placement until it settles; placing their symbols again for the intermediate
+    // frames would mostly be wasted. Tiles that are still missing a placement get one right away.
+    const bool deferPlacement = parameters.transformState.isChanging();
 
     for (auto& pair : tiles) {
+        auto prefetchPriority = prefetchPriorities.find(pair.first);
+        pair.second->setPriority(prefetchPriority != prefetchPriorities.end()
+            ? prefetchPriority->second
+            : tilePriority(pair.first, center, tileZoom));
+
         const PlacementConfig config { parameters.transformState.getAngle(),
                                        parameters.transformState.getPitch(),
                                        parameters.transformState.getCameraToCenterDistance(),
                                        parameters.transformState.getCameraToTileDistance(pair.first.toUnwrapped()),
                                        parameters.debugOptions & MapDebugOptions::Collision };
 
-        pair.second->setPlacementConfig(config);
+        if (!deferPlacement || !pair.second->isComplete()) {
+            pair.second->setPlacementConfig(config);
+        }
     }
 }
 
 // Moves all tiles to the cache except for those specified in the retain set.
-void TilePyramid::removeStaleTiles(const std::set<OverscaledTileID>& retain) {
-    // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
-    // and removes items from tiles that don't have the corresponding key in the retain set.
-    auto tilesIt = tiles.begin();
-    auto retainIt = retain.begin();
-    while (tilesIt != tiles.end()) {
-        if (retainIt == retain.end() || tilesIt->first < *retainIt) {
-            tilesIt->second->setNecessity(Tile::Necessity::Optional);
-            cache.add(tilesIt->first, std::move(tilesIt->second));
-            tiles.erase(tilesIt++);
-        } else {
-            if (!(*retainIt < tilesIt->first)) {
-                ++tilesIt;
-            }
-            ++retainIt;
+void TilePyramid::removeStaleTiles(const std::unordered_set<OverscaledTileID>& retain) {
+    // In ID order, so that the cache evicts the same tiles first from run to run.
+    std::vector<OverscaledTileID> stale;
+    for (const auto& pair : tiles) {
+        if (!retain.count(pair.first)) {
+            stale.push_back(pair.first);
         }
     }
+    std::sort(stale.begin(), stale.end());
+
+    for (const auto& id : stale) {
+        auto it = tiles.find(id);
+        it->second->setNecessity(Tile::Necessity::Optional);
+        cache.add(it->first, std::move(it->second));
+        tiles.erase(it);
+    }
 }
 
 std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRenderedFeatures(const ScreenLineString& geometry,
@@ -229,6 +345,7 @@ std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRendered
             std::tie(b.id.canonical.z, b.id.canonical.y, b.id.wrap, b.id.canonical.x);
     });
 
+    std::vector<std::pair<std::reference_wrapper<const RenderTile>, GeometryCoordinates>> queries;
     for (const RenderTile& renderTile : sortedTiles) {
         GeometryCoordinate tileSpaceBoundsMin = TileCoordinate::toGeometryCoordinate(renderTile.id, box.min);
         if (tileSpaceBoundsMin.x >= util::EXTENT || tileSpaceBoundsMin.y >= util::EXTENT) {
@@ -246,32 +363,101 @@ std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRendered
             tileSpaceQueryGeometry.push_back(TileCoordinate::toGeometryCoordinate(renderTile.id, c));
         }
 
-        renderTile.tile.queryRenderedFeatures(result,
-                                              tileSpaceQueryGeometry,
-                                              transformState,
-                                              style,
-                                              options);
+        queries.emplace_back(renderTile, std::move(tileSpaceQueryGeometry));
     }
 
-    return result;
-}
+    auto query = [&] (std::size_t i, std::unordered_map<std::string, std::vector<Feature>>& tileResult) {
+        queries[i].first.get().tile.queryRenderedFeatures(tileResult,
+                                                          queries[i].second,
+                                                          transformState,
+                                                          style,
+                                                          options);
+    };
 
-std::vector<Feature> TilePyramid::querySourceFeatures(const SourceQueryOptions& options) const {
-    std::vector<Feature> result;
+    // Point queries only touch the few features around them, so they aren't worth handing over
+    // to other threads. Queries of lines and boxes spanning several tiles decode and test the
+    // features of each tile on the worker threads, and the results are merged in tile order, as
+    // if the tiles had been queried one after the other.
+    if (geometry.size() == 1 || queries.size() <= 1) {
+        for (std::size_t i = 0; i < queries.size(); i++) {
+            query(i, result);
+        }
+        return result;
+    }
 
-    for (const auto& pair : tiles) {
-        pair.second->querySourceFeatures(result, options);
+    std::vector<std::unordered_map<std::string, std::vector<Feature>>> tileResults(queries.size());
+    util::parallelFor(style.scheduler, queries.size(), [&] (std::size_t i) {
+        query(i, tileResults[i]);
+    });
+
+    for (auto& tileResult : tileResults) {
+        for (auto& layer : tileResult) {
+            auto& features = result[layer.first];
+            std::move(layer.second.begin(), layer.second.end(), std::back_inserter(features));
+        }
     }
 
     return result;
 }
 
+void TilePyramid::querySourceFeatures(const SourceQueryOptions& options, const SourceFeatureCallback& callback) const {
+    LineString<double> queryGeometry;
+    mapbox::geometry::box<double> box { {}, {} };
+    if (options.geometry) {
+        if (options.geometry->empty()) {
+            return;
+        }
+        for (const auto& latLng : *options.geometry) {
+            queryGeometry.push_back(TileCoordinate::fromLatLng(0, latLng).p);
+        }
+        box = mapbox::geometry::envelope(queryGeometry);
+    }
+
+    // Features split across tiles have the same identifier in each of them.
+    std::set<FeatureIdentifier> found;
+    const SourceFeatureCallback unique = [&] (Feature&& feature) {
+        if (feature.id && !found.insert(*feature.id).second) {
+            return;
+        }
+        callback(std::move(feature));
+    };
+
+    for (const auto& tileID : getTileIDs()) {
+        GeometryCoordinates tileSpaceQueryGeometry;
+        if (options.geometry) {
+            const auto id = tileID.toUnwrapped();
+            GeometryCoordinate tileSpaceBoundsMin = TileCoordinate::toGeometryCoordinate(id, box.min);
+            GeometryCoordinate tileSpaceBoundsMax = TileCoordinate::toGeometryCoordinate(id, box.max);
+            if (tileSpaceBoundsMin.x >= util::EXTENT || tileSpaceBoundsMin.y >= util::EXTENT ||
+                tileSpaceBoundsMax.x < 0 || tileSpaceBoundsMax.y < 0) {
+                continue;
+            }
+
+            tileSpaceQueryGeometry.reserve(queryGeometry.size());
+            for (const auto& c : queryGeometry) {
+                tileSpaceQueryGeometry.push_back(TileCoordinate::toGeometryCoordinate(id, c));
+            }
+        }
+
+        tiles.at(tileID)->querySourceFeatures(tileSpaceQueryGeometry, options, options.unique ? unique : callback);
+    }
+}
+
 void TilePyramid::setCacheSize(size_t size) {
     cache.setSize(size);
 }
 
-void TilePyramid::onLowMemory() {
+RendererStatistics::LowMemory TilePyramid::onLowMemory(MemoryPressure pressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    RendererStatistics::LowMemory freed;
+    freed.tileCache = cache.getMemoryUsage();
     cache.clear();
+
+    if (pressure == MemoryPressure::Critical) {
+        for (const auto& pair : tiles) {
+            freed.queryData += pair.second->trimMemory(workerCachesFreed);
+        }
+    }
+    return freed;
 }
 
 void TilePyramid::setObserver(TileObserver* observer_) {
@@ -279,8 +465,8 @@ void TilePyramid::setObserver(TileObserver* observer_) {
 }
 
 void TilePyramid::dumpDebugLogs() const {
-    for (const auto& pair : tiles) {
-        pair.second->dumpDebugLogs();
+    for (const auto& id : getTileIDs()) {
+        tiles.at(id)->dumpDebugLogs();
     }
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mbgl/map/mode.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/tile/tile.hpp>
@@ -10,11 +12,13 @@
 #include <mbgl/util/mat4.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/range.hpp>
+#include <mbgl/util/tile_cover.hpp>
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <map>
 
 namespace mbgl {
 
@@ -32,6 +36,9 @@ public:
     ~TilePyramid();
 
     bool isLoaded() const;
+    std::vector<OverscaledTileID> getIncompleteTiles() const;
+    RendererStatistics::Tiles getTileStatistics() const;
+    RendererStatistics::Memory getMemoryUsage() const;
 
     void update(const std::vector<Immutable<style::Layer::Impl>>&,
                 bool needsRendering,
@@ -53,24 +60,38 @@ public:
                           const RenderStyle& style,
                           const RenderedQueryOptions& options) const;
 
-    std::vector<Feature> querySourceFeatures(const SourceQueryOptions&) const;
+    void querySourceFeatures(const SourceQueryOptions&, const SourceFeatureCallback&) const;
 
     void setCacheSize(size_t);
-    void onLowMemory();
+    RendererStatistics::LowMemory onLowMemory(MemoryPressure, const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed);
 
     void setObserver(TileObserver*);
     void dumpDebugLogs() const;
 
     bool enabled = false;
 
-    void removeStaleTiles(const std::set<OverscaledTileID>&);
+    void removeStaleTiles(const std::unordered_set<OverscaledTileID>&);
 
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+    std::unordered_map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
     TileCache cache;
 
     std::vector<RenderTile> renderTiles;
 
     TileObserver* observer = nullptr;
+
+private:
+    // The IDs of the tiles, sorted.
+    std::vector<OverscaledTileID> getTileIDs() const;
+
+    // Updated from the viewport of the previous update rather than computed from scratch.
+    util::TileCover idealCover;
+    util::TileCover panCover;
+
+    // Scratch space of update(), kept between updates to reuse its allocations.
+    std::unordered_set<OverscaledTileID> retained;
+    std::unordered_set<UnwrappedTileID> checked;
+    std::unordered_map<OverscaledTileID, int32_t> prefetchPriorities;
+    std::vector<UnwrappedTileID> lodTiles;
 };
 
 } // namespace mbgl
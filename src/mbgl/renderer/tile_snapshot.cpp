@@ -0,0 +1,255 @@
+#include <mbgl/renderer/tile_snapshot.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/group_by_layout.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/version.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <exception>
+#include <limits>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+// Snapshot
+enum : protozero::pbf_tag_type {
+    SnapshotRevision = 1,
+    SnapshotTile = 2,
+};
+
+// Tile
+enum : protozero::pbf_tag_type {
+    TileSource = 1,
+    TileOverscaledZ = 2,
+    TileWrap = 3,
+    TileZ = 4,
+    TileX = 5,
+    TileY = 6,
+    TileBucket = 7,
+};
+
+// Bucket
+enum : protozero::pbf_tag_type {
+    BucketLayer = 1,
+    BucketLayoutKey = 2,
+    BucketData = 3,
+};
+
+std::shared_ptr<const TileSnapshot::SerializedBucket> decodeBucket(protozero::pbf_reader&& pbf) {
+    auto bucket = std::make_shared<TileSnapshot::SerializedBucket>();
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case BucketLayer:
+            bucket->layerIDs.push_back(pbf.get_string());
+            break;
+        case BucketLayoutKey:
+            bucket->layoutKey = pbf.get_string();
+            break;
+        case BucketData:
+            bucket->data = pbf.get_string();
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+    if (bucket->layerIDs.empty()) {
+        throw std::runtime_error("snapshot bucket has no layers");
+    }
+    return std::move(bucket);
+}
+
+} // namespace
+
+void TileSnapshot::setRecording(bool recording_) {
+    recording = recording_;
+    if (!recording) {
+        recorded.clear();
+    }
+}
+
+std::shared_ptr<const TileSnapshot::SerializedBucket>
+TileSnapshot::serialize(const Bucket& bucket, const std::vector<const RenderLayer*>& layers) {
+    auto result = std::make_shared<SerializedBucket>();
+    protozero::pbf_writer pbf(result->data);
+    if (layers.empty() || !bucket.serialize(pbf)) {
+        return nullptr;
+    }
+    for (const auto& layer : layers) {
+        result->layerIDs.push_back(layer->getID());
+    }
+    result->layoutKey = layers.front()->baseImpl->layoutKey().value;
+    return std::move(result);
+}
+
+void TileSnapshot::record(const std::string& sourceID, const OverscaledTileID& id, SerializedBuckets buckets) {
+    if (!recording) {
+        return;
+    }
+    if (buckets.empty()) {
+        recorded.erase({ sourceID, id });
+    } else {
+        recorded[{ sourceID, id }] = std::move(buckets);
+    }
+}
+
+void TileSnapshot::erase(const std::string& sourceID, const OverscaledTileID& id) {
+    recorded.erase({ sourceID, id });
+}
+
+std::string TileSnapshot::encode(const std::set<TileKey>& tiles) const {
+    std::string data;
+    protozero::pbf_writer pbf(data);
+    pbf.add_string(SnapshotRevision, version::revision);
+
+    for (const auto& key : tiles) {
+        auto it = recorded.find(key);
+        if (it == recorded.end()) {
+            continue;
+        }
+
+        const OverscaledTileID& id = key.second;
+        protozero::pbf_writer tile(pbf, SnapshotTile);
+        tile.add_string(TileSource, key.first);
+        tile.add_uint32(TileOverscaledZ, id.overscaledZ);
+        tile.add_sint32(TileWrap, id.wrap);
+        tile.add_uint32(TileZ, id.canonical.z);
+        tile.add_uint32(TileX, id.canonical.x);
+        tile.add_uint32(TileY, id.canonical.y);
+
+        for (const auto& serialized : it->second) {
+            protozero::pbf_writer bucket(tile, TileBucket);
+            for (const auto& layerID : serialized->layerIDs) {
+                bucket.add_string(BucketLayer, layerID);
+            }
+            bucket.add_string(BucketLayoutKey, serialized->layoutKey);
+            bucket.add_bytes(BucketData, serialized->data);
+        }
+    }
+
+    return data;
+}
+
+bool TileSnapshot::decode(const std::string& data) {
+    restorable.clear();
+
+    std::map<TileKey, SerializedBuckets> tiles;
+    try {
+        protozero::pbf_reader pbf(data);
+        bool matchingRevision = false;
+        while (pbf.next()) {
+            switch (pbf.tag()) {
+            case SnapshotRevision:
+                matchingRevision = pbf.get_string() == version::revision;
+                if (!matchingRevision) {
+                    Log::Warning(Event::Render, "Ignoring a tile snapshot of another build");
+                    return false;
+                }
+                break;
+            case SnapshotTile: {
+                protozero::pbf_reader tile = pbf.get_message();
+                std::string sourceID;
+                uint32_t overscaledZ = 0, z = 0, x = 0, y = 0;
+                int32_t wrap = 0;
+                SerializedBuckets buckets;
+                while (tile.next()) {
+                    switch (tile.tag()) {
+                    case TileSource: sourceID = tile.get_string(); break;
+                    case TileOverscaledZ: overscaledZ = tile.get_uint32(); break;
+                    case TileWrap: wrap = tile.get_sint32(); break;
+                    case TileZ: z = tile.get_uint32(); break;
+                    case TileX: x = tile.get_uint32(); break;
+                    case TileY: y = tile.get_uint32(); break;
+                    case TileBucket: buckets.push_back(decodeBucket(tile.get_message())); break;
+                    default: tile.skip(); break;
+                    }
+                }
+                if (z > 32 || overscaledZ > 255 || overscaledZ < z ||
+                    x >= (1ull << z) || y >= (1ull << z) ||
+                    wrap < std::numeric_limits<int16_t>::min() || wrap > std::numeric_limits<int16_t>::max()) {
+                    throw std::runtime_error("invalid snapshot tile ID");
+                }
+                tiles.emplace(TileKey { sourceID, OverscaledTileID(overscaledZ, wrap, z, x, y) }, std::move(buckets));
+                break;
+            }
+            default:
+                pbf.skip();
+                break;
+            }
+        }
+        if (!matchingRevision) {
+            throw std::runtime_error("snapshot has no revision");
+        }
+    } catch (const std::exception& ex) {
+        Log::Error(Event::Render, "Unable to decode a tile snapshot: %s", ex.what());
+        return false;
+    }
+
+    restorable = std::move(tiles);
+    return true;
+}
+
+std::unordered_map<std::string, std::shared_ptr<Bucket>>
+TileSnapshot::restore(const std::string& sourceID, const OverscaledTileID& id,
+                      const std::vector<Immutable<style::Layer::Impl>>& layers, const BucketParameters& parameters) {
+    std::unordered_map<std::string, std::shared_ptr<Bucket>> result;
+
+    auto it = restorable.find({ sourceID, id });
+    if (it == restorable.end()) {
+        return result;
+    }
+    const SerializedBuckets serialized = std::move(it->second);
+    restorable.erase(it);
+
+    const std::vector<std::unique_ptr<RenderLayer>> renderLayers = RenderLayer::createForLayout(layers, id.overscaledZ);
+    for (const auto& group : groupByLayout(renderLayers)) {
+        const RenderLayer& leader = *group.front();
+        if (leader.is<RenderSymbolLayer>()) {
+            continue;
+        }
+
+        std::shared_ptr<const SerializedBucket> match;
+        for (const auto& bucket : serialized) {
+            if (bucket->layerIDs.size() != group.size() || bucket->layoutKey != leader.baseImpl->layoutKey().value) {
+                continue;
+            }
+            bool sameLayers = true;
+            for (std::size_t i = 0; i < group.size(); i++) {
+                sameLayers = sameLayers && bucket->layerIDs[i] == group[i]->getID();
+            }
+            if (sameLayers) {
+                match = bucket;
+                break;
+            }
+        }
+        if (!match) {
+            continue;
+        }
+
+        std::shared_ptr<Bucket> bucket = leader.createBucket(parameters, group);
+        try {
+            protozero::pbf_reader pbf(match->data);
+            if (!bucket->deserialize(pbf) || !bucket->hasData()) {
+                continue;
+            }
+        } catch (const std::exception& ex) {
+            Log::Error(Event::Render, "Unable to restore a bucket: %s", ex.what());
+            continue;
+        }
+
+        for (const auto& layer : group) {
+            result.emplace(layer->getID(), bucket);
+        }
+    }
+
+    return result;
+}
+
+} // namespace mbgl
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/immutable.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+class Bucket;
+class BucketParameters;
+class RenderLayer;
+
+/*
+   Keeps the laid out geometry of the non-symbol buckets of vector tiles, so that a renderer
+   created later, e.g. when the app is launched again, can draw the tiles that were visible right
+   away. Restored tiles are loaded and laid out again as usual, which replaces their buckets and
+   adds their labels.
+
+   While recording, tile workers serialize the buckets they lay out, and the tiles keep them here
+   until they're destroyed. Buckets with data-driven paint attributes aren't kept. Snapshots hold
+   vertex data as is, so they're only restored by the build that encoded them.
+
+   Used on the render thread, except for isRecording() and serialize(), which workers call.
+*/
+class TileSnapshot : private util::noncopyable {
+public:
+    // The serialized geometry of a bucket, with the layers it was laid out for.
+    class SerializedBucket {
+    public:
+        std::vector<std::string> layerIDs;
+        std::string layoutKey;
+        std::string data;
+    };
+    using SerializedBuckets = std::vector<std::shared_ptr<const SerializedBucket>>;
+
+    void setRecording(bool);
+    bool isRecording() const {
+        return recording;
+    }
+
+    // Serializes a bucket made for a group of layers with the same layout; returns null if the
+    // bucket can't be serialized.
+    static std::shared_ptr<const SerializedBucket> serialize(const Bucket&, const std::vector<const RenderLayer*>& layers);
+
+    // Replaces the buckets recorded for a tile with those of its latest layout.
+    void record(const std::string& sourceID, const OverscaledTileID&, SerializedBuckets);
+    void erase(const std::string& sourceID, const OverscaledTileID&);
+
+    // Encodes the buckets recorded for the given tiles.
+    std::string encode(const std::set<std::pair<std::string, OverscaledTileID>>& tiles) const;
+
+    // Makes the tiles of an encoded snapshot available to restore(), replacing those of the
+    // snapshot decoded before. Returns false, and keeps nothing, if the snapshot is malformed or
+    // was encoded by another build.
+    bool decode(const std::string&);
+
+    // Creates the buckets of a tile that hasn't been laid out yet from the snapshot, for those of
+    // its layers whose layout is the one the buckets were laid out for, by layer ID. A tile's
+    // buckets are restored once at most.
+    std::unordered_map<std::string, std::shared_ptr<Bucket>>
+    restore(const std::string& sourceID, const OverscaledTileID&,
+            const std::vector<Immutable<style::Layer::Impl>>& layers, const BucketParameters&);
+
+    bool hasRestorableTiles() const {
+        return !restorable.empty();
+    }
+
+private:
+    using TileKey = std::pair<std::string, OverscaledTileID>;
+
+    std::atomic<bool> recording { false };
+    std::map<TileKey, SerializedBuckets> recorded;
+    std::map<TileKey, SerializedBuckets> restorable;
+};
+
+} // namespace mbgl
@@ -0,0 +1,57 @@
+#include <mbgl/renderer/tile_upload_queue.hpp>
+#include <mbgl/tile/geometry_tile.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+void TileUploadQueue::setBudget(std::size_t bytesPerFrame) {
+    budget = bytesPerFrame;
+}
+
+bool TileUploadQueue::add(GeometryTile& tile) {
+    if (!budget) {
+        return false;
+    }
+    if (std::find(tiles.begin(), tiles.end(), &tile) == tiles.end()) {
+        tiles.push_back(&tile);
+    }
+    return true;
+}
+
+void TileUploadQueue::remove(GeometryTile& tile) {
+    tiles.erase(std::remove(tiles.begin(), tiles.end(), &tile), tiles.end());
+}
+
+std::size_t TileUploadQueue::upload(gl::Context& context, bool all) {
+    if (tiles.empty()) {
+        return 0;
+    }
+
+    // Tiles nearest to the center of the viewport have the highest priority.
+    std::stable_sort(tiles.begin(), tiles.end(), [](const GeometryTile* a, const GeometryTile* b) {
+        return a->getPriority() > b->getPriority();
+    });
+
+    std::size_t uploaded = 0;
+    std::size_t count = 0;
+    for (GeometryTile* tile : tiles) {
+        const std::size_t size = tile->uploadSize();
+        if (!all && budget && count > 0 && uploaded + size > budget) {
+            break;
+        }
+        uploaded += size;
+        tile->upload(context);
+        count++;
+    }
+
+    // Marking tiles renderable notifies their observers, so do it once the queue is consistent.
+    std::vector<GeometryTile*> done(tiles.begin(), tiles.begin() + count);
+    tiles.erase(tiles.begin(), tiles.begin() + count);
+    for (GeometryTile* tile : done) {
+        tile->onUploaded();
+    }
+    return count;
+}
+
+} // namespace mbgl
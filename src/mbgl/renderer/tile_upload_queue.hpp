@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace mbgl {
+
+class GeometryTile;
+
+namespace gl {
+class Context;
+} // namespace gl
+
+// Spreads the first upload of newly laid out tiles over several frames, so that a burst of tiles
+// arriving at once doesn't cause a frame to hitch. Tiles waiting in the queue aren't renderable
+// yet, so the tile pyramid keeps rendering the parent or child tiles covering for them until
+// they're uploaded.
+class TileUploadQueue : private util::noncopyable {
+public:
+    // Limits the data uploaded per frame, in bytes. Zero disables the queue.
+    void setBudget(std::size_t bytesPerFrame);
+
+    // Returns false if the tile should be uploaded and rendered right away instead.
+    bool add(GeometryTile&);
+    void remove(GeometryTile&);
+
+    // Uploads waiting tiles, highest priority first, until this frame's budget is spent. At least
+    // one tile is uploaded per call. With `all`, the budget is ignored. Returns the number of
+    // tiles uploaded.
+    std::size_t upload(gl::Context&, bool all);
+
+    bool empty() const {
+        return tiles.empty();
+    }
+
+private:
+    std::size_t budget = 0;
+    std::vector<GeometryTile*> tiles;
+};
+
+} // namespace mbgl
@@ -8,6 +8,7 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/immutable.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <vector>
 
@@ -28,6 +29,7 @@ public:
 
     const std::string glyphURL;
     const bool spriteLoaded;
+    const bool styleImagesOnDemand;
     const style::TransitionOptions transitionOptions;
     const Immutable<style::Light::Impl> light;
     const Immutable<std::vector<Immutable<style::Image::Impl>>> images;
@@ -39,9 +41,17 @@ public:
     AnnotationManager& annotationManager;
 
     const uint8_t prefetchZoomDelta;
+    const uint64_t tileCacheSize;
+    const uint32_t placementBudget;
+    const optional<double> tileLODBias;
+
+    // Camera states along the current animation, for prefetching tiles.
+    const std::vector<TransformState> transitionKeyframes;
     
     // For still image requests, render requested
     const bool stillImageRequest;
+    // Render the still image with whatever has loaded, instead of waiting for all tiles.
+    const bool stillImageTimedOut;
 };
 
 } // namespace mbgl
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Circles with feature states, see circle_state.cpp.
+class circle_state {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
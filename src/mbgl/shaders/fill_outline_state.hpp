@@ -0,0 +1,15 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Fill outlines with feature states, see fill_outline_state.cpp.
+class fill_outline_state {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
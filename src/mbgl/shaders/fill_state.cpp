@@ -0,0 +1,92 @@
+// fill.cpp with the color of each feature mixed with u_state_color by its feature state, which
+// a_state holds from 0 to 255, see FeatureStateBuffer. Keep the two in sync.
+
+#include <mbgl/shaders/fill_state.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* fill_state::name = "fill_state";
+const char* fill_state::vertexSource = R"MBGL_SHADER(
+attribute vec2 a_pos;
+attribute mediump float a_state;
+
+uniform mat4 u_matrix;
+
+varying lowp float v_state;
+
+
+#ifndef HAS_UNIFORM_u_color
+uniform lowp float a_color_t;
+attribute highp vec4 a_color;
+varying highp vec4 color;
+#else
+uniform highp vec4 u_color;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+uniform lowp float a_opacity_t;
+attribute lowp vec2 a_opacity;
+varying lowp float opacity;
+#else
+uniform lowp float u_opacity;
+#endif
+
+void main() {
+
+#ifndef HAS_UNIFORM_u_color
+    color = unpack_mix_vec4(a_color, a_color_t);
+#else
+    highp vec4 color = u_color;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+    opacity = unpack_mix_vec2(a_opacity, a_opacity_t);
+#else
+    lowp float opacity = u_opacity;
+#endif
+
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    v_state = a_state / 255.0;
+}
+
+)MBGL_SHADER";
+const char* fill_state::fragmentSource = R"MBGL_SHADER(
+uniform highp vec4 u_state_color;
+
+varying lowp float v_state;
+
+
+#ifndef HAS_UNIFORM_u_color
+varying highp vec4 color;
+#else
+uniform highp vec4 u_color;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+varying lowp float opacity;
+#else
+uniform lowp float u_opacity;
+#endif
+
+void main() {
+
+#ifdef HAS_UNIFORM_u_color
+    highp vec4 color = u_color;
+#endif
+
+#ifdef HAS_UNIFORM_u_opacity
+    lowp float opacity = u_opacity;
+#endif
+
+    gl_FragColor = mix(color, u_state_color, v_state) * opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,107 @@
+// Draws a Gaussian kernel around each point into the red channel of the density texture, which
+// is blended additively. circle-radius is the radius of the kernel and circle-opacity the weight
+// of the point.
+
+#include <mbgl/shaders/heatmap.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* heatmap::name = "heatmap";
+const char* heatmap::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+uniform vec2 u_extrude_scale;
+uniform highp float u_intensity;
+
+attribute vec2 a_pos;
+
+
+#ifndef HAS_UNIFORM_u_radius
+uniform lowp float a_radius_t;
+attribute mediump vec2 a_radius;
+#else
+uniform mediump float u_radius;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+uniform lowp float a_opacity_t;
+attribute highp vec2 a_opacity;
+varying highp float weight;
+#else
+uniform highp float u_opacity;
+#endif
+
+varying vec2 v_extrude;
+
+// The density below which the kernel counts as zero, a fraction of the smallest non-zero value
+// of an 8-bit texture.
+const highp float ZERO = 1.0 / 255.0 / 16.0;
+
+// 1 / sqrt(2 * PI), the coefficient of the Gaussian kernel.
+#define GAUSS_COEF 0.3989422804014327
+
+void main(void) {
+
+#ifndef HAS_UNIFORM_u_radius
+    mediump float radius = unpack_mix_vec2(a_radius, a_radius_t);
+#else
+    mediump float radius = u_radius;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+    weight = unpack_mix_vec2(a_opacity, a_opacity_t);
+#else
+    highp float weight = u_opacity;
+#endif
+
+    // unencode the extrusion vector that we snuck into the a_pos vector
+    vec2 unscaled_extrude = vec2(mod(a_pos, 2.0) * 2.0 - 1.0);
+
+    // The quad is grown until the kernel falls to ZERO along its edges, i.e. to the S that solves
+    // weight * u_intensity * GAUSS_COEF * exp(-0.5 * 3.0^2 * S^2) == ZERO. Points without weight
+    // get an empty quad.
+    float S = weight > 0.0 ? sqrt(-2.0 * log(ZERO / weight / u_intensity / GAUSS_COEF)) / 3.0 : 0.0;
+
+    v_extrude = S * unscaled_extrude;
+    vec2 extrude = v_extrude * radius * u_extrude_scale;
+
+    // multiply a_pos by 0.5, since we had it * 2 in order to sneak
+    // in extrusion data
+    gl_Position = u_matrix * vec4(floor(a_pos * 0.5) + extrude, 0, 1);
+}
+
+)MBGL_SHADER";
+const char* heatmap::fragmentSource = R"MBGL_SHADER(
+uniform highp float u_intensity;
+
+#ifndef HAS_UNIFORM_u_opacity
+varying highp float weight;
+#else
+uniform highp float u_opacity;
+#endif
+
+varying vec2 v_extrude;
+
+#define GAUSS_COEF 0.3989422804014327
+
+void main() {
+
+#ifdef HAS_UNIFORM_u_opacity
+    highp float weight = u_opacity;
+#endif
+
+    // The kernel spans three standard deviations on either side of the point.
+    float d = -0.5 * 3.0 * 3.0 * dot(v_extrude, v_extrude);
+    float val = weight * u_intensity * GAUSS_COEF * exp(d);
+
+    gl_FragColor = vec4(val, 1.0, 1.0, 1.0);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Adds the density of each point of a circle layer drawn as a heatmap to a texture, see
+// RenderCircleLayer.
+class heatmap {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,75 @@
+// Instanced variant of the heatmap vertex shader, see heatmap.cpp. Keep the two in sync.
+
+#include <mbgl/shaders/heatmap_instanced.hpp>
+#include <mbgl/shaders/heatmap.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* heatmap_instanced::name = "heatmap_instanced";
+const char* heatmap_instanced::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+uniform vec2 u_extrude_scale;
+uniform highp float u_intensity;
+
+// The corner of the quad shared by all instances, and the point drawn by this instance.
+attribute vec2 a_extrude;
+attribute vec2 a_pos;
+
+
+#ifndef HAS_UNIFORM_u_radius
+uniform lowp float a_radius_t;
+attribute mediump vec2 a_radius;
+#else
+uniform mediump float u_radius;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+uniform lowp float a_opacity_t;
+attribute highp vec2 a_opacity;
+varying highp float weight;
+#else
+uniform highp float u_opacity;
+#endif
+
+varying vec2 v_extrude;
+
+// The density below which the kernel counts as zero, a fraction of the smallest non-zero value
+// of an 8-bit texture.
+const highp float ZERO = 1.0 / 255.0 / 16.0;
+
+// 1 / sqrt(2 * PI), the coefficient of the Gaussian kernel.
+#define GAUSS_COEF 0.3989422804014327
+
+void main(void) {
+
+#ifndef HAS_UNIFORM_u_radius
+    mediump float radius = unpack_mix_vec2(a_radius, a_radius_t);
+#else
+    mediump float radius = u_radius;
+#endif
+
+#ifndef HAS_UNIFORM_u_opacity
+    weight = unpack_mix_vec2(a_opacity, a_opacity_t);
+#else
+    highp float weight = u_opacity;
+#endif
+
+    vec2 unscaled_extrude = a_extrude;
+
+    // The quad is grown until the kernel falls to ZERO along its edges, i.e. to the S that solves
+    // weight * u_intensity * GAUSS_COEF * exp(-0.5 * 3.0^2 * S^2) == ZERO. Points without weight
+    // get an empty quad.
+    float S = weight > 0.0 ? sqrt(-2.0 * log(ZERO / weight / u_intensity / GAUSS_COEF)) / 3.0 : 0.0;
+
+    v_extrude = S * unscaled_extrude;
+    vec2 extrude = v_extrude * radius * u_extrude_scale;
+
+    gl_Position = u_matrix * vec4(a_pos + extrude, 0, 1);
+}
+
+)MBGL_SHADER";
+const char* heatmap_instanced::fragmentSource = heatmap::fragmentSource;
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// The heatmap shader, with the point and the corner of its quad in separate attributes, so that
+// one shared quad can be drawn per point instance.
+class heatmap_instanced {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,31 @@
+// Draws the density texture of a heatmap over the viewport, with the vertices and the vertex
+// shader of extrusion_texture. Densities are looked up in a color ramp, whose colors are
+// premultiplied.
+
+#include <mbgl/shaders/heatmap_texture.hpp>
+#include <mbgl/shaders/extrusion_texture.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* heatmap_texture::name = "heatmap_texture";
+const char* heatmap_texture::vertexSource = extrusion_texture::vertexSource;
+const char* heatmap_texture::fragmentSource = R"MBGL_SHADER(
+uniform sampler2D u_image;
+uniform sampler2D u_color_ramp;
+uniform float u_opacity;
+varying vec2 v_pos;
+
+void main() {
+    float t = texture2D(u_image, v_pos).r;
+    gl_FragColor = texture2D(u_color_ramp, vec2(t, 0.5)) * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(0.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Colors the density texture of a heatmap with the heatmap's color ramp.
+class heatmap_texture {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
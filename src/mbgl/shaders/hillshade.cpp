@@ -0,0 +1,53 @@
+// Shades the tiles of raster-dem sources from the slopes of their terrain, which DEMData packs
+// as angles into the red and green channels of the texture. Shadows are drawn as translucent
+// black and highlights as translucent white over the layers below.
+
+#include <mbgl/shaders/hillshade.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* hillshade::name = "hillshade";
+const char* hillshade::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+
+attribute vec2 a_pos;
+attribute vec2 a_texture_pos;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    v_pos = a_texture_pos / 8192.0;
+}
+
+)MBGL_SHADER";
+const char* hillshade::fragmentSource = R"MBGL_SHADER(
+uniform sampler2D u_image;
+uniform vec3 u_light_direction;
+uniform float u_opacity;
+
+varying vec2 v_pos;
+
+#define PI_2 1.5707963267949
+
+void main() {
+    // The slopes of the terrain towards the east and south, which are stored as angles.
+    vec2 angles = (texture2D(u_image, v_pos).rg * 255.0 - 128.0) / 127.0 * PI_2;
+    vec2 slopes = tan(clamp(angles, -1.56, 1.56));
+    vec3 normal = normalize(vec3(-slopes, 1.0));
+
+    // Relative to flat terrain, shadows darken the layers below and highlights lighten them.
+    float shade = clamp(dot(normal, u_light_direction) - u_light_direction.z, -1.0, 1.0);
+    vec4 color = shade < 0.0 ? vec4(0.0, 0.0, 0.0, -shade) : vec4(shade * 0.5);
+    gl_FragColor = color * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Draws the hillshading of an elevation tile, see RenderRasterLayer.
+class hillshade {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
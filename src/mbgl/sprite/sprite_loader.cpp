@@ -7,6 +7,8 @@
 #include <mbgl/util/std.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/weak_cache.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
@@ -19,12 +21,30 @@ namespace mbgl {
 
 static SpriteLoaderObserver nullObserver;
 
+// Sprites that are in use by any map, keyed by URL and pixel ratio.
+static util::WeakCache<std::string, std::vector<style::Image>> sharedSprites;
+
+static std::string sharedSpriteKey(const std::string& url, float pixelRatio) {
+    return url + "@" + util::toString(pixelRatio);
+}
+
+static std::vector<std::unique_ptr<style::Image>> copyImages(const std::vector<style::Image>& images) {
+    // Copies share the pixels of the images they're made from.
+    std::vector<std::unique_ptr<style::Image>> result;
+    result.reserve(images.size());
+    for (const auto& image : images) {
+        result.push_back(std::make_unique<style::Image>(image));
+    }
+    return result;
+}
+
 struct SpriteLoader::Loader {
     Loader(Scheduler& scheduler, SpriteLoader& imageManager)
         : mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
           worker(scheduler, ActorRef<SpriteLoader>(imageManager, mailbox)) {
     }
 
+    std::string url;
     std::shared_ptr<const std::string> image;
     std::shared_ptr<const std::string> json;
     std::unique_ptr<AsyncRequest> jsonRequest;
@@ -47,7 +67,15 @@ void SpriteLoader::load(const std::string& url, Scheduler& scheduler, FileSource
         return;
     }
 
+    // Another map already loaded and parsed the sprite.
+    if ((sprite = sharedSprites.get(sharedSpriteKey(url, pixelRatio)))) {
+        loader.reset();
+        observer->onSpriteLoaded(copyImages(*sprite));
+        return;
+    }
+
     loader = std::make_unique<Loader>(scheduler, *this);
+    loader->url = url;
 
     loader->jsonRequest = fileSource.request(Resource::spriteJSON(url, pixelRatio), [this](Response res) {
         if (res.error) {
@@ -90,6 +118,16 @@ void SpriteLoader::emitSpriteLoadedIfComplete() {
 }
 
 void SpriteLoader::onParsed(std::vector<std::unique_ptr<style::Image>>&& result) {
+    assert(loader);
+
+    auto images = std::make_shared<std::vector<style::Image>>();
+    images->reserve(result.size());
+    for (const auto& image : result) {
+        images->push_back(*image);
+    }
+    sprite = images;
+    sharedSprites.add(sharedSpriteKey(loader->url, pixelRatio), std::move(images));
+
     observer->onSpriteLoaded(std::move(result));
 }
 
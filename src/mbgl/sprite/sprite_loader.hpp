@@ -35,6 +35,10 @@ private:
 
     const float pixelRatio;
 
+    // The parsed sprite, which maps that load the same sprite share for as long as one of them
+    // holds it.
+    std::shared_ptr<const std::vector<style::Image>> sprite;
+
     struct Loader;
     std::unique_ptr<Loader> loader;
 
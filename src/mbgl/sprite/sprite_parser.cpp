@@ -1,5 +1,5 @@
 #include <mbgl/sprite/sprite_parser.hpp>
-#include <mbgl/style/image.hpp>
+#include <mbgl/style/image_impl.hpp>
 
 #include <mbgl/util/logging.hpp>
 
@@ -13,14 +13,14 @@
 
 namespace mbgl {
 
-std::unique_ptr<style::Image> createStyleImage(const std::string& id,
-                                               const PremultipliedImage& image,
-                                               const uint32_t srcX,
-                                               const uint32_t srcY,
-                                               const uint32_t width,
-                                               const uint32_t height,
-                                               const double ratio,
-                                               const bool sdf) {
+namespace {
+
+bool checkMetrics(const PremultipliedImage& image,
+                  const uint32_t srcX,
+                  const uint32_t srcY,
+                  const uint32_t width,
+                  const uint32_t height,
+                  const double ratio) {
     // Disallow invalid parameter configurations.
     if (width <= 0 || height <= 0 || width > 1024 || height > 1024 ||
         ratio <= 0 || ratio > 10 ||
@@ -30,6 +30,22 @@ std::unique_ptr<style::Image> createStyleImage(const std::string& id,
             width, height, srcX, srcY,
             image.size.width, image.size.height,
             util::toString(ratio).c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::unique_ptr<style::Image> createStyleImage(const std::string& id,
+                                               const PremultipliedImage& image,
+                                               const uint32_t srcX,
+                                               const uint32_t srcY,
+                                               const uint32_t width,
+                                               const uint32_t height,
+                                               const double ratio,
+                                               const bool sdf) {
+    if (!checkMetrics(image, srcX, srcY, width, height, ratio)) {
         return nullptr;
     }
 
@@ -41,6 +57,22 @@ std::unique_ptr<style::Image> createStyleImage(const std::string& id,
     return std::make_unique<style::Image>(id, std::move(dstImage), ratio, sdf);
 }
 
+std::unique_ptr<style::Image> createStyleImage(const std::string& id,
+                                               std::shared_ptr<const PremultipliedImage> sheet,
+                                               const uint32_t srcX,
+                                               const uint32_t srcY,
+                                               const uint32_t width,
+                                               const uint32_t height,
+                                               const double ratio,
+                                               const bool sdf) {
+    if (!checkMetrics(*sheet, srcX, srcY, width, height, ratio)) {
+        return nullptr;
+    }
+
+    return std::make_unique<style::Image>(makeMutable<style::Image::Impl>(
+        id, std::move(sheet), Point<uint32_t>{ srcX, srcY }, Size{ width, height }, ratio, sdf));
+}
+
 namespace {
 
 uint16_t getUInt16(const JSValue& value, const char* name, const uint16_t def = 0) {
@@ -86,7 +118,8 @@ bool getBoolean(const JSValue& value, const char* name, const bool def = false)
 } // namespace
 
 std::vector<std::unique_ptr<style::Image>> parseSprite(const std::string& encodedImage, const std::string& json) {
-    const PremultipliedImage raster = decodeImage(encodedImage);
+    // Images keep referring to the decoded sheet, rather than each copying their pixels out of it.
+    const auto raster = std::make_shared<const PremultipliedImage>(decodeImage(encodedImage));
 
     JSDocument doc;
     doc.Parse<0>(json.c_str());
@@ -22,6 +22,17 @@ std::unique_ptr<style::Image> createStyleImage(const std::string& id,
                                                double ratio,
                                                bool sdf);
 
+// Refers to an individual image of a spritesheet, which it shares with the other images of the
+// sheet instead of copying it.
+std::unique_ptr<style::Image> createStyleImage(const std::string& id,
+                                               std::shared_ptr<const PremultipliedImage> sheet,
+                                               uint32_t srcX,
+                                               uint32_t srcY,
+                                               uint32_t srcWidth,
+                                               uint32_t srcHeight,
+                                               double ratio,
+                                               bool sdf);
+
 // Parses an image and an associated JSON file and returns the sprite objects.
 std::vector<std::unique_ptr<style::Image>> parseSprite(const std::string& image, const std::string& json);
 
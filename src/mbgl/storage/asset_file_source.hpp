@@ -2,11 +2,12 @@
 
 #include <mbgl/storage/file_source.hpp>
 
+#include <vector>
+
 namespace mbgl {
 
-namespace util {
-template <typename T> class Thread;
-} // namespace util
+template <class> class Actor;
+class ThreadPool;
 
 class AssetFileSource : public FileSource {
 public:
@@ -18,7 +19,10 @@ public:
 private:
     class Impl;
 
-    std::unique_ptr<util::Thread<Impl>> impl;
+    // Files are read by several threads at once, one per Impl, taking turns with requests.
+    std::unique_ptr<ThreadPool> threadPool;
+    std::vector<std::unique_ptr<Actor<Impl>>> impls;
+    std::size_t nextImpl = 0;
 };
 
 } // namespace mbgl
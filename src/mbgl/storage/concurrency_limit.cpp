@@ -0,0 +1,75 @@
+#include <mbgl/storage/concurrency_limit.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace mbgl {
+
+namespace {
+
+// The data of smaller responses arrives within a few round trips, so their transfer time says
+// more about latency than about throughput.
+const std::size_t throughputSampleSize = 16 * 1024;
+
+// How much slower than over the long term responses may get before the limit shrinks.
+const double tolerance = 1.5;
+
+double seconds(Duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+// Exponentially weighted moving average, starting out at the first sample.
+double smooth(double average, double sample, double weight) {
+    return average ? average + (sample - average) * weight : sample;
+}
+
+} // namespace
+
+ConcurrencyLimit::ConcurrencyLimit(std::size_t minimum_, std::size_t maximum_)
+    : minimum(std::max<std::size_t>(minimum_, 1)),
+      maximum(std::max<std::size_t>(maximum_, std::max<std::size_t>(minimum_, 1))),
+      limit(util::clamp(4.0, minimum, maximum)) {
+}
+
+std::size_t ConcurrencyLimit::get() const {
+    return std::size_t(limit);
+}
+
+void ConcurrencyLimit::completed(const Response::Timing& timing, std::size_t bytes, std::size_t inflight) {
+    averageBytes = smooth(averageBytes, bytes, 0.1);
+
+    const double transfer = seconds(timing.transfer);
+    if (bytes >= throughputSampleSize && transfer > 0) {
+        throughput = smooth(throughput, bytes / transfer, 0.1);
+    }
+
+    // Normalize to a response of average size, so that large responses don't read as congestion.
+    const double latency = seconds(timing.firstByte) + (throughput ? averageBytes / throughput : transfer);
+    shortLatency = smooth(shortLatency, latency, 0.3);
+    // A connection that got faster is the new normal right away; one that got slower only over
+    // the course of a few hundred responses.
+    longLatency = smooth(longLatency, latency, latency < longLatency ? 0.1 : 0.01);
+
+    if (shortLatency <= 0) {
+        return;
+    }
+
+    const double gradient = util::clamp(tolerance * longLatency / shortLatency, 0.5, 1.0);
+
+    // Responses to fewer requests than the limit allows can't tell whether more would do.
+    if (gradient == 1.0 && inflight < limit / 2) {
+        return;
+    }
+
+    // Leave room for a few requests to queue, so that growth doesn't stall.
+    const double next = limit * gradient + std::sqrt(limit);
+    limit = util::clamp(limit * 0.8 + next * 0.2, minimum, maximum);
+}
+
+void ConcurrencyLimit::failed() {
+    limit = std::max(minimum, limit / 2);
+}
+
+} // namespace mbgl
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mbgl/storage/response.hpp>
+
+#include <cstddef>
+
+namespace mbgl {
+
+/*
+   Adapts the number of network requests a file source keeps in flight to what the connection
+   sustains. Every response contributes how long it waited for its first byte, and, if it was
+   large enough to tell, the rate at which its data arrived. From these, the limit keeps an
+   estimate of how long a response of average size takes: measured over the last few responses,
+   and over a longer period. As long as the short-term estimate stays close to the long-term one,
+   the connection keeps up and the limit grows; once responses slow down, requests are queueing
+   somewhere on the way and the limit shrinks in proportion. Connection errors halve it.
+*/
+class ConcurrencyLimit {
+public:
+    ConcurrencyLimit(std::size_t minimum, std::size_t maximum);
+
+    std::size_t get() const;
+
+    // Records a successful response with `bytes` of data that arrived while `inflight`
+    // requests, including its own, were active.
+    void completed(const Response::Timing&, std::size_t bytes, std::size_t inflight);
+
+    // Records a request that failed for lack of connectivity.
+    void failed();
+
+    // Bytes per second a single response's data arrives at; zero until measured.
+    double getThroughput() const {
+        return throughput;
+    }
+
+private:
+    const double minimum;
+    const double maximum;
+    double limit;
+
+    double averageBytes = 0;
+    double throughput = 0;
+    double shortLatency = 0;
+    double longLatency = 0;
+};
+
+} // namespace mbgl
@@ -13,6 +13,11 @@ public:
 
     static uint32_t maximumConcurrentRequests();
 
+    // Multiplex requests to the same host over a single HTTP/2 connection, with at most
+    // `maximumStreamsPerHost` of them in flight at once. Platforms whose HTTP stack
+    // negotiates HTTP/2 on its own ignore this.
+    void setHTTP2Multiplexing(bool enabled, uint32_t maximumStreamsPerHost = 100);
+
     class Impl;
 
 private:
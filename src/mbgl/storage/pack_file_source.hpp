@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+/*
+   Serves tiles, and a TileJSON document describing them, straight from a read-only tile
+   archive on disk, without going through the offline database. Requesting
+   `pack:///path/to/archive` yields TileJSON whose tile URLs point back into the archive, so
+   the URL can be used as a source URL as is.
+
+   Two archive formats are recognized by their leading bytes:
+
+   * MBTiles (https://github.com/mapbox/mbtiles-spec), read through SQLite with memory-mapped
+     I/O. gzip-compressed tile data is inflated before it's returned.
+   * Flat tile packs, which are memory-mapped in their entirety. A pack is a little-endian
+     file consisting of
+       - a 32 byte header: the magic `MBGLPACK`, a uint32 version (1), a uint32 tile count,
+         and the uint64 offset and length of a TileJSON object without `tiles`,
+       - the tile index: a `{ uint32 z, x, y, length; uint64 offset; }` entry per tile,
+         sorted by z, then x, then y,
+       - the tile data and the TileJSON object, at the offsets given in the header and index.
+     Tile data is returned exactly as stored.
+
+   Tiles absent from an archive are reported as having no content.
+*/
+class PackFileSource : public FileSource {
+public:
+    PackFileSource();
+    ~PackFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+
+    std::unique_ptr<util::Thread<Impl>> impl;
+};
+
+} // namespace mbgl
@@ -1,6 +1,7 @@
 #include <mapbox/geometry/box.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/dtoa.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/token.hpp>
 #include <mbgl/util/url.hpp>
@@ -35,8 +36,15 @@ static std::string getTileBBox(int32_t x, int32_t y, int8_t z) {
     auto min = getMercCoord(x * 256, y * 256, z);
     auto max = getMercCoord((x + 1) * 256, (y + 1) * 256, z);
 
-    return (util::toString(min.x) + "," + util::toString(min.y) + "," +
-            util::toString(max.x) + "," + util::toString(max.y));
+    char buffer[4 * util::dtoaBufferSize + 3];
+    char* end = util::dtoa(min.x, buffer);
+    *end++ = ',';
+    end = util::dtoa(min.y, end);
+    *end++ = ',';
+    end = util::dtoa(max.x, end);
+    *end++ = ',';
+    end = util::dtoa(max.y, end);
+    return std::string(buffer, end);
 }
 
 Resource Resource::style(const std::string& url) {
@@ -0,0 +1,88 @@
+#include <mbgl/storage/response_cache.hpp>
+
+namespace mbgl {
+
+std::string ResponseCache::key(const Resource& resource) {
+    return char(resource.kind) + resource.url;
+}
+
+void ResponseCache::setMaximumSize(std::size_t bytes_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes_;
+    evict();
+}
+
+optional<Response> ResponseCache::get(const Resource& resource) {
+    if (!maximumSize) {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key(resource));
+    if (it == entries.end()) {
+        ++misses;
+        return {};
+    }
+
+    ++hits;
+    uses.splice(uses.begin(), uses, it->second.use);
+    return it->second.response;
+}
+
+void ResponseCache::add(const Resource& resource, const Response& response) {
+    if (!maximumSize || response.error || response.notModified) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string entryKey = key(resource);
+    const std::size_t size = sizeof(Entry) + entryKey.size() + (response.data ? response.data->size() : 0);
+
+    auto it = entries.find(entryKey);
+    if (it != entries.end()) {
+        bytes -= it->second.bytes;
+        uses.erase(it->second.use);
+        entries.erase(it);
+    }
+
+    if (size > maximumSize) {
+        return;
+    }
+
+    it = entries.emplace(std::move(entryKey), Entry { response, size, uses.end() }).first;
+    uses.push_front(&it->first);
+    it->second.use = uses.begin();
+    bytes += size;
+
+    evict();
+}
+
+void ResponseCache::remove(const Resource& resource) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key(resource));
+    if (it != entries.end()) {
+        bytes -= it->second.bytes;
+        uses.erase(it->second.use);
+        entries.erase(it);
+    }
+}
+
+void ResponseCache::evict() {
+    while (bytes > maximumSize) {
+        // Erase by iterator: the key is owned by the entry being erased.
+        auto oldest = entries.find(*uses.back());
+        uses.pop_back();
+        bytes -= oldest->second.bytes;
+        entries.erase(oldest);
+    }
+}
+
+ResponseCache::Stats ResponseCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return { hits, misses, entries.size(), bytes };
+}
+
+} // namespace mbgl
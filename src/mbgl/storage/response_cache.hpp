@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+/*
+   A least recently used cache of responses read from a file source's database, held in memory
+   already decompressed, so that resources read again shortly after, e.g. the tiles of an area
+   zoomed out of and back into, are served without a database lookup. Map instances sharing
+   the file source share the cache.
+
+   Only successful responses are cached. The cache is safe to use from any thread, and caches
+   nothing until it's given a size.
+*/
+class ResponseCache : private util::noncopyable {
+public:
+    // Evicts the least recently used responses until the cache fits into `bytes`; zero disables
+    // the cache.
+    void setMaximumSize(std::size_t bytes);
+
+    optional<Response> get(const Resource&);
+    void add(const Resource&, const Response&);
+    void remove(const Resource&);
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        std::size_t size;
+        std::size_t bytes;
+    };
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        Response response;
+        std::size_t bytes;
+        std::list<const std::string*>::iterator use;
+    };
+
+    static std::string key(const Resource&);
+    void evict();
+
+    std::atomic<std::size_t> maximumSize { 0 };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    // Keys of the entries, most recently used first.
+    std::list<const std::string*> uses;
+    std::size_t bytes = 0;
+
+    std::atomic<uint64_t> hits { 0 };
+    std::atomic<uint64_t> misses { 0 };
+};
+
+} // namespace mbgl
@@ -0,0 +1,121 @@
+#include <mbgl/storage/tile_batch.hpp>
+#include <mbgl/util/http_header.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/token.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+std::string trim(const std::string& value) {
+    const auto begin = value.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    return value.substr(begin, value.find_last_not_of(" \t") - begin + 1);
+}
+
+bool equalsIgnoringCase(const std::string& lhs, const char* rhs) {
+    std::size_t i = 0;
+    for (; i < lhs.size() && rhs[i]; i++) {
+        if (std::tolower(static_cast<unsigned char>(lhs[i])) != rhs[i]) {
+            return false;
+        }
+    }
+    return i == lhs.size() && !rhs[i];
+}
+
+} // namespace
+
+std::string batchTileKey(const Resource::TileData& tile) {
+    return util::toString(tile.z) + "/" + util::toString(tile.x) + "/" + util::toString(tile.y);
+}
+
+std::string batchURL(const std::string& urlTemplate, const std::vector<Resource::TileData>& tiles) {
+    return util::replaceTokens(urlTemplate, [&](const std::string& token) {
+        if (token == "tiles") {
+            std::string list;
+            for (const auto& tile : tiles) {
+                if (!list.empty()) {
+                    list += ",";
+                }
+                list += batchTileKey(tile);
+            }
+            return list;
+        } else {
+            return std::string();
+        }
+    });
+}
+
+std::unordered_map<std::string, Response> parseBatchResponse(const std::string& body) {
+    const auto malformed = [] {
+        return std::runtime_error("malformed batch response");
+    };
+
+    // The first line is the boundary delimiter; every further one is preceded by a line break,
+    // which belongs to the delimiter rather than to the part before it.
+    std::size_t pos = body.find("\r\n");
+    if (pos == std::string::npos || body.compare(0, 2, "--") != 0) {
+        throw malformed();
+    }
+    const std::string delimiter = "\r\n" + body.substr(0, pos);
+
+    std::unordered_map<std::string, Response> tiles;
+    while (body.compare(pos, 2, "--") != 0) {
+        if (body.compare(pos, 2, "\r\n") != 0) {
+            throw malformed();
+        }
+        pos += 2;
+
+        Response response;
+        std::string location;
+        optional<Timestamp> expires;
+        optional<Timestamp> maxAge;
+        for (std::size_t end; (end = body.find("\r\n", pos)) != pos; pos = end + 2) {
+            if (end == std::string::npos) {
+                throw malformed();
+            }
+            const std::string line = body.substr(pos, end - pos);
+            const auto colon = line.find(':');
+            if (colon == std::string::npos) {
+                throw malformed();
+            }
+            const std::string name = trim(line.substr(0, colon));
+            const std::string value = trim(line.substr(colon + 1));
+            if (equalsIgnoringCase(name, "content-location")) {
+                location = value;
+            } else if (equalsIgnoringCase(name, "etag")) {
+                response.etag = value;
+            } else if (equalsIgnoringCase(name, "last-modified")) {
+                response.modified = util::parseTimestamp(value.c_str());
+            } else if (equalsIgnoringCase(name, "expires")) {
+                expires = util::parseTimestamp(value.c_str());
+            } else if (equalsIgnoringCase(name, "cache-control")) {
+                maxAge = http::CacheControl::parse(value).toTimePoint();
+            }
+        }
+        pos += 2;
+
+        const std::size_t next = body.find(delimiter, pos);
+        if (next == std::string::npos) {
+            throw malformed();
+        }
+        response.data = std::make_shared<const std::string>(body, pos, next - pos);
+        // Like in HTTP, a max-age takes precedence over an expiration date.
+        response.expires = maxAge ? maxAge : expires;
+        pos = next + delimiter.size();
+
+        if (!location.empty()) {
+            tiles[location] = std::move(response);
+        }
+    }
+
+    return tiles;
+}
+
+} // namespace mbgl
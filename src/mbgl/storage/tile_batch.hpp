@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   Tilesets may have a batch endpoint that returns several tiles in one response, see
+   Tileset::batch. It's requested with the `{tiles}` token of its URL template replaced by a comma
+   separated list of the tiles, each as `z/x/y`, and responds with a multipart body: the body
+   starts with its boundary delimiter, and every part has a `Content-Location: z/x/y` header that
+   tells its tile, and optionally the caching headers of a regular tile response:
+
+       --boundary
+       Content-Location: 14/8800/5373
+       Cache-Control: max-age=3600
+
+       <tile data>
+       --boundary
+       ...
+       --boundary--
+
+   Lines end in CRLF. Tiles the response doesn't have are requested on their own.
+*/
+
+// Returns the `z/x/y` of a tile, as used in batch URLs and parts.
+std::string batchTileKey(const Resource::TileData&);
+
+std::string batchURL(const std::string& urlTemplate, const std::vector<Resource::TileData>&);
+
+// Splits a batch response into the responses of its tiles, keyed by batchTileKey(). Throws if
+// the body isn't a well-formed multipart body.
+std::unordered_map<std::string, Response> parseBatchResponse(const std::string& body);
+
+} // namespace mbgl
@@ -49,6 +49,10 @@ public:
     // should call this method.
     void update(const T&);
 
+    // Like update(), for every element at once: however many elements were mutated, the
+    // collection's impls are copied only once.
+    void updateAll();
+
 private:
     std::size_t index(const std::string&) const;
 
@@ -137,5 +141,14 @@ void Collection<T>::update(const T& wrapper) {
     });
 }
 
+template <class T>
+void Collection<T>::updateAll() {
+    mutate(impls, [&] (auto& impls_) {
+        for (std::size_t i = 0; i < wrappers.size(); i++) {
+            impls_[i] = wrappers[i]->baseImpl;
+        }
+    });
+}
+
 } // namespace style
 } // namespace mbgl
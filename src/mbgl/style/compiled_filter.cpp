@@ -0,0 +1,468 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <array>
+#include <cassert>
+#include <functional>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+// Per-evaluation state: the feature being evaluated and the values fetched for it so far.
+class CompiledFilter::Context {
+public:
+    Context(const std::vector<std::string>& keys_,
+            FeatureType type_,
+            const optional<FeatureIdentifier>& id_,
+            const void* data_,
+            Lookup lookup_)
+        : type(type_), id(id_), keys(keys_), data(data_), lookup(lookup_) {
+    }
+
+    // Returns the feature's value for the key in the given slot, or nullptr if the
+    // feature has no such property. Each slot is looked up at most once.
+    const Value* get(std::size_t slot) {
+        optional<Value>* value;
+        if (slot < inlineSlots) {
+            if (!(fetched & (1u << slot))) {
+                values[slot] = lookup(data, keys[slot]);
+                fetched |= (1u << slot);
+            }
+            value = &values[slot];
+        } else {
+            if (overflow.empty()) {
+                overflow.resize(keys.size() - inlineSlots);
+            }
+            optional<optional<Value>>& entry = overflow[slot - inlineSlots];
+            if (!entry) {
+                entry = lookup(data, keys[slot]);
+            }
+            value = &*entry;
+        }
+        return *value ? &**value : nullptr;
+    }
+
+    const FeatureType type;
+    const optional<FeatureIdentifier>& id;
+
+private:
+    static constexpr std::size_t inlineSlots = 8;
+
+    const std::vector<std::string>& keys;
+    const void* data;
+    const Lookup lookup;
+
+    uint32_t fetched = 0;
+    std::array<optional<Value>, inlineSlots> values;
+    std::vector<optional<optional<Value>>> overflow;
+};
+
+class CompiledFilter::Program {
+public:
+    std::vector<std::string> keys;
+    std::function<bool (Context&)> root;
+    bool matchesAll = false;
+};
+
+namespace {
+
+using Context = CompiledFilter::Context;
+using Node = std::function<bool (Context&)>;
+
+// Same comparison semantics as `FilterEvaluator`: numbers compare across integer and
+// floating point representations, and values of differing types never match.
+template <class Op>
+struct Comparator {
+    const Op& op;
+
+    template <class T>
+    bool operator()(const T& lhs, const T& rhs) const {
+        return op(lhs, rhs);
+    }
+
+    template <class T0, class T1>
+    auto operator()(const T0& lhs, const T1& rhs) const
+        -> typename std::enable_if_t<std::is_arithmetic<T0>::value && !std::is_same<T0, bool>::value &&
+                                     std::is_arithmetic<T1>::value && !std::is_same<T1, bool>::value, bool> {
+        return op(double(lhs), double(rhs));
+    }
+
+    template <class T0, class T1>
+    auto operator()(const T0&, const T1&) const
+        -> typename std::enable_if_t<!std::is_arithmetic<T0>::value || std::is_same<T0, bool>::value ||
+                                     !std::is_arithmetic<T1>::value || std::is_same<T1, bool>::value, bool> {
+        return false;
+    }
+
+    bool operator()(const NullValue&, const NullValue&) const {
+        // Should be unreachable; null is not currently allowed by the style specification.
+        assert(false);
+        return false;
+    }
+
+    bool operator()(const std::vector<Value>&, const std::vector<Value>&) const {
+        // Should be unreachable; nested values are not currently allowed by the style specification.
+        assert(false);
+        return false;
+    }
+
+    bool operator()(const PropertyMap&, const PropertyMap&) const {
+        // Should be unreachable; nested values are not currently allowed by the style specification.
+        assert(false);
+        return false;
+    }
+};
+
+template <class Op>
+bool compare(const Value& lhs, const Value& rhs, const Op& op) {
+    return Value::binary_visit(lhs, rhs, Comparator<Op> { op });
+}
+
+bool equal(const Value& lhs, const Value& rhs) {
+    return compare(lhs, rhs, [] (const auto& lhs_, const auto& rhs_) { return lhs_ == rhs_; });
+}
+
+// The values of an `in` or `!in` filter. Strings only ever equal strings, so they are
+// hashed; everything else keeps the generic comparison.
+class ValueSet {
+public:
+    explicit ValueSet(const std::vector<Value>& values) {
+        for (const auto& value : values) {
+            if (value.is<std::string>()) {
+                strings.insert(value.get<std::string>());
+            } else {
+                others.push_back(value);
+            }
+        }
+    }
+
+    bool contains(const Value& actual) const {
+        if (actual.is<std::string>()) {
+            return strings.count(actual.get<std::string>()) != 0;
+        }
+        for (const auto& value : others) {
+            if (equal(actual, value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::unordered_set<std::string> strings;
+    std::vector<Value> others;
+};
+
+// Whether a filter accepts every feature regardless of its properties.
+bool matchesAll(const Filter& filter) {
+    if (filter.is<NullFilter>()) {
+        return true;
+    }
+    if (filter.is<AllFilter>()) {
+        for (const auto& child : filter.get<AllFilter>().filters) {
+            if (!matchesAll(child)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+uint32_t typeMask(const std::vector<FeatureType>& types) {
+    uint32_t mask = 0;
+    for (const auto& type : types) {
+        mask |= 1u << uint8_t(type);
+    }
+    return mask;
+}
+
+class Compiler {
+public:
+    std::vector<std::string>& keys;
+
+    Node compile(const Filter& filter) {
+        return Filter::visit(filter, *this);
+    }
+
+    Node operator()(const NullFilter&) {
+        return [] (Context&) { return true; };
+    }
+
+    Node operator()(const EqualsFilter& filter) {
+        const std::size_t key = slot(filter.key);
+        if (filter.value.is<std::string>()) {
+            return [key, value = filter.value.get<std::string>()] (Context& context) {
+                const Value* actual = context.get(key);
+                return actual && actual->is<std::string>() && actual->get<std::string>() == value;
+            };
+        }
+        return [key, value = filter.value] (Context& context) {
+            const Value* actual = context.get(key);
+            return actual && equal(*actual, value);
+        };
+    }
+
+    Node operator()(const NotEqualsFilter& filter) {
+        const std::size_t key = slot(filter.key);
+        if (filter.value.is<std::string>()) {
+            return [key, value = filter.value.get<std::string>()] (Context& context) {
+                const Value* actual = context.get(key);
+                return !actual || !actual->is<std::string>() || actual->get<std::string>() != value;
+            };
+        }
+        return [key, value = filter.value] (Context& context) {
+            const Value* actual = context.get(key);
+            return !actual || !equal(*actual, value);
+        };
+    }
+
+    Node operator()(const LessThanFilter& filter) {
+        return comparison(filter.key, filter.value, [] (const auto& lhs, const auto& rhs) { return lhs < rhs; });
+    }
+
+    Node operator()(const LessThanEqualsFilter& filter) {
+        return comparison(filter.key, filter.value, [] (const auto& lhs, const auto& rhs) { return lhs <= rhs; });
+    }
+
+    Node operator()(const GreaterThanFilter& filter) {
+        return comparison(filter.key, filter.value, [] (const auto& lhs, const auto& rhs) { return lhs > rhs; });
+    }
+
+    Node operator()(const GreaterThanEqualsFilter& filter) {
+        return comparison(filter.key, filter.value, [] (const auto& lhs, const auto& rhs) { return lhs >= rhs; });
+    }
+
+    Node operator()(const InFilter& filter) {
+        return [key = slot(filter.key), values = ValueSet(filter.values)] (Context& context) {
+            const Value* actual = context.get(key);
+            return actual && values.contains(*actual);
+        };
+    }
+
+    Node operator()(const NotInFilter& filter) {
+        return [key = slot(filter.key), values = ValueSet(filter.values)] (Context& context) {
+            const Value* actual = context.get(key);
+            return !actual || !values.contains(*actual);
+        };
+    }
+
+    Node operator()(const AnyFilter& filter) {
+        std::vector<Node> children = flatten<AnyFilter>(filter.filters);
+        if (children.size() == 1) {
+            return std::move(children.front());
+        }
+        return [children = std::move(children)] (Context& context) {
+            for (const auto& child : children) {
+                if (child(context)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+    }
+
+    Node operator()(const AllFilter& filter) {
+        std::vector<Node> children = flatten<AllFilter>(filter.filters);
+        if (children.size() == 1) {
+            return std::move(children.front());
+        }
+        return [children = std::move(children)] (Context& context) {
+            for (const auto& child : children) {
+                if (!child(context)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+    }
+
+    Node operator()(const NoneFilter& filter) {
+        return [children = flatten<AnyFilter>(filter.filters)] (Context& context) {
+            for (const auto& child : children) {
+                if (child(context)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+    }
+
+    Node operator()(const HasFilter& filter) {
+        return [key = slot(filter.key)] (Context& context) {
+            return context.get(key) != nullptr;
+        };
+    }
+
+    Node operator()(const NotHasFilter& filter) {
+        return [key = slot(filter.key)] (Context& context) {
+            return context.get(key) == nullptr;
+        };
+    }
+
+    Node operator()(const TypeEqualsFilter& filter) {
+        return [value = filter.value] (Context& context) {
+            return context.type == value;
+        };
+    }
+
+    Node operator()(const TypeNotEqualsFilter& filter) {
+        return [value = filter.value] (Context& context) {
+            return context.type != value;
+        };
+    }
+
+    Node operator()(const TypeInFilter& filter) {
+        return [mask = typeMask(filter.values)] (Context& context) {
+            return (mask & (1u << uint8_t(context.type))) != 0;
+        };
+    }
+
+    Node operator()(const TypeNotInFilter& filter) {
+        return [mask = typeMask(filter.values)] (Context& context) {
+            return (mask & (1u << uint8_t(context.type))) == 0;
+        };
+    }
+
+    Node operator()(const IdentifierEqualsFilter& filter) {
+        return [value = filter.value] (Context& context) {
+            return context.id == value;
+        };
+    }
+
+    Node operator()(const IdentifierNotEqualsFilter& filter) {
+        return [value = filter.value] (Context& context) {
+            return context.id != value;
+        };
+    }
+
+    Node operator()(const IdentifierInFilter& filter) {
+        return [values = filter.values] (Context& context) {
+            for (const auto& value : values) {
+                if (context.id == value) {
+                    return true;
+                }
+            }
+            return false;
+        };
+    }
+
+    Node operator()(const IdentifierNotInFilter& filter) {
+        return [values = filter.values] (Context& context) {
+            for (const auto& value : values) {
+                if (context.id == value) {
+                    return false;
+                }
+            }
+            return true;
+        };
+    }
+
+    Node operator()(const HasIdentifierFilter&) {
+        return [] (Context& context) {
+            return bool(context.id);
+        };
+    }
+
+    Node operator()(const NotHasIdentifierFilter&) {
+        return [] (Context& context) {
+            return !context.id;
+        };
+    }
+
+private:
+    std::size_t slot(const std::string& key) {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) {
+                return i;
+            }
+        }
+        keys.push_back(key);
+        return keys.size() - 1;
+    }
+
+    template <class Op>
+    Node comparison(const std::string& property, const Value& value, Op op) {
+        return [key = slot(property), value, op] (Context& context) {
+            const Value* actual = context.get(key);
+            return actual && compare(*actual, value, op);
+        };
+    }
+
+    // Compiles the children of an `any` or `all` filter, splicing in the children of nested
+    // filters of the same kind. Children of `all` filters that accept everything are dropped.
+    template <class Combinator>
+    std::vector<Node> flatten(const std::vector<Filter>& filters) {
+        std::vector<Node> result;
+        flatten<Combinator>(filters, result);
+        return result;
+    }
+
+    template <class Combinator>
+    void flatten(const std::vector<Filter>& filters, std::vector<Node>& result) {
+        for (const auto& filter : filters) {
+            if (filter.is<Combinator>()) {
+                flatten<Combinator>(filter.get<Combinator>().filters, result);
+            } else if (!std::is_same<Combinator, AllFilter>::value || !matchesAll(filter)) {
+                result.push_back(compile(filter));
+            }
+        }
+    }
+};
+
+} // namespace
+
+CompiledFilter::CompiledFilter()
+    : CompiledFilter(NullFilter()) {
+}
+
+CompiledFilter::CompiledFilter(const Filter& filter) {
+    auto program_ = std::make_shared<Program>();
+    program_->matchesAll = style::matchesAll(filter);
+    if (!program_->matchesAll) {
+        program_->root = Compiler { program_->keys }.compile(filter);
+    }
+    program = std::move(program_);
+}
+
+bool CompiledFilter::matchesAll() const {
+    return program->matchesAll;
+}
+
+bool CompiledFilter::operator()(const Feature& feature) const {
+    if (program->matchesAll) {
+        return true;
+    }
+    return evaluate(apply_visitor(ToFeatureType(), feature.geometry), feature.id, &feature,
+        [] (const void* data, const std::string& key) -> optional<Value> {
+            const PropertyMap& properties = static_cast<const Feature*>(data)->properties;
+            auto it = properties.find(key);
+            if (it == properties.end())
+                return {};
+            return it->second;
+        });
+}
+
+bool CompiledFilter::operator()(const GeometryTileFeature& feature) const {
+    if (program->matchesAll) {
+        return true;
+    }
+    return evaluate(feature.getType(), feature.getID(), &feature,
+        [] (const void* data, const std::string& key) {
+            return static_cast<const GeometryTileFeature*>(data)->getValue(key);
+        });
+}
+
+bool CompiledFilter::evaluate(FeatureType type, const optional<FeatureIdentifier>& id, const void* data, Lookup lookup) const {
+    if (program->matchesAll) {
+        return true;
+    }
+    Context context(program->keys, type, id, data, lookup);
+    return program->root(context);
+}
+
+} // namespace style
+} // namespace mbgl
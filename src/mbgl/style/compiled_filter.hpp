@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class GeometryTileFeature;
+
+namespace style {
+
+/*
+   A `Filter` compiled into a tree of specialized closures, for evaluation over many features.
+
+   Compilation resolves each distinct property key to a slot, so that a feature's value for a
+   key is looked up at most once per evaluation no matter how often the filter references it.
+   Nested `all`/`any` filters are flattened, `in` filters over strings become hash lookups, and
+   filters that accept everything are detected up front so that callers skip evaluation
+   entirely. Results are identical to those of `FilterEvaluator`.
+
+   Compiled filters are immutable and cheap to copy; copies share the compiled program.
+*/
+class CompiledFilter {
+public:
+    using Lookup = optional<Value> (*)(const void* data, const std::string& key);
+
+    // Accepts every feature, like a default-constructed `Filter`.
+    CompiledFilter();
+    explicit CompiledFilter(const Filter&);
+
+    bool matchesAll() const;
+
+    bool operator()(const Feature&) const;
+    bool operator()(const GeometryTileFeature&) const;
+
+    template <class PropertyAccessor>
+    bool operator()(FeatureType type, const optional<FeatureIdentifier>& id, const PropertyAccessor& accessor) const {
+        return evaluate(type, id, &accessor, [] (const void* data, const std::string& key) -> optional<Value> {
+            return (*static_cast<const PropertyAccessor*>(data))(key);
+        });
+    }
+
+    class Context;
+    class Program;
+
+private:
+    bool evaluate(FeatureType, const optional<FeatureIdentifier>&, const void* data, Lookup) const;
+
+    std::shared_ptr<const Program> program;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -1,16 +1,562 @@
 #include <mbgl/style/conversion/geojson.hpp>
-#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/util/rapidjson.hpp>
 
 #include <mapbox/geojson.hpp>
 #include <mapbox/geojson/rapidjson.hpp>
 
+#include <rapidjson/reader.h>
+
+#include <sstream>
+
 namespace mbgl {
 namespace style {
 namespace conversion {
 
+namespace {
+
+using Geometry = mapbox::geometry::geometry<double>;
+
+// Builds the GeoJSON from the events of the SAX parser, without a JSON document in between. The
+// members of GeoJSON objects may come in any order, so coordinates are kept as flat numbers,
+// together with the sizes of the arrays at each depth, until the type of the geometry is known.
+class GeoJSONHandler {
+public:
+    optional<GeoJSON> result;
+    std::string error;
+
+    bool Null() { return scalar(NullValue()); }
+    bool Bool(bool value) { return scalar(value); }
+    bool Int(int value) { return scalar(int64_t(value)); }
+    bool Uint(unsigned value) { return scalar(uint64_t(value)); }
+    bool Int64(int64_t value) { return scalar(value); }
+    bool Uint64(uint64_t value) { return scalar(value); }
+    bool Double(double value) { return scalar(value); }
+    bool RawNumber(const char*, rapidjson::SizeType, bool) { return fail("unexpected raw number"); }
+    bool String(const char* value, rapidjson::SizeType length, bool) { return scalar(std::string(value, length)); }
+
+    bool StartObject() {
+        if (skipping) {
+            skipping++;
+            return true;
+        }
+
+        switch (states.back()) {
+        case State::Root:
+        case State::Features:
+        case State::Geometries:
+            return startGeoJSONObject();
+        case State::Object:
+            return startObjectMember();
+        case State::Value:
+            containers.push_back({ PropertyMap(), {} });
+            return true;
+        case State::Coordinates:
+            return fail("coordinates must be numbers");
+        }
+        return false;
+    }
+
+    bool Key(const char* value, rapidjson::SizeType length, bool) {
+        if (skipping) {
+            return true;
+        }
+
+        const std::string key(value, length);
+        if (states.back() == State::Value) {
+            containers.back().key = key;
+            return true;
+        }
+
+        Object& object = objects.back();
+        if (key == "type") {
+            object.member = Member::Type;
+        } else if (key == "coordinates") {
+            object.member = Member::Coordinates;
+        } else if (key == "geometries") {
+            object.member = Member::Geometries;
+        } else if (key == "features") {
+            object.member = Member::Features;
+        } else if (key == "geometry") {
+            object.member = Member::Geometry;
+        } else if (key == "properties") {
+            object.member = Member::Properties;
+        } else if (key == "id") {
+            object.member = Member::Id;
+        } else {
+            object.member = Member::Other;
+        }
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        if (skipping) {
+            return endSkipped();
+        }
+        if (states.back() == State::Value) {
+            return endContainer();
+        }
+        return endGeoJSONObject();
+    }
+
+    bool StartArray() {
+        if (skipping) {
+            skipping++;
+            return true;
+        }
+
+        switch (states.back()) {
+        case State::Root:
+            return fail("GeoJSON must be an object");
+        case State::Features:
+        case State::Geometries:
+            return fail(states.back() == State::Features ? "features must be objects" : "geometries must be objects");
+        case State::Value:
+            containers.push_back({ std::vector<Value>(), {} });
+            return true;
+        case State::Coordinates:
+            return startCoordinateArray();
+        case State::Object:
+            return startArrayMember();
+        }
+        return false;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        if (skipping) {
+            return endSkipped();
+        }
+
+        switch (states.back()) {
+        case State::Value:
+            return endContainer();
+        case State::Coordinates:
+            return endCoordinateArray();
+        case State::Features:
+        case State::Geometries:
+            states.pop_back();
+            objects.back().member = Member::None;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+private:
+    enum class State { Root, Object, Features, Geometries, Coordinates, Value };
+    enum class Member { None, Type, Coordinates, Geometries, Features, Geometry, Properties, Id, Other };
+
+    struct Coordinates {
+        std::vector<double> numbers;
+        std::vector<std::vector<std::size_t>> sizes;
+        // The depth of the arrays of numbers, once one ended.
+        optional<std::size_t> leafDepth;
+    };
+
+    struct Object {
+        Member member = Member::None;
+        std::string type;
+        Coordinates coordinates;
+        bool hasCoordinates = false;
+        mapbox::geometry::geometry_collection<double> geometries;
+        FeatureCollection features;
+        optional<Geometry> geometry;
+        PropertyMap properties;
+        optional<FeatureIdentifier> id;
+    };
+
+    // An open array of coordinates, and whether it holds numbers or arrays.
+    struct CoordinateArray {
+        std::size_t size = 0;
+        optional<bool> numbers;
+    };
+
+    // An open array or object of a property value, and the key of its next member.
+    struct Container {
+        Value value;
+        std::string key;
+    };
+
+    std::vector<State> states { State::Root };
+    std::vector<Object> objects;
+    std::vector<CoordinateArray> coordinateArrays;
+    std::vector<Container> containers;
+    std::size_t skipping = 0;
+
+    bool fail(std::string message) {
+        error = std::move(message);
+        return false;
+    }
+
+    std::string memberError() const {
+        switch (objects.back().member) {
+        case Member::Type: return "type must be a string";
+        case Member::Coordinates: return "coordinates must be an array";
+        case Member::Geometries: return "geometries must be an array";
+        case Member::Features: return "features must be an array";
+        case Member::Geometry: return "geometry must be an object or null";
+        case Member::Properties: return "properties must be an object or null";
+        case Member::Id: return "id must be a number or a string";
+        default: return "unexpected value";
+        }
+    }
+
+    bool startObjectMember() {
+        switch (objects.back().member) {
+        case Member::Geometry:
+            return startGeoJSONObject();
+        case Member::Properties:
+            states.push_back(State::Value);
+            containers.push_back({ PropertyMap(), {} });
+            return true;
+        case Member::Other:
+            skipping = 1;
+            return true;
+        default:
+            return fail(memberError());
+        }
+    }
+
+    bool startArrayMember() {
+        switch (objects.back().member) {
+        case Member::Coordinates:
+            objects.back().coordinates = {};
+            states.push_back(State::Coordinates);
+            return startCoordinateArray();
+        case Member::Features:
+            states.push_back(State::Features);
+            return true;
+        case Member::Geometries:
+            states.push_back(State::Geometries);
+            return true;
+        case Member::Other:
+            skipping = 1;
+            return true;
+        default:
+            return fail(memberError());
+        }
+    }
+
+    bool scalar(Value value) {
+        if (skipping) {
+            return true;
+        }
+
+        switch (states.back()) {
+        case State::Root:
+            return fail("GeoJSON must be an object");
+        case State::Features:
+            return fail("features must be objects");
+        case State::Geometries:
+            return fail("geometries must be objects");
+        case State::Value:
+            add(std::move(value));
+            return true;
+        case State::Coordinates:
+            return coordinate(value);
+        case State::Object:
+            return member(std::move(value));
+        }
+        return false;
+    }
+
+    bool member(Value value) {
+        Object& object = objects.back();
+        switch (object.member) {
+        case Member::Type:
+            if (!value.is<std::string>()) {
+                return fail(memberError());
+            }
+            object.type = std::move(value.get<std::string>());
+            break;
+        case Member::Id:
+            if (value.is<uint64_t>()) {
+                object.id = FeatureIdentifier(value.get<uint64_t>());
+            } else if (value.is<int64_t>()) {
+                object.id = FeatureIdentifier(value.get<int64_t>());
+            } else if (value.is<double>()) {
+                object.id = FeatureIdentifier(value.get<double>());
+            } else if (value.is<std::string>()) {
+                object.id = FeatureIdentifier(std::move(value.get<std::string>()));
+            } else if (!value.is<NullValue>()) {
+                return fail(memberError());
+            }
+            break;
+        case Member::Geometry:
+            if (!value.is<NullValue>()) {
+                return fail(memberError());
+            }
+            object.geometry = Geometry { mapbox::geometry::geometry_collection<double>() };
+            break;
+        case Member::Properties:
+            if (!value.is<NullValue>()) {
+                return fail(memberError());
+            }
+            break;
+        case Member::Coordinates:
+        case Member::Geometries:
+        case Member::Features:
+            return fail(memberError());
+        case Member::None:
+        case Member::Other:
+            break;
+        }
+        object.member = Member::None;
+        return true;
+    }
+
+    void add(Value value) {
+        Container& container = containers.back();
+        if (container.value.is<std::vector<Value>>()) {
+            container.value.get<std::vector<Value>>().push_back(std::move(value));
+        } else {
+            container.value.get<PropertyMap>()[container.key] = std::move(value);
+        }
+    }
+
+    bool endContainer() {
+        Value value = std::move(containers.back().value);
+        containers.pop_back();
+
+        if (!containers.empty()) {
+            add(std::move(value));
+            return true;
+        }
+
+        states.pop_back();
+        Object& object = objects.back();
+        object.properties = std::move(value.get<PropertyMap>());
+        object.member = Member::None;
+        return true;
+    }
+
+    bool endSkipped() {
+        if (--skipping == 0) {
+            objects.back().member = Member::None;
+        }
+        return true;
+    }
+
+    bool startCoordinateArray() {
+        if (!coordinateArrays.empty()) {
+            CoordinateArray& parent = coordinateArrays.back();
+            if (parent.numbers && *parent.numbers) {
+                return fail("coordinates must be numbers");
+            }
+            parent.numbers = false;
+            parent.size++;
+        }
+        coordinateArrays.emplace_back();
+        return true;
+    }
+
+    bool coordinate(const Value& value) {
+        optional<double> number = numericValue<double>(value);
+        CoordinateArray& array = coordinateArrays.back();
+        if (!number || (array.numbers && !*array.numbers)) {
+            return fail("coordinates must be arrays of numbers");
+        }
+        array.numbers = true;
+        array.size++;
+        objects.back().coordinates.numbers.push_back(*number);
+        return true;
+    }
+
+    bool endCoordinateArray() {
+        Coordinates& coordinates = objects.back().coordinates;
+        const std::size_t depth = coordinateArrays.size() - 1;
+        const CoordinateArray array = coordinateArrays.back();
+        coordinateArrays.pop_back();
+
+        if (array.numbers && *array.numbers) {
+            if (coordinates.leafDepth && *coordinates.leafDepth != depth) {
+                return fail("coordinates must be nested evenly");
+            }
+            coordinates.leafDepth = depth;
+        }
+        if (coordinates.sizes.size() <= depth) {
+            coordinates.sizes.resize(depth + 1);
+        }
+        coordinates.sizes[depth].push_back(array.size);
+
+        if (coordinateArrays.empty()) {
+            states.pop_back();
+            objects.back().hasCoordinates = true;
+            objects.back().member = Member::None;
+        }
+        return true;
+    }
+
+    bool startGeoJSONObject() {
+        objects.emplace_back();
+        states.push_back(State::Object);
+        return true;
+    }
+
+    bool endGeoJSONObject() {
+        Object object = std::move(objects.back());
+        objects.pop_back();
+        states.pop_back();
+
+        try {
+            switch (states.back()) {
+            case State::Root:
+                if (object.type == "FeatureCollection") {
+                    result = GeoJSON { std::move(object.features) };
+                } else if (object.type == "Feature") {
+                    result = GeoJSON { toFeature(object) };
+                } else {
+                    result = GeoJSON { toGeometry(object) };
+                }
+                break;
+            case State::Features:
+                objects.back().features.push_back(toFeature(object));
+                break;
+            case State::Geometries:
+                objects.back().geometries.push_back(toGeometry(object));
+                break;
+            case State::Object:
+                objects.back().geometry = toGeometry(object);
+                objects.back().member = Member::None;
+                break;
+            default:
+                return false;
+            }
+        } catch (const std::exception& ex) {
+            return fail(ex.what());
+        }
+        return true;
+    }
+
+    static Feature toFeature(Object& object) {
+        if (object.type != "Feature") {
+            throw std::runtime_error("features must be of type Feature");
+        }
+        if (!object.geometry) {
+            throw std::runtime_error("Feature must have a geometry property");
+        }
+        Feature feature { std::move(*object.geometry) };
+        feature.properties = std::move(object.properties);
+        feature.id = std::move(object.id);
+        return feature;
+    }
+
+    // Reads the coordinates back in document order.
+    class CoordinateReader {
+    public:
+        CoordinateReader(const Coordinates& coordinates_, std::size_t depth)
+            : coordinates(coordinates_),
+              indices(depth + 1, 0) {
+            if (coordinates.sizes.size() > depth + 1 ||
+                (coordinates.leafDepth && *coordinates.leafDepth != depth)) {
+                throw std::runtime_error("coordinates are nested too deeply or not deeply enough");
+            }
+        }
+
+        std::size_t size(std::size_t depth) {
+            return coordinates.sizes.at(depth).at(indices[depth]++);
+        }
+
+        mapbox::geometry::point<double> point(std::size_t depth) {
+            const std::size_t length = size(depth);
+            if (length < 2) {
+                throw std::runtime_error("coordinates must have at least two numbers");
+            }
+            mapbox::geometry::point<double> result { coordinates.numbers[number], coordinates.numbers[number + 1] };
+            number += length;
+            return result;
+        }
+
+        template <class T>
+        T points(std::size_t depth) {
+            T result;
+            const std::size_t length = size(depth);
+            result.reserve(length);
+            for (std::size_t i = 0; i < length; i++) {
+                result.push_back(point(depth + 1));
+            }
+            return result;
+        }
+
+        template <class T, class Read>
+        T list(std::size_t depth, Read read) {
+            T result;
+            const std::size_t length = size(depth);
+            result.reserve(length);
+            for (std::size_t i = 0; i < length; i++) {
+                result.push_back(read(depth + 1));
+            }
+            return result;
+        }
+
+    private:
+        const Coordinates& coordinates;
+        std::vector<std::size_t> indices;
+        std::size_t number = 0;
+    };
+
+    static Geometry toGeometry(Object& object) {
+        using namespace mapbox::geometry;
+
+        if (object.type == "GeometryCollection") {
+            return std::move(object.geometries);
+        }
+        if (!object.hasCoordinates) {
+            throw std::runtime_error("geometry must have coordinates");
+        }
+
+        const Coordinates& coordinates = object.coordinates;
+        if (object.type == "Point") {
+            return CoordinateReader(coordinates, 0).point(0);
+        } else if (object.type == "MultiPoint") {
+            return CoordinateReader(coordinates, 1).points<multi_point<double>>(0);
+        } else if (object.type == "LineString") {
+            return CoordinateReader(coordinates, 1).points<line_string<double>>(0);
+        } else if (object.type == "MultiLineString") {
+            CoordinateReader reader(coordinates, 2);
+            return reader.list<multi_line_string<double>>(0, [&] (std::size_t depth) {
+                return reader.points<line_string<double>>(depth);
+            });
+        } else if (object.type == "Polygon") {
+            CoordinateReader reader(coordinates, 2);
+            return reader.list<polygon<double>>(0, [&] (std::size_t depth) {
+                return reader.points<linear_ring<double>>(depth);
+            });
+        } else if (object.type == "MultiPolygon") {
+            CoordinateReader reader(coordinates, 3);
+            return reader.list<multi_polygon<double>>(0, [&] (std::size_t depth) {
+                return reader.list<polygon<double>>(depth, [&] (std::size_t ringDepth) {
+                    return reader.points<linear_ring<double>>(ringDepth);
+                });
+            });
+        }
+        throw std::runtime_error("unknown geometry type " + object.type);
+    }
+};
+
+} // namespace
+
+// Parses the string with the SAX parser, which needs less memory than a document for the large
+// GeoJSON that sources load from URLs.
 optional<GeoJSON> Converter<GeoJSON>::operator()(const std::string& value, Error& error) const {
-    return convertJSON<GeoJSON>(value, error);
+    GeoJSONHandler handler;
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(value.c_str());
+    rapidjson::ParseResult parsed = reader.Parse(stream, handler);
+
+    if (!parsed || !handler.result) {
+        std::stringstream message;
+        message << parsed.Offset() << " - ";
+        if (!handler.error.empty()) {
+            message << handler.error;
+        } else {
+            message << rapidjson::GetParseError_En(parsed.Code());
+        }
+        error = { message.str() };
+        return {};
+    }
+
+    return handler.result;
 }
 
 template <>
@@ -2,30 +2,84 @@
 #include <mbgl/style/types.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <algorithm>
 #include <array>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
 
-optional<CategoricalValue> categoricalValue(const Value& value) {
-    return value.match(
-        [] (bool t) { return optional<CategoricalValue>(t); },
-        [] (uint64_t t) { return optional<CategoricalValue>(int64_t(t)); },
-        [] (int64_t t) { return optional<CategoricalValue>(t); },
-        [] (double t) { return optional<CategoricalValue>(int64_t(t)); },
-        [] (const std::string& t) { return optional<CategoricalValue>(t); },
-        [] (const auto&) { return optional<CategoricalValue>(); }
-    );
+template <class T>
+struct CategoricalStops<T>::Lookup {
+    std::unordered_map<std::string, T> strings;
+
+    // Integer stops whose values lie close together are kept in an array indexed from
+    // `firstInteger`, the others in a hash table.
+    int64_t firstInteger = 0;
+    std::vector<optional<T>> denseIntegers;
+    std::unordered_map<int64_t, T> integers;
+
+    optional<T> falseValue;
+    optional<T> trueValue;
+
+    optional<T> integer(int64_t value) const {
+        if (!denseIntegers.empty()) {
+            const uint64_t index = uint64_t(value) - uint64_t(firstInteger);
+            return index < denseIntegers.size() ? denseIntegers[index] : optional<T>();
+        }
+        auto it = integers.find(value);
+        return it == integers.end() ? optional<T>() : it->second;
+    }
+};
+
+template <class T>
+std::shared_ptr<const typename CategoricalStops<T>::Lookup> CategoricalStops<T>::compile(const Stops& stops) {
+    auto lookup = std::make_shared<Lookup>();
+
+    for (const auto& stop : stops) {
+        stop.first.match(
+            [&] (bool t) { (t ? lookup->trueValue : lookup->falseValue) = stop.second; },
+            [&] (int64_t t) { lookup->integers.emplace(t, stop.second); },
+            [&] (const std::string& t) { lookup->strings.emplace(t, stop.second); }
+        );
+    }
+
+    if (!lookup->integers.empty()) {
+        const auto bounds = std::minmax_element(lookup->integers.begin(), lookup->integers.end(),
+            [] (const auto& a, const auto& b) { return a.first < b.first; });
+        const uint64_t span = uint64_t(bounds.second->first) - uint64_t(bounds.first->first);
+
+        // Only use an array while at least a third of it is filled.
+        if (span < 3 * lookup->integers.size()) {
+            lookup->firstInteger = bounds.first->first;
+            lookup->denseIntegers.resize(span + 1);
+            for (const auto& entry : lookup->integers) {
+                lookup->denseIntegers[uint64_t(entry.first) - uint64_t(lookup->firstInteger)] = entry.second;
+            }
+            lookup->integers.clear();
+        }
+    }
+
+    return lookup;
 }
 
 template <class T>
 optional<T> CategoricalStops<T>::evaluate(const Value& value) const {
-    auto v = categoricalValue(value);
-    if (!v) {
+    if (!lookup) {
         return {};
     }
-    auto it = stops.find(*v);
-    return it == stops.end() ? optional<T>() : it->second;
+    return value.match(
+        [&] (bool t) { return t ? lookup->trueValue : lookup->falseValue; },
+        [&] (uint64_t t) { return lookup->integer(int64_t(t)); },
+        [&] (int64_t t) { return lookup->integer(t); },
+        [&] (double t) { return lookup->integer(int64_t(t)); },
+        [&] (const std::string& t) {
+            auto it = lookup->strings.find(t);
+            return it == lookup->strings.end() ? optional<T>() : it->second;
+        },
+        [&] (const auto&) { return optional<T>(); }
+    );
 }
 
 template class CategoricalStops<float>;
@@ -9,15 +9,50 @@ Image::Impl::Impl(std::string id_,
                   const float pixelRatio_,
                   bool sdf_)
         : id(std::move(id_)),
-          image(std::move(image_)),
           pixelRatio(pixelRatio_),
-          sdf(sdf_) {
+          sdf(sdf_),
+          sheet(std::make_shared<const PremultipliedImage>(std::move(image_))),
+          origin(0, 0),
+          size(sheet->size) {
+    validate();
+}
+
+Image::Impl::Impl(std::string id_,
+                  std::shared_ptr<const PremultipliedImage> sheet_,
+                  const Point<uint32_t> origin_,
+                  const Size size_,
+                  const float pixelRatio_,
+                  bool sdf_)
+        : id(std::move(id_)),
+          pixelRatio(pixelRatio_),
+          sdf(sdf_),
+          sheet(std::move(sheet_)),
+          origin(origin_),
+          size(size_) {
+    validate();
+}
 
-    if (!image.valid()) {
+void Image::Impl::validate() const {
+    if (!sheet->valid() || size.isEmpty()) {
         throw util::SpriteImageException("Sprite image dimensions may not be zero");
     } else if (pixelRatio <= 0) {
         throw util::SpriteImageException("Sprite pixelRatio may not be <= 0");
+    } else if (size.width > sheet->size.width || origin.x > sheet->size.width - size.width ||
+               size.height > sheet->size.height || origin.y > sheet->size.height - size.height) {
+        throw util::SpriteImageException("Sprite image must be within its sprite sheet");
+    }
+}
+
+const PremultipliedImage& Image::Impl::getImage() const {
+    if (size == sheet->size) {
+        return *sheet;
     }
+
+    std::call_once(copyPixels, [&] {
+        pixels = PremultipliedImage(size);
+        PremultipliedImage::copy(*sheet, pixels, origin, { 0, 0 }, size);
+    });
+    return pixels;
 }
 
 } // namespace style
@@ -2,9 +2,11 @@
 
 #include <mbgl/style/image.hpp>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <mutex>
 
 namespace mbgl {
 namespace style {
@@ -13,15 +15,37 @@ class Image::Impl {
 public:
     Impl(std::string id, PremultipliedImage&&, float pixelRatio, bool sdf = false);
 
-    const std::string id;
+    // An image that refers to a region of a sprite sheet, which it shares with the other images
+    // of the sheet instead of copying its pixels.
+    Impl(std::string id,
+         std::shared_ptr<const PremultipliedImage> sheet,
+         Point<uint32_t> origin,
+         Size size,
+         float pixelRatio,
+         bool sdf = false);
 
-    PremultipliedImage image;
+    const std::string id;
 
     // Pixel ratio of the sprite image.
     const float pixelRatio;
 
     // Whether this image should be interpreted as a signed distance field icon.
     const bool sdf;
+
+    // The pixels of the image are those within `size` at `origin` in `sheet`.
+    const std::shared_ptr<const PremultipliedImage> sheet;
+    const Point<uint32_t> origin;
+    const Size size;
+
+    // The pixels of the image on their own, which images of a sprite sheet only copy when first
+    // asked for them.
+    const PremultipliedImage& getImage() const;
+
+private:
+    void validate() const;
+
+    mutable std::once_flag copyPixels;
+    mutable PremultipliedImage pixels;
 };
 
 } // namespace style
@@ -1,4 +1,8 @@
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/conversion/stringify.hpp>
+
+#include <atomic>
+#include <functional>
 
 namespace mbgl {
 namespace style {
@@ -9,5 +13,38 @@ Layer::Impl::Impl(LayerType type_, std::string layerID, std::string sourceID)
       source(std::move(sourceID)) {
 }
 
+const LayoutKey& Layer::Impl::layoutKey() const {
+    // Several tile workers may ask for the key at once. If they race, they all compute equal keys,
+    // and the first one stored is kept: once set, the key is never replaced.
+    std::shared_ptr<const LayoutKey> key = std::atomic_load(&layoutKeyCache.key);
+    if (key) {
+        return *key;
+    }
+
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartArray();
+    writer.Uint(static_cast<uint32_t>(type));
+    writer.String(source);
+    writer.String(sourceLayer);
+    writer.Double(minZoom);
+    writer.Double(maxZoom);
+    writer.Uint(static_cast<uint32_t>(visibility));
+    conversion::stringify(writer, filter);
+    stringifyLayout(writer);
+    writer.EndArray();
+
+    std::string value = s.GetString();
+    const std::size_t hash = std::hash<std::string>()(value);
+    key = std::make_shared<const LayoutKey>(LayoutKey { std::move(value), hash });
+
+    std::shared_ptr<const LayoutKey> stored;
+    if (!std::atomic_compare_exchange_strong(&layoutKeyCache.key, &stored, key)) {
+        return *stored;
+    }
+    return *key;
+}
+
 } // namespace style
 } // namespace mbgl
@@ -3,12 +3,14 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
 #include <string>
 #include <limits>
+#include <memory>
 
 namespace mbgl {
 
@@ -16,6 +18,18 @@ class RenderLayer;
 
 namespace style {
 
+// Everything that affects how a layer is laid out, flattened into a string, along with its hash.
+// Layers with equal keys produce identical buckets and can share them.
+class LayoutKey {
+public:
+    std::string value;
+    std::size_t hash;
+
+    bool operator==(const LayoutKey& other) const {
+        return hash == other.hash && value == other.value;
+    }
+};
+
 /**
  * `Layer::Impl` contains the internal implementation of `Layer`: the details that need to be accessible to other parts
  * of the code, but hidden from the public API. Like `Layer`, it is an abstract base class, with derived classes for
@@ -38,20 +52,44 @@ public:
     // visibility, layout properties, or data-driven paint properties.
     virtual bool hasLayoutDifference(const Layer::Impl&) const = 0;
 
+    // Returns true if the layout difference is confined to data-driven paint properties: the
+    // layer's buckets can then be repainted without laying out their geometry again.
+    virtual bool hasPaintOnlyLayoutDifference(const Layer::Impl&) const {
+        return false;
+    }
+
     // Utility function for automatic layer grouping.
     virtual void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const = 0;
 
+    // Returns the layout key of the layer. It's computed the first time it's needed and kept
+    // for the lifetime of the impl, which doesn't change once it's shared.
+    const LayoutKey& layoutKey() const;
+
     const LayerType type;
     std::string id;
     std::string source;
     std::string sourceLayer;
     Filter filter;
+    CompiledFilter compiledFilter; // Kept in sync with `filter` by setFilter().
     float minZoom = -std::numeric_limits<float>::infinity();
     float maxZoom = std::numeric_limits<float>::infinity();
     VisibilityType visibility = VisibilityType::Visible;
 
 protected:
     Impl(const Impl&) = default;
+
+private:
+    // Copies are made in order to be modified, so they start without a key.
+    class LayoutKeyCache {
+    public:
+        LayoutKeyCache() = default;
+        LayoutKeyCache(const LayoutKeyCache&) {}
+        LayoutKeyCache& operator=(const LayoutKeyCache&) = delete;
+
+        std::shared_ptr<const LayoutKey> key;
+    };
+
+    mutable LayoutKeyCache layoutKeyCache;
 };
 
 } // namespace style
@@ -56,6 +56,7 @@ const std::string& CircleLayer::getSourceLayer() const {
 void CircleLayer::setFilter(const Filter& filter) {
     auto impl_ = mutableImpl();
     impl_->filter = filter;
+    impl_->compiledFilter = CompiledFilter(filter);
     baseImpl = std::move(impl_);
     observer->onLayerChanged(*this);
 }
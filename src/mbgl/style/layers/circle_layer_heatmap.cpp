@@ -0,0 +1,22 @@
+#include <mbgl/style/layers/circle_layer_heatmap.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/layer_observer.hpp>
+
+namespace mbgl {
+namespace style {
+
+optional<CircleHeatmap> getCircleHeatmap(const CircleLayer& layer) {
+    return layer.impl().heatmap;
+}
+
+void setCircleHeatmap(CircleLayer& layer, optional<CircleHeatmap> heatmap) {
+    if (heatmap == layer.impl().heatmap)
+        return;
+    auto impl_ = layer.mutableImpl();
+    impl_->heatmap = std::move(heatmap);
+    layer.baseImpl = std::move(impl_);
+    layer.observer->onLayerChanged(layer);
+}
+
+} // namespace style
+} // namespace mbgl
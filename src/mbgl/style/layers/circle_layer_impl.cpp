@@ -11,5 +11,13 @@ bool CircleLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
+bool CircleLayer::Impl::hasPaintOnlyLayoutDifference(const Layer::Impl& other) const {
+    assert(dynamic_cast<const CircleLayer::Impl*>(&other));
+    const auto& impl = static_cast<const style::CircleLayer::Impl&>(other);
+    return filter     == impl.filter &&
+           visibility == impl.visibility &&
+           paint.hasDataDrivenPropertyDifference(impl.paint);
+}
+
 } // namespace style
 } // namespace mbgl
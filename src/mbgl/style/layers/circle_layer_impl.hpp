@@ -3,6 +3,7 @@
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/circle_layer_properties.hpp>
+#include <mbgl/style/layers/circle_layer_heatmap.hpp>
 
 namespace mbgl {
 namespace style {
@@ -12,9 +13,16 @@ public:
     using Layer::Impl::Impl;
 
     bool hasLayoutDifference(const Layer::Impl&) const override;
+    bool hasPaintOnlyLayoutDifference(const Layer::Impl&) const override;
     void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
 
     CirclePaintProperties::Transitionable paint;
+
+    // Set when the layer is drawn as a heatmap rather than as circles.
+    optional<CircleHeatmap> heatmap;
+
+    // See setCircleStateColor().
+    optional<Color> stateColor;
 };
 
 } // namespace style
@@ -53,6 +53,24 @@ void CustomLayer::setMaxZoom(float maxZoom) {
     baseImpl = std::move(impl_);
 }
 
+void CustomLayer::setPrepareFunction(CustomLayerPrepareFunction prepare) {
+    auto impl_ = mutableImpl();
+    impl_->prepareFn = prepare;
+    baseImpl = std::move(impl_);
+    observer->onLayerChanged(*this);
+}
+
+void CustomLayer::setModifiedGLState(CustomLayerGLState state) {
+    auto impl_ = mutableImpl();
+    impl_->modifiedGLState = state;
+    baseImpl = std::move(impl_);
+    observer->onLayerChanged(*this);
+}
+
+CustomLayerGLState CustomLayer::getModifiedGLState() const {
+    return impl().modifiedGLState;
+}
+
 template <>
 bool Layer::is<CustomLayer>() const {
     return getType() == LayerType::Custom;
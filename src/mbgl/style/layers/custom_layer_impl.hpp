@@ -23,6 +23,8 @@ public:
     CustomLayerInitializeFunction initializeFn = nullptr;
     CustomLayerRenderFunction renderFn = nullptr;
     CustomLayerDeinitializeFunction deinitializeFn = nullptr;
+    CustomLayerPrepareFunction prepareFn = nullptr;
+    CustomLayerGLState modifiedGLState = CustomLayerGLState::All;
     void* context = nullptr;
 };
 
@@ -0,0 +1,36 @@
+#include <mbgl/style/layers/feature_state_color.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layer_observer.hpp>
+
+namespace mbgl {
+namespace style {
+
+optional<Color> getCircleStateColor(const CircleLayer& layer) {
+    return layer.impl().stateColor;
+}
+
+void setCircleStateColor(CircleLayer& layer, optional<Color> color) {
+    if (color == layer.impl().stateColor)
+        return;
+    auto impl_ = layer.mutableImpl();
+    impl_->stateColor = std::move(color);
+    layer.baseImpl = std::move(impl_);
+    layer.observer->onLayerChanged(layer);
+}
+
+optional<Color> getFillStateColor(const FillLayer& layer) {
+    return layer.impl().stateColor;
+}
+
+void setFillStateColor(FillLayer& layer, optional<Color> color) {
+    if (color == layer.impl().stateColor)
+        return;
+    auto impl_ = layer.mutableImpl();
+    impl_->stateColor = std::move(color);
+    layer.baseImpl = std::move(impl_);
+    layer.observer->onLayerChanged(layer);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -11,5 +11,13 @@ bool FillExtrusionLayer::Impl::hasLayoutDifference(const Layer::Impl& other) con
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
+bool FillExtrusionLayer::Impl::hasPaintOnlyLayoutDifference(const Layer::Impl& other) const {
+    assert(dynamic_cast<const FillExtrusionLayer::Impl*>(&other));
+    const auto& impl = static_cast<const style::FillExtrusionLayer::Impl&>(other);
+    return filter     == impl.filter &&
+           visibility == impl.visibility &&
+           paint.hasDataDrivenPropertyDifference(impl.paint);
+}
+
 } // namespace style
 } // namespace mbgl
@@ -56,6 +56,7 @@ const std::string& FillLayer::getSourceLayer() const {
 void FillLayer::setFilter(const Filter& filter) {
     auto impl_ = mutableImpl();
     impl_->filter = filter;
+    impl_->compiledFilter = CompiledFilter(filter);
     baseImpl = std::move(impl_);
     observer->onLayerChanged(*this);
 }
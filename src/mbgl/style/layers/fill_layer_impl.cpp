@@ -11,5 +11,13 @@ bool FillLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
+bool FillLayer::Impl::hasPaintOnlyLayoutDifference(const Layer::Impl& other) const {
+    assert(dynamic_cast<const FillLayer::Impl*>(&other));
+    const auto& impl = static_cast<const style::FillLayer::Impl&>(other);
+    return filter     == impl.filter &&
+           visibility == impl.visibility &&
+           paint.hasDataDrivenPropertyDifference(impl.paint);
+}
+
 } // namespace style
 } // namespace mbgl
@@ -3,6 +3,8 @@
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_properties.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/optional.hpp>
 
 namespace mbgl {
 namespace style {
@@ -12,9 +14,13 @@ public:
     using Layer::Impl::Impl;
 
     bool hasLayoutDifference(const Layer::Impl&) const override;
+    bool hasPaintOnlyLayoutDifference(const Layer::Impl&) const override;
     void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
 
     FillPaintProperties::Transitionable paint;
+
+    // See setFillStateColor().
+    optional<Color> stateColor;
 };
 
 } // namespace style
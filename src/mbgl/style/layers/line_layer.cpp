@@ -57,6 +57,7 @@ const std::string& LineLayer::getSourceLayer() const {
 void LineLayer::setFilter(const Filter& filter) {
     auto impl_ = mutableImpl();
     impl_->filter = filter;
+    impl_->compiledFilter = CompiledFilter(filter);
     baseImpl = std::move(impl_);
     observer->onLayerChanged(*this);
 }
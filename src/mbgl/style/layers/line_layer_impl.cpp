@@ -12,5 +12,14 @@ bool LineLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
+bool LineLayer::Impl::hasPaintOnlyLayoutDifference(const Layer::Impl& other) const {
+    assert(dynamic_cast<const LineLayer::Impl*>(&other));
+    const auto& impl = static_cast<const style::LineLayer::Impl&>(other);
+    return filter     == impl.filter &&
+           visibility == impl.visibility &&
+           layout     == impl.layout &&
+           paint.hasDataDrivenPropertyDifference(impl.paint);
+}
+
 } // namespace style
 } // namespace mbgl
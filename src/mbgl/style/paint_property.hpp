@@ -21,6 +21,10 @@ public:
     using PossiblyEvaluatedType = T;
     using Type = T;
     static constexpr bool IsDataDriven = false;
+
+    static bool isZoomDependent(const UnevaluatedType& value) {
+        return value.getValue().isCameraFunction();
+    }
 };
 
 template <class T, class A, class U>
@@ -33,6 +37,11 @@ public:
     using Type = T;
     static constexpr bool IsDataDriven = true;
 
+    // Source and composite functions are evaluated per feature, and only later at a zoom level.
+    static bool isZoomDependent(const UnevaluatedType& value) {
+        return value.getValue().isCameraFunction();
+    }
+
     using Attribute = A;
     using Uniform = U;
 };
@@ -46,6 +55,12 @@ public:
     using PossiblyEvaluatedType = Faded<T>;
     using Type = T;
     static constexpr bool IsDataDriven = false;
+
+    // The evaluated value carries the scales of the zoom levels it fades between, which only
+    // matter once there's a pattern to fade.
+    static bool isZoomDependent(const UnevaluatedType& value) {
+        return !value.isUndefined();
+    }
 };
 
 } // namespace style
@@ -25,8 +25,11 @@ namespace style {
 Parser::~Parser() = default;
 
 StyleParseResult Parser::parse(const std::string& json) {
+    // Parse a copy of the style in place, so that the document's strings point into it instead
+    // of each being allocated separately. The buffer must outlive the document.
+    std::string buffer = json;
     rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> document;
-    document.Parse<0>(json.c_str());
+    document.ParseInsitu<0>(&buffer[0]);
 
     if (document.HasParseError()) {
         std::stringstream message;
@@ -148,6 +151,7 @@ void Parser::parseSources(const JSValue& value) {
         return;
     }
 
+    sources.reserve(value.MemberCount());
     for (const auto& property : value.GetObject()) {
         std::string id = *conversion::toString(property.name);
 
@@ -172,6 +176,8 @@ void Parser::parseLayers(const JSValue& value) {
         return;
     }
 
+    ids.reserve(value.Size());
+    layersMap.reserve(value.Size());
     for (auto& layerValue : value.GetArray()) {
         if (!layerValue.IsObject()) {
             Log::Warning(Event::ParseStyle, "layer must be an object");
@@ -207,6 +213,7 @@ void Parser::parseLayers(const JSValue& value) {
                    it->second.second);
     }
 
+    layers.reserve(ids.size());
     for (const auto& id : ids) {
         auto it = layersMap.find(id);
 
@@ -8,6 +8,7 @@
 #include <mbgl/renderer/transition_parameters.hpp>
 #include <mbgl/util/indexed_tuple.hpp>
 #include <mbgl/util/ignore.hpp>
+#include <mbgl/util/unitbezier_table.hpp>
 
 namespace mbgl {
 
@@ -59,7 +60,7 @@ public:
             // Interpolate between recursively-calculated prior value and final.
             float t = std::chrono::duration<float>(now - begin) / (end - begin);
             return util::interpolate(prior->get().evaluate(evaluator, now), finalValue,
-                                     util::DEFAULT_TRANSITION_EASE.solve(t, 0.001));
+                                     util::UnitBezierTable::defaultTransitionEase().solve(t));
         }
     }
 
@@ -187,6 +188,14 @@ public:
             return result;
         }
 
+        // Whether evaluating at another zoom level may give different results. Properties that
+        // aren't can keep their evaluated values while only the zoom level changes.
+        bool isZoomDependent() const {
+            bool result = false;
+            util::ignore({ result |= Ps::isZoomDependent(this->template get<Ps>())... });
+            return result;
+        }
+
         template <class P>
         auto evaluate(const PropertyEvaluationParameters& parameters) const {
             using Evaluator = typename P::EvaluatorType;
@@ -200,6 +209,18 @@ public:
             };
         }
 
+        // Like evaluate(), but with `parameters.transitionsOnly`, only evaluates the properties
+        // that have a transition, and keeps the values the others have in `previous`.
+        PossiblyEvaluated evaluate(const PropertyEvaluationParameters& parameters,
+                                   PossiblyEvaluated&& previous) const {
+            if (!parameters.transitionsOnly) {
+                return evaluate(parameters);
+            }
+            util::ignore({ (this->template get<Ps>().hasTransition()
+                ? (previous.template get<Ps>() = evaluate<Ps>(parameters), 0) : 0)... });
+            return std::move(previous);
+        }
+
         template <class Writer>
         void stringify(Writer& writer) const {
             writer.StartObject();
@@ -0,0 +1,33 @@
+#include <mbgl/style/sources/custom_geometry_source.hpp>
+#include <mbgl/style/sources/custom_geometry_source_impl.hpp>
+#include <mbgl/style/source_observer.hpp>
+
+namespace mbgl {
+namespace style {
+
+CustomGeometrySource::CustomGeometrySource(std::string id, CustomGeometrySourceOptions options)
+    : Source(makeMutable<Impl>(std::move(id), std::move(options))) {
+}
+
+CustomGeometrySource::~CustomGeometrySource() = default;
+
+const CustomGeometrySource::Impl& CustomGeometrySource::impl() const {
+    return static_cast<const Impl&>(*baseImpl);
+}
+
+void CustomGeometrySource::invalidateRegion(const LatLngBounds& bounds) {
+    baseImpl = makeMutable<Impl>(impl(), bounds);
+    observer->onSourceChanged(*this);
+}
+
+void CustomGeometrySource::invalidateTile(const CanonicalTileID& tileID) {
+    invalidateRegion(LatLngBounds(tileID));
+}
+
+void CustomGeometrySource::loadDescription(FileSource&) {
+    // Tiles are generated as they're needed.
+    loaded = true;
+}
+
+} // namespace style
+} // namespace mbgl
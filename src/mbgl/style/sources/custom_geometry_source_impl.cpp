@@ -0,0 +1,69 @@
+#include <mbgl/style/sources/custom_geometry_source_impl.hpp>
+
+namespace mbgl {
+namespace style {
+
+CustomGeometrySource::Impl::Impl(std::string id_, CustomGeometrySourceOptions options)
+    : Source::Impl(SourceType::CustomGeometry, std::move(id_)),
+      zoomRange(options.minzoom, options.maxzoom),
+      tileFunction(std::make_shared<const CustomTileFunction>(std::move(options.fetchTile))) {
+    tileOptions.maxzoom = options.maxzoom;
+    tileOptions.buffer = options.buffer;
+    tileOptions.tolerance = options.tolerance;
+    // Each index only holds the features of one tile, which it slices down to when asked for it.
+    tileOptions.indexMaxZoom = 0;
+}
+
+CustomGeometrySource::Impl::Impl(const Impl& other, const LatLngBounds& invalidated)
+    : Source::Impl(other),
+      zoomRange(other.zoomRange),
+      tileFunction(other.tileFunction),
+      tileOptions(other.tileOptions),
+      revision(other.revision + 1) {
+    // Render sources that are further behind generate all of their tiles again.
+    static const std::size_t maxInvalidations = 16;
+    const std::size_t first = other.invalidations.size() < maxInvalidations
+        ? 0 : other.invalidations.size() - maxInvalidations + 1;
+    invalidations.assign(other.invalidations.begin() + first, other.invalidations.end());
+    invalidations.push_back({ revision, invalidated });
+}
+
+Range<uint8_t> CustomGeometrySource::Impl::getZoomRange() const {
+    return zoomRange;
+}
+
+std::shared_ptr<const CustomTileFunction> CustomGeometrySource::Impl::getTileFunction() const {
+    return tileFunction;
+}
+
+const GeoJSONOptions& CustomGeometrySource::Impl::getTileOptions() const {
+    return tileOptions;
+}
+
+uint64_t CustomGeometrySource::Impl::getRevision() const {
+    return revision;
+}
+
+optional<LatLngBounds> CustomGeometrySource::Impl::getInvalidatedBounds(uint64_t since) const {
+    if (since >= revision) {
+        return LatLngBounds::empty();
+    }
+    if (invalidations.empty() || invalidations.front().revision > since + 1) {
+        return {};
+    }
+
+    LatLngBounds bounds = LatLngBounds::empty();
+    for (const auto& invalidation : invalidations) {
+        if (invalidation.revision > since) {
+            bounds.extend(invalidation.bounds);
+        }
+    }
+    return bounds;
+}
+
+optional<std::string> CustomGeometrySource::Impl::getAttribution() const {
+    return {};
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/sources/custom_geometry_source.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/util/range.hpp>
+
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+class CustomGeometrySource::Impl : public Source::Impl {
+public:
+    Impl(std::string id, CustomGeometrySourceOptions);
+    Impl(const Impl&, const LatLngBounds& invalidated);
+
+    Range<uint8_t> getZoomRange() const;
+
+    // Shared by all versions of the source and by the tiles it's generating, which may outlive it.
+    std::shared_ptr<const CustomTileFunction> getTileFunction() const;
+
+    // The options of the GeoJSON-VT index that the features of each tile are clipped and
+    // simplified with.
+    const GeoJSONOptions& getTileOptions() const;
+
+    // Increases with every invalidation.
+    uint64_t getRevision() const;
+
+    // The bounds invalidated since the given revision, if they're still known. Otherwise all
+    // tiles may be invalid.
+    optional<LatLngBounds> getInvalidatedBounds(uint64_t since) const;
+
+    optional<std::string> getAttribution() const final;
+
+private:
+    struct Invalidation {
+        uint64_t revision;
+        LatLngBounds bounds;
+    };
+
+    Range<uint8_t> zoomRange;
+    std::shared_ptr<const CustomTileFunction> tileFunction;
+    GeoJSONOptions tileOptions;
+    uint64_t revision = 0;
+    std::vector<Invalidation> invalidations;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -1,14 +1,70 @@
 #include <mbgl/style/sources/geojson_source.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
 #include <mbgl/style/source_observer.hpp>
-#include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion/geojson.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/util/geobuf.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/stopwatch.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/scheduler.hpp>
 
 namespace mbgl {
 namespace style {
 
+class GeoJSONSource::Worker {
+public:
+    Worker(ActorRef<Worker>,
+           Scheduler& scheduler_,
+           ActorRef<GeoJSONSource> parent_,
+           const std::atomic<uint64_t>& latest_)
+        : scheduler(scheduler_),
+          parent(std::move(parent_)),
+          latest(latest_) {
+    }
+
+    void build(std::shared_ptr<const GeoJSON> geoJSON, GeoJSONOptions options, uint64_t version, bool fromURL) {
+        if (version != latest) {
+            return; // Superseded by data that is queued after it.
+        }
+        parent.invoke(&GeoJSONSource::onBuilt, GeoJSONData::create(*geoJSON, options, &scheduler), version, fromURL);
+    }
+
+    void update(std::shared_ptr<const GeoJSON> geoJSON, std::vector<FeatureUpdate> updates,
+                GeoJSONOptions options, uint64_t version) {
+        if (version != latest) {
+            return;
+        }
+        LatLngBounds changed = LatLngBounds::empty();
+        auto updated = apply(std::move(geoJSON), updates, changed);
+        auto data = GeoJSONData::create(*updated, options, &scheduler);
+        parent.invoke(&GeoJSONSource::onUpdated, std::move(updated), std::move(data), changed, version);
+    }
+
+    // GeoJSON-VT and Supercluster can't update their indexes, so updates rebuild them from the
+    // updated data.
+    static std::shared_ptr<const GeoJSON> apply(std::shared_ptr<const GeoJSON> geoJSON,
+                                                const std::vector<FeatureUpdate>& updates,
+                                                LatLngBounds& changed) {
+        if (!geoJSON) {
+            geoJSON = std::make_shared<const GeoJSON>(FeatureCollection{});
+        }
+        for (const auto& featureUpdate : updates) {
+            geoJSON = std::make_shared<const GeoJSON>(
+                updateFeatures(*geoJSON, featureUpdate.features, featureUpdate.removed, changed));
+        }
+        return geoJSON;
+    }
+
+private:
+    // The scheduler the worker runs on, which also builds the clusters.
+    Scheduler& scheduler;
+    ActorRef<GeoJSONSource> parent;
+    // Owned by the source, which outlives the worker.
+    const std::atomic<uint64_t>& latest;
+};
+
 GeoJSONSource::GeoJSONSource(const std::string& id, const GeoJSONOptions& options)
     : Source(makeMutable<Impl>(std::move(id), options)) {
 }
@@ -23,17 +79,129 @@ void GeoJSONSource::setURL(const std::string& url_) {
     url = std::move(url_);
 
     // Signal that the source description needs a reload
-    if (loaded || req) {
+    if (loaded || req || building) {
         loaded = false;
         req.reset();
+        // Drop the data that is being built.
+        building = false;
+        pendingUpdates.clear();
+        ++version;
         observer->onSourceDescriptionChanged(*this);
     }
 }
 
 void GeoJSONSource::setGeoJSON(const mapbox::geojson::geojson& geoJSON) {
     req.reset();
-    baseImpl = makeMutable<Impl>(impl(), geoJSON);
-    observer->onSourceChanged(*this);
+    build(geoJSON, false);
+}
+
+void GeoJSONSource::setGeobuf(const std::string& data) {
+    GeoJSON geoJSON;
+    try {
+        geoJSON = util::decodeGeobuf(data);
+    } catch (...) {
+        observer->onSourceError(*this, std::current_exception());
+        return;
+    }
+
+    req.reset();
+    build(std::move(geoJSON), false);
+}
+
+void GeoJSONSource::updateGeoJSON(const FeatureCollection& features,
+                                  const std::vector<FeatureIdentifier>& removed) {
+    pendingUpdates.push_back({ features, removed });
+
+    // Updates apply to the data of the index that is being built.
+    if (!building) {
+        update();
+    }
+}
+
+void GeoJSONSource::build(GeoJSON geoJSON, bool fromURL) {
+    const uint64_t current = ++version;
+    snapshot = std::make_shared<const GeoJSON>(std::move(geoJSON));
+    pendingUpdates.clear();
+
+    if (!scheduler) {
+        building = false;
+        setData(GeoJSONData::create(*snapshot, impl().getOptions()), {}, fromURL);
+        return;
+    }
+
+    createWorker();
+    building = true;
+    loaded = false;
+    worker->invoke(&Worker::build, snapshot, impl().getOptions(), current, fromURL);
+}
+
+void GeoJSONSource::update() {
+    const uint64_t current = ++version;
+    std::vector<FeatureUpdate> updates = std::move(pendingUpdates);
+    pendingUpdates.clear();
+
+    if (!scheduler) {
+        building = false;
+        LatLngBounds changed = LatLngBounds::empty();
+        snapshot = Worker::apply(std::move(snapshot), updates, changed);
+        setData(GeoJSONData::create(*snapshot, impl().getOptions()), changed, false);
+        return;
+    }
+
+    createWorker();
+    building = true;
+    worker->invoke(&Worker::update, snapshot, std::move(updates), impl().getOptions(), current);
+}
+
+void GeoJSONSource::createWorker() {
+    if (!worker || workerScheduler != scheduler) {
+        worker.reset();
+        mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+        workerScheduler = scheduler;
+        worker = std::make_unique<Actor<Worker>>(*scheduler, *scheduler, ActorRef<GeoJSONSource>(*this, mailbox), version);
+    }
+}
+
+void GeoJSONSource::onBuilt(std::unique_ptr<GeoJSONData> data, uint64_t built, bool fromURL) {
+    if (built != version) {
+        return; // Later data is being built.
+    }
+
+    building = false;
+    loaded = true;
+    setData(std::move(data), {}, fromURL);
+
+    if (!pendingUpdates.empty()) {
+        update();
+    }
+}
+
+void GeoJSONSource::onUpdated(std::shared_ptr<const GeoJSON> updated,
+                              std::unique_ptr<GeoJSONData> data,
+                              LatLngBounds changed,
+                              uint64_t built) {
+    if (built != version) {
+        return;
+    }
+
+    building = false;
+    snapshot = std::move(updated);
+    setData(std::move(data), changed, false);
+
+    if (!pendingUpdates.empty()) {
+        update();
+    }
+}
+
+void GeoJSONSource::setData(std::unique_ptr<GeoJSONData> data, optional<LatLngBounds> changed, bool fromURL) {
+    baseImpl = makeMutable<Impl>(impl(), std::move(data), changed);
+
+    if (fromURL) {
+        loaded = true;
+        observer->onSourceLoaded(*this);
+    } else {
+        observer->onSourceChanged(*this);
+    }
 }
 
 optional<std::string> GeoJSONSource::getURL() const {
@@ -42,7 +210,7 @@ optional<std::string> GeoJSONSource::getURL() const {
 
 void GeoJSONSource::loadDescription(FileSource& fileSource) {
     if (!url) {
-        loaded = true;
+        loaded = !building;
         return;
     }
 
@@ -61,19 +229,28 @@ void GeoJSONSource::loadDescription(FileSource& fileSource) {
                 *this, std::make_exception_ptr(std::runtime_error("unexpectedly empty GeoJSON")));
         } else {
             conversion::Error error;
-            optional<GeoJSON> geoJSON = conversion::convertJSON<GeoJSON>(*res.data, error);
+            optional<GeoJSON> geoJSON;
+            {
+                util::stopwatch watch("GeoJSON source " + impl().id + " parsing", Event::ParseStyle);
+                if (util::isGeobuf(*res.data)) {
+                    try {
+                        geoJSON = util::decodeGeobuf(*res.data);
+                    } catch (const std::exception& ex) {
+                        error = { ex.what() };
+                    }
+                } else {
+                    geoJSON = conversion::convert<GeoJSON>(*res.data, error);
+                }
+            }
             if (!geoJSON) {
                 Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s",
                            error.message.c_str());
                 // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for
                 // tiles to load.
-                baseImpl = makeMutable<Impl>(impl(), GeoJSON{ FeatureCollection{} });
+                build(GeoJSON{ FeatureCollection{} }, true);
             } else {
-                baseImpl = makeMutable<Impl>(impl(), *geoJSON);
+                build(std::move(*geoJSON), true);
             }
-
-            loaded = true;
-            observer->onSourceLoaded(*this);
         }
     });
 }
@@ -2,11 +2,52 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/parallel.hpp>
 
 #include <mapbox/geojsonvt.hpp>
-#include <supercluster.hpp>
+#include <mapbox/geometry/envelope.hpp>
+#include <kdbush.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+namespace {
+
+// A point, or a cluster of points, in projected coordinates from 0 to 1.
+struct Cluster {
+    double x;
+    double y;
+    uint32_t numPoints;
+    // The index of the feature for single points, and of the first clustered point otherwise.
+    uint32_t id;
+};
+
+} // namespace
+} // namespace style
+} // namespace mbgl
+
+namespace kdbush {
+
+template <>
+struct nth<0, mbgl::style::Cluster> {
+    static double get(const mbgl::style::Cluster& cluster) {
+        return cluster.x;
+    }
+};
+
+template <>
+struct nth<1, mbgl::style::Cluster> {
+    static double get(const mbgl::style::Cluster& cluster) {
+        return cluster.y;
+    }
+};
+
+} // namespace kdbush
 
 namespace mbgl {
 namespace style {
@@ -21,22 +62,211 @@ public:
         return impl.getTile(tileID.z, tileID.x, tileID.y).features;
     }
 
+    std::size_t getIndexedTileCount() const final {
+        return impl.total;
+    }
+
 private:
     mapbox::geojsonvt::GeoJSONVT impl;
 };
 
+// Clusters the points like Supercluster does, with a kdbush index per zoom level that is built
+// from the clusters of the level above it. Each level is built in blocks of points: the neighbour
+// searches of the points of a block run in parallel on the scheduler, and the points are then
+// merged with their unmerged neighbours in order, which gives the same clusters as searching
+// and merging one point after another.
 class SuperclusterData : public GeoJSONData {
 public:
-    SuperclusterData(const mapbox::geometry::feature_collection<double>& features,
-                     const mapbox::supercluster::Options& options)
-        : impl(features, options) {}
+    SuperclusterData(const mapbox::geometry::feature_collection<double>& features_,
+                     uint8_t maxZoom_,
+                     uint16_t radius_,
+                     uint16_t extent_,
+                     Scheduler* scheduler_)
+        : features(features_),
+          maxZoom(maxZoom_),
+          radius(radius_),
+          extent(extent_),
+          scheduler(scheduler_),
+          levels(maxZoom + 2) {
+        buildPoints(levels[maxZoom + 1]);
+        for (int z = maxZoom; z >= 0; z--) {
+            buildClusters(levels[z], levels[z + 1], double(radius) / (extent * std::pow(2, z)));
+        }
+    }
 
     mapbox::geometry::feature_collection<int16_t> getTile(const CanonicalTileID& tileID) final {
-        return impl.getTile(tileID.z, tileID.x, tileID.y);
+        mapbox::geometry::feature_collection<int16_t> result;
+        Level& level = levels[std::min<uint8_t>(tileID.z, maxZoom + 1)];
+        if (level.clusters.empty()) {
+            return result;
+        }
+
+        const double z2 = std::pow(2, tileID.z);
+        const double r = double(radius) / extent;
+        double x = tileID.x;
+        const double y = tileID.y;
+
+        auto visit = [&] (uint32_t index) {
+            const Cluster& cluster = level.clusters[index];
+            mapbox::geometry::feature<int16_t> feature {
+                mapbox::geometry::point<int16_t>(
+                    static_cast<int16_t>(std::round(extent * (cluster.x * z2 - x))),
+                    static_cast<int16_t>(std::round(extent * (cluster.y * z2 - y))))
+            };
+            if (cluster.numPoints == 1) {
+                feature.properties = features[cluster.id].properties;
+            } else {
+                feature.properties["cluster"] = true;
+                feature.properties["point_count"] = static_cast<uint64_t>(cluster.numPoints);
+            }
+            result.push_back(std::move(feature));
+        };
+
+        const double top = (y - r) / z2;
+        const double bottom = (y + 1 + r) / z2;
+        level.tree.range((x - r) / z2, top, (x + 1 + r) / z2, bottom, visit);
+
+        // Points across the antimeridian.
+        if (tileID.x == 0) {
+            x = z2;
+            level.tree.range(1 - r / z2, top, 1, bottom, visit);
+        }
+        if (tileID.x == z2 - 1) {
+            x = -1;
+            level.tree.range(0, top, r / z2, bottom, visit);
+        }
+
+        return result;
+    }
+
+    // Clusters are indexed by zoom level rather than by tile.
+    std::size_t getIndexedTileCount() const final {
+        return 0;
     }
 
 private:
-    mapbox::supercluster::Supercluster impl;
+    struct Level {
+        std::vector<Cluster> clusters;
+        kdbush::KDBush<Cluster, uint32_t> tree;
+    };
+
+    // Points per parallel call, and per block of points whose neighbours are searched before
+    // they are merged.
+    static constexpr std::size_t chunkSize = 1024;
+    static constexpr std::size_t blockSize = 64 * chunkSize;
+
+    void forEachChunk(std::size_t begin, std::size_t end, const std::function<void (std::size_t, std::size_t)>& fn) {
+        const std::size_t count = (end - begin + chunkSize - 1) / chunkSize;
+        auto call = [&] (std::size_t i) {
+            const std::size_t chunkBegin = begin + i * chunkSize;
+            fn(chunkBegin, std::min(chunkBegin + chunkSize, end));
+        };
+        if (scheduler) {
+            util::parallelFor(*scheduler, count, call);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                call(i);
+            }
+        }
+    }
+
+    void buildPoints(Level& level) {
+        // Clusters only hold points, as documented with GeoJSONOptions::cluster; Supercluster
+        // itself can't index other geometries at all.
+        std::vector<uint32_t> ids;
+        ids.reserve(features.size());
+        for (uint32_t i = 0; i < features.size(); ++i) {
+            if (features[i].geometry.is<mapbox::geometry::point<double>>()) {
+                ids.push_back(i);
+            }
+        }
+
+        level.clusters.resize(ids.size());
+        forEachChunk(0, ids.size(), [&] (std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const auto& point = features[ids[i]].geometry.get<mapbox::geometry::point<double>>();
+                const double sin = std::sin(point.y * util::DEG2RAD);
+                const double y = 0.5 - 0.25 * std::log((1 + sin) / (1 - sin)) / M_PI;
+                level.clusters[i] = { point.x / 360 + 0.5, util::clamp(y, 0.0, 1.0), 1, ids[i] };
+            }
+        });
+
+        if (!level.clusters.empty()) {
+            level.tree.fill(level.clusters);
+        }
+    }
+
+    void buildClusters(Level& level, Level& previous, double r) {
+        const std::vector<Cluster>& points = previous.clusters;
+        std::vector<bool> merged(points.size(), false);
+
+        // The neighbours of the points of each chunk of a block, one point after another.
+        struct Neighbours {
+            std::vector<uint32_t> ids;
+            std::vector<std::size_t> ends;
+        };
+        std::vector<Neighbours> neighbours;
+
+        for (std::size_t block = 0; block < points.size(); block += blockSize) {
+            const std::size_t blockEnd = std::min(block + blockSize, points.size());
+            neighbours.resize((blockEnd - block + chunkSize - 1) / chunkSize);
+
+            // Points that the previous blocks merged don't need their neighbours.
+            forEachChunk(block, blockEnd, [&] (std::size_t begin, std::size_t end) {
+                Neighbours& chunk = neighbours[(begin - block) / chunkSize];
+                chunk.ids.clear();
+                chunk.ends.clear();
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (!merged[i]) {
+                        previous.tree.within(points[i].x, points[i].y, r, [&] (uint32_t id) {
+                            chunk.ids.push_back(id);
+                        });
+                    }
+                    chunk.ends.push_back(chunk.ids.size());
+                }
+            });
+
+            for (std::size_t i = block; i < blockEnd; ++i) {
+                if (merged[i]) {
+                    continue;
+                }
+                merged[i] = true;
+
+                const Cluster& point = points[i];
+                uint32_t numPoints = point.numPoints;
+                double x = point.x * numPoints;
+                double y = point.y * numPoints;
+
+                const Neighbours& chunk = neighbours[(i - block) / chunkSize];
+                const std::size_t offset = (i - block) % chunkSize;
+                for (std::size_t j = offset ? chunk.ends[offset - 1] : 0; j < chunk.ends[offset]; ++j) {
+                    const uint32_t id = chunk.ids[j];
+                    if (merged[id]) {
+                        continue;
+                    }
+                    merged[id] = true;
+
+                    // The center of the cluster is the average of its points.
+                    x += points[id].x * points[id].numPoints;
+                    y += points[id].y * points[id].numPoints;
+                    numPoints += points[id].numPoints;
+                }
+
+                level.clusters.push_back({ x / numPoints, y / numPoints, numPoints, point.id });
+            }
+        }
+
+        if (!level.clusters.empty()) {
+            level.tree.fill(level.clusters);
+        }
+    }
+
+    const mapbox::geometry::feature_collection<double> features;
+    const uint8_t maxZoom;
+    const uint16_t radius;
+    const uint16_t extent;
+    Scheduler* const scheduler;
+    std::vector<Level> levels;
 };
 
 GeoJSONSource::Impl::Impl(std::string id_, GeoJSONOptions options_)
@@ -44,27 +274,122 @@ GeoJSONSource::Impl::Impl(std::string id_, GeoJSONOptions options_)
       options(std::move(options_)) {
 }
 
-GeoJSONSource::Impl::Impl(const Impl& other, const GeoJSON& geoJSON)
-    : Source::Impl(other),
-      options(other.options) {
+std::unique_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON, const GeoJSONOptions& options, Scheduler* scheduler) {
     double scale = util::EXTENT / util::tileSize;
 
     if (options.cluster
         && geoJSON.is<mapbox::geometry::feature_collection<double>>()
         && !geoJSON.get<mapbox::geometry::feature_collection<double>>().empty()) {
-        mapbox::supercluster::Options clusterOptions;
-        clusterOptions.maxZoom = options.clusterMaxZoom;
-        clusterOptions.extent = util::EXTENT;
-        clusterOptions.radius = ::round(scale * options.clusterRadius);
-        data = std::make_unique<SuperclusterData>(
-            geoJSON.get<mapbox::geometry::feature_collection<double>>(), clusterOptions);
+        return std::make_unique<SuperclusterData>(
+            geoJSON.get<mapbox::geometry::feature_collection<double>>(), options.clusterMaxZoom,
+            ::round(scale * options.clusterRadius), util::EXTENT, scheduler);
     } else {
         mapbox::geojsonvt::Options vtOptions;
         vtOptions.maxZoom = options.maxzoom;
         vtOptions.extent = util::EXTENT;
         vtOptions.buffer = ::round(scale * options.buffer);
         vtOptions.tolerance = scale * options.tolerance;
-        data = std::make_unique<GeoJSONVTData>(geoJSON, vtOptions);
+        vtOptions.indexMaxZoom = options.indexMaxZoom;
+        vtOptions.indexMaxPoints = options.indexMaxPoints;
+        return std::make_unique<GeoJSONVTData>(geoJSON, vtOptions);
+    }
+}
+
+namespace {
+
+struct FeatureIdentifierHash {
+    std::size_t operator()(const FeatureIdentifier& id) const {
+        return mapbox::util::apply_visitor([] (const auto& value) {
+            return std::hash<std::decay_t<decltype(value)>>()(value);
+        }, id);
+    }
+};
+
+void extend(LatLngBounds& bounds, const mapbox::geometry::geometry<double>& geometry) {
+    const mapbox::geometry::box<double> box = mapbox::geometry::envelope(geometry);
+    // Empty geometries have no envelope, and invalid coordinates can't be part of bounds.
+    if (!(box.min.x <= box.max.x && box.min.y <= box.max.y) ||
+        !std::isfinite(box.min.x) || !std::isfinite(box.max.x) ||
+        !std::isfinite(box.min.y) || !std::isfinite(box.max.y)) {
+        return;
+    }
+    bounds.extend(LatLng(util::clamp(box.min.y, -90.0, 90.0), box.min.x));
+    bounds.extend(LatLng(util::clamp(box.max.y, -90.0, 90.0), box.max.x));
+}
+
+} // namespace
+
+FeatureCollection updateFeatures(const GeoJSON& geoJSON,
+                                 const FeatureCollection& features,
+                                 const std::vector<FeatureIdentifier>& removed,
+                                 LatLngBounds& changed) {
+    FeatureCollection result = geoJSON.match(
+        [] (const FeatureCollection& collection) { return collection; },
+        [] (const Feature& feature) { return FeatureCollection { feature }; },
+        [] (const mapbox::geometry::geometry<double>& geometry) {
+            return FeatureCollection { Feature { geometry } };
+        });
+
+    std::unordered_map<FeatureIdentifier, std::size_t, FeatureIdentifierHash> indices;
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        if (result[i].id) {
+            indices.emplace(*result[i].id, i);
+        }
+    }
+
+    std::vector<bool> isRemoved(result.size(), false);
+    for (const auto& id : removed) {
+        auto it = indices.find(id);
+        if (it != indices.end()) {
+            extend(changed, result[it->second].geometry);
+            isRemoved[it->second] = true;
+            indices.erase(it);
+        }
+    }
+
+    for (const auto& feature : features) {
+        extend(changed, feature.geometry);
+        auto it = feature.id ? indices.find(*feature.id) : indices.end();
+        if (it != indices.end()) {
+            extend(changed, result[it->second].geometry);
+            result[it->second] = feature;
+        } else {
+            if (feature.id) {
+                indices.emplace(*feature.id, result.size());
+            }
+            result.push_back(feature);
+            isRemoved.push_back(false);
+        }
+    }
+
+    // Keeps the order of the remaining features.
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        if (!isRemoved[i]) {
+            if (kept != i) {
+                result[kept] = std::move(result[i]);
+            }
+            ++kept;
+        }
+    }
+    result.erase(result.begin() + kept, result.end());
+
+    return result;
+}
+
+GeoJSONSource::Impl::Impl(const Impl& other,
+                          std::unique_ptr<GeoJSONData> data_,
+                          optional<LatLngBounds> changed)
+    : Source::Impl(other),
+      options(other.options),
+      data(std::move(data_)),
+      dataID(other.dataID + 1) {
+    if (changed) {
+        // Render sources that are further behind update all of their tiles.
+        static const std::size_t maxChanges = 16;
+        const std::size_t first = other.changes.size() < maxChanges ? 0 : other.changes.size() - maxChanges + 1;
+        changes.assign(other.changes.begin() + first, other.changes.end());
+        changes.push_back({ dataID, *changed });
     }
 }
 
@@ -78,6 +403,29 @@ GeoJSONData* GeoJSONSource::Impl::getData() const {
     return data.get();
 }
 
+const GeoJSONOptions& GeoJSONSource::Impl::getOptions() const {
+    return options;
+}
+
+uint64_t GeoJSONSource::Impl::getDataID() const {
+    return dataID;
+}
+
+optional<LatLngBounds> GeoJSONSource::Impl::getChangedBounds(uint64_t since) const {
+    // The recorded changes need to cover everything since then.
+    if (since >= dataID || changes.empty() || changes.front().dataID > since + 1) {
+        return {};
+    }
+
+    LatLngBounds bounds = LatLngBounds::empty();
+    for (const auto& change : changes) {
+        if (change.dataID > since && !change.bounds.isEmpty()) {
+            bounds.extend(change.bounds);
+        }
+    }
+    return bounds;
+}
+
 optional<std::string> GeoJSONSource::Impl::getAttribution() const {
     return {};
 }
@@ -3,11 +3,16 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
 #include <mbgl/util/range.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <vector>
 
 namespace mbgl {
 
 class AsyncRequest;
 class CanonicalTileID;
+class Scheduler;
 
 namespace style {
 
@@ -15,22 +20,54 @@ class GeoJSONData {
 public:
     virtual ~GeoJSONData() = default;
     virtual mapbox::geometry::feature_collection<int16_t> getTile(const CanonicalTileID&) = 0;
+
+    // The number of tiles the index holds, which take most of its memory.
+    virtual std::size_t getIndexedTileCount() const = 0;
+
+    // Builds the GeoJSON-VT or Supercluster index of the data, which can take long for large
+    // data; GeoJSONSource does it on the style's worker scheduler. With a scheduler, clusters
+    // are built in parallel on it.
+    static std::unique_ptr<GeoJSONData> create(const GeoJSON&, const GeoJSONOptions&, Scheduler* = nullptr);
+};
+
+// Applies GeoJSONSource::updateGeoJSON() to the data, and extends `changed` by the bounds of the
+// features that are added, replaced or removed.
+FeatureCollection updateFeatures(const GeoJSON&,
+                                 const FeatureCollection& features,
+                                 const std::vector<FeatureIdentifier>& removed,
+                                 LatLngBounds& changed);
+
+// The bounds of the features that changed with the data of the given ID.
+struct GeoJSONDataChange {
+    uint64_t dataID;
+    LatLngBounds bounds;
 };
 
 class GeoJSONSource::Impl : public Source::Impl {
 public:
     Impl(std::string id, GeoJSONOptions);
-    Impl(const GeoJSONSource::Impl&, const GeoJSON&);
+    // Without bounds, all of the data may have changed.
+    Impl(const GeoJSONSource::Impl&, std::unique_ptr<GeoJSONData>, optional<LatLngBounds> changed);
     ~Impl() final;
 
     Range<uint8_t> getZoomRange() const;
     GeoJSONData* getData() const;
+    const GeoJSONOptions& getOptions() const;
+
+    // Increases with every change of the data.
+    uint64_t getDataID() const;
+
+    // The bounds of the features that changed since the data of the given ID, if only features
+    // within them changed. Otherwise all of the data may have changed.
+    optional<LatLngBounds> getChangedBounds(uint64_t since) const;
 
     optional<std::string> getAttribution() const final;
 
 private:
     GeoJSONOptions options;
     std::unique_ptr<GeoJSONData> data;
+    uint64_t dataID = 0;
+    std::vector<GeoJSONDataChange> changes;
 };
 
 } // namespace style
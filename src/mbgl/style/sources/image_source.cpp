@@ -47,6 +47,32 @@ void ImageSource::setImage(PremultipliedImage&& image_) {
     observer->onSourceChanged(*this);
 }
 
+void ImageSource::setFrames(std::vector<PremultipliedImage>&& frames) {
+    url = {};
+    if (req) {
+        req.reset();
+    }
+    loaded = true;
+    baseImpl = makeMutable<Impl>(impl(), std::move(frames));
+    observer->onSourceChanged(*this);
+}
+
+void ImageSource::setFrame(std::size_t frame) {
+    if (frame >= getFrameCount() || frame == getFrame()) {
+        return;
+    }
+    baseImpl = makeMutable<Impl>(impl(), frame);
+    observer->onSourceChanged(*this);
+}
+
+std::size_t ImageSource::getFrame() const {
+    return impl().getFrame();
+}
+
+std::size_t ImageSource::getFrameCount() const {
+    return impl().getFrames().size();
+}
+
 optional<std::string> ImageSource::getURL() const {
     return url;
 }
@@ -1,6 +1,8 @@
 #include <mbgl/style/sources/image_source_impl.hpp>
 #include <mbgl/util/geo.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 namespace style {
 
@@ -12,18 +14,45 @@ ImageSource::Impl::Impl(std::string id_, std::array<LatLng, 4> coords_)
 ImageSource::Impl::Impl(const Impl& other, std::array<LatLng, 4> coords_)
     : Source::Impl(other),
     coords(std::move(coords_)),
-    image(other.image) {
+    frames(other.frames),
+    frame(other.frame) {
 }
 
 ImageSource::Impl::Impl(const Impl& rhs, PremultipliedImage&& image_)
     : Source::Impl(rhs),
     coords(rhs.coords),
-    image(std::make_shared<PremultipliedImage>(std::move(image_))) {
+    frames({ std::make_shared<PremultipliedImage>(std::move(image_)) }) {
+}
+
+ImageSource::Impl::Impl(const Impl& rhs, std::vector<PremultipliedImage>&& frames_)
+    : Source::Impl(rhs),
+    coords(rhs.coords) {
+    frames.reserve(frames_.size());
+    for (auto& image : frames_) {
+        frames.push_back(std::make_shared<PremultipliedImage>(std::move(image)));
+    }
 }
+
+ImageSource::Impl::Impl(const Impl& rhs, std::size_t frame_)
+    : Source::Impl(rhs),
+    coords(rhs.coords),
+    frames(rhs.frames),
+    frame(frame_) {
+    assert(frame < frames.size());
+}
+
 ImageSource::Impl::~Impl() = default;
 
 std::shared_ptr<PremultipliedImage> ImageSource::Impl::getImage() const {
-    return image;
+    return frames.empty() ? nullptr : frames[frame];
+}
+
+const std::vector<std::shared_ptr<PremultipliedImage>>& ImageSource::Impl::getFrames() const {
+    return frames;
+}
+
+std::size_t ImageSource::Impl::getFrame() const {
+    return frame;
 }
 
 std::array<LatLng, 4> ImageSource::Impl::getCoordinates() const {
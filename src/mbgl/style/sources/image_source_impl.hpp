@@ -5,6 +5,8 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/geo.hpp>
 
+#include <vector>
+
 namespace mbgl {
 
 namespace style {
@@ -14,16 +16,22 @@ public:
     Impl(std::string id, std::array<LatLng, 4> coords);
     Impl(const Impl& rhs, std::array<LatLng, 4> coords);
     Impl(const Impl& rhs, PremultipliedImage&& image);
+    Impl(const Impl& rhs, std::vector<PremultipliedImage>&& frames);
+    Impl(const Impl& rhs, std::size_t frame);
 
     ~Impl() final;
 
+    // The frame that is shown.
     std::shared_ptr<PremultipliedImage> getImage() const;
+    const std::vector<std::shared_ptr<PremultipliedImage>>& getFrames() const;
+    std::size_t getFrame() const;
     std::array<LatLng, 4> getCoordinates() const;
 
     optional<std::string> getAttribution() const final;
 private:
     std::array<LatLng, 4> coords;
-    std::shared_ptr<PremultipliedImage> image;
+    std::vector<std::shared_ptr<PremultipliedImage>> frames;
+    std::size_t frame = 0;
 };
 
 } // namespace style
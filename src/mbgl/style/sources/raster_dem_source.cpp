@@ -0,0 +1,11 @@
+#include <mbgl/style/sources/raster_dem_source.hpp>
+
+namespace mbgl {
+namespace style {
+
+RasterDEMSource::RasterDEMSource(std::string id, variant<std::string, Tileset> urlOrTileset_, uint16_t tileSize)
+    : RasterSource(SourceType::RasterDEM, std::move(id), std::move(urlOrTileset_), tileSize) {
+}
+
+} // namespace style
+} // namespace mbgl
@@ -10,7 +10,11 @@ namespace mbgl {
 namespace style {
 
 RasterSource::RasterSource(std::string id, variant<std::string, Tileset> urlOrTileset_, uint16_t tileSize)
-    : Source(makeMutable<Impl>(std::move(id), tileSize)),
+    : RasterSource(SourceType::Raster, std::move(id), std::move(urlOrTileset_), tileSize) {
+}
+
+RasterSource::RasterSource(SourceType type, std::string id, variant<std::string, Tileset> urlOrTileset_, uint16_t tileSize)
+    : Source(makeMutable<Impl>(type, std::move(id), tileSize)),
       urlOrTileset(std::move(urlOrTileset_)) {
 }
 
@@ -10,13 +10,16 @@ class VectorSource::Impl : public Source::Impl {
 public:
     Impl(std::string id);
     Impl(const Impl&, Tileset);
+    Impl(const Impl&, float simplificationTolerance);
 
     optional<Tileset> getTileset() const;
+    float getSimplificationTolerance() const;
 
     optional<std::string> getAttribution() const final;
 
 private:
     optional<Tileset> tileset;
+    float simplificationTolerance = 0;
 };
 
 } // namespace style
@@ -142,5 +142,13 @@ std::unique_ptr<Layer> Style::removeLayer(const std::string& id) {
     return impl->removeLayer(id);
 }
 
+void Style::beginBatch() {
+    impl->beginBatch();
+}
+
+void Style::commitBatch() {
+    impl->commitBatch();
+}
+
 } // namespace style
 } // namespace mbgl
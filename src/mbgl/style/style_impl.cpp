@@ -20,6 +20,8 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 namespace style {
 
@@ -143,6 +145,7 @@ void Style::Impl::addSource(std::unique_ptr<Source> source) {
     }
 
     source->setObserver(this);
+    source->setScheduler(&scheduler);
     source->loadDescription(fileSource);
 
     sources.add(std::move(source));
@@ -176,6 +179,7 @@ std::unique_ptr<Source> Style::Impl::removeSource(const std::string& id) {
 
     if (source) {
         source->setObserver(nullptr);
+        source->setScheduler(nullptr);
     }
 
     return source;
@@ -202,7 +206,7 @@ Layer* Style::Impl::addLayer(std::unique_ptr<Layer> layer, optional<std::string>
     }
 
     layer->setObserver(this);
-    observer->onUpdate(Update::Repaint);
+    update(Update::Repaint);
 
     return layers.add(std::move(layer), before);
 }
@@ -212,7 +216,7 @@ std::unique_ptr<Layer> Style::Impl::removeLayer(const std::string& id) {
 
     if (layer) {
         layer->setObserver(nullptr);
-        observer->onUpdate(Update::Repaint);
+        update(Update::Repaint);
     }
 
     return layer;
@@ -297,15 +301,23 @@ void Style::Impl::setObserver(style::Observer* observer_) {
 }
 
 void Style::Impl::onSourceLoaded(Source& source) {
-    sources.update(source);
+    if (batchDepth) {
+        batchedSourceChanges = true;
+    } else {
+        sources.update(source);
+    }
     observer->onSourceLoaded(source);
-    observer->onUpdate(Update::Repaint);
+    update(Update::Repaint);
 }
 
 void Style::Impl::onSourceChanged(Source& source) {
-    sources.update(source);
+    if (batchDepth) {
+        batchedSourceChanges = true;
+    } else {
+        sources.update(source);
+    }
     observer->onSourceChanged(source);
-    observer->onUpdate(Update::Repaint);
+    update(Update::Repaint);
 }
 
 void Style::Impl::onSourceError(Source& source, std::exception_ptr error) {
@@ -317,7 +329,11 @@ void Style::Impl::onSourceError(Source& source, std::exception_ptr error) {
 }
 
 void Style::Impl::onSourceDescriptionChanged(Source& source) {
-    sources.update(source);
+    if (batchDepth) {
+        batchedSourceChanges = true;
+    } else {
+        sources.update(source);
+    }
     observer->onSourceDescriptionChanged(source);
     if (!source.loaded) {
         source.loadDescription(fileSource);
@@ -329,7 +345,7 @@ void Style::Impl::onSpriteLoaded(std::vector<std::unique_ptr<Image>>&& images_)
         addImage(std::move(image));
     }
     spriteLoaded = true;
-    observer->onUpdate(Update::Repaint); // For *-pattern properties.
+    update(Update::Repaint); // For *-pattern properties.
 }
 
 void Style::Impl::onSpriteError(std::exception_ptr error) {
@@ -339,12 +355,52 @@ void Style::Impl::onSpriteError(std::exception_ptr error) {
 }
 
 void Style::Impl::onLayerChanged(Layer& layer) {
-    layers.update(layer);
-    observer->onUpdate(Update::Repaint);
+    if (batchDepth) {
+        batchedLayerChanges = true;
+    } else {
+        layers.update(layer);
+    }
+    update(Update::Repaint);
 }
 
 void Style::Impl::onLightChanged(const Light&) {
-    observer->onUpdate(Update::Repaint);
+    update(Update::Repaint);
+}
+
+void Style::Impl::update(Update flags) {
+    if (batchDepth) {
+        batchedUpdate |= flags;
+    } else {
+        observer->onUpdate(flags);
+    }
+}
+
+void Style::Impl::beginBatch() {
+    batchDepth++;
+}
+
+void Style::Impl::commitBatch() {
+    assert(batchDepth);
+    if (!batchDepth || --batchDepth) {
+        return;
+    }
+
+    // Elements changed while batching may have been removed since, so rather than keeping
+    // track of them, take the impls of all of their collection.
+    if (batchedSourceChanges) {
+        sources.updateAll();
+        batchedSourceChanges = false;
+    }
+    if (batchedLayerChanges) {
+        layers.updateAll();
+        batchedLayerChanges = false;
+    }
+
+    const Update flags = batchedUpdate;
+    batchedUpdate = Update::Nothing;
+    if (flags != Update::Nothing) {
+        observer->onUpdate(flags);
+    }
 }
 
 void Style::Impl::dumpDebugLogs() const {
@@ -90,6 +90,11 @@ public:
     Immutable<std::vector<Immutable<Source::Impl>>> getSourceImpls() const;
     Immutable<std::vector<Immutable<Layer::Impl>>> getLayerImpls() const;
 
+    // Between the two, changes to sources and layers are collected, and the observer hears
+    // about them once, when the outermost batch is committed.
+    void beginBatch();
+    void commitBatch();
+
     void dumpDebugLogs() const;
 
     bool mutated = false;
@@ -98,6 +103,7 @@ public:
 
 private:
     void parse(const std::string&);
+    void update(Update);
 
     Scheduler& scheduler;
     FileSource& fileSource;
@@ -142,6 +148,11 @@ private:
     Observer* observer = &nullObserver;
 
     std::exception_ptr lastError;
+
+    std::size_t batchDepth = 0;
+    Update batchedUpdate = Update::Nothing;
+    bool batchedSourceChanges = false;
+    bool batchedLayerChanges = false;
 };
 
 } // namespace style
@@ -12,6 +12,8 @@ MBGL_DEFINE_ENUM(SourceType, {
     { SourceType::Video, "video" },
     { SourceType::Annotations, "annotations" },
     { SourceType::Image, "image" },
+    { SourceType::RasterDEM, "raster-dem" },
+    { SourceType::CustomGeometry, "custom-geometry" },
 });
 
 MBGL_DEFINE_ENUM(VisibilityType, {
@@ -0,0 +1,67 @@
+#include <mbgl/text/collision_grid.hpp>
+
+#include <cassert>
+#include <cmath>
+
+namespace mbgl {
+
+constexpr uint32_t CollisionGrid::none;
+
+CollisionGrid::CollisionGrid(float extent, uint32_t n, uint32_t padding)
+    : d(n + 2 * padding),
+      scale(n / extent),
+      offset(padding),
+      heads(d * d, none) {
+}
+
+std::size_t CollisionGrid::addFeature(const IndexedSubfeature& feature) {
+    features.push_back(feature);
+    return features.size() - 1;
+}
+
+void CollisionGrid::insert(const Bounds& bounds, const CollisionBox& box, std::size_t feature) {
+    assert(bounds.x1 <= bounds.x2 && bounds.y1 <= bounds.y2);
+    assert(feature < features.size());
+    assert(boxes.size() < none);
+
+    const auto i = uint32_t(boxes.size());
+    x1s.push_back(bounds.x1);
+    y1s.push_back(bounds.y1);
+    x2s.push_back(bounds.x2);
+    y2s.push_back(bounds.y2);
+    boxes.push_back(box);
+    featureIndices.push_back(uint32_t(feature));
+
+    const uint32_t cx1 = toCell(bounds.x1);
+    const uint32_t cy1 = toCell(bounds.y1);
+    const uint32_t cx2 = toCell(bounds.x2);
+    const uint32_t cy2 = toCell(bounds.y2);
+
+    for (uint32_t y = cy1; y <= cy2; ++y) {
+        for (uint32_t x = cx1; x <= cx2; ++x) {
+            uint32_t& head = heads[d * y + x];
+            entries.push_back({ i, head });
+            head = uint32_t(entries.size() - 1);
+        }
+    }
+}
+
+std::size_t CollisionGrid::byteSize() const {
+    return (x1s.capacity() + y1s.capacity() + x2s.capacity() + y2s.capacity()) * sizeof(float) +
+        boxes.capacity() * sizeof(CollisionBox) +
+        featureIndices.capacity() * sizeof(uint32_t) +
+        features.capacity() * sizeof(IndexedSubfeature) +
+        heads.capacity() * sizeof(uint32_t) +
+        entries.capacity() * sizeof(Entry);
+}
+
+uint32_t CollisionGrid::toCell(float coordinate) const {
+    const float cell = std::floor(coordinate * scale) + offset;
+    // Also maps NaN to the first cell.
+    if (!(cell > 0)) {
+        return 0;
+    }
+    return cell >= d - 1 ? d - 1 : uint32_t(cell);
+}
+
+} // namespace mbgl
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <mbgl/text/collision_feature.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   A uniform grid of collision boxes, used by CollisionTile for placement.
+
+   Box bounds are stored in separate arrays, so that a query only reads the coordinates of the
+   candidates it tests. The boxes of a cell form a list that is threaded through a single entry
+   array, so inserting a box doesn't allocate unless one of the arrays has to grow. Boxes are
+   kept in insertion order, and the features they belong to are stored once per feature.
+
+   Bounds outside of the area covered by the grid are clamped to the cells along its border.
+*/
+class CollisionGrid {
+public:
+    struct Bounds {
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+    };
+
+    // Covers `extent` units in each direction with `n` cells, plus `padding` cells on every side.
+    CollisionGrid(float extent, uint32_t n, uint32_t padding);
+
+    // Returns the index to insert the feature's boxes with.
+    std::size_t addFeature(const IndexedSubfeature&);
+    void insert(const Bounds&, const CollisionBox&, std::size_t feature);
+
+    // Calls `fn` with the index of every box intersecting the bounds, once per box, for as long
+    // as it returns true.
+    template <class Fn>
+    void query(const Bounds&, Fn&& fn) const;
+
+    bool empty() const { return boxes.empty(); }
+    std::size_t size() const { return boxes.size(); }
+
+    // Memory held by the grid, in bytes.
+    std::size_t byteSize() const;
+
+    const CollisionBox& getBox(std::size_t i) const { return boxes[i]; }
+    const IndexedSubfeature& getFeature(std::size_t i) const { return features[featureIndices[i]]; }
+
+private:
+    uint32_t toCell(float) const;
+
+    static constexpr uint32_t none = UINT32_MAX;
+
+    struct Entry {
+        uint32_t box;
+        uint32_t next;
+    };
+
+    const uint32_t d;
+    const float scale;
+    const float offset;
+
+    std::vector<float> x1s;
+    std::vector<float> y1s;
+    std::vector<float> x2s;
+    std::vector<float> y2s;
+    std::vector<CollisionBox> boxes;
+    std::vector<uint32_t> featureIndices;
+    std::vector<IndexedSubfeature> features;
+
+    // First entry of each cell, or `none`.
+    std::vector<uint32_t> heads;
+    std::vector<Entry> entries;
+};
+
+template <class Fn>
+void CollisionGrid::query(const Bounds& bounds, Fn&& fn) const {
+    const uint32_t cx1 = toCell(bounds.x1);
+    const uint32_t cy1 = toCell(bounds.y1);
+    const uint32_t cx2 = toCell(bounds.x2);
+    const uint32_t cy2 = toCell(bounds.y2);
+
+    for (uint32_t y = cy1; y <= cy2; ++y) {
+        for (uint32_t x = cx1; x <= cx2; ++x) {
+            for (uint32_t e = heads[d * y + x]; e != none; e = entries[e].next) {
+                const uint32_t i = entries[e].box;
+                if (x1s[i] > bounds.x2 || x2s[i] < bounds.x1 || y1s[i] > bounds.y2 || y2s[i] < bounds.y1) {
+                    continue;
+                }
+
+                // A box spanning several of the queried cells is reported from the first of them
+                // only, which is where the cell ranges of the box and the query start to overlap.
+                if (x != std::max(cx1, toCell(x1s[i])) || y != std::max(cy1, toCell(y1s[i]))) {
+                    continue;
+                }
+
+                if (!fn(std::size_t(i))) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+} // namespace mbgl
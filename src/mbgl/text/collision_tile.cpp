@@ -10,10 +10,17 @@
 #include <mapbox/geometry/multi_point.hpp>
 
 #include <cmath>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
-CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_)) {
+// Rotated tile coordinates reach beyond the tile by up to the tile's diagonal, so the grid is
+// padded by a tile on every side. Cells are about as large as a short label.
+CollisionTile::CollisionTile(PlacementConfig config_)
+    : config(std::move(config_)),
+      grid(util::EXTENT, 16, 16),
+      ignoredGrid(util::EXTENT, 16, 16) {
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -101,13 +108,14 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, bool allowOve
         const float boxMaxScale = box.adjustedMaxScale(rotationMatrix, yStretch);
 
         if (!allowOverlap) {
-            for (auto it = tree.qbegin(bgi::intersects(getTreeBox(anchor, box))); it != tree.qend(); ++it) {
-                const CollisionBox& blocking = std::get<1>(*it);
+            grid.query(getGridBounds(anchor, box), [&] (std::size_t i) {
+                const CollisionBox& blocking = grid.getBox(i);
                 Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
 
                 minPlacementScale = util::max(minPlacementScale, findPlacementScale(anchor, box, boxMaxScale, blockingAnchor, blocking));
-                if (minPlacementScale >= maxScale) return minPlacementScale;
-            }
+                return minPlacementScale < maxScale;
+            });
+            if (minPlacementScale >= maxScale) return minPlacementScale;
         }
 
         if (avoidEdges) {
@@ -138,17 +146,13 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
         box.placementScale = minPlacementScale;
     }
 
-    if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
+    if (minPlacementScale < maxScale && !feature.boxes.empty()) {
+        CollisionGrid& target = ignorePlacement ? ignoredGrid : grid;
+        const std::size_t index = target.addFeature(feature.indexedFeature);
         for (auto& box : feature.boxes) {
             CollisionBox adjustedBox = box;
             box.maxScale = box.adjustedMaxScale(rotationMatrix, yStretch);
-            treeBoxes.emplace_back(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), std::move(adjustedBox), feature.indexedFeature);
-        }
-        if (ignorePlacement) {
-            ignoredTree.insert(treeBoxes.begin(), treeBoxes.end());
-        } else {
-            tree.insert(treeBoxes.begin(), treeBoxes.end());
+            target.insert(getGridBounds(util::matrixMultiply(rotationMatrix, box.anchor), box), adjustedBox, index);
         }
     }
 
@@ -158,7 +162,7 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
 // |(x1,y1)      |             | relative to the tile e.g. when zooming in,
 // |             |             | the symbol gets smaller relative to the tile.
 // |  (x1',y1')  v             |
-// |     +-------+-------+     | The boxes inserted into the tree represents
+// |     +-------+-------+     | The boxes inserted into the grid represents
 // |     |       |       |     | the bounds at the integer zoom level (where
 // |     |       |       |     | the symbol is biggest relative to the tile).
 // |     |       |       |     |
@@ -171,9 +175,9 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
 // |             |             | calculating the bounds at current zoom level
 // |             |      (x2,y2)| we must unscale the box using its center as
 // +---------------------------+ transform origin.
-Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
+CollisionGrid::Bounds CollisionTile::getGridBounds(const Point<float>& anchor, const CollisionBox& box, const float scale) {
     assert(box.x1 <= box.x2 && box.y1 <= box.y2);
-    return Box{
+    return CollisionGrid::Bounds {
         // When the 'perspectiveRatio' is high, we're effectively underzooming
         // the tile because it's in the distance.
         // In order to detect collisions that only happen while underzoomed,
@@ -182,20 +186,16 @@ Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& bo
         // Note that this adjustment ONLY affects the bounding boxes
         // in the grid. It doesn't affect the boxes used for the
         // minPlacementScale calculations.
-        CollisionPoint{
-            anchor.x + box.x1 / scale * perspectiveRatio,
-            anchor.y + box.y1 / scale * yStretch * perspectiveRatio,
-        },
-        CollisionPoint{
-            anchor.x + box.x2 / scale * perspectiveRatio,
-            anchor.y + box.y2 / scale * yStretch * perspectiveRatio
-        }
+        anchor.x + box.x1 / scale * perspectiveRatio,
+        anchor.y + box.y1 / scale * yStretch * perspectiveRatio,
+        anchor.x + box.x2 / scale * perspectiveRatio,
+        anchor.y + box.y2 / scale * yStretch * perspectiveRatio
     };
 }
 
 std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const GeometryCoordinates& queryGeometry, float scale) const {
     std::vector<IndexedSubfeature> result;
-    if (queryGeometry.empty() || (tree.empty() && ignoredTree.empty())) {
+    if (queryGeometry.empty() || (grid.empty() && ignoredGrid.empty())) {
         return result;
     }
 
@@ -208,10 +208,9 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     }
 
     // Predicate for ruling out already seen features.
-    std::unordered_map<std::string, std::unordered_set<std::size_t>> sourceLayerFeatures;
-    auto seenFeature = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const IndexedSubfeature& feature = std::get<2>(treeBox);
-        const auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
+    std::unordered_map<uint16_t, std::unordered_set<std::size_t>> sourceLayerFeatures;
+    auto seenFeature = [&] (const IndexedSubfeature& feature) -> bool {
+        const auto& seenFeatures = sourceLayerFeatures[feature.sourceLayer];
         return seenFeatures.find(feature.index) == seenFeatures.end();
     };
 
@@ -225,14 +224,12 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     const float roundedScale = std::pow(2.0f, std::ceil(util::log2(perspectiveScale) * 10.0f) / 10.0f);
 
     // Check if feature is rendered (collision free) at current scale.
-    auto visibleAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& box = std::get<1>(treeBox);
+    auto visibleAtScale = [&] (const CollisionBox& box) -> bool {
         return roundedScale >= box.placementScale && roundedScale <= box.adjustedMaxScale(rotationMatrix, yStretch);
     };
 
     // Check if query polygon intersects with the feature box at current scale.
-    auto intersectsAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& collisionBox = std::get<1>(treeBox);
+    auto intersectsAtScale = [&] (const CollisionBox& collisionBox) -> bool {
         const auto anchor = util::matrixMultiply(rotationMatrix, collisionBox.anchor);
 
         const int16_t x1 = anchor.x + (collisionBox.x1 / perspectiveScale);
@@ -245,21 +242,21 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
         return util::polygonIntersectsPolygon(polygon, bbox);
     };
 
-    auto predicates = bgi::satisfies(seenFeature)
-                   && bgi::satisfies(visibleAtScale)
-                   && bgi::satisfies(intersectsAtScale);
-
-    auto queryTree = [&](const auto& tree_) {
-        for (auto it = tree_.qbegin(predicates); it != tree_.qend(); ++it) {
-            const IndexedSubfeature& feature = std::get<2>(*it);
-            auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
-            seenFeatures.insert(feature.index);
-            result.push_back(feature);
+    // The query geometry isn't bounded by the scale the boxes were inserted at, so all boxes
+    // are tested.
+    auto queryGrid = [&](const CollisionGrid& grid_) {
+        for (std::size_t i = 0; i < grid_.size(); ++i) {
+            const IndexedSubfeature& feature = grid_.getFeature(i);
+            const CollisionBox& box = grid_.getBox(i);
+            if (seenFeature(feature) && visibleAtScale(box) && intersectsAtScale(box)) {
+                sourceLayerFeatures[feature.sourceLayer].insert(feature.index);
+                result.push_back(feature);
+            }
         }
     };
 
-    queryTree(tree);
-    queryTree(ignoredTree);
+    queryGrid(grid);
+    queryGrid(ignoredGrid);
 
     return result;
 }
@@ -1,65 +1,163 @@
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/util/logging.hpp>
 
-#include <mapbox/shelf-pack.hpp>
+#include <algorithm>
 
 namespace mbgl {
 
 static constexpr uint32_t padding = 1;
 
-GlyphAtlas makeGlyphAtlas(const GlyphMap& glyphs) {
-    GlyphAtlas result;
-
-    mapbox::ShelfPack::ShelfPackOptions options;
-    options.autoResize = true;
-    mapbox::ShelfPack pack(0, 0, options);
-
-    for (const auto& glyphMapEntry : glyphs) {
-        const FontStack& fontStack = glyphMapEntry.first;
-        GlyphPositionMap& positions = result.positions[fontStack];
-
-        for (const auto& entry : glyphMapEntry.second) {
-            if (entry.second && (*entry.second)->bitmap.valid()) {
-                const Glyph& glyph = **entry.second;
-
-                const mapbox::Bin& bin = *pack.packOne(-1,
-                    glyph.bitmap.size.width + 2 * padding,
-                    glyph.bitmap.size.height + 2 * padding);
-
-                result.image.resize({
-                    static_cast<uint32_t>(pack.width()),
-                    static_cast<uint32_t>(pack.height())
-                });
-
-                AlphaImage::copy(glyph.bitmap,
-                                 result.image,
-                                 { 0, 0 },
-                                 {
-                                    bin.x + padding,
-                                    bin.y + padding
-                                 },
-                                 glyph.bitmap.size);
-
-                positions.emplace(glyph.id,
-                                  GlyphPosition {
-                                     Rect<uint16_t> {
-                                         static_cast<uint16_t>(bin.x),
-                                         static_cast<uint16_t>(bin.y),
-                                         static_cast<uint16_t>(bin.w),
-                                         static_cast<uint16_t>(bin.h)
-                                     },
-                                     glyph.metrics
-                                  });
-            }
+// Uploading many small regions one by one is slower than uploading the whole atlas.
+static constexpr std::size_t maxSubImageUploads = 64;
+
+GlyphAtlas::GlyphAtlas()
+    : shelfPack(128, 128) {
+}
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+optional<GlyphPosition> GlyphAtlas::addReference(const FontStack& fontStack, const Immutable<Glyph>& glyph) {
+    if (!glyph->bitmap.valid()) {
+        return {};
+    }
+
+    auto& fontEntries = entries[fontStack];
+    auto it = fontEntries.find(glyph->id);
+    if (it != fontEntries.end()) {
+        shelfPack.ref(*it->second.bin);
+        return it->second.position;
+    }
+
+    const int32_t width = glyph->bitmap.size.width + 2 * padding;
+    const int32_t height = glyph->bitmap.size.height + 2 * padding;
+    mapbox::Bin* bin = shelfPack.packOne(-1, width, height);
+    while (!bin && grow(width, height)) {
+        bin = shelfPack.packOne(-1, width, height);
+    }
+    if (!bin) {
+        if (!full) {
+            full = true;
+            Log::Warning(Event::Glyph, "Glyph atlas is full at %ux%u pixels", getPixelSize().width,
+                         getPixelSize().height);
         }
+        return {};
+    }
+
+    image.resize(getPixelSize());
+
+    // A bin may have held another glyph before, so its padding is written as well.
+    const Size binSize { static_cast<uint32_t>(bin->w), static_cast<uint32_t>(bin->h) };
+    AlphaImage padded(binSize);
+    AlphaImage::copy(glyph->bitmap, padded, { 0, 0 }, { padding, padding }, glyph->bitmap.size);
+    AlphaImage::copy(padded, image, { 0, 0 },
+                     { static_cast<uint32_t>(bin->x), static_cast<uint32_t>(bin->y) }, binSize);
+
+    const Rect<uint16_t> rect {
+        static_cast<uint16_t>(bin->x),
+        static_cast<uint16_t>(bin->y),
+        static_cast<uint16_t>(bin->w),
+        static_cast<uint16_t>(bin->h)
+    };
+    dirtyRects.push_back(rect);
+
+    return fontEntries.emplace(glyph->id, Entry { bin, GlyphPosition { rect, glyph->metrics } })
+        .first->second.position;
+}
+
+void GlyphAtlas::removeReference(const FontStack& fontStack, GlyphID id) {
+    auto fontEntries = entries.find(fontStack);
+    if (fontEntries == entries.end()) {
+        return;
     }
 
-    pack.shrink();
-    result.image.resize({
-        static_cast<uint32_t>(pack.width()),
-        static_cast<uint32_t>(pack.height())
-    });
+    auto it = fontEntries->second.find(id);
+    if (it != fontEntries->second.end() && shelfPack.unref(*it->second.bin) == 0) {
+        fontEntries->second.erase(it);
+        full = false;
+    }
+}
+
+optional<GlyphPosition> GlyphAtlas::getPosition(const FontStack& fontStack, GlyphID id) const {
+    auto fontEntries = entries.find(fontStack);
+    if (fontEntries == entries.end()) {
+        return {};
+    }
+
+    auto it = fontEntries->second.find(id);
+    if (it == fontEntries->second.end()) {
+        return {};
+    }
+    return it->second.position;
+}
+
+Size GlyphAtlas::getPixelSize() const {
+    return Size {
+        static_cast<uint32_t>(shelfPack.width()),
+        static_cast<uint32_t>(shelfPack.height())
+    };
+}
+
+void GlyphAtlas::setMaximumSize(uint32_t size) {
+    maximumSize = size;
+}
+
+bool GlyphAtlas::grow(int32_t width, int32_t height) {
+    // Like ShelfPack's auto resizing: doubles the shorter side, and any side the bin is larger
+    // than.
+    const int32_t currentWidth = shelfPack.width();
+    const int32_t currentHeight = shelfPack.height();
+    int32_t newWidth = currentWidth;
+    int32_t newHeight = currentHeight;
+    if (currentWidth <= currentHeight || width > currentWidth) {
+        newWidth = std::max(width, currentWidth) * 2;
+    }
+    if (currentHeight < currentWidth || height > currentHeight) {
+        newHeight = std::max(height, currentHeight) * 2;
+    }
+
+    const int32_t maximum = static_cast<int32_t>(maximumSize);
+    newWidth = std::max(currentWidth, std::min(newWidth, maximum));
+    newHeight = std::max(currentHeight, std::min(newHeight, maximum));
+    if (newWidth == currentWidth && newHeight == currentHeight) {
+        return false;
+    }
+
+    shelfPack.resize(newWidth, newHeight);
+    return true;
+}
+
+void GlyphAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
+    if (context.getMaximumTextureSize()) {
+        setMaximumSize(context.getMaximumTextureSize());
+    }
+
+    if (!texture) {
+        texture = context.createTexture(image, unit);
+    } else if (texture->size != image.size || dirtyRects.size() > maxSubImageUploads) {
+        context.updateTexture(*texture, image, unit);
+    } else {
+        for (const auto& rect : dirtyRects) {
+            const Size size { rect.w, rect.h };
+            AlphaImage region(size);
+            AlphaImage::copy(image, region, { rect.x, rect.y }, { 0, 0 }, size);
+            context.updateTextureSubImage(*texture, region, { rect.x, rect.y }, unit);
+        }
+    }
+
+    dirtyRects.clear();
+}
+
+RendererStatistics::Memory GlyphAtlas::memoryUsage() const {
+    RendererStatistics::Memory memory;
+    memory.cpu = image.bytes();
+    memory.gpu = texture ? texture->size.area() : 0;
+    return memory;
+}
 
-    return result;
+void GlyphAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
+    upload(context, unit);
+    context.bindTexture(*texture, unit, gl::TextureFilter::Linear);
 }
 
 } // namespace mbgl
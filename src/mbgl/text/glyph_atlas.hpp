@@ -1,11 +1,22 @@
 #pragma once
 
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/gl/texture.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <mapbox/shelf-pack.hpp>
 
+#include <unordered_map>
+#include <vector>
+
 namespace mbgl {
 
+namespace gl {
+class Context;
+} // namespace gl
+
 struct GlyphPosition {
     Rect<uint16_t> rect;
     GlyphMetrics metrics;
@@ -14,12 +25,63 @@ struct GlyphPosition {
 using GlyphPositionMap = std::map<GlyphID, GlyphPosition>;
 using GlyphPositions = std::map<FontStack, GlyphPositionMap>;
 
-class GlyphAtlas {
+/*
+    A texture atlas of the glyphs of all tiles, owned by the GlyphManager.
+
+    Glyphs are reference counted: one that several tiles use is stored once, and its space is
+    reused once no tile references it any more. Glyphs added since the last upload are uploaded
+    as sub images of the texture, unless the atlas grew and has to be uploaded as a whole.
+
+    The atlas grows up to the maximum texture size of the context it was uploaded to. Once it is
+    full, glyphs that don't fit into the space of unreferenced ones are refused until tiles
+    release theirs.
+*/
+class GlyphAtlas : private util::noncopyable {
 public:
+    GlyphAtlas();
+    ~GlyphAtlas();
+
+    // Returns nothing if the glyph has no bitmap or doesn't fit into the atlas.
+    optional<GlyphPosition> addReference(const FontStack&, const Immutable<Glyph>&);
+    void removeReference(const FontStack&, GlyphID);
+    optional<GlyphPosition> getPosition(const FontStack&, GlyphID) const;
+
+    Size getPixelSize() const;
+
+    // Limits the width and height the atlas grows to. Uploading sets it to the context's maximum
+    // texture size; before the first upload, it defaults to 2048.
+    void setMaximumSize(uint32_t);
+
+    void upload(gl::Context&, gl::TextureUnit);
+    void bind(gl::Context&, gl::TextureUnit);
+
+    // Memory held by the atlas image, and by its texture once uploaded.
+    RendererStatistics::Memory memoryUsage() const;
+
+    // Only for use in tests.
+    const AlphaImage& getAtlasImage() const {
+        return image;
+    }
+
+private:
+    struct Entry {
+        mapbox::Bin* bin;
+        GlyphPosition position;
+    };
+
+    // Grows the atlas so that a bin of this size may fit, as far as the maximum size allows.
+    bool grow(int32_t width, int32_t height);
+
+    mapbox::ShelfPack shelfPack;
+    uint32_t maximumSize = 2048;
+    // Whether a glyph was refused since space was last released.
+    bool full = false;
+    std::unordered_map<FontStack, std::map<GlyphID, Entry>, FontStackHash> entries;
     AlphaImage image;
-    GlyphPositions positions;
-};
 
-GlyphAtlas makeGlyphAtlas(const GlyphMap&);
+    optional<gl::Texture> texture;
+    // Regions changed since the last upload.
+    std::vector<Rect<uint16_t>> dirtyRects;
+};
 
 } // namespace mbgl
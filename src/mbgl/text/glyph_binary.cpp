@@ -0,0 +1,111 @@
+#include <mbgl/text/glyph_binary.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+// Bump the version whenever the encoding changes, so that stale cache files are discarded.
+constexpr const char magic[] = { 'M', 'B', 'G', 'L', 'G', 'L', 'Y', '1' };
+
+// Followed by the number of glyphs (2 bytes, little endian), so that truncated files are detected.
+constexpr std::size_t headerSize = sizeof(magic) + 2;
+
+// id (2 bytes, little endian), width, height, left, top, advance
+constexpr std::size_t glyphHeaderSize = 7;
+
+Size bitmapSize(const GlyphMetrics& metrics) {
+    if (!metrics.width || !metrics.height) {
+        return { 0, 0 };
+    }
+    return { metrics.width + 2 * Glyph::borderSize, metrics.height + 2 * Glyph::borderSize };
+}
+
+} // namespace
+
+std::string encodeGlyphs(const std::vector<Glyph>& glyphs) {
+    assert(glyphs.size() <= 0xFFFF);
+    std::string data(magic, sizeof(magic));
+    data.push_back(char(glyphs.size() & 0xFF));
+    data.push_back(char(glyphs.size() >> 8));
+
+    for (const auto& glyph : glyphs) {
+        assert(glyph.metrics.width < 256 && glyph.metrics.height < 256);
+        assert(glyph.metrics.left >= -128 && glyph.metrics.left < 128);
+        assert(glyph.metrics.top >= -128 && glyph.metrics.top < 128);
+        assert(glyph.metrics.advance < 256);
+
+        const char header[glyphHeaderSize] = {
+            char(glyph.id & 0xFF),
+            char(glyph.id >> 8),
+            char(uint8_t(glyph.metrics.width)),
+            char(uint8_t(glyph.metrics.height)),
+            char(int8_t(glyph.metrics.left)),
+            char(int8_t(glyph.metrics.top)),
+            char(uint8_t(glyph.metrics.advance)),
+        };
+        data.append(header, glyphHeaderSize);
+
+        const Size size = bitmapSize(glyph.metrics);
+        assert(glyph.bitmap.bytes() == size.area());
+        if (size.area()) {
+            data.append(reinterpret_cast<const char*>(glyph.bitmap.data.get()), size.area());
+        }
+    }
+
+    return data;
+}
+
+std::vector<Glyph> decodeGlyphs(const GlyphRange& glyphRange, const std::string& data) {
+    if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("unknown glyph cache format");
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    const std::size_t count = bytes[sizeof(magic)] | (bytes[sizeof(magic) + 1] << 8);
+    std::size_t offset = headerSize;
+
+    std::vector<Glyph> result;
+    result.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (data.size() - offset < glyphHeaderSize) {
+            throw std::runtime_error("truncated glyph cache");
+        }
+
+        Glyph glyph;
+        glyph.id = GlyphID(bytes[offset] | (bytes[offset + 1] << 8));
+        glyph.metrics.width = bytes[offset + 2];
+        glyph.metrics.height = bytes[offset + 3];
+        glyph.metrics.left = int8_t(bytes[offset + 4]);
+        glyph.metrics.top = int8_t(bytes[offset + 5]);
+        glyph.metrics.advance = bytes[offset + 6];
+        offset += glyphHeaderSize;
+
+        if (glyph.id < glyphRange.first || glyph.id > glyphRange.second) {
+            throw std::runtime_error("glyph cache doesn't match its range");
+        }
+
+        const Size size = bitmapSize(glyph.metrics);
+        if (size.area()) {
+            if (data.size() - offset < size.area()) {
+                throw std::runtime_error("truncated glyph cache");
+            }
+            glyph.bitmap = AlphaImage(size, bytes + offset, size.area());
+            offset += size.area();
+        }
+
+        result.push_back(std::move(glyph));
+    }
+
+    if (offset != data.size()) {
+        throw std::runtime_error("glyph cache has trailing data");
+    }
+
+    return result;
+}
+
+} // namespace mbgl
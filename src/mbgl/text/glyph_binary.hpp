@@ -0,0 +1,21 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_range.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// A compact encoding of parsed glyphs, used to cache them on disk. Decoding it copies the
+// bitmaps as they are, instead of parsing a glyph PBF again.
+//
+// Only glyphs as returned by parseGlyphPBF() can be encoded: their metrics are limited to
+// a byte each.
+std::string encodeGlyphs(const std::vector<Glyph>&);
+
+// Throws std::runtime_error if the data is malformed or out of the range.
+std::vector<Glyph> decodeGlyphs(const GlyphRange&, const std::string& data);
+
+} // namespace mbgl
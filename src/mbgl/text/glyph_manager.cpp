@@ -1,19 +1,77 @@
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/glyph_binary.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/weak_cache.hpp>
+
+#include <iomanip>
+#include <sstream>
 
 namespace mbgl {
 
 static GlyphManagerObserver nullObserver;
 
-GlyphManager::GlyphManager(FileSource& fileSource_)
+// Glyph ranges that are in use by any glyph manager, keyed by glyph URL, font stack and range.
+static util::WeakCache<std::string, std::vector<Immutable<Glyph>>> sharedRanges;
+
+static std::string sharedRangeKey(const std::string& url, const FontStack& fontStack, const GlyphRange& range) {
+    return url + "\n" + fontStackToString(fontStack) + "\n" + util::toString(range.first) + "-" + util::toString(range.second);
+}
+
+class GlyphManager::LocalGlyphWorker {
+public:
+    LocalGlyphWorker(ActorRef<GlyphManager> parent_, std::unique_ptr<LocalGlyphRasterizer> rasterizer_)
+        : parent(std::move(parent_)),
+          rasterizer(std::move(rasterizer_)) {
+    }
+
+    void rasterize(FontStack fontStack, GlyphIDs glyphIDs, uint64_t requestID) {
+        std::vector<Glyph> glyphs;
+        GlyphIDs missing;
+        glyphs.reserve(glyphIDs.size());
+
+        for (const auto& glyphID : glyphIDs) {
+            optional<Glyph> glyph = rasterizer->rasterizeGlyph(fontStack, glyphID);
+            if (glyph) {
+                glyphs.push_back(std::move(*glyph));
+            } else {
+                missing.insert(glyphID);
+            }
+        }
+
+        parent.invoke(&GlyphManager::onGlyphsRasterized, std::move(fontStack), std::move(glyphs),
+                      std::move(missing), requestID);
+    }
+
+private:
+    ActorRef<GlyphManager> parent;
+    const std::unique_ptr<LocalGlyphRasterizer> rasterizer;
+};
+
+GlyphManager::GlyphManager(FileSource& fileSource_, optional<std::string> cacheDir_)
     : fileSource(fileSource_),
+      cacheDir(std::move(cacheDir_)),
       observer(&nullObserver) {
 }
 
+GlyphManager::GlyphManager(FileSource& fileSource_, optional<std::string> cacheDir_,
+                           Scheduler& scheduler, std::unique_ptr<LocalGlyphRasterizer> rasterizer)
+    : GlyphManager(fileSource_, std::move(cacheDir_)) {
+    if (rasterizer) {
+        mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+        localGlyphWorker = std::make_unique<Actor<LocalGlyphWorker>>(
+            scheduler, ActorRef<GlyphManager>(*this, mailbox), std::move(rasterizer));
+    }
+}
+
 GlyphManager::~GlyphManager() = default;
 
 void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphDependencies) {
@@ -29,15 +87,31 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
 
         const GlyphIDs& glyphIDs = dependency.second;
         GlyphRangeSet ranges;
+        GlyphIDs rasterize;
+        std::set<uint64_t> rasterizing;
         for (const auto& glyphID : glyphIDs) {
-            ranges.insert(getGlyphRange(glyphID));
+            if (!rasterizesLocally(entry, glyphID)) {
+                ranges.insert(getGlyphRange(glyphID));
+            } else if (!entry.glyphs.count(glyphID)) {
+                auto it = entry.rasterizing.find(glyphID);
+                if (it != entry.rasterizing.end()) {
+                    rasterizing.insert(it->second);
+                } else {
+                    rasterize.insert(glyphID);
+                }
+            }
+        }
+
+        if (!rasterize.empty()) {
+            rasterizing.insert(rasterizeGlyphs(entry, fontStack, std::move(rasterize)));
+        }
+        for (const auto& requestID : rasterizing) {
+            localRequests[requestID].requestors[&requestor] = dependencies;
         }
 
         for (const auto& range : ranges) {
-            auto it = entry.ranges.find(range);
-            if (it == entry.ranges.end() || !it->second.parsed) {
-                GlyphRequest& request = requestRange(entry, fontStack, range);
-                request.requestors[&requestor] = dependencies;
+            if (GlyphRequest* request = loadRange(entry, fontStack, range)) {
+                request->requestors[&requestor] = dependencies;
             }
         }
     }
@@ -49,6 +123,30 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
     }
 }
 
+void GlyphManager::prefetchGlyphs(const FontStack& fontStack, const GlyphRangeSet& ranges) {
+    if (glyphURL.empty()) {
+        return;
+    }
+
+    Entry& entry = entries[fontStack];
+    for (const auto& range : ranges) {
+        loadRange(entry, fontStack, range);
+    }
+}
+
+// Returns the request of the range if it's still loading.
+GlyphManager::GlyphRequest* GlyphManager::loadRange(Entry& entry, const FontStack& fontStack, const GlyphRange& range) {
+    auto it = entry.ranges.find(range);
+    if (it == entry.ranges.end() &&
+        (loadSharedRange(entry, fontStack, range) || loadCachedRange(entry, fontStack, range))) {
+        return nullptr;
+    }
+    if (it != entry.ranges.end() && it->second.parsed) {
+        return nullptr;
+    }
+    return &requestRange(entry, fontStack, range);
+}
+
 GlyphManager::GlyphRequest& GlyphManager::requestRange(Entry& entry, const FontStack& fontStack, const GlyphRange& range) {
     GlyphRequest& request = entry.ranges[range];
 
@@ -76,9 +174,8 @@ void GlyphManager::processResponse(const Response& res, const FontStack& fontSta
     Entry& entry = entries[fontStack];
     GlyphRequest& request = entry.ranges[range];
 
+    std::vector<Glyph> glyphs;
     if (!res.noContent) {
-        std::vector<Glyph> glyphs;
-
         try {
             glyphs = parseGlyphPBF(range, *res.data);
         } catch (...) {
@@ -86,12 +183,11 @@ void GlyphManager::processResponse(const Response& res, const FontStack& fontSta
             return;
         }
 
-        for (auto& glyph : glyphs) {
-            entry.glyphs.erase(glyph.id);
-            entry.glyphs.emplace(glyph.id, makeMutable<Glyph>(std::move(glyph)));
-        }
+        cacheRange(glyphs, fontStack, range);
     }
 
+    addRange(entry, std::move(glyphs), fontStack, range);
+
     request.parsed = true;
 
     for (auto& pair : request.requestors) {
@@ -107,31 +203,186 @@ void GlyphManager::processResponse(const Response& res, const FontStack& fontSta
     observer->onGlyphsLoaded(fontStack, range);
 }
 
+optional<std::string> GlyphManager::cachePath(const FontStack& fontStack, const GlyphRange& range) const {
+    if (!cacheDir) {
+        return {};
+    }
+
+    // Glyphs of the same font stack may differ between glyph URLs.
+    std::ostringstream ss;
+    ss << *cacheDir << "/com.mapbox.gl.glyphs." << std::setfill('0') << std::setw(sizeof(size_t) * 2)
+       << std::hex << std::hash<std::string>()(glyphURL + "\n" + fontStackToString(fontStack))
+       << std::dec << "." << range.first << "-" << range.second << ".bin";
+    return ss.str();
+}
+
+bool GlyphManager::loadCachedRange(Entry& entry, const FontStack& fontStack, const GlyphRange& range) {
+    const optional<std::string> path = cachePath(fontStack, range);
+    if (!path) {
+        return false;
+    }
+
+    std::vector<Glyph> glyphs;
+    try {
+        optional<std::string> data = util::readFile(*path);
+        if (!data) {
+            return false;
+        }
+        glyphs = decodeGlyphs(range, *data);
+    } catch (std::runtime_error& error) {
+        Log::Warning(Event::Glyph, "Could not load cached glyphs: %s", error.what());
+        return false;
+    }
+
+    addRange(entry, std::move(glyphs), fontStack, range);
+    entry.ranges[range].parsed = true;
+
+    observer->onGlyphsLoaded(fontStack, range);
+    return true;
+}
+
+bool GlyphManager::loadSharedRange(Entry& entry, const FontStack& fontStack, const GlyphRange& range) {
+    std::shared_ptr<const SharedRange> glyphs = sharedRanges.get(sharedRangeKey(glyphURL, fontStack, range));
+    if (!glyphs) {
+        return false;
+    }
+
+    for (const auto& glyph : *glyphs) {
+        entry.glyphs.erase(glyph->id);
+        entry.glyphs.emplace(glyph->id, glyph);
+    }
+
+    GlyphRequest& request = entry.ranges[range];
+    request.glyphs = std::move(glyphs);
+    request.parsed = true;
+
+    observer->onGlyphsLoaded(fontStack, range);
+    return true;
+}
+
+void GlyphManager::addRange(Entry& entry, std::vector<Glyph>&& glyphs, const FontStack& fontStack, const GlyphRange& range) {
+    auto shared = std::make_shared<SharedRange>();
+    shared->reserve(glyphs.size());
+
+    for (auto& glyph : glyphs) {
+        Immutable<Glyph> immutable = makeMutable<Glyph>(std::move(glyph));
+        entry.glyphs.erase(immutable->id);
+        entry.glyphs.emplace(immutable->id, immutable);
+        shared->push_back(std::move(immutable));
+    }
+
+    // Other glyph managers pick the range up for as long as this one keeps it.
+    GlyphRequest& request = entry.ranges[range];
+    request.glyphs = shared;
+    sharedRanges.add(sharedRangeKey(glyphURL, fontStack, range), std::move(shared));
+}
+
+void GlyphManager::cacheRange(const std::vector<Glyph>& glyphs, const FontStack& fontStack, const GlyphRange& range) {
+    const optional<std::string> path = cachePath(fontStack, range);
+    if (!path) {
+        return;
+    }
+
+    try {
+        util::write_file(*path, encodeGlyphs(glyphs));
+    } catch (std::runtime_error& error) {
+        Log::Warning(Event::Glyph, "Failed to cache glyphs: %s", error.what());
+    }
+}
+
+bool GlyphManager::rasterizesLocally(const Entry& entry, GlyphID glyphID) const {
+    return localGlyphWorker && LocalGlyphRasterizer::canRasterizeGlyph(glyphID) &&
+        !entry.notRasterized.count(glyphID);
+}
+
+uint64_t GlyphManager::rasterizeGlyphs(Entry& entry, const FontStack& fontStack, GlyphIDs glyphIDs) {
+    const uint64_t requestID = ++localRequestID;
+    for (const auto& glyphID : glyphIDs) {
+        entry.rasterizing.emplace(glyphID, requestID);
+    }
+    localGlyphWorker->invoke(&LocalGlyphWorker::rasterize, fontStack, std::move(glyphIDs), requestID);
+    return requestID;
+}
+
+void GlyphManager::onGlyphsRasterized(FontStack fontStack, std::vector<Glyph> glyphs, GlyphIDs missing, uint64_t requestID) {
+    Entry& entry = entries[fontStack];
+    for (auto& glyph : glyphs) {
+        entry.rasterizing.erase(glyph.id);
+        entry.glyphs.erase(glyph.id);
+        const GlyphID glyphID = glyph.id;
+        entry.glyphs.emplace(glyphID, makeMutable<Glyph>(std::move(glyph)));
+    }
+
+    // Glyphs the font doesn't have are downloaded with their ranges, like other glyphs.
+    GlyphRangeSet ranges;
+    for (const auto& glyphID : missing) {
+        entry.rasterizing.erase(glyphID);
+        entry.notRasterized.insert(glyphID);
+        ranges.insert(getGlyphRange(glyphID));
+    }
+
+    auto it = localRequests.find(requestID);
+    if (it == localRequests.end()) {
+        return;
+    }
+    auto requestors = std::move(it->second.requestors);
+    localRequests.erase(it);
+
+    for (const auto& range : ranges) {
+        if (GlyphRequest* request = loadRange(entry, fontStack, range)) {
+            for (const auto& pair : requestors) {
+                request->requestors.emplace(pair);
+            }
+        }
+    }
+
+    for (auto& pair : requestors) {
+        if (pair.second.unique()) {
+            notify(*pair.first, *pair.second);
+        }
+    }
+}
+
 void GlyphManager::setObserver(GlyphManagerObserver* observer_) {
     observer = observer_ ? observer_ : &nullObserver;
 }
 
 void GlyphManager::notify(GlyphRequestor& requestor, const GlyphDependencies& glyphDependencies) {
     GlyphMap response;
+    GlyphPositions positions;
+    GlyphDependencies& referenced = references[&requestor];
 
     for (const auto& dependency : glyphDependencies) {
         const FontStack& fontStack = dependency.first;
         const GlyphIDs& glyphIDs = dependency.second;
 
         Glyphs& glyphs = response[fontStack];
+        GlyphPositionMap& glyphPositions = positions[fontStack];
+        GlyphIDs& referencedIDs = referenced[fontStack];
         Entry& entry = entries[fontStack];
 
         for (const auto& glyphID : glyphIDs) {
             auto it = entry.glyphs.find(glyphID);
             if (it != entry.glyphs.end()) {
                 glyphs.emplace(*it);
+
+                // Requestors reference each glyph once, however often they request it.
+                optional<GlyphPosition> position;
+                if (referencedIDs.count(glyphID)) {
+                    position = atlas.getPosition(fontStack, glyphID);
+                } else if ((position = atlas.addReference(fontStack, it->second))) {
+                    referencedIDs.insert(glyphID);
+                }
+                if (position) {
+                    glyphPositions.emplace(glyphID, *position);
+                }
             } else {
                 glyphs.emplace(glyphID, std::experimental::nullopt);
             }
         }
     }
 
-    requestor.onGlyphsAvailable(response);
+    requestor.onGlyphsAvailable(std::move(response), std::move(positions));
 }
 
 void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
@@ -140,6 +391,19 @@ void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
             range.second.requestors.erase(&requestor);
         }
     }
+    for (auto& request : localRequests) {
+        request.second.requestors.erase(&requestor);
+    }
+
+    auto it = references.find(&requestor);
+    if (it != references.end()) {
+        for (const auto& dependency : it->second) {
+            for (const auto& glyphID : dependency.second) {
+                atlas.removeReference(dependency.first, glyphID);
+            }
+        }
+        references.erase(it);
+    }
 }
 
 } // namespace mbgl
@@ -1,30 +1,48 @@
 #pragma once
 
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_range.hpp>
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
+#include <mbgl/util/optional.hpp>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
 class FileSource;
 class AsyncRequest;
 class Response;
+class Scheduler;
+class LocalGlyphRasterizer;
 
 class GlyphRequestor {
 public:
     virtual ~GlyphRequestor() = default;
-    virtual void onGlyphsAvailable(GlyphMap) = 0;
+    // The positions are those of the glyphs in the GlyphManager's atlas, which keeps them for as
+    // long as the requestor isn't removed.
+    virtual void onGlyphsAvailable(GlyphMap, GlyphPositions) = 0;
 };
 
 class GlyphManager : public util::noncopyable {
 public:
-    GlyphManager(FileSource&);
+    // With a cache directory, parsed glyph ranges are stored there and loaded from there instead
+    // of being requested and parsed again.
+    GlyphManager(FileSource&, optional<std::string> cacheDir = {});
+
+    // With a local glyph rasterizer, the glyphs it can rasterize are rasterized on a worker of
+    // `scheduler` rather than downloaded. The ranges they belong to are downloaded only for other
+    // glyphs, or for those the rasterizer's font doesn't have. It's created on the thread whose
+    // run loop gets the rasterized glyphs.
+    GlyphManager(FileSource&, optional<std::string> cacheDir, Scheduler& scheduler,
+                 std::unique_ptr<LocalGlyphRasterizer>);
     ~GlyphManager();
 
     // Workers send a `getGlyphs` message to the main thread once they have determined
@@ -35,18 +53,36 @@ public:
     void getGlyphs(GlyphRequestor&, GlyphDependencies);
     void removeRequestor(GlyphRequestor&);
 
+    // Loads the ranges of the font stack ahead of the tiles that are going to need them, so that
+    // those don't wait for the ranges once they're parsed. Ranges that are loaded or loading
+    // already are left as they are.
+    void prefetchGlyphs(const FontStack&, const GlyphRangeSet&);
+
     void setURL(const std::string& url) {
         glyphURL = url;
     }
 
+    const std::string& getURL() const {
+        return glyphURL;
+    }
+
     void setObserver(GlyphManagerObserver*);
 
+    GlyphAtlas& getAtlas() {
+        return atlas;
+    }
+
 private:
     FileSource& fileSource;
+    const optional<std::string> cacheDir;
     std::string glyphURL;
 
+    // The glyphs of a range, shared by all glyph managers that load it from the same URL.
+    using SharedRange = std::vector<Immutable<Glyph>>;
+
     struct GlyphRequest {
         bool parsed = false;
+        std::shared_ptr<const SharedRange> glyphs;
         std::unique_ptr<AsyncRequest> req;
         std::unordered_map<GlyphRequestor*, std::shared_ptr<GlyphDependencies>> requestors;
     };
@@ -54,15 +90,47 @@ private:
     struct Entry {
         std::map<GlyphRange, GlyphRequest> ranges;
         std::map<GlyphID, Immutable<Glyph>> glyphs;
+
+        // The glyphs being rasterized locally, with the ID of their request, and those the
+        // rasterizer doesn't have, which are downloaded instead.
+        std::map<GlyphID, uint64_t> rasterizing;
+        GlyphIDs notRasterized;
     };
 
     std::unordered_map<FontStack, Entry, FontStackHash> entries;
 
+    // Glyphs of a font stack that are rasterized together on the worker.
+    struct LocalGlyphRequest {
+        std::unordered_map<GlyphRequestor*, std::shared_ptr<GlyphDependencies>> requestors;
+    };
+
+    std::unordered_map<uint64_t, LocalGlyphRequest> localRequests;
+    uint64_t localRequestID = 0;
+
+    // The glyphs each requestor references in the atlas.
+    std::unordered_map<GlyphRequestor*, GlyphDependencies> references;
+    GlyphAtlas atlas;
+
+    GlyphRequest* loadRange(Entry&, const FontStack&, const GlyphRange&);
     GlyphRequest& requestRange(Entry&, const FontStack&, const GlyphRange&);
     void processResponse(const Response&, const FontStack&, const GlyphRange&);
+
+    optional<std::string> cachePath(const FontStack&, const GlyphRange&) const;
+    bool loadSharedRange(Entry&, const FontStack&, const GlyphRange&);
+    bool loadCachedRange(Entry&, const FontStack&, const GlyphRange&);
+    void addRange(Entry&, std::vector<Glyph>&&, const FontStack&, const GlyphRange&);
+    void cacheRange(const std::vector<Glyph>&, const FontStack&, const GlyphRange&);
     void notify(GlyphRequestor&, const GlyphDependencies&);
 
+    bool rasterizesLocally(const Entry&, GlyphID) const;
+    uint64_t rasterizeGlyphs(Entry&, const FontStack&, GlyphIDs);
+    void onGlyphsRasterized(FontStack, std::vector<Glyph>, GlyphIDs missing, uint64_t requestID);
+
     GlyphManagerObserver* observer = nullptr;
+
+    class LocalGlyphWorker;
+    std::shared_ptr<Mailbox> mailbox;
+    std::unique_ptr<Actor<LocalGlyphWorker>> localGlyphWorker;
 };
 
 } // namespace mbgl
@@ -0,0 +1,89 @@
+#include <mbgl/text/line_break_cache.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+bool LineBreakCache::Key::operator==(const Key& rhs) const {
+    return text == rhs.text &&
+        fontStack == rhs.fontStack &&
+        spacing == rhs.spacing &&
+        maxWidth == rhs.maxWidth &&
+        writingMode == rhs.writingMode;
+}
+
+std::size_t LineBreakCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = std::hash<std::u16string>()(key.text);
+    boost::hash_combine(seed, FontStackHash()(key.fontStack));
+    boost::hash_combine(seed, key.spacing);
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.writingMode));
+    return seed;
+}
+
+LineBreakCache::LineBreakCache(std::size_t capacity_)
+    : capacity(capacity_) {
+    assert(capacity > 0);
+}
+
+optional<std::vector<std::u16string>> LineBreakCache::get(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        ++misses;
+        return {};
+    }
+
+    ++hits;
+    uses.splice(uses.begin(), uses, it->second.use);
+    return it->second.lines;
+}
+
+void LineBreakCache::add(Key key, std::vector<std::u16string> lines) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Another worker may have added the same lines in the meantime.
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        uses.splice(uses.begin(), uses, it->second.use);
+        return;
+    }
+
+    it = entries.emplace(std::move(key), Entry { std::move(lines), uses.end() }).first;
+    uses.push_front(&it->first);
+    it->second.use = uses.begin();
+
+    if (entries.size() > capacity) {
+        // Erase by iterator: the key is owned by the entry being erased.
+        const Key* oldest = uses.back();
+        uses.pop_back();
+        entries.erase(entries.find(*oldest));
+    }
+}
+
+void LineBreakCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    uses.clear();
+}
+
+LineBreakCache::Stats LineBreakCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return { hits, misses, entries.size() };
+}
+
+void LineBreakCache::dumpDebugLogs() const {
+    const Stats stats = getStats();
+    const uint64_t lookups = stats.hits + stats.misses;
+    Log::Info(Event::General, "LineBreakCache::size: %zu", stats.size);
+    Log::Info(Event::General, "LineBreakCache::hits: %llu of %llu (%.1f%%)",
+              static_cast<unsigned long long>(stats.hits),
+              static_cast<unsigned long long>(lookups),
+              lookups ? 100.0 * stats.hits / lookups : 0.0);
+}
+
+} // namespace mbgl
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   A least recently used cache of the lines getShaping() breaks a label into, in visual order.
+   Breaking lines and reordering them with the bidirectional algorithm only depends on the text,
+   the glyph advances of its font stack, the letter spacing, the maximum width and the writing
+   mode, and is expensive, in particular for right-to-left scripts.
+
+   The cache is shared by all tile workers and is safe to use from any thread. Lines are only
+   cached once every glyph of the text is known, so entries stay valid as glyphs are loaded. The
+   key doesn't tell glyphs of different URLs apart, so the cache is cleared when the URL changes.
+*/
+class LineBreakCache : private util::noncopyable {
+public:
+    struct Key {
+        std::u16string text;
+        FontStack fontStack;
+        float spacing;
+        float maxWidth;
+        WritingModeType writingMode;
+
+        bool operator==(const Key&) const;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        std::size_t size;
+    };
+
+    explicit LineBreakCache(std::size_t capacity = 4096);
+
+    optional<std::vector<std::u16string>> get(const Key&);
+    void add(Key, std::vector<std::u16string> lines);
+
+    // Forgets all lines, e.g. once the glyphs they were broken with are replaced.
+    void clear();
+
+    Stats getStats() const;
+    void dumpDebugLogs() const;
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        std::vector<std::u16string> lines;
+        std::list<const Key*>::iterator use;
+    };
+
+    const std::size_t capacity;
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    // Keys of the entries, most recently used first.
+    std::list<const Key*> uses;
+
+    std::atomic<uint64_t> hits { 0 };
+    std::atomic<uint64_t> misses { 0 };
+};
+
+} // namespace mbgl
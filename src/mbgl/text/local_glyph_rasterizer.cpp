@@ -0,0 +1,137 @@
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/util/i18n.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mbgl {
+
+bool LocalGlyphRasterizer::canRasterizeGlyph(GlyphID glyphID) {
+    return util::i18n::allowsIdeographicBreaking(glyphID);
+}
+
+optional<Glyph> LocalGlyphRasterizer::rasterizeGlyph(const FontStack& fontStack, GlyphID glyphID) {
+    optional<DrawnGlyph> drawn = drawGlyph(fontStack, glyphID);
+    if (!drawn) {
+        return {};
+    }
+
+    Glyph glyph;
+    glyph.id = glyphID;
+    glyph.metrics = drawn->metrics;
+    if (drawn->bitmap.valid()) {
+        glyph.metrics.width = drawn->bitmap.size.width;
+        glyph.metrics.height = drawn->bitmap.size.height;
+        glyph.bitmap = makeGlyphSDF(drawn->bitmap);
+    } else {
+        // Glyphs without a bitmap, like spaces, have no size.
+        glyph.metrics.width = glyph.metrics.height = 0;
+    }
+    return optional<Glyph>(std::move(glyph));
+}
+
+namespace {
+
+// The distance in pixels that the values of the field span, and where the edge is within it, as
+// for glyph PBFs.
+constexpr const double radius = 8;
+constexpr const double cutoff = 0.25;
+constexpr const double infinity = 1e20;
+
+// The squared distance of each element of `f` to the nearest zero of it, along a row or column of
+// `n` elements (Felzenszwalb & Huttenlocher, "Distance Transforms of Sampled Functions").
+void transform1D(const std::vector<double>& f, std::vector<double>& d, std::vector<std::size_t>& v,
+                 std::vector<double>& z, std::size_t n) {
+    v[0] = 0;
+    z[0] = -infinity;
+    z[1] = infinity;
+
+    std::size_t k = 0;
+    for (std::size_t q = 1; q < n; q++) {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = infinity;
+    }
+
+    k = 0;
+    for (std::size_t q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        const double offset = double(q) - double(v[k]);
+        d[q] = offset * offset + f[v[k]];
+    }
+}
+
+// Turns the grid into the squared distances to its zeros, columns first, then rows.
+void transform2D(std::vector<double>& grid, std::size_t width, std::size_t height) {
+    const std::size_t n = std::max(width, height);
+    std::vector<double> f(n), d(n), z(n + 1);
+    std::vector<std::size_t> v(n);
+
+    for (std::size_t x = 0; x < width; x++) {
+        for (std::size_t y = 0; y < height; y++) {
+            f[y] = grid[y * width + x];
+        }
+        transform1D(f, d, v, z, height);
+        for (std::size_t y = 0; y < height; y++) {
+            grid[y * width + x] = d[y];
+        }
+    }
+
+    for (std::size_t y = 0; y < height; y++) {
+        for (std::size_t x = 0; x < width; x++) {
+            f[x] = grid[y * width + x];
+        }
+        transform1D(f, d, v, z, width);
+        for (std::size_t x = 0; x < width; x++) {
+            grid[y * width + x] = d[x];
+        }
+    }
+}
+
+} // namespace
+
+AlphaImage makeGlyphSDF(const AlphaImage& coverage) {
+    const std::size_t border = Glyph::borderSize;
+    const std::size_t width = coverage.size.width + 2 * border;
+    const std::size_t height = coverage.size.height + 2 * border;
+
+    // The distances to the nearest pixel outside of the glyph, and inside of it. Partially covered
+    // pixels are taken to be half a pixel off the edge at most.
+    std::vector<double> outer(width * height, infinity);
+    std::vector<double> inner(width * height, 0);
+    for (std::size_t y = 0; y < coverage.size.height; y++) {
+        for (std::size_t x = 0; x < coverage.size.width; x++) {
+            const double alpha = coverage.data[y * coverage.size.width + x] / 255.0;
+            const std::size_t i = (y + border) * width + x + border;
+            if (alpha == 1) {
+                outer[i] = 0;
+                inner[i] = infinity;
+            } else if (alpha > 0) {
+                outer[i] = std::pow(std::max(0.0, 0.5 - alpha), 2);
+                inner[i] = std::pow(std::max(0.0, alpha - 0.5), 2);
+            }
+        }
+    }
+
+    transform2D(outer, width, height);
+    transform2D(inner, width, height);
+
+    AlphaImage sdf({ uint32_t(width), uint32_t(height) });
+    for (std::size_t i = 0; i < width * height; i++) {
+        const double distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);
+        sdf.data[i] = uint8_t(util::clamp(std::round(255 - 255 * (distance / radius + cutoff)), 0.0, 255.0));
+    }
+    return sdf;
+}
+
+} // namespace mbgl
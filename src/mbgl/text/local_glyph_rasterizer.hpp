@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+/*
+    Rasterizes glyphs with a font of the platform rather than taking them from the downloaded
+    glyph ranges. Only CJK glyphs are rasterized locally: a CJK label typically needs glyphs from
+    dozens of ranges, while ideographs look alike enough across fonts that a platform font makes a
+    fine substitute. Latin and other glyphs, whose shapes and metrics depend on the style's fonts,
+    are still downloaded.
+
+    The glyphs are turned into signed distance fields like those of glyph PBFs, so that they're
+    laid out and drawn like downloaded ones.
+*/
+class LocalGlyphRasterizer {
+public:
+    // Returns a rasterizer drawing glyphs in the platform's font family, or none if the platform
+    // can't draw glyphs, in which case all glyphs are downloaded.
+    static std::unique_ptr<LocalGlyphRasterizer> create(const std::string& fontFamily);
+
+    virtual ~LocalGlyphRasterizer() = default;
+
+    // Whether the glyph is rasterized locally rather than downloaded.
+    static bool canRasterizeGlyph(GlyphID);
+
+    // Returns none if the font doesn't have the glyph, in which case it should be downloaded.
+    optional<Glyph> rasterizeGlyph(const FontStack&, GlyphID);
+
+protected:
+    struct DrawnGlyph {
+        // The coverage of each pixel of the glyph, from 0 to 255, with the size of the metrics
+        // and no border.
+        AlphaImage bitmap;
+        GlyphMetrics metrics;
+    };
+
+    // Draws the glyph at 24px, the size of glyph PBFs, with the metrics of glyph PBFs. The font
+    // stack may be used to pick a weight.
+    virtual optional<DrawnGlyph> drawGlyph(const FontStack&, GlyphID) = 0;
+};
+
+// The signed distance field of a glyph's coverage, with a border of Glyph::borderSize and the
+// encoding of glyph PBFs: the glyph's edge is at 191, and values change by 32 per pixel.
+AlphaImage makeGlyphSDF(const AlphaImage& coverage);
+
+} // namespace mbgl
@@ -102,7 +102,19 @@ SymbolQuads getGlyphQuads(const Shaping& shapedText,
     textOffset[0] *= oneEm;
     textOffset[1] *= oneEm;
 
+    const bool alongLine = layout.get<TextRotationAlignment>() == AlignmentType::Map && placement == SymbolPlacementType::Line;
+
+    // The rotation of the text is the same for all of its glyphs.
+    const float textRotateSin = std::sin(textRotate);
+    const float textRotateCos = std::cos(textRotate);
+    const std::array<float, 4> matrix = {{textRotateCos, -textRotateSin, textRotateSin, textRotateCos}};
+
+    // The rects have an addditional buffer that is not included in their size;
+    const float glyphPadding = 1.0f;
+    const float rectBuffer = 3.0f + glyphPadding;
+
     SymbolQuads quads;
+    quads.reserve(shapedText.positionedGlyphs.size());
 
     for (const PositionedGlyph &positionedGlyph: shapedText.positionedGlyphs) {
         auto positionsIt = positions.find(positionedGlyph.glyph);
@@ -112,12 +124,7 @@ SymbolQuads getGlyphQuads(const Shaping& shapedText,
         const GlyphPosition& glyph = positionsIt->second;
         const Rect<uint16_t>& rect = glyph.rect;
 
-        // The rects have an addditional buffer that is not included in their size;
-        const float glyphPadding = 1.0f;
-        const float rectBuffer = 3.0f + glyphPadding;
-
         const float halfAdvance = glyph.metrics.advance / 2.0;
-        const bool alongLine = layout.get<TextRotationAlignment>() == AlignmentType::Map && placement == SymbolPlacementType::Line;
 
         const Point<float> glyphOffset = alongLine ?
             Point<float>{ positionedGlyph.x + halfAdvance, positionedGlyph.y } :
@@ -141,18 +148,18 @@ SymbolQuads getGlyphQuads(const Shaping& shapedText,
         Point<float> br{x2, y2};
 
         if (positionedGlyph.angle != 0) {
-            tl = util::rotate(tl - center, positionedGlyph.angle) + center;
-            tr = util::rotate(tr - center, positionedGlyph.angle) + center;
-            bl = util::rotate(bl - center, positionedGlyph.angle) + center;
-            br = util::rotate(br - center, positionedGlyph.angle) + center;
+            // Same as util::rotate(), without computing the sine and cosine for every corner.
+            const float angleSin = std::sin(positionedGlyph.angle);
+            const float angleCos = std::cos(positionedGlyph.angle);
+            const std::array<float, 4> glyphMatrix = {{angleCos, -angleSin, angleSin, angleCos}};
+
+            tl = util::matrixMultiply(glyphMatrix, tl - center) + center;
+            tr = util::matrixMultiply(glyphMatrix, tr - center) + center;
+            bl = util::matrixMultiply(glyphMatrix, bl - center) + center;
+            br = util::matrixMultiply(glyphMatrix, br - center) + center;
         }
 
         if (textRotate) {
-            // Compute the transformation matrix.
-            float angle_sin = std::sin(textRotate);
-            float angle_cos = std::cos(textRotate);
-            std::array<float, 4> matrix = {{angle_cos, -angle_sin, angle_sin, angle_cos}};
-
             tl = util::matrixMultiply(matrix, tl);
             tr = util::matrixMultiply(matrix, tr);
             bl = util::matrixMultiply(matrix, bl);
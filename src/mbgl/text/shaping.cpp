@@ -3,6 +3,7 @@
 #include <mbgl/layout/symbol_feature.hpp>
 #include <mbgl/math/minmax.hpp>
 #include <mbgl/text/bidi.hpp>
+#include <mbgl/text/line_break_cache.hpp>
 
 #include <boost/algorithm/string.hpp>
 
@@ -316,14 +317,31 @@ const Shaping getShaping(const std::u16string& logicalInput,
                          const float verticalHeight,
                          const WritingModeType writingMode,
                          BiDi& bidi,
+                         LineBreakCache* lineBreakCache,
+                         const FontStack& fontStack,
                          const Glyphs& glyphs) {
     Shaping shaping(translate.x, translate.y, writingMode);
-    
-    std::vector<std::u16string> reorderedLines =
-    bidi.processText(logicalInput,
-                     determineLineBreaks(logicalInput, spacing, maxWidth, writingMode, glyphs));
-    
-    shapeLines(shaping, reorderedLines, spacing, lineHeight, textAnchor,
+
+    optional<LineBreakCache::Key> key;
+    optional<std::vector<std::u16string>> reorderedLines;
+    if (lineBreakCache) {
+        key = LineBreakCache::Key { logicalInput, fontStack, spacing, maxWidth, writingMode };
+        reorderedLines = lineBreakCache->get(*key);
+    }
+
+    if (!reorderedLines) {
+        reorderedLines = bidi.processText(logicalInput,
+                                          determineLineBreaks(logicalInput, spacing, maxWidth, writingMode, glyphs));
+
+        // Lines broken while glyphs are missing may change once they're loaded.
+        if (key && std::all_of(logicalInput.begin(), logicalInput.end(), [&] (char16_t chr) {
+                return glyphs.find(chr) != glyphs.end();
+            })) {
+            lineBreakCache->add(std::move(*key), *reorderedLines);
+        }
+    }
+
+    shapeLines(shaping, *reorderedLines, spacing, lineHeight, textAnchor,
                textJustify, verticalHeight, writingMode, glyphs);
     
     return shaping;
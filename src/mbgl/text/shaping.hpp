@@ -8,6 +8,7 @@ namespace mbgl {
 
 class SymbolFeature;
 class BiDi;
+class LineBreakCache;
 
 class PositionedIcon {
 private:
@@ -52,6 +53,8 @@ const Shaping getShaping(const std::u16string& string,
                          float verticalHeight,
                          const WritingModeType,
                          BiDi& bidi,
+                         LineBreakCache*,
+                         const FontStack&,
                          const Glyphs& glyphs);
 
 } // namespace mbgl
@@ -0,0 +1,97 @@
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+bool ShapingCache::Key::operator==(const Key& rhs) const {
+    return text == rhs.text &&
+        fontStack == rhs.fontStack &&
+        maxWidth == rhs.maxWidth &&
+        lineHeight == rhs.lineHeight &&
+        textAnchor == rhs.textAnchor &&
+        textJustify == rhs.textJustify &&
+        spacing == rhs.spacing &&
+        translate == rhs.translate &&
+        verticalHeight == rhs.verticalHeight &&
+        writingMode == rhs.writingMode;
+}
+
+std::size_t ShapingCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = std::hash<std::u16string>()(key.text);
+    boost::hash_combine(seed, FontStackHash()(key.fontStack));
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, key.lineHeight);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.textAnchor));
+    boost::hash_combine(seed, static_cast<uint8_t>(key.textJustify));
+    boost::hash_combine(seed, key.spacing);
+    boost::hash_combine(seed, key.translate.x);
+    boost::hash_combine(seed, key.translate.y);
+    boost::hash_combine(seed, key.verticalHeight);
+    boost::hash_combine(seed, static_cast<uint8_t>(key.writingMode));
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t capacity_)
+    : capacity(capacity_) {
+    assert(capacity > 0);
+}
+
+const Shaping* ShapingCache::get(const Key& key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    uses.splice(uses.begin(), uses, it->second.use);
+    return &it->second.shaping;
+}
+
+void ShapingCache::add(Key key, Shaping shaping) {
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        it->second.shaping = std::move(shaping);
+        uses.splice(uses.begin(), uses, it->second.use);
+        return;
+    }
+
+    it = entries.emplace(std::move(key), Entry { std::move(shaping), uses.end() }).first;
+    uses.push_front(&it->first);
+    it->second.use = uses.begin();
+
+    if (entries.size() > capacity) {
+        // Erase by iterator: the key is owned by the entry being erased.
+        const Key* oldest = uses.back();
+        uses.pop_back();
+        entries.erase(entries.find(*oldest));
+    }
+}
+
+std::size_t ShapingCache::clear() {
+    std::size_t result = 0;
+    for (const auto& entry : entries) {
+        result += sizeof(entry) + sizeof(const Key*) + 2 * sizeof(void*) +
+                  entry.first.text.capacity() * sizeof(char16_t) +
+                  entry.second.shaping.positionedGlyphs.capacity() * sizeof(PositionedGlyph);
+        for (const auto& font : entry.first.fontStack) {
+            result += font.capacity();
+        }
+    }
+    entries.clear();
+    uses.clear();
+    return result;
+}
+
+void ShapingCache::invalidate(const FontStack& fontStack) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->first.fontStack == fontStack) {
+            uses.erase(it->second.use);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/style/types.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+/*
+   A least recently used cache of getShaping() results. Labels repeat a lot within a tile, e.g.
+   along the segments of a street, and shaping them is expensive.
+
+   Shapings only depend on the metrics of the glyphs of their font stack, so the entries of a
+   font stack must be invalidated when glyphs of it are added or change.
+*/
+class ShapingCache {
+public:
+    struct Key {
+        std::u16string text;
+        FontStack fontStack;
+        float maxWidth;
+        float lineHeight;
+        style::TextAnchorType textAnchor;
+        style::TextJustifyType textJustify;
+        float spacing;
+        Point<float> translate;
+        float verticalHeight;
+        WritingModeType writingMode;
+
+        bool operator==(const Key&) const;
+    };
+
+    explicit ShapingCache(std::size_t capacity = 1024);
+
+    // Returns nullptr if there is no entry. The shaping is valid until the next call to add().
+    const Shaping* get(const Key&);
+    void add(Key, Shaping);
+
+    void invalidate(const FontStack&);
+
+    // Removes all entries, and returns the bytes they took.
+    std::size_t clear();
+
+    std::size_t size() const { return entries.size(); }
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        Shaping shaping;
+        std::list<const Key*>::iterator use;
+    };
+
+    const std::size_t capacity;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    // Keys of the entries, most recently used first.
+    std::list<const Key*> uses;
+};
+
+} // namespace mbgl
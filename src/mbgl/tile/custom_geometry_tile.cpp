@@ -0,0 +1,126 @@
+#include <mbgl/tile/custom_geometry_tile.hpp>
+#include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+namespace mbgl {
+
+using namespace style;
+
+class CustomGeometryTile::Fetcher {
+public:
+    Fetcher(ActorRef<CustomGeometryTile> parent_)
+        : parent(std::move(parent_)) {
+    }
+
+    void fetch(CanonicalTileID tileID,
+               std::shared_ptr<const CustomTileFunction> tileFunction,
+               GeoJSONOptions options,
+               std::shared_ptr<std::atomic<bool>> cancelled,
+               uint64_t fetchID) {
+        if (*cancelled) {
+            return;
+        }
+
+        mapbox::geometry::feature_collection<int16_t> features;
+        try {
+            const GeoJSON geoJSON = (*tileFunction)(tileID, *cancelled);
+            if (*cancelled) {
+                return;
+            }
+            // Clips and simplifies the features like those of a GeoJSON source, which is quick
+            // as the index holds a single tile's worth of them.
+            features = GeoJSONData::create(geoJSON, options)->getTile(tileID);
+        } catch (...) {
+            parent.invoke(&CustomGeometryTile::onFetchError, std::current_exception(), fetchID);
+            return;
+        }
+
+        parent.invoke(&CustomGeometryTile::onFetched, std::move(features), fetchID);
+    }
+
+private:
+    ActorRef<CustomGeometryTile> parent;
+};
+
+CustomGeometryTile::CustomGeometryTile(const OverscaledTileID& overscaledTileID,
+                                       std::string sourceID_,
+                                       const TileParameters& parameters,
+                                       std::shared_ptr<const CustomTileFunction> tileFunction_,
+                                       GeoJSONOptions options_)
+    : GeoJSONTile(overscaledTileID, std::move(sourceID_), parameters),
+      tileFunction(std::move(tileFunction_)),
+      options(std::move(options_)),
+      fetchMailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
+      fetcher(parameters.workerScheduler, ActorRef<CustomGeometryTile>(*this, fetchMailbox)) {
+}
+
+CustomGeometryTile::~CustomGeometryTile() {
+    cancelFetch();
+}
+
+void CustomGeometryTile::setNecessity(Necessity newNecessity) {
+    if (newNecessity == necessity) {
+        return;
+    }
+    necessity = newNecessity;
+
+    if (necessity == Necessity::Required) {
+        if (stale) {
+            fetch();
+        }
+    } else if (cancelled) {
+        // The features would only be needed if the tile was required again.
+        cancelFetch();
+        stale = true;
+    }
+}
+
+void CustomGeometryTile::setPriority(int32_t priority) {
+    GeometryTile::setPriority(priority);
+    fetcher.setPriority(priority);
+}
+
+void CustomGeometryTile::cancel() {
+    cancelFetch();
+    GeometryTile::cancel();
+}
+
+void CustomGeometryTile::invalidate() {
+    stale = true;
+    if (necessity == Necessity::Required) {
+        fetch();
+    }
+}
+
+void CustomGeometryTile::fetch() {
+    cancelFetch();
+    stale = false;
+    cancelled = std::make_shared<std::atomic<bool>>(false);
+    fetcher.invoke(&Fetcher::fetch, id.canonical, tileFunction, options, cancelled, ++fetchID);
+}
+
+void CustomGeometryTile::cancelFetch() {
+    if (cancelled) {
+        *cancelled = true;
+        cancelled.reset();
+    }
+}
+
+void CustomGeometryTile::onFetched(mapbox::geometry::feature_collection<int16_t> features, uint64_t fetchID_) {
+    if (fetchID_ != fetchID || !cancelled) {
+        return; // Superseded or cancelled.
+    }
+    cancelled.reset();
+    updateData(std::move(features));
+}
+
+void CustomGeometryTile::onFetchError(std::exception_ptr error, uint64_t fetchID_) {
+    if (fetchID_ != fetchID || !cancelled) {
+        return;
+    }
+    cancelled.reset();
+    setError(error);
+}
+
+} // namespace mbgl
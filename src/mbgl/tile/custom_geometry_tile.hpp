@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/style/sources/custom_geometry_source.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/actor/actor.hpp>
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace mbgl {
+
+class TileParameters;
+
+// A GeoJSON tile whose features are generated by the function of a CustomGeometrySource, on a
+// worker thread, once the tile is required. Tiles that are no longer required before their
+// features are ready cancel the function.
+class CustomGeometryTile : public GeoJSONTile {
+public:
+    CustomGeometryTile(const OverscaledTileID&,
+                       std::string sourceID,
+                       const TileParameters&,
+                       std::shared_ptr<const style::CustomTileFunction>,
+                       style::GeoJSONOptions);
+    ~CustomGeometryTile() override;
+
+    void setNecessity(Necessity) final;
+    void setPriority(int32_t) override;
+    void cancel() override;
+
+    // Generates the features again once the tile is required, keeping the current ones until
+    // then.
+    void invalidate();
+
+    void onFetched(mapbox::geometry::feature_collection<int16_t>, uint64_t fetchID);
+    void onFetchError(std::exception_ptr, uint64_t fetchID);
+
+private:
+    class Fetcher;
+
+    void fetch();
+    void cancelFetch();
+
+    const std::shared_ptr<const style::CustomTileFunction> tileFunction;
+    const style::GeoJSONOptions options;
+
+    Necessity necessity = Necessity::Optional;
+    // Whether the tile needs features, or newer ones than it has.
+    bool stale = true;
+
+    // The ID of the latest fetch, and its cancellation flag while it's in flight.
+    uint64_t fetchID = 0;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+
+    std::shared_ptr<Mailbox> fetchMailbox;
+    Actor<Fetcher> fetcher;
+};
+
+} // namespace mbgl
@@ -2,9 +2,11 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/util/string.hpp>
 
 #include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
 #include <supercluster.hpp>
 
 namespace mbgl {
@@ -93,6 +95,15 @@ public:
         return std::make_unique<GeoJSONTileLayer>(features);
     }
 
+    std::size_t byteSize() const override {
+        std::size_t result = features->capacity() * sizeof(mapbox::geometry::feature<int16_t>);
+        for (const auto& feature : *features) {
+            mapbox::geometry::for_each_point(feature.geometry, [&] (const auto&) {
+                result += sizeof(mapbox::geometry::point<int16_t>);
+            });
+        }
+        return result;
+    }
 
 private:
     std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>> features;
@@ -106,6 +117,12 @@ GeoJSONTile::GeoJSONTile(const OverscaledTileID& overscaledTileID,
     updateData(std::move(features));
 }
 
+GeoJSONTile::GeoJSONTile(const OverscaledTileID& overscaledTileID,
+                         std::string sourceID_,
+                         const TileParameters& parameters)
+    : GeometryTile(overscaledTileID, std::move(sourceID_), parameters) {
+}
+
 void GeoJSONTile::updateData(mapbox::geometry::feature_collection<int16_t> features) {
     setData(std::make_unique<GeoJSONTileData>(std::move(features)));
 }
@@ -113,24 +130,21 @@ void GeoJSONTile::updateData(mapbox::geometry::feature_collection<int16_t> featu
 void GeoJSONTile::setNecessity(Necessity) {}
     
 void GeoJSONTile::querySourceFeatures(
-    std::vector<Feature>& result,
-    const SourceQueryOptions& options) {
+    const GeometryCoordinates& queryGeometry,
+    const SourceQueryOptions& options,
+    const SourceFeatureCallback& callback) {
     
+    // Tiles with features that are set later on have none yet.
+    if (!getData()) {
+        return;
+    }
+
     // Ignore the sourceLayer, there is only one
     auto layer = getData()->getLayer({});
     
     if (layer) {
-        auto featureCount = layer->featureCount();
-        for (std::size_t i = 0; i < featureCount; i++) {
-            auto feature = layer->getFeature(i);
-            
-            // Apply filter, if any
-            if (options.filter && !(*options.filter)(*feature)) {
-                continue;
-            }
-            
-            result.push_back(convertFeature(*feature, id.canonical));
-        }
+        const style::CompiledFilter filter = options.filter ? style::CompiledFilter(*options.filter) : style::CompiledFilter();
+        querySourceLayer(*layer, queryGeometry, filter, callback);
     }
 }
 
@@ -16,11 +16,16 @@ public:
 
     void updateData(mapbox::geometry::feature_collection<int16_t>);
 
-    void setNecessity(Necessity) final;
+    void setNecessity(Necessity) override;
     
     void querySourceFeatures(
-        std::vector<Feature>& result,
-        const SourceQueryOptions&) override;
+        const GeometryCoordinates& queryGeometry,
+        const SourceQueryOptions&,
+        const SourceFeatureCallback&) override;
+
+protected:
+    // For tiles whose features are set later on, with updateData().
+    GeoJSONTile(const OverscaledTileID&, std::string sourceID, const TileParameters&);
 };
 
 } // namespace mbgl
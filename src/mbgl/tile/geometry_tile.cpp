@@ -10,6 +10,9 @@
 #include <mbgl/renderer/layers/render_custom_layer.hpp>
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/renderer/bucket_uploader.hpp>
+#include <mbgl/renderer/tile_upload_queue.hpp>
+#include <mbgl/renderer/tile_snapshot.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
@@ -18,11 +21,15 @@
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/util/run_loop.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/util/chrono.hpp>
+#include <mbgl/util/intersection_tests.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <mapbox/geometry/envelope.hpp>
+
 #include <iostream>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -30,18 +37,33 @@ using namespace style;
 
 GeometryTile::GeometryTile(const OverscaledTileID& id_,
                            std::string sourceID_,
-                           const TileParameters& parameters)
+                           const TileParameters& parameters,
+                           float simplificationTolerance)
     : Tile(id_),
       sourceID(std::move(sourceID_)),
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
       worker(parameters.workerScheduler,
              ActorRef<GeometryTile>(*this, mailbox),
+             parameters.workerScheduler,
              id_,
              obsolete,
+             latestLayoutID,
+             latestPlacementID,
              parameters.mode,
-             parameters.pixelRatio),
+             parameters.pixelRatio,
+             parameters.instancing,
+             parameters.lineBreakCache,
+             parameters.placementBudget,
+             simplificationTolerance,
+             parameters.layoutProfiler,
+             parameters.tileSnapshot,
+             parameters.layoutCache),
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
+      bucketUploader(parameters.bucketUploader),
+      uploadQueue(parameters.uploadQueue),
+      tileSnapshot(parameters.tileSnapshot),
+      bucketParameters { id_, parameters.mode, parameters.pixelRatio, parameters.instancing, nullptr },
       placementThrottler(Milliseconds(300), [this] { invokePlacement(); }),
       lastYStretch(1.0f) {
 }
@@ -49,7 +71,11 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
 GeometryTile::~GeometryTile() {
     glyphManager.removeRequestor(*this);
     imageManager.removeRequestor(*this);
+    unqueueUpload();
     markObsolete();
+    if (tileSnapshot) {
+        tileSnapshot->erase(sourceID, id);
+    }
 }
 
 void GeometryTile::cancel() {
@@ -63,6 +89,7 @@ void GeometryTile::markObsolete() {
 void GeometryTile::setError(std::exception_ptr err) {
     loaded = true;
     renderable = false;
+    unqueueUpload();
     observer->onTileError(*this, err);
 }
 
@@ -72,9 +99,15 @@ void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_) {
     pending = true;
 
     ++correlationID;
+    latestLayoutID = latestPlacementID = correlationID;
     worker.invoke(&GeometryTileWorker::setData, std::move(data_), correlationID);
 }
 
+void GeometryTile::setPriority(int32_t priority_) {
+    priority = priority_;
+    worker.setPriority(priority);
+}
+
 void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
     if (requestedConfig == desiredConfig) {
         return;
@@ -91,6 +124,7 @@ void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
 
 void GeometryTile::invokePlacement() {
     if (requestedConfig) {
+        latestPlacementID = correlationID;
         worker.invoke(&GeometryTileWorker::setPlacementConfig, *requestedConfig, correlationID);
     }
 }
@@ -116,36 +150,87 @@ void GeometryTile::setLayers(const std::vector<Immutable<Layer::Impl>>& layers)
         impls.push_back(layer);
     }
 
+    // Until the tile is laid out, it's drawn with the geometry of the tile snapshot, if it has any.
+    if (tileSnapshot && !loaded && nonSymbolBuckets.empty() && tileSnapshot->hasRestorableTiles()) {
+        nonSymbolBuckets = tileSnapshot->restore(sourceID, id, impls, bucketParameters);
+        if (!nonSymbolBuckets.empty()) {
+            if (bucketUploader) {
+                bucketUploader->schedule(nonSymbolBuckets);
+            }
+            setRenderable();
+        }
+    }
+
     ++correlationID;
-    worker.invoke(&GeometryTileWorker::setLayers, std::move(impls), correlationID);
+    latestLayoutID = latestPlacementID = correlationID;
+    worker.invoke(&GeometryTileWorker::setLayers, std::move(impls), imageManager.getVersion(), correlationID);
 }
 
 void GeometryTile::onLayout(LayoutResult result) {
     loaded = true;
-    renderable = true;
+    setRenderable();
     nonSymbolBuckets = std::move(result.nonSymbolBuckets);
+    if (bucketUploader) {
+        bucketUploader->schedule(nonSymbolBuckets);
+    }
     featureIndex = std::move(result.featureIndex);
     data = std::move(result.tileData);
     collisionTile.reset();
+    if (tileSnapshot) {
+        tileSnapshot->record(sourceID, id, std::move(result.serializedBuckets));
+    }
     observer->onTileChanged(*this);
 }
 
 void GeometryTile::onPlacement(PlacementResult result) {
     loaded = true;
-    renderable = true;
-    if (result.correlationID == correlationID) {
+    setRenderable();
+    if (result.correlationID == correlationID && result.complete) {
         pending = false;
     }
+
+    // Buckets that were placed again keep their buffers; only the placement zooms of their symbols
+    // change. Layers with the same layout share a bucket, which is updated once.
+    std::unordered_set<Bucket*> updated;
+    for (const auto& placement : result.symbolPlacements) {
+        auto it = symbolBuckets.find(placement.first);
+        if (it == symbolBuckets.end()) {
+            continue;
+        }
+        if (updated.insert(it->second.get()).second) {
+            static_cast<SymbolBucket&>(*it->second).applyPlacement(*placement.second);
+        }
+        result.symbolBuckets.emplace(placement.first, it->second);
+    }
+
     symbolBuckets = std::move(result.symbolBuckets);
-    collisionTile = std::move(result.collisionTile);
-    if (result.glyphAtlasImage) {
-        glyphAtlasImage = std::move(*result.glyphAtlasImage);
+    if (bucketUploader) {
+        bucketUploader->schedule(symbolBuckets);
     }
-    if (result.iconAtlasImage) {
-        iconAtlasImage = std::move(*result.iconAtlasImage);
+    // Queries use the collision tile of the last complete placement until the next one completes.
+    if (result.complete) {
+        collisionTile = std::move(result.collisionTile);
+        if (collisionTile.get()) {
+            lastYStretch = collisionTile->yStretch;
+        }
+    } else {
+        lastYStretch = result.yStretch;
     }
-    if (collisionTile.get()) {
-        lastYStretch = collisionTile->yStretch;
+    observer->onTileChanged(*this);
+}
+
+void GeometryTile::onRepaint(RepaintResult result) {
+    if (result.correlationID == correlationID && result.complete) {
+        pending = false;
+    }
+
+    // Layers with the same layout share a bucket, which is repainted once.
+    std::unordered_set<Bucket*> repainted;
+    for (auto& entry : result.paintedBuckets) {
+        auto it = nonSymbolBuckets.find(entry.first);
+        if (it != nonSymbolBuckets.end() && repainted.insert(it->second.get()).second) {
+            it->second->setPaint(std::move(entry.second));
+        }
     }
     observer->onTileChanged(*this);
 }
@@ -154,19 +239,44 @@ void GeometryTile::onError(std::exception_ptr err) {
     loaded = true;
     pending = false;
     renderable = false;
+    unqueueUpload();
     observer->onTileError(*this, err);
 }
     
-void GeometryTile::onGlyphsAvailable(GlyphMap glyphs) {
-    worker.invoke(&GeometryTileWorker::onGlyphsAvailable, std::move(glyphs));
+// A tile that wasn't renderable before waits for its first upload in the upload queue, if there
+// is one, so that its parents or children are rendered in its place meanwhile.
+void GeometryTile::setRenderable() {
+    if (!renderable && !uploadQueued && uploadQueue && uploadQueue->add(*this)) {
+        uploadQueued = true;
+    }
+    if (!uploadQueued) {
+        renderable = true;
+    }
+}
+
+void GeometryTile::unqueueUpload() {
+    if (uploadQueued) {
+        uploadQueue->remove(*this);
+        uploadQueued = false;
+    }
+}
+
+void GeometryTile::onUploaded() {
+    uploadQueued = false;
+    renderable = true;
+    observer->onTileChanged(*this);
+}
+
+void GeometryTile::onGlyphsAvailable(GlyphMap glyphs, GlyphPositions positions) {
+    worker.invoke(&GeometryTileWorker::onGlyphsAvailable, std::move(glyphs), std::move(positions));
 }
 
 void GeometryTile::getGlyphs(GlyphDependencies glyphDependencies) {
     glyphManager.getGlyphs(*this, std::move(glyphDependencies));
 }
 
-void GeometryTile::onImagesAvailable(ImageMap images) {
-    worker.invoke(&GeometryTileWorker::onImagesAvailable, std::move(images));
+void GeometryTile::onImagesAvailable(ImageMap images, ImagePositions positions) {
+    worker.invoke(&GeometryTileWorker::onImagesAvailable, std::move(images), std::move(positions));
 }
 
 void GeometryTile::getImages(ImageDependencies imageDependencies) {
@@ -174,10 +284,24 @@ void GeometryTile::getImages(ImageDependencies imageDependencies) {
 }
 
 void GeometryTile::upload(gl::Context& context) {
+    // Only frames that upload anything are traced.
+    util::trace::Span span;
+    bool traced = false;
     auto uploadFn = [&] (Bucket& bucket) {
-        if (bucket.needsUpload()) {
+        if (!traced && bucket.needsUpload()) {
+            span = util::trace::Span("upload", id.canonical);
+            traced = true;
+        }
+        if (bucketUploader) {
+            bucketUploader->upload(bucket, context);
+        } else if (bucket.needsUpload()) {
             bucket.upload(context);
         }
+        // Paint attributes are swapped in on the render thread only, once the upload thread is
+        // done with the bucket.
+        if (bucket.needsPaintUpload()) {
+            bucket.uploadPaint(context);
+        }
     };
 
     for (auto& entry : nonSymbolBuckets) {
@@ -187,16 +311,6 @@ void GeometryTile::upload(gl::Context& context) {
     for (auto& entry : symbolBuckets) {
         uploadFn(*entry.second);
     }
-
-    if (glyphAtlasImage) {
-        glyphAtlasTexture = context.createTexture(*glyphAtlasImage, 0);
-        glyphAtlasImage = {};
-    }
-
-    if (iconAtlasImage) {
-        iconAtlasTexture = context.createTexture(*iconAtlasImage, 0);
-        iconAtlasImage = {};
-    }
 }
 
 Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
@@ -210,6 +324,50 @@ Bucket* GeometryTile::getBucket(const Layer::Impl& layer) const {
     return it->second.get();
 }
 
+RendererStatistics::Memory GeometryTile::memoryUsage() const {
+    RendererStatistics::Memory result;
+    for (const auto& entry : nonSymbolBuckets) {
+        result += entry.second->memoryUsage();
+    }
+    for (const auto& entry : symbolBuckets) {
+        result += entry.second->memoryUsage();
+    }
+    if (featureIndex) {
+        result.cpu += featureIndex->byteSize();
+    }
+    if (collisionTile) {
+        result.cpu += collisionTile->byteSize();
+    }
+    if (data) {
+        result.cpu += data->byteSize();
+    }
+    return result;
+}
+
+std::size_t GeometryTile::trimMemory(const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) {
+    worker.invoke(&GeometryTileWorker::trimMemory, workerCachesFreed);
+
+    std::size_t freed = 0;
+    if (featureIndex) {
+        freed += featureIndex->compact();
+    }
+    if (data) {
+        freed += data->releaseParsed();
+    }
+    return freed;
+}
+
+std::size_t GeometryTile::uploadSize() const {
+    std::size_t result = 0;
+    for (const auto& entry : nonSymbolBuckets) {
+        result += entry.second->memoryUsage().cpu;
+    }
+    for (const auto& entry : symbolBuckets) {
+        result += entry.second->memoryUsage().cpu;
+    }
+    return result;
+}
+
 void GeometryTile::queryRenderedFeatures(
     std::unordered_map<std::string, std::vector<Feature>>& result,
     const GeometryCoordinates& queryGeometry,
@@ -232,9 +390,43 @@ void GeometryTile::queryRenderedFeatures(
                         *this);
 }
 
+static bool intersectsQueryGeometry(const GeometryTileFeature& feature,
+                                    const GeometryCoordinates& queryGeometry,
+                                    const mapbox::geometry::box<int16_t>& queryBox) {
+    const GeometryCollection geometries = feature.getGeometries();
+
+    bool overlapsBox = false;
+    for (const auto& ring : geometries) {
+        if (ring.empty()) {
+            continue;
+        }
+        const auto box = mapbox::geometry::envelope(ring);
+        if (box.min.x <= queryBox.max.x && box.max.x >= queryBox.min.x &&
+            box.min.y <= queryBox.max.y && box.max.y >= queryBox.min.y) {
+            overlapsBox = true;
+            break;
+        }
+    }
+    if (!overlapsBox) {
+        return false;
+    }
+
+    switch (feature.getType()) {
+    case FeatureType::Point:
+        return util::polygonIntersectsBufferedMultiPoint(queryGeometry, geometries, 0);
+    case FeatureType::LineString:
+        return util::polygonIntersectsBufferedMultiLine(queryGeometry, geometries, 0);
+    case FeatureType::Polygon:
+        return util::polygonIntersectsMultiPolygon(queryGeometry, geometries);
+    default:
+        return false;
+    }
+}
+
 void GeometryTile::querySourceFeatures(
-    std::vector<Feature>& result,
-    const SourceQueryOptions& options) {
+    const GeometryCoordinates& queryGeometry,
+    const SourceQueryOptions& options,
+    const SourceFeatureCallback& callback) {
 
     // Data not yet available
     if (!data) {
@@ -247,24 +439,44 @@ void GeometryTile::querySourceFeatures(
         return;
     }
 
+    const CompiledFilter filter = options.filter ? CompiledFilter(*options.filter) : CompiledFilter();
+
     for (auto sourceLayer : *options.sourceLayers) {
         // Go throught all sourceLayers, if any
         // to gather all the features
         auto layer = data->getLayer(sourceLayer);
         
         if (layer) {
-            auto featureCount = layer->featureCount();
-            for (std::size_t i = 0; i < featureCount; i++) {
-                auto feature = layer->getFeature(i);
+            querySourceLayer(*layer, queryGeometry, filter, callback);
+        }
+    }
+}
 
-                // Apply filter, if any
-                if (options.filter && !(*options.filter)(*feature)) {
-                    continue;
-                }
+// The tile's FeatureIndex only holds the features that style layers render, so the query tests the
+// geometry of every feature that passes the filter instead, after checking its box.
+void GeometryTile::querySourceLayer(const GeometryTileLayer& layer,
+                                    const GeometryCoordinates& queryGeometry,
+                                    const style::CompiledFilter& filter,
+                                    const SourceFeatureCallback& callback) const {
+    optional<mapbox::geometry::box<int16_t>> queryBox;
+    if (!queryGeometry.empty()) {
+        queryBox = mapbox::geometry::envelope(queryGeometry);
+    }
 
-                result.push_back(convertFeature(*feature, id.canonical));
-            }
+    auto featureCount = layer.featureCount();
+    for (std::size_t i = 0; i < featureCount; i++) {
+        auto feature = layer.getFeature(i);
+
+        // Apply filter, if any
+        if (!filter(*feature)) {
+            continue;
         }
+
+        if (queryBox && !intersectsQueryGeometry(*feature, queryGeometry, *queryBox)) {
+            continue;
+        }
+
+        callback(convertFeature(*feature, id.canonical));
     }
 }
 
@@ -3,6 +3,7 @@
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/text/collision_tile.hpp>
@@ -21,33 +22,49 @@ namespace mbgl {
 class GeometryTileData;
 class RenderStyle;
 class RenderLayer;
-class SourceQueryOptions;
 class TileParameters;
 class GlyphAtlas;
-class ImageAtlas;
+class BucketUploader;
+class TileUploadQueue;
+
+namespace style {
+class CompiledFilter;
+} // namespace style
+struct SymbolPlacementZooms;
 
 class GeometryTile : public Tile, public GlyphRequestor, ImageRequestor {
 public:
+    // The simplification tolerance is in pixels; see VectorSource::setSimplificationTolerance().
     GeometryTile(const OverscaledTileID&,
                  std::string sourceID,
-                 const TileParameters&);
+                 const TileParameters&,
+                 float simplificationTolerance = 0);
 
     ~GeometryTile() override;
 
     void setError(std::exception_ptr);
     void setData(std::unique_ptr<const GeometryTileData>);
 
+    void setPriority(int32_t) override;
+    int32_t getPriority() const {
+        return priority;
+    }
     void setPlacementConfig(const PlacementConfig&) override;
     void setLayers(const std::vector<Immutable<style::Layer::Impl>>&) override;
     
-    void onGlyphsAvailable(GlyphMap) override;
-    void onImagesAvailable(ImageMap) override;
+    void onGlyphsAvailable(GlyphMap, GlyphPositions) override;
+    void onImagesAvailable(ImageMap, ImagePositions) override;
     
     void getGlyphs(GlyphDependencies);
     void getImages(ImageDependencies);
 
     void upload(gl::Context&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    RendererStatistics::Memory memoryUsage() const override;
+    std::size_t trimMemory(const std::shared_ptr<std::atomic<std::size_t>>& workerCachesFreed) override;
+
+    // The bytes the tile's buckets hold on the CPU, which uploading them copies to the GPU.
+    std::size_t uploadSize() const;
 
     Size bindGlyphAtlas(gl::Context&);
     Size bindIconAtlas(gl::Context&);
@@ -60,8 +77,9 @@ public:
             const RenderedQueryOptions& options) override;
 
     void querySourceFeatures(
-        std::vector<Feature>& result,
-        const SourceQueryOptions&) override;
+        const GeometryCoordinates& queryGeometry,
+        const SourceQueryOptions&,
+        const SourceFeatureCallback&) override;
 
     void cancel() override;
 
@@ -75,11 +93,16 @@ public:
         LayoutResult(std::unordered_map<std::string, std::shared_ptr<Bucket>> nonSymbolBuckets_,
                      std::unique_ptr<FeatureIndex> featureIndex_,
                      std::unique_ptr<GeometryTileData> tileData_,
-                     uint64_t correlationID_)
+                     uint64_t correlationID_,
+                     TileSnapshot::SerializedBuckets serializedBuckets_ = {})
             : nonSymbolBuckets(std::move(nonSymbolBuckets_)),
               featureIndex(std::move(featureIndex_)),
               tileData(std::move(tileData_)),
-              correlationID(correlationID_) {}
+              correlationID(correlationID_),
+              serializedBuckets(std::move(serializedBuckets_)) {}
+
+        // The non-symbol buckets serialized for the tile snapshot, if it's recording.
+        TileSnapshot::SerializedBuckets serializedBuckets;
     };
     void onLayout(LayoutResult);
 
@@ -87,24 +110,43 @@ public:
     public:
         std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
         std::unique_ptr<CollisionTile> collisionTile;
-        optional<AlphaImage> glyphAtlasImage;
-        optional<PremultipliedImage> iconAtlasImage;
         uint64_t correlationID;
+        // New placements of the symbol buckets the tile has already, by layer, instead of new buckets.
+        std::unordered_map<std::string, std::shared_ptr<const SymbolPlacementZooms>> symbolPlacements;
+        // False for the results of a placement with a budget that places more symbols later on.
+        // These come without a collision tile, and with the yStretch of the one they're placed in.
+        bool complete;
+        float yStretch;
 
         PlacementResult(std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets_,
                         std::unique_ptr<CollisionTile> collisionTile_,
-                        optional<AlphaImage> glyphAtlasImage_,
-                        optional<PremultipliedImage> iconAtlasImage_,
-                        uint64_t correlationID_)
+                        uint64_t correlationID_,
+                        std::unordered_map<std::string, std::shared_ptr<const SymbolPlacementZooms>> symbolPlacements_ = {},
+                        bool complete_ = true,
+                        float yStretch_ = 1.0f)
             : symbolBuckets(std::move(symbolBuckets_)),
               collisionTile(std::move(collisionTile_)),
-              glyphAtlasImage(std::move(glyphAtlasImage_)),
-              iconAtlasImage(std::move(iconAtlasImage_)),
-              correlationID(correlationID_) {}
+              correlationID(correlationID_),
+              symbolPlacements(std::move(symbolPlacements_)),
+              complete(complete_),
+              yStretch(yStretch_) {}
     };
     void onPlacement(PlacementResult);
 
+    class RepaintResult {
+    public:
+        // Buckets with just the paint attributes of the tile's equivalent non-symbol buckets, by layer.
+        std::unordered_map<std::string, std::shared_ptr<Bucket>> paintedBuckets;
+        uint64_t correlationID;
+        // False if the repaint is followed by a placement.
+        bool complete;
+    };
+    void onRepaint(RepaintResult);
+
     void onError(std::exception_ptr);
+
+    // Called by the TileUploadQueue once the tile was first uploaded.
+    void onUploaded();
     
     float yStretch() const override;
     
@@ -113,8 +155,16 @@ protected:
         return data.get();
     }
 
+    // Finds the features of a layer of the tile's data for querySourceFeatures().
+    void querySourceLayer(const GeometryTileLayer&,
+                          const GeometryCoordinates& queryGeometry,
+                          const style::CompiledFilter&,
+                          const SourceFeatureCallback&) const;
+
 private:
     void markObsolete();
+    void setRenderable();
+    void unqueueUpload();
     void invokePlacement();
 
     const std::string sourceID;
@@ -122,11 +172,25 @@ private:
     // Used to signal the worker that it should abandon parsing this tile as soon as possible.
     std::atomic<bool> obsolete { false };
 
+    // Correlation IDs of the most recently sent messages that will cause the worker to redo
+    // layout or placement, respectively. The worker compares them with the ID of the work it's
+    // doing to abandon layouts and placements that have already been superseded.
+    std::atomic<uint64_t> latestLayoutID { 0 };
+    std::atomic<uint64_t> latestPlacementID { 0 };
+
     std::shared_ptr<Mailbox> mailbox;
     Actor<GeometryTileWorker> worker;
 
     GlyphManager& glyphManager;
     ImageManager& imageManager;
+    BucketUploader* const bucketUploader;
+    TileUploadQueue* const uploadQueue;
+    TileSnapshot* const tileSnapshot;
+    // The parameters of the buckets restored from the tile snapshot.
+    const BucketParameters bucketParameters;
+
+    int32_t priority = 0;
+    bool uploadQueued = false;
 
     uint64_t correlationID = 0;
     optional<PlacementConfig> requestedConfig;
@@ -135,18 +199,12 @@ private:
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unique_ptr<const GeometryTileData> data;
 
-    optional<AlphaImage> glyphAtlasImage;
-    optional<PremultipliedImage> iconAtlasImage;
 
     std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
     std::unique_ptr<CollisionTile> collisionTile;
     
     util::Throttler placementThrottler;
     float lastYStretch;
-
-public:
-    optional<gl::Texture> glyphAtlasTexture;
-    optional<gl::Texture> iconAtlasTexture;
 };
 
 } // namespace mbgl
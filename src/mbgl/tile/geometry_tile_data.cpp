@@ -3,6 +3,9 @@
 
 #include <mapbox/geometry/wagyu/wagyu.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 namespace mbgl {
 
 static double signedArea(const GeometryCoordinates& ring) {
@@ -36,9 +39,71 @@ static GeometryCollection toGeometryCollection(MultiPolygon<int16_t>&& multipoly
     return result;
 }
 
+static std::atomic<uint64_t> checkedPolygons { 0 };
+static std::atomic<uint64_t> fixedPolygons { 0 };
+
+// Checks winding and closure in a single pass over the rings. Exterior rings have a positive
+// signed area. An exterior ring within the bounds of the one before it is most likely a hole
+// that is wound the wrong way.
+static bool isWellFormedPolygon(const GeometryCollection& rings) {
+    struct Bounds {
+        int16_t minX, minY, maxX, maxY;
+        bool within(const Bounds& o) const {
+            return minX >= o.minX && minY >= o.minY && maxX <= o.maxX && maxY <= o.maxY;
+        }
+    };
+
+    bool hasExterior = false;
+    Bounds exterior {};
+
+    for (const auto& ring : rings) {
+        if (ring.size() < 4 || ring.front() != ring.back()) {
+            return false;
+        }
+
+        double area = 0;
+        Bounds bounds { ring[0].x, ring[0].y, ring[0].x, ring[0].y };
+        for (std::size_t i = 0, len = ring.size(), j = len - 1; i < len; j = i++) {
+            const GeometryCoordinate& p1 = ring[i];
+            const GeometryCoordinate& p2 = ring[j];
+            area += double(p2.x - p1.x) * (p1.y + p2.y);
+            bounds.minX = std::min(bounds.minX, p1.x);
+            bounds.minY = std::min(bounds.minY, p1.y);
+            bounds.maxX = std::max(bounds.maxX, p1.x);
+            bounds.maxY = std::max(bounds.maxY, p1.y);
+        }
+
+        if (area > 0) {
+            if (hasExterior && bounds.within(exterior)) {
+                return false;
+            }
+            hasExterior = true;
+            exterior = bounds;
+        } else if (area < 0) {
+            if (!hasExterior || !bounds.within(exterior)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+PolygonFixupCounts getPolygonFixupCounts() {
+    return { checkedPolygons, fixedPolygons };
+}
+
 GeometryCollection fixupPolygons(const GeometryCollection& rings) {
     using namespace mapbox::geometry::wagyu;
 
+    checkedPolygons++;
+    if (isWellFormedPolygon(rings)) {
+        return rings;
+    }
+    fixedPolygons++;
+
     wagyu<int32_t> clipper;
 
     for (const auto& ring : rings) {
@@ -53,38 +118,64 @@ GeometryCollection fixupPolygons(const GeometryCollection& rings) {
 
 std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
     std::vector<GeometryCollection> polygons;
+    classifyRings(rings, polygons);
+    return polygons;
+}
 
-    std::size_t len = rings.size();
+void classifyRings(const GeometryCollection& rings, std::vector<GeometryCollection>& polygons) {
+    std::size_t polygonCount = 0;
+    std::size_t ringCount = 0;
 
-    if (len <= 1) {
-        polygons.push_back(rings);
-        return polygons;
-    }
+    auto addPolygon = [&] {
+        if (polygonCount > 0) {
+            polygons[polygonCount - 1].resize(ringCount);
+        }
+        if (polygonCount == polygons.size()) {
+            polygons.emplace_back();
+        }
+        polygonCount++;
+        ringCount = 0;
+    };
 
-    GeometryCollection polygon;
-    int8_t ccw = 0;
+    // Copy assignment reuses the storage of the ring that was there before.
+    auto addRing = [&] (const GeometryCoordinates& ring) {
+        GeometryCollection& polygon = polygons[polygonCount - 1];
+        if (ringCount < polygon.size()) {
+            polygon[ringCount] = ring;
+        } else {
+            polygon.push_back(ring);
+        }
+        ringCount++;
+    };
 
-    for (std::size_t i = 0; i < len; i++) {
-        double area = signedArea(rings[i]);
+    if (rings.size() <= 1) {
+        addPolygon();
+        for (const auto& ring : rings) {
+            addRing(ring);
+        }
+    } else {
+        int8_t ccw = 0;
 
-        if (area == 0)
-            continue;
+        for (const auto& ring : rings) {
+            double area = signedArea(ring);
 
-        if (ccw == 0)
-            ccw = (area < 0 ? -1 : 1);
+            if (area == 0)
+                continue;
 
-        if (ccw == (area < 0 ? -1 : 1) && !polygon.empty()) {
-            polygons.push_back(polygon);
-            polygon.clear();
-        }
+            if (ccw == 0)
+                ccw = (area < 0 ? -1 : 1);
 
-        polygon.push_back(rings[i]);
-    }
+            if (ccw == (area < 0 ? -1 : 1))
+                addPolygon();
 
-    if (!polygon.empty())
-        polygons.push_back(polygon);
+            addRing(ring);
+        }
+    }
 
-    return polygons;
+    if (polygonCount > 0) {
+        polygons[polygonCount - 1].resize(ringCount);
+    }
+    polygons.resize(polygonCount);
 }
 
 void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
@@ -99,6 +190,90 @@ void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
     }
 }
 
+// The squared distance of p from the segment ab.
+static double sqSegmentDistance(const GeometryCoordinate& p, const GeometryCoordinate& a, const GeometryCoordinate& b) {
+    double x = a.x;
+    double y = a.y;
+    double dx = b.x - x;
+    double dy = b.y - y;
+
+    if (dx != 0 || dy != 0) {
+        const double t = ((p.x - x) * dx + (p.y - y) * dy) / (dx * dx + dy * dy);
+        if (t > 1) {
+            x = b.x;
+            y = b.y;
+        } else if (t > 0) {
+            x += dx * t;
+            y += dy * t;
+        }
+    }
+
+    dx = p.x - x;
+    dy = p.y - y;
+    return dx * dx + dy * dy;
+}
+
+void simplifyGeometries(GeometryCollection& geometries, FeatureType type, double tolerance) {
+    if (tolerance <= 0 || (type != FeatureType::LineString && type != FeatureType::Polygon)) {
+        return;
+    }
+
+    const double sqTolerance = tolerance * tolerance;
+    // Closed rings repeat their first point.
+    const std::size_t minPoints = type == FeatureType::Polygon ? 4 : 2;
+
+    std::vector<bool> keep;
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+    for (auto& line : geometries) {
+        const std::size_t n = line.size();
+        if (n <= minPoints) {
+            continue;
+        }
+
+        keep.assign(n, false);
+        keep.front() = keep.back() = true;
+        std::size_t kept = 2;
+
+        ranges.clear();
+        ranges.emplace_back(0, n - 1);
+        while (!ranges.empty()) {
+            const std::size_t first = ranges.back().first;
+            const std::size_t last = ranges.back().second;
+            ranges.pop_back();
+
+            double maxSqDistance = 0;
+            std::size_t index = 0;
+            for (std::size_t i = first + 1; i < last; i++) {
+                const double sqDistance = sqSegmentDistance(line[i], line[first], line[last]);
+                if (sqDistance > maxSqDistance) {
+                    maxSqDistance = sqDistance;
+                    index = i;
+                }
+            }
+
+            if (maxSqDistance > sqTolerance) {
+                keep[index] = true;
+                kept++;
+                ranges.emplace_back(first, index);
+                ranges.emplace_back(index, last);
+            }
+        }
+
+        if (kept == n || kept < minPoints) {
+            continue;
+        }
+
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            if (keep[i]) {
+                line[j++] = line[i];
+            }
+        }
+        line.resize(j);
+    }
+}
+
 static Feature::geometry_type convertGeometry(const GeometryTileFeature& geometryTileFeature, const CanonicalTileID& tileID) {
     const double size = util::EXTENT * std::pow(2, tileID.z);
     const double x0 = util::EXTENT * tileID.x;
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
@@ -45,6 +46,10 @@ public:
     virtual PropertyMap getProperties() const { return PropertyMap(); }
     virtual optional<FeatureIdentifier> getID() const { return {}; }
     virtual GeometryCollection getGeometries() const = 0;
+
+    // The geometries, if the tile data keeps them decoded for all tiles it is shared by, or
+    // nullptr. Unlike getGeometries(), this doesn't copy them.
+    virtual const GeometryCollection* getSharedGeometries() const { return nullptr; }
 };
 
 class GeometryTileLayer {
@@ -67,21 +72,56 @@ public:
     // Returns the layer with the given name. The returned layer object *may* outlive the data
     // object.
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
+
+    // Memory held by the data, in bytes. Copies that share their data each count all of it.
+    virtual std::size_t byteSize() const { return 0; }
+
+    // Drops what has been parsed of the data and isn't in use, which is parsed again when it's
+    // accessed next, and returns the bytes freed.
+    virtual std::size_t releaseParsed() const { return 0; }
+
+    // Like releaseParsed(), but keeps the layers the current style uses, so that laying the tile
+    // out again doesn't parse them again.
+    virtual std::size_t releaseUnusedLayers(const std::unordered_set<std::string>&) const { return 0; }
+
+    // A hash of the encoded tile the data was decoded from, for caches of what's made of it.
+    // Data that isn't decoded from an encoded tile has none.
+    virtual optional<std::size_t> contentHash() const { return {}; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
 std::vector<GeometryCollection> classifyRings(const GeometryCollection&);
 
+// Same as above, into `polygons`. The rings and polygons it had are overwritten rather than
+// reallocated, so that reusing it for many features doesn't allocate for every one of them.
+void classifyRings(const GeometryCollection&, std::vector<GeometryCollection>& polygons);
+
 // Truncate polygon to the largest `maxHoles` inner rings by area.
 void limitHoles(GeometryCollection&, uint32_t maxHoles);
 
+// Simplify the lines or polygon rings of a feature with the Douglas-Peucker algorithm, dropping
+// points closer than `tolerance` (in tile units) to the simplified line. Rings that would
+// collapse are left as they are. Points are never simplified.
+void simplifyGeometries(GeometryCollection&, FeatureType, double tolerance);
+
 // convert from GeometryTileFeature to Feature (eventually we should eliminate GeometryTileFeature)
 Feature convertFeature(const GeometryTileFeature&, const CanonicalTileID&);
 
 // Fix up possibly-non-V2-compliant polygon geometry using angus clipper.
 // The result is guaranteed to have correctly wound, strictly simple rings.
+//
+// Geometry whose rings are closed and wound like V2 geometry, with every hole within the bounds
+// of the exterior ring before it, is returned as is. Self-intersecting rings aren't detected in
+// that case.
 GeometryCollection fixupPolygons(const GeometryCollection&);
 
+// How many polygons fixupPolygons() has been called with, and how many of them it had to fix.
+struct PolygonFixupCounts {
+    uint64_t polygons;
+    uint64_t fixed;
+};
+PolygonFixupCounts getPolygonFixupCounts();
+
 struct ToGeometryCollection {
     GeometryCollection operator()(const mapbox::geometry::point<int16_t>& geom) const {
         return { { geom } };
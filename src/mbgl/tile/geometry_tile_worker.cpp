@@ -3,10 +3,11 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/layout/layout_profiler.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/renderer/group_by_layout.hpp>
 #include <mbgl/style/filter.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
@@ -14,7 +15,14 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/parallel.hpp>
+#include <mbgl/util/trace.hpp>
 
+#include <mapbox/geometry/envelope.hpp>
+#include <protozero/pbf_reader.hpp>
+
+#include <algorithm>
+#include <mutex>
 #include <unordered_set>
 
 namespace mbgl {
@@ -23,16 +31,36 @@ using namespace style;
 
 GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
+                                       Scheduler& scheduler_,
                                        OverscaledTileID id_,
                                        const std::atomic<bool>& obsolete_,
+                                       const std::atomic<uint64_t>& latestLayoutID_,
+                                       const std::atomic<uint64_t>& latestPlacementID_,
                                        const MapMode mode_,
-                                       const float pixelRatio_)
+                                       const float pixelRatio_,
+                                       const bool instancing_,
+                                       LineBreakCache* lineBreakCache_,
+                                       uint32_t placementBudget_,
+                                       float simplificationTolerance_,
+                                       LayoutProfiler* layoutProfiler_,
+                                       const TileSnapshot* tileSnapshot_,
+                                       LayoutCache* layoutCache_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
+      scheduler(scheduler_),
       id(std::move(id_)),
       obsolete(obsolete_),
+      latestLayoutID(latestLayoutID_),
+      latestPlacementID(latestPlacementID_),
       mode(mode_),
-      pixelRatio(pixelRatio_) {
+      pixelRatio(pixelRatio_),
+      instancing(instancing_),
+      lineBreakCache(lineBreakCache_),
+      placementBudget(placementBudget_),
+      simplificationTolerance(double(simplificationTolerance_) * util::EXTENT / (util::tileSize * id.overscaleFactor())),
+      layoutProfiler(layoutProfiler_),
+      tileSnapshot(tileSnapshot_),
+      layoutCache(layoutCache_) {
 }
 
 GeometryTileWorker::~GeometryTileWorker() = default;
@@ -70,10 +98,35 @@ GeometryTileWorker::~GeometryTileWorker() = default;
    since it will trigger placement when complete), or return to the [idle] state if not.
 */
 
+void GeometryTileWorker::trimMemory(std::shared_ptr<std::atomic<std::size_t>> freed) {
+    std::size_t bytes = shapingCache.clear() + tessellationCache.clear();
+
+    // The buckets are shared with the tile; only the feature index entries and serialized
+    // buckets kept for reusing them are the worker's own.
+    if (laidOut) {
+        for (const auto& entry : laidOut->indexedRings) {
+            if (entry.second.use_count() == 1) {
+                bytes += entry.second->capacity() * sizeof(LaidOut::IndexedRings::value_type);
+            }
+        }
+        for (const auto& entry : laidOut->serialized) {
+            if (entry.second.use_count() == 1) {
+                bytes += entry.second->data.capacity() + entry.second->layoutKey.capacity();
+            }
+        }
+        laidOut = {};
+    }
+
+    *freed += bytes;
+}
+
 void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_, uint64_t correlationID_) {
     try {
         data = std::move(data_);
+        dataHash = {};
         correlationID = correlationID_;
+        tessellationCache.clear();
+        laidOut = {};
 
         switch (state) {
         case Idle:
@@ -92,9 +145,10 @@ void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
     }
 }
 
-void GeometryTileWorker::setLayers(std::vector<Immutable<Layer::Impl>> layers_, uint64_t correlationID_) {
+void GeometryTileWorker::setLayers(std::vector<Immutable<Layer::Impl>> layers_, uint64_t imagesVersion_, uint64_t correlationID_) {
     try {
         layers = std::move(layers_);
+        imagesVersion = imagesVersion_;
         correlationID = correlationID_;
 
         switch (state) {
@@ -120,6 +174,7 @@ void GeometryTileWorker::setPlacementConfig(PlacementConfig placementConfig_, ui
     try {
         placementConfig = std::move(placementConfig_);
         correlationID = correlationID_;
+        partialPlacement = {};
 
         switch (state) {
         case Idle:
@@ -173,7 +228,12 @@ void GeometryTileWorker::coalesced() {
             break;
 
         case Coalescing:
-            state = Idle;
+            if (partialPlacement) {
+                attemptPlacement();
+                coalesce();
+            } else {
+                state = Idle;
+            }
             break;
 
         case NeedLayout:
@@ -196,28 +256,42 @@ void GeometryTileWorker::coalesce() {
     self.invoke(&GeometryTileWorker::coalesced);
 }
 
-void GeometryTileWorker::onGlyphsAvailable(GlyphMap newGlyphMap) {
+void GeometryTileWorker::onGlyphsAvailable(GlyphMap newGlyphMap, GlyphPositions newGlyphPositions) {
     for (auto& newFontGlyphs : newGlyphMap) {
         const FontStack& fontStack = newFontGlyphs.first;
         Glyphs& newGlyphs = newFontGlyphs.second;
 
         Glyphs& glyphs = glyphMap[fontStack];
+        GlyphPositionMap& positions = glyphPositions[fontStack];
+        const GlyphPositionMap& newPositions = newGlyphPositions[fontStack];
         GlyphIDs& pendingGlyphIDs = pendingGlyphDependencies[fontStack];
 
+        bool added = false;
         for (auto& newGlyph : newGlyphs) {
             const GlyphID& glyphID = newGlyph.first;
             optional<Immutable<Glyph>>& glyph = newGlyph.second;
 
             if (pendingGlyphIDs.erase(glyphID)) {
                 glyphs.emplace(glyphID, std::move(glyph));
+                auto position = newPositions.find(glyphID);
+                if (position != newPositions.end()) {
+                    positions.emplace(*position);
+                }
+                added = true;
             }
         }
+
+        // Shapings of this font stack may have been made without the added glyphs.
+        if (added) {
+            shapingCache.invalidate(fontStack);
+        }
     }
     symbolDependenciesChanged();
 }
 
-void GeometryTileWorker::onImagesAvailable(ImageMap newImageMap) {
+void GeometryTileWorker::onImagesAvailable(ImageMap newImageMap, ImagePositions newImagePositions) {
     imageMap = std::move(newImageMap);
+    imagePositions = std::move(newImagePositions);
     pendingImageDependencies.clear();
     symbolDependenciesChanged();
 }
@@ -243,29 +317,55 @@ void GeometryTileWorker::requestNewImages(const ImageDependencies& imageDependen
     }
 }
 
-static std::vector<std::unique_ptr<RenderLayer>> toRenderLayers(const std::vector<Immutable<style::Layer::Impl>>& layers, float zoom) {
-    std::vector<std::unique_ptr<RenderLayer>> renderLayers;
-    renderLayers.reserve(layers.size());
-    for (auto& layer : layers) {
-        renderLayers.push_back(RenderLayer::create(layer));
+namespace {
 
-        renderLayers.back()->transition(TransitionParameters {
-            Clock::time_point::max(),
-            TransitionOptions()
-        });
+RendererStatistics::LayerLayout layerCost(const std::string& layer, const OverscaledTileID& id) {
+    RendererStatistics::LayerLayout cost;
+    cost.layer = layer;
+    cost.zoom = id.overscaledZ;
+    return cost;
+}
 
-        renderLayers.back()->evaluate(PropertyEvaluationParameters {
-            zoom
-        });
-    }
-    return renderLayers;
+GeometryCollection decodeGeometries(const GeometryTileFeature& feature, double simplificationTolerance) {
+    GeometryCollection geometries = feature.getGeometries();
+    simplifyGeometries(geometries, feature.getType(), simplificationTolerance);
+    return geometries;
 }
 
+// The decoded geometries of the features of a source layer that several bucket jobs use. Each
+// feature is decoded by the first job that needs it, and reused by the others.
+class SharedGeometries {
+public:
+    SharedGeometries(std::size_t featureCount, double simplificationTolerance_)
+        : geometries(featureCount), decoded(featureCount), simplificationTolerance(simplificationTolerance_) {}
+
+    const GeometryCollection& get(std::size_t i, const GeometryTileFeature& feature) {
+        std::call_once(decoded[i], [&] { geometries[i] = decodeGeometries(feature, simplificationTolerance); });
+        return geometries[i];
+    }
+
+private:
+    std::vector<GeometryCollection> geometries;
+    std::vector<std::once_flag> decoded;
+    const double simplificationTolerance;
+};
+
+} // namespace
+
 void GeometryTileWorker::redoLayout() {
+    if (repaint()) {
+        return;
+    }
+
+    partialPlacement = {};
+
     if (!data || !layers) {
         return;
     }
 
+    // Features are decoded from the tile data as they're laid out, so this includes parsing them.
+    const util::trace::Span span("layout", id.canonical);
+
     std::vector<std::string> symbolOrder;
     for (auto it = layers->rbegin(); it != layers->rend(); it++) {
         if ((*it)->type == LayerType::Symbol) {
@@ -276,17 +376,91 @@ void GeometryTileWorker::redoLayout() {
     std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
     std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
     auto featureIndex = std::make_unique<FeatureIndex>();
-    BucketParameters parameters { id, mode, pixelRatio };
+    BucketParameters parameters { id, mode, pixelRatio, instancing, &tessellationCache };
 
     GlyphDependencies glyphDependencies;
     ImageDependencies imageDependencies;
 
     // Create render layers and group by layout
-    std::vector<std::unique_ptr<RenderLayer>> renderLayers = toRenderLayers(*layers, id.overscaledZ);
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers = RenderLayer::createForLayout(*layers, id.overscaledZ);
     std::vector<std::vector<const RenderLayer*>> groups = groupByLayout(renderLayers);
 
+    // Non-symbol buckets don't depend on each other, so they're collected here and built in
+    // parallel once all groups have been visited. Symbol layouts are created right away.
+    struct BucketJob {
+        const std::vector<const RenderLayer*>& group;
+        std::unique_ptr<GeometryTileLayer> geometryLayer;
+        std::shared_ptr<Bucket> bucket;
+        // Set if other jobs use the same source layer.
+        std::shared_ptr<SharedGeometries> sharedGeometries;
+
+        // Feature index entries, inserted in group order afterwards to keep query results stable.
+        std::shared_ptr<const LaidOut::IndexedRings> indexedRings;
+
+        // Whether the bucket is that of the latest layout, which none of the group's layers changed.
+        bool reused;
+
+        // Set while the tile snapshot is recording, or the layout cache is enabled.
+        std::shared_ptr<const TileSnapshot::SerializedBucket> serialized;
+
+        // The layout cache's key for the bucket, and the layout it had, if any.
+        optional<LayoutCache::Key> cacheKey;
+        optional<LayoutCache::Layout> cachedLayout;
+    };
+    std::vector<BucketJob> bucketJobs;
+
+    // The number of layers that shared each bucket of the latest layout.
+    std::unordered_map<const Bucket*, std::size_t> laidOutGroupSizes;
+    std::unordered_map<std::string, const Layer::Impl*> laidOutLayers;
+    if (laidOut) {
+        for (const auto& entry : laidOut->buckets) {
+            laidOutGroupSizes[entry.second.get()]++;
+        }
+        for (const auto& layer : laidOut->layers) {
+            laidOutLayers.emplace(layer->id, layer.get());
+        }
+    }
+
+    // A bucket of the latest layout can be reused if it was made for exactly the layers of the
+    // group, and none of them changed since.
+    auto reusableBucket = [&] (const std::vector<const RenderLayer*>& group) -> std::shared_ptr<Bucket> {
+        if (!laidOut || !laidOut->indexedRings.count(group.at(0)->getID())) {
+            return nullptr;
+        }
+        auto laidOutBucket = laidOut->buckets.find(group.at(0)->getID());
+        if (laidOutBucket == laidOut->buckets.end() ||
+            laidOutGroupSizes[laidOutBucket->second.get()] != group.size()) {
+            return nullptr;
+        }
+        for (const auto& layer : group) {
+            auto bucket = laidOut->buckets.find(layer->getID());
+            auto impl = laidOutLayers.find(layer->getID());
+            if (bucket == laidOut->buckets.end() || bucket->second != laidOutBucket->second ||
+                impl == laidOutLayers.end() || impl->second != layer->baseImpl.get()) {
+                return nullptr;
+            }
+        }
+        return laidOutBucket->second;
+    };
+
+    // The layout cache is only used for data that has a content hash.
+    if (caching() && *data && !dataHash) {
+        dataHash = (*data)->contentHash();
+    }
+    auto cacheKey = [&] (const std::vector<const RenderLayer*>& group) -> optional<LayoutCache::Key> {
+        if (!caching() || !dataHash || !*dataHash) {
+            return {};
+        }
+        LayoutCache::Key key { id, **dataHash, group.at(0)->baseImpl->layoutKey().value, {},
+                               instancing, simplificationTolerance };
+        for (const auto& layer : group) {
+            key.layerIDs.push_back(layer->getID());
+        }
+        return key;
+    };
+
     for (auto& group : groups) {
-        if (obsolete) {
+        if (layoutCancelled()) {
             return;
         }
 
@@ -309,34 +483,159 @@ void GeometryTileWorker::redoLayout() {
         featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
 
         if (leader.is<RenderSymbolLayer>()) {
+            const TimePoint start = profiling() ? Clock::now() : TimePoint();
             auto layout = leader.as<RenderSymbolLayer>()->createLayout(
-                parameters, group, std::move(geometryLayer), glyphDependencies, imageDependencies);
+                parameters, group, std::move(geometryLayer), glyphDependencies, imageDependencies, *featureIndex);
+            if (profiling()) {
+                RendererStatistics::LayerLayout cost = layerCost(leader.getID(), id);
+                cost.tiles = 1;
+                cost.layoutTime = Clock::now() - start;
+                cost.features = layout->getFeatureCount();
+                layoutProfiler->add(cost);
+            }
             symbolLayoutMap.emplace(leader.getID(), std::move(layout));
-            symbolLayoutsNeedPreparation = true;
+        } else if (auto bucket = reusableBucket(group)) {
+            auto serialized = laidOut->serialized.find(leader.getID());
+            bucketJobs.push_back({ group, nullptr, std::move(bucket), nullptr,
+                                   laidOut->indexedRings.at(leader.getID()), true,
+                                   serialized != laidOut->serialized.end() ? serialized->second : nullptr,
+                                   {}, {} });
         } else {
-            const Filter& filter = leader.baseImpl->filter;
-            const std::string& sourceLayerID = leader.baseImpl->sourceLayer;
-            std::shared_ptr<Bucket> bucket = leader.createBucket(parameters, group);
+            auto key = cacheKey(group);
+            auto cachedLayout = key ? layoutCache->get(*key) : optional<LayoutCache::Layout>();
+            bucketJobs.push_back({ group, std::move(geometryLayer), nullptr, nullptr, nullptr, false, nullptr,
+                                   std::move(key), std::move(cachedLayout) });
+        }
+    }
 
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+    // Styles often draw a source layer with many layers of different layouts, which would decode
+    // the same geometries once each.
+    std::unordered_map<std::string, std::vector<BucketJob*>> jobsBySourceLayer;
+    for (auto& job : bucketJobs) {
+        if (!job.reused && !job.cachedLayout) {
+            jobsBySourceLayer[job.group.at(0)->baseImpl->sourceLayer].push_back(&job);
+        }
+    }
+    for (auto& entry : jobsBySourceLayer) {
+        if (entry.second.size() > 1) {
+            auto shared = std::make_shared<SharedGeometries>(entry.second.front()->geometryLayer->featureCount(), simplificationTolerance);
+            for (BucketJob* job : entry.second) {
+                job->sharedGeometries = shared;
+            }
+        }
+    }
 
-                if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
-                    continue;
+    util::parallelFor(scheduler, bucketJobs.size(), [&] (std::size_t j) {
+        BucketJob& job = bucketJobs[j];
+        if (job.reused) {
+            return;
+        }
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries);
-                featureIndex->insert(geometries, i, sourceLayerID, leader.getID());
+        const RenderLayer& leader = *job.group.at(0);
+
+        // Copying a cached bucket only fails if it doesn't fit the bucket, in which case the
+        // bucket is laid out as usual.
+        if (job.cachedLayout) {
+            job.bucket = leader.createBucket(parameters, job.group);
+            protozero::pbf_reader pbf(job.cachedLayout->bucket->data);
+            if (job.bucket->deserialize(pbf)) {
+                job.indexedRings = job.cachedLayout->indexedRings;
+                job.serialized = job.cachedLayout->bucket;
+                return;
             }
+            job.cacheKey = {};
+        }
+
+        const CompiledFilter& filter = leader.baseImpl->compiledFilter;
+        const TimePoint start = profiling() ? Clock::now() : TimePoint();
+        job.bucket = leader.createBucket(parameters, job.group);
+        auto indexedRings = std::make_shared<LaidOut::IndexedRings>();
+
+        for (std::size_t i = 0; !layoutCancelled() && i < job.geometryLayer->featureCount(); i++) {
+            std::unique_ptr<GeometryTileFeature> feature = job.geometryLayer->getFeature(i);
 
-            if (!bucket->hasData()) {
+            if (!filter(*feature))
                 continue;
-            }
 
-            for (const auto& layer : group) {
-                buckets.emplace(layer->getID(), bucket);
+            // Geometries kept by the tile data are used as they are unless they need simplifying.
+            const GeometryCollection* shared = simplificationTolerance > 0 ? nullptr : feature->getSharedGeometries();
+            GeometryCollection decoded;
+            if (!shared && !job.sharedGeometries) {
+                decoded = decodeGeometries(*feature, simplificationTolerance);
+            }
+            const GeometryCollection& geometries = shared ? *shared
+                : job.sharedGeometries ? job.sharedGeometries->get(i, *feature) : decoded;
+            job.bucket->addFeature(*feature, geometries, i);
+            for (const auto& ring : geometries) {
+                indexedRings->emplace_back(i, mapbox::geometry::envelope(ring));
             }
         }
+        job.indexedRings = std::move(indexedRings);
+
+        if (profiling() && !layoutCancelled()) {
+            RendererStatistics::LayerLayout cost = layerCost(leader.getID(), id);
+            cost.tiles = 1;
+            cost.layoutTime = Clock::now() - start;
+            cost.features = job.bucket->getFeatureCount();
+            cost.vertices = job.bucket->getVertexCount();
+            cost.bytes = job.bucket->byteSize();
+            layoutProfiler->add(cost);
+        }
+
+        if (layoutCancelled()) {
+            return;
+        }
+        // Empty buckets are cached too: laying them out still goes through all features.
+        if ((recording() && job.bucket->hasData()) || job.cacheKey) {
+            job.serialized = TileSnapshot::serialize(*job.bucket, job.group);
+        }
+        if (job.serialized && job.cacheKey) {
+            layoutCache->add(std::move(*job.cacheKey), { job.serialized, job.indexedRings });
+        }
+    });
+
+    if (layoutCancelled()) {
+        return;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<const LaidOut::IndexedRings>> indexedRings;
+    std::unordered_map<std::string, std::shared_ptr<const TileSnapshot::SerializedBucket>> serialized;
+    TileSnapshot::SerializedBuckets serializedBuckets;
+    for (auto& job : bucketJobs) {
+        const RenderLayer& leader = *job.group.at(0);
+        const std::string& sourceLayerID = leader.baseImpl->sourceLayer;
+
+        for (const auto& ring : *job.indexedRings) {
+            featureIndex->insert(ring.second, ring.first, sourceLayerID, leader.getID());
+        }
+
+        // Reused buckets only came from the latest layout because they had data; the renderer may be
+        // uploading them meanwhile.
+        if (!job.reused && !job.bucket->hasData()) {
+            continue;
+        }
+
+        for (const auto& layer : job.group) {
+            buckets.emplace(layer->getID(), job.bucket);
+        }
+        indexedRings.emplace(leader.getID(), std::move(job.indexedRings));
+        if (job.serialized && recording()) {
+            serializedBuckets.push_back(job.serialized);
+            serialized.emplace(leader.getID(), std::move(job.serialized));
+        }
+    }
+
+    // Symbol layouts have interned their names already, so the index is complete.
+    featureIndex->compact();
+
+    // Source layers the style no longer uses, or that were only parsed for queries, don't need
+    // to stay parsed with the tile.
+    if (*data) {
+        std::unordered_set<std::string> sourceLayers;
+        for (const auto& group : groups) {
+            sourceLayers.insert(group.at(0)->baseImpl->sourceLayer);
+        }
+        (*data)->releaseUnusedLayers(sourceLayers);
     }
 
     symbolLayouts.clear();
@@ -346,20 +645,135 @@ void GeometryTileWorker::redoLayout() {
             symbolLayouts.push_back(std::move(it->second));
         }
     }
+    symbolLayoutsNeedPreparation = !symbolLayouts.empty();
 
     requestNewGlyphs(glyphDependencies);
     requestNewImages(imageDependencies);
 
+    laidOut = LaidOut { *layers, imagesVersion, buckets, std::move(indexedRings), std::move(serialized) };
     parent.invoke(&GeometryTile::onLayout, GeometryTile::LayoutResult {
         std::move(buckets),
         std::move(featureIndex),
         *data ? (*data)->clone() : nullptr,
-        correlationID
+        correlationID,
+        std::move(serializedBuckets)
     });
 
     attemptPlacement();
 }
 
+// Repaints the buckets of the latest layout if the layers only changed in data-driven paint
+// properties since: their paint attributes are populated from the features the buckets have, and
+// their geometry is kept. Returns false if the tile needs to be laid out again instead.
+bool GeometryTileWorker::repaint() {
+    if (!laidOut || !data || !*data || !layers ||
+        laidOut->imagesVersion != imagesVersion ||
+        laidOut->layers.size() != layers->size()) {
+        return false;
+    }
+
+    std::unordered_set<std::string> changed;
+    for (std::size_t i = 0; i < layers->size(); i++) {
+        const Layer::Impl& before = *laidOut->layers[i];
+        const Layer::Impl& after = *(*layers)[i];
+        if (&before == &after) {
+            continue;
+        }
+        if (before.id != after.id ||
+            before.type != after.type ||
+            before.sourceLayer != after.sourceLayer ||
+            before.minZoom != after.minZoom ||
+            before.maxZoom != after.maxZoom) {
+            return false;
+        }
+        if (!before.hasLayoutDifference(after)) {
+            continue;
+        }
+        if (!before.hasPaintOnlyLayoutDifference(after)) {
+            return false;
+        }
+        changed.insert(after.id);
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<Bucket>> paintedBuckets;
+    BucketParameters parameters { id, mode, pixelRatio, instancing, &tessellationCache };
+
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers = RenderLayer::createForLayout(*layers, id.overscaledZ);
+    for (const auto& group : groupByLayout(renderLayers)) {
+        if (layoutCancelled()) {
+            return true;
+        }
+
+        const RenderLayer& leader = *group.at(0);
+        if (std::none_of(group.begin(), group.end(), [&] (const RenderLayer* layer) {
+                return changed.count(layer->getID());
+            })) {
+            continue;
+        }
+
+        auto laidOutBucket = laidOut->buckets.find(leader.getID());
+        if (laidOutBucket == laidOut->buckets.end()) {
+            continue; // No features of the group were laid out.
+        }
+        for (const auto& layer : group) {
+            auto it = laidOut->buckets.find(layer->getID());
+            if (it == laidOut->buckets.end() || it->second != laidOutBucket->second) {
+                return false;
+            }
+        }
+
+        auto geometryLayer = (*data)->getLayer(leader.baseImpl->sourceLayer);
+        if (!geometryLayer) {
+            return false;
+        }
+
+        std::shared_ptr<Bucket> painted = leader.createBucket(parameters, group);
+        if (!painted->repaint(*laidOutBucket->second, *geometryLayer)) {
+            return false;
+        }
+        for (const auto& layer : group) {
+            paintedBuckets.emplace(layer->getID(), painted);
+        }
+    }
+
+    if (layoutCancelled()) {
+        return true;
+    }
+
+    laidOut->layers = *layers;
+    parent.invoke(&GeometryTile::onRepaint, GeometryTile::RepaintResult {
+        std::move(paintedBuckets),
+        correlationID,
+        placementSent
+    });
+
+    // The tile is only complete once a placement was sent for its correlation ID.
+    if (!placementSent) {
+        attemptPlacement();
+    }
+    return true;
+}
+
+bool GeometryTileWorker::profiling() const {
+    return layoutProfiler && layoutProfiler->isEnabled();
+}
+
+bool GeometryTileWorker::recording() const {
+    return tileSnapshot && tileSnapshot->isRecording();
+}
+
+bool GeometryTileWorker::caching() const {
+    return layoutCache && layoutCache->isEnabled();
+}
+
+bool GeometryTileWorker::layoutCancelled() const {
+    return obsolete || latestLayoutID > correlationID;
+}
+
+bool GeometryTileWorker::placementCancelled() const {
+    return obsolete || latestPlacementID > correlationID;
+}
+
 bool GeometryTileWorker::hasPendingSymbolDependencies() const {
     for (auto& glyphDependency : pendingGlyphDependencies) {
         if (!glyphDependency.second.empty()) {
@@ -370,37 +784,73 @@ bool GeometryTileWorker::hasPendingSymbolDependencies() const {
 }
 
 void GeometryTileWorker::attemptPlacement() {
+    placementSent = false;
+
     if (!data || !layers || !placementConfig || hasPendingSymbolDependencies()) {
         return;
     }
-    
-    optional<AlphaImage> glyphAtlasImage;
-    optional<PremultipliedImage> iconAtlasImage;
 
+    const util::trace::Span span("placement", id.canonical);
+    
     if (symbolLayoutsNeedPreparation) {
-        GlyphAtlas glyphAtlas = makeGlyphAtlas(glyphMap);
-        ImageAtlas imageAtlas = makeImageAtlas(imageMap);
-
-        glyphAtlasImage = std::move(glyphAtlas.image);
-        iconAtlasImage = std::move(imageAtlas.image);
-
+        // Preparation is resumable: an interrupted prepare() picks up where it left off the
+        // next time we get here.
+        auto cancelled = [this] { return layoutCancelled(); };
         for (auto& symbolLayout : symbolLayouts) {
-            if (obsolete) {
+            const TimePoint start = profiling() ? Clock::now() : TimePoint();
+            symbolLayout->prepare(glyphMap, glyphPositions,
+                                  imageMap, imagePositions, shapingCache,
+                                  lineBreakCache, cancelled);
+            if (profiling()) {
+                RendererStatistics::LayerLayout cost = layerCost(symbolLayout->getBucketName(), id);
+                cost.layoutTime = Clock::now() - start;
+                layoutProfiler->add(cost);
+            }
+            if (cancelled()) {
                 return;
             }
-
-            symbolLayout->prepare(glyphMap, glyphAtlas.positions,
-                                  imageMap, imageAtlas.positions);
+            // The tile's buckets don't have the symbols prepared since.
+            symbolLayout->placedAllCandidates = false;
         }
 
         symbolLayoutsNeedPreparation = false;
+        // A placement of the symbols as they were before can't be resumed.
+        partialPlacement = {};
     }
 
-    auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
-    std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
+    PartialPlacement placement;
+    if (partialPlacement) {
+        placement = std::move(*partialPlacement);
+        partialPlacement = {};
+    } else {
+        placement.collisionTile = std::make_unique<CollisionTile>(*placementConfig);
+        for (auto& symbolLayout : symbolLayouts) {
+            symbolLayout->resetPlacement();
+        }
+    }
 
-    for (auto& symbolLayout : symbolLayouts) {
-        if (obsolete) {
+    // Still images are only rendered once placement is complete, so they are placed at once.
+    std::size_t budget = placementBudget;
+    std::size_t* const remaining = mode == MapMode::Continuous && placementBudget ? &budget : nullptr;
+
+    // Sends the symbols placed so far to the tile, and resumes the placement in the next pass. The
+    // collision tile stays here, as the rest of the symbols are placed in it.
+    auto handOut = [&] {
+        parent.invoke(&GeometryTile::onPlacement, GeometryTile::PlacementResult {
+            placement.buckets,
+            nullptr,
+            correlationID,
+            placement.placements,
+            false,
+            placement.collisionTile->yStretch
+        });
+        partialPlacement = std::move(placement);
+    };
+
+    auto cancelled = [this] { return placementCancelled(); };
+    for (; placement.layout < symbolLayouts.size(); ++placement.layout) {
+        auto& symbolLayout = symbolLayouts[placement.layout];
+        if (cancelled()) {
             return;
         }
 
@@ -408,18 +858,72 @@ void GeometryTileWorker::attemptPlacement() {
             continue;
         }
 
-        std::shared_ptr<Bucket> bucket = symbolLayout->place(*collisionTile);
+        // Placing a layout again usually only changes which of its symbols show at which zoom
+        // levels, which the tile can apply to the bucket it has. The first placement adds the
+        // symbols that show only; once a layout is placed again, its buckets keep them all.
+        const bool canUpdatePlacement = symbolLayout->canUpdatePlacement(*placementConfig);
+        const TimePoint start = profiling() ? Clock::now() : TimePoint();
+        if (canUpdatePlacement && symbolLayout->placedAllCandidates) {
+            auto zooms = symbolLayout->updatePlacement(*placement.collisionTile, cancelled);
+            if (profiling()) {
+                RendererStatistics::LayerLayout cost = layerCost(symbolLayout->getBucketName(), id);
+                cost.placementTime = Clock::now() - start;
+                layoutProfiler->add(cost);
+            }
+            if (!zooms) {
+                return;
+            }
+            auto shared = std::make_shared<const SymbolPlacementZooms>(std::move(*zooms));
+            for (const auto& pair : symbolLayout->layerPaintProperties) {
+                placement.placements.emplace(pair.first, shared);
+            }
+            continue;
+        }
+
+        if (remaining && *remaining == 0) {
+            handOut();
+            return;
+        }
+
+        std::shared_ptr<Bucket> bucket = symbolLayout->place(*placement.collisionTile, cancelled,
+                                                             canUpdatePlacement && symbolLayout->placed,
+                                                             remaining);
+        if (profiling()) {
+            // Incomplete placements only count the time; the bucket is counted once it's complete.
+            RendererStatistics::LayerLayout cost = layerCost(symbolLayout->getBucketName(), id);
+            cost.placementTime = Clock::now() - start;
+            if (bucket && symbolLayout->placementComplete()) {
+                cost.vertices = bucket->getVertexCount();
+                cost.bytes = bucket->byteSize();
+            }
+            layoutProfiler->add(cost);
+        }
+        if (!bucket) {
+            return;
+        }
         for (const auto& pair : symbolLayout->layerPaintProperties) {
-            buckets.emplace(pair.first, bucket);
+            placement.buckets[pair.first] = bucket;
+        }
+
+        if (!symbolLayout->placementComplete()) {
+            handOut();
+            return;
         }
     }
 
+    for (auto& symbolLayout : symbolLayouts) {
+        if (symbolLayout->hasSymbolInstances()) {
+            symbolLayout->placedAllCandidates = symbolLayout->canUpdatePlacement(*placementConfig) && symbolLayout->placed;
+            symbolLayout->placed = true;
+        }
+    }
+
+    placementSent = true;
     parent.invoke(&GeometryTile::onPlacement, GeometryTile::PlacementResult {
-        std::move(buckets),
-        std::move(collisionTile),
-        std::move(glyphAtlasImage),
-        std::move(iconAtlasImage),
-        correlationID
+        std::move(placement.buckets),
+        std::move(placement.collisionTile),
+        correlationID,
+        std::move(placement.placements)
     });
 }
 
@@ -3,8 +3,15 @@
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/image_impl.hpp>
+#include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/placement_config.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/geometry/tessellation.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/tile_snapshot.hpp>
+#include <mbgl/tile/layout_cache.hpp>
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/immutable.hpp>
@@ -12,12 +19,20 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace mbgl {
 
 class GeometryTile;
 class GeometryTileData;
 class SymbolLayout;
+class LineBreakCache;
+class LayoutProfiler;
+class Scheduler;
+class Bucket;
+class CollisionTile;
+struct SymbolPlacementZooms;
 
 namespace style {
 class Layer;
@@ -27,22 +42,38 @@ class GeometryTileWorker {
 public:
     GeometryTileWorker(ActorRef<GeometryTileWorker> self,
                        ActorRef<GeometryTile> parent,
+                       Scheduler&,
                        OverscaledTileID,
-                       const std::atomic<bool>&,
+                       const std::atomic<bool>& obsolete,
+                       const std::atomic<uint64_t>& latestLayoutID,
+                       const std::atomic<uint64_t>& latestPlacementID,
                        const MapMode,
-                       const float pixelRatio);
+                       const float pixelRatio,
+                       const bool instancing = false,
+                       LineBreakCache* lineBreakCache = nullptr,
+                       uint32_t placementBudget = 0,
+                       float simplificationTolerance = 0,
+                       LayoutProfiler* layoutProfiler = nullptr,
+                       const TileSnapshot* tileSnapshot = nullptr,
+                       LayoutCache* layoutCache = nullptr);
     ~GeometryTileWorker();
 
-    void setLayers(std::vector<Immutable<style::Layer::Impl>>, uint64_t correlationID);
+    // The images version is that of the ImageManager, which symbol layouts depend on.
+    void setLayers(std::vector<Immutable<style::Layer::Impl>>, uint64_t imagesVersion, uint64_t correlationID);
     void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
     void setPlacementConfig(PlacementConfig, uint64_t correlationID);
     
-    void onGlyphsAvailable(GlyphMap glyphs);
-    void onImagesAvailable(ImageMap images);
+    void onGlyphsAvailable(GlyphMap glyphs, GlyphPositions);
+    void onImagesAvailable(ImageMap images, ImagePositions);
+
+    // Frees the caches that speed up relayouts of the tile, and adds the bytes freed to `freed`.
+    // The next layout lays out every layer again and recreates them.
+    void trimMemory(std::shared_ptr<std::atomic<std::size_t>> freed);
 
 private:
     void coalesced();
     void redoLayout();
+    bool repaint();
     void attemptPlacement();
     
     void coalesce();
@@ -53,13 +84,39 @@ private:
     void symbolDependenciesChanged();
     bool hasPendingSymbolDependencies() const;
 
+    // True when the tile is obsolete, or when a message that will make us redo the current
+    // layout (or placement) is already waiting in the mailbox.
+    bool layoutCancelled() const;
+    bool placementCancelled() const;
+
     ActorRef<GeometryTileWorker> self;
     ActorRef<GeometryTile> parent;
 
+    // The scheduler this worker runs on; used to build independent buckets in parallel.
+    Scheduler& scheduler;
+
     const OverscaledTileID id;
     const std::atomic<bool>& obsolete;
+    const std::atomic<uint64_t>& latestLayoutID;
+    const std::atomic<uint64_t>& latestPlacementID;
     const MapMode mode;
     const float pixelRatio;
+    const bool instancing;
+    // Shared by the workers of all tiles; owned by the RenderStyle.
+    LineBreakCache* const lineBreakCache;
+    // The number of symbols placed per pass in continuous mode; all of them if 0.
+    const uint32_t placementBudget;
+    // In tile units; lines and polygons are drawn at full resolution if 0.
+    const double simplificationTolerance;
+    // Shared by the workers of all tiles, like the line break cache.
+    LayoutProfiler* const layoutProfiler;
+    // Likewise; buckets are serialized for it while it's recording.
+    const TileSnapshot* const tileSnapshot;
+    LayoutCache* const layoutCache;
+
+    bool profiling() const;
+    bool recording() const;
+    bool caching() const;
 
     enum State {
         Idle,
@@ -74,14 +131,56 @@ private:
     // Outer optional indicates whether we've received it or not.
     optional<std::vector<Immutable<style::Layer::Impl>>> layers;
     optional<std::unique_ptr<const GeometryTileData>> data;
+    // The content hash of the data, computed the first time the layout cache needs it.
+    optional<optional<std::size_t>> dataHash;
     optional<PlacementConfig> placementConfig;
+    uint64_t imagesVersion = 0;
+
+    // What the latest layout sent to the tile was made of; layers that only changed in data-driven
+    // paint properties since are repainted rather than laid out again, and the buckets of layers
+    // that didn't change at all are reused by the next layout. Reset when the data changes.
+    struct LaidOut {
+        std::vector<Immutable<style::Layer::Impl>> layers;
+        uint64_t imagesVersion;
+        // The tile's non-symbol buckets, by layer.
+        std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
+        // The feature index entries of the non-symbol buckets, by the first layer of their group.
+        using IndexedRings = LayoutCache::IndexedRings;
+        std::unordered_map<std::string, std::shared_ptr<const IndexedRings>> indexedRings;
+        // The serialized non-symbol buckets, by the first layer of their group, while the tile
+        // snapshot is recording.
+        std::unordered_map<std::string, std::shared_ptr<const TileSnapshot::SerializedBucket>> serialized;
+    };
+    optional<LaidOut> laidOut;
+    // Whether the latest placement was sent to the tile in full. If not, repaints place again.
+    bool placementSent = false;
 
     bool symbolLayoutsNeedPreparation = false;
     std::vector<std::unique_ptr<SymbolLayout>> symbolLayouts;
     GlyphDependencies pendingGlyphDependencies;
     ImageDependencies pendingImageDependencies;
     GlyphMap glyphMap;
+    // Positions in the renderer's glyph atlas.
+    GlyphPositions glyphPositions;
     ImageMap imageMap;
+    // Positions in the renderer's image atlas.
+    ImagePositions imagePositions;
+
+    // Outlives the symbol layouts, so that relayouts of the tile reuse their shapings.
+    ShapingCache shapingCache;
+    // Likewise for the triangulations of polygons; cleared when the data changes.
+    TessellationCache tessellationCache;
+
+    // A placement that is sent to the tile over several passes, because it exceeded the placement
+    // budget; resumed by the passes after the first.
+    struct PartialPlacement {
+        std::unique_ptr<CollisionTile> collisionTile;
+        // The index of the symbol layout to place next.
+        std::size_t layout = 0;
+        std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
+        std::unordered_map<std::string, std::shared_ptr<const SymbolPlacementZooms>> placements;
+    };
+    optional<PartialPlacement> partialPlacement;
 };
 
 } // namespace mbgl
@@ -0,0 +1,88 @@
+#include <mbgl/tile/layout_cache.hpp>
+
+#include <boost/functional/hash.hpp>
+
+namespace mbgl {
+
+bool LayoutCache::Key::operator==(const Key& rhs) const {
+    return tileID.overscaledZ == rhs.tileID.overscaledZ &&
+        tileID.canonical == rhs.tileID.canonical &&
+        dataHash == rhs.dataHash &&
+        layoutKey == rhs.layoutKey &&
+        layerIDs == rhs.layerIDs &&
+        instancing == rhs.instancing &&
+        simplificationTolerance == rhs.simplificationTolerance;
+}
+
+std::size_t LayoutCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = std::hash<OverscaledTileID>()(key.tileID);
+    boost::hash_combine(seed, key.dataHash);
+    boost::hash_combine(seed, key.layoutKey);
+    for (const auto& layerID : key.layerIDs) {
+        boost::hash_combine(seed, layerID);
+    }
+    boost::hash_combine(seed, key.instancing);
+    boost::hash_combine(seed, key.simplificationTolerance);
+    return seed;
+}
+
+void LayoutCache::setMaximumSize(std::size_t bytes_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = bytes_;
+    evict();
+}
+
+optional<LayoutCache::Layout> LayoutCache::get(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        ++misses;
+        return {};
+    }
+
+    ++hits;
+    uses.splice(uses.begin(), uses, it->second.use);
+    return it->second.layout;
+}
+
+void LayoutCache::add(Key key, Layout layout) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Another worker may have laid out the same tile in the meantime.
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        uses.splice(uses.begin(), uses, it->second.use);
+        return;
+    }
+
+    const std::size_t size = sizeof(Entry) + key.layoutKey.size() + layout.bucket->data.size() +
+        layout.indexedRings->size() * sizeof(IndexedRings::value_type);
+    if (size > maximumSize) {
+        return;
+    }
+
+    it = entries.emplace(std::move(key), Entry { std::move(layout), size, uses.end() }).first;
+    uses.push_front(&it->first);
+    it->second.use = uses.begin();
+    bytes += size;
+
+    evict();
+}
+
+void LayoutCache::evict() {
+    while (bytes > maximumSize) {
+        // Erase by iterator: the key is owned by the entry being erased.
+        auto oldest = entries.find(*uses.back());
+        uses.pop_back();
+        bytes -= oldest->second.bytes;
+        entries.erase(oldest);
+    }
+}
+
+LayoutCache::Stats LayoutCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return { hits, misses, entries.size(), bytes };
+}
+
+} // namespace mbgl
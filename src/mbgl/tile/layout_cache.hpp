@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/renderer/tile_snapshot.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   A least recently used cache of the non-symbol buckets tile workers lay out, serialized, with
+   the feature index entries of their features. A tile that is laid out again with the same data
+   and the same layout, e.g. when an area is revisited after its tiles were evicted from the tile
+   cache, copies its buckets out of the cache instead of decoding and laying out its features.
+
+   Buckets with data-driven paint attributes aren't cached. The cache is shared by all tile
+   workers of a renderer, is safe to use from any thread, and caches nothing until it's given a
+   size.
+*/
+class LayoutCache : private util::noncopyable {
+public:
+    using IndexedRings = std::vector<std::pair<std::size_t, FeatureIndex::BBox>>;
+
+    struct Key {
+        // Wrapped copies of a tile share their layouts.
+        OverscaledTileID tileID;
+        // See GeometryTileData::contentHash().
+        std::size_t dataHash;
+        std::string layoutKey;
+        std::vector<std::string> layerIDs;
+        bool instancing;
+        double simplificationTolerance;
+
+        bool operator==(const Key&) const;
+    };
+
+    struct Layout {
+        std::shared_ptr<const TileSnapshot::SerializedBucket> bucket;
+        std::shared_ptr<const IndexedRings> indexedRings;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        std::size_t size;
+        std::size_t bytes;
+    };
+
+    // Evicts the least recently used layouts until the cache fits into `bytes`; zero disables
+    // the cache.
+    void setMaximumSize(std::size_t bytes);
+    bool isEnabled() const {
+        return maximumSize > 0;
+    }
+
+    optional<Layout> get(const Key&);
+    void add(Key, Layout);
+
+    Stats getStats() const;
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        Layout layout;
+        std::size_t bytes;
+        std::list<const Key*>::iterator use;
+    };
+
+    void evict();
+
+    std::atomic<std::size_t> maximumSize { 0 };
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    // Keys of the entries, most recently used first.
+    std::list<const Key*> uses;
+    std::size_t bytes = 0;
+
+    std::atomic<uint64_t> hits { 0 };
+    std::atomic<uint64_t> misses { 0 };
+};
+
+} // namespace mbgl
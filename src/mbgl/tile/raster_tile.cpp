@@ -10,16 +10,31 @@
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <cmath>
+
 namespace mbgl {
 
+// The size the tile covers on screen at its own zoom level, in device pixels. Overzoomed tiles are
+// stretched, so they need all the pixels of the image.
+static Size displaySize(const OverscaledTileID& id, const TileParameters& parameters, uint16_t tileSize) {
+    const float scale = parameters.pixelRatio * std::pow(2.0f, id.overscaledZ - id.canonical.z);
+    const auto size = static_cast<uint32_t>(std::ceil(tileSize * scale));
+    return { size, size };
+}
+
 RasterTile::RasterTile(const OverscaledTileID& id_,
                        const TileParameters& parameters,
-                       const Tileset& tileset)
+                       const Tileset& tileset,
+                       uint16_t tileSize,
+                       SourceType type)
     : Tile(id_),
       loader(*this, id_, parameters, tileset),
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
       worker(parameters.workerScheduler,
-             ActorRef<RasterTile>(*this, mailbox)) {
+             ActorRef<RasterTile>(*this, mailbox),
+             id_.canonical,
+             type == SourceType::RasterDEM ? Size() : displaySize(id_, parameters, tileSize),
+             type == SourceType::RasterDEM) {
 }
 
 RasterTile::~RasterTile() = default;
@@ -41,8 +56,25 @@ void RasterTile::setData(std::shared_ptr<const std::string> data,
     worker.invoke(&RasterTileWorker::parse, data);
 }
 
+static uint16_t neighborBit(int8_t dx, int8_t dy) {
+    return 1 << ((dy + 1) * 3 + (dx + 1));
+}
+
+// The center, which isn't a neighbor.
+static constexpr uint16_t allNeighbors = 0x1FF & ~(1 << 4);
+
 void RasterTile::onParsed(std::unique_ptr<RasterBucket> result) {
     bucket = std::move(result);
+    backfilled = 0;
+
+    // There are no neighbors beyond the poles.
+    if (id.canonical.y == 0) {
+        backfilled |= neighborBit(-1, -1) | neighborBit(0, -1) | neighborBit(1, -1);
+    }
+    if (id.canonical.y == (1u << id.canonical.z) - 1) {
+        backfilled |= neighborBit(-1, 1) | neighborBit(0, 1) | neighborBit(1, 1);
+    }
+
     loaded = true;
     renderable = bucket ? true : false;
     observer->onTileChanged(*this);
@@ -55,8 +87,22 @@ void RasterTile::onError(std::exception_ptr err) {
     observer->onTileError(*this, err);
 }
 
+void RasterTile::backfillBorder(const RasterTile& neighbor, int8_t dx, int8_t dy) {
+    const uint16_t bit = neighborBit(dx, dy);
+    if ((backfilled & bit) || !neighbor.bucket || !neighbor.bucket->dem) {
+        return;
+    }
+    bucket->backfillBorder(*neighbor.bucket, dx, dy);
+    backfilled |= bit;
+}
+
+bool RasterTile::needsBackfill() const {
+    return bucket && bucket->dem && backfilled != allNeighbors;
+}
+
 void RasterTile::upload(gl::Context& context) {
     if (bucket) {
+        const util::trace::Span span(bucket->needsUpload() ? "upload" : nullptr, id.canonical);
         bucket->upload(context);
     }
 }
@@ -65,14 +111,39 @@ Bucket* RasterTile::getBucket(const style::Layer::Impl&) const {
     return bucket.get();
 }
 
+RendererStatistics::Memory RasterTile::memoryUsage() const {
+    return bucket ? bucket->memoryUsage() : RendererStatistics::Memory();
+}
+
 void RasterTile::setMask(TileMask&& mask) {
     if (bucket) {
         bucket->setMask(std::move(mask));
     }
 }
 
+const TileMask* RasterTile::getMask() const {
+    return bucket ? &bucket->mask : nullptr;
+}
+
+void RasterTile::updateMaskGeometry(TileMaskCache& cache, gl::Context& context) {
+    if (bucket && !bucket->maskGeometry) {
+        bucket->maskGeometry = cache.get(bucket->mask);
+        if (bucket->maskGeometry) {
+            bucket->maskGeometry->upload(context);
+        }
+    }
+}
+
 void RasterTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setRequestPriority(Resource::Priority priority) {
+    loader.setPriority(priority);
+}
+
+void RasterTile::setPriority(int32_t priority) {
+    worker.setPriority(priority);
+}
+
 } // namespace mbgl
@@ -4,12 +4,14 @@
 #include <mbgl/tile/tile_loader.hpp>
 #include <mbgl/tile/raster_tile_worker.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/style/types.hpp>
 
 namespace mbgl {
 
 class Tileset;
 class TileParameters;
 class RasterBucket;
+class TileMaskCache;
 
 namespace style {
 class Layer;
@@ -19,10 +21,14 @@ class RasterTile : public Tile {
 public:
     RasterTile(const OverscaledTileID&,
                    const TileParameters&,
-                   const Tileset&);
+                   const Tileset&,
+                   uint16_t tileSize,
+                   SourceType);
     ~RasterTile() final;
 
     void setNecessity(Necessity) final;
+    void setRequestPriority(Resource::Priority) final;
+    void setPriority(int32_t) override;
 
     void setError(std::exception_ptr);
     void setData(std::shared_ptr<const std::string> data,
@@ -33,12 +39,22 @@ public:
 
     void upload(gl::Context&) override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
+    RendererStatistics::Memory memoryUsage() const override;
 
     void setMask(TileMask&&) override;
+    // The mask the tile is drawn with, once it has loaded.
+    const TileMask* getMask() const;
+    // Gives the tile the shared, uploaded geometry of its mask, if the mask changed.
+    void updateMaskGeometry(TileMaskCache&, gl::Context&);
 
     void onParsed(std::unique_ptr<RasterBucket> result);
     void onError(std::exception_ptr);
 
+    // Tiles of raster-dem sources fill in the border they share with the tile at `dx`, `dy` from
+    // them once both have loaded, which happens once for every direction.
+    void backfillBorder(const RasterTile& neighbor, int8_t dx, int8_t dy);
+    bool needsBackfill() const;
+
 private:
     TileLoader<RasterTile> loader;
 
@@ -48,6 +64,10 @@ private:
     // Contains the Bucket object for the tile. Buckets are render
     // objects and they get added by tile parsing operations.
     std::unique_ptr<RasterBucket> bucket;
+
+    // A bit for each of the neighbors that the border has been filled in from, in rows from the
+    // top left.
+    uint16_t backfilled = 0;
 };
 
 } // namespace mbgl
@@ -3,11 +3,32 @@
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/actor/actor.hpp>
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/compressed_image.hpp>
+#include <mbgl/util/trace.hpp>
 
 namespace mbgl {
 
-RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_)
-    : parent(std::move(parent_)) {
+RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_,
+                                   CanonicalTileID id_, Size displaySize_, bool dem_)
+    : parent(std::move(parent_)),
+      id(std::move(id_)),
+      displaySize(displaySize_),
+      dem(dem_) {
+}
+
+static PremultipliedImage decodeReduced(const std::string& data, Size displaySize) {
+    PremultipliedImage image = decodeImage(data, displaySize);
+
+    // Box filter whatever the decoder couldn't reduce itself.
+    uint32_t factor = 1;
+    while (!displaySize.isEmpty() &&
+           image.size.width % (factor * 2) == 0 && image.size.height % (factor * 2) == 0 &&
+           image.size.width / (factor * 2) >= displaySize.width &&
+           image.size.height / (factor * 2) >= displaySize.height) {
+        factor *= 2;
+    }
+
+    return factor > 1 ? image.downsample(factor) : std::move(image);
 }
 
 void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
@@ -16,8 +37,20 @@ void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
         return;
     }
 
+    const util::trace::Span span("parse", id);
+
     try {
-        auto bucket = std::make_unique<RasterBucket>(decodeImage(*data));
+        if (dem) {
+            // Elevations are kept at full resolution, since averaging their encoding mixes them up.
+            parent.invoke(&RasterTile::onParsed,
+                          std::make_unique<RasterBucket>(DEMData(decodeImage(*data), id)));
+            return;
+        }
+
+        // Compressed textures are uploaded as they are, at a fraction of the memory of RGBA.
+        auto bucket = isCompressedImage(*data)
+            ? std::make_unique<RasterBucket>(decodeCompressedImage(*data))
+            : std::make_unique<RasterBucket>(decodeReduced(*data, displaySize));
         parent.invoke(&RasterTile::onParsed, std::move(bucket));
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception());
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/size.hpp>
 
 #include <memory>
 #include <string>
@@ -11,12 +13,18 @@ class RasterTile;
 
 class RasterTileWorker {
 public:
-    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>);
+    // Images are reduced by powers of two for as long as they stay at least `displaySize`. Tiles
+    // of raster-dem sources are decoded as elevations instead.
+    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>, CanonicalTileID,
+                     Size displaySize, bool dem);
 
     void parse(std::shared_ptr<const std::string> data);
 
 private:
     ActorRef<RasterTile> parent;
+    const CanonicalTileID id;
+    const Size displaySize;
+    const bool dem;
 };
 
 } // namespace mbgl
@@ -9,7 +9,10 @@ namespace mbgl {
 
 static TileObserver nullObserver;
 
-Tile::Tile(OverscaledTileID id_) : id(std::move(id_)), observer(&nullObserver) {
+Tile::Tile(OverscaledTileID id_)
+    : id(std::move(id_)),
+      observer(&nullObserver),
+      untilDrawnSpan("first draw", id.canonical) {
 }
 
 Tile::~Tile() = default;
@@ -23,6 +26,13 @@ void Tile::setTriedOptional() {
     observer->onTileChanged(*this);
 }
 
+void Tile::setExpiration(optional<Timestamp> modified_, optional<Timestamp> expires_) {
+    if (modified_) {
+        modified = modified_;
+    }
+    expires = expires_;
+}
+
 void Tile::dumpDebugLogs() const {
     Log::Info(Event::General, "Tile::id: %s", util::toString(id).c_str());
     Log::Info(Event::General, "Tile::renderable: %s", isRenderable() ? "yes" : "no");
@@ -37,7 +47,8 @@ void Tile::queryRenderedFeatures(
         const RenderedQueryOptions&) {}
 
 void Tile::querySourceFeatures(
-        std::vector<Feature>&,
-        const SourceQueryOptions&) {}
+        const GeometryCoordinates&,
+        const SourceQueryOptions&,
+        const SourceFeatureCallback&) {}
 
 } // namespace mbgl
@@ -5,13 +5,16 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/trace.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/renderer/query.hpp>
 #include <mbgl/renderer/tile_mask.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/style/layer_impl.hpp>
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <functional>
@@ -24,8 +27,6 @@ class TransformState;
 class TileObserver;
 class PlacementConfig;
 class RenderStyle;
-class RenderedQueryOptions;
-class SourceQueryOptions;
 
 namespace gl {
 class Context;
@@ -47,6 +48,14 @@ public:
 
     virtual void setNecessity(Necessity) = 0;
 
+    // Priority of this tile's network requests; tiles prefetched ahead of the camera are
+    // requested with low priority. See TilePyramid::update.
+    virtual void setRequestPriority(Resource::Priority) {}
+
+    // Relative importance of this tile's pending worker tasks; tiles with a higher priority are
+    // parsed and laid out first. See TilePyramid::update.
+    virtual void setPriority(int32_t) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel() = 0;
 
@@ -64,12 +73,19 @@ public:
             const RenderStyle&,
             const RenderedQueryOptions& options);
 
+    // Finds the features of the tile's data that intersect the query geometry, in tile units, or
+    // all of them if it is empty.
     virtual void querySourceFeatures(
-            std::vector<Feature>& result,
-            const SourceQueryOptions&);
+            const GeometryCoordinates& queryGeometry,
+            const SourceQueryOptions&,
+            const SourceFeatureCallback&);
 
     void setTriedOptional();
 
+    // Updates the freshness of the tile's data without replacing the data, after revalidation
+    // found it unchanged.
+    void setExpiration(optional<Timestamp> modified, optional<Timestamp> expires);
+
     // Returns true when the tile source has received a first response, regardless of whether a load
     // error occurred or actual data was loaded.
     bool hasTriedOptional() const {
@@ -101,6 +117,11 @@ public:
 
     void dumpDebugLogs() const;
 
+    // Called whenever the tile is drawn.
+    void setDrawn() {
+        untilDrawnSpan.end();
+    }
+
     const OverscaledTileID id;
     optional<Timestamp> modified;
     optional<Timestamp> expires;
@@ -110,6 +131,21 @@ public:
     
     virtual float yStretch() const { return 1.0f; }
 
+    // Memory held by this tile's render data and the tile data it was made from.
+    virtual RendererStatistics::Memory memoryUsage() const { return {}; }
+
+    // Frees what the tile keeps to speed up relayouts and queries, all of which is recreated when
+    // it's needed again. Returns the bytes of query data freed; the tile's worker adds what it
+    // frees to `workerCachesFreed` once it has.
+    virtual std::size_t trimMemory(const std::shared_ptr<std::atomic<std::size_t>>&) { return 0; }
+
+    // The memory held on both the CPU and the GPU, in bytes. Used to keep the tile cache within
+    // its budget.
+    std::size_t byteSize() const {
+        const RendererStatistics::Memory memory = memoryUsage();
+        return memory.cpu + memory.gpu;
+    }
+
 protected:
     bool triedOptional = false;
     bool renderable = false;
@@ -117,6 +153,9 @@ protected:
     bool loaded = false;
 
     TileObserver* observer = nullptr;
+
+private:
+    util::trace::Span untilDrawnSpan;
 };
 
 } // namespace mbgl
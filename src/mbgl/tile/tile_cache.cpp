@@ -5,16 +5,20 @@
 
 namespace mbgl {
 
+static constexpr size_t tileOverhead = 16 * 1024;
+
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
+    assert(byteSize <= size);
+}
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
+RendererStatistics::Memory TileCache::getMemoryUsage() const {
+    RendererStatistics::Memory result;
+    for (const auto& entry : tiles) {
+        result += entry.second.tile->memoryUsage();
     }
-
-    assert(orderedKeys.size() <= size);
+    return result;
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -22,21 +26,26 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    // Tile objects and their workers aren't part of Tile::byteSize(); charge a fixed amount for
+    // them so that empty tiles can't accumulate without bound.
+    const size_t tileSize = tile->byteSize() + tileOverhead;
+
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        // keep the existing tile, but mark it as newest
+        orderedKeys.splice(orderedKeys.end(), orderedKeys, it->second.position);
+        return;
     }
 
-    // (re-)insert tile key as newest
+    // insert tile key as newest
     orderedKeys.push_back(key);
+    tiles.emplace(key, Entry { std::move(tile), tileSize, std::prev(orderedKeys.end()) });
+    byteSize += tileSize;
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
-    }
+    // purge oldest tiles if necessary
+    evict();
 
-    assert(orderedKeys.size() <= size);
+    assert(byteSize <= size);
 }
 
 std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
@@ -45,9 +54,10 @@ std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
+        tile = std::move(it->second.tile);
+        byteSize -= it->second.byteSize;
+        orderedKeys.erase(it->second.position);
         tiles.erase(it);
-        orderedKeys.remove(key);
         assert(tile->isRenderable());
     }
 
@@ -61,6 +71,13 @@ bool TileCache::has(const OverscaledTileID& key) {
 void TileCache::clear() {
     orderedKeys.clear();
     tiles.clear();
+    byteSize = 0;
+}
+
+void TileCache::evict() {
+    while (byteSize > size && !orderedKeys.empty()) {
+        get(orderedKeys.front());
+    }
 }
 
 } // namespace mbgl
@@ -1,31 +1,54 @@
 #pragma once
 
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/renderer/renderer_statistics.hpp>
 
 #include <list>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
 class Tile;
 
+// Keeps recently used tiles that are no longer needed for rendering, evicting the least recently
+// used ones once the tiles' combined byteSize() exceeds the budget.
 class TileCache {
 public:
     TileCache(size_t size_ = 0) : size(size_) {}
 
+    // Sets the budget, in bytes.
     void setSize(size_t);
     size_t getSize() const { return size; };
+
+    // Returns the bytes currently held by cached tiles.
+    size_t getByteSize() const { return byteSize; }
+
+    // Returns the number of cached tiles.
+    size_t getCount() const { return tiles.size(); }
+
+    // Returns the memory currently held by cached tiles, on the CPU and the GPU.
+    RendererStatistics::Memory getMemoryUsage() const;
+
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+    void evict();
+
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        size_t byteSize;
+        std::list<OverscaledTileID>::iterator position;
+    };
+
+    std::unordered_map<OverscaledTileID, Entry> tiles;
     std::list<OverscaledTileID> orderedKeys;
 
     size_t size;
+    size_t byteSize = 0;
 };
 
 } // namespace mbgl
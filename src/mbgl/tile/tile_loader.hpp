@@ -3,6 +3,10 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/trace.hpp>
+
+#include <memory>
+#include <string>
 
 namespace mbgl {
 
@@ -34,6 +38,8 @@ public:
         }
     }
 
+    void setPriority(Resource::Priority);
+
 private:
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
@@ -49,11 +55,18 @@ private:
     void loadedData(const Response&);
     void loadRequired();
 
+    // Starts the required request along with the cache lookup, if the file source supports it.
+    void loadConcurrently();
+
     T& tile;
     Necessity necessity;
     Resource resource;
     FileSource& fileSource;
     std::unique_ptr<AsyncRequest> request;
+    util::trace::Span requestSpan;
+
+    // The data the tile was last given, to recognize revalidated data that didn't change.
+    std::shared_ptr<const std::string> data;
 };
 
 } // namespace mbgl
@@ -25,6 +25,7 @@ TileLoader<T>::TileLoader(T& tile_,
         tileset.scheme)),
       fileSource(parameters.fileSource) {
     assert(!request);
+    resource.batchURL = tileset.batch;
     if (fileSource.supportsOptionalRequests()) {
         // When supported, the first request is always optional, even if the TileLoader
         // is marked as required. That way, we can let the first optional request continue
@@ -52,8 +53,10 @@ void TileLoader<T>::loadOptional() {
     assert(!request);
 
     resource.necessity = Resource::Optional;
+    requestSpan = util::trace::Span("request", util::trace::tileOf(resource));
     request = fileSource.request(resource, [this](Response res) {
         request.reset();
+        requestSpan.end();
 
         tile.setTriedOptional();
 
@@ -76,6 +79,11 @@ template <typename T>
 void TileLoader<T>::makeRequired() {
     if (!request) {
         loadRequired();
+    } else if (resource.necessity == Resource::Optional && fileSource.supportsConcurrentNetworkRequests()) {
+        // Rather than waiting for the pending optional request to miss the cache before going to
+        // the network, replace it with a request that looks the tile up while it is downloaded.
+        request.reset();
+        loadConcurrently();
     }
 }
 
@@ -84,6 +92,32 @@ void TileLoader<T>::makeOptional() {
     if (resource.necessity == Resource::Required && request) {
         // Abort a potential HTTP request.
         request.reset();
+
+        // A concurrent request that hasn't looked the tile up yet goes on as an optional one, like
+        // the optional request it replaced.
+        if (!tile.hasTriedOptional() && fileSource.supportsConcurrentNetworkRequests()) {
+            loadOptional();
+        }
+    }
+}
+
+template <typename T>
+void TileLoader<T>::setPriority(Resource::Priority priority) {
+    if (priority == resource.priority) {
+        return;
+    }
+
+    resource.priority = priority;
+
+    // A prefetched tile that's now needed goes back into the queue, ahead of the prefetched ones.
+    if (priority == Resource::Priority::Regular && resource.necessity == Resource::Required &&
+        request && !tile.isLoaded()) {
+        request.reset();
+        if (!tile.hasTriedOptional() && fileSource.supportsConcurrentNetworkRequests()) {
+            loadConcurrently();
+        } else {
+            loadRequired();
+        }
     }
 }
 
@@ -93,22 +127,57 @@ void TileLoader<T>::loadedData(const Response& res) {
         tile.setError(std::make_exception_ptr(std::runtime_error(res.error->message)));
     } else if (res.notModified) {
         resource.priorExpires = res.expires;
-        // Do not notify the tile; when we get this message, it already has the current
-        // version of the data.
+        // Do not hand the data to the tile again; when we get this message, it already has the
+        // current version of the data, possibly served stale while it was being revalidated.
+        // Parsing and laying it out again would only repeat work.
+        tile.setExpiration(res.modified, res.expires);
+    } else if (data && res.data && (data == res.data || *data == *res.data)) {
+        // Servers that don't answer conditional requests send the unchanged data again.
+        resource.priorModified = res.modified;
+        resource.priorExpires = res.expires;
+        resource.priorEtag = res.etag;
+        tile.setExpiration(res.modified, res.expires);
     } else {
         resource.priorModified = res.modified;
         resource.priorExpires = res.expires;
         resource.priorEtag = res.etag;
-        tile.setData(res.noContent ? nullptr : res.data, res.modified, res.expires);
+        data = res.noContent ? nullptr : res.data;
+        tile.setData(data, res.modified, res.expires);
     }
 }
 
+template <typename T>
+void TileLoader<T>::loadConcurrently() {
+    assert(!request);
+
+    resource.necessity = Resource::Required;
+    resource.concurrentNetworkRequest = true;
+    requestSpan = util::trace::Span("request", util::trace::tileOf(resource));
+    request = fileSource.request(resource, [this](Response res) {
+        if (!tile.hasTriedOptional()) {
+            // The first response is the one of the cache lookup.
+            tile.setTriedOptional();
+            if (res.error && res.error->reason == Response::Error::Reason::NotFound) {
+                // The tile isn't in the cache, and is on its way from the network.
+                return;
+            }
+        }
+        requestSpan.end();
+        loadedData(res);
+    });
+    resource.concurrentNetworkRequest = false;
+}
+
 template <typename T>
 void TileLoader<T>::loadRequired() {
     assert(!request);
 
     resource.necessity = Resource::Required;
-    request = fileSource.request(resource, [this](Response res) { loadedData(res); });
+    requestSpan = util::trace::Span("request", util::trace::tileOf(resource));
+    request = fileSource.request(resource, [this](Response res) {
+        requestSpan.end();
+        loadedData(res);
+    });
 }
 
 } // namespace mbgl
@@ -1,28 +1,45 @@
 #include <mbgl/tile/vector_tile.hpp>
 #include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data_cache.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/util/tileset.hpp>
 
 namespace mbgl {
 
 VectorTile::VectorTile(const OverscaledTileID& id_,
                        std::string sourceID_,
                        const TileParameters& parameters,
-                       const Tileset& tileset)
-    : GeometryTile(id_, sourceID_, parameters), loader(*this, id_, parameters, tileset) {
+                       const Tileset& tileset,
+                       float simplificationTolerance)
+    : GeometryTile(id_, sourceID_, parameters, simplificationTolerance),
+      urlTemplate(tileset.tiles.empty() ? std::string() : tileset.tiles.front()),
+      loader(*this, id_, parameters, tileset) {
 }
 
 void VectorTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void VectorTile::setRequestPriority(Resource::Priority priority) {
+    loader.setPriority(priority);
+}
+
 void VectorTile::setData(std::shared_ptr<const std::string> data_,
                          optional<Timestamp> modified_,
                          optional<Timestamp> expires_) {
     modified = modified_;
     expires = expires_;
 
-    GeometryTile::setData(data_ ? std::make_unique<VectorTileData>(data_) : nullptr);
+    if (!data_) {
+        GeometryTile::setData(nullptr);
+        return;
+    }
+
+    // Tiles past the source's maximum zoom level all lay out the same canonical tile.
+    GeometryTile::setData(std::make_unique<VectorTileData>(
+        VectorTileDataCache::shared().get(urlTemplate, id.canonical, std::move(data_)),
+        id.overscaleFactor() > 1));
 }
 
 } // namespace mbgl
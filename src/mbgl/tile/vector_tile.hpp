@@ -13,14 +13,17 @@ public:
     VectorTile(const OverscaledTileID&,
                std::string sourceID,
                const TileParameters&,
-               const Tileset&);
+               const Tileset&,
+               float simplificationTolerance = 0);
 
     void setNecessity(Necessity) final;
+    void setRequestPriority(Resource::Priority) final;
     void setData(std::shared_ptr<const std::string> data,
                  optional<Timestamp> modified,
                  optional<Timestamp> expires);
 
 private:
+    const std::string urlTemplate;
     TileLoader<VectorTile> loader;
 };
 
@@ -1,11 +1,21 @@
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/constants.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
 namespace mbgl {
 
-VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
-                                     const protozero::data_view& view)
-    : feature(view, layer) {
+VectorTileFeature::VectorTileFeature(const VectorTileLayer& layer_,
+                                     const protozero::data_view& view_,
+                                     optional<std::size_t> sharedIndex_)
+    : layer(layer_),
+      view(view_),
+      feature(view_, layer_.layer),
+      sharedIndex(std::move(sharedIndex_)) {
 }
 
 FeatureType VectorTileFeature::getType() const {
@@ -21,12 +31,54 @@ FeatureType VectorTileFeature::getType() const {
     }
 }
 
+const VectorTileFeature::Tags& VectorTileFeature::getTags() const {
+    if (!tags) {
+        protozero::pbf_reader reader(view);
+        tags = Tags();
+        while (reader.next(2 /* tags */)) {
+            tags = reader.get_packed_uint32();
+        }
+    }
+    return *tags;
+}
+
 optional<Value> VectorTileFeature::getValue(const std::string& key) const {
-    return feature.getValue(key);
+    const optional<uint32_t> keyIndex = layer.getKeyIndex(key);
+    if (!keyIndex) {
+        return {};
+    }
+
+    const Tags& range = getTags();
+    for (auto it = range.begin(); it != range.end();) {
+        const uint32_t tagKey = *it++;
+        if (it == range.end()) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+        const uint32_t tagValue = *it++;
+        if (tagKey == *keyIndex) {
+            return layer.getValue(tagValue);
+        }
+    }
+
+    return {};
 }
 
 std::unordered_map<std::string, Value> VectorTileFeature::getProperties() const {
-    return feature.getProperties();
+    std::unordered_map<std::string, Value> properties;
+
+    const Tags& range = getTags();
+    for (auto it = range.begin(); it != range.end();) {
+        const uint32_t tagKey = *it++;
+        if (it == range.end()) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+        const uint32_t tagValue = *it++;
+        if (auto value = layer.getValue(tagValue)) {
+            properties.emplace(layer.getKey(tagKey), std::move(*value));
+        }
+    }
+
+    return properties;
 }
 
 optional<FeatureIdentifier> VectorTileFeature::getID() const {
@@ -34,8 +86,177 @@ optional<FeatureIdentifier> VectorTileFeature::getID() const {
 }
 
 GeometryCollection VectorTileFeature::getGeometries() const {
+    if (sharedIndex) {
+        return layer.getSharedGeometries(*sharedIndex, *this);
+    }
+    return decodeGeometries();
+}
+
+const GeometryCollection* VectorTileFeature::getSharedGeometries() const {
+    return sharedIndex ? &layer.getSharedGeometries(*sharedIndex, *this) : nullptr;
+}
+
+namespace {
+
+enum GeometryCommand : uint32_t {
+    MoveTo = 1,
+    LineTo = 2,
+    ClosePath = 7
+};
+
+uint32_t decodeVarint(const char*& p, const char* end) {
+    // Parameters are uint32, but longer, sign-extended encodings are truncated to their low bits.
+    uint32_t value = 0;
+    for (uint32_t shift = 0; p != end && shift < 70; shift += 7) {
+        const auto byte = uint8_t(*p++);
+        if (shift < 32) {
+            value |= uint32_t(byte & 0x7F) << shift;
+        }
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw std::runtime_error("malformed geometry");
+}
+
+int32_t decodeZigZag(uint32_t value) {
+    return int32_t(value >> 1) ^ -int32_t(value & 1);
+}
+
+// Whether the next eight bytes are all single byte varints. The mask is the same in either byte
+// order.
+bool singleByteVarints(const char* p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return !(word & 0x8080808080808080ull);
+}
+
+// Skips up to `count` varints, and returns how many there were.
+uint32_t skipVarints(const char*& p, const char* end, uint32_t count) {
+    uint32_t skipped = 0;
+    while (count - skipped >= 8 && end - p >= 8 && singleByteVarints(p)) {
+        p += 8;
+        skipped += 8;
+    }
+    for (; skipped < count && p != end; p++) {
+        skipped += !(uint8_t(*p) & 0x80);
+    }
+    return skipped;
+}
+
+// Decodes a feature's geometry command stream the way mapbox::vector_tile::feature::getGeometries()
+// does, in two passes: the first one only finds the number of points of every ring from the
+// command headers, so that the second one allocates each ring once, at its final size, while it
+// decodes the points. Runs of single byte parameters, the common delta encoded case, are decoded
+// four points at a time.
+GeometryCollection decodeGeometry(const protozero::data_view& geometry, float scale) {
+    const char* const begin = geometry.data();
+    const char* const end = begin + geometry.size();
+
+    std::vector<uint32_t> sizes(1, 0);
+    for (const char* p = begin; p != end;) {
+        const uint32_t header = decodeVarint(p, end);
+        const uint32_t count = header >> 3;
+        switch (header & 0x7) {
+        case MoveTo:
+            for (uint32_t i = skipVarints(p, end, count * 2) / 2; i > 0; i--) {
+                if (sizes.back()) {
+                    sizes.push_back(0);
+                }
+                sizes.back()++;
+            }
+            break;
+        case LineTo:
+            sizes.back() += skipVarints(p, end, count * 2) / 2;
+            break;
+        case ClosePath:
+            if (sizes.back()) {
+                sizes.back()++;
+            }
+            break;
+        default:
+            throw std::runtime_error("unknown command");
+        }
+    }
+
+    const float minCoordinate = std::numeric_limits<int16_t>::min();
+    const float maxCoordinate = std::numeric_limits<int16_t>::max();
+
+    GeometryCollection paths;
+    paths.reserve(sizes.size());
+    paths.emplace_back();
+    paths.back().reserve(sizes.front());
+
+    int32_t x = 0;
+    int32_t y = 0;
+    auto append = [&] () {
+        // Points that are out of range are dropped, like mapbox::vector_tile does.
+        const float px = std::round(x * scale);
+        const float py = std::round(y * scale);
+        if (px >= minCoordinate && px <= maxCoordinate && py >= minCoordinate && py <= maxCoordinate) {
+            paths.back().emplace_back(int16_t(px), int16_t(py));
+        }
+    };
+
+    for (const char* p = begin; p != end;) {
+        const uint32_t header = decodeVarint(p, end);
+        const uint32_t count = header >> 3;
+        switch (header & 0x7) {
+        case MoveTo:
+            for (uint32_t i = 0; i < count; i++) {
+                if (!paths.back().empty()) {
+                    paths.emplace_back();
+                    if (paths.size() <= sizes.size()) {
+                        paths.back().reserve(sizes[paths.size() - 1]);
+                    }
+                }
+                x += decodeZigZag(decodeVarint(p, end));
+                y += decodeZigZag(decodeVarint(p, end));
+                append();
+            }
+            break;
+        case LineTo: {
+            uint32_t remaining = count;
+            while (remaining >= 4 && end - p >= 8 && singleByteVarints(p)) {
+                for (std::size_t i = 0; i < 8; i += 2) {
+                    x += decodeZigZag(uint8_t(p[i]));
+                    y += decodeZigZag(uint8_t(p[i + 1]));
+                    append();
+                }
+                p += 8;
+                remaining -= 4;
+            }
+            for (; remaining > 0; remaining--) {
+                x += decodeZigZag(decodeVarint(p, end));
+                y += decodeZigZag(decodeVarint(p, end));
+                append();
+            }
+            break;
+        }
+        case ClosePath:
+            if (!paths.back().empty()) {
+                paths.back().push_back(paths.back().front());
+            }
+            break;
+        default:
+            throw std::runtime_error("unknown command");
+        }
+    }
+
+    return paths;
+}
+
+} // namespace
+
+GeometryCollection VectorTileFeature::decodeGeometries() const {
+    protozero::data_view geometry;
+    protozero::pbf_reader reader(view);
+    while (reader.next(4 /* geometry */)) {
+        geometry = reader.get_view();
+    }
+
     const float scale = float(util::EXTENT) / feature.getExtent();
-    auto lines = feature.getGeometries<GeometryCollection>(scale);
+    auto lines = decodeGeometry(geometry, scale);
     if (feature.getVersion() >= 2 || feature.getType() != mapbox::vector_tile::GeomType::POLYGON) {
         return lines;
     } else {
@@ -46,6 +267,33 @@ GeometryCollection VectorTileFeature::getGeometries() const {
 VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
                                  const protozero::data_view& view)
     : data(std::move(data_)), layer(view) {
+    protozero::pbf_reader reader(view);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case 3: { // keys
+            const protozero::data_view key = reader.get_view();
+            keyIndices.emplace(std::string(key.data(), key.size()), uint32_t(keys.size()));
+            keys.emplace_back(key.data(), key.size());
+            break;
+        }
+        case 4: // values
+            values.push_back(reader.get_view());
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
+}
+
+std::size_t VectorTileLayer::byteSize() const {
+    std::size_t result = keys.capacity() * sizeof(std::string) + values.capacity() * sizeof(protozero::data_view) +
+                         sharedGeometryBytes;
+    for (const auto& key : keys) {
+        // Each key is also held by its entry in the index, with a hash node around it.
+        result += 2 * key.capacity() + sizeof(std::string) + sizeof(uint32_t) + 2 * sizeof(void*);
+    }
+    return result;
 }
 
 std::size_t VectorTileLayer::featureCount() const {
@@ -53,37 +301,236 @@ std::size_t VectorTileLayer::featureCount() const {
 }
 
 std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i));
+    return std::make_unique<VectorTileFeature>(*this, layer.getFeature(i));
+}
+
+std::unique_ptr<GeometryTileFeature> VectorTileLayer::getSharedFeature(std::size_t i) const {
+    return std::make_unique<VectorTileFeature>(*this, layer.getFeature(i), i);
+}
+
+const GeometryCollection& VectorTileLayer::getSharedGeometries(std::size_t i, const VectorTileFeature& feature) const {
+    std::call_once(sharedAllocated, [&] {
+        const std::size_t count = featureCount();
+        sharedGeometries = std::make_unique<GeometryCollection[]>(count);
+        sharedDecoded = std::make_unique<std::once_flag[]>(count);
+        sharedGeometryBytes += count * (sizeof(GeometryCollection) + sizeof(std::once_flag));
+    });
+    std::call_once(sharedDecoded[i], [&] {
+        sharedGeometries[i] = feature.decodeGeometries();
+        std::size_t bytes = sharedGeometries[i].capacity() * sizeof(GeometryCoordinates);
+        for (const auto& ring : sharedGeometries[i]) {
+            bytes += ring.capacity() * sizeof(GeometryCoordinate);
+        }
+        sharedGeometryBytes += bytes;
+    });
+    return sharedGeometries[i];
 }
 
 std::string VectorTileLayer::getName() const {
     return layer.getName();
 }
 
-VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_) : data(std::move(data_)) {
+optional<uint32_t> VectorTileLayer::getKeyIndex(const std::string& key) const {
+    auto it = keyIndices.find(key);
+    if (it == keyIndices.end()) {
+        return {};
+    }
+    return it->second;
 }
 
-std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
-    return std::make_unique<VectorTileData>(data);
+const std::string& VectorTileLayer::getKey(uint32_t keyIndex) const {
+    if (keyIndex >= keys.size()) {
+        throw std::runtime_error("feature referenced out of range key");
+    }
+    return keys[keyIndex];
 }
 
-std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
-    if (!parsed) {
-        // We're parsing this lazily so that we can construct VectorTileData objects on the main
-        // thread without incurring the overhead of parsing immediately.
-        layers = mapbox::vector_tile::buffer(*data).getLayers();
-        parsed = true;
+optional<Value> VectorTileLayer::getValue(uint32_t valueIndex) const {
+    if (valueIndex >= values.size()) {
+        throw std::runtime_error("feature referenced out of range value");
     }
 
+    protozero::pbf_reader reader(values[valueIndex]);
+    while (reader.next()) {
+        switch (reader.tag()) {
+        case 1: // string_value
+            return Value(reader.get_string());
+        case 2: // float_value
+            return Value(double(reader.get_float()));
+        case 3: // double_value
+            return Value(reader.get_double());
+        case 4: // int_value
+            return Value(int64_t(reader.get_int64()));
+        case 5: // uint_value
+            return Value(uint64_t(reader.get_uint64()));
+        case 6: // sint_value
+            return Value(int64_t(reader.get_sint64()));
+        case 7: // bool_value
+            return Value(reader.get_bool());
+        default:
+            reader.skip();
+            break;
+        }
+    }
+
+    return {};
+}
+
+namespace {
+
+// A layer owned by a ParsedVectorTile, handed out as a GeometryTileLayer of its own.
+class SharedVectorTileLayer : public GeometryTileLayer {
+public:
+    SharedVectorTileLayer(std::shared_ptr<const VectorTileLayer> layer_, bool keepGeometries_)
+        : layer(std::move(layer_)), keepGeometries(keepGeometries_) {
+    }
+
+    std::size_t featureCount() const override {
+        return layer->featureCount();
+    }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return keepGeometries ? layer->getSharedFeature(i) : layer->getFeature(i);
+    }
+
+    std::string getName() const override {
+        return layer->getName();
+    }
+
+private:
+    const std::shared_ptr<const VectorTileLayer> layer;
+    const bool keepGeometries;
+};
+
+} // namespace
+
+ParsedVectorTile::ParsedVectorTile(std::shared_ptr<const std::string> data_) : data(std::move(data_)) {
+}
+
+std::shared_ptr<const VectorTileLayer> ParsedVectorTile::getLayer(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
     auto it = layers.find(name);
     if (it != layers.end()) {
-        return std::make_unique<VectorTileLayer>(data, it->second);
+        return it->second;
+    }
+
+    const auto& index = getIndex();
+    auto view = std::find_if(index.begin(), index.end(), [&] (const auto& entry) {
+        return entry.first.size() == name.size() && std::equal(name.begin(), name.end(), entry.first.data());
+    });
+    if (view == index.end()) {
+        return nullptr;
+    }
+
+    auto layer = std::make_shared<const VectorTileLayer>(data, view->second);
+    layers.emplace(name, layer);
+    return layer;
+}
+
+const ParsedVectorTile::Index& ParsedVectorTile::getIndex() const {
+    // We're parsing this lazily so that we can construct VectorTileData objects on the main
+    // thread without incurring the overhead of parsing immediately. Only the names are read;
+    // layers are decoded when they're first asked for.
+    if (!parsed) {
+        protozero::pbf_reader tile(*data);
+        while (tile.next(3 /* layers */)) {
+            const protozero::data_view layer = tile.get_view();
+            protozero::pbf_reader reader(layer);
+            if (!reader.next(1 /* name */)) {
+                throw std::runtime_error("Layer missing name");
+            }
+            index.emplace_back(reader.get_view(), layer);
+        }
+        parsed = true;
+    }
+    return index;
+}
+
+std::size_t ParsedVectorTile::releaseLayers() const {
+    return releaseLayers([] (const std::string&) { return true; });
+}
+
+std::size_t ParsedVectorTile::releaseLayersExcept(const std::unordered_set<std::string>& sourceLayers) const {
+    return releaseLayers([&] (const std::string& name) { return sourceLayers.count(name) == 0; });
+}
+
+std::size_t ParsedVectorTile::releaseLayers(const std::function<bool (const std::string&)>& release) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::size_t result = 0;
+    for (auto it = layers.begin(); it != layers.end();) {
+        if (it->second.use_count() == 1 && release(it->first)) {
+            result += sizeof(VectorTileLayer) + it->second->byteSize();
+            it = layers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return result;
+}
+
+std::size_t ParsedVectorTile::byteSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::size_t result = data->size();
+    for (const auto& layer : layers) {
+        result += sizeof(VectorTileLayer) + layer.second->byteSize();
+    }
+    return result;
+}
+
+std::vector<std::string> ParsedVectorTile::layerNames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::string> result;
+    for (const auto& entry : getIndex()) {
+        result.emplace_back(entry.first.data(), entry.first.size());
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+VectorTileData::VectorTileData(std::shared_ptr<const std::string> data)
+    : tile(std::make_shared<const ParsedVectorTile>(std::move(data))),
+      keepGeometries(false) {
+}
+
+VectorTileData::VectorTileData(std::shared_ptr<const ParsedVectorTile> tile_, bool keepGeometries_)
+    : tile(std::move(tile_)),
+      keepGeometries(keepGeometries_) {
+}
+
+std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
+    return std::make_unique<VectorTileData>(tile, keepGeometries);
+}
+
+std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
+    if (auto layer = tile->getLayer(name)) {
+        return std::make_unique<SharedVectorTileLayer>(std::move(layer), keepGeometries);
     }
     return nullptr;
 }
 
+std::size_t VectorTileData::byteSize() const {
+    return tile->getData()->size();
+}
+
+std::size_t VectorTileData::releaseParsed() const {
+    return tile->releaseLayers();
+}
+
+std::size_t VectorTileData::releaseUnusedLayers(const std::unordered_set<std::string>& sourceLayers) const {
+    return tile->releaseLayersExcept(sourceLayers);
+}
+
+optional<std::size_t> VectorTileData::contentHash() const {
+    return std::hash<std::string>()(*tile->getData());
+}
+
 std::vector<std::string> VectorTileData::layerNames() const {
-    return mapbox::vector_tile::buffer(*data).layerNames();
+    return tile->layerNames();
 }
 
 } // namespace mbgl
@@ -3,24 +3,44 @@
 #include <mapbox/vector_tile.hpp>
 #include <protozero/pbf_reader.hpp>
 
+#include <atomic>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <utility>
 
 namespace mbgl {
 
+class VectorTileLayer;
+
 class VectorTileFeature : public GeometryTileFeature {
 public:
-    VectorTileFeature(const mapbox::vector_tile::layer&, const protozero::data_view&);
+    // With an index, the feature's geometries are decoded once and kept by the layer.
+    VectorTileFeature(const VectorTileLayer&, const protozero::data_view&,
+                      optional<std::size_t> sharedIndex = {});
 
     FeatureType getType() const override;
     optional<Value> getValue(const std::string& key) const override;
     std::unordered_map<std::string, Value> getProperties() const override;
     optional<FeatureIdentifier> getID() const override;
     GeometryCollection getGeometries() const override;
+    const GeometryCollection* getSharedGeometries() const override;
 
 private:
+    friend class VectorTileLayer;
+    GeometryCollection decodeGeometries() const;
+
+    // The feature's packed (key index, value index) tag pairs, located on first use.
+    using Tags = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+    const Tags& getTags() const;
+
+    const VectorTileLayer& layer;
+    const protozero::data_view view;
     mapbox::vector_tile::feature feature;
+    const optional<std::size_t> sharedIndex;
+    mutable optional<Tags> tags;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
@@ -31,24 +51,93 @@ public:
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override;
     std::string getName() const override;
 
+    // The returned feature shares its decoded geometries with all other features returned for
+    // the same index.
+    std::unique_ptr<GeometryTileFeature> getSharedFeature(std::size_t i) const;
+
+    // Properties are stored as indices into the layer's key and value tables. Keys are resolved
+    // to their index once per layer; values are decoded straight from the tile data on access.
+    optional<uint32_t> getKeyIndex(const std::string& key) const;
+    const std::string& getKey(uint32_t keyIndex) const;
+    optional<Value> getValue(uint32_t valueIndex) const;
+
+    // The bytes of the key and value tables and of the shared geometries.
+    std::size_t byteSize() const;
+
 private:
+    friend class VectorTileFeature;
+
+    const GeometryCollection& getSharedGeometries(std::size_t i, const VectorTileFeature&) const;
+
     std::shared_ptr<const std::string> data;
     mapbox::vector_tile::layer layer;
+
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> keyIndices;
+    std::vector<protozero::data_view> values;
+
+    // Allocated when the first shared feature is decoded.
+    mutable std::once_flag sharedAllocated;
+    mutable std::unique_ptr<GeometryCollection[]> sharedGeometries;
+    mutable std::unique_ptr<std::once_flag[]> sharedDecoded;
+    mutable std::atomic<std::size_t> sharedGeometryBytes { 0 };
+};
+
+// The parsed contents of a vector tile. Layers are located on first access and each layer's key
+// and value tables are built once, so that every VectorTileData sharing a ParsedVectorTile, on any
+// thread, reuses the same parse.
+class ParsedVectorTile {
+public:
+    ParsedVectorTile(std::shared_ptr<const std::string> data);
+
+    std::shared_ptr<const VectorTileLayer> getLayer(const std::string& name) const;
+    std::vector<std::string> layerNames() const;
+
+    // Drop the layers that nothing else holds on to, and return the bytes they took.
+    std::size_t releaseLayers() const;
+    std::size_t releaseLayersExcept(const std::unordered_set<std::string>& sourceLayers) const;
+
+    const std::shared_ptr<const std::string>& getData() const { return data; }
+
+    // The bytes of the data and of the layers parsed so far, which grows as layers are parsed and
+    // shared geometries are decoded.
+    std::size_t byteSize() const;
+
+private:
+    // The name and the bytes of each layer, in tile order.
+    using Index = std::vector<std::pair<protozero::data_view, protozero::data_view>>;
+    const Index& getIndex() const;
+
+    std::size_t releaseLayers(const std::function<bool (const std::string&)>&) const;
+
+    const std::shared_ptr<const std::string> data;
+
+    mutable std::mutex mutex;
+    mutable bool parsed = false;
+    mutable Index index;
+    mutable std::map<std::string, std::shared_ptr<const VectorTileLayer>> layers;
 };
 
 class VectorTileData : public GeometryTileData {
 public:
     VectorTileData(std::shared_ptr<const std::string> data);
 
+    // Overscaled tiles keep the geometries they decode in the parsed tile, so that tiles of the
+    // other zoom levels past the source's maximum zoom level reuse them.
+    VectorTileData(std::shared_ptr<const ParsedVectorTile>, bool keepGeometries = false);
+
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
+    std::size_t byteSize() const override;
+    std::size_t releaseParsed() const override;
+    std::size_t releaseUnusedLayers(const std::unordered_set<std::string>& sourceLayers) const override;
+    optional<std::size_t> contentHash() const override;
 
     std::vector<std::string> layerNames() const;
 
 private:
-    std::shared_ptr<const std::string> data;
-    mutable bool parsed = false;
-    mutable std::map<std::string, const protozero::data_view> layers;
+    std::shared_ptr<const ParsedVectorTile> tile;
+    const bool keepGeometries;
 };
 
 } // namespace mbgl
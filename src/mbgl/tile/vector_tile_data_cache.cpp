@@ -0,0 +1,89 @@
+#include <mbgl/tile/vector_tile_data_cache.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+
+VectorTileDataCache::VectorTileDataCache(std::size_t maximumSize_)
+    : maximumSize(maximumSize_) {
+}
+
+VectorTileDataCache& VectorTileDataCache::shared() {
+    static VectorTileDataCache cache(util::DEFAULT_VECTOR_TILE_DATA_CACHE_SIZE);
+    return cache;
+}
+
+std::shared_ptr<const ParsedVectorTile> VectorTileDataCache::get(const std::string& urlTemplate,
+                                                                 const CanonicalTileID& tileID,
+                                                                 std::shared_ptr<const std::string> data) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Key key { urlTemplate, tileID };
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        const auto& cached = it->second.tile->getData();
+        if (cached == data || *cached == *data) {
+            order.splice(order.end(), order, it->second.position);
+            return it->second.tile;
+        }
+
+        size -= it->second.size;
+        order.erase(it->second.position);
+        entries.erase(it);
+    }
+
+    auto tile = std::make_shared<const ParsedVectorTile>(std::move(data));
+    if (tile->getData()->size() > maximumSize) {
+        return tile;
+    }
+
+    size += tile->getData()->size();
+    order.push_back(key);
+    entries.emplace(std::move(key), Entry { tile, std::prev(order.end()), tile->getData()->size() });
+    measure();
+    evict();
+
+    return tile;
+}
+
+void VectorTileDataCache::setMaximumSize(std::size_t maximumSize_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumSize = maximumSize_;
+    measure();
+    evict();
+}
+
+std::size_t VectorTileDataCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t result = 0;
+    for (const auto& entry : entries) {
+        result += entry.second.tile->byteSize();
+    }
+    return result;
+}
+
+void VectorTileDataCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    order.clear();
+    size = 0;
+}
+
+void VectorTileDataCache::measure() {
+    for (auto& entry : entries) {
+        const std::size_t measured = entry.second.tile->byteSize();
+        size = size - entry.second.size + measured;
+        entry.second.size = measured;
+    }
+}
+
+void VectorTileDataCache::evict() {
+    while (size > maximumSize && !order.empty()) {
+        auto it = entries.find(order.front());
+        size -= it->second.size;
+        entries.erase(it);
+        order.pop_front();
+    }
+}
+
+} // namespace mbgl
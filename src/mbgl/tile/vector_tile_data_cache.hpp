@@ -0,0 +1,65 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace mbgl {
+
+class ParsedVectorTile;
+
+/*
+   A process-wide cache of parsed vector tiles, keyed by tile URL template and tile ID.
+
+   Sources that point at the same tileset, a source that is re-added after a style change, and
+   separate Map instances in the same process all receive the same ParsedVectorTile for a tile,
+   so its layers are parsed once and its data is held in memory once. An entry is only reused
+   while the tile data is unchanged; revalidated or updated data replaces it.
+
+   The cache keeps the least recently used tiles within a budget of the bytes of their data and
+   of the layers parsed from it. As tiles in the cache keep parsing layers and decoding shared
+   geometries, their sizes are measured again whenever a tile is added. Tiles in use elsewhere
+   stay alive regardless of the budget; the cache only adds to their lifetime.
+*/
+class VectorTileDataCache : private util::noncopyable {
+public:
+    VectorTileDataCache(std::size_t maximumSize);
+
+    static VectorTileDataCache& shared();
+
+    std::shared_ptr<const ParsedVectorTile> get(const std::string& urlTemplate,
+                                                const CanonicalTileID&,
+                                                std::shared_ptr<const std::string> data);
+
+    void setMaximumSize(std::size_t);
+    std::size_t getSize() const;
+    void clear();
+
+private:
+    using Key = std::pair<std::string, CanonicalTileID>;
+
+    struct Entry {
+        std::shared_ptr<const ParsedVectorTile> tile;
+        std::list<Key>::iterator position;
+        // The size the tile had when it was last measured.
+        std::size_t size;
+    };
+
+    // Brings the total up to date with the tiles' current sizes.
+    void measure();
+    void evict();
+
+    mutable std::mutex mutex;
+    std::size_t maximumSize;
+    std::size_t size = 0;
+    std::map<Key, Entry> entries;
+    std::list<Key> order; // Least recently used first.
+};
+
+} // namespace mbgl
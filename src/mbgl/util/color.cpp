@@ -1,8 +1,10 @@
 #include <mbgl/util/color.hpp>
-#include <mbgl/util/string.hpp>
+#include <mbgl/util/dtoa.hpp>
 
 #include <csscolorparser/csscolorparser.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 optional<Color> Color::parse(const std::string& s) {
@@ -23,11 +25,17 @@ optional<Color> Color::parse(const std::string& s) {
 }
 
 std::string Color::stringify() const {
-    return "rgba(" +
-        util::toString(r * 255) + "," +
-        util::toString(g * 255) + "," +
-        util::toString(b * 255) + "," +
-        util::toString(a) + ")";
+    char buffer[4 * util::dtoaBufferSize + 9];
+    char* end = std::copy_n("rgba(", 5, buffer);
+    end = util::dtoa(r * 255, end);
+    *end++ = ',';
+    end = util::dtoa(g * 255, end);
+    *end++ = ',';
+    end = util::dtoa(b * 255, end);
+    *end++ = ',';
+    end = util::dtoa(a, end);
+    *end++ = ')';
+    return std::string(buffer, end);
 }
 
 } // namespace mbgl
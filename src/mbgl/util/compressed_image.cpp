@@ -0,0 +1,178 @@
+#include <mbgl/util/compressed_image.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+const char ktxIdentifier[12] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+const char ddsMagic[4] = { 'D', 'D', 'S', ' ' };
+
+bool isKTX(const std::string& data) {
+    return data.size() >= sizeof(ktxIdentifier) &&
+        std::equal(ktxIdentifier, ktxIdentifier + sizeof(ktxIdentifier), data.begin());
+}
+
+bool isDDS(const std::string& data) {
+    return data.size() >= sizeof(ddsMagic) &&
+        std::equal(ddsMagic, ddsMagic + sizeof(ddsMagic), data.begin());
+}
+
+// Reads a little endian, or with `swap` set, big endian 32 bit integer.
+uint32_t readUint32(const std::string& data, std::size_t offset, bool swap = false) {
+    if (offset + 4 > data.size()) {
+        throw std::runtime_error("truncated compressed image");
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data() + offset);
+    if (swap) {
+        return uint32_t(bytes[0]) << 24 | uint32_t(bytes[1]) << 16 | uint32_t(bytes[2]) << 8 | bytes[3];
+    }
+    return uint32_t(bytes[3]) << 24 | uint32_t(bytes[2]) << 16 | uint32_t(bytes[1]) << 8 | bytes[0];
+}
+
+CompressedImage readImage(const std::string& data, std::size_t offset, Size size, CompressedImageFormat format) {
+    if (size.isEmpty()) {
+        throw std::runtime_error("empty compressed image");
+    }
+    const std::size_t length = CompressedImage::bytes(size, format);
+    if (offset > data.size() || data.size() - offset < length) {
+        throw std::runtime_error("truncated compressed image");
+    }
+    auto pixels = std::make_unique<uint8_t[]>(length);
+    std::memcpy(pixels.get(), data.data() + offset, length);
+    return { size, format, std::move(pixels) };
+}
+
+CompressedImageFormat checkFormat(uint32_t format) {
+    switch (CompressedImageFormat(format)) {
+    case CompressedImageFormat::ETC1_RGB8:
+    case CompressedImageFormat::ETC2_RGB8:
+    case CompressedImageFormat::ETC2_RGBA8:
+    case CompressedImageFormat::S3TC_DXT1_RGB:
+    case CompressedImageFormat::S3TC_DXT5_RGBA:
+    case CompressedImageFormat::ASTC_4x4_RGBA:
+    case CompressedImageFormat::ASTC_8x8_RGBA:
+        return CompressedImageFormat(format);
+    }
+    throw std::runtime_error("unsupported compressed image format");
+}
+
+// See https://www.khronos.org/opengles/sdk/tools/KTX/file_format_spec/
+CompressedImage decodeKTX(const std::string& data) {
+    const uint32_t endianness = readUint32(data, 12);
+    if (endianness != 0x04030201 && endianness != 0x01020304) {
+        throw std::runtime_error("invalid KTX endianness");
+    }
+    const bool swap = endianness != 0x04030201;
+
+    const uint32_t glType = readUint32(data, 16, swap);
+    const uint32_t glInternalFormat = readUint32(data, 28, swap);
+    const uint32_t pixelWidth = readUint32(data, 36, swap);
+    const uint32_t pixelHeight = readUint32(data, 40, swap);
+    const uint32_t pixelDepth = readUint32(data, 44, swap);
+    const uint32_t numberOfArrayElements = readUint32(data, 48, swap);
+    const uint32_t numberOfFaces = readUint32(data, 52, swap);
+    const uint32_t bytesOfKeyValueData = readUint32(data, 60, swap);
+
+    if (glType != 0) {
+        throw std::runtime_error("KTX image isn't compressed");
+    }
+    if (pixelDepth > 1 || numberOfArrayElements > 1 || numberOfFaces != 1) {
+        throw std::runtime_error("KTX image isn't a 2D texture");
+    }
+
+    // The header is followed by the key/value data, and by the size of the base level.
+    const std::size_t offset = 64 + std::size_t(bytesOfKeyValueData);
+    const uint32_t imageSize = readUint32(data, offset, swap);
+    const Size size { pixelWidth, pixelHeight };
+    const CompressedImageFormat format = checkFormat(glInternalFormat);
+    if (imageSize != CompressedImage::bytes(size, format)) {
+        throw std::runtime_error("mismatched KTX image size");
+    }
+    return readImage(data, offset + 4, size, format);
+}
+
+// See https://docs.microsoft.com/en-us/windows/desktop/direct3ddds/dx-graphics-dds-pguide
+CompressedImage decodeDDS(const std::string& data) {
+    const uint32_t headerSize = readUint32(data, 4);
+    if (headerSize != 124) {
+        throw std::runtime_error("invalid DDS header");
+    }
+    const uint32_t height = readUint32(data, 12);
+    const uint32_t width = readUint32(data, 16);
+    const uint32_t pixelFormatFlags = readUint32(data, 80);
+    const uint32_t fourCC = readUint32(data, 84);
+
+    const uint32_t DDPF_FOURCC = 0x4;
+    if (!(pixelFormatFlags & DDPF_FOURCC)) {
+        throw std::runtime_error("DDS image isn't compressed");
+    }
+
+    const auto code = [] (const char (&name)[5]) {
+        return uint32_t(uint8_t(name[0])) | uint32_t(uint8_t(name[1])) << 8 |
+            uint32_t(uint8_t(name[2])) << 16 | uint32_t(uint8_t(name[3])) << 24;
+    };
+
+    CompressedImageFormat format;
+    if (fourCC == code("DXT1")) {
+        format = CompressedImageFormat::S3TC_DXT1_RGB;
+    } else if (fourCC == code("DXT5")) {
+        format = CompressedImageFormat::S3TC_DXT5_RGBA;
+    } else {
+        throw std::runtime_error("unsupported compressed image format");
+    }
+
+    // The magic number and the header precede the base level.
+    return readImage(data, 4 + headerSize, { width, height }, format);
+}
+
+} // namespace
+
+CompressedImage::CompressedImage(Size size_, CompressedImageFormat format_, std::unique_ptr<uint8_t[]> data_)
+    : size(std::move(size_)),
+      format(format_),
+      data(std::move(data_)) {
+}
+
+std::size_t CompressedImage::bytes(Size imageSize, CompressedImageFormat imageFormat) {
+    std::size_t blockWidth = 4;
+    std::size_t blockHeight = 4;
+    std::size_t blockBytes = 16;
+
+    switch (imageFormat) {
+    case CompressedImageFormat::ETC1_RGB8:
+    case CompressedImageFormat::ETC2_RGB8:
+    case CompressedImageFormat::S3TC_DXT1_RGB:
+        blockBytes = 8;
+        break;
+    case CompressedImageFormat::ETC2_RGBA8:
+    case CompressedImageFormat::S3TC_DXT5_RGBA:
+    case CompressedImageFormat::ASTC_4x4_RGBA:
+        break;
+    case CompressedImageFormat::ASTC_8x8_RGBA:
+        blockWidth = 8;
+        blockHeight = 8;
+        break;
+    }
+
+    return ((imageSize.width + blockWidth - 1) / blockWidth) *
+        ((imageSize.height + blockHeight - 1) / blockHeight) * blockBytes;
+}
+
+bool isCompressedImage(const std::string& data) {
+    return isKTX(data) || isDDS(data);
+}
+
+CompressedImage decodeCompressedImage(const std::string& data) {
+    if (isKTX(data)) {
+        return decodeKTX(data);
+    } else if (isDDS(data)) {
+        return decodeDDS(data);
+    }
+    throw std::runtime_error("unsupported compressed image container");
+}
+
+} // namespace mbgl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/size.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+// Block-compressed texture formats, with the values of their GL internal formats.
+enum class CompressedImageFormat : uint32_t {
+    ETC1_RGB8 = 0x8D64,
+    ETC2_RGB8 = 0x9274,
+    ETC2_RGBA8 = 0x9278,
+    S3TC_DXT1_RGB = 0x83F0,
+    S3TC_DXT5_RGBA = 0x83F3,
+    ASTC_4x4_RGBA = 0x93B0,
+    ASTC_8x8_RGBA = 0x93B7,
+};
+
+// An image in a format that GPUs decode themselves, so it can be uploaded as it is and takes up
+// a fraction of the memory of its RGBA pixels. Only the base mipmap level is kept. Colors with
+// alpha are expected to be premultiplied already.
+class CompressedImage : private util::noncopyable {
+public:
+    CompressedImage(Size, CompressedImageFormat, std::unique_ptr<uint8_t[]>);
+
+    CompressedImage(CompressedImage&&) = default;
+    CompressedImage& operator=(CompressedImage&&) = default;
+
+    // The size of the image data, in bytes.
+    std::size_t bytes() const {
+        return bytes(size, format);
+    }
+
+    static std::size_t bytes(Size, CompressedImageFormat);
+
+    Size size;
+    CompressedImageFormat format;
+    std::unique_ptr<uint8_t[]> data;
+};
+
+// Returns true if the data looks like a KTX or DDS container.
+bool isCompressedImage(const std::string&);
+
+// Reads the base level of a KTX or DDS container. Throws if the container is malformed, or if it
+// holds a format other than the ones above.
+CompressedImage decodeCompressedImage(const std::string&);
+
+} // namespace mbgl
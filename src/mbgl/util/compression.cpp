@@ -2,8 +2,16 @@
 
 #include <zlib.h>
 
+#if MBGL_USE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 
 // Check zlib library version.
@@ -28,37 +36,35 @@ namespace util {
 #undef compress
 
 std::string compress(const std::string &raw) {
+    return compress(raw, Z_DEFAULT_COMPRESSION);
+}
+
+std::string compress(const std::string &raw, int level) {
     z_stream deflate_stream;
     memset(&deflate_stream, 0, sizeof(deflate_stream));
 
     // TODO: reuse z_streams
-    if (deflateInit(&deflate_stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    if (deflateInit(&deflate_stream, level) != Z_OK) {
         throw std::runtime_error("failed to initialize deflate");
     }
 
     deflate_stream.next_in = (Bytef *)raw.data();
     deflate_stream.avail_in = uInt(raw.size());
 
-    std::string result;
-    char out[16384];
+    // Deflate straight into the result, which is large enough for a single pass.
+    std::string result(deflateBound(&deflate_stream, uLong(raw.size())), '\0');
+    deflate_stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+    deflate_stream.avail_out = uInt(result.size());
 
-    int code;
-    do {
-        deflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        deflate_stream.avail_out = sizeof(out);
-        code = deflate(&deflate_stream, Z_FINISH);
-        if (result.size() < deflate_stream.total_out) {
-            // append the block to the output string
-            result.append(out, deflate_stream.total_out - result.size());
-        }
-    } while (code == Z_OK);
+    const int code = deflate(&deflate_stream, Z_FINISH);
 
     deflateEnd(&deflate_stream);
 
     if (code != Z_STREAM_END) {
-        throw std::runtime_error(deflate_stream.msg);
+        throw std::runtime_error(deflate_stream.msg ? deflate_stream.msg : "compression error");
     }
 
+    result.resize(deflate_stream.total_out);
     return result;
 }
 
@@ -67,25 +73,26 @@ std::string decompress(const std::string &raw) {
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accept gzip as well as zlib streams.
+    if (inflateInit2(&inflate_stream, MAX_WBITS + 32) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
     inflate_stream.next_in = (Bytef *)raw.data();
     inflate_stream.avail_in = uInt(raw.size());
 
-    std::string result;
-    char out[15384];
+    // Inflate straight into the result, growing it geometrically from an estimate of the
+    // compression ratio, rather than through an intermediate buffer.
+    std::string result(std::max<std::size_t>(raw.size() * 4, 1024), '\0');
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (inflate_stream.total_out == result.size()) {
+            result.resize(result.size() * 2);
         }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[inflate_stream.total_out]);
+        inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
+        code = inflate(&inflate_stream, 0);
     } while (code == Z_OK);
 
     inflateEnd(&inflate_stream);
@@ -94,7 +101,124 @@ std::string decompress(const std::string &raw) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
+    result.resize(inflate_stream.total_out);
     return result;
 }
+
+bool isCodecAvailable(Codec codec) {
+    switch (codec) {
+    case Codec::None:
+    case Codec::Zlib:
+        return true;
+    case Codec::Zstd:
+#if MBGL_USE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+#if MBGL_USE_ZSTD
+namespace {
+
+void checkZstd(size_t code) {
+    if (ZSTD_isError(code)) {
+        throw std::runtime_error(ZSTD_getErrorName(code));
+    }
+}
+
+} // namespace
+#endif
+
+std::string compress(const std::string& raw, Codec codec, const std::string& dictionary) {
+    switch (codec) {
+    case Codec::None:
+        return raw;
+    case Codec::Zlib:
+        return compress(raw);
+    case Codec::Zstd: {
+#if MBGL_USE_ZSTD
+        static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> context { ZSTD_createCCtx(), ZSTD_freeCCtx };
+
+        std::string result(ZSTD_compressBound(raw.size()), '\0');
+        const size_t size = ZSTD_compress_usingDict(context.get(), &result[0], result.size(),
+                                                    raw.data(), raw.size(),
+                                                    dictionary.data(), dictionary.size(), 3);
+        checkZstd(size);
+        result.resize(size);
+        return result;
+#else
+        (void)dictionary;
+        break;
+#endif
+    }
+    }
+    throw std::runtime_error("unsupported codec");
+}
+
+std::string decompress(const std::string& raw, Codec codec, const std::string& dictionary) {
+    switch (codec) {
+    case Codec::None:
+        return raw;
+    case Codec::Zlib:
+        return decompress(raw);
+    case Codec::Zstd: {
+#if MBGL_USE_ZSTD
+        static thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> context { ZSTD_createDCtx(), ZSTD_freeDCtx };
+
+        // Frames written by compress() above always record their content size.
+        const unsigned long long contentSize = ZSTD_getFrameContentSize(raw.data(), raw.size());
+        if (contentSize == ZSTD_CONTENTSIZE_ERROR || contentSize == ZSTD_CONTENTSIZE_UNKNOWN) {
+            throw std::runtime_error("invalid zstd frame");
+        }
+
+        std::string result(contentSize, '\0');
+        const size_t size = ZSTD_decompress_usingDict(context.get(), &result[0], result.size(),
+                                                      raw.data(), raw.size(),
+                                                      dictionary.data(), dictionary.size());
+        checkZstd(size);
+        result.resize(size);
+        return result;
+#else
+        (void)dictionary;
+        break;
+#endif
+    }
+    }
+    throw std::runtime_error("unsupported codec");
+}
+
+optional<std::string> trainDictionary(Codec codec, const std::vector<std::string>& samples, std::size_t size) {
+#if MBGL_USE_ZSTD
+    if (codec == Codec::Zstd) {
+        std::string buffer;
+        std::vector<size_t> sizes;
+        buffer.reserve(std::accumulate(samples.begin(), samples.end(), size_t(0), [] (size_t sum, const std::string& sample) {
+            return sum + sample.size();
+        }));
+        for (const auto& sample : samples) {
+            buffer += sample;
+            sizes.push_back(sample.size());
+        }
+
+        std::string dictionary(size, '\0');
+        const size_t result = ZDICT_trainFromBuffer(&dictionary[0], dictionary.size(),
+                                                    buffer.data(), sizes.data(), unsigned(sizes.size()));
+        if (ZDICT_isError(result)) {
+            return {};
+        }
+        dictionary.resize(result);
+        return dictionary;
+    }
+#else
+    (void)samples;
+    (void)size;
+#endif
+    (void)codec;
+    return {};
+}
+
 } // namespace util
 } // namespace mbgl
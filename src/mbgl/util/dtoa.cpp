@@ -8,6 +8,10 @@
 
 #include <mbgl/util/string.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 namespace mbgl {
 namespace util {
 
@@ -102,15 +106,24 @@ char* dtoa(double value, char* buffer) {
 }
 
 std::string dtoa(double value) {
-    std::string data;
-    data.resize(25);
-    auto end = dtoa(value, const_cast<char*>(data.data()));
-    data.resize(end - data.data());
-    return data;
+    // Most numbers fit into the string's own storage, so that only long ones allocate.
+    char buffer[dtoaBufferSize];
+    return std::string(buffer, dtoa(value, buffer));
 }
 
 #else
 
+char* dtoa(double value, char* buffer) {
+    char result[dtoaBufferSize + 1];
+    const int length = std::snprintf(result, sizeof(result), "%.17g", value);
+    if (length <= 0) {
+        return buffer;
+    }
+    const std::size_t written = std::min<std::size_t>(length, dtoaBufferSize);
+    std::memcpy(buffer, result, written);
+    return buffer + written;
+}
+
 std::string dtoa(double value) {
     return std::to_string(value);
 }
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace mbgl {
 namespace util {
 
+// The most characters dtoa() writes for any number.
+constexpr std::size_t dtoaBufferSize = 25;
+
+// Writes the shortest representation of `value` that reads back as it to `buffer`, which must
+// have room for dtoaBufferSize characters, and returns the end of what it wrote. The result
+// isn't terminated. Nothing is allocated, for formatting many numbers into a single string.
+char* dtoa(double value, char* buffer);
+
 std::string dtoa(double value);
 
 } // end namespace util
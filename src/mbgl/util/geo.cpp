@@ -8,12 +8,12 @@ namespace mbgl {
 
 namespace {
 
-double lat_(const uint8_t z, const int64_t y) {
+double lat_(const uint8_t z, const double y) {
     const double n = M_PI - 2.0 * M_PI * y / std::pow(2.0, z);
     return util::RAD2DEG * std::atan(0.5 * (std::exp(n) - std::exp(-n)));
 }
 
-double lon_(const uint8_t z, const int64_t x) {
+double lon_(const uint8_t z, const double x) {
     return x / std::pow(2.0, z) * util::DEGREES_MAX - util::LONGITUDE_MAX;
 }
 
@@ -32,6 +32,11 @@ LatLngBounds::LatLngBounds(const CanonicalTileID& id)
       ne({ lat_(id.z, id.y), lon_(id.z, id.x + 1) }) {
 }
 
+LatLngBounds::LatLngBounds(const CanonicalTileID& id, double buffer)
+    : sw({ lat_(id.z, id.y + 1 + buffer), lon_(id.z, id.x - buffer) }),
+      ne({ lat_(id.z, id.y - buffer), lon_(id.z, id.x + 1 + buffer) }) {
+}
+
 ScreenCoordinate EdgeInsets::getCenter(uint16_t width, uint16_t height) const {
     return {
         (width - left() - right()) / 2.0 + left(),
@@ -0,0 +1,325 @@
+#include <mbgl/util/geobuf.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+using namespace mapbox::geometry;
+
+enum class GeometryType : uint32_t {
+    Point = 0,
+    MultiPoint = 1,
+    LineString = 2,
+    MultiLineString = 3,
+    Polygon = 4,
+    MultiPolygon = 5,
+    GeometryCollection = 6
+};
+
+Value toValue(const JSValue& json) {
+    if (json.IsObject()) {
+        PropertyMap map;
+        for (const auto& member : json.GetObject()) {
+            map.emplace(std::string(member.name.GetString(), member.name.GetStringLength()), toValue(member.value));
+        }
+        return map;
+    } else if (json.IsArray()) {
+        std::vector<Value> array;
+        array.reserve(json.Size());
+        for (const auto& element : json.GetArray()) {
+            array.push_back(toValue(element));
+        }
+        return array;
+    } else if (json.IsString()) {
+        return std::string(json.GetString(), json.GetStringLength());
+    } else if (json.IsBool()) {
+        return json.GetBool();
+    } else if (json.IsUint64()) {
+        return json.GetUint64();
+    } else if (json.IsInt64()) {
+        return json.GetInt64();
+    } else if (json.IsNumber()) {
+        return json.GetDouble();
+    }
+    return NullValue();
+}
+
+class GeobufDecoder {
+public:
+    GeoJSON decode(const std::string& data) {
+        protozero::pbf_reader reader(data);
+        protozero::pbf_reader content;
+        uint32_t contentTag = 0;
+
+        while (reader.next()) {
+            switch (reader.tag()) {
+            case 1: // keys
+                keys.push_back(reader.get_string());
+                break;
+            case 2: // dimensions
+                dimensions = reader.get_uint32();
+                break;
+            case 3: // precision
+                precision = std::pow(10.0, reader.get_uint32());
+                break;
+            case 4: // feature_collection
+            case 5: // feature
+            case 6: // geometry
+                contentTag = reader.tag();
+                content = reader.get_message();
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+
+        if (dimensions < 2) {
+            throw std::runtime_error("geobuf data must have at least two dimensions");
+        }
+
+        // The content is decoded last, because it refers to the keys.
+        switch (contentTag) {
+        case 4:
+            return featureCollection(content);
+        case 5:
+            return feature(content);
+        case 6:
+            return geometry(content);
+        default:
+            throw std::runtime_error("geobuf data has no content");
+        }
+    }
+
+private:
+    std::vector<std::string> keys;
+    uint32_t dimensions = 2;
+    double precision = 1e6;
+
+    FeatureCollection featureCollection(protozero::pbf_reader reader) {
+        FeatureCollection features;
+        while (reader.next(1 /* features */)) {
+            features.push_back(feature(reader.get_message()));
+        }
+        return features;
+    }
+
+    Feature feature(protozero::pbf_reader reader) {
+        Feature result;
+        bool hasGeometry = false;
+        std::vector<Value> values;
+        std::vector<uint32_t> properties;
+
+        while (reader.next()) {
+            switch (reader.tag()) {
+            case 1: // geometry
+                result.geometry = geometry(reader.get_message());
+                hasGeometry = true;
+                break;
+            case 11: // id
+                result.id = FeatureIdentifier(reader.get_string());
+                break;
+            case 12: { // int_id
+                const int64_t id = reader.get_sint64();
+                if (id >= 0) {
+                    result.id = FeatureIdentifier(uint64_t(id));
+                } else {
+                    result.id = FeatureIdentifier(id);
+                }
+                break;
+            }
+            case 13: // values
+                values.push_back(value(reader.get_message()));
+                break;
+            case 14: { // properties
+                auto range = reader.get_packed_uint32();
+                properties.insert(properties.end(), range.begin(), range.end());
+                break;
+            }
+            default:
+                reader.skip();
+                break;
+            }
+        }
+
+        if (!hasGeometry) {
+            throw std::runtime_error("geobuf feature must have a geometry");
+        }
+        if (properties.size() % 2 != 0) {
+            throw std::runtime_error("uneven number of geobuf feature property ids");
+        }
+        for (std::size_t i = 0; i < properties.size(); i += 2) {
+            result.properties[keys.at(properties[i])] = values.at(properties[i + 1]);
+        }
+        return result;
+    }
+
+    Value value(protozero::pbf_reader reader) {
+        Value result = NullValue();
+        while (reader.next()) {
+            switch (reader.tag()) {
+            case 1: // string_value
+                result = reader.get_string();
+                break;
+            case 2: // double_value
+                result = reader.get_double();
+                break;
+            case 3: // pos_int_value
+                result = reader.get_uint64();
+                break;
+            case 4: // neg_int_value
+                result = -int64_t(reader.get_uint64());
+                break;
+            case 5: // bool_value
+                result = reader.get_bool();
+                break;
+            case 6: { // json_value
+                JSDocument document;
+                const std::string json = reader.get_string();
+                document.Parse<0>(json.c_str());
+                if (document.HasParseError()) {
+                    throw std::runtime_error("geobuf property has invalid JSON value");
+                }
+                result = toValue(document);
+                break;
+            }
+            default:
+                reader.skip();
+                break;
+            }
+        }
+        return result;
+    }
+
+    // Coordinates are delta encoded from the previous point of the line, or of the ring, which
+    // leaves out its closing point.
+    template <class Line>
+    Line line(const std::vector<int64_t>& coords, std::size_t& start, std::size_t points, bool closed) const {
+        if (start + points * dimensions > coords.size()) {
+            throw std::runtime_error("geobuf geometry has too few coordinates");
+        }
+
+        Line result;
+        result.reserve(points + (closed ? 1 : 0));
+        int64_t x = 0;
+        int64_t y = 0;
+        for (std::size_t i = 0; i < points; i++, start += dimensions) {
+            x += coords[start];
+            y += coords[start + 1];
+            result.emplace_back(x / precision, y / precision);
+        }
+        if (closed && !result.empty()) {
+            result.push_back(result.front());
+        }
+        return result;
+    }
+
+    template <class Lines, class Line>
+    Lines lines(const std::vector<int64_t>& coords, const std::vector<uint32_t>& lengths, bool closed) const {
+        Lines result;
+        std::size_t start = 0;
+        if (lengths.empty()) {
+            result.push_back(line<Line>(coords, start, coords.size() / dimensions, closed));
+        }
+        for (const uint32_t length : lengths) {
+            result.push_back(line<Line>(coords, start, length, closed));
+        }
+        return result;
+    }
+
+    Geometry<double> geometry(protozero::pbf_reader reader) {
+        GeometryType type = GeometryType::Point;
+        std::vector<uint32_t> lengths;
+        std::vector<int64_t> coords;
+        geometry_collection<double> geometries;
+
+        while (reader.next()) {
+            switch (reader.tag()) {
+            case 1: // type
+                type = GeometryType(reader.get_enum());
+                break;
+            case 2: { // lengths
+                auto range = reader.get_packed_uint32();
+                lengths.insert(lengths.end(), range.begin(), range.end());
+                break;
+            }
+            case 3: { // coords
+                auto range = reader.get_packed_sint64();
+                coords.insert(coords.end(), range.begin(), range.end());
+                break;
+            }
+            case 4: // geometries
+                geometries.push_back(geometry(reader.get_message()));
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+
+        std::size_t start = 0;
+        switch (type) {
+        case GeometryType::Point:
+            if (coords.size() < 2) {
+                throw std::runtime_error("geobuf point must have coordinates");
+            }
+            return point<double>(coords[0] / precision, coords[1] / precision);
+        case GeometryType::MultiPoint:
+            return line<multi_point<double>>(coords, start, coords.size() / dimensions, false);
+        case GeometryType::LineString:
+            return line<line_string<double>>(coords, start, coords.size() / dimensions, false);
+        case GeometryType::MultiLineString:
+            return lines<multi_line_string<double>, line_string<double>>(coords, lengths, false);
+        case GeometryType::Polygon:
+            return lines<polygon<double>, linear_ring<double>>(coords, lengths, true);
+        case GeometryType::MultiPolygon: {
+            multi_polygon<double> result;
+            if (lengths.empty()) {
+                result.push_back({ line<linear_ring<double>>(coords, start, coords.size() / dimensions, true) });
+                return result;
+            }
+            // The number of polygons, then for each one the number of its rings and their lengths.
+            std::size_t j = 1;
+            for (uint32_t i = 0; i < lengths.at(0); i++) {
+                polygon<double> rings;
+                const uint32_t ringCount = lengths.at(j++);
+                for (uint32_t k = 0; k < ringCount; k++) {
+                    rings.push_back(line<linear_ring<double>>(coords, start, lengths.at(j++), true));
+                }
+                result.push_back(std::move(rings));
+            }
+            return result;
+        }
+        case GeometryType::GeometryCollection:
+            return geometries;
+        }
+        throw std::runtime_error("unknown geobuf geometry type");
+    }
+};
+
+} // namespace
+
+bool isGeobuf(const std::string& data) {
+    for (const char c : data) {
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return c != '{';
+        }
+    }
+    return false;
+}
+
+GeoJSON decodeGeobuf(const std::string& data) {
+    return GeobufDecoder().decode(data);
+}
+
+} // namespace util
+} // namespace mbgl
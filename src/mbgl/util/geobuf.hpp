@@ -0,0 +1,19 @@
+#pragma once
+
+#include <mbgl/util/geojson.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace util {
+
+// Whether the data looks like geobuf rather than GeoJSON text, which starts with an object after
+// any whitespace.
+bool isGeobuf(const std::string& data);
+
+// Decodes geobuf (https://github.com/mapbox/geobuf) data straight into GeoJSON. Throws an
+// exception for malformed data.
+GeoJSON decodeGeobuf(const std::string& data);
+
+} // namespace util
+} // namespace mbgl
@@ -2,7 +2,8 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
+#include <algorithm>
+#include <cassert>
 
 namespace mbgl {
 
@@ -21,65 +22,112 @@ GridIndex<T>::GridIndex(int32_t extent_, int32_t n_, int32_t padding_) :
     }
 
 template <class T>
-void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = elements.size();
-
+template <class Fn>
+void GridIndex<T>::forEachCell(const BBox& bbox, Fn&& fn) const {
     auto cx1 = convertToCellCoord(bbox.min.x);
     auto cy1 = convertToCellCoord(bbox.min.y);
     auto cx2 = convertToCellCoord(bbox.max.x);
     auto cy2 = convertToCellCoord(bbox.max.y);
 
-    int32_t x, y, cellIndex;
+    int32_t x, y;
     for (x = cx1; x <= cx2; ++x) {
         for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            cells[cellIndex].push_back(uid);
+            fn(d * y + x);
         }
     }
+}
+
+template <class T>
+void GridIndex<T>::insert(T&& t, const BBox& bbox) {
+    assert(!packed());
+    const auto uid = static_cast<uint32_t>(elements.size());
+
+    forEachCell(bbox, [&] (int32_t cellIndex) {
+        cells[cellIndex].push_back(uid);
+    });
 
     elements.emplace_back(t, bbox);
 }
 
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
-    std::vector<T> result;
-    std::unordered_set<size_t> seenUids;
+    std::vector<std::size_t> ids;
+    query(queryBBox, ids);
 
-    auto cx1 = convertToCellCoord(queryBBox.min.x);
-    auto cy1 = convertToCellCoord(queryBBox.min.y);
-    auto cx2 = convertToCellCoord(queryBBox.max.x);
-    auto cy2 = convertToCellCoord(queryBBox.max.y);
+    std::vector<T> result;
+    result.reserve(ids.size());
+    for (auto id : ids) {
+        result.push_back(elements[id].first);
+    }
+    return result;
+}
 
-    int32_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            for (auto uid : cells[cellIndex]) {
-                if (seenUids.count(uid) == 0) {
-                    seenUids.insert(uid);
-
-                    auto& pair = elements.at(uid);
-                    auto& bbox = pair.second;
-                    if (queryBBox.min.x <= bbox.max.x &&
-                        queryBBox.min.y <= bbox.max.y &&
-                        queryBBox.max.x >= bbox.min.x &&
-                        queryBBox.max.y >= bbox.min.y) {
-
-                        result.push_back(pair.first);
-                    }
-                }
-            }
-        }
+template <class T>
+void GridIndex<T>::query(const BBox& queryBBox, std::vector<std::size_t>& ids) const {
+    ids.clear();
+
+    if (packed()) {
+        forEachCell(queryBBox, [&] (int32_t cellIndex) {
+            ids.insert(ids.end(), cellIDs.begin() + cellOffsets[cellIndex],
+                       cellIDs.begin() + cellOffsets[cellIndex + 1]);
+        });
+    } else {
+        forEachCell(queryBBox, [&] (int32_t cellIndex) {
+            ids.insert(ids.end(), cells[cellIndex].begin(), cells[cellIndex].end());
+        });
     }
 
+    // Elements spanning several cells are listed once per cell.
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    ids.erase(std::remove_if(ids.begin(), ids.end(), [&] (std::size_t id) {
+        const BBox& bbox = elements[id].second;
+        return queryBBox.min.x > bbox.max.x ||
+               queryBBox.min.y > bbox.max.y ||
+               queryBBox.max.x < bbox.min.x ||
+               queryBBox.max.y < bbox.min.y;
+    }), ids.end());
+}
+
+template <class T>
+std::size_t GridIndex<T>::byteSize() const {
+    std::size_t result = elements.capacity() * sizeof(std::pair<T, BBox>) +
+                         cells.capacity() * sizeof(std::vector<uint32_t>) +
+                         (cellOffsets.capacity() + cellIDs.capacity()) * sizeof(uint32_t);
+    for (const auto& cell : cells) {
+        result += cell.capacity() * sizeof(uint32_t);
+    }
     return result;
 }
 
+template <class T>
+void GridIndex<T>::pack() {
+    elements.shrink_to_fit();
+    if (packed()) {
+        return;
+    }
+
+    std::size_t count = 0;
+    for (const auto& cell : cells) {
+        count += cell.size();
+    }
+
+    cellOffsets.reserve(cells.size() + 1);
+    cellIDs.reserve(count);
+    for (const auto& cell : cells) {
+        cellOffsets.push_back(static_cast<uint32_t>(cellIDs.size()));
+        cellIDs.insert(cellIDs.end(), cell.begin(), cell.end());
+    }
+    cellOffsets.push_back(static_cast<uint32_t>(cellIDs.size()));
+
+    std::vector<std::vector<uint32_t>>().swap(cells);
+}
 
 template <class T>
 int32_t GridIndex<T>::convertToCellCoord(int32_t x) const {
     return util::max(0.0, util::min(d - 1.0, std::floor(x * scale) + padding));
 }
 
-template class GridIndex<IndexedSubfeature>;
+template class GridIndex<IndexedFeature>;
 } // namespace mbgl
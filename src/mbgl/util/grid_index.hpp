@@ -9,6 +9,13 @@
 
 namespace mbgl {
 
+/*
+   A uniform grid of boxes, for finding the elements that may intersect a query box.
+
+   While the index is built, every cell holds a vector of element IDs. Once all elements are in,
+   pack() moves the cells into one sorted array of IDs with an offset per cell, which takes a
+   fraction of the memory the per-cell vectors need. Nothing can be inserted after packing.
+*/
 template <class T>
 class GridIndex {
 public:
@@ -19,9 +26,23 @@ public:
     void insert(T&& t, const BBox&);
     std::vector<T> query(const BBox&) const;
 
+    // Replaces the contents of `ids` with the IDs of the elements whose boxes intersect the query
+    // box, in insertion order. Reusing the vector across queries avoids copying the elements.
+    void query(const BBox&, std::vector<std::size_t>& ids) const;
+    const T& get(std::size_t id) const { return elements[id].first; }
+
+    std::size_t byteSize() const;
+
+    // Packs the cells and releases the capacity the elements grew beyond their contents.
+    void pack();
+    bool packed() const { return cells.empty(); }
+
 private:
     int32_t convertToCellCoord(int32_t x) const;
 
+    template <class Fn>
+    void forEachCell(const BBox&, Fn&&) const;
+
     const int32_t extent;
     const int32_t n;
     const int32_t padding;
@@ -31,7 +52,11 @@ private:
     const int32_t max;
 
     std::vector<std::pair<T, BBox>> elements;
-    std::vector<std::vector<size_t>> cells;
+    std::vector<std::vector<uint32_t>> cells;
+
+    // The IDs in cell `i` once packed are cellIDs[cellOffsets[i]] to cellIDs[cellOffsets[i + 1]].
+    std::vector<uint32_t> cellOffsets;
+    std::vector<uint32_t> cellIDs;
 
 };
 
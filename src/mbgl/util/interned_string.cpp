@@ -0,0 +1,40 @@
+#include <mbgl/util/interned_string.hpp>
+
+#include <mutex>
+#include <unordered_set>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+std::mutex mutex;
+
+// Leaked on purpose, so that handles held by other static objects stay valid on exit. The
+// elements of an unordered_set keep their addresses as it grows.
+std::unordered_set<std::string>& strings() {
+    static auto* set = new std::unordered_set<std::string>();
+    return *set;
+}
+
+const std::string* intern(const std::string& string) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*strings().insert(string).first;
+}
+
+} // namespace
+
+InternedString::InternedString()
+    : string(intern({})) {
+}
+
+InternedString::InternedString(const std::string& string_)
+    : string(intern(string_)) {
+}
+
+InternedString::InternedString(const char* string_)
+    : string(intern(string_)) {
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace mbgl {
+namespace util {
+
+/*
+   A handle to a string in a process-wide table, for names that are copied and compared far more
+   often than they're created, such as the source layer and bucket names every symbol carries.
+   Equal strings share one entry, so copying, comparing and hashing handles only deals with a
+   pointer.
+
+   Entries are never removed, so only names should be interned, not data. Safe to use from any
+   thread; interning takes a lock, so intern once and copy the handle.
+*/
+class InternedString {
+public:
+    InternedString();
+    InternedString(const std::string&);
+    InternedString(const char*);
+
+    const std::string& str() const {
+        return *string;
+    }
+
+    friend bool operator==(const InternedString& lhs, const InternedString& rhs) {
+        return lhs.string == rhs.string;
+    }
+
+    friend bool operator!=(const InternedString& lhs, const InternedString& rhs) {
+        return lhs.string != rhs.string;
+    }
+
+private:
+    const std::string* string;
+};
+
+} // namespace util
+} // namespace mbgl
+
+namespace std {
+
+template <>
+struct hash<mbgl::util::InternedString> {
+    std::size_t operator()(const mbgl::util::InternedString& s) const {
+        return std::hash<const std::string*>()(&s.str());
+    }
+};
+
+} // namespace std
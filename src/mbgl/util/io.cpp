@@ -20,24 +20,34 @@ void write_file(const std::string &filename, const std::string &data) {
 }
 
 std::string read_file(const std::string &filename) {
-    std::ifstream file(filename);
-    if (file.good()) {
-        std::stringstream data;
-        data << file.rdbuf();
-        return data.str();
+    if (optional<std::string> data = readFile(filename)) {
+        return std::move(*data);
     } else {
         throw std::runtime_error(std::string("Cannot read file ") + filename);
     }
 }
 
 optional<std::string> readFile(const std::string &filename) {
-    std::ifstream file(filename);
-    if (file.good()) {
-        std::stringstream data;
-        data << file.rdbuf();
-        return data.str();
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.good()) {
+        return {};
     }
-    return {};
+
+    // Read regular files straight into a buffer of their size, rather than through a stream.
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size > 0 && file.good()) {
+        std::string data(static_cast<std::size_t>(size), '\0');
+        file.read(&data[0], size);
+        data.resize(static_cast<std::size_t>(file.gcount()));
+        return data;
+    }
+
+    file.clear();
+    std::stringstream data;
+    data << file.rdbuf();
+    return data.str();
 }
 
 void deleteFile(const std::string& filename) {
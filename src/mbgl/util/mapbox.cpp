@@ -133,12 +133,14 @@ canonicalizeTileURL(const std::string& str, const SourceType type, const uint16_
     std::string result = "mapbox://tiles/";
     result.append(str, path.directory.first + versionLen, path.directory.second - versionLen);
     result.append(str, path.filename.first, path.filename.second);
-    if (type == SourceType::Raster) {
+    if (type == SourceType::Raster || type == SourceType::RasterDEM) {
         result += tileSize == util::tileSize ? "@2x" : "{ratio}";
     }
 
 #if !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
-    const bool forceWebP = str.compare(path.extension.first, path.extension.second, ".png") == 0;
+    // Elevations don't survive lossy compression.
+    const bool forceWebP = type != SourceType::RasterDEM &&
+        str.compare(path.extension.first, path.extension.second, ".png") == 0;
 #else
     const bool forceWebP = false;
 #endif // !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
@@ -106,6 +106,11 @@ T smoothstep(T edge0, T edge1, T x) {
     return t * t * (T(3) - T(2) * t);
 }
 
+template <typename T>
+constexpr bool isPowerOfTwo(const T value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
 template <typename T>
 inline T division(const T dividend, const T divisor, const T nan) {
     if (divisor == 0) {
@@ -11,25 +11,22 @@ OffscreenTexture& OffscreenTexture::operator=(OffscreenTexture&&) = default;
 
 class OffscreenTexture::Impl {
 public:
-    Impl(gl::Context& context_, const Size size_, OffscreenTextureAttachment type_)
-        : context(context_), size(std::move(size_)), type(type_) {
+    Impl(gl::Context& context_, const Size size_, OffscreenTextureAttachment type_, gl::TextureType textureType_)
+        : context(context_), size(std::move(size_)), type(type_), textureType(textureType_) {
         assert(!size.isEmpty());
     }
 
-    void bind() {
-        if (!framebuffer) {
-            texture = context.createTexture(size, gl::TextureFormat::RGBA);
-
-            if (type == OffscreenTextureAttachment::Depth) {
-                gl::Renderbuffer<gl::RenderbufferType::DepthComponent> depth =
-                    context.createRenderbuffer<gl::RenderbufferType::DepthComponent>(size);
-                framebuffer = context.createFramebuffer(*texture, depth);
+    ~Impl() {
+        if (target) {
+            context.releaseRenderTarget(std::move(*target));
+        }
+    }
 
-            } else {
-                framebuffer = context.createFramebuffer(*texture);
-            }
+    void bind() {
+        if (!target) {
+            target = context.createRenderTarget(size, type == OffscreenTextureAttachment::Depth, textureType);
         } else {
-            context.bindFramebuffer = framebuffer->framebuffer;
+            context.bindFramebuffer = target->framebuffer.framebuffer;
         }
 
         context.activeTexture = 0;
@@ -42,8 +39,8 @@ public:
     }
 
     gl::Texture& getTexture() {
-        assert(texture);
-        return *texture;
+        assert(target);
+        return target->texture;
     }
 
     const Size& getSize() const {
@@ -54,14 +51,16 @@ private:
     gl::Context& context;
     const Size size;
     OffscreenTextureAttachment type;
-    optional<gl::Framebuffer> framebuffer;
-    optional<gl::Texture> texture;
+    gl::TextureType textureType;
+    // Taken from the context's pool of render targets and returned to it when destroyed.
+    optional<gl::Context::RenderTarget> target;
 };
 
 OffscreenTexture::OffscreenTexture(gl::Context& context,
                                    const Size size,
-                                   OffscreenTextureAttachment type)
-    : impl(std::make_unique<Impl>(context, std::move(size), type)) {
+                                   OffscreenTextureAttachment type,
+                                   gl::TextureType textureType)
+    : impl(std::make_unique<Impl>(context, std::move(size), type, textureType)) {
     assert(!size.isEmpty());
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/gl/types.hpp>
 #include <mbgl/util/image.hpp>
 
 namespace mbgl {
@@ -16,9 +17,11 @@ enum class OffscreenTextureAttachment {
 
 class OffscreenTexture {
 public:
+    // Half float textures require gl::Context::supportsHalfFloatTextures().
     OffscreenTexture(gl::Context&,
                      Size size = { 256, 256 },
-                     OffscreenTextureAttachment type = OffscreenTextureAttachment::None);
+                     OffscreenTextureAttachment type = OffscreenTextureAttachment::None,
+                     gl::TextureType textureType = gl::TextureType::UnsignedByte);
     ~OffscreenTexture();
     OffscreenTexture(OffscreenTexture&&);
     OffscreenTexture& operator=(OffscreenTexture&&);
@@ -0,0 +1,108 @@
+#include <mbgl/util/parallel.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+class ParallelFor {
+public:
+    ParallelFor(std::size_t count_, const std::function<void (std::size_t)>& fn_)
+        : count(count_), fn(fn_), remaining(count_) {
+    }
+
+    // Claims and runs calls until there are none left to claim. `fn` is only touched for claimed
+    // calls, so helpers that get to run after parallelFor() has returned do nothing.
+    void work() {
+        std::size_t i;
+        while ((i = next++) < count) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) {
+                cv.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return remaining == 0; });
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    const std::size_t count;
+    const std::function<void (std::size_t)>& fn;
+
+    std::atomic<std::size_t> next { 0 };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t remaining;
+    std::exception_ptr error;
+};
+
+class ParallelForMessage : public Message {
+public:
+    ParallelForMessage(std::shared_ptr<ParallelFor> state_)
+        : state(std::move(state_)) {
+    }
+
+    void operator()() override {
+        state->work();
+    }
+
+private:
+    std::shared_ptr<ParallelFor> state;
+};
+
+} // namespace
+
+void parallelFor(Scheduler& scheduler, std::size_t count, const std::function<void (std::size_t)>& fn) {
+    if (count == 0) {
+        return;
+    } else if (count == 1) {
+        fn(0);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelFor>(count, fn);
+
+    // One helper per additional call, but no more than there could possibly be idle threads.
+    // Helpers that are still queued when we return are dropped together with their mailbox.
+    const std::size_t helperCount = std::min<std::size_t>(count - 1, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::shared_ptr<Mailbox>> helpers;
+    helpers.reserve(helperCount);
+    for (std::size_t i = 0; i < helperCount; ++i) {
+        helpers.push_back(std::make_shared<Mailbox>(scheduler));
+        helpers.back()->push(std::make_unique<ParallelForMessage>(state));
+    }
+
+    state->work();
+    state->wait();
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+
+class Scheduler;
+
+namespace util {
+
+// Calls fn(i) for every i in [0, count), spreading the calls across the threads of `scheduler`.
+// The calling thread takes part as well, and only waits for calls that another thread has
+// already started, so it's safe to use from a task that is itself running on `scheduler`, even
+// when all of its threads are busy. If any call throws, the first exception is rethrown once all
+// calls have finished.
+void parallelFor(Scheduler&, std::size_t count, const std::function<void (std::size_t)>& fn);
+
+} // namespace util
+} // namespace mbgl
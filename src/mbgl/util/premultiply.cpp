@@ -1,10 +1,53 @@
 #include <mbgl/util/premultiply.hpp>
 
-#include <cmath>
+#include <array>
 
 namespace mbgl {
 namespace util {
 
+namespace {
+
+// ceil(2^24 / a) for each alpha value. Multiplying by it and shifting by 24 bits divides any value
+// up to 255 * 255 + 127 by a exactly, without a division per channel.
+const std::array<uint32_t, 256> reciprocals = [] {
+    std::array<uint32_t, 256> result {};
+    for (uint32_t a = 1; a < 256; a++) {
+        result[a] = ((1u << 24) + a - 1) / a;
+    }
+    return result;
+}();
+
+} // namespace
+
+void premultiply(uint8_t* data, std::size_t bytes) {
+    // Branchless, so that the compiler can vectorize it. (x + 1 + (x >> 8)) >> 8 equals x / 255
+    // for all x up to 255 * 255 + 127.
+    for (std::size_t i = 0; i < bytes; i += 4) {
+        const uint32_t a = data[i + 3];
+        for (std::size_t c = 0; c < 3; c++) {
+            const uint32_t x = data[i + c] * a + 127;
+            data[i + c] = (x + 1 + (x >> 8)) >> 8;
+        }
+    }
+}
+
+void unpremultiply(const uint8_t* src, uint8_t* dst, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; i += 4) {
+        const uint32_t a = src[i + 3];
+        if (a) {
+            const uint64_t reciprocal = reciprocals[a];
+            for (std::size_t c = 0; c < 3; c++) {
+                dst[i + c] = ((255 * src[i + c] + (a / 2)) * reciprocal) >> 24;
+            }
+        } else if (dst != src) {
+            dst[i + 0] = src[i + 0];
+            dst[i + 1] = src[i + 1];
+            dst[i + 2] = src[i + 2];
+        }
+        dst[i + 3] = a;
+    }
+}
+
 PremultipliedImage premultiply(UnassociatedImage&& src) {
     PremultipliedImage dst;
 
@@ -12,16 +55,7 @@ PremultipliedImage premultiply(UnassociatedImage&& src) {
     src.size = { 0, 0 };
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        r = (r * a + 127) / 255;
-        g = (g * a + 127) / 255;
-        b = (b * a + 127) / 255;
-    }
+    premultiply(dst.data.get(), dst.bytes());
 
     return dst;
 }
@@ -33,18 +67,7 @@ UnassociatedImage unpremultiply(PremultipliedImage&& src) {
     src.size = { 0, 0 };
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        if (a) {
-            r = (255 * r + (a / 2)) / a;
-            g = (255 * g + (a / 2)) / a;
-            b = (255 * b + (a / 2)) / a;
-        }
-    }
+    unpremultiply(dst.data.get(), dst.data.get(), dst.bytes());
 
     return dst;
 }
@@ -25,8 +25,8 @@ namespace util {
 // in that thread. When the `Thread<>` object is destructed, the destructor waits
 // for thread termination. The `Thread<>` constructor blocks until the thread and
 // the `Object` are fully created, so after the object creation, it's safe to obtain the
-// `Object` stored in this thread. The thread created will always have low priority on
-// the platforms that support setting thread priority.
+// `Object` stored in this thread. The thread created has low priority, unless another
+// priority is given, on the platforms that support setting thread priority.
 //
 // The following properties make this class different from `ThreadPool`:
 //
@@ -40,12 +40,17 @@ template<class Object>
 class Thread : public Scheduler {
 public:
     template <class... Args>
-    Thread(const std::string& name, Args&&... args) {
+    Thread(const std::string& name, Args&&... args)
+        : Thread(platform::ThreadPriority::Low, name, std::forward<Args>(args)...) {
+    }
+
+    template <class... Args>
+    Thread(platform::ThreadPriority priority, const std::string& name, Args&&... args) {
         std::promise<void> running;
 
         thread = std::thread([&] {
             platform::setCurrentThreadName(name);
-            platform::makeThreadLowPriority();
+            platform::setCurrentThreadPriority(priority);
 
             util::RunLoop loop_(util::RunLoop::Type::New);
             loop = &loop_;
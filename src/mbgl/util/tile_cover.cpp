@@ -1,9 +1,15 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/math/clamp.hpp>
 #include <mbgl/map/transform_state.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <map>
+#include <tuple>
 
 namespace mbgl {
 
@@ -75,27 +81,47 @@ namespace util {
 
 namespace {
 
-std::vector<UnwrappedTileID> tileCover(const Point<double>& tl,
-                                       const Point<double>& tr,
-                                       const Point<double>& br,
-                                       const Point<double>& bl,
-                                       const Point<double>& c,
-                                       int32_t z) {
-    const int32_t tiles = 1 << z;
+using CoveredTile = TileCover::CoveredTile;
 
-    struct ID {
-        int32_t x, y;
-        double sqDist;
+struct Viewport {
+    Point<double> tl, tr, br, bl, c;
+};
+
+Viewport viewport(const TransformState& state, int32_t z) {
+    const double w = state.getSize().width;
+    const double h = state.getSize().height;
+    return {
+        TileCoordinate::fromScreenCoordinate(state, z, { 0,   0   }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { w,   0   }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { w,   h   }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { 0,   h   }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { w/2, h/2 }).p,
     };
+}
+
+double sqDist(int32_t x, int32_t y, const Point<double>& c) {
+    const auto dx = x + 0.5 - c.x, dy = y + 0.5 - c.y;
+    return dx * dx + dy * dy;
+}
 
-    std::vector<ID> t;
+// Sorts first by distance, then by x/y.
+bool nearer(const CoveredTile& a, const CoveredTile& b) {
+    return std::tie(a.sqDist, a.x, a.y) < std::tie(b.sqDist, b.x, b.y);
+}
+
+bool sameTile(const CoveredTile& a, const CoveredTile& b) {
+    return a.x == b.x && a.y == b.y;
+}
 
+void scanTiles(const Viewport& v, int32_t z, std::vector<CoveredTile>& t) {
+    const int32_t tiles = 1 << z;
+
+    t.clear();
     auto scanLine = [&](int32_t x0, int32_t x1, int32_t y) {
         int32_t x;
         if (y >= 0 && y <= tiles) {
             for (x = x0; x < x1; ++x) {
-                const auto dx = x + 0.5 - c.x, dy = y + 0.5 - c.y;
-                t.emplace_back(ID{ x, y, dx * dx + dy * dy });
+                t.push_back({ x, y, sqDist(x, y, v.c) });
             }
         }
     };
@@ -104,31 +130,56 @@ std::vector<UnwrappedTileID> tileCover(const Point<double>& tl,
     // \---+
     // | \ |
     // +---\.
-    scanTriangle(tl, tr, br, 0, tiles, scanLine);
-    scanTriangle(br, bl, tl, 0, tiles, scanLine);
+    scanTriangle(v.tl, v.tr, v.br, 0, tiles, scanLine);
+    scanTriangle(v.br, v.bl, v.tl, 0, tiles, scanLine);
+}
 
-    // Sort first by distance, then by x/y.
-    std::sort(t.begin(), t.end(), [](const ID& a, const ID& b) {
-        return std::tie(a.sqDist, a.x, a.y) < std::tie(b.sqDist, b.x, b.y);
-    });
+void sortTiles(std::vector<CoveredTile>& t) {
+    std::sort(t.begin(), t.end(), nearer);
 
     // Erase duplicate tile IDs (they typically occur at the common side of both triangles).
-    t.erase(std::unique(t.begin(), t.end(), [](const ID& a, const ID& b) {
-                return a.x == b.x && a.y == b.y;
-            }), t.end());
+    t.erase(std::unique(t.begin(), t.end(), sameTile), t.end());
+}
 
-    std::vector<UnwrappedTileID> result;
+void toTileIDs(const std::vector<CoveredTile>& t, int32_t z, std::vector<UnwrappedTileID>& result) {
+    result.clear();
     for (const auto& id : t) {
         result.emplace_back(z, id.x, id.y);
     }
+}
+
+std::vector<UnwrappedTileID> tileCover(const Viewport& v, int32_t z) {
+    std::vector<CoveredTile> t;
+    scanTiles(v, z, t);
+    sortTiles(t);
+
+    std::vector<UnwrappedTileID> result;
+    toTileIDs(t, z, result);
     return result;
 }
 
+// A tile of a level of detail cover, and the highest zoom level that the tiles of the viewport it
+// contains call for.
+struct LODTile {
+    int32_t x;
+    int32_t y;
+    int32_t desired;
+};
+
+bool lodBefore(const LODTile& a, const LODTile& b) {
+    return std::tie(a.x, a.y) < std::tie(b.x, b.y);
+}
+
+// Rounds down, unlike dividing negative (wrapped) coordinates.
+int32_t parentCoordinate(int32_t c) {
+    return c >= 0 ? c / 2 : (c - 1) / 2;
+}
+
 } // namespace
 
 int32_t coveringZoomLevel(double zoom, SourceType type, uint16_t size) {
     zoom += std::log(util::tileSize / size) / std::log(2);
-    if (type == SourceType::Raster || type == SourceType::Video) {
+    if (type == SourceType::Raster || type == SourceType::RasterDEM || type == SourceType::Video) {
         return ::round(zoom);
     } else {
         return std::floor(zoom);
@@ -146,27 +197,394 @@ std::vector<UnwrappedTileID> tileCover(const LatLngBounds& bounds_, int32_t z) {
         { std::max(bounds_.south(), -util::LATITUDE_MAX), bounds_.west() },
         { std::min(bounds_.north(),  util::LATITUDE_MAX), bounds_.east() });
 
-    return tileCover(
+    return tileCover(Viewport {
         TileCoordinate::fromLatLng(z, bounds.northwest()).p,
         TileCoordinate::fromLatLng(z, bounds.northeast()).p,
         TileCoordinate::fromLatLng(z, bounds.southeast()).p,
         TileCoordinate::fromLatLng(z, bounds.southwest()).p,
         TileCoordinate::fromLatLng(z, bounds.center()).p,
-        z);
+    }, z);
+}
+
+TileRange::TileRange(const LatLngBounds& bounds_, uint8_t z_) : z(z_) {
+    if (bounds_.isEmpty() ||
+        bounds_.south() >  util::LATITUDE_MAX ||
+        bounds_.north() < -util::LATITUDE_MAX) {
+        return;
+    }
+
+    LatLngBounds bounds = LatLngBounds::hull(
+        { std::max(bounds_.south(), -util::LATITUDE_MAX), bounds_.west() },
+        { std::min(bounds_.north(),  util::LATITUDE_MAX), bounds_.east() });
+
+    const Point<double> nw = TileCoordinate::fromLatLng(z, bounds.northwest()).p;
+    const Point<double> se = TileCoordinate::fromLatLng(z, bounds.southeast()).p;
+    const int64_t tiles = int64_t(1) << z;
+
+    // Like the scan in tileCover(), which covers no rows of bounds without height, and every
+    // tile a side of other bounds passes through.
+    if (se.y == nw.y) {
+        return;
+    }
+
+    const int64_t y0 = std::max<int64_t>(0, std::floor(nw.y));
+    const int64_t y1 = std::min<int64_t>(tiles, std::ceil(se.y));
+    const int64_t x0 = std::floor(nw.x);
+    const int64_t x1 = std::ceil(se.x);
+    if (y1 <= y0 || x1 <= x0) {
+        return;
+    }
+
+    if (x1 - x0 >= tiles) {
+        add(0, tiles, y0, y1 - y0);
+    } else {
+        add(((x0 % tiles) + tiles) % tiles, x1 - x0, y0, y1 - y0);
+    }
+}
+
+namespace {
+
+// Collects the tiles of a geometry as column spans by row, in unwrapped columns.
+class GeometryScan {
+public:
+    explicit GeometryScan(uint8_t z_) : z(z_), tiles(int64_t(1) << z_) {}
+
+    void operator()(const Point<double>& point) {
+        const Point<double> p = project(point);
+        tile(std::floor(p.x), std::floor(p.y));
+    }
+
+    void operator()(const MultiPoint<double>& points) {
+        for (const auto& point : points) {
+            (*this)(point);
+        }
+    }
+
+    void operator()(const LineString<double>& line) {
+        if (line.size() == 1) {
+            (*this)(line.front());
+        }
+        for (std::size_t i = 1; i < line.size(); i++) {
+            segment(project(line[i - 1]), project(line[i]));
+        }
+    }
+
+    void operator()(const MultiLineString<double>& lines) {
+        for (const auto& line : lines) {
+            (*this)(line);
+        }
+    }
+
+    void operator()(const Polygon<double>& polygon) {
+        struct Edge {
+            Point<double> a;
+            Point<double> b;
+        };
+        std::vector<Edge> edges;
+
+        // The boundary, and the tiles whose center is inside, by the even-odd rule.
+        for (const auto& ring : polygon) {
+            for (std::size_t i = 0; i < ring.size(); i++) {
+                Edge edge { project(ring[i]), project(ring[(i + 1) % ring.size()]) };
+                segment(edge.a, edge.b);
+                if (edge.a.y != edge.b.y) {
+                    if (edge.a.y > edge.b.y) {
+                        std::swap(edge.a, edge.b);
+                    }
+                    edges.push_back(edge);
+                }
+            }
+        }
+        if (edges.empty()) {
+            return;
+        }
+
+        std::sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) {
+            return lhs.a.y < rhs.a.y;
+        });
+        double maxY = 0;
+        for (const auto& edge : edges) {
+            maxY = std::max(maxY, edge.b.y);
+        }
+
+        std::vector<const Edge*> active;
+        std::vector<double> crossings;
+        auto next = edges.begin();
+        const int64_t y0 = std::max<int64_t>(0, std::floor(edges.front().a.y));
+        const int64_t y1 = std::min<int64_t>(tiles - 1, std::floor(maxY));
+        for (int64_t y = y0; y <= y1; y++) {
+            const double center = y + 0.5;
+            for (; next != edges.end() && next->a.y <= center; ++next) {
+                active.push_back(&*next);
+            }
+            active.erase(std::remove_if(active.begin(), active.end(), [&](const Edge* edge) {
+                return edge->b.y <= center;
+            }), active.end());
+
+            crossings.clear();
+            for (const Edge* edge : active) {
+                crossings.push_back(edge->a.x + (center - edge->a.y) * (edge->b.x - edge->a.x) / (edge->b.y - edge->a.y));
+            }
+            std::sort(crossings.begin(), crossings.end());
+            for (std::size_t i = 1; i < crossings.size(); i += 2) {
+                span(y, std::ceil(crossings[i - 1] - 0.5), int64_t(std::floor(crossings[i] - 0.5)) + 1);
+            }
+        }
+    }
+
+    void operator()(const MultiPolygon<double>& polygons) {
+        for (const auto& polygon : polygons) {
+            (*this)(polygon);
+        }
+    }
+
+    void operator()(const mapbox::geometry::geometry_collection<double>& geometries) {
+        for (const auto& geometry : geometries) {
+            Geometry<double>::visit(geometry, *this);
+        }
+    }
+
+    // Spans by row, sorted, possibly overlapping.
+    std::map<int64_t, std::vector<std::pair<int64_t, int64_t>>> rows;
+
+    const uint8_t z;
+    const int64_t tiles;
+
+private:
+    Point<double> project(const Point<double>& point) const {
+        const double latitude = util::clamp(point.y, -util::LATITUDE_MAX, util::LATITUDE_MAX);
+        return TileCoordinate::fromLatLng(z, LatLng(latitude, point.x)).p;
+    }
+
+    void span(int64_t y, int64_t x0, int64_t x1) {
+        if (y >= 0 && y < tiles && x0 < x1) {
+            rows[y].emplace_back(x0, x1);
+        }
+    }
+
+    void tile(int64_t x, int64_t y) {
+        span(y, x, x + 1);
+    }
+
+    // Visits the tiles the segment passes through, stepping from one to the next across the
+    // nearer of the column and row boundaries ahead.
+    void segment(const Point<double>& a, const Point<double>& b) {
+        int64_t x = std::floor(a.x);
+        int64_t y = std::floor(a.y);
+        const int64_t xEnd = std::floor(b.x);
+        const int64_t yEnd = std::floor(b.y);
+
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const int64_t stepX = dx > 0 ? 1 : -1;
+        const int64_t stepY = dy > 0 ? 1 : -1;
+
+        // Positions along the segment, as fractions of its length.
+        double nextX = dx != 0 ? ((stepX > 0 ? x + 1 : x) - a.x) / dx : INFINITY;
+        double nextY = dy != 0 ? ((stepY > 0 ? y + 1 : y) - a.y) / dy : INFINITY;
+        const double deltaX = dx != 0 ? stepX / dx : INFINITY;
+        const double deltaY = dy != 0 ? stepY / dy : INFINITY;
+
+        tile(x, y);
+        while (x != xEnd || y != yEnd) {
+            if (y == yEnd || (x != xEnd && nextX < nextY)) {
+                x += stepX;
+                nextX += deltaX;
+            } else {
+                y += stepY;
+                nextY += deltaY;
+            }
+            tile(x, y);
+        }
+    }
+};
+
+} // namespace
+
+TileRange::TileRange(const Geometry<double>& geometry, uint8_t z_) : z(z_) {
+    GeometryScan scan(z);
+    Geometry<double>::visit(geometry, scan);
+
+    std::vector<std::pair<int64_t, int64_t>> wrapped;
+    for (const auto& row : scan.rows) {
+        wrapped.clear();
+        for (const auto& span : row.second) {
+            if (span.second - span.first >= scan.tiles) {
+                wrapped.emplace_back(0, scan.tiles);
+                continue;
+            }
+            const int64_t x0 = ((span.first % scan.tiles) + scan.tiles) % scan.tiles;
+            const int64_t x1 = x0 + span.second - span.first;
+            wrapped.emplace_back(x0, std::min(x1, scan.tiles));
+            if (x1 > scan.tiles) {
+                wrapped.emplace_back(0, x1 - scan.tiles);
+            }
+        }
+
+        std::sort(wrapped.begin(), wrapped.end());
+        int64_t x0 = wrapped.front().first;
+        int64_t x1 = wrapped.front().second;
+        for (const auto& span : wrapped) {
+            if (span.first > x1) {
+                add(x0, x1 - x0, row.first, 1);
+                x0 = span.first;
+            }
+            x1 = std::max(x1, span.second);
+        }
+        add(x0, x1 - x0, row.first, 1);
+    }
 }
 
+void TileRange::add(uint64_t minX, uint64_t columns, uint64_t minY, uint64_t rows) {
+    blocks.push_back({ minX, columns, minY, rows, count });
+    count += columns * rows;
+}
+
+CanonicalTileID TileRange::operator[](uint64_t index) const {
+    assert(index < size());
+    auto block = std::upper_bound(blocks.begin(), blocks.end(), index, [](uint64_t i, const Block& b) {
+        return i < b.offset;
+    }) - 1;
+    index -= block->offset;
+
+    const uint64_t tiles = uint64_t(1) << z;
+    return { z, uint32_t((block->minX + index / block->rows) % tiles), uint32_t(block->minY + index % block->rows) };
+}
+
+
 std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z) {
     assert(state.valid());
+    return tileCover(viewport(state, z), z);
+}
 
-    const double w = state.getSize().width;
-    const double h = state.getSize().height;
-    return tileCover(
-        TileCoordinate::fromScreenCoordinate(state, z, { 0,   0   }).p,
-        TileCoordinate::fromScreenCoordinate(state, z, { w,   0   }).p,
-        TileCoordinate::fromScreenCoordinate(state, z, { w,   h   }).p,
-        TileCoordinate::fromScreenCoordinate(state, z, { 0,   h   }).p,
-        TileCoordinate::fromScreenCoordinate(state, z, { w/2, h/2 }).p,
-        z);
+std::vector<UnwrappedTileID> lodTileCover(const TransformState& state, int32_t z, int32_t minZ, double bias) {
+    assert(state.valid());
+    const Viewport v = viewport(state, z);
+
+    std::vector<CoveredTile> t;
+    scanTiles(v, z, t);
+    sortTiles(t);
+
+    std::vector<UnwrappedTileID> result;
+    if (state.getPitch() == 0 || minZ >= z) {
+        toTileIDs(t, z, result);
+        return result;
+    }
+
+    // The distance of a point from the camera is the w component of its projection.
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+    const double tileScale = util::tileSize * std::pow(2.0, state.getZoom() - z);
+    const double centerDistance = state.getCameraToCenterDistance();
+
+    // The tiles at zoom levels z, z - 1, ..., minZ that contain tiles of the viewport, by x/y.
+    std::vector<std::vector<LODTile>> levels(z - minZ + 1);
+    for (const auto& tile : t) {
+        const double px = (tile.x + 0.5) * tileScale;
+        const double py = (tile.y + 0.5) * tileScale;
+        const double distance = projMatrix[3] * px + projMatrix[7] * py + projMatrix[15];
+
+        int32_t reduction = 0;
+        if (distance > centerDistance) {
+            reduction = std::floor(std::log2(distance / centerDistance) - bias);
+        }
+        levels[0].push_back({ tile.x, tile.y, z - util::clamp(reduction, 0, z - minZ) });
+    }
+    std::sort(levels[0].begin(), levels[0].end(), lodBefore);
+
+    for (std::size_t i = 1; i < levels.size(); ++i) {
+        auto& parents = levels[i];
+        for (const auto& child : levels[i - 1]) {
+            parents.push_back({ parentCoordinate(child.x), parentCoordinate(child.y), child.desired });
+        }
+        std::sort(parents.begin(), parents.end(), lodBefore);
+
+        auto last = parents.begin();
+        for (auto it = parents.begin(); it != parents.end(); ++it) {
+            if (it == last) {
+                continue;
+            } else if (!lodBefore(*last, *it)) {
+                last->desired = std::max(last->desired, it->desired);
+            } else {
+                *++last = *it;
+            }
+        }
+        parents.erase(parents.empty() ? parents.end() : last + 1, parents.end());
+    }
+
+    // Descend from the lowest zoom level, and subdivide the tiles that contain tiles calling for
+    // more detail than their zoom level has. Since a tile is either used or subdivided, the cover
+    // doesn't overlap.
+    struct LODCoveredTile {
+        UnwrappedTileID id;
+        double sqDist;
+    };
+    std::vector<LODCoveredTile> covered;
+    std::vector<LODTile> subdivided;
+    std::vector<LODTile> nextSubdivided;
+
+    for (std::size_t i = levels.size(); i-- > 0;) {
+        const int32_t level = z - i;
+        const double size = 1 << i;
+
+        nextSubdivided.clear();
+        for (const auto& tile : levels[i]) {
+            if (i != levels.size() - 1 &&
+                !std::binary_search(subdivided.begin(), subdivided.end(),
+                                    LODTile { parentCoordinate(tile.x), parentCoordinate(tile.y), 0 },
+                                    lodBefore)) {
+                continue;
+            }
+
+            if (tile.desired > level) {
+                nextSubdivided.push_back(tile);
+            } else {
+                const double dx = (tile.x + 0.5) * size - v.c.x;
+                const double dy = (tile.y + 0.5) * size - v.c.y;
+                covered.push_back({ UnwrappedTileID(level, tile.x, tile.y), dx * dx + dy * dy });
+            }
+        }
+        std::swap(subdivided, nextSubdivided);
+    }
+
+    std::sort(covered.begin(), covered.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.sqDist, a.id) < std::tie(b.sqDist, b.id);
+    });
+
+    result.reserve(covered.size());
+    for (const auto& tile : covered) {
+        result.push_back(tile.id);
+    }
+    return result;
+}
+
+const std::vector<UnwrappedTileID>& TileCover::update(const TransformState& state, int32_t z) {
+    assert(state.valid());
+    const Viewport v = viewport(state, z);
+
+    std::swap(scanned, previouslyScanned);
+    scanTiles(v, z, scanned);
+
+    // The scan visits the same tiles in the same order as long as the viewport's edges cross the
+    // same tiles, so then the cover only needs sorting again if the center moved far enough to
+    // change which tiles are nearest.
+    if (z == zoom && std::equal(scanned.begin(), scanned.end(),
+                                previouslyScanned.begin(), previouslyScanned.end(), sameTile)) {
+        for (auto& tile : sorted) {
+            tile.sqDist = sqDist(tile.x, tile.y, v.c);
+        }
+        if (!std::is_sorted(sorted.begin(), sorted.end(), nearer)) {
+            std::sort(sorted.begin(), sorted.end(), nearer);
+            toTileIDs(sorted, z, result);
+        }
+        return result;
+    }
+
+    zoom = z;
+    sorted = scanned;
+    sortTiles(sorted);
+    toTileIDs(sorted, z, result);
+    return result;
 }
 
 } // namespace util
@@ -2,6 +2,7 @@
 
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/types.hpp>
+#include <mbgl/util/geometry.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
 
 #include <vector>
@@ -18,5 +19,74 @@ int32_t coveringZoomLevel(double z, SourceType type, uint16_t tileSize);
 std::vector<UnwrappedTileID> tileCover(const TransformState&, int32_t z);
 std::vector<UnwrappedTileID> tileCover(const LatLngBounds&, int32_t z);
 
+// Covers the viewport like tileCover(), except that in pitched views, tiles farther from the
+// camera than the center of the viewport get lower zoom levels: one less than `z` at twice the
+// distance, two less at four times the distance, and so on, but not less than `minZ`. A positive
+// `bias`, in zoom levels, keeps more detail, and a negative one less. The tiles don't overlap, and
+// the ones nearest to the center come first.
+std::vector<UnwrappedTileID> lodTileCover(const TransformState&, int32_t z, int32_t minZ, double bias);
+
+// The canonical tiles of a zoom level that cover a bounding box or a geometry, each of them once.
+// The tiles are held as rectangles of columns and rows, so that they're counted in constant time
+// and enumerated without materializing them.
+//
+// For bounding boxes, these are the tiles of tileCover(), wrapped, enumerated column by column
+// from west to east, and each column from north to south. Geometries, in longitudes and
+// latitudes, cover the tiles their points are in, their lines pass through, and their polygons
+// overlap, enumerated row by row.
+class TileRange {
+public:
+    TileRange(const LatLngBounds&, uint8_t z);
+    TileRange(const Geometry<double>&, uint8_t z);
+
+    uint64_t size() const {
+        return count;
+    }
+
+    CanonicalTileID operator[](uint64_t index) const;
+
+private:
+    struct Block {
+        uint64_t minX;
+        uint64_t columns;
+        uint64_t minY;
+        uint64_t rows;
+        // The number of tiles in the blocks before this one.
+        uint64_t offset;
+    };
+
+    void add(uint64_t minX, uint64_t columns, uint64_t minY, uint64_t rows);
+
+    uint8_t z;
+    std::vector<Block> blocks;
+    uint64_t count = 0;
+};
+
+// Computes the same tile cover of a viewport as tileCover(), updating the cover of the previous
+// call. While the viewport moves within the tiles it covers, only the order of the tiles by their
+// distance from the center is checked, which is linear, and it's rarely sorted again.
+class TileCover {
+public:
+    const std::vector<UnwrappedTileID>& update(const TransformState&, int32_t z);
+
+    // A tile and its squared distance from the center of the viewport, in tiles.
+    struct CoveredTile {
+        int32_t x;
+        int32_t y;
+        double sqDist;
+    };
+
+private:
+    int32_t zoom = -1;
+
+    // The tiles as scanned, with duplicates, and the ones scanned before them.
+    std::vector<CoveredTile> scanned;
+    std::vector<CoveredTile> previouslyScanned;
+
+    // Without duplicates, nearest to the center first.
+    std::vector<CoveredTile> sorted;
+    std::vector<UnwrappedTileID> result;
+};
+
 } // namespace util
 } // namespace mbgl
@@ -0,0 +1,268 @@
+#include <mbgl/util/timer_wheel.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Keeps timeouts like Duration::max() from overflowing once the elapsed time is added.
+Duration clampTimeout(Duration timeout) {
+    return std::min(timeout, Duration::max() / 2);
+}
+
+uint64_t ceilTicks(Duration duration, Duration granularity) {
+    return uint64_t((duration.count() + granularity.count() - 1) / granularity.count());
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(Duration granularity_)
+    : granularity(granularity_),
+      epoch(Clock::now()) {
+    assert(granularity > Duration::zero());
+}
+
+TimerWheel::~TimerWheel() = default;
+
+std::shared_ptr<TimerWheel> TimerWheel::get() {
+    RunLoop* loop = RunLoop::Get();
+    assert(loop);
+    if (!loop->timerWheel) {
+        loop->timerWheel = std::make_shared<TimerWheel>(Seconds(1));
+    }
+    return loop->timerWheel;
+}
+
+TimerWheel::TimerID TimerWheel::start(Duration timeout, Duration repeat, std::function<void()>&& callback) {
+    const TimePoint now = Clock::now();
+    if (entries.empty()) {
+        // Nothing has been waiting for the wheel while it was idle, so it can skip ahead.
+        tick = std::max(tick, tickAt(now));
+    }
+
+    Entry entry;
+    entry.expiry = std::max(ceilTicks(now - epoch + clampTimeout(std::max(timeout, Duration::zero())), granularity),
+                            tick + 1);
+    entry.repeat = repeat <= Duration::zero() ? 0 : std::max<uint64_t>(ceilTicks(clampTimeout(repeat), granularity), 1);
+    entry.callback = std::move(callback);
+
+    const TimerID id = nextID++;
+    insert(id, entries.emplace(id, std::move(entry)).first->second);
+    schedule();
+    return id;
+}
+
+void TimerWheel::stop(TimerID id) {
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        return;
+    }
+    remove(id, it->second);
+    entries.erase(it);
+    schedule();
+}
+
+uint64_t TimerWheel::tickAt(TimePoint time) const {
+    return time <= epoch ? 0 : uint64_t((time - epoch) / granularity);
+}
+
+TimePoint TimerWheel::timeOf(uint64_t tick_) const {
+    return epoch + granularity * int64_t(tick_);
+}
+
+void TimerWheel::insert(TimerID id, Entry& entry) {
+    assert(entry.expiry >= tick);
+    for (std::size_t level = 0; level < levelCount; level++) {
+        const std::size_t shift = level * levelBits;
+        if ((entry.expiry >> shift) - (tick >> shift) < slotCount) {
+            entry.level = level;
+            entry.slot = (entry.expiry >> shift) & (slotCount - 1);
+            entry.index = levels[level][entry.slot].size();
+            levels[level][entry.slot].push_back(id);
+            return;
+        }
+    }
+    entry.level = overflowLevel;
+    entry.index = overflow.size();
+    overflow.push_back(id);
+}
+
+void TimerWheel::remove(TimerID id, const Entry& entry) {
+    if (entry.level == firingLevel) {
+        return;
+    }
+
+    Slot& slot = entry.level == overflowLevel ? overflow : levels[entry.level][entry.slot];
+    assert(entry.index < slot.size() && slot[entry.index] == id);
+    const TimerID last = slot.back();
+    slot[entry.index] = last;
+    slot.pop_back();
+    if (last != id) {
+        entries.at(last).index = entry.index;
+    }
+}
+
+void TimerWheel::cascade(Slot&& slot) {
+    for (TimerID id : slot) {
+        insert(id, entries.at(id));
+    }
+}
+
+void TimerWheel::advance() {
+    scheduledTick = {};
+    advancing = true;
+
+    const uint64_t target = tickAt(Clock::now());
+    if (target > tick + slotCount) {
+        // The wheel fell behind by more than the first level, e.g. because the device was asleep,
+        // so the ticks in between aren't worth stepping through: the timers that are due fire
+        // at once, and the others are sorted into the levels again.
+        for (auto& level : levels) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+        overflow.clear();
+
+        tick = target;
+        Slot due;
+        for (auto& entry : entries) {
+            if (entry.second.expiry <= tick) {
+                due.push_back(entry.first);
+            } else {
+                insert(entry.first, entry.second);
+            }
+        }
+        std::sort(due.begin(), due.end());
+        fire(std::move(due));
+    }
+
+    while (tick < target) {
+        tick++;
+
+        // Moves the timers down from the top, so that those that move down several levels at
+        // once are cascaded again on the levels below.
+        if ((tick & ((uint64_t(1) << (levelCount * levelBits)) - 1)) == 0) {
+            Slot slot;
+            slot.swap(overflow);
+            cascade(std::move(slot));
+        }
+        for (std::size_t level = levelCount - 1; level > 0; level--) {
+            const std::size_t shift = level * levelBits;
+            if ((tick & ((uint64_t(1) << shift) - 1)) == 0) {
+                Slot slot;
+                slot.swap(levels[level][(tick >> shift) & (slotCount - 1)]);
+                cascade(std::move(slot));
+            }
+        }
+
+        Slot slot;
+        slot.swap(levels[0][tick & (slotCount - 1)]);
+        fire(std::move(slot));
+    }
+
+    advancing = false;
+    schedule();
+}
+
+void TimerWheel::fire(Slot&& slot) {
+    // The callbacks may stop the timers that fire after them, which have left their slot already.
+    for (TimerID id : slot) {
+        entries.at(id).level = firingLevel;
+    }
+
+    for (TimerID id : slot) {
+        // Timers may be stopped by the callbacks of those that fired before.
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            continue;
+        }
+
+        if (it->second.repeat) {
+            it->second.expiry = tick + it->second.repeat;
+            insert(id, it->second);
+            // The callback may stop its own timer.
+            auto callback = it->second.callback;
+            callback();
+        } else {
+            auto callback = std::move(it->second.callback);
+            entries.erase(it);
+            callback();
+        }
+    }
+}
+
+void TimerWheel::schedule() {
+    if (advancing) {
+        // Timers started and stopped by the callbacks are taken into account once all have fired.
+        return;
+    }
+
+    if (entries.empty()) {
+        if (scheduledTick) {
+            timer.stop();
+            scheduledTick = {};
+        }
+        return;
+    }
+
+    // Wakes up for the first slot of the first level that has timers, or, if there are timers on
+    // the other levels, when the first level wraps around and they're moved down.
+    optional<uint64_t> wake;
+    std::size_t pending = 0;
+    for (uint64_t i = 1; i < slotCount; i++) {
+        const Slot& slot = levels[0][(tick + i) & (slotCount - 1)];
+        if (!slot.empty() && !wake) {
+            wake = tick + i;
+        }
+        pending += slot.size();
+    }
+    if (pending < entries.size()) {
+        const uint64_t wrap = ((tick >> levelBits) + 1) << levelBits;
+        wake = wake ? std::min(*wake, wrap) : wrap;
+    }
+
+    if (scheduledTick == wake) {
+        return;
+    }
+    scheduledTick = wake;
+    timer.start(std::max(timeOf(*wake) - Clock::now(), Duration::zero()), Duration::zero(), [this] {
+        advance();
+    });
+}
+
+CoarseTimer::CoarseTimer()
+    : wheel(TimerWheel::get()) {
+}
+
+CoarseTimer::CoarseTimer(std::shared_ptr<TimerWheel> wheel_)
+    : wheel(std::move(wheel_)) {
+}
+
+CoarseTimer::~CoarseTimer() {
+    stop();
+}
+
+void CoarseTimer::start(Duration timeout, Duration repeat, std::function<void()>&& callback) {
+    stop();
+    if (auto wheel_ = wheel.lock()) {
+        id = wheel_->start(timeout, repeat, std::move(callback));
+    }
+}
+
+void CoarseTimer::stop() {
+    if (!id) {
+        return;
+    }
+    if (auto wheel_ = wheel.lock()) {
+        wheel_->stop(*id);
+    }
+    id = {};
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/timer.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+/*
+    Multiplexes many timers that don't need to be precise through a single platform timer, e.g.
+    the expiration refreshes of cached resources, of which there may be thousands. Time advances
+    in ticks of the wheel's granularity; timers are rounded up to a tick, so they never fire
+    early, and all timers expiring within the same tick fire together on one wake-up.
+
+    Timers are kept in a hierarchical wheel of four levels of 64 slots each, so that starting and
+    stopping a timer takes constant time, however many timers there are. The first level holds
+    the timers of the next 64 ticks, one tick per slot; each further level covers 64 times the
+    span of the one below, and its slots are moved down to the lower levels as time reaches them.
+    Timers that are further out than the top level are kept aside until the top level wraps
+    around.
+
+    Every RunLoop has a wheel, with a granularity of a second, which is used by CoarseTimer.
+*/
+class TimerWheel : private util::noncopyable {
+public:
+    using TimerID = uint64_t;
+
+    explicit TimerWheel(Duration granularity);
+    ~TimerWheel();
+
+    // Returns the wheel of the current RunLoop.
+    static std::shared_ptr<TimerWheel> get();
+
+    // Calls the function once the timeout has passed, rounded up to the granularity of the wheel,
+    // and then every `repeat` period unless it is zero.
+    TimerID start(Duration timeout, Duration repeat, std::function<void()>&&);
+
+    // Does nothing if the timer has fired already, unless it repeats.
+    void stop(TimerID);
+
+    // The number of timers that are pending.
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    Duration getGranularity() const {
+        return granularity;
+    }
+
+private:
+    static constexpr const std::size_t levelBits = 6;
+    static constexpr const std::size_t slotCount = 1 << levelBits;
+    static constexpr const std::size_t levelCount = 4;
+
+    // Denotes the timers that don't fit into the levels yet.
+    static constexpr const std::size_t overflowLevel = levelCount;
+
+    // Denotes the timers of a slot that is firing, which are in no slot anymore.
+    static constexpr const std::size_t firingLevel = levelCount + 1;
+
+    struct Entry {
+        uint64_t expiry;
+        uint64_t repeat;
+        std::function<void()> callback;
+        std::size_t level;
+        std::size_t slot;
+        // The position in the slot, so that stopping a timer doesn't search for it.
+        std::size_t index;
+    };
+
+    using Slot = std::vector<TimerID>;
+
+    uint64_t tickAt(TimePoint) const;
+    TimePoint timeOf(uint64_t tick) const;
+
+    // Adds the timer to the slot of the lowest level whose span covers its expiry.
+    void insert(TimerID, Entry&);
+    // Moves the last timer of the slot into the place of the removed one.
+    void remove(TimerID, const Entry&);
+
+    // Moves the timers of a slot down to the lower levels.
+    void cascade(Slot&&);
+
+    // Processes the ticks up to the current time, and waits for the next one that has timers.
+    void advance();
+    void fire(Slot&&);
+    void schedule();
+
+    const Duration granularity;
+    const TimePoint epoch;
+
+    // The last tick that has been processed.
+    uint64_t tick = 0;
+    optional<uint64_t> scheduledTick;
+    bool advancing = false;
+
+    TimerID nextID = 1;
+    std::unordered_map<TimerID, Entry> entries;
+    std::array<std::array<Slot, slotCount>, levelCount> levels;
+    Slot overflow;
+
+    Timer timer;
+};
+
+// A timer like util::Timer, but firing on the wheel of the current RunLoop, for timeouts that
+// may be off by up to a second, like those of expiration refreshes. Should the RunLoop be gone,
+// the timer doesn't fire anymore.
+class CoarseTimer : private util::noncopyable {
+public:
+    CoarseTimer();
+    explicit CoarseTimer(std::shared_ptr<TimerWheel>);
+    ~CoarseTimer();
+
+    void start(Duration timeout, Duration repeat, std::function<void()>&&);
+    void stop();
+
+private:
+    std::weak_ptr<TimerWheel> wheel;
+    optional<TimerWheel::TimerID> id;
+};
+
+} // namespace util
+} // namespace mbgl
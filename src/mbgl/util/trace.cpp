@@ -0,0 +1,193 @@
+#include <mbgl/util/trace.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+namespace trace {
+
+namespace {
+
+std::atomic<bool> enabled { false };
+
+} // namespace
+
+struct Event {
+    const char* name;
+    optional<CanonicalTileID> tile;
+    TimePoint start;
+    Duration duration;
+};
+
+class ThreadBuffer {
+public:
+    // Enough for the stages of a few hundred tiles.
+    static constexpr std::size_t capacity = 4096;
+
+    ThreadBuffer(uint32_t tid_) : tid(tid_) {
+        events.reserve(capacity);
+    }
+
+    void record(Event&& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (events.size() < capacity) {
+            events.push_back(std::move(event));
+        } else {
+            events[next] = std::move(event);
+        }
+        next = (next + 1) % capacity;
+    }
+
+    const uint32_t tid;
+    // Only contended while the events are exported.
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::size_t next = 0;
+};
+
+namespace {
+
+// Buffers outlive their threads, so that what those recorded can still be exported. Threads of
+// the pools are long lived, which keeps their number bounded.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry& instance = *new Registry;
+    return instance;
+}
+
+ThreadBuffer& currentBuffer() {
+    static ThreadLocal<ThreadBuffer>& current = *new ThreadLocal<ThreadBuffer>;
+    ThreadBuffer* buffer = current.get();
+    if (!buffer) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(reg.buffers.size() + 1)));
+        buffer = reg.buffers.back().get();
+        current.set(buffer);
+    }
+    return *buffer;
+}
+
+} // namespace
+
+void setEnabled(bool enabled_) {
+    enabled = enabled_;
+}
+
+bool isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+std::string exportChromeTrace() {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    const TimePoint epoch = TimePoint();
+    auto micros = [] (Duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> registryLock(reg.mutex);
+    for (const auto& threadBuffer : reg.buffers) {
+        std::lock_guard<std::mutex> lock(threadBuffer->mutex);
+        for (const Event& event : threadBuffer->events) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(event.name);
+            writer.Key("cat");
+            writer.String(event.tile ? "tile" : "mbgl");
+            writer.Key("ph");
+            writer.String("X");
+            writer.Key("ts");
+            writer.Int64(micros(event.start - epoch));
+            writer.Key("dur");
+            writer.Int64(micros(event.duration));
+            writer.Key("pid");
+            writer.Uint(1);
+            writer.Key("tid");
+            writer.Uint(threadBuffer->tid);
+            if (event.tile) {
+                const std::string tile = std::to_string(event.tile->z) + "/" +
+                    std::to_string(event.tile->x) + "/" + std::to_string(event.tile->y);
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key("tile");
+                writer.String(tile.c_str());
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+        threadBuffer->events.clear();
+        threadBuffer->next = 0;
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    return buffer.GetString();
+}
+
+optional<CanonicalTileID> tileOf(const Resource& resource) {
+    if (!resource.tileData) {
+        return {};
+    }
+    return CanonicalTileID(resource.tileData->z, resource.tileData->x, resource.tileData->y);
+}
+
+Span::Span(const char* name_, optional<CanonicalTileID> tile_) {
+    if (isEnabled()) {
+        name = name_;
+        tile = std::move(tile_);
+        start = Clock::now();
+    }
+}
+
+Span::Span(Span&& other)
+    : name(other.name), tile(std::move(other.tile)), start(other.start) {
+    other.name = nullptr;
+}
+
+Span& Span::operator=(Span&& other) {
+    if (this != &other) {
+        end();
+        name = other.name;
+        tile = std::move(other.tile);
+        start = other.start;
+        other.name = nullptr;
+    }
+    return *this;
+}
+
+Span::~Span() {
+    end();
+}
+
+void Span::end() {
+    if (!name) {
+        return;
+    }
+    if (isEnabled()) {
+        currentBuffer().record({ name, std::move(tile), start, Clock::now() - start });
+    }
+    name = nullptr;
+}
+
+} // namespace trace
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace util {
+namespace trace {
+
+/*
+   Records spans of time, such as the stages a tile goes through from being requested to being
+   drawn for the first time, so that they can be inspected in chrome://tracing or Perfetto. Every
+   thread records into a ring buffer of its own, which keeps its most recent events.
+
+   Tracing is off until enabled. While it is, spans don't do anything but check whether it is.
+*/
+
+class ThreadBuffer;
+
+void setEnabled(bool);
+bool isEnabled();
+
+// Returns the events recorded on all threads in the Chrome trace event format, and clears them.
+// Events of a tile have its ID as their "tile" argument.
+std::string exportChromeTrace();
+
+// The tile that a resource is for, if it is one.
+optional<CanonicalTileID> tileOf(const Resource&);
+
+// A span of time that starts when it's constructed, and ends when it is destroyed or end() is
+// called. It is recorded on the thread it ends on. Spans are movable, so that those of
+// asynchronous work can be kept along with it. Spans without a name aren't recorded.
+class Span {
+public:
+    Span() = default;
+    explicit Span(const char* name, optional<CanonicalTileID> tile = {});
+    Span(Span&&);
+    Span& operator=(Span&&);
+    ~Span();
+
+    void end();
+
+private:
+    const char* name = nullptr;
+    optional<CanonicalTileID> tile;
+    TimePoint start;
+};
+
+} // namespace trace
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,33 @@
+#include <mbgl/util/unitbezier_table.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+namespace util {
+
+UnitBezierTable::UnitBezierTable(const UnitBezier& curve) {
+    for (std::size_t i = 0; i <= segments; i++) {
+        samples[i] = curve.solve(double(i) / segments, 0.001);
+    }
+}
+
+double UnitBezierTable::solve(double x) const {
+    if (!(x > 0)) {
+        return samples.front();
+    }
+    if (x >= 1) {
+        return samples.back();
+    }
+
+    const double position = x * segments;
+    const auto index = std::size_t(position);
+    const double fraction = position - index;
+    return samples[index] + (samples[index + 1] - samples[index]) * fraction;
+}
+
+const UnitBezierTable& UnitBezierTable::defaultTransitionEase() {
+    static const UnitBezierTable table { DEFAULT_TRANSITION_EASE };
+    return table;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <mbgl/util/unitbezier.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace mbgl {
+namespace util {
+
+// A unit bezier curve sampled at evenly spaced x values, so that easing looks up the two samples
+// around x and interpolates between them, instead of solving the curve numerically every time.
+// Samples are solved with the same precision that style transitions have always used, and
+// easing at the sample points, like the midpoint, gives the same values as solving the curve.
+class UnitBezierTable {
+public:
+    explicit UnitBezierTable(const UnitBezier&);
+
+    // Clamps `x` to [0, 1].
+    double solve(double x) const;
+
+    // The table of DEFAULT_TRANSITION_EASE, which style transitions ease with.
+    static const UnitBezierTable& defaultTransitionEase();
+
+private:
+    static constexpr std::size_t segments = 256;
+    std::array<double, segments + 1> samples;
+};
+
+} // namespace util
+} // namespace mbgl
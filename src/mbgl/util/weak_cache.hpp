@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mbgl {
+namespace util {
+
+/*
+   A process-wide registry of immutable values that are expensive to produce, such as parsed
+   glyph ranges and sprites, so that maps which load the same resources can share them instead
+   of each holding a copy. The cache only references values weakly: they are kept alive by
+   whoever uses them, and disappear once the last of them lets go.
+
+   Safe to use from any thread.
+*/
+template <class Key, class Value>
+class WeakCache : private util::noncopyable {
+public:
+    std::shared_ptr<const Value> get(const Key& key) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = values.find(key);
+        return it == values.end() ? nullptr : it->second.lock();
+    }
+
+    // Replaces any previous value of the key, and drops entries that expired in the meantime.
+    void add(const Key& key, std::shared_ptr<const Value> value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = values.begin(); it != values.end();) {
+            it = it->second.expired() ? values.erase(it) : std::next(it);
+        }
+        values[key] = value;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<Key, std::weak_ptr<const Value>> values;
+};
+
+} // namespace util
+} // namespace mbgl
@@ -7,6 +7,9 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -336,3 +339,172 @@ TEST(Actor, NoSelfActorRef) {
     withArguments.invoke(&WithArguments::receive);
     future.wait();
 }
+
+TEST(Actor, OrderedMailboxMultipleSenders) {
+    // Messages sent concurrently from several threads are all received, and each sender's
+    // messages are received in the order it sent them.
+
+    struct Test {
+        std::vector<int> last;
+
+        Test(ActorRef<Test>, std::size_t senders)
+            : last(senders, -1) {
+        }
+
+        void receive(std::size_t sender, int i) {
+            EXPECT_EQ(last[sender] + 1, i);
+            last[sender] = i;
+        }
+
+        std::vector<int> result() {
+            return last;
+        }
+    };
+
+    const std::size_t senders = 8;
+    const int messages = 1000;
+
+    ThreadPool pool { 2 };
+    Actor<Test> test(pool, senders);
+
+    std::vector<std::thread> threads;
+    for (std::size_t sender = 0; sender < senders; ++sender) {
+        threads.emplace_back([&, sender] (ActorRef<Test> ref) {
+            for (int i = 0; i < messages; ++i) {
+                ref.invoke(&Test::receive, sender, i);
+            }
+        }, test.self());
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(std::vector<int>(senders, messages - 1), test.ask(&Test::result).get());
+}
+
+TEST(Actor, Priority) {
+    // When several mailboxes are waiting for a ThreadPool worker, the ones with the highest
+    // priority are processed first.
+
+    struct Blocker {
+        std::promise<void> entered;
+        std::shared_future<void> release;
+
+        Blocker(ActorRef<Blocker>, std::promise<void> entered_, std::shared_future<void> release_)
+            : entered(std::move(entered_)), release(std::move(release_)) {
+        }
+
+        void block() {
+            entered.set_value();
+            release.wait();
+        }
+    };
+
+    struct Test {
+        int id;
+        std::vector<int>& order;
+
+        Test(ActorRef<Test>, int id_, std::vector<int>& order_)
+            : id(id_), order(order_) {
+        }
+
+        void receive() {
+            order.push_back(id);
+        }
+    };
+
+    ThreadPool pool { 1 };
+
+    std::promise<void> enteredPromise;
+    std::future<void> enteredFuture = enteredPromise.get_future();
+    std::promise<void> releasePromise;
+    Actor<Blocker> blocker(pool, std::move(enteredPromise), releasePromise.get_future().share());
+
+    std::vector<int> order;
+    Actor<Test> low(pool, 1, std::ref(order));
+    Actor<Test> high(pool, 2, std::ref(order));
+    Actor<Test> medium(pool, 3, std::ref(order));
+    high.setPriority(10);
+    medium.setPriority(5);
+
+    // Occupy the only worker so that all three mailboxes are queued at the same time.
+    blocker.invoke(&Blocker::block);
+    enteredFuture.wait();
+
+    low.invoke(&Test::receive);
+    high.invoke(&Test::receive);
+    medium.invoke(&Test::receive);
+
+    std::promise<void> donePromise;
+    std::future<void> doneFuture = donePromise.get_future();
+    struct Done {
+        Done(ActorRef<Done>) {}
+        void done(std::promise<void> promise) { promise.set_value(); }
+    };
+    Actor<Done> done(pool);
+    done.invoke(&Done::done, std::move(donePromise));
+
+    releasePromise.set_value();
+    doneFuture.wait();
+
+    EXPECT_EQ((std::vector<int>{ 2, 3, 1 }), order);
+}
+
+TEST(Actor, Coalesce) {
+    // Coalesced messages supersede the coalesced messages for the same function that haven't been
+    // received yet. Other messages, and coalesced messages for other functions, are all received.
+
+    struct Test {
+        std::shared_future<void> release;
+        std::vector<std::string> received;
+
+        Test(ActorRef<Test>, std::shared_future<void> release_)
+            : release(std::move(release_)) {
+        }
+
+        void block() {
+            release.wait();
+        }
+
+        void set(int i) {
+            received.push_back("set " + std::to_string(i));
+        }
+
+        void configure(int i) {
+            received.push_back("configure " + std::to_string(i));
+        }
+
+        std::vector<std::string> result() {
+            return received;
+        }
+    };
+
+    ThreadPool pool { 1 };
+
+    std::promise<void> releasePromise;
+    Actor<Test> test(pool, releasePromise.get_future().share());
+    ActorRef<Test> ref = test.self();
+
+    // Keeps the messages below waiting in the mailbox.
+    test.invoke(&Test::block);
+
+    test.coalesce(&Test::set, 1);
+    test.invoke(&Test::set, 2);
+    ref.coalesce(&Test::configure, 1);
+    test.coalesce(&Test::set, 3);
+    ref.coalesce(&Test::configure, 2);
+    test.coalesce(&Test::set, 4);
+
+    releasePromise.set_value();
+
+    EXPECT_EQ((std::vector<std::string> { "set 2", "configure 2", "set 4" }), test.ask(&Test::result).get());
+
+    // Once received, a coalesced message doesn't supersede the ones pushed after it.
+    test.coalesce(&Test::set, 5);
+    test.ask(&Test::result).get();
+    test.coalesce(&Test::set, 6);
+
+    EXPECT_EQ((std::vector<std::string> { "set 2", "configure 2", "set 4", "set 5", "set 6" }),
+              test.ask(&Test::result).get());
+}
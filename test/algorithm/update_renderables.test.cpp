@@ -1259,3 +1259,38 @@ TEST(UpdateRenderables, LoadRequiredIfIdealTileCantBeFound) {
               }),
               log);
 }
+
+TEST(UpdateRenderables, MixedZoomLevels) {
+    ActionLog log;
+    MockSource source;
+    auto getTileData = getTileDataFn(log, source.dataTiles);
+    auto createTileData = createTileDataFn(log, source.dataTiles);
+    auto retainTileData = retainTileDataFn(log);
+    auto renderTile = renderTileFn(log);
+
+    // A level of detail cover, with a tile far from the camera one zoom level lower. The tiles are
+    // overscaled by one zoom level, each of them.
+    source.zoomRange.max = 3;
+    source.idealTiles.emplace(UnwrappedTileID{ 3, 0, 0 });
+    source.idealTiles.emplace(UnwrappedTileID{ 2, 1, 0 });
+
+    auto tile_3_2_1_0 = source.createTileData(OverscaledTileID{ 3, 0, { 2, 1, 0 } });
+    tile_3_2_1_0->renderable = true;
+
+    algorithm::updateRenderables(getTileData, createTileData, retainTileData, renderTile,
+                                 source.idealTiles, source.zoomRange, 4);
+    EXPECT_EQ(ActionLog({
+                  GetTileDataAction{ { 3, 0, { 2, 1, 0 } }, Found }, // lower ideal tile, ready
+                  RetainTileDataAction{ { 3, 0, { 2, 1, 0 } }, Resource::Necessity::Required }, //
+                  RenderTileAction{ { 2, 1, 0 }, *tile_3_2_1_0 }, //
+                  GetTileDataAction{ { 4, 0, { 3, 0, 0 } }, NotFound }, // ideal tile, missing
+                  CreateTileDataAction{ { 4, 0, { 3, 0, 0 } } }, //
+                  RetainTileDataAction{ { 4, 0, { 3, 0, 0 } }, Resource::Necessity::Required }, //
+                  GetTileDataAction{ { 5, 0, { 3, 0, 0 } }, NotFound }, // overzoomed child
+                  GetTileDataAction{ { 3, 0, { 3, 0, 0 } }, NotFound }, // ascent
+                  GetTileDataAction{ { 2, 0, { 2, 0, 0 } }, NotFound }, // ...
+                  GetTileDataAction{ { 1, 0, { 1, 0, 0 } }, NotFound }, // ...
+                  GetTileDataAction{ { 0, 0, { 0, 0, 0 } }, NotFound }, // ...
+              }),
+              log);
+}
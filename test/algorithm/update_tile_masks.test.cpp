@@ -130,3 +130,20 @@ TEST(UpdateTileMasks, Complex) {
         MaskedRenderable{ UnwrappedTileID{ 14, 4114, 5825 }, { CanonicalTileID{ 0, 0, 0 } } },
     });
 }
+
+TEST(UpdateTileMasks, MaskedArea) {
+    EXPECT_EQ(1.0, maskedArea({ CanonicalTileID{ 0, 0, 0 } }));
+    EXPECT_EQ(0.0, maskedArea({}));
+
+    std::vector<MaskedRenderable> renderables {
+        MaskedRenderable{ UnwrappedTileID{ 0, 0, 0 }, {} },
+        MaskedRenderable{ UnwrappedTileID{ 1, 0, 0 }, {} },
+        MaskedRenderable{ UnwrappedTileID{ 2, 2, 2 }, {} },
+    };
+    algorithm::updateTileMasks<MaskedRenderable>({ renderables.begin(), renderables.end() });
+
+    // Every part of the parent is drawn once, either by itself or by one of the children.
+    EXPECT_EQ(1.0 - 0.25 - 0.0625, maskedArea(renderables[0].mask));
+    EXPECT_EQ(1.0, maskedArea(renderables[1].mask));
+    EXPECT_EQ(1.0, maskedArea(renderables[2].mask));
+}
@@ -160,6 +160,23 @@ TEST(Annotations, AddMultiple) {
     test.checkRendering("add_multiple");
 }
 
+TEST(Annotations, AddMultipleAtOnce) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationImage(namedMarker("default_marker"));
+    AnnotationIDs ids = test.map.addAnnotations({
+        SymbolAnnotation { Point<double> { -10, 0 }, "default_marker" },
+        SymbolAnnotation { Point<double> { 10, 0 }, "default_marker" }
+    });
+    ASSERT_EQ(2u, ids.size());
+    EXPECT_NE(ids[0], ids[1]);
+    test.checkRendering("add_multiple");
+
+    test.map.removeAnnotations(ids);
+    test.checkRendering("remove_point");
+}
+
 TEST(Annotations, NonImmediateAdd) {
     AnnotationTest test;
 
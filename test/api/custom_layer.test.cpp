@@ -67,6 +67,14 @@ public:
         MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(GLfloat), triangle, GL_STATIC_DRAW));
     }
 
+    // Uploads the triangle again, as a layer double buffering its instance data would.
+    void prepare() {
+        GLfloat triangle[] = { 0, 0.5, 0.5, -0.5, -0.5, -0.5 };
+        MBGL_CHECK_ERROR(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+        MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, 6 * sizeof(GLfloat), triangle));
+        prepared++;
+    }
+
     void render() {
         MBGL_CHECK_ERROR(glUseProgram(program));
         MBGL_CHECK_ERROR(glBindBuffer(GL_ARRAY_BUFFER, buffer));
@@ -80,6 +88,7 @@ public:
     GLuint fragmentShader = 0;
     GLuint buffer = 0;
     GLuint a_pos = 0;
+    unsigned prepared = 0;
 };
 
 TEST(CustomLayer, Basic) {
@@ -112,3 +121,48 @@ TEST(CustomLayer, Basic) {
 
     test::checkImage("test/fixtures/custom_layer/basic", frontend.render(map), 0.0006, 0.1);
 }
+
+TEST(CustomLayer, Prepare) {
+    util::RunLoop loop;
+
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+    ThreadPool threadPool(4);
+    float pixelRatio { 1 };
+    HeadlessFrontend frontend { pixelRatio, fileSource, threadPool };
+    Map map(frontend, MapObserver::nullObserver(), frontend.getSize(), pixelRatio, fileSource,
+            threadPool, MapMode::Still);
+    map.getStyle().loadJSON(util::read_file("test/fixtures/api/water.json"));
+    map.setLatLngZoom({ 37.8, -122.5 }, 10);
+
+    static unsigned prepared = 0;
+    auto custom = std::make_unique<CustomLayer>(
+        "custom",
+        [] (void* context) {
+            reinterpret_cast<TestLayer*>(context)->initialize();
+        },
+        [] (void* context, const CustomLayerRenderParameters&) {
+            EXPECT_EQ(prepared + 1, reinterpret_cast<TestLayer*>(context)->prepared);
+            prepared = reinterpret_cast<TestLayer*>(context)->prepared;
+            reinterpret_cast<TestLayer*>(context)->render();
+        },
+        [] (void* context) {
+            delete reinterpret_cast<TestLayer*>(context);
+        }, new TestLayer());
+    custom->setPrepareFunction([] (void* context, const CustomLayerRenderParameters& parameters) {
+        EXPECT_NE(0, parameters.projectionMatrix[0]);
+        reinterpret_cast<TestLayer*>(context)->prepare();
+    });
+    custom->setModifiedGLState(CustomLayerGLState::Program | CustomLayerGLState::VertexArrays);
+    EXPECT_TRUE(custom->getModifiedGLState() & CustomLayerGLState::Program);
+    EXPECT_FALSE(custom->getModifiedGLState() & CustomLayerGLState::Framebuffer);
+    map.getStyle().addLayer(std::move(custom));
+
+    auto layer = std::make_unique<FillLayer>("landcover", "mapbox");
+    layer->setSourceLayer("landcover");
+    layer->setFillColor(Color{ 1.0, 1.0, 0.0, 1.0 });
+    map.getStyle().addLayer(std::move(layer));
+
+    // Layers that only declare some of the state render the same as those that don't.
+    test::checkImage("test/fixtures/custom_layer/basic", frontend.render(map), 0.0006, 0.1);
+    EXPECT_LT(0u, prepared);
+}
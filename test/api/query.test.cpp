@@ -47,6 +47,45 @@ TEST(Query, QueryRenderedFeatures) {
     EXPECT_EQ(features2.size(), 0u);
 }
 
+TEST(Query, QueryRenderedFeaturesBatch) {
+    QueryTest test;
+
+    auto zz = test.map.pixelForLatLng({ 0, 0 });
+    auto nn = test.map.pixelForLatLng({ 9, 9 });
+
+    auto features = test.frontend.getRenderer()->queryRenderedFeatures(std::vector<ScreenCoordinate> { zz, nn, zz });
+    ASSERT_EQ(features.size(), 3u);
+    EXPECT_EQ(features[0].size(), 4u);
+    EXPECT_EQ(features[1].size(), 0u);
+    EXPECT_EQ(features[2].size(), 4u);
+
+    auto layerFeatures = test.frontend.getRenderer()->queryRenderedFeatures(
+        std::vector<ScreenBox> { { { zz.x - 1, zz.y - 1 }, { zz.x + 1, zz.y + 1 } } }, {{{ "layer1", "layer2" }}, {}});
+    ASSERT_EQ(layerFeatures.size(), 1u);
+    EXPECT_EQ(layerFeatures[0].size(), 2u);
+
+    EXPECT_TRUE(test.frontend.getRenderer()->queryRenderedFeatures(std::vector<ScreenBox>()).empty());
+}
+
+TEST(Query, QueryRenderedFeaturesAcrossTiles) {
+    QueryTest test;
+
+    // The features at the corner of the four tiles of zoom 1.
+    test.map.setLatLngZoom({ 0, 0 }, 1);
+    test.frontend.render(test.map);
+
+    auto points = test.frontend.getRenderer()->queryRenderedFeatures(test.map.pixelForLatLng({ 0, 0 }));
+    EXPECT_FALSE(points.empty());
+
+    // Tiles of box queries are queried in parallel, but their results are merged in tile order.
+    const Size size = test.frontend.getSize();
+    const ScreenBox box { { 0, 0 }, { double(size.width), double(size.height) } };
+    auto features1 = test.frontend.getRenderer()->queryRenderedFeatures(box);
+    auto features2 = test.frontend.getRenderer()->queryRenderedFeatures(box);
+    EXPECT_GE(features1.size(), points.size());
+    EXPECT_EQ(features1, features2);
+}
+
 TEST(Query, QueryRenderedFeaturesFilterLayer) {
     QueryTest test;
 
@@ -122,3 +161,29 @@ TEST(Query, QuerySourceFeaturesFilter) {
     EXPECT_EQ(features3.size(), 1u);
 }
 
+TEST(Query, QuerySourceFeaturesGeometry) {
+    QueryTest test;
+
+    SourceQueryOptions options;
+    options.geometry = std::vector<LatLng> { { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 } };
+    auto features1 = test.frontend.getRenderer()->querySourceFeatures("source4", options);
+    EXPECT_EQ(features1.size(), 1u);
+
+    options.geometry = std::vector<LatLng> { { 5, 5 }, { 5, 6 }, { 6, 6 }, { 6, 5 } };
+    auto features2 = test.frontend.getRenderer()->querySourceFeatures("source4", options);
+    EXPECT_EQ(features2.size(), 0u);
+}
+
+TEST(Query, QuerySourceFeaturesCallback) {
+    QueryTest test;
+
+    SourceQueryOptions options;
+    options.unique = true;
+    std::vector<FeatureIdentifier> ids;
+    test.frontend.getRenderer()->querySourceFeatures("source4", options, [&] (Feature&& feature) {
+        ASSERT_TRUE(bool(feature.id));
+        ids.push_back(*feature.id);
+    });
+    ASSERT_EQ(ids.size(), 1u);
+    EXPECT_EQ(ids[0], FeatureIdentifier(std::string("feature1")));
+}
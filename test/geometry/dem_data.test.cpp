@@ -0,0 +1,65 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/dem_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A Terrain-RGB tile, with elevations in meters given for each pixel.
+template <class Fn>
+PremultipliedImage terrain(uint32_t dim, Fn&& elevation) {
+    PremultipliedImage image({ dim, dim });
+    uint8_t* pixel = image.data.get();
+    for (uint32_t y = 0; y < dim; y++) {
+        for (uint32_t x = 0; x < dim; x++, pixel += 4) {
+            const uint32_t value = (elevation(x, y) + 10000) * 10;
+            pixel[0] = value >> 16;
+            pixel[1] = (value >> 8) & 0xFF;
+            pixel[2] = value & 0xFF;
+            pixel[3] = 255;
+        }
+    }
+    return image;
+}
+
+uint8_t slope(const DEMData& dem, uint32_t x, uint32_t y, uint32_t channel) {
+    return dem.getSlopes().data[(y * dem.dim + x) * 4 + channel];
+}
+
+} // namespace
+
+TEST(DEMData, Decode) {
+    const CanonicalTileID id { 14, 8192, 8192 };
+    DEMData dem(terrain(4, [] (uint32_t x, uint32_t) { return x * 100; }), id);
+
+    ASSERT_EQ(4, dem.dim);
+    EXPECT_NEAR(100, dem.get(1, 2), 0.01);
+
+    // The border starts out as a copy of the edges.
+    EXPECT_NEAR(0, dem.get(-1, 0), 0.01);
+    EXPECT_NEAR(300, dem.get(4, 4), 0.01);
+
+    // Rising towards the east, and flat towards the south.
+    EXPECT_LT(128, slope(dem, 1, 1, 0));
+    EXPECT_EQ(128, slope(dem, 1, 1, 1));
+
+    EXPECT_THROW(DEMData(PremultipliedImage({ 4, 2 }), id), std::runtime_error);
+}
+
+TEST(DEMData, BackfillBorder) {
+    const CanonicalTileID id { 14, 8192, 8192 };
+    DEMData dem(terrain(4, [] (uint32_t, uint32_t) { return 0; }), id);
+    const DEMData east(terrain(4, [] (uint32_t x, uint32_t) { return x == 0 ? 500 : 0; }), { 14, 8193, 8192 });
+
+    EXPECT_EQ(128, slope(dem, 3, 1, 0));
+
+    dem.backfillBorder(east, 1, 0);
+    EXPECT_NEAR(500, dem.get(4, 1), 0.01);
+    EXPECT_NEAR(0, dem.get(4, -1), 0.01);
+
+    // The slopes along the border take the neighbor into account.
+    EXPECT_LT(128, slope(dem, 3, 1, 0));
+    EXPECT_EQ(128, slope(dem, 2, 1, 0));
+}
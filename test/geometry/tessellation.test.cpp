@@ -0,0 +1,74 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/tessellation.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+// The summed area of the triangles, which matches the area of the polygon when it's covered.
+double triangleArea(const GeometryCollection& polygon, const std::vector<uint32_t>& indices) {
+    GeometryCoordinates vertices;
+    for (const auto& ring : polygon) {
+        vertices.insert(vertices.end(), ring.begin(), ring.end());
+    }
+
+    double area = 0;
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        const GeometryCoordinate& a = vertices.at(indices[i]);
+        const GeometryCoordinate& b = vertices.at(indices[i + 1]);
+        const GeometryCoordinate& c = vertices.at(indices[i + 2]);
+        area += std::abs(double(b.x - a.x) * (c.y - a.y) - double(b.y - a.y) * (c.x - a.x)) / 2;
+    }
+    return area;
+}
+
+} // namespace
+
+TEST(Tessellation, Convex) {
+    const GeometryCollection square { { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 }, { 0, 0 } } };
+    EXPECT_EQ((std::vector<uint32_t> { 0, 1, 2, 0, 2, 3 }), tessellate(square));
+
+    // Open rings, and collinear points.
+    const GeometryCollection triangle { { { 0, 0 }, { 5, 0 }, { 10, 0 }, { 0, 10 } } };
+    EXPECT_EQ((std::vector<uint32_t> { 0, 1, 2, 0, 2, 3 }), tessellate(triangle));
+    EXPECT_EQ(50.0, triangleArea(triangle, tessellate(triangle)));
+}
+
+TEST(Tessellation, Concave) {
+    const GeometryCollection corner { { { 0, 0 }, { 20, 0 }, { 20, 10 }, { 10, 10 }, { 10, 20 }, { 0, 20 }, { 0, 0 } } };
+    const std::vector<uint32_t> indices = tessellate(corner);
+    EXPECT_EQ(12u, indices.size());
+    EXPECT_EQ(300.0, triangleArea(corner, indices));
+
+    const GeometryCollection withHole {
+        { { 0, 0 }, { 20, 0 }, { 20, 20 }, { 0, 20 }, { 0, 0 } },
+        { { 5, 5 }, { 5, 15 }, { 15, 15 }, { 15, 5 }, { 5, 5 } }
+    };
+    EXPECT_EQ(300.0, triangleArea(withHole, tessellate(withHole)));
+}
+
+TEST(Tessellation, Degenerate) {
+    EXPECT_TRUE(tessellate({ { { 0, 0 }, { 5, 0 }, { 10, 0 }, { 0, 0 } } }).empty());
+    EXPECT_TRUE(tessellate(GeometryCollection { GeometryCoordinates() }).empty());
+}
+
+TEST(TessellationCache, GetAndClear) {
+    TessellationCache cache;
+    EXPECT_EQ(nullptr, cache.get("buildings", 3));
+
+    cache.add("buildings", 3, { { 0, 1, 2 } });
+    ASSERT_NE(nullptr, cache.get("buildings", 3));
+    EXPECT_EQ((FeatureTessellation { { 0, 1, 2 } }), *cache.get("buildings", 3));
+    EXPECT_EQ(nullptr, cache.get("buildings", 4));
+    EXPECT_EQ(nullptr, cache.get("water", 3));
+
+    // Entries aren't replaced.
+    cache.add("buildings", 3, { { 2, 1, 0 } });
+    EXPECT_EQ((FeatureTessellation { { 0, 1, 2 } }), *cache.get("buildings", 3));
+
+    cache.clear();
+    EXPECT_EQ(nullptr, cache.get("buildings", 3));
+}
@@ -3,12 +3,15 @@
 
 #include <mbgl/renderer/buckets/circle_bucket.hpp>
 #include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/renderer/buckets/fill_extrusion_bucket.hpp>
 #include <mbgl/renderer/buckets/line_bucket.hpp>
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/programs/line_program.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/util/constants.hpp>
 
 #include <mbgl/map/mode.hpp>
 
@@ -47,7 +50,7 @@ TEST(Buckets, CircleBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 
     GeometryCollection point { { { 0, 0 } } };
-    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, point, properties }, point);
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, point, properties }, point, 0);
     ASSERT_TRUE(bucket.hasData());
     ASSERT_TRUE(bucket.needsUpload());
 
@@ -56,6 +59,22 @@ TEST(Buckets, CircleBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, CircleBucketSegments) {
+    CircleBucket bucket { { {0, 0, 0}, MapMode::Still, 1.0 }, {} };
+
+    // More circles than fit into one segment.
+    GeometryCollection points { {} };
+    for (int16_t i = 0; i < 20000; i++) {
+        points[0].emplace_back(i % util::EXTENT, i / util::EXTENT);
+    }
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, points, properties }, points, 0);
+
+    // All segments start at the beginning of the shared quad indices.
+    ASSERT_EQ(2u, bucket.segments.size());
+    EXPECT_EQ((Segment<CircleAttributes> { 0, 0, 65532, 98298 }), bucket.segments[0]);
+    EXPECT_EQ((Segment<CircleAttributes> { 65532, 0, 14468, 21702 }), bucket.segments[1]);
+}
+
 TEST(Buckets, FillBucket) {
     gl::Context context;
     FillBucket bucket { { {0, 0, 0}, MapMode::Still, 1.0 }, {} };
@@ -63,7 +82,7 @@ TEST(Buckets, FillBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 
     GeometryCollection polygon { { { 0, 0 }, { 0, 1 }, { 1, 1 } } };
-    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, polygon, properties }, polygon);
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, polygon, properties }, polygon, 0);
     ASSERT_TRUE(bucket.hasData());
     ASSERT_TRUE(bucket.needsUpload());
 
@@ -71,6 +90,58 @@ TEST(Buckets, FillBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, FillBucketSegmentBounds) {
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still, 1.0 }, {} };
+
+    GeometryCollection square { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 } } };
+    for (std::size_t i = 0; i < segmentCullingVertices / 4; i++) {
+        bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, square, properties }, square, i);
+    }
+
+    // Once a segment is large enough, a polygon far from it starts a new one, which those close
+    // to that polygon are added to.
+    GeometryCollection distant { { { 4000, 4000 }, { 4000, 4010 }, { 4010, 4010 }, { 4010, 4000 } } };
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, distant, properties }, distant, 1024);
+    GeometryCollection nearby { { { 4100, 4100 }, { 4100, 4110 }, { 4110, 4110 }, { 4110, 4100 } } };
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, nearby, properties }, nearby, 1025);
+
+    ASSERT_EQ(2u, bucket.triangleSegments.size());
+    ASSERT_EQ(2u, bucket.lineSegments.size());
+    EXPECT_EQ(segmentCullingVertices, bucket.triangleSegments[0].vertexLength);
+    EXPECT_EQ(segmentCullingVertices, bucket.lineSegments[1].vertexOffset);
+
+    ASSERT_EQ(2u, bucket.triangleSegmentBounds.size());
+    EXPECT_EQ((GeometryCoordinate { 0, 0 }), bucket.triangleSegmentBounds[0].min);
+    EXPECT_EQ((GeometryCoordinate { 10, 10 }), bucket.triangleSegmentBounds[0].max);
+    EXPECT_EQ((GeometryCoordinate { 4000, 4000 }), bucket.triangleSegmentBounds[1].min);
+    EXPECT_EQ((GeometryCoordinate { 4110, 4110 }), bucket.triangleSegmentBounds[1].max);
+    ASSERT_EQ(2u, bucket.lineSegmentBounds.size());
+    EXPECT_EQ(bucket.triangleSegmentBounds[1].max, bucket.lineSegmentBounds[1].max);
+}
+
+TEST(Buckets, FillExtrusionBucketWalls) {
+    FillExtrusionBucket bucket { { {0, 0, 0}, MapMode::Still, 1.0 }, {} };
+
+    // The walls of small buildings are kept apart from those of the others.
+    GeometryCollection small { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 0, 0 } } };
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, small, properties }, small, 0);
+    GeometryCollection large { { { 100, 100 }, { 100, 1000 }, { 1000, 1000 }, { 100, 100 } } };
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, large, properties }, large, 1);
+    ASSERT_TRUE(bucket.hasData());
+
+    ASSERT_EQ(1u, bucket.triangleSegments.size());
+    ASSERT_EQ(1u, bucket.wallSegments.size());
+    ASSERT_EQ(1u, bucket.smallWallSegments.size());
+    EXPECT_EQ(6u, bucket.triangleSegments[0].indexLength);
+    EXPECT_EQ(18u, bucket.wallSegments[0].indexLength);
+    EXPECT_EQ(18u, bucket.smallWallSegments[0].indexLength);
+    EXPECT_EQ(bucket.triangleSegments[0].vertexLength, bucket.wallSegments[0].vertexLength);
+
+    ASSERT_EQ(1u, bucket.segmentBounds.size());
+    EXPECT_EQ((GeometryCoordinate { 0, 0 }), bucket.segmentBounds[0].min);
+    EXPECT_EQ((GeometryCoordinate { 1000, 1000 }), bucket.segmentBounds[0].max);
+}
+
 TEST(Buckets, LineBucket) {
     gl::Context context;
     LineBucket bucket { { {0, 0, 0}, MapMode::Still, 1.0 }, {}, {} };
@@ -79,11 +150,11 @@ TEST(Buckets, LineBucket) {
 
     // Ignore invalid feature type.
     GeometryCollection point { { { 0, 0 } } };
-    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, point, properties }, point);
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, point, properties }, point, 0);
     ASSERT_FALSE(bucket.hasData());
 
     GeometryCollection line { { { 0, 0 }, { 1, 1 } } };
-    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::LineString, line, properties }, line);
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::LineString, line, properties }, line, 0);
     ASSERT_TRUE(bucket.hasData());
     ASSERT_TRUE(bucket.needsUpload());
 
@@ -91,6 +162,37 @@ TEST(Buckets, LineBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, SharedPaintPropertyBinders) {
+    using namespace style;
+
+    LinePaintProperties::PossiblyEvaluated casing;
+    casing.get<LineColor>() = PossiblyEvaluatedPropertyValue<Color>(
+        SourceFunction<Color>("class", IdentityStops<Color>(), Color::black()));
+    LinePaintProperties::PossiblyEvaluated fill = casing;
+    fill.get<LineWidth>() = PossiblyEvaluatedPropertyValue<float>(
+        SourceFunction<float>("width", IdentityStops<float>(), 1.0f));
+
+    LineProgram::PaintPropertyBinders casingBinders(casing, 0);
+    LineProgram::PaintPropertyBinders fillBinders(fill, 0);
+    fillBinders.share(fill, casingBinders);
+
+    // The color function is the same, so its binder is shared. The width function isn't.
+    EXPECT_EQ(&casingBinders.statistics<LineColor>(), &fillBinders.statistics<LineColor>());
+    EXPECT_NE(&casingBinders.statistics<LineWidth>(), &fillBinders.statistics<LineWidth>());
+
+    // Constants aren't shared.
+    EXPECT_NE(&casingBinders.statistics<LineOpacity>(), &fillBinders.statistics<LineOpacity>());
+
+    // Shared binders are only populated by their owner.
+    PropertyMap featureProperties { { "class", std::string("red") }, { "width", 2.0 } };
+    GeometryCollection line { { { 0, 0 }, { 1, 1 } } };
+    StubGeometryTileFeature feature { {}, FeatureType::LineString, line, featureProperties };
+    casingBinders.populateVertexVectors(feature, 4);
+    fillBinders.populateVertexVectors(feature, 4);
+    EXPECT_EQ(2.0f, *fillBinders.statistics<LineWidth>().max());
+    EXPECT_FALSE(casingBinders.statistics<LineWidth>().max());
+}
+
 TEST(Buckets, SymbolBucket) {
     style::SymbolLayoutProperties::PossiblyEvaluated layout;
     bool sdfIcons = false;
@@ -106,7 +208,7 @@ TEST(Buckets, SymbolBucket) {
 
     // SymbolBucket::addFeature() is a no-op.
     GeometryCollection point { { { 0, 0 } } };
-    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, point, properties }, point);
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Point, point, properties }, point, 0);
     ASSERT_FALSE(bucket.hasData());
     ASSERT_FALSE(bucket.needsUpload());
 
@@ -136,29 +238,44 @@ TEST(Buckets, RasterBucket) {
 }
 
 TEST(Buckets, RasterBucketMaskEmpty) {
-    RasterBucket bucket{ nullptr };
-    bucket.setMask({});
-    EXPECT_EQ((std::vector<RasterLayoutVertex>{}), bucket.vertices.vector());
-    EXPECT_EQ((std::vector<uint16_t>{}), bucket.indices.vector());
+    TileMaskGeometry geometry{ TileMask{} };
+    EXPECT_EQ((std::vector<RasterLayoutVertex>{}), geometry.vertices.vector());
+    EXPECT_EQ((std::vector<uint16_t>{}), geometry.indices.vector());
     SegmentVector<RasterAttributes> expectedSegments;
     expectedSegments.emplace_back(0, 0, 0, 0);
-    EXPECT_EQ(expectedSegments, bucket.segments);
+    EXPECT_EQ(expectedSegments, geometry.segments);
 }
 
 TEST(Buckets, RasterBucketMaskNoChildren) {
+    TileMaskCache cache;
     RasterBucket bucket{ nullptr };
     bucket.setMask({ CanonicalTileID{ 0, 0, 0 } });
 
     // A mask of 0/0/0 doesn't produce buffers since we're instead using the global shared buffers.
-    EXPECT_EQ((std::vector<RasterLayoutVertex>{}), bucket.vertices.vector());
-    EXPECT_EQ((std::vector<uint16_t>{}), bucket.indices.vector());
-    EXPECT_EQ((SegmentVector<RasterAttributes>{}), bucket.segments);
+    EXPECT_FALSE(cache.get(bucket.mask));
+    EXPECT_FALSE(bucket.maskGeometry);
+}
+
+TEST(Buckets, RasterBucketMaskShared) {
+    TileMaskCache cache;
+    const TileMask mask = { CanonicalTileID{ 1, 0, 0 }, CanonicalTileID{ 1, 1, 1 } };
+
+    // Tiles with the same mask share its geometry, for as long as one of them uses it.
+    auto geometry = cache.get(mask);
+    EXPECT_EQ(geometry, cache.get(TileMask(mask)));
+    EXPECT_NE(geometry, cache.get({ CanonicalTileID{ 1, 0, 0 } }));
+
+    EXPECT_EQ(2u, cache.size());
+
+    // Masks that no tile uses anymore are dropped.
+    geometry.reset();
+    auto other = cache.get({ CanonicalTileID{ 1, 1, 0 } });
+    EXPECT_EQ(1u, cache.size());
 }
 
  TEST(Buckets, RasterBucketMaskTwoChildren) {
-     RasterBucket bucket{ nullptr };
-     bucket.setMask(
-         { CanonicalTileID{ 1, 0, 0 }, CanonicalTileID{ 1, 1, 1 } });
+     TileMaskGeometry geometry{
+         { CanonicalTileID{ 1, 0, 0 }, CanonicalTileID{ 1, 1, 1 } } };
 
      EXPECT_EQ(
          (std::vector<RasterLayoutVertex>{
@@ -174,7 +291,7 @@ TEST(Buckets, RasterBucketMaskNoChildren) {
              RasterProgram::layoutVertex({ 4096, 8192 }, { 4096, 8192 }),
              RasterProgram::layoutVertex({ 8192, 8192 }, { 8192, 8192 }),
          }),
-         bucket.vertices.vector());
+         geometry.vertices.vector());
 
      EXPECT_EQ(
          (std::vector<uint16_t>{
@@ -186,19 +303,18 @@ TEST(Buckets, RasterBucketMaskNoChildren) {
              4, 5, 6,
              5, 6, 7,
          }),
-         bucket.indices.vector());
+         geometry.indices.vector());
 
 
      SegmentVector<RasterAttributes> expectedSegments;
      expectedSegments.emplace_back(0, 0, 8, 12);
-     EXPECT_EQ(expectedSegments, bucket.segments);
+     EXPECT_EQ(expectedSegments, geometry.segments);
  }
 
  TEST(Buckets, RasterBucketMaskComplex) {
-     RasterBucket bucket{ nullptr };
-     bucket.setMask(
+     TileMaskGeometry geometry{
          { CanonicalTileID{ 1, 0, 1 }, CanonicalTileID{ 1, 1, 0 }, CanonicalTileID{ 2, 2, 3 },
-           CanonicalTileID{ 2, 3, 2 }, CanonicalTileID{ 3, 6, 7 }, CanonicalTileID{ 3, 7, 6 } });
+           CanonicalTileID{ 2, 3, 2 }, CanonicalTileID{ 3, 6, 7 }, CanonicalTileID{ 3, 7, 6 } } };
 
      EXPECT_EQ(
          (std::vector<RasterLayoutVertex>{
@@ -238,7 +354,7 @@ TEST(Buckets, RasterBucketMaskNoChildren) {
              RasterProgram::layoutVertex({ 7168, 7168 }, { 7168, 7168 }),
              RasterProgram::layoutVertex({ 8192, 7168 }, { 8192, 7168 }),
          }),
-         bucket.vertices.vector());
+         geometry.vertices.vector());
 
      EXPECT_EQ(
          (std::vector<uint16_t>{
@@ -266,10 +382,10 @@ TEST(Buckets, RasterBucketMaskNoChildren) {
              20, 21, 22,
              21, 22, 23,
          }),
-         bucket.indices.vector());
+         geometry.indices.vector());
 
 
      SegmentVector<RasterAttributes> expectedSegments;
      expectedSegments.emplace_back(0, 0, 24, 36);
-     EXPECT_EQ(expectedSegments, bucket.segments);
+     EXPECT_EQ(expectedSegments, geometry.segments);
  }
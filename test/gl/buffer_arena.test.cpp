@@ -0,0 +1,58 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/buffer_arena.hpp>
+
+using namespace mbgl;
+using namespace mbgl::gl;
+
+TEST(BufferArena, Allocate) {
+    BufferArena arena { 128 };
+
+    // Ranges are aligned.
+    EXPECT_EQ(0u, *arena.allocate(10));
+    EXPECT_EQ(16u, *arena.allocate(30));
+    EXPECT_EQ(48u, *arena.allocate(16));
+    EXPECT_EQ(64u, arena.getUsedBytes());
+    EXPECT_EQ(64u, arena.getLargestFreeRange());
+
+    EXPECT_FALSE(bool(arena.allocate(65)));
+    EXPECT_EQ(64u, *arena.allocate(64));
+    EXPECT_FALSE(bool(arena.allocate(1)));
+    EXPECT_EQ(0u, arena.getFreeRangeCount());
+}
+
+TEST(BufferArena, BestFit) {
+    BufferArena arena { 256 };
+    const std::size_t a = *arena.allocate(64);
+    arena.allocate(16);
+    const std::size_t b = *arena.allocate(32);
+    arena.allocate(16);
+
+    arena.release(a, 64);
+    arena.release(b, 32);
+    EXPECT_EQ(3u, arena.getFreeRangeCount());
+
+    // Ranges are taken from the smallest free range they fit in.
+    EXPECT_EQ(32u, *arena.fit(20));
+    EXPECT_EQ(b, *arena.allocate(20));
+    EXPECT_EQ(64u, *arena.fit(48));
+    EXPECT_EQ(a, *arena.allocate(48));
+}
+
+TEST(BufferArena, Release) {
+    BufferArena arena { 128 };
+    const std::size_t a = *arena.allocate(32);
+    const std::size_t b = *arena.allocate(32);
+    const std::size_t c = *arena.allocate(32);
+
+    arena.release(a, 32);
+    arena.release(c, 32);
+    EXPECT_EQ(2u, arena.getFreeRangeCount());
+    EXPECT_EQ(64u, arena.getLargestFreeRange());
+
+    // Releasing the range between two free ones merges all three.
+    arena.release(b, 32);
+    EXPECT_EQ(1u, arena.getFreeRangeCount());
+    EXPECT_EQ(128u, arena.getLargestFreeRange());
+    EXPECT_TRUE(arena.empty());
+}
@@ -3,6 +3,7 @@
 #include <mbgl/renderer/backend_scope.hpp>
 #include <mbgl/gl/headless_backend.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/programs/attributes.hpp>
 
 #include <memory>
 
@@ -63,3 +64,116 @@ TEST(GLObject, Store) {
     context.reset();
     EXPECT_TRUE(context.empty());
 }
+
+TEST(GLObject, TileTexturePool) {
+    HeadlessBackend backend { { 256, 256 } };
+    BackendScope scope { backend };
+
+    gl::Context context;
+    const PremultipliedImage image({ 256, 256 });
+
+    optional<gl::Texture> texture = context.createTileTexture(image, true);
+    const gl::TextureID id = texture->texture.get();
+    EXPECT_EQ(0u, context.getTileTexturePoolStats().hits);
+    EXPECT_EQ(1u, context.getTileTexturePoolStats().misses);
+
+    // Released tile textures are reused by tiles of the same size.
+    texture = {};
+    texture = context.createTileTexture(image, false);
+    EXPECT_EQ(id, texture->texture.get());
+    EXPECT_EQ(1u, context.getTileTexturePoolStats().hits);
+
+    texture = {};
+    texture = context.createTileTexture(PremultipliedImage({ 512, 512 }), false);
+    EXPECT_NE(id, texture->texture.get());
+    EXPECT_EQ(2u, context.getTileTexturePoolStats().misses);
+
+    texture = {};
+    context.reset();
+    EXPECT_TRUE(context.empty());
+}
+
+TEST(GLObject, BufferArenas) {
+    HeadlessBackend backend { { 256, 256 } };
+    BackendScope scope { backend };
+
+    gl::Context context;
+
+    using Vertex = gl::Attributes<attributes::a_pos>::Vertex;
+    auto vertices = [] (std::size_t count) {
+        gl::VertexVector<Vertex> result;
+        for (std::size_t i = 0; i < count; i++) {
+            result.emplace_back(Vertex { {{ int16_t(i % 256), 0 }} });
+        }
+        return result;
+    };
+
+    // Small static buffers are ranges of the same buffer, aligned.
+    optional<gl::VertexBuffer<Vertex>> a = context.createVertexBuffer(vertices(10));
+    optional<gl::VertexBuffer<Vertex>> b = context.createVertexBuffer(vertices(10));
+    EXPECT_EQ(a->buffer.get(), b->buffer.get());
+    EXPECT_EQ(0u, a->byteOffset);
+    EXPECT_EQ(48u, b->byteOffset);
+
+    // Dynamic and large buffers have buffers of their own.
+    optional<gl::VertexBuffer<Vertex>> dynamic = context.createVertexBuffer(vertices(10), gl::BufferUsage::DynamicDraw);
+    EXPECT_NE(a->buffer.get(), dynamic->buffer.get());
+    EXPECT_EQ(0u, dynamic->byteOffset);
+    optional<gl::VertexBuffer<Vertex>> large = context.createVertexBuffer(vertices(gl::BufferArenaRangeMax / sizeof(Vertex) + 1));
+    EXPECT_NE(a->buffer.get(), large->buffer.get());
+
+    gl::Context::BufferArenaStats stats = context.getBufferArenaStats();
+    EXPECT_EQ(1u, stats.arenas);
+    EXPECT_EQ(gl::BufferArenaSize, stats.reservedBytes);
+    EXPECT_EQ(96u, stats.usedBytes);
+    EXPECT_EQ(1u, stats.freeRanges);
+
+    // Released ranges are merged with the free ranges next to them.
+    a = {};
+    stats = context.getBufferArenaStats();
+    EXPECT_EQ(48u, stats.usedBytes);
+    EXPECT_EQ(2u, stats.freeRanges);
+    EXPECT_EQ(gl::BufferArenaSize - 96, stats.largestFreeRange);
+
+    b = {};
+    stats = context.getBufferArenaStats();
+    EXPECT_EQ(0u, stats.usedBytes);
+    EXPECT_EQ(1u, stats.freeRanges);
+    EXPECT_EQ(gl::BufferArenaSize, stats.largestFreeRange);
+
+    // An empty arena is kept for the buffers to come, unless memory is reduced.
+    context.performCleanup();
+    EXPECT_EQ(1u, context.getBufferArenaStats().arenas);
+    context.releaseBufferArenas();
+    EXPECT_EQ(0u, context.getBufferArenaStats().arenas);
+
+    dynamic = {};
+    large = {};
+    context.reset();
+    EXPECT_TRUE(context.empty());
+}
+
+TEST(GLObject, HashBindings) {
+    gl::AttributeBinding binding { gl::DataType::Short, 2, 0, 1, 4, 0 };
+    gl::AttributeBindingArray bindings;
+    bindings[0] = binding;
+
+    gl::AttributeBindingArray same;
+    same[0] = binding;
+    EXPECT_EQ(gl::hashBindings(bindings), gl::hashBindings(same));
+
+    // Vertex arrays bound to other buffers, offsets or locations are told apart.
+    gl::AttributeBindingArray other = bindings;
+    other[0]->vertexBuffer = 2;
+    EXPECT_NE(gl::hashBindings(bindings), gl::hashBindings(other));
+
+    other = bindings;
+    other[0]->vertexOffset = 10;
+    EXPECT_NE(gl::hashBindings(bindings), gl::hashBindings(other));
+
+    other = {};
+    other[1] = binding;
+    EXPECT_NE(gl::hashBindings(bindings), gl::hashBindings(other));
+
+    EXPECT_NE(gl::hashBindings(bindings), gl::hashBindings(bindings, 1));
+}
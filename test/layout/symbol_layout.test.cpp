@@ -0,0 +1,240 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/renderer/image_atlas.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/style/image_impl.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/placement_config.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubGeometryTileFeature>(features.at(i));
+    }
+    std::string getName() const override { return "symbols"; }
+
+    std::vector<StubGeometryTileFeature> features;
+};
+
+// Lays out a grid of icons that are closer to each other than they are wide, so that some of them
+// only show at higher zoom levels and others never.
+class SymbolLayoutTest {
+public:
+    style::SymbolLayer layer { "symbol", "source" };
+    MapMode mode = MapMode::Continuous;
+
+    mapbox::ShelfPack shelfPack { 64, 64 };
+    ImageMap imageMap;
+    ImagePositions imagePositions;
+    ShapingCache shapingCache;
+    FeatureIndex featureIndex;
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers;
+
+    SymbolLayoutTest() {
+        layer.setIconImage(std::string("icon"));
+
+        Immutable<style::Image::Impl> image = makeMutable<style::Image::Impl>("icon", PremultipliedImage({ 16, 16 }), 1.0f);
+        imagePositions.emplace("icon", ImagePosition(*shelfPack.packOne(-1, 18, 18), *image));
+        imageMap.emplace("icon", std::move(image));
+    }
+
+    std::unique_ptr<SymbolLayout> layout() {
+        auto sourceLayer = std::make_unique<StubGeometryTileLayer>();
+        for (int16_t i = 0; i < 400; ++i) {
+            const int16_t x = 256 + (i % 20) * 96;
+            const int16_t y = 256 + (i / 20) * 96 + (i % 3) * 32;
+            sourceLayer->features.emplace_back(optional<FeatureIdentifier>(), FeatureType::Point,
+                GeometryCollection { GeometryCoordinates { GeometryCoordinate { x, y } } }, PropertyMap());
+        }
+
+        renderLayers = RenderLayer::createForLayout({ layer.baseImpl }, 10);
+        ImageDependencies imageDependencies;
+        GlyphDependencies glyphDependencies;
+        auto result = std::make_unique<SymbolLayout>(BucketParameters { OverscaledTileID(10, 0, 0), mode, 1.0f },
+                                                     std::vector<const RenderLayer*> { renderLayers.front().get() },
+                                                     std::move(sourceLayer), imageDependencies, glyphDependencies,
+                                                     featureIndex);
+        result->prepare({}, {}, imageMap, imagePositions, shapingCache, nullptr, [] { return false; });
+        return result;
+    }
+};
+
+const auto notCancelled = [] { return false; };
+
+template <typename Vertices>
+bool sameVertices(const Vertices& a, const Vertices& b) {
+    return a.vertexSize() == b.vertexSize() && std::memcmp(a.data(), b.data(), a.byteSize()) == 0;
+}
+
+std::vector<float> placementZooms(const std::vector<PlacedSymbol>& placedSymbols) {
+    std::vector<float> zooms;
+    for (const auto& placedSymbol : placedSymbols) {
+        zooms.push_back(placedSymbol.placementZoom);
+    }
+    return zooms;
+}
+
+} // namespace
+
+TEST(SymbolLayout, BudgetedPlacementMatchesUnbudgetedPlacement) {
+    SymbolLayoutTest test;
+    PlacementConfig config;
+    config.angle = 0.5;
+
+    auto unbudgetedLayout = test.layout();
+    CollisionTile unbudgetedTile(config);
+    auto unbudgetedBucket = unbudgetedLayout->place(unbudgetedTile, notCancelled);
+    ASSERT_TRUE(unbudgetedBucket);
+    const SymbolBucket& unbudgeted = *unbudgetedBucket;
+    ASSERT_TRUE(unbudgetedLayout->placementComplete());
+
+    auto budgetedLayout = test.layout();
+    CollisionTile budgetedTile(config);
+    std::vector<std::unique_ptr<SymbolBucket>> passes;
+    do {
+        std::size_t budget = 64;
+        passes.push_back(budgetedLayout->place(budgetedTile, notCancelled, false, &budget));
+        ASSERT_TRUE(passes.back());
+        if (!budgetedLayout->placementComplete()) {
+            EXPECT_EQ(0u, budget);
+        }
+    } while (!budgetedLayout->placementComplete());
+    ASSERT_EQ(7u, passes.size());
+    const SymbolBucket& budgeted = *passes.back();
+
+    // Each pass hands out the symbols placed so far, which the next one adds to.
+    for (std::size_t i = 1; i < passes.size(); ++i) {
+        const auto& previous = passes[i - 1]->icon;
+        const auto& next = passes[i]->icon;
+        ASSERT_LE(previous.vertices.vertexSize(), next.vertices.vertexSize());
+        EXPECT_EQ(0, std::memcmp(previous.vertices.data(), next.vertices.data(), previous.vertices.byteSize()));
+    }
+
+    // Not all icons show at the zoom level of the tile, so the placement matters.
+    const std::vector<float> zooms = placementZooms(unbudgeted.icon.placedSymbols);
+    ASSERT_FALSE(zooms.empty());
+    EXPECT_LT(zooms.size(), 400u);
+    EXPECT_NE(*std::min_element(zooms.begin(), zooms.end()), *std::max_element(zooms.begin(), zooms.end()));
+
+    EXPECT_EQ(zooms, placementZooms(budgeted.icon.placedSymbols));
+    EXPECT_TRUE(sameVertices(unbudgeted.icon.vertices, budgeted.icon.vertices));
+    EXPECT_TRUE(sameVertices(unbudgeted.icon.dynamicVertices, budgeted.icon.dynamicVertices));
+    EXPECT_EQ(unbudgeted.icon.triangles.vector(), budgeted.icon.triangles.vector());
+    ASSERT_EQ(unbudgeted.icon.segments.size(), budgeted.icon.segments.size());
+    for (std::size_t i = 0; i < unbudgeted.icon.segments.size(); ++i) {
+        EXPECT_EQ(unbudgeted.icon.segments[i].vertexLength, budgeted.icon.segments[i].vertexLength);
+        EXPECT_EQ(unbudgeted.icon.segments[i].indexLength, budgeted.icon.segments[i].indexLength);
+    }
+}
+
+TEST(SymbolLayout, UpdatePlacement) {
+    SymbolLayoutTest test;
+    auto layout = test.layout();
+
+    CollisionTile initialTile(PlacementConfig {});
+    auto bucket = layout->place(initialTile, notCancelled, true);
+    ASSERT_TRUE(bucket);
+    ASSERT_EQ(400u, bucket->icon.placedSymbols.size());
+    const auto vertices = bucket->icon.vertices;
+    const auto dynamicVertices = bucket->icon.dynamicVertices;
+    const auto triangles = bucket->icon.triangles;
+    const std::vector<float> initialZooms = placementZooms(bucket->icon.placedSymbols);
+
+    PlacementConfig config;
+    config.angle = 1.0;
+    ASSERT_TRUE(layout->canUpdatePlacement(config));
+
+    CollisionTile tile(config);
+    optional<SymbolPlacementZooms> zooms = layout->updatePlacement(tile, notCancelled);
+    ASSERT_TRUE(bool(zooms));
+    EXPECT_TRUE(zooms->text.empty());
+    ASSERT_EQ(400u, zooms->icon.size());
+    EXPECT_NE(initialZooms, zooms->icon);
+
+    // The zooms are those a new layout places the symbols at.
+    auto expectedLayout = test.layout();
+    CollisionTile expectedTile(config);
+    auto expected = expectedLayout->place(expectedTile, notCancelled, true);
+    ASSERT_TRUE(expected);
+    EXPECT_EQ(placementZooms(expected->icon.placedSymbols), zooms->icon);
+
+    // Applying them only changes the placement zooms, which the renderer writes to the dynamic
+    // vertex buffer; the static buffers stay as they are.
+    bucket->applyPlacement(*zooms);
+    EXPECT_EQ(zooms->icon, placementZooms(bucket->icon.placedSymbols));
+    EXPECT_TRUE(bucket->dynamicVerticesOutdated);
+    EXPECT_TRUE(sameVertices(vertices, bucket->icon.vertices));
+    EXPECT_TRUE(sameVertices(dynamicVertices, bucket->icon.dynamicVertices));
+    EXPECT_EQ(triangles.vector(), bucket->icon.triangles.vector());
+}
+
+TEST(SymbolLayout, UpdatePlacementFallsBackToLayout) {
+    {
+        SymbolLayoutTest test;
+        auto layout = test.layout();
+        EXPECT_TRUE(layout->canUpdatePlacement({}));
+
+        // Debug placements add collision boxes for the placement they're made for.
+        PlacementConfig config;
+        config.debug = true;
+        EXPECT_FALSE(layout->canUpdatePlacement(config));
+    }
+
+    {
+        // Still images are placed once.
+        SymbolLayoutTest test;
+        test.mode = MapMode::Still;
+        EXPECT_FALSE(test.layout()->canUpdatePlacement({}));
+    }
+
+    {
+        // Overlapping symbols are ordered by their position on screen, so a placement at another
+        // angle needs a bucket of its own.
+        SymbolLayoutTest test;
+        test.layer.setIconAllowOverlap(true);
+        auto layout = test.layout();
+
+        PlacementConfig config;
+        config.angle = 1.0;
+        EXPECT_FALSE(layout->canUpdatePlacement(config));
+
+        auto anchors = [](const SymbolBucket& bucket) {
+            std::vector<Point<float>> result;
+            for (const auto& placedSymbol : bucket.icon.placedSymbols) {
+                result.push_back(placedSymbol.anchorPoint);
+            }
+            return result;
+        };
+
+        CollisionTile initialTile(PlacementConfig {});
+        auto initial = layout->place(initialTile, notCancelled, true);
+        ASSERT_TRUE(initial);
+
+        CollisionTile tile(config);
+        auto placed = layout->place(tile, notCancelled, true);
+        ASSERT_TRUE(placed);
+        ASSERT_EQ(initial->icon.placedSymbols.size(), placed->icon.placedSymbols.size());
+        EXPECT_NE(anchors(*initial), anchors(*placed));
+        EXPECT_FALSE(sameVertices(initial->icon.vertices, placed->icon.vertices));
+    }
+}
@@ -6,6 +6,7 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_frontend.hpp>
+#include <mbgl/renderer/renderer.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/storage/default_file_source.hpp>
@@ -59,7 +60,14 @@ public:
     std::function<void()> onDidFinishLoadingMapCallback;
     std::function<void()> didFailLoadingMapCallback;
     std::function<void()> didFinishLoadingStyleCallback;
+    void onDidCollectGPUTimings(const GPUTimings& timings) final {
+        if (didCollectGPUTimings) {
+            didCollectGPUTimings(timings);
+        }
+    }
+
     std::function<void(RenderMode)> didFinishRenderingFrame;
+    std::function<void(const GPUTimings&)> didCollectGPUTimings;
 };
 
 template <class FileSource = StubFileSource>
@@ -429,6 +437,66 @@ TEST(Map, RemoveLayer) {
     test::checkImage("test/fixtures/map/remove_layer", test.frontend.render(test.map));
 }
 
+TEST(Map, PipelinedReadback) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({{ 1, 0, 0, 1 }});
+    test.map.getStyle().addLayer(std::move(layer));
+    test.frontend.renderAndStartReadback(test.map);
+
+    // Rendering the next image doesn't change the one that's being read back.
+    test.map.getStyle().removeLayer("background");
+    test.frontend.renderAndStartReadback(test.map);
+
+    test::checkImage("test/fixtures/map/add_layer", test.frontend.readStillImage());
+    test::checkImage("test/fixtures/map/remove_layer", test.frontend.readStillImage());
+}
+
+TEST(Map, RenderTiles) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({{ 1, 0, 0, 1 }});
+    test.map.getStyle().addLayer(std::move(layer));
+
+    auto tiles = test.frontend.renderTiles(test.map, 2);
+    ASSERT_EQ(4u, tiles.size());
+    for (const auto& tile : tiles) {
+        EXPECT_EQ((Size { 128, 128 }), tile.size);
+        EXPECT_EQ(255, tile.data[0]);
+        EXPECT_EQ(0, tile.data[1]);
+    }
+
+    EXPECT_THROW(HeadlessFrontend::splitImage(PremultipliedImage({ 256, 256 }), 3), std::invalid_argument);
+}
+
+TEST(Map, RenderAtPixelRatios) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({{ 1, 0, 0, 1 }});
+    test.map.getStyle().addLayer(std::move(layer));
+
+    auto images = test.frontend.render(test.map, { 1, 2 });
+    ASSERT_EQ(2u, images.size());
+    EXPECT_EQ((Size { 256, 256 }), images[0].size);
+    EXPECT_EQ((Size { 512, 512 }), images[1].size);
+    for (const auto& image : images) {
+        EXPECT_EQ(255, image.data[0]);
+        EXPECT_EQ(0, image.data[1]);
+    }
+
+    // The frontend renders at its own pixel ratio again afterwards.
+    EXPECT_EQ((Size { 256, 256 }), test.frontend.render(test.map).size);
+}
+
 TEST(Map, DisabledSources) {
     MapTest<> test;
 
@@ -489,6 +557,84 @@ TEST(Map, DisabledSources) {
     test::checkImage("test/fixtures/map/disabled_layers/second", test.frontend.render(test.map));
 }
 
+TEST(Map, RenderStillTimeout) {
+    MapTest<> test;
+
+    // Tiles never arrive.
+    test.fileSource.response = [] (const Resource&) -> optional<Response> {
+        return {};
+    };
+
+    test.map.getStyle().loadJSON(R"STYLE({
+  "version": 8,
+  "sources": {
+    "raster": { "type": "raster", "tiles": [ "tile://{z}-{x}-{y}" ], "tileSize": 256 }
+  },
+  "layers": [{
+    "id": "background",
+    "type": "background",
+    "paint": { "background-color": "red" }
+  }, {
+    "id": "raster",
+    "type": "raster",
+    "source": "raster"
+  }]
+})STYLE");
+
+    bool rendered = false;
+    test.map.renderStill(Milliseconds(50), [&] (std::exception_ptr error, MissingTiles missing) {
+        EXPECT_FALSE(error);
+        ASSERT_EQ(1u, missing.size());
+        EXPECT_EQ((MissingTile { "raster", 0, 0, 0 }), missing[0]);
+
+        PremultipliedImage image = test.frontend.readStillImage();
+        EXPECT_EQ(255, image.data[0]);
+        EXPECT_EQ(0, image.data[1]);
+        rendered = true;
+    });
+
+    while (!rendered) {
+        test.runLoop.runOnce();
+    }
+}
+
+TEST(Map, StyleSwitchReusesTiles) {
+    MapTest<> test;
+
+    unsigned tileRequests = 0;
+    test.fileSource.tileResponse = [&](const Resource&) {
+        tileRequests++;
+        Response response;
+        response.data = std::make_shared<std::string>(
+            util::read_file("test/fixtures/map/disabled_layers/tile.png"));
+        return response;
+    };
+
+    const std::string rasterStyle = R"STYLE({
+  "version": 8,
+  "sources": {
+    "raster": { "type": "raster", "tiles": [ "tile://{z}-{x}-{y}" ], "tileSize": 256 }
+  },
+  "layers": [{
+    "id": "raster",
+    "type": "raster",
+    "source": "raster"
+  }]
+})STYLE";
+
+    test.map.getStyle().loadJSON(rasterStyle);
+    test.frontend.render(test.map);
+    EXPECT_EQ(1u, tileRequests);
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.frontend.render(test.map);
+
+    // Switching back takes the tiles of the first style.
+    test.map.getStyle().loadJSON(rasterStyle);
+    test.frontend.render(test.map);
+    EXPECT_EQ(1u, tileRequests);
+}
+
 TEST(Map, DontLoadUnneededTiles) {
     MapTest<> test;
 
@@ -536,6 +682,93 @@ TEST(Map, DontLoadUnneededTiles) {
     }
 }
 
+TEST(Map, RendererStatistics) {
+    MapTest<> test;
+
+    test.fileSource.response = [] (const Resource& res) -> optional<Response> {
+        if (res.url == "asset://tile.png") {
+            Response response;
+            response.data = std::make_shared<std::string>(
+                util::read_file("test/fixtures/map/disabled_layers/tile.png"));
+            return {std::move(response)};
+        }
+        return {};
+    };
+
+    test.map.getStyle().loadJSON(R"STYLE({
+  "version": 8,
+  "sources": {
+    "raster": { "type": "raster", "tiles": [ "asset://tile.png" ], "tileSize": 256 }
+  },
+  "layers": [{
+    "id": "raster",
+    "type": "raster",
+    "source": "raster"
+  }]
+})STYLE");
+
+    test.frontend.render(test.map);
+
+    const RendererStatistics statistics = test.frontend.getRenderer()->getStatistics();
+    EXPECT_EQ(1u, statistics.frames);
+    EXPECT_LT(0u, statistics.drawCalls);
+    EXPECT_LT(0u, statistics.uploadedBytes);
+    EXPECT_EQ(0u, statistics.tiles.loading);
+    EXPECT_EQ(0u, statistics.tiles.pending);
+    EXPECT_LT(0u, statistics.tiles.complete);
+
+    // The raster tiles were uploaded as textures.
+    ASSERT_EQ(1u, statistics.sourceMemory.count("raster"));
+    EXPECT_LT(0u, statistics.sourceMemory.at("raster").gpu);
+
+    // The stub file source has no cache.
+    EXPECT_EQ(0u, statistics.cacheHits + statistics.cacheMisses);
+
+    // A still image is complete when it's first rendered.
+    EXPECT_LT(Duration::zero(), statistics.timeToFirstFrame);
+    EXPECT_EQ(statistics.timeToFirstFrame, statistics.timeToFullFrame);
+
+    test.frontend.render(test.map);
+    EXPECT_EQ(2u, test.frontend.getRenderer()->getStatistics().frames);
+    EXPECT_EQ(statistics.timeToFirstFrame, test.frontend.getRenderer()->getStatistics().timeToFirstFrame);
+}
+
+TEST(Map, OpaqueLayersBatchedByProgram) {
+    MapTest<> test;
+
+    test.map.getStyle().loadJSON(R"STYLE({
+  "version": 8,
+  "sources": {
+    "shape": {
+      "type": "geojson",
+      "data": {
+        "type": "Polygon",
+        "coordinates": [ [ [ -10, -10 ], [ 10, -10 ], [ 10, 10 ], [ -10, 10 ], [ -10, -10 ] ] ]
+      }
+    }
+  },
+  "layers": [{
+    "id": "below",
+    "type": "fill",
+    "source": "shape",
+    "paint": { "fill-color": "red", "fill-antialias": false }
+  }, {
+    "id": "background",
+    "type": "background",
+    "paint": { "background-color": "white" }
+  }, {
+    "id": "above",
+    "type": "fill",
+    "source": "shape",
+    "paint": { "fill-color": "blue", "fill-antialias": false }
+  }]
+})STYLE");
+
+    // Both fills are drawn before the background that's between them, saving a program change.
+    test.frontend.render(test.map);
+    EXPECT_EQ(1u, test.frontend.getRenderer()->getStatistics().stateChangesAvoided);
+}
+
 TEST(Map, TEST_DISABLED_ON_CI(ContinuousRendering)) {
     util::RunLoop runLoop;
     ThreadPool threadPool { 4 };
@@ -569,3 +802,54 @@ TEST(Map, TEST_DISABLED_ON_CI(ContinuousRendering)) {
 
     runLoop.run();
 }
+
+TEST(Map, GPUTimingsForwarded) {
+    util::RunLoop runLoop;
+    ThreadPool threadPool { 4 };
+    StubFileSource fileSource;
+    float pixelRatio { 1 };
+
+    HeadlessFrontend frontend(pixelRatio, fileSource, threadPool);
+    frontend.getRenderer()->setGPUTimingEnabled(true);
+
+    optional<GPUTimings> collected;
+    unsigned frames = 0;
+
+    StubMapObserver observer;
+    Map map(frontend, observer, frontend.getSize(), pixelRatio, fileSource, threadPool, MapMode::Continuous);
+
+    // Timings trail the frame they measure, so keep rendering until they arrive.
+    observer.didFinishRenderingFrame = [&] (MapObserver::RenderMode) {
+        if (collected || ++frames == 30) {
+            runLoop.stop();
+        } else {
+            map.triggerRepaint();
+        }
+    };
+    observer.didCollectGPUTimings = [&] (const GPUTimings& timings) {
+        collected = timings;
+    };
+
+    map.getStyle().loadJSON(R"STYLE({
+  "version": 8,
+  "sources": {},
+  "layers": [{
+    "id": "background",
+    "type": "background",
+    "paint": { "background-color": "white" }
+  }]
+})STYLE");
+
+    runLoop.run();
+
+    BackendScope scope { *frontend.getBackend() };
+    if (!frontend.getBackend()->getContext().getTimerQueryExtension()) {
+        EXPECT_FALSE(collected);
+        return;
+    }
+
+    ASSERT_TRUE(collected);
+    EXPECT_FALSE(collected->passes.empty());
+    ASSERT_EQ(1u, collected->layers.size());
+    EXPECT_EQ("background", collected->layers[0].first);
+}
@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/map/transform.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/geo.hpp>
 
 using namespace mbgl;
@@ -476,6 +477,43 @@ TEST(Transform, Camera) {
     ASSERT_FALSE(transform.inTransition());
 }
 
+TEST(Transform, TransitionKeyframes) {
+    Transform transform;
+    transform.resize({ 1000, 1000 });
+    transform.setLatLngZoom({ 0, 0 }, 2);
+    EXPECT_TRUE(transform.getTransitionKeyframes().empty());
+
+    CameraOptions camera;
+    camera.center = LatLng { 40, 60 };
+    camera.zoom = 12;
+
+    // The sampled path ends at the destination, without moving the camera.
+    transform.flyTo(camera, AnimationOptions(Seconds(1)));
+    auto keyframes = transform.getTransitionKeyframes();
+    ASSERT_EQ(4u, keyframes.size());
+    EXPECT_NEAR(40, keyframes.back().getLatLng().latitude(), 0.001);
+    EXPECT_NEAR(60, keyframes.back().getLatLng().longitude(), 0.001);
+    EXPECT_NEAR(12, keyframes.back().getZoom(), 0.00001);
+    EXPECT_DOUBLE_EQ(2, transform.getZoom());
+
+    // Keyframes the camera has passed are dropped.
+    transform.updateTransitions(transform.getTransitionStart() + Milliseconds(600));
+    keyframes = transform.getTransitionKeyframes();
+    ASSERT_FALSE(keyframes.empty());
+    EXPECT_GT(4u, keyframes.size());
+    EXPECT_NEAR(12, keyframes.back().getZoom(), 0.00001);
+
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    EXPECT_TRUE(transform.getTransitionKeyframes().empty());
+
+    // Cancelling a transition clears its keyframes.
+    camera.zoom = 4;
+    transform.easeTo(camera, AnimationOptions(Seconds(1)));
+    EXPECT_EQ(4u, transform.getTransitionKeyframes().size());
+    transform.cancelTransitions();
+    EXPECT_TRUE(transform.getTransitionKeyframes().empty());
+}
+
 TEST(Transform, DefaultTransform) {
     struct TransformObserver : public mbgl::MapObserver {
         void onCameraWillChange(MapObserver::CameraChangeMode) final {
@@ -609,3 +647,26 @@ TEST(Transform, PitchBounds) {
     transform.setPitch(60.0 * util::DEG2RAD);
     ASSERT_NEAR(transform.getState().getPitch() * util::RAD2DEG, 55.0, 1e-5);
 }
+
+TEST(Transform, ProjectedTileMatrix) {
+    Transform transform;
+    transform.resize({ 1000, 1000 });
+    transform.setLatLngZoom({ 37.7749, -122.4194 }, 12.5);
+    transform.setPitch(45.0 * util::DEG2RAD);
+    transform.setAngle(30.0 * util::DEG2RAD);
+
+    mat4 projMatrix;
+    transform.getState().getProjMatrix(projMatrix);
+
+    for (const UnwrappedTileID id : { UnwrappedTileID { 12, 655, 1583 }, UnwrappedTileID { -1, { 1, 0, 1 } } }) {
+        mat4 expected;
+        transform.getState().matrixFor(expected, id);
+        matrix::multiply(expected, projMatrix, expected);
+
+        mat4 projected;
+        transform.getState().matrixFor(projected, id, projMatrix);
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            EXPECT_DOUBLE_EQ(expected[i], projected[i]);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/programs/fill_program.hpp>
+#include <mbgl/renderer/backend_scope.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/bucket_uploader.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace mbgl;
+
+namespace {
+
+class StubBucket : public Bucket {
+public:
+    void upload(gl::Context& context) override {
+        gl::VertexVector<FillLayoutVertex> vertices;
+        vertices.emplace_back(FillProgram::layoutVertex({ 0, 0 }));
+        vertices.emplace_back(FillProgram::layoutVertex({ 4096, 0 }));
+        vertices.emplace_back(FillProgram::layoutVertex({ 0, 4096 }));
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        uploadThread = std::this_thread::get_id();
+        uploaded = true;
+    }
+
+    bool hasData() const override {
+        return true;
+    }
+
+    RendererStatistics::Memory memoryUsage() const override {
+        return {};
+    }
+
+    optional<gl::VertexBuffer<FillLayoutVertex>> vertexBuffer;
+    std::thread::id uploadThread;
+};
+
+} // namespace
+
+TEST(BucketUploader, UploadsThroughSharedContext) {
+    HeadlessBackend backend;
+    backend.setSharedUploadContextEnabled(true);
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    // Not every headless platform can create a shared context.
+    if (!backend.supportsSharedUploadContext()) {
+        return;
+    }
+
+    BucketUploader uploader(backend);
+
+    auto bucket = std::make_shared<StubBucket>();
+    uploader.schedule({ { "layer", bucket } });
+    uploader.upload(*bucket, context);
+
+    EXPECT_FALSE(bucket->needsUpload());
+    EXPECT_NE(std::this_thread::get_id(), bucket->uploadThread);
+
+    // The buffer was made by the upload context, and is usable by the rendering context.
+    ASSERT_TRUE(bool(bucket->vertexBuffer));
+    EXPECT_EQ(GLboolean(GL_TRUE), MBGL_CHECK_ERROR(glIsBuffer(bucket->vertexBuffer->buffer.get())));
+}
+
+TEST(BucketUploader, UploadsUnscheduledBucketsRightAway) {
+    HeadlessBackend backend;
+    backend.setSharedUploadContextEnabled(true);
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    if (!backend.supportsSharedUploadContext()) {
+        return;
+    }
+
+    BucketUploader uploader(backend);
+
+    StubBucket bucket;
+    uploader.upload(bucket, context);
+
+    EXPECT_FALSE(bucket.needsUpload());
+    EXPECT_EQ(std::this_thread::get_id(), bucket.uploadThread);
+}
+
+TEST(BucketUploader, DisabledByDefault) {
+    HeadlessBackend backend;
+    BackendScope scope { backend };
+    backend.getContext();
+
+    EXPECT_FALSE(backend.supportsSharedUploadContext());
+}
@@ -0,0 +1,139 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/renderer/cross_tile_symbol_index.hpp>
+#include <mbgl/renderer/layers/render_symbol_layer.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/tile/tile.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, SymbolBucket& bucket_)
+        : Tile(id_), bucket(bucket_) {
+        renderable = true;
+        loaded = true;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    void upload(gl::Context&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return &bucket; }
+
+    SymbolBucket& bucket;
+};
+
+// A tile with a bucket of line labels.
+class LabelledTile {
+public:
+    LabelledTile(const UnwrappedTileID& id)
+        : bucket(style::SymbolLayoutProperties::PossiblyEvaluated(),
+                 std::map<std::string, std::pair<style::IconPaintProperties::PossiblyEvaluated,
+                                                 style::TextPaintProperties::PossiblyEvaluated>>(),
+                 16.0f, 1.0f, id.canonical.z, false, false),
+          tile(id.overscaleTo(id.canonical.z), bucket),
+          renderTile(id, tile) {
+        bucket.labelRepeatDistance = 512;
+    }
+
+    void addLabel(const std::u16string& text, Point<float> anchor) {
+        bucket.labels.push_back({ text, anchor, bucket.text.placedSymbols.size(), {} });
+        bucket.text.placedSymbols.emplace_back(anchor, 0, 16.0f, 16.0f, std::array<float, 2> {{ 0, 0 }},
+                                               0.0f, false, GeometryCoordinates());
+    }
+
+    bool hidden(std::size_t label) const {
+        return bucket.text.placedSymbols.at(*bucket.labels.at(label).textSymbol).hidden;
+    }
+
+    SymbolBucket bucket;
+    StubTile tile;
+    RenderTile renderTile;
+};
+
+class CrossTileSymbolIndexTest {
+public:
+    style::SymbolLayer layer { "symbol", "source" };
+    std::unique_ptr<RenderLayer> renderLayer = RenderLayer::create(layer.baseImpl);
+    CrossTileSymbolIndex index;
+
+    // The left tile labels the street just before the edge it shares with the right one, which
+    // labels it again just after that edge.
+    LabelledTile left { UnwrappedTileID(1, 0, 0) };
+    LabelledTile right { UnwrappedTileID(1, 1, 0) };
+
+    CrossTileSymbolIndexTest() {
+        left.addLabel(u"Main Street", { 8100, 4000 });
+        right.addLabel(u"Main Street", { 50, 4000 });
+        right.addLabel(u"Side Street", { 60, 4100 });
+        right.addLabel(u"Main Street", { 4096, 4000 });
+    }
+
+    void render(std::vector<std::reference_wrapper<LabelledTile>> tiles) {
+        std::vector<std::reference_wrapper<RenderTile>> renderTiles;
+        for (LabelledTile& tile : tiles) {
+            renderTiles.emplace_back(tile.renderTile);
+        }
+        renderLayer->setRenderTiles(std::move(renderTiles));
+    }
+
+    bool update(TimePoint deadline = TimePoint::max()) {
+        return index.update({ renderLayer->as<RenderSymbolLayer>() }, deadline);
+    }
+};
+
+} // namespace
+
+TEST(CrossTileSymbolIndex, HidesDuplicateLabels) {
+    CrossTileSymbolIndexTest test;
+    test.render({ test.left, test.right });
+    EXPECT_TRUE(test.update());
+
+    EXPECT_TRUE(test.left.bucket.crossTileIndexed);
+    EXPECT_TRUE(test.right.bucket.crossTileIndexed);
+    EXPECT_TRUE(test.right.bucket.dynamicVerticesOutdated);
+
+    EXPECT_FALSE(test.left.hidden(0));
+    EXPECT_TRUE(test.right.hidden(0));
+
+    // Labels of another text, and those far from the edge, aren't duplicates.
+    EXPECT_FALSE(test.right.hidden(1));
+    EXPECT_FALSE(test.right.hidden(2));
+}
+
+TEST(CrossTileSymbolIndex, ShowsLabelsAgainOnceTheirNeighbourIsRemoved) {
+    CrossTileSymbolIndexTest test;
+    test.render({ test.left, test.right });
+    EXPECT_TRUE(test.update());
+    ASSERT_TRUE(test.right.hidden(0));
+
+    test.render({ test.right });
+    EXPECT_TRUE(test.update());
+    EXPECT_TRUE(test.right.bucket.crossTileIndexed);
+    EXPECT_FALSE(test.right.hidden(0));
+}
+
+TEST(CrossTileSymbolIndex, ResumesOnceTheBudgetIsUsedUp) {
+    CrossTileSymbolIndexTest test;
+    test.render({ test.left, test.right });
+
+    // With no time left, the buckets are left for the next update.
+    EXPECT_FALSE(test.update(Clock::now()));
+    EXPECT_FALSE(test.left.bucket.crossTileIndexed);
+    EXPECT_FALSE(test.right.bucket.crossTileIndexed);
+    EXPECT_FALSE(test.right.hidden(0));
+
+    EXPECT_TRUE(test.update());
+    EXPECT_TRUE(test.left.bucket.crossTileIndexed);
+    EXPECT_TRUE(test.right.bucket.crossTileIndexed);
+    EXPECT_FALSE(test.left.hidden(0));
+    EXPECT_TRUE(test.right.hidden(0));
+}
@@ -0,0 +1,65 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/renderer/feature_state.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+using namespace mbgl;
+
+TEST(FeatureState, Store) {
+    FeatureStateStore store;
+    EXPECT_EQ(nullptr, store.find("source", "layer"));
+    EXPECT_EQ(0.0f, store.get("source", "layer", uint64_t(1)));
+
+    EXPECT_TRUE(store.set("source", "layer", uint64_t(1), 0.5f));
+    EXPECT_FALSE(store.set("source", "layer", uint64_t(1), 0.5f));
+    EXPECT_EQ(0.5f, store.get("source", "layer", uint64_t(1)));
+
+    // Ids of different types are different features.
+    EXPECT_EQ(0.0f, store.get("source", "layer", int64_t(1)));
+    EXPECT_EQ(0.0f, store.get("source", "other", uint64_t(1)));
+
+    const FeatureStates* states = store.find("source", "layer");
+    ASSERT_NE(nullptr, states);
+    const uint64_t revision = states->revision;
+
+    EXPECT_TRUE(store.set("source", "layer", std::string("a"), 1.0f));
+    EXPECT_LT(revision, states->revision);
+    EXPECT_EQ(2u, states->states.size());
+
+    // Zero removes the state.
+    EXPECT_TRUE(store.set("source", "layer", uint64_t(1), 0.0f));
+    EXPECT_FALSE(store.set("source", "layer", uint64_t(1), 0.0f));
+    EXPECT_EQ(1u, states->states.size());
+}
+
+TEST(FeatureState, SerializeBuffer) {
+    FeatureStateBuffer buffer;
+    buffer.addFeature(StubGeometryTileFeature(FeatureIdentifier(uint64_t(7)), FeatureType::Point, {}, {}), 0, 4);
+    buffer.addFeature(StubGeometryTileFeature(PropertyMap()), 4, 8);
+    buffer.addFeature(StubGeometryTileFeature(FeatureIdentifier(uint64_t(3)), FeatureType::Point, {}, {}), 8, 12);
+
+    std::string data;
+    {
+        protozero::pbf_writer pbf(data);
+        buffer.serialize(pbf, 1);
+    }
+
+    FeatureStateBuffer copy;
+    protozero::pbf_reader pbf(data);
+    ASSERT_TRUE(pbf.next(1));
+    EXPECT_TRUE(copy.deserialize(pbf));
+    EXPECT_EQ(buffer.memoryUsage().cpu, copy.memoryUsage().cpu);
+
+    // Buffers with ids that aren't unsigned integers aren't serialized.
+    FeatureStateBuffer strings;
+    strings.addFeature(StubGeometryTileFeature(FeatureIdentifier(std::string("a")), FeatureType::Point, {}, {}), 0, 4);
+    std::string empty;
+    {
+        protozero::pbf_writer writer(empty);
+        strings.serialize(writer, 1);
+    }
+    EXPECT_TRUE(empty.empty());
+}
@@ -0,0 +1,28 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/frame_history.hpp>
+
+using namespace mbgl;
+
+TEST(FrameHistory, Settled) {
+    const Duration duration = Milliseconds(300);
+    const TimePoint start = Clock::now();
+
+    FrameHistory history;
+    history.record(start, 10, duration);
+    EXPECT_TRUE(history.isSettled());
+
+    // Zooming in fades in the levels in between.
+    history.record(start + Milliseconds(10), 11, duration);
+    EXPECT_TRUE(history.needsAnimation(duration));
+    EXPECT_FALSE(history.isSettled());
+
+    // Zooming back out when they're half visible fades them out, faster than a full fade.
+    history.record(start + Milliseconds(160), 11, duration);
+    history.record(start + Milliseconds(160), 10, duration);
+    EXPECT_FALSE(history.isSettled());
+
+    history.record(start + Milliseconds(320), 10, duration);
+    EXPECT_TRUE(history.needsAnimation(duration));
+    EXPECT_TRUE(history.isSettled());
+}
@@ -0,0 +1,48 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/frame_timer.hpp>
+#include <mbgl/gl/context.hpp>
+
+#include <thread>
+
+using namespace mbgl;
+
+TEST(FrameTimer, SlowFrame) {
+    gl::Context context;
+    FrameTimer timer;
+
+    timer.beginFrame();
+    {
+        FrameTimer::Scope phase(timer, "upload", context);
+        phase.setCount(14, "uploaded %zu tiles");
+        context.uploadedBytes += 13 * 512 * 1024;
+    }
+    {
+        FrameTimer::Scope phase(timer, "opaque", context);
+        context.drawCalls += 3;
+        phase.addItem("water", Milliseconds(2));
+        phase.addItem("roads", Milliseconds(5));
+        phase.addItem("parks", Milliseconds(1));
+        std::this_thread::sleep_for(Milliseconds(5));
+    }
+
+    // Frames within the budget aren't reported.
+    EXPECT_FALSE(bool(timer.endFrame(Seconds(10))));
+    EXPECT_FALSE(bool(timer.endFrame(Duration::zero())));
+
+    const optional<FrameTimings> timings = timer.endFrame(Milliseconds(1));
+    ASSERT_TRUE(bool(timings));
+    EXPECT_EQ(Milliseconds(1), timings->budget);
+    EXPECT_LE(Milliseconds(5), timings->total);
+
+    ASSERT_EQ(2u, timings->phases.size());
+    EXPECT_EQ("upload", timings->phases[0].name);
+    EXPECT_EQ("uploaded 14 tiles, 6.5 MB", timings->phases[0].details);
+    EXPECT_EQ("opaque", timings->phases[1].name);
+    EXPECT_EQ("3 draw calls, slowest roads (5.0 ms)", timings->phases[1].details);
+    EXPECT_EQ("opaque", timings->slowest().name);
+
+    // Each frame starts over.
+    timer.beginFrame();
+    EXPECT_FALSE(bool(timer.endFrame(Seconds(10))));
+}
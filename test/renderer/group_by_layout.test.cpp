@@ -2,6 +2,7 @@
 
 #include <mbgl/renderer/group_by_layout.hpp>
 #include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
@@ -52,3 +53,20 @@ TEST(GroupByLayout, UnrelatedLayout) {
     auto result = groupByLayout(toRenderLayers(layers));
     ASSERT_EQ(2u, result.size());
 }
+
+TEST(GroupByLayout, LayoutKey) {
+    LineLayer layer("a", "source");
+    const auto impl = layer.baseImpl;
+
+    // The key is computed once per impl.
+    const LayoutKey& key = impl->layoutKey();
+    EXPECT_EQ(&key, &impl->layoutKey());
+
+    // Modified layers get a new impl, which doesn't inherit the key.
+    layer.setLineCap(LineCapType::Square);
+    ASSERT_NE(impl.get(), layer.baseImpl.get());
+    EXPECT_FALSE(key == layer.baseImpl->layoutKey());
+
+    layer.setLineCap({});
+    EXPECT_TRUE(key == layer.baseImpl->layoutKey());
+}
@@ -4,6 +4,7 @@
 #include <mbgl/test/stub_style_observer.hpp>
 
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/sprite/sprite_parser.hpp>
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/io.hpp>
@@ -108,11 +109,11 @@ TEST(ImageManager, RemoveReleasesBinPackRect) {
 
 class StubImageRequestor : public ImageRequestor {
 public:
-    void onImagesAvailable(ImageMap images) final {
-        if (imagesAvailable) imagesAvailable(images);
+    void onImagesAvailable(ImageMap images, ImagePositions positions) final {
+        if (imagesAvailable) imagesAvailable(images, positions);
     }
 
-    std::function<void (ImageMap)> imagesAvailable;
+    std::function<void (ImageMap, ImagePositions)> imagesAvailable;
 };
 
 TEST(ImageManager, NotifiesRequestorWhenSpriteIsLoaded) {
@@ -120,7 +121,7 @@ TEST(ImageManager, NotifiesRequestorWhenSpriteIsLoaded) {
     StubImageRequestor requestor;
     bool notified = false;
 
-    requestor.imagesAvailable = [&] (ImageMap) {
+    requestor.imagesAvailable = [&] (ImageMap, ImagePositions) {
         notified = true;
     };
 
@@ -136,7 +137,7 @@ TEST(ImageManager, NotifiesRequestorImmediatelyIfDependenciesAreSatisfied) {
     StubImageRequestor requestor;
     bool notified = false;
 
-    requestor.imagesAvailable = [&] (ImageMap) {
+    requestor.imagesAvailable = [&] (ImageMap, ImagePositions) {
         notified = true;
     };
 
@@ -145,3 +146,151 @@ TEST(ImageManager, NotifiesRequestorImmediatelyIfDependenciesAreSatisfied) {
 
     ASSERT_TRUE(notified);
 }
+
+class StubImageManagerObserver : public ImageManagerObserver {
+public:
+    void onStyleImageMissing(const std::string& id) final {
+        missing.push_back(id);
+    }
+
+    std::vector<std::string> missing;
+};
+
+TEST(ImageManager, NotifiesRequestorImmediatelyWithImagesOnDemand) {
+    ImageManager imageManager;
+    StubImageManagerObserver observer;
+    imageManager.setObserver(&observer);
+    imageManager.setImagesOnDemand(true);
+
+    StubImageRequestor requestor;
+    ImageMap images;
+    requestor.imagesAvailable = [&] (ImageMap images_, ImagePositions) {
+        images = std::move(images_);
+    };
+
+    imageManager.addImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 2));
+    imageManager.getImages(requestor, {"one", "two"});
+    ASSERT_EQ(1u, images.size());
+    EXPECT_EQ(1u, images.count("one"));
+    EXPECT_EQ(std::vector<std::string> { "two" }, observer.missing);
+
+    // Missing images are reported once, until they're added.
+    StubImageRequestor other;
+    imageManager.getImages(other, {"two"});
+    EXPECT_EQ(std::vector<std::string> { "two" }, observer.missing);
+
+    imageManager.addImage(makeMutable<style::Image::Impl>("two", PremultipliedImage({ 16, 16 }), 2));
+    imageManager.getImages(requestor, {"one", "two"});
+    EXPECT_EQ(2u, images.size());
+
+    imageManager.removeImage("two");
+    imageManager.getImages(requestor, {"two"});
+    EXPECT_EQ((std::vector<std::string> { "two", "two" }), observer.missing);
+
+    imageManager.removeRequestor(requestor);
+    imageManager.removeRequestor(other);
+}
+
+TEST(ImageManager, ReportsImagesMissingFromSprite) {
+    ImageManager imageManager;
+    StubImageManagerObserver observer;
+    imageManager.setObserver(&observer);
+
+    StubImageRequestor requestor;
+    imageManager.getImages(requestor, {"one"});
+    EXPECT_TRUE(observer.missing.empty());
+
+    // Not before the sprite has loaded, which may have the image.
+    imageManager.setLoaded(true);
+    EXPECT_EQ(std::vector<std::string> { "one" }, observer.missing);
+
+    imageManager.removeRequestor(requestor);
+}
+
+TEST(ImageManager, ImagesOnDemandNotifiesWaitingRequestors) {
+    ImageManager imageManager;
+    StubImageRequestor requestor;
+    bool notified = false;
+
+    requestor.imagesAvailable = [&] (ImageMap, ImagePositions) {
+        notified = true;
+    };
+
+    imageManager.getImages(requestor, {"one"});
+    ASSERT_FALSE(notified);
+
+    imageManager.setImagesOnDemand(true);
+    ASSERT_TRUE(notified);
+}
+
+TEST(ImageManager, SharesIconsBetweenRequestors) {
+    ImageManager imageManager;
+    StubImageRequestor a;
+    StubImageRequestor b;
+    ImagePositions positionsA;
+    ImagePositions positionsB;
+
+    a.imagesAvailable = [&] (ImageMap, ImagePositions positions) {
+        positionsA = std::move(positions);
+    };
+    b.imagesAvailable = [&] (ImageMap, ImagePositions positions) {
+        positionsB = std::move(positions);
+    };
+
+    imageManager.addImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 2));
+    imageManager.getImages(a, {"one"});
+    imageManager.getImages(b, {"one"});
+
+    ASSERT_EQ(1u, positionsA.count("one"));
+    ASSERT_EQ(1u, positionsB.count("one"));
+    EXPECT_TRUE(positionsA.at("one").textureRect == positionsB.at("one").textureRect);
+
+    // The icon keeps its space while one of the requestors remains.
+    imageManager.removeRequestor(a);
+    imageManager.addImage(makeMutable<style::Image::Impl>("two", PremultipliedImage({ 16, 16 }), 2));
+    imageManager.getImages(a, {"two"});
+    ASSERT_EQ(1u, positionsA.count("two"));
+    EXPECT_FALSE(positionsA.at("two").textureRect == positionsB.at("one").textureRect);
+
+    // Images that keep their size are updated in place.
+    const auto before = positionsB.at("one").textureRect;
+    imageManager.updateImage(makeMutable<style::Image::Impl>("one", PremultipliedImage({ 16, 16 }), 1));
+    imageManager.getImages(b, {"one"});
+    EXPECT_TRUE(before == positionsB.at("one").textureRect);
+    EXPECT_EQ(16.0f, positionsB.at("one").displaySize()[0]);
+}
+
+TEST(ImageManager, SDFIconsInAlphaAtlas) {
+    ImageManager imageManager;
+    StubImageRequestor requestor;
+    ImagePositions positions;
+
+    requestor.imagesAvailable = [&] (ImageMap, ImagePositions positions_) {
+        positions = std::move(positions_);
+    };
+
+    PremultipliedImage sdf({ 4, 4 });
+    sdf.fill(100);
+    imageManager.addImage(makeMutable<style::Image::Impl>("sdf", std::move(sdf), 1, true));
+    imageManager.addImage(makeMutable<style::Image::Impl>("rgba", PremultipliedImage({ 4, 4 }), 1));
+    imageManager.getImages(requestor, {"sdf", "rgba"});
+
+    ASSERT_EQ(1u, positions.count("sdf"));
+    ASSERT_EQ(1u, positions.count("rgba"));
+
+    // Both icons are first in the atlas of their kind.
+    EXPECT_TRUE(positions.at("sdf").textureRect == positions.at("rgba").textureRect);
+
+    const AlphaImage& atlas = imageManager.getSDFAtlasImage();
+    EXPECT_EQ(imageManager.getSDFPixelSize(), atlas.size);
+    const auto tl = positions.at("sdf").tl();
+    EXPECT_EQ(100u, atlas.data[tl[1] * atlas.size.width + tl[0]]);
+    EXPECT_EQ(0u, atlas.data[(tl[1] - 1) * atlas.size.width + tl[0]]);
+
+    // The bins are released into the atlas they came from.
+    imageManager.removeImage("sdf");
+    imageManager.removeRequestor(requestor);
+    imageManager.addImage(makeMutable<style::Image::Impl>("sdf", PremultipliedImage({ 4, 4 }), 1, true));
+    imageManager.getImages(requestor, {"sdf"});
+    EXPECT_EQ(tl, positions.at("sdf").tl());
+}
@@ -0,0 +1,63 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/layout/layout_profiler.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+RendererStatistics::LayerLayout cost(const std::string& layer, uint8_t zoom, Duration layoutTime, uint64_t features) {
+    RendererStatistics::LayerLayout result;
+    result.layer = layer;
+    result.zoom = zoom;
+    result.tiles = 1;
+    result.layoutTime = layoutTime;
+    result.features = features;
+    return result;
+}
+
+} // namespace
+
+TEST(LayoutProfiler, Totals) {
+    LayoutProfiler profiler;
+    EXPECT_FALSE(profiler.isEnabled());
+
+    profiler.setEnabled(true);
+    profiler.add(cost("roads", 14, Milliseconds(2), 10));
+    profiler.add(cost("labels", 14, Milliseconds(3), 5));
+    profiler.add(cost("roads", 14, Milliseconds(2), 20));
+    profiler.add(cost("roads", 15, Milliseconds(1), 7));
+
+    RendererStatistics::LayerLayout placement;
+    placement.layer = "labels";
+    placement.zoom = 14;
+    placement.placementTime = Milliseconds(2);
+    profiler.add(placement);
+
+    // Sorted by layout and placement time, most expensive first.
+    const auto profile = profiler.getProfile();
+    ASSERT_EQ(3u, profile.size());
+    EXPECT_EQ("labels", profile[0].layer);
+    EXPECT_EQ(1u, profile[0].tiles);
+    EXPECT_EQ(Milliseconds(3), profile[0].layoutTime);
+    EXPECT_EQ(Milliseconds(2), profile[0].placementTime);
+    EXPECT_EQ("roads", profile[1].layer);
+    EXPECT_EQ(14, profile[1].zoom);
+    EXPECT_EQ(2u, profile[1].tiles);
+    EXPECT_EQ(30u, profile[1].features);
+    EXPECT_EQ("roads", profile[2].layer);
+    EXPECT_EQ(15, profile[2].zoom);
+}
+
+TEST(LayoutProfiler, EnablingStartsOver) {
+    LayoutProfiler profiler;
+    profiler.setEnabled(true);
+    profiler.add(cost("roads", 14, Milliseconds(2), 10));
+
+    // Disabling keeps the totals around for reading them.
+    profiler.setEnabled(false);
+    EXPECT_EQ(1u, profiler.getProfile().size());
+
+    profiler.setEnabled(true);
+    EXPECT_TRUE(profiler.getProfile().empty());
+}
@@ -0,0 +1,68 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/renderer/renderer.hpp>
+#include <mbgl/renderer/threaded_renderer_frontend.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+class FrameObserver : public MapObserver {
+public:
+    void onDidFinishRenderingFrame(RenderMode mode) final {
+        threads.push_back(std::this_thread::get_id());
+        if (mode == RenderMode::Full) {
+            done();
+        }
+    }
+
+    std::function<void()> done;
+    std::vector<std::thread::id> threads;
+};
+
+} // namespace
+
+TEST(ThreadedRendererFrontend, RendersOnItsOwnThread) {
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    ThreadPool threadPool { 4 };
+    HeadlessBackend backend { { 256, 256 } };
+    FrameObserver observer;
+
+    ThreadedRendererFrontend frontend { backend, 1, fileSource, threadPool };
+    Map map(frontend, observer, { 256, 256 }, 1, fileSource, threadPool, MapMode::Continuous);
+
+    observer.done = [&] { loop.stop(); };
+    map.getStyle().loadJSON(R"STYLE({
+        "version": 8,
+        "layers": [{ "id": "background", "type": "background", "paint": { "background-color": "red" } }]
+    })STYLE");
+    loop.run();
+
+    // The observer hears about every frame on the thread of the map.
+    ASSERT_FALSE(observer.threads.empty());
+    for (const auto& id : observer.threads) {
+        EXPECT_EQ(std::this_thread::get_id(), id);
+    }
+
+    std::thread::id renderThread;
+    uint64_t frames = 0;
+    frontend.withRenderer([&] (Renderer& renderer) {
+        renderThread = std::this_thread::get_id();
+        const auto statistics = renderer.getStatistics();
+        frames = statistics.frames + statistics.skippedFrames;
+    });
+    EXPECT_NE(std::this_thread::get_id(), renderThread);
+    EXPECT_LE(observer.threads.size(), frames);
+
+    frontend.reset();
+}
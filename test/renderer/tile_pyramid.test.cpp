@@ -0,0 +1,123 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/renderer/tile_pyramid.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/text/placement_config.hpp>
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, std::vector<std::pair<OverscaledTileID, PlacementConfig>>& placements_)
+        : Tile(id_), placements(placements_) {
+        renderable = true;
+        loaded = true;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    void upload(gl::Context&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return nullptr; }
+
+    void setPlacementConfig(const PlacementConfig& config) override {
+        placements.emplace_back(id, config);
+    }
+
+    std::vector<std::pair<OverscaledTileID, PlacementConfig>>& placements;
+};
+
+class TilePyramidTest {
+public:
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    ThreadPool threadPool { 1 };
+    style::Style style { loop, fileSource, 1 };
+    AnnotationManager annotationManager { style };
+    ImageManager imageManager;
+    GlyphManager glyphManager { fileSource };
+    Transform transform;
+
+    TilePyramid pyramid;
+    std::vector<std::pair<OverscaledTileID, PlacementConfig>> placements;
+
+    TilePyramidTest() {
+        transform.resize({ 512, 512 });
+    }
+
+    // The placements the center tile received.
+    std::vector<PlacementConfig> centerPlacements() const {
+        std::vector<PlacementConfig> result;
+        for (const auto& placement : placements) {
+            if (placement.first == OverscaledTileID { 0, 0, 0 }) {
+                result.push_back(placement.second);
+            }
+        }
+        return result;
+    }
+
+    void update() {
+        const TileParameters parameters {
+            1.0,
+            MapDebugOptions(),
+            transform.getState(),
+            threadPool,
+            fileSource,
+            MapMode::Continuous,
+            annotationManager,
+            imageManager,
+            glyphManager,
+            0,
+            0,
+            {}
+        };
+        pyramid.update({}, true, false, parameters, SourceType::Vector, 512, { 0, 22 },
+                       [&](const OverscaledTileID& tileID) {
+                           return std::make_unique<StubTile>(tileID, placements);
+                       });
+    }
+};
+
+} // namespace
+
+TEST(TilePyramid, PlacesTilesAgainOnceTheCameraSettles) {
+    using namespace std::chrono_literals;
+
+    TilePyramidTest test;
+    test.update();
+    ASSERT_EQ(1u, test.centerPlacements().size());
+
+    CameraOptions camera;
+    camera.angle = 1.0;
+    AnimationOptions animation;
+    animation.duration = Duration(1s);
+    test.transform.easeTo(camera, animation);
+
+    // Complete tiles keep their placement while the camera rotates.
+    test.transform.updateTransitions(Clock::now() + 500ms);
+    ASSERT_TRUE(test.transform.getState().isChanging());
+    test.update();
+    EXPECT_EQ(1u, test.centerPlacements().size());
+
+    // The update that ends the transition places them for the final camera.
+    test.transform.updateTransitions(Clock::now() + 2s);
+    ASSERT_FALSE(test.transform.getState().isChanging());
+    test.update();
+    const std::vector<PlacementConfig> placements = test.centerPlacements();
+    ASSERT_EQ(2u, placements.size());
+    EXPECT_FLOAT_EQ(test.transform.getState().getAngle(), placements.back().angle);
+}
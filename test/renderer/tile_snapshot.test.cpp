@@ -0,0 +1,112 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/renderer/tile_snapshot.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/function/source_function.hpp>
+#include <mbgl/style/function/identity_stops.hpp>
+
+#include <protozero/pbf_writer.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+PropertyMap properties;
+
+const OverscaledTileID tileID { 3, 0, 3, 2, 1 };
+const BucketParameters parameters { tileID, MapMode::Continuous, 1.0 };
+
+std::shared_ptr<const TileSnapshot::SerializedBucket>
+layOut(const std::vector<Immutable<Layer::Impl>>& impls) {
+    auto renderLayers = RenderLayer::createForLayout(impls, tileID.overscaledZ);
+    const std::vector<const RenderLayer*> group { renderLayers.front().get() };
+    FillBucket bucket { parameters, group };
+
+    GeometryCollection polygon { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 0, 0 } } };
+    bucket.addFeature(StubGeometryTileFeature { {}, FeatureType::Polygon, polygon, properties }, polygon, 0);
+    return TileSnapshot::serialize(bucket, group);
+}
+
+} // namespace
+
+TEST(TileSnapshot, RoundTrip) {
+    FillLayer layer("fill", "source");
+    const std::vector<Immutable<Layer::Impl>> impls { layer.baseImpl };
+
+    TileSnapshot recorder;
+    recorder.setRecording(true);
+    auto serialized = layOut(impls);
+    ASSERT_TRUE(serialized);
+    recorder.record("source", tileID, { serialized });
+
+    TileSnapshot snapshot;
+    ASSERT_TRUE(snapshot.decode(recorder.encode({ { "source", tileID } })));
+    ASSERT_TRUE(snapshot.hasRestorableTiles());
+
+    // Other tiles and sources have nothing to restore.
+    EXPECT_TRUE(snapshot.restore("other", tileID, impls, parameters).empty());
+    EXPECT_TRUE(snapshot.restore("source", OverscaledTileID { 3, 0, 3, 1, 1 }, impls, parameters).empty());
+
+    auto buckets = snapshot.restore("source", tileID, impls, parameters);
+    ASSERT_EQ(1u, buckets.count("fill"));
+    auto& bucket = static_cast<FillBucket&>(*buckets.at("fill"));
+    EXPECT_TRUE(bucket.hasData());
+    EXPECT_EQ(4u, bucket.vertices.vertexSize());
+    EXPECT_EQ(1u, bucket.triangleSegments.size());
+    EXPECT_EQ(1u, bucket.lineSegments.size());
+
+    // Tiles are restored once.
+    EXPECT_FALSE(snapshot.hasRestorableTiles());
+    EXPECT_TRUE(snapshot.restore("source", tileID, impls, parameters).empty());
+}
+
+TEST(TileSnapshot, LayoutChanged) {
+    FillLayer layer("fill", "source");
+    TileSnapshot recorder;
+    recorder.setRecording(true);
+    recorder.record("source", tileID, { layOut({ layer.baseImpl }) });
+    const std::string encoded = recorder.encode({ { "source", tileID } });
+
+    // Buckets are only restored for the layers they were laid out for, with the same layout.
+    TileSnapshot snapshot;
+    FillLayer other("other", "source");
+    ASSERT_TRUE(snapshot.decode(encoded));
+    EXPECT_TRUE(snapshot.restore("source", tileID, { other.baseImpl }, parameters).empty());
+
+    layer.setSourceLayer("water");
+    ASSERT_TRUE(snapshot.decode(encoded));
+    EXPECT_TRUE(snapshot.restore("source", tileID, { layer.baseImpl }, parameters).empty());
+}
+
+TEST(TileSnapshot, DataDrivenPaint) {
+    FillLayer layer("fill", "source");
+    layer.setFillColor(SourceFunction<Color>("color", IdentityStops<Color>(), Color::black()));
+    EXPECT_FALSE(layOut({ layer.baseImpl }));
+}
+
+TEST(TileSnapshot, NotRecording) {
+    FillLayer layer("fill", "source");
+    TileSnapshot recorder;
+    recorder.record("source", tileID, { layOut({ layer.baseImpl }) });
+
+    TileSnapshot snapshot;
+    ASSERT_TRUE(snapshot.decode(recorder.encode({ { "source", tileID } })));
+    EXPECT_FALSE(snapshot.hasRestorableTiles());
+}
+
+TEST(TileSnapshot, Invalid) {
+    TileSnapshot snapshot;
+    EXPECT_FALSE(snapshot.decode(""));
+    EXPECT_FALSE(snapshot.decode("\xff\xff\xff"));
+
+    std::string otherBuild;
+    protozero::pbf_writer pbf(otherBuild);
+    pbf.add_string(1, "0000000");
+    EXPECT_FALSE(snapshot.decode(otherBuild));
+    EXPECT_FALSE(snapshot.hasRestorableTiles());
+}
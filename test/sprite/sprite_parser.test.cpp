@@ -2,7 +2,7 @@
 #include <mbgl/test/fixture_log_observer.hpp>
 
 #include <mbgl/sprite/sprite_parser.hpp>
-#include <mbgl/style/image.hpp>
+#include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
@@ -186,6 +186,19 @@ TEST(Sprite, SpriteImageCreation1_5x) {
               sprite2->getImage());
 }
 
+TEST(Sprite, SpriteImageCreationShared) {
+    const auto sheet = std::make_shared<const PremultipliedImage>(
+        decodeImage(util::read_file("test/fixtures/annotations/emerald.png")));
+
+    // "museum_icon":{"x":177,"y":187,"width":18,"height":18,"pixelRatio":1,"sdf":false}
+    const auto sprite = createStyleImage("test", sheet, 177, 187, 18, 18, 1, false);
+    ASSERT_TRUE(sprite.get());
+    EXPECT_EQ(sheet, sprite->baseImpl->sheet);
+    EXPECT_EQ(Size(18, 18), sprite->baseImpl->size);
+    EXPECT_EQ(readImage("test/fixtures/annotations/result-spriteimagecreation1x-museum.png"),
+              sprite->getImage());
+}
+
 TEST(Sprite, SpriteParsing) {
     const auto image_1x = util::read_file("test/fixtures/annotations/emerald.png");
     const auto json_1x = util::read_file("test/fixtures/annotations/emerald.json");
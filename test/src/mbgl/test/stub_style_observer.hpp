@@ -26,6 +26,10 @@ public:
         if (sourceDescriptionChanged) sourceDescriptionChanged(source);
     }
 
+    void onUpdate(Update update) override {
+        if (updated) updated(update);
+    }
+
     void onResourceError(std::exception_ptr error) override {
         if (resourceError) resourceError(error);
     };
@@ -34,5 +38,6 @@ public:
     std::function<void (Source&)> sourceChanged;
     std::function<void (Source&, std::exception_ptr)> sourceError;
     std::function<void (Source&)> sourceDescriptionChanged;
+    std::function<void (Update)> updated;
     std::function<void (std::exception_ptr)> resourceError;
 };
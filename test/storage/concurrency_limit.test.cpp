@@ -0,0 +1,83 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/concurrency_limit.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Response::Timing timing(Milliseconds firstByte, Milliseconds transfer) {
+    Response::Timing result;
+    result.firstByte = firstByte;
+    result.transfer = transfer;
+    return result;
+}
+
+} // namespace
+
+TEST(ConcurrencyLimit, Grows) {
+    ConcurrencyLimit limit(2, 20);
+    EXPECT_EQ(4u, limit.get());
+
+    // Responses to fewer requests than allowed don't raise the limit.
+    for (int i = 0; i < 100; i++) {
+        limit.completed(timing(Milliseconds(100), Milliseconds(10)), 1000, 1);
+    }
+    EXPECT_EQ(4u, limit.get());
+
+    for (int i = 0; i < 100; i++) {
+        limit.completed(timing(Milliseconds(100), Milliseconds(10)), 1000, limit.get());
+    }
+    EXPECT_EQ(20u, limit.get());
+}
+
+TEST(ConcurrencyLimit, Shrinks) {
+    ConcurrencyLimit limit(2, 20);
+    for (int i = 0; i < 100; i++) {
+        limit.completed(timing(Milliseconds(100), Milliseconds(10)), 1000, limit.get());
+    }
+    ASSERT_EQ(20u, limit.get());
+
+    // Responses that slow down tenfold mean requests are queueing up.
+    for (int i = 0; i < 20; i++) {
+        limit.completed(timing(Milliseconds(1000), Milliseconds(10)), 1000, limit.get());
+    }
+    EXPECT_LT(limit.get(), 12u);
+
+    // Connection errors halve the limit, down to the minimum.
+    const std::size_t before = limit.get();
+    limit.failed();
+    EXPECT_GE(before / 2 + 1, limit.get());
+    for (int i = 0; i < 10; i++) {
+        limit.failed();
+    }
+    EXPECT_EQ(2u, limit.get());
+
+    // Once responses are fast again, the limit recovers.
+    for (int i = 0; i < 100; i++) {
+        limit.completed(timing(Milliseconds(100), Milliseconds(10)), 1000, limit.get());
+    }
+    EXPECT_EQ(20u, limit.get());
+}
+
+TEST(ConcurrencyLimit, Throughput) {
+    ConcurrencyLimit limit(2, 20);
+    EXPECT_EQ(0.0, limit.getThroughput());
+
+    // Small responses don't tell how fast data arrives.
+    limit.completed(timing(Milliseconds(100), Milliseconds(1)), 1000, 1);
+    EXPECT_EQ(0.0, limit.getThroughput());
+
+    limit.completed(timing(Milliseconds(100), Milliseconds(1000)), 100000, 1);
+    EXPECT_DOUBLE_EQ(100000, limit.getThroughput());
+
+    // Large responses that take as long as their size implies don't read as congestion.
+    for (int i = 0; i < 200; i++) {
+        if (i % 2) {
+            limit.completed(timing(Milliseconds(100), Milliseconds(10)), 1000, limit.get());
+        } else {
+            limit.completed(timing(Milliseconds(100), Milliseconds(2000)), 200000, limit.get());
+        }
+    }
+    EXPECT_EQ(20u, limit.get());
+}
@@ -4,6 +4,9 @@
 #include <mbgl/storage/resource_transform.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace mbgl;
 
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CacheResponse)) {
@@ -525,3 +528,221 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(SetResourceTransform)) {
 
     loop.run();
 }
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(SetSynchronousResourceTransform)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    // Takes precedence over the transform actor, which doesn't translate anything.
+    Actor<ResourceTransform> transform(loop, [](Resource::Kind, const std::string&& url) -> std::string {
+        return std::move(url);
+    });
+    fs.setResourceTransform(transform.self());
+
+    std::atomic<int> transformed { 0 };
+    fs.setSynchronousResourceTransform([&](Resource::Kind kind, const std::string& url) -> std::string {
+        transformed++;
+        EXPECT_EQ(Resource::Unknown, kind);
+        return url == "localhost://test" ? "http://127.0.0.1:3000/test" : url;
+    });
+
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request({ Resource::Unknown, "localhost://test" }, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+    EXPECT_EQ(1, transformed.load());
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CoalesceIdenticalRequests)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/coalesce" };
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    std::unique_ptr<AsyncRequest> req3;
+    int responses = 0;
+
+    // Both requests are answered by a single request to the server.
+    auto callback = [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Response 1", *res.data);
+
+        if (++responses < 2) {
+            return;
+        }
+
+        req1.reset();
+        req2.reset();
+
+        // Once the response is cached, a joining request is handed the same response.
+        req3 = fs.request(resource, [&](Response res3) {
+            req3.reset();
+            EXPECT_EQ(nullptr, res3.error);
+            ASSERT_TRUE(res3.data.get());
+            EXPECT_EQ("Response 1", *res3.data);
+            loop.stop();
+        });
+    };
+
+    req1 = fs.request(resource, callback);
+    req2 = fs.request(resource, callback);
+
+    loop.run();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CoalesceAfterNotModified)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource revalidateSame { Resource::Unknown, "http://127.0.0.1:3000/revalidate-same" };
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    std::unique_ptr<AsyncRequest> req3;
+
+    req1 = fs.request(revalidateSame, [&](Response) {
+        req1.reset();
+
+        // Gets the cached copy, and then revalidates it.
+        req2 = fs.request(revalidateSame, [&](Response res2) {
+            if (!res2.notModified) {
+                return;
+            }
+
+            // Joins the revalidated request, and starts out with its data rather than the 304.
+            req3 = fs.request(revalidateSame, [&](Response res3) {
+                req2.reset();
+                req3.reset();
+
+                EXPECT_EQ(nullptr, res3.error);
+                EXPECT_FALSE(res3.notModified);
+                ASSERT_TRUE(res3.data.get());
+                EXPECT_EQ("Response", *res3.data);
+                EXPECT_TRUE(bool(res3.expires));
+                EXPECT_EQ("snowfall", *res3.etag);
+
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(ConcurrentCacheReads)) {
+    util::RunLoop loop;
+
+    mkdir("test/fixtures/default_file_source", 0755);
+    const std::string path = "test/fixtures/default_file_source/cache.db";
+    unlink(path.c_str());
+    unlink((path + "-wal").c_str());
+    unlink((path + "-shm").c_str());
+
+    DefaultFileSource fs(path, ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/concurrent", {}, Resource::Optional };
+    Response response;
+    response.data = std::make_shared<std::string>("Cached");
+    response.expires = util::now() + Seconds(100);
+    fs.put(resource, response);
+
+    std::unique_ptr<AsyncRequest> req;
+
+    // Once the write has gone through, the response is served by a read-only connection.
+    fs.listOfflineRegions([&](std::exception_ptr, optional<std::vector<OfflineRegion>>) {
+        loop.invoke([&] {
+            req = fs.request(resource, [&](Response res) {
+                req.reset();
+                EXPECT_EQ(nullptr, res.error);
+                ASSERT_TRUE(res.data.get());
+                EXPECT_EQ("Cached", *res.data);
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(ConcurrentNetworkRequest)) {
+    util::RunLoop loop;
+
+    mkdir("test/fixtures/default_file_source", 0755);
+    const std::string path = "test/fixtures/default_file_source/cache.db";
+    unlink(path.c_str());
+    unlink((path + "-wal").c_str());
+    unlink((path + "-shm").c_str());
+
+    // Lookups are only done alongside the network request by the read-only connections.
+    EXPECT_FALSE(DefaultFileSource(":memory:", ".").supportsConcurrentNetworkRequests());
+
+    DefaultFileSource fs(path, ".");
+
+    Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test" };
+    resource.concurrentNetworkRequest = true;
+
+    // The miss in the cache is reported before the response of the network.
+    std::vector<Response> responses;
+    std::unique_ptr<AsyncRequest> req;
+
+    // The read-only connections are used once the database has been opened.
+    fs.listOfflineRegions([&](std::exception_ptr, optional<std::vector<OfflineRegion>>) {
+        loop.invoke([&] {
+            EXPECT_TRUE(fs.supportsConcurrentNetworkRequests());
+            req = fs.request(resource, [&](Response res) {
+                responses.push_back(res);
+                if (responses.size() == 2) {
+                    req.reset();
+                    loop.stop();
+                }
+            });
+        });
+    });
+
+    loop.run();
+
+    ASSERT_EQ(2u, responses.size());
+    ASSERT_TRUE(responses[0].error.get());
+    EXPECT_EQ(Response::Error::Reason::NotFound, responses[0].error->reason);
+    EXPECT_EQ(nullptr, responses[1].error);
+    ASSERT_TRUE(responses[1].data.get());
+    EXPECT_EQ("Hello World!", *responses[1].data);
+}
+
+TEST(DefaultFileSource, CacheReadersWithoutDatabase) {
+    util::RunLoop loop;
+
+    // The database can't be created, so the file source falls back to one in memory, which the
+    // read-only connections can't share. Lookups then stay on the database in memory.
+    DefaultFileSource fs("test/fixtures/default_file_source/nonexistent/cache.db", ".");
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/fallback", {}, Resource::Optional };
+    Response response;
+    response.data = std::make_shared<std::string>("Cached");
+    response.expires = util::now() + Seconds(100);
+    fs.put(resource, response);
+
+    std::unique_ptr<AsyncRequest> req;
+
+    fs.listOfflineRegions([&](std::exception_ptr, optional<std::vector<OfflineRegion>>) {
+        loop.invoke([&] {
+            EXPECT_FALSE(fs.supportsConcurrentNetworkRequests());
+            req = fs.request(resource, [&](Response res) {
+                req.reset();
+                EXPECT_EQ(nullptr, res.error);
+                ASSERT_TRUE(res.data.get());
+                EXPECT_EQ("Cached", *res.data);
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+}
@@ -193,3 +193,49 @@ TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Load)) {
 
     loop.run();
 }
+
+TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Timing)) {
+    util::RunLoop loop;
+    HTTPFileSource fs;
+
+    // Falls back to HTTP/1.1 for plain HTTP servers.
+    fs.setHTTP2Multiplexing(true, 8);
+
+    std::unique_ptr<AsyncRequest> req;
+    std::vector<Response::Timing> timings;
+
+    std::function<void ()> request = [&] {
+        req = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/test" }, [&](Response res) {
+            req.reset();
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ("Hello World!", *res.data);
+
+            if (!res.timing) {
+                // Not reported by this platform's HTTP stack.
+                loop.stop();
+                return;
+            }
+
+            EXPECT_FALSE(res.timing->multiplexed);
+            EXPECT_EQ(Duration::zero(), res.timing->tls);
+            timings.push_back(*res.timing);
+
+            if (timings.size() < 2) {
+                request();
+            } else {
+                loop.stop();
+            }
+        });
+    };
+
+    request();
+    loop.run();
+
+    if (!timings.empty()) {
+        ASSERT_EQ(2u, timings.size());
+        EXPECT_FALSE(timings[0].reusedConnection);
+        EXPECT_TRUE(timings[1].reusedConnection);
+        EXPECT_EQ(Duration::zero(), timings[1].connect);
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 using namespace mbgl;
 
 static const LatLngBounds sanFrancisco =
@@ -52,3 +54,48 @@ TEST(OfflineTilePyramidRegionDefinition, TileCoverWrapped) {
     EXPECT_EQ((std::vector<CanonicalTileID>{ { 0, 0, 0 } }),
               region.tileCover(SourceType::Vector, 512, { 0, 22 }));
 }
+
+TEST(OfflineTilePyramidRegionDefinition, TileCount) {
+    OfflineTilePyramidRegionDefinition region("", sanFrancisco, 0, 14, 1.0);
+    EXPECT_EQ(region.tileCover(SourceType::Vector, 512, { 0, 22 }).size(),
+              region.tileCount(SourceType::Vector, 512, { 0, 22 }));
+    EXPECT_EQ(region.tileCover(SourceType::Raster, 256, { 2, 10 }).size(),
+              region.tileCount(SourceType::Raster, 256, { 2, 10 }));
+
+    // Counting doesn't enumerate the tiles, even of the whole world at high zoom levels.
+    OfflineTilePyramidRegionDefinition world("", LatLngBounds::world(), 20, 20, 1.0);
+    EXPECT_EQ(uint64_t(1) << 40, world.tileCount(SourceType::Vector, 512, { 0, 22 }));
+}
+
+TEST(OfflineGeometryRegionDefinition, TileCover) {
+    OfflineGeometryRegionDefinition route("", LineString<double>{ { -10, 0 }, { 10, 0 } }, 2, 2, 1.0);
+
+    EXPECT_EQ((std::vector<CanonicalTileID>{ { 2, 1, 2 }, { 2, 2, 2 } }),
+              route.tileCover(SourceType::Vector, 512, { 0, 22 }));
+    EXPECT_EQ(2u, route.tileCount(SourceType::Vector, 512, { 0, 22 }));
+    EXPECT_EQ((std::vector<CanonicalTileID>{}), route.tileCover(SourceType::Vector, 512, { 3, 22 }));
+
+    OfflineGeometryRegionDefinition area("", Polygon<double>{
+        { { -122.5744, 37.6609 }, { -122.3204, 37.6609 }, { -122.4, 37.8271 }, { -122.5744, 37.6609 } }
+    }, 0, 14, 1.0);
+    EXPECT_EQ(area.tileCover(SourceType::Vector, 512, { 0, 22 }).size(),
+              area.tileCount(SourceType::Vector, 512, { 0, 22 }));
+}
+
+TEST(OfflineGeometryRegionDefinition, EncodeDecode) {
+    const Geometry<double> geometry = LineString<double>{ { -122.5, 37.7 }, { -122.3, 37.8 } };
+    const std::string encoded = encodeOfflineRegionDefinition(
+        OfflineGeometryRegionDefinition("mapbox://style", geometry, 1, INFINITY, 2.0));
+
+    const OfflineRegionDefinition decoded = decodeOfflineRegionDefinition(encoded);
+    ASSERT_TRUE(decoded.is<OfflineGeometryRegionDefinition>());
+    const auto& region = decoded.get<OfflineGeometryRegionDefinition>();
+    EXPECT_EQ("mapbox://style", region.styleURL);
+    EXPECT_TRUE(geometry == region.geometry);
+    EXPECT_EQ(1, region.minZoom);
+    EXPECT_EQ(INFINITY, region.maxZoom);
+    EXPECT_EQ(2.0, region.pixelRatio);
+
+    EXPECT_TRUE(decodeOfflineRegionDefinition(encodeOfflineRegionDefinition(
+        OfflineTilePyramidRegionDefinition("", sanFrancisco, 0, 1, 1.0))).is<OfflineTilePyramidRegionDefinition>());
+}
@@ -4,6 +4,8 @@
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
 
@@ -258,19 +260,56 @@ TEST(OfflineDatabase, PutTileNotFound) {
     EXPECT_FALSE(res->data.get());
 }
 
+TEST(OfflineDatabase, CompressionCodecs) {
+    using namespace mbgl;
+
+    for (auto codec : { util::Codec::None, util::Codec::Zlib, util::Codec::Zstd }) {
+        if (!util::isCodecAvailable(codec)) {
+            continue;
+        }
+
+        OfflineDatabase db(":memory:");
+        db.setCompression(codec);
+
+        // Enough tiles to train a dictionary when compressing with zstd.
+        const int32_t count = 300;
+        for (int32_t x = 0; x < count; x++) {
+            Resource resource = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1, x, 0, 9, Tileset::Scheme::XYZ);
+            Response response;
+            response.data = std::make_shared<std::string>(
+                "layer water; layer roads; tile " + util::toString(x) + std::string(512, 'a' + x % 26));
+
+            auto result = db.put(resource, response);
+            EXPECT_TRUE(result.first);
+            if (codec == util::Codec::None) {
+                EXPECT_EQ(response.data->size(), result.second);
+            } else {
+                EXPECT_GT(response.data->size(), result.second);
+            }
+        }
+
+        for (int32_t x = 0; x < count; x++) {
+            auto result = db.get(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1, x, 0, 9, Tileset::Scheme::XYZ));
+            ASSERT_TRUE(result && result->data);
+            EXPECT_EQ("layer water; layer roads; tile " + util::toString(x) + std::string(512, 'a' + x % 26),
+                      *result->data);
+        }
+    }
+}
+
 TEST(OfflineDatabase, CreateRegion) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata {{ 1, 2, 3 }};
     OfflineRegion region = db.createRegion(definition, metadata);
 
-    EXPECT_EQ(definition.styleURL, region.getDefinition().styleURL);
-    EXPECT_EQ(definition.bounds, region.getDefinition().bounds);
-    EXPECT_EQ(definition.minZoom, region.getDefinition().minZoom);
-    EXPECT_EQ(definition.maxZoom, region.getDefinition().maxZoom);
-    EXPECT_EQ(definition.pixelRatio, region.getDefinition().pixelRatio);
+    EXPECT_EQ(definition.styleURL, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().styleURL);
+    EXPECT_EQ(definition.bounds, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().bounds);
+    EXPECT_EQ(definition.minZoom, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().minZoom);
+    EXPECT_EQ(definition.maxZoom, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().maxZoom);
+    EXPECT_EQ(definition.pixelRatio, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().pixelRatio);
     EXPECT_EQ(metadata, region.getMetadata());
 }
 
@@ -278,7 +317,7 @@ TEST(OfflineDatabase, UpdateMetadata) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata {{ 1, 2, 3 }};
     OfflineRegion region = db.createRegion(definition, metadata);
 
@@ -291,7 +330,7 @@ TEST(OfflineDatabase, ListRegions) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata {{ 1, 2, 3 }};
 
     OfflineRegion region = db.createRegion(definition, metadata);
@@ -299,11 +338,11 @@ TEST(OfflineDatabase, ListRegions) {
 
     ASSERT_EQ(1u, regions.size());
     EXPECT_EQ(region.getID(), regions.at(0).getID());
-    EXPECT_EQ(definition.styleURL, regions.at(0).getDefinition().styleURL);
-    EXPECT_EQ(definition.bounds, regions.at(0).getDefinition().bounds);
-    EXPECT_EQ(definition.minZoom, regions.at(0).getDefinition().minZoom);
-    EXPECT_EQ(definition.maxZoom, regions.at(0).getDefinition().maxZoom);
-    EXPECT_EQ(definition.pixelRatio, regions.at(0).getDefinition().pixelRatio);
+    EXPECT_EQ(definition.styleURL, regions.at(0).getDefinition().get<OfflineTilePyramidRegionDefinition>().styleURL);
+    EXPECT_EQ(definition.bounds, regions.at(0).getDefinition().get<OfflineTilePyramidRegionDefinition>().bounds);
+    EXPECT_EQ(definition.minZoom, regions.at(0).getDefinition().get<OfflineTilePyramidRegionDefinition>().minZoom);
+    EXPECT_EQ(definition.maxZoom, regions.at(0).getDefinition().get<OfflineTilePyramidRegionDefinition>().maxZoom);
+    EXPECT_EQ(definition.pixelRatio, regions.at(0).getDefinition().get<OfflineTilePyramidRegionDefinition>().pixelRatio);
     EXPECT_EQ(metadata, regions.at(0).getMetadata());
 }
 
@@ -311,11 +350,11 @@ TEST(OfflineDatabase, GetRegionDefinition) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata {{ 1, 2, 3 }};
 
     OfflineRegion region = db.createRegion(definition, metadata);
-    OfflineRegionDefinition result = db.getRegionDefinition(region.getID());
+    OfflineTilePyramidRegionDefinition result = db.getRegionDefinition(region.getID()).get<OfflineTilePyramidRegionDefinition>();
 
     EXPECT_EQ(definition.styleURL, result.styleURL);
     EXPECT_EQ(definition.bounds, result.bounds);
@@ -328,7 +367,7 @@ TEST(OfflineDatabase, DeleteRegion) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata {{ 1, 2, 3 }};
     OfflineRegion region = db.createRegion(definition, metadata);
 
@@ -343,16 +382,42 @@ TEST(OfflineDatabase, DeleteRegion) {
     ASSERT_EQ(0u, db.listRegions().size());
 }
 
+TEST(OfflineDatabase, DeleteRegionSharingTiles) {
+    using namespace mbgl;
+
+    // Without room for ambient caching, deleting a region evicts what no other region requires.
+    OfflineDatabase db(":memory:", 0);
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion first = db.createRegion(definition, OfflineRegionMetadata());
+    OfflineRegion second = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    const Resource shared = Resource::tile("http://example.com/", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    const Resource own = Resource::tile("http://example.com/", 1.0, 1, 0, 1, Tileset::Scheme::XYZ);
+    db.putRegionResource(first.getID(), shared, response);
+    db.putRegionResource(first.getID(), own, response);
+    ASSERT_TRUE(bool(db.getRegionResource(second.getID(), shared)));
+
+    db.deleteRegion(std::move(first));
+    EXPECT_TRUE(bool(db.get(shared)));
+    EXPECT_FALSE(bool(db.get(own)));
+
+    db.deleteRegion(std::move(second));
+    EXPECT_FALSE(bool(db.get(shared)));
+}
+
 TEST(OfflineDatabase, CreateRegionInfiniteMaxZoom) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
     OfflineRegionMetadata metadata;
     OfflineRegion region = db.createRegion(definition, metadata);
 
-    EXPECT_EQ(0, region.getDefinition().minZoom);
-    EXPECT_EQ(INFINITY, region.getDefinition().maxZoom);
+    EXPECT_EQ(0, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().minZoom);
+    EXPECT_EQ(INFINITY, region.getDefinition().get<OfflineTilePyramidRegionDefinition>().maxZoom);
 }
 
 TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
@@ -432,11 +497,85 @@ TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
 }
 
+TEST(OfflineDatabase, EvictsIncrementallyBetweenWatermarks) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 1024);
+    db.setEvictionWatermarks(0.1, 0.05);
+
+    Response response;
+    response.data = randomString(1024);
+
+    for (uint32_t i = 1; i <= 60; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+
+    // Over the high watermark, but puts never needed to evict on their own.
+    EXPECT_TRUE(db.isEvictionPending());
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+
+    unsigned chunks = 0;
+    while (db.evictIncrementally()) {
+        chunks++;
+    }
+
+    EXPECT_LT(0u, chunks);
+    EXPECT_FALSE(db.isEvictionPending());
+    EXPECT_FALSE(db.evictIncrementally());
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+}
+
+TEST(OfflineDatabase, EvictionDoesNotRunBelowHighWatermark) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+
+    Response response;
+    response.data = randomString(1024);
+    db.put(Resource::style("http://example.com/"), response);
+
+    EXPECT_FALSE(db.isEvictionPending());
+    EXPECT_FALSE(db.evictIncrementally());
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/"))));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(AccessTimesAreWrittenInBatches)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+
+    Resource resource = Resource::style("http://example.com/");
+    Response response;
+    response.noContent = true;
+    db.put(resource, response);
+
+    auto accessed = [] {
+        mapbox::sqlite::Database reader("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = reader.prepare("SELECT accessed FROM resources");
+        stmt.run();
+        return stmt.get<int64_t>(0);
+    };
+
+    {
+        mapbox::sqlite::Database writer("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadWrite);
+        writer.exec("UPDATE resources SET accessed = 0");
+    }
+
+    EXPECT_TRUE(bool(db.get(resource)));
+    EXPECT_EQ(0, accessed());
+
+    db.flush();
+    EXPECT_LT(0, accessed());
+}
+
 TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:", 1024 * 100);
-    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
     OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
 
     Response response;
@@ -450,6 +589,66 @@ TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/20"))));
 }
 
+TEST(OfflineDatabase, PutRegionResources) {
+    using namespace mbgl;
+
+    for (auto codec : { util::Codec::None, util::Codec::Zlib, util::Codec::Zstd }) {
+        if (!util::isCodecAvailable(codec)) {
+            continue;
+        }
+
+        OfflineDatabase db(":memory:");
+        db.setCompression(codec);
+        OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+        OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+        ThreadPool threadPool(2);
+
+        // Enough tiles to train a dictionary when compressing with zstd.
+        std::vector<std::pair<Resource, Response>> resources;
+        for (int32_t x = 0; x < 300; x++) {
+            Response response;
+            response.data = std::make_shared<std::string>(
+                "layer water; layer roads; tile " + util::toString(x) + std::string(512, 'a' + x % 26));
+            resources.emplace_back(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1, x, 0, 9, Tileset::Scheme::XYZ),
+                                   std::move(response));
+        }
+
+        const uint64_t size = db.putRegionResources(region.getID(), resources, threadPool);
+
+        OfflineRegionStatus status = db.getRegionCompletedStatus(region.getID());
+        EXPECT_EQ(300u, status.completedTileCount);
+        EXPECT_EQ(size, status.completedTileSize);
+
+        for (const auto& resource : resources) {
+            auto result = db.getRegionResource(region.getID(), resource.first);
+            ASSERT_TRUE(result && result->first.data);
+            EXPECT_EQ(*resource.second.data, *result->first.data);
+        }
+    }
+}
+
+TEST(OfflineDatabase, PutRegionResourcesRespectsMapboxTileCountLimit) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    db.setOfflineMapboxTileCountLimit(1);
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+    ThreadPool threadPool(1);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    std::vector<std::pair<Resource, Response>> resources {
+        { Resource::tile("mapbox://tiles/1", 1.0, 0, 0, 0, Tileset::Scheme::XYZ), response },
+        { Resource::tile("mapbox://tiles/1", 1.0, 0, 0, 1, Tileset::Scheme::XYZ), response },
+    };
+
+    // Nothing is stored.
+    EXPECT_THROW(db.putRegionResources(region.getID(), resources, threadPool), std::runtime_error);
+    EXPECT_EQ(0u, db.getOfflineMapboxTileCount());
+    EXPECT_FALSE(bool(db.get(resources[0].first)));
+}
+
 TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     using namespace mbgl;
 
@@ -466,7 +665,7 @@ TEST(OfflineDatabase, GetRegionCompletedStatus) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata;
     OfflineRegion region = db.createRegion(definition, metadata);
 
@@ -500,7 +699,7 @@ TEST(OfflineDatabase, HasRegionResource) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:", 1024 * 100);
-    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
     OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
 
     EXPECT_FALSE(bool(db.hasRegionResource(region.getID(), Resource::style("http://example.com/1"))));
@@ -522,7 +721,7 @@ TEST(OfflineDatabase, HasRegionResourceTile) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:", 1024 * 100);
-    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
     OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
 
     Resource resource { Resource::Tile, "http://example.com/" };
@@ -553,7 +752,7 @@ TEST(OfflineDatabase, OfflineMapboxTileCount) {
     using namespace mbgl;
 
     OfflineDatabase db(":memory:");
-    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
     OfflineRegionMetadata metadata;
 
     OfflineRegion region1 = db.createRegion(definition, metadata);
@@ -606,6 +805,155 @@ TEST(OfflineDatabase, OfflineMapboxTileCount) {
     EXPECT_EQ(0u, db.getOfflineMapboxTileCount());
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ExportImportRegion)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/region.archive");
+
+    OfflineDatabase source(":memory:");
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0 };
+    OfflineRegionMetadata metadata {{ 1, 2, 3 }};
+    OfflineRegion region = source.createRegion(definition, metadata);
+
+    Resource style = Resource::style("http://example.com/style");
+    Resource tile = Resource::tile("mapbox://tiles/1", 1.0, 1, 2, 3, Tileset::Scheme::XYZ);
+    Resource empty = Resource::tile("mapbox://tiles/1", 1.0, 0, 0, 3, Tileset::Scheme::XYZ);
+
+    Response response;
+    response.data = std::make_shared<std::string>(std::string(1024, 'x'));
+    response.etag = "etag"s;
+    response.expires = Timestamp(Seconds(1000));
+    source.putRegionResource(region.getID(), style, response);
+    response.data = randomString(1024);
+    source.putRegionResource(region.getID(), tile, response);
+    Response noContent;
+    noContent.noContent = true;
+    source.putRegionResource(region.getID(), empty, noContent);
+
+    // Resources of other regions aren't exported.
+    OfflineRegion other = source.createRegion(definition, metadata);
+    source.putRegionResource(other.getID(), Resource::style("http://example.com/other"), response);
+
+    source.exportRegion(region.getID(), "test/fixtures/offline_database/region.archive");
+
+    OfflineDatabase target(":memory:");
+    OfflineRegion imported = target.importRegion("test/fixtures/offline_database/region.archive");
+    EXPECT_EQ(definition.styleURL, imported.getDefinition().get<OfflineTilePyramidRegionDefinition>().styleURL);
+    EXPECT_EQ(metadata, imported.getMetadata());
+    EXPECT_EQ(1u, target.listRegions().size());
+
+    auto importedStyle = target.get(style);
+    ASSERT_TRUE(importedStyle && importedStyle->data);
+    EXPECT_EQ(std::string(1024, 'x'), *importedStyle->data);
+    EXPECT_EQ("etag"s, importedStyle->etag);
+    EXPECT_EQ(Timestamp(Seconds(1000)), importedStyle->expires);
+    EXPECT_EQ(*response.data, *target.get(tile)->data);
+    EXPECT_TRUE(target.get(empty)->noContent);
+    EXPECT_FALSE(bool(target.get(Resource::style("http://example.com/other"))));
+
+    OfflineRegionStatus status = target.getRegionCompletedStatus(imported.getID());
+    EXPECT_EQ(3u, status.completedResourceCount);
+    EXPECT_EQ(2u, status.completedTileCount);
+    EXPECT_EQ(2u, target.getOfflineMapboxTileCount());
+
+    // Imports that would exceed the tile limit leave nothing behind.
+    OfflineDatabase limited(":memory:");
+    limited.setOfflineMapboxTileCountLimit(1);
+    EXPECT_THROW(limited.importRegion("test/fixtures/offline_database/region.archive"), std::runtime_error);
+    EXPECT_EQ(0u, limited.listRegions().size());
+    EXPECT_EQ(0u, limited.getOfflineMapboxTileCount());
+    EXPECT_FALSE(bool(limited.get(style)));
+
+    // Truncated archives are rejected.
+    const std::string archive = util::read_file("test/fixtures/offline_database/region.archive");
+    writeFile("test/fixtures/offline_database/region.archive", archive.substr(0, archive.size() - 4));
+    EXPECT_THROW(target.importRegion("test/fixtures/offline_database/region.archive"), std::runtime_error);
+    EXPECT_EQ(1u, target.listRegions().size());
+}
+
+TEST(OfflineDatabase, RegionSyncTime) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    EXPECT_FALSE(bool(db.getRegionSyncTime(region.getID(), "http://example.com/{z}-{x}-{y}")));
+    db.setRegionSyncTime(region.getID(), "http://example.com/{z}-{x}-{y}", Timestamp(Seconds(1000)));
+    db.setRegionSyncTime(region.getID(), "http://example.com/{z}-{x}-{y}", Timestamp(Seconds(2000)));
+    EXPECT_EQ(Timestamp(Seconds(2000)), db.getRegionSyncTime(region.getID(), "http://example.com/{z}-{x}-{y}"));
+    EXPECT_FALSE(bool(db.getRegionSyncTime(region.getID(), "http://example.com/other/{z}-{x}-{y}")));
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    response.expires = Timestamp(Seconds(1000));
+    db.putRegionResource(region.getID(), Resource::tile("http://example.com/{z}-{x}-{y}", 1.0, 0, 0, 0, Tileset::Scheme::XYZ), response);
+    db.putRegionResource(region.getID(), Resource::tile("http://example.com/{z}-{x}-{y}", 1.0, 0, 0, 1, Tileset::Scheme::XYZ), response);
+    db.put(Resource::tile("http://example.com/{z}-{x}-{y}", 1.0, 1, 0, 1, Tileset::Scheme::XYZ), response);
+
+    // Only the region's tiles are revalidated.
+    EXPECT_EQ(2u, db.revalidateRegionTiles(region.getID(), "http://example.com/{z}-{x}-{y}", Timestamp(Seconds(3000))));
+    EXPECT_EQ(Timestamp(Seconds(3000)), db.get(Resource::tile("http://example.com/{z}-{x}-{y}", 1.0, 0, 0, 1, Tileset::Scheme::XYZ))->expires);
+    EXPECT_EQ(Timestamp(Seconds(1000)), db.get(Resource::tile("http://example.com/{z}-{x}-{y}", 1.0, 1, 0, 1, Tileset::Scheme::XYZ))->expires);
+
+    // Sync times are deleted with their region.
+    db.deleteRegion(std::move(region));
+    OfflineRegion other = db.createRegion(definition, OfflineRegionMetadata());
+    EXPECT_FALSE(bool(db.getRegionSyncTime(other.getID(), "http://example.com/{z}-{x}-{y}")));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(TileDeduplication)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    auto tile = [](int32_t x) {
+        return Resource::tile("http://example.com/", 1.0, x, 0, 1, Tileset::Scheme::XYZ);
+    };
+    auto response = [](const std::string& data) {
+        Response result;
+        result.data = std::make_shared<std::string>(data);
+        return result;
+    };
+    auto blobCount = [] {
+        mapbox::sqlite::Database reader("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = reader.prepare("SELECT COUNT(*) FROM tile_blobs");
+        stmt.run();
+        return stmt.get<int>(0);
+    };
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    db.put(tile(0), response("stored before"));
+    db.setTileDeduplication(true);
+
+    db.put(tile(1), response("ocean"));
+    db.put(tile(0), response("ocean"));
+    db.put(tile(2), response("land"));
+    EXPECT_EQ(2, blobCount());
+    EXPECT_EQ("ocean", *db.get(tile(0))->data);
+    EXPECT_EQ("ocean", *db.get(tile(1))->data);
+    EXPECT_EQ("land", *db.get(tile(2))->data);
+
+    // Blobs go with the last tile sharing them.
+    Response noContent;
+    noContent.noContent = true;
+    db.put(tile(0), noContent);
+    EXPECT_EQ(2, blobCount());
+    db.put(tile(1), response("land"));
+    EXPECT_EQ(1, blobCount());
+    EXPECT_TRUE(db.get(tile(0))->noContent);
+    EXPECT_EQ("land", *db.get(tile(1))->data);
+
+    // Tiles stored without deduplication keep their own data.
+    db.setTileDeduplication(false);
+    db.put(tile(2), response("coast"));
+    EXPECT_EQ(1, blobCount());
+    EXPECT_EQ("coast", *db.get(tile(2))->data);
+    EXPECT_EQ("land", *db.get(tile(1))->data);
+}
+
 static int databasePageCount(const std::string& path) {
     mapbox::sqlite::Database db(path, mapbox::sqlite::ReadOnly);
     mapbox::sqlite::Statement stmt = db.prepare("pragma page_count");
@@ -634,6 +982,84 @@ static int databaseSyncMode(const std::string& path) {
     return stmt.get<int>(0);
 }
 
+TEST(OfflineDatabase, BatchedWrites) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    std::vector<std::size_t> batches;
+    db.setBatchObserver([&] (std::size_t writes, Duration) {
+        batches.push_back(writes);
+    });
+    db.setWriteBatching(Duration::max(), 4);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    for (uint32_t i = 1; i <= 6; i++) {
+        db.putRegionResource(region.getID(), Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+
+    // Pending writes are visible to the writing connection.
+    EXPECT_TRUE(db.hasPendingWrites());
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/6"))));
+    EXPECT_EQ(6u, db.getRegionCompletedStatus(region.getID()).completedResourceCount);
+    EXPECT_EQ(std::vector<std::size_t>({ 4u }), batches);
+
+    db.flush();
+    EXPECT_FALSE(db.hasPendingWrites());
+    EXPECT_EQ(std::vector<std::size_t>({ 4u, 2u }), batches);
+
+    db.flush();
+    EXPECT_EQ(2u, batches.size());
+}
+
+TEST(OfflineDatabase, BatchedWritesFlushInterval) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    db.setWriteBatching(Duration::zero(), 100);
+
+    Response response;
+    response.noContent = true;
+
+    // An elapsed interval commits on the next write, regardless of the batch size.
+    db.put(Resource::style("http://example.com/"), response);
+    EXPECT_FALSE(db.hasPendingWrites());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(BatchedWritesCommitOnFlush)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    {
+        OfflineDatabase writer("test/fixtures/offline_database/offline.db");
+        writer.setWriteBatching(Duration::max(), 100);
+        writer.put(resource, response);
+        EXPECT_TRUE(writer.hasPendingWrites());
+
+        // Uncommitted, and holding the write lock.
+        mapbox::sqlite::Database reader("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = reader.prepare("SELECT COUNT(*) FROM resources");
+        ASSERT_TRUE(stmt.run());
+        EXPECT_EQ(0, stmt.get<int>(0));
+    }
+
+    // Pending writes are committed on destruction.
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    auto result = db.get(resource);
+    ASSERT_TRUE(bool(result));
+    EXPECT_EQ("data", *result->data);
+}
+
 TEST(OfflineDatabase, MigrateFromV2Schema) {
     using namespace mbgl;
 
@@ -650,7 +1076,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(9, databaseUserVersion("test/fixtures/offline_database/v5.db"));
     EXPECT_LT(databasePageCount("test/fixtures/offline_database/v5.db"),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 }
@@ -671,7 +1097,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(9, databaseUserVersion("test/fixtures/offline_database/v5.db"));
 }
 
 TEST(OfflineDatabase, MigrateFromV4Schema) {
@@ -690,7 +1116,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(9, databaseUserVersion("test/fixtures/offline_database/v5.db"));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/v5.db"));
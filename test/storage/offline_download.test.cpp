@@ -43,7 +43,7 @@ public:
     std::size_t size = 0;
 
     OfflineRegion createRegion() {
-        OfflineRegionDefinition definition { "", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 1.0 };
+        OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 1.0 };
         OfflineRegionMetadata metadata;
         return db.createRegion(definition, metadata);
     }
@@ -270,6 +270,62 @@ TEST(OfflineDownload, DoesNotFloodTheFileSourceWithRequests) {
     EXPECT_EQ(HTTPFileSource::maximumConcurrentRequests(), fileSource.requests.size());
 }
 
+TEST(OfflineDownload, LimitsConcurrentRequests) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, fileSource);
+
+    download.setMaximumConcurrentRequests(4, 100);
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    fileSource.respond(Resource::Kind::Style, test.response("style.json"));
+    test.loop.runOnce();
+
+    EXPECT_EQ(4u, fileSource.requests.size());
+
+    // All resources of this style are on the same host.
+    download.setMaximumConcurrentRequests(100, 2);
+    fileSource.respond(Resource::Kind::SpriteJSON, test.response("sprite.json"));
+    fileSource.respond(Resource::Kind::SpriteImage, test.response("sprite.png"));
+    test.loop.runOnce();
+
+    EXPECT_EQ(2u, fileSource.requests.size());
+}
+
+TEST(OfflineDownload, ReportsThroughput) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, fileSource);
+
+    OfflineRegionStatus lastStatus;
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        lastStatus = status;
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    fileSource.respond(Resource::Kind::Style, test.response("style.json"));
+    test.loop.runOnce();
+
+    EXPECT_EQ(0, lastStatus.tilesPerSecond);
+    EXPECT_LT(0, lastStatus.bytesPerSecond);
+
+    download.setState(OfflineRegionDownloadState::Inactive);
+    EXPECT_EQ(0, lastStatus.bytesPerSecond);
+}
+
 TEST(OfflineDownload, GetStatusNoResources) {
     OfflineTest test;
     OfflineRegion region = test.createRegion();
@@ -593,6 +649,70 @@ TEST(OfflineDownload, ReactivatePreviouslyCompletedDownload) {
     EXPECT_EQ(2u, statusesAfterReactivate[2].completedResourceCount);
 }
 
+TEST(OfflineDownload, RefreshWithManifest) {
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0),
+        test.db, test.fileSource);
+
+    const std::string urlTemplate = "http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf";
+    Response stale = test.response("0-0-0.vector.pbf");
+    stale.expires = Timestamp(Seconds(1000));
+    const std::vector<CanonicalTileID> tiles {{ 0, 0, 0 }, { 1, 0, 0 }, { 1, 0, 1 }, { 1, 1, 0 }, { 1, 1, 1 }};
+    for (const auto& tile : tiles) {
+        test.db.putRegionResource(region.getID(),
+            Resource::tile(urlTemplate, 1, tile.x, tile.y, tile.z, Tileset::Scheme::XYZ), stale);
+    }
+    test.db.setRegionSyncTime(region.getID(), urlTemplate, Timestamp(Seconds(2000)));
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("manifest_source.style.json");
+    };
+
+    const Timestamp expires = util::now() + Seconds(3600);
+    test.fileSource.sourceResponse = [&] (const Resource& resource) {
+        EXPECT_EQ("http://127.0.0.1:3000/manifest.json?since=2000", resource.url);
+        Response result;
+        result.data = std::make_shared<std::string>(R"({ "tiles": [[1, 1, 0], [20, 0, 0]] })");
+        result.expires = expires;
+        return result;
+    };
+
+    std::vector<std::string> tileRequests;
+    test.fileSource.tileResponse = [&] (const Resource& resource) {
+        tileRequests.push_back(resource.url);
+        return test.response("0-0-0.vector.pbf");
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.downloadState == OfflineRegionDownloadState::Inactive) {
+            EXPECT_EQ(6u, status.completedResourceCount);
+            EXPECT_EQ(5u, status.completedTileCount);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.refresh();
+
+    test.loop.run();
+
+    // Only the changed tile is downloaded again; the others are revalidated in bulk.
+    ASSERT_EQ(1u, tileRequests.size());
+    EXPECT_EQ("http://127.0.0.1:3000/1-1-0.vector.pbf", tileRequests[0]);
+    auto unchanged = test.db.get(Resource::tile(urlTemplate, 1, 0, 0, 0, Tileset::Scheme::XYZ));
+    ASSERT_TRUE(unchanged);
+    EXPECT_EQ(std::chrono::time_point_cast<Seconds>(expires), unchanged->expires);
+
+    // The region is synced as of the refresh.
+    auto synced = test.db.getRegionSyncTime(region.getID(), urlTemplate);
+    ASSERT_TRUE(synced);
+    EXPECT_LT(Timestamp(Seconds(2000)), *synced);
+}
+
 TEST(OfflineDownload, Deactivate) {
     OfflineTest test;
     OfflineRegion region = test.createRegion();
@@ -5,9 +5,12 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/timer.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/tile/tile_id.hpp>
 
 #include <gtest/gtest.h>
 
+#include <map>
+
 using namespace mbgl;
 
 TEST(OnlineFileSource, Cancel) {
@@ -405,6 +408,37 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RateLimitDefault)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(BatchedTiles)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    std::map<std::string, std::string> received;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    for (const auto& tile : std::vector<CanonicalTileID> { { 1, 0, 0 }, { 1, 1, 0 }, { 0, 0, 0 } }) {
+        Resource resource = Resource::tile("http://127.0.0.1:3000/batch-tile/{z}/{x}/{y}", 1.0,
+                                           tile.x, tile.y, tile.z, Tileset::Scheme::XYZ);
+        resource.batchURL = std::string("http://127.0.0.1:3000/batch?tiles={tiles}");
+        const std::string key = resource.url;
+        requests.push_back(fs.request(resource, [&, key](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            received.emplace(key, *res.data);
+            if (received.size() == 3) {
+                loop.stop();
+            }
+        }));
+    }
+
+    loop.run();
+
+    // The tile the batch doesn't have is requested on its own.
+    EXPECT_EQ((std::map<std::string, std::string> {
+        { "http://127.0.0.1:3000/batch-tile/1/0/0", "Tile 1/0/0" },
+        { "http://127.0.0.1:3000/batch-tile/1/1/0", "Tile 1/1/0" },
+        { "http://127.0.0.1:3000/batch-tile/0/0/0", "Single tile 0/0/0" },
+    }), received);
+}
+
 TEST(OnlineFileSource, ChangeAPIBaseURL){
     util::RunLoop loop;
     OnlineFileSource fs;
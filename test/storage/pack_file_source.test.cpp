@@ -0,0 +1,139 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/pack_file_source.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <gtest/gtest.h>
+#include <sqlite3.hpp>
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace mbgl;
+
+namespace {
+
+std::string fixturePath(const std::string& fileName) {
+    char buff[PATH_MAX + 1];
+    char* cwd = getcwd(buff, PATH_MAX + 1);
+    mkdir("test/fixtures/pack_file_source", 0755);
+    unlink(("test/fixtures/pack_file_source/" + fileName).c_str());
+    return std::string(cwd) + "/test/fixtures/pack_file_source/" + fileName;
+}
+
+template <class T>
+void append(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Writes a pack holding tiles 0/0/0 and 1/1/0, laid out as documented in pack_file_source.hpp.
+void writePack(const std::string& path) {
+    const std::string metadata = R"({"minzoom":0,"maxzoom":1,"tiles":["ignored"]})";
+    const std::string tile0 = "tile 0/0/0";
+    const std::string tile1 = "tile 1/1/0";
+
+    const uint64_t dataOffset = 32 + 2 * 24;
+
+    std::string pack = "MBGLPACK";
+    append<uint32_t>(pack, 1);
+    append<uint32_t>(pack, 2);
+    append<uint64_t>(pack, dataOffset + tile0.size() + tile1.size());
+    append<uint64_t>(pack, metadata.size());
+
+    for (const auto& entry : { std::make_tuple(0u, 0u, 0u, tile0, dataOffset),
+                               std::make_tuple(1u, 1u, 0u, tile1, dataOffset + tile0.size()) }) {
+        append<uint32_t>(pack, std::get<0>(entry));
+        append<uint32_t>(pack, std::get<1>(entry));
+        append<uint32_t>(pack, std::get<2>(entry));
+        append<uint32_t>(pack, std::get<3>(entry).size());
+        append<uint64_t>(pack, std::get<4>(entry));
+    }
+
+    pack += tile0 + tile1 + metadata;
+    std::ofstream(path, std::ios::binary) << pack;
+}
+
+Response requestSync(util::RunLoop& loop, PackFileSource& fs, const std::string& url) {
+    Response result;
+    std::unique_ptr<AsyncRequest> req = fs.request({ Resource::Unknown, url }, [&](Response res) {
+        req.reset();
+        result = res;
+        loop.stop();
+    });
+    loop.run();
+    return result;
+}
+
+} // namespace
+
+TEST(PackFileSource, AcceptsURL) {
+    EXPECT_TRUE(PackFileSource::acceptsURL("pack:///data/region.pack"));
+    EXPECT_FALSE(PackFileSource::acceptsURL("file:///data/region.pack"));
+    EXPECT_FALSE(PackFileSource::acceptsURL("http://example.com/region.pack"));
+}
+
+TEST(PackFileSource, TEST_REQUIRES_WRITE(Pack)) {
+    const std::string path = fixturePath("tiles.pack");
+    writePack(path);
+
+    util::RunLoop loop;
+    PackFileSource fs;
+
+    Response tileJSON = requestSync(loop, fs, "pack://" + path);
+    EXPECT_EQ(nullptr, tileJSON.error);
+    ASSERT_TRUE(tileJSON.data.get());
+    EXPECT_EQ(R"({"minzoom":0,"maxzoom":1,"tiles":["pack://)" + path + R"(?z={z}&x={x}&y={y}"]})", *tileJSON.data);
+
+    Response tile = requestSync(loop, fs, "pack://" + path + "?z=1&x=1&y=0");
+    EXPECT_EQ(nullptr, tile.error);
+    ASSERT_TRUE(tile.data.get());
+    EXPECT_EQ("tile 1/1/0", *tile.data);
+
+    Response missing = requestSync(loop, fs, "pack://" + path + "?z=1&x=0&y=0");
+    EXPECT_EQ(nullptr, missing.error);
+    EXPECT_TRUE(missing.noContent);
+}
+
+TEST(PackFileSource, TEST_REQUIRES_WRITE(MBTiles)) {
+    const std::string path = fixturePath("tiles.mbtiles");
+
+    {
+        mapbox::sqlite::Database db(path, mapbox::sqlite::ReadWrite | mapbox::sqlite::Create);
+        db.exec("CREATE TABLE metadata (name TEXT, value TEXT)");
+        db.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)");
+        db.exec("INSERT INTO metadata VALUES ('minzoom', '0'), ('maxzoom', '2'), ('bounds', '-180,-85,180,85')");
+
+        // Stored in TMS order, so row 2 at z2 is row 1 counting from the north.
+        mapbox::sqlite::Statement stmt = db.prepare("INSERT INTO tiles VALUES (2, 3, 2, ?1)");
+        const std::string data = "tile 2/3/1";
+        stmt.bindBlob(1, data.data(), data.size());
+        stmt.run();
+    }
+
+    util::RunLoop loop;
+    PackFileSource fs;
+
+    Response tileJSON = requestSync(loop, fs, "pack://" + path);
+    EXPECT_EQ(nullptr, tileJSON.error);
+    ASSERT_TRUE(tileJSON.data.get());
+    EXPECT_NE(std::string::npos, tileJSON.data->find(R"("maxzoom":2)"));
+    EXPECT_NE(std::string::npos, tileJSON.data->find(R"("bounds":[-180.0,-85.0,180.0,85.0])"));
+
+    Response tile = requestSync(loop, fs, "pack://" + path + "?z=2&x=3&y=1");
+    EXPECT_EQ(nullptr, tile.error);
+    ASSERT_TRUE(tile.data.get());
+    EXPECT_EQ("tile 2/3/1", *tile.data);
+}
+
+TEST(PackFileSource, NonExistentFile) {
+    util::RunLoop loop;
+    PackFileSource fs;
+
+    Response response = requestSync(loop, fs, "pack:///does/not/exist.pack");
+    ASSERT_NE(nullptr, response.error);
+    EXPECT_EQ(Response::Error::Reason::NotFound, response.error->reason);
+}
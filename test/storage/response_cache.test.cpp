@@ -0,0 +1,89 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/response_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Response response(std::size_t bytes) {
+    Response result;
+    result.data = std::make_shared<std::string>(bytes, '\0');
+    return result;
+}
+
+} // namespace
+
+TEST(ResponseCache, Disabled) {
+    ResponseCache cache;
+    const Resource style = Resource::style("http://example.com/style.json");
+
+    cache.add(style, response(10));
+    EXPECT_FALSE(cache.get(style));
+    EXPECT_EQ(0u, cache.getStats().size);
+}
+
+TEST(ResponseCache, Get) {
+    ResponseCache cache;
+    cache.setMaximumSize(1024 * 1024);
+
+    const Resource style = Resource::style("http://example.com/style.json");
+    cache.add(style, response(10));
+    ASSERT_TRUE(cache.get(style));
+    EXPECT_EQ(10u, cache.get(style)->data->size());
+
+    // Resources of other kinds or URLs don't match.
+    EXPECT_FALSE(cache.get(Resource::source("http://example.com/style.json")));
+    EXPECT_FALSE(cache.get(Resource::style("http://example.com/other.json")));
+
+    // Errors and revalidations aren't cached; newer responses replace older ones.
+    const Resource source = Resource::source("http://example.com/source.json");
+    Response error;
+    error.error = std::make_unique<Response::Error>(Response::Error::Reason::Server, "");
+    cache.add(source, error);
+    Response notModified;
+    notModified.notModified = true;
+    cache.add(source, notModified);
+    EXPECT_FALSE(cache.get(source));
+
+    cache.add(style, response(20));
+    EXPECT_EQ(20u, cache.get(style)->data->size());
+
+    cache.remove(style);
+    EXPECT_FALSE(cache.get(style));
+
+    const ResponseCache::Stats stats = cache.getStats();
+    EXPECT_EQ(3u, stats.hits);
+    EXPECT_EQ(4u, stats.misses);
+    EXPECT_EQ(0u, stats.size);
+    EXPECT_EQ(0u, stats.bytes);
+}
+
+TEST(ResponseCache, Evict) {
+    ResponseCache cache;
+    cache.setMaximumSize(3000);
+
+    const Resource a = Resource::style("http://example.com/a");
+    const Resource b = Resource::style("http://example.com/b");
+    const Resource c = Resource::style("http://example.com/c");
+    cache.add(a, response(1000));
+    cache.add(b, response(1000));
+
+    // Reading a response makes it the most recently used.
+    EXPECT_TRUE(cache.get(a));
+    cache.add(c, response(1000));
+    EXPECT_TRUE(cache.get(a));
+    EXPECT_FALSE(cache.get(b));
+    EXPECT_TRUE(cache.get(c));
+    EXPECT_LE(cache.getStats().bytes, 3000u);
+
+    // Responses larger than the cache aren't kept.
+    const Resource d = Resource::style("http://example.com/d");
+    cache.add(d, response(3000));
+    EXPECT_FALSE(cache.get(d));
+    EXPECT_EQ(2u, cache.getStats().size);
+
+    cache.setMaximumSize(0);
+    EXPECT_EQ(0u, cache.getStats().size);
+    EXPECT_EQ(0u, cache.getStats().bytes);
+}
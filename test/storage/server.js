@@ -42,6 +42,15 @@ app.get('/cache', function(req, res) {
     res.send('Response ' + (++cacheCounter));
 });
 
+var coalesceCounter = 0;
+app.get('/coalesce', function(req, res) {
+    // Slow enough for identical requests to overlap.
+    setTimeout(function() {
+        res.setHeader('Cache-Control', 'max-age=30');
+        res.send('Response ' + (++coalesceCounter));
+    }, 100);
+});
+
 app.get('/revalidate-same', function(req, res) {
     if (req.headers['if-none-match'] == 'snowfall') {
         // Second request can be cached for 30 seconds.
@@ -169,6 +178,23 @@ app.get('/load/:number(\\d+)', function(req, res) {
     res.send('Request ' + req.params.number);
 });
 
+app.get('/batch', function(req, res) {
+    // Leaves out the tiles at zoom level 0, which are then requested on their own.
+    var body = '--tile-batch';
+    req.query.tiles.split(',').forEach(function(tile) {
+        if (tile.split('/')[0] !== '0') {
+            body += '\r\nContent-Location: ' + tile + '\r\nCache-Control: max-age=60\r\n\r\n' +
+                'Tile ' + tile + '\r\n--tile-batch';
+        }
+    });
+    res.setHeader('Content-Type', 'multipart/mixed; boundary=tile-batch');
+    res.send(body + '--\r\n');
+});
+
+app.get('/batch-tile/:z/:x/:y', function(req, res) {
+    res.send('Single tile ' + req.params.z + '/' + req.params.x + '/' + req.params.y);
+});
+
 var server = app.listen(3000, function () {
     // Tell parent that we're now listening.
     process.stdout.write("OK");
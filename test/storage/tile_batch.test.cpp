@@ -0,0 +1,55 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/tile_batch.hpp>
+
+using namespace mbgl;
+
+TEST(TileBatch, URL) {
+    const std::vector<Resource::TileData> tiles {
+        { "", 1, 8800, 5373, 14 },
+        { "", 1, 8801, 5373, 14 },
+    };
+    EXPECT_EQ("https://example.com/batch?tiles=14/8800/5373,14/8801/5373&ratio=",
+              batchURL("https://example.com/batch?tiles={tiles}&ratio={ratio}", tiles));
+}
+
+TEST(TileBatch, ParseResponse) {
+    const std::string body =
+        "--b\r\n"
+        "Content-Location: 14/8800/5373\r\n"
+        "cache-control: max-age=60\r\n"
+        "ETag: \"a\"\r\n"
+        "\r\n"
+        "first\r\n\r\ntile\r\n"
+        "--b\r\n"
+        "\r\n"
+        "without location\r\n"
+        "--b\r\n"
+        "content-location:14/8801/5373\r\n"
+        "Expires: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+        "\r\n"
+        "\r\n"
+        "--b--\r\n";
+
+    auto tiles = parseBatchResponse(body);
+    ASSERT_EQ(2u, tiles.size());
+
+    const Response& first = tiles.at("14/8800/5373");
+    ASSERT_TRUE(first.data.get());
+    EXPECT_EQ("first\r\n\r\ntile", *first.data);
+    EXPECT_EQ(std::string("\"a\""), first.etag);
+    ASSERT_TRUE(bool(first.expires));
+    EXPECT_GT(*first.expires, util::now());
+
+    const Response& second = tiles.at("14/8801/5373");
+    ASSERT_TRUE(second.data.get());
+    EXPECT_EQ("", *second.data);
+    EXPECT_EQ(util::parseTimestamp(784111777), second.expires);
+}
+
+TEST(TileBatch, MalformedResponse) {
+    EXPECT_THROW(parseBatchResponse(""), std::runtime_error);
+    EXPECT_THROW(parseBatchResponse("tile"), std::runtime_error);
+    EXPECT_THROW(parseBatchResponse("--b\r\nContent-Location: 0/0/0\r\n\r\ntile"), std::runtime_error);
+    EXPECT_THROW(parseBatchResponse("--b\r\nno header\r\n\r\ntile\r\n--b--"), std::runtime_error);
+}
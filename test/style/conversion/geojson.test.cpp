@@ -0,0 +1,89 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/conversion/geojson.hpp>
+#include <mbgl/util/feature.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style::conversion;
+
+namespace {
+
+optional<GeoJSON> parse(const std::string& json, Error& error) {
+    return convert<GeoJSON>(json, error);
+}
+
+} // namespace
+
+TEST(GeoJSONConversion, FeatureCollection) {
+    Error error;
+    optional<GeoJSON> geoJSON = parse(R"({
+        "features": [{
+            "geometry": { "coordinates": [[[0, 0], [10, 0], [10, 10], [0, 0]]], "type": "Polygon" },
+            "properties": { "name": "square", "height": 12, "tags": ["a", { "b": null }] },
+            "id": 7,
+            "type": "Feature"
+        }, {
+            "type": "Feature",
+            "id": "line",
+            "bbox": [0, 0, 1, 1],
+            "properties": null,
+            "geometry": { "type": "LineString", "coordinates": [[0, 0, 5], [1, -1.5]] }
+        }],
+        "type": "FeatureCollection"
+    })", error);
+    ASSERT_TRUE(geoJSON) << error.message;
+    ASSERT_TRUE(geoJSON->is<FeatureCollection>());
+
+    const FeatureCollection& features = geoJSON->get<FeatureCollection>();
+    ASSERT_EQ(2u, features.size());
+
+    // Members before the type are kept.
+    const Feature& polygon = features[0];
+    EXPECT_EQ((mapbox::geometry::polygon<double> { { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 0 } } }),
+              polygon.geometry.get<mapbox::geometry::polygon<double>>());
+    EXPECT_EQ(FeatureIdentifier(uint64_t(7)), *polygon.id);
+    EXPECT_EQ(Value(std::string("square")), polygon.properties.at("name"));
+    EXPECT_EQ(Value(uint64_t(12)), polygon.properties.at("height"));
+    EXPECT_EQ(Value(std::vector<Value> { std::string("a"), PropertyMap { { "b", NullValue() } } }),
+              polygon.properties.at("tags"));
+
+    // Altitudes are dropped.
+    const Feature& line = features[1];
+    EXPECT_EQ((mapbox::geometry::line_string<double> { { 0, 0 }, { 1, -1.5 } }),
+              line.geometry.get<mapbox::geometry::line_string<double>>());
+    EXPECT_EQ(FeatureIdentifier(std::string("line")), *line.id);
+    EXPECT_TRUE(line.properties.empty());
+}
+
+TEST(GeoJSONConversion, Geometries) {
+    Error error;
+    optional<GeoJSON> point = parse(R"({ "type": "Point", "coordinates": [1, 2] })", error);
+    ASSERT_TRUE(point) << error.message;
+    EXPECT_EQ(mapbox::geometry::point<double>(1, 2), point->get<mapbox::geometry::geometry<double>>().get<mapbox::geometry::point<double>>());
+
+    optional<GeoJSON> collection = parse(R"({ "type": "GeometryCollection", "geometries": [
+        { "type": "MultiPoint", "coordinates": [[1, 2], [3, 4]] },
+        { "type": "MultiPolygon", "coordinates": [[[[0, 0], [1, 0], [1, 1], [0, 0]]], []] }
+    ] })", error);
+    ASSERT_TRUE(collection) << error.message;
+    const auto& geometries = collection->get<mapbox::geometry::geometry<double>>().get<mapbox::geometry::geometry_collection<double>>();
+    ASSERT_EQ(2u, geometries.size());
+    EXPECT_EQ(2u, geometries[0].get<mapbox::geometry::multi_point<double>>().size());
+    EXPECT_EQ(2u, geometries[1].get<mapbox::geometry::multi_polygon<double>>().size());
+
+    optional<GeoJSON> feature = parse(R"({ "type": "Feature", "geometry": null, "properties": {} })", error);
+    ASSERT_TRUE(feature) << error.message;
+    EXPECT_TRUE(feature->get<Feature>().geometry.is<mapbox::geometry::geometry_collection<double>>());
+}
+
+TEST(GeoJSONConversion, Errors) {
+    Error error;
+    EXPECT_FALSE(parse(R"([1, 2])", error));
+    EXPECT_FALSE(parse(R"({ "type": "Point", "coordinates": [[1, 2]] })", error));
+    EXPECT_FALSE(parse(R"({ "type": "LineString", "coordinates": [[1, 2], 3] })", error));
+    EXPECT_FALSE(parse(R"({ "type": "Polygon", "coordinates": [[[1, 2]], [3, 4]] })", error));
+    EXPECT_FALSE(parse(R"({ "type": "Feature", "properties": {} })", error));
+    EXPECT_FALSE(parse(R"({ "type": "FeatureCollection", "features": [{ "type": "Point", "coordinates": [1, 2] }] })", error));
+    EXPECT_FALSE(parse(R"({ "type": "Point", "coordinates": [1, 2] )", error));
+    EXPECT_FALSE(error.message.empty());
+}
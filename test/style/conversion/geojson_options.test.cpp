@@ -36,6 +36,8 @@ TEST(GeoJSONOptions, RetainsDefaults) {
     ASSERT_EQ(converted.maxzoom, defaults.maxzoom);
     ASSERT_EQ(converted.buffer, defaults.buffer);
     ASSERT_EQ(converted.tolerance, defaults.tolerance);
+    ASSERT_EQ(converted.indexMaxZoom, defaults.indexMaxZoom);
+    ASSERT_EQ(converted.indexMaxPoints, defaults.indexMaxPoints);
 
     // Supercluster
     ASSERT_EQ(converted.cluster, defaults.cluster);
@@ -50,6 +52,8 @@ TEST(GeoJSONOptions, FullConversion) {
         {"maxzoom", 1.0f},
         {"buffer", 2.0f},
         {"tolerance", 3.0f},
+        {"indexMaxZoom", 0.0f},
+        {"indexMaxPoints", 1000.0f},
 
         // Supercluster
         {"cluster", true},
@@ -64,6 +68,8 @@ TEST(GeoJSONOptions, FullConversion) {
     ASSERT_EQ(converted.maxzoom, 1);
     ASSERT_EQ(converted.buffer, 2);
     ASSERT_EQ(converted.tolerance, 3);
+    ASSERT_EQ(converted.indexMaxZoom, 0);
+    ASSERT_EQ(converted.indexMaxPoints, 1000u);
 
     // Supercluster
     ASSERT_EQ(converted.cluster, true);
@@ -4,6 +4,7 @@
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion/layer.hpp>
 #include <mbgl/style/layers/background_layer_impl.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
 #include <mbgl/util/rapidjson.hpp>
 
 using namespace mbgl;
@@ -35,3 +36,42 @@ TEST(StyleConversion, LayerTransition) {
     ASSERT_EQ(500ms, *layer->as<BackgroundLayer>()->impl().paint
         .get<BackgroundColor>().options.delay);
 }
+
+TEST(StyleConversion, HeatmapLayer) {
+    auto layer = parseLayer(R"JSON({
+        "type": "heatmap",
+        "id": "heatmap",
+        "source": "points",
+        "paint": {
+            "heatmap-weight": 0.5,
+            "heatmap-intensity": {
+                "stops": [[0, 1], [9, 3]]
+            },
+            "heatmap-opacity": 0.8,
+            "heatmap-color": ["interpolate", ["linear"], ["heatmap-density"], 0, "white", 1, "red"]
+        }
+    })JSON");
+
+    auto circle = layer->as<CircleLayer>();
+    ASSERT_NE(nullptr, circle);
+    ASSERT_TRUE(bool(circle->impl().heatmap));
+    EXPECT_TRUE(circle->impl().heatmap->intensity.isCameraFunction());
+    EXPECT_EQ(PropertyValue<float>(0.8f), circle->impl().heatmap->opacity);
+    EXPECT_EQ(DataDrivenPropertyValue<float>(30.0f), circle->getCircleRadius());
+    EXPECT_EQ(DataDrivenPropertyValue<float>(0.5f), circle->getCircleOpacity());
+}
+
+TEST(StyleConversion, HeatmapLayerUnknownProperty) {
+    JSDocument doc;
+    doc.Parse<0>(R"JSON({
+        "type": "heatmap",
+        "id": "heatmap",
+        "source": "points",
+        "paint": {
+            "circle-color": "red"
+        }
+    })JSON");
+    Error error;
+    EXPECT_FALSE(convert<std::unique_ptr<Layer>, JSValue>(doc, error));
+    EXPECT_EQ("property not found", error.message);
+}
@@ -4,6 +4,7 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -126,3 +127,69 @@ TEST(Filter, ID) {
 
     ASSERT_FALSE(parse("[\"==\", \"$id\", 1234]")(feature2));
 }
+
+TEST(Filter, Compiled) {
+    const char* expressions[] = {
+        R"(["==", "foo", "bar"])",
+        R"(["!=", "foo", "bar"])",
+        R"(["==", "foo", 0])",
+        R"(["!=", "foo", 0])",
+        R"(["<", "foo", 1.5])",
+        R"([">=", "foo", 0])",
+        R"(["in", "foo", "bar", 0, true])",
+        R"(["!in", "foo", "bar", 0, true])",
+        R"(["any", ["==", "foo", "bar"], ["any", ["==", "foo", 1], ["has", "baz"]]])",
+        R"(["all", ["!=", "foo", "bar"], ["all"], ["!has", "baz"]])",
+        R"(["none", ["==", "foo", "bar"], ["==", "foo", 1]])",
+        R"(["==", "$type", "Point"])",
+        R"(["in", "$type", "LineString", "Polygon"])",
+        R"(["==", "$id", 1234])",
+        R"(["in", "$id", 1, 1234])",
+        R"(["has", "$id"])",
+    };
+
+    Feature withID { Point<double>() };
+    withID.id = { uint64_t(1234) };
+    withID.properties["foo"] = std::string("qux");
+
+    const Feature features[] = {
+        feature({{}}),
+        feature({{ "foo", std::string("bar") }}),
+        feature({{ "foo", std::string("baz") }}),
+        feature({{ "foo", int64_t(0) }}),
+        feature({{ "foo", uint64_t(1) }}),
+        feature({{ "foo", 1.0 }}),
+        feature({{ "foo", true }}),
+        feature({{ "baz", false }}, LineString<double>()),
+        feature({{ "foo", int64_t(2) }, { "baz", std::string("bar") }}, Polygon<double>()),
+        withID,
+    };
+
+    for (const char* expression : expressions) {
+        const Filter filter = parse(expression);
+        const CompiledFilter compiled(filter);
+        for (const auto& feature_ : features) {
+            EXPECT_EQ(filter(feature_), compiled(feature_)) << expression;
+        }
+    }
+}
+
+TEST(Filter, CompiledMatchesAll) {
+    EXPECT_TRUE(CompiledFilter().matchesAll());
+    EXPECT_TRUE(CompiledFilter(parse(R"(["all"])")).matchesAll());
+    EXPECT_TRUE(CompiledFilter(parse(R"(["all", ["all"]])")).matchesAll());
+    EXPECT_FALSE(CompiledFilter(parse(R"(["any"])")).matchesAll());
+    EXPECT_FALSE(CompiledFilter(parse(R"(["all", ["has", "foo"]])")).matchesAll());
+}
+
+TEST(Filter, CompiledLooksUpEachKeyOnce) {
+    const CompiledFilter filter(parse(R"(["all", ["has", "foo"], ["!=", "foo", "bar"], ["!in", "foo", "baz", "qux"]])"));
+
+    std::size_t lookups = 0;
+    EXPECT_TRUE(filter(FeatureType::Point, {}, [&] (const std::string& key) -> optional<Value> {
+        lookups++;
+        EXPECT_EQ("foo", key);
+        return { std::string("quux") };
+    }));
+    EXPECT_EQ(1u, lookups);
+}
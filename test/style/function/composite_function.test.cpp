@@ -69,3 +69,21 @@ TEST(CompositeFunction, Issue8460) {
     EXPECT_NEAR(600.0f, fn2.evaluate(18.0f, oneInteger, -1.0f), 0.00);
     EXPECT_NEAR(600.0f, fn2.evaluate(19.0f, oneInteger, -1.0f), 0.00);
 }
+
+TEST(CompositeFunction, Categorical) {
+    const StubGeometryTileFeature school { PropertyMap {{ "property", "school"s }} };
+    const StubGeometryTileFeature park { PropertyMap {{ "property", "park"s }} };
+
+    CompositeFunction<float> fn("property", CompositeCategoricalStops<float>({
+        {0.0f, {{"school"s, 10.0f}, {"park"s, 20.0f}}},
+        {10.0f, {{"school"s, 30.0f}}}
+    }), 0.0f);
+
+    EXPECT_EQ(20.0f, fn.evaluate(5.0f, school, -1.0f));
+    EXPECT_EQ(10.0f, fn.evaluate(5.0f, park, -1.0f));
+    EXPECT_EQ(0.0f, fn.evaluate(5.0f, oneInteger, -1.0f));
+
+    // Copies evaluate the same.
+    CompositeFunction<float> copy = fn;
+    EXPECT_EQ(30.0f, copy.evaluate(10.0f, school, -1.0f));
+}
@@ -95,3 +95,24 @@ TEST(SourceFunction, Categorical) {
     EXPECT_EQ(1.0f, SourceFunction<float>("property", CategoricalStops<float>({{ false, 1.0f }}))
         .evaluate(falseFeature, 0.0f));
 }
+
+TEST(SourceFunction, CategoricalIntegers) {
+    // Stops that lie close together, and ones that are spread out.
+    for (const int64_t step : { int64_t(1), int64_t(1) << 40 }) {
+        CategoricalStops<float>::Stops stops;
+        for (int64_t i = -3; i <= 3; i++) {
+            if (i != 0) {
+                stops[i * step] = float(i);
+            }
+        }
+        const SourceFunction<float> function("property", CategoricalStops<float>(stops), -10.0f);
+
+        for (int64_t i = -3; i <= 3; i++) {
+            const StubGeometryTileFeature feature { PropertyMap {{ "property", i * step }} };
+            EXPECT_EQ(i ? float(i) : -10.0f, function.evaluate(feature, 0.0f)) << i * step;
+        }
+
+        const StubGeometryTileFeature outside { PropertyMap {{ "property", 4 * step }} };
+        EXPECT_EQ(-10.0f, function.evaluate(outside, 0.0f));
+    }
+}
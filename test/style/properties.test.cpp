@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/style/properties.hpp>
+#include <mbgl/style/layers/fill_layer_properties.hpp>
 #include <mbgl/renderer/property_evaluator.hpp>
 #include <mbgl/renderer/data_driven_property_evaluator.hpp>
 
@@ -137,3 +138,54 @@ TEST(TransitioningDataDrivenPropertyValue, Evaluate) {
     ASSERT_FALSE(evaluate(t1, 0ms).isConstant()) <<
         "A paint property transition to a data-driven evaluates immediately to the final value (see https://github.com/mapbox/mapbox-gl-native/issues/8237).";
 }
+
+TEST(Properties, ZoomDependent) {
+    FillPaintProperties::Transitionable properties;
+    EXPECT_FALSE(properties.untransitioned().isZoomDependent());
+
+    properties.get<FillColor>().value = Color::red();
+    properties.get<FillOpacity>().value = SourceFunction<float>("opacity", IdentityStops<float>());
+    EXPECT_FALSE(properties.untransitioned().isZoomDependent());
+
+    properties.get<FillTranslate>().value = CameraFunction<std::array<float, 2>>(
+        ExponentialStops<std::array<float, 2>>({{ 0, {{ 0, 0 }} }, { 10, {{ 10, 10 }} }}));
+    EXPECT_TRUE(properties.untransitioned().isZoomDependent());
+
+    // Patterns fade between the zoom levels they're scaled for.
+    properties.get<FillTranslate>().value = {};
+    properties.get<FillPattern>().value = std::string("pattern");
+    EXPECT_TRUE(properties.untransitioned().isZoomDependent());
+}
+
+TEST(Properties, EvaluateTransitionsOnly) {
+    FillPaintProperties::Transitionable properties;
+    properties.get<FillColor>().value = Color::red();
+    properties.get<FillOpacity>().value = 0.0f;
+    properties.get<FillOpacity>().options.duration = { 1000ms };
+
+    FillPaintProperties::Unevaluated unevaluated = properties.untransitioned();
+    properties.get<FillOpacity>().value = 1.0f;
+    unevaluated = properties.transitioned({ TimePoint::min(), {} }, std::move(unevaluated));
+    EXPECT_TRUE(unevaluated.get<FillOpacity>().hasTransition());
+    EXPECT_FALSE(unevaluated.get<FillColor>().hasTransition());
+
+    ZoomHistory zoomHistory;
+    zoomHistory.update(0, TimePoint::min());
+    PropertyEvaluationParameters parameters { zoomHistory, TimePoint::min() + 500ms, Duration::zero() };
+    FillPaintProperties::PossiblyEvaluated evaluated = unevaluated.evaluate(parameters);
+    EXPECT_FLOAT_EQ(0.823099f, evaluated.get<FillOpacity>().constantOr(0));
+    EXPECT_EQ(Color::red(), evaluated.get<FillColor>().constantOr(Color::black()));
+
+    // Properties without a transition keep the values they were evaluated to before.
+    evaluated.get<FillColor>() = PossiblyEvaluatedPropertyValue<Color>(Color::blue());
+    parameters.now = TimePoint::min() + 1000ms;
+    parameters.transitionsOnly = true;
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
+    EXPECT_FLOAT_EQ(1.0f, evaluated.get<FillOpacity>().constantOr(0));
+    EXPECT_EQ(Color::blue(), evaluated.get<FillColor>().constantOr(Color::black()));
+    EXPECT_FALSE(unevaluated.hasTransition());
+
+    parameters.transitionsOnly = false;
+    evaluated = unevaluated.evaluate(parameters, std::move(evaluated));
+    EXPECT_EQ(Color::red(), evaluated.get<FillColor>().constantOr(Color::black()));
+}
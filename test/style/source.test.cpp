@@ -8,7 +8,11 @@
 #include <mbgl/style/sources/raster_source.hpp>
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/sources/custom_geometry_source.hpp>
+#include <mbgl/style/sources/custom_geometry_source_impl.hpp>
 #include <mbgl/style/sources/image_source.hpp>
+#include <mbgl/style/sources/image_source_impl.hpp>
 #include <mbgl/style/layers/raster_layer.cpp>
 #include <mbgl/style/layers/line_layer.hpp>
 
@@ -24,6 +28,7 @@
 #include <mbgl/util/image.hpp>
 
 #include <mbgl/util/tileset.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/optional.hpp>
@@ -35,7 +40,11 @@
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 
+#include <supercluster.hpp>
+
+#include <cmath>
 #include <cstdint>
+#include <random>
 
 using namespace mbgl;
 
@@ -63,7 +72,9 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        0,
+        {}
     };
 
     SourceTest() {
@@ -211,6 +222,34 @@ TEST(Source, VectorTileEmpty) {
     test.run();
 }
 
+TEST(Source, VectorTilesetWithoutTiles) {
+    SourceTest test;
+
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        ADD_FAILURE() << "Should never be called";
+        return Response();
+    };
+
+    LineLayer layer("id", "source");
+    layer.setSourceLayer("water");
+
+    std::vector<Immutable<Layer::Impl>> layers {{ layer.baseImpl }};
+
+    VectorSource source("source", Tileset());
+    source.loadDescription(test.fileSource);
+
+    auto renderSource = RenderSource::create(source.baseImpl);
+    renderSource->setObserver(&test.renderSourceObserver);
+    renderSource->update(source.baseImpl,
+                         layers,
+                         true,
+                         true,
+                         test.tileParameters);
+
+    EXPECT_TRUE(renderSource->getRenderTiles().empty());
+    EXPECT_TRUE(renderSource->isLoaded());
+}
+
 TEST(Source, RasterTileFail) {
     SourceTest test;
 
@@ -512,6 +551,190 @@ TEST(Source, GeoJSonSourceUrlUpdate) {
     test.run();
 }
 
+TEST(Source, GeoJSonSourceBuildsInBackground) {
+    SourceTest test;
+
+    GeoJSONSource source("source");
+    source.setObserver(&test.styleObserver);
+    source.setScheduler(&test.threadPool);
+    source.loadDescription(test.fileSource);
+    ASSERT_TRUE(source.loaded);
+
+    test.styleObserver.sourceChanged = [&] (Source&) {
+        EXPECT_TRUE(source.loaded);
+        EXPECT_NE(nullptr, source.impl().getData());
+        test.end();
+    };
+
+    source.setGeoJSON(GeoJSON{ FeatureCollection{} });
+
+    // The current data is kept until the index is built.
+    EXPECT_FALSE(source.loaded);
+    EXPECT_EQ(nullptr, source.impl().getData());
+
+    test.run();
+}
+
+TEST(Source, GeoJSonSourceUpdateFeatures) {
+    SourceTest test;
+
+    auto point = [] (uint64_t id, double lon, double lat) {
+        Feature feature { mapbox::geometry::point<double>(lon, lat) };
+        feature.id = id;
+        return feature;
+    };
+
+    GeoJSONSource source("source");
+    source.setObserver(&test.styleObserver);
+    source.setGeoJSON(GeoJSON{ FeatureCollection{ point(1, 0, 0), point(2, 10, 10) } });
+    const uint64_t dataID = source.impl().getDataID();
+    EXPECT_FALSE(source.impl().getChangedBounds(dataID - 1));
+
+    // Feature 1 moves, 2 is removed, and 3 is added.
+    source.updateGeoJSON(FeatureCollection{ point(1, 1, 1), point(3, 20, 20) }, { uint64_t(2) });
+    EXPECT_EQ(dataID + 1, source.impl().getDataID());
+
+    optional<LatLngBounds> changed = source.impl().getChangedBounds(dataID);
+    ASSERT_TRUE(changed);
+    EXPECT_EQ(LatLngBounds::hull({ 0, 0 }, { 20, 20 }), *changed);
+    EXPECT_EQ(2u, source.impl().getData()->getTile(CanonicalTileID(0, 0, 0)).size());
+
+    // Render sources that missed an update don't know what changed.
+    source.updateGeoJSON(FeatureCollection{}, { uint64_t(3) });
+    EXPECT_FALSE(source.impl().getChangedBounds(dataID - 1));
+    EXPECT_EQ(LatLngBounds::hull({ 0, 0 }, { 20, 20 }), *source.impl().getChangedBounds(dataID));
+    EXPECT_EQ(1u, source.impl().getData()->getTile(CanonicalTileID(0, 0, 0)).size());
+
+    // New data may change everything.
+    source.setGeoJSON(GeoJSON{ FeatureCollection{} });
+    EXPECT_FALSE(source.impl().getChangedBounds(dataID + 2));
+}
+
+TEST(Source, GeoJSonSourceLazyTiling) {
+    GeoJSONOptions options;
+    options.indexMaxZoom = 0;
+
+    GeoJSONSource source("source", options);
+    source.setGeoJSON(GeoJSON{ FeatureCollection{
+        Feature { mapbox::geometry::point<double>(0, 0) },
+        Feature { mapbox::geometry::point<double>(100, 50) }
+    } });
+
+    // Only the root tile is sliced up front.
+    GeoJSONData& data = *source.impl().getData();
+    EXPECT_EQ(1u, data.getIndexedTileCount());
+
+    EXPECT_EQ(1u, data.getTile(CanonicalTileID(2, 2, 1)).size());
+    EXPECT_LT(1u, data.getIndexedTileCount());
+}
+
+TEST(Source, GeoJSonSourceParallelClusters) {
+    GeoJSONOptions options;
+    options.cluster = true;
+
+    // Enough points for several blocks of neighbour searches.
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> lon(-180, 180);
+    std::uniform_real_distribution<double> lat(-85, 85);
+    FeatureCollection points;
+    for (std::size_t i = 0; i < 100000; i++) {
+        Feature feature { mapbox::geometry::point<double>(lon(generator), lat(generator)) };
+        feature.properties["index"] = uint64_t(i);
+        points.push_back(std::move(feature));
+    }
+
+    const double scale = util::EXTENT / util::tileSize;
+    mapbox::supercluster::Options clusterOptions;
+    clusterOptions.maxZoom = options.clusterMaxZoom;
+    clusterOptions.extent = util::EXTENT;
+    clusterOptions.radius = ::round(scale * options.clusterRadius);
+    mapbox::supercluster::Supercluster supercluster(points, clusterOptions);
+
+    ThreadPool pool(4);
+    auto sequential = GeoJSONData::create(GeoJSON { points }, options);
+    auto parallel = GeoJSONData::create(GeoJSON { points }, options, &pool);
+
+    // Clusters only hold points.
+    FeatureCollection mixed = points;
+    mixed.push_back(Feature { mapbox::geometry::line_string<double>{ { 0, 0 }, { 10, 10 } } });
+    auto withLine = GeoJSONData::create(GeoJSON { mixed }, options, &pool);
+
+    const auto root = parallel->getTile(CanonicalTileID(0, 0, 0));
+    ASSERT_FALSE(root.empty());
+    EXPECT_TRUE(root[0].properties.count("cluster"));
+
+    for (const auto& tileID : { CanonicalTileID(0, 0, 0), CanonicalTileID(3, 0, 3), CanonicalTileID(3, 7, 4),
+                                CanonicalTileID(10, 511, 380), CanonicalTileID(18, 131072, 87000) }) {
+        const auto expected = supercluster.getTile(tileID.z, tileID.x, tileID.y);
+        EXPECT_EQ(expected, sequential->getTile(tileID)) << tileID;
+        EXPECT_EQ(expected, parallel->getTile(tileID)) << tileID;
+        EXPECT_EQ(expected, withLine->getTile(tileID)) << tileID;
+    }
+}
+
+TEST(Source, CustomGeometrySourceFetchesRequiredTiles) {
+    SourceTest test;
+
+    LineLayer layer("id", "source");
+    std::vector<Immutable<Layer::Impl>> layers {{ layer.baseImpl }};
+
+    std::atomic<std::size_t> fetched { 0 };
+    CustomGeometrySourceOptions options;
+    options.fetchTile = [&] (const CanonicalTileID& tileID, const std::atomic<bool>&) {
+        EXPECT_EQ(CanonicalTileID(0, 0, 0), tileID);
+        fetched++;
+        return GeoJSON{ FeatureCollection{
+            Feature { mapbox::geometry::line_string<double>{ { -10, -10 }, { 10, 10 } } }
+        } };
+    };
+
+    CustomGeometrySource source("source", std::move(options));
+    source.loadDescription(test.fileSource);
+    EXPECT_TRUE(source.loaded);
+
+    test.renderSourceObserver.tileChanged = [&] (RenderSource& source_, const OverscaledTileID& tileID) {
+        EXPECT_EQ("source", source_.baseImpl->id);
+        EXPECT_EQ(CanonicalTileID(0, 0, 0), tileID.canonical);
+        EXPECT_LE(1u, fetched);
+        test.end();
+    };
+
+    test.renderSourceObserver.tileError = [&] (RenderSource&, const OverscaledTileID&, std::exception_ptr) {
+        FAIL() << "Should never be called";
+    };
+
+    auto renderSource = RenderSource::create(source.baseImpl);
+    renderSource->setObserver(&test.renderSourceObserver);
+    renderSource->update(source.baseImpl,
+                         layers,
+                         true,
+                         true,
+                         test.tileParameters);
+
+    test.run();
+}
+
+TEST(Source, CustomGeometrySourceInvalidation) {
+    CustomGeometrySource source("source", CustomGeometrySourceOptions());
+    EXPECT_EQ(0u, source.impl().getRevision());
+
+    source.invalidateRegion(LatLngBounds::hull({ 0, 0 }, { 10, 10 }));
+    source.invalidateTile(CanonicalTileID(1, 1, 1));
+    EXPECT_EQ(2u, source.impl().getRevision());
+
+    optional<LatLngBounds> invalidated = source.impl().getInvalidatedBounds(0);
+    ASSERT_TRUE(invalidated);
+    EXPECT_TRUE(invalidated->contains(LatLng { 5, 5 }));
+    EXPECT_TRUE(invalidated->contains(LatLng { -45, 90 }));
+    EXPECT_TRUE(source.impl().getInvalidatedBounds(2)->isEmpty());
+
+    // Render sources that fell too far behind invalidate all of their tiles.
+    for (std::size_t i = 0; i < 20; i++) {
+        source.invalidateTile(CanonicalTileID(0, 0, 0));
+    }
+    EXPECT_FALSE(source.impl().getInvalidatedBounds(0));
+}
+
 TEST(Source, ImageSourceImageUpdate) {
     SourceTest test;
 
@@ -547,3 +770,31 @@ TEST(Source, ImageSourceImageUpdate) {
 
     test.run();
 }
+
+TEST(Source, ImageSourceFrames) {
+    std::array<LatLng, 4> coords;
+    ImageSource source("source", coords);
+
+    std::vector<PremultipliedImage> frames;
+    for (uint8_t i = 0; i < 3; i++) {
+        PremultipliedImage frame({ 2, 2 });
+        frame.fill(i);
+        frames.push_back(std::move(frame));
+    }
+    source.setFrames(std::move(frames));
+    ASSERT_EQ(3u, source.getFrameCount());
+    EXPECT_EQ(0u, source.getFrame());
+
+    source.setFrame(2);
+    EXPECT_EQ(2u, source.getFrame());
+    EXPECT_EQ(source.impl().getFrames()[2], source.impl().getImage());
+    EXPECT_EQ(2u, source.impl().getImage()->data[0]);
+
+    // Frames that don't exist aren't shown.
+    source.setFrame(3);
+    EXPECT_EQ(2u, source.getFrame());
+
+    source.setImage(PremultipliedImage({ 1, 1 }));
+    EXPECT_EQ(1u, source.getFrameCount());
+    EXPECT_EQ(0u, source.getFrame());
+}
@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/stub_file_source.hpp>
 #include <mbgl/test/fixture_log_observer.hpp>
+#include <mbgl/test/stub_style_observer.hpp>
 
 #include <mbgl/style/style_impl.hpp>
 #include <mbgl/style/source_impl.hpp>
@@ -99,3 +100,45 @@ TEST(Style, RemoveSourceInUse) {
 
     EXPECT_EQ(log->count(logMessage), 1u);
 }
+
+TEST(Style, Batch) {
+    util::RunLoop loop;
+
+    ThreadPool threadPool{ 1 };
+    StubFileSource fileSource;
+    Style::Impl style { threadPool, fileSource, 1.0 };
+
+    StubStyleObserver observer;
+    std::size_t updates = 0;
+    observer.updated = [&] (Update) { updates++; };
+    style.setObserver(&observer);
+
+    style.loadJSON(R"STYLE({"version": 8, "layers": []})STYLE");
+    auto* layer = style.addLayer(std::make_unique<LineLayer>("line", "source"))->as<LineLayer>();
+    updates = 0;
+
+    const auto layerImpls = style.getLayerImpls();
+
+    style.beginBatch();
+    layer->setLineWidth(2.0f);
+    layer->setLineOpacity(0.5f);
+
+    // Nested batches are committed with the outermost one.
+    style.beginBatch();
+    layer->setVisibility(VisibilityType::None);
+    layer->setLineColor(Color::red());
+    style.commitBatch();
+
+    EXPECT_EQ(0u, updates);
+    EXPECT_EQ(layerImpls, style.getLayerImpls());
+    EXPECT_EQ(layerImpls->at(0), style.getLayerImpls()->at(0));
+
+    style.commitBatch();
+    EXPECT_EQ(1u, updates);
+    EXPECT_EQ(layer->baseImpl, style.getLayerImpls()->at(0));
+
+    // Outside of batches, every change is an update of its own.
+    layer->setLineWidth(3.0f);
+    EXPECT_EQ(2u, updates);
+    EXPECT_EQ(layer->baseImpl, style.getLayerImpls()->at(0));
+}
@@ -291,3 +291,32 @@ TEST(Layer, DuplicateLayer) {
     }
 }
 
+
+TEST(Layer, PaintOnlyLayoutDifference) {
+    auto layer = std::make_unique<FillLayer>("fill", "source");
+    const Immutable<Layer::Impl> initial = layer->baseImpl;
+
+    // Constant paint properties don't affect layout.
+    layer->setFillColor(color);
+    EXPECT_FALSE(initial->hasLayoutDifference(*layer->baseImpl));
+    EXPECT_FALSE(initial->hasPaintOnlyLayoutDifference(*layer->baseImpl));
+
+    // Data-driven ones can be applied by repainting buckets.
+    layer->setFillOpacity(SourceFunction<float>("opacity", IdentityStops<float>()));
+    const Immutable<Layer::Impl> dataDriven = layer->baseImpl;
+    EXPECT_TRUE(initial->hasLayoutDifference(*dataDriven));
+    EXPECT_TRUE(initial->hasPaintOnlyLayoutDifference(*dataDriven));
+
+    // Unless the layout changes as well.
+    layer->setFilter(EqualsFilter { "class", std::string("park") });
+    EXPECT_TRUE(initial->hasLayoutDifference(*layer->baseImpl));
+    EXPECT_FALSE(initial->hasPaintOnlyLayoutDifference(*layer->baseImpl));
+    EXPECT_FALSE(dataDriven->hasPaintOnlyLayoutDifference(*layer->baseImpl));
+
+    // Symbol buckets are always laid out again.
+    auto symbolLayer = std::make_unique<SymbolLayer>("symbol", "source");
+    const Immutable<Layer::Impl> symbol = symbolLayer->baseImpl;
+    symbolLayer->setTextOpacity(SourceFunction<float>("opacity", IdentityStops<float>()));
+    EXPECT_TRUE(symbol->hasLayoutDifference(*symbolLayer->baseImpl));
+    EXPECT_FALSE(symbol->hasPaintOnlyLayoutDifference(*symbolLayer->baseImpl));
+}
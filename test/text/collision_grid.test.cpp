@@ -0,0 +1,57 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/collision_grid.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+CollisionBox box() {
+    return CollisionBox({ 0, 0 }, { 0, 0 }, 0, 0, 0, 0, 1);
+}
+
+std::vector<std::size_t> query(const CollisionGrid& grid, const CollisionGrid::Bounds& bounds) {
+    std::vector<std::size_t> result;
+    grid.query(bounds, [&] (std::size_t i) {
+        result.push_back(i);
+        return true;
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST(CollisionGrid, Query) {
+    CollisionGrid grid(100, 10, 1);
+    const std::size_t feature = grid.addFeature(IndexedSubfeature { 7, 0, 0, 0 });
+
+    grid.insert({ 5, 5, 45, 25 }, box(), feature);   // spans many cells
+    grid.insert({ 60, 60, 62, 62 }, box(), feature); // a single cell
+    grid.insert({ -50, -50, -40, -40 }, box(), feature); // outside, clamped to the padding
+
+    EXPECT_EQ(3u, grid.size());
+    EXPECT_EQ(7u, grid.getFeature(1).index);
+
+    EXPECT_EQ((std::vector<std::size_t>{ 0 }), query(grid, { 0, 0, 100, 50 }));
+    EXPECT_EQ((std::vector<std::size_t>{ 0, 1 }), query(grid, { 10, 10, 70, 70 }));
+    EXPECT_EQ((std::vector<std::size_t>{ 1 }), query(grid, { 62, 62, 63, 63 }));
+    EXPECT_EQ((std::vector<std::size_t>{}), query(grid, { 50, 30, 58, 58 }));
+    EXPECT_EQ((std::vector<std::size_t>{ 2 }), query(grid, { -45, -60, -30, -45 }));
+}
+
+TEST(CollisionGrid, QueryStops) {
+    CollisionGrid grid(100, 10, 0);
+    const std::size_t feature = grid.addFeature(IndexedSubfeature { 0, 0, 0, 0 });
+    for (int i = 0; i < 10; ++i) {
+        grid.insert({ 0, 0, 100, 100 }, box(), feature);
+    }
+
+    std::size_t calls = 0;
+    grid.query({ 0, 0, 100, 100 }, [&] (std::size_t) {
+        return ++calls < 3;
+    });
+    EXPECT_EQ(3u, calls);
+}
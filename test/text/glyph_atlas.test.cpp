@@ -0,0 +1,100 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_atlas.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Immutable<Glyph> glyph(GlyphID id, uint32_t size) {
+    auto result = makeMutable<Glyph>();
+    result->id = id;
+    result->metrics.width = size - 2 * Glyph::borderSize;
+    result->metrics.height = size - 2 * Glyph::borderSize;
+    result->bitmap = AlphaImage({ size, size });
+    result->bitmap.fill(id);
+    return std::move(result);
+}
+
+const FontStack fontStack { "Test Stack" };
+
+} // namespace
+
+TEST(GlyphAtlas, References) {
+    GlyphAtlas atlas;
+
+    const auto a = atlas.addReference(fontStack, glyph(1, 10));
+    ASSERT_TRUE(bool(a));
+    EXPECT_EQ(12, a->rect.w); // padded
+    EXPECT_EQ(1u, atlas.getAtlasImage().data[(a->rect.y + 1) * atlas.getAtlasImage().size.width + a->rect.x + 1]);
+
+    // Referencing the glyph again, e.g. from another tile, shares it.
+    const auto shared = atlas.addReference(fontStack, glyph(1, 10));
+    ASSERT_TRUE(bool(shared));
+    EXPECT_EQ(a->rect, shared->rect);
+
+    // The same glyph ID of another font stack is stored separately.
+    const auto other = atlas.addReference({ "Other Stack" }, glyph(1, 10));
+    ASSERT_TRUE(bool(other));
+    EXPECT_FALSE(a->rect == other->rect);
+
+    atlas.removeReference(fontStack, 1);
+    EXPECT_TRUE(bool(atlas.getPosition(fontStack, 1)));
+    atlas.removeReference(fontStack, 1);
+    EXPECT_FALSE(bool(atlas.getPosition(fontStack, 1)));
+
+    // The space of glyphs no longer referenced is reused.
+    const auto b = atlas.addReference(fontStack, glyph(2, 10));
+    ASSERT_TRUE(bool(b));
+    EXPECT_EQ(a->rect, b->rect);
+    EXPECT_EQ(2u, atlas.getAtlasImage().data[(b->rect.y + 1) * atlas.getAtlasImage().size.width + b->rect.x + 1]);
+}
+
+TEST(GlyphAtlas, NoBitmap) {
+    GlyphAtlas atlas;
+    auto space = makeMutable<Glyph>();
+    space->id = ' ';
+    EXPECT_FALSE(bool(atlas.addReference(fontStack, std::move(space))));
+}
+
+TEST(GlyphAtlas, GrowsUpToMaximumSize) {
+    GlyphAtlas atlas;
+    atlas.setMaximumSize(256);
+
+    // 32 pixels with padding: 64 glyphs fill 256 by 256 pixels.
+    for (GlyphID id = 0; id < 64; id++) {
+        EXPECT_TRUE(bool(atlas.addReference(fontStack, glyph(id, 30)))) << id;
+    }
+    EXPECT_EQ((Size { 256, 256 }), atlas.getPixelSize());
+
+    EXPECT_FALSE(bool(atlas.addReference(fontStack, glyph(64, 30))));
+    EXPECT_EQ((Size { 256, 256 }), atlas.getPixelSize());
+
+    // Glyphs larger than the maximum size are refused right away.
+    EXPECT_FALSE(bool(atlas.addReference(fontStack, glyph(65, 300))));
+    EXPECT_EQ((Size { 256, 256 }), atlas.getPixelSize());
+}
+
+TEST(GlyphAtlas, FullAtlasReusesReleasedSpace) {
+    GlyphAtlas atlas;
+    atlas.setMaximumSize(128);
+
+    optional<GlyphPosition> first;
+    for (GlyphID id = 0; id < 16; id++) {
+        const auto position = atlas.addReference(fontStack, glyph(id, 30));
+        ASSERT_TRUE(bool(position)) << id;
+        if (id == 0) {
+            first = position;
+        }
+    }
+
+    EXPECT_FALSE(bool(atlas.addReference(fontStack, glyph(16, 30))));
+    EXPECT_FALSE(bool(atlas.getPosition(fontStack, 16)));
+
+    // Once a tile releases a glyph, the refused one takes its place.
+    atlas.removeReference(fontStack, 0);
+    const auto replacement = atlas.addReference(fontStack, glyph(16, 30));
+    ASSERT_TRUE(bool(replacement));
+    EXPECT_EQ(first->rect, replacement->rect);
+    EXPECT_EQ((Size { 128, 128 }), atlas.getPixelSize());
+}
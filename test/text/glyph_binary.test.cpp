@@ -0,0 +1,32 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_binary.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(GlyphBinary, RoundTrip) {
+    const GlyphRange range { 0, 255 };
+    const auto glyphs = parseGlyphPBF(range, util::read_file("test/fixtures/resources/glyphs.pbf"));
+    ASSERT_FALSE(glyphs.empty());
+
+    const auto decoded = decodeGlyphs(range, encodeGlyphs(glyphs));
+    ASSERT_EQ(glyphs.size(), decoded.size());
+    for (std::size_t i = 0; i < glyphs.size(); ++i) {
+        EXPECT_EQ(glyphs[i].id, decoded[i].id);
+        EXPECT_EQ(glyphs[i].metrics, decoded[i].metrics);
+        EXPECT_EQ(glyphs[i].bitmap, decoded[i].bitmap);
+    }
+}
+
+TEST(GlyphBinary, Malformed) {
+    const GlyphRange range { 0, 255 };
+    const auto data = encodeGlyphs(parseGlyphPBF(range, util::read_file("test/fixtures/resources/glyphs.pbf")));
+
+    EXPECT_THROW(decodeGlyphs(range, ""), std::runtime_error);
+    EXPECT_THROW(decodeGlyphs(range, "not a glyph cache"), std::runtime_error);
+    EXPECT_THROW(decodeGlyphs(range, data.substr(0, data.size() - 1)), std::runtime_error);
+    EXPECT_THROW(decodeGlyphs(range, data + "x"), std::runtime_error);
+    EXPECT_THROW(decodeGlyphs(GlyphRange { 256, 511 }, data), std::runtime_error);
+}
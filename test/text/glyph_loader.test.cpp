@@ -25,7 +25,7 @@ public:
 
 class StubGlyphRequestor : public GlyphRequestor {
 public:
-    void onGlyphsAvailable(GlyphMap glyphs) override {
+    void onGlyphsAvailable(GlyphMap glyphs, GlyphPositions) override {
         if (glyphsAvailable) glyphsAvailable(std::move(glyphs));
     }
 
@@ -214,3 +214,82 @@ TEST(GlyphManager, LoadingInvalid) {
             {{{"Test Stack"}}, {u'A', u'E'}}
         });
 }
+
+TEST(GlyphManager, LoadingShared) {
+    GlyphManagerTest test;
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    GlyphMap loaded;
+    test.requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        loaded = std::move(glyphs);
+        test.end();
+    };
+
+    const GlyphDependencies dependencies {
+        {{{"Test Stack"}}, {u'a', u'å'}}
+    };
+    test.run("test/fixtures/resources/glyphs.pbf", dependencies);
+
+    // Another glyph manager picks up the parsed range without requesting it.
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        ADD_FAILURE() << "Should never be called";
+        return optional<Response>();
+    };
+
+    GlyphManager other { test.fileSource };
+    other.setURL("test/fixtures/resources/glyphs.pbf");
+
+    StubGlyphRequestor requestor;
+    bool available = false;
+    requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        const auto& testGlyphs = glyphs.at({{"Test Stack"}});
+        ASSERT_EQ(2u, testGlyphs.size());
+        EXPECT_EQ(&**loaded.at({{"Test Stack"}}).at(u'a'), &**testGlyphs.at(u'a'));
+        available = true;
+    };
+
+    other.getGlyphs(requestor, dependencies);
+    EXPECT_TRUE(available);
+}
+
+TEST(GlyphManager, Prefetch) {
+    GlyphManagerTest test;
+    test.glyphManager.setURL("test/fixtures/resources/glyphs.pbf");
+    test.glyphManager.setObserver(&test.observer);
+
+    unsigned requests = 0;
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    test.observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange& range) {
+        EXPECT_EQ(GlyphRange(0, 255), range);
+        test.end();
+    };
+
+    // Prefetching a range that is loading already doesn't request it again.
+    test.glyphManager.prefetchGlyphs({{"Test Stack"}}, {{ 0, 255 }});
+    test.glyphManager.prefetchGlyphs({{"Test Stack"}}, {{ 0, 255 }});
+    test.loop.run();
+    EXPECT_EQ(1u, requests);
+
+    // Tiles get the prefetched glyphs right away.
+    bool available = false;
+    test.requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        EXPECT_EQ(2u, glyphs.at({{"Test Stack"}}).size());
+        available = true;
+    };
+    test.glyphManager.getGlyphs(test.requestor, GlyphDependencies {
+        {{{"Test Stack"}}, {u'a', u'å'}}
+    });
+    EXPECT_TRUE(available);
+    EXPECT_EQ(1u, requests);
+}
@@ -0,0 +1,95 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/line_break_cache.hpp>
+#include <mbgl/text/shaping.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const FontStack fontStack { "Open Sans Regular" };
+
+LineBreakCache::Key key(std::u16string text) {
+    return { std::move(text), fontStack, 0, 240, WritingModeType::Horizontal };
+}
+
+Glyphs glyphs(const std::u16string& text) {
+    Glyphs result;
+    for (char16_t chr : text) {
+        auto glyph = makeMutable<Glyph>();
+        glyph->id = chr;
+        glyph->metrics.advance = 10;
+        result.emplace(chr, Immutable<Glyph>(std::move(glyph)));
+    }
+    return result;
+}
+
+Shaping shape(const std::u16string& text, BiDi& bidi, LineBreakCache& cache, const Glyphs& glyphMap) {
+    return getShaping(text, 240, 24, style::TextAnchorType::Center, style::TextJustifyType::Center,
+                      0, { 0, 0 }, 24, WritingModeType::Horizontal, bidi, &cache, fontStack, glyphMap);
+}
+
+} // namespace
+
+TEST(LineBreakCache, Get) {
+    LineBreakCache cache;
+    EXPECT_FALSE(cache.get(key(u"Main Street")));
+
+    cache.add(key(u"Main Street"), { u"Main", u"Street" });
+    auto lines = cache.get(key(u"Main Street"));
+    ASSERT_TRUE(bool(lines));
+    EXPECT_EQ((std::vector<std::u16string>{ u"Main", u"Street" }), *lines);
+
+    auto vertical = key(u"Main Street");
+    vertical.writingMode = WritingModeType::Vertical;
+    EXPECT_FALSE(cache.get(vertical));
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(1u, stats.size);
+}
+
+TEST(LineBreakCache, EvictsLeastRecentlyUsed) {
+    LineBreakCache cache(2);
+    cache.add(key(u"a"), { u"a" });
+    cache.add(key(u"b"), { u"b" });
+    EXPECT_TRUE(bool(cache.get(key(u"a"))));
+
+    cache.add(key(u"c"), { u"c" });
+    EXPECT_EQ(2u, cache.getStats().size);
+    EXPECT_TRUE(bool(cache.get(key(u"a"))));
+    EXPECT_FALSE(bool(cache.get(key(u"b"))));
+    EXPECT_TRUE(bool(cache.get(key(u"c"))));
+}
+
+TEST(LineBreakCache, Clear) {
+    LineBreakCache cache;
+    cache.add(key(u"Main Street"), { u"Main", u"Street" });
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStats().size);
+    EXPECT_FALSE(bool(cache.get(key(u"Main Street"))));
+
+    cache.add(key(u"Main Street"), { u"Main Street" });
+    EXPECT_TRUE(bool(cache.get(key(u"Main Street"))));
+}
+
+TEST(LineBreakCache, Shaping) {
+    BiDi bidi;
+    LineBreakCache cache;
+    const std::u16string text = u"Main Street";
+
+    // Lines broken without all the glyphs aren't cached.
+    shape(text, bidi, cache, glyphs(u"Main"));
+    EXPECT_EQ(0u, cache.getStats().size);
+
+    const Shaping first = shape(text, bidi, cache, glyphs(text));
+    EXPECT_EQ(1u, cache.getStats().size);
+
+    const Shaping second = shape(text, bidi, cache, glyphs(text));
+    EXPECT_EQ(1u, cache.getStats().hits);
+    ASSERT_EQ(first.positionedGlyphs.size(), second.positionedGlyphs.size());
+    EXPECT_EQ(first.right, second.right);
+    EXPECT_EQ(first.bottom, second.bottom);
+}
@@ -0,0 +1,114 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Draws U+4E2D as a filled square, and doesn't have any other glyph.
+class StubLocalGlyphRasterizer : public LocalGlyphRasterizer {
+protected:
+    optional<DrawnGlyph> drawGlyph(const FontStack&, GlyphID glyphID) override {
+        if (glyphID != u'中') {
+            return {};
+        }
+        DrawnGlyph glyph;
+        glyph.bitmap = AlphaImage({ 16, 16 });
+        std::fill(glyph.bitmap.data.get(), glyph.bitmap.data.get() + glyph.bitmap.bytes(), 255);
+        glyph.metrics.top = -4;
+        glyph.metrics.advance = 24;
+        return optional<DrawnGlyph>(std::move(glyph));
+    }
+};
+
+class StubGlyphRequestor : public GlyphRequestor {
+public:
+    void onGlyphsAvailable(GlyphMap glyphs, GlyphPositions) override {
+        if (glyphsAvailable) glyphsAvailable(std::move(glyphs));
+    }
+
+    std::function<void (GlyphMap)> glyphsAvailable;
+};
+
+} // namespace
+
+TEST(LocalGlyphRasterizer, CanRasterizeGlyph) {
+    EXPECT_TRUE(LocalGlyphRasterizer::canRasterizeGlyph(u'中'));
+    EXPECT_TRUE(LocalGlyphRasterizer::canRasterizeGlyph(u'あ'));
+    EXPECT_FALSE(LocalGlyphRasterizer::canRasterizeGlyph(u'a'));
+    EXPECT_FALSE(LocalGlyphRasterizer::canRasterizeGlyph(u'å'));
+}
+
+TEST(LocalGlyphRasterizer, SDF) {
+    AlphaImage coverage({ 8, 8 });
+    std::fill(coverage.data.get(), coverage.data.get() + coverage.bytes(), 0);
+    for (uint32_t y = 2; y < 6; y++) {
+        for (uint32_t x = 2; x < 6; x++) {
+            coverage.data[y * 8 + x] = 255;
+        }
+    }
+
+    const AlphaImage sdf = makeGlyphSDF(coverage);
+    ASSERT_EQ(Size(14, 14), sdf.size);
+
+    auto value = [&] (uint32_t x, uint32_t y) {
+        return sdf.data[(y + Glyph::borderSize) * sdf.size.width + x + Glyph::borderSize];
+    };
+
+    // The edge lies between the outermost covered pixels and their neighbors, at 191.
+    EXPECT_EQ(223, value(2, 2));
+    EXPECT_EQ(159, value(1, 2));
+    EXPECT_EQ(255, value(3, 3));
+    EXPECT_EQ(128, value(0, 2));
+    EXPECT_EQ(value(2, 3), value(3, 2));
+}
+
+TEST(LocalGlyphRasterizer, GlyphManager) {
+    util::RunLoop loop;
+    ThreadPool threadPool { 1 };
+    StubFileSource fileSource;
+    GlyphManager glyphManager { fileSource, {}, threadPool, std::make_unique<StubLocalGlyphRasterizer>() };
+    glyphManager.setURL("test/{range}");
+
+    std::vector<std::string> requested;
+    fileSource.glyphsResponse = [&] (const Resource& resource) {
+        requested.push_back(resource.url);
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    StubGlyphRequestor requestor;
+    requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        const auto& testGlyphs = glyphs.at({{"Test Stack"}});
+        ASSERT_EQ(3u, testGlyphs.size());
+        ASSERT_TRUE(bool(testGlyphs.at(u'a')));
+
+        // Rasterized locally, with a border.
+        ASSERT_TRUE(bool(testGlyphs.at(u'中')));
+        const Glyph& glyph = **testGlyphs.at(u'中');
+        EXPECT_EQ(16u, glyph.metrics.width);
+        EXPECT_EQ(24u, glyph.metrics.advance);
+        EXPECT_EQ(Size(22, 22), glyph.bitmap.size);
+
+        // Not in the local font, so it's downloaded, but the range doesn't have it either.
+        EXPECT_FALSE(bool(testGlyphs.at(u'一')));
+
+        loop.stop();
+    };
+
+    glyphManager.getGlyphs(requestor, GlyphDependencies {
+        {{{"Test Stack"}}, {u'a', u'中', u'一'}}
+    });
+    loop.run();
+
+    // The range of U+4E2D and U+4E00 is only downloaded for the glyph the rasterizer doesn't have.
+    EXPECT_EQ((std::vector<std::string> { "test/0-255", "test/19968-20223" }), requested);
+    glyphManager.removeRequestor(requestor);
+}
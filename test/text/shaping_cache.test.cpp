@@ -0,0 +1,78 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/shaping_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+ShapingCache::Key key(std::u16string text, FontStack fontStack = { "Open Sans Regular" }) {
+    return { std::move(text), std::move(fontStack), 240, 28.8f, style::TextAnchorType::Center,
+             style::TextJustifyType::Center, 0, { 0, 0 }, 24, WritingModeType::Horizontal };
+}
+
+Shaping shaping(float x) {
+    return Shaping(x, 0, WritingModeType::Horizontal);
+}
+
+} // namespace
+
+TEST(ShapingCache, Get) {
+    ShapingCache cache;
+    EXPECT_EQ(nullptr, cache.get(key(u"Main Street")));
+
+    cache.add(key(u"Main Street"), shaping(1));
+    ASSERT_NE(nullptr, cache.get(key(u"Main Street")));
+    EXPECT_EQ(1, cache.get(key(u"Main Street"))->left);
+
+    auto vertical = key(u"Main Street");
+    vertical.writingMode = WritingModeType::Vertical;
+    EXPECT_EQ(nullptr, cache.get(vertical));
+
+    cache.add(key(u"Main Street"), shaping(2));
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(2, cache.get(key(u"Main Street"))->left);
+}
+
+TEST(ShapingCache, EvictsLeastRecentlyUsed) {
+    ShapingCache cache(2);
+    cache.add(key(u"a"), shaping(1));
+    cache.add(key(u"b"), shaping(2));
+    EXPECT_NE(nullptr, cache.get(key(u"a")));
+
+    cache.add(key(u"c"), shaping(3));
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_NE(nullptr, cache.get(key(u"a")));
+    EXPECT_EQ(nullptr, cache.get(key(u"b")));
+    EXPECT_NE(nullptr, cache.get(key(u"c")));
+}
+
+TEST(ShapingCache, Invalidate) {
+    ShapingCache cache;
+    cache.add(key(u"a"), shaping(1));
+    cache.add(key(u"a", { "Open Sans Bold" }), shaping(2));
+
+    cache.invalidate({ "Open Sans Regular" });
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(nullptr, cache.get(key(u"a")));
+    EXPECT_NE(nullptr, cache.get(key(u"a", { "Open Sans Bold" })));
+
+    // Entries can be added again after invalidation.
+    cache.add(key(u"a"), shaping(3));
+    cache.add(key(u"b"), shaping(4));
+    EXPECT_EQ(3u, cache.size());
+}
+
+TEST(ShapingCache, Clear) {
+    ShapingCache cache;
+    cache.add(key(u"a"), shaping(1));
+    cache.add(key(u"b"), shaping(2));
+
+    EXPECT_LT(0u, cache.clear());
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(nullptr, cache.get(key(u"a")));
+    EXPECT_EQ(0u, cache.clear());
+
+    cache.add(key(u"a"), shaping(3));
+    EXPECT_EQ(3, cache.get(key(u"a"))->left);
+}
@@ -45,7 +45,9 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        0,
+        {}
     };
 };
 
@@ -67,7 +69,7 @@ TEST(AnnotationTile, Issue8289) {
 
     auto collisionTile = std::make_unique<CollisionTile>(PlacementConfig());
 
-    IndexedSubfeature subfeature { 0, "", "", 0 };
+    IndexedSubfeature subfeature { 0, 0, 0, 0 };
     CollisionFeature feature(GeometryCoordinates(), Anchor(0, 0, 0, 0), -5, 5, -5, 5, 1, 0, style::SymbolPlacementType::Point, subfeature, CollisionFeature::AlignmentType::Curved);
     collisionTile->insertFeature(feature, 0, true);
     collisionTile->placeFeature(feature, false, false);
@@ -75,8 +77,6 @@ TEST(AnnotationTile, Issue8289) {
     tile.onPlacement(GeometryTile::PlacementResult {
         std::unordered_map<std::string, std::shared_ptr<Bucket>>(),
         std::move(collisionTile),
-        {},
-        {},
         0
     });
 
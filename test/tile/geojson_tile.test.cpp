@@ -41,7 +41,9 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        0,
+        {}
     };
 };
 
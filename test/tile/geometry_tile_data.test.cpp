@@ -38,6 +38,34 @@ TEST(GeometryTileData, classifyRings2) {
     ASSERT_EQ(polygons[0].size(), 2u);
 }
 
+TEST(GeometryTileData, classifyRingsReused) {
+    std::vector<GeometryCollection> polygons;
+    classifyRings({
+      { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
+      { {10, 10}, {20, 10}, {20, 20}, {10, 10} },
+      { {50, 50}, {50, 60}, {60, 60}, {60, 50}, {50, 50} }
+    }, polygons);
+
+    ASSERT_EQ(polygons.size(), 2u);
+    ASSERT_EQ(polygons[0].size(), 2u);
+    ASSERT_EQ(polygons[1].size(), 1u);
+    const GeometryCoordinate* storage = polygons[0][0].data();
+
+    // Rings no larger than those before them are copied into their storage.
+    classifyRings({
+      { {0, 0}, {0, 20}, {20, 20}, {20, 0}, {0, 0} }
+    }, polygons);
+
+    ASSERT_EQ(polygons.size(), 1u);
+    ASSERT_EQ(polygons[0].size(), 1u);
+    EXPECT_EQ(storage, polygons[0][0].data());
+    EXPECT_EQ(GeometryCoordinate(0, 20), polygons[0][0][1]);
+
+    classifyRings({}, polygons);
+    ASSERT_EQ(polygons.size(), 1u);
+    EXPECT_TRUE(polygons[0].empty());
+}
+
 TEST(GeometryTileData, limitHoles1) {
     GeometryCollection polygon = {
       { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
@@ -105,3 +133,73 @@ TEST(GeometryTileData, limitHoles3) {
     ASSERT_EQ(original.at(3), polygon.at(2));
 
 }
+
+TEST(GeometryTileData, fixupPolygonsWellFormed) {
+    const GeometryCollection polygon {
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {10, 20}, {20, 20}, {10, 10} },
+      { {50, 50}, {60, 50}, {60, 60}, {50, 60}, {50, 50} }
+    };
+    ASSERT_GT(_signedArea(polygon[0]), 0);
+    ASSERT_LT(_signedArea(polygon[1]), 0);
+
+    const PolygonFixupCounts before = getPolygonFixupCounts();
+    EXPECT_EQ(polygon, fixupPolygons(polygon));
+
+    const PolygonFixupCounts after = getPolygonFixupCounts();
+    EXPECT_EQ(before.polygons + 1, after.polygons);
+    EXPECT_EQ(before.fixed, after.fixed);
+}
+
+TEST(GeometryTileData, fixupPolygonsMiswound) {
+    // The hole is wound like an exterior ring.
+    const GeometryCollection polygon {
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {20, 10}, {20, 20}, {10, 10} }
+    };
+
+    const PolygonFixupCounts before = getPolygonFixupCounts();
+    const GeometryCollection fixed = fixupPolygons(polygon);
+    EXPECT_EQ(before.fixed + 1, getPolygonFixupCounts().fixed);
+
+    // An exterior ring and a hole, wound opposite to each other.
+    ASSERT_EQ(2u, fixed.size());
+    EXPECT_LT(_signedArea(fixed[0]) * _signedArea(fixed[1]), 0);
+}
+
+TEST(GeometryTileData, simplifyGeometriesLine) {
+    GeometryCollection line {
+      { {0, 0}, {10, 1}, {20, 0}, {30, 10}, {30, 20} }
+    };
+
+    // Points within the tolerance of the simplified line are dropped.
+    simplifyGeometries(line, FeatureType::LineString, 2);
+    EXPECT_EQ((GeometryCollection { { {0, 0}, {20, 0}, {30, 10}, {30, 20} } }), line);
+
+    // Nothing changes without a tolerance.
+    GeometryCollection unchanged {
+      { {0, 0}, {10, 1}, {20, 0} }
+    };
+    simplifyGeometries(unchanged, FeatureType::LineString, 0);
+    EXPECT_EQ((GeometryCollection { { {0, 0}, {10, 1}, {20, 0} } }), unchanged);
+
+    // Points aren't simplified.
+    GeometryCollection points { { {0, 0}, {1, 0}, {2, 0} } };
+    simplifyGeometries(points, FeatureType::Point, 10);
+    EXPECT_EQ(3u, points[0].size());
+}
+
+TEST(GeometryTileData, simplifyGeometriesPolygon) {
+    GeometryCollection polygon {
+      { {0, 0}, {20, 1}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {11, 10}, {11, 11}, {10, 10} }
+    };
+
+    simplifyGeometries(polygon, FeatureType::Polygon, 2);
+
+    // Rings that would collapse are kept.
+    EXPECT_EQ((GeometryCollection {
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {11, 10}, {11, 11}, {10, 10} }
+    }), polygon);
+}
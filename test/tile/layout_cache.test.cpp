@@ -0,0 +1,77 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/layout_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+LayoutCache::Key key(const OverscaledTileID& id, std::size_t dataHash = 1) {
+    return { id, dataHash, "[3,\"source\",\"water\"]", { "water" }, false, 0 };
+}
+
+LayoutCache::Layout layout(std::size_t bytes) {
+    auto bucket = std::make_shared<TileSnapshot::SerializedBucket>();
+    bucket->data = std::string(bytes, '\0');
+    return { bucket, std::make_shared<LayoutCache::IndexedRings>() };
+}
+
+} // namespace
+
+TEST(LayoutCache, Disabled) {
+    LayoutCache cache;
+    EXPECT_FALSE(cache.isEnabled());
+
+    cache.add(key({ 1, 0, 0 }), layout(10));
+    EXPECT_FALSE(cache.get(key({ 1, 0, 0 })));
+    EXPECT_EQ(0u, cache.getStats().size);
+}
+
+TEST(LayoutCache, Get) {
+    LayoutCache cache;
+    cache.setMaximumSize(1024 * 1024);
+    ASSERT_TRUE(cache.isEnabled());
+
+    const OverscaledTileID id { 1, 0, 0 };
+    cache.add(key(id), layout(10));
+    ASSERT_TRUE(cache.get(key(id)));
+    EXPECT_EQ(10u, cache.get(key(id))->bucket->data.size());
+
+    // Wrapped copies of a tile share the layout; other data and layouts don't.
+    EXPECT_TRUE(cache.get(key({ 1, 1, 1, 0, 0 })));
+    EXPECT_FALSE(cache.get(key(id, 2)));
+    EXPECT_FALSE(cache.get(key({ 1, 0, 1 })));
+    auto other = key(id);
+    other.layerIDs.push_back("water-outline");
+    EXPECT_FALSE(cache.get(other));
+
+    const LayoutCache::Stats stats = cache.getStats();
+    EXPECT_EQ(3u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(1u, stats.size);
+}
+
+TEST(LayoutCache, Evict) {
+    LayoutCache cache;
+    cache.setMaximumSize(2500);
+
+    cache.add(key({ 1, 0, 0 }), layout(1000));
+    cache.add(key({ 1, 0, 1 }), layout(1000));
+
+    // Using a layout makes it the most recently used.
+    EXPECT_TRUE(cache.get(key({ 1, 0, 0 })));
+    cache.add(key({ 1, 1, 0 }), layout(1000));
+    EXPECT_TRUE(cache.get(key({ 1, 0, 0 })));
+    EXPECT_FALSE(cache.get(key({ 1, 0, 1 })));
+    EXPECT_TRUE(cache.get(key({ 1, 1, 0 })));
+    EXPECT_LE(cache.getStats().bytes, 2500u);
+
+    // Layouts larger than the cache aren't kept.
+    cache.add(key({ 1, 1, 1 }), layout(3000));
+    EXPECT_FALSE(cache.get(key({ 1, 1, 1 })));
+    EXPECT_EQ(2u, cache.getStats().size);
+
+    cache.setMaximumSize(0);
+    EXPECT_EQ(0u, cache.getStats().size);
+    EXPECT_EQ(0u, cache.getStats().bytes);
+}
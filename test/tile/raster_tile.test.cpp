@@ -37,13 +37,15 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        0,
+        {}
     };
 };
 
 TEST(RasterTile, setError) {
     RasterTileTest test;
-    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset);
+    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset, 512, SourceType::Raster);
     tile.setError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_FALSE(tile.isRenderable());
     EXPECT_TRUE(tile.isLoaded());
@@ -52,7 +54,7 @@ TEST(RasterTile, setError) {
 
 TEST(RasterTile, onError) {
     RasterTileTest test;
-    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset);
+    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset, 512, SourceType::Raster);
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_FALSE(tile.isRenderable());
     EXPECT_TRUE(tile.isLoaded());
@@ -61,7 +63,7 @@ TEST(RasterTile, onError) {
 
 TEST(RasterTile, onParsed) {
     RasterTileTest test;
-    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset);
+    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset, 512, SourceType::Raster);
     tile.onParsed(std::make_unique<RasterBucket>(PremultipliedImage{}));
     EXPECT_TRUE(tile.isRenderable());
     EXPECT_TRUE(tile.isLoaded());
@@ -70,7 +72,7 @@ TEST(RasterTile, onParsed) {
 
 TEST(RasterTile, onParsedEmpty) {
     RasterTileTest test;
-    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset);
+    RasterTile tile(OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset, 512, SourceType::Raster);
     tile.onParsed(nullptr);
     EXPECT_FALSE(tile.isRenderable());
     EXPECT_TRUE(tile.isLoaded());
@@ -0,0 +1,95 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/tile_cache.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, std::size_t cpu_, std::size_t gpu_ = 0)
+        : Tile(id_) {
+        memory.cpu = cpu_;
+        memory.gpu = gpu_;
+        renderable = true;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    void upload(gl::Context&) override {}
+    Bucket* getBucket(const style::Layer::Impl&) const override { return nullptr; }
+
+    RendererStatistics::Memory memoryUsage() const override { return memory; }
+
+    RendererStatistics::Memory memory;
+};
+
+std::unique_ptr<Tile> tile(uint8_t x, std::size_t cpu, std::size_t gpu = 0) {
+    return std::make_unique<StubTile>(OverscaledTileID { 1, x, 0 }, cpu, gpu);
+}
+
+} // namespace
+
+TEST(TileCache, EvictsByBytes) {
+    const std::size_t mb = 1024 * 1024;
+    TileCache cache(8 * mb);
+
+    cache.add(OverscaledTileID { 1, 0, 0 }, tile(0, 4 * mb));
+    cache.add(OverscaledTileID { 1, 1, 0 }, tile(1, 1 * mb));
+    cache.add(OverscaledTileID { 1, 0, 1 }, tile(0, 1 * mb));
+    EXPECT_TRUE(cache.has(OverscaledTileID { 1, 0, 0 }));
+    EXPECT_GE(cache.getByteSize(), 6 * mb);
+
+    // A large tile evicts the least recently used tiles until the cache fits its budget.
+    cache.add(OverscaledTileID { 1, 1, 1 }, tile(1, 4 * mb));
+    EXPECT_FALSE(cache.has(OverscaledTileID { 1, 0, 0 }));
+    EXPECT_TRUE(cache.has(OverscaledTileID { 1, 1, 0 }));
+    EXPECT_TRUE(cache.has(OverscaledTileID { 1, 0, 1 }));
+    EXPECT_TRUE(cache.has(OverscaledTileID { 1, 1, 1 }));
+    EXPECT_LE(cache.getByteSize(), 8 * mb);
+
+    // Retrieving a tile removes it and its bytes.
+    auto retrieved = cache.get(OverscaledTileID { 1, 1, 1 });
+    ASSERT_TRUE(bool(retrieved));
+    EXPECT_FALSE(cache.has(OverscaledTileID { 1, 1, 1 }));
+    EXPECT_LT(cache.getByteSize(), 4 * mb);
+
+    // Shrinking the budget evicts immediately.
+    cache.setSize(1 * mb);
+    EXPECT_LE(cache.getByteSize(), 1 * mb);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getByteSize());
+}
+
+TEST(TileCache, EmptyTilesAreBounded) {
+    TileCache cache(48 * 1024);
+    for (uint8_t x = 0; x < 2; x++) {
+        for (uint32_t y = 0; y < 2; y++) {
+            cache.add(OverscaledTileID { 1, x, y }, tile(x, 0));
+        }
+    }
+    EXPECT_LE(cache.getByteSize(), 48u * 1024);
+    EXPECT_FALSE(cache.has(OverscaledTileID { 1, 0, 0 }));
+}
+
+TEST(TileCache, MemoryUsage) {
+    const std::size_t mb = 1024 * 1024;
+    TileCache cache(8 * mb);
+
+    // The budget covers both CPU and GPU memory.
+    cache.add(OverscaledTileID { 1, 0, 0 }, tile(0, 1 * mb, 2 * mb));
+    cache.add(OverscaledTileID { 1, 1, 0 }, tile(1, 1 * mb));
+    EXPECT_EQ(2 * mb, cache.getMemoryUsage().cpu);
+    EXPECT_EQ(2 * mb, cache.getMemoryUsage().gpu);
+    EXPECT_GE(cache.getByteSize(), 4 * mb);
+
+    cache.add(OverscaledTileID { 1, 0, 1 }, tile(0, 2 * mb, 3 * mb));
+    EXPECT_FALSE(cache.has(OverscaledTileID { 1, 0, 0 }));
+    EXPECT_EQ(3 * mb, cache.getMemoryUsage().cpu);
+    EXPECT_EQ(3 * mb, cache.getMemoryUsage().gpu);
+}
@@ -2,11 +2,13 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
@@ -15,7 +17,13 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/tile_upload_queue.hpp>
+#include <mbgl/gl/context.hpp>
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <mapbox/vector_tile.hpp>
 
 #include <memory>
 
@@ -43,7 +51,9 @@ public:
         annotationManager,
         imageManager,
         glyphManager,
-        0
+        0,
+        0,
+        {}
     };
 };
 
@@ -84,8 +94,6 @@ TEST(VectorTile, Issue7615) {
             symbolBucket
         }},
         nullptr,
-        {},
-        {},
         0
     });
 
@@ -100,11 +108,366 @@ TEST(VectorTile, Issue7615) {
     EXPECT_EQ(symbolBucket.get(), tile.getBucket(*symbolLayer.baseImpl));
 }
 
+TEST(VectorTile, PartialPlacement) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, test.tileset);
+    tile.setPlacementConfig({});
+
+    style::SymbolLayer symbolLayer("symbol", "source");
+    auto symbolBucket = std::make_shared<SymbolBucket>(
+        style::SymbolLayoutProperties::PossiblyEvaluated(),
+        std::map<
+            std::string,
+            std::pair<style::IconPaintProperties::PossiblyEvaluated, style::TextPaintProperties::PossiblyEvaluated>>(),
+        16.0f, 1.0f, 0.0f, false, false);
+
+    // The symbols placed within the budget are shown while the rest are placed.
+    tile.onPlacement(GeometryTile::PlacementResult {
+        {{ symbolLayer.getID(), symbolBucket }},
+        nullptr,
+        1,
+        {},
+        false
+    });
+    EXPECT_TRUE(tile.isRenderable());
+    EXPECT_FALSE(tile.isComplete());
+    EXPECT_EQ(symbolBucket.get(), tile.getBucket(*symbolLayer.baseImpl));
+
+    tile.onPlacement(GeometryTile::PlacementResult {
+        {{ symbolLayer.getID(), symbolBucket }},
+        nullptr,
+        1
+    });
+    EXPECT_TRUE(tile.isComplete());
+}
+
 TEST(VectorTile, Issue8542) {
     VectorTileTest test;
     VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, test.tileset);
 
     // Query before data is set
-    std::vector<Feature> result;
-    tile.querySourceFeatures(result, { { {"layer"} }, {} });
+    std::size_t count = 0;
+    tile.querySourceFeatures({}, { { {"layer"} }, {} }, [&] (Feature&&) { count++; });
+    EXPECT_EQ(0u, count);
+}
+
+namespace {
+
+// Records what a TileLoader hands to its tile.
+class LoaderTestTile {
+public:
+    void setTriedOptional() {}
+    void setError(std::exception_ptr) { errors++; }
+    void setData(std::shared_ptr<const std::string>, optional<Timestamp>, optional<Timestamp> expires_) {
+        dataCount++;
+        expires = expires_;
+    }
+    void setExpiration(optional<Timestamp>, optional<Timestamp> expires_) {
+        expires = expires_;
+    }
+
+    int dataCount = 0;
+    int errors = 0;
+    optional<Timestamp> expires;
+};
+
+} // namespace
+
+TEST(VectorTile, RevalidatedDataIsNotReparsed) {
+    VectorTileTest test;
+    LoaderTestTile tile;
+    TileLoader<LoaderTestTile> loader(tile, OverscaledTileID(0, 0, 0), test.tileParameters, test.tileset);
+    loader.setNecessity(Resource::Required);
+
+    Response response;
+    response.data = std::make_shared<std::string>("tile");
+    response.expires = Timestamp{ Seconds(1) };
+    ASSERT_TRUE(test.fileSource.respond(Resource::Tile, response));
+    EXPECT_EQ(1, tile.dataCount);
+
+    // A 304 only moves the expiration; the tile keeps the data it has.
+    Response notModified;
+    notModified.notModified = true;
+    notModified.expires = Timestamp{ Seconds(2) };
+    ASSERT_TRUE(test.fileSource.respond(Resource::Tile, notModified));
+    EXPECT_EQ(1, tile.dataCount);
+    EXPECT_EQ(Timestamp{ Seconds(2) }, *tile.expires);
+
+    // So does receiving the same data again.
+    Response unchanged;
+    unchanged.data = std::make_shared<std::string>("tile");
+    unchanged.expires = Timestamp{ Seconds(3) };
+    ASSERT_TRUE(test.fileSource.respond(Resource::Tile, unchanged));
+    EXPECT_EQ(1, tile.dataCount);
+    EXPECT_EQ(Timestamp{ Seconds(3) }, *tile.expires);
+
+    // Changed data goes to the tile.
+    Response changed;
+    changed.data = std::make_shared<std::string>("new tile");
+    ASSERT_TRUE(test.fileSource.respond(Resource::Tile, changed));
+    EXPECT_EQ(2, tile.dataCount);
+    EXPECT_EQ(0, tile.errors);
+}
+
+namespace {
+
+class UploadTestBucket : public Bucket {
+public:
+    void upload(gl::Context&) override {
+        uploaded = true;
+    }
+
+    bool hasData() const override {
+        return true;
+    }
+
+    RendererStatistics::Memory memoryUsage() const override {
+        RendererStatistics::Memory memory;
+        memory.cpu = 100;
+        return memory;
+    }
+};
+
+} // namespace
+
+TEST(VectorTile, UploadQueue) {
+    VectorTileTest test;
+    TileUploadQueue uploadQueue;
+    uploadQueue.setBudget(150);
+
+    const TileParameters tileParameters {
+        1.0,
+        MapDebugOptions(),
+        test.transformState,
+        test.threadPool,
+        test.fileSource,
+        MapMode::Continuous,
+        test.annotationManager,
+        test.imageManager,
+        test.glyphManager,
+        0,
+        0,
+        {},
+        nullptr,
+        &uploadQueue
+    };
+
+    VectorTile far(OverscaledTileID(1, 0, 0), "source", tileParameters, test.tileset);
+    VectorTile near(OverscaledTileID(1, 1, 1), "source", tileParameters, test.tileset);
+    far.setPriority(0);
+    near.setPriority(1);
+
+    auto layout = [] () {
+        std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets {
+            { "layer", std::make_shared<UploadTestBucket>() }
+        };
+        return GeometryTile::LayoutResult(std::move(buckets), std::make_unique<FeatureIndex>(), nullptr, 0);
+    };
+    far.onLayout(layout());
+    near.onLayout(layout());
+
+    // Laid out tiles wait for their first upload before they can be rendered.
+    EXPECT_TRUE(far.isLoaded());
+    EXPECT_FALSE(far.isRenderable());
+    EXPECT_FALSE(near.isRenderable());
+
+    // Only one of them fits into a frame's budget; the one nearer to the center goes first.
+    gl::Context context;
+    uploadQueue.upload(context, false);
+    EXPECT_FALSE(far.isRenderable());
+    EXPECT_TRUE(near.isRenderable());
+
+    uploadQueue.upload(context, false);
+    EXPECT_TRUE(far.isRenderable());
+    EXPECT_TRUE(uploadQueue.empty());
+
+    // New layouts of renderable tiles are used right away.
+    near.onLayout(layout());
+    EXPECT_TRUE(near.isRenderable());
+    EXPECT_TRUE(uploadQueue.empty());
+}
+
+namespace {
+
+class RepaintTestBucket : public UploadTestBucket {
+public:
+    Bucket* painted = nullptr;
+
+protected:
+    void swapPaint(Bucket& painted_, gl::Context&) override {
+        painted = &painted_;
+    }
+};
+
+} // namespace
+
+TEST(VectorTile, Repaint) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, test.tileset);
+
+    auto bucket = std::make_shared<RepaintTestBucket>();
+    std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets {
+        { "layer", bucket },
+        { "layer-2", bucket }
+    };
+    tile.onLayout(GeometryTile::LayoutResult(std::move(buckets), std::make_unique<FeatureIndex>(), nullptr, 0));
+
+    gl::Context context;
+    tile.upload(context);
+    EXPECT_FALSE(bucket->needsUpload());
+
+    // Layers that share a bucket share the repainted one too; the bucket keeps its geometry.
+    auto painted = std::make_shared<RepaintTestBucket>();
+    tile.onRepaint({ { { "layer", painted }, { "layer-2", painted }, { "other", painted } }, 0, true });
+    EXPECT_EQ(bucket.get(), tile.getBucket(*style::FillLayer("layer", "source").baseImpl));
+    EXPECT_TRUE(bucket->needsPaintUpload());
+    EXPECT_FALSE(bucket->needsUpload());
+
+    tile.upload(context);
+    EXPECT_EQ(painted.get(), bucket->painted);
+    EXPECT_FALSE(bucket->needsPaintUpload());
+    EXPECT_TRUE(tile.isComplete());
+}
+
+TEST(VectorTile, RelayoutReusesUnchangedBuckets) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(10, 163, 395), "source", test.tileParameters, test.tileset);
+    tile.setPlacementConfig({});
+    tile.setData(std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")), {}, {});
+
+    style::FillLayer water("water", "source");
+    water.setSourceLayer("water");
+    style::FillLayer landuse("landuse", "source");
+    landuse.setSourceLayer("landuse");
+
+    tile.setLayers({ water.baseImpl, landuse.baseImpl });
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+    Bucket* waterBucket = tile.getBucket(*water.baseImpl);
+    Bucket* landuseBucket = tile.getBucket(*landuse.baseImpl);
+    ASSERT_NE(nullptr, waterBucket);
+    ASSERT_NE(nullptr, landuseBucket);
+
+    // Only the layer that changed is laid out again.
+    landuse.setFilter(style::HasFilter { "class" });
+    tile.setLayers({ water.baseImpl, landuse.baseImpl });
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+    EXPECT_EQ(waterBucket, tile.getBucket(*water.baseImpl));
+    EXPECT_NE(landuseBucket, tile.getBucket(*landuse.baseImpl));
+}
+
+TEST(VectorTileData, Properties) {
+    // Property access through the layer's key and value tables matches mapbox::vector_tile.
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    VectorTileData tile(data);
+    mapbox::vector_tile::buffer buffer(*data);
+
+    for (const auto& name : tile.layerNames()) {
+        auto layer = tile.getLayer(name);
+        ASSERT_TRUE(bool(layer));
+        const mapbox::vector_tile::layer expectedLayer(buffer.getLayers().at(name));
+        ASSERT_EQ(expectedLayer.featureCount(), layer->featureCount());
+
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            const mapbox::vector_tile::feature expected(expectedLayer.getFeature(i), expectedLayer);
+            auto feature = layer->getFeature(i);
+
+            const auto properties = feature->getProperties();
+            EXPECT_EQ(expected.getProperties(), properties);
+            for (const auto& property : properties) {
+                EXPECT_EQ(expected.getValue(property.first), feature->getValue(property.first));
+            }
+            EXPECT_FALSE(bool(feature->getValue("nonexistent")));
+        }
+    }
+}
+
+TEST(VectorTileData, Geometries) {
+    // Geometries decode to the same rings as with mapbox::vector_tile.
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    VectorTileData tile(data);
+    mapbox::vector_tile::buffer buffer(*data);
+
+    for (const auto& name : tile.layerNames()) {
+        auto layer = tile.getLayer(name);
+        ASSERT_TRUE(bool(layer));
+        const mapbox::vector_tile::layer expectedLayer(buffer.getLayers().at(name));
+        ASSERT_EQ(expectedLayer.featureCount(), layer->featureCount());
+
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            const mapbox::vector_tile::feature expected(expectedLayer.getFeature(i), expectedLayer);
+            const float scale = float(util::EXTENT) / expected.getExtent();
+            auto geometries = expected.getGeometries<GeometryCollection>(scale);
+            if (expected.getVersion() < 2 && expected.getType() == mapbox::vector_tile::GeomType::POLYGON) {
+                geometries = fixupPolygons(geometries);
+            }
+            EXPECT_EQ(geometries, layer->getFeature(i)->getGeometries());
+        }
+    }
+}
+
+TEST(VectorTileData, ReleaseParsed) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    VectorTileData tile(data);
+    const std::string name = tile.layerNames().front();
+
+    auto layer = tile.getLayer(name);
+    ASSERT_TRUE(bool(layer));
+    const std::size_t featureCount = layer->featureCount();
+
+    // Layers in use are kept.
+    EXPECT_EQ(0u, tile.releaseParsed());
+
+    layer.reset();
+    EXPECT_LT(0u, tile.releaseParsed());
+    EXPECT_EQ(0u, tile.releaseParsed());
+
+    // Released layers are parsed again when they're next needed.
+    layer = tile.getLayer(name);
+    ASSERT_TRUE(bool(layer));
+    EXPECT_EQ(featureCount, layer->featureCount());
+}
+
+TEST(VectorTileData, SharedGeometries) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    auto parsed = std::make_shared<const ParsedVectorTile>(data);
+    VectorTileData z17(parsed, true);
+    VectorTileData z18(parsed, true);
+    const std::string name = z17.layerNames().front();
+
+    auto layer17 = z17.getLayer(name);
+    auto layer18 = z18.getLayer(name);
+    ASSERT_TRUE(bool(layer17));
+    ASSERT_LT(0u, layer17->featureCount());
+
+    // Tiles sharing the parsed tile decode each feature's geometries once.
+    auto feature17 = layer17->getFeature(0);
+    auto feature18 = layer18->getFeature(0);
+    ASSERT_NE(nullptr, feature17->getSharedGeometries());
+    EXPECT_EQ(feature17->getSharedGeometries(), feature18->getSharedGeometries());
+    EXPECT_EQ(*feature17->getSharedGeometries(), feature18->getGeometries());
+
+    // Tiles that don't keep geometries decode them on every call.
+    VectorTileData z16(parsed);
+    auto feature16 = z16.getLayer(name)->getFeature(0);
+    EXPECT_EQ(nullptr, feature16->getSharedGeometries());
+    EXPECT_EQ(*feature17->getSharedGeometries(), feature16->getGeometries());
+}
+
+TEST(VectorTileData, ReleaseUnusedLayers) {
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+    VectorTileData tile(data);
+    const std::vector<std::string> names = tile.layerNames();
+    ASSERT_LT(1u, names.size());
+
+    EXPECT_TRUE(bool(tile.getLayer(names[0])));
+    EXPECT_TRUE(bool(tile.getLayer(names[1])));
+
+    // Layers the style uses stay parsed.
+    EXPECT_LT(0u, tile.releaseUnusedLayers({ names[0] }));
+    EXPECT_EQ(0u, tile.releaseUnusedLayers({ names[0] }));
+    EXPECT_LT(0u, tile.releaseParsed());
 }
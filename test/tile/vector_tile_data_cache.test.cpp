@@ -0,0 +1,98 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data_cache.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+std::shared_ptr<const std::string> tileData() {
+    return std::make_shared<const std::string>(util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+}
+
+} // namespace
+
+TEST(VectorTileDataCache, SharesParse) {
+    VectorTileDataCache cache(16 * 1024 * 1024);
+    const std::string url = "mapbox://tiles/{z}/{x}/{y}.vector.pbf";
+
+    // Identical data for the same tile, loaded separately, shares a single parse.
+    auto a = cache.get(url, { 10, 163, 395 }, tileData());
+    auto b = cache.get(url, { 10, 163, 395 }, tileData());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a->getData()->size(), cache.getSize());
+
+    // Layers are parsed once and shared.
+    EXPECT_EQ(a->getLayer("road"), b->getLayer("road"));
+    EXPECT_FALSE(bool(a->getLayer("nonexistent")));
+
+    // Other tilesets and tiles are distinct.
+    EXPECT_NE(a, cache.get("mapbox://other/{z}/{x}/{y}.vector.pbf", { 10, 163, 395 }, tileData()));
+    EXPECT_NE(a, cache.get(url, { 10, 163, 396 }, tileData()));
+}
+
+TEST(VectorTileDataCache, ReplacesChangedData) {
+    VectorTileDataCache cache(16 * 1024 * 1024);
+    const std::string url = "mapbox://tiles/{z}/{x}/{y}.vector.pbf";
+
+    auto a = cache.get(url, { 0, 0, 0 }, tileData());
+    auto b = cache.get(url, { 0, 0, 0 }, std::make_shared<const std::string>(util::read_file("test/fixtures/api/assets/streets/0-0-0.vector.pbf")));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(b, cache.get(url, { 0, 0, 0 }, b->getData()));
+    EXPECT_EQ(b->getData()->size(), cache.getSize());
+}
+
+TEST(VectorTileDataCache, Evicts) {
+    const auto data = tileData();
+    VectorTileDataCache cache(data->size() * 2);
+    const std::string url = "mapbox://tiles/{z}/{x}/{y}.vector.pbf";
+
+    auto a = cache.get(url, { 10, 0, 0 }, data);
+    cache.get(url, { 10, 0, 1 }, data);
+    EXPECT_EQ(a, cache.get(url, { 10, 0, 0 }, data));
+
+    // Adding a third tile evicts the least recently used one.
+    cache.get(url, { 10, 0, 2 }, data);
+    EXPECT_EQ(data->size() * 2, cache.getSize());
+    EXPECT_EQ(a, cache.get(url, { 10, 0, 0 }, data));
+    EXPECT_EQ(data->size() * 2, cache.getSize());
+
+    cache.setMaximumSize(0);
+    EXPECT_EQ(0u, cache.getSize());
+
+    // Tiles larger than the budget are parsed but not cached.
+    EXPECT_NE(cache.get(url, { 10, 0, 0 }, data), cache.get(url, { 10, 0, 0 }, data));
+    EXPECT_EQ(0u, cache.getSize());
+
+    cache.setMaximumSize(data->size());
+    cache.get(url, { 10, 0, 0 }, data);
+    cache.clear();
+    EXPECT_EQ(0u, cache.getSize());
+}
+
+TEST(VectorTileDataCache, MeasuresParsedLayers) {
+    const auto data = tileData();
+    VectorTileDataCache cache(data->size() * 2);
+    const std::string url = "mapbox://tiles/{z}/{x}/{y}.vector.pbf";
+
+    auto a = cache.get(url, { 10, 0, 0 }, data);
+    EXPECT_EQ(data->size(), cache.getSize());
+
+    // Layers parsed and geometries decoded after the tile was cached count towards its size.
+    auto layer = VectorTileData(a, true).getLayer("road");
+    ASSERT_TRUE(bool(layer));
+    const std::size_t parsed = cache.getSize();
+    EXPECT_LT(data->size(), parsed);
+    ASSERT_NE(nullptr, layer->getFeature(0)->getSharedGeometries());
+    EXPECT_LT(parsed, cache.getSize());
+    EXPECT_EQ(a->byteSize(), cache.getSize());
+
+    // The grown tile leaves no room for another one.
+    cache.get(url, { 10, 0, 1 }, data);
+    EXPECT_EQ(data->size(), cache.getSize());
+    EXPECT_NE(a, cache.get(url, { 10, 0, 0 }, data));
+}
@@ -0,0 +1,82 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compressed_image.hpp>
+
+#include <cstring>
+
+using namespace mbgl;
+
+namespace {
+
+void appendUint32(std::string& data, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        data.push_back(char((value >> (8 * i)) & 0xFF));
+    }
+}
+
+std::string ktx(uint32_t internalFormat, uint32_t width, uint32_t height, uint32_t imageSize) {
+    std::string data("\xABKTX 11\xBB\r\n\x1A\n", 12);
+    for (uint32_t value : { 0x04030201u, 0u, 1u, 0u, internalFormat, 0x1908u, width, height, 0u, 0u, 1u, 1u, 4u }) {
+        appendUint32(data, value);
+    }
+    data.append(4, '\0'); // Key/value data.
+    appendUint32(data, imageSize);
+    data.append(imageSize, '\x55');
+    return data;
+}
+
+std::string dds(const char* fourCC, uint32_t width, uint32_t height, std::size_t imageSize) {
+    std::string data("DDS ");
+    appendUint32(data, 124);
+    appendUint32(data, 0);
+    appendUint32(data, height);
+    appendUint32(data, width);
+    data.resize(80, '\0');
+    appendUint32(data, 0x4);
+    data.append(fourCC, 4);
+    data.resize(128, '\0');
+    data.append(imageSize, '\x55');
+    return data;
+}
+
+} // namespace
+
+TEST(CompressedImage, Bytes) {
+    EXPECT_EQ(8u, CompressedImage::bytes({ 4, 4 }, CompressedImageFormat::ETC2_RGB8));
+    EXPECT_EQ(32u, CompressedImage::bytes({ 5, 5 }, CompressedImageFormat::S3TC_DXT1_RGB));
+    EXPECT_EQ(256u * 256u, CompressedImage::bytes({ 256, 256 }, CompressedImageFormat::ETC2_RGBA8));
+    EXPECT_EQ(16u, CompressedImage::bytes({ 8, 8 }, CompressedImageFormat::ASTC_8x8_RGBA));
+}
+
+TEST(CompressedImage, KTX) {
+    const std::string data = ktx(0x9274, 8, 8, 32);
+    ASSERT_TRUE(isCompressedImage(data));
+
+    const CompressedImage image = decodeCompressedImage(data);
+    EXPECT_EQ(Size(8, 8), image.size);
+    EXPECT_EQ(CompressedImageFormat::ETC2_RGB8, image.format);
+    ASSERT_EQ(32u, image.bytes());
+    EXPECT_EQ(0x55, image.data[0]);
+    EXPECT_EQ(0x55, image.data[31]);
+
+    EXPECT_THROW(decodeCompressedImage(ktx(0x9274, 8, 8, 16)), std::runtime_error);
+    EXPECT_THROW(decodeCompressedImage(ktx(0x1908, 8, 8, 256)), std::runtime_error);
+    EXPECT_THROW(decodeCompressedImage(data.substr(0, data.size() - 1)), std::runtime_error);
+}
+
+TEST(CompressedImage, DDS) {
+    const std::string data = dds("DXT5", 4, 8, 32);
+    ASSERT_TRUE(isCompressedImage(data));
+
+    const CompressedImage image = decodeCompressedImage(data);
+    EXPECT_EQ(Size(4, 8), image.size);
+    EXPECT_EQ(CompressedImageFormat::S3TC_DXT5_RGBA, image.format);
+
+    EXPECT_THROW(decodeCompressedImage(dds("DXT3", 4, 8, 32)), std::runtime_error);
+    EXPECT_THROW(decodeCompressedImage(dds("DXT1", 4, 8, 8)), std::runtime_error);
+}
+
+TEST(CompressedImage, Other) {
+    EXPECT_FALSE(isCompressedImage("\x89PNG\r\n\x1A\n"));
+    EXPECT_THROW(decodeCompressedImage("\x89PNG\r\n\x1A\n"), std::runtime_error);
+}
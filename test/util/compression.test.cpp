@@ -0,0 +1,30 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+TEST(Compression, RoundTrip) {
+    std::mt19937 generator(1);
+    std::string incompressible(100000, '\0');
+    for (auto& c : incompressible) {
+        c = char(generator());
+    }
+
+    // Highly compressible data inflates to many times the size of its input, so
+    // decompression has to grow its output repeatedly.
+    for (const std::string& raw : { std::string(), std::string("Hello World!"),
+                                    std::string(1000000, 'a'), incompressible }) {
+        const std::string compressed = util::compress(raw);
+        EXPECT_EQ(raw, util::decompress(compressed));
+    }
+}
+
+TEST(Compression, Invalid) {
+    EXPECT_ANY_THROW(util::decompress("not compressed"));
+
+    const std::string truncated = util::compress(std::string(10000, 'a'));
+    EXPECT_ANY_THROW(util::decompress(truncated.substr(0, truncated.size() / 2)));
+}
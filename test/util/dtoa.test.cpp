@@ -22,3 +22,14 @@ TEST(Dtoa, Precision) {
     EXPECT_EQ(M_SQRT2, std::stod(util::dtoa(M_SQRT2)));
     EXPECT_EQ(M_SQRT1_2, std::stod(util::dtoa(M_SQRT1_2)));
 }
+
+TEST(Dtoa, Buffer) {
+    for (double value : { 0., -0., 1., -1.5, M_PI, 1e21, 1.2345e-7, -1.2345678901234567e-6,
+                          DBL_MIN, -DBL_MIN, DBL_MAX, -DBL_MAX }) {
+        char buffer[util::dtoaBufferSize];
+        const char* end = util::dtoa(value, buffer);
+        EXPECT_LE(std::size_t(end - buffer), util::dtoaBufferSize);
+        EXPECT_EQ(util::dtoa(value), std::string(buffer, end));
+        EXPECT_EQ(value, std::stod(std::string(buffer, end)));
+    }
+}
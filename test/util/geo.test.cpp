@@ -220,3 +220,18 @@ TEST(LatLngBounds, FromTileID) {
         ASSERT_DOUBLE_EQ(util::LATITUDE_MAX, bounds.north());
     }
 }
+
+TEST(LatLngBounds, FromTileIDWithBuffer) {
+    const LatLngBounds bounds{ CanonicalTileID(1, 1, 1), 0.5 };
+    ASSERT_DOUBLE_EQ(-90, bounds.west());
+    ASSERT_DOUBLE_EQ(270, bounds.east());
+    ASSERT_GT(bounds.north(), 0);
+    ASSERT_LT(bounds.south(), -util::LATITUDE_MAX);
+
+    // The buffer is measured in projected units, like tile coordinates.
+    const LatLngBounds buffered{ CanonicalTileID(2, 1, 1), 1.0 };
+    ASSERT_DOUBLE_EQ(LatLngBounds(CanonicalTileID(2, 0, 0)).north(), buffered.north());
+    ASSERT_DOUBLE_EQ(LatLngBounds(CanonicalTileID(2, 2, 2)).south(), buffered.south());
+    ASSERT_DOUBLE_EQ(LatLngBounds(CanonicalTileID(2, 0, 0)).west(), buffered.west());
+    ASSERT_DOUBLE_EQ(LatLngBounds(CanonicalTileID(2, 2, 2)).east(), buffered.east());
+}
@@ -0,0 +1,75 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/geobuf.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <protozero/pbf_writer.hpp>
+
+using namespace mbgl;
+
+TEST(Geobuf, FeatureCollection) {
+    std::string data;
+    {
+        protozero::pbf_writer pbf(data);
+        pbf.add_string(1 /* keys */, "name");
+        protozero::pbf_writer collection(pbf, 4 /* feature_collection */);
+        {
+            protozero::pbf_writer feature(collection, 1 /* features */);
+            {
+                protozero::pbf_writer geometry(feature, 1 /* geometry */);
+                geometry.add_enum(1 /* type */, 2 /* LineString */);
+                const std::vector<int64_t> coords { 0, 0, 1000000, 2000000 };
+                geometry.add_packed_sint64(3 /* coords */, coords.begin(), coords.end());
+            }
+            feature.add_sint64(12 /* int_id */, -3);
+            {
+                protozero::pbf_writer value(feature, 13 /* values */);
+                value.add_string(1 /* string_value */, "road");
+            }
+            const std::vector<uint32_t> properties { 0, 0 };
+            feature.add_packed_uint32(14 /* properties */, properties.begin(), properties.end());
+        }
+        {
+            protozero::pbf_writer feature(collection, 1 /* features */);
+            feature.add_string(11 /* id */, "square");
+            protozero::pbf_writer geometry(feature, 1 /* geometry */);
+            geometry.add_enum(1 /* type */, 4 /* Polygon */);
+            // The closing point is left out.
+            const std::vector<int64_t> coords { 0, 0, 1000000, 0, 0, 1000000 };
+            geometry.add_packed_sint64(3 /* coords */, coords.begin(), coords.end());
+        }
+    }
+
+    ASSERT_TRUE(util::isGeobuf(data));
+    const GeoJSON geoJSON = util::decodeGeobuf(data);
+    const FeatureCollection& features = geoJSON.get<FeatureCollection>();
+    ASSERT_EQ(2u, features.size());
+
+    EXPECT_EQ((mapbox::geometry::line_string<double> { { 0, 0 }, { 1, 2 } }),
+              features[0].geometry.get<mapbox::geometry::line_string<double>>());
+    EXPECT_EQ(FeatureIdentifier(int64_t(-3)), *features[0].id);
+    EXPECT_EQ(Value(std::string("road")), features[0].properties.at("name"));
+
+    EXPECT_EQ((mapbox::geometry::polygon<double> { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 } } }),
+              features[1].geometry.get<mapbox::geometry::polygon<double>>());
+    EXPECT_EQ(FeatureIdentifier(std::string("square")), *features[1].id);
+}
+
+TEST(Geobuf, Invalid) {
+    EXPECT_FALSE(util::isGeobuf(" \n{ \"type\": \"Point\", \"coordinates\": [0, 0] }"));
+    // Data without content.
+    EXPECT_ANY_THROW(util::decodeGeobuf(std::string("\x10\x02", 2)));
+
+    // A line with fewer coordinates than its length.
+    std::string data;
+    {
+        protozero::pbf_writer pbf(data);
+        protozero::pbf_writer geometry(pbf, 6 /* geometry */);
+        geometry.add_enum(1 /* type */, 3 /* MultiLineString */);
+        const std::vector<uint32_t> lengths { 3 };
+        geometry.add_packed_uint32(2 /* lengths */, lengths.begin(), lengths.end());
+        const std::vector<int64_t> coords { 0, 0, 1, 1 };
+        geometry.add_packed_sint64(3 /* coords */, coords.begin(), coords.end());
+    }
+    EXPECT_ANY_THROW(util::decodeGeobuf(data));
+}
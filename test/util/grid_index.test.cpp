@@ -0,0 +1,51 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+
+using namespace mbgl;
+
+TEST(GridIndex, QueryIDs) {
+    GridIndex<IndexedFeature> grid(100, 10, 0);
+    grid.insert(IndexedFeature { 0, 0, 0 }, { { 0, 0 }, { 5, 5 } });
+    grid.insert(IndexedFeature { 1, 0, 0 }, { { 0, 0 }, { 60, 60 } });
+    grid.insert(IndexedFeature { 2, 0, 0 }, { { 80, 80 }, { 90, 90 } });
+
+    std::vector<std::size_t> ids { 42 };
+
+    // Elements that span several cells are only returned once, and in insertion order.
+    grid.query({ { 0, 0 }, { 50, 50 } }, ids);
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1 }), ids);
+    EXPECT_EQ(1u, grid.get(ids[1]).index);
+
+    // Elements that share a cell but not the box are left out.
+    grid.query({ { 6, 6 }, { 7, 7 } }, ids);
+    EXPECT_EQ((std::vector<std::size_t> { 1 }), ids);
+
+    grid.query({ { 95, 95 }, { 99, 99 } }, ids);
+    EXPECT_TRUE(ids.empty());
+
+    EXPECT_EQ(3u, grid.query({ { 0, 0 }, { 100, 100 } }).size());
+}
+
+TEST(GridIndex, Pack) {
+    GridIndex<IndexedFeature> grid(100, 10, 0);
+    for (uint32_t i = 0; i < 100; i++) {
+        const int16_t x = i;
+        grid.insert(IndexedFeature { i, 0, 0 }, { { x, 0 }, { int16_t(x + 15), 100 } });
+    }
+
+    std::vector<std::size_t> before;
+    grid.query({ { 20, 20 }, { 40, 40 } }, before);
+    const std::size_t bytes = grid.byteSize();
+
+    grid.pack();
+    EXPECT_TRUE(grid.packed());
+    EXPECT_LT(grid.byteSize(), bytes);
+
+    // Packing doesn't change what queries return.
+    std::vector<std::size_t> after;
+    grid.query({ { 20, 20 }, { 40, 40 } }, after);
+    EXPECT_EQ(before, after);
+    EXPECT_EQ(100u, grid.query({ { 0, 0 }, { 100, 100 } }).size());
+}
@@ -79,12 +79,39 @@ TEST(Image, JPEGTile) {
 }
 
 #if !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
+TEST(Image, JPEGTileReduced) {
+    const std::string data = util::read_file("test/fixtures/image/tile.jpeg");
+
+    // The largest power of two reduction that keeps the minimum size.
+    PremultipliedImage image = decodeImage(data, { 100, 100 });
+    EXPECT_EQ(128u, image.size.width);
+    EXPECT_EQ(128u, image.size.height);
+
+    image = decodeImage(data, { 256, 256 });
+    EXPECT_EQ(256u, image.size.width);
+    EXPECT_EQ(256u, image.size.height);
+}
+#endif // !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
+
+#if !defined(__ANDROID__) && !defined(QT_IMAGE_DECODERS)
 TEST(Image, WebPTile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/tile.webp"));
     EXPECT_EQ(256u, image.size.width);
     EXPECT_EQ(256u, image.size.height);
 }
-#endif // !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
+
+TEST(Image, WebPTileReduced) {
+    const std::string data = util::read_file("test/fixtures/image/tile.webp");
+
+    PremultipliedImage image = decodeImage(data, { 100, 100 });
+    EXPECT_EQ(128u, image.size.width);
+    EXPECT_EQ(128u, image.size.height);
+
+    image = decodeImage(data, { 512, 512 });
+    EXPECT_EQ(256u, image.size.width);
+    EXPECT_EQ(256u, image.size.height);
+}
+#endif // !defined(__ANDROID__) && !defined(QT_IMAGE_DECODERS)
 
 TEST(Image, Resize) {
     AlphaImage image({0, 0});
@@ -102,6 +129,20 @@ TEST(Image, Resize) {
     EXPECT_EQ(image.size, Size({0, 0}));
 }
 
+TEST(Image, Downsample) {
+    AlphaImage image({ 3, 2 });
+    const uint8_t pixels[] = { 10, 20, 255,
+                               30, 41, 255 };
+    std::copy(pixels, pixels + sizeof(pixels), image.data.get());
+
+    // The odd column doesn't fill a block and is dropped.
+    AlphaImage reduced = image.downsample(2);
+    EXPECT_EQ(Size({ 1, 1 }), reduced.size);
+    EXPECT_EQ(25, reduced.data[0]);
+
+    EXPECT_EQ(image, image.downsample(1));
+}
+
 TEST(Image, Copy) {
     PremultipliedImage src5({5, 5});
     PremultipliedImage dst5({5, 5});
@@ -163,3 +204,29 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(0u, rgba.size.width);
     EXPECT_EQ(0u, rgba.size.height);
 }
+
+TEST(Image, PremultiplyAllValues) {
+    // Every combination of a channel value and an alpha value matches the reference formulas.
+    std::vector<uint8_t> pixels;
+    for (uint32_t a = 0; a < 256; a++) {
+        for (uint32_t c = 0; c < 256; c++) {
+            pixels.insert(pixels.end(), { uint8_t(c), uint8_t(c), uint8_t(255 - c), uint8_t(a) });
+        }
+    }
+
+    std::vector<uint8_t> premultiplied = pixels;
+    util::premultiply(premultiplied.data(), premultiplied.size());
+
+    std::vector<uint8_t> unpremultiplied(pixels.size());
+    util::unpremultiply(premultiplied.data(), unpremultiplied.data(), premultiplied.size());
+
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        const uint32_t a = pixels[i + 3];
+        for (std::size_t c = 0; c < 3; c++) {
+            const uint32_t pre = (pixels[i + c] * a + 127) / 255;
+            ASSERT_EQ(pre, premultiplied[i + c]);
+            ASSERT_EQ(a ? (255 * pre + a / 2) / a : pre, unpremultiplied[i + c]);
+        }
+        ASSERT_EQ(a, unpremultiplied[i + 3]);
+    }
+}
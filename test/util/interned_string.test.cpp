@@ -0,0 +1,44 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/interned_string.hpp>
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(InternedString, Equality) {
+    const InternedString a("water");
+    const InternedString b(std::string("wat") + "er");
+    const InternedString c("road");
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(&a.str(), &b.str());
+    EXPECT_NE(a, c);
+    EXPECT_EQ("water", a.str());
+    EXPECT_EQ(InternedString(""), InternedString());
+
+    std::unordered_set<InternedString> set { a, b, c };
+    EXPECT_EQ(2u, set.size());
+}
+
+TEST(InternedString, Threads) {
+    std::vector<const std::string*> interned(4);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < interned.size(); i++) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 1000; j++) {
+                InternedString(std::to_string(j));
+            }
+            interned[i] = &InternedString("building").str();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto* string : interned) {
+        EXPECT_EQ(interned.front(), string);
+    }
+}
@@ -117,3 +117,18 @@ TEST(MergeLines, EmptyInnerGeometry) {
 
     EXPECT_EQ(input[0].geometry, expected[0].getGeometries());
 }
+
+TEST(MergeLines, DistinctEndpoints) {
+    // Endpoints in the tile buffer, and endpoints that only differ in one coordinate, aren't
+    // mistaken for each other.
+    std::vector<mbgl::SymbolFeature> input;
+    input.push_back(SymbolFeatureStub({}, FeatureType::LineString, {{{-64, 0}, {-1, 0}}}, properties, aaa, {}, 0));
+    input.push_back(SymbolFeatureStub({}, FeatureType::LineString, {{{0, -1}, {10, 10}}}, properties, aaa, {}, 0));
+    input.push_back(SymbolFeatureStub({}, FeatureType::LineString, {{{-1, 0}, {-1, -64}}}, properties, aaa, {}, 0));
+
+    mbgl::util::mergeLines(input);
+
+    EXPECT_EQ((GeometryCollection { { {-64, 0}, {-1, 0}, {-1, -64} } }), input[0].geometry);
+    EXPECT_EQ((GeometryCollection { { {0, -1}, {10, 10} } }), input[1].geometry);
+    EXPECT_EQ((GeometryCollection { emptyLine }), input[2].geometry);
+}
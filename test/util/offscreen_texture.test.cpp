@@ -142,8 +142,8 @@ void main() {
     MBGL_CHECK_ERROR(glUseProgram(paintShader.program));
     MBGL_CHECK_ERROR(glBindBuffer(GL_ARRAY_BUFFER, triangleBuffer.buffer));
     MBGL_CHECK_ERROR(glEnableVertexAttribArray(paintShader.a_pos));
-    MBGL_CHECK_ERROR(
-        glVertexAttribPointer(paintShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+    MBGL_CHECK_ERROR(glVertexAttribPointer(paintShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0,
+                                           reinterpret_cast<GLvoid*>(triangleBuffer.byteOffset)));
     MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, 3));
 
     auto image = texture.readStillImage();
@@ -161,10 +161,49 @@ void main() {
     MBGL_CHECK_ERROR(glUniform1i(u_texture, 0));
     MBGL_CHECK_ERROR(glBindBuffer(GL_ARRAY_BUFFER, viewportBuffer.buffer));
     MBGL_CHECK_ERROR(glEnableVertexAttribArray(compositeShader.a_pos));
-    MBGL_CHECK_ERROR(
-        glVertexAttribPointer(compositeShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+    MBGL_CHECK_ERROR(glVertexAttribPointer(compositeShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0,
+                                           reinterpret_cast<GLvoid*>(viewportBuffer.byteOffset)));
     MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
 
     image = backend.readStillImage();
     test::checkImage("test/fixtures/offscreen_texture/render-to-fbo-composited", image, 0, 0.1);
 }
+
+TEST(OffscreenTexture, Pool) {
+    HeadlessBackend backend({ 512, 256 });
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    gl::TextureID id = 0;
+    {
+        OffscreenTexture texture(context, { 128, 128 }, OffscreenTextureAttachment::Depth);
+        texture.bind();
+        id = texture.getTexture().texture.get();
+    }
+    EXPECT_EQ(0u, context.getRenderTargetPoolStats().hits);
+    EXPECT_EQ(1u, context.getRenderTargetPoolStats().misses);
+
+    // Textures of another size reuse the objects of a released one with the same attachments.
+    {
+        OffscreenTexture other(context, { 64, 64 });
+        other.bind();
+        EXPECT_NE(id, other.getTexture().texture.get());
+    }
+    {
+        OffscreenTexture resized(context, { 256, 128 }, OffscreenTextureAttachment::Depth);
+        resized.bind();
+        EXPECT_EQ(id, resized.getTexture().texture.get());
+        EXPECT_EQ(Size(256, 128), resized.getTexture().size);
+
+        MBGL_CHECK_ERROR(glClearColor(1.0f, 0.0f, 0.0f, 1.0f));
+        MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+        auto image = resized.readStillImage();
+        EXPECT_EQ(Size(256, 128), image.size);
+        EXPECT_EQ(255, image.data[0]);
+    }
+    EXPECT_EQ(1u, context.getRenderTargetPoolStats().hits);
+    EXPECT_EQ(2u, context.getRenderTargetPoolStats().misses);
+
+    context.reset();
+    EXPECT_TRUE(context.empty());
+}
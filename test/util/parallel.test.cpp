@@ -0,0 +1,63 @@
+#include <mbgl/util/parallel.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/actor/actor.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(Parallel, CallsEveryIndexOnce) {
+    ThreadPool pool { 4 };
+
+    std::vector<std::atomic<int>> calls(1000);
+    util::parallelFor(pool, calls.size(), [&] (std::size_t i) {
+        ++calls[i];
+    });
+
+    for (auto& count : calls) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+TEST(Parallel, FromWithinSaturatedPool) {
+    // Calling parallelFor() from the only thread of a pool must not deadlock: that thread does
+    // all the work itself.
+
+    struct Test {
+        Test(ActorRef<Test>, Scheduler& scheduler_)
+            : scheduler(scheduler_) {
+        }
+
+        int sum() {
+            std::atomic<int> result { 0 };
+            util::parallelFor(scheduler, 100, [&] (std::size_t i) {
+                result += int(i);
+            });
+            return result;
+        }
+
+        Scheduler& scheduler;
+    };
+
+    ThreadPool pool { 1 };
+    Actor<Test> test(pool, pool);
+
+    EXPECT_EQ(4950, test.ask(&Test::sum).get());
+}
+
+TEST(Parallel, RethrowsException) {
+    ThreadPool pool { 2 };
+
+    std::atomic<int> calls { 0 };
+    EXPECT_THROW(util::parallelFor(pool, 10, [&] (std::size_t i) {
+        ++calls;
+        if (i == 5) {
+            throw std::runtime_error("failure");
+        }
+    }), std::runtime_error);
+    EXPECT_EQ(10, calls);
+}
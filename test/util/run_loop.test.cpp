@@ -1,8 +1,12 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/timer.hpp>
+#include <mbgl/actor/actor.hpp>
 
 #include <mbgl/test/util.hpp>
 
+#include <vector>
+
+using namespace mbgl;
 using namespace mbgl::util;
 
 TEST(RunLoop, Stop) {
@@ -50,3 +54,27 @@ TEST(RunLoop, MultipleRun) {
 
     EXPECT_TRUE(secondTimeout);
 }
+
+TEST(RunLoop, TasksAndMessagesInOrder) {
+    RunLoop loop(RunLoop::Type::New);
+
+    struct Receiver {
+        Receiver(ActorRef<Receiver>, std::vector<int>& received_) : received(received_) {}
+        void receive(int i) { received.push_back(i); }
+        std::vector<int>& received;
+    };
+
+    std::vector<int> received;
+    Actor<Receiver> first(loop, std::ref(received));
+    Actor<Receiver> second(loop, std::ref(received));
+
+    // Messages to actors on the loop are queued alongside its tasks, and everything queued before
+    // the loop runs is processed in one go.
+    first.invoke(&Receiver::receive, 1);
+    loop.invoke([&] { received.push_back(2); });
+    second.invoke(&Receiver::receive, 3);
+    loop.invoke([&] { received.push_back(4); });
+
+    loop.runOnce();
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3, 4 }), received);
+}
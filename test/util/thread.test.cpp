@@ -189,6 +189,25 @@ TEST(Thread, ThreadPoolMessaging) {
     loop->run();
 }
 
+TEST(Thread, Priority) {
+    RunLoop loop;
+
+    // Raising the priority may not be permitted, but the threads run either way.
+    Thread<TestObject> thread(platform::ThreadPriority::Background, "Test", std::this_thread::get_id());
+    ThreadPool threadPool(1, platform::ThreadPriority::Interactive, platform::ThreadAffinity::PerformanceCores);
+    Actor<TestObject> poolObject(threadPool, std::this_thread::get_id());
+
+    std::promise<bool> threadResult;
+    auto threadFuture = threadResult.get_future();
+    thread.actor().invoke(&TestObject::checkContext, std::move(threadResult));
+    EXPECT_TRUE(threadFuture.get());
+
+    std::promise<bool> poolResult;
+    auto poolFuture = poolResult.get_future();
+    poolObject.self().invoke(&TestObject::checkContext, std::move(poolResult));
+    EXPECT_TRUE(poolFuture.get());
+}
+
 TEST(Thread, ReferenceCanOutliveThread) {
     auto thread = std::make_unique<Thread<TestWorker>>("Test");
     auto worker = thread->actor();
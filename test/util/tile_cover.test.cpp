@@ -4,6 +4,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <set>
+
 using namespace mbgl;
 
 TEST(TileCover, Empty) {
@@ -84,3 +87,137 @@ TEST(TileCover, SanFranciscoZ0Wrapped) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{ { 0, 1, 0 } }),
               util::tileCover(sanFranciscoWrapped, 0));
 }
+
+TEST(TileCover, Range) {
+    const std::vector<LatLngBounds> bounds {
+        LatLngBounds::world(),
+        LatLngBounds::empty(),
+        LatLngBounds::singleton({ 0, 0 }),
+        LatLngBounds::hull({ 86, -180 }, { 90, 180 }),
+        LatLngBounds::hull({ -10, -10 }, { 10, 10 }),
+        LatLngBounds::hull({ 0, -190 }, { 10, 200 }),
+        LatLngBounds::hull({ 37.6609, 9.5 }, { 37.8271, 9.5 }),
+        sanFrancisco,
+        sanFranciscoWrapped,
+    };
+
+    // The range holds the canonical tiles of the cover, each of them once.
+    for (const auto& bound : bounds) {
+        for (uint8_t z = 0; z <= 12; z++) {
+            std::set<CanonicalTileID> expected;
+            for (const auto& tile : util::tileCover(bound, z)) {
+                expected.insert(tile.canonical);
+            }
+
+            const util::TileRange range(bound, z);
+            std::set<CanonicalTileID> actual;
+            for (uint64_t i = 0; i < range.size(); i++) {
+                actual.insert(range[i]);
+            }
+
+            EXPECT_EQ(expected.size(), range.size());
+            EXPECT_EQ(expected, actual);
+        }
+    }
+}
+
+TEST(TileCover, RangeGeometry) {
+    auto tiles = [](const util::TileRange& range) {
+        std::vector<CanonicalTileID> result;
+        for (uint64_t i = 0; i < range.size(); i++) {
+            result.push_back(range[i]);
+        }
+        return result;
+    };
+
+    EXPECT_EQ((std::vector<CanonicalTileID>{ { 1, 1, 1 } }),
+              tiles({ Point<double>{ 0, 0 }, 1 }));
+
+    // Lines cover the tiles they pass through, also across the antimeridian.
+    EXPECT_EQ((std::vector<CanonicalTileID>{ { 2, 1, 2 }, { 2, 2, 2 } }),
+              tiles({ LineString<double>{ { -10, 0 }, { 10, 0 } }, 2 }));
+    EXPECT_EQ((std::vector<CanonicalTileID>{ { 2, 0, 2 }, { 2, 3, 2 } }),
+              tiles({ LineString<double>{ { 170, 0 }, { 190, 0 } }, 2 }));
+
+    // A rectangle covers the same tiles as its bounds.
+    const Polygon<double> rectangle {
+        { { -100, -50 }, { 100, -50 }, { 100, 50 }, { -100, 50 }, { -100, -50 } }
+    };
+    for (uint8_t z = 0; z <= 8; z++) {
+        const auto expected = tiles({ LatLngBounds::hull({ -50, -100 }, { 50, 100 }), z });
+        const auto actual = tiles({ rectangle, z });
+        EXPECT_EQ(std::set<CanonicalTileID>(expected.begin(), expected.end()),
+                  std::set<CanonicalTileID>(actual.begin(), actual.end()));
+        EXPECT_EQ(expected.size(), actual.size());
+    }
+
+    // Tiles inside holes aren't covered.
+    Polygon<double> ring = rectangle;
+    ring.push_back({ { -40, -30 }, { -40, 30 }, { 40, 30 }, { 40, -30 }, { -40, -30 } });
+    const auto covered = tiles({ ring, 4 });
+    const std::set<CanonicalTileID> set(covered.begin(), covered.end());
+    EXPECT_EQ(covered.size(), set.size());
+    EXPECT_EQ(1u, set.count({ 4, 5, 8 }));
+    EXPECT_EQ(0u, set.count({ 4, 8, 8 }));
+    EXPECT_EQ(0u, set.count({ 4, 7, 7 }));
+}
+
+TEST(TileCover, Incremental) {
+    Transform transform;
+    transform.resize({ 512, 512 });
+    transform.setLatLng({ 0.1, -0.1 });
+    transform.setZoom(4.5);
+    transform.setAngle(0.3);
+    transform.setPitch(30.0 * M_PI / 180.0);
+
+    // Small pans mostly keep the cover, and larger ones change it; either way the incremental
+    // cover matches the one computed from scratch, in the same order.
+    util::TileCover cover;
+    for (int i = 0; i < 200; i++) {
+        transform.moveBy({ 3.0 * (i % 7), 2.0 * (i % 5) - 4.0 });
+        if (i % 50 == 49) {
+            transform.setAngle(0.3 + i * 0.01);
+        }
+        const int32_t z = i < 100 ? 4 : 5;
+        EXPECT_EQ(util::tileCover(transform.getState(), z), cover.update(transform.getState(), z));
+    }
+}
+
+TEST(TileCover, LevelOfDetail) {
+    Transform transform;
+    transform.resize({ 512, 512 });
+    transform.setLatLng({ 0.1, -0.1 });
+    transform.setZoom(10);
+    transform.setAngle(0.3);
+    transform.setPitch(60.0 * M_PI / 180.0);
+
+    const auto ideal = util::tileCover(transform.getState(), 10);
+    const auto lod = util::lodTileCover(transform.getState(), 10, 0, 0);
+
+    // Far tiles are replaced by fewer tiles at lower zoom levels, and the near ones are kept.
+    EXPECT_LT(lod.size(), ideal.size());
+    EXPECT_EQ(ideal.front(), lod.front());
+    EXPECT_TRUE(std::any_of(lod.begin(), lod.end(), [](const auto& id) { return id.canonical.z < 10; }));
+
+    // Every ideal tile is covered by exactly one tile, and every tile covers some ideal tile.
+    for (const auto& idealID : ideal) {
+        EXPECT_EQ(1, std::count_if(lod.begin(), lod.end(), [&](const auto& id) {
+            return id == idealID || idealID.isChildOf(id);
+        }));
+    }
+    for (const auto& id : lod) {
+        EXPECT_TRUE(std::any_of(ideal.begin(), ideal.end(), [&](const auto& idealID) {
+            return id == idealID || idealID.isChildOf(id);
+        }));
+    }
+
+    // A positive bias keeps more detail.
+    EXPECT_GT(util::lodTileCover(transform.getState(), 10, 0, 1).size(), lod.size());
+
+    // Tiles don't get lower zoom levels than the minimum.
+    EXPECT_EQ(ideal, util::lodTileCover(transform.getState(), 10, 10, 0));
+
+    // Views without pitch are covered like by tileCover().
+    transform.setPitch(0);
+    EXPECT_EQ(util::tileCover(transform.getState(), 10), util::lodTileCover(transform.getState(), 10, 0, -1));
+}
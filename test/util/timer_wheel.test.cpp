@@ -0,0 +1,163 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/timer_wheel.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace mbgl::util;
+
+TEST(TimerWheel, RunLoopWheel) {
+    RunLoop loop;
+
+    auto wheel = TimerWheel::get();
+    EXPECT_EQ(wheel, TimerWheel::get());
+    EXPECT_EQ(mbgl::Seconds(1), wheel->getGranularity());
+
+    CoarseTimer timer;
+    timer.start(mbgl::Seconds(10), mbgl::Duration::zero(), [] {});
+    EXPECT_EQ(1u, wheel->size());
+    timer.stop();
+    EXPECT_EQ(0u, wheel->size());
+}
+
+TEST(TimerWheel, TEST_REQUIRES_ACCURATE_TIMING(Coalesce)) {
+    RunLoop loop;
+
+    auto wheel = std::make_shared<TimerWheel>(mbgl::Milliseconds(200));
+    CoarseTimer timer1(wheel);
+    CoarseTimer timer2(wheel);
+    CoarseTimer timer3(wheel);
+
+    // All three expire within the same tick, and fire together at its end.
+    std::vector<mbgl::TimePoint> fired;
+    auto callback = [&] {
+        fired.push_back(mbgl::Clock::now());
+        if (fired.size() == 3) {
+            loop.stop();
+        }
+    };
+
+    auto first = mbgl::Clock::now();
+    timer1.start(mbgl::Milliseconds(10), mbgl::Duration::zero(), callback);
+    timer2.start(mbgl::Milliseconds(50), mbgl::Duration::zero(), callback);
+    timer3.start(mbgl::Milliseconds(100), mbgl::Duration::zero(), callback);
+
+    loop.run();
+
+    ASSERT_EQ(3u, fired.size());
+    EXPECT_GE(fired.front() - first, mbgl::Milliseconds(100));
+    EXPECT_LE(fired.back() - fired.front(), mbgl::Milliseconds(10));
+    EXPECT_EQ(0u, wheel->size());
+}
+
+TEST(TimerWheel, TEST_REQUIRES_ACCURATE_TIMING(Cascade)) {
+    RunLoop loop;
+
+    // Beyond the first level of 64 ticks, so the timer is moved down the levels before it fires.
+    auto wheel = std::make_shared<TimerWheel>(mbgl::Milliseconds(1));
+    CoarseTimer timer(wheel);
+
+    auto interval = mbgl::Milliseconds(300);
+
+    auto first = mbgl::Clock::now();
+    timer.start(interval, mbgl::Duration::zero(), [&] { loop.stop(); });
+
+    loop.run();
+
+    auto totalTime = std::chrono::duration_cast<mbgl::Milliseconds>(mbgl::Clock::now() - first);
+
+    EXPECT_GE(totalTime, interval);
+    EXPECT_LE(totalTime, interval * 1.2);
+}
+
+TEST(TimerWheel, TEST_REQUIRES_ACCURATE_TIMING(Repeat)) {
+    RunLoop loop;
+
+    auto wheel = std::make_shared<TimerWheel>(mbgl::Milliseconds(10));
+    CoarseTimer timer(wheel);
+
+    unsigned count = 10;
+    auto callback = [&] {
+        if (!--count) {
+            timer.stop();
+            loop.stop();
+        }
+    };
+
+    auto interval = mbgl::Milliseconds(50);
+    auto expectedTotalTime = interval * count;
+
+    auto first = mbgl::Clock::now();
+    timer.start(interval, interval, callback);
+
+    loop.run();
+
+    auto totalTime = std::chrono::duration_cast<mbgl::Milliseconds>(mbgl::Clock::now() - first);
+
+    EXPECT_GE(totalTime, expectedTotalTime);
+    EXPECT_LE(totalTime, expectedTotalTime * 1.2);
+    EXPECT_EQ(0u, wheel->size());
+}
+
+TEST(TimerWheel, TEST_REQUIRES_ACCURATE_TIMING(Stop)) {
+    RunLoop loop;
+
+    auto wheel = std::make_shared<TimerWheel>(mbgl::Milliseconds(10));
+    CoarseTimer timer1(wheel);
+    CoarseTimer timer2(wheel);
+    CoarseTimer timer3(wheel);
+
+    int count = 0;
+
+    // Stops the timer expiring in the same tick from its callback.
+    timer1.start(mbgl::Milliseconds(50), mbgl::Duration::zero(), [&] {
+        ++count;
+        timer2.stop();
+    });
+    timer2.start(mbgl::Milliseconds(50), mbgl::Duration::zero(), [&] {
+        ++count;
+    });
+    timer3.start(mbgl::Milliseconds(100), mbgl::Duration::zero(), [&] {
+        ++count;
+        loop.stop();
+    });
+
+    loop.run();
+
+    EXPECT_EQ(2, count);
+}
+
+TEST(TimerWheel, DestroyLoop) {
+    auto loop = std::make_unique<RunLoop>(RunLoop::Type::New);
+
+    CoarseTimer timer;
+    timer.start(mbgl::Seconds(10), mbgl::Duration::zero(), [] {});
+
+    // The timer outlives its loop, and doesn't fire anymore.
+    loop.reset();
+    timer.stop();
+}
+
+TEST(TimerWheel, StopWithinSlot) {
+    RunLoop loop;
+
+    auto wheel = std::make_shared<TimerWheel>(mbgl::Seconds(1));
+    std::vector<std::unique_ptr<CoarseTimer>> timers;
+
+    // All in the same slot, and stopped out of the order they were started in.
+    for (int i = 0; i < 1000; i++) {
+        timers.push_back(std::make_unique<CoarseTimer>(wheel));
+        timers.back()->start(mbgl::Seconds(10), mbgl::Duration::zero(), [] {});
+    }
+    for (std::size_t i = 0; i < timers.size(); i += 2) {
+        timers[i]->stop();
+    }
+    EXPECT_EQ(500u, wheel->size());
+    for (std::size_t i = timers.size() - 1; i < timers.size(); i -= 2) {
+        timers[i]->stop();
+    }
+    EXPECT_EQ(0u, wheel->size());
+}
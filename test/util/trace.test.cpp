@@ -0,0 +1,39 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/trace.hpp>
+
+#include <thread>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(Trace, Disabled) {
+    trace::exportChromeTrace();
+
+    { trace::Span span("disabled"); }
+    EXPECT_EQ(std::string::npos, trace::exportChromeTrace().find("disabled"));
+}
+
+TEST(Trace, Spans) {
+    trace::setEnabled(true);
+    trace::exportChromeTrace();
+
+    { trace::Span span("parse", CanonicalTileID(1, 0, 1)); }
+
+    // Spans moved to another thread are recorded there.
+    trace::Span moved("network");
+    std::thread thread([span = std::move(moved)] () mutable { span.end(); });
+    thread.join();
+
+    { trace::Span unnamed(nullptr); }
+
+    const std::string json = trace::exportChromeTrace();
+    trace::setEnabled(false);
+
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"parse\",\"cat\":\"tile\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("\"args\":{\"tile\":\"1/0/1\"}"));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"network\",\"cat\":\"mbgl\""));
+
+    // Exporting clears the events.
+    EXPECT_EQ("{\"traceEvents\":[]}", trace::exportChromeTrace());
+}
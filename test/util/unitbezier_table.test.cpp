@@ -0,0 +1,34 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/unitbezier_table.hpp>
+
+using namespace mbgl;
+
+TEST(UnitBezierTable, MatchesCurve) {
+    const util::UnitBezierTable& table = util::UnitBezierTable::defaultTransitionEase();
+
+    // Within the precision that the curve is solved with, both by the table and without it.
+    for (int i = 0; i <= 1000; i++) {
+        const double x = i / 1000.0;
+        EXPECT_NEAR(util::DEFAULT_TRANSITION_EASE.solve(x, 0.001), table.solve(x), 0.005) << x;
+    }
+}
+
+TEST(UnitBezierTable, SamplePoints) {
+    const util::UnitBezier curve { 0.42, 0, 0.58, 1 };
+    const util::UnitBezierTable table { curve };
+
+    EXPECT_DOUBLE_EQ(curve.solve(0.5, 0.001), table.solve(0.5));
+    EXPECT_DOUBLE_EQ(curve.solve(0.25, 0.001), table.solve(0.25));
+    EXPECT_DOUBLE_EQ(curve.solve(0.75, 0.001), table.solve(0.75));
+}
+
+TEST(UnitBezierTable, Clamps) {
+    const util::UnitBezierTable& table = util::UnitBezierTable::defaultTransitionEase();
+
+    EXPECT_DOUBLE_EQ(table.solve(0), table.solve(-1));
+    EXPECT_DOUBLE_EQ(table.solve(1), table.solve(2));
+    EXPECT_NEAR(0, table.solve(0), 1e-6);
+    EXPECT_NEAR(1, table.solve(1), 1e-6);
+}
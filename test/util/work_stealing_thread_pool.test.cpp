@@ -0,0 +1,130 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(WorkStealingThreadPool, ProcessesAllActors) {
+    // Every message sent to every actor is received exactly once, regardless of which worker
+    // ends up processing it.
+
+    struct Test {
+        std::atomic<int>& received;
+
+        Test(ActorRef<Test>, std::atomic<int>& received_)
+            : received(received_) {
+        }
+
+        void receive() {
+            ++received;
+        }
+
+        bool sync() {
+            return true;
+        }
+    };
+
+    WorkStealingThreadPool pool { 4 };
+    std::atomic<int> received { 0 };
+
+    {
+        std::vector<std::unique_ptr<Actor<Test>>> actors;
+        for (int i = 0; i < 100; ++i) {
+            actors.push_back(std::make_unique<Actor<Test>>(pool, std::ref(received)));
+        }
+
+        std::vector<std::future<bool>> futures;
+        for (auto& actor : actors) {
+            for (int i = 0; i < 10; ++i) {
+                actor->invoke(&Test::receive);
+            }
+            futures.push_back(actor->ask(&Test::sync));
+        }
+
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
+
+    EXPECT_EQ(100 * 10, received);
+}
+
+TEST(WorkStealingThreadPool, OrderedMailbox) {
+    // Messages are processed in order, including messages that actors send to each other from
+    // within the pool.
+
+    struct Sink {
+        int last = 0;
+        std::promise<void> promise;
+
+        Sink(ActorRef<Sink>, std::promise<void> promise_)
+            : promise(std::move(promise_)) {
+        }
+
+        void receive(int i) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    struct Forwarder {
+        ActorRef<Sink> sink;
+
+        Forwarder(ActorRef<Forwarder>, ActorRef<Sink> sink_)
+            : sink(std::move(sink_)) {
+        }
+
+        void forward(int i) {
+            sink.invoke(&Sink::receive, i);
+        }
+
+        void end() {
+            sink.invoke(&Sink::end);
+        }
+    };
+
+    WorkStealingThreadPool pool { 4 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Sink> sink(pool, std::move(endedPromise));
+    Actor<Forwarder> forwarder(pool, sink.self());
+
+    for (int i = 1; i <= 1000; ++i) {
+        forwarder.invoke(&Forwarder::forward, i);
+    }
+    forwarder.invoke(&Forwarder::end);
+
+    endedFuture.wait();
+}
+
+TEST(WorkStealingThreadPool, DestructionWithPendingWork) {
+    // Destroying the pool while work is still queued doesn't crash or hang.
+
+    struct Test {
+        Test(ActorRef<Test>) {
+        }
+
+        void receive() {
+        }
+    };
+
+    auto pool = std::make_unique<WorkStealingThreadPool>(2);
+    Actor<Test> actor(*pool);
+
+    for (int i = 0; i < 1000; ++i) {
+        actor.invoke(&Test::receive);
+    }
+
+    pool.reset();
+}